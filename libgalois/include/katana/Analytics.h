@@ -1,14 +1,27 @@
 #ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_H_
 #define KATANA_LIBGALOIS_KATANA_ANALYTICS_H_
 
+#include "katana/analytics/AutoTune.h"
+#include "katana/analytics/analytics_batch/analytics_batch.h"
 #include "katana/analytics/betweenness_centrality/betweenness_centrality.h"
 #include "katana/analytics/bfs/bfs.h"
+#include "katana/analytics/bipartite_matching/bipartite_matching.h"
 #include "katana/analytics/connected_components/connected_components.h"
+#include "katana/analytics/graph_coloring/graph_coloring.h"
+#include "katana/analytics/hypergraph_partition/hypergraph_partition.h"
 #include "katana/analytics/jaccard/jaccard.h"
 #include "katana/analytics/k_core/k_core.h"
+#include "katana/analytics/k_shortest_paths/k_shortest_paths.h"
 #include "katana/analytics/k_truss/k_truss.h"
+#include "katana/analytics/label_propagation/label_propagation.h"
+#include "katana/analytics/matrix_completion/matrix_completion.h"
+#include "katana/analytics/max_flow/max_flow.h"
+#include "katana/analytics/minimum_spanning_forest/minimum_spanning_forest.h"
 #include "katana/analytics/pagerank/pagerank.h"
+#include "katana/analytics/partition/partition.h"
+#include "katana/analytics/pattern_matching/pattern_matching.h"
 #include "katana/analytics/sssp/sssp.h"
+#include "katana/analytics/strongly_connected_components/strongly_connected_components.h"
 #include "katana/analytics/triangle_count/triangle_count.h"
 
 #endif
@@ -21,7 +21,11 @@
 #define KATANA_LIBGALOIS_KATANA_BAG_H_
 
 #include <algorithm>
+#include <atomic>
+#include <memory>
 #include <stdexcept>
+#include <utility>
+#include <vector>
 
 #include <boost/iterator/iterator_facade.hpp>
 
@@ -34,6 +38,11 @@
 
 namespace katana {
 
+template <typename T>
+class NUMAArray;
+template <typename T>
+class PODVector;
+
 /**
  * Unordered collection of elements. This data structure supports scalable
  * concurrent pushes but reading the bag can only be done serially.
@@ -193,6 +202,17 @@ private:
   }
 
 public:
+  /// How Flatten divides the copying among threads. The output order is the
+  /// iteration order, i.e., grouped by the inserting thread, in both cases.
+  enum class FlattenMode {
+    /// Each thread copies the blocks it inserted, so the reads stay on the
+    /// NUMA node that wrote them and the output is first touched there
+    kLocal,
+    /// Threads take blocks as they finish the previous one, which balances
+    /// bags that were filled unevenly, e.g., by a few threads
+    kBalanced,
+  };
+
   // static_assert(BlockSize == 0 || BlockSize >= (2 * sizeof(T) +
   // sizeof(header)),
   //     "BlockSize should larger than sizeof(T) + O(1)");
@@ -252,6 +272,44 @@ public:
     }
     return true;
   }
+
+  //! Number of elements; walks the blocks but not the elements
+  size_t size() const {
+    size_t ret = 0;
+    for (unsigned x = 0; x < heads.size(); ++x) {
+      for (const header* h = heads.getRemote(x)->first; h; h = h->next) {
+        ret += h->dend - h->dbegin;
+      }
+    }
+    return ret;
+  }
+
+  /**
+   * Copy the elements, in parallel, into a contiguous array in iteration
+   * order so that later loops can index them and steal work evenly. Must
+   * not run concurrently with pushes. The array is reallocated: with kLocal
+   * its pages are left untouched so each lands on the node of the thread
+   * that copies into it first, and with kBalanced it is interleaved.
+   */
+  void Flatten(
+      NUMAArray<T>* out, FlattenMode mode = FlattenMode::kLocal) const {
+    NUMAArray<T> ret;
+    if (mode == FlattenMode::kLocal) {
+      ret.allocateFloating(size());
+    } else {
+      ret.allocateInterleaved(size());
+    }
+    uninitializedCopyTo(ret.data(), mode);
+    *out = std::move(ret);
+  }
+
+  //! Resizes out to size() and copies the elements as above
+  void Flatten(
+      PODVector<T>* out, FlattenMode mode = FlattenMode::kLocal) const {
+    out->resize(size());
+    uninitializedCopyTo(out->data(), mode);
+  }
+
   //! Thread safe bag insertion
   template <typename... Args>
   reference emplace(Args&&... args) {
@@ -295,6 +353,49 @@ public:
   reference push_back(ItemTy&& val) {
     return emplace(std::forward<ItemTy>(val));
   }
+
+private:
+  // Copy construct the elements into uninitialized storage in iteration
+  // order. Every block gets its offset in out up front, so the blocks can be
+  // copied in any order by any thread.
+  void uninitializedCopyTo(T* out, FlattenMode mode) const {
+    std::vector<std::pair<const header*, size_t>> blocks;
+    std::vector<size_t> thread_blocks(heads.size() + 1, 0);
+    size_t offset = 0;
+    for (unsigned x = 0; x < heads.size(); ++x) {
+      thread_blocks[x] = blocks.size();
+      for (const header* h = heads.getRemote(x)->first; h; h = h->next) {
+        blocks.emplace_back(h, offset);
+        offset += h->dend - h->dbegin;
+      }
+    }
+    thread_blocks[heads.size()] = blocks.size();
+
+    auto copy_block = [&](size_t i) {
+      const header* h = blocks[i].first;
+      std::uninitialized_copy(h->dbegin, h->dend, out + blocks[i].second);
+    };
+
+    std::atomic<size_t> next_block{0};
+    katana::on_each_gen(
+        [&](const unsigned int tid, const unsigned int num_threads) {
+          if (mode == FlattenMode::kLocal) {
+            // Threads beyond the active ones may have inserted too
+            for (unsigned x = tid; x < heads.size(); x += num_threads) {
+              for (size_t i = thread_blocks[x]; i < thread_blocks[x + 1];
+                   ++i) {
+                copy_block(i);
+              }
+            }
+          } else {
+            for (size_t i = next_block++; i < blocks.size();
+                 i = next_block++) {
+              copy_block(i);
+            }
+          }
+        },
+        std::make_tuple(katana::no_stats()));
+  }
 };
 
 }  // namespace katana
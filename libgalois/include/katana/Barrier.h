@@ -58,6 +58,11 @@ public:
  * be in the barrier while the main thread reinitializes this
  * barrier to the new number of active threads. If that may
  * happen, use {@link CreateSimpleBarrier()} instead.
+ *
+ * The kind of barrier is chosen with the KATANA_BARRIER environment
+ * variable. With KATANA_BARRIER=auto, the first call for each number of
+ * active threads times every kind of barrier with those threads and keeps
+ * the fastest; the choice is reported as a statistic.
  */
 KATANA_EXPORT Barrier& GetBarrier(unsigned active_threads);
 
@@ -28,7 +28,7 @@ using NullMaps = std::pair<
     std::unordered_map<int, std::shared_ptr<arrow::Array>>,
     std::unordered_map<int, std::shared_ptr<arrow::Array>>>;
 
-enum SourceType { kGraphml, kKatana };
+enum SourceType { kGraphml, kKatana, kCsv, kParquet };
 enum SourceDatabase { kNone, kNeo4j, kMongodb, kMysql };
 enum ImportDataType {
   kString,
@@ -111,6 +111,14 @@ struct LabelsState {
   std::unordered_map<std::string, std::string> reverse_schema;
 };
 
+/// An edge end whose node ID was not known when the edge was added; the ID
+/// is stored at [offset, offset + length) of TopologyState::intermediate_ids
+struct IntermediateID {
+  size_t edge;
+  size_t offset;
+  size_t length;
+};
+
 struct TopologyState {
   // maps node IDs to node indexes
   std::unordered_map<std::string, size_t> node_indexes;
@@ -125,9 +133,11 @@ struct TopologyState {
 
   // for schema mapping
   std::unordered_set<std::string> edge_ids;
-  // for data ingestion that does not guarantee nodes are imported first
-  std::unordered_map<size_t, std::string> sources_intermediate;
-  std::unordered_map<size_t, std::string> destinations_intermediate;
+  // for data ingestion that does not guarantee nodes are imported first;
+  // the unresolved IDs are stored back to back in intermediate_ids
+  std::string intermediate_ids;
+  std::vector<IntermediateID> sources_intermediate;
+  std::vector<IntermediateID> destinations_intermediate;
 };
 
 struct WriterProperties {
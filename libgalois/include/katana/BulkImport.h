@@ -0,0 +1,79 @@
+#ifndef KATANA_LIBGALOIS_KATANA_BULKIMPORT_H_
+#define KATANA_LIBGALOIS_KATANA_BULKIMPORT_H_
+
+/// Construct a PropertyGraph from tables of nodes and edges, such as CSV or
+/// parquet exports of a database.
+///
+/// Unlike PropertyGraphBuilder, which takes one element at a time, the
+/// importer works on whole columns in parallel: node ids are mapped to dense
+/// node ids with a partitioned hash join, and the CSR is built with a two
+/// pass counting sort of the edges by source.
+///
+/// \file
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/BuildGraph.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// The columns of the node and edge tables with the graph structure
+struct BulkImportOptions {
+  /// The column of the node tables with the id of each node. Ids are
+  /// integers or strings, and are kept as a node property.
+  std::string node_id_column{"id"};
+  /// The columns of the edge tables with the ids of the source and the
+  /// destination of each edge, which are not kept as properties
+  std::string edge_source_column{"src"};
+  std::string edge_destination_column{"dst"};
+  /// If not empty, a string column whose values become node labels
+  std::string node_label_column;
+  /// If not empty, a string column whose values become edge types
+  std::string edge_type_column;
+};
+
+/// Read a table of nodes or edges from a CSV, with a header line, or a
+/// parquet file, using arrow's multithreaded readers. Strings are read as
+/// large strings.
+///
+/// \param format kCsv or kParquet
+KATANA_EXPORT Result<std::shared_ptr<arrow::Table>> ReadImportTable(
+    const std::string& path, SourceType format);
+
+/// Build the components of a graph from node and edge tables. Node i of the
+/// graph is row i of nodes. The edges of each node are in the order of
+/// edges, and every source and destination must be the id of a node.
+KATANA_EXPORT Result<GraphComponents> ImportTables(
+    const std::shared_ptr<arrow::Table>& nodes,
+    const std::shared_ptr<arrow::Table>& edges,
+    const BulkImportOptions& options);
+
+/// Read and import node and edge files of the given format; the tables of
+/// several files are concatenated in order
+KATANA_EXPORT Result<GraphComponents> ImportFiles(
+    const std::vector<std::string>& node_paths,
+    const std::vector<std::string>& edge_paths, SourceType format,
+    const BulkImportOptions& options);
+
+/// Build the components of a graph from an edge list whose sources and
+/// destinations are already node ids, e.g., numpy arrays from Python. The
+/// graph has max id + 1 nodes, with no node properties. The edges of each
+/// node are in input order, and edge_properties, which may be null, has a
+/// row for each edge.
+///
+/// Integer id arrays without nulls are read in place; fixed width property
+/// columns without nulls are put in the order of the CSR in the same
+/// parallel pass as the destinations.
+KATANA_EXPORT Result<GraphComponents> ImportEdgeList(
+    std::shared_ptr<arrow::Array> sources, std::shared_ptr<arrow::Array> dests,
+    std::shared_ptr<arrow::Table> edge_properties);
+
+}  // namespace katana
+
+#endif
@@ -20,6 +20,8 @@
 #ifndef KATANA_LIBGALOIS_KATANA_CHUNK_H_
 #define KATANA_LIBGALOIS_KATANA_CHUNK_H_
 
+#include <algorithm>
+
 #include "katana/FixedSizeRing.h"
 #include "katana/Mem.h"
 #include "katana/PaddedLock.h"
@@ -52,22 +54,36 @@ struct squeue<false, PS, TQ> {
   int size() { return 0; }
 };
 
+//! Chunks a thread took from a chunked worklist, and its attempts to take
+//! them from the queues of other threads or sockets and how many succeeded
+struct ChunkStats {
+  size_t chunks{0};
+  size_t steal_attempts{0};
+  size_t steals{0};
+};
+
 //! Common functionality to all chunked worklists
+//!
+//! If Adaptive is true, ChunkSize is only the capacity of a chunk. Each
+//! thread publishes its chunks once they hold a per-thread limit of items.
+//! The limit doubles after a run of pops served from the thread's own queue
+//! and halves whenever a thread has to take a chunk from another queue or
+//! finds no chunk at all, so it tracks how much spare work there is.
 template <
     typename T, template <typename, bool> class QT, bool Distributed,
-    bool IsStack, int ChunkSize, bool Concurrent>
+    bool IsStack, int ChunkSize, bool Concurrent, bool Adaptive = false>
 struct ChunkMaster {
   template <typename _T>
-  using retype =
-      ChunkMaster<_T, QT, Distributed, IsStack, ChunkSize, Concurrent>;
+  using retype = ChunkMaster<
+      _T, QT, Distributed, IsStack, ChunkSize, Concurrent, Adaptive>;
 
   template <int _chunk_size>
-  using with_chunk_size =
-      ChunkMaster<T, QT, Distributed, IsStack, _chunk_size, Concurrent>;
+  using with_chunk_size = ChunkMaster<
+      T, QT, Distributed, IsStack, _chunk_size, Concurrent, Adaptive>;
 
   template <bool _Concurrent>
-  using rethread =
-      ChunkMaster<T, QT, Distributed, IsStack, ChunkSize, _Concurrent>;
+  using rethread = ChunkMaster<
+      T, QT, Distributed, IsStack, ChunkSize, _Concurrent, Adaptive>;
 
 private:
   class Chunk : public FixedSizeRing<T, ChunkSize>,
@@ -75,10 +91,19 @@ private:
 
   FixedSizeAllocator<Chunk> alloc;
 
+  //! Initial per-thread chunk limit in adaptive mode
+  constexpr static unsigned kAdaptiveInitialLimit =
+      ChunkSize < 16 ? ChunkSize : 16;
+  //! Consecutive pops from a thread's own queue before its limit doubles
+  constexpr static unsigned kAdaptiveGrowAfter = 8;
+
   struct p {
     Chunk* cur;
     Chunk* next;
-    p() : cur(0), next(0) {}
+    unsigned limit;
+    unsigned local_pops;
+    ChunkStats stats;
+    p() : cur(0), next(0), limit(kAdaptiveInitialLimit), local_pops(0) {}
   };
 
   typedef QT<Chunk, Concurrent> LevelItem;
@@ -107,31 +132,59 @@ private:
     return I.pop();
   }
 
-  Chunk* popChunk() {
+  void growLimit(p& n) {
+    if (Adaptive && ++n.local_pops >= kAdaptiveGrowAfter) {
+      n.local_pops = 0;
+      n.limit = std::min<unsigned>(2 * n.limit, ChunkSize);
+    }
+  }
+
+  void shrinkLimit(p& n) {
+    if (Adaptive) {
+      n.local_pops = 0;
+      n.limit = std::max<unsigned>(n.limit / 2, 1);
+    }
+  }
+
+  Chunk* popChunk(p& n) {
     int id = Q.myEffectiveID();
     Chunk* r = popChunkByID(id);
-    if (r)
+    if (r) {
+      growLimit(n);
+      ++n.stats.chunks;
       return r;
+    }
+
+    shrinkLimit(n);
 
     for (int i = id + 1; i < (int)Q.size(); ++i) {
+      ++n.stats.steal_attempts;
       r = popChunkByID(i);
       if (r)
-        return r;
+        break;
     }
 
-    for (int i = 0; i < id; ++i) {
+    for (int i = 0; !r && i < id; ++i) {
+      ++n.stats.steal_attempts;
       r = popChunkByID(i);
-      if (r)
-        return r;
     }
 
-    return 0;
+    if (r) {
+      ++n.stats.chunks;
+      ++n.stats.steals;
+    }
+    return r;
+  }
+
+  bool belowLimit(const p& n) const {
+    return !Adaptive || n.next->size() < n.limit;
   }
 
   template <typename... Args>
   T* emplacei(p& n, Args&&... args) {
     T* retval = 0;
-    if (n.next && (retval = n.next->emplace_back(std::forward<Args>(args)...)))
+    if (n.next && belowLimit(n) &&
+        (retval = n.next->emplace_back(std::forward<Args>(args)...)))
       return retval;
     if (n.next)
       pushChunk(n.next);
@@ -180,7 +233,7 @@ public:
         return &n.next->back();
       if (n.next)
         delChunk(n.next);
-      n.next = popChunk();
+      n.next = popChunk(n);
       if (n.next && !n.next->empty())
         return &n.next->back();
       return NULL;
@@ -189,7 +242,7 @@ public:
         return &n.cur->front();
       if (n.cur)
         delChunk(n.cur);
-      n.cur = popChunk();
+      n.cur = popChunk(n);
       if (!n.cur) {
         n.cur = n.next;
         n.next = 0;
@@ -233,6 +286,14 @@ public:
     push(range.local_begin(), range.local_end());
   }
 
+  //! The ChunkStats of the calling thread since the last call
+  ChunkStats TakeChunkStats() {
+    p& n = data.get();
+    ChunkStats stats = n.stats;
+    n.stats = ChunkStats();
+    return stats;
+  }
+
   std::optional<value_type> pop() {
     p& n = data.get();
     std::optional<value_type> retval;
@@ -241,7 +302,7 @@ public:
         return retval;
       if (n.next)
         delChunk(n.next);
-      n.next = popChunk();
+      n.next = popChunk(n);
       if (n.next)
         return n.next->extract_back();
       return std::nullopt;
@@ -250,7 +311,7 @@ public:
         return retval;
       if (n.cur)
         delChunk(n.cur);
-      n.cur = popChunk();
+      n.cur = popChunk(n);
       if (!n.cur) {
         n.cur = n.next;
         n.next = 0;
@@ -315,6 +376,30 @@ using PerSocketChunkBag = internal::ChunkMaster<
     T, ConExtLinkedQueue, true, true, ChunkSize, Concurrent>;
 KATANA_WLCOMPILECHECK(PerSocketChunkBag)
 
+/**
+ * {@link PerSocketChunkFIFO} whose chunk size adapts at runtime. Each thread
+ * starts with small chunks, grows them while it finds work in its own queue
+ * and shrinks them when it runs out, so one binary suits graphs that want
+ * very different chunk sizes.
+ *
+ * @tparam MaxChunkSize largest chunk size
+ */
+template <int MaxChunkSize = 512, typename T = int, bool Concurrent = true>
+using AdaptivePerSocketChunkFIFO = internal::ChunkMaster<
+    T, ConExtLinkedQueue, true, false, MaxChunkSize, Concurrent, true>;
+KATANA_WLCOMPILECHECK(AdaptivePerSocketChunkFIFO)
+
+/**
+ * {@link PerSocketChunkLIFO} whose chunk size adapts at runtime; see
+ * {@link AdaptivePerSocketChunkFIFO}.
+ *
+ * @tparam MaxChunkSize largest chunk size
+ */
+template <int MaxChunkSize = 512, typename T = int, bool Concurrent = true>
+using AdaptivePerSocketChunkLIFO = internal::ChunkMaster<
+    T, ConExtLinkedStack, true, true, MaxChunkSize, Concurrent, true>;
+KATANA_WLCOMPILECHECK(AdaptivePerSocketChunkLIFO)
+
 }  // end namespace katana
 
 #endif
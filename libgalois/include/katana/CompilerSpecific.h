@@ -50,6 +50,14 @@ constexpr int KATANA_CACHE_LINE_SIZE = 128;
 #define KATANA_ATTRIBUTE_NOINLINE
 #endif
 
+// A function whose result depends only on its arguments, so calls with the
+// same arguments may be merged or hoisted out of loops
+#if defined(__GNUC__)
+#define KATANA_ATTRIBUTE_CONST __attribute__((const))
+#else
+#define KATANA_ATTRIBUTE_CONST
+#endif
+
 }  // namespace katana
 
 #endif
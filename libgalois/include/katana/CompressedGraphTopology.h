@@ -0,0 +1,256 @@
+#ifndef KATANA_LIBGALOIS_KATANA_COMPRESSEDGRAPHTOPOLOGY_H_
+#define KATANA_LIBGALOIS_KATANA_COMPRESSEDGRAPHTOPOLOGY_H_
+
+#include <cstdint>
+#include <iterator>
+
+#include "katana/GraphTopology.h"
+#include "katana/Iterators.h"
+#include "katana/Logging.h"
+#include "katana/NUMAArray.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+namespace internal {
+
+inline uint64_t
+ZigZagEncode(int64_t val) noexcept {
+  return (static_cast<uint64_t>(val) << 1) ^ static_cast<uint64_t>(val >> 63);
+}
+
+inline int64_t
+ZigZagDecode(uint64_t val) noexcept {
+  return static_cast<int64_t>(val >> 1) ^ -static_cast<int64_t>(val & 1);
+}
+
+/// \returns the number of bytes needed to LEB128 encode \p val
+inline uint64_t
+VarintSize(uint64_t val) noexcept {
+  uint64_t size = 1;
+  while (val >= 0x80) {
+    val >>= 7;
+    ++size;
+  }
+  return size;
+}
+
+inline uint8_t*
+WriteVarint(uint8_t* pos, uint64_t val) noexcept {
+  while (val >= 0x80) {
+    *pos++ = static_cast<uint8_t>(val | 0x80);
+    val >>= 7;
+  }
+  *pos++ = static_cast<uint8_t>(val);
+  return pos;
+}
+
+inline const uint8_t*
+ReadVarint(const uint8_t* pos, uint64_t* val) noexcept {
+  uint64_t result = 0;
+  int shift = 0;
+  uint8_t byte;
+  do {
+    byte = *pos++;
+    result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    shift += 7;
+  } while ((byte & 0x80) && shift < 64);
+  *val = result;
+  return pos;
+}
+
+inline const uint8_t*
+SkipVarint(const uint8_t* pos) noexcept {
+  while (*pos++ & 0x80) {
+  }
+  return pos;
+}
+
+}  // namespace internal
+
+/// A CSR topology whose destinations are delta and varint encoded in blocks
+/// of edges, mirroring the kCompressedCSRTopologyVersion file format (see
+/// tsuba/CSRTopology.h).
+///
+/// Edge IDs are the same as in the uncompressed GraphTopology, so edges(),
+/// degree() and property lookups work unchanged. Destinations are read either
+/// with dests(node), which decodes a node's edge list on the fly, or with
+/// Decompress(), which materializes an ordinary GraphTopology in parallel.
+class KATANA_EXPORT CompressedGraphTopology : public GraphTopologyTypes {
+public:
+  static constexpr uint64_t kDefaultEdgesPerBlock = 128;
+
+  /// Forward iterator over the destinations of a contiguous range of edges.
+  /// It is positioned at an edge ID; dereferencing yields that edge's
+  /// destination.
+  class DestIterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Node;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const Node*;
+    using reference = Node;
+
+    DestIterator() = default;
+
+    Node operator*() const noexcept { return dest_; }
+
+    Edge edge() const noexcept { return edge_; }
+
+    DestIterator& operator++() noexcept {
+      ++edge_;
+      if (edge_ < end_) {
+        Decode();
+      }
+      return *this;
+    }
+
+    DestIterator operator++(int) noexcept {
+      DestIterator tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    bool operator==(const DestIterator& that) const noexcept {
+      return edge_ == that.edge_;
+    }
+    bool operator!=(const DestIterator& that) const noexcept {
+      return !(*this == that);
+    }
+
+  private:
+    friend class CompressedGraphTopology;
+
+    DestIterator(
+        const uint8_t* pos, Edge edge, Edge node_begin, Edge end, Node src,
+        uint64_t edges_per_block) noexcept
+        : pos_(pos),
+          edge_(edge),
+          node_begin_(node_begin),
+          end_(end),
+          src_(src),
+          edges_per_block_(edges_per_block) {
+      if (edge_ < end_) {
+        Decode();
+      }
+    }
+
+    void Decode() noexcept;
+
+    const uint8_t* pos_{nullptr};
+    Edge edge_{0};
+    Edge node_begin_{0};
+    Edge end_{0};
+    Node src_{0};
+    Node dest_{0};
+    uint64_t edges_per_block_{1};
+  };
+
+  using dests_range = StandardRange<DestIterator>;
+
+  CompressedGraphTopology() = default;
+  CompressedGraphTopology(CompressedGraphTopology&&) = default;
+  CompressedGraphTopology& operator=(CompressedGraphTopology&&) = default;
+
+  CompressedGraphTopology(const CompressedGraphTopology&) = delete;
+  CompressedGraphTopology& operator=(const CompressedGraphTopology&) = delete;
+
+  /// Copy a compressed topology from the arrays of a compressed topology
+  /// file. The arrays are not checked; call Validate() before reading
+  /// destinations with dests() or edge_dest() if they may be corrupt.
+  CompressedGraphTopology(
+      const Edge* adj_indices, size_t num_nodes, size_t num_edges,
+      uint64_t edges_per_block, const uint64_t* block_offsets,
+      size_t num_blocks, const uint8_t* payload, size_t payload_size) noexcept;
+
+  /// Encode \p topology. Encoding is done in parallel over blocks.
+  static CompressedGraphTopology Make(
+      const GraphTopology& topology,
+      uint64_t edges_per_block = kDefaultEdgesPerBlock) noexcept;
+
+  /// Decode every destination into an ordinary GraphTopology.
+  ///
+  /// \returns an error if the encoded data is inconsistent, e.g., because the
+  ///     file it was read from is corrupt
+  Result<GraphTopology> Decompress() const;
+
+  /// Check, in parallel, that the adjacency indices and block offsets are
+  /// nondecreasing and consistent with the sizes and that every encoded
+  /// destination decodes to a node, without materializing the destinations.
+  /// dests() and edge_dest() do not check what they decode.
+  ///
+  /// \returns an error if the encoded data is inconsistent
+  Result<void> Validate() const;
+
+  uint64_t num_nodes() const noexcept { return adj_indices_.size(); }
+
+  uint64_t num_edges() const noexcept { return num_edges_; }
+
+  uint64_t edges_per_block() const noexcept { return edges_per_block_; }
+
+  uint64_t num_blocks() const noexcept {
+    return block_offsets_.empty() ? 0 : block_offsets_.size() - 1;
+  }
+
+  const Edge* adj_data() const noexcept { return adj_indices_.data(); }
+
+  /// num_blocks() + 1 byte offsets into the payload
+  const uint64_t* block_offset_data() const noexcept {
+    return block_offsets_.data();
+  }
+
+  const uint8_t* payload_data() const noexcept { return payload_.data(); }
+
+  uint64_t payload_size() const noexcept { return payload_.size(); }
+
+  edges_range edges(Node node) const noexcept {
+    KATANA_LOG_DEBUG_ASSERT(node < adj_indices_.size());
+    edge_iterator e_beg{node > 0 ? adj_indices_[node - 1] : 0};
+    edge_iterator e_end{adj_indices_[node]};
+
+    return MakeStandardRange(e_beg, e_end);
+  }
+
+  size_t degree(Node node) const noexcept { return edges(node).size(); }
+
+  nodes_range all_nodes() const noexcept {
+    return MakeStandardRange<node_iterator>(
+        Node{0}, static_cast<Node>(num_nodes()));
+  }
+
+  /// The destinations of the out edges of \p node in edge ID order. Only the
+  /// block containing the first edge of \p node is partially scanned.
+  dests_range dests(Node node) const noexcept;
+
+  /// The destination of a single edge. This decodes from the start of the
+  /// edge's block, so prefer dests() when visiting every edge of a node.
+  Node edge_dest(Edge edge_id) const noexcept;
+
+private:
+  Node FirstSourceOfBlock(uint64_t block) const noexcept;
+
+  /// Validate the topology while calling fn(edge, dest) on each decoded
+  /// destination; see Validate()
+  template <typename Fn>
+  Result<void> DecodeChecked(const Fn& fn) const;
+
+  NUMAArray<Edge> adj_indices_;
+  NUMAArray<uint64_t> block_offsets_;
+  NUMAArray<uint8_t> payload_;
+  uint64_t num_edges_{0};
+  uint64_t edges_per_block_{kDefaultEdgesPerBlock};
+};
+
+inline void
+CompressedGraphTopology::DestIterator::Decode() noexcept {
+  uint64_t raw;
+  pos_ = internal::ReadVarint(pos_, &raw);
+  bool rebase = edge_ == node_begin_ || edge_ % edges_per_block_ == 0;
+  int64_t base = rebase ? src_ : dest_;
+  dest_ = static_cast<Node>(base + internal::ZigZagDecode(raw));
+}
+
+}  // namespace katana
+
+#endif
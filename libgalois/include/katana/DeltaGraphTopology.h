@@ -0,0 +1,212 @@
+#ifndef KATANA_LIBGALOIS_KATANA_DELTAGRAPHTOPOLOGY_H_
+#define KATANA_LIBGALOIS_KATANA_DELTAGRAPHTOPOLOGY_H_
+
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+#include "katana/DynamicBitset.h"
+#include "katana/GraphTopology.h"
+#include "katana/Iterators.h"
+#include "katana/Logging.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// A GraphTopology with a mutable overlay for a stream of edge inserts and
+/// deletes.
+///
+/// Deleted edges of the base CSR are marked in a tombstone bitset and
+/// inserted edges are appended to per-node buffers, so updates are visible
+/// immediately without rebuilding the CSR. Compact() folds the overlay into a
+/// fresh CSR in parallel once it grows past a fraction of the base (see
+/// NeedsCompaction()).
+///
+/// Edge IDs of base edges are their IDs in the base CSR; inserted edges get
+/// IDs starting at base().num_edges() in insertion order. IDs of deleted
+/// edges are never reused, and all IDs change when the topology is compacted.
+///
+/// Updates must not run concurrently with each other or with reads; reads
+/// may run concurrently with each other.
+class KATANA_EXPORT DeltaGraphTopology : public GraphTopologyTypes {
+public:
+  /// Compact once the overlay holds this fraction of the base edges
+  static constexpr double kDefaultCompactionRatio = 0.1;
+
+  /// Forward iterator over the live out edges of one node: the base edges
+  /// that are not deleted, then the inserted ones.
+  class EdgeIterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Edge;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const Edge*;
+    using reference = Edge;
+
+    EdgeIterator() = default;
+
+    Edge operator*() const noexcept {
+      return base_pos_ < base_end_ ? base_pos_ : (*inserted_)[inserted_pos_];
+    }
+
+    EdgeIterator& operator++() noexcept {
+      if (base_pos_ < base_end_) {
+        ++base_pos_;
+        SkipDeleted();
+      } else {
+        ++inserted_pos_;
+      }
+      return *this;
+    }
+
+    EdgeIterator operator++(int) noexcept {
+      EdgeIterator tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    bool operator==(const EdgeIterator& that) const noexcept {
+      return base_pos_ == that.base_pos_ &&
+             inserted_pos_ == that.inserted_pos_;
+    }
+    bool operator!=(const EdgeIterator& that) const noexcept {
+      return !(*this == that);
+    }
+
+  private:
+    friend class DeltaGraphTopology;
+
+    EdgeIterator(
+        const DynamicBitset* deleted, const std::vector<Edge>* inserted,
+        Edge base_pos, Edge base_end, size_t inserted_pos) noexcept
+        : deleted_(deleted),
+          inserted_(inserted),
+          base_pos_(base_pos),
+          base_end_(base_end),
+          inserted_pos_(inserted_pos) {
+      SkipDeleted();
+    }
+
+    void SkipDeleted() noexcept {
+      while (base_pos_ < base_end_ && deleted_->test(base_pos_)) {
+        ++base_pos_;
+      }
+    }
+
+    const DynamicBitset* deleted_{nullptr};
+    const std::vector<Edge>* inserted_{nullptr};
+    Edge base_pos_{0};
+    Edge base_end_{0};
+    size_t inserted_pos_{0};
+  };
+
+  using delta_edges_range = StandardRange<EdgeIterator>;
+
+  DeltaGraphTopology() = default;
+  DeltaGraphTopology(DeltaGraphTopology&&) = default;
+  DeltaGraphTopology& operator=(DeltaGraphTopology&&) = default;
+
+  DeltaGraphTopology(const DeltaGraphTopology&) = delete;
+  DeltaGraphTopology& operator=(const DeltaGraphTopology&) = delete;
+
+  explicit DeltaGraphTopology(GraphTopology&& base) noexcept;
+
+  const GraphTopology& base() const noexcept { return base_; }
+
+  uint64_t num_nodes() const noexcept { return inserted_.size(); }
+
+  /// The number of live edges
+  uint64_t num_edges() const noexcept { return num_edges_; }
+
+  /// The number of deleted base edges plus the number of edges ever
+  /// inserted since the last compaction
+  uint64_t delta_size() const noexcept {
+    return num_deleted_ + inserted_dests_.size();
+  }
+
+  nodes_range all_nodes() const noexcept {
+    return MakeStandardRange<node_iterator>(
+        Node{0}, static_cast<Node>(num_nodes()));
+  }
+
+  node_iterator begin() const noexcept { return node_iterator(0); }
+
+  node_iterator end() const noexcept { return node_iterator(num_nodes()); }
+
+  delta_edges_range edges(Node node) const noexcept {
+    KATANA_LOG_DEBUG_ASSERT(node < num_nodes());
+    Edge base_begin = 0;
+    Edge base_end = 0;
+    if (node < base_.num_nodes()) {
+      auto base_edges = base_.edges(node);
+      base_begin = *base_edges.begin();
+      base_end = *base_edges.end();
+    }
+    const std::vector<Edge>* inserted = &inserted_[node];
+    return MakeStandardRange(
+        EdgeIterator(&deleted_, inserted, base_begin, base_end, 0),
+        EdgeIterator(
+            &deleted_, inserted, base_end, base_end, inserted->size()));
+  }
+
+  /// Alias of edges() for code written against the out edge naming
+  delta_edges_range OutEdges(Node node) const noexcept { return edges(node); }
+
+  Node edge_dest(Edge edge_id) const noexcept {
+    if (edge_id < base_.num_edges()) {
+      return base_.edge_dest(edge_id);
+    }
+    KATANA_LOG_DEBUG_ASSERT(
+        edge_id - base_.num_edges() < inserted_dests_.size());
+    return inserted_dests_[edge_id - base_.num_edges()];
+  }
+
+  /// The number of live out edges of \p node; linear in the base degree
+  size_t degree(Node node) const noexcept;
+
+  /// Add \p count nodes without edges. Their IDs follow the existing nodes.
+  void AddNodes(uint64_t count);
+
+  /// Insert an edge from \p src to \p dst. Parallel edges are allowed.
+  ///
+  /// \returns the ID of the new edge
+  Result<Edge> InsertEdge(Node src, Node dst);
+
+  /// Delete one edge from \p src to \p dst. Inserted edges are preferred to
+  /// base edges so that fewer tombstones need compacting.
+  ///
+  /// \returns ErrorCode::NotFound if there is no such edge
+  Result<void> DeleteEdge(Node src, Node dst);
+
+  /// \returns true if the overlay is large enough relative to the base that
+  /// iteration would be noticeably faster after Compact()
+  bool NeedsCompaction(
+      double ratio = kDefaultCompactionRatio) const noexcept {
+    return delta_size() > ratio * base_.num_edges();
+  }
+
+  /// Build a CSR of the live edges in parallel. Each node's base edges come
+  /// first, in base order, followed by its inserted edges in insertion order.
+  ///
+  /// \param old_edge_ids if not null, filled with the ID in this topology of
+  ///     each edge of the result, e.g., to carry edge properties over
+  GraphTopology Materialize(PropIndexVec* old_edge_ids = nullptr) const;
+
+  /// Replace the base with Materialize() and clear the overlay
+  void Compact(PropIndexVec* old_edge_ids = nullptr);
+
+private:
+  GraphTopology base_;
+  DynamicBitset deleted_;
+  // The IDs of the inserted edges of each node
+  std::vector<std::vector<Edge>> inserted_;
+  // The destination of each inserted edge, indexed by ID - base_.num_edges()
+  std::vector<Node> inserted_dests_;
+  uint64_t num_edges_{0};
+  uint64_t num_deleted_{0};
+};
+
+}  // namespace katana
+
+#endif
@@ -271,6 +271,15 @@ public:
   // assumes bit_vector is not updated (set) in parallel
   void bitwise_or(const DynamicBitset& other);
 
+  /**
+   * Does an IN-PLACE bitwise or of 2 passed in bitsets and saves to this
+   * bitset
+   *
+   * @param other1 Bitset to or with other 2
+   * @param other2 Bitset to or with other 1
+   */
+  void bitwise_or(const DynamicBitset& other1, const DynamicBitset& other2);
+
   // assumes bit_vector is not updated (set) in parallel
   void bitwise_not();
 
@@ -292,6 +301,24 @@ public:
    */
   void bitwise_and(const DynamicBitset& other1, const DynamicBitset& other2);
 
+  /**
+   * Does an IN-PLACE bitwise and of this bitset and the complement of
+   * another bitset, i.e., clears the bits that are set in other
+   *
+   * @param other Bitset whose set bits are cleared from this bitset
+   */
+  void bitwise_and_not(const DynamicBitset& other);
+
+  /**
+   * Saves other1 and the complement of other2 to this bitset, e.g., the
+   * nodes of a frontier that have not been visited
+   *
+   * @param other1 Bitset to and with the complement of other 2
+   * @param other2 Bitset whose complement is and-ed with other 1
+   */
+  void bitwise_and_not(
+      const DynamicBitset& other1, const DynamicBitset& other2);
+
   /**
    * Does an IN-PLACE bitwise xor of this bitset and another bitset
    *
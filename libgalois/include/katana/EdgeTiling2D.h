@@ -0,0 +1,113 @@
+#ifndef KATANA_LIBGALOIS_KATANA_EDGETILING2D_H_
+#define KATANA_LIBGALOIS_KATANA_EDGETILING2D_H_
+
+#include <cstdint>
+
+#include "katana/GraphTopology.h"
+#include "katana/Loops.h"
+#include "katana/NUMAArray.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// The edges of a topology grouped into 2D tiles of the adjacency matrix, a
+/// range of sources by a range of destinations, for edge-centric loops over
+/// graphs whose node state does not fit in cache, e.g., push-style PageRank
+/// or label propagation.
+///
+/// A tile is sized so that the state of its sources and destinations fits in
+/// a cache, by default the L2 cache. Tiles are stored and visited in the
+/// order of a Hilbert curve over the grid of tiles: consecutive tiles share
+/// their source or destination range, so the destination state updated by a
+/// thread stays in cache from one tile to the next, and since each thread
+/// starts on a contiguous run of the curve, threads mostly work on different
+/// parts of the matrix.
+///
+/// Unlike Fixed2DGraphTiledExecutor, tiles are not locked against each other:
+/// tiles with the same destinations may run at once, so the operator must
+/// update destination state atomically.
+///
+/// The edges are copied as (source, destination) pairs, 8 bytes per edge,
+/// once; the tiling is then reused by every round of an algorithm.
+class KATANA_EXPORT EdgeTiling2D {
+public:
+  using Node = GraphTopologyTypes::Node;
+
+  struct Options {
+    /// Bytes of state read per source node, e.g., its contribution
+    size_t bytes_per_source{sizeof(float)};
+    /// Bytes of state updated per destination node, e.g., its rank sum
+    size_t bytes_per_dest{sizeof(float)};
+    /// The cache the state of a tile should fit in, or 0 for the size of
+    /// the L2 cache of the machine
+    size_t cache_bytes{0};
+  };
+
+  /// A tile: the edges [edge_begin, edge_end) of the tiling, from sources in
+  /// [src_begin, src_end) to destinations in [dest_begin, dest_end)
+  struct Tile {
+    uint64_t edge_begin;
+    uint64_t edge_end;
+    Node src_begin;
+    Node src_end;
+    Node dest_begin;
+    Node dest_end;
+  };
+
+  EdgeTiling2D() = default;
+  EdgeTiling2D(EdgeTiling2D&&) = default;
+  EdgeTiling2D& operator=(EdgeTiling2D&&) = default;
+  EdgeTiling2D(const EdgeTiling2D&) = delete;
+  EdgeTiling2D& operator=(const EdgeTiling2D&) = delete;
+
+  /// Tile the edges of topology with tiles sized for opts
+  static Result<EdgeTiling2D> Make(
+      const GraphTopology& topology, const Options& opts = Options());
+
+  /// Tile the edges of topology with tiles of src_nodes sources by
+  /// dest_nodes destinations
+  static Result<EdgeTiling2D> Make(
+      const GraphTopology& topology, uint64_t src_nodes, uint64_t dest_nodes);
+
+  /// The size of the L2 cache of the machine, or an estimate if it is
+  /// unknown
+  static size_t L2CacheBytes();
+
+  uint64_t num_edges() const noexcept { return srcs_.size(); }
+  uint64_t num_tiles() const noexcept { return tiles_.size(); }
+  uint64_t src_nodes_per_tile() const noexcept { return src_nodes_; }
+  uint64_t dest_nodes_per_tile() const noexcept { return dest_nodes_; }
+
+  /// The i-th tile in Hilbert order
+  const Tile& tile(uint64_t i) const noexcept { return tiles_[i]; }
+
+  Node edge_src(uint64_t e) const noexcept { return srcs_[e]; }
+  Node edge_dest(uint64_t e) const noexcept { return dests_[e]; }
+
+  /// Call fn(src, dest) for every edge, in parallel over the tiles
+  template <typename Fn>
+  void ForEachEdge(const Fn& fn, const char* loopname = "EdgeTiling2D") const {
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_tiles()),
+        [&](uint64_t t) {
+          const Tile& tile = tiles_[t];
+          for (uint64_t e = tile.edge_begin; e < tile.edge_end; ++e) {
+            fn(srcs_[e], dests_[e]);
+          }
+        },
+        katana::steal(), katana::chunk_size<1>(), katana::no_stats(),
+        katana::loopname(loopname));
+  }
+
+private:
+  NUMAArray<Tile> tiles_;
+  NUMAArray<Node> srcs_;
+  NUMAArray<Node> dests_;
+  uint64_t src_nodes_{0};
+  uint64_t dest_nodes_{0};
+};
+
+}  // namespace katana
+
+#endif
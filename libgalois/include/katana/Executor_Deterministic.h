@@ -45,7 +45,6 @@
 #include "katana/gIO.h"
 #include "katana/gslist.h"
 
-// TODO deterministic hash
 // TODO deterministic hash: only give ids to window
 // TODO detect and fail if using releasable objects
 // TODO fixed neighborhood: cyclic scheduling
@@ -91,6 +90,27 @@ template <typename OptionsTy>
 using DItem =
     DItemBase<typename OptionsTy::value_type, OptionsTy::useLocalState>;
 
+//! True if the item with id lhs wins conflicts against the item with id rhs.
+//! With HashPriority, ids are compared after a bijective mix of their bits
+//! (the MurmurHash3 finalizer), which keeps the order total and fixed but
+//! unrelated to the order in which ids were assigned.
+template <bool HashPriority>
+inline bool
+DetHasPriority(unsigned long lhs, unsigned long rhs) {
+  if (!HashPriority) {
+    return lhs < rhs;
+  }
+  auto mix = [](uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+  };
+  return mix(lhs) < mix(rhs);
+}
+
 class KATANA_EXPORT FirstPassBase : public SimpleRuntimeContext {
 protected:
   bool firstPassFlag;
@@ -143,7 +163,8 @@ public:
       if (other == this)
         return;
       if (other) {
-        bool conflict = other->item.id < this->item.id;
+        bool conflict = DetHasPriority<OptionsTy::hashPriority>(
+            other->item.id, this->item.id);
         if (conflict) {
           // A lock that I want but can't get
           notReady = true;
@@ -220,7 +241,8 @@ private:
       if (other == this || other == &readerCtx)
         return;
       if (other) {
-        bool conflict = other->id < this->id;
+        bool conflict =
+            DetHasPriority<OptionsTy::hashPriority>(other->id, this->id);
         if (conflict) {
           if (other->isWriter)
             readerCtx.notReady = true;
@@ -249,7 +271,8 @@ private:
       if (other == this || other == &readerCtx)
         return;
       if (other) {
-        bool conflict = other->id < this->id;
+        bool conflict =
+            DetHasPriority<OptionsTy::hashPriority>(other->id, this->id);
         if (conflict) {
           // A lock that I want but can't get
           this->notReady = true;
@@ -313,7 +336,7 @@ public:
       // id
       if (a->item.id == b->item.id)
         return a < b;
-      return a->item.id < b->item.id;
+      return DetHasPriority<OptionsTy::hashPriority>(a->item.id, b->item.id);
     }
   };
 
@@ -470,6 +493,8 @@ struct OptionsCommon {
 
   constexpr static bool hasBreak = has_trait<det_parallel_break_tag, ArgsTy>();
   constexpr static bool hasID = has_trait<det_id_tag, ArgsTy>();
+  constexpr static bool hashPriority =
+      has_trait<det_hash_priority_tag, ArgsTy>();
 
   constexpr static bool useLocalState = has_trait<local_state_tag, ArgsTy>();
   constexpr static bool hasFixedNeighborhood =
@@ -1495,6 +1520,9 @@ Executor<OptionsTy>::go() {
     } else {
       this->calculateWindow(false);
 
+      // Other threads read the counters that nextWindow resets
+      barrier.Wait();
+
       this->pushNextWindow(tld.wlnext, local.nextWindow());
     }
   }
@@ -1686,6 +1714,10 @@ Executor<OptionsTy>::commitLoop(ThreadLocalData& tld) {
 
 /**
  * Deterministic execution. Operator should be cautious.
+ *
+ * Conflicts are won by the element with the smaller id; with the
+ * katana::det_hash_priority trait, by the smaller hash of the id, which
+ * usually needs far fewer rounds when neighboring elements have nearby ids.
  */
 template <typename T = int>
 struct Deterministic {
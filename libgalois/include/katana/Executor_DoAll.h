@@ -22,13 +22,20 @@
 
 #include "katana/Barrier.h"
 #include "katana/CompilerSpecific.h"
+#include "katana/EventRecorder.h"
 #include "katana/Executor_OnEach.h"
+#include "katana/LoopBalance.h"
+#include "katana/LoopCounters.h"
+#include "katana/LoopStatistics.h"
 #include "katana/OperatorReferenceTypes.h"
 #include "katana/PaddedLock.h"
+#include "katana/ParallelismProfile.h"
 #include "katana/PerThreadStorage.h"
+#include "katana/Range.h"
 #include "katana/Statistics.h"
 #include "katana/TerminationDetection.h"
 #include "katana/ThreadPool.h"
+#include "katana/Threads.h"
 #include "katana/Timer.h"
 #include "katana/config.h"
 #include "katana/gIO.h"
@@ -44,6 +51,8 @@ class DoAllStealingExec {
 
   enum StealAmt { HALF, FULL };
 
+  enum VictimScope { SAME_NUMA_NODE, SAME_SOCKET, REMOTE, NUM_SCOPES };
+
   constexpr static const bool NEED_STATS =
       katana::internal::NeedStats<ArgsTuple>::value;
   constexpr static const bool MORE_STATS =
@@ -58,8 +67,11 @@ class DoAllStealingExec {
     Iter shared_end;
     Diff_ty m_size;
     size_t num_iter;
+    size_t num_chunks{0};
 
-    // Stats
+    // Stats, indexed by VictimScope
+    size_t steal_attempts[NUM_SCOPES] = {};
+    size_t steals[NUM_SCOPES] = {};
 
     ThreadContext()
         : work_mutex(),
@@ -89,12 +101,14 @@ class DoAllStealingExec {
       while (getWork(beg, end, chunk_size)) {
         didwork = true;
 
+        // Counted regardless of stats for the ParallelismProfile
         for (; beg != end; ++beg) {
-          if (NEED_STATS) {
-            ++num_iter;
-          }
+          ++num_iter;
           func(*beg);
         }
+        if (NEED_STATS) {
+          ++num_chunks;
+        }
       }
 
       return didwork;
@@ -259,64 +273,49 @@ private:
     return succ;
   }
 
-  KATANA_ATTRIBUTE_NOINLINE bool stealWithinSocket(ThreadContext& poor) {
-    bool sawWork = false;
-    bool stoleWork = false;
-
+  /// Whether \p victim shares a NUMA node with \p poor, shares only a
+  /// socket, or is on another socket. Victims are tried in this order so that
+  /// stolen ranges of NUMA blocked arrays stay close to the thief.
+  VictimScope victimScope(const ThreadContext& poor, unsigned victim) const {
     auto& tp = GetThreadPool();
-
-    const unsigned maxT = katana::getActiveThreads();
-    const unsigned my_pack = ThreadPool::getSocket();
-    const unsigned per_pack = tp.getMaxThreads() / tp.getMaxSockets();
-
-    const unsigned pack_beg = my_pack * per_pack;
-    const unsigned pack_end = (my_pack + 1) * per_pack;
-
-    for (unsigned i = 1; i < pack_end; ++i) {
-      // go around the socket in circle starting from the next thread
-      unsigned t = (poor.id + i) % per_pack + pack_beg;
-      KATANA_LOG_DEBUG_ASSERT((t >= pack_beg) && (t < pack_end));
-
-      if (t < maxT) {
-        if (workers.getRemote(t)->hasWorkWeak()) {
-          sawWork = true;
-
-          stoleWork = transferWork(*workers.getRemote(t), poor, HALF);
-
-          if (stoleWork) {
-            break;
-          }
-        }
-      }
+    if (tp.getSocket(victim) != tp.getSocket(poor.id)) {
+      return REMOTE;
     }
-
-    return sawWork || stoleWork;
+    if (tp.getNumaNode(victim) != tp.getNumaNode(poor.id)) {
+      return SAME_SOCKET;
+    }
+    return SAME_NUMA_NODE;
   }
 
-  KATANA_ATTRIBUTE_NOINLINE bool stealOutsideSocket(
-      ThreadContext& poor, const StealAmt& amt) {
+  /// Try to steal from the threads in \p scope, going around the active
+  /// threads in a circle starting from the one after \p poor
+  KATANA_ATTRIBUTE_NOINLINE bool stealFromScope(
+      ThreadContext& poor, VictimScope scope, StealAmt amt) {
     bool sawWork = false;
     bool stoleWork = false;
 
-    auto& tp = GetThreadPool();
-    unsigned myPkg = ThreadPool::getSocket();
-    // unsigned maxT = LL::getMaxThreads ();
-    unsigned maxT = katana::getActiveThreads();
+    const unsigned maxT = katana::getActiveThreads();
 
-    for (unsigned i = 0; i < maxT; ++i) {
-      ThreadContext& rich = *(workers.getRemote((poor.id + i) % maxT));
+    for (unsigned i = 1; i < maxT; ++i) {
+      unsigned t = (poor.id + i) % maxT;
+      ThreadContext& rich = *(workers.getRemote(t));
 
-      if (tp.getSocket(rich.id) != myPkg) {
-        if (rich.hasWorkWeak()) {
-          sawWork = true;
+      if (!rich.hasWorkWeak() || victimScope(poor, t) != scope) {
+        continue;
+      }
 
-          stoleWork = transferWork(rich, poor, amt);
-          // stoleWork = transferWork (rich, poor, HALF);
+      sawWork = true;
+      if (NEED_STATS) {
+        ++poor.steal_attempts[scope];
+      }
 
-          if (stoleWork) {
-            break;
-          }
+      stoleWork = transferWork(rich, poor, amt);
+
+      if (stoleWork) {
+        if (NEED_STATS) {
+          ++poor.steals[scope];
         }
+        break;
       }
     }
 
@@ -324,32 +323,33 @@ private:
   }
 
   KATANA_ATTRIBUTE_NOINLINE bool trySteal(ThreadContext& poor) {
-    bool ret = false;
-
-    ret = stealWithinSocket(poor);
+    if (stealFromScope(poor, SAME_NUMA_NODE, HALF)) {
+      return true;
+    }
 
-    if (ret) {
+    if (stealFromScope(poor, SAME_SOCKET, HALF)) {
       return true;
     }
 
     asmPause();
 
-    if (GetThreadPool().isLeader(poor.id)) {
-      ret = stealOutsideSocket(poor, HALF);
-
-      if (ret) {
+    // Socket leaders go remote first and the rest of the socket can then
+    // steal what they brought back; check the socket once more before
+    // crossing the interconnect ourselves
+    if (!GetThreadPool().isLeader(poor.id)) {
+      if (stealFromScope(poor, SAME_NUMA_NODE, HALF) ||
+          stealFromScope(poor, SAME_SOCKET, HALF)) {
         return true;
       }
       asmPause();
     }
 
-    ret = stealOutsideSocket(poor, HALF);
-    if (ret) {
+    if (stealFromScope(poor, REMOTE, HALF)) {
       return true;
     }
     asmPause();
 
-    return ret;
+    return false;
   }
 
 private:
@@ -367,6 +367,7 @@ private:
   PerThreadTimer<MORE_STATS> execTime;
   PerThreadTimer<MORE_STATS> stealTime;
   PerThreadTimer<MORE_STATS> termTime;
+  CondLoopBalance<NEED_STATS> balance;
 
 public:
   DoAllStealingExec(const R& _range, F _func, const ArgsTuple& argsTuple)
@@ -379,7 +380,8 @@ public:
         initTime(loopname, "Init"),
         execTime(loopname, "Execute"),
         stealTime(loopname, "Steal"),
-        termTime(loopname, "Term") {
+        termTime(loopname, "Term"),
+        balance(loopname) {
     KATANA_LOG_DEBUG_ASSERT(chunk_size > 0);
   }
 
@@ -409,19 +411,26 @@ public:
     // printStats ();
   }
 
+  // executed serially after the loop
+  void reportBalance() { balance.Report(); }
+
   void operator()(void) {
     ThreadContext& ctx = *workers.getLocal();
+    EventScope event(EventRecorder::kLoop, loopname);
     totalTime.start();
+    balance.BeginThread();
 
     while (true) {
       bool workHappened = false;
 
       execTime.start();
+      uint64_t busy_start = balance.StartBusy();
 
       if (ctx.doWork(func, chunk_size)) {
         workHappened = true;
       }
 
+      balance.StopBusy(busy_start, workHappened);
       execTime.stop();
 
       KATANA_LOG_DEBUG_ASSERT(!ctx.hasWork());
@@ -453,9 +462,25 @@ public:
 
     totalTime.stop();
     KATANA_LOG_DEBUG_ASSERT(!ctx.hasWork());
+    ParallelismProfile::AddWork(ctx.num_iter);
 
     if (NEED_STATS) {
       katana::ReportStatSum(loopname, "Iterations", ctx.num_iter);
+
+      size_t steal_attempts = 0;
+      size_t steals = 0;
+      const char* const scope_names[NUM_SCOPES] = {
+          "NumaNode", "Socket", "Remote"};
+      for (unsigned s = 0; s < NUM_SCOPES; ++s) {
+        steal_attempts += ctx.steal_attempts[s];
+        steals += ctx.steals[s];
+        katana::ReportStatSum(
+            loopname, std::string("Steals") + scope_names[s], ctx.steals[s]);
+        katana::ReportStatSum(
+            loopname, std::string("FailedSteals") + scope_names[s],
+            ctx.steal_attempts[s] - ctx.steals[s]);
+      }
+      balance.EndThread(ctx.num_chunks, steal_attempts, steals);
     }
   }
 };
@@ -469,10 +494,17 @@ struct ChooseDoAllImpl {
         exec(range, std::forward<F>(func), argsTuple);
 
     Barrier& barrier = GetBarrier(activeThreads);
+    const char* loopname = katana::internal::getLoopName(argsTuple);
 
     GetThreadPool().run(
         activeThreads, [&exec]() { exec.initThread(); },
-        [&barrier]() { barrier.Wait(); }, std::ref(exec));
+        [&barrier, loopname]() {
+          EventScope event(EventRecorder::kBarrier, loopname);
+          barrier.Wait();
+        },
+        std::ref(exec));
+
+    exec.reportBalance();
   }
 };
 
@@ -488,6 +520,7 @@ struct ChooseDoAllImpl<false> {
               NEED_STATS && has_trait<more_stats_tag, ArgsT>();
 
           const char* const loopname = katana::internal::getLoopName(argsTuple);
+          EventScope event(EventRecorder::kLoop, loopname);
 
           PerThreadTimer<MORE_STATS> totalTime(loopname, "Total");
           PerThreadTimer<MORE_STATS> initTime(loopname, "Init");
@@ -507,13 +540,12 @@ struct ChooseDoAllImpl<false> {
 
           while (begin != end) {
             func(*begin++);
-            if (NEED_STATS) {
-              ++iter;
-            }
+            ++iter;
           }
           execTime.stop();
 
           totalTime.stop();
+          ParallelismProfile::AddWork(iter);
 
           if (NEED_STATS) {
             katana::ReportStatSum(loopname, "Iterations", iter);
@@ -546,9 +578,27 @@ do_all_gen(const R& range, F&& func, const ArgsTuple& argsTuple) {
 
   constexpr bool STEAL = has_trait<steal_tag, ArgsT>();
 
+  unsigned threads = activeThreads;
+  if constexpr (has_trait<auto_threads_tag, ArgsT>()) {
+    threads = internal::ThreadsForRange(
+        range, get_trait_value<auto_threads_tag>(argsT).value);
+  }
+  internal::ScopedActiveThreads scoped_threads(threads);
+  if constexpr (has_trait<auto_threads_tag, ArgsT>()) {
+    LoopStatistics<internal::NeedStats<ArgsT>::value>::ReportThreads(
+        internal::getLoopName(argsT), activeThreads);
+  }
+
+  CondLoopCounters<TIME_IT> counters(katana::internal::getLoopName(argsT));
+  CondParallelismRound<TIME_IT> round(katana::internal::getLoopName(argsT));
+  counters.start();
+  round.start();
+
   OperatorReferenceType<decltype(std::forward<F>(func))> func_ref = func;
   internal::ChooseDoAllImpl<STEAL>::call(range, func_ref, argsT);
 
+  round.stop();
+  counters.stop();
   timer.stop();
 }
 
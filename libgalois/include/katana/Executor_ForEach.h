@@ -28,6 +28,9 @@
 #include "katana/Barrier.h"
 #include "katana/Chunk.h"
 #include "katana/Context.h"
+#include "katana/EventRecorder.h"
+#include "katana/LoopBalance.h"
+#include "katana/LoopCounters.h"
 #include "katana/LoopStatistics.h"
 #include "katana/Mem.h"
 #include "katana/OperatorReferenceTypes.h"
@@ -152,6 +155,8 @@ public:
   static constexpr bool needsBreak = has_trait<parallel_break_tag, ArgsTy>();
   static constexpr bool MORE_STATS =
       needStats && has_trait<more_stats_tag, ArgsTy>();
+  //! Worklist pops and pushes between counter events of a thread
+  static constexpr uint64_t kEventSampleInterval = 1024;
 
 protected:
   typedef typename WorkListTy::value_type value_type;
@@ -160,6 +165,8 @@ protected:
     UserContextAccess<value_type> facing;
     FunctionTy function;
     SimpleRuntimeContext ctx;
+    uint64_t event_pops{0};
+    uint64_t event_pushes{0};
 
     explicit ThreadLocalBasics(FunctionTy fn) : facing(), function(fn), ctx() {}
   };
@@ -193,6 +200,7 @@ protected:
 
   PerThreadTimer<MORE_STATS> initTime;
   PerThreadTimer<MORE_STATS> execTime;
+  CondLoopBalance<needStats> balance;
 
   inline void commitIteration(ThreadLocalData& tld) {
     if (needsPush) {
@@ -202,6 +210,13 @@ protected:
       auto n = pb.size();
       if (n) {
         tld.inc_pushes(n);
+        if ((tld.event_pushes + n) / kEventSampleInterval !=
+            tld.event_pushes / kEventSampleInterval) {
+          EventRecorder::Record(
+              EventRecorder::kWorklist, EventRecorder::kCounter, "pushes",
+              tld.event_pushes + n);
+        }
+        tld.event_pushes += n;
         wl.push(pb.begin(), pb.end());
         pb.clear();
       }
@@ -233,6 +248,11 @@ protected:
       tld.ctx.startIteration();
 
     tld.inc_iterations();
+    if (++tld.event_pops % kEventSampleInterval == 0) {
+      EventRecorder::Record(
+          EventRecorder::kWorklist, EventRecorder::kCounter, "pops",
+          tld.event_pops);
+    }
     tld.function(val, tld.facing.data());
     commitIteration(tld);
   }
@@ -297,9 +317,19 @@ protected:
     return wl.empty();
   }
 
+  void endBalance(WorkListTy&, ...) { balance.EndThread(0, 0, 0); }
+
+  template <typename WL>
+  auto endBalance(WL& wl, int) -> decltype(wl.TakeChunkStats(), void()) {
+    auto stats = wl.TakeChunkStats();
+    balance.EndThread(stats.chunks, stats.steal_attempts, stats.steals);
+  }
+
   template <bool couldAbort, bool isLeader>
   void go() {
+    EventScope event(EventRecorder::kLoop, loopname);
     execTime.start();
+    balance.BeginThread();
 
     // Thread-local data goes on the local stack to be NUMA friendly
     ThreadLocalData tld(origFunction, loopname);
@@ -314,6 +344,7 @@ protected:
     while (true) {
       do {
         bool didWork = false;
+        uint64_t busy_start = balance.StartBusy();
 
         // Run some iterations
         if (couldAbort || needsBreak) {
@@ -329,6 +360,7 @@ protected:
           bool b = runQueueSimple(tld);
           didWork = b || didWork;
         }
+        balance.StopBusy(busy_start, didWork);
 
         // Update node color and prop token
         term.SignalWorked(didWork);
@@ -346,9 +378,14 @@ protected:
       }
 
       term.InitializeThread();
+      EventScope barrier_event(EventRecorder::kBarrier, loopname);
       barrier.Wait();
     }
 
+    if (needStats) {
+      endBalance(wl, 0);
+    }
+
     if (couldAbort)
       setThreadContext(0);
   }
@@ -365,7 +402,8 @@ protected:
         loopname(katana::internal::getLoopName(args)),
         broke(false),
         initTime(loopname, "Init"),
-        execTime(loopname, "Execute") {}
+        execTime(loopname, "Execute"),
+        balance(loopname) {}
 
   template <typename WArgsTy, size_t... Is>
   ForEachExecutor(
@@ -399,6 +437,9 @@ public:
     initTime.stop();
   }
 
+  // executed serially after the loop
+  void reportBalance() { balance.Report(); }
+
   void operator()() {
     bool isLeader = ThreadPool::isLeader();
     bool couldAbort = needsAborts && activeThreads > 1;
@@ -451,13 +492,30 @@ for_each_impl(const RangeTy& range, FunctionTy&& fn, const ArgsTy& args) {
       OperatorReferenceType<decltype(std::forward<FunctionTy>(fn))>;
   typedef ForEachExecutor<WorkListTy, FuncRefType, ArgsTy> WorkTy;
 
+  unsigned threads = activeThreads;
+  if constexpr (has_trait<auto_threads_tag, ArgsTy>()) {
+    threads = internal::ThreadsForRange(
+        range, get_trait_value<auto_threads_tag>(args).value);
+  }
+  internal::ScopedActiveThreads scoped_threads(threads);
+  if constexpr (has_trait<auto_threads_tag, ArgsTy>()) {
+    LoopStatistics<internal::NeedStats<ArgsTy>::value>::ReportThreads(
+        internal::getLoopName(args), activeThreads);
+  }
+
   auto& barrier = GetBarrier(activeThreads);
   FuncRefType fn_ref = fn;
   WorkTy W(fn_ref, args);
   W.init(range);
+  const char* loopname = internal::getLoopName(args);
   GetThreadPool().run(
       activeThreads, [&W, &range]() { W.initThread(range); },
-      [&barrier] { barrier.Wait(); }, std::ref(W));
+      [&barrier, loopname] {
+        EventScope event(EventRecorder::kBarrier, loopname);
+        barrier.Wait();
+      },
+      std::ref(W));
+  W.reportBalance();
 }
 
 // TODO: Need to decide whether user should provide num_run tag or
@@ -481,10 +539,14 @@ for_each_gen(const RangeTy& r, FunctionTy&& fn, const TupleTy& tpl) {
   constexpr bool TIME_IT = has_trait<loopname_tag, decltype(xtpl)>();
   CondStatTimer<TIME_IT> timer(katana::internal::getLoopName(xtpl));
 
+  CondLoopCounters<TIME_IT> counters(katana::internal::getLoopName(xtpl));
+
   timer.start();
+  counters.start();
 
   for_each_impl(r, std::forward<FunctionTy>(fn), xtpl);
 
+  counters.stop();
   timer.stop();
 }
 
@@ -20,6 +20,8 @@
 #ifndef KATANA_LIBGALOIS_KATANA_EXECUTORONEACH_H_
 #define KATANA_LIBGALOIS_KATANA_EXECUTORONEACH_H_
 
+#include "katana/EventRecorder.h"
+#include "katana/LoopCounters.h"
 #include "katana/OperatorReferenceTypes.h"
 #include "katana/ThreadPool.h"
 #include "katana/ThreadTimer.h"
@@ -54,6 +56,7 @@ on_each_impl(FunctionTy&& fn, const ArgsTy& argsTuple) {
   OperatorReferenceType<decltype(std::forward<FunctionTy>(fn))> fn_ref = fn;
 
   auto runFun = [&] {
+    EventScope event(EventRecorder::kLoop, loopname);
     execTime.start();
 
     fn_ref(ThreadPool::getTID(), numT);
@@ -61,8 +64,12 @@ on_each_impl(FunctionTy&& fn, const ArgsTy& argsTuple) {
     execTime.stop();
   };
 
+  CondLoopCounters<NEEDS_STATS> counters(loopname);
+
   timer.start();
+  counters.start();
   GetThreadPool().run(numT, runFun);
+  counters.stop();
   timer.stop();
 }
 
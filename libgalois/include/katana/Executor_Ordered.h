@@ -20,20 +20,316 @@
 #ifndef KATANA_LIBGALOIS_KATANA_EXECUTORORDERED_H_
 #define KATANA_LIBGALOIS_KATANA_EXECUTORORDERED_H_
 
+#include <algorithm>
+#include <deque>
+#include <iterator>
+#include <vector>
+
+#include "katana/Context.h"
+#include "katana/Executor_Deterministic.h"
+#include "katana/Executor_DoAll.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/PriorityQueue.h"
+#include "katana/Range.h"
+#include "katana/Statistics.h"
+#include "katana/Threads.h"
+#include "katana/UserContextAccess.h"
 #include "katana/config.h"
 
 namespace katana {
 
-// TODO(ddn): Pull in and integrate in executors from exp
+namespace internal {
+
+/**
+ * Per-item context of the ordered executor. During the neighborhood pass,
+ * items race for the locks of their neighborhoods and the item with the
+ * smaller rank, i.e., the earlier one in priority order, keeps each lock. An
+ * item that loses any lock is not ready for this round.
+ */
+template <typename T>
+class OrderedContext : public FirstPassBase {
+public:
+  T item;
+  size_t rank;
+
+private:
+  bool notReady;
+
+public:
+  OrderedContext(const T& _item, size_t _rank)
+      : FirstPassBase(true), item(_item), rank(_rank), notReady(false) {}
+
+  bool isReady() { return !notReady; }
+
+  void alwaysAcquire(Lockable* lockable, katana::MethodFlag) override {
+    if (this->tryLock(lockable))
+      this->addToNhood(lockable);
+
+    OrderedContext* other;
+    do {
+      other = static_cast<OrderedContext*>(this->getOwner(lockable));
+      if (other == this)
+        return;
+      if (other && other->rank < this->rank) {
+        // An earlier item needs this lock too
+        notReady = true;
+        return;
+      }
+    } while (!this->stealByCAS(lockable, other));
+
+    // Disable loser
+    if (other) {
+      // Only need atomic write
+      other->notReady = true;
+    }
+  }
+};
+
+/**
+ * Speculative ordered executor.
+ *
+ * Each round takes a window of the earliest pending items. First, the
+ * neighborhood function of every item in the window runs in parallel under a
+ * lock-acquiring context, so conflicts between items are detected through
+ * the usual katana::MethodFlag machinery and resolved in priority order.
+ * Then every item that conflicts with no earlier item in the window, and
+ * passes the stability test if there is one, runs the operator in parallel.
+ * The remaining items are rolled back by releasing their locks and returning
+ * them to the pending set for a later round.
+ *
+ * Items pushed by the operator join the pending set when the round ends, so
+ * they run after every item that committed in the round, even the ones they
+ * precede in priority order. The commits are therefore only equivalent to
+ * running the items one after another in priority order if the algorithm
+ * has stable sources: an item pushed in a round never conflicts with a later
+ * item that commits in the same round. Otherwise, the stability test must
+ * reject every item that a new item may precede; rejected items wait for a
+ * later round, in which the earliest item always commits.
+ *
+ * Since operators are cautious, an item does not write anything before its
+ * neighborhood is locked, and rollback never needs to undo an update. The
+ * window grows while almost all of its items commit and shrinks with the
+ * abort rate otherwise.
+ */
+template <
+    typename T, typename Cmp, typename NhFunc, typename OpFunc,
+    typename StableTest, bool HasStableTest>
+class OrderedExecutor {
+  typedef OrderedContext<T> Context;
+
+  static const size_t MinWindowPerThread = 32;
+  static constexpr float TargetCommitRatio = 0.95;
+
+  //! Strict order derived from cmp, which is less than or equal
+  struct Before {
+    const Cmp& cmp;
+    explicit Before(const Cmp& c) : cmp(c) {}
+    bool operator()(const T& a, const T& b) const { return !cmp(b, a); }
+  };
+
+  struct ThreadLocalData {
+    UserContextAccess<T> facing;
+    std::vector<T> newItems;
+  };
+
+  const Cmp& cmp;
+  const NhFunc& nhFunc;
+  const OpFunc& opFunc;
+  const StableTest& stabilityTest;
+  const char* loopname;
+
+  MinHeap<T, Before> pending;
+  std::deque<Context> window;
+  std::vector<char> committed;
+  PerThreadStorage<ThreadLocalData> data;
+
+  size_t windowSize;
+  size_t minWindow;
+
+  size_t rounds = 0;
+  size_t iterations = 0;
+  size_t commits = 0;
+
+  bool isSafe(const Context& ctx) const {
+    if constexpr (HasStableTest) {
+      // The earliest pending item is always a stable source
+      return ctx.rank == 0 || stabilityTest(ctx.item);
+    } else {
+      return true;
+    }
+  }
+
+  int runOperator(ThreadLocalData& tld, Context& ctx) {
+    int result = 0;
+#ifdef KATANA_USE_LONGJMP_ABORT
+    if ((result = setjmp(execFrame)) == 0) {
+#elif defined(KATANA_USE_EXCEPTION_ABORT)
+    try {
+#endif
+      opFunc(ctx.item, tld.facing.data());
+#ifdef KATANA_USE_LONGJMP_ABORT
+    } else {
+      clearConflictLock();
+    }
+#elif defined(KATANA_USE_EXCEPTION_ABORT)
+    } catch (const ConflictFlag& flag) {
+      clearConflictLock();
+      result = flag;
+    }
+#endif
+    return result;
+  }
+
+  void neighborhoodPass() {
+    do_all_gen(
+        katana::iterate(size_t{0}, window.size()),
+        [&](size_t i) {
+          Context& ctx = window[i];
+          ctx.startIteration();
+          ctx.setFirstPass();
+          setThreadContext(&ctx);
+          nhFunc(ctx.item);
+          ctx.resetFirstPass();
+          setThreadContext(nullptr);
+        },
+        std::make_tuple(katana::steal(), katana::no_stats()));
+  }
+
+  void commitPass() {
+    do_all_gen(
+        katana::iterate(size_t{0}, window.size()),
+        [&](size_t i) {
+          Context& ctx = window[i];
+          ThreadLocalData& tld = *data.getLocal();
+          bool commit = ctx.isReady() && isSafe(ctx);
+          if (commit) {
+            setThreadContext(&ctx);
+            int result = runOperator(tld, ctx);
+            setThreadContext(nullptr);
+            switch (result) {
+            case 0:
+            case REACHED_FAILSAFE:
+              break;
+            case CONFLICT:
+              commit = false;
+              break;
+            default:
+              KATANA_LOG_FATAL("unknown conflict flag");
+              break;
+            }
+          }
+
+          if (commit) {
+            for (auto& item : tld.facing.getPushBuffer()) {
+              tld.newItems.push_back(item);
+            }
+            ctx.commitIteration();
+          } else {
+            ctx.cancelIteration();
+          }
+          committed[i] = commit;
+          tld.facing.resetPushBuffer();
+          tld.facing.resetAlloc();
+        },
+        std::make_tuple(katana::steal(), katana::no_stats()));
+  }
+
+  void calculateWindow(size_t numCommitted) {
+    float commitRatio = numCommitted / (float)window.size();
+    if (commitRatio >= TargetCommitRatio) {
+      windowSize += windowSize;
+    } else {
+      windowSize = commitRatio / TargetCommitRatio * windowSize;
+    }
+    windowSize = std::max(windowSize, minWindow);
+  }
+
+public:
+  OrderedExecutor(
+      const Cmp& _cmp, const NhFunc& _nhFunc, const OpFunc& _opFunc,
+      const StableTest& _stabilityTest, const char* _loopname)
+      : cmp(_cmp),
+        nhFunc(_nhFunc),
+        opFunc(_opFunc),
+        stabilityTest(_stabilityTest),
+        loopname(_loopname),
+        pending(Before(cmp)) {
+    minWindow = MinWindowPerThread * getActiveThreads();
+    windowSize = minWindow;
+  }
+
+  template <typename Iter>
+  void push(Iter b, Iter e) {
+    for (; b != e; ++b) {
+      pending.push(*b);
+    }
+  }
+
+  void execute() {
+    while (!pending.empty()) {
+      size_t n = std::min(windowSize, pending.size());
+      window.clear();
+      committed.assign(n, false);
+      for (size_t i = 0; i < n; ++i) {
+        window.emplace_back(pending.pop(), i);
+      }
+
+      neighborhoodPass();
+      commitPass();
+
+      size_t numCommitted = 0;
+      for (size_t i = 0; i < n; ++i) {
+        if (committed[i]) {
+          ++numCommitted;
+        } else {
+          pending.push(window[i].item);
+        }
+      }
+      for (unsigned i = 0; i < data.size(); ++i) {
+        auto& newItems = data.getRemote(i)->newItems;
+        push(newItems.begin(), newItems.end());
+        newItems.clear();
+      }
+      KATANA_LOG_DEBUG_VASSERT(
+          numCommitted > 0, "the earliest item should always commit");
+
+      ++rounds;
+      iterations += n;
+      commits += numCommitted;
+      calculateWindow(numCommitted);
+    }
+
+    if (loopname) {
+      ReportStatSingle(loopname, "Iterations", iterations);
+      ReportStatSingle(loopname, "Commits", commits);
+      ReportStatSingle(loopname, "Conflicts", iterations - commits);
+      ReportStatSingle(loopname, "RoundsExecuted", rounds);
+    }
+  }
+};
+
+//! Stability test of stable source algorithms
+struct AlwaysStable {
+  template <typename T>
+  bool operator()(const T&) const {
+    return true;
+  }
+};
+
+}  // namespace internal
 
 template <typename Iter, typename Cmp, typename NhFunc, typename OpFunc>
 void
 for_each_ordered_impl(
-    [[maybe_unused]] Iter beg, [[maybe_unused]] Iter end,
-    [[maybe_unused]] const Cmp& cmp, [[maybe_unused]] const NhFunc& nhFunc,
-    [[maybe_unused]] const OpFunc& opFunc,
-    [[maybe_unused]] const char* loopname) {
-  KATANA_DIE("not yet implemented");
+    Iter beg, Iter end, const Cmp& cmp, const NhFunc& nhFunc,
+    const OpFunc& opFunc, const char* loopname) {
+  typedef typename std::iterator_traits<Iter>::value_type T;
+  internal::AlwaysStable stable;
+  internal::OrderedExecutor<
+      T, Cmp, NhFunc, OpFunc, internal::AlwaysStable, false>
+      executor(cmp, nhFunc, opFunc, stable, loopname);
+  executor.push(beg, end);
+  executor.execute();
 }
 
 template <
@@ -41,12 +337,14 @@ template <
     typename StableTest>
 void
 for_each_ordered_impl(
-    [[maybe_unused]] Iter beg, [[maybe_unused]] Iter end,
-    [[maybe_unused]] const Cmp& cmp, [[maybe_unused]] const NhFunc& nhFunc,
-    [[maybe_unused]] const OpFunc& opFunc,
-    [[maybe_unused]] const StableTest& stabilityTest,
-    [[maybe_unused]] const char* loopname) {
-  KATANA_DIE("not yet implemented");
+    Iter beg, Iter end, const Cmp& cmp, const NhFunc& nhFunc,
+    const OpFunc& opFunc, const StableTest& stabilityTest,
+    const char* loopname) {
+  typedef typename std::iterator_traits<Iter>::value_type T;
+  internal::OrderedExecutor<T, Cmp, NhFunc, OpFunc, StableTest, true>
+      executor(cmp, nhFunc, opFunc, stabilityTest, loopname);
+  executor.push(beg, end);
+  executor.execute();
 }
 
 }  // end namespace katana
@@ -25,7 +25,10 @@
 #include <cstdlib>
 #include <ctime>
 #include <deque>
+#include <iterator>
 #include <random>
+#include <tuple>
+#include <type_traits>
 #include <vector>
 
 #include "katana/Context.h"
@@ -33,6 +36,7 @@
 #include "katana/Executor_ForEach.h"
 #include "katana/Executor_OnEach.h"
 #include "katana/Mem.h"
+#include "katana/ParallelismProfile.h"
 #include "katana/Reduction.h"
 #include "katana/Simple.h"
 #include "katana/Traits.h"
@@ -373,10 +377,15 @@ private:
         std::make_tuple());
 
     UnorderedStepStats stats;
+    ParallelismProfile::Loop profile(loopname, "for_each");
 
     while (!m_wl.empty()) {
       m_wl.nextStep();
 
+      if (profile.recording()) {
+        profile.BeginRound();
+      }
+
       if (needsAborts) {
         runCautiousStep(stats);
 
@@ -389,7 +398,12 @@ private:
       KATANA_LOG_DEBUG_VASSERT(
           stats.parallelism.reduce(), "ERROR: No Progress");
 
-      stats.dump(m_statsFile, loopname);
+      if (profile.recording()) {
+        profile.EndRound(stats.parallelism.reduce(), stats.wlSize.reduce());
+      }
+      if (m_statsFile) {
+        stats.dump(m_statsFile, loopname);
+      }
       stats.nextStep();
 
       if (needsBreak && m_broken.reduce()) {
@@ -398,14 +412,20 @@ private:
 
     }  // end while
 
-    closeStatsFile();
+    if (m_statsFile) {
+      closeStatsFile();
+    }
   }
 
 public:
   ParaMeterExecutor(const FunctionTy& f, const ArgsTy& args)
+      : ParaMeterExecutor(f, args, getStatsFile()) {}
+
+  //! statsFile may be null to only report to the ParallelismProfile
+  ParaMeterExecutor(const FunctionTy& f, const ArgsTy& args, FILE* statsFile)
       : m_func(f),
         loopname(katana::internal::getLoopName(args)),
-        m_statsFile(getStatsFile()) {}
+        m_statsFile(statsFile) {}
 
   // called serially once
   template <typename RangeTy>
@@ -468,6 +488,39 @@ for_each_ParaMeter(const R& range, const F& func, const ArgsTuple& argsTuple) {
   exec.execute(range);
 }
 
+namespace internal {
+
+//! Whether for_each may run a loop with these arguments with the ParaMeter
+//! executor to record it in the ParallelismProfile
+template <typename ArgsTuple>
+constexpr bool
+CanProfileParallelism() {
+  return has_trait<loopname_tag, ArgsTuple>() &&
+         !has_trait<local_state_tag, ArgsTuple>();
+}
+
+//! Run a for_each loop with the ParaMeter executor, whatever its worklist,
+//! recording its steps in the ParallelismProfile instead of a stats file
+template <typename R, typename F, typename ArgsTuple>
+void
+for_each_profiled(const R& range, F&& func, const ArgsTuple& argsTuple) {
+  using T = typename std::iterator_traits<typename R::iterator>::value_type;
+  using FuncRefType = OperatorReferenceType<decltype(std::forward<F>(func))>;
+
+  // The first wl trait wins
+  auto tpl = std::tuple_cat(
+      std::make_tuple(wl<katana::ParaMeter<>>()), argsTuple,
+      typename function_traits<std::decay_t<F>>::type{});
+
+  using Exec = parameter::ParaMeterExecutor<T, FuncRefType, decltype(tpl)>;
+  FuncRefType fn_ref = func;
+  Exec exec(fn_ref, tpl, nullptr);
+
+  exec.init(range);
+}
+
+}  // namespace internal
+
 }  // end namespace katana
 #endif
 
@@ -0,0 +1,241 @@
+#ifndef KATANA_LIBGALOIS_KATANA_FRONTIER_H_
+#define KATANA_LIBGALOIS_KATANA_FRONTIER_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "katana/Bag.h"
+#include "katana/DynamicBitset.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// The set of active nodes of one round of a frontier-based algorithm, e.g.,
+/// a BFS level or the nodes whose core number dropped in a k-core round.
+///
+/// A round pushes nodes in parallel; pushes are deduplicated, so a node is
+/// active at most once. After the round, Seal() picks the representation
+/// that makes the next round cheapest to visit:
+///
+/// - kSparse: a list of the pushed nodes, for frontiers much smaller than
+///   the graph
+/// - kCompressed: a bitset plus a summary bit per 64 nodes so that empty
+///   stretches of the graph are skipped, for frontiers of moderate density
+/// - kDense: a bitset scanned in full, for large frontiers
+///
+/// The bitset is always kept up to date, so Contains() is O(1) in every
+/// representation, as bottom-up BFS steps need.
+///
+/// \code
+/// katana::Frontier current(n);
+/// katana::Frontier next(n);
+/// current.Push(source);
+/// current.Seal();
+/// while (!current.empty()) {
+///   current.ForEachActive([&](uint32_t node) { ... next.Push(dst); ... });
+///   next.Seal();
+///   std::swap(current, next);
+///   next.Clear();
+/// }
+/// \endcode
+class Frontier {
+public:
+  enum class Representation { kSparse, kCompressed, kDense };
+
+  /// \param num_nodes nodes are in [0, num_nodes)
+  /// \param max_sparse_density the largest fraction of nodes kept as a list
+  /// \param max_compressed_density the largest fraction of nodes visited
+  ///     through the summary bits
+  explicit Frontier(
+      size_t num_nodes, double max_sparse_density = 1.0 / 256,
+      double max_compressed_density = 1.0 / 32)
+      : num_nodes_(num_nodes),
+        max_sparse_(num_nodes * max_sparse_density),
+        max_compressed_(num_nodes * max_compressed_density) {
+    members_.resize(num_nodes);
+    summary_.resize(members_.get_vec().size());
+  }
+
+  Frontier(Frontier&&) = default;
+  Frontier& operator=(Frontier&&) = default;
+
+  /// Add a node; may be called in parallel before Seal().
+  ///
+  /// \returns true if the node was not already in the frontier
+  bool Push(uint32_t node) {
+    KATANA_LOG_DEBUG_ASSERT(!sealed_);
+    KATANA_LOG_DEBUG_ASSERT(node < num_nodes_);
+    size_t word = node / DynamicBitset::kNumBitsInUint64;
+    uint64_t mask = uint64_t{1} << (node % DynamicBitset::kNumBitsInUint64);
+    uint64_t old =
+        members_.get_vec()[word].fetch_or(mask, std::memory_order_relaxed);
+    if (old & mask) {
+      return false;
+    }
+    if (old == 0) {
+      summary_.set(word);
+    }
+    // Stop listing nodes once the frontier is too large to stay sparse
+    size_t& count = *counts_.getLocal();
+    if (++count <= max_sparse_) {
+      sparse_.push(node);
+    }
+    return true;
+  }
+
+  /// Finish a round of pushes and choose the representation. Call on the
+  /// main thread after the loop that pushes.
+  void Seal() {
+    KATANA_LOG_DEBUG_ASSERT(!sealed_);
+    size_ = 0;
+    bool listed_all = true;
+    for (unsigned i = 0; i < counts_.size(); ++i) {
+      size_t count = *counts_.getRemote(i);
+      size_ += count;
+      listed_all = listed_all && count <= max_sparse_;
+    }
+
+    if (listed_all && size_ <= max_sparse_) {
+      representation_ = Representation::kSparse;
+    } else {
+      sparse_.clear();
+      representation_ = size_ <= max_compressed_ ? Representation::kCompressed
+                                                 : Representation::kDense;
+    }
+    sealed_ = true;
+  }
+
+  /// Remove every node; call on the main thread
+  void Clear() {
+    if (!sealed_) {
+      Seal();
+    }
+    auto& words = members_.get_vec();
+    switch (representation_) {
+    case Representation::kSparse:
+      do_all(
+          iterate(sparse_),
+          [&](uint32_t node) {
+            words[node / DynamicBitset::kNumBitsInUint64].store(
+                0, std::memory_order_relaxed);
+          },
+          no_stats());
+      break;
+    case Representation::kCompressed:
+      ForEachNonEmptyWord([&](size_t word) {
+        words[word].store(0, std::memory_order_relaxed);
+      });
+      break;
+    case Representation::kDense:
+      do_all(
+          iterate(size_t{0}, words.size()),
+          [&](size_t word) { words[word].store(0, std::memory_order_relaxed); },
+          no_stats());
+      break;
+    }
+    summary_.reset();
+    sparse_.clear();
+    for (unsigned i = 0; i < counts_.size(); ++i) {
+      *counts_.getRemote(i) = 0;
+    }
+    size_ = 0;
+    sealed_ = false;
+  }
+
+  /// Call fn(node) in parallel for every node in the frontier. Extra
+  /// arguments, e.g., katana::loopname, are passed on to do_all. Requires
+  /// Seal().
+  template <typename F, typename... Args>
+  void ForEachActive(const F& fn, Args&&... args) {
+    KATANA_LOG_DEBUG_ASSERT(sealed_);
+    const auto& words = members_.get_vec();
+    auto visit_word = [&](size_t word) {
+      uint64_t bits = words[word].load(std::memory_order_relaxed);
+      uint32_t base = word * DynamicBitset::kNumBitsInUint64;
+      while (bits) {
+        fn(base + __builtin_ctzll(bits));
+        bits &= bits - 1;
+      }
+    };
+
+    switch (representation_) {
+    case Representation::kSparse:
+      do_all(iterate(sparse_), fn, std::forward<Args>(args)...);
+      break;
+    case Representation::kCompressed:
+      ForEachNonEmptyWord(visit_word, std::forward<Args>(args)...);
+      break;
+    case Representation::kDense:
+      do_all(
+          iterate(size_t{0}, words.size()), visit_word, steal(),
+          std::forward<Args>(args)...);
+      break;
+    }
+  }
+
+  bool Contains(uint32_t node) const { return members_.test(node); }
+
+  /// The number of nodes in the frontier. Requires Seal().
+  size_t Size() const {
+    KATANA_LOG_DEBUG_ASSERT(sealed_);
+    return size_;
+  }
+
+  /// The fraction of nodes in the frontier. Requires Seal().
+  double Density() const {
+    return num_nodes_ == 0 ? 0 : static_cast<double>(Size()) / num_nodes_;
+  }
+
+  bool empty() const { return Size() == 0; }
+
+  /// Requires Seal()
+  Representation representation() const {
+    KATANA_LOG_DEBUG_ASSERT(sealed_);
+    return representation_;
+  }
+
+  /// The frontier as a bitset over all nodes; valid in every representation
+  const DynamicBitset& bitset() const { return members_; }
+
+private:
+  template <typename F, typename... Args>
+  void ForEachNonEmptyWord(const F& fn, Args&&... args) const {
+    const auto& summary = summary_.get_vec();
+    do_all(
+        iterate(size_t{0}, summary.size()),
+        [&](size_t i) {
+          uint64_t bits = summary[i].load(std::memory_order_relaxed);
+          size_t base = i * DynamicBitset::kNumBitsInUint64;
+          while (bits) {
+            fn(base + __builtin_ctzll(bits));
+            bits &= bits - 1;
+          }
+        },
+        steal(), std::forward<Args>(args)...);
+  }
+
+  size_t num_nodes_;
+  size_t max_sparse_;
+  size_t max_compressed_;
+  // Bit i is set if node i is in the frontier
+  DynamicBitset members_;
+  // Bit i is set if word i of members_ is not zero
+  DynamicBitset summary_;
+  // The nodes in the order pushed, while there are at most max_sparse_
+  InsertBag<uint32_t> sparse_;
+  // The number of nodes each thread added this round
+  PerThreadStorage<size_t> counts_;
+  size_t size_{0};
+  Representation representation_{Representation::kSparse};
+  bool sealed_{false};
+};
+
+}  // namespace katana
+
+#endif
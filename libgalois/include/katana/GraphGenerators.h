@@ -0,0 +1,91 @@
+#ifndef KATANA_LIBGALOIS_KATANA_GRAPHGENERATORS_H_
+#define KATANA_LIBGALOIS_KATANA_GRAPHGENERATORS_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "katana/GraphTopology.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// Parallel generators of synthetic graphs for benchmarking.
+///
+/// Generators are seeded: the same options and seed give the same graph for
+/// any number of threads. Random generators produce edges in fixed blocks,
+/// each with its own random stream, and build the CSR with a parallel
+/// counting sort that generates every block twice, once to count degrees
+/// and once to place edges, so no edge list is ever materialized and memory
+/// use is that of the topology itself. The destinations of each node are
+/// sorted. Random graphs are multigraphs: they may have self loops and
+/// parallel edges.
+
+/// R-MAT: each edge picks a quadrant of the adjacency matrix with
+/// probabilities a, b, c and 1 - a - b - c, scale times.
+struct RmatOptions {
+  /// The graph has 2^scale nodes
+  uint32_t scale{16};
+  /// and edge_factor * 2^scale edges
+  uint64_t edge_factor{16};
+  double a{0.57};
+  double b{0.19};
+  double c{0.19};
+  /// Relabel the nodes with a random permutation so that ids do not reveal
+  /// degree, as Graph500 does
+  bool scramble_ids{false};
+  uint64_t seed{0};
+
+  /// The Graph500 Kronecker generator
+  static RmatOptions Graph500(uint32_t scale, uint64_t seed = 0) {
+    RmatOptions opts;
+    opts.scale = scale;
+    opts.scramble_ids = true;
+    opts.seed = seed;
+    return opts;
+  }
+};
+
+KATANA_EXPORT Result<GraphTopology> GenerateRmatTopology(
+    const RmatOptions& opts);
+
+/// Erdos-Renyi G(n, m): num_edges edges with uniformly random endpoints
+KATANA_EXPORT Result<GraphTopology> GenerateErdosRenyiTopology(
+    uint64_t num_nodes, uint64_t num_edges, uint64_t seed = 0);
+
+/// Chung-Lu: num_edges edges whose endpoints are drawn with probability
+/// proportional to an expected degree that follows a power law with the
+/// given exponent, which must be greater than 2. Node 0 has the highest
+/// expected degree.
+KATANA_EXPORT Result<GraphTopology> GenerateChungLuTopology(
+    uint64_t num_nodes, uint64_t num_edges, double exponent = 2.5,
+    uint64_t seed = 0);
+
+/// A 2D (z == 1) or 3D grid of x by y by z nodes, each with an edge to and
+/// from each of its neighbors along every axis. Node (i, j, k) has id
+/// i + x * (j + y * k).
+KATANA_EXPORT Result<GraphTopology> GenerateGridTopology(
+    uint64_t x, uint64_t y, uint64_t z = 1);
+
+/// Random properties for a generated topology
+struct GeneratedPropertiesOptions {
+  /// Name of a uint32 edge property with weights uniform in
+  /// [1, max_weight], or empty for none
+  std::string weight_property{"weight"};
+  uint32_t max_weight{255};
+  /// Number of node and edge types, named "node_type_<i>" and
+  /// "edge_type_<i>", assigned uniformly at random; 0 for none
+  uint32_t num_node_types{0};
+  uint32_t num_edge_types{0};
+  uint64_t seed{0};
+};
+
+/// A property graph over topology with random weights and types
+KATANA_EXPORT Result<std::unique_ptr<PropertyGraph>> MakeGeneratedGraph(
+    GraphTopology&& topology, const GeneratedPropertiesOptions& opts);
+
+}  // namespace katana
+
+#endif
@@ -13,11 +13,15 @@ namespace katana {
 ///     memory usage when converting large inputs
 /// \param verbose If true, print graph data to the standard out while
 ///     converting.
+/// \param parallel If true, read the keys in a first pass, then split the
+///     graph element at node and edge elements and parse the pieces on all
+///     threads. The file must not have comments or CDATA sections in the
+///     graph element that contain node or edge tags.
 /// \returns A collection of Arrow tables of node properties/labels, edge
 ///     properties/types, and CSR topology
 KATANA_EXPORT katana::Result<katana::GraphComponents> ConvertGraphML(
     const std::string& infilename, size_t chunk_size = 25000,
-    bool verbose = false);
+    bool verbose = false, bool parallel = false);
 
 }  // end namespace katana
 
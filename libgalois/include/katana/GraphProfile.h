@@ -0,0 +1,58 @@
+#ifndef KATANA_LIBGALOIS_KATANA_GRAPHPROFILE_H_
+#define KATANA_LIBGALOIS_KATANA_GRAPHPROFILE_H_
+
+#include <cstdint>
+
+#include "katana/GraphTopology.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// Cheap statistics of a graph topology for the plans that choose an
+/// algorithm automatically, e.g., SsspPlan::kAutomatic or
+/// JaccardPlan::kUnknown. Building one takes a parallel pass over the edges
+/// and a few samples; PropertyGraph::GetGraphProfile builds it once and
+/// caches it with the views of the graph.
+struct KATANA_EXPORT GraphProfile {
+  enum DiameterClass {
+    /// Most nodes are a few hops from a hub, e.g., social or web graphs
+    kLowDiameter,
+    /// Paths are long, e.g., road networks or meshes
+    kHighDiameter,
+  };
+
+  /// Breadth first search levels from a hub beyond which a graph is
+  /// kHighDiameter
+  static constexpr uint32_t kHighDiameterLevels = 32;
+
+  uint64_t num_nodes{0};
+  uint64_t num_edges{0};
+  uint64_t max_degree{0};
+  /// The mean over the median of the out degrees of sampled nodes that have
+  /// edges; well above 1 for skewed degree distributions
+  double degree_skew{0};
+  /// Whether the degrees look like a power law (heavy tailed), as in
+  /// the WorthRelabelling heuristic of the GAP benchmark suite
+  bool power_law{false};
+
+  /// The levels reached by a breadth first search from a node of
+  /// max_degree, which stops early on large graphs; a lower bound of the
+  /// diameter
+  uint32_t probe_levels{0};
+  DiameterClass diameter_class{kLowDiameter};
+
+  /// The fraction of nodes whose edges are sorted by destination
+  double sorted_fraction{1};
+  /// Whether the edges of every node are sorted by destination
+  bool edges_sorted{true};
+
+  /// Whether every sampled edge has a reverse edge. A sample can miss an
+  /// asymmetric edge, so this can only rule symmetry out.
+  bool likely_symmetric{true};
+
+  static GraphProfile Make(const GraphTopology& topo) noexcept;
+};
+
+}  // namespace katana
+
+#endif
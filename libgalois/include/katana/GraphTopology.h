@@ -1,18 +1,32 @@
 #ifndef KATANA_LIBGALOIS_KATANA_GRAPHTOPOLOGY_H_
 #define KATANA_LIBGALOIS_KATANA_GRAPHTOPOLOGY_H_
 
+#include <algorithm>
+#include <cstdint>
+#include <future>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
+#include <arrow/type_fwd.h>
 #include <boost/iterator/counting_iterator.hpp>
 
 #include "katana/Iterators.h"
 #include "katana/NUMAArray.h"
+#include "katana/Range.h"
+#include "katana/Result.h"
 #include "katana/config.h"
 
 namespace katana {
 
 class KATANA_EXPORT PropertyGraph;
+class KATANA_EXPORT EntityTypeManager;
+struct KATANA_EXPORT GraphProfile;
 
 // TODO(amber): None of the topologies or views or PGViewCache can keep a member
 // pointer to PropertyGraph because PropertyGraph can be moved. This issue plagues
@@ -25,7 +39,7 @@ struct KATANA_EXPORT GraphTopologyTypes {
   using Node = uint32_t;
   using Edge = uint64_t;
   using PropertyIndex = uint64_t;
-  using EntityType = uint8_t;
+  using EntityType = uint16_t;
   using node_iterator = boost::counting_iterator<Node>;
   using edge_iterator = boost::counting_iterator<Edge>;
   using nodes_range = StandardRange<node_iterator>;
@@ -40,11 +54,78 @@ struct KATANA_EXPORT GraphTopologyTypes {
 
 class KATANA_EXPORT EdgeShuffleTopology;
 class KATANA_EXPORT EdgeTypeAwareTopology;
+class KATANA_EXPORT DestTypeAwareTopology;
+class KATANA_EXPORT TemporalEdgeIndex;
+
+/// A split of the nodes of a topology among threads in which each thread's
+/// block of nodes has about as many edges (counting each node as one more
+/// edge) as any other's. See GraphTopology::edge_balanced_partition().
+class KATANA_EXPORT EdgeBalancedPartition : public GraphTopologyTypes {
+public:
+  explicit EdgeBalancedPartition(std::vector<uint32_t> thread_ranges) noexcept
+      : thread_ranges_(std::move(thread_ranges)) {}
+
+  uint32_t num_threads() const noexcept { return thread_ranges_.size() - 1; }
+
+  /// num_threads() + 1 node IDs; thread t's nodes are
+  /// [thread_ranges()[t], thread_ranges()[t + 1])
+  const std::vector<uint32_t>& thread_ranges() const noexcept {
+    return thread_ranges_;
+  }
+
+  nodes_range thread_nodes(uint32_t tid) const noexcept {
+    KATANA_LOG_DEBUG_ASSERT(tid < num_threads());
+    return MakeStandardRange<node_iterator>(
+        thread_ranges_[tid], thread_ranges_[tid + 1]);
+  }
+
+  nodes_range all_nodes() const noexcept {
+    return MakeStandardRange<node_iterator>(Node{0}, thread_ranges_.back());
+  }
+
+private:
+  std::vector<uint32_t> thread_ranges_;
+};
+
+/// Iterate over all nodes of a topology, each thread starting with its block
+/// of \p partition rather than an equal share of the node IDs. With
+/// katana::steal(), idle threads still take work from busy ones.
+///
+///     katana::do_all(
+///         katana::iterate(*topo.edge_balanced_partition()),
+///         [&](auto node) { ... }, katana::steal());
+///
+/// The partition must have been made for the current number of active
+/// threads.
+inline SpecificRange<GraphTopologyTypes::node_iterator>
+iterate(const EdgeBalancedPartition& partition) {
+  KATANA_LOG_VASSERT(
+      partition.num_threads() == activeThreads,
+      "partition is for {} threads but {} are active",
+      partition.num_threads(), activeThreads);
+  return MakeSpecificRange(
+      partition.all_nodes().begin(), partition.all_nodes().end(),
+      partition.thread_ranges());
+}
 
 /// A graph topology represents the adjacency information for a graph in CSR
 /// format.
 class KATANA_EXPORT GraphTopology : public GraphTopologyTypes {
 public:
+  /// How the arrays of a topology are placed on NUMA nodes
+  enum class Placement {
+    /// Pages are spread round robin over the nodes of the active threads
+    kInterleaved,
+    /// The nodes of each thread's share of all_nodes(), and their edges, are
+    /// on that thread's NUMA node
+    kBlocked,
+    /// The arrays are not copied; the topology reads the buffers passed to
+    /// it, which must outlive it and not change. Used for topologies read
+    /// straight from a mapped file. Friends that modify the arrays get a
+    /// copy first (see borrowed()).
+    kBorrowed,
+  };
+
   GraphTopology() = default;
   GraphTopology(GraphTopology&&) = default;
   GraphTopology& operator=(GraphTopology&&) = default;
@@ -54,7 +135,14 @@ public:
 
   GraphTopology(
       const Edge* adj_indices, size_t num_nodes, const Node* dests,
-      size_t num_edges) noexcept;
+      size_t num_edges) noexcept
+      : GraphTopology(
+            adj_indices, num_nodes, dests, num_edges,
+            Placement::kInterleaved) {}
+
+  GraphTopology(
+      const Edge* adj_indices, size_t num_nodes, const Node* dests,
+      size_t num_edges, Placement placement) noexcept;
 
   GraphTopology(NUMAArray<Edge>&& adj_indices, NUMAArray<Node>&& dests) noexcept
       : adj_indices_(std::move(adj_indices)), dests_(std::move(dests)) {}
@@ -69,23 +157,33 @@ public:
 
   const Node* dest_data() const noexcept { return dests_.data(); }
 
+  /// Whether the arrays are buffers owned by someone else, see
+  /// Placement::kBorrowed
+  bool borrowed() const noexcept { return borrowed_; }
+
+  /// Move the arrays into storage shared with the topologies that Share()
+  /// returns. This topology then borrows them, so friends that modify the
+  /// arrays get a copy first and the shared arrays never change.
+  void MoveToSharedStorage() noexcept;
+
+  /// Whether Share() returns without copying the arrays
+  bool shareable() const noexcept { return owner_ != nullptr; }
+
+  /// A topology that reads the same arrays as this one and keeps them alive
+  /// after this one is destroyed, e.g., for PropertyGraph::Copy. Arrays that
+  /// are not in shared storage (see MoveToSharedStorage), e.g., ones read
+  /// straight from a mapped file, are copied instead.
+  GraphTopology Share() const noexcept;
+
+  /// Copy the arrays if other topologies read them too (see Share), before
+  /// they are modified in place
+  void Unshare() noexcept;
+
   /// Checks equality against another instance of GraphTopology.
-  /// WARNING: Expensive operation due to element-wise checks on large arrays
+  /// WARNING: Reads all of both topologies, though in parallel
   /// @param that: GraphTopology instance to compare against
   /// @returns true if topology arrays are equal
-  bool Equals(const GraphTopology& that) const noexcept {
-    if (this == &that) {
-      return true;
-    }
-    if (num_nodes() != that.num_nodes()) {
-      return false;
-    }
-    if (num_edges() != that.num_edges()) {
-      return false;
-    }
-
-    return adj_indices_ == that.adj_indices_ && dests_ == that.dests_;
-  }
+  bool Equals(const GraphTopology& that) const noexcept;
 
   /// Gets the edge range of some node.
   ///
@@ -165,6 +263,13 @@ public:
     return edge_property_index(eid);
   }
 
+  /// A split of all_nodes() among the active threads that balances their
+  /// edges, for use with katana::iterate(const EdgeBalancedPartition&). It is
+  /// computed by binary search over the CSR on first use and cached until the
+  /// number of active threads changes. Safe to call concurrently.
+  std::shared_ptr<const EdgeBalancedPartition> edge_balanced_partition()
+      const;
+
   void Print() noexcept;
 
 private:
@@ -173,11 +278,88 @@ private:
   friend class EdgeShuffleTopology;
   friend class EdgeTypeAwareTopology;
 
-  NUMAArray<Edge>& GetAdjIndices() noexcept { return adj_indices_; }
-  NUMAArray<Node>& GetDests() noexcept { return dests_; }
+  NUMAArray<Edge>& GetAdjIndices() noexcept {
+    if (borrowed_) {
+      Own();
+    }
+    std::atomic_store(
+        &edge_balanced_partition_,
+        std::shared_ptr<const EdgeBalancedPartition>());
+    return adj_indices_;
+  }
+  NUMAArray<Node>& GetDests() noexcept {
+    if (borrowed_) {
+      Own();
+    }
+    return dests_;
+  }
+
+  /// Replace borrowed arrays with interleaved copies
+  void Own() noexcept;
 
   NUMAArray<Edge> adj_indices_;
   NUMAArray<Node> dests_;
+  bool borrowed_{false};
+  // Keeps the arrays alive while they are borrowed from shared storage
+  std::shared_ptr<const void> owner_;
+  mutable std::shared_ptr<const EdgeBalancedPartition>
+      edge_balanced_partition_;
+};
+
+/// Auxiliary index answering edge lookups on high degree nodes in O(1).
+///
+/// Each indexed hub gets either an open addressing hash table from
+/// destination to the offset of its first edge to that destination, or, when
+/// smaller, a bitmap over the range of its destinations. Bitmaps answer
+/// whether an edge exists but not where it is. Hubs are indexed in order of
+/// decreasing degree until the byte budget is spent.
+class KATANA_EXPORT HubEdgeIndex : public GraphTopologyTypes {
+public:
+  static constexpr uint64_t kDefaultMinDegree = 1024;
+
+  enum class LookupKind { kNotIndexed, kAbsent, kPresent };
+
+  struct LookupResult {
+    LookupKind kind{LookupKind::kNotIndexed};
+    /// Offset among the edges of the source node, if known; UINT64_MAX
+    /// otherwise
+    uint64_t edge_offset{UINT64_MAX};
+  };
+
+  /// Index nodes of \p topo with at least \p min_degree edges while the
+  /// index takes at most \p max_bytes
+  static std::unique_ptr<HubEdgeIndex> Make(
+      const GraphTopology& topo, uint64_t min_degree,
+      uint64_t max_bytes) noexcept;
+
+  LookupResult Find(Node src, Node dst) const noexcept;
+
+  uint64_t min_degree() const noexcept { return min_degree_; }
+
+  uint64_t num_hubs() const noexcept { return hubs_.size(); }
+
+  size_t bytes() const noexcept {
+    return hubs_.size() * sizeof(Hub) + words_.size() * sizeof(uint64_t);
+  }
+
+private:
+  struct Hub {
+    Node node;
+    // For bitmaps, the destination of bit 0; unused for hash tables
+    Node min_dest;
+    bool is_bitmap;
+    // Word offset and length in words_; hash tables have a power of two
+    // length
+    uint64_t begin;
+    uint64_t size;
+  };
+
+  HubEdgeIndex() = default;
+
+  uint64_t min_degree_{0};
+  // Sorted by node
+  std::vector<Hub> hubs_;
+  NUMAArray<uint64_t> words_;
 };
 
 // TODO(amber): In the future, when we group properties e.g., by node or edge type,
@@ -200,7 +382,9 @@ public:
     kAny = 0,  // don't care. Sorted or Unsorted
     kSortedByDestID,
     kSortedByEdgeType,
-    kSortedByNodeType
+    kSortedByNodeType,
+    /// By an edge property of timestamps; see TemporalEdgeIndex
+    kSortedByTimestamp
   };
 
   bool is_transposed() const noexcept {
@@ -236,11 +420,28 @@ public:
     return edge_property_index(eid);
   }
 
+  const PropertyIndex* edge_prop_index_data() const noexcept {
+    return edge_prop_indices_.data();
+  }
+
   static std::unique_ptr<EdgeShuffleTopology> MakeTransposeCopy(
       const PropertyGraph* pg);
   static std::unique_ptr<EdgeShuffleTopology> MakeOriginalCopy(
       const PropertyGraph* pg);
 
+  /// Copy a topology with the given states from its arrays, e.g., those of a
+  /// derived topology file
+  static std::unique_ptr<EdgeShuffleTopology> MakeFromArrays(
+      const TransposeKind& tpose_state, const EdgeSortKind& edge_sort_state,
+      const Edge* adj_indices, size_t num_nodes, const Node* dests,
+      const PropertyIndex* edge_prop_indices, size_t num_edges) noexcept;
+
+  /// The out- and in-edges of each node of \p pg merged, sorted by
+  /// destination, without duplicates or self-loops; \p in_topo holds the
+  /// in-edges. See UndirectedTopology.
+  static std::unique_ptr<EdgeShuffleTopology> MakeUndirected(
+      const PropertyGraph* pg, const EdgeShuffleTopology& in_topo) noexcept;
+
   static std::unique_ptr<EdgeShuffleTopology> Make(
       const PropertyGraph* pg, const TransposeKind& tpose_todo,
       const EdgeSortKind& edge_sort_todo) noexcept {
@@ -266,14 +467,37 @@ public:
     return find_edge(src, dst) != edges(src).end();
   }
 
+  /// Build a HubEdgeIndex over nodes with at least \p min_degree edges,
+  /// taking at most \p max_bytes, so that find_edge and has_edge on them
+  /// are O(1). The index is dropped if the edges are sorted again.
+  void BuildHubIndex(uint64_t min_degree, uint64_t max_bytes) noexcept;
+
+  /// Bytes used by the hub index, if any
+  size_t hub_index_bytes() const noexcept {
+    return hub_index_ ? hub_index_->bytes() : 0;
+  }
+
+  /// Sort the edges of each node by timestamps[edge_property_index(e)],
+  /// keeping the current order of edges with the same timestamp
+  void SortEdgesByTimestamp(const int64_t* timestamps) noexcept;
+
 protected:
   void SortEdgesByDestID() noexcept;
 
   void SortEdgesByTypeThenDest(const PropertyGraph* pg) noexcept;
 
+  /// Sort the edges of each node by the type of their destination, then by
+  /// destination. Destinations are nodes of this topology; when it has
+  /// renumbered the nodes, node_prop_indices maps them to the nodes of \p pg,
+  /// and when it is empty they are the same.
   void SortEdgesByDestType(
       const PropertyGraph* pg, const PropIndexVec& node_prop_indices) noexcept;
 
+  /// Sort the edges of each node, in parallel over nodes, by the 64-bit key
+  /// key_of(dest, edge_property_index)
+  template <typename KeyFn>
+  void SortEdgesByKey(const KeyFn& key_of) noexcept;
+
   void sortEdges(
       const PropertyGraph* pg, const EdgeSortKind& edge_sort_todo) noexcept {
     switch (edge_sort_todo) {
@@ -286,7 +510,10 @@ protected:
       SortEdgesByTypeThenDest(pg);
       return;
     case EdgeSortKind::kSortedByNodeType:
-      KATANA_LOG_FATAL("Not implemented yet");
+      SortEdgesByDestType(pg, PropIndexVec{});
+      return;
+    case EdgeSortKind::kSortedByTimestamp:
+      KATANA_LOG_FATAL("sorting by timestamp needs the timestamps");
       return;
     default:
       KATANA_LOG_FATAL("switch-case fell through");
@@ -316,6 +543,8 @@ private:
   // PropertyGraph.edge_type_set_id(edge_prop_indices_[edge_id]) to obtain
   // edge_type_id. This may not be true when we group properties
   PropIndexVec edge_prop_indices_;
+
+  std::unique_ptr<HubEdgeIndex> hub_index_;
 };
 
 /// This is a fully shuffled topology where both the nodes and edges can be sorted
@@ -327,6 +556,17 @@ public:
     kAny = 0,
     kSortedByDegree,
     kSortedByNodeType,
+    /// Reverse Cuthill-McKee: breadth first from low degree nodes, visiting
+    /// neighbors in increasing degree order, reversed
+    kReverseCuthillMcKee,
+    /// Breadth first order, from the lowest numbered unvisited node
+    kBFSOrder,
+    /// Gorder-style greedy placement that keeps nodes sharing neighbors
+    /// within a small window of each other
+    kGorder,
+    /// Degree-bucketed hub clustering: nodes grouped by degree relative to
+    /// the average, hottest group first, original order within a group
+    kHubCluster,
   };
 
   PropertyIndex node_property_index(const Node& nid) const noexcept {
@@ -350,6 +590,18 @@ public:
   static std::unique_ptr<ShuffleTopology> MakeSortedByNodeType(
       const PropertyGraph* pg, const EdgeShuffleTopology& seed_topo) noexcept;
 
+  static std::unique_ptr<ShuffleTopology> MakeReverseCuthillMcKee(
+      const PropertyGraph* pg, const EdgeShuffleTopology& seed_topo) noexcept;
+
+  static std::unique_ptr<ShuffleTopology> MakeBFSOrder(
+      const PropertyGraph* pg, const EdgeShuffleTopology& seed_topo) noexcept;
+
+  static std::unique_ptr<ShuffleTopology> MakeGorder(
+      const PropertyGraph* pg, const EdgeShuffleTopology& seed_topo) noexcept;
+
+  static std::unique_ptr<ShuffleTopology> MakeHubClustered(
+      const PropertyGraph* pg, const EdgeShuffleTopology& seed_topo) noexcept;
+
   static std::unique_ptr<ShuffleTopology> MakeFromTopo(
       const PropertyGraph* pg, const EdgeShuffleTopology& seed_topo,
       const NodeSortKind& node_sort_todo,
@@ -366,6 +618,18 @@ public:
     case NodeSortKind::kSortedByNodeType:
       ret = MakeSortedByNodeType(pg, seed_topo);
       break;
+    case NodeSortKind::kReverseCuthillMcKee:
+      ret = MakeReverseCuthillMcKee(pg, seed_topo);
+      break;
+    case NodeSortKind::kBFSOrder:
+      ret = MakeBFSOrder(pg, seed_topo);
+      break;
+    case NodeSortKind::kGorder:
+      ret = MakeGorder(pg, seed_topo);
+      break;
+    case NodeSortKind::kHubCluster:
+      ret = MakeHubClustered(pg, seed_topo);
+      break;
     default:
       KATANA_LOG_FATAL("switch case fell through");
     }
@@ -376,6 +640,18 @@ public:
   }
 
 private:
+  /// Hides EdgeShuffleTopology::sortEdges so that destinations, which are
+  /// renumbered, are mapped back to nodes of the PropertyGraph to find their
+  /// types
+  void sortEdges(
+      const PropertyGraph* pg, const EdgeSortKind& edge_sort_todo) noexcept {
+    if (edge_sort_todo == EdgeSortKind::kSortedByNodeType) {
+      SortEdgesByDestType(pg, node_prop_indices_);
+      return;
+    }
+    Base::sortEdges(pg, edge_sort_todo);
+  }
+
   template <typename CmpFunc>
   static std::unique_ptr<ShuffleTopology> MakeNodeSortedTopo(
       const EdgeShuffleTopology& seed_topo, const CmpFunc& cmp,
@@ -391,61 +667,16 @@ private:
         node_prop_indices.begin(), node_prop_indices.end(),
         [&](const auto& i1, const auto& i2) { return cmp(i1, i2); });
 
-    GraphTopology::AdjIndexVec degrees;
-    degrees.allocateInterleaved(seed_topo.num_nodes());
-
-    katana::NUMAArray<GraphTopologyTypes::Node> old_to_new_map;
-    old_to_new_map.allocateInterleaved(seed_topo.num_nodes());
-    // TODO(amber): given 32-bit node ids, put a check here that
-    // node_prop_indices.size() < 2^32
-    katana::do_all(
-        katana::iterate(size_t{0}, node_prop_indices.size()),
-        [&](auto i) {
-          // node_prop_indices[i] gives old node id
-          old_to_new_map[node_prop_indices[i]] = i;
-          degrees[i] = seed_topo.degree(node_prop_indices[i]);
-        },
-        katana::no_stats());
-
-    KATANA_LOG_DEBUG_ASSERT(std::is_sorted(degrees.begin(), degrees.end()));
-
-    katana::ParallelSTL::partial_sum(
-        degrees.begin(), degrees.end(), degrees.begin());
-
-    GraphTopologyTypes::EdgeDestVec new_dest_vec;
-    new_dest_vec.allocateInterleaved(seed_topo.num_edges());
-
-    GraphTopologyTypes::PropIndexVec edge_prop_indices;
-    edge_prop_indices.allocateInterleaved(seed_topo.num_edges());
-
-    katana::do_all(
-        katana::iterate(seed_topo.all_nodes()),
-        [&](auto old_srd_id) {
-          auto new_srd_id = old_to_new_map[old_srd_id];
-          auto new_out_index = new_srd_id > 0 ? degrees[new_srd_id - 1] : 0;
-
-          for (auto e : seed_topo.edges(old_srd_id)) {
-            auto new_edge_dest = old_to_new_map[seed_topo.edge_dest(e)];
-
-            auto new_edge_id = new_out_index;
-            ++new_out_index;
-            KATANA_LOG_DEBUG_ASSERT(new_out_index <= degrees[new_srd_id]);
-
-            new_dest_vec[new_edge_id] = new_edge_dest;
-
-            // copy over edge_property_index mapping from old edge to new edge
-            edge_prop_indices[new_edge_id] = seed_topo.edge_property_index(e);
-          }
-        },
-        katana::steal(), katana::no_stats());
-
-    return std::make_unique<ShuffleTopology>(ShuffleTopology{
-        seed_topo.transpose_state(), node_sort_todo,
-        seed_topo.edge_sort_state(), std::move(degrees),
-        std::move(node_prop_indices), std::move(new_dest_vec),
-        std::move(edge_prop_indices)});
+    return MakeFromNodeOrder(
+        seed_topo, std::move(node_prop_indices), node_sort_todo);
   }
 
+  /// Renumber the nodes of \p seed_topo so that new node i is old node
+  /// node_prop_indices[i]
+  static std::unique_ptr<ShuffleTopology> MakeFromNodeOrder(
+      const EdgeShuffleTopology& seed_topo, PropIndexVec&& node_prop_indices,
+      const NodeSortKind& node_sort_todo) noexcept;
+
   ShuffleTopology(
       const TransposeKind& tpose_todo, const NodeSortKind& node_sort_todo,
       const EdgeSortKind& edge_sort_todo, AdjIndexVec&& adj_indices,
@@ -490,7 +721,9 @@ public:
 
   static std::unique_ptr<CondensedTypeIDMap> MakeFromEdgeTypes(
       const PropertyGraph* pg) noexcept;
-  // TODO(amber): add MakeFromNodeTypes
+
+  static std::unique_ptr<CondensedTypeIDMap> MakeFromNodeTypes(
+      const PropertyGraph* pg) noexcept;
 
   EntityType GetType(uint32_t index) const noexcept {
     KATANA_LOG_DEBUG_ASSERT(size_t(index) < index_to_type_map_.size());
@@ -514,6 +747,18 @@ public:
   ///
   /// @returns Range of the distinct edge types
   EdgeTypeIDRange distinct_edge_type_ids() const noexcept {
+    return distinct_type_ids();
+  }
+
+  /// @param type: entity type to check
+  /// @returns true iff some entity of the graph, edge or node depending on
+  /// how the map was made, has that type
+  bool has_type_id(const EntityType& type) const noexcept {
+    return type_to_index_map_.find(type) != type_to_index_map_.cend();
+  }
+
+  /// @returns Range of the distinct types, in index order
+  EdgeTypeIDRange distinct_type_ids() const noexcept {
     return EdgeTypeIDRange{
         index_to_type_map_.cbegin(), index_to_type_map_.cend()};
   }
@@ -536,6 +781,225 @@ private:
   bool is_valid_ = true;
 };
 
+/// The IDs of the nodes, or of the edges, that have each entity type, so
+/// that a loop over the entities of one type visits only them instead of
+/// testing the type of every entity:
+///
+/// \code
+/// auto partition = pg->GetNodeTypePartition();
+/// katana::do_all(
+///     katana::iterate(partition->entities(pg->GetNodeEntityTypeID("Person"))),
+///     [&](Node n) { ... });
+/// \endcode
+///
+/// An entity has a type if its most specific type is that type or one of its
+/// subtypes, so an entity of an intersection type is in the list of each of
+/// its atomic types as well. kUnknownEntityType lists the entities whose type
+/// is unknown. The lists are built with one parallel counting sort over the
+/// entities.
+template <typename Entity>
+class KATANA_EXPORT EntityTypePartition : public GraphTopologyTypes {
+public:
+  using EntitiesRange = StandardRange<const Entity*>;
+
+  EntityTypePartition(EntityTypePartition&&) = default;
+  EntityTypePartition& operator=(EntityTypePartition&&) = default;
+
+  EntityTypePartition(const EntityTypePartition&) = delete;
+  EntityTypePartition& operator=(const EntityTypePartition&) = delete;
+
+  /// \p entity_types holds the most specific type of each of the
+  /// \p num_entities entities, as types of \p manager
+  static std::unique_ptr<EntityTypePartition> Make(
+      const EntityTypeManager& manager, const EntityType* entity_types,
+      size_t num_entities) noexcept;
+
+  /// The entities that have \p type, in increasing order of ID; empty if
+  /// there is no such type
+  EntitiesRange entities(EntityType type) const noexcept {
+    if (size_t(type) >= num_types()) {
+      return EntitiesRange{nullptr, nullptr};
+    }
+    const Entity* data = entities_.data();
+    return EntitiesRange{data + offsets_[type], data + offsets_[type + 1]};
+  }
+
+  /// The number of entities that have \p type
+  size_t num_entities(EntityType type) const noexcept {
+    return entities(type).size();
+  }
+
+  /// The number of entity types, including kUnknownEntityType
+  size_t num_types() const noexcept {
+    return offsets_.empty() ? 0 : offsets_.size() - 1;
+  }
+
+  /// Bytes held by the lists
+  size_t num_bytes() const noexcept {
+    return offsets_.size() * sizeof(uint64_t) +
+           entities_.size() * sizeof(Entity);
+  }
+
+private:
+  EntityTypePartition(
+      NUMAArray<uint64_t>&& offsets, NUMAArray<Entity>&& entities) noexcept
+      : offsets_(std::move(offsets)), entities_(std::move(entities)) {}
+
+  /// The entities of type t are entities_[offsets_[t], offsets_[t + 1])
+  NUMAArray<uint64_t> offsets_;
+  NUMAArray<Entity> entities_;
+};
+
+using NodeTypePartition = EntityTypePartition<GraphTopologyTypes::Node>;
+using EdgeTypePartition = EntityTypePartition<GraphTopologyTypes::Edge>;
+
+/// A copy of an EdgeShuffleTopology whose adjacency indices and edge
+/// property indices are EdgeIndex wide, e.g., uint32_t for graphs (or
+/// partitions) with fewer than 2^32 edges. Edge scans that also look up edge
+/// properties then stream half the bytes of the 64-bit topologies.
+///
+/// Kernels written against a topology template parameter work unchanged; see
+/// EdgesSortedByDestAnyWidthTopology for picking the width at run time.
+template <typename EdgeIndex>
+class CompactTopology {
+  static_assert(
+      std::is_integral_v<EdgeIndex> && std::is_unsigned_v<EdgeIndex>,
+      "EdgeIndex must be an unsigned integer");
+
+public:
+  using Node = GraphTopologyTypes::Node;
+  using Edge = EdgeIndex;
+  using PropertyIndex = EdgeIndex;
+  using EntityType = GraphTopologyTypes::EntityType;
+  using node_iterator = GraphTopologyTypes::node_iterator;
+  using edge_iterator = boost::counting_iterator<Edge>;
+  using nodes_range = StandardRange<node_iterator>;
+  using edges_range = StandardRange<edge_iterator>;
+  using iterator = node_iterator;
+  using TransposeKind = EdgeShuffleTopology::TransposeKind;
+  using EdgeSortKind = EdgeShuffleTopology::EdgeSortKind;
+
+  CompactTopology(CompactTopology&&) = default;
+  CompactTopology& operator=(CompactTopology&&) = default;
+
+  CompactTopology(const CompactTopology&) = delete;
+  CompactTopology& operator=(const CompactTopology&) = delete;
+
+  /// \returns true if \p topo can be represented with EdgeIndex wide indices
+  static bool Fits(const EdgeShuffleTopology& topo) noexcept {
+    return topo.num_edges() <= std::numeric_limits<EdgeIndex>::max();
+  }
+
+  static std::unique_ptr<CompactTopology> Make(
+      const EdgeShuffleTopology& topo) noexcept {
+    KATANA_LOG_VASSERT(
+        Fits(topo), "{} edges do not fit in {} byte indices", topo.num_edges(),
+        sizeof(EdgeIndex));
+
+    std::unique_ptr<CompactTopology> ret(new CompactTopology(topo));
+    ret->adj_indices_.allocateInterleaved(topo.num_nodes());
+    ret->dests_.allocateInterleaved(topo.num_edges());
+    ret->edge_prop_indices_.allocateInterleaved(topo.num_edges());
+
+    katana::do_all(
+        katana::iterate(topo.all_nodes()),
+        [&](Node node) {
+          ret->adj_indices_[node] =
+              static_cast<EdgeIndex>(*topo.edges(node).end());
+        },
+        katana::no_stats());
+    katana::do_all(
+        katana::iterate(topo.all_edges()),
+        [&](GraphTopologyTypes::Edge e) {
+          ret->dests_[e] = topo.edge_dest(e);
+          ret->edge_prop_indices_[e] =
+              static_cast<EdgeIndex>(topo.edge_property_index(e));
+        },
+        katana::no_stats());
+
+    return ret;
+  }
+
+  uint64_t num_nodes() const noexcept { return adj_indices_.size(); }
+
+  uint64_t num_edges() const noexcept { return dests_.size(); }
+
+  bool has_transpose_state(const TransposeKind& expected) const noexcept {
+    return tpose_state_ == expected;
+  }
+
+  bool has_edges_sorted_by(const EdgeSortKind& kind) const noexcept {
+    return kind == EdgeSortKind::kAny || edge_sort_state_ == kind;
+  }
+
+  bool is_valid() const noexcept { return is_valid_; }
+
+  void invalidate() noexcept { is_valid_ = false; }
+
+  edges_range edges(Node node) const noexcept {
+    KATANA_LOG_DEBUG_ASSERT(node < adj_indices_.size());
+    edge_iterator e_beg{node > 0 ? adj_indices_[node - 1] : Edge{0}};
+    edge_iterator e_end{adj_indices_[node]};
+    return MakeStandardRange(e_beg, e_end);
+  }
+
+  Node edge_dest(Edge edge_id) const noexcept {
+    KATANA_LOG_DEBUG_ASSERT(edge_id < dests_.size());
+    return dests_[edge_id];
+  }
+
+  PropertyIndex edge_property_index(Edge edge_id) const noexcept {
+    KATANA_LOG_DEBUG_ASSERT(edge_id < edge_prop_indices_.size());
+    return edge_prop_indices_[edge_id];
+  }
+
+  const PropertyIndex* edge_prop_index_data() const noexcept {
+    return edge_prop_indices_.data();
+  }
+
+  size_t degree(Node node) const noexcept { return edges(node).size(); }
+
+  nodes_range all_nodes() const noexcept {
+    return MakeStandardRange<node_iterator>(
+        Node{0}, static_cast<Node>(num_nodes()));
+  }
+
+  edges_range all_edges() const noexcept {
+    return MakeStandardRange<edge_iterator>(
+        Edge{0}, static_cast<Edge>(num_edges()));
+  }
+
+  /// Requires edges sorted by destination
+  edge_iterator find_edge(const Node& src, const Node& dst) const noexcept {
+    KATANA_LOG_DEBUG_ASSERT(has_edges_sorted_by(EdgeSortKind::kSortedByDestID));
+    auto e_range = edges(src);
+    const Node* begin = dests_.data() + *e_range.begin();
+    const Node* end = dests_.data() + *e_range.end();
+    const Node* it = std::lower_bound(begin, end, dst);
+    if (it == end || *it != dst) {
+      return e_range.end();
+    }
+    return edge_iterator{static_cast<Edge>(it - dests_.data())};
+  }
+
+  bool has_edge(const Node& src, const Node& dst) const noexcept {
+    return find_edge(src, dst) != edges(src).end();
+  }
+
+private:
+  explicit CompactTopology(const EdgeShuffleTopology& topo) noexcept
+      : tpose_state_(topo.transpose_state()),
+        edge_sort_state_(topo.edge_sort_state()) {}
+
+  NUMAArray<EdgeIndex> adj_indices_;
+  NUMAArray<Node> dests_;
+  NUMAArray<EdgeIndex> edge_prop_indices_;
+
+  bool is_valid_{true};
+  TransposeKind tpose_state_;
+  EdgeSortKind edge_sort_state_;
+};
+
 template <typename Topo>
 class KATANA_EXPORT BasicTopologyWrapper : public GraphTopologyTypes {
 public:
@@ -561,6 +1025,10 @@ public:
     return topo().edge_source(eid);
   }
 
+  /// The destinations of all edges indexed by edge ID, so that the
+  /// neighbors of a node can be handed to kernels over plain arrays
+  const Node* dest_data() const noexcept { return topo().dest_data(); }
+
   /// @param node node to get degree for
   /// @returns Degree of node N
   auto degree(const Node& node) const noexcept { return topo().degree(node); }
@@ -598,6 +1066,10 @@ public:
     return topo().original_edge_id(eid);
   }
 
+  auto edge_prop_index_data() const noexcept {
+    return topo().edge_prop_index_data();
+  }
+
 protected:
   const Topo& topo() const noexcept { return *topo_ptr_; }
 
@@ -621,6 +1093,64 @@ struct EdgeDestComparator {
     return n < topo_->edge_dest(e);
   }
 };
+
+/// Where the edges of each (node, type) pair begin and end, for a topology
+/// whose edges are grouped by a type, e.g., the type of the edge or of its
+/// destination, in the index order of a CondensedTypeIDMap.
+///
+/// The dense form holds a prefix sum per (node, type) pair: num_nodes *
+/// num_unique_types entries, with O(1) lookups. The sparse form holds one
+/// run per type that is actually present at a node: per node, the end of
+/// its runs in node_runs, and per run, its type index and end edge. Lookups
+/// are a binary search over the node's runs. The smaller of the two is
+/// built.
+struct KATANA_EXPORT PerTypeAdjIndex : public GraphTopologyTypes {
+  AdjIndexVec dense;
+  NUMAArray<uint64_t> node_runs;
+  NUMAArray<uint32_t> run_types;
+  AdjIndexVec run_ends;
+
+  bool is_sparse() const noexcept { return !node_runs.empty(); }
+
+  size_t bytes() const noexcept {
+    return dense.size() * sizeof(Edge) + node_runs.size() * sizeof(uint64_t) +
+           run_types.size() * sizeof(uint32_t) +
+           run_ends.size() * sizeof(Edge);
+  }
+
+  /// @param N node to get edges for
+  /// @param type_idx index of the type, of num_types
+  /// @param node_edges all edges of N
+  /// @returns Range to edges of node N of the type
+  edges_range edges(
+      Node N, uint32_t type_idx, size_t num_types,
+      const edges_range& node_edges) const noexcept {
+    if (!is_sparse()) {
+      // The dense index stores num_types prefix sums per node; we pick the
+      // prefix sum based on the index of the type
+      auto idx = (N * num_types) + type_idx;
+      KATANA_LOG_DEBUG_ASSERT(idx < dense.size());
+      edge_iterator e_beg{(idx == 0) ? 0 : dense[idx - 1]};
+      edge_iterator e_end{dense[idx]};
+      return katana::MakeStandardRange(e_beg, e_end);
+    }
+
+    // The sparse index stores one run per type present at a node, in type
+    // index order; binary search the node's runs
+    uint64_t r_beg = N > 0 ? node_runs[N - 1] : 0;
+    uint64_t r_end = node_runs[N];
+    const uint32_t* types = run_types.data();
+    uint64_t r = std::lower_bound(types + r_beg, types + r_end, type_idx) -
+                 types;
+
+    edge_iterator e_beg{r == r_beg ? *node_edges.begin() : run_ends[r - 1]};
+    if (r == r_end || types[r] != type_idx) {
+      return katana::MakeStandardRange(e_beg, e_beg);
+    }
+    edge_iterator e_end{run_ends[r]};
+    return katana::MakeStandardRange(e_beg, e_end);
+  }
+};
 }  // end namespace internal
 
 /// store adjacency indices per each node such that they are divided by edge edge_type type.
@@ -644,21 +1174,10 @@ public:
   /// @param edge_type edge_type to get edges of
   /// @returns Range to edges of node N that have edge type == edge_type
   edges_range edges(Node N, const EntityType& edge_type) const noexcept {
-    // per_type_adj_indices_ is expanded so that it stores P prefix sums per node, where
-    // P == edge_type_index_->num_unique_types()
-    // We pick the prefix sum based on the index of the edge_type provided
     KATANA_LOG_DEBUG_ASSERT(edge_type_index_->num_unique_types() > 0);
-    auto beg_idx = (N * edge_type_index_->num_unique_types()) +
-                   edge_type_index_->GetIndex(edge_type);
-    edge_iterator e_beg{
-        (beg_idx == 0) ? 0 : per_type_adj_indices_[beg_idx - 1]};
-
-    auto end_idx = (N * edge_type_index_->num_unique_types()) +
-                   edge_type_index_->GetIndex(edge_type);
-    KATANA_LOG_DEBUG_ASSERT(end_idx < per_type_adj_indices_.size());
-    edge_iterator e_end{per_type_adj_indices_[end_idx]};
-
-    return katana::MakeStandardRange(e_beg, e_end);
+    return per_type_adj_index_.edges(
+        N, edge_type_index_->GetIndex(edge_type),
+        edge_type_index_->num_unique_types(), Base::edges(N));
   }
 
   // C++ Derived classes hides Base class methods with the same name
@@ -788,34 +1307,168 @@ public:
     const_cast<EdgeShuffleTopology*>(edge_shuff_topo_)->invalidate();
   }
 
+  /// Bytes used by the per edge type index, on top of the shuffled topology
+  size_t per_type_index_bytes() const noexcept {
+    return per_type_adj_index_.bytes();
+  }
+
+  bool has_sparse_per_type_index() const noexcept {
+    return per_type_adj_index_.is_sparse();
+  }
+
 private:
+  using PerTypeAdjIndex = internal::PerTypeAdjIndex;
+
   // Must invoke SortAllEdgesByDataThenDst() before
   // calling this function
-  static AdjIndexVec CreatePerEdgeTypeAdjacencyIndex(
+  static PerTypeAdjIndex CreatePerEdgeTypeAdjacencyIndex(
       const PropertyGraph* pg, const CondensedTypeIDMap* edge_type_index,
       const EdgeShuffleTopology* topo) noexcept;
 
   EdgeTypeAwareTopology(
       const PropertyGraph* pg, const CondensedTypeIDMap* edge_type_index,
       const EdgeShuffleTopology* e_topo,
-      AdjIndexVec&& per_type_adj_indices) noexcept
+      PerTypeAdjIndex&& per_type_adj_index) noexcept
       :
 
         Base(e_topo),
         edge_type_index_(edge_type_index),
         edge_shuff_topo_(e_topo),
-        per_type_adj_indices_(std::move(per_type_adj_indices)) {
+        per_type_adj_index_(std::move(per_type_adj_index)) {
     KATANA_LOG_ASSERT(pg);
     KATANA_LOG_DEBUG_ASSERT(edge_type_index);
 
     KATANA_LOG_DEBUG_ASSERT(
-        per_type_adj_indices_.size() ==
-        edge_shuff_topo_->num_nodes() * edge_type_index_->num_unique_types());
+        per_type_adj_index_.is_sparse()
+            ? per_type_adj_index_.node_runs.size() ==
+                  edge_shuff_topo_->num_nodes()
+            : per_type_adj_index_.dense.size() ==
+                  edge_shuff_topo_->num_nodes() *
+                      edge_type_index_->num_unique_types());
   }
 
   const CondensedTypeIDMap* edge_type_index_;
   const EdgeShuffleTopology* edge_shuff_topo_;
-  AdjIndexVec per_type_adj_indices_;
+  PerTypeAdjIndex per_type_adj_index_;
+};
+
+/// Store adjacency indices per node such that they are divided by the type
+/// of the destination node, so that a kernel that follows only edges to
+/// nodes of one type, e.g., one step of a metapath, scans just those edges.
+/// Requires sorting the edges by destination node type, which also sorts
+/// the edges to nodes of one type by destination.
+class KATANA_EXPORT DestTypeAwareTopology
+    : public BasicTopologyWrapper<EdgeShuffleTopology> {
+  using Base = BasicTopologyWrapper<EdgeShuffleTopology>;
+
+public:
+  DestTypeAwareTopology(DestTypeAwareTopology&&) = default;
+  DestTypeAwareTopology& operator=(DestTypeAwareTopology&&) = default;
+
+  DestTypeAwareTopology(const DestTypeAwareTopology&) = delete;
+  DestTypeAwareTopology& operator=(const DestTypeAwareTopology&) = delete;
+
+  static std::unique_ptr<DestTypeAwareTopology> MakeFrom(
+      const PropertyGraph* pg, const CondensedTypeIDMap* node_type_index,
+      const EdgeShuffleTopology* e_topo) noexcept;
+
+  /// @param N node to get edges for
+  /// @param dest_type node type of the destinations
+  /// @returns Range to edges of node N whose destination has type dest_type
+  edges_range edges(Node N, const EntityType& dest_type) const noexcept {
+    KATANA_LOG_DEBUG_ASSERT(node_type_index_->num_unique_types() > 0);
+    return per_type_adj_index_.edges(
+        N, node_type_index_->GetIndex(dest_type),
+        node_type_index_->num_unique_types(), Base::edges(N));
+  }
+
+  // C++ Derived classes hides Base class methods with the same name
+  auto edges(const Node& N) const noexcept { return Base::edges(N); };
+
+  /// @param N node to get degree for
+  /// @param dest_type node type of the destinations
+  /// @returns Number of edges of node N to nodes of type dest_type
+  size_t degree(Node N, const EntityType& dest_type) const noexcept {
+    return edges(N, dest_type).size();
+  }
+
+  // C++ Derived classes hides Base class methods with the same name
+  auto degree(const Node& N) const noexcept { return Base::degree(N); }
+
+  auto GetDistinctNodeTypes() const noexcept {
+    return node_type_index_->distinct_type_ids();
+  }
+
+  bool DoesNodeTypeExist(const EntityType& node_type) const noexcept {
+    return node_type_index_->has_type_id(node_type);
+  }
+
+  /// Check if vertex src is connected to vertex dst, whose type is
+  /// dst_type, by binary searching the edges of src to nodes of that type
+  bool IsConnected(Node src, Node dst, const EntityType& dst_type) const {
+    auto e_range = edges(src, dst_type);
+    if (e_range.empty()) {
+      return false;
+    }
+
+    internal::EdgeDestComparator<DestTypeAwareTopology> comp{this};
+    return std::binary_search(e_range.begin(), e_range.end(), dst, comp);
+  }
+
+  bool is_transposed() const noexcept {
+    return edge_shuff_topo_->is_transposed();
+  }
+
+  bool has_transpose_state(
+      const EdgeShuffleTopology::TransposeKind& k) const noexcept {
+    return edge_shuff_topo_->has_transpose_state(k);
+  }
+
+  bool is_valid() const noexcept { return edge_shuff_topo_->is_valid(); }
+
+  void invalidate() noexcept {
+    const_cast<EdgeShuffleTopology*>(edge_shuff_topo_)->invalidate();
+  }
+
+  /// Bytes used by the per destination type index, on top of the shuffled
+  /// topology
+  size_t per_type_index_bytes() const noexcept {
+    return per_type_adj_index_.bytes();
+  }
+
+  bool has_sparse_per_type_index() const noexcept {
+    return per_type_adj_index_.is_sparse();
+  }
+
+private:
+  using PerTypeAdjIndex = internal::PerTypeAdjIndex;
+
+  static PerTypeAdjIndex CreatePerDestTypeAdjacencyIndex(
+      const PropertyGraph* pg, const CondensedTypeIDMap* node_type_index,
+      const EdgeShuffleTopology* e_topo) noexcept;
+
+  DestTypeAwareTopology(
+      const CondensedTypeIDMap* node_type_index,
+      const EdgeShuffleTopology* e_topo,
+      PerTypeAdjIndex&& per_type_adj_index) noexcept
+      : Base(e_topo),
+        node_type_index_(node_type_index),
+        edge_shuff_topo_(e_topo),
+        per_type_adj_index_(std::move(per_type_adj_index)) {
+    KATANA_LOG_DEBUG_ASSERT(node_type_index);
+
+    KATANA_LOG_DEBUG_ASSERT(
+        per_type_adj_index_.is_sparse()
+            ? per_type_adj_index_.node_runs.size() ==
+                  edge_shuff_topo_->num_nodes()
+            : per_type_adj_index_.dense.size() ==
+                  edge_shuff_topo_->num_nodes() *
+                      node_type_index_->num_unique_types());
+  }
+
+  const CondensedTypeIDMap* node_type_index_;
+  const EdgeShuffleTopology* edge_shuff_topo_;
+  PerTypeAdjIndex per_type_adj_index_;
 };
 
 template <typename OutTopo, typename InTopo>
@@ -897,6 +1550,123 @@ using EdgesSortedByDestTopology = SortedTopologyWrapper<EdgeShuffleTopology>;
 using NodesSortedByDegreeEdgesSortedByDestIDTopology =
     SortedTopologyWrapper<ShuffleTopology>;
 
+/// A topology whose nodes are renumbered by kNodeSortKind to improve
+/// locality, with edges sorted by destination. Node IDs are those of the
+/// reordered topology; node_property_index() maps them back to the nodes of
+/// the PropertyGraph. With kTransposeKind == kYes the edges are in-edges,
+/// which suits pull-style kernels.
+template <
+    ShuffleTopology::NodeSortKind kNodeSortKind,
+    EdgeShuffleTopology::TransposeKind kTransposeKind>
+class NodesReorderedEdgesSortedByDestIDTopology
+    : public SortedTopologyWrapper<ShuffleTopology> {
+  using Base = SortedTopologyWrapper<ShuffleTopology>;
+
+public:
+  explicit NodesReorderedEdgesSortedByDestIDTopology(
+      const ShuffleTopology* t) noexcept
+      : Base(t) {
+    KATANA_LOG_DEBUG_ASSERT(Base::topo().has_nodes_sorted_by(kNodeSortKind));
+    KATANA_LOG_DEBUG_ASSERT(Base::topo().has_transpose_state(kTransposeKind));
+  }
+
+  auto node_property_index(const Node& N) const noexcept {
+    return Base::topo().node_property_index(N);
+  }
+};
+
+/// The graph with every edge in both directions, as triangle counting,
+/// k-truss, k-core, Louvain and connected components expect: the out- and
+/// in-edges of each node merged and sorted by destination, without
+/// duplicates or self-loops. edge_property_index() maps an edge to the
+/// original edge with the smallest ID among those joining its two nodes, so
+/// both directions of an edge have the same properties.
+class KATANA_EXPORT UndirectedTopology
+    : public SortedTopologyWrapper<EdgeShuffleTopology> {
+  using Base = SortedTopologyWrapper<EdgeShuffleTopology>;
+
+public:
+  explicit UndirectedTopology(const EdgeShuffleTopology* t) noexcept
+      : Base(t) {}
+};
+
+/// Edges sorted by destination, held by a 32-bit CompactTopology when the
+/// graph has fewer than 2^32 edges and by the 64-bit EdgeShuffleTopology
+/// otherwise. Run a kernel that is templated on the topology type with
+/// Visit; it is instantiated for both widths and called with whichever is
+/// present:
+///
+///     view.Visit([&](const auto& topo) { return BFS(topo, source); });
+class KATANA_EXPORT EdgesSortedByDestAnyWidthTopology {
+public:
+  using Compact = CompactTopology<uint32_t>;
+
+  explicit EdgesSortedByDestAnyWidthTopology(const Compact* compact) noexcept
+      : compact_(compact) {
+    KATANA_LOG_DEBUG_ASSERT(compact_);
+  }
+
+  explicit EdgesSortedByDestAnyWidthTopology(
+      const EdgeShuffleTopology* wide) noexcept
+      : wide_(EdgesSortedByDestTopology{wide}) {}
+
+  bool is_compact() const noexcept { return compact_ != nullptr; }
+
+  template <typename Fn>
+  decltype(auto) Visit(Fn&& fn) const {
+    if (compact_) {
+      return fn(*compact_);
+    }
+    return fn(*wide_);
+  }
+
+  uint64_t num_nodes() const noexcept {
+    return Visit([](const auto& topo) -> uint64_t { return topo.num_nodes(); });
+  }
+
+  uint64_t num_edges() const noexcept {
+    return Visit([](const auto& topo) -> uint64_t { return topo.num_edges(); });
+  }
+
+private:
+  const Compact* compact_{nullptr};
+  std::optional<EdgesSortedByDestTopology> wide_;
+};
+
+/// The out-edges of a DestTypeAwareTopology, held by a view
+class KATANA_EXPORT DestTypeAwareTopoWrapper
+    : public BasicTopologyWrapper<DestTypeAwareTopology> {
+  using Base = BasicTopologyWrapper<DestTypeAwareTopology>;
+
+public:
+  explicit DestTypeAwareTopoWrapper(const DestTypeAwareTopology* t) noexcept
+      : Base(t) {}
+
+  auto GetDistinctNodeTypes() const noexcept {
+    return Base::topo().GetDistinctNodeTypes();
+  }
+
+  bool DoesNodeTypeExist(const EntityType& node_type) const noexcept {
+    return Base::topo().DoesNodeTypeExist(node_type);
+  }
+
+  auto edges(Node N, const EntityType& dest_type) const noexcept {
+    return Base::topo().edges(N, dest_type);
+  }
+
+  auto edges(Node N) const noexcept { return Base::topo().edges(N); }
+
+  auto degree(Node N, const EntityType& dest_type) const noexcept {
+    return Base::topo().degree(N, dest_type);
+  }
+
+  auto degree(Node N) const noexcept { return Base::topo().degree(N); }
+
+  bool IsConnected(Node src, Node dst, const EntityType& dst_type) const {
+    return Base::topo().IsConnected(src, dst, dst_type);
+  }
+};
+
 class KATANA_EXPORT EdgeTypeAwareBiDirTopology
     : public BasicBiDirTopoWrapper<
           EdgeTypeAwareTopology, EdgeTypeAwareTopology> {
@@ -1009,19 +1779,95 @@ public:
   }
 };
 
+/// The order of the edges of a view relative to the edges of its property
+/// graph: edge e of the view has the properties of edge property_index(e) of
+/// the graph. A default constructed order is the graph's own. An order keeps
+/// the topology that defines it alive.
+class EdgeOrder {
+public:
+  EdgeOrder() = default;
+
+  /// The edge order of \p topo, e.g., an EdgeShuffleTopology or a
+  /// CompactTopology<uint32_t>
+  template <typename Topo>
+  explicit EdgeOrder(const std::shared_ptr<Topo>& topo) noexcept
+      : EdgeOrder(topo, topo->num_edges()) {}
+
+  /// The edge order of \p topo, whose edges are some of those of a graph
+  /// with \p num_rows edges, or some of them more than once, e.g., an
+  /// UndirectedTopology
+  template <typename Topo>
+  EdgeOrder(const std::shared_ptr<Topo>& topo, uint64_t num_rows) noexcept
+      : topo_(topo), num_edges_(topo->num_edges()), num_rows_(num_rows) {
+    SetIndices(topo->edge_prop_index_data());
+  }
+
+  /// True if the edges are in the order of the property graph
+  bool is_original() const noexcept { return topo_ == nullptr; }
+
+  uint64_t num_edges() const noexcept { return num_edges_; }
+
+  /// The number of edges of the graph, i.e., of rows of its edge properties
+  uint64_t num_rows() const noexcept { return num_rows_; }
+
+  uint64_t property_index(uint64_t e) const noexcept {
+    KATANA_LOG_DEBUG_ASSERT(!is_original() && e < num_edges_);
+    return wide_ ? wide_[e] : narrow_[e];
+  }
+
+  /// The property indices when they are 64 bits wide, otherwise nullptr
+  const uint64_t* wide_indices() const noexcept { return wide_; }
+  /// The property indices when they are 32 bits wide, otherwise nullptr
+  const uint32_t* narrow_indices() const noexcept { return narrow_; }
+
+  /// The topology that defines the order, to tell orders apart
+  const std::shared_ptr<const void>& topology() const noexcept {
+    return topo_;
+  }
+
+private:
+  void SetIndices(const uint64_t* indices) noexcept { wide_ = indices; }
+  void SetIndices(const uint32_t* indices) noexcept { narrow_ = indices; }
+
+  std::shared_ptr<const void> topo_;
+  const uint64_t* wide_{nullptr};
+  const uint32_t* narrow_{nullptr};
+  uint64_t num_edges_{0};
+  uint64_t num_rows_{0};
+};
+
 template <typename Topo>
 class BasicPropGraphViewWrapper : public Topo {
   using Base = Topo;
 
 public:
+  /// \p pins keeps the topologies that \p topo points to alive for as long
+  /// as the view, even if PGViewCache evicts them. \p edge_order and
+  /// \p in_edge_order are the orders of the out- and in-edges of \p topo.
   explicit BasicPropGraphViewWrapper(
-      const PropertyGraph* pg, const Topo& topo) noexcept
-      : Base(topo), prop_graph_(pg) {}
+      const PropertyGraph* pg, const Topo& topo,
+      std::vector<std::shared_ptr<const void>> pins = {},
+      EdgeOrder edge_order = {}, EdgeOrder in_edge_order = {}) noexcept
+      : Base(topo),
+        prop_graph_(pg),
+        pins_(std::move(pins)),
+        edge_order_(std::move(edge_order)),
+        in_edge_order_(std::move(in_edge_order)) {}
 
   const PropertyGraph& property_graph() const noexcept { return *prop_graph_; }
 
+  /// The order of the (out-)edges of this view, e.g., for
+  /// PropertyGraph::GetEdgePropertyInOrder
+  const EdgeOrder& edge_order() const noexcept { return edge_order_; }
+
+  /// The order of the in-edges of a view with in-edges
+  const EdgeOrder& in_edge_order() const noexcept { return in_edge_order_; }
+
 private:
   const PropertyGraph* prop_graph_;
+  std::vector<std::shared_ptr<const void>> pins_;
+  EdgeOrder edge_order_;
+  EdgeOrder in_edge_order_;
 };
 
 namespace internal {
@@ -1032,6 +1878,15 @@ using PGViewNodesSortedByDegreeEdgesSortedByDestID =
 using PGViewBiDirectional = BasicPropGraphViewWrapper<SimpleBiDirTopology>;
 using PGViewEdgeTypeAwareBiDir =
     BasicPropGraphViewWrapper<EdgeTypeAwareBiDirTopology>;
+using PGViewUndirected = BasicPropGraphViewWrapper<UndirectedTopology>;
+using PGViewDestTypeAware = BasicPropGraphViewWrapper<DestTypeAwareTopoWrapper>;
+using PGViewEdgesSortedByDestIDAnyWidth =
+    BasicPropGraphViewWrapper<EdgesSortedByDestAnyWidthTopology>;
+template <
+    ShuffleTopology::NodeSortKind kNodeSortKind,
+    EdgeShuffleTopology::TransposeKind kTransposeKind>
+using PGViewNodesReorderedEdgesSortedByDestID = BasicPropGraphViewWrapper<
+    NodesReorderedEdgesSortedByDestIDTopology<kNodeSortKind, kTransposeKind>>;
 
 template <typename PGView>
 struct PGViewBuilder {};
@@ -1044,10 +1899,11 @@ struct PGViewBuilder<PGViewBiDirectional> {
     auto tpose_topo = viewCache.BuildOrGetEdgeShuffTopo(
         pg, EdgeShuffleTopology::TransposeKind::kYes,
         EdgeShuffleTopology::EdgeSortKind::kAny);
-    auto bidir_topo =
-        SimpleBiDirTopology{viewCache.GetOriginalTopology(pg), tpose_topo};
+    auto bidir_topo = SimpleBiDirTopology{
+        viewCache.GetOriginalTopology(pg), tpose_topo.get()};
 
-    return PGViewBiDirectional{pg, bidir_topo};
+    return PGViewBiDirectional{
+        pg, bidir_topo, {tpose_topo}, EdgeOrder{}, EdgeOrder{tpose_topo}};
   }
 };
 
@@ -1061,7 +1917,8 @@ struct PGViewBuilder<PGViewEdgesSortedByDestID> {
         EdgeShuffleTopology::EdgeSortKind::kSortedByDestID);
 
     return PGViewEdgesSortedByDestID{
-        pg, EdgesSortedByDestTopology{sorted_topo}};
+        pg, EdgesSortedByDestTopology{sorted_topo.get()}, {sorted_topo},
+        EdgeOrder{sorted_topo}};
   }
 };
 
@@ -1076,7 +1933,8 @@ struct PGViewBuilder<PGViewNodesSortedByDegreeEdgesSortedByDestID> {
         EdgeShuffleTopology::EdgeSortKind::kSortedByDestID);
 
     return PGViewNodesSortedByDegreeEdgesSortedByDestID{
-        pg, NodesSortedByDegreeEdgesSortedByDestIDTopology{sorted_topo}};
+        pg, NodesSortedByDegreeEdgesSortedByDestIDTopology{sorted_topo.get()},
+        {sorted_topo}, EdgeOrder{sorted_topo}};
   }
 };
 
@@ -1091,7 +1949,79 @@ struct PGViewBuilder<PGViewEdgeTypeAwareBiDir> {
         pg, EdgeShuffleTopology::TransposeKind::kYes);
 
     return PGViewEdgeTypeAwareBiDir{
-        pg, EdgeTypeAwareBiDirTopology{out_topo, in_topo}};
+        pg, EdgeTypeAwareBiDirTopology{out_topo.get(), in_topo.get()},
+        {out_topo, in_topo}, EdgeOrder{out_topo}, EdgeOrder{in_topo}};
+  }
+};
+
+template <>
+struct PGViewBuilder<PGViewUndirected> {
+  template <typename ViewCache>
+  static PGViewUndirected BuildView(
+      const PropertyGraph* pg, ViewCache& viewCache) noexcept {
+    auto topo = viewCache.BuildOrGetUndirectedTopo(pg);
+
+    return PGViewUndirected{
+        pg, UndirectedTopology{topo.get()}, {topo},
+        EdgeOrder{topo, pg->num_edges()}};
+  }
+};
+
+template <>
+struct PGViewBuilder<PGViewDestTypeAware> {
+  template <typename ViewCache>
+  static PGViewDestTypeAware BuildView(
+      const PropertyGraph* pg, ViewCache& viewCache) noexcept {
+    auto topo = viewCache.BuildOrGetDestTypeAwareTopo(
+        pg, EdgeShuffleTopology::TransposeKind::kNo);
+
+    return PGViewDestTypeAware{
+        pg, DestTypeAwareTopoWrapper{topo.get()}, {topo}, EdgeOrder{topo}};
+  }
+};
+
+template <>
+struct PGViewBuilder<PGViewEdgesSortedByDestIDAnyWidth> {
+  template <typename ViewCache>
+  static PGViewEdgesSortedByDestIDAnyWidth BuildView(
+      const PropertyGraph* pg, ViewCache& viewCache) noexcept {
+    auto compact_topo = viewCache.BuildOrGetCompactTopo(
+        pg, EdgeShuffleTopology::TransposeKind::kNo,
+        EdgeShuffleTopology::EdgeSortKind::kSortedByDestID);
+    if (compact_topo) {
+      return PGViewEdgesSortedByDestIDAnyWidth{
+          pg, EdgesSortedByDestAnyWidthTopology{compact_topo.get()},
+          {compact_topo}, EdgeOrder{compact_topo}};
+    }
+
+    auto sorted_topo = viewCache.BuildOrGetEdgeShuffTopo(
+        pg, EdgeShuffleTopology::TransposeKind::kNo,
+        EdgeShuffleTopology::EdgeSortKind::kSortedByDestID);
+    return PGViewEdgesSortedByDestIDAnyWidth{
+        pg, EdgesSortedByDestAnyWidthTopology{sorted_topo.get()},
+        {sorted_topo}, EdgeOrder{sorted_topo}};
+  }
+};
+
+template <
+    ShuffleTopology::NodeSortKind kNodeSortKind,
+    EdgeShuffleTopology::TransposeKind kTransposeKind>
+struct PGViewBuilder<
+    PGViewNodesReorderedEdgesSortedByDestID<kNodeSortKind, kTransposeKind>> {
+  using View =
+      PGViewNodesReorderedEdgesSortedByDestID<kNodeSortKind, kTransposeKind>;
+  using Topo =
+      NodesReorderedEdgesSortedByDestIDTopology<kNodeSortKind, kTransposeKind>;
+
+  template <typename ViewCache>
+  static View BuildView(
+      const PropertyGraph* pg, ViewCache& viewCache) noexcept {
+    auto sorted_topo = viewCache.BuildOrGetShuffTopo(
+        pg, kTransposeKind, kNodeSortKind,
+        EdgeShuffleTopology::EdgeSortKind::kSortedByDestID);
+
+    return View{
+        pg, Topo{sorted_topo.get()}, {sorted_topo}, EdgeOrder{sorted_topo}};
   }
 };
 
@@ -1101,24 +2031,123 @@ struct PropertyGraphViews {
   using BiDirectional = internal::PGViewBiDirectional;
   using EdgesSortedByDestID = internal::PGViewEdgesSortedByDestID;
   using EdgeTypeAwareBiDir = internal::PGViewEdgeTypeAwareBiDir;
+  /// Each edge in both directions, without duplicates or self-loops, for
+  /// analytics that expect a symmetric graph
+  using Undirected = internal::PGViewUndirected;
+  /// Out-edges grouped by the node type of their destinations
+  using DestTypeAware = internal::PGViewDestTypeAware;
   using NodesSortedByDegreeEdgesSortedByDestID =
       internal::PGViewNodesSortedByDegreeEdgesSortedByDestID;
+
+  /// Edges sorted by destination with 32-bit indices when the graph allows
+  using EdgesSortedByDestIDAnyWidth =
+      internal::PGViewEdgesSortedByDestIDAnyWidth;
+
+  /// Out-edges of nodes renumbered by a locality improving order
+  template <ShuffleTopology::NodeSortKind kNodeSortKind>
+  using NodesReorderedEdgesSortedByDestID =
+      internal::PGViewNodesReorderedEdgesSortedByDestID<
+          kNodeSortKind, EdgeShuffleTopology::TransposeKind::kNo>;
+  /// In-edges of nodes renumbered by a locality improving order, for
+  /// pull-style kernels
+  template <ShuffleTopology::NodeSortKind kNodeSortKind>
+  using NodesReorderedInEdgesSortedBySrcID =
+      internal::PGViewNodesReorderedEdgesSortedByDestID<
+          kNodeSortKind, EdgeShuffleTopology::TransposeKind::kYes>;
+
+  using ReverseCuthillMcKee = NodesReorderedEdgesSortedByDestID<
+      ShuffleTopology::NodeSortKind::kReverseCuthillMcKee>;
+  using BFSOrder = NodesReorderedEdgesSortedByDestID<
+      ShuffleTopology::NodeSortKind::kBFSOrder>;
+  using Gorder =
+      NodesReorderedEdgesSortedByDestID<ShuffleTopology::NodeSortKind::kGorder>;
+  using HubClustered = NodesReorderedEdgesSortedByDestID<
+      ShuffleTopology::NodeSortKind::kHubCluster>;
 };
 
+/// Builds and holds the topologies derived from a PropertyGraph's topology
+/// that back its views.
+///
+/// BuildView may be called from several threads at once, e.g., from the
+/// threads of a parallel loop, as long as the topologies it needs are cached:
+/// building one runs parallel loops, which may not be nested or started from
+/// two application threads at once. A topology is built once: threads that
+/// ask for one that is being built wait for it and share the result.
+///
+/// Cached topologies, edge properties gathered into the order of a view and
+/// temporal edge indexes are limited to byte_budget() bytes. When over
+/// budget, the least recently used topologies that no view refers to, and
+/// other entries that no caller holds, are dropped.
+/// Topologies still in use by some view are kept alive by that view, so
+/// eviction never invalidates a view; it only means the topology is rebuilt
+/// (or reloaded) by the next BuildView that needs it.
 class KATANA_EXPORT PGViewCache {
-  std::vector<std::unique_ptr<EdgeShuffleTopology>> edge_shuff_topos_;
-  std::vector<std::unique_ptr<ShuffleTopology>> fully_shuff_topos_;
-  std::vector<std::unique_ptr<EdgeTypeAwareTopology>> edge_type_aware_topos_;
-  std::unique_ptr<CondensedTypeIDMap> edge_type_id_map_;
-  // TODO(amber): define a node_type_id_map_;
+  template <typename Topo>
+  struct CacheEntry {
+    EdgeShuffleTopology::TransposeKind tpose_kind;
+    EdgeShuffleTopology::EdgeSortKind edge_sort_kind;
+    ShuffleTopology::NodeSortKind node_sort_kind;
+    // Ready once the topology is built
+    std::shared_future<std::shared_ptr<Topo>> topo;
+    uint64_t id{0};
+    uint64_t last_use{0};
+    size_t bytes{0};
+  };
+
+  std::vector<CacheEntry<EdgeShuffleTopology>> edge_shuff_topos_;
+  std::vector<CacheEntry<ShuffleTopology>> fully_shuff_topos_;
+  std::vector<CacheEntry<EdgeTypeAwareTopology>> edge_type_aware_topos_;
+  std::vector<CacheEntry<DestTypeAwareTopology>> dest_type_aware_topos_;
+  std::vector<CacheEntry<EdgeShuffleTopology>> undirected_topos_;
+  std::vector<CacheEntry<CompactTopology<uint32_t>>> compact_topos_;
+
+  /// An edge property gathered into the order of a view
+  struct OrderedEdgeProperty {
+    std::weak_ptr<const void> order;
+    // The column gathered from; the entry is stale once it is replaced
+    std::weak_ptr<arrow::ChunkedArray> column;
+    std::string name;
+    std::shared_ptr<arrow::Array> values;
+    uint64_t last_use{0};
+    size_t bytes{0};
+  };
+  std::vector<OrderedEdgeProperty> ordered_edge_props_;
+
+  struct TemporalIndexEntry {
+    std::string name;
+    EdgeShuffleTopology::TransposeKind tpose_kind;
+    // The timestamps indexed; the entry is stale once they are replaced
+    std::weak_ptr<arrow::ChunkedArray> column;
+    std::shared_ptr<const TemporalEdgeIndex> index;
+    uint64_t last_use{0};
+    size_t bytes{0};
+  };
+  std::vector<TemporalIndexEntry> temporal_indexes_;
+  std::shared_ptr<CondensedTypeIDMap> edge_type_id_map_;
+  std::shared_ptr<CondensedTypeIDMap> node_type_id_map_;
+  std::shared_ptr<NodeTypePartition> node_type_partition_;
+  std::shared_ptr<EdgeTypePartition> edge_type_partition_;
+  std::shared_ptr<const GraphProfile> graph_profile_;
+
+  // Protects everything above as well as the accounting below. Topologies are
+  // built without holding it.
+  mutable std::mutex mutex_;
+  size_t byte_budget_;
+  size_t cached_bytes_{0};
+  uint64_t clock_{0};
 
   template <typename>
   friend struct internal::PGViewBuilder;
 
 public:
-  PGViewCache() = default;
-  PGViewCache(PGViewCache&&) = default;
-  PGViewCache& operator=(PGViewCache&&) = default;
+  static constexpr size_t kUnlimitedBudget = SIZE_MAX;
+
+  /// The budget defaults to KATANA_VIEW_CACHE_MB megabytes if set, otherwise
+  /// it is unlimited
+  PGViewCache() noexcept;
+  /// Not thread safe: no other thread may use either cache while moving
+  PGViewCache(PGViewCache&& other) noexcept;
+  PGViewCache& operator=(PGViewCache&& other) noexcept;
 
   PGViewCache(const PGViewCache&) = delete;
   PGViewCache& operator=(const PGViewCache&) = delete;
@@ -1128,26 +2157,112 @@ public:
     return internal::PGViewBuilder<PGView>::BuildView(pg, *this);
   }
 
+  /// The edge shuffled topology with the given states, built in parallel on
+  /// first use, e.g., to hand the in-edges of a view to another library
+  std::shared_ptr<const EdgeShuffleTopology> BuildEdgeShuffTopo(
+      const PropertyGraph* pg,
+      const EdgeShuffleTopology::TransposeKind& tpose_kind,
+      const EdgeShuffleTopology::EdgeSortKind& sort_kind) noexcept {
+    return BuildOrGetEdgeShuffTopo(pg, tpose_kind, sort_kind);
+  }
+
+  /// The valid edge shuffled topologies built or loaded so far, e.g., to
+  /// store them with the graph
+  std::vector<std::shared_ptr<const EdgeShuffleTopology>> GetEdgeShuffTopos()
+      const noexcept;
+
+  size_t byte_budget() const noexcept;
+
+  /// Set the budget, evicting topologies if the cache is now over it
+  void set_byte_budget(size_t bytes) noexcept;
+
+  /// Bytes held by the cache, including topologies also held by views
+  size_t cached_bytes() const noexcept;
+
+  /// The nodes of each node type, built on first use
+  std::shared_ptr<const NodeTypePartition> BuildOrGetNodeTypePartition(
+      const PropertyGraph* pg) noexcept;
+
+  /// The edges of each edge type, built on first use
+  std::shared_ptr<const EdgeTypePartition> BuildOrGetEdgeTypePartition(
+      const PropertyGraph* pg) noexcept;
+
+  /// The profile of the original topology, built on first use
+  std::shared_ptr<const GraphProfile> BuildOrGetGraphProfile(
+      const PropertyGraph* pg) noexcept;
+
+  /// The values of the edge property \p name in \p order: value e is the
+  /// property of edge order.property_index(e), so that a kernel reads them
+  /// sequentially alongside the destinations of a view instead of gathering
+  /// from the property column. Gathered in parallel on first use and cached
+  /// within byte_budget() until the order's topology or the column go away.
+  /// Two threads that ask for the same values at once may both gather them.
+  Result<std::shared_ptr<arrow::Array>> BuildOrGetEdgePropertyInOrder(
+      const PropertyGraph* pg, const EdgeOrder& order,
+      const std::string& name) noexcept;
+
+  /// The TemporalEdgeIndex of the edge property \p timestamp_property, built
+  /// on first use and cached within byte_budget() until the property is
+  /// replaced
+  Result<std::shared_ptr<const TemporalEdgeIndex>> BuildOrGetTemporalEdgeIndex(
+      const PropertyGraph* pg, const std::string& timestamp_property,
+      EdgeShuffleTopology::TransposeKind tpose_kind) noexcept;
+
+  /// Drop the type partitions, e.g., after the entity types have changed.
+  /// Partitions still held by callers stay valid, but describe the old types.
+  void DropTypePartitions() noexcept;
+
 private:
   const GraphTopology* GetOriginalTopology(
       const PropertyGraph* pg) const noexcept;
 
-  CondensedTypeIDMap* BuildOrGetEdgeTypeIndex(const PropertyGraph* pg) noexcept;
+  std::shared_ptr<CondensedTypeIDMap> BuildOrGetEdgeTypeIndex(
+      const PropertyGraph* pg) noexcept;
 
-  EdgeShuffleTopology* BuildOrGetEdgeShuffTopo(
+  std::shared_ptr<CondensedTypeIDMap> BuildOrGetNodeTypeIndex(
+      const PropertyGraph* pg) noexcept;
+
+  std::shared_ptr<EdgeShuffleTopology> BuildOrGetEdgeShuffTopo(
       const PropertyGraph* pg,
       const EdgeShuffleTopology::TransposeKind& tpose_kind,
       const EdgeShuffleTopology::EdgeSortKind& sort_kind) noexcept;
 
-  ShuffleTopology* BuildOrGetShuffTopo(
+  std::shared_ptr<ShuffleTopology> BuildOrGetShuffTopo(
       const PropertyGraph* pg,
       const EdgeShuffleTopology::TransposeKind& tpose_kind,
       const ShuffleTopology::NodeSortKind& node_sort_todo,
       const EdgeShuffleTopology::EdgeSortKind& edge_sort_todo) noexcept;
 
-  EdgeTypeAwareTopology* BuildOrGetEdgeTypeAwareTopo(
+  std::shared_ptr<EdgeTypeAwareTopology> BuildOrGetEdgeTypeAwareTopo(
+      const PropertyGraph* pg,
+      const EdgeShuffleTopology::TransposeKind& tpose_kind) noexcept;
+
+  std::shared_ptr<DestTypeAwareTopology> BuildOrGetDestTypeAwareTopo(
       const PropertyGraph* pg,
       const EdgeShuffleTopology::TransposeKind& tpose_kind) noexcept;
+
+  /// See EdgeShuffleTopology::MakeUndirected
+  std::shared_ptr<EdgeShuffleTopology> BuildOrGetUndirectedTopo(
+      const PropertyGraph* pg) noexcept;
+
+  /// \returns nullptr if the graph has too many edges for 32-bit indices
+  std::shared_ptr<CompactTopology<uint32_t>> BuildOrGetCompactTopo(
+      const PropertyGraph* pg,
+      const EdgeShuffleTopology::TransposeKind& tpose_kind,
+      const EdgeShuffleTopology::EdgeSortKind& sort_kind) noexcept;
+
+  /// Return the valid topology in \p entries for which \p matches is true,
+  /// wait for one being built with the same kinds as \p key, or else build
+  /// one with \p build
+  template <typename Topo, typename Matches, typename Build>
+  std::shared_ptr<Topo> FindOrBuild(
+      std::vector<CacheEntry<Topo>>* entries, const CacheEntry<Topo>& key,
+      const Matches& matches, const Build& build) noexcept;
+
+  /// Drop least recently used topologies until the cache is within budget.
+  /// The dropped topologies are returned so that they can be freed after
+  /// releasing mutex_.
+  std::vector<std::shared_ptr<const void>> EvictLocked() noexcept;
 };
 
 /// Creates a uniform-random CSR GrpahTopology instance, where each node as
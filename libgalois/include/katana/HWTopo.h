@@ -35,8 +35,14 @@ struct KATANA_EXPORT ThreadTopoInfo {
   unsigned cumulativeMaxSocket;  // max socket id seen from [0, tid]
   unsigned osContext;            // OS ID to use for thread binding
   unsigned osNumaNode;           // OS ID for numa node
+  unsigned capacity;  // relative speed of osContext, see kMaxThreadCapacity
 };
 
+/// The capacity of the fastest hardware threads of the machine. Slower
+/// ones, e.g., the efficiency cores of a hybrid CPU, have proportionally
+/// less.
+constexpr unsigned kMaxThreadCapacity = 1024;
+
 struct KATANA_EXPORT MachineTopoInfo {
   unsigned maxThreads;
   unsigned maxCores;
@@ -52,6 +58,12 @@ struct KATANA_EXPORT HWTopoInfo {
 /**
  * getHWTopo determines the machine topology from the process information
  * exposed in /proc and /dev filesystems.
+ *
+ * Threads are ordered so that the first ones run on distinct physical cores,
+ * performance cores before efficiency cores, and SMT siblings come last. If
+ * a cgroup CPU quota (e.g., a container CPU limit) allows fewer CPUs than
+ * the process may run on, only that many threads, rounded down, are
+ * reported, so that the thread pool does not oversubscribe the quota.
  */
 KATANA_EXPORT HWTopoInfo getHWTopo();
 
@@ -61,6 +73,13 @@ KATANA_EXPORT HWTopoInfo getHWTopo();
  */
 KATANA_EXPORT std::vector<int> parseCPUList(const std::string& in);
 
+/**
+ * parseCgroupCPUMax parses a CPU quota in the format of the cgroup v2
+ * cpu.max file, "$MAX $PERIOD", and returns the number of CPUs it allows,
+ * or 0 if it is unlimited ("max" or a negative quota) or malformed
+ */
+KATANA_EXPORT double parseCgroupCPUMax(const std::string& in);
+
 /**
  * bindThreadSelf binds a thread to an osContext as returned by getHWTopo.
  */
@@ -0,0 +1,343 @@
+#ifndef KATANA_LIBGALOIS_KATANA_HASHMAPREDUCER_H_
+#define KATANA_LIBGALOIS_KATANA_HASHMAPREDUCER_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// An open-addressing hash map (linear probing) whose slots are split into
+/// 2^k independent partitions by the high bits of the key hash. Maps built
+/// with the same number of partitions agree on which partition a key is in,
+/// so partition i of several maps can be merged without touching any other
+/// partition, which is what makes the parallel merge of GHashMapReducer
+/// possible.
+///
+/// K and V must be default constructible. Unlike std::unordered_map, an
+/// insertion may invalidate pointers to values.
+template <typename K, typename V, typename Hash = std::hash<K>>
+class PartitionedHashMap : private Hash {
+  struct Partition {
+    std::vector<std::pair<K, V>> slots;
+    std::vector<uint8_t> used;
+    size_t size{0};
+  };
+
+public:
+  using key_type = K;
+  using mapped_type = V;
+  using value_type = std::pair<K, V>;
+
+  constexpr static unsigned kDefaultLogPartitions = 6;
+
+  class iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = PartitionedHashMap::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const value_type*;
+    using reference = const value_type&;
+
+    iterator() = default;
+
+    reference operator*() const {
+      return map_->partitions_[partition_].slots[slot_];
+    }
+    pointer operator->() const { return &**this; }
+
+    iterator& operator++() {
+      ++slot_;
+      Settle();
+      return *this;
+    }
+    iterator operator++(int) {
+      iterator ret = *this;
+      ++*this;
+      return ret;
+    }
+
+    bool operator==(const iterator& o) const {
+      return partition_ == o.partition_ && slot_ == o.slot_;
+    }
+    bool operator!=(const iterator& o) const { return !(*this == o); }
+
+  private:
+    friend class PartitionedHashMap;
+
+    iterator(const PartitionedHashMap* map, size_t partition)
+        : map_(map), partition_(partition) {
+      Settle();
+    }
+
+    // Advance to the next used slot at or after the current position
+    void Settle() {
+      while (partition_ < map_->partitions_.size()) {
+        const Partition& p = map_->partitions_[partition_];
+        while (slot_ < p.used.size() && !p.used[slot_]) {
+          ++slot_;
+        }
+        if (slot_ < p.used.size()) {
+          return;
+        }
+        ++partition_;
+        slot_ = 0;
+      }
+    }
+
+    const PartitionedHashMap* map_{nullptr};
+    size_t partition_{0};
+    size_t slot_{0};
+  };
+
+  explicit PartitionedHashMap(
+      unsigned log_partitions = kDefaultLogPartitions, Hash hash = Hash())
+      : Hash(hash),
+        log_partitions_(log_partitions),
+        partitions_(size_t{1} << log_partitions) {
+    KATANA_LOG_DEBUG_ASSERT(log_partitions < 32);
+  }
+
+  /// If key is absent, insert (key, value); otherwise replace its value v
+  /// with merge(v, value)
+  template <typename MergeFunc>
+  void Upsert(const K& key, const V& value, const MergeFunc& merge) {
+    uint64_t h = HashOf(key);
+    UpsertHashed(&partitions_[PartitionOf(h)], h, key, value, merge);
+  }
+
+  /// Return the value of key, inserting a default constructed value if it is
+  /// absent
+  V& operator[](const K& key) {
+    uint64_t h = HashOf(key);
+    Partition* p = &partitions_[PartitionOf(h)];
+    Reserve(p, p->size + 1);
+    size_t slot = Probe(*p, h, key);
+    if (!p->used[slot]) {
+      p->used[slot] = 1;
+      p->slots[slot] = {key, V()};
+      ++p->size;
+    }
+    return p->slots[slot].second;
+  }
+
+  /// \returns a pointer to the value of key or nullptr if it is absent
+  const V* find(const K& key) const {
+    uint64_t h = HashOf(key);
+    const Partition& p = partitions_[PartitionOf(h)];
+    if (p.size == 0) {
+      return nullptr;
+    }
+    size_t slot = Probe(p, h, key);
+    return p.used[slot] ? &p.slots[slot].second : nullptr;
+  }
+
+  size_t count(const K& key) const { return find(key) ? 1 : 0; }
+
+  size_t size() const {
+    size_t ret = 0;
+    for (const Partition& p : partitions_) {
+      ret += p.size;
+    }
+    return ret;
+  }
+
+  bool empty() const { return size() == 0; }
+
+  /// Remove every entry but keep the memory for reuse
+  void clear() {
+    for (size_t i = 0; i < partitions_.size(); ++i) {
+      ClearPartition(i);
+    }
+  }
+
+  iterator begin() const { return iterator(this, 0); }
+  iterator end() const { return iterator(this, partitions_.size()); }
+
+  size_t num_partitions() const { return partitions_.size(); }
+
+  size_t partition_size(size_t partition) const {
+    return partitions_[partition].size;
+  }
+
+  /// Merge the entries of partition i of other into partition i of this map.
+  /// Distinct partitions may be merged concurrently.
+  template <typename MergeFunc>
+  void MergePartition(
+      size_t partition, const PartitionedHashMap& other,
+      const MergeFunc& merge) {
+    KATANA_LOG_DEBUG_ASSERT(log_partitions_ == other.log_partitions_);
+    Partition* p = &partitions_[partition];
+    const Partition& o = other.partitions_[partition];
+    for (size_t i = 0; i < o.used.size(); ++i) {
+      if (o.used[i]) {
+        const auto& [key, value] = o.slots[i];
+        UpsertHashed(p, HashOf(key), key, value, merge);
+      }
+    }
+  }
+
+  /// Make room for at least n entries in partition i without rehashing
+  void ReservePartition(size_t partition, size_t n) {
+    Reserve(&partitions_[partition], n);
+  }
+
+  void ClearPartition(size_t partition) {
+    Partition& p = partitions_[partition];
+    if (p.size != 0) {
+      std::fill(p.used.begin(), p.used.end(), 0);
+      p.size = 0;
+    }
+  }
+
+private:
+  uint64_t HashOf(const K& key) const {
+    // Finalizer of MurmurHash3; std::hash of integers is the identity, which
+    // would put every small key in partition 0 and cluster probes
+    uint64_t h = Hash::operator()(key);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+  }
+
+  size_t PartitionOf(uint64_t h) const {
+    return log_partitions_ == 0 ? 0 : h >> (64 - log_partitions_);
+  }
+
+  // The slot holding key or the empty slot where it belongs. Requires a
+  // non-full partition.
+  static size_t Probe(const Partition& p, uint64_t h, const K& key) {
+    size_t mask = p.used.size() - 1;
+    size_t slot = h & mask;
+    while (p.used[slot] && !(p.slots[slot].first == key)) {
+      slot = (slot + 1) & mask;
+    }
+    return slot;
+  }
+
+  template <typename MergeFunc>
+  void UpsertHashed(
+      Partition* p, uint64_t h, const K& key, const V& value,
+      const MergeFunc& merge) {
+    Reserve(p, p->size + 1);
+    size_t slot = Probe(*p, h, key);
+    if (p->used[slot]) {
+      p->slots[slot].second = merge(p->slots[slot].second, value);
+    } else {
+      p->used[slot] = 1;
+      p->slots[slot] = {key, value};
+      ++p->size;
+    }
+  }
+
+  // Keep the load factor at most 1/2
+  void Reserve(Partition* p, size_t n) {
+    if (2 * n <= p->used.size()) {
+      return;
+    }
+    size_t capacity = std::max<size_t>(p->used.size(), 8);
+    while (2 * n > capacity) {
+      capacity *= 2;
+    }
+
+    Partition old = std::move(*p);
+    p->slots.assign(capacity, value_type());
+    p->used.assign(capacity, 0);
+    p->size = old.size;
+    for (size_t i = 0; i < old.used.size(); ++i) {
+      if (old.used[i]) {
+        size_t slot = Probe(*p, HashOf(old.slots[i].first), old.slots[i].first);
+        p->used[slot] = 1;
+        p->slots[slot] = std::move(old.slots[i]);
+      }
+    }
+  }
+
+  unsigned log_partitions_;
+  std::vector<Partition> partitions_;
+};
+
+/// Aggregates (key, value) pairs from many threads, e.g., the size of each
+/// component or a degree histogram, without locks or a map per update.
+///
+/// Each thread upserts into its own PartitionedHashMap. reduce() merges the
+/// thread maps partition by partition in parallel, so the merge scales with
+/// threads instead of running on the main thread. Like katana::Reducible,
+/// reduce() moves the thread local values into the result, so it may be
+/// called again after further updates, and reset() clears everything.
+///
+/// \code
+/// katana::GHashMapReducer<uint64_t, uint64_t> sizes;
+/// katana::do_all(katana::iterate(graph), [&](auto n) {
+///   sizes.update(graph.GetData<Component>(n), 1);
+/// });
+/// const auto& map = sizes.reduce();
+/// \endcode
+template <
+    typename K, typename V, typename MergeFunc = std::plus<V>,
+    typename Hash = std::hash<K>>
+class GHashMapReducer : public MergeFunc {
+public:
+  using Map = PartitionedHashMap<K, V, Hash>;
+  using value_type = Map;
+
+  explicit GHashMapReducer(MergeFunc merge_func = MergeFunc())
+      : MergeFunc(merge_func) {}
+
+  /// Merge value into the thread local value of key
+  void update(const K& key, const V& value) {
+    data_.getLocal()->Upsert(key, value, static_cast<const MergeFunc&>(*this));
+  }
+
+  /// The map of the calling thread
+  Map& getLocal() { return *data_.getLocal(); }
+
+  /// Merge every thread's map into the result and return it. Only valid
+  /// outside the parallel region.
+  Map& reduce() {
+    const MergeFunc& merge = *this;
+    do_all(
+        iterate(size_t{0}, result_.num_partitions()),
+        [&](size_t partition) {
+          size_t total = result_.partition_size(partition);
+          for (unsigned i = 0; i < data_.size(); ++i) {
+            total += data_.getRemote(i)->partition_size(partition);
+          }
+          result_.ReservePartition(partition, total);
+          for (unsigned i = 0; i < data_.size(); ++i) {
+            Map* local = data_.getRemote(i);
+            result_.MergePartition(partition, *local, merge);
+            local->ClearPartition(partition);
+          }
+        },
+        steal(), no_stats());
+    return result_;
+  }
+
+  void reset() {
+    result_.clear();
+    for (unsigned i = 0; i < data_.size(); ++i) {
+      data_.getRemote(i)->clear();
+    }
+  }
+
+private:
+  PerThreadStorage<Map> data_;
+  Map result_;
+};
+
+}  // namespace katana
+
+#endif
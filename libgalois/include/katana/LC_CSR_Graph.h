@@ -21,13 +21,18 @@
 #define KATANA_LIBGALOIS_KATANA_LCCSRGRAPH_H_
 
 #include <fstream>
+#include <string>
 #include <type_traits>
 
+#include <arrow/type_traits.h>
+
 #include "katana/Details.h"
 #include "katana/FileGraph.h"
 #include "katana/Galois.h"
 #include "katana/GraphHelpers.h"
 #include "katana/PODVector.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
 #include "katana/config.h"
 
 namespace katana {
@@ -456,6 +461,70 @@ public:
     }
   }
 
+  /**
+   * Use the topology of a property graph, and one of its edge properties as
+   * edge data, in place, so legacy apps can run on an RDG without converting
+   * it to a .gr file. Only node data (and locks) are allocated; the edge
+   * arrays are the property graph's, so pg must outlive this graph and
+   * UseNumaAlloc only places node data.
+   *
+   * The edge arrays must not be modified through this graph: sortEdges and
+   * friends would reorder the property graph's topology. Writes to edge data
+   * change the edge property.
+   *
+   * @param pg the property graph
+   * @param edge_property the edge property with the edge data, whose type
+   * must be EdgeTy; unused if EdgeTy is void
+   */
+  Result<void> constructFrom(
+      const PropertyGraph& pg, const std::string& edge_property = "") {
+    const GraphTopology& topology = pg.topology();
+    using EdgeValue = typename EdgeData::raw_value_type;
+    [[maybe_unused]] EdgeValue* edge_values = nullptr;
+    if constexpr (!std::is_void_v<EdgeTy>) {
+      using ArrowType = typename arrow::CTypeTraits<EdgeTy>::ArrowType;
+      static_assert(
+          arrow::is_number_type<ArrowType>::value,
+          "only numeric edge data can be used in place");
+      auto column = KATANA_CHECKED(pg.GetEdgeProperty(edge_property));
+      auto type = arrow::TypeTraits<ArrowType>::type_singleton();
+      if (!column->type()->Equals(type)) {
+        return KATANA_ERROR(
+            ErrorCode::TypeError, "edge property {} is {}, not {}",
+            edge_property, column->type()->ToString(), type->ToString());
+      }
+      if (column->num_chunks() != 1) {
+        return KATANA_ERROR(
+            ErrorCode::InvalidArgument,
+            "edge property {} has {} chunks, not 1", edge_property,
+            column->num_chunks());
+      }
+      edge_values = const_cast<EdgeValue*>(
+          column->chunk(0)->data()->template GetValues<EdgeValue>(1));
+    }
+
+    deallocate();
+    numNodes = topology.num_nodes();
+    numEdges = topology.num_edges();
+    if (UseNumaAlloc) {
+      nodeData.allocateBlocked(numNodes);
+      this->outOfLineAllocateBlocked(numNodes);
+    } else {
+      nodeData.allocateInterleaved(numNodes);
+      this->outOfLineAllocateInterleaved(numNodes);
+    }
+    edgeIndData = EdgeIndData(
+        const_cast<GraphTopology::Edge*>(topology.adj_data()), numNodes);
+    edgeDst = EdgeDst(
+        const_cast<GraphTopology::Node*>(topology.dest_data()), numEdges);
+    if constexpr (!std::is_void_v<EdgeTy>) {
+      edgeData = EdgeData(edge_values, numEdges);
+    }
+    constructNodes();
+    initializeLocalRanges();
+    return ResultSuccess();
+  }
+
   void destroyAndAllocateFrom(uint32_t nNodes, uint64_t nEdges) {
     numNodes = nNodes;
     numEdges = nEdges;
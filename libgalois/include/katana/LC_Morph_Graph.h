@@ -26,6 +26,8 @@
 #ifndef KATANA_LIBGALOIS_KATANA_LCMORPHGRAPH_H_
 #define KATANA_LIBGALOIS_KATANA_LCMORPHGRAPH_H_
 
+#include <algorithm>
+#include <iterator>
 #include <type_traits>
 
 #include <boost/mpl/if.hpp>
@@ -33,8 +35,11 @@
 #include "katana/Bag.h"
 #include "katana/Details.h"
 #include "katana/FileGraph.h"
+#include "katana/LoopArena.h"
 #include "katana/NUMAArray.h"
+#include "katana/PerThreadStorage.h"
 #include "katana/config.h"
+#include "katana/gstl.h"
 
 namespace katana {
 
@@ -147,17 +152,6 @@ protected:
   using NodeInfoTypes = internal::NodeInfoBaseTypes<
       NodeTy, !HasNoLockable && !HasOutOfLineLockable>;
 
-  //! Linked list structure holding together blocks of memory that stores
-  //! edges.
-  struct EdgeHolder {
-    //! Beginning of memory for this block.
-    EdgeInfo* begin;
-    //! End of memory for this block.
-    EdgeInfo* end;
-    //! Pointer to another block of memory for edges (if it exists).
-    EdgeHolder* next;
-  };
-
   /**
    * Class that stores node info (e.g. where its edges begin and end, its data,
    * etc.).
@@ -233,8 +227,9 @@ public:
 protected:
   //! Nodes in this graph
   Nodes nodes;
-  //! Memory for edges in this graph (memory held in EdgeHolders)
-  katana::PerThreadStorage<EdgeHolder*> edgesL;
+  //! Memory for edges in this graph: a bump arena per thread, whose pages
+  //! are returned to the page pool when the graph is destroyed
+  katana::PerThreadStorage<ThreadArena> edgeArenas;
 
   /**
    * Acquire a node for the scope in which the function is called.
@@ -437,39 +432,14 @@ public:
   GraphNode createNode(int nedges, Args&&... args) {
     NodeInfo* N = &nodes.emplace(std::forward<Args>(args)...);
     acquireNode(N, MethodFlag::WRITE);
-    EdgeHolder*& local_edges = *edgesL.getLocal();
-
-    // Allocate space for a new EdgeHolder object if necessary
-    if (!local_edges ||
-        std::distance(local_edges->begin, local_edges->end) < nedges) {
-      EdgeHolder* old = local_edges;
-      // FIXME: this seems to leak
-      size_t size = allocSize();
-      void* block = pagePoolAlloc();
-      local_edges = reinterpret_cast<EdgeHolder*>(block);
-      local_edges->next = old;
-
-      size -= sizeof(EdgeHolder);
-      block = reinterpret_cast<char*>(block) + sizeof(EdgeHolder);
-
-      if (!std::align(
-              std::alignment_of_v<EdgeInfo>, sizeof(EdgeInfo), block, size)) {
-        KATANA_DIE("not enough space for EdgeInfo");
-      }
 
-      local_edges->begin = reinterpret_cast<EdgeInfo*>(block);
-      local_edges->end = local_edges->begin;
-      local_edges->end += size / sizeof(EdgeInfo);
-      if (std::distance(local_edges->begin, local_edges->end) < nedges) {
-        KATANA_DIE("not enough space for EdgeInfo");
-      }
-    }
-
-    // Set the memory aside for the new node in the edge holder object
-    N->edgeBegin = N->edgeEnd = local_edges->begin;
-    local_edges->begin += nedges;
+    // Set the memory aside for the edges of the new node; nodes with more
+    // edges than fit in a page get memory of their own from the arena
+    N->edgeBegin = N->edgeEnd =
+        static_cast<EdgeInfo*>(edgeArenas.getLocal()->allocate(
+            sizeof(EdgeInfo) * nedges, alignof(EdgeInfo)));
 #ifndef NDEBUG
-    N->trueEdgeEnd = local_edges->begin;
+    N->trueEdgeEnd = N->edgeBegin + nedges;
 #endif
     return GraphNode(N);
   }
@@ -519,6 +489,46 @@ public:
     return it;
   }
 
+  /**
+   * Adds an edge from src to each node in dsts that src has no edge to yet,
+   * as if by addEdge without edge data arguments, and returns the number of
+   * edges added. Duplicates are found by sorting instead of scanning the
+   * edges of src once per new edge. The new edges must fit in the space
+   * reserved for src by createNode.
+   */
+  template <typename Range>
+  size_t addEdgesBulk(
+      GraphNode src, const Range& dsts,
+      katana::MethodFlag mflag = MethodFlag::WRITE) {
+    acquireNode(src, mflag);
+
+    katana::gstl::Vector<NodeInfo*> added(std::begin(dsts), std::end(dsts));
+    std::sort(added.begin(), added.end());
+    added.erase(std::unique(added.begin(), added.end()), added.end());
+
+    katana::gstl::Vector<NodeInfo*> existing;
+    existing.reserve(std::distance(src->edgeBegin, src->edgeEnd));
+    for (edge_iterator ii = src->edgeBegin; ii != src->edgeEnd; ++ii) {
+      existing.push_back(ii->dst);
+    }
+    std::sort(existing.begin(), existing.end());
+    added.erase(
+        std::remove_if(
+            added.begin(), added.end(),
+            [&](NodeInfo* dst) {
+              return std::binary_search(existing.begin(), existing.end(), dst);
+            }),
+        added.end());
+
+    for (NodeInfo* dst : added) {
+      src->edgeEnd->dst = dst;
+      src->edgeEnd->construct();
+      src->edgeEnd++;
+    }
+    KATANA_LOG_DEBUG_ASSERT(src->edgeEnd <= src->trueEdgeEnd);
+    return added.size();
+  }
+
   /**
    * Remove an edge from the graph.
    *
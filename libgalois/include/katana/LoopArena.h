@@ -0,0 +1,184 @@
+#ifndef KATANA_LIBGALOIS_KATANA_LOOPARENA_H_
+#define KATANA_LIBGALOIS_KATANA_LOOPARENA_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory_resource>
+#include <new>
+#include <vector>
+
+#include "katana/Logging.h"
+#include "katana/PageAlloc.h"
+#include "katana/PagePool.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// A bump allocator owned by one thread. Memory comes from the page pool,
+/// so it is local to the thread's NUMA node; deallocation is a no-op and all
+/// memory is reclaimed at once by Rewind(). Allocations larger than a page
+/// go to malloc and are freed on Rewind().
+///
+/// It is a std::pmr::memory_resource, so STL containers can use it through
+/// std::pmr::polymorphic_allocator, e.g., std::pmr::vector<T> v(arena).
+class ThreadArena : public std::pmr::memory_resource {
+public:
+  /// A position to rewind to
+  struct Mark {
+    size_t block;
+    size_t offset;
+    size_t num_large;
+  };
+
+  ThreadArena() = default;
+  ThreadArena(const ThreadArena&) = delete;
+  ThreadArena& operator=(const ThreadArena&) = delete;
+
+  ~ThreadArena() override {
+    Rewind({0, 0, 0});
+    for (void* block : blocks_) {
+      pagePoolFree(block);
+    }
+  }
+
+  Mark GetMark() const { return {cur_, offset_, large_.size()}; }
+
+  /// Release everything allocated since \p mark. Memory allocated before it
+  /// stays valid. Cost is independent of the number of allocations.
+  void Rewind(const Mark& mark) {
+    KATANA_LOG_DEBUG_ASSERT(mark.num_large <= large_.size());
+    while (large_.size() > mark.num_large) {
+      free(large_.back());
+      large_.pop_back();
+    }
+    cur_ = mark.block;
+    offset_ = mark.offset;
+  }
+
+  /// Bytes of page pool memory held, whether in use or not
+  size_t capacity() const { return blocks_.size() * allocSize(); }
+
+protected:
+  void* do_allocate(size_t bytes, size_t align) override {
+    const size_t block_size = allocSize();
+    if (bytes + align > block_size) {
+      return AllocateLarge(bytes, align);
+    }
+
+    while (true) {
+      if (cur_ < blocks_.size()) {
+        uintptr_t base = reinterpret_cast<uintptr_t>(blocks_[cur_]);
+        uintptr_t pos = (base + offset_ + align - 1) & ~(uintptr_t{align} - 1);
+        if (pos + bytes <= base + block_size) {
+          offset_ = pos + bytes - base;
+          return reinterpret_cast<void*>(pos);
+        }
+        ++cur_;
+        offset_ = 0;
+        continue;
+      }
+      blocks_.emplace_back(pagePoolAlloc());
+    }
+  }
+
+  void do_deallocate(void*, size_t, size_t) override {}
+
+  bool do_is_equal(
+      const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+
+private:
+  void* AllocateLarge(size_t bytes, size_t align) {
+    if (align < alignof(std::max_align_t)) {
+      align = alignof(std::max_align_t);
+    }
+    void* ptr = aligned_alloc(align, (bytes + align - 1) / align * align);
+    if (!ptr) {
+      throw std::bad_alloc();
+    }
+    large_.emplace_back(ptr);
+    return ptr;
+  }
+
+  std::vector<void*> blocks_;
+  std::vector<void*> large_;
+  size_t cur_{0};
+  size_t offset_{0};
+  uint64_t epoch_{0};
+
+  friend class LoopArena;
+};
+
+/// Per-thread bump arenas for the temporaries of a parallel loop, e.g.,
+/// per-node maps or buffers that would otherwise be allocated with malloc in
+/// every iteration.
+///
+/// \code
+/// katana::LoopArena arena;
+/// katana::do_all(katana::iterate(graph), [&](auto node) {
+///   std::pmr::unordered_map<uint32_t, uint64_t> counts(arena.Local());
+///   ...
+/// });
+/// arena.Reset();  // before the next round
+/// \endcode
+///
+/// Reset() only bumps an epoch; each thread rewinds its arena the next time
+/// it calls Local(), so the cost at the loop barrier is O(1). Pages are kept
+/// for later rounds and returned to the page pool when the LoopArena is
+/// destroyed. Containers allocated from an arena must not outlive the round.
+class LoopArena {
+public:
+  LoopArena() = default;
+  LoopArena(const LoopArena&) = delete;
+  LoopArena& operator=(const LoopArena&) = delete;
+
+  /// The arena of the calling thread
+  ThreadArena* Local() {
+    ThreadArena* arena = arenas_.getLocal();
+    if (arena->epoch_ != epoch_) {
+      arena->Rewind({0, 0, 0});
+      arena->epoch_ = epoch_;
+    }
+    return arena;
+  }
+
+  /// Release everything allocated in the current round. Must not run
+  /// concurrently with Local().
+  void Reset() { ++epoch_; }
+
+  /// Bytes of page pool memory held by all threads
+  size_t capacity() const {
+    size_t ret = 0;
+    for (unsigned i = 0; i < arenas_.size(); ++i) {
+      ret += arenas_.getRemote(i)->capacity();
+    }
+    return ret;
+  }
+
+private:
+  PerThreadStorage<ThreadArena> arenas_;
+  uint64_t epoch_{0};
+};
+
+/// Rewinds a thread arena when it goes out of scope, so that temporaries of a
+/// single iteration do not accumulate over a round
+class ArenaScope {
+public:
+  explicit ArenaScope(ThreadArena* arena)
+      : arena_(arena), mark_(arena->GetMark()) {}
+  ArenaScope(const ArenaScope&) = delete;
+  ArenaScope& operator=(const ArenaScope&) = delete;
+
+  ~ArenaScope() { arena_->Rewind(mark_); }
+
+private:
+  ThreadArena* arena_;
+  ThreadArena::Mark mark_;
+};
+
+}  // namespace katana
+
+#endif
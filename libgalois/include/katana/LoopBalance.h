@@ -0,0 +1,102 @@
+#ifndef KATANA_LIBGALOIS_KATANA_LOOPBALANCE_H_
+#define KATANA_LIBGALOIS_KATANA_LOOPBALANCE_H_
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+#include "katana/PerThreadStorage.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// How evenly the work of one run of a named loop was spread over its
+/// threads.
+///
+/// If KATANA_LOOP_BALANCE is set to a true value, every do_all with steal()
+/// and every for_each with a loopname records, on each thread that runs it,
+/// the time spent in the operator (BusyTime), the rest of the time until the
+/// last thread finished (IdleTime), the chunks of work taken (Chunks) and the
+/// attempts to take work from other threads and how many of them succeeded
+/// (StealAttempts and Steals). Report() adds them to the StatManager under
+/// the loopname, times in nanoseconds, and logs a summary to the active
+/// tracing span, if there is one.
+class KATANA_EXPORT LoopBalance {
+public:
+  struct ThreadStats {
+    uint64_t begin_ns{0};
+    uint64_t end_ns{0};
+    uint64_t busy_ns{0};
+    uint64_t chunks{0};
+    uint64_t steal_attempts{0};
+    uint64_t steals{0};
+  };
+
+  /// Whether KATANA_LOOP_BALANCE is set
+  static bool IsEnabled();
+
+  static uint64_t Now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+  explicit LoopBalance(const char* loopname);
+
+  /// Called by each thread when it starts its part of the loop
+  void BeginThread() {
+    if (threads_) {
+      threads_->getLocal()->begin_ns = Now();
+    }
+  }
+
+  /// Called by each thread when it runs out of work
+  void EndThread(uint64_t chunks, uint64_t steal_attempts, uint64_t steals) {
+    if (threads_) {
+      ThreadStats& stats = *threads_->getLocal();
+      stats.end_ns = Now();
+      stats.chunks += chunks;
+      stats.steal_attempts += steal_attempts;
+      stats.steals += steals;
+    }
+  }
+
+  /// \returns the start of a busy interval to pass to StopBusy
+  uint64_t StartBusy() const { return threads_ ? Now() : 0; }
+
+  /// Count the time since \p start as busy if the thread did any work
+  void StopBusy(uint64_t start, bool did_work) {
+    if (threads_ && did_work) {
+      threads_->getLocal()->busy_ns += Now() - start;
+    }
+  }
+
+  /// Report the stats of each thread; called serially after the loop
+  void Report();
+
+private:
+  const char* loopname_;
+  std::unique_ptr<PerThreadStorage<ThreadStats>> threads_;
+};
+
+template <bool Enable>
+class CondLoopBalance : public LoopBalance {
+public:
+  explicit CondLoopBalance(const char* loopname) : LoopBalance(loopname) {}
+};
+
+template <>
+class CondLoopBalance<false> {
+public:
+  explicit CondLoopBalance(const char*) {}
+
+  void BeginThread() const {}
+  void EndThread(uint64_t, uint64_t, uint64_t) const {}
+  uint64_t StartBusy() const { return 0; }
+  void StopBusy(uint64_t, bool) const {}
+  void Report() const {}
+};
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef KATANA_LIBGALOIS_KATANA_LOOPCOUNTERS_H_
+#define KATANA_LIBGALOIS_KATANA_LOOPCOUNTERS_H_
+
+#include "katana/config.h"
+
+namespace katana {
+
+/// Hardware event counts of one run of a named loop, by thread.
+///
+/// If KATANA_LOOP_COUNTERS is set to a true value, every do_all, for_each
+/// and on_each with a loopname counts, on each thread that runs it, the
+/// events below with Linux perf_event and reports their sums under the
+/// loopname to the StatManager, next to the loop's Time and Iterations.
+/// Events that the CPU or kernel cannot count, e.g., because of
+/// perf_event_paranoid, are left out; a warning lists them once. Counts are
+/// scaled when the kernel multiplexes the events.
+class KATANA_EXPORT LoopCounters {
+public:
+  /// The events and the names of their statistics
+  enum Event {
+    kCycles,
+    kLLCMisses,
+    kRemoteDRAMAccesses,
+    kDTLBMisses,
+    kStalledCycles,
+    kNumEvents
+  };
+
+  static const char* EventName(Event event);
+
+  /// Whether KATANA_LOOP_COUNTERS is set
+  static bool IsEnabled();
+
+  explicit LoopCounters(const char* loopname) : loopname_(loopname) {}
+
+  /// Record the counts of each active thread; a no-op unless IsEnabled()
+  void start();
+
+  /// Report the counts since start() of each active thread
+  void stop();
+
+private:
+  const char* loopname_;
+  bool running_{false};
+};
+
+template <bool Enable>
+class CondLoopCounters : public LoopCounters {
+public:
+  explicit CondLoopCounters(const char* loopname) : LoopCounters(loopname) {}
+};
+
+template <>
+class CondLoopCounters<false> {
+public:
+  explicit CondLoopCounters(const char*) {}
+
+  void start() const {}
+  void stop() const {}
+};
+
+}  // namespace katana
+
+#endif
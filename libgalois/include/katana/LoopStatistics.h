@@ -54,6 +54,13 @@ public:
   inline void inc_iterations() { ++m_iterations; }
 
   inline void inc_conflicts() { ++m_conflicts; }
+
+  //! Called once per round with the number of threads that ran it
+  static void ReportThreads(const char* loopname, unsigned threads) {
+    ReportStatMin(loopname, "MinThreads", threads);
+    ReportStatMax(loopname, "MaxThreads", threads);
+    ReportStatAvg(loopname, "AvgThreads", threads);
+  }
 };
 
 template <>
@@ -68,6 +75,8 @@ public:
   inline void inc_iterations() const {}
   inline void inc_pushes(size_t) const {}
   inline void inc_conflicts() const {}
+
+  static void ReportThreads(const char*, unsigned) {}
 };
 
 }  // namespace katana
@@ -27,6 +27,7 @@
 #include "katana/Executor_Ordered.h"
 #include "katana/Executor_ParaMeter.h"
 #include "katana/LoopsDecl.h"
+#include "katana/ParallelismProfile.h"
 #include "katana/WorkList.h"
 #include "katana/config.h"
 
@@ -42,6 +43,9 @@ namespace katana {
  * Operator should conform to <code>fn(item, UserContext<T>&)</code> where item
  * is a value from the iteration range and T is the type of item.
  *
+ * While a {@link ParallelismProfile} is recording, named loops run with the
+ * ParaMeter executor instead of their worklist.
+ *
  * @param range an iterator range typically returned by @ref katana::iterate
  * @param fn operator
  * @param args optional arguments to loop, e.g., {@see loopname}, {@see wl}
@@ -51,6 +55,14 @@ template <typename Range, typename FunctionTy, typename... Args>
 void
 for_each(const Range& range, FunctionTy&& fn, Args&&... args) {
   auto tpl = std::make_tuple(std::forward<Args>(args)...);
+  using FnTraits = typename function_traits<std::decay_t<FunctionTy>>::type;
+  if constexpr (internal::CanProfileParallelism<decltype(
+                    std::tuple_cat(tpl, FnTraits{}))>()) {
+    if (ParallelismProfile::IsEnabled()) {
+      internal::for_each_profiled(range, std::forward<FunctionTy>(fn), tpl);
+      return;
+    }
+  }
   for_each_gen(range, std::forward<FunctionTy>(fn), tpl);
 }
 
@@ -98,6 +110,12 @@ on_each(FunctionTy&& fn, Args&&... args) {
  * conform to <code>nhFunc(item)</code> and should visit every element in the
  * neighborhood of active element item.
  *
+ * Items are executed speculatively in windows, and items pushed by the
+ * operator only run after the window that pushed them, even if they precede
+ * some of its items. The result is that of executing the items in priority
+ * order as long as a pushed item never conflicts with the later items of the
+ * window; otherwise, use the overload with a stability test.
+ *
  * @param b begining of range of initial items
  * @param e end of range of initial items
  * @param cmp comparison function
@@ -123,7 +141,9 @@ for_each_ordered(
  * conform to <code>nhFunc(item)</code> and should visit every element in the
  * neighborhood of active element item. The stability test should conform to
  * <code>bool r = stabilityTest(item)</code> where r is true if item is a stable
- * source.
+ * source, i.e., no item pushed by an earlier item may precede it and conflict
+ * with it. Items that are not stable are retried in later windows; the
+ * earliest pending item always runs.
  *
  * @param b begining of range of initial items
  * @param e end of range of initial items
@@ -805,6 +805,71 @@ public
     return createEdge(src, dst, mflag, std::forward<Args>(args)...);
   }
 
+  /**
+   * Adds an edge from src to each node in dsts that src has no edge to yet,
+   * as if by addEdge, and returns the number of edges added. The edges of src
+   * are grown once and duplicates are found by sorting, instead of scanning
+   * the edges of src once per new edge. Unlike addEdge, the space of removed
+   * edges is not reused.
+   */
+  template <typename Range>
+  size_t addEdgesBulk(
+      GraphNode src, const Range& dsts,
+      katana::MethodFlag mflag = MethodFlag::WRITE) {
+    KATANA_LOG_DEBUG_ASSERT(src);
+    src->acquire(mflag);
+
+    katana::gstl::Vector<gNode*> added(std::begin(dsts), std::end(dsts));
+    std::sort(added.begin(), added.end());
+    added.erase(std::unique(added.begin(), added.end()), added.end());
+
+    katana::gstl::Vector<gNode*> existing;
+    for (auto& edge : src->edges) {
+      if (!edge.isInEdge() && edge.first() && edge.first()->active) {
+        existing.push_back(edge.first());
+      }
+    }
+    std::sort(existing.begin(), existing.end());
+    added.erase(
+        std::remove_if(
+            added.begin(), added.end(),
+            [&](gNode* dst) {
+              return std::binary_search(existing.begin(), existing.end(), dst);
+            }),
+        added.end());
+
+    // A self loop of an undirected or in-out graph also adds an edge to the
+    // edges of src being appended to, so it is added last
+    bool self_loop = false;
+    size_t old_size = src->edges.size();
+    src->edges.reserve(old_size + added.size());
+    for (gNode* dst : added) {
+      if (dst == src && !DirectedNotInOut) {
+        self_loop = true;
+        continue;
+      }
+      EdgeTy* e = nullptr;
+      if (!DirectedNotInOut) {
+        dst->acquire(mflag);
+        e = edgesF.mkEdge();
+        dst->createEdge(src, e, Directional ? true : false);
+      }
+      src->edges.emplace_back(dst, e, false);
+    }
+    if (SortedNeighbors) {
+      std::inplace_merge(
+          src->edges.begin(), src->edges.begin() + old_size, src->edges.end(),
+          [](const typename gNode::EdgeInfo& e1,
+             const typename gNode::EdgeInfo& e2) {
+            return e1.first() < e2.first();
+          });
+    }
+    if (self_loop) {
+      createEdge(src, src, mflag);
+    }
+    return added.size();
+  }
+
   //! Removes an edge from the graph
   void removeEdge(
       GraphNode src, edge_iterator dst,
@@ -0,0 +1,231 @@
+#ifndef KATANA_LIBGALOIS_KATANA_MULTIQUEUE_H_
+#define KATANA_LIBGALOIS_KATANA_MULTIQUEUE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+#include <boost/noncopyable.hpp>
+
+#include "katana/CompilerSpecific.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/PriorityQueue.h"
+#include "katana/SimpleLock.h"
+#include "katana/ThreadPool.h"
+#include "katana/Threads.h"
+#include "katana/WLCompileCheck.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/**
+ * Relaxed concurrent priority scheduling (Rihani, Sanders and Dementiev,
+ * SPAA 2015). The worklist is C * P sequential min heaps, each behind its own
+ * lock, where P is the number of active threads. A push goes to a random
+ * heap; a pop looks at two random heaps and takes the better of their tops.
+ *
+ * Pops return items in approximately, not exactly, ascending order, with a
+ * rank error that grows with C * P but does not depend on the distribution
+ * of priorities. Unlike \ref OrderedByIntegerMetric, there is no indexer or
+ * bucket width to tune and priorities may be any comparable type.
+ *
+ * \code
+ * katana::for_each(
+ *     katana::iterate(init), fn, katana::wl<katana::MultiQueue<>>());
+ * \endcode
+ *
+ * @tparam Comparator strict weak order on items; the least item has the
+ *     highest priority. The default compares items with operator<.
+ * @tparam C number of heaps per thread
+ */
+template <
+    typename Comparator = std::less<>, int C = 2, typename T = int,
+    bool Concurrent = true>
+class MultiQueue : private boost::noncopyable {
+  static_assert(C > 0, "need at least one heap per thread");
+
+public:
+  template <typename _T>
+  using retype = MultiQueue<Comparator, C, _T, Concurrent>;
+
+  template <bool _concurrent>
+  using rethread = MultiQueue<Comparator, C, T, _concurrent>;
+
+  template <typename _comparator>
+  using with_comparator = MultiQueue<_comparator, C, T, Concurrent>;
+
+  template <int _c>
+  using with_heaps_per_thread = MultiQueue<Comparator, _c, T, Concurrent>;
+
+  typedef T value_type;
+
+private:
+  //! Random heaps sampled by a pop before it falls back to a full scan
+  constexpr static int kPopTries = 4;
+
+  struct alignas(KATANA_CACHE_LINE_SIZE) Heap {
+    SimpleLock lock;
+    MinHeap<T, Comparator> heap;
+    // Readable without the lock to skip empty heaps
+    std::atomic<size_t> size{0};
+
+    explicit Heap(const Comparator& cmp) : heap(cmp) {}
+  };
+
+  struct Rng {
+    uint64_t state{0};
+
+    uint64_t next() {
+      // xorshift64*
+      state ^= state >> 12;
+      state ^= state << 25;
+      state ^= state >> 27;
+      return state * UINT64_C(2685821657736338717);
+    }
+  };
+
+  Comparator cmp;
+  unsigned num_heaps;
+  std::unique_ptr<std::unique_ptr<Heap>[]> heaps;
+  PerThreadStorage<Rng> rngs;
+
+  unsigned randomHeap() {
+    Rng& rng = *rngs.getLocal();
+    if (rng.state == 0) {
+      rng.state = ThreadPool::getTID() + 1;
+    }
+    return rng.next() % num_heaps;
+  }
+
+  //! Requires h.lock
+  std::optional<value_type> takeLocked(Heap& h) {
+    if (h.heap.empty()) {
+      return std::nullopt;
+    }
+    value_type ret = h.heap.pop();
+    h.size.store(h.heap.size(), std::memory_order_relaxed);
+    return ret;
+  }
+
+  template <typename Iter>
+  void pushLocked(Heap& h, Iter b, Iter e) {
+    for (; b != e; ++b) {
+      h.heap.push(*b);
+    }
+    h.size.store(h.heap.size(), std::memory_order_relaxed);
+  }
+
+  //! Pop the better top of two random heaps, skipping heaps that are empty or
+  //! locked by someone else
+  std::optional<value_type> tryTwoChoices() {
+    Heap* a = heaps[randomHeap()].get();
+    Heap* b = heaps[randomHeap()].get();
+    if (a == b || !b->size.load(std::memory_order_relaxed)) {
+      b = nullptr;
+    }
+    if (!a->size.load(std::memory_order_relaxed)) {
+      a = b;
+      b = nullptr;
+    }
+    if (!a || !a->lock.try_lock()) {
+      a = nullptr;
+    }
+    if (b && !b->lock.try_lock()) {
+      b = nullptr;
+    }
+    if (!a) {
+      std::swap(a, b);
+    }
+    if (!a) {
+      return std::nullopt;
+    }
+
+    Heap* best = a;
+    if (b && !b->heap.empty() &&
+        (a->heap.empty() || cmp(b->heap.top(), a->heap.top()))) {
+      best = b;
+    }
+    std::optional<value_type> ret = takeLocked(*best);
+
+    a->lock.unlock();
+    if (b) {
+      b->lock.unlock();
+    }
+    return ret;
+  }
+
+  KATANA_ATTRIBUTE_NOINLINE std::optional<value_type> popSlow() {
+    unsigned start = randomHeap();
+    for (unsigned i = 0; i < num_heaps; ++i) {
+      Heap& h = *heaps[(start + i) % num_heaps];
+      if (!h.size.load(std::memory_order_relaxed)) {
+        continue;
+      }
+      std::lock_guard<SimpleLock> guard(h.lock);
+      if (std::optional<value_type> ret = takeLocked(h)) {
+        return ret;
+      }
+    }
+    return std::nullopt;
+  }
+
+public:
+  explicit MultiQueue(const Comparator& cmp = Comparator())
+      : cmp(cmp),
+        num_heaps(Concurrent ? C * getActiveThreads() : 1),
+        heaps(std::make_unique<std::unique_ptr<Heap>[]>(num_heaps)) {
+    for (unsigned i = 0; i < num_heaps; ++i) {
+      heaps[i] = std::make_unique<Heap>(cmp);
+    }
+  }
+
+  void push(const value_type& val) { push(&val, &val + 1); }
+
+  //! Pushes the whole range to a single heap
+  template <typename Iter>
+  void push(Iter b, Iter e) {
+    if (b == e) {
+      return;
+    }
+    while (true) {
+      Heap& h = *heaps[randomHeap()];
+      if (h.lock.try_lock()) {
+        pushLocked(h, b, e);
+        h.lock.unlock();
+        return;
+      }
+    }
+  }
+
+  template <typename RangeTy>
+  void push_initial(const RangeTy& range) {
+    push(range.local_begin(), range.local_end());
+  }
+
+  std::optional<value_type> pop() {
+    for (int i = 0; i < kPopTries; ++i) {
+      if (std::optional<value_type> ret = tryTwoChoices()) {
+        return ret;
+      }
+    }
+    return popSlow();
+  }
+
+  bool empty() {
+    for (unsigned i = 0; i < num_heaps; ++i) {
+      if (heaps[i]->size.load(std::memory_order_relaxed)) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+KATANA_WLCOMPILECHECK(MultiQueue)
+
+}  // end namespace katana
+
+#endif
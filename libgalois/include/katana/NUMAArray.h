@@ -20,7 +20,10 @@
 #ifndef KATANA_LIBGALOIS_KATANA_NUMAARRAY_H_
 #define KATANA_LIBGALOIS_KATANA_NUMAARRAY_H_
 
+#include <cstring>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "katana/Galois.h"
 #include "katana/NumaMem.h"
@@ -41,17 +44,43 @@ namespace katana {
  * Allocation size must be known at runtime (allocation cannot grow dynamically).
  * Allocations and deallocations must occur on the main thread.
  *
+ * Read-mostly arrays that every socket reads at random, e.g., node degrees,
+ * can be allocated with allocateReplicated(), which keeps a copy per NUMA
+ * node. Writes go to the primary copy through the usual accessors and become
+ * visible to get() after syncReplicas().
+ *
  * If the allocation can be concurrent, check katana::gstl::Vector.
  * If the allocation must be uninitialized and resized, check katana::PODVector.
  * Read CONTRIBUTING.md for a more detailed comparison between these types.
  */
 template <typename T>
 class NUMAArray {
-  enum class AllocType { Blocked, Local, Interleaved, Floating };
+  enum class AllocType { Blocked, Local, Interleaved, Floating, Replicated };
 
   LAptr real_data_;
   T* data_{};
   size_t size_{};
+  // Replicated only: the copies for each NUMA node with active threads and,
+  // indexed by ThreadPool::getNumaNode(), the copy each node reads
+  std::vector<LAptr> replica_data_;
+  std::vector<T*> replicas_;
+
+  void AllocateReplicas() {
+    auto& tp = GetThreadPool();
+    replicas_.assign(tp.getMaxNumaNodes(), data_);
+    if (tp.getMaxNumaNodes() < 2) {
+      return;
+    }
+    for (unsigned tid = 0; tid < activeThreads; ++tid) {
+      unsigned node = tp.getNumaNode(tid);
+      if (replicas_[node] != data_) {
+        continue;
+      }
+      // Pages are placed by the first touch in syncReplicas()
+      replica_data_.emplace_back(largeMallocFloating(size_ * sizeof(T)));
+      replicas_[node] = reinterpret_cast<T*>(replica_data_.back().get());
+    }
+  }
 
   void Allocate(size_t n, AllocType t) {
     KATANA_LOG_DEBUG_ASSERT(!data_);
@@ -69,11 +98,18 @@ class NUMAArray {
     case AllocType::Floating:
       real_data_ = largeMallocFloating(n * sizeof(T));
       break;
+    case AllocType::Replicated:
+      real_data_ = largeMallocInterleaved(n * sizeof(T), activeThreads);
+      break;
     default:
       KATANA_LOG_DEBUG_ASSERT(false);
     };
 
     data_ = reinterpret_cast<T*>(real_data_.get());
+
+    if (t == AllocType::Replicated) {
+      AllocateReplicas();
+    }
   }
 
 public:
@@ -102,9 +138,15 @@ public:
   NUMAArray() = default;
 
   NUMAArray(NUMAArray&& o) noexcept
-      : real_data_(std::move(o.real_data_)), data_(o.data_), size_(o.size_) {
+      : real_data_(std::move(o.real_data_)),
+        data_(o.data_),
+        size_(o.size_),
+        replica_data_(std::move(o.replica_data_)),
+        replicas_(std::move(o.replicas_)) {
     o.data_ = nullptr;
     o.size_ = 0;
+    o.replica_data_.clear();
+    o.replicas_.clear();
   }
 
   NUMAArray& operator=(NUMAArray&& o) {
@@ -112,6 +154,8 @@ public:
     std::swap(real_data_, tmp.real_data_);
     std::swap(data_, tmp.data_);
     std::swap(size_, tmp.size_);
+    std::swap(replica_data_, tmp.replica_data_);
+    std::swap(replicas_, tmp.replicas_);
     return *this;
   }
 
@@ -160,6 +204,19 @@ public:
    */
   void allocateFloating(size_type n) { Allocate(n, AllocType::Floating); }
 
+  /**
+   * Allocates an interleaved primary copy plus a read-only copy on each NUMA
+   * node that has active threads. Uses (nodes + 1) * n elements of memory.
+   *
+   * @param  n         number of elements to allocate
+   */
+  void allocateReplicated(size_type n) {
+    static_assert(
+        std::is_trivially_copyable_v<T>,
+        "replicated arrays are copied bytewise");
+    Allocate(n, AllocType::Replicated);
+  }
+
   /**
    * Allocate memory to threads based on a provided array specifying which
    * threads receive which elements of data.
@@ -202,6 +259,8 @@ public:
   }
 
   void deallocate() {
+    replicas_.clear();
+    replica_data_.clear();
     real_data_.reset();
     data_ = 0;
     size_ = 0;
@@ -218,6 +277,55 @@ public:
   const_pointer data() const { return data_; }
   pointer data() { return data_; }
 
+  /**
+   * The copy of the array on the calling thread's NUMA node as of the last
+   * syncReplicas(). Without replicas, this is data(). Hoist it out of inner
+   * loops; the lookup reads a thread local.
+   */
+  const_pointer localData() const {
+    if (replicas_.empty()) {
+      return data_;
+    }
+    return replicas_[ThreadPool::getNumaNode()];
+  }
+
+  //! Read element x from the calling thread's NUMA node. See localData().
+  const_reference get(size_type x) const { return localData()[x]; }
+
+  /**
+   * Copies the primary copy to every replica. Each replica is written by
+   * the active threads on its own NUMA node. Call on the main thread after
+   * writes and before reading through get().
+   */
+  void syncReplicas() {
+    if (replica_data_.empty()) {
+      return;
+    }
+    auto& tp = GetThreadPool();
+    // Split each replica among the active threads on its node
+    std::vector<unsigned> rank(activeThreads);
+    std::vector<unsigned> num_on_node(replicas_.size());
+    for (unsigned tid = 0; tid < activeThreads; ++tid) {
+      rank[tid] = num_on_node[tp.getNumaNode(tid)]++;
+    }
+    for (size_t node = 0; node < replicas_.size(); ++node) {
+      if (replicas_[node] != data_ && num_on_node[node] == 0) {
+        // The number of active threads has changed since allocation
+        std::memcpy(replicas_[node], data_, size_ * sizeof(T));
+      }
+    }
+    katana::on_each([&](unsigned tid, unsigned) {
+      unsigned node = ThreadPool::getNumaNode();
+      T* replica = replicas_[node];
+      if (replica == data_) {
+        return;
+      }
+      auto [b, e] =
+          katana::block_range(size_t{0}, size_, rank[tid], num_on_node[node]);
+      std::memcpy(replica + b, data_ + b, (e - b) * sizeof(T));
+    });
+  }
+
   /**
    * equal_to operator. WARNING: Expensive, O(n) cost of checking two arrays
    * element by element
@@ -291,6 +399,8 @@ public:
   void allocateBlocked(size_type) {}
   void allocateLocal(size_type) {}
   void allocateFloating(size_type) {}
+  void allocateReplicated(size_type) {}
+  void syncReplicas() {}
   template <typename RangeArray>
   void allocateSpecified(size_type, RangeArray) {}
 
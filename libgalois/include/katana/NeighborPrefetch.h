@@ -0,0 +1,210 @@
+#ifndef KATANA_LIBGALOIS_KATANA_NEIGHBORPREFETCH_H_
+#define KATANA_LIBGALOIS_KATANA_NEIGHBORPREFETCH_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <utility>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/Timer.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// The number of edges ahead of the current one at which the property slot
+/// of a neighbor is prefetched. A distance of zero disables prefetching.
+///
+/// A default constructed distance is chosen by the first
+/// GatherNeighborsPrefetched that uses it: the loop times its first few
+/// blocks of edges with each of kCandidates and keeps the fastest. The best
+/// distance depends on the graph, so share one object between the
+/// iterations over a graph, not between calls on different graphs.
+class PrefetchDistance {
+public:
+  static constexpr unsigned kAuto = std::numeric_limits<unsigned>::max();
+  /// Used until a distance has been tuned
+  static constexpr unsigned kDefault = 8;
+  static constexpr unsigned kCandidates[] = {0, 4, 8, 16, 32, 64};
+
+  explicit PrefetchDistance(unsigned distance = kAuto) : distance_(distance) {}
+
+  bool tuned() const { return value() != kAuto; }
+
+  unsigned value() const { return distance_.load(std::memory_order_relaxed); }
+
+  void Set(unsigned distance) {
+    distance_.store(distance, std::memory_order_relaxed);
+  }
+
+private:
+  std::atomic<unsigned> distance_;
+};
+
+/// Call fn(edge, dest) for every out-edge of node, prefetching
+/// props[dest] of the neighbor distance edges ahead. props is anything
+/// indexable by a node, e.g., a NUMAArray or a pointer.
+template <typename Topo, typename Props, typename F>
+void
+ForEachNeighborPrefetched(
+    const Topo& topo, typename Topo::Node node, const Props& props,
+    unsigned distance, const F& fn) {
+  auto edges = topo.edges(node);
+  auto ahead = *edges.begin();
+  // Nothing is prefetched at distance zero
+  auto end = distance > 0 ? *edges.end() : ahead;
+  auto prefetch_until = std::min(end, ahead + distance);
+  for (; ahead < prefetch_until; ++ahead) {
+    __builtin_prefetch(&props[topo.edge_dest(ahead)]);
+  }
+  for (auto e : edges) {
+    if (ahead < end) {
+      __builtin_prefetch(&props[topo.edge_dest(ahead)]);
+      ++ahead;
+    }
+    fn(e, topo.edge_dest(e));
+  }
+}
+
+namespace internal {
+
+// Gather over the nodes [begin, end). The edges of consecutive nodes are
+// consecutive, so prefetches run across node boundaries and low degree nodes
+// still get their neighbors fetched ahead.
+template <
+    typename Topo, typename Props, typename T, typename EdgeFn,
+    typename NodeFn>
+void
+GatherBlockPrefetched(
+    const Topo& topo, const Props& props, unsigned distance,
+    typename Topo::Node begin, typename Topo::Node end, const T& identity,
+    const EdgeFn& edge_fn, const NodeFn& node_fn) {
+  if (begin == end) {
+    return;
+  }
+  auto ahead = *topo.edges(begin).begin();
+  // Nothing is prefetched at distance zero
+  auto last = distance > 0 ? *topo.edges(end - 1).end() : ahead;
+  auto prefetch_until = std::min(last, ahead + distance);
+  for (; ahead < prefetch_until; ++ahead) {
+    __builtin_prefetch(&props[topo.edge_dest(ahead)]);
+  }
+  for (auto n = begin; n != end; ++n) {
+    T acc = identity;
+    for (auto e : topo.edges(n)) {
+      if (ahead < last) {
+        __builtin_prefetch(&props[topo.edge_dest(ahead)]);
+        ++ahead;
+      }
+      acc = edge_fn(std::move(acc), e, topo.edge_dest(e));
+    }
+    node_fn(n, std::move(acc));
+  }
+}
+
+}  // namespace internal
+
+/// For every node n of topo, in parallel, fold edge_fn over the out-edges of
+/// n starting from identity and pass the result to node_fn, while the
+/// property slots props[dest] of upcoming neighbors are prefetched.
+///
+/// - edge_fn(T acc, edge, dest) returns the new accumulator
+/// - node_fn(n, T acc) consumes the result for n
+///
+/// Extra arguments, e.g., katana::loopname, are passed on to do_all. The
+/// edges of node n + 1 must directly follow those of node n, as in every
+/// CSR topology.
+///
+/// \code
+/// katana::PrefetchDistance distance;
+/// for (unsigned i = 0; i < num_iterations; ++i) {
+///   katana::GatherNeighborsPrefetched(
+///       topo, rank, &distance, 0.0f,
+///       [&](float sum, auto, auto dest) { return sum + rank[dest]; },
+///       [&](auto n, float sum) { next[n] = sum; });
+///   std::swap(rank, next);
+/// }
+/// \endcode
+template <
+    typename Topo, typename Props, typename T, typename EdgeFn,
+    typename NodeFn, typename... Args>
+void
+GatherNeighborsPrefetched(
+    const Topo& topo, const Props& props, PrefetchDistance* distance,
+    const T& identity, const EdgeFn& edge_fn, const NodeFn& node_fn,
+    Args&&... args) {
+  using Node = typename Topo::Node;
+  constexpr uint64_t kTuneEdges = 1 << 16;
+  constexpr Node kBlockNodes = 64;
+
+  Node num_nodes = topo.num_nodes();
+  Node begin = 0;
+
+  // Tune on the leading nodes of the graph, which must be visited anyway,
+  // so no node is visited twice. Every candidate is timed twice and its
+  // best time kept to filter out noise.
+  if (!distance->tuned()) {
+    constexpr size_t kNumCandidates =
+        std::size(PrefetchDistance::kCandidates);
+    uint64_t best_usec[kNumCandidates];
+    std::fill_n(best_usec, kNumCandidates, ~uint64_t{0});
+    bool complete = true;
+    for (unsigned round = 0; round < 2 && complete; ++round) {
+      for (size_t i = 0; i < kNumCandidates; ++i) {
+        if (begin == num_nodes) {
+          complete = false;
+          break;
+        }
+        uint64_t first = *topo.edges(begin).begin();
+        Node end = begin;
+        while (end < num_nodes &&
+               *topo.edges(end).end() - first < kTuneEdges) {
+          ++end;
+        }
+        if (end == num_nodes) {
+          complete = false;
+          break;
+        }
+        ++end;
+
+        Timer timer;
+        timer.start();
+        internal::GatherBlockPrefetched(
+            topo, props, PrefetchDistance::kCandidates[i], begin, end,
+            identity, edge_fn, node_fn);
+        timer.stop();
+        uint64_t num_edges = *topo.edges(end - 1).end() - first;
+        uint64_t usec = timer.get_usec() * kTuneEdges / num_edges;
+        best_usec[i] = std::min(best_usec[i], usec);
+        begin = end;
+      }
+    }
+    // Too small a graph to tell the candidates apart; tune on a later call
+    if (complete) {
+      distance->Set(PrefetchDistance::kCandidates[std::distance(
+          best_usec, std::min_element(best_usec, best_usec + kNumCandidates))]);
+    }
+  }
+
+  unsigned d =
+      distance->tuned() ? distance->value() : PrefetchDistance::kDefault;
+  Node num_blocks = (num_nodes - begin + kBlockNodes - 1) / kBlockNodes;
+  do_all(
+      iterate(Node{0}, num_blocks),
+      [&](Node block) {
+        Node block_begin = begin + block * kBlockNodes;
+        Node block_end = std::min<Node>(block_begin + kBlockNodes, num_nodes);
+        internal::GatherBlockPrefetched(
+            topo, props, d, block_begin, block_end, identity, edge_fn,
+            node_fn);
+      },
+      steal(), std::forward<Args>(args)...);
+}
+
+}  // namespace katana
+
+#endif
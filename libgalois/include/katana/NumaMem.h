@@ -21,9 +21,11 @@
 #define KATANA_LIBGALOIS_KATANA_NUMAMEM_H_
 
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <vector>
 
+#include "katana/MemoryAccounting.h"
 #include "katana/config.h"
 
 namespace katana {
@@ -31,12 +33,16 @@ namespace katana {
 namespace internal {
 struct KATANA_EXPORT largeFreer {
   size_t bytes;
+  /// The category the allocation was charged to
+  MemoryCategory category;
   void operator()(void* ptr) const;
 };
 }  // namespace internal
 
 typedef std::unique_ptr<void, internal::largeFreer> LAptr;
 
+// Each allocation is charged to the CurrentMemoryCategory of the calling
+// thread until it is freed; going over the memory budget is fatal.
 KATANA_EXPORT LAptr largeMallocLocal(size_t bytes);  // fault in locally
 KATANA_EXPORT LAptr
 largeMallocFloating(size_t bytes);  // leave numa mapping undefined
@@ -51,6 +57,24 @@ KATANA_EXPORT LAptr largeMallocSpecified(
     size_t bytes, uint32_t numThreads, RangeArrayTy& threadRanges,
     size_t elementSize);
 
+/// Where the pages of a memory region are, as reported by the OS
+struct KATANA_EXPORT PagePlacement {
+  /// Bytes of the region backed by explicit or transparent huge pages. For
+  /// transparent huge pages this is prorated from the whole mapping.
+  uint64_t huge_page_bytes{0};
+  /// The number of sampled pages on each NUMA node
+  std::vector<uint64_t> sampled_pages_per_node;
+  /// The number of sampled pages that are not faulted in or whose node could
+  /// not be determined
+  uint64_t sampled_pages_unknown{0};
+};
+
+/// Query the page sizes and NUMA nodes backing [ptr, ptr + bytes). At most
+/// max_samples pages, spread evenly over the region, are queried for their
+/// node. Only Linux is supported; elsewhere every sample is unknown.
+KATANA_EXPORT PagePlacement GetPagePlacement(
+    const void* ptr, size_t bytes, size_t max_samples = 4096);
+
 }  // namespace katana
 
 #endif
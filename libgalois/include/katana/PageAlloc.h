@@ -21,6 +21,7 @@
 #define KATANA_LIBGALOIS_KATANA_PAGEALLOC_H_
 
 #include <cstddef>
+#include <cstdint>
 
 #include "katana/config.h"
 
@@ -35,6 +36,18 @@ KATANA_EXPORT void* allocPages(unsigned num, bool preFault);
 // free page range
 KATANA_EXPORT void freePages(void* ptr, unsigned num);
 
+//! Number of pages returned by allocPages, by how they are backed
+struct PageBackingCounts {
+  //! Reserved huge pages (MAP_HUGETLB)
+  uint64_t hugetlb{0};
+  //! Regular mappings advised to use transparent huge pages
+  uint64_t transparent{0};
+  //! Regular pages only
+  uint64_t regular{0};
+};
+
+KATANA_EXPORT PageBackingCounts pageBackingCounts();
+
 }  // namespace katana
 
 #endif
@@ -28,6 +28,7 @@
 #include <vector>
 
 #include "katana/CacheLineStorage.h"
+#include "katana/MemoryAccounting.h"
 #include "katana/PageAlloc.h"
 #include "katana/PtrLock.h"
 #include "katana/SimpleLock.h"
@@ -48,6 +49,11 @@ KATANA_EXPORT int numPagePoolAllocTotal();
 //! Returns total large pages allocated for thread by Galois memory management
 //! subsystem
 KATANA_EXPORT int numPagePoolAllocForThread(unsigned tid);
+//! Returns pages on the free list of thread
+KATANA_EXPORT int numPagePoolFreeForThread(unsigned tid);
+//! Returns pages thread took from the free list of another thread on its NUMA
+//! node rather than from the OS
+KATANA_EXPORT int numPagePoolNodeReuseForThread(unsigned tid);
 
 namespace internal {
 
@@ -58,16 +64,24 @@ struct FreeNode {
 typedef katana::PtrLock<FreeNode> HeadPtr;
 typedef katana::CacheLineStorage<HeadPtr> HeadPtrStorage;
 
-// Tracks pages allocated
+// Tracks pages allocated. Each page belongs to the thread that got it from
+// the OS and returns to that thread's free list, so a free list only holds
+// pages on its thread's NUMA node. A thread whose own list is empty takes
+// from the lists of the other threads on its node before asking the OS.
 template <typename _UNUSED = void>
 class PageAllocState {
   std::deque<std::atomic<int>> counts;
   std::deque<std::atomic<int>> freeCounts;
+  std::deque<std::atomic<int>> nodeReuseCounts;
   std::vector<HeadPtrStorage> pool;
   std::unordered_map<void*, int> ownerMap;
   katana::SimpleLock mapLock;
 
   void* allocFromOS() {
+    // Pool pages are kept until exit and are all charged to worklists, their
+    // main user
+    katana::MemoryAccounting::ChargeOrDie(
+        katana::MemoryCategory::kWorklists, katana::allocSize());
     void* ptr = katana::allocPages(1, true);
     KATANA_LOG_DEBUG_ASSERT(ptr);
     auto tid = katana::ThreadPool::getTID();
@@ -77,11 +91,45 @@ class PageAllocState {
     return ptr;
   }
 
+  FreeNode* popFree(unsigned tid) {
+    HeadPtr& hp = pool[tid].data;
+    if (!hp.getValue()) {
+      return nullptr;
+    }
+    hp.lock();
+    FreeNode* h = hp.getValue();
+    if (h) {
+      hp.unlock_and_set(h->next);
+      freeCounts[tid] -= 1;
+      return h;
+    }
+    hp.unlock();
+    return nullptr;
+  }
+
+  FreeNode* popFreeOnNode(unsigned tid) {
+    auto& tp = katana::GetThreadPool();
+    const unsigned num = tp.getMaxThreads();
+    const unsigned node = tp.getNumaNode(tid);
+    for (unsigned i = 1; i < num; ++i) {
+      unsigned t = (tid + i) % num;
+      if (freeCounts[t] <= 0 || tp.getNumaNode(t) != node) {
+        continue;
+      }
+      if (FreeNode* h = popFree(t)) {
+        nodeReuseCounts[tid] += 1;
+        return h;
+      }
+    }
+    return nullptr;
+  }
+
 public:
   PageAllocState() {
     auto num = katana::GetThreadPool().getMaxThreads();
     counts.resize(num);
     freeCounts.resize(num);
+    nodeReuseCounts.resize(num);
     pool.resize(num);
   }
 
@@ -100,18 +148,15 @@ public:
     return std::accumulate(freeCounts.begin(), freeCounts.end(), 0);
   }
 
+  int nodeReuseCount(unsigned tid) const { return nodeReuseCounts[tid]; }
+
   void* pageAlloc() {
     auto tid = katana::ThreadPool::getTID();
-    HeadPtr& hp = pool[tid].data;
-    if (hp.getValue()) {
-      hp.lock();
-      FreeNode* h = hp.getValue();
-      if (h) {
-        hp.unlock_and_set(h->next);
-        freeCounts[tid] -= 1;
-        return h;
-      }
-      hp.unlock();
+    if (FreeNode* h = popFree(tid)) {
+      return h;
+    }
+    if (FreeNode* h = popFreeOnNode(tid)) {
+      return h;
     }
     return allocFromOS();
   }
@@ -119,6 +164,8 @@ public:
   void pageFree(void* ptr) {
 #ifdef KATANA_USE_JEMALLOC
     freePages(ptr, 1);
+    katana::MemoryAccounting::Release(
+        katana::MemoryCategory::kWorklists, katana::allocSize());
 #else
     KATANA_LOG_DEBUG_ASSERT(ptr);
     mapLock.lock();
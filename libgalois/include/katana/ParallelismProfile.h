@@ -0,0 +1,131 @@
+#ifndef KATANA_LIBGALOIS_KATANA_PARALLELISMPROFILE_H_
+#define KATANA_LIBGALOIS_KATANA_PARALLELISMPROFILE_H_
+
+#include <cstdint>
+#include <string>
+
+#include "katana/config.h"
+
+namespace katana {
+
+/// A profile of the parallelism available to the named loops of a run, to
+/// tell a run that lacks parallelism from one that is bound by memory or
+/// something else.
+///
+/// Loops are recorded in rounds:
+///
+/// - Each run of a named do_all is one round of a bulk-synchronous loop. All
+///   of its iterations are independent, so its available parallelism is its
+///   number of iterations.
+/// - A named for_each runs with the ParaMeter executor while profiling: it
+///   proceeds in steps, each running every item available at the start of
+///   the step, and items pushed or aborted in a step run in the next one.
+///   Each step is a round whose available parallelism is the number of items
+///   that committed. for_each loops with local_state are run as usual and
+///   not recorded.
+///
+/// For each loop the profile has its rounds with their work (iterations
+/// run, aborted ones included), available parallelism, time and threads,
+/// and a summary: the critical path length is the number of rounds, and
+/// starved rounds are those with less parallelism than threads. A loop with
+/// few starved rounds that still scales poorly is limited by something
+/// other than parallelism, e.g., memory bandwidth.
+///
+/// Profiling is on for a whole run if KATANA_PARALLELISM_PROFILE names a
+/// file, which is written when the SharedMemSys is destroyed, and for the
+/// lifetime of a Scope, e.g., for an analytics call whose plan sets
+/// analytics::Plan::parallelism_profile. Profiles are written as JSON. The
+/// ParaMeter schedule differs from the usual worklists, so a profiled run is
+/// slower and may do different work.
+class KATANA_EXPORT ParallelismProfile {
+public:
+  /// Profile the loops run during the lifetime of a scope into a file
+  class KATANA_EXPORT Scope {
+  public:
+    /// Write the profile to path, which may be empty for no profile
+    explicit Scope(std::string path);
+    ~Scope();
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+    Scope(Scope&&) = delete;
+    Scope& operator=(Scope&&) = delete;
+
+  private:
+    std::string path_;
+  };
+
+  /// Records the rounds of one run of a loop. While it exists, other loops,
+  /// e.g., the loops an executor runs each round with, are not recorded.
+  class KATANA_EXPORT Loop {
+  public:
+    /// Record the loop if IsEnabled(); kind is "do_all" or "for_each"
+    Loop(const char* loopname, const char* kind);
+    ~Loop();
+
+    Loop(const Loop&) = delete;
+    Loop& operator=(const Loop&) = delete;
+
+    bool recording() const { return recording_; }
+
+    void BeginRound();
+
+    /// End a round whose work was counted by the threads with AddWork;
+    /// every iteration is available in parallel
+    void EndRound();
+
+    /// End a round of work iterations of which parallelism committed
+    void EndRound(uint64_t parallelism, uint64_t work);
+
+  private:
+    const char* loopname_;
+    const char* kind_;
+    bool recording_{false};
+    uint64_t round_start_ns_{0};
+  };
+
+  /// Whether loops started now are recorded
+  static bool IsEnabled();
+
+  /// Count n iterations run by the calling thread in the current round of
+  /// a do_all; a no-op unless a round is counting
+  static void AddWork(uint64_t n);
+
+  /// Write the profile named by KATANA_PARALLELISM_PROFILE, if any
+  static void DumpAtExit();
+};
+
+/// A round of a do_all for do_all_gen, recorded if Enable and profiling
+template <bool Enable>
+class CondParallelismRound {
+  ParallelismProfile::Loop loop_;
+
+public:
+  explicit CondParallelismRound(const char* loopname)
+      : loop_(loopname, "do_all") {}
+
+  void start() {
+    if (loop_.recording()) {
+      loop_.BeginRound();
+    }
+  }
+
+  void stop() {
+    if (loop_.recording()) {
+      loop_.EndRound();
+    }
+  }
+};
+
+template <>
+class CondParallelismRound<false> {
+public:
+  explicit CondParallelismRound(const char*) {}
+
+  void start() const {}
+  void stop() const {}
+};
+
+}  // namespace katana
+
+#endif
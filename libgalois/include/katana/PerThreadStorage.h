@@ -27,6 +27,7 @@
 
 #include <boost/iterator/iterator_facade.hpp>
 
+#include "katana/CompilerSpecific.h"
 #include "katana/HWTopo.h"
 #include "katana/PaddedLock.h"
 #include "katana/ThreadPool.h"
@@ -39,6 +40,10 @@ class KATANA_EXPORT PerBackend {
 
   std::atomic<unsigned int> nextLoc{0};
   std::atomic<char*>* heads{nullptr};
+  //! Whether threads of a socket share the storage of their socket leader
+  bool perSocket{false};
+  //! Whether every thread has storage, including threads not started yet
+  std::atomic<bool> remotesReady{false};
   Lock freeOffsetsLock;
   std::vector<std::vector<unsigned>> freeOffsets;
   /**
@@ -52,6 +57,11 @@ class KATANA_EXPORT PerBackend {
 
   void initCommon(unsigned maxT);
   static unsigned nextLog2(unsigned size);
+  //! Give thread id storage unless some was made for it before it started
+  char* adoptOrAlloc(unsigned id);
+  //! Make storage for the threads the pool has not started yet, so that
+  //! storage can be created before they are
+  void initRemotes();
 
 public:
   PerBackend();
@@ -83,6 +93,23 @@ KATANA_EXPORT PerBackend& getPTSBackend();
 extern thread_local char* pssBase;
 KATANA_EXPORT PerBackend& getPPSBackend();
 
+namespace internal {
+
+/**
+ * The calling thread's ptsBase and pssBase.
+ *
+ * Reading a thread_local defined in another shared object takes a call to
+ * __tls_get_addr, which the compiler must repeat for every getLocal() in a
+ * loop, e.g., for every Reducible::update in a loop over edges. The bases do
+ * not change once a thread has started, so, like errno's
+ * __errno_location(), these are declared const, which lets the compiler
+ * hoist the lookup out of loops.
+ */
+KATANA_ATTRIBUTE_CONST KATANA_EXPORT char* PerThreadBase() noexcept;
+KATANA_ATTRIBUTE_CONST KATANA_EXPORT char* PerSocketBase() noexcept;
+
+}  // namespace internal
+
 KATANA_EXPORT void initPTS(unsigned maxT);
 
 template <typename T>
@@ -164,12 +191,12 @@ public:
   }
 
   T* getLocal() {
-    void* ditem = b->getLocal(offset, ptsBase);
+    void* ditem = b->getLocal(offset, internal::PerThreadBase());
     return reinterpret_cast<T*>(ditem);
   }
 
   const T* getLocal() const {
-    void* ditem = b->getLocal(offset, ptsBase);
+    void* ditem = b->getLocal(offset, internal::PerThreadBase());
     return reinterpret_cast<T*>(ditem);
   }
 
@@ -250,12 +277,12 @@ public:
   ~PerSocketStorage() { destruct(); }
 
   T* getLocal() {
-    void* ditem = b->getLocal(offset, pssBase);
+    void* ditem = b->getLocal(offset, internal::PerSocketBase());
     return reinterpret_cast<T*>(ditem);
   }
 
   const T* getLocal() const {
-    void* ditem = b->getLocal(offset, pssBase);
+    void* ditem = b->getLocal(offset, internal::PerSocketBase());
     return reinterpret_cast<T*>(ditem);
   }
 
@@ -1,11 +1,15 @@
 #ifndef KATANA_LIBGALOIS_KATANA_PROPERTIES_H_
 #define KATANA_LIBGALOIS_KATANA_PROPERTIES_H_
 
+#include <algorithm>
 #include <cassert>
+#include <memory>
 #include <string_view>
 #include <utility>
+#include <vector>
 
 #include <arrow/array.h>
+#include <arrow/chunked_array.h>
 #include <arrow/stl.h>
 #include <arrow/type_fwd.h>
 #include <arrow/type_traits.h>
@@ -403,6 +407,199 @@ private:
   const ArrowArrayType& array_;
 };
 
+/// DictionaryPropertyReadOnlyView provides a read-only property view over
+/// arrow::DictionaryArrays, such as dictionary encoded string properties.
+/// The value of an element is its code, the index of its value in
+/// dictionary(), so elements can be compared and grouped as integers
+/// without decoding them.
+///
+/// \tparam CodeType the C type of the dictionary indices
+template <typename CodeType = int32_t>
+class DictionaryPropertyReadOnlyView {
+public:
+  using value_type = CodeType;
+
+  static Result<DictionaryPropertyReadOnlyView> Make(
+      const arrow::DictionaryArray& array) {
+    const auto& index_type = *array.indices()->type();
+    if (index_type.id() != arrow::CTypeTraits<CodeType>::ArrowType::type_id) {
+      return KATANA_ERROR(
+          ErrorCode::TypeError, "dictionary codes are {}",
+          index_type.ToString());
+    }
+    return DictionaryPropertyReadOnlyView(array);
+  }
+
+  bool IsValid(size_t i) const { return array_.IsValid(i); }
+
+  value_type GetValue(size_t i) const {
+    KATANA_LOG_DEBUG_ASSERT(IsValid(i));
+    return codes_[i];
+  }
+
+  value_type operator[](size_t i) const {
+    if (!IsValid(i)) {
+      return value_type{};
+    }
+    return GetValue(i);
+  }
+
+  /// \returns the values of the codes
+  std::shared_ptr<arrow::Array> dictionary() const {
+    return array_.dictionary();
+  }
+
+  /// \returns the number of codes, which are in [0, num_codes())
+  size_t num_codes() const { return array_.dictionary()->length(); }
+
+private:
+  DictionaryPropertyReadOnlyView(const arrow::DictionaryArray& array)
+      : array_(array),
+        codes_(array.indices()->data()->template GetValues<CodeType>(1)) {}
+
+  const arrow::DictionaryArray& array_;
+  const CodeType* codes_;
+};
+
+/// ChunkedPropertyView applies the view of a property to every chunk of an
+/// arrow::ChunkedArray, so that a column made of several arrays, as after an
+/// upsert or when a table comes from arrow, can be used without combining
+/// its chunks into a copy.
+///
+/// Elements are addressed by their index in the whole column. An index is
+/// mapped to its chunk through a table with the first chunk of each block of
+/// 2^block_shift elements. Blocks are no larger than the smallest chunk, so
+/// a lookup checks the table entry and the next chunk boundary, but they
+/// have at least 2^kMinBlockShift elements to bound the table; with smaller
+/// chunks, a lookup binary searches the chunks that start in one block.
+///
+/// Loops over all elements should use DoAllChunkAligned (PropertyViews.h),
+/// which gives each task a range within one chunk and skips the lookup.
+///
+/// \tparam Prop A property; each chunk must have its arrow type
+template <typename Prop>
+class ChunkedPropertyView {
+public:
+  using ChunkViewType = PropertyViewType<Prop>;
+  using value_type = typename ChunkViewType::value_type;
+
+  static Result<ChunkedPropertyView> Make(
+      std::shared_ptr<arrow::ChunkedArray> array) {
+    ChunkedPropertyView view;
+    view.chunk_begins_.emplace_back(0);
+    for (int i = 0, n = array->num_chunks(); i < n; ++i) {
+      arrow::Array* chunk = array->chunk(i).get();
+      if (chunk->length() == 0) {
+        continue;
+      }
+      Result<ChunkViewType> chunk_view = ConstructPropertyView<Prop>(chunk);
+      if (!chunk_view) {
+        return chunk_view.error().WithContext("chunk {} of {}", i, n);
+      }
+      view.chunks_.emplace_back(std::move(chunk_view.value()));
+      view.chunk_begins_.emplace_back(
+          view.chunk_begins_.back() + chunk->length());
+    }
+    view.array_ = std::move(array);
+    view.BuildLookup();
+    return Result<ChunkedPropertyView>(std::move(view));
+  }
+
+  /// \returns the number of elements over all chunks
+  size_t size() const { return chunk_begins_.back(); }
+
+  /// \returns the number of non-empty chunks
+  size_t num_chunks() const { return chunks_.size(); }
+
+  /// \returns the view of chunk c; element j of chunk c is element
+  /// chunk_begin(c) + j of the column
+  ChunkViewType& chunk(size_t c) { return chunks_[c]; }
+  const ChunkViewType& chunk(size_t c) const { return chunks_[c]; }
+
+  size_t chunk_begin(size_t c) const { return chunk_begins_[c]; }
+  size_t chunk_end(size_t c) const { return chunk_begins_[c + 1]; }
+
+  /// \returns the chunk holding element i and the index of i in that chunk
+  std::pair<size_t, size_t> Locate(size_t i) const {
+    KATANA_LOG_DEBUG_ASSERT(i < size());
+    size_t block = i >> block_shift_;
+    size_t c = block_chunks_[block];
+    if (chunk_begins_[c + 1] <= i) {
+      // several chunks start in this block; they are at most the ones up to
+      // the chunk of the next block
+      auto begin = chunk_begins_.begin();
+      c = std::upper_bound(
+              begin + c + 1, begin + block_chunks_[block + 1] + 1, i) -
+          begin - 1;
+    }
+    return std::make_pair(c, i - chunk_begins_[c]);
+  }
+
+  bool IsValid(size_t i) const {
+    auto [c, j] = Locate(i);
+    return chunks_[c].IsValid(j);
+  }
+
+  decltype(auto) GetValue(size_t i) {
+    auto [c, j] = Locate(i);
+    return chunks_[c].GetValue(j);
+  }
+
+  decltype(auto) GetValue(size_t i) const {
+    auto [c, j] = Locate(i);
+    return chunks_[c].GetValue(j);
+  }
+
+  decltype(auto) operator[](size_t i) {
+    auto [c, j] = Locate(i);
+    return chunks_[c][j];
+  }
+
+  decltype(auto) operator[](size_t i) const {
+    auto [c, j] = Locate(i);
+    return chunks_[c][j];
+  }
+
+private:
+  static constexpr size_t kMinBlockShift = 6;
+
+  ChunkedPropertyView() = default;
+
+  void BuildLookup() {
+    if (chunks_.empty()) {
+      return;
+    }
+    size_t min_chunk_size = size();
+    for (size_t c = 0; c < chunks_.size(); ++c) {
+      min_chunk_size = std::min(min_chunk_size, chunk_end(c) - chunk_begin(c));
+    }
+    block_shift_ = kMinBlockShift;
+    while ((size_t{2} << block_shift_) <= min_chunk_size) {
+      ++block_shift_;
+    }
+
+    // The last entry is the chunk of the last element and bounds the search
+    // in the last block
+    size_t num_blocks = ((size() - 1) >> block_shift_) + 1;
+    block_chunks_.resize(num_blocks + 1);
+    size_t c = 0;
+    for (size_t block = 0; block < num_blocks; ++block) {
+      size_t first = block << block_shift_;
+      while (chunk_begins_[c + 1] <= first) {
+        ++c;
+      }
+      block_chunks_[block] = c;
+    }
+    block_chunks_[num_blocks] = chunks_.size() - 1;
+  }
+
+  std::shared_ptr<arrow::ChunkedArray> array_;
+  std::vector<ChunkViewType> chunks_;
+  std::vector<size_t> chunk_begins_;
+  std::vector<uint32_t> block_chunks_;
+  size_t block_shift_{kMinBlockShift};
+};
+
 template <typename ArrowT, typename ViewT>
 struct Property {
   using ArrowType = ArrowT;
@@ -472,6 +669,12 @@ struct LargeStringReadOnlyProperty
           arrow::LargeStringType,
           StringPropertyReadOnlyView<arrow::LargeStringArray>> {};
 
+/// A DictionaryReadOnlyProperty views the int32 codes of a dictionary
+/// encoded property, as read from a dictionary encoded parquet column.
+struct DictionaryReadOnlyProperty
+    : public Property<
+          arrow::DictionaryType, DictionaryPropertyReadOnlyView<int32_t>> {};
+
 template <typename T>
 struct StructProperty
     : public Property<arrow::FixedSizeBinaryType, katana::PODPropertyView<T>> {
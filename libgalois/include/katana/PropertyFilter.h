@@ -0,0 +1,127 @@
+#ifndef KATANA_LIBGALOIS_KATANA_PROPERTYFILTER_H_
+#define KATANA_LIBGALOIS_KATANA_PROPERTYFILTER_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/DynamicBitset.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+class PropertyGraph;
+
+/// A predicate over the properties and types of the nodes or the edges of a
+/// property graph, built from comparisons, IN-lists, type membership and the
+/// boolean connectives. PropertyGraph::FilterNodes and
+/// PropertyGraph::FilterEdges evaluate a predicate into a DynamicBitset with
+/// the bit of each selected entity set, which can be passed to
+/// SubGraphExtraction or used as a mask by analytics.
+///
+/// The leaves are evaluated one property column at a time: the entities are
+/// split into blocks of whole bitset words that are processed in parallel,
+/// and each word is computed from 64 consecutive values without branching.
+/// The connectives combine the bitsets of their operands word by word.
+///
+/// A null property value satisfies no comparison and no IN-list, so Not
+/// selects the entities whose value is null.
+///
+/// \code
+/// using P = katana::PropertyPredicate;
+/// auto selected = KATANA_CHECKED(pg->FilterNodes(P::And({
+///     P::HasType("Person"),
+///     P::Between(
+///         "age", arrow::MakeScalar(int64_t{18}),
+///         arrow::MakeScalar(int64_t{65})),
+/// })));
+/// \endcode
+class KATANA_EXPORT PropertyPredicate {
+public:
+  enum class Op {
+    kEqual,
+    kNotEqual,
+    kLess,
+    kLessEqual,
+    kGreater,
+    kGreaterEqual,
+  };
+
+  /// Select the entities whose property_name value compares to value as op
+  /// says. value is cast to the type of the property, which must be numeric,
+  /// boolean or a string.
+  static PropertyPredicate Compare(
+      const std::string& property_name, Op op,
+      std::shared_ptr<arrow::Scalar> value);
+
+  /// Select the entities whose property_name value is in [low, high].
+  static PropertyPredicate Between(
+      const std::string& property_name, std::shared_ptr<arrow::Scalar> low,
+      std::shared_ptr<arrow::Scalar> high);
+
+  /// Select the entities whose property_name value equals one of values.
+  static PropertyPredicate In(
+      const std::string& property_name,
+      std::vector<std::shared_ptr<arrow::Scalar>> values);
+
+  /// Select the entities that have the atomic type named type_name,
+  /// directly or as part of an intersection type.
+  static PropertyPredicate HasType(const std::string& type_name);
+
+  /// Select the entities that satisfy every operand; every entity if there
+  /// are none.
+  static PropertyPredicate And(std::vector<PropertyPredicate> operands);
+
+  /// Select the entities that satisfy at least one operand; no entity if
+  /// there are none.
+  static PropertyPredicate Or(std::vector<PropertyPredicate> operands);
+
+  /// Select the entities that do not satisfy operand.
+  static PropertyPredicate Not(PropertyPredicate operand);
+
+  /// Evaluate the predicate over the nodes of pg, setting the bit of each
+  /// node that satisfies it in a bitset of pg.num_nodes() bits.
+  Result<DynamicBitset> SelectNodes(const PropertyGraph& pg) const;
+
+  /// Evaluate the predicate over the edges of pg, like SelectNodes.
+  Result<DynamicBitset> SelectEdges(const PropertyGraph& pg) const;
+
+  /// A description of the predicate, for messages.
+  std::string ToString() const;
+
+private:
+  enum class Kind {
+    kCompare,
+    kIn,
+    kHasType,
+    kAnd,
+    kOr,
+    kNot,
+  };
+
+  struct Node {
+    Kind kind;
+    Op op{Op::kEqual};
+    std::string name;
+    std::vector<std::shared_ptr<arrow::Scalar>> values;
+    std::vector<PropertyPredicate> operands;
+  };
+
+  struct Entities;
+
+  explicit PropertyPredicate(std::shared_ptr<const Node> node)
+      : node_(std::move(node)) {}
+
+  Result<void> Evaluate(
+      const Entities& entities, DynamicBitset* selected) const;
+
+  // Predicates are immutable, so copies share their tree
+  std::shared_ptr<const Node> node_;
+};
+
+}  // namespace katana
+
+#endif
@@ -1,6 +1,8 @@
 #ifndef KATANA_LIBGALOIS_KATANA_PROPERTYGRAPH_H_
 #define KATANA_LIBGALOIS_KATANA_PROPERTYGRAPH_H_
 
+#include <memory>
+#include <mutex>
 #include <utility>
 
 #include <arrow/api.h>
@@ -8,12 +10,15 @@
 #include <arrow/type_traits.h>
 
 #include "katana/ArrowInterchange.h"
+#include "katana/CompressedGraphTopology.h"
 #include "katana/Details.h"
 #include "katana/EntityTypeManager.h"
 #include "katana/ErrorCode.h"
+#include "katana/GraphProfile.h"
 #include "katana/GraphTopology.h"
 #include "katana/Iterators.h"
 #include "katana/NUMAArray.h"
+#include "katana/PropertyFilter.h"
 #include "katana/PropertyIndex.h"
 #include "katana/Result.h"
 #include "katana/config.h"
@@ -32,6 +37,73 @@ ProjectAsArrowArray(const T* buf, const size_t len) noexcept {
   return std::make_shared<ArrowArrayType>(len, arrow::Buffer::Wrap(buf, len));
 }
 
+/// An immutable version of the properties and the topology of a
+/// PropertyGraph, see PropertyGraph::Snapshot. A snapshot keeps what it reads
+/// alive, so a reader that holds one neither waits for nor sees the changes
+/// of writers; a version is freed once the graph and every snapshot of it
+/// move on.
+///
+/// Only the properties that are loaded when the snapshot is taken are in it.
+class KATANA_EXPORT PropertyGraphSnapshot {
+public:
+  using Node = GraphTopology::Node;
+  using Edge = GraphTopology::Edge;
+
+  /// The number of changes made to the graph before this snapshot was taken
+  uint64_t version() const noexcept { return version_; }
+
+  const GraphTopology& topology() const noexcept { return topology_; }
+
+  uint64_t num_nodes() const noexcept { return topology_.num_nodes(); }
+  uint64_t num_edges() const noexcept { return topology_.num_edges(); }
+
+  const std::shared_ptr<arrow::Table>& node_properties() const noexcept {
+    return node_properties_;
+  }
+  const std::shared_ptr<arrow::Table>& edge_properties() const noexcept {
+    return edge_properties_;
+  }
+
+  Result<std::shared_ptr<arrow::ChunkedArray>> GetNodeProperty(
+      const std::string& name) const {
+    if (auto column = node_properties_->GetColumnByName(name)) {
+      return MakeResult(std::move(column));
+    }
+    return KATANA_ERROR(
+        ErrorCode::PropertyNotFound, "node property does not exist: {}", name);
+  }
+
+  Result<std::shared_ptr<arrow::ChunkedArray>> GetEdgeProperty(
+      const std::string& name) const {
+    if (auto column = edge_properties_->GetColumnByName(name)) {
+      return MakeResult(std::move(column));
+    }
+    return KATANA_ERROR(
+        ErrorCode::PropertyNotFound, "edge property does not exist: {}", name);
+  }
+
+  EntityTypeID GetTypeOfNode(Node node) const {
+    return node_entity_type_ids_[node];
+  }
+  EntityTypeID GetTypeOfEdge(Edge edge) const {
+    return edge_entity_type_ids_[edge];
+  }
+
+private:
+  friend class PropertyGraph;
+
+  PropertyGraphSnapshot() = default;
+
+  uint64_t version_{0};
+  GraphTopology topology_;
+  std::shared_ptr<arrow::Table> node_properties_;
+  std::shared_ptr<arrow::Table> edge_properties_;
+  NUMAArray<EntityTypeID> node_entity_type_ids_;
+  NUMAArray<EntityTypeID> edge_entity_type_ids_;
+  std::shared_ptr<const void> node_entity_type_ids_owner_;
+  std::shared_ptr<const void> edge_entity_type_ids_owner_;
+};
+
 /// A property graph is a graph that has properties associated with its nodes
 /// and edges. A property has a name and value. Its value may be a primitive
 /// type, a list of values or a composition of properties.
@@ -57,9 +129,6 @@ public:
   using EntityTypeIDArray = katana::NUMAArray<EntityTypeID>;
 
 private:
-  /// Validate performs a sanity check on the the graph after loading
-  Result<void> Validate();
-
   Result<void> DoWrite(
       tsuba::RDGHandle handle, const std::string& command_line,
       tsuba::RDG::RDGVersioningPolicy versioning_action);
@@ -74,6 +143,35 @@ private:
   Result<void> WriteView(
       const std::string& uri, const std::string& command_line);
 
+  /// Held by writers while they change the properties or the topology, so
+  /// that a snapshot has either all or none of a change. Writers call Commit
+  /// once they have changed the graph; an operation that fails before then
+  /// keeps the version of the graph.
+  class VersionChange {
+  public:
+    explicit VersionChange(PropertyGraph* pg)
+        : pg_(pg), lock_(*pg->version_mutex_) {}
+    ~VersionChange() {
+      if (committed_) {
+        ++pg_->version_;
+        pg_->snapshot_.reset();
+      }
+    }
+
+    void Commit() noexcept { committed_ = true; }
+
+  private:
+    PropertyGraph* pg_;
+    std::lock_guard<std::mutex> lock_;
+    bool committed_{false};
+  };
+
+  /// Move the topology and the type ID arrays into storage that Copy shares,
+  /// after they are built or replaced
+  void MoveToSharedStorage() noexcept;
+  void MoveNodeTypeIDsToSharedStorage() noexcept;
+  void MoveEdgeTypeIDsToSharedStorage() noexcept;
+
   tsuba::RDG rdg_;
   std::unique_ptr<tsuba::RDGFile> file_;
   GraphTopology topology_;
@@ -87,6 +185,9 @@ private:
   EntityTypeIDArray node_entity_type_ids_;
   /// The edge EntityTypeID for each edge's most specific type
   EntityTypeIDArray edge_entity_type_ids_;
+  // Keep the type ID arrays alive while copies of this graph read them
+  std::shared_ptr<const void> node_entity_type_ids_owner_;
+  std::shared_ptr<const void> edge_entity_type_ids_owner_;
 
   // List of node and edge indexes on this graph.
   std::vector<std::unique_ptr<PropertyIndex<GraphTopology::Node>>>
@@ -94,7 +195,21 @@ private:
   std::vector<std::unique_ptr<PropertyIndex<GraphTopology::Edge>>>
       edge_indexes_;
 
-  PGViewCache pg_view_cache_;
+  // Mutable so that cached statistics, e.g., GetGraphProfile, can be built
+  // through a const graph
+  mutable PGViewCache pg_view_cache_;
+
+  // Versions for Snapshot. The mutex is on the heap so that graphs stay
+  // movable.
+  std::unique_ptr<std::mutex> version_mutex_{std::make_unique<std::mutex>()};
+  uint64_t version_{0};
+  // Held weakly: a snapshot shares the property tables, and a table that is
+  // shared is copied rather than written in place on upsert, so the graph
+  // must not keep one alive after its readers are done with it
+  std::weak_ptr<const PropertyGraphSnapshot> snapshot_;
+  // A copy in shared storage of a topology read straight from a mapped file,
+  // which snapshots share instead
+  GraphTopology mapped_topology_copy_;
 
   friend class PropertyGraphRetractor;
 
@@ -210,12 +325,122 @@ public:
         edge_entity_type_ids_(std::move(edge_entity_type_ids)) {
     KATANA_LOG_DEBUG_ASSERT(node_entity_type_ids_.size() == num_nodes());
     KATANA_LOG_DEBUG_ASSERT(edge_entity_type_ids_.size() == num_edges());
+    MoveToSharedStorage();
   }
 
+  /// Pin the current version of the properties and the topology of this
+  /// graph. Readers, e.g., long running analytics, work on the snapshot while
+  /// writers keep calling AddNodeProperties, UpsertNodeProperties,
+  /// RemoveNodeProperty, ReplaceTopology, etc., each of which installs a new
+  /// version atomically. Snapshots taken between two changes, while one of
+  /// them is still held, are the same object, so taking one is cheap. May be
+  /// called from several threads at once, and concurrently with writers, but
+  /// waits for a change in progress, including a property being loaded on
+  /// access, to finish. Reading a snapshot never waits. An operation that
+  /// fails without changing the graph does not make a new version.
+  ///
+  /// Values written in place, e.g., through a TypedPropertyGraph, are not
+  /// versioned. A topology read straight from a mapped file (see
+  /// GraphTopology::Placement::kBorrowed) is copied once for the snapshots,
+  /// since the mapping goes away when the topology is replaced.
+  std::shared_ptr<const PropertyGraphSnapshot> Snapshot();
+
+  /// Build a view of this graph, or reuse the topologies of a previously
+  /// built one. May be called from several threads at once.
   template <typename PGView>
   PGView BuildView() noexcept {
     return pg_view_cache_.BuildView<PGView>(this);
   }
+
+  /// The nodes of each node entity type, built on first use and cached with
+  /// the views, e.g., to run a loop over the nodes of one type only. May be
+  /// called from several threads at once.
+  ///
+  /// \see EntityTypePartition
+  std::shared_ptr<const NodeTypePartition> GetNodeTypePartition() noexcept {
+    return pg_view_cache_.BuildOrGetNodeTypePartition(this);
+  }
+
+  /// The edges of each edge entity type, like GetNodeTypePartition.
+  std::shared_ptr<const EdgeTypePartition> GetEdgeTypePartition() noexcept {
+    return pg_view_cache_.BuildOrGetEdgeTypePartition(this);
+  }
+
+  /// Statistics of the topology for automatic plan choices, built on first
+  /// use and cached with the views until the topology changes. May be called
+  /// from several threads at once.
+  ///
+  /// \see GraphProfile
+  std::shared_ptr<const GraphProfile> GetGraphProfile() const noexcept {
+    return pg_view_cache_.BuildOrGetGraphProfile(this);
+  }
+
+  /// The edge shuffled topologies built so far for views of this graph, e.g.,
+  /// to hand their arrays to another library without copying. Each pointer
+  /// keeps its topology alive even if the cache drops it.
+  std::vector<std::shared_ptr<const EdgeShuffleTopology>>
+  GetCachedEdgeShuffleTopologies() const noexcept {
+    return pg_view_cache_.GetEdgeShuffTopos();
+  }
+
+  /// The topology with the given states that views are built from, e.g.,
+  /// the in-edges of PropertyGraphViews::BiDirectional, built in parallel on
+  /// first use and shared with BuildView. The pointer keeps the topology alive
+  /// even if the cache drops it.
+  std::shared_ptr<const EdgeShuffleTopology> BuildEdgeShuffleTopology(
+      EdgeShuffleTopology::TransposeKind tpose_kind,
+      EdgeShuffleTopology::EdgeSortKind sort_kind) noexcept {
+    return pg_view_cache_.BuildEdgeShuffTopo(this, tpose_kind, sort_kind);
+  }
+
+  /// The values of the edge property \p name in the edge order of a view,
+  /// e.g., view.edge_order(), so that value e belongs to edge e of the view.
+  /// Kernels on sorted or transposed views can then read weights alongside
+  /// the destinations instead of through edge_property_index. The values are
+  /// gathered in parallel on first use and cached with the views. May be
+  /// called from several threads at once.
+  ///
+  /// \code
+  /// auto view = pg->BuildView<PropertyGraphViews::BiDirectional>();
+  /// auto weights = std::static_pointer_cast<arrow::UInt32Array>(
+  ///     KATANA_CHECKED(
+  ///         pg->GetEdgePropertyInOrder(view.in_edge_order(), "weight")));
+  /// // weights->Value(e) is the weight of in-edge e of view
+  /// \endcode
+  Result<std::shared_ptr<arrow::Array>> GetEdgePropertyInOrder(
+      const EdgeOrder& order, const std::string& name) const noexcept {
+    return pg_view_cache_.BuildOrGetEdgePropertyInOrder(this, order, name);
+  }
+
+  /// The edges of every node sorted by the timestamps in the edge property
+  /// \p timestamp_property, to find the edges in a time window by binary
+  /// search, built on first use and cached with the views. With
+  /// \p tpose_kind kYes, the in-edges. May be called from several threads
+  /// at once.
+  ///
+  /// \see TemporalEdgeIndex
+  Result<std::shared_ptr<const TemporalEdgeIndex>> GetTemporalEdgeIndex(
+      const std::string& timestamp_property,
+      EdgeShuffleTopology::TransposeKind tpose_kind =
+          EdgeShuffleTopology::TransposeKind::kNo) const noexcept {
+    return pg_view_cache_.BuildOrGetTemporalEdgeIndex(
+        this, timestamp_property, tpose_kind);
+  }
+
+  /// Limit the memory held by the topologies cached for BuildView. Topologies
+  /// in use by a view are never freed while that view exists.
+  void SetViewCacheByteBudget(size_t bytes) noexcept {
+    pg_view_cache_.set_byte_budget(bytes);
+  }
+
+  /// Load a topology derived from this graph's topology with the given
+  /// states if one was stored with the graph (see
+  /// KATANA_PERSIST_DERIVED_TOPOLOGIES).
+  ///
+  /// \returns nullptr if no such topology was stored
+  Result<std::unique_ptr<EdgeShuffleTopology>> LoadDerivedTopology(
+      const EdgeShuffleTopology::TransposeKind& tpose_kind,
+      const EdgeShuffleTopology::EdgeSortKind& sort_kind) const;
   /// Make a property graph from a constructed RDG. Take ownership of the RDG
   /// and its underlying resources.
   static Result<std::unique_ptr<PropertyGraph>> Make(
@@ -226,6 +451,14 @@ public:
       const std::string& rdg_name,
       const tsuba::RDGLoadOptions& opts = tsuba::RDGLoadOptions());
 
+  /// Load only the topology of an RDG and keep its destinations encoded,
+  /// for read-only analytics that walk out-edges with
+  /// CompressedGraphTopology::dests(), e.g., CompressedBfsDistances. A graph
+  /// stored in the compressed format (see KATANA_COMPRESS_TOPOLOGY) is never
+  /// decompressed; one stored uncompressed is compressed after loading.
+  static Result<CompressedGraphTopology> LoadCompressedTopology(
+      const std::string& rdg_name);
+
   /// Make a property graph from topology
   static Result<std::unique_ptr<PropertyGraph>> Make(
       GraphTopology&& topo_to_assign);
@@ -237,14 +470,21 @@ public:
       EntityTypeManager&& node_type_manager,
       EntityTypeManager&& edge_type_manager);
 
-  /// \return A copy of this with the same set of properties. The copy shares no
-  ///       state with this.
+  /// \return A copy of this with the same set of properties, see
+  ///     Copy(node_properties, edge_properties).
   Result<std::unique_ptr<PropertyGraph>> Copy() const;
 
+  /// The copy shares the topology, the type ID arrays and the property
+  /// buffers of this rather than copying them, so taking a scratch copy to
+  /// add properties to is cheap. Neither graph sees changes made to the
+  /// other: a change replaces what is shared instead of writing to it. A
+  /// topology read straight from a mapped file (see
+  /// GraphTopology::Placement::kBorrowed) is copied. The copy is not bound
+  /// to storage, nor does it have the property indexes of this.
+  ///
   /// \param node_properties The node properties to copy.
   /// \param edge_properties The edge properties to copy.
-  /// \return A copy of this with a subset of the properties. The copy shares no
-  ///        state with this.
+  /// \return A copy of this with a subset of the properties.
   Result<std::unique_ptr<PropertyGraph>> Copy(
       const std::vector<std::string>& node_properties,
       const std::vector<std::string>& edge_properties) const;
@@ -278,6 +518,11 @@ public:
     return edge_entity_type_ids_.data();
   }
 
+  /// Give this graph its own copy of its topology if it shares it with
+  /// copies of the graph (see Copy), before the topology is modified in place
+  /// through a const_cast of topology().adj_data() or dest_data().
+  void UnshareTopology() noexcept;
+
   const EntityTypeManager& GetNodeTypeManager() const {
     return node_entity_type_manager_;
   }
@@ -314,11 +559,20 @@ public:
   /// but their properties information would differ as the old software added the type information to properties while the new
   /// software did not. The two graphs would be functionally Equal, but this function would say this are not equal
   /// TODO(unknown):(emcginnis) consider breaking the function down into: topology comparison, type comparison, and property comparison. Move pitfall described above alone with the property comparison function
+  /// Properties that are unchanged since they were stored compare by the
+  /// content digests in their metadata; the rest, the topology and the
+  /// entity type arrays are compared in parallel.
   bool Equals(const PropertyGraph* other) const;
   /// Report the differences between two graphs
   /// THIS IS A TESTING ONLY FUNCTION, DO NOT EXPOSE THIS TO THE USER
   std::string ReportDiff(const PropertyGraph* other) const;
 
+  /// Validate performs a sanity check on the graph after loading: the
+  /// topology is checked in parallel for nondecreasing adjacency indices and
+  /// in-range destinations, and the property tables and entity type arrays
+  /// for sizes that match it
+  Result<void> Validate();
+
   /// get the schema for loaded node properties
   std::shared_ptr<arrow::Schema> loaded_node_schema() const {
     return rdg_.node_properties()->schema();
@@ -534,7 +788,11 @@ public:
     return loaded_edge_schema()->GetFieldIndex(name) != -1;
   }
 
-  /// Get a node property by name.
+  /// Get a node property by name. If the graph was loaded with
+  /// tsuba::RDGLoadOptions::load_properties_on_access and the property is
+  /// absent, it is loaded first; with
+  /// tsuba::RDGLoadOptions::load_properties_in_background, this waits for
+  /// the background load of just this property.
   ///
   /// \param name The name of the property to get.
   /// \return The property data or NULL if the property is not found.
@@ -620,11 +878,32 @@ public:
   Result<void> AddNodeProperties(const std::shared_ptr<arrow::Table>& props);
   /// Add Edge properties that do not exist in the current graph
   Result<void> AddEdgeProperties(const std::shared_ptr<arrow::Table>& props);
-  /// If property name exists, replace it, otherwise insert it
+  /// If property name exists, replace it, otherwise insert it.
+  ///
+  /// A loaded fixed-width property that is not shared with other readers,
+  /// e.g., through the PropertyCache or a column returned by
+  /// GetNodeProperty, is overwritten in place when the new values have the
+  /// same type and no nulls; otherwise the column is replaced and existing
+  /// readers keep the old values.
   Result<void> UpsertNodeProperties(const std::shared_ptr<arrow::Table>& props);
-  /// If property name exists, replace it, otherwise insert it
+  /// If property name exists, replace it, otherwise insert it. See
+  /// UpsertNodeProperties.
   Result<void> UpsertEdgeProperties(const std::shared_ptr<arrow::Table>& props);
 
+  /// Replace the topology, e.g., after inserting or deleting nodes and edges.
+  /// The next Commit writes the new topology; property files are only
+  /// rewritten for the side whose rows change.
+  ///
+  /// \param node_entity_type_ids, node_props the types and properties of the
+  ///     nodes of topo; if node_props is null, the nodes of topo are the
+  ///     nodes of this graph, in order, and keep their types and properties
+  /// \param edge_entity_type_ids, edge_props like node_props for the edges
+  Result<void> ReplaceTopology(
+      GraphTopology&& topo, EntityTypeIDArray&& node_entity_type_ids,
+      EntityTypeIDArray&& edge_entity_type_ids,
+      const std::shared_ptr<arrow::Table>& node_props,
+      const std::shared_ptr<arrow::Table>& edge_props);
+
   Result<void> RemoveNodeProperty(int i);
   Result<void> RemoveNodeProperty(const std::string& prop_name);
 
@@ -657,13 +936,34 @@ public:
   /// the table do nothing otherwise
   Result<void> EnsureEdgePropertyLoaded(const std::string& name);
 
+  /// Start loading the named node properties in the background, e.g., while
+  /// an analytics routine builds its topology views, so that they are ready
+  /// when first accessed. Names that are loaded or unknown are ignored.
+  ///
+  /// With tsuba::RDGLoadOptions::load_properties_on_access, GetNodeProperty
+  /// loads any absent property, prefetched or not. Such a load mutates the
+  /// property table, so it must not race with other property accesses.
+  Result<void> PrefetchNodeProperties(const std::vector<std::string>& names);
+
+  /// Start loading the named edge properties in the background; see
+  /// PrefetchNodeProperties
+  Result<void> PrefetchEdgeProperties(const std::vector<std::string>& names);
+
   std::vector<std::string> ListNodeProperties() const;
   std::vector<std::string> ListEdgeProperties() const;
 
   /// Remove all node properties
-  void DropNodeProperties() { rdg_.DropNodeProperties(); }
+  void DropNodeProperties() {
+    VersionChange change(this);
+    rdg_.DropNodeProperties();
+    change.Commit();
+  }
   /// Remove all edge properties
-  void DropEdgeProperties() { rdg_.DropEdgeProperties(); }
+  void DropEdgeProperties() {
+    VersionChange change(this);
+    rdg_.DropEdgeProperties();
+    change.Commit();
+  }
 
   MutablePropertyView NodeMutablePropertyView() {
     return MutablePropertyView{
@@ -755,11 +1055,33 @@ public:
     return node_iterator(node_id);
   }
 
-  // Creates an index over a node property.
-  Result<void> MakeNodeIndex(const std::string& column_name);
+  // Creates an index of the given kind over a node property. An index of
+  // the same kind over the property that was stored with the graph is mapped
+  // rather than rebuilt. Indexes are stored by Write, and rebuilt when their
+  // property is upserted.
+  Result<void> MakeNodeIndex(
+      const std::string& column_name,
+      PropertyIndexKind kind = PropertyIndexKind::kOrdered);
+
+  // Creates an index of the given kind over an edge property, like
+  // MakeNodeIndex.
+  Result<void> MakeEdgeIndex(
+      const std::string& column_name,
+      PropertyIndexKind kind = PropertyIndexKind::kOrdered);
+
+  /// Evaluate predicate over the nodes, in parallel, returning a bitset of
+  /// num_nodes() bits with the bit of each node that satisfies it set.
+  ///
+  /// \see PropertyPredicate
+  Result<DynamicBitset> FilterNodes(const PropertyPredicate& predicate) const {
+    return predicate.SelectNodes(*this);
+  }
 
-  // Creates an index over an edge property.
-  Result<void> MakeEdgeIndex(const std::string& column_name);
+  /// Evaluate predicate over the edges, like FilterNodes, returning a bitset
+  /// of num_edges() bits.
+  Result<DynamicBitset> FilterEdges(const PropertyPredicate& predicate) const {
+    return predicate.SelectEdges(*this);
+  }
 
   // Returns the list of node indexes.
   const std::vector<std::unique_ptr<PropertyIndex<GraphTopology::Node>>>&
@@ -808,7 +1130,8 @@ KATANA_EXPORT GraphTopology::Edge FindEdgeSortedByDest(
     GraphTopology::Node node_to_find);
 
 /// Renumber all nodes in the graph by sorting in the descending
-/// order by node degree.
+/// order by node degree. Properties are not renumbered; see
+/// RelabelNodesByDegree.
 // TODO(amber): this method should return a new sorted topology
 KATANA_EXPORT Result<void> SortNodesByDegree(PropertyGraph* pg);
 
@@ -842,6 +1165,49 @@ CreateSymmetricGraph(PropertyGraph* pg);
 KATANA_EXPORT Result<std::unique_ptr<PropertyGraph>>
 CreateTransposeGraphTopology(const GraphTopology& topology);
 
+/// Renumber the nodes of a property graph.
+///
+/// Node i of the new graph is node old_ids[i] of pg, with its entity type and
+/// loaded properties, and its edges are those of that node, in the same order,
+/// with their types and loaded properties. Properties are gathered in
+/// parallel, with one task for each column and slice of rows.
+/// \param pg The original property graph
+/// \param old_ids A permutation of the nodes of pg
+/// \return The renumbered property graph
+KATANA_EXPORT Result<std::unique_ptr<PropertyGraph>> PermuteNodes(
+    const PropertyGraph& pg, const NUMAArray<GraphTopology::Node>& old_ids);
+
+/// Renumber the nodes of a property graph in descending order of degree and
+/// sort the edges of each node by destination, e.g., for locality before
+/// triangle counting.
+///
+/// Unlike SortNodesByDegree and SortAllEdgesByDest, pg is not modified: the
+/// relabeled graph is a new graph, like one made by PermuteNodes, with every
+/// loaded node and edge property and entity type moved along, so it may be
+/// written as an RDG.
+/// \param pg The original property graph
+/// \param old_id_property If not empty, the name of a new uint32 node
+///     property holding the id each node had in pg
+/// \return The relabeled property graph
+KATANA_EXPORT Result<std::unique_ptr<PropertyGraph>> RelabelNodesByDegree(
+    const PropertyGraph& pg, const std::string& old_id_property = "");
+
+/// The out degree of each of nodes, an array of node ids of any integer type.
+/// This and the queries below take one parallel pass over the nodes, so
+/// that a batch of lookups costs one call.
+KATANA_EXPORT Result<std::shared_ptr<arrow::UInt64Array>> GetDegrees(
+    const GraphTopology& topo, const arrow::Array& nodes);
+
+/// The destinations of the out edges of each of nodes, in edge order. The
+/// offsets and values of the list array are in CSR form.
+KATANA_EXPORT Result<std::shared_ptr<arrow::LargeListArray>> GetNeighbors(
+    const GraphTopology& topo, const arrow::Array& nodes);
+
+/// The values of node property name at each of nodes
+KATANA_EXPORT Result<std::shared_ptr<arrow::ChunkedArray>> GatherNodeProperty(
+    const PropertyGraph& pg, const std::string& name,
+    const arrow::Array& nodes);
+
 }  // namespace katana
 
 #endif
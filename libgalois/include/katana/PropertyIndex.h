@@ -1,50 +1,128 @@
 #ifndef KATANA_LIBGALOIS_KATANA_PROPERTYINDEX_H_
 #define KATANA_LIBGALOIS_KATANA_PROPERTYINDEX_H_
 
-#include <set>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
 #include <string>
-#include <variant>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include <arrow/api.h>
 #include <arrow/array.h>
 #include <arrow/type_traits.h>
-#include <boost/iterator/iterator_categories.hpp>
-#include <boost/iterator/iterator_facade.hpp>
 
+#include "katana/NUMAArray.h"
 #include "katana/Result.h"
 #include "katana/config.h"
+#include "tsuba/FileFrame.h"
+#include "tsuba/FileView.h"
 
 namespace katana {
 
+// The kinds of PropertyIndex.
+enum class PropertyIndexKind {
+  // Supports Find, LowerBound and UpperBound in O(log n), and iterates in
+  // order of values: PrimitivePropertyIndex, StringPropertyIndex and
+  // DictionaryPropertyIndex.
+  kOrdered,
+  // Supports Find and EqualRange in O(1): HashPropertyIndex.
+  kHash,
+};
+
+// Version of stored property index files (see PropertyIndex::Write). A file
+// starts with a PropertyIndexFileHeader and num_arrays uint64_t sizes in
+// bytes, followed by the arrays of the index, each starting at a multiple of
+// kPropertyIndexFileAlignment bytes.
+constexpr uint64_t kPropertyIndexFileVersion = 1;
+constexpr uint64_t kPropertyIndexFileAlignment = 64;
+
+struct PropertyIndexFileHeader {
+  uint64_t version{kPropertyIndexFileVersion};
+  // PropertyIndexKind
+  uint64_t kind{0};
+  uint64_t num_entities{0};
+  uint64_t size{0};
+  uint64_t num_arrays{0};
+};
+
+namespace internal {
+
+// An array of a PropertyIndex, either allocated when the index is built or
+// pointing into a stored index file.
+class KATANA_EXPORT IndexArrayBase {
+public:
+  const uint8_t* bytes() const { return data_; }
+  size_t num_bytes() const { return num_bytes_; }
+
+  // Use the num_bytes bytes at data, which must outlive the array, instead
+  // of memory owned by the array.
+  void Map(const uint8_t* data, size_t num_bytes) {
+    owned_.deallocate();
+    data_ = data;
+    num_bytes_ = num_bytes;
+  }
+
+protected:
+  void AllocateBytes(size_t num_bytes) {
+    owned_.deallocate();
+    owned_.allocateInterleaved(num_bytes);
+    data_ = owned_.data();
+    num_bytes_ = num_bytes;
+  }
+
+  uint8_t* mutable_bytes() { return owned_.data(); }
+
+private:
+  katana::NUMAArray<uint8_t> owned_;
+  const uint8_t* data_{nullptr};
+  size_t num_bytes_{0};
+};
+
+template <typename T>
+class IndexArray : public IndexArrayBase {
+public:
+  // Allocate size elements, which are written through the non-const
+  // accessors. Only allocated arrays may be written.
+  void Allocate(size_t size) { AllocateBytes(size * sizeof(T)); }
+
+  T* data() { return reinterpret_cast<T*>(mutable_bytes()); }
+  const T* data() const { return reinterpret_cast<const T*>(bytes()); }
+  size_t size() const { return num_bytes() / sizeof(T); }
+  bool empty() const { return num_bytes() == 0; }
+
+  T& operator[](size_t i) { return data()[i]; }
+  const T& operator[](size_t i) const { return data()[i]; }
+
+  T* begin() { return data(); }
+  T* end() { return data() + size(); }
+};
+
+}  // namespace internal
+
 // PropertyIndex provides an interface similar to an ordered container
 // over a single property.
+//
+// An index is a permutation of the node or edge ids that have a value,
+// sorted with a parallel sort, so building it costs a sort of the property
+// rather than one tree insertion per entity, and an entry costs one id.
+//
+// An index can be stored with Write and used again over the same property
+// with BuildFromFile, which maps the stored arrays instead of building them.
 template <typename node_or_edge>
 class KATANA_EXPORT PropertyIndex {
 public:
-  // Type-safe container for node and edge ids to avoid overlap with the
-  // primitive types we are indexing.
-  struct IndexID {
-    node_or_edge id;
-  };
-
-  // The set key type is either a node/edge id (all the keys in the actual set)
-  // or a value representing the search key.
-  using set_key_type = typename std::variant<
-      IndexID, bool, uint8_t, int64_t, double_t, std::string_view*>;
-
-  // PropertyIndex::iterator returns a sequence of node or edge ids.
-  using base_iterator = typename std::multiset<set_key_type>::iterator;
-  class iterator : public base_iterator {
-  public:
-    explicit iterator(const base_iterator& base) : base_iterator(base) {}
-    iterator() : base_iterator(0) {}
-    const node_or_edge& operator*() const {
-      return std::get<IndexID>(base_iterator::operator*()).id;
-    }
-  };
+  // PropertyIndex::iterator returns a sequence of node or edge ids. For
+  // ordered indexes, they are in increasing order of their property values,
+  // and of their ids for equal values. For hash indexes, ids with equal
+  // values are next to each other.
+  using iterator = const node_or_edge*;
 
-  PropertyIndex(std::string column_name)
-      : column_name_(std::move(column_name)) {}
+  PropertyIndex(std::string column_name, size_t num_entities)
+      : column_name_(std::move(column_name)), num_entities_(num_entities) {}
 
   PropertyIndex(const PropertyIndex&) = delete;
   PropertyIndex& operator=(const PropertyIndex&) = delete;
@@ -56,90 +134,150 @@ public:
   // The name of the indexed property.
   std::string column_name() { return column_name_; }
 
-  virtual iterator begin() = 0;
-  virtual iterator end() = 0;
+  iterator begin() const { return sorted_ids_.data(); }
+  iterator end() const { return sorted_ids_.data() + size_; }
+
+  // The number of indexed entities, which excludes those with null values.
+  size_t size() const { return size_; }
+
+  // The number of nodes or edges of the indexed property.
+  size_t num_entities() const { return num_entities_; }
+
+  virtual PropertyIndexKind kind() const = 0;
 
   virtual Result<void> BuildFromProperty() = 0;
-  // virtual Result<void> BuildFromFile() = 0;
+
+  // Use an index stored by Write over the same property. The arrays of the
+  // index point into file, which must be bound with resolve set and is kept
+  // until the index is destroyed, so nothing is sorted or copied.
+  Result<void> BuildFromFile(std::shared_ptr<tsuba::FileView> file);
+
+  // Serialize the index for BuildFromFile.
+  Result<std::unique_ptr<tsuba::FileFrame>> Write();
+
+  // True if the index uses a stored index file.
+  bool is_mapped() const { return file_ != nullptr; }
+
+protected:
+  // The arrays that make up the index, in the order they are stored.
+  virtual std::vector<internal::IndexArrayBase*> arrays() {
+    return {&sorted_ids_};
+  }
+
+  // Check the arrays mapped by BuildFromFile against the property, and set
+  // what is derived from them.
+  virtual Result<void> FinishBuildFromFile() = 0;
+
+  // Fill sorted_ids_ with the ids in [0, num_entities) for which is_valid is
+  // true, sorted with less. less only compares valid ids.
+  template <typename IsValid, typename Less>
+  void SortIds(size_t num_entities, IsValid is_valid, Less less);
+
+  internal::IndexArray<node_or_edge> sorted_ids_;
+  size_t size_{0};
 
 private:
   std::string column_name_;
+  size_t num_entities_;
+  std::shared_ptr<tsuba::FileView> file_;
 };
 
 // PrimitivePropertyIndex provides a PropertyIndex for primitive types.
+//
+// Besides the sorted ids, the index keeps the values in the same order, so a
+// search reads contiguous keys instead of following each id into the
+// property. Searches first go through the first key of every block of
+// kBlockSize keys, laid out in Eytzinger (breadth first) order so that the
+// top of the implicit search tree shares cache lines and later levels can be
+// prefetched, and then binary search one block.
 template <typename node_or_edge, typename c_type>
 class KATANA_EXPORT PrimitivePropertyIndex
     : public PropertyIndex<node_or_edge> {
 public:
   using ArrowArrayType = typename arrow::CTypeTraits<c_type>::ArrayType;
-  using IndexID = typename PropertyIndex<node_or_edge>::IndexID;
   using iterator = typename PropertyIndex<node_or_edge>::iterator;
-  using set_key_type = typename PropertyIndex<node_or_edge>::set_key_type;
+
+  // The number of consecutive sorted keys under one search tree leaf: two
+  // cache lines of 8-byte keys.
+  static constexpr size_t kBlockSize = 16;
 
   PrimitivePropertyIndex(
       const std::string& column, size_t num_entities,
       std::shared_ptr<arrow::Array> property)
-      : PropertyIndex<node_or_edge>(column),
-        num_entities_(num_entities),
-        property_(std::static_pointer_cast<ArrowArrayType>(property)),
-        set_(PropertyCompare(property_)) {}
-
-  iterator begin() override { return iterator(set_.begin()); }
-  iterator end() override { return iterator(set_.end()); }
-
-  // Returns an iterator to the first element in the set with its property
-  // value equal to `key`. The STL does not seem to specify that
-  // multiset::find returns the first value, though it appears so in practice.
-  iterator Find(c_type key) {
-    auto it = set_.lower_bound(key);
-    if (it == set_.end() ||
-        property_->Value(std::get<IndexID>(*it).id) != key) {
-      return end();
+      : PropertyIndex<node_or_edge>(column, num_entities),
+        property_(std::static_pointer_cast<ArrowArrayType>(property)) {}
+
+  PropertyIndexKind kind() const override {
+    return PropertyIndexKind::kOrdered;
+  }
+
+  // Returns an iterator to the first element in the index with its property
+  // value equal to `key`.
+  iterator Find(c_type key) const {
+    size_t pos = Search(key, std::less<c_type>{});
+    if (pos == this->size_ || keys_[pos] != key) {
+      return this->end();
     }
-    return iterator(it);
+    return this->begin() + pos;
   }
 
-  // Returns an iterator to the first element in the set that is greater than or
-  // equal to `key`.
-  iterator LowerBound(c_type key) { return iterator(set_.lower_bound(key)); }
+  // Returns an iterator to the first element in the index that is greater
+  // than or equal to `key`.
+  iterator LowerBound(c_type key) const {
+    return this->begin() + Search(key, std::less<c_type>{});
+  }
 
-  // Returns an iterator to the first element in the set that is greater than
-  // `key`.
-  iterator UpperBound(c_type key) { return iterator(set_.upper_bound(key)); }
+  // Returns an iterator to the first element in the index that is greater
+  // than `key`.
+  iterator UpperBound(c_type key) const {
+    return this->begin() + Search(key, std::less_equal<c_type>{});
+  }
 
 private:
-  class PropertyCompare {
-  public:
-    PropertyCompare(std::shared_ptr<ArrowArrayType> property)
-        : property_(std::move(property)) {}
-
-    bool operator()(const set_key_type& a, const set_key_type& b) const {
-      // Each operand is either a literal key_type or a node/edge.
-      c_type val_a = GetValue(a);
-      c_type val_b = GetValue(b);
-      // Compare the value of the indexed property for a and b using std::less.
-      return std::less<c_type>{}(val_a, val_b);
+  // The position of the first key k for which before(k, key) is false. The
+  // keys must be partitioned by before.
+  template <typename Before>
+  size_t Search(c_type key, Before before) const {
+    if (this->size_ == 0) {
+      return 0;
     }
-
-  private:
-    c_type GetValue(const set_key_type& a) const {
-      if (std::holds_alternative<IndexID>(a)) {
-        node_or_edge id = std::get<IndexID>(a).id;
-        c_type val = property_->Value(id);
-        return val;
-      }
-      return std::get<c_type>(a);
+    const size_t num_blocks = block_keys_.size() - 1;
+
+    // Descend the Eytzinger tree to the first block whose first key is not
+    // before key. The index of the answer has the path taken as its bits:
+    // drop the trailing right turns and the left turn above them.
+    size_t k = 1;
+    while (k <= num_blocks) {
+      __builtin_prefetch(block_keys_.data() + std::min(16 * k, num_blocks));
+      k = 2 * k + before(block_keys_[k], key);
     }
-
-    std::shared_ptr<ArrowArrayType> property_;
-  };
+    k >>= __builtin_ffsll(~k);
+    size_t block = k == 0 ? num_blocks : block_ranks_[k];
+
+    // The answer is in the previous block, or is the first key of block
+    size_t first = block == 0 ? 0 : (block - 1) * kBlockSize;
+    size_t last = std::min(block * kBlockSize, this->size_);
+    return std::partition_point(
+               keys_.data() + first, keys_.data() + last,
+               [&](const c_type& value) { return before(value, key); }) -
+           keys_.data();
+  }
 
   Result<void> BuildFromProperty() override;
-  // Result<void> BuildFromFile(...) override;
 
-  size_t num_entities_;
+  std::vector<internal::IndexArrayBase*> arrays() override {
+    return {&this->sorted_ids_, &keys_, &block_keys_, &block_ranks_};
+  }
+
+  Result<void> FinishBuildFromFile() override;
+
   std::shared_ptr<ArrowArrayType> property_;
-  std::multiset<set_key_type, PropertyCompare> set_;
+  // keys_[i] is the value of sorted_ids_[i]
+  internal::IndexArray<c_type> keys_;
+  // 1-indexed Eytzinger order of the first key of each block, and the block
+  // of each of these keys
+  internal::IndexArray<c_type> block_keys_;
+  internal::IndexArray<uint64_t> block_ranks_;
 };
 
 // StringPropertyIndex provides a PropertyIndex for strings.
@@ -148,89 +286,296 @@ class KATANA_EXPORT StringPropertyIndex : public PropertyIndex<node_or_edge> {
 public:
   using ArrowArrayType =
       typename arrow::TypeTraits<arrow::LargeStringType>::ArrayType;
-  using IndexID = typename PropertyIndex<node_or_edge>::IndexID;
   using iterator = typename PropertyIndex<node_or_edge>::iterator;
-  using set_key_type = typename PropertyIndex<node_or_edge>::set_key_type;
 
   StringPropertyIndex(
       const std::string& column_name, size_t num_entities,
       const std::shared_ptr<arrow::Array>& property)
-      : PropertyIndex<node_or_edge>(column_name),
-        num_entities_(num_entities),
-        property_(std::static_pointer_cast<arrow::LargeStringArray>(property)),
-        set_(StringCompare(property_)) {}
-
-  iterator begin() override { return iterator(set_.begin()); }
-  iterator end() override { return iterator(set_.end()); }
-
-  // Returns an iterator to the first element in the set with its property
-  // value equal to `key`. The STL does not appear to specify that
-  // multiset::find returns the first value, though it appears so in practice.
-  iterator Find(std::string_view key) {
-    auto it = set_.lower_bound(&key);
-    if (it != set_.end()) {
-      arrow::util::string_view arrow_view =
-          property_->GetView(std::get<IndexID>(*it).id);
-      if (std::string_view(arrow_view.data(), arrow_view.length()) != key) {
-        return end();
-      }
+      : PropertyIndex<node_or_edge>(column_name, num_entities),
+        property_(std::static_pointer_cast<arrow::LargeStringArray>(property)) {
+  }
+
+  PropertyIndexKind kind() const override {
+    return PropertyIndexKind::kOrdered;
+  }
+
+  // Returns an iterator to the first element in the index with its property
+  // value equal to `key`.
+  iterator Find(std::string_view key) const {
+    iterator it = LowerBound(key);
+    if (it == this->end() || GetValue(*it) != key) {
+      return this->end();
     }
-    return iterator(it);
+    return it;
   }
 
-  // Returns an iterator to the first element in the set that is greater than or
-  // equal to `key`.
-  iterator LowerBound(std::string_view key) {
-    return iterator(set_.lower_bound(&key));
+  // Returns an iterator to the first element in the index that is greater
+  // than or equal to `key`.
+  iterator LowerBound(std::string_view key) const {
+    return std::partition_point(
+        this->begin(), this->end(),
+        [&](node_or_edge id) { return GetValue(id) < key; });
   }
 
-  // Returns an iterator to the first element in the set that is greater than
-  // `key`.
-  iterator UpperBound(std::string_view key) {
-    return iterator(set_.upper_bound(&key));
+  // Returns an iterator to the first element in the index that is greater
+  // than `key`.
+  iterator UpperBound(std::string_view key) const {
+    return std::partition_point(
+        this->begin(), this->end(),
+        [&](node_or_edge id) { return GetValue(id) <= key; });
   }
 
 private:
-  class StringCompare {
-  public:
-    StringCompare(std::shared_ptr<arrow::LargeStringArray> property)
-        : property_(std::move(property)) {}
-
-    bool operator()(const set_key_type& a, const set_key_type& b) const {
-      // Each operand is either a pointer to a string_view or a node/edge.
-      std::string_view val_a = GetValue(a);
-      std::string_view val_b = GetValue(b);
-      // Compare the value of the indexed property for a and b using std::less.
-      return std::less<std::string_view>{}(val_a, val_b);
-    }
+  std::string_view GetValue(node_or_edge id) const {
+    arrow::util::string_view arrow_view = property_->GetView(id);
+    return std::string_view(arrow_view.data(), arrow_view.length());
+  }
+
+  Result<void> BuildFromProperty() override;
+  Result<void> FinishBuildFromFile() override;
+
+  std::shared_ptr<arrow::LargeStringArray> property_;
+};
 
-  private:
-    std::string_view GetValue(const set_key_type& a) const {
-      if (std::holds_alternative<IndexID>(a)) {
-        arrow::util::string_view arrow_view =
-            property_->GetView(std::get<IndexID>(a).id);
-        return std::string_view(arrow_view.data(), arrow_view.length());
+namespace internal {
+
+template <typename c_type>
+struct HashIndexArrayType {
+  using type = typename arrow::CTypeTraits<c_type>::ArrayType;
+};
+
+template <>
+struct HashIndexArrayType<std::string_view> {
+  using type = arrow::LargeStringArray;
+};
+
+}  // namespace internal
+
+// HashPropertyIndex provides a PropertyIndex for point lookups on primitive
+// types or, with c_type std::string_view, on strings.
+//
+// The ids are grouped by value, and the groups are found through an open
+// addressing table of cache line sized buckets, each holding 8 slots probed
+// linearly. A slot packs 32 bits of the hash of a value with the number of
+// its group, so a lookup usually reads one bucket and then compares one
+// value in the property. Values are not copied into the index. The table is
+// half full at most.
+template <typename node_or_edge, typename c_type>
+class KATANA_EXPORT HashPropertyIndex : public PropertyIndex<node_or_edge> {
+public:
+  using ArrowArrayType = typename internal::HashIndexArrayType<c_type>::type;
+  using iterator = typename PropertyIndex<node_or_edge>::iterator;
+
+  static constexpr size_t kSlotsPerBucket = 8;
+
+  HashPropertyIndex(
+      const std::string& column_name, size_t num_entities,
+      const std::shared_ptr<arrow::Array>& property)
+      : PropertyIndex<node_or_edge>(column_name, num_entities),
+        property_(std::static_pointer_cast<ArrowArrayType>(property)) {}
+
+  PropertyIndexKind kind() const override { return PropertyIndexKind::kHash; }
+
+  // Returns an iterator to an element in the index with its property value
+  // equal to `key`, or end(). EqualRange returns all of them.
+  iterator Find(c_type key) const { return EqualRange(key).first; }
+
+  // Returns the range of elements in the index with their property value
+  // equal to `key`, which is empty and at end() if there is none.
+  std::pair<iterator, iterator> EqualRange(c_type key) const {
+    if (buckets_.empty()) {
+      return {this->end(), this->end()};
+    }
+    const uint64_t hash = Hash(key);
+    const uint64_t tag = hash & kGroupMask;
+    const size_t mask = buckets_.size() - 1;
+    for (size_t b = hash >> shift_;; b = (b + 1) & mask) {
+      for (const std::atomic<uint64_t>& slot : buckets_[b].slots) {
+        uint64_t entry = slot.load(std::memory_order_relaxed);
+        if (entry == 0) {
+          return {this->end(), this->end()};
+        }
+        if ((entry >> 32) != tag) {
+          continue;
+        }
+        uint64_t group = (entry & kGroupMask) - 1;
+        iterator first = this->begin() + group_offsets_[group];
+        if (GetValue(*first) == key) {
+          return {first, this->begin() + group_offsets_[group + 1]};
+        }
       }
-      return *std::get<std::string_view*>(a);
     }
+  }
 
-    std::shared_ptr<arrow::LargeStringArray> property_;
+  // The number of distinct values in the index.
+  size_t num_distinct_values() const {
+    return group_offsets_.empty() ? 0 : group_offsets_.size() - 1;
+  }
+
+private:
+  struct alignas(64) Bucket {
+    // 0 for an empty slot, otherwise the low 32 bits of the hash of a value
+    // above one plus the number of its group
+    std::atomic<uint64_t> slots[kSlotsPerBucket];
   };
 
+  static constexpr uint64_t kGroupMask = 0xffffffff;
+
+  static uint64_t Hash(c_type value) {
+    // std::hash is the identity for integers in some implementations, and
+    // the buckets are picked by the high bits, so finish with a mixer
+    // (MurmurHash3 fmix64).
+    uint64_t hash = std::hash<c_type>{}(value);
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+  }
+
+  c_type GetValue(node_or_edge id) const {
+    if constexpr (std::is_same_v<c_type, std::string_view>) {
+      arrow::util::string_view arrow_view = property_->GetView(id);
+      return std::string_view(arrow_view.data(), arrow_view.length());
+    } else {
+      return property_->Value(id);
+    }
+  }
+
   Result<void> BuildFromProperty() override;
-  // virtual Result<void> BuildFromFile(...) override;
 
-  size_t num_entities_;
-  std::shared_ptr<arrow::LargeStringArray> property_;
-  std::multiset<set_key_type, StringCompare> set_;
-};  // namespace katana
+  std::vector<internal::IndexArrayBase*> arrays() override {
+    return {&this->sorted_ids_, &group_offsets_, &buckets_};
+  }
+
+  Result<void> FinishBuildFromFile() override;
+
+  std::shared_ptr<ArrowArrayType> property_;
+  // The ids of group g are sorted_ids_[group_offsets_[g]] to
+  // sorted_ids_[group_offsets_[g + 1] - 1]
+  internal::IndexArray<uint64_t> group_offsets_;
+  internal::IndexArray<Bucket> buckets_;
+  // A value with hash h starts probing at bucket h >> shift_
+  unsigned shift_{64};
+};
+
+// DictionaryPropertyIndex provides an ordered PropertyIndex for dictionary
+// encoded strings, such as categorical properties read from parquet, with
+// codes of type code_type.
+//
+// The ids are sorted by the dictionary values of their codes, and the ids
+// of the values in order are found through offsets, one for each distinct
+// value. A search only looks at the dictionary, which is much smaller than
+// the property, and strings are compared only there: building the index
+// compares codes, and finding the ids of a code reads two offsets.
+template <typename node_or_edge, typename code_type>
+class KATANA_EXPORT DictionaryPropertyIndex
+    : public PropertyIndex<node_or_edge> {
+public:
+  using iterator = typename PropertyIndex<node_or_edge>::iterator;
+
+  DictionaryPropertyIndex(
+      const std::string& column_name, size_t num_entities,
+      const std::shared_ptr<arrow::Array>& property)
+      : PropertyIndex<node_or_edge>(column_name, num_entities),
+        property_(std::static_pointer_cast<arrow::DictionaryArray>(property)),
+        dictionary_(std::static_pointer_cast<arrow::LargeStringArray>(
+            property_->dictionary())),
+        codes_(property_->indices()->data()->template GetValues<code_type>(
+            1)) {}
+
+  PropertyIndexKind kind() const override {
+    return PropertyIndexKind::kOrdered;
+  }
+
+  // Returns an iterator to the first element in the index with its property
+  // value equal to `key`.
+  iterator Find(std::string_view key) const {
+    auto [first, last] = EqualRange(key);
+    return first == last ? this->end() : first;
+  }
+
+  // Returns the range of elements in the index with their property value
+  // equal to `key`.
+  std::pair<iterator, iterator> EqualRange(std::string_view key) const {
+    return {LowerBound(key), UpperBound(key)};
+  }
+
+  // Returns an iterator to the first element in the index that is greater
+  // than or equal to `key`.
+  iterator LowerBound(std::string_view key) const {
+    return RankBegin(std::partition_point(
+        ranked_codes_.begin(), ranked_codes_.end(),
+        [&](code_type code) { return GetValue(code) < key; }));
+  }
+
+  // Returns an iterator to the first element in the index that is greater
+  // than `key`.
+  iterator UpperBound(std::string_view key) const {
+    return RankBegin(std::partition_point(
+        ranked_codes_.begin(), ranked_codes_.end(),
+        [&](code_type code) { return GetValue(code) <= key; }));
+  }
+
+  // Returns the range of elements in the index with the dictionary code
+  // `code`, which is empty for codes of null dictionary values.
+  std::pair<iterator, iterator> EqualRangeOfCode(code_type code) const {
+    uint64_t rank = code_ranks_[code];
+    if (rank == ranked_codes_.size()) {
+      return {this->end(), this->end()};
+    }
+    return {
+        this->begin() + rank_offsets_[rank],
+        this->begin() + rank_offsets_[rank + 1]};
+  }
+
+  // The number of entries in the dictionary of the property.
+  size_t num_codes() const { return code_ranks_.size(); }
+
+private:
+  std::string_view GetValue(code_type code) const {
+    arrow::util::string_view arrow_view = dictionary_->GetView(code);
+    return std::string_view(arrow_view.data(), arrow_view.length());
+  }
+
+  iterator RankBegin(
+      typename std::vector<code_type>::const_iterator ranked) const {
+    return this->begin() + rank_offsets_[ranked - ranked_codes_.begin()];
+  }
+
+  // Sort the codes of non-null dictionary values by value into
+  // ranked_codes_, and set code_ranks_.
+  void RankCodes();
+
+  Result<void> BuildFromProperty() override;
+
+  std::vector<internal::IndexArrayBase*> arrays() override {
+    return {&this->sorted_ids_, &rank_offsets_};
+  }
+
+  Result<void> FinishBuildFromFile() override;
+
+  std::shared_ptr<arrow::DictionaryArray> property_;
+  std::shared_ptr<arrow::LargeStringArray> dictionary_;
+  const code_type* codes_;
+  // The ids with the value of ranked_codes_[r] are sorted_ids_[
+  // rank_offsets_[r]] to sorted_ids_[rank_offsets_[r + 1] - 1]
+  internal::IndexArray<uint64_t> rank_offsets_;
+  // The codes in order of their values, and the position of each code in
+  // that order, or ranked_codes_.size() for codes of null values. They are
+  // derived from the dictionary rather than stored.
+  std::vector<code_type> ranked_codes_;
+  std::vector<uint64_t> code_ranks_;
+};
 
-// Create a PropertyIndex with the apropriate type for 'property'. Does not
-// build the index.
+// Create a PropertyIndex of the given kind with the apropriate type for
+// 'property'. Does not build the index.
 template <typename node_or_edge>
 Result<std::unique_ptr<PropertyIndex<node_or_edge>>> MakeTypedIndex(
     const std::string& column_name, size_t num_entities,
-    std::shared_ptr<arrow::Array> property);
+    std::shared_ptr<arrow::Array> property,
+    PropertyIndexKind kind = PropertyIndexKind::kOrdered);
 
 }  // namespace katana
 
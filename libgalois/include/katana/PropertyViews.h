@@ -1,9 +1,88 @@
 #ifndef KATANA_LIBGALOIS_KATANA_PROPERTYVIEWS_H_
 #define KATANA_LIBGALOIS_KATANA_PROPERTYVIEWS_H_
 
+#include <algorithm>
+
+#include "katana/Loops.h"
 #include "katana/Properties.h"
 #include "katana/PropertyGraph.h"
 
+namespace katana {
+
+/// MakeNodeChunkedPropertyView applies a chunked view of Prop to the node
+/// property named name, whatever the number of its chunks.
+///
+/// \see ChunkedPropertyView
+template <typename Prop>
+Result<ChunkedPropertyView<Prop>>
+MakeNodeChunkedPropertyView(
+    const PropertyGraph* pg, const std::string& name) {
+  return ChunkedPropertyView<Prop>::Make(
+      KATANA_CHECKED(pg->GetNodeProperty(name)));
+}
+
+/// MakeEdgeChunkedPropertyView applies a chunked view of Prop to the edge
+/// property named name.
+///
+/// \see MakeNodeChunkedPropertyView
+template <typename Prop>
+Result<ChunkedPropertyView<Prop>>
+MakeEdgeChunkedPropertyView(
+    const PropertyGraph* pg, const std::string& name) {
+  return ChunkedPropertyView<Prop>::Make(
+      KATANA_CHECKED(pg->GetEdgeProperty(name)));
+}
+
+/// DoAllChunkAligned calls fn(chunk, i, j) in parallel for every element of
+/// a chunked view, where chunk is the view of the chunk holding element i of
+/// the column and j is its index in that chunk.
+///
+/// Each chunk is split into ranges of at most range_size elements that are
+/// distributed with work stealing, so no range crosses a chunk boundary and
+/// elements are reached without a chunk lookup.
+///
+/// \code
+/// auto rank = KATANA_CHECKED(
+///     katana::MakeNodeChunkedPropertyView<katana::PODProperty<float>>(
+///         pg, "rank"));
+/// katana::DoAllChunkAligned(&rank, [](auto& chunk, size_t, size_t j) {
+///   chunk[j] = 0;
+/// });
+/// \endcode
+template <typename Prop, typename F>
+void
+DoAllChunkAligned(
+    ChunkedPropertyView<Prop>* view, const F& fn,
+    size_t range_size = size_t{1} << 14,
+    const char* loopname = "DoAllChunkAligned") {
+  struct Range {
+    size_t chunk;
+    size_t begin;
+    size_t end;
+  };
+  std::vector<Range> ranges;
+  for (size_t c = 0; c < view->num_chunks(); ++c) {
+    for (size_t begin = view->chunk_begin(c); begin < view->chunk_end(c);
+         begin += range_size) {
+      ranges.emplace_back(
+          Range{c, begin, std::min(begin + range_size, view->chunk_end(c))});
+    }
+  }
+
+  katana::do_all(
+      katana::iterate(ranges.begin(), ranges.end()),
+      [&](const Range& range) {
+        auto& chunk = view->chunk(range.chunk);
+        size_t offset = view->chunk_begin(range.chunk);
+        for (size_t i = range.begin; i < range.end; ++i) {
+          fn(chunk, i, i - offset);
+        }
+      },
+      katana::steal(), katana::no_stats(), katana::loopname(loopname));
+}
+
+}  // namespace katana
+
 namespace katana::internal {
 
 /// ExtractArrays returns the array for each column of a table. It returns an
@@ -20,6 +20,7 @@
 #ifndef KATANA_LIBGALOIS_KATANA_RANGE_H_
 #define KATANA_LIBGALOIS_KATANA_RANGE_H_
 
+#include <algorithm>
 #include <iterator>
 #include <type_traits>
 
@@ -152,6 +153,40 @@ MakeStandardRange(Iterator begin, Iterator end) {
   return StandardRange<Iterator>(begin, end);
 }
 
+namespace internal {
+
+/**
+ * Returns the number of threads needed to give each thread at least
+ * iterations_per_thread items of range, capped at the number of active
+ * threads.
+ *
+ * Only ranges whose items are divided among threads by position can run on
+ * fewer threads. Other ranges, e.g., the per-thread parts of an InsertBag,
+ * would lose the items of the threads left out, so they use all active
+ * threads.
+ */
+template <typename RangeTy>
+unsigned
+ThreadsForRange(const RangeTy&, size_t) {
+  return activeThreads;
+}
+
+template <typename Iterator>
+unsigned
+ThreadsForRange(
+    const StandardRange<Iterator>& range, size_t iterations_per_thread) {
+  using Category = typename std::iterator_traits<Iterator>::iterator_category;
+  if constexpr (!std::is_base_of_v<std::random_access_iterator_tag, Category>) {
+    return activeThreads;
+  } else {
+    size_t size = std::distance(range.begin(), range.end());
+    size_t wanted = (size + iterations_per_thread - 1) / iterations_per_thread;
+    return std::max<size_t>(std::min<size_t>(wanted, activeThreads), 1);
+  }
+}
+
+}  // namespace internal
+
 /**
  * SpecificRange is a range type where a threads range is specified by an int
  * array that gives where each thread should begin its iteration
@@ -0,0 +1,231 @@
+#ifndef KATANA_LIBGALOIS_KATANA_SETINTERSECTION_H_
+#define KATANA_LIBGALOIS_KATANA_SETINTERSECTION_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "katana/Logging.h"
+
+/// \file SetIntersection.h
+///
+/// Kernels that intersect sorted, duplicate free lists of node ids, e.g., the
+/// edge destinations of nodes of a topology with edges sorted by destination.
+/// Each ForEachCommon* kernel calls fn(id) for every id in both lists in
+/// increasing order; CountCommon returns the size of the intersection.
+/// ForEachCommon and CountCommon pick a kernel for each pair from the sizes
+/// of the lists.
+
+namespace katana {
+
+/// Lists whose sizes differ by at least this factor are intersected by
+/// galloping through the longer one
+constexpr size_t kIntersectGallopRatio = 32;
+
+/// A list at least this long pays for an IntersectionBitmap when it is
+/// intersected with more than one other list
+constexpr size_t kIntersectBitmapMinSize = 512;
+
+/// A set of node ids with one bit per id, against which a list is
+/// intersected with one probe per element however large the set is. It is
+/// meant for the neighbors of a high degree node that are intersected with
+/// many other lists. Keep one per thread and reuse it: Clear only touches the
+/// words of the current members, so it costs as much as Assign.
+class IntersectionBitmap {
+public:
+  /// Make the set [members, members + size) of ids less than universe. The
+  /// members must stay valid until the next Assign or Clear.
+  void Assign(const uint32_t* members, size_t size, size_t universe) {
+    Clear();
+    size_t num_words = (universe + kBitsPerWord - 1) / kBitsPerWord;
+    if (words_.size() < num_words) {
+      words_.resize(num_words, 0);
+    }
+    for (size_t i = 0; i < size; ++i) {
+      KATANA_LOG_DEBUG_ASSERT(members[i] < universe);
+      words_[members[i] / kBitsPerWord] |= uint64_t{1}
+                                           << (members[i] % kBitsPerWord);
+    }
+    members_ = members;
+    size_ = size;
+  }
+
+  void Clear() {
+    for (size_t i = 0; i < size_; ++i) {
+      words_[members_[i] / kBitsPerWord] = 0;
+    }
+    members_ = nullptr;
+    size_ = 0;
+  }
+
+  /// The list last passed to Assign, or null if the set is empty
+  const uint32_t* members() const { return members_; }
+
+  size_t size() const { return size_; }
+
+  bool Contains(uint32_t id) const {
+    size_t word = id / kBitsPerWord;
+    return word < words_.size() &&
+           ((words_[word] >> (id % kBitsPerWord)) & 1) != 0;
+  }
+
+private:
+  static constexpr size_t kBitsPerWord = 64;
+
+  std::vector<uint64_t> words_;
+  const uint32_t* members_{nullptr};
+  size_t size_{0};
+};
+
+/// Merge a and b in one pass. Where SSE2 is available, blocks of four
+/// elements of each list are compared all against all at once, and the block
+/// with the smaller last element moves on. Best for lists of similar sizes.
+template <typename F>
+void
+ForEachCommonMerge(
+    const uint32_t* a, size_t a_size, const uint32_t* b, size_t b_size,
+    const F& fn) {
+  size_t i = 0;
+  size_t j = 0;
+#if defined(__SSE2__)
+  constexpr size_t kBlock = 4;
+  while (i + kBlock <= a_size && j + kBlock <= b_size) {
+    __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+    __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + j));
+    // Compare va with every rotation of vb
+    __m128i eq = _mm_or_si128(
+        _mm_or_si128(
+            _mm_cmpeq_epi32(va, vb),
+            _mm_cmpeq_epi32(
+                va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1)))),
+        _mm_or_si128(
+            _mm_cmpeq_epi32(
+                va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))),
+            _mm_cmpeq_epi32(
+                va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3)))));
+    for (int matched = _mm_movemask_ps(_mm_castsi128_ps(eq)); matched != 0;
+         matched &= matched - 1) {
+      fn(a[i + __builtin_ctz(matched)]);
+    }
+    uint32_t a_last = a[i + kBlock - 1];
+    uint32_t b_last = b[j + kBlock - 1];
+    i += a_last <= b_last ? kBlock : 0;
+    j += b_last <= a_last ? kBlock : 0;
+  }
+#endif
+  while (i < a_size && j < b_size) {
+    if (a[i] < b[j]) {
+      ++i;
+    } else if (b[j] < a[i]) {
+      ++j;
+    } else {
+      fn(a[i]);
+      ++i;
+      ++j;
+    }
+  }
+}
+
+/// Search large for every element of small, each search starting where the
+/// previous one ended and doubling its step until it passes the element.
+/// Best when large is much longer than small.
+template <typename F>
+void
+ForEachCommonGalloping(
+    const uint32_t* small, size_t small_size, const uint32_t* large,
+    size_t large_size, const F& fn) {
+  const uint32_t* lo = large;
+  const uint32_t* end = large + large_size;
+  for (size_t i = 0; i < small_size && lo != end; ++i) {
+    uint32_t id = small[i];
+    auto remaining = static_cast<size_t>(end - lo);
+    size_t bound = 1;
+    while (bound <= remaining && lo[bound - 1] < id) {
+      bound *= 2;
+    }
+    lo = std::lower_bound(lo + bound / 2, lo + std::min(bound, remaining), id);
+    if (lo != end && *lo == id) {
+      fn(id);
+      ++lo;
+    }
+  }
+}
+
+/// Probe a_bitmap with every element of b
+template <typename F>
+void
+ForEachCommonBitmap(
+    const IntersectionBitmap& a_bitmap, const uint32_t* b, size_t b_size,
+    const F& fn) {
+  for (size_t j = 0; j < b_size; ++j) {
+    if (a_bitmap.Contains(b[j])) {
+      fn(b[j]);
+    }
+  }
+}
+
+/// Intersect a and b by galloping if one is much longer than the other and
+/// by merging otherwise
+template <typename F>
+void
+ForEachCommon(
+    const uint32_t* a, size_t a_size, const uint32_t* b, size_t b_size,
+    const F& fn) {
+  if (a_size > b_size) {
+    std::swap(a, b);
+    std::swap(a_size, b_size);
+  }
+  if (a_size == 0) {
+    return;
+  }
+  if (b_size / a_size >= kIntersectGallopRatio) {
+    ForEachCommonGalloping(a, a_size, b, b_size, fn);
+  } else {
+    ForEachCommonMerge(a, a_size, b, b_size, fn);
+  }
+}
+
+/// Intersect a and b by probing a_bitmap with b, or by galloping through b
+/// if b is much longer than a. a may be a sub-range of the set in a_bitmap as
+/// long as the two agree on every element of b.
+template <typename F>
+void
+ForEachCommon(
+    const IntersectionBitmap& a_bitmap, const uint32_t* a, size_t a_size,
+    const uint32_t* b, size_t b_size, const F& fn) {
+  if (a_size == 0) {
+    return;
+  }
+  if (b_size / a_size >= kIntersectGallopRatio) {
+    ForEachCommonGalloping(a, a_size, b, b_size, fn);
+  } else {
+    ForEachCommonBitmap(a_bitmap, b, b_size, fn);
+  }
+}
+
+inline size_t
+CountCommon(
+    const uint32_t* a, size_t a_size, const uint32_t* b, size_t b_size) {
+  size_t count = 0;
+  ForEachCommon(a, a_size, b, b_size, [&](uint32_t) { ++count; });
+  return count;
+}
+
+inline size_t
+CountCommon(
+    const IntersectionBitmap& a_bitmap, const uint32_t* a, size_t a_size,
+    const uint32_t* b, size_t b_size) {
+  size_t count = 0;
+  ForEachCommon(a_bitmap, a, a_size, b, b_size, [&](uint32_t) { ++count; });
+  return count;
+}
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,267 @@
+#ifndef KATANA_LIBGALOIS_KATANA_SPARSEMATRIXVECTOR_H_
+#define KATANA_LIBGALOIS_KATANA_SPARSEMATRIXVECTOR_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "katana/Bag.h"
+#include "katana/Frontier.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// Semirings for SparseMatrixVector. A semiring is a struct with a Value
+/// type and static Zero(), One(), Add(a, b) and Multiply(a, b). Add must be
+/// associative and commutative with identity Zero(), since the engine sums
+/// in any order, and Multiply(One(), x) must be x. Everything is inlined, so
+/// every semiring gets its own kernels.
+
+/// Sums of products, e.g., for PageRank, HITS and Katz centrality
+template <typename T>
+struct PlusTimesSemiring {
+  using Value = T;
+  static constexpr T Zero() { return T{0}; }
+  static constexpr T One() { return T{1}; }
+  static constexpr T Add(T a, T b) { return a + b; }
+  static constexpr T Multiply(T a, T b) { return a * b; }
+};
+
+/// Shortest paths: Zero() is infinity and absorbs Multiply
+template <typename T>
+struct MinPlusSemiring {
+  using Value = T;
+  static constexpr T Zero() { return std::numeric_limits<T>::max(); }
+  static constexpr T One() { return T{0}; }
+  static constexpr T Add(T a, T b) { return std::min(a, b); }
+  static constexpr T Multiply(T a, T b) {
+    return a == Zero() || b == Zero() ? Zero() : a + b;
+  }
+};
+
+/// Reachability, e.g., for BFS
+struct OrAndSemiring {
+  using Value = uint8_t;
+  static constexpr Value Zero() { return 0; }
+  static constexpr Value One() { return 1; }
+  static constexpr Value Add(Value a, Value b) { return a | b; }
+  static constexpr Value Multiply(Value a, Value b) { return a & b; }
+};
+
+/// The weight of every edge is One(); the engine skips the multiplication
+template <typename Semiring>
+struct UnitWeight {
+  constexpr typename Semiring::Value operator()(uint64_t) const {
+    return Semiring::One();
+  }
+};
+
+/// Computes y = y + A^T x over a semiring, where A is the adjacency matrix
+/// of a graph: for every edge src -> dst, y[dst] += w(e) * x[src]. The
+/// weight of an edge is weight(edge property index), so a weight can be an
+/// edge property array.
+///
+/// The sparse form (SpMSpV) only reads x for the nodes of a Frontier and
+/// reports the nodes whose value in y changed, so one round of BFS, SSSP or
+/// PageRank-delta is one call. It either pushes along the out-edges of the
+/// active nodes or pulls along the in-edges of every node, like a
+/// direction-optimizing BFS:
+///
+/// - push: products are appended to per-thread bins, one per block of
+///   destinations, and every block is then summed by a single task
+///   (propagation blocking), so no atomics are needed and the writes to y of
+///   a task stay within a cache-sized block
+/// - pull: every destination sums its in-edges into a register and writes
+///   once; the dense form is this loop over contiguous edges, which the
+///   compiler vectorizes
+///
+/// Graph must provide out- and in-edges, e.g., a
+/// PropertyGraphViews::BiDirectional view, and must outlive the engine. x and
+/// y may not overlap.
+///
+/// \code
+/// katana::SparseMatrixVector<katana::OrAndSemiring, View> spmv(view);
+/// // One BFS level: visited |= A^T frontier
+/// spmv.Multiply(current, ones.data(), visited.data(), &next);
+/// \endcode
+template <typename Semiring, typename Graph>
+class SparseMatrixVector {
+public:
+  using Value = typename Semiring::Value;
+  using Node = uint32_t;
+
+  enum class Direction { kAuto, kPush, kPull };
+
+  /// \param pull_density pull once the frontier holds more than this
+  ///     fraction of the nodes
+  /// \param block_bits the log2 of the number of destinations per push bin
+  explicit SparseMatrixVector(
+      const Graph& graph, double pull_density = 1.0 / 20,
+      uint32_t block_bits = 16)
+      : graph_(graph),
+        pull_density_(pull_density),
+        block_bits_(block_bits),
+        num_blocks_((graph.num_nodes() >> block_bits) + 1),
+        block_touched_(std::make_unique<std::atomic<bool>[]>(num_blocks_)) {
+    for (size_t i = 0; i < num_blocks_; ++i) {
+      block_touched_[i].store(false, std::memory_order_relaxed);
+    }
+  }
+
+  /// Dense SpMV: y[dst] += sum of w(e) * x[src] over all edges
+  template <typename Weight = UnitWeight<Semiring>>
+  void Multiply(
+      const Value* x, Value* y, const Weight& weight = Weight()) const {
+    do_all(
+        iterate(graph_.all_nodes()),
+        [&](Node dst) { y[dst] = Semiring::Add(y[dst], Pull(dst, x, weight)); },
+        steal(), no_stats(), loopname("SpMVPull"));
+  }
+
+  /// SpMSpV: y[dst] += sum of w(e) * x[src] over the edges whose source is
+  /// in active. Every node whose value in y changes is pushed to changed,
+  /// if not null, which is not sealed.
+  template <typename Weight = UnitWeight<Semiring>>
+  void Multiply(
+      const Frontier& active, const Value* x, Value* y, Frontier* changed,
+      const Weight& weight = Weight(),
+      Direction direction = Direction::kAuto) {
+    if (direction == Direction::kAuto) {
+      direction = active.Density() > pull_density_ ? Direction::kPull
+                                                   : Direction::kPush;
+    }
+    if (direction == Direction::kPull) {
+      MultiplyPull(active, x, y, changed, weight);
+    } else {
+      MultiplyPush(active, x, y, changed, weight);
+    }
+  }
+
+private:
+  struct Entry {
+    Node dst;
+    Value value;
+  };
+
+  template <typename Weight>
+  static constexpr bool kUnitWeight =
+      std::is_same_v<Weight, UnitWeight<Semiring>>;
+
+  template <typename Weight>
+  Value Product(uint64_t property_index, Value x, const Weight& weight) const {
+    if constexpr (kUnitWeight<Weight>) {
+      return x;
+    } else {
+      return Semiring::Multiply(weight(property_index), x);
+    }
+  }
+
+  /// The sum over the in-edges of dst of the products with x
+  template <typename Weight>
+  Value Pull(Node dst, const Value* __restrict x, const Weight& weight) const {
+    Value sum = Semiring::Zero();
+    for (auto e : graph_.in_edges(dst)) {
+      sum = Semiring::Add(
+          sum, Product(
+                   graph_.in_edge_property_index(e),
+                   x[graph_.in_edge_dest(e)], weight));
+    }
+    return sum;
+  }
+
+  template <typename Weight>
+  void MultiplyPull(
+      const Frontier& active, const Value* x, Value* y, Frontier* changed,
+      const Weight& weight) const {
+    do_all(
+        iterate(graph_.all_nodes()),
+        [&](Node dst) {
+          Value sum = Semiring::Zero();
+          for (auto e : graph_.in_edges(dst)) {
+            Node src = graph_.in_edge_dest(e);
+            if (active.Contains(src)) {
+              sum = Semiring::Add(
+                  sum,
+                  Product(graph_.in_edge_property_index(e), x[src], weight));
+            }
+          }
+          Apply(dst, sum, y, changed);
+        },
+        steal(), no_stats(), loopname("SpMSpVPull"));
+  }
+
+  template <typename Weight>
+  void MultiplyPush(
+      const Frontier& active, const Value* x, Value* y, Frontier* changed,
+      const Weight& weight) {
+    InsertBag<size_t> touched;
+    active.ForEachActive(
+        [&](Node src) {
+          std::vector<std::vector<Entry>>& bins = *bins_.getLocal();
+          if (bins.size() != num_blocks_) {
+            bins.resize(num_blocks_);
+          }
+          Value value = x[src];
+          for (auto e : graph_.edges(src)) {
+            Node dst = graph_.edge_dest(e);
+            size_t block = dst >> block_bits_;
+            if (bins[block].empty() &&
+                !block_touched_[block].exchange(
+                    true, std::memory_order_relaxed)) {
+              touched.push(block);
+            }
+            bins[block].emplace_back(Entry{
+                dst, Product(graph_.edge_property_index(e), value, weight)});
+          }
+        },
+        loopname("SpMSpVPushBin"));
+
+    do_all(
+        iterate(touched),
+        [&](size_t block) {
+          block_touched_[block].store(false, std::memory_order_relaxed);
+          for (unsigned t = 0; t < bins_.size(); ++t) {
+            std::vector<std::vector<Entry>>& bins = *bins_.getRemote(t);
+            if (block >= bins.size()) {
+              continue;
+            }
+            for (const Entry& entry : bins[block]) {
+              Apply(entry.dst, entry.value, y, changed);
+            }
+            bins[block].clear();
+          }
+        },
+        steal(), no_stats(), loopname("SpMSpVPushApply"));
+  }
+
+  static void Apply(Node dst, Value value, Value* y, Frontier* changed) {
+    Value updated = Semiring::Add(y[dst], value);
+    if (updated != y[dst]) {
+      y[dst] = updated;
+      if (changed) {
+        changed->Push(dst);
+      }
+    }
+  }
+
+  const Graph& graph_;
+  double pull_density_;
+  uint32_t block_bits_;
+  size_t num_blocks_;
+  // Whether a block has entries in some bin and is listed for this round
+  std::unique_ptr<std::atomic<bool>[]> block_touched_;
+  // bins_[thread][block] holds the products pushed to the block
+  PerThreadStorage<std::vector<std::vector<Entry>>> bins_;
+};
+
+}  // namespace katana
+
+#endif
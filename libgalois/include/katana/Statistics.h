@@ -313,6 +313,11 @@ protected:
   /// ReadParam and ReadFP and print their own results here.
   virtual void PrintStats(std::ostream& out);
 
+  /// PrintStatsJson prints statistics to a stream as a JSON array of
+  /// objects, one per statistic. Print uses it for stat files ending in
+  /// .json.
+  void PrintStatsJson(std::ostream& out);
+
   void MergeStats();
 
   bool IsPrintingThreadVals() const;
@@ -477,6 +482,9 @@ private:
   bool reported_{false};
 };
 
+/// Reports the current and peak bytes of each MemoryCategory
+KATANA_EXPORT void ReportMemoryAccounting();
+
 /// Prints statistics out to standard out or to the file indicated by
 /// SetStatFile
 KATANA_EXPORT void PrintStats();
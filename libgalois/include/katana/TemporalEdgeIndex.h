@@ -0,0 +1,114 @@
+#ifndef KATANA_LIBGALOIS_KATANA_TEMPORALEDGEINDEX_H_
+#define KATANA_LIBGALOIS_KATANA_TEMPORALEDGEINDEX_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+
+#include "katana/GraphTopology.h"
+#include "katana/NUMAArray.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// The timestamps [begin, end), in the units of a timestamp property, e.g.,
+/// the last 24 hours of a property of arrow::timestamp(arrow::TimeUnit::SECOND)
+/// values is {now - 24 * 3600, now + 1}
+struct TimeWindow {
+  int64_t begin{std::numeric_limits<int64_t>::min()};
+  int64_t end{std::numeric_limits<int64_t>::max()};
+
+  bool Contains(int64_t time) const noexcept {
+    return begin <= time && time < end;
+  }
+};
+
+/// The edges of every node sorted by an edge property of timestamps, with
+/// the timestamps stored in the same order, so that the edges of a node in
+/// a TimeWindow are found by two binary searches over the timestamps of the
+/// node rather than by scanning and filtering all of its edges.
+///
+/// The timestamp property may be of any integer, date, time, timestamp or
+/// duration type without nulls; its values are compared as 64-bit integers.
+/// PropertyGraph::GetTemporalEdgeIndex builds an index once and caches it
+/// with the views of the graph.
+class KATANA_EXPORT TemporalEdgeIndex {
+public:
+  using Node = GraphTopologyTypes::Node;
+  using Edge = GraphTopologyTypes::Edge;
+  using PropertyIndex = GraphTopologyTypes::PropertyIndex;
+  using edges_range = GraphTopologyTypes::edges_range;
+
+  TemporalEdgeIndex(const TemporalEdgeIndex&) = delete;
+  TemporalEdgeIndex& operator=(const TemporalEdgeIndex&) = delete;
+
+  /// Index the out-edges of pg, or its in-edges if \p tpose_kind is kYes, by
+  /// the edge property \p timestamp_property
+  static Result<std::unique_ptr<TemporalEdgeIndex>> Make(
+      const PropertyGraph* pg, const std::string& timestamp_property,
+      EdgeShuffleTopology::TransposeKind tpose_kind =
+          EdgeShuffleTopology::TransposeKind::kNo) noexcept;
+
+  uint64_t num_nodes() const noexcept { return topo_->num_nodes(); }
+  uint64_t num_edges() const noexcept { return topo_->num_edges(); }
+
+  auto all_nodes() const noexcept { return topo_->all_nodes(); }
+
+  bool is_transposed() const noexcept { return topo_->is_transposed(); }
+
+  /// The edges of \p node, oldest first
+  edges_range edges(Node node) const noexcept { return topo_->edges(node); }
+
+  /// The edges of \p node with a timestamp in \p window, oldest first
+  edges_range edges(Node node, const TimeWindow& window) const noexcept {
+    edges_range all = topo_->edges(node);
+    const int64_t* first = times_.data() + *all.begin();
+    const int64_t* last = times_.data() + *all.end();
+    const int64_t* begin = std::lower_bound(first, last, window.begin);
+    const int64_t* end = std::lower_bound(begin, last, window.end);
+    return MakeStandardRange<edge_iterator>(
+        Edge(begin - times_.data()), Edge(end - times_.data()));
+  }
+
+  Node edge_dest(Edge e) const noexcept { return topo_->edge_dest(e); }
+
+  int64_t edge_time(Edge e) const noexcept {
+    KATANA_LOG_DEBUG_ASSERT(e < times_.size());
+    return times_[e];
+  }
+
+  PropertyIndex edge_property_index(Edge e) const noexcept {
+    return topo_->edge_property_index(e);
+  }
+
+  /// The timestamps of all edges, indexed by edge
+  const int64_t* time_data() const noexcept { return times_.data(); }
+
+  /// The order of the edges of the index, e.g., to read another edge
+  /// property alongside the timestamps with
+  /// PropertyGraph::GetEdgePropertyInOrder
+  EdgeOrder edge_order() const noexcept { return EdgeOrder{topo_}; }
+
+  const EdgeShuffleTopology& topology() const noexcept { return *topo_; }
+
+  size_t bytes() const noexcept;
+
+private:
+  using edge_iterator = GraphTopologyTypes::edge_iterator;
+
+  TemporalEdgeIndex(
+      std::shared_ptr<EdgeShuffleTopology> topo,
+      NUMAArray<int64_t>&& times) noexcept
+      : topo_(std::move(topo)), times_(std::move(times)) {}
+
+  // Edges sorted by timestamp within each node
+  std::shared_ptr<EdgeShuffleTopology> topo_;
+  NUMAArray<int64_t> times_;
+};
+
+}  // namespace katana
+
+#endif
@@ -67,6 +67,10 @@ KATANA_EXPORT TerminationDetection& GetTerminationDetection(
 ///
 ///   } while (term.Working());
 ///
+/// The implementation is chosen when the runtime starts with the
+/// KATANA_TERMINATION environment variable. The snzi implementation parks
+/// threads that stay idle, so SignalWorked(false) may block for a short time.
+///
 class KATANA_EXPORT TerminationDetection {
   // So that GetTerminationDetection can call init.
   friend TerminationDetection& GetTerminationDetection(unsigned);
@@ -101,11 +101,13 @@ protected:
   thread_local static per_signal my_box;
 
   MachineTopoInfo mi;
+  std::vector<ThreadTopoInfo> threadTopo;
   std::vector<per_signal*> signals;
+  //! threads 1 to threads.size(), started as regions first need them
   std::vector<std::thread> threads;
   unsigned reserved;
   unsigned masterFastmode;
-  bool running;
+  std::atomic<bool> running;
   std::function<void(void)> work;
 
   //! destroy all threads
@@ -117,12 +119,29 @@ protected:
   //! main thread loop
   void threadLoop(unsigned tid);
 
+  //! start the threads with IDs below num that have not been started yet
+  void spawnThreads(unsigned num);
+
   //! spin up for run
   void cascade(bool fastmode);
 
   //! spin down after run
   void decascade();
 
+  //! claim the pool for a parallel region
+  void beginRun();
+
+  //! releases the pool claimed by beginRun, also when the region throws
+  class RunGuard {
+    std::atomic<bool>& running_;
+
+  public:
+    explicit RunGuard(std::atomic<bool>& running) : running_(running) {}
+    RunGuard(const RunGuard&) = delete;
+    RunGuard& operator=(const RunGuard&) = delete;
+    ~RunGuard() { running_ = false; }
+  };
+
   //! execute work on num threads
   void runInternal(unsigned num);
 
@@ -139,8 +158,16 @@ public:
 
   //! execute work on all threads
   //! a simple wrapper for run
+  //!
+  //! Only one parallel region runs at a time. Regions may not be nested, and
+  //! they may not be started concurrently from different application threads:
+  //! per-thread runtime state (PerThreadStorage, the per-thread allocators
+  //! and activeThreads) is indexed by pool thread ID and shared by every
+  //! region.
   template <typename... Args>
   void run(unsigned num, Args&&... args) {
+    beginRun();
+    RunGuard guard(running);
     struct ExecuteTuple {
       //      using Ty = std::tuple<Args...>;
       std::tuple<Args...> cmds;
@@ -188,18 +215,25 @@ public:
     abort();
   }
 
+  //! return the number of threads started so far, including the main
+  //! thread; the others start when a parallel region first uses them
+  unsigned getNumSpawnedThreads() const { return threads.size() + 1; }
+
   bool isLeader(unsigned tid) const {
-    return signals[tid]->topo.socketLeader == tid;
+    return threadTopo[tid].socketLeader == tid;
   }
-  unsigned getSocket(unsigned tid) const { return signals[tid]->topo.socket; }
+  unsigned getSocket(unsigned tid) const { return threadTopo[tid].socket; }
   unsigned getLeader(unsigned tid) const {
-    return signals[tid]->topo.socketLeader;
+    return threadTopo[tid].socketLeader;
   }
   unsigned getCumulativeMaxSocket(unsigned tid) const {
-    return signals[tid]->topo.cumulativeMaxSocket;
+    return threadTopo[tid].cumulativeMaxSocket;
   }
   unsigned getNumaNode(unsigned tid) const {
-    return signals[tid]->topo.numaNode;
+    return threadTopo[tid].numaNode;
+  }
+  unsigned getOSNumaNode(unsigned tid) const {
+    return threadTopo[tid].osNumaNode;
   }
 
   static unsigned getTID() { return my_box.topo.tid; }
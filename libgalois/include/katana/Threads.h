@@ -37,5 +37,26 @@ KATANA_EXPORT unsigned int setActiveThreads(unsigned int num) noexcept;
  */
 KATANA_EXPORT unsigned int getActiveThreads() noexcept;
 
+namespace internal {
+
+/**
+ * Lowers the number of active threads for its lifetime, e.g., to run a
+ * single loop on fewer threads. Threads above the new count stay asleep.
+ * Does nothing if created during parallel execution.
+ */
+class KATANA_EXPORT ScopedActiveThreads {
+public:
+  explicit ScopedActiveThreads(unsigned int num) noexcept;
+  ~ScopedActiveThreads();
+
+  ScopedActiveThreads(const ScopedActiveThreads&) = delete;
+  ScopedActiveThreads& operator=(const ScopedActiveThreads&) = delete;
+
+private:
+  unsigned int prev_;
+};
+
+}  // namespace internal
+
 }  // namespace katana
 #endif
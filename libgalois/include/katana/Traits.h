@@ -338,6 +338,22 @@ struct det_id : public trait_has_value<T>, det_id_tag {
   det_id(T&& t) : trait_has_value<T>(std::move(t)) {}
 };
 
+/**
+ * Indicates that the deterministic scheduler should resolve conflicts by a
+ * fixed hash of the ids of active elements rather than by the ids
+ * themselves. Results are still deterministic, but they differ from the
+ * ones with id priority.
+ *
+ * Ids are usually assigned in iteration order, so elements with nearby ids
+ * often share a neighborhood, e.g., consecutive nodes of a graph. With id
+ * priority, each such chain of conflicts commits one element per round;
+ * hashed priorities break the chains up, so more elements commit per round
+ * and the scheduler grows its window faster.
+ */
+struct det_hash_priority_tag {};
+struct det_hash_priority : public trait_has_type<bool>,
+                           det_hash_priority_tag {};
+
 /**
  * Indicates the operator has a type that encapsulates state that is passed
  * between the suspension and resumpsion of an operator during deterministic
@@ -383,6 +399,22 @@ public:
   chunk_size(unsigned cs = SZ) : trait_has_value(clamp(cs)) {}
 };
 
+/**
+ * Run a loop on only as many threads as its initial range has work for: one
+ * thread per iterations_per_thread items, up to the number of active
+ * threads. Threads left out stay asleep, so small rounds, e.g., the tail
+ * frontiers of a BFS, do not pay to wake and synchronize every thread.
+ *
+ * Applies to ranges made from random access iterators or integers, e.g.,
+ * katana::iterate(0, n) or katana::iterate(vector). Loops over other ranges
+ * use all active threads.
+ */
+struct auto_threads_tag {};
+struct auto_threads : public trait_has_value<unsigned>, auto_threads_tag {
+  auto_threads(unsigned iterations_per_thread = 1024)
+      : trait_has_value(std::max(iterations_per_thread, 1U)) {}
+};
+
 typedef PerSocketChunkFIFO<chunk_size<>::value> defaultWL;
 
 namespace internal {
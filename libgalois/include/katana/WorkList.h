@@ -25,12 +25,14 @@
 #include "katana/BulkSynchronous.h"
 #include "katana/Chunk.h"
 #include "katana/LocalQueue.h"
+#include "katana/MultiQueue.h"
 #include "katana/Obim.h"
 #include "katana/OrderedList.h"
 #include "katana/OwnerComputes.h"
 #include "katana/PerThreadChunk.h"
 #include "katana/Simple.h"
 #include "katana/StableIterator.h"
+#include "katana/WorkStealingDeque.h"
 #include "katana/config.h"
 
 namespace katana {
@@ -38,7 +40,10 @@ namespace katana {
  * Scheduling policies for Galois iterators. Unless you have very specific
  * scheduling requirement, \ref PerSocketChunkLIFO or \ref PerSocketChunkFIFO is
  * a reasonable scheduling policy. If you need approximate priority scheduling,
- * use \ref OrderedByIntegerMetric. For debugging, you may be interested in
+ * use \ref OrderedByIntegerMetric, or \ref MultiQueue if the priorities do
+ * not map well onto integer buckets. For fine-grained operators that push only
+ * a few items per iteration, \ref WorkStealingLIFO avoids the locks of the
+ * chunked worklists. For debugging, you may be interested in
  * \ref FIFO or \ref LIFO, which try to follow serial order exactly.
  *
  * The way to use a worklist is to pass it as a template parameter to
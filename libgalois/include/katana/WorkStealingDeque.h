@@ -0,0 +1,275 @@
+#ifndef KATANA_LIBGALOIS_KATANA_WORKSTEALINGDEQUE_H_
+#define KATANA_LIBGALOIS_KATANA_WORKSTEALINGDEQUE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include "katana/Chunk.h"
+#include "katana/CompilerSpecific.h"
+#include "katana/Logging.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/ThreadPool.h"
+#include "katana/WLCompileCheck.h"
+#include "katana/config.h"
+
+namespace katana {
+
+namespace internal {
+
+/// A Chase-Lev work stealing deque (Chase and Lev, SPAA 2005), using the
+/// C11 memory orderings of Le et al., PPoPP 2013.
+///
+/// Only the owning thread may call push() and pop(), which work at the bottom
+/// of the deque. Any thread may call steal(), which takes from the top. None
+/// of these take a lock; pop() and steal() only contend, with a CAS, for the
+/// last item.
+///
+/// The circular buffer grows by doubling. Stealers may still be reading a
+/// buffer that has been replaced, so old buffers are kept until the deque is
+/// destroyed.
+template <typename T>
+class ChaseLevDeque {
+  // Stealers may read a slot while the owner overwrites it; the value is then
+  // discarded because the stealer's CAS on top_ fails. That is only sound for
+  // types that can be copied bitwise.
+  static_assert(
+      std::is_trivially_copyable<T>::value,
+      "work stealing deque items must be trivially copyable");
+
+  struct Buffer {
+    explicit Buffer(int64_t capacity)
+        : mask(capacity - 1), items(std::make_unique<T[]>(capacity)) {
+      KATANA_LOG_DEBUG_ASSERT((capacity & mask) == 0);
+    }
+
+    int64_t capacity() const { return mask + 1; }
+    T get(int64_t i) const { return items[i & mask]; }
+    void put(int64_t i, const T& val) { items[i & mask] = val; }
+
+    int64_t mask;
+    std::unique_ptr<T[]> items;
+  };
+
+  alignas(KATANA_CACHE_LINE_SIZE) std::atomic<int64_t> top_{0};
+  alignas(KATANA_CACHE_LINE_SIZE) std::atomic<int64_t> bottom_{0};
+  std::atomic<Buffer*> buffer_{nullptr};
+  // Owner only: every buffer ever allocated, the current one last
+  std::vector<std::unique_ptr<Buffer>> buffers_;
+  int64_t initial_capacity_;
+
+  KATANA_ATTRIBUTE_NOINLINE Buffer* grow(
+      Buffer* old, int64_t top, int64_t bottom) {
+    int64_t capacity = old ? old->capacity() * 2 : initial_capacity_;
+    auto fresh = std::make_unique<Buffer>(capacity);
+    for (int64_t i = top; i < bottom; ++i) {
+      fresh->put(i, old->get(i));
+    }
+    Buffer* ret = fresh.get();
+    buffers_.emplace_back(std::move(fresh));
+    buffer_.store(ret, std::memory_order_release);
+    return ret;
+  }
+
+public:
+  /// \param initial_capacity a power of two; the first buffer is allocated on
+  ///     the first push
+  explicit ChaseLevDeque(int64_t initial_capacity = 1024)
+      : initial_capacity_(initial_capacity) {}
+
+  ChaseLevDeque(const ChaseLevDeque&) = delete;
+  ChaseLevDeque& operator=(const ChaseLevDeque&) = delete;
+
+  /// Owner only
+  void push(const T& val) {
+    int64_t b = bottom_.load(std::memory_order_relaxed);
+    int64_t t = top_.load(std::memory_order_acquire);
+    Buffer* a = buffer_.load(std::memory_order_relaxed);
+    if (!a || b - t > a->capacity() - 1) {
+      a = grow(a, t, b);
+    }
+    a->put(b, val);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom_.store(b + 1, std::memory_order_relaxed);
+  }
+
+  /// Owner only. Pops the most recently pushed item.
+  std::optional<T> pop() {
+    int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+    Buffer* a = buffer_.load(std::memory_order_relaxed);
+    bottom_.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = top_.load(std::memory_order_relaxed);
+
+    if (t > b) {
+      // Empty
+      bottom_.store(b + 1, std::memory_order_relaxed);
+      return std::nullopt;
+    }
+
+    std::optional<T> ret = a->get(b);
+    if (t == b) {
+      // Last item: race stealers for it
+      if (!top_.compare_exchange_strong(
+              t, t + 1, std::memory_order_seq_cst,
+              std::memory_order_relaxed)) {
+        ret = std::nullopt;
+      }
+      bottom_.store(b + 1, std::memory_order_relaxed);
+    }
+    return ret;
+  }
+
+  /// Any thread. Steals the least recently pushed item.
+  ///
+  /// \param aborted set to true if the deque was not empty but another
+  ///     thread won the race for the item, i.e., a retry may succeed
+  std::optional<T> steal(bool* aborted) {
+    int64_t t = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t b = bottom_.load(std::memory_order_acquire);
+
+    if (t >= b) {
+      return std::nullopt;
+    }
+
+    Buffer* a = buffer_.load(std::memory_order_acquire);
+    T val = a->get(t);
+    if (!top_.compare_exchange_strong(
+            t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+      *aborted = true;
+      return std::nullopt;
+    }
+    return val;
+  }
+
+  /// A snapshot that may be stale by the time it is returned
+  bool empty() const {
+    int64_t b = bottom_.load(std::memory_order_relaxed);
+    int64_t t = top_.load(std::memory_order_relaxed);
+    return t >= b;
+  }
+};
+
+}  // namespace internal
+
+/**
+ * Per-thread lock-free work stealing deques. Each thread pushes and pops its
+ * own deque in LIFO order; a thread whose deque is empty steals the oldest
+ * item of another thread's deque, trying threads on its own socket first.
+ *
+ * Unlike the chunked worklists, pushes and local pops take no lock, which
+ * suits fine-grained operators that push a few items per iteration. Items
+ * must be trivially copyable.
+ *
+ * @tparam InitialCapacity initial per-thread capacity; must be a power of two
+ */
+template <int InitialCapacity = 1024, typename T = int, bool Concurrent = true>
+class WorkStealingLIFO : private boost::noncopyable {
+  static_assert(
+      InitialCapacity > 0 && (InitialCapacity & (InitialCapacity - 1)) == 0,
+      "initial capacity must be a power of two");
+
+public:
+  template <typename _T>
+  using retype = WorkStealingLIFO<InitialCapacity, _T, Concurrent>;
+
+  template <bool _concurrent>
+  using rethread = WorkStealingLIFO<InitialCapacity, T, _concurrent>;
+
+  template <int _initial_capacity>
+  using with_initial_capacity =
+      WorkStealingLIFO<_initial_capacity, T, Concurrent>;
+
+  typedef T value_type;
+
+private:
+  struct Deque : public internal::ChaseLevDeque<T> {
+    Deque() : internal::ChaseLevDeque<T>(InitialCapacity) {}
+  };
+
+  internal::squeue<Concurrent, PerThreadStorage, Deque> deques;
+
+  std::optional<value_type> stealFromScope(bool same_socket, bool* aborted) {
+    auto& tp = GetThreadPool();
+    const int id = deques.myEffectiveID();
+    const int num = deques.size();
+    const unsigned my_socket = ThreadPool::getSocket();
+
+    // Go around the threads in a circle starting from the next one
+    for (int i = 1; i < num; ++i) {
+      int victim = (id + i) % num;
+      if ((tp.getSocket(victim) == my_socket) != same_socket) {
+        continue;
+      }
+      std::optional<value_type> ret = deques.get(victim).steal(aborted);
+      if (ret) {
+        return ret;
+      }
+    }
+    return std::nullopt;
+  }
+
+  std::optional<value_type> steal() {
+    bool aborted;
+    do {
+      aborted = false;
+      std::optional<value_type> ret = stealFromScope(true, &aborted);
+      if (!ret) {
+        ret = stealFromScope(false, &aborted);
+      }
+      if (ret) {
+        return ret;
+      }
+    } while (aborted);
+    return std::nullopt;
+  }
+
+public:
+  WorkStealingLIFO() = default;
+
+  void push(const value_type& val) { deques.get().push(val); }
+
+  template <typename Iter>
+  void push(Iter b, Iter e) {
+    auto& d = deques.get();
+    while (b != e) {
+      d.push(*b++);
+    }
+  }
+
+  template <typename RangeTy>
+  void push_initial(const RangeTy& range) {
+    push(range.local_begin(), range.local_end());
+  }
+
+  std::optional<value_type> pop() {
+    std::optional<value_type> ret = deques.get().pop();
+    if (ret || !Concurrent) {
+      return ret;
+    }
+    return steal();
+  }
+
+  bool empty() {
+    if (!Concurrent) {
+      return deques.get().empty();
+    }
+    for (int i = 0; i < deques.size(); ++i) {
+      if (!deques.get(i).empty()) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+KATANA_WLCOMPILECHECK(WorkStealingLIFO)
+
+}  // end namespace katana
+
+#endif
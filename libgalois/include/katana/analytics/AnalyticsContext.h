@@ -0,0 +1,150 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_ANALYTICSCONTEXT_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_ANALYTICSCONTEXT_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <typeindex>
+#include <typeinfo>
+#include <unordered_map>
+
+#include "katana/ErrorCode.h"
+#include "katana/NUMAArray.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana::analytics {
+
+class Checkpointer;
+
+/// Scratch memory kept between calls of analytics routines.
+///
+/// Routines that accept a context take their node and edge arrays from it
+/// instead of allocating and freeing them on every call. An array is
+/// allocated and page faulted on its first use and reused by later calls
+/// with the same size, which saves the allocation, NUMA placement and page
+/// faults when the same routine runs many times on one graph.
+///
+/// The scratch memory of a routine is only valid during the call; routines
+/// initialize what they read. A context may be used by one call at a time,
+/// and holds its memory until it is cleared or destroyed.
+///
+/// A context also lets another thread cancel the call using it. Routines
+/// check for cancellation between rounds, so a round in progress finishes
+/// first, and then fail with ErrorCode::Cancelled without writing their
+/// output property.
+///
+/// A context may also carry a Checkpointer, with which the long running
+/// routines that support it periodically save their state and resume from
+/// it after a failed or cancelled run.
+///
+/// \code
+/// katana::analytics::AnalyticsContext context;
+/// for (uint32_t source : sources) {
+///   KATANA_CHECKED(
+///       Bfs(pg, source, fmt::format("bfs_{}", source), {}, &context));
+/// }
+/// \endcode
+class KATANA_EXPORT AnalyticsContext {
+  struct Entry {
+    std::type_index type;
+    std::shared_ptr<void> value;
+  };
+
+  std::unordered_map<std::string, Entry> entries_;
+  uint64_t num_allocations_{0};
+  std::atomic<bool> cancelled_{false};
+  Checkpointer* checkpointer_{nullptr};
+
+public:
+  AnalyticsContext() = default;
+  AnalyticsContext(const AnalyticsContext&) = delete;
+  AnalyticsContext& operator=(const AnalyticsContext&) = delete;
+
+  /// The object of type T named name, default constructed on first use. An
+  /// object of another type with the same name is replaced.
+  template <typename T>
+  T* Get(const std::string& name) {
+    auto it = entries_.find(name);
+    if (it == entries_.end() || it->second.type != typeid(T)) {
+      Entry entry{typeid(T), std::make_shared<T>()};
+      it = entries_.insert_or_assign(name, std::move(entry)).first;
+    }
+    return static_cast<T*>(it->second.value.get());
+  }
+
+  /// The array of size elements of T named name, interleaved across NUMA
+  /// nodes. It is allocated on first use and whenever size changes;
+  /// otherwise its elements are left as the previous call left them.
+  template <typename T>
+  NUMAArray<T>* Array(const std::string& name, size_t size) {
+    NUMAArray<T>* array = Get<NUMAArray<T>>(name);
+    if (array->size() != size) {
+      array->deallocate();
+      array->allocateInterleaved(size);
+      ++num_allocations_;
+    }
+    return array;
+  }
+
+  /// Release all scratch memory.
+  void Clear() { entries_.clear(); }
+
+  /// The number of arrays allocated by this context, for checking reuse.
+  uint64_t num_allocations() const { return num_allocations_; }
+
+  /// Ask the call using this context to stop; may be called from any
+  /// thread. Later calls with the context are cancelled too, until
+  /// ResetCancelled.
+  void Cancel() { cancelled_.store(true, std::memory_order_relaxed); }
+  void ResetCancelled() { cancelled_.store(false, std::memory_order_relaxed); }
+  bool cancelled() const { return cancelled_.load(std::memory_order_relaxed); }
+
+  /// Checkpoint the routines that use this context with checkpointer, which
+  /// must outlive their calls; null turns checkpointing off.
+  void SetCheckpointer(Checkpointer* checkpointer) {
+    checkpointer_ = checkpointer;
+  }
+  Checkpointer* checkpointer() const { return checkpointer_; }
+};
+
+/// Whether the call using context, which may be null, has been cancelled
+inline bool
+IsCancelled(const AnalyticsContext* context) {
+  return context && context->cancelled();
+}
+
+/// ErrorCode::Cancelled if the call using context has been cancelled
+inline Result<void>
+CheckCancelled(const AnalyticsContext* context) {
+  if (IsCancelled(context)) {
+    return KATANA_ERROR(ErrorCode::Cancelled, "analytics call cancelled");
+  }
+  return ResultSuccess();
+}
+
+/// The checkpointer of context, or null if context is null or has none
+inline Checkpointer*
+GetCheckpointer(const AnalyticsContext* context) {
+  return context ? context->checkpointer() : nullptr;
+}
+
+/// The scratch array named name in context, or, without a context, local
+/// allocated with size elements. The array is meant to be used like local,
+/// which is left empty when there is a context.
+template <typename T>
+NUMAArray<T>*
+ScratchArray(
+    AnalyticsContext* context, const std::string& name, size_t size,
+    NUMAArray<T>* local) {
+  if (context) {
+    return context->Array<T>(name, size);
+  }
+  local->allocateInterleaved(size);
+  return local;
+}
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_AUTOTUNE_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_AUTOTUNE_H_
+
+#include <cstdint>
+#include <string>
+
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/analytics/bfs/bfs.h"
+#include "katana/analytics/connected_components/connected_components.h"
+#include "katana/analytics/sssp/sssp.h"
+
+namespace katana::analytics {
+
+/// Options of the AutoTune*Plan functions
+struct KATANA_EXPORT AutoTuneOptions {
+  /// Use the plan stored for the graph by an earlier tuning if there is one
+  bool reuse_stored{true};
+  /// Store the plan chosen with the graph, so later runs can reuse it
+  bool store{true};
+  /// Graphs with more nodes are calibrated on a connected sample of this
+  /// many nodes rather than the whole graph
+  uint64_t max_sample_nodes{uint64_t{1} << 20};
+  /// The number of timed runs of each candidate plan; the fastest counts
+  uint32_t runs{2};
+};
+
+/// Choose the BFS plan, algorithm and parameters, that runs fastest on pg.
+/// Each candidate plan is run from the node of highest degree of pg, or of a
+/// sample of pg if it is large (see AutoTuneOptions), and the fastest is
+/// returned. The choice is stored in the directory of the RDG that pg was
+/// loaded from, if any, and reused by later calls for the same graph instead
+/// of calibrating again.
+KATANA_EXPORT Result<BfsPlan> AutoTuneBfsPlan(
+    PropertyGraph* pg, const AutoTuneOptions& options = {});
+
+/// Choose the SSSP plan that runs fastest on pg with the edge weights in the
+/// property named edge_weight_property_name. See AutoTuneBfsPlan.
+KATANA_EXPORT Result<SsspPlan> AutoTuneSsspPlan(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const AutoTuneOptions& options = {});
+
+/// Choose the connected components plan that runs fastest on pg, which is
+/// expected to be symmetric. See AutoTuneBfsPlan.
+KATANA_EXPORT Result<ConnectedComponentsPlan> AutoTuneConnectedComponentsPlan(
+    PropertyGraph* pg, const AutoTuneOptions& options = {});
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,139 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_CHECKPOINT_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_CHECKPOINT_H_
+
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "katana/NUMAArray.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana::analytics {
+
+/// Saves the state of an iterative analytics routine every few rounds, so
+/// that a run that is killed, e.g., when a spot instance is preempted,
+/// resumes from its last checkpoint instead of from the start.
+///
+/// A routine names its run with a key that identifies its input and
+/// parameters, adds the buffers that hold its state between rounds (node
+/// arrays, frontier bits, round counters), calls Restore before its first
+/// round and Save after every round:
+///
+/// \code
+/// checkpointer->Begin(fmt::format("Pagerank-{}", pg->num_nodes()));
+/// checkpointer->Add("rank", &rank);
+/// checkpointer->Add("round", &round);
+/// KATANA_CHECKED(checkpointer->Restore());
+/// for (; round < max_rounds; ++round) {
+///   ...
+///   KATANA_CHECKED(checkpointer->Save(round + 1));
+/// }
+/// KATANA_CHECKED(checkpointer->Complete());
+/// \endcode
+///
+/// Save copies the buffers into memory mapped tsuba::FileFrames and
+/// returns; a background task stores them with a tsuba::WriteGroup while
+/// the routine computes its next rounds. A checkpoint is committed by
+/// writing its manifest after all of its files are stored, so a run killed
+/// while a checkpoint is written resumes from the one before. When the
+/// previous checkpoint is still being written as the next one is due, the
+/// new one is skipped rather than waiting for storage.
+///
+/// Checkpoints go to a directory that tsuba can write to, e.g., a local
+/// directory or an s3:// prefix. A checkpointer is used by one routine at a
+/// time, usually through AnalyticsContext::SetCheckpointer.
+class KATANA_EXPORT Checkpointer {
+public:
+  /// \param directory where checkpoints are written
+  /// \param interval save every interval-th round
+  static Result<std::unique_ptr<Checkpointer>> Make(
+      const std::string& directory, uint32_t interval = 1);
+
+  Checkpointer(const Checkpointer&) = delete;
+  Checkpointer& operator=(const Checkpointer&) = delete;
+
+  /// Waits for the checkpoint being written, if any
+  ~Checkpointer();
+
+  /// Start a run of a routine: forget the buffers of the previous run. Runs
+  /// with the same key resume each other's checkpoints, so the key must
+  /// change with anything the saved state depends on, e.g., the size of the
+  /// graph or the parameters of the routine. Keys are used in file names.
+  void Begin(const std::string& key);
+
+  /// Save and restore size bytes at data
+  void AddBuffer(const std::string& name, void* data, size_t size);
+
+  template <typename T>
+  void Add(const std::string& name, NUMAArray<T>* array) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    AddBuffer(name, array->data(), array->size() * sizeof(T));
+  }
+
+  template <
+      typename T,
+      typename = std::enable_if_t<std::is_trivially_copyable_v<T>>>
+  void Add(const std::string& name, T* value) {
+    AddBuffer(name, value, sizeof(T));
+  }
+
+  /// Fill the buffers from the last committed checkpoint of the key, if
+  /// there is one. Returns whether there was. A checkpoint whose buffers
+  /// differ from the ones added is an error.
+  Result<bool> Restore();
+
+  /// Checkpoint the buffers after round, if round is a multiple of the
+  /// interval and the previous checkpoint has been written. Returns the
+  /// error of the previous checkpoint, if it failed.
+  Result<void> Save(uint64_t round);
+
+  /// Wait until the checkpoint being written, if any, is committed, e.g.,
+  /// before returning from a cancelled run.
+  Result<void> Wait();
+
+  /// Wait and delete the checkpoint of the key, once a run has finished.
+  Result<void> Complete();
+
+  const std::string& directory() const { return directory_; }
+  uint32_t interval() const { return interval_; }
+
+  /// The number of checkpoints started and skipped, for tests and tuning
+  uint64_t num_saved() const { return num_saved_; }
+  uint64_t num_skipped() const { return num_skipped_; }
+
+private:
+  struct Buffer {
+    std::string name;
+    void* data;
+    size_t size;
+  };
+
+  Checkpointer(std::string directory, uint32_t interval)
+      : directory_(std::move(directory)), interval_(interval) {}
+
+  std::string ManifestUri() const;
+  std::string FileName(uint64_t sequence, const std::string& buffer) const;
+
+  std::string directory_;
+  uint32_t interval_;
+  std::string key_;
+  std::vector<Buffer> buffers_;
+  // The sequence number of the last committed checkpoint of key_, whose
+  // files are deleted once the next one is committed
+  uint64_t sequence_{0};
+  bool has_committed_{false};
+  uint64_t next_sequence_{0};
+  // The sequence number of the checkpoint in flight
+  uint64_t pending_sequence_{0};
+  std::future<CopyableResult<void>> in_flight_;
+  uint64_t num_saved_{0};
+  uint64_t num_skipped_{0};
+};
+
+}  // namespace katana::analytics
+
+#endif
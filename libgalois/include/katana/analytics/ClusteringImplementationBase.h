@@ -20,13 +20,22 @@
 #ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_CLUSTERINGIMPLEMENTATIONBASE_H_
 #define KATANA_LIBGALOIS_KATANA_ANALYTICS_CLUSTERINGIMPLEMENTATIONBASE_H_
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <map>
 #include <random>
+#include <utility>
+#include <vector>
 
 #include "katana/AtomicHelpers.h"
 #include "katana/Galois.h"
+#include "katana/GraphTopology.h"
 #include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/NarrowEdgeWeights.h"
 #include "katana/analytics/Utils.h"
 
 namespace katana::analytics {
@@ -48,6 +57,190 @@ using DegreeWeight = katana::PODProperty<EdgeWeightType>;
 template <typename EdgeWeightType>
 using EdgeWeight = katana::PODProperty<EdgeWeightType>;
 
+/// Make array hold at least size elements, reallocating it only if it is
+/// too small. The elements are not initialized.
+template <typename T>
+void
+EnsureCapacity(katana::NUMAArray<T>* array, size_t size) {
+  if (array->size() < size) {
+    array->deallocate();
+    array->allocateInterleaved(size);
+  }
+}
+
+/**
+ * The graph of one level of a multi-level clustering: a weighted CSR
+ * topology and the node data of the clustering, with the part of the
+ * TypedPropertyGraph interface that ClusteringImplementationBase uses.
+ *
+ * The arrays are only reallocated when a level does not fit in them. Levels
+ * only get smaller, so alternating between two of these graphs while
+ * coarsening allocates memory for the first two levels only.
+ */
+template <typename EdgeWeightType>
+class ClusteringLevelGraph {
+public:
+  using Node = katana::GraphTopology::Node;
+  using Edge = katana::GraphTopology::Edge;
+  using node_iterator = katana::GraphTopology::node_iterator;
+  using edge_iterator = katana::GraphTopology::edge_iterator;
+  using iterator = node_iterator;
+
+  /// Copy the topology of pg and the edge weights in property
+  /// edge_weight_property_name. The weights are packed into 8 or 16 bits
+  /// when that changes none of them by more than edge_weight_tolerance.
+  static katana::Result<ClusteringLevelGraph> Make(
+      katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+      double edge_weight_tolerance = 0) {
+    using WeightGraph = katana::TypedPropertyGraph<
+        std::tuple<>, std::tuple<EdgeWeight<EdgeWeightType>>>;
+    auto weight_graph = KATANA_CHECKED(
+        WeightGraph::Make(pg, {}, {edge_weight_property_name}));
+    const katana::GraphTopology& topology = pg->topology();
+
+    ClusteringLevelGraph graph;
+    graph.ResizeNodes(topology.num_nodes());
+    graph.narrow_weights_ = NarrowEdgeWeights<EdgeWeightType>::Make(
+        topology.num_edges(),
+        [&](Edge e) -> EdgeWeightType {
+          return weight_graph
+              .template GetEdgeData<EdgeWeight<EdgeWeightType>>(e);
+        },
+        edge_weight_tolerance);
+    const bool packed = graph.narrow_weights_.width() > 0;
+    EnsureCapacity(&graph.dests_, topology.num_edges());
+    if (!packed) {
+      EnsureCapacity(&graph.weights_, topology.num_edges());
+    }
+    graph.num_edges_ = topology.num_edges();
+    katana::do_all(
+        katana::iterate(topology),
+        [&](Node n) { graph.adj_indices_[n] = topology.adj_data()[n]; },
+        katana::no_stats());
+    katana::do_all(
+        katana::iterate(topology.all_edges()),
+        [&](Edge e) {
+          graph.dests_[e] = topology.dest_data()[e];
+          if (!packed) {
+            graph.weights_[e] =
+                weight_graph.template GetEdgeData<EdgeWeight<EdgeWeightType>>(
+                    e);
+          }
+        },
+        katana::no_stats());
+    return katana::Result<ClusteringLevelGraph>(std::move(graph));
+  }
+
+  /// Make room for num_nodes nodes. Adjacency indices and node data are
+  /// kept if the arrays are large enough.
+  void ResizeNodes(uint64_t num_nodes) {
+    EnsureCapacity(&adj_indices_, num_nodes);
+    EnsureCapacity(&previous_community_, num_nodes);
+    EnsureCapacity(&current_community_, num_nodes);
+    EnsureCapacity(&degree_weight_, num_nodes);
+    num_nodes_ = num_nodes;
+  }
+
+  /// Make room for num_edges edges. Their weights are not packed.
+  void ResizeEdges(uint64_t num_edges) {
+    narrow_weights_ = {};
+    EnsureCapacity(&dests_, num_edges);
+    EnsureCapacity(&weights_, num_edges);
+    num_edges_ = num_edges;
+  }
+
+  uint64_t num_nodes() const { return num_nodes_; }
+  uint64_t num_edges() const { return num_edges_; }
+  size_t size() const { return num_nodes_; }
+  bool empty() const { return num_nodes_ == 0; }
+
+  node_iterator begin() const { return node_iterator(0); }
+  node_iterator end() const { return node_iterator(num_nodes_); }
+
+  edge_iterator edge_begin(Node n) const {
+    return edge_iterator(n == 0 ? 0 : adj_indices_[n - 1]);
+  }
+  edge_iterator edge_end(Node n) const {
+    return edge_iterator(adj_indices_[n]);
+  }
+
+  node_iterator GetEdgeDest(const edge_iterator& e) const {
+    return node_iterator(dests_[*e]);
+  }
+
+  template <typename NodeIndex>
+  auto& GetData(Node n) {
+    return NodeArray<NodeIndex>(this)[n];
+  }
+  template <typename NodeIndex>
+  const auto& GetData(Node n) const {
+    return NodeArray<NodeIndex>(this)[n];
+  }
+  template <typename NodeIndex>
+  auto& GetData(const node_iterator& n) {
+    return GetData<NodeIndex>(*n);
+  }
+  template <typename NodeIndex>
+  const auto& GetData(const node_iterator& n) const {
+    return GetData<NodeIndex>(*n);
+  }
+
+  /// The weight of edge e, decoded if the weights are packed
+  template <typename EdgeIndex>
+  EdgeWeightType GetEdgeData(const edge_iterator& e) const {
+    static_assert(std::is_same_v<EdgeIndex, EdgeWeight<EdgeWeightType>>);
+    if (narrow_weights_.width() > 0) {
+      return narrow_weights_[*e];
+    }
+    return weights_[*e];
+  }
+
+  /// End of the edges of each node, as in GraphTopology
+  katana::NUMAArray<Edge>& adj_indices() { return adj_indices_; }
+  katana::NUMAArray<Node>& dests() { return dests_; }
+  /// The unpacked weights, as written by the coarsening of a finer level
+  katana::NUMAArray<EdgeWeightType>& weights() { return weights_; }
+
+private:
+  template <typename NodeIndex, typename Self>
+  static auto& NodeArray(Self* self) {
+    if constexpr (std::is_same_v<NodeIndex, PreviousCommunityID>) {
+      return self->previous_community_;
+    } else if constexpr (std::is_same_v<NodeIndex, CurrentCommunityID>) {
+      return self->current_community_;
+    } else {
+      static_assert(
+          std::is_same_v<NodeIndex, DegreeWeight<EdgeWeightType>>,
+          "unknown node property");
+      return self->degree_weight_;
+    }
+  }
+
+  katana::NUMAArray<Edge> adj_indices_;
+  katana::NUMAArray<Node> dests_;
+  katana::NUMAArray<EdgeWeightType> weights_;
+  NarrowEdgeWeights<EdgeWeightType> narrow_weights_;
+  katana::NUMAArray<uint64_t> previous_community_;
+  katana::NUMAArray<uint64_t> current_community_;
+  katana::NUMAArray<EdgeWeightType> degree_weight_;
+  uint64_t num_nodes_{0};
+  uint64_t num_edges_{0};
+};
+
+/// Scratch space of ClusteringImplementationBase::GraphCoarsening, kept from
+/// one level to the next
+template <typename EdgeWeightType>
+struct ClusteringCoarseningBuffers {
+  /// Start of the members of each cluster in members
+  katana::NUMAArray<uint64_t> member_offsets;
+  /// The nodes of the finer graph grouped by cluster
+  katana::NUMAArray<uint32_t> members;
+  /// Start of the merged edges of each cluster in dests and weights
+  katana::NUMAArray<uint64_t> edge_offsets;
+  katana::NUMAArray<uint32_t> dests;
+  katana::NUMAArray<EdgeWeightType> weights;
+};
+
 template <typename _Graph, typename _EdgeType, typename _CommunityType>
 struct ClusteringImplementationBase {
   using Graph = _Graph;
@@ -166,6 +359,29 @@ struct ClusteringImplementationBase {
     return;
   }
 
+  /**
+   * Starts every node in the cluster given by its PreviousCommunityID
+   * and sums up the degree weight and size of the clusters. Expects
+   * the degree weights set by SumVertexDegreeWeight.
+   */
+  template <typename EdgeWeightType>
+  void InitClustersFromPrevious(Graph* graph, CommunityArray& c_info) {
+    katana::do_all(katana::iterate(*graph), [&](GNode n) {
+      c_info[n].degree_wt = 0;
+      c_info[n].size = 0;
+    });
+    katana::do_all(katana::iterate(*graph), [&](GNode n) {
+      uint64_t n_data_prev_comm_id =
+          graph->template GetData<PreviousCommunityID>(n);
+      KATANA_LOG_DEBUG_ASSERT(n_data_prev_comm_id < graph->num_nodes());
+      graph->template GetData<CurrentCommunityID>(n) = n_data_prev_comm_id;
+      katana::atomicAdd(
+          c_info[n_data_prev_comm_id].degree_wt,
+          graph->template GetData<DegreeWeight<EdgeWeightType>>(n));
+      katana::atomicAdd(c_info[n_data_prev_comm_id].size, uint64_t{1});
+    });
+  }
+
   /**
    * Computes the constant term 1/(2 * total internal edge weight)
    * of the current coarsened graph.
@@ -399,27 +615,44 @@ struct ClusteringImplementationBase {
   /**
  * Renumbers the cluster to contiguous cluster ids
  * to fill the holes in the cluster id assignments.
+ * Clusters (NodePropType) are numbered in the order of
+ * their first node.
  */
+  template <typename NodePropType = CurrentCommunityID>
   uint64_t RenumberClustersContiguously(Graph* graph) {
-    std::map<uint64_t, uint64_t> cluster_local_map;
-    uint64_t num_unique_clusters = 0;
+    const uint64_t num_nodes = graph->num_nodes();
+    if (num_nodes == 0) {
+      return 0;
+    }
 
-    for (GNode n = 0; n < graph->num_nodes(); ++n) {
-      auto& n_data_curr_comm_id =
-          graph->template GetData<CurrentCommunityID>(n);
-      if (n_data_curr_comm_id != UNASSIGNED) {
-        KATANA_LOG_DEBUG_ASSERT(n_data_curr_comm_id < graph->num_nodes());
-        auto stored_already = cluster_local_map.find(n_data_curr_comm_id);
-        if (stored_already != cluster_local_map.end()) {
-          n_data_curr_comm_id = stored_already->second;
-        } else {
-          cluster_local_map[n_data_curr_comm_id] = num_unique_clusters;
-          n_data_curr_comm_id = num_unique_clusters;
-          num_unique_clusters++;
-        }
+    katana::NUMAArray<std::atomic<uint64_t>> first_node;
+    first_node.allocateBlocked(num_nodes);
+    katana::NUMAArray<uint64_t> rank;
+    rank.allocateBlocked(num_nodes);
+
+    katana::do_all(katana::iterate(*graph), [&](GNode n) {
+      first_node[n] = num_nodes;
+    });
+    katana::do_all(katana::iterate(*graph), [&](GNode n) {
+      uint64_t c = graph->template GetData<NodePropType>(n);
+      if (c != UNASSIGNED) {
+        KATANA_LOG_DEBUG_ASSERT(c < num_nodes);
+        katana::atomicMin(first_node[c], uint64_t{n});
       }
-    }
-    return num_unique_clusters;
+    });
+    katana::do_all(katana::iterate(*graph), [&](GNode n) {
+      uint64_t c = graph->template GetData<NodePropType>(n);
+      rank[n] = (c != UNASSIGNED && first_node[c] == n) ? 1 : 0;
+    });
+    katana::ParallelSTL::partial_sum(rank.begin(), rank.end(), rank.begin());
+
+    katana::do_all(katana::iterate(*graph), [&](GNode n) {
+      auto& n_data_comm_id = graph->template GetData<NodePropType>(n);
+      if (n_data_comm_id != UNASSIGNED) {
+        n_data_comm_id = rank[first_node[n_data_comm_id]] - 1;
+      }
+    });
+    return rank[num_nodes - 1];
   }
 
   template <typename EdgeWeightType>
@@ -436,239 +669,270 @@ struct ClusteringImplementationBase {
         CalModularityFinal<Graph, EdgeWeightType, CurrentCommunityID>(graph);
   }
 
-  /**
- * Creates a duplicate of the graph by copying the
- * graph (pfg_from) topology as well as edge property
- * (read from the underlying RDG) to the in-memory
- * temporary graph (pfg_to).
- */
-  template <typename NodeData>
-  katana::Result<std::unique_ptr<katana::PropertyGraph>> DuplicateGraph(
-      katana::PropertyGraph* pfg_from, const std::string& edge_property_name,
-      const std::string& new_edge_property_name) {
-    const katana::GraphTopology& topology_from = pfg_from->topology();
-
-    katana::GraphTopology topo_copy = GraphTopology::Copy(topology_from);
-
-    auto pfg_to_res = katana::PropertyGraph::Make(std::move(topo_copy));
-    if (!pfg_to_res) {
-      return pfg_to_res.error();
-    }
-
-    std::unique_ptr<katana::PropertyGraph> pfg_to =
-        std::move(pfg_to_res.value());
-
-    // Remove the existing edge property
-    if (pfg_to->HasEdgeProperty(new_edge_property_name)) {
-      if (auto r = pfg_to->RemoveEdgeProperty(new_edge_property_name); !r) {
-        return r.error();
-      }
-    }
-    // Copy edge properties
-    using ArrowType = typename arrow::CTypeTraits<EdgeTy>::ArrowType;
-    auto edge_property_result =
-        pfg_from->GetEdgePropertyTyped<EdgeTy>(edge_property_name);
-    if (!edge_property_result) {
-      return edge_property_result.error();
-    }
-    auto edge_property = edge_property_result.value();
-    std::vector<std::shared_ptr<arrow::Field>> fields;
-    std::vector<std::shared_ptr<arrow::Array>> columns;
-    fields.emplace_back(
-        arrow::field((new_edge_property_name), std::make_shared<ArrowType>()));
-    columns.emplace_back(edge_property);
-    auto edge_data_table = arrow::Table::Make(arrow::schema(fields), columns);
-    if (auto r = pfg_to->AddEdgeProperties(edge_data_table); !r) {
-      return r.error();
-    }
-
-    if (auto result = ConstructNodeProperties<NodeData>(pfg_to.get());
-        !result) {
-      return result.error();
-    }
-
-    return std::unique_ptr<katana::PropertyGraph>(std::move(pfg_to));
-  }
-
   /**
  * Creates a coarsened hierarchical graph for the next phase
- * of the clustering algorithm. It merges all the nodes within a
- * same cluster to form a super node for the coursened graphs.
- * The total number of nodes in the coarsened graph are equal to
- * the number of unique clusters in the previous level of the graph.
- * All the edges inside a cluster are merged (edge weights are summed
- * up) to form the edges within super nodes.
+ * of the clustering algorithm in graph_next. It merges all the nodes
+ * within a same cluster (NodePropType) to form a super node for the
+ * coarsened graphs. The total number of nodes in the coarsened graph
+ * are equal to the number of unique clusters in the previous level of
+ * the graph, which must be numbered contiguously. All the edges inside
+ * a cluster are merged (edge weights are summed up) to form the edges
+ * within super nodes. The PreviousCommunityID of a super node is the
+ * CurrentCommunityID of its nodes.
+ *
+ * graph_next and buffers are only reallocated when they are too small,
+ * so levels after the first two reuse the memory of earlier ones.
  */
-  template <typename NodeData, typename EdgeData, typename EdgeWeightType>
-  katana::Result<std::unique_ptr<katana::PropertyGraph>> GraphCoarsening(
-      const Graph& graph, katana::PropertyGraph* pfg_mutable,
-      uint64_t num_unique_clusters,
-      const std::vector<std::string>& temp_node_property_names,
-      const std::vector<std::string>& temp_edge_property_names) {
-    using GNode = typename Graph::Node;
-
+  template <typename EdgeWeightType, typename NodePropType = CurrentCommunityID>
+  static void GraphCoarsening(
+      const Graph& graph, uint64_t num_unique_clusters,
+      ClusteringCoarseningBuffers<EdgeTy>* buffers, Graph* graph_next) {
     katana::StatTimer TimerGraphBuild("Timer_Graph_build");
-    TimerGraphBuild.start();
+    katana::TimerGuard TimerGraphBuildGuard(TimerGraphBuild);
 
     const uint64_t num_nodes_next = num_unique_clusters;
-
-    std::vector<std::vector<GNode>> cluster_bags(num_unique_clusters);
-    // TODO(amber): This loop can be parallelized when using a concurrent container
-    // for cluster_bags, but something like katana::InsertBag exhausts the
-    // per-thread-storage memory
-    for (GNode n = 0; n < graph.num_nodes(); ++n) {
-      auto n_data_curr_comm_id = graph.template GetData<CurrentCommunityID>(n);
-      if (n_data_curr_comm_id != UNASSIGNED) {
-        cluster_bags[n_data_curr_comm_id].push_back(n);
+    auto& member_offsets = buffers->member_offsets;
+    auto& members = buffers->members;
+    auto& edge_offsets = buffers->edge_offsets;
+    EnsureCapacity(&member_offsets, num_nodes_next + 1);
+    EnsureCapacity(&edge_offsets, num_nodes_next + 1);
+    EnsureCapacity(&members, graph.num_nodes());
+
+    /* Group the nodes by cluster with a counting sort */
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_next + 1),
+        [&](uint64_t c) {
+          member_offsets[c] = 0;
+          edge_offsets[c] = 0;
+        },
+        katana::no_stats());
+    katana::do_all(katana::iterate(graph), [&](GNode n) {
+      uint64_t c = graph.template GetData<NodePropType>(n);
+      if (c != UNASSIGNED) {
+        KATANA_LOG_DEBUG_ASSERT(c < num_nodes_next);
+        __sync_fetch_and_add(&member_offsets[c + 1], uint64_t{1});
       }
-    }
-
-    std::vector<katana::gstl::Vector<uint32_t>> edges_id(num_unique_clusters);
-    std::vector<katana::gstl::Vector<EdgeTy>> edges_data(num_unique_clusters);
+    });
+    katana::ParallelSTL::partial_sum(
+        member_offsets.begin(), member_offsets.begin() + num_nodes_next + 1,
+        member_offsets.begin());
+    // edge_offsets count the members placed so far until they are replaced
+    // by the edge counts below
+    katana::do_all(katana::iterate(graph), [&](GNode n) {
+      uint64_t c = graph.template GetData<NodePropType>(n);
+      if (c != UNASSIGNED) {
+        members[member_offsets[c] +
+                __sync_fetch_and_add(&edge_offsets[c], uint64_t{1})] = n;
+      }
+    });
 
-    /* First pass to find the number of edges */
+    /* Bound the number of merged edges of each cluster by its degree */
     katana::do_all(
-        katana::iterate(uint64_t{0}, num_unique_clusters),
+        katana::iterate(uint64_t{0}, num_nodes_next),
         [&](uint64_t c) {
-          katana::gstl::Map<uint64_t, uint64_t> cluster_local_map;
-          uint64_t num_unique_clusters = 0;
-          for (auto node : cluster_bags[c]) {
-            KATANA_LOG_DEBUG_ASSERT(
-                graph.template GetData<CurrentCommunityID>(node) ==
-                c);  // All nodes in this bag must have same cluster id
-
+          // Sort the members so that weights are summed in a fixed order
+          std::sort(
+              members.begin() + member_offsets[c],
+              members.begin() + member_offsets[c + 1]);
+          uint64_t degree = 0;
+          for (uint64_t i = member_offsets[c]; i < member_offsets[c + 1];
+               ++i) {
+            degree += std::distance(
+                graph.edge_begin(members[i]), graph.edge_end(members[i]));
+          }
+          edge_offsets[c] = degree;
+        },
+        katana::steal(), katana::loopname("BuildGraph: Group nodes"));
+    std::rotate(
+        edge_offsets.begin(), edge_offsets.begin() + num_nodes_next,
+        edge_offsets.begin() + num_nodes_next + 1);
+    edge_offsets[0] = 0;
+    katana::ParallelSTL::partial_sum(
+        edge_offsets.begin(), edge_offsets.begin() + num_nodes_next + 1,
+        edge_offsets.begin());
+    EnsureCapacity(&buffers->dests, edge_offsets[num_nodes_next]);
+    EnsureCapacity(&buffers->weights, edge_offsets[num_nodes_next]);
+
+    /* Merge the edges of each cluster into one per neighboring cluster */
+    graph_next->ResizeNodes(num_nodes_next);
+    auto& adj_indices_next = graph_next->adj_indices();
+    katana::PerThreadStorage<std::vector<std::pair<uint32_t, EdgeTy>>>
+        edges_local;
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_next),
+        [&](uint64_t c) {
+          auto& edges = *edges_local.getLocal();
+          edges.clear();
+          for (uint64_t i = member_offsets[c]; i < member_offsets[c + 1];
+               ++i) {
+            GNode node = members[i];
             for (auto ii = graph.edge_begin(node); ii != graph.edge_end(node);
                  ++ii) {
-              auto dst = graph.GetEdgeDest(ii);
-              auto dst_data_curr_comm_id =
-                  graph.template GetData<CurrentCommunityID>(dst);
-              KATANA_LOG_DEBUG_ASSERT(dst_data_curr_comm_id != UNASSIGNED);
-              auto stored_already = cluster_local_map.find(
-                  dst_data_curr_comm_id);  // Check if it already exists
-              if (stored_already != cluster_local_map.end()) {
-                edges_data[c][stored_already->second] +=
-                    graph.template GetEdgeData<EdgeWeight<EdgeWeightType>>(ii);
-              } else {
-                cluster_local_map[dst_data_curr_comm_id] = num_unique_clusters;
-                edges_id[c].push_back(dst_data_curr_comm_id);
-                edges_data[c].push_back(
-                    graph.template GetEdgeData<EdgeWeight<EdgeWeightType>>(ii));
-                num_unique_clusters++;
-              }
-            }  // End edge loop
+              auto dst_data_comm_id =
+                  graph.template GetData<NodePropType>(graph.GetEdgeDest(ii));
+              KATANA_LOG_DEBUG_ASSERT(dst_data_comm_id != UNASSIGNED);
+              edges.emplace_back(
+                  dst_data_comm_id,
+                  graph.template GetEdgeData<EdgeWeight<EdgeWeightType>>(ii));
+            }
+          }
+          std::stable_sort(
+              edges.begin(), edges.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+
+          uint64_t num_edges = 0;
+          uint64_t start_index = edge_offsets[c];
+          for (size_t k = 0; k < edges.size(); ++k) {
+            if (k > 0 && edges[k].first == edges[k - 1].first) {
+              buffers->weights[start_index + num_edges - 1] += edges[k].second;
+            } else {
+              buffers->dests[start_index + num_edges] = edges[k].first;
+              buffers->weights[start_index + num_edges] = edges[k].second;
+              num_edges++;
+            }
           }
+          adj_indices_next[c] = num_edges;
+          graph_next->template GetData<PreviousCommunityID>(c) =
+              graph.template GetData<CurrentCommunityID>(
+                  members[member_offsets[c]]);
         },
-        katana::steal(), katana::loopname("BuildGraph: Find edges"));
+        katana::steal(), katana::loopname("BuildGraph: Merge edges"));
 
-    /* Serial loop to reduce all the edge counts */
-    katana::NUMAArray<uint64_t> prefix_edges_count;
-    prefix_edges_count.allocateInterleaved(num_unique_clusters);
+    katana::ParallelSTL::partial_sum(
+        adj_indices_next.begin(), adj_indices_next.begin() + num_nodes_next,
+        adj_indices_next.begin());
+    const uint64_t num_edges_next =
+        num_nodes_next == 0 ? 0 : adj_indices_next[num_nodes_next - 1];
+    graph_next->ResizeEdges(num_edges_next);
 
-    katana::GAccumulator<uint64_t> num_edges_acc;
     katana::do_all(
-        katana::iterate(uint64_t{0}, num_nodes_next), [&](uint64_t c) {
-          prefix_edges_count[c] = edges_id[c].size();
-          num_edges_acc += prefix_edges_count[c];
-        });
+        katana::iterate(uint64_t{0}, num_nodes_next),
+        [&](uint64_t c) {
+          uint64_t start_index = c == 0 ? 0 : adj_indices_next[c - 1];
+          uint64_t number_of_edges = adj_indices_next[c] - start_index;
+          for (uint64_t k = 0; k < number_of_edges; ++k) {
+            graph_next->dests()[start_index + k] =
+                buffers->dests[edge_offsets[c] + k];
+            graph_next->weights()[start_index + k] =
+                buffers->weights[edge_offsets[c] + k];
+          }
+        },
+        katana::loopname("BuildGraph: Compact edges"));
+  }
 
-    const uint64_t num_edges_next = num_edges_acc.reduce();
+  /**
+   * Leiden refinement: splits every cluster (CurrentCommunityID) into
+   * well connected sub-clusters, which are stored in PreviousCommunityID.
+   * Each node starts as a sub-cluster of its own. A node that is still
+   * alone and is well connected to the rest of its cluster moves to the
+   * neighboring sub-cluster of its cluster with the largest positive
+   * modularity gain, if that sub-cluster is well connected as well.
+   * A sub-cluster is identified by one of its nodes.
+   */
+  template <typename EdgeWeightType>
+  void RefineClusters(
+      Graph* graph, CommunityArray& c_info, double constant_for_second_term) {
+    CommunityArray r_info;  // Sub-cluster info
+    r_info.allocateBlocked(graph->num_nodes());
+    // Weight of the edges from each sub-cluster to the rest of its cluster
+    katana::NUMAArray<std::atomic<EdgeTy>> external_wt;
+    external_wt.allocateBlocked(graph->num_nodes());
 
-    katana::ParallelSTL::partial_sum(
-        prefix_edges_count.begin(), prefix_edges_count.end(),
-        prefix_edges_count.begin());
-
-    KATANA_LOG_DEBUG_ASSERT(
-        prefix_edges_count[num_unique_clusters - 1] == num_edges_next);
-    katana::StatTimer TimerConstructFrom("Timer_Construct_From");
-    TimerConstructFrom.start();
-
-    // Remove all the existing node/edge properties
-    for (auto property : temp_node_property_names) {
-      if (pfg_mutable->HasNodeProperty(property)) {
-        if (auto r = pfg_mutable->RemoveNodeProperty(property); !r) {
-          return r.error();
-        }
-      }
-    }
-    for (auto property : temp_edge_property_names) {
-      if (pfg_mutable->HasEdgeProperty(property)) {
-        if (auto r = pfg_mutable->RemoveEdgeProperty(property); !r) {
-          return r.error();
+    katana::do_all(katana::iterate(*graph), [&](GNode n) {
+      uint64_t n_data_curr_comm_id =
+          graph->template GetData<CurrentCommunityID>(n);
+      EdgeTy n_external_wt = 0;
+      for (auto ii = graph->edge_begin(n); ii != graph->edge_end(n); ++ii) {
+        auto dst = graph->GetEdgeDest(ii);
+        if (*dst != n && graph->template GetData<CurrentCommunityID>(dst) ==
+                             n_data_curr_comm_id) {
+          n_external_wt +=
+              graph->template GetEdgeData<EdgeWeight<EdgeWeightType>>(ii);
         }
       }
-    }
-
-    using Node = katana::GraphTopology::Node;
-    using Edge = katana::GraphTopology::Edge;
-
-    katana::NUMAArray<Node> out_dests_next;
-    out_dests_next.allocateInterleaved(num_edges_next);
+      graph->template GetData<PreviousCommunityID>(n) = n;
+      r_info[n].size = 1;
+      r_info[n].degree_wt =
+          graph->template GetData<DegreeWeight<EdgeWeightType>>(n);
+      external_wt[n] = n_external_wt;
+    });
 
-    katana::NUMAArray<EdgeWeightType> edge_data_next;
-    edge_data_next.allocateInterleaved(num_edges_next);
+    // Whether a set with total degree weight a_r and weight e_r of edges
+    // to the rest of a cluster with total degree weight a_c is well
+    // connected to it
+    auto well_connected = [&](double e_r, double a_r, double a_c) {
+      return e_r >= a_r * (a_c - a_r) * constant_for_second_term;
+    };
 
     katana::do_all(
-        katana::iterate(uint64_t{0}, num_nodes_next), [&](uint64_t n) {
-          uint64_t number_of_edges =
-              (n == 0) ? prefix_edges_count[0]
-                       : (prefix_edges_count[n] - prefix_edges_count[n - 1]);
-          uint64_t start_index = (n == 0) ? 0 : prefix_edges_count[n - 1];
-          for (uint64_t k = 0; k < number_of_edges; ++k) {
-            out_dests_next[start_index + k] = edges_id[n][k];
-            edge_data_next[start_index + k] = edges_data[n][k];
+        katana::iterate(*graph),
+        [&](GNode n) {
+          uint64_t n_data_curr_comm_id =
+              graph->template GetData<CurrentCommunityID>(n);
+          EdgeTy n_data_degree_wt =
+              graph->template GetData<DegreeWeight<EdgeWeightType>>(n);
+          EdgeTy n_external_wt = external_wt[n];
+          if (r_info[n].size != 1 ||
+              !well_connected(
+                  n_external_wt, n_data_degree_wt,
+                  c_info[n_data_curr_comm_id].degree_wt)) {
+            return;
           }
-        });
-
-    TimerConstructFrom.stop();
-
-    // TODO(amber): This is a lame attempt at freeing the memory back to each
-    // thread's pool of free pages and blocks. Due to stealing, the execution of
-    // do_all above that populates these containers may be different from the
-    // do_all below that frees them.
-    katana::do_all(
-        katana::iterate(uint64_t{0}, num_unique_clusters), [&](uint64_t c) {
-          edges_id[c] = gstl::Vector<uint32_t>();
-          edges_data[c] = gstl::Vector<EdgeTy>();
-        });
-
-    GraphTopology topo_next{
-        std::move(prefix_edges_count), std::move(out_dests_next)};
-    auto pfg_next_res = katana::PropertyGraph::Make(std::move(topo_next));
 
-    if (!pfg_next_res) {
-      return pfg_next_res.error();
-    }
-    std::unique_ptr<katana::PropertyGraph> pfg_next =
-        std::move(pfg_next_res.value());
-
-    if (auto result = katana::analytics::ConstructNodeProperties<NodeData>(
-            pfg_next.get(), temp_node_property_names);
-        !result) {
-      return result.error();
-    }
+          // Edge weight to each neighboring sub-cluster of the cluster
+          std::map<uint64_t, EdgeTy> sub_cluster_wt;
+          for (auto ii = graph->edge_begin(n); ii != graph->edge_end(n);
+               ++ii) {
+            auto dst = graph->GetEdgeDest(ii);
+            if (*dst != n &&
+                graph->template GetData<CurrentCommunityID>(dst) ==
+                    n_data_curr_comm_id) {
+              sub_cluster_wt[graph->template GetData<PreviousCommunityID>(
+                  dst)] +=
+                  graph->template GetEdgeData<EdgeWeight<EdgeWeightType>>(ii);
+            }
+          }
 
-    if (auto result = katana::analytics::ConstructEdgeProperties<EdgeData>(
-            pfg_next.get(), temp_edge_property_names);
-        !result) {
-      return result.error();
-    }
+          uint64_t max_index = UNASSIGNED;
+          double max_gain = 0;
+          EdgeTy max_wt = 0;
+          for (const auto& [r, wt] : sub_cluster_wt) {
+            if (r == n) {
+              continue;
+            }
+            double ar = r_info[r].degree_wt;
+            if (!well_connected(
+                    external_wt[r], ar,
+                    c_info[n_data_curr_comm_id].degree_wt)) {
+              continue;
+            }
+            double cur_gain =
+                wt - n_data_degree_wt * ar * constant_for_second_term;
+            if (cur_gain > max_gain) {
+              max_gain = cur_gain;
+              max_index = r;
+              max_wt = wt;
+            }
+          }
+          if (max_index == UNASSIGNED) {
+            return;
+          }
 
-    auto graph_result = Graph::Make(pfg_next.get());
-    if (!graph_result) {
-      return graph_result.error();
-    }
-    Graph graph_curr = graph_result.value();
-    // TODO(amber): figure out a better way to add/update the edge property
-    katana::do_all(
-        katana::iterate(Edge{0}, num_edges_next),
-        [&](Edge e) {
-          graph_curr.template GetEdgeData<EdgeWeight<EdgeWeightType>>(e) =
-              edge_data_next[e];
+          // Leave the singleton sub-cluster unless another node joined it
+          uint64_t expected = 1;
+          if (!r_info[n].size.compare_exchange_strong(expected, 0)) {
+            return;
+          }
+          katana::atomicSub(r_info[n].degree_wt, n_data_degree_wt);
+          katana::atomicSub(external_wt[n], n_external_wt);
+
+          katana::atomicAdd(r_info[max_index].size, uint64_t{1});
+          katana::atomicAdd(r_info[max_index].degree_wt, n_data_degree_wt);
+          katana::atomicAdd(
+              external_wt[max_index], EdgeTy(n_external_wt - 2 * max_wt));
+          graph->template GetData<PreviousCommunityID>(n) = max_index;
         },
-        katana::no_stats());
-
-    TimerGraphBuild.stop();
-    return std::unique_ptr<katana::PropertyGraph>(std::move(pfg_next));
+        katana::steal(), katana::loopname("leiden algo: Refinement"));
   }
 };
 }  // namespace katana::analytics
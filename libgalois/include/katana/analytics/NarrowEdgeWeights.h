@@ -0,0 +1,294 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_NARROWEDGEWEIGHTS_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_NARROWEDGEWEIGHTS_H_
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <type_traits>
+
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/Reduction.h"
+
+namespace katana::analytics {
+
+namespace internal {
+
+template <typename Weight, bool Integral = std::is_integral_v<Weight>>
+struct NarrowArithmetic {
+  using type = Weight;
+};
+
+/// Integer weights are decoded in unsigned arithmetic, which wraps around
+/// instead of overflowing when the range of the weights does not fit in a
+/// signed type
+template <typename Weight>
+struct NarrowArithmetic<Weight, true> {
+  using type = std::make_unsigned_t<Weight>;
+};
+
+}  // namespace internal
+
+/// Edge weights packed into 8 or 16 bit codes, indexed by edge like the
+/// destinations of a topology, so that weighted edge scans read a quarter or
+/// a half of the memory of 32 or 64 bit weights. The weight of edge e is
+/// offset + scale * code[e].
+template <typename Weight>
+class NarrowEdgeWeights {
+  static_assert(std::is_integral_v<Weight> || std::is_floating_point_v<Weight>);
+
+  using Arithmetic = typename internal::NarrowArithmetic<Weight>::type;
+
+public:
+  /// The weights decoded from codes of type Code; it indexes like an array
+  /// of weights so kernels can take either
+  template <typename Code>
+  class View {
+  public:
+    View(const Code* codes, Arithmetic offset, Arithmetic scale)
+        : codes_(codes), offset_(offset), scale_(scale) {}
+
+    Weight operator[](uint64_t e) const {
+      return static_cast<Weight>(
+          offset_ + scale_ * static_cast<Arithmetic>(codes_[e]));
+    }
+
+  private:
+    const Code* codes_;
+    Arithmetic offset_;
+    Arithmetic scale_;
+  };
+
+  NarrowEdgeWeights() = default;
+
+  /// Pack the weights weight(e) of the edges e in [0, num_edges) into the
+  /// narrowest codes that reproduce each weight within tolerance, or leave
+  /// them unpacked if 16 bits are not enough. Weights that are integers,
+  /// also in floating point columns, are first tried on the exact grid of
+  /// their greatest common difference; with a positive tolerance, weights
+  /// are then rounded to evenly spaced codes between their minimum and
+  /// maximum.
+  template <typename WeightFn>
+  static NarrowEdgeWeights Make(
+      uint64_t num_edges, const WeightFn& weight, double tolerance = 0) {
+    NarrowEdgeWeights ret;
+    if (num_edges == 0) {
+      return ret;
+    }
+
+    Summary summary = Summarize(num_edges, weight);
+    if (summary.finite &&
+        !ret.TryPack<uint8_t>(num_edges, weight, tolerance, summary)) {
+      ret.TryPack<uint16_t>(num_edges, weight, tolerance, summary);
+    }
+    return ret;
+  }
+
+  /// The number of bits of a code: 8 or 16, or 0 if the weights are not
+  /// packed
+  unsigned width() const { return width_; }
+
+  /// The largest difference between a weight and its decoded value
+  double max_error() const { return max_error_; }
+
+  /// The weight of edge e; the packed weights must not be empty. Kernels
+  /// that are instantiated for the width should prefer Visit.
+  Weight operator[](uint64_t e) const {
+    if (width_ == 8) {
+      return View<uint8_t>(codes8_.data(), offset_, scale_)[e];
+    }
+    return View<uint16_t>(codes16_.data(), offset_, scale_)[e];
+  }
+
+  /// Return fn(&view) with the View of the packed weights or, if they are
+  /// not packed, fn(full), where full indexes the weights by edge
+  template <typename Full, typename Fn>
+  auto Visit(Full* full, const Fn& fn) const {
+    if (width_ == 8) {
+      View<uint8_t> view(codes8_.data(), offset_, scale_);
+      return fn(&view);
+    }
+    if (width_ == 16) {
+      View<uint16_t> view(codes16_.data(), offset_, scale_);
+      return fn(&view);
+    }
+    return fn(full);
+  }
+
+private:
+  struct Summary {
+    Weight min;
+    Weight max;
+    /// Greatest common divisor of the differences between the weights if
+    /// they are integral
+    uint64_t gcd;
+    /// Whether all weights are integers, small enough for their differences
+    /// to be exact in double if they are floating point
+    bool integral;
+    bool finite;
+  };
+
+  /// |a - b|, exactly for integers
+  static uint64_t IntegralDistance(Weight a, Weight b) {
+    if constexpr (std::is_integral_v<Weight>) {
+      return a < b ? static_cast<Arithmetic>(b) - static_cast<Arithmetic>(a)
+                   : static_cast<Arithmetic>(a) - static_cast<Arithmetic>(b);
+    } else {
+      return static_cast<uint64_t>(
+          std::abs(static_cast<double>(a) - static_cast<double>(b)));
+    }
+  }
+
+  static double Distance(Weight a, Weight b) {
+    if constexpr (std::is_integral_v<Weight>) {
+      return static_cast<double>(IntegralDistance(a, b));
+    } else {
+      return std::abs(static_cast<double>(a) - static_cast<double>(b));
+    }
+  }
+
+  template <typename WeightFn>
+  static Summary Summarize(uint64_t num_edges, const WeightFn& weight) {
+    constexpr double kMaxIntegral =
+        1ULL << (std::numeric_limits<double>::digits - 1);
+
+    const Weight first = weight(0);
+    auto merge = [](const Summary& a, const Summary& b) {
+      return Summary{
+          std::min(a.min, b.min), std::max(a.max, b.max),
+          std::gcd(a.gcd, b.gcd), a.integral && b.integral,
+          a.finite && b.finite};
+    };
+    auto identity = [first]() {
+      return Summary{first, first, 0, true, true};
+    };
+    auto summary = katana::make_reducible(merge, identity);
+
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_edges),
+        [&](uint64_t e) {
+          Weight w = weight(e);
+          Summary& local = summary.getLocal();
+          if constexpr (std::is_floating_point_v<Weight>) {
+            if (!std::isfinite(w)) {
+              local.finite = false;
+              return;
+            }
+            if (w != std::trunc(w) || std::abs(w) >= kMaxIntegral ||
+                std::abs(first) >= kMaxIntegral) {
+              local.integral = false;
+            }
+          }
+          local.min = std::min(local.min, w);
+          local.max = std::max(local.max, w);
+          if (local.integral) {
+            local.gcd = std::gcd(local.gcd, IntegralDistance(w, first));
+          }
+        },
+        katana::no_stats());
+    return summary.reduce();
+  }
+
+  template <typename Code, typename WeightFn>
+  bool TryPack(
+      uint64_t num_edges, const WeightFn& weight, double tolerance,
+      const Summary& summary) {
+    constexpr uint64_t kMaxCode = std::numeric_limits<Code>::max();
+    const Arithmetic offset = static_cast<Arithmetic>(summary.min);
+
+    // The exact grid: every weight is min + k * gcd
+    if (summary.min == summary.max) {
+      return Encode<Code>(num_edges, weight, tolerance, offset, 1);
+    }
+    if (summary.integral &&
+        IntegralDistance(summary.max, summary.min) / summary.gcd <= kMaxCode &&
+        Encode<Code>(
+            num_edges, weight, tolerance, offset,
+            static_cast<Arithmetic>(summary.gcd))) {
+      return true;
+    }
+
+    // The rounded grid: kMaxCode + 1 evenly spaced weights from min to max
+    if (tolerance <= 0) {
+      return false;
+    }
+    Arithmetic scale;
+    if constexpr (std::is_integral_v<Weight>) {
+      uint64_t range = IntegralDistance(summary.max, summary.min);
+      scale = static_cast<Arithmetic>(range / kMaxCode + 1);
+    } else {
+      scale = static_cast<Arithmetic>(
+          Distance(summary.max, summary.min) / kMaxCode);
+    }
+    return scale > 0 &&
+           Encode<Code>(num_edges, weight, tolerance, offset, scale);
+  }
+
+  /// Round each weight to the nearest code and keep the codes if all
+  /// decoded weights are within tolerance
+  template <typename Code, typename WeightFn>
+  bool Encode(
+      uint64_t num_edges, const WeightFn& weight, double tolerance,
+      Arithmetic offset, Arithmetic scale) {
+    constexpr uint64_t kMaxCode = std::numeric_limits<Code>::max();
+
+    katana::NUMAArray<Code> codes;
+    codes.allocateInterleaved(num_edges);
+    View<Code> view(codes.data(), offset, scale);
+    katana::GReduceLogicalOr too_far;
+    auto max_error =
+        katana::make_reducible(katana::gmax<double>(), []() { return 0.0; });
+
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_edges),
+        [&](uint64_t e) {
+          Weight w = weight(e);
+          uint64_t code;
+          if constexpr (std::is_integral_v<Weight>) {
+            Arithmetic d = static_cast<Arithmetic>(w) - offset;
+            code = d / scale + (d % scale > (scale - 1) / 2 ? 1 : 0);
+          } else {
+            code = std::llround(
+                (static_cast<double>(w) - static_cast<double>(offset)) /
+                static_cast<double>(scale));
+          }
+          codes[e] = static_cast<Code>(std::min(code, kMaxCode));
+
+          Weight decoded = view[e];
+          if (decoded != w) {
+            double error = Distance(decoded, w);
+            if (!(error <= tolerance)) {
+              too_far.update(true);
+            }
+            max_error.update(error);
+          }
+        },
+        katana::no_stats());
+
+    if (too_far.reduce()) {
+      return false;
+    }
+    width_ = std::numeric_limits<Code>::digits;
+    offset_ = offset;
+    scale_ = scale;
+    max_error_ = max_error.reduce();
+    if constexpr (std::is_same_v<Code, uint8_t>) {
+      codes8_ = std::move(codes);
+    } else {
+      codes16_ = std::move(codes);
+    }
+    return true;
+  }
+
+  katana::NUMAArray<uint8_t> codes8_;
+  katana::NUMAArray<uint16_t> codes16_;
+  Arithmetic offset_{0};
+  Arithmetic scale_{1};
+  unsigned width_{0};
+  double max_error_{0};
+};
+
+}  // namespace katana::analytics
+
+#endif
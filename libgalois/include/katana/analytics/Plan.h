@@ -1,6 +1,9 @@
 #ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_PLAN_H_
 #define KATANA_LIBGALOIS_KATANA_ANALYTICS_PLAN_H_
 
+#include <string>
+#include <utility>
+
 namespace katana::analytics {
 
 enum Architecture {
@@ -29,6 +32,8 @@ enum Architecture {
 /// larger graph.
 class Plan {
   Architecture architecture_;
+  std::string parallelism_profile_;
+  double edge_weight_tolerance_{0};
 
 protected:
   explicit Plan(Architecture architecture) : architecture_(architecture) {}
@@ -36,6 +41,36 @@ protected:
 public:
   /// The architecture on which the algorithm will run.
   Architecture architecture() const { return architecture_; }
+
+  /// Run calls with this plan on architecture. Algorithms that do not
+  /// implement architecture fail with ErrorCode::NotImplemented.
+  void set_architecture(Architecture architecture) {
+    architecture_ = architecture;
+  }
+
+  /// The file the katana::ParallelismProfile of calls with this plan is
+  /// written to as JSON, or empty to not profile them.
+  const std::string& parallelism_profile() const {
+    return parallelism_profile_;
+  }
+
+  /// Profile the parallelism of calls with this plan into path; profiling
+  /// slows the calls down.
+  void set_parallelism_profile(std::string path) {
+    parallelism_profile_ = std::move(path);
+  }
+
+  /// The largest difference from its edge weight property that a weighted
+  /// algorithm may round an edge weight by to pack the weights into 8 or 16
+  /// bits. With the default, 0, weights are only packed when no weight
+  /// changes.
+  double edge_weight_tolerance() const { return edge_weight_tolerance_; }
+
+  /// Allow weights to be packed with at most tolerance error; results may
+  /// then differ from those with the exact weights.
+  void set_edge_weight_tolerance(double tolerance) {
+    edge_weight_tolerance_ = tolerance;
+  }
 };
 
 }  // namespace katana::analytics
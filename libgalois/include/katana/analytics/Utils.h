@@ -5,10 +5,13 @@
 #include <random>
 #include <utility>
 
+#include "katana/ArrowVisitor.h"
 #include "katana/ErrorCode.h"
+#include "katana/ParallelismProfile.h"
 #include "katana/Properties.h"
 #include "katana/PropertyGraph.h"
 #include "katana/Result.h"
+#include "katana/analytics/Plan.h"
 
 namespace katana::analytics {
 
@@ -28,12 +31,67 @@ public:
 };
 
 //! Used to determine if a graph has power-law degree distribution or not
-//! by sampling some of the vertices in the graph randomly
-//! This code has been copied from GAP benchmark suite
-//! (https://github.com/sbeamer/gapbs/blob/master/src/tc.cc WorthRelabelling())
+//! by sampling some of the vertices in the graph randomly. The answer is
+//! cached with the graph; see GraphProfile::power_law.
 KATANA_EXPORT bool IsApproximateDegreeDistributionPowerLaw(
     const PropertyGraph& graph);
 
+/// Check that the plan targets an architecture the algorithm can run on.
+/// Only kCPU is implemented; algorithms check before creating any property
+/// so that a plan for another architecture, see Plan::set_architecture,
+/// fails rather than silently running on the CPU.
+inline katana::Result<void>
+CheckArchitecture(const Plan& plan) {
+  if (plan.architecture() != kCPU) {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotImplemented, "Unsupported architecture: {}",
+        static_cast<int>(plan.architecture()));
+  }
+  return katana::ResultSuccess();
+}
+
+/// Profile the loops of an analytics call until the returned scope ends if
+/// plan asks for it; see Plan::parallelism_profile.
+inline ParallelismProfile::Scope
+ProfileParallelism(const Plan& plan) {
+  return ParallelismProfile::Scope(plan.parallelism_profile());
+}
+
+/// Call fn with a value of the C++ type of the named edge property, one of
+/// CTypes; see katana::VisitArrowCType. The type is found from the schema,
+/// so an absent property is not loaded first.
+template <typename CTypes = katana::NumericCTypes, typename Fn>
+auto
+DispatchOnEdgePropertyType(
+    const PropertyGraph* pg, const std::string& name, const Fn& fn)
+    -> decltype(fn(typename CTypes::First{})) {
+  std::shared_ptr<arrow::Field> field =
+      pg->full_edge_schema()->GetFieldByName(name);
+  if (!field) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "edge property does not exist: {}",
+        name);
+  }
+  return katana::VisitArrowCType<CTypes>(*field->type(), fn);
+}
+
+/// Call fn with a value of the C++ type of the named node property, one of
+/// CTypes; see DispatchOnEdgePropertyType
+template <typename CTypes = katana::NumericCTypes, typename Fn>
+auto
+DispatchOnNodePropertyType(
+    const PropertyGraph* pg, const std::string& name, const Fn& fn)
+    -> decltype(fn(typename CTypes::First{})) {
+  std::shared_ptr<arrow::Field> field =
+      pg->full_node_schema()->GetFieldByName(name);
+  if (!field) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "node property does not exist: {}",
+        name);
+  }
+  return katana::VisitArrowCType<CTypes>(*field->type(), fn);
+}
+
 template <typename Props>
 std::vector<std::string>
 DefaultPropertyNames() {
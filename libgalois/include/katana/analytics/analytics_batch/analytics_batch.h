@@ -0,0 +1,82 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_ANALYTICSBATCH_ANALYTICSBATCH_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_ANALYTICSBATCH_ANALYTICSBATCH_H_
+
+#include <optional>
+#include <string>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+#include "katana/analytics/pagerank/pagerank.h"
+
+namespace katana::analytics {
+
+/// A batch of node analytics that are computed together, sharing passes over
+/// the edges instead of each scanning the topology and allocating its own
+/// node arrays.
+///
+/// A first pass over the edges computes the degrees, which PageRank needs,
+/// together with the first step of label propagation. Every later pass runs
+/// an iteration of PageRank and of label propagation on each node while
+/// reading its edges once, with the state of both kept next to each other so
+/// that visiting a neighbor touches one cache line. A pass skips an analytic
+/// once it has converged. All the outputs are added to the graph at once, at
+/// the end, so either every requested property is created or none is.
+///
+/// Analytics with other access patterns, such as k-core or triangle
+/// counting, do not share passes and are not part of a batch.
+///
+/// \code
+/// katana::analytics::AnalyticsBatch batch;
+/// batch.AddOutDegree("out_degree").AddPagerank("rank").AddConnectedComponents(
+///     "component");
+/// KATANA_CHECKED(batch.Run(pg));
+/// \endcode
+class KATANA_EXPORT AnalyticsBatch {
+  std::string out_degree_property_name_;
+  std::string in_degree_property_name_;
+  std::string pagerank_property_name_;
+  std::string connected_components_property_name_;
+  std::optional<PagerankPlan> pagerank_plan_;
+
+public:
+  /// Compute the number of edges leaving each node, as a uint32_t property.
+  AnalyticsBatch& AddOutDegree(const std::string& output_property_name) {
+    out_degree_property_name_ = output_property_name;
+    return *this;
+  }
+
+  /// Compute the number of edges entering each node, as a uint32_t property.
+  AnalyticsBatch& AddInDegree(const std::string& output_property_name) {
+    in_degree_property_name_ = output_property_name;
+    return *this;
+  }
+
+  /// Compute the Page Rank of each node as Pagerank does with the same plan,
+  /// as a float property. plan must be PagerankPlan::PullTopological and, as
+  /// for that plan, the graph must be transposed.
+  AnalyticsBatch& AddPagerank(
+      const std::string& output_property_name,
+      PagerankPlan plan = PagerankPlan::PullTopological()) {
+    pagerank_property_name_ = output_property_name;
+    pagerank_plan_ = plan;
+    return *this;
+  }
+
+  /// Compute the connected component of each node as ConnectedComponents
+  /// does with ConnectedComponentsPlan::LabelProp, as a uint64_t property
+  /// holding the smallest node ID of the component. As for ConnectedComponents,
+  /// the graph must be symmetric.
+  AnalyticsBatch& AddConnectedComponents(
+      const std::string& output_property_name) {
+    connected_components_property_name_ = output_property_name;
+    return *this;
+  }
+
+  /// Compute every analytic added to the batch and create its property. The
+  /// properties may not exist before the call and must have distinct names.
+  Result<void> Run(PropertyGraph* pg) const;
+};
+
+}  // namespace katana::analytics
+
+#endif
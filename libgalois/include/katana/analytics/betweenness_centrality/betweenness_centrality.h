@@ -18,16 +18,25 @@ public:
   enum Algorithm {
     kLevel,
     kOuter,
+    kBatched,
     // TODO(gill): Reinstate async and auto once we have bidirectional graphs.
     // kAsynchronous,
     // kAutomatic,
   };
 
+  /// 1 GiB
+  static const size_t kDefaultMaxBatchBytes = size_t{1} << 30;
+
 private:
   Algorithm algorithm_;
+  size_t max_batch_bytes_;
 
-  BetweennessCentralityPlan(Architecture architecture, Algorithm algorithm)
-      : Plan(architecture), algorithm_(algorithm) {}
+  BetweennessCentralityPlan(
+      Architecture architecture, Algorithm algorithm,
+      size_t max_batch_bytes = kDefaultMaxBatchBytes)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        max_batch_bytes_(max_batch_bytes) {}
 
 public:
   BetweennessCentralityPlan() : BetweennessCentralityPlan{kCPU, kLevel} {}
@@ -51,18 +60,59 @@ public:
 
   Algorithm algorithm() const { return algorithm_; }
 
+  /// The most memory for the per-source state of a batch of kBatched
+  size_t max_batch_bytes() const { return max_batch_bytes_; }
+
+  /// Process the nodes of each BFS level in parallel, one source at a time.
   static BetweennessCentralityPlan Level() { return {kCPU, kLevel}; }
 
+  /// Process sources in parallel, one per thread. Every thread keeps its own
+  /// state for every node, so memory is O(num_nodes * num_threads).
   static BetweennessCentralityPlan Outer() { return {kCPU, kOuter}; }
 
+  /// Process sources in batches, each one with a parallel level-synchronous
+  /// Brandes over all the sources of the batch. A node's state for every
+  /// source of the batch (a 32-bit distance, float path count and
+  /// dependency) is kept together, so one pass over its edges serves the
+  /// whole batch. The batch is as wide as fits in max_batch_bytes, about
+  /// 16 bytes per node per source, regardless of the number of threads.
+  static BetweennessCentralityPlan Batched(
+      size_t max_batch_bytes = kDefaultMaxBatchBytes) {
+    return {kCPU, kBatched, max_batch_bytes};
+  }
+
   static BetweennessCentralityPlan FromAlgorithm(Algorithm algo) {
     return BetweennessCentralityPlan(kCPU, algo);
   }
 };
 
-/// Either a vector of node IDs or a number of nodes to use as sources.
-using BetweennessCentralitySources =
-    std::variant<std::vector<uint32_t>, uint32_t>;
+/// Sources drawn uniformly at random, in batches, until the betweenness
+/// centrality of every node is estimated within epsilon of its exact value
+/// with probability at least 1 - delta. Centralities are compared normalized
+/// by n (n - 1), n being the number of nodes, and the estimates are scaled
+/// to the range of the exact centralities.
+///
+/// After each batch, sampling stops if an empirical Bernstein bound on every
+/// node guarantees the accuracy, which takes few sources on graphs whose
+/// dependencies vary little from source to source. It stops in any case
+/// after the O(log(n / delta) / epsilon^2) sources for which Hoeffding's
+/// bound does.
+struct BetweennessCentralityAdaptiveSources {
+  double epsilon;
+  double delta;
+  /// Seed of the random choice of sources
+  uint64_t seed{0};
+
+  bool operator==(const BetweennessCentralityAdaptiveSources& other) const {
+    return epsilon == other.epsilon && delta == other.delta &&
+           seed == other.seed;
+  }
+};
+
+/// Either a vector of node IDs, a number of nodes to use as sources, or
+/// randomly drawn sources.
+using BetweennessCentralitySources = std::variant<
+    std::vector<uint32_t>, uint32_t, BetweennessCentralityAdaptiveSources>;
 
 /// Use all sources instead of a subset.
 KATANA_EXPORT extern const BetweennessCentralitySources
@@ -77,7 +127,9 @@ KATANA_EXPORT extern const BetweennessCentralitySources
 /// @param output_property_name The parameter to create with the computed value.
 /// @param sources Only process some sources, producing an approximate
 ///          betweenness centrality. If this is a vector process those source
-///          nodes; if this is an int process that number of source nodes.
+///          nodes; if this is an int process that number of source nodes; if
+///          this is a BetweennessCentralityAdaptiveSources process random
+///          sources until the estimates are accurate enough.
 /// @param plan
 KATANA_EXPORT Result<void> BetweennessCentrality(
     PropertyGraph* pg, const std::string& output_property_name,
@@ -2,7 +2,13 @@
 #define KATANA_LIBGALOIS_KATANA_ANALYTICS_BFS_BFS_H_
 
 #include <iostream>
+#include <string>
+#include <vector>
 
+#include "katana/CompressedGraphTopology.h"
+#include "katana/NUMAArray.h"
+#include "katana/TemporalEdgeIndex.h"
+#include "katana/analytics/AnalyticsContext.h"
 #include "katana/analytics/Plan.h"
 #include "katana/analytics/Utils.h"
 
@@ -17,27 +23,33 @@ public:
     kAsynchronous,
     kSynchronousTile,
     kSynchronous,
-    kSynchronousDirectOpt
+    kSynchronousDirectOpt,
+    kSynchronousDirectOptLazyTranspose,
+    kMultiSource
   };
 
   static const int kDefaultEdgeTileSize = 256;
   static const uint32_t kDefaultAlpha = 15;
   static const uint32_t kDefaultBeta = 18;
+  static const uint32_t kDefaultBatchSize = 64;
+  static const uint32_t kMaxBatchSize = 512;
 
 private:
   Algorithm algorithm_;
   ptrdiff_t edge_tile_size_;
   uint32_t alpha_;
   uint32_t beta_;
+  uint32_t batch_size_;
 
   BfsPlan(
       Architecture architecture, Algorithm algorithm, ptrdiff_t edge_tile_size,
-      uint32_t alpha, uint32_t beta)
+      uint32_t alpha, uint32_t beta, uint32_t batch_size = kDefaultBatchSize)
       : Plan(architecture),
         algorithm_(algorithm),
         edge_tile_size_(edge_tile_size),
         alpha_(alpha),
-        beta_(beta) {}
+        beta_(beta),
+        batch_size_(batch_size) {}
 
 public:
   BfsPlan()
@@ -49,6 +61,8 @@ public:
   ptrdiff_t edge_tile_size() const { return edge_tile_size_; }
   uint32_t alpha() const { return alpha_; }
   uint32_t beta() const { return beta_; }
+  /// The number of sources searched together by MultiSource
+  uint32_t batch_size() const { return batch_size_; }
 
   static BfsPlan AsynchronousTile(
       ptrdiff_t edge_tile_size = kDefaultEdgeTileSize) {
@@ -68,16 +82,36 @@ public:
       uint32_t alpha = kDefaultAlpha, uint32_t beta = kDefaultBeta) {
     return {kCPU, kSynchronousDirectOpt, 0, alpha, beta};
   }
+
+  /// Like SynchronousDirectOpt, but rather than building the transpose before
+  /// the search starts, build it in the background while the first top-down
+  /// levels run. Bottom-up levels are only used once it is ready, which cuts
+  /// the time to first result for single source queries on large graphs.
+  static BfsPlan SynchronousDirectOptLazyTranspose(
+      uint32_t alpha = kDefaultAlpha, uint32_t beta = kDefaultBeta) {
+    return {kCPU, kSynchronousDirectOptLazyTranspose, 0, alpha, beta};
+  }
+
+  /// Search from batch_size sources at once (MS-BFS). Every node keeps a bit
+  /// per source of the batch for the sources that reached it and for those
+  /// in the frontier, so one scan of the edges of a node advances every
+  /// search that has the node in its frontier. For use with MultiSourceBfs;
+  /// batch_size must be a multiple of 64 no larger than kMaxBatchSize.
+  static BfsPlan MultiSource(uint32_t batch_size = kDefaultBatchSize) {
+    return {kCPU, kMultiSource, 0, 0, 0, batch_size};
+  }
 };
 
 /// Compute BFS parent of nodes in the graph pg starting from start_node. The
 /// result is stored in a property named by output_property_name. The plan
 /// controls the algorithm and parameters used to compute the BFS.
 /// The property named output_property_name is created by this function and may
-/// not exist before the call.
+/// not exist before the call. With a context, the node arrays of the search
+/// are taken from it and kept for the next call.
 KATANA_EXPORT Result<void> Bfs(
     PropertyGraph* pg, uint32_t start_node,
-    const std::string& output_property_name, BfsPlan algo = {});
+    const std::string& output_property_name, BfsPlan algo = {},
+    AnalyticsContext* context = nullptr);
 
 /// Do a quick validation of the results of a BFS computation where the results
 /// are stored in property_name. This function does do an exhaustive check.
@@ -86,6 +120,57 @@ KATANA_EXPORT Result<void> Bfs(
 KATANA_EXPORT Result<void> BfsAssertValid(
     PropertyGraph* pg, uint32_t source, const std::string& property_name);
 
+/// Compute the BFS distance, in hops, from each of sources to every node of
+/// pg, searching plan.batch_size() sources at a time. The distances from
+/// sources[i] are stored in a new uint32_t property named
+/// output_property_names[i]; unreachable nodes get the maximum uint32_t.
+/// plan must be BfsPlan::MultiSource.
+KATANA_EXPORT Result<void> MultiSourceBfs(
+    PropertyGraph* pg, const std::vector<uint32_t>& sources,
+    const std::vector<std::string>& output_property_names,
+    BfsPlan plan = BfsPlan::MultiSource());
+
+/// Like MultiSourceBfs but return the distances as a matrix with a row per
+/// source: entry i * pg->num_nodes() + n is the distance from sources[i] to
+/// n.
+KATANA_EXPORT Result<NUMAArray<uint32_t>> MultiSourceBfsDistances(
+    PropertyGraph* pg, const std::vector<uint32_t>& sources,
+    BfsPlan plan = BfsPlan::MultiSource());
+
+/// Find a shortest path, in hops, from source to target with a bidirectional
+/// BFS that stops as soon as the two searches meet, so only the neighborhoods
+/// of the two nodes are visited and no node property is created. The first
+/// call on pg builds and caches its bidirectional view.
+///
+/// \returns the nodes of the path from source to target, both included, or
+///     an empty vector if target is not reachable from source
+KATANA_EXPORT Result<std::vector<uint32_t>> BfsPath(
+    PropertyGraph* pg, uint32_t source, uint32_t target);
+
+/// Compute the BFS distance, in hops, from start_node to every node of pg
+/// over only the edges whose timestamp_property_name value is in window,
+/// e.g., what a node reached in the last day. The edges of a node in the
+/// window are found by binary search in pg->GetTemporalEdgeIndex, which is
+/// built on the first call and cached, so edges outside the window are never
+/// scanned. The distances are stored in a new uint32_t property named
+/// output_property_name; unreached nodes get the maximum uint32_t.
+KATANA_EXPORT Result<void> TimeWindowBfs(
+    PropertyGraph* pg, uint32_t start_node,
+    const std::string& timestamp_property_name, const TimeWindow& window,
+    const std::string& output_property_name);
+
+/// Compute the BFS distance, in hops, from start_node to every node of a
+/// topology loaded with PropertyGraph::LoadCompressedTopology. Each node's
+/// destinations are decoded as the node is expanded, so the topology is
+/// never decompressed. Unreached nodes get the maximum uint32_t.
+KATANA_EXPORT Result<NUMAArray<uint32_t>> CompressedBfsDistances(
+    const CompressedGraphTopology& topology, uint32_t start_node);
+
+/// Check the distances from source stored in property_name by
+/// MultiSourceBfs against a single source BFS.
+KATANA_EXPORT Result<void> MultiSourceBfsAssertValid(
+    PropertyGraph* pg, uint32_t source, const std::string& property_name);
+
 /// Statistics about a graph that can be extracted from the results of BFS.
 struct KATANA_EXPORT BfsStatistics {
   /// The number of nodes reachable from the source node.
@@ -0,0 +1,135 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_BIPARTITEMATCHING_BIPARTITEMATCHING_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_BIPARTITEMATCHING_BIPARTITEMATCHING_H_
+
+#include <iostream>
+#include <limits>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+
+namespace katana::analytics {
+
+/// A computational plan for BipartiteMatching and
+/// MaximumWeightBipartiteMatching, specifying the algorithm.
+class BipartiteMatchingPlan : public Plan {
+public:
+  /// Algorithm selectors for bipartite matching
+  enum Algorithm { kPushRelabel, kPothenFan, kAuction };
+
+  /// Selects 1 / (number of left nodes + 1) as the final epsilon
+  constexpr static const double kDefaultEpsilon = 0;
+
+private:
+  Algorithm algorithm_;
+  double epsilon_;
+
+  BipartiteMatchingPlan(
+      Architecture architecture, Algorithm algorithm, double epsilon)
+      : Plan(architecture), algorithm_(algorithm), epsilon_(epsilon) {}
+
+public:
+  BipartiteMatchingPlan() : BipartiteMatchingPlan(PushRelabel()) {}
+
+  BipartiteMatchingPlan& operator=(const BipartiteMatchingPlan&) = default;
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  /// For the auction, the final bid increment. The weight of the matching is
+  /// within the number of left nodes times epsilon of the maximum, so the
+  /// default finds a maximum weight matching when the weights are integers.
+  double epsilon() const { return epsilon_; }
+
+  /// Maximum cardinality matching by asynchronous push-relabel. Free left
+  /// nodes are processed in parallel; each takes the right neighbor with the
+  /// lowest label with an atomic exchange, displacing its mate, and relabels
+  /// it past its second lowest neighbor. Labels are recomputed exactly by a
+  /// breadth first search from the free right nodes once the work since the
+  /// last global relabel exceeds 6 * |V| + |E| arcs scanned.
+  ///
+  /// LANGGUTH, Johannes; AZAD, Ariful; HALAPPANAVAR, Mahantesh; MANNE,
+  /// Fredrik. On parallel push-relabel based algorithms for bipartite maximum
+  /// matching. Parallel Computing, 2014.
+  static BipartiteMatchingPlan PushRelabel() {
+    return {kCPU, kPushRelabel, kDefaultEpsilon};
+  }
+
+  /// Maximum cardinality matching by parallel augmenting paths. In each
+  /// phase, every free left node searches depth first for a vertex-disjoint
+  /// augmenting path, claiming right nodes atomically, and first looks
+  /// ahead for a free right neighbor. Phases alternate the direction in which
+  /// neighbors are scanned and end when no path is found.
+  ///
+  /// AZAD, Ariful; HALAPPANAVAR, Mahantesh; RAJAMANICKAM, Sivasankaran;
+  /// BOMAN, Erik G.; KHAN, Arif; POTHEN, Alex. Multithreaded algorithms for
+  /// maximum matching in bipartite graphs. IPDPS, 2012.
+  static BipartiteMatchingPlan PothenFan() {
+    return {kCPU, kPothenFan, kDefaultEpsilon};
+  }
+
+  /// Maximum weight matching by a parallel auction with epsilon scaling.
+  /// Unassigned left nodes bid in parallel for their most valuable right
+  /// neighbor, raising its price by the difference to the second most
+  /// valuable option plus the current epsilon, which shrinks by a factor of 4
+  /// per phase down to epsilon. Edges with non-positive weight are never
+  /// matched.
+  ///
+  /// BERTSEKAS, Dimitri P.; CASTANON, David A. Parallel synchronous and
+  /// asynchronous implementations of the auction algorithm. Parallel
+  /// Computing, 1991.
+  static BipartiteMatchingPlan Auction(double epsilon = kDefaultEpsilon) {
+    return {kCPU, kAuction, epsilon};
+  }
+};
+
+/// The value of the output property for unmatched nodes
+constexpr uint32_t kBipartiteMatchingUnmatched =
+    std::numeric_limits<uint32_t>::max();
+
+/// Compute a maximum cardinality matching between the nodes of the atomic
+/// node type left_node_type_name and the other nodes, the right nodes. Only
+/// edges between a left and a right node, in either direction, are
+/// considered; other edges are ignored. Create a node property with the mate
+/// of each node, or kBipartiteMatchingUnmatched for unmatched nodes.
+/// The property named output_property_name is created by this function and may
+/// not exist before the call. The created property has type uint32_t.
+KATANA_EXPORT Result<void> BipartiteMatching(
+    PropertyGraph* pg, const std::string& left_node_type_name,
+    const std::string& output_property_name, BipartiteMatchingPlan plan = {});
+
+/// Compute a matching of maximum total weight between the nodes of the atomic
+/// node type left_node_type_name and the other nodes, where the weight of each
+/// edge is given by the edge property edge_weight_property_name. Edges are
+/// considered as for BipartiteMatching, and the output property is the same.
+/// The plan must select the auction.
+KATANA_EXPORT Result<void> MaximumWeightBipartiteMatching(
+    PropertyGraph* pg, const std::string& left_node_type_name,
+    const std::string& edge_weight_property_name,
+    const std::string& output_property_name,
+    BipartiteMatchingPlan plan = BipartiteMatchingPlan::Auction());
+
+/// Check that the property is a matching: mates are mutual, and every matched
+/// pair is a left and a right node joined by an edge. This does not check that
+/// the matching is maximum.
+KATANA_EXPORT Result<void> BipartiteMatchingAssertValid(
+    PropertyGraph* pg, const std::string& left_node_type_name,
+    const std::string& property_name);
+
+struct KATANA_EXPORT BipartiteMatchingStatistics {
+  /// The number of matched pairs.
+  uint64_t num_matched_pairs;
+
+  /// The total weight of the matched pairs, each weighing as much as the
+  /// heaviest edge between them, or 0 without a weight property.
+  double total_weight;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<BipartiteMatchingStatistics> Compute(
+      katana::PropertyGraph* pg, const std::string& property_name,
+      const std::string& edge_weight_property_name = "");
+};
+
+}  // namespace katana::analytics
+
+#endif
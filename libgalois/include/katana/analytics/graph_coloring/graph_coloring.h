@@ -0,0 +1,97 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_GRAPHCOLORING_GRAPHCOLORING_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_GRAPHCOLORING_GRAPHCOLORING_H_
+
+#include <iostream>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+
+namespace katana::analytics {
+
+/// A computational plan for GraphColoring, specifying the algorithm and the
+/// order in which nodes get their colors.
+class GraphColoringPlan : public Plan {
+public:
+  /// Algorithm selectors for GraphColoring
+  enum Algorithm { kJonesPlassmann, kSpeculative };
+
+  /// Node priorities. Nodes with higher priorities are colored first by
+  /// Jones-Plassmann and keep their colors in conflicts of Speculative.
+  enum Priority {
+    /// Order nodes by a hash of their ID
+    kRandom,
+    /// Order nodes by decreasing degree, then by a hash of their ID, which
+    /// usually needs fewer colors
+    kDegree
+  };
+
+private:
+  Algorithm algorithm_;
+  Priority priority_;
+
+  GraphColoringPlan(
+      Architecture architecture, Algorithm algorithm, Priority priority)
+      : Plan(architecture), algorithm_(algorithm), priority_(priority) {}
+
+public:
+  GraphColoringPlan() : GraphColoringPlan(kCPU, kJonesPlassmann, kDegree) {}
+
+  GraphColoringPlan& operator=(const GraphColoringPlan&) = default;
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  Priority priority() const { return priority_; }
+
+  /// Jones-Plassmann coloring: a node is colored with the smallest color not
+  /// used by its neighbors once all of its neighbors with higher priorities
+  /// are colored. The coloring is the same as the greedy serial coloring in
+  /// order of priority, for any number of threads.
+  static GraphColoringPlan JonesPlassmann(Priority priority = kDegree) {
+    return {kCPU, kJonesPlassmann, priority};
+  }
+
+  /// Speculative iterative coloring: all uncolored nodes pick the smallest
+  /// color not used by their neighbors in parallel, then the node with the
+  /// lower priority of each pair of neighbors with the same color is
+  /// uncolored, until there are no conflicts. This has less synchronization
+  /// than Jones-Plassmann, but the coloring depends on the schedule.
+  static GraphColoringPlan Speculative(Priority priority = kDegree) {
+    return {kCPU, kSpeculative, priority};
+  }
+
+  static GraphColoringPlan FromAlgorithm(
+      Algorithm algorithm, Priority priority = kDegree) {
+    return {kCPU, algorithm, priority};
+  }
+};
+
+/// Color the nodes of the graph so that no two neighbors have the same color,
+/// and create a property with the color of each node. Colors are consecutive
+/// from 0, and self loops are ignored.
+/// The graph must be symmetric.
+/// The property named output_property_name is created by this function and may
+/// not exist before the call. The created property has type uint32_t.
+KATANA_EXPORT Result<void> GraphColoring(
+    PropertyGraph* pg, const std::string& output_property_name,
+    GraphColoringPlan plan = {});
+
+KATANA_EXPORT Result<void> GraphColoringAssertValid(
+    PropertyGraph* pg, const std::string& property_name);
+
+struct KATANA_EXPORT GraphColoringStatistics {
+  /// The number of colors used.
+  uint32_t num_colors;
+
+  /// The largest number of nodes with the same color.
+  uint64_t largest_color_class;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<GraphColoringStatistics> Compute(
+      katana::PropertyGraph* pg, const std::string& property_name);
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,196 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_GRAPHSAMPLING_GRAPHSAMPLING_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_GRAPHSAMPLING_GRAPHSAMPLING_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+
+// API
+
+namespace katana::analytics {
+
+/// A computational plan for graph sampling, specifying how the sample is
+/// chosen and the parameters of the method.
+///
+/// Every method draws its random numbers from katana::CounterRng, keyed by
+/// the seed and by what is being decided (a candidate, a walker's step, a
+/// burning node), so a sample depends only on the graph, the plan and the
+/// seed, not on the number of threads.
+class GraphSamplingPlan : public Plan {
+public:
+  enum Algorithm {
+    kUniformNode,
+    kUniformEdge,
+    kRandomWalk,
+    kForestFire,
+    kSnowball,
+  };
+
+  constexpr static const double kDefaultRestartProbability = 0.15;
+  static const uint32_t kDefaultNumberOfWalkers = 64;
+  constexpr static const double kDefaultBurnProbability = 0.7;
+  static const uint32_t kDefaultFanout = 5;
+
+private:
+  Algorithm algorithm_;
+  double restart_probability_;
+  uint32_t number_of_walkers_;
+  double burn_probability_;
+  uint32_t fanout_;
+
+  GraphSamplingPlan(
+      Architecture architecture, Algorithm algorithm,
+      double restart_probability, uint32_t number_of_walkers,
+      double burn_probability, uint32_t fanout)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        restart_probability_(restart_probability),
+        number_of_walkers_(number_of_walkers),
+        burn_probability_(burn_probability),
+        fanout_(fanout) {}
+
+public:
+  GraphSamplingPlan()
+      : GraphSamplingPlan{
+            kCPU,
+            kUniformNode,
+            kDefaultRestartProbability,
+            kDefaultNumberOfWalkers,
+            kDefaultBurnProbability,
+            kDefaultFanout} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  /// Probability that a walker returns to its start node at each step
+  double restart_probability() const { return restart_probability_; }
+
+  /// Number of random walks run at once
+  uint32_t number_of_walkers() const { return number_of_walkers_; }
+
+  /// Forest fire: each burning node burns a geometrically distributed number
+  /// of its unburnt out-neighbors, with mean p / (1 - p)
+  double burn_probability() const { return burn_probability_; }
+
+  /// Snowball: number of unvisited out-neighbors each node adds
+  uint32_t fanout() const { return fanout_; }
+
+  /// Nodes picked uniformly at random, without replacement; the sample is
+  /// the sub-graph they induce
+  static GraphSamplingPlan UniformNode() {
+    return {
+        kCPU,
+        kUniformNode,
+        kDefaultRestartProbability,
+        kDefaultNumberOfWalkers,
+        kDefaultBurnProbability,
+        kDefaultFanout};
+  }
+
+  /// Edges picked uniformly at random, without replacement; the sample is
+  /// those edges and their endpoints
+  static GraphSamplingPlan UniformEdge() {
+    return {
+        kCPU,
+        kUniformEdge,
+        kDefaultRestartProbability,
+        kDefaultNumberOfWalkers,
+        kDefaultBurnProbability,
+        kDefaultFanout};
+  }
+
+  /// Random walks with restart from uniformly random start nodes, following
+  /// out-edges; walkers that find no new nodes for a while, or reach a node
+  /// without out-edges, jump to a new start node. The sample is the
+  /// sub-graph induced by the nodes visited.
+  static GraphSamplingPlan RandomWalk(
+      double restart_probability = kDefaultRestartProbability,
+      uint32_t number_of_walkers = kDefaultNumberOfWalkers) {
+    return {
+        kCPU,
+        kRandomWalk,
+        restart_probability,
+        number_of_walkers,
+        kDefaultBurnProbability,
+        kDefaultFanout};
+  }
+
+  /// Forest fire (Leskovec and Faloutsos, "Sampling from Large Graphs", KDD
+  /// 2006) over out-edges, burning level by level from a uniformly random
+  /// node, and from another one whenever the fire dies out. The sample is
+  /// the sub-graph induced by the nodes burnt.
+  static GraphSamplingPlan ForestFire(
+      double burn_probability = kDefaultBurnProbability) {
+    return {
+        kCPU,
+        kForestFire,
+        kDefaultRestartProbability,
+        kDefaultNumberOfWalkers,
+        burn_probability,
+        kDefaultFanout};
+  }
+
+  /// Snowball sampling: a breadth-first search from a uniformly random node
+  /// in which each node adds at most fanout random unvisited out-neighbors,
+  /// restarted like forest fire. The sample is the sub-graph induced by the
+  /// nodes visited.
+  static GraphSamplingPlan Snowball(uint32_t fanout = kDefaultFanout) {
+    return {
+        kCPU,
+        kSnowball,
+        kDefaultRestartProbability,
+        kDefaultNumberOfWalkers,
+        kDefaultBurnProbability,
+        fanout};
+  }
+};
+
+/**
+ * Pick the nodes of a sample of pg of sample_size nodes, or of all of them if
+ * the graph is smaller, in the order they were picked. The work done is
+ * proportional to the sample size and the degrees of the nodes picked, not to
+ * the size of the graph.
+ *
+ * Not supported for GraphSamplingPlan::kUniformEdge, whose sample is not
+ * induced by its nodes.
+ *
+ * @param pg The graph to sample.
+ * @param sample_size Number of nodes to pick
+ * @param seed Seed of the random numbers
+ * @param plan
+ */
+KATANA_EXPORT katana::Result<std::vector<katana::PropertyGraph::Node>>
+GraphSampleNodes(
+    katana::PropertyGraph* pg, uint64_t sample_size, uint64_t seed,
+    GraphSamplingPlan plan = {});
+
+/**
+ * Construct a sample of pg as a new graph with the named properties of its
+ * nodes and edges. The sample has sample_size nodes, or sample_size edges for
+ * GraphSamplingPlan::kUniformEdge, or the whole graph if it is smaller. The
+ * nodes of the sample are in the order GraphSampleNodes picks them, or in
+ * increasing order of ID for kUniformEdge, and the edges of each node are
+ * kept as in SubGraphExtraction.
+ *
+ * @param pg The graph to sample.
+ * @param sample_size Number of nodes, or edges, of the sample
+ * @param seed Seed of the random numbers
+ * @param node_properties_to_copy Names of the node properties to copy
+ * @param edge_properties_to_copy Names of the edge properties to copy
+ * @param plan
+ * @param sample_nodes If not null, set to the original ID of each node of the
+ *     sample
+ */
+KATANA_EXPORT katana::Result<std::unique_ptr<katana::PropertyGraph>>
+GraphSample(
+    katana::PropertyGraph* pg, uint64_t sample_size, uint64_t seed,
+    const std::vector<std::string>& node_properties_to_copy = {},
+    const std::vector<std::string>& edge_properties_to_copy = {},
+    GraphSamplingPlan plan = {},
+    std::vector<katana::PropertyGraph::Node>* sample_nodes = nullptr);
+
+}  // namespace katana::analytics
+
+#endif
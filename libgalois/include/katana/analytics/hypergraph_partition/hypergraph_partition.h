@@ -0,0 +1,131 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_HYPERGRAPHPARTITION_HYPERGRAPHPARTITION_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_HYPERGRAPHPARTITION_HYPERGRAPHPARTITION_H_
+
+#include <iostream>
+#include <limits>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+
+namespace katana::analytics {
+
+/// A computational plan for HypergraphPartition, specifying the balance
+/// constraint and the sizes of the coarsening and refinement phases.
+class HypergraphPartitionPlan : public Plan {
+public:
+  /// Algorithm selectors for HypergraphPartition
+  enum Algorithm { kRecursiveBisection };
+
+  static const uint32_t kDefaultCoarsestNodesPerPartition = 20;
+  static const uint32_t kDefaultRefinementRounds = 10;
+  constexpr static const double kDefaultImbalance = 0.03;
+
+private:
+  Algorithm algorithm_;
+  double imbalance_;
+  uint32_t coarsest_nodes_per_partition_;
+  uint32_t refinement_rounds_;
+
+  HypergraphPartitionPlan(
+      Architecture architecture, Algorithm algorithm, double imbalance,
+      uint32_t coarsest_nodes_per_partition, uint32_t refinement_rounds)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        imbalance_(imbalance),
+        coarsest_nodes_per_partition_(coarsest_nodes_per_partition),
+        refinement_rounds_(refinement_rounds) {}
+
+public:
+  HypergraphPartitionPlan()
+      : HypergraphPartitionPlan(RecursiveBisection()) {}
+
+  HypergraphPartitionPlan& operator=(const HypergraphPartitionPlan&) =
+      default;
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  /// The fraction by which the number of nodes of a partition may exceed the
+  /// average.
+  double imbalance() const { return imbalance_; }
+
+  /// Coarsening of a bisection stops when the coarsest hypergraph has at most
+  /// this many nodes per side.
+  uint32_t coarsest_nodes_per_partition() const {
+    return coarsest_nodes_per_partition_;
+  }
+
+  /// The maximum number of refinement rounds at each level.
+  uint32_t refinement_rounds() const { return refinement_rounds_; }
+
+  /// Recursive multilevel bisection followed by direct k-way refinement.
+  /// Each bisection coarsens its hypergraph by merging nodes that pick the
+  /// same hyperedge, bisects the coarsest hypergraph by greedy growing, and
+  /// refines the bisection at each level on the way back. The halves are
+  /// bisected in turn, with their cut hyperedges split, until each has one
+  /// partition. All the subproblems of a level of the recursion are
+  /// independent: large ones are bisected one after another with parallel
+  /// loops, and the rest run concurrently, one per thread. Hypergraphs are
+  /// stored as flat arrays of pins and incidences. Finally, nodes move
+  /// directly between any partitions to reduce the connectivity cut.
+  /// Coarsening and bisection are deterministic but k-way refinement depends
+  /// on the schedule.
+  ///
+  /// MASKE, Sepideh; LI, Lingda; PINGALI, Keshav. BiPart: a parallel and
+  /// deterministic hypergraph partitioner. PPoPP 2021.
+  static HypergraphPartitionPlan RecursiveBisection(
+      double imbalance = kDefaultImbalance,
+      uint32_t coarsest_nodes_per_partition =
+          kDefaultCoarsestNodesPerPartition,
+      uint32_t refinement_rounds = kDefaultRefinementRounds) {
+    return {
+        kCPU, kRecursiveBisection, imbalance, coarsest_nodes_per_partition,
+        refinement_rounds};
+  }
+};
+
+/// The value of the output property for hyperedge nodes
+constexpr uint32_t kHypergraphPartitionHyperedge =
+    std::numeric_limits<uint32_t>::max();
+
+/// Partition a hypergraph stored as a bipartite graph: the nodes of the
+/// atomic node type hyperedge_node_type_name are hyperedges, and their
+/// neighbors by edges in either direction that are not hyperedges are their
+/// pins. Other edges are ignored. The other nodes are split into
+/// num_partitions parts of at most (1 + imbalance) times the average number
+/// of nodes, minimizing the connectivity cut: the sum over hyperedges of one
+/// less than the number of parts they span. Create a node property with the
+/// partition of each node, or kHypergraphPartitionHyperedge for hyperedges.
+/// The property named output_property_name is created by this function and may
+/// not exist before the call. The created property has type uint32_t.
+KATANA_EXPORT Result<void> HypergraphPartition(
+    PropertyGraph* pg, const std::string& hyperedge_node_type_name,
+    uint32_t num_partitions, const std::string& output_property_name,
+    HypergraphPartitionPlan plan = {});
+
+struct KATANA_EXPORT HypergraphPartitionStatistics {
+  /// The number of partitions, one more than the largest partition ID.
+  uint32_t num_partitions;
+
+  /// The number of hyperedges with pins in more than one partition.
+  uint64_t cut_hyperedges;
+
+  /// The sum over hyperedges of one less than the number of partitions they
+  /// span.
+  uint64_t connectivity_cut;
+
+  /// The largest number of nodes in a partition.
+  uint64_t largest_partition_size;
+
+  /// The ratio of the largest partition size to the average.
+  double imbalance;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<HypergraphPartitionStatistics> Compute(
+      katana::PropertyGraph* pg, const std::string& property_name);
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -16,11 +16,12 @@ public:
   enum Algorithm {
     kSerial,
     kPull,
-    // TODO(gill): These algorithms need locks and cautious operator.
+    // TODO(gill): This algorithm needs locks and cautious operator.
     // kNondeterministic,
-    // kDeterministicBase,
     kPriority,
-    kEdgeTiledPriority
+    kEdgeTiledPriority,
+    kLuby,
+    kDeterministic
   };
 
 private:
@@ -46,6 +47,21 @@ public:
     return {kCPU, kEdgeTiledPriority};
   }
 
+  /// Luby's algorithm with fixed priorities: in each round, the undecided
+  /// nodes with a higher priority than all of their undecided neighbors join
+  /// the set. Lower degree nodes get higher priorities, which cuts the number
+  /// of rounds on skewed graphs, and equal degrees are ordered by a hash of
+  /// the ID. The set does not depend on the number of threads.
+  static IndependentSetPlan Luby() { return {kCPU, kLuby}; }
+
+  /// Find the set that a greedy serial pass would find taking nodes in a
+  /// fixed pseudo-random order, given by a hash of the ID, in
+  /// bulk-synchronous rounds: in each round, a node joins the set when it
+  /// comes before all of its undecided neighbors. A random order needs only
+  /// a logarithmic number of rounds, and the set depends neither on the
+  /// number of threads nor on the run.
+  static IndependentSetPlan Deterministic() { return {kCPU, kDeterministic}; }
+
   static IndependentSetPlan FromAlgorithm(Algorithm algorithm) {
     return {kCPU, algorithm};
   }
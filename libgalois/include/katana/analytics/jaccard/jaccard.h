@@ -2,6 +2,8 @@
 #define KATANA_LIBGALOIS_KATANA_ANALYTICS_JACCARD_JACCARD_H_
 
 #include <iostream>
+#include <memory>
+#include <vector>
 
 #include "katana/Properties.h"
 #include "katana/PropertyGraph.h"
@@ -15,8 +17,8 @@ class JaccardPlan : public Plan {
 public:
   enum EdgeSorting {
     /// The edges may be sorted, but may not.
-    /// Jaccard may optimistically use a sorted algorithm and fail over to an
-    /// unsorted one if unsorted edges are detected.
+    /// Jaccard uses the sorted algorithm if the profile of the graph (see
+    /// GraphProfile) finds the edges sorted.
     kUnknown,
     /// The edges are known to be sorted by destination.
     /// Use faster sorted intersection algorithm.
@@ -33,9 +35,8 @@ private:
       : Plan(architecture), edge_sorting_(edge_sorting) {}
 
 public:
-  /// Automatically choose an algorithm.
-  /// May either use the unsorted algorithm, or use an algorithm that attempts
-  /// the sorted algorithm, but checks for out of order edges.
+  /// Automatically choose an algorithm from whether the edges of the graph
+  /// are sorted.
   JaccardPlan() : JaccardPlan(kCPU, kUnknown) {}
 
   JaccardPlan& operator=(const JaccardPlan&) = default;
@@ -64,6 +65,105 @@ KATANA_EXPORT Result<void> Jaccard(
 KATANA_EXPORT Result<void> JaccardAssertValid(
     PropertyGraph* pg, uint32_t compare_node, const std::string& property_name);
 
+/// A computational plan for JaccardSimilarityJoin, specifying the algorithm,
+/// the number of similar nodes to keep for each node and the smallest
+/// similarity to keep.
+class JaccardSimilarityJoinPlan : public Plan {
+public:
+  enum Algorithm {
+    /// Find candidates by prefix filtering if min_similarity is above 0, and
+    /// otherwise through every two-hop wedge, and compute exact similarities.
+    kExact,
+    /// Find candidates through MinHash signatures hashed in bands, and
+    /// estimate similarities from the signatures.
+    kMinHash,
+  };
+
+  static const uint32_t kDefaultTopK = 10;
+  static const uint32_t kDefaultNumBands = 16;
+  static const uint32_t kDefaultRowsPerBand = 4;
+
+private:
+  Algorithm algorithm_;
+  uint32_t top_k_;
+  double min_similarity_;
+  uint32_t num_bands_;
+  uint32_t rows_per_band_;
+  uint64_t seed_;
+
+  JaccardSimilarityJoinPlan(
+      Architecture architecture, Algorithm algorithm, uint32_t top_k,
+      double min_similarity, uint32_t num_bands, uint32_t rows_per_band,
+      uint64_t seed)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        top_k_(top_k),
+        min_similarity_(min_similarity),
+        num_bands_(num_bands),
+        rows_per_band_(rows_per_band),
+        seed_(seed) {}
+
+public:
+  JaccardSimilarityJoinPlan() : JaccardSimilarityJoinPlan(Exact()) {}
+
+  Algorithm algorithm() const { return algorithm_; }
+  /// The number of most similar nodes kept for each node
+  uint32_t top_k() const { return top_k_; }
+  /// Pairs less similar than this are never kept
+  double min_similarity() const { return min_similarity_; }
+  /// The number of bands of MinHash signatures
+  uint32_t num_bands() const { return num_bands_; }
+  /// The number of hashes in each band of MinHash signatures
+  uint32_t rows_per_band() const { return rows_per_band_; }
+  /// The seed of the MinHash hash functions
+  uint64_t seed() const { return seed_; }
+
+  /// Compute exact similarities. With min_similarity above 0, only pairs
+  /// that share a neighbor among the rarest ones of both nodes are compared.
+  static JaccardSimilarityJoinPlan Exact(
+      uint32_t top_k = kDefaultTopK, double min_similarity = 0) {
+    return {kCPU, kExact, top_k, min_similarity, 0, 0, 0};
+  }
+
+  /// Estimate similarities from MinHash signatures of
+  /// num_bands * rows_per_band hashes. Pairs are compared if all hashes of
+  /// some band agree, which for similarity s happens with probability
+  /// 1 - (1 - s^rows_per_band)^num_bands.
+  static JaccardSimilarityJoinPlan MinHash(
+      uint32_t top_k = kDefaultTopK, double min_similarity = 0,
+      uint32_t num_bands = kDefaultNumBands,
+      uint32_t rows_per_band = kDefaultRowsPerBand, uint64_t seed = 0) {
+    return {kCPU,          kMinHash, top_k, min_similarity, num_bands,
+            rows_per_band, seed};
+  }
+};
+
+/// The pairs kept by JaccardSimilarityJoin as an edge list: the i-th pair
+/// is from sources[i] to destinations[i] with similarity similarities[i].
+/// Pairs are grouped by source in increasing order, and the pairs of each
+/// source are in decreasing order of similarity.
+struct KATANA_EXPORT JaccardSimilarityJoinResult {
+  std::vector<uint32_t> sources;
+  std::vector<uint32_t> destinations;
+  std::vector<double> similarities;
+};
+
+/// Find for each node of pg the top_k nodes whose neighbor sets are most
+/// similar to its own, by Jaccard similarity, in one pass over the graph
+/// rather than one call to Jaccard per node. Only pairs with positive
+/// similarity of at least the plan's min_similarity are kept, and nodes with
+/// no edges are not paired. Edges need not be sorted, but there must be no
+/// duplicate edges.
+KATANA_EXPORT Result<JaccardSimilarityJoinResult> JaccardSimilarityJoin(
+    PropertyGraph* pg, JaccardSimilarityJoinPlan plan = {});
+
+/// Like JaccardSimilarityJoin, but return the pairs as the edges of a new
+/// graph with the nodes of pg, with the similarities in the edge property
+/// named similarity_property_name.
+KATANA_EXPORT Result<std::unique_ptr<PropertyGraph>> JaccardSimilarityGraph(
+    PropertyGraph* pg, const std::string& similarity_property_name,
+    JaccardSimilarityJoinPlan plan = {});
+
 struct KATANA_EXPORT JaccardStatistics {
   /// The maximum similarity excluding the comparison node.
   double max_similarity;
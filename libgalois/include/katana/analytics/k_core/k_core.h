@@ -2,6 +2,9 @@
 #define KATANA_LIBGALOIS_KATANA_ANALYTICS_KCORE_KCORE_H_
 
 #include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include <katana/analytics/Plan.h>
 
@@ -17,7 +20,7 @@ namespace katana::analytics {
 class KCorePlan : public Plan {
 public:
   /// Algorithm selectors for KCore
-  enum Algorithm { kSynchronous, kAsynchronous };
+  enum Algorithm { kSynchronous, kAsynchronous, kBucketPeeling };
 
   // Don't allow people to directly construct these, so as to have only one
   // consistent way to configure.
@@ -40,6 +43,11 @@ public:
 
   /// Asynchronous k-core algorithm.
   static KCorePlan Asynchronous() { return {kCPU, kAsynchronous}; }
+
+  /// Bucket peeling k-core algorithm. Computes the core number of every node
+  /// at once, so it costs the same for any k; use it for many values of k or
+  /// through KCoreNumbers.
+  static KCorePlan BucketPeeling() { return {kCPU, kBucketPeeling}; }
 };
 
 /// Compute the k-core for pg. The pg must be symmetric.
@@ -51,6 +59,46 @@ KATANA_EXPORT Result<void> KCore(
     PropertyGraph* pg, uint32_t k_core_number,
     const std::string& output_property_name, KCorePlan plan = KCorePlan());
 
+/// Compute the core number of every node of pg: the largest k such that the
+/// node is in the k-core. The pg must be symmetric.
+/// The property named output_property_name is created by this function and may
+/// not exist before the call. It has type uint32_t.
+KATANA_EXPORT Result<void> KCoreNumbers(
+    PropertyGraph* pg, const std::string& output_property_name);
+
+/// Compute a degeneracy ordering of pg, e.g., to relabel it before counting
+/// triangles: an order of the nodes in which each node has at most d
+/// neighbors after it, where d is the largest core number. It comes from the
+/// same peeling as KCoreNumbers, so core numbers do not decrease along it.
+/// The pg must be symmetric.
+/// The property named output_property_name is created by this function and may
+/// not exist before the call. It has type uint32_t and holds the position of
+/// each node in the ordering.
+KATANA_EXPORT Result<void> KCoreDegeneracyOrder(
+    PropertyGraph* pg, const std::string& output_property_name);
+
+/// Update the core numbers in the property named core_number_property_name,
+/// as computed by KCoreNumbers, after a batch of edge changes, without
+/// recomputing them from scratch. pg is the graph after the changes and must
+/// be symmetric; inserted_edges and deleted_edges list the edges added to and
+/// removed from it, each once in either direction. Self loops are not
+/// supported. The property is updated in place.
+///
+/// Deletions only lower core numbers, so the old ones are an upper bound and
+/// each node reached from the ends of the deleted edges is lowered to the
+/// h-index of its neighbors' numbers until none changes. Insertions are
+/// applied in rounds of edges that share no root, the end of lower core
+/// number (both if equal). In a round, numbers rise by at most one and only
+/// in the subcores of the roots: the nodes of the same core number connected
+/// to them that have more neighbors of at least their number than it. Those
+/// are raised by one and lowered back the same way. The work is proportional
+/// to the regions the changes affect, and the nodes of a round, or of all the
+/// deletions, are processed in parallel.
+KATANA_EXPORT Result<void> KCoreNumbersIncremental(
+    PropertyGraph* pg, const std::string& core_number_property_name,
+    const std::vector<std::pair<uint32_t, uint32_t>>& inserted_edges,
+    const std::vector<std::pair<uint32_t, uint32_t>>& deleted_edges);
+
 KATANA_EXPORT Result<void> KCoreAssertValid(
     PropertyGraph* pg, uint32_t k_core_number,
     const std::string& property_name);
@@ -0,0 +1,78 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_KSHORTESTPATHS_KSHORTESTPATHS_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_KSHORTESTPATHS_KSHORTESTPATHS_H_
+
+#include <string>
+#include <vector>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+#include "katana/analytics/sssp/sssp.h"
+
+namespace katana::analytics {
+
+/// A computational plan for KShortestPaths, specifying the algorithm and any
+/// parameters associated with it.
+class KShortestPathsPlan : public Plan {
+public:
+  /// Algorithm selectors for KShortestPaths
+  enum Algorithm { kYen, kLawler, kAStar };
+
+  static const unsigned kDefaultDelta = 13;
+
+private:
+  Algorithm algorithm_;
+  unsigned delta_;
+
+  KShortestPathsPlan(
+      Architecture architecture, Algorithm algorithm, unsigned delta)
+      : Plan(architecture), algorithm_(algorithm), delta_(delta) {}
+
+public:
+  KShortestPathsPlan() : KShortestPathsPlan{kCPU, kAStar, kDefaultDelta} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  /// The shift of the bucket width of the delta-stepping search for the
+  /// shortest path tree to the target: distances d and d' are in the same
+  /// bucket if d >> delta == d' >> delta. Only used by AStar.
+  unsigned delta() const { return delta_; }
+
+  /// Yen's algorithm as published: every node of the last path found is a
+  /// spur node, and each spur path is found by a Dijkstra search. The spur
+  /// searches of a path run in parallel.
+  static KShortestPathsPlan Yen() { return {kCPU, kYen, kDefaultDelta}; }
+
+  /// Yen's algorithm with Lawler's rule: only the spur nodes from where the
+  /// last path left its parent path on are searched, since the earlier ones
+  /// were searched for the parent path already.
+  static KShortestPathsPlan Lawler() {
+    return {kCPU, kLawler, kDefaultDelta};
+  }
+
+  /// Yen's algorithm with Lawler's rule, and the shortest path tree to the
+  /// target computed once by a parallel delta-stepping search over in-edges.
+  /// Every spur path search then starts by checking whether the tree path
+  /// from the spur node is allowed, and otherwise runs an A* search guided
+  /// by the tree distances. The spur searches of each path run in parallel
+  /// and stop early at the target, or once they cannot beat the candidates
+  /// already known.
+  static KShortestPathsPlan AStar(unsigned delta = kDefaultDelta) {
+    return {kCPU, kAStar, delta};
+  }
+};
+
+/// Find the k shortest simple paths from source to target, in increasing
+/// order of distance. Which paths of equal distance are returned does not
+/// depend on the number of threads, but may depend on the algorithm. Fewer
+/// than k paths are returned if there are not that many.
+/// No node property is created. The edge weights are taken from
+/// edge_weight_property_name, as for Sssp, and must not be negative. The
+/// first call on pg builds and caches its bidirectional view.
+KATANA_EXPORT Result<std::vector<SsspPath>> KShortestPaths(
+    PropertyGraph* pg, uint32_t source, uint32_t target, uint32_t k,
+    const std::string& edge_weight_property_name,
+    KShortestPathsPlan plan = {});
+
+}  // namespace katana::analytics
+
+#endif
@@ -16,7 +16,12 @@ namespace katana::analytics {
 class KTrussPlan : public Plan {
 public:
   /// Algorithm selectors for KCore
-  enum Algorithm { kBsp, kBspJacobi, kBspCoreThenTruss };
+  enum Algorithm {
+    kBsp,
+    kBspJacobi,
+    kBspCoreThenTruss,
+    kTrussDecomposition
+  };
 
   // Don't allow people to directly construct these, so as to have only one
   // consistent way to configure.
@@ -39,6 +44,12 @@ public:
 
   /// Compute k-1 core and then k-truss algorithm.
   static KTrussPlan BspCoreThenTruss() { return {kCPU, kBspCoreThenTruss}; }
+
+  /// Compute the trussness of every edge at once by peeling edges in order of
+  /// support, and keep edges whose trussness is at least k.
+  static KTrussPlan TrussDecomposition() {
+    return {kCPU, kTrussDecomposition};
+  }
 };
 
 /// Compute the k-truss for pg. The pg is expected to be
@@ -53,6 +64,15 @@ KATANA_EXPORT Result<void> KTruss(
     PropertyGraph* pg, uint32_t k_truss_number,
     const std::string& output_property_name, KTrussPlan plan = KTrussPlan());
 
+/// Compute the trussness of every edge of pg: the largest k such that the
+/// edge is in the k-truss. Edges in no triangle have trussness 2. The pg is
+/// expected to be symmetric, and both directions of an edge get the same
+/// trussness.
+/// The property named output_property_name is created by this function and may
+/// not exist before the call. It has type uint32_t.
+KATANA_EXPORT Result<void> KTrussNumbers(
+    PropertyGraph* pg, const std::string& output_property_name);
+
 KATANA_EXPORT Result<void> KTrussAssertValid(
     PropertyGraph* pg, uint32_t k_truss_number,
     const std::string& property_name);
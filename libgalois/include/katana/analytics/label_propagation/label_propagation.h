@@ -0,0 +1,97 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_LABELPROPAGATION_LABELPROPAGATION_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_LABELPROPAGATION_LABELPROPAGATION_H_
+
+#include <iostream>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+
+namespace katana::analytics {
+
+/// A computational plan for LabelPropagation, specifying the algorithm and
+/// when to stop.
+class LabelPropagationPlan : public Plan {
+public:
+  /// Algorithm selectors for LabelPropagation
+  enum Algorithm { kFrontier };
+
+  static constexpr double kDefaultChangedFractionThreshold = 0.001;
+  static const uint32_t kDefaultMaxIterations = 20;
+
+private:
+  Algorithm algorithm_;
+  double changed_fraction_threshold_;
+  uint32_t max_iterations_;
+
+  LabelPropagationPlan(
+      Architecture architecture, Algorithm algorithm,
+      double changed_fraction_threshold, uint32_t max_iterations)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        changed_fraction_threshold_(changed_fraction_threshold),
+        max_iterations_(max_iterations) {}
+
+public:
+  LabelPropagationPlan() : LabelPropagationPlan(Frontier()) {}
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  /// Stop after a round in which fewer than this fraction of the nodes
+  /// changed label.
+  double changed_fraction_threshold() const {
+    return changed_fraction_threshold_;
+  }
+
+  /// Stop after this many rounds.
+  uint32_t max_iterations() const { return max_iterations_; }
+
+  /// Asynchronous label propagation: every node in the frontier takes the
+  /// most frequent label among its neighbors, reading the labels already
+  /// updated in the round, and the neighbors of the nodes that changed form
+  /// the frontier of the next round. Labels are counted in a per-thread
+  /// vector rather than a hash map.
+  ///
+  /// RAGHAVAN, Usha Nandini; ALBERT, Réka; KUMARA, Soundar. Near linear time
+  /// algorithm to detect community structures in large-scale networks.
+  /// Physical Review E, 2007.
+  static LabelPropagationPlan Frontier(
+      double changed_fraction_threshold = kDefaultChangedFractionThreshold,
+      uint32_t max_iterations = kDefaultMaxIterations) {
+    return {kCPU, kFrontier, changed_fraction_threshold, max_iterations};
+  }
+};
+
+/// Detect communities in pg by label propagation, treating edges as
+/// undirected. Create a node property with the label of every node, which is
+/// the ID of the node whose label spread to its community.
+/// The property named output_property_name is created by this function and
+/// may not exist before the call. The created property has type uint32_t.
+KATANA_EXPORT Result<void> LabelPropagation(
+    PropertyGraph* pg, const std::string& output_property_name,
+    LabelPropagationPlan plan = {});
+
+/// Check that every label is a node ID. Label propagation stops before a
+/// fixed point, so the communities themselves are not checked.
+KATANA_EXPORT Result<void> LabelPropagationAssertValid(
+    PropertyGraph* pg, const std::string& property_name);
+
+struct KATANA_EXPORT LabelPropagationStatistics {
+  /// Total number of communities in the graph.
+  uint64_t total_communities;
+  /// Total number of communities with more than 1 node.
+  uint64_t total_non_trivial_communities;
+  /// The number of nodes present in the largest community.
+  uint64_t largest_community_size;
+  /// The ratio of nodes present in the largest community.
+  double largest_community_ratio;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<LabelPropagationStatistics> Compute(
+      katana::PropertyGraph* pg, const std::string& property_name);
+};
+
+}  // namespace katana::analytics
+
+#endif
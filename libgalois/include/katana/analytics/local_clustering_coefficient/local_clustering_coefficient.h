@@ -14,7 +14,11 @@ namespace katana::analytics {
 /// Clustering Coefficient of the nodes in the graph.
 class LocalClusteringCoefficientPlan : public Plan {
 public:
-  enum Algorithm { kOrderedCountAtomics, kOrderedCountPerThread };
+  enum Algorithm {
+    kOrderedCountAtomics,
+    kOrderedCountPerThread,
+    kOrderedCountHybrid
+  };
 
   enum Relabeling {
     kRelabel,
@@ -41,7 +45,7 @@ private:
 public:
   LocalClusteringCoefficientPlan()
       : LocalClusteringCoefficientPlan{
-            kCPU, kOrderedCountPerThread, kDefaultEdgesSorted,
+            kCPU, kOrderedCountHybrid, kDefaultEdgesSorted,
             kDefaultRelabeling} {}
 
   Algorithm algorithm() const { return algorithm_; }
@@ -64,11 +68,29 @@ public:
     return {kCPU, kOrderedCountAtomics, edges_sorted, relabeling};
   }
 
+  /**
+   * The ordered count algorithm with a separate count of every node for
+   * every thread. Its memory is num_nodes * num_threads counters, so it only
+   * suits small graphs.
+   */
   static LocalClusteringCoefficientPlan OrderedCountPerThread(
       bool edges_sorted = kDefaultEdgesSorted,
       Relabeling relabeling = kDefaultRelabeling) {
     return {kCPU, kOrderedCountPerThread, edges_sorted, relabeling};
   }
+
+  /**
+   * The ordered count algorithm where each thread combines the counts of
+   * the nodes it has seen last in a small fixed size cache, and adds them to
+   * a single count per node with atomics when they are evicted. This bounds
+   * memory to num_nodes counters plus a few KiB per thread and avoids atomic
+   * contention on hubs.
+   */
+  static LocalClusteringCoefficientPlan OrderedCountHybrid(
+      bool edges_sorted = kDefaultEdgesSorted,
+      Relabeling relabeling = kDefaultRelabeling) {
+    return {kCPU, kOrderedCountHybrid, edges_sorted, relabeling};
+  }
 };
 
 /**
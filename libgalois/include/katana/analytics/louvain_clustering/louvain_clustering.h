@@ -16,6 +16,7 @@ public:
   enum Algorithm {
     kDoAll,
     kDeterministic,
+    kLeiden,
   };
 
   static const bool kDefaultEnableVF = false;
@@ -110,6 +111,27 @@ public:
         max_iterations,
         min_graph_size};
   }
+
+  /// Leiden algorithm: local moving as in DoAll, followed by a refinement
+  /// that splits every cluster into well connected sub-clusters. The
+  /// coarsened graph has a node per sub-cluster, which starts in the
+  /// cluster of its nodes.
+  static LouvainClusteringPlan Leiden(
+      bool enable_vf = kDefaultEnableVF,
+      double modularity_threshold_per_round =
+          kDefaultModularityThresholdPerRound,
+      double modularity_threshold_total = kDefaultModularityThresholdTotal,
+      uint32_t max_iterations = kDefaultMaxIterations,
+      uint32_t min_graph_size = kDefaultMinGraphSize) {
+    return {
+        kCPU,
+        kLeiden,
+        enable_vf,
+        modularity_threshold_per_round,
+        modularity_threshold_total,
+        max_iterations,
+        min_graph_size};
+  }
 };
 
 /// Compute the Louvain Clustering for pg.
@@ -0,0 +1,177 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_MATRIXCOMPLETION_MATRIXCOMPLETION_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_MATRIXCOMPLETION_MATRIXCOMPLETION_H_
+
+#include <iostream>
+#include <string>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+
+namespace katana::analytics {
+
+/// A computational plan for MatrixCompletion, specifying the algorithm and
+/// its parameters.
+class MatrixCompletionPlan : public Plan {
+public:
+  /// Algorithm selectors for MatrixCompletion
+  enum Algorithm { kSGD, kALS };
+
+  static const uint32_t kDefaultLatentVectorSize = 20;
+  constexpr static const double kDefaultLambda = 0.05;
+  constexpr static const double kDefaultLearningRate = 0.012;
+  constexpr static const double kDefaultDecayRate = 0.015;
+  constexpr static const double kDefaultTolerance = 0.01;
+  static const uint32_t kDefaultMaxIterations = 100;
+  static const uint32_t kDefaultUsersPerBlock = 2048;
+  static const uint32_t kDefaultItemsPerBlock = 350;
+
+private:
+  Algorithm algorithm_;
+  uint32_t latent_vector_size_;
+  double lambda_;
+  double learning_rate_;
+  double decay_rate_;
+  double tolerance_;
+  uint32_t max_iterations_;
+  uint32_t users_per_block_;
+  uint32_t items_per_block_;
+
+  MatrixCompletionPlan(
+      Architecture architecture, Algorithm algorithm,
+      uint32_t latent_vector_size, double lambda, double learning_rate,
+      double decay_rate, double tolerance, uint32_t max_iterations,
+      uint32_t users_per_block, uint32_t items_per_block)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        latent_vector_size_(latent_vector_size),
+        lambda_(lambda),
+        learning_rate_(learning_rate),
+        decay_rate_(decay_rate),
+        tolerance_(tolerance),
+        max_iterations_(max_iterations),
+        users_per_block_(users_per_block),
+        items_per_block_(items_per_block) {}
+
+public:
+  MatrixCompletionPlan() : MatrixCompletionPlan(SGD()) {}
+
+  MatrixCompletionPlan& operator=(const MatrixCompletionPlan&) = default;
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  /// The length of the latent vector of each node
+  uint32_t latent_vector_size() const { return latent_vector_size_; }
+
+  /// The weight of the squared norms of the latent vectors in the objective
+  double lambda() const { return lambda_; }
+
+  /// The initial step size of SGD
+  double learning_rate() const { return learning_rate_; }
+
+  /// How fast the step size of SGD decreases with the round
+  double decay_rate() const { return decay_rate_; }
+
+  /// Stop once the squared error changes by less than this fraction in a
+  /// round
+  double tolerance() const { return tolerance_; }
+
+  /// The maximum number of rounds
+  uint32_t max_iterations() const { return max_iterations_; }
+
+  /// The number of consecutive user IDs in an SGD block
+  uint32_t users_per_block() const { return users_per_block_; }
+
+  /// The number of consecutive item IDs in an SGD block
+  uint32_t items_per_block() const { return items_per_block_; }
+
+  /// Lock-free stochastic gradient descent. Each round sweeps every block of
+  /// users over all the blocks of items, so that the latent vectors of the
+  /// blocks stay in cache, and concurrent blocks of users start at different
+  /// blocks of items. Updates that do race are not synchronized, as in
+  /// Hogwild. The step size of round r is
+  /// learning_rate * 1.5 / (1 + decay_rate * (r + 1)^1.5).
+  ///
+  /// RECHT, Benjamin; RE, Christopher; WRIGHT, Stephen; NIU, Feng. Hogwild!:
+  /// A lock-free approach to parallelizing stochastic gradient descent. In:
+  /// Advances in Neural Information Processing Systems (NIPS), 2011.
+  static MatrixCompletionPlan SGD(
+      uint32_t latent_vector_size = kDefaultLatentVectorSize,
+      double lambda = kDefaultLambda,
+      double learning_rate = kDefaultLearningRate,
+      double decay_rate = kDefaultDecayRate,
+      double tolerance = kDefaultTolerance,
+      uint32_t max_iterations = kDefaultMaxIterations,
+      uint32_t users_per_block = kDefaultUsersPerBlock,
+      uint32_t items_per_block = kDefaultItemsPerBlock) {
+    return {
+        kCPU,
+        kSGD,
+        latent_vector_size,
+        lambda,
+        learning_rate,
+        decay_rate,
+        tolerance,
+        max_iterations,
+        users_per_block,
+        items_per_block};
+  }
+
+  /// Alternating least squares with weighted regularization. Each round
+  /// solves for the latent vectors of all users with those of the items
+  /// fixed, then for those of the items. Each latent vector is the solution
+  /// of a least squares problem of the size of the latent vectors, and the
+  /// problems are solved in parallel. The results do not depend on the
+  /// number of threads.
+  ///
+  /// ZHOU, Yunhong; WILKINSON, Dennis; SCHREIBER, Robert; PAN, Rong.
+  /// Large-scale parallel collaborative filtering for the Netflix prize. In:
+  /// Algorithmic Aspects in Information and Management (AAIM), 2008.
+  static MatrixCompletionPlan ALS(
+      uint32_t latent_vector_size = kDefaultLatentVectorSize,
+      double lambda = kDefaultLambda, double tolerance = kDefaultTolerance,
+      uint32_t max_iterations = kDefaultMaxIterations) {
+    return {
+        kCPU,
+        kALS,
+        latent_vector_size,
+        lambda,
+        kDefaultLearningRate,
+        kDefaultDecayRate,
+        tolerance,
+        max_iterations,
+        kDefaultUsersPerBlock,
+        kDefaultItemsPerBlock};
+  }
+};
+
+/// Factor the sparse matrix of ratings that users give items into latent
+/// vectors, so that the inner product of the latent vectors of a user and an
+/// item approximates the rating. Each edge is a rating from its source, a
+/// user, to its destination, an item, and its rating is the value of
+/// rating_property_name, which may have any numeric type. No node may have
+/// both in- and out-edges. The objective is the sum over the ratings of the
+/// squared error plus lambda times the squared norms of the latent vectors of
+/// the user and the item.
+/// The property named output_property_name is created by this function and may
+/// not exist before the call. The created property is a fixed size list of
+/// latent_vector_size floats. The latent vectors of nodes without edges keep
+/// their (deterministic, random) initial values.
+KATANA_EXPORT Result<void> MatrixCompletion(
+    PropertyGraph* pg, const std::string& rating_property_name,
+    const std::string& output_property_name, MatrixCompletionPlan plan = {});
+
+struct KATANA_EXPORT MatrixCompletionStatistics {
+  /// The root mean squared error of the predicted ratings.
+  double rmse;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<MatrixCompletionStatistics> Compute(
+      katana::PropertyGraph* pg, const std::string& rating_property_name,
+      const std::string& output_property_name);
+};
+
+}  // namespace katana::analytics
+
+#endif
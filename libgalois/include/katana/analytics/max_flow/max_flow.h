@@ -0,0 +1,111 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_MAXFLOW_MAXFLOW_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_MAXFLOW_MAXFLOW_H_
+
+#include <iostream>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+
+namespace katana::analytics {
+
+/// A computational plan for MaxFlow, specifying how often heights are
+/// recomputed and whether gaps are detected.
+class MaxFlowPlan : public Plan {
+public:
+  /// Algorithm selectors for MaxFlow
+  enum Algorithm { kPushRelabel };
+
+  constexpr static const double kDefaultGlobalRelabelFrequency = 1.0;
+  static const bool kDefaultGapRelabeling = true;
+
+private:
+  Algorithm algorithm_;
+  double global_relabel_frequency_;
+  bool gap_relabeling_;
+
+  MaxFlowPlan(
+      Architecture architecture, Algorithm algorithm,
+      double global_relabel_frequency, bool gap_relabeling)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        global_relabel_frequency_(global_relabel_frequency),
+        gap_relabeling_(gap_relabeling) {}
+
+public:
+  MaxFlowPlan() : MaxFlowPlan(PushRelabel()) {}
+
+  MaxFlowPlan& operator=(const MaxFlowPlan&) = default;
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  /// Heights are recomputed after this many times 6 * |V| + |E| units of
+  /// work, where a unit is one residual arc scanned.
+  double global_relabel_frequency() const { return global_relabel_frequency_; }
+
+  /// Whether nodes above an empty height are lifted out of reach as soon as
+  /// the height empties, rather than at the next global relabel.
+  bool gap_relabeling() const { return gap_relabeling_; }
+
+  /// Asynchronous lock-free push-relabel. Active nodes are discharged in
+  /// parallel, pushing to any lower neighbor, with atomic updates of the
+  /// residual capacities and excesses. Heights are recomputed exactly by a
+  /// parallel breadth first search from the sink, globally relabeling, once
+  /// the work since the last global relabel exceeds the Cherkassky-Goldberg
+  /// interval scaled by global_relabel_frequency. A second phase returns the
+  /// excess that cannot reach the sink to the source.
+  ///
+  /// HONG, Bo; HE, Zhengyu. An asynchronous multithreaded algorithm for the
+  /// maximum network flow problem with nonblocking global relabeling
+  /// heuristic. IEEE Transactions on Parallel and Distributed Systems, 2011.
+  ///
+  /// CHERKASSKY, Boris V.; GOLDBERG, Andrew V. On implementing the
+  /// push-relabel method for the maximum flow problem. Algorithmica, 1997.
+  static MaxFlowPlan PushRelabel(
+      double global_relabel_frequency = kDefaultGlobalRelabelFrequency,
+      bool gap_relabeling = kDefaultGapRelabeling) {
+    return {kCPU, kPushRelabel, global_relabel_frequency, gap_relabeling};
+  }
+};
+
+/// Compute a maximum flow from source to sink, where the capacity of each
+/// edge is given by the edge property capacity_property_name, which must have
+/// a non-negative integer type. Create an edge property with the flow on each
+/// edge, and a node property which is 1 for the nodes on the source side of a
+/// minimum cut, those reachable from the source in the final residual graph,
+/// and 0 for the others.
+/// The properties named output_flow_property_name and
+/// output_cut_property_name are created by this function and may not exist
+/// before the call. The created properties have types uint64_t and uint8_t.
+KATANA_EXPORT Result<void> MaxFlow(
+    PropertyGraph* pg, uint32_t source, uint32_t sink,
+    const std::string& capacity_property_name,
+    const std::string& output_flow_property_name,
+    const std::string& output_cut_property_name, MaxFlowPlan plan = {});
+
+/// Check that the flow property respects the capacities and conserves flow at
+/// every node but source and sink, and that no path from source to sink
+/// remains in the residual graph.
+KATANA_EXPORT Result<void> MaxFlowAssertValid(
+    PropertyGraph* pg, uint32_t source, uint32_t sink,
+    const std::string& capacity_property_name,
+    const std::string& flow_property_name);
+
+struct KATANA_EXPORT MaxFlowStatistics {
+  /// The net flow out of the source.
+  uint64_t flow_value;
+
+  /// The number of edges from the source side of the cut to the sink side.
+  uint64_t num_cut_edges;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<MaxFlowStatistics> Compute(
+      katana::PropertyGraph* pg, uint32_t source,
+      const std::string& flow_property_name,
+      const std::string& cut_property_name);
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_MINIMUMSPANNINGFOREST_MINIMUMSPANNINGFOREST_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_MINIMUMSPANNINGFOREST_MINIMUMSPANNINGFOREST_H_
+
+#include <iostream>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+
+namespace katana::analytics {
+
+/// A computational plan for MinimumSpanningForest, specifying the algorithm.
+class MinimumSpanningForestPlan : public Plan {
+public:
+  /// Algorithm selectors for MinimumSpanningForest
+  enum Algorithm { kBoruvka, kFilterKruskal };
+
+  static const uint64_t kDefaultBaseCaseSize = 1 << 16;
+
+private:
+  Algorithm algorithm_;
+  uint64_t base_case_size_;
+
+  MinimumSpanningForestPlan(
+      Architecture architecture, Algorithm algorithm, uint64_t base_case_size)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        base_case_size_(base_case_size) {}
+
+public:
+  MinimumSpanningForestPlan() : MinimumSpanningForestPlan(Boruvka()) {}
+
+  MinimumSpanningForestPlan& operator=(const MinimumSpanningForestPlan&) =
+      default;
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  /// For filter-Kruskal, the number of edges at or below which a range of
+  /// edges is sorted and scanned rather than split further.
+  uint64_t base_case_size() const { return base_case_size_; }
+
+  /// Parallel Boruvka with edge contraction. In each round, every component
+  /// picks its lightest edge, the picked edges are added to the forest, the
+  /// components they join are contracted by pointer jumping, and the edges
+  /// between the new components are gathered into a new compressed sparse
+  /// row graph, keeping only the lightest edge between each pair.
+  static MinimumSpanningForestPlan Boruvka() {
+    return {kCPU, kBoruvka, kDefaultBaseCaseSize};
+  }
+
+  /// Filter-Kruskal. The edges are split around a sampled pivot weight; the
+  /// light edges are processed first, then the heavy edges whose endpoints
+  /// are already connected are filtered out in parallel before the rest are
+  /// processed. Ranges of at most base_case_size edges are sorted in
+  /// parallel and scanned with Kruskal's algorithm. Components are kept in the
+  /// lock-free union-find of katana/UnionFind.h.
+  ///
+  /// OSIPOV, Vitaly; SANDERS, Peter; SINGLER, Johannes. The filter-Kruskal
+  /// minimum spanning tree algorithm. ALENEX, 2009.
+  static MinimumSpanningForestPlan FilterKruskal(
+      uint64_t base_case_size = kDefaultBaseCaseSize) {
+    return {kCPU, kFilterKruskal, base_case_size};
+  }
+};
+
+/// Compute a minimum spanning forest of the graph, where the weight of each
+/// edge is given by the edge property edge_weight_property_name, and create an
+/// edge property which is 1 for the edges in the forest and 0 for the others.
+/// Edges are treated as undirected: parallel edges and the two directions of
+/// a symmetric edge are distinct edges, of which at most one is in the forest.
+/// Ties between equal weights are broken by edge property index, so the forest
+/// is unique.
+/// The property named output_property_name is created by this function and may
+/// not exist before the call. The created property has type uint8_t.
+KATANA_EXPORT Result<void> MinimumSpanningForest(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name,
+    MinimumSpanningForestPlan plan = {});
+
+/// Check that the edges marked in the property form a forest that spans each
+/// connected component. This does not check that the forest is minimum.
+KATANA_EXPORT Result<void> MinimumSpanningForestAssertValid(
+    PropertyGraph* pg, const std::string& property_name);
+
+struct KATANA_EXPORT MinimumSpanningForestStatistics {
+  /// The number of edges in the forest.
+  uint64_t num_forest_edges;
+
+  /// The number of trees in the forest, including isolated nodes.
+  uint64_t num_trees;
+
+  /// The total weight of the edges in the forest.
+  double total_weight;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<MinimumSpanningForestStatistics> Compute(
+      katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+      const std::string& property_name);
+};
+
+}  // namespace katana::analytics
+
+#endif
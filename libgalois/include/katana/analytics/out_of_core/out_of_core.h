@@ -0,0 +1,83 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_OUTOFCORE_OUTOFCORE_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_OUTOFCORE_OUTOFCORE_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <arrow/api.h>
+
+#include "katana/Result.h"
+#include "katana/analytics/Plan.h"
+#include "katana/analytics/pagerank/pagerank.h"
+#include "katana/config.h"
+
+namespace katana::analytics {
+
+/// How out-of-core analytics stream the edges of a graph from storage (see
+/// tsuba::RDGEdgeStream)
+class OutOfCorePlan : public Plan {
+public:
+  static constexpr uint64_t kDefaultBlockBytes = 64UL << 20;
+  static constexpr uint32_t kDefaultResidentBlocks = 2;
+
+  OutOfCorePlan()
+      : OutOfCorePlan(kCPU, kDefaultBlockBytes, kDefaultResidentBlocks) {}
+
+  OutOfCorePlan(
+      Architecture architecture, uint64_t block_bytes,
+      uint32_t max_resident_blocks)
+      : Plan(architecture),
+        block_bytes_(block_bytes),
+        max_resident_blocks_(max_resident_blocks) {}
+
+  /// Stream edges in blocks of about block_bytes bytes, with at most
+  /// max_resident_blocks of them in memory at once. Memory use is about
+  /// block_bytes * max_resident_blocks plus the state of every node.
+  static OutOfCorePlan Blocks(
+      uint64_t block_bytes = kDefaultBlockBytes,
+      uint32_t max_resident_blocks = kDefaultResidentBlocks) {
+    return {kCPU, block_bytes, max_resident_blocks};
+  }
+
+  uint64_t block_bytes() const { return block_bytes_; }
+  uint32_t max_resident_blocks() const { return max_resident_blocks_; }
+
+private:
+  uint64_t block_bytes_;
+  uint32_t max_resident_blocks_;
+};
+
+/// The analytics below run on graphs whose edges do not fit in memory. They
+/// are edge centric, like X-Stream: the state of every node is kept in
+/// memory while the edges of the topology of the RDG at rdg_name are
+/// streamed from storage, block by block, once per iteration, without
+/// loading the graph. The edges of a block are processed in parallel while
+/// the next blocks are fetched. Partitioned and compressed topologies are
+/// not supported.
+
+/// Compute the PageRank of every node, which sum to 1, by iterating until
+/// the ranks change by less than the tolerance of pagerank_plan in total or
+/// its maximum number of iterations. Returns a float array.
+KATANA_EXPORT Result<std::shared_ptr<arrow::Array>> OutOfCorePagerank(
+    const std::string& rdg_name,
+    const PagerankPlan& pagerank_plan = PagerankPlan(),
+    const OutOfCorePlan& plan = OutOfCorePlan());
+
+/// Compute the BFS distance, in hops along out edges, from source to every
+/// node. Returns a uint32 array; unreached nodes get the maximum uint32_t.
+/// Each level is one pass over the edges, so this suits graphs of small
+/// diameter.
+KATANA_EXPORT Result<std::shared_ptr<arrow::Array>> OutOfCoreBfs(
+    const std::string& rdg_name, uint64_t source,
+    const OutOfCorePlan& plan = OutOfCorePlan());
+
+/// Compute the weakly connected components by label propagation. Returns a
+/// uint64 array with, for every node, the smallest node of its component.
+KATANA_EXPORT Result<std::shared_ptr<arrow::Array>>
+OutOfCoreConnectedComponents(
+    const std::string& rdg_name, const OutOfCorePlan& plan = OutOfCorePlan());
+
+}  // namespace katana::analytics
+
+#endif
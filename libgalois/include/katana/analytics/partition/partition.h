@@ -0,0 +1,113 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_PARTITION_PARTITION_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_PARTITION_PARTITION_H_
+
+#include <iostream>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+
+namespace katana::analytics {
+
+/// A computational plan for Partition, specifying the balance constraint and
+/// the sizes of the coarsening and refinement phases.
+class PartitionPlan : public Plan {
+public:
+  /// Algorithm selectors for Partition
+  enum Algorithm { kMultilevel };
+
+  static const uint32_t kDefaultCoarsestNodesPerPartition = 20;
+  static const uint32_t kDefaultRefinementRounds = 10;
+  constexpr static const double kDefaultImbalance = 0.03;
+
+private:
+  Algorithm algorithm_;
+  double imbalance_;
+  uint32_t coarsest_nodes_per_partition_;
+  uint32_t refinement_rounds_;
+
+  PartitionPlan(
+      Architecture architecture, Algorithm algorithm, double imbalance,
+      uint32_t coarsest_nodes_per_partition, uint32_t refinement_rounds)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        imbalance_(imbalance),
+        coarsest_nodes_per_partition_(coarsest_nodes_per_partition),
+        refinement_rounds_(refinement_rounds) {}
+
+public:
+  PartitionPlan() : PartitionPlan(Multilevel()) {}
+
+  PartitionPlan& operator=(const PartitionPlan&) = default;
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  /// The fraction by which the number of nodes of a partition may exceed the
+  /// average.
+  double imbalance() const { return imbalance_; }
+
+  /// Coarsening stops when the coarsest graph has at most this many nodes
+  /// per partition.
+  uint32_t coarsest_nodes_per_partition() const {
+    return coarsest_nodes_per_partition_;
+  }
+
+  /// The maximum number of refinement rounds at each level.
+  uint32_t refinement_rounds() const { return refinement_rounds_; }
+
+  /// Multilevel k-way partitioning. The graph is coarsened by contracting a
+  /// heavy edge matching, computed in parallel by rounds of mutual
+  /// proposals, into a hierarchy of compressed sparse row graphs. The
+  /// coarsest graph is split into contiguous ranges of a breadth first
+  /// order, and the partition is projected back through the hierarchy with
+  /// parallel greedy refinement at each level: nodes on the boundary move to
+  /// the neighboring partition that most reduces the edge cut, in alternating
+  /// directions to avoid neighbors swapping. Coarsening is deterministic but
+  /// refinement depends on the schedule.
+  ///
+  /// KARYPIS, George; KUMAR, Vipin. Multilevel k-way partitioning scheme for
+  /// irregular graphs. Journal of Parallel and Distributed Computing, 1998.
+  static PartitionPlan Multilevel(
+      double imbalance = kDefaultImbalance,
+      uint32_t coarsest_nodes_per_partition =
+          kDefaultCoarsestNodesPerPartition,
+      uint32_t refinement_rounds = kDefaultRefinementRounds) {
+    return {
+        kCPU, kMultilevel, imbalance, coarsest_nodes_per_partition,
+        refinement_rounds};
+  }
+};
+
+/// Partition the nodes of the graph into num_partitions parts of at most
+/// (1 + imbalance) times the average number of nodes, minimizing the number
+/// of edges between parts, and create a property with the partition of each
+/// node. Edges are treated as undirected; parallel edges in either direction
+/// count once each and self loops are ignored.
+/// The property named output_property_name is created by this function and may
+/// not exist before the call. The created property has type uint32_t.
+KATANA_EXPORT Result<void> Partition(
+    PropertyGraph* pg, uint32_t num_partitions,
+    const std::string& output_property_name, PartitionPlan plan = {});
+
+struct KATANA_EXPORT PartitionStatistics {
+  /// The number of partitions, one more than the largest partition ID.
+  uint32_t num_partitions;
+
+  /// The number of edges whose endpoints are in different partitions.
+  uint64_t edge_cut;
+
+  /// The largest number of nodes in a partition.
+  uint64_t largest_partition_size;
+
+  /// The ratio of the largest partition size to the average.
+  double imbalance;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<PartitionStatistics> Compute(
+      katana::PropertyGraph* pg, const std::string& property_name);
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -0,0 +1,111 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_PATTERNMATCHING_PATTERNMATCHING_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_PATTERNMATCHING_PATTERNMATCHING_H_
+
+#include <functional>
+#include <optional>
+#include <vector>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+
+namespace katana::analytics {
+
+/// A small directed pattern to find in a graph. Nodes and edges may require
+/// an entity type, which a matched node or edge must have (it may also have
+/// more specific types), e.g., pg->GetNodeEntityTypeID("Person").
+///
+/// \code
+/// // Diamonds: two paths of length 2 from a to d
+/// PatternQuery diamond;
+/// uint32_t a = diamond.AddNode();
+/// uint32_t b = diamond.AddNode();
+/// uint32_t c = diamond.AddNode();
+/// uint32_t d = diamond.AddNode();
+/// diamond.AddEdge(a, b);
+/// diamond.AddEdge(a, c);
+/// diamond.AddEdge(b, d);
+/// diamond.AddEdge(c, d);
+/// \endcode
+class KATANA_EXPORT PatternQuery {
+public:
+  struct Node {
+    std::optional<EntityTypeID> type;
+  };
+
+  struct Edge {
+    uint32_t src;
+    uint32_t dst;
+    std::optional<EntityTypeID> type;
+  };
+
+  /// Add a node and return its index in matches
+  uint32_t AddNode(std::optional<EntityTypeID> type = std::nullopt) {
+    nodes_.emplace_back(Node{type});
+    return nodes_.size() - 1;
+  }
+
+  void AddEdge(
+      uint32_t src, uint32_t dst,
+      std::optional<EntityTypeID> type = std::nullopt) {
+    edges_.emplace_back(Edge{src, dst, type});
+  }
+
+  const std::vector<Node>& nodes() const { return nodes_; }
+  const std::vector<Edge>& edges() const { return edges_; }
+
+private:
+  std::vector<Node> nodes_;
+  std::vector<Edge> edges_;
+};
+
+/// A computational plan for PatternMatchCount and PatternMatchEnumerate.
+class PatternMatchingPlan : public Plan {
+public:
+  /// Algorithm selectors for pattern matching
+  enum Algorithm { kGenericJoin };
+
+private:
+  Algorithm algorithm_;
+
+  PatternMatchingPlan(Architecture architecture, Algorithm algorithm)
+      : Plan(architecture), algorithm_(algorithm) {}
+
+public:
+  PatternMatchingPlan() : PatternMatchingPlan(GenericJoin()) {}
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  /// Worst-case optimal join: the pattern nodes are bound one at a time, in
+  /// an order where each node is adjacent to the ones before it, and the
+  /// candidates for a node are the intersection of the sorted neighbor lists
+  /// of its bound neighbors. Every node of the graph starts a depth-first
+  /// search on some thread; idle threads steal start nodes.
+  ///
+  /// NGO, Hung Q.; RÉ, Christopher; RUDRA, Atri. Skew strikes back: new
+  /// developments in the theory of join algorithms. SIGMOD Record, 2014.
+  static PatternMatchingPlan GenericJoin() { return {kCPU, kGenericJoin}; }
+};
+
+/// Called with every match; match[i] is the node matched to pattern node i.
+/// The sink is called concurrently from many threads.
+using PatternMatchSink = std::function<void(const std::vector<uint32_t>&)>;
+
+/// Count the matches of query in pg. A match maps the pattern nodes to
+/// distinct nodes such that every pattern edge src -> dst has an edge of
+/// the required type from the node of src to the node of dst. Symmetric
+/// matches, e.g., the rotations of a cycle, are counted separately, and
+/// parallel edges do not multiply matches. The pattern must be connected and
+/// have no self loops.
+KATANA_EXPORT Result<uint64_t> PatternMatchCount(
+    PropertyGraph* pg, const PatternQuery& query,
+    PatternMatchingPlan plan = {});
+
+/// Call sink with every match of query in pg, as counted by
+/// PatternMatchCount.
+KATANA_EXPORT Result<void> PatternMatchEnumerate(
+    PropertyGraph* pg, const PatternQuery& query, const PatternMatchSink& sink,
+    PatternMatchingPlan plan = {});
+
+}  // namespace katana::analytics
+
+#endif
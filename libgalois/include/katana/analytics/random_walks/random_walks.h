@@ -1,11 +1,18 @@
 #ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_RANDOMWALKS_RANDOMWALKS_H_
 #define KATANA_LIBGALOIS_KATANA_ANALYTICS_RANDOMWALKS_RANDOMWALKS_H_
 
+#include <algorithm>
+#include <functional>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <string>
 
+#include <arrow/api.h>
 #include <katana/analytics/Plan.h>
 
 #include "katana/AtomicHelpers.h"
+#include "katana/TemporalEdgeIndex.h"
 #include "katana/analytics/Utils.h"
 
 // API
@@ -26,6 +33,7 @@ public:
   constexpr static const double kDefaultForwardProbability = 1.0;
   static const uint32_t kDefaultMaxIterations = 10;
   static const uint32_t kDefaultNumberOfEdgeTypes = 1;
+  static const uint64_t kDefaultAliasTableMaxBytes = uint64_t{1} << 30;
 
   // Don't allow people to directly construct these, so as to have only one
   // consistent way to configure.
@@ -40,12 +48,13 @@ private:
   // Only need for edge2vec
   // TODO(gill) Find number of edge types automatically
   uint32_t number_of_edge_types_;
+  uint64_t alias_table_max_bytes_;
 
   RandomWalksPlan(
       Architecture architecture, Algorithm algorithm, uint32_t walk_length,
       uint32_t number_of_walks, double backward_probability,
       double forward_probability, uint32_t max_iterations,
-      uint32_t number_of_edge_types)
+      uint32_t number_of_edge_types, uint64_t alias_table_max_bytes)
       : Plan(architecture),
         algorithm_(algorithm),
         walk_length_(walk_length),
@@ -53,7 +62,8 @@ private:
         backward_probability_(backward_probability),
         forward_probability_(forward_probability),
         max_iterations_(max_iterations),
-        number_of_edge_types_(number_of_edge_types) {}
+        number_of_edge_types_(number_of_edge_types),
+        alias_table_max_bytes_(alias_table_max_bytes) {}
 
 public:
   // kChunkSize is fixed at 1
@@ -68,7 +78,8 @@ public:
             kDefaultBackwardProbability,
             kDefaultForwardProbability,
             kDefaultMaxIterations,
-            kDefaultNumberOfEdgeTypes} {}
+            kDefaultNumberOfEdgeTypes,
+            kDefaultAliasTableMaxBytes} {}
 
   Algorithm algorithm() const { return algorithm_; }
 
@@ -95,12 +106,23 @@ public:
 
   uint32_t number_of_edge_types() const { return number_of_edge_types_; }
 
+  /// Memory for the alias tables of weighted walks. Nodes of high degree get
+  /// a table, from which a step is sampled in constant time, highest degree
+  /// first until the tables would take more than this; the other nodes
+  /// binary search the prefix sums of their edge weights.
+  uint64_t alias_table_max_bytes() const { return alias_table_max_bytes_; }
+
+  /// Number of node ids each walk takes in the flat output of RandomWalks:
+  /// the start node followed by walk_length() steps (at least one).
+  uint32_t walk_stride() const { return std::max(walk_length_, 1U) + 1; }
+
   /// Node2Vec algorithm to generate random walks on the graph
   static RandomWalksPlan Node2Vec(
       uint32_t walk_length = kDefaultWalkLength,
       uint32_t number_of_walks = kDefaultNumberOfWalks,
       double backward_probability = kDefaultBackwardProbability,
-      double forward_probability = kDefaultBackwardProbability) {
+      double forward_probability = kDefaultBackwardProbability,
+      uint64_t alias_table_max_bytes = kDefaultAliasTableMaxBytes) {
     return {
         kCPU,
         kNode2Vec,
@@ -109,7 +131,8 @@ public:
         backward_probability,
         forward_probability,
         0,
-        1};
+        1,
+        alias_table_max_bytes};
   }
 
   /// Edge2Vec algorithm to generate random walks on the graph.
@@ -120,7 +143,8 @@ public:
       double backward_probability = kDefaultBackwardProbability,
       double forward_probability = kDefaultBackwardProbability,
       uint32_t max_iterations = kDefaultMaxIterations,
-      uint32_t number_of_edge_types = kDefaultNumberOfEdgeTypes) {
+      uint32_t number_of_edge_types = kDefaultNumberOfEdgeTypes,
+      uint64_t alias_table_max_bytes = kDefaultAliasTableMaxBytes) {
     return {
         kCPU,
         kNode2Vec,
@@ -129,17 +153,87 @@ public:
         backward_probability,
         forward_probability,
         max_iterations,
-        number_of_edge_types};
+        number_of_edge_types,
+        alias_table_max_bytes};
   }
 };
 
 /// Compute the random-walks for pg. The pg is expected to be symmetric. The
 /// parameters can be specified, but have reasonable defaults. Not all
 /// parameters are used by the algorithms. The generated random-walks generated
-/// are returned as a vector of vectors.
+/// are returned as a vector of vectors, each walk in an allocation of its
+/// own; the overloads below avoid that for large outputs.
 KATANA_EXPORT Result<std::vector<std::vector<uint32_t>>> RandomWalks(
     PropertyGraph* pg, RandomWalksPlan plan = RandomWalksPlan());
 
+/// Fills the ends of walks that are shorter than
+/// RandomWalksPlan::walk_stride() in flat walk buffers
+constexpr uint32_t kRandomWalkPadding = std::numeric_limits<uint32_t>::max();
+
+/// Default number of walks in each chunk passed to a RandomWalksSink
+constexpr uint64_t kRandomWalksDefaultChunkSize = uint64_t{1} << 16;
+
+/// Upper bound on the number of walks RandomWalks generates for pg: one per
+/// node and walk, times max_iterations() for Edge2Vec, which emits the walks
+/// of every iteration
+KATANA_EXPORT uint64_t RandomWalksMaxWalks(
+    const PropertyGraph& pg, const RandomWalksPlan& plan);
+
+/// Compute the random-walks for pg into the preallocated buffer walks, which
+/// must have room for capacity walks of plan.walk_stride() node ids each,
+/// capacity being at least RandomWalksMaxWalks(*pg, plan). Walk i takes
+/// walks[i * stride, (i + 1) * stride), padded with kRandomWalkPadding after
+/// its end if it is shorter. Returns the number of walks written.
+KATANA_EXPORT Result<uint64_t> RandomWalks(
+    PropertyGraph* pg, uint32_t* walks, uint64_t capacity,
+    RandomWalksPlan plan = RandomWalksPlan());
+
+/// Receives num_walks walks laid out as in the flat buffer of RandomWalks.
+/// The buffer is reused once the sink returns; an error stops the walks.
+using RandomWalksSink =
+    std::function<Result<void>(const uint32_t* walks, uint64_t num_walks)>;
+
+/// Compute the random-walks for pg in chunks of at most chunk_size walks,
+/// passing each chunk to sink as soon as it is done. Only one chunk is held
+/// in memory, so the walks can outgrow memory.
+KATANA_EXPORT Result<void> RandomWalks(
+    PropertyGraph* pg, const RandomWalksSink& sink,
+    uint64_t chunk_size = kRandomWalksDefaultChunkSize,
+    RandomWalksPlan plan = RandomWalksPlan());
+
+/// Like the RandomWalks above, but every step, the first included, picks an
+/// edge in proportion to its weight in edge_weight_property_name, which must
+/// be non-negative. The second order bias of Node2Vec and Edge2Vec is
+/// applied on top by rejection sampling, so no neighbor list is scanned.
+KATANA_EXPORT Result<void> RandomWalks(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const RandomWalksSink& sink,
+    uint64_t chunk_size = kRandomWalksDefaultChunkSize,
+    RandomWalksPlan plan = RandomWalksPlan());
+
+/// Like the RandomWalks above, but every step only follows the edges whose
+/// timestamp_property_name value is in window, e.g., the last day of
+/// transactions, picking one of them uniformly; a walk ends early at a node
+/// without such edges. The edges of a node in the window are found by binary
+/// search in pg->GetTemporalEdgeIndex, which is built on the first call and
+/// cached, so edges outside the window are never scanned. The second order
+/// bias of Node2Vec applies as above and only counts edges in the window.
+/// plan must be RandomWalksPlan::Node2Vec.
+KATANA_EXPORT Result<void> TimeWindowRandomWalks(
+    PropertyGraph* pg, const std::string& timestamp_property_name,
+    const TimeWindow& window, const RandomWalksSink& sink,
+    uint64_t chunk_size = kRandomWalksDefaultChunkSize,
+    RandomWalksPlan plan = RandomWalksPlan());
+
+/// A RandomWalksSink that wraps each chunk in an arrow::RecordBatch with one
+/// column "walk" of fixed size lists of walk_stride (plan.walk_stride())
+/// node ids and passes it to batch_sink. The batch does not copy the walks,
+/// so it is only valid during the call.
+KATANA_EXPORT RandomWalksSink MakeRandomWalksRecordBatchSink(
+    uint32_t walk_stride,
+    std::function<Result<void>(const std::shared_ptr<arrow::RecordBatch>&)>
+        batch_sink);
+
 KATANA_EXPORT Result<void> RandomWalksAssertValid(PropertyGraph* pg);
 
 }  // namespace katana::analytics
@@ -2,8 +2,11 @@
 #define KATANA_LIBGALOIS_KATANA_ANALYTICS_SSSP_SSSP_H_
 
 #include <iostream>
+#include <string>
+#include <vector>
 
 #include "katana/AtomicHelpers.h"
+#include "katana/analytics/AnalyticsContext.h"
 #include "katana/analytics/Plan.h"
 #include "katana/analytics/Utils.h"
 
@@ -19,6 +22,8 @@ public:
     kDeltaStep,
     kDeltaStepBarrier,
     kDeltaStepFusion,
+    kDeltaStepAdaptive,
+    kMultiQueue,
     // TODO(gill): Do we want to expose serial implementations at all?
     kSerialDeltaTile,
     kSerialDelta,
@@ -55,9 +60,13 @@ private:
 public:
   SsspPlan() : SsspPlan{kCPU, kAutomatic, 0, 0} {}
 
+  /// Choose a plan from the profile of pg (see GraphProfile): asynchronous
+  /// delta stepping for low diameter power-law graphs and delta stepping with
+  /// a barrier between buckets otherwise
   SsspPlan(const katana::PropertyGraph* pg) : Plan(kCPU) {
-    bool isPowerLaw = IsApproximateDegreeDistributionPowerLaw(*pg);
-    if (isPowerLaw) {
+    std::shared_ptr<const GraphProfile> profile = pg->GetGraphProfile();
+    if (profile->power_law &&
+        profile->diameter_class == GraphProfile::kLowDiameter) {
       *this = DeltaStep();
     } else {
       *this = DeltaStepBarrier();
@@ -88,6 +97,19 @@ public:
     return {kCPU, kDeltaStepFusion, delta, 0};
   }
 
+  /// Delta stepping with fused buckets where delta needs no tuning: it is
+  /// estimated from the edge weights and the average degree before the run
+  /// and adjusted between buckets, growing when a bucket has too little work
+  /// for the threads and shrinking when too many relaxations are wasted
+  static SsspPlan DeltaStepAdaptive() {
+    return {kCPU, kDeltaStepAdaptive, 0, 0};
+  }
+
+  /// Asynchronous relaxation scheduled by a relaxed concurrent priority queue
+  /// (katana::MultiQueue) instead of delta buckets, so there is no delta to
+  /// tune
+  static SsspPlan MultiQueue() { return {kCPU, kMultiQueue, 0, 0}; }
+
   static SsspPlan SerialDeltaTile(
       unsigned delta = kDefaultDelta,
       ptrdiff_t edge_tile_size = kDefaultEdgeTileSize) {
@@ -120,17 +142,41 @@ public:
 /// output_property_name (as uint32_t). The algorithm and delta stepping
 /// parameter can be specified, but have reasonable defaults.
 /// The property named output_property_name is created by this function and may
-/// not exist before the call.
+/// not exist before the call. With a context, the node distances and edge
+/// weights of the search are kept in it for the next call.
 KATANA_EXPORT Result<void> Sssp(
     PropertyGraph* pg, size_t start_node,
     const std::string& edge_weight_property_name,
-    const std::string& output_property_name, SsspPlan plan = {});
+    const std::string& output_property_name, SsspPlan plan = {},
+    AnalyticsContext* context = nullptr);
 
 KATANA_EXPORT Result<void> SsspAssertValid(
     PropertyGraph* pg, size_t start_node,
     const std::string& edge_weight_property_name,
     const std::string& output_property_name);
 
+/// A shortest path between two nodes
+struct KATANA_EXPORT SsspPath {
+  /// The nodes of the path from the source to the target, both included;
+  /// empty if the target is not reachable
+  std::vector<uint32_t> nodes;
+  /// The sum of the weights of the edges of the path; infinity if the target
+  /// is not reachable
+  double distance;
+};
+
+/// Find a shortest path from source to target with a bidirectional Dijkstra
+/// search that stops once no path through the unsettled nodes can be shorter
+/// than the best one found, so only the neighborhoods of the two nodes are
+/// visited and no node property is created. The edge weights are taken from
+/// edge_weight_property_name, as for Sssp, and must not be negative; weights
+/// are checked as their edges are relaxed, so a negative weight returns
+/// ErrorCode::InvalidArgument if the search reaches it. The first call on pg
+/// builds and caches its bidirectional view.
+KATANA_EXPORT Result<SsspPath> SsspPointToPoint(
+    PropertyGraph* pg, uint32_t source, uint32_t target,
+    const std::string& edge_weight_property_name);
+
 struct KATANA_EXPORT SsspStatistics {
   /// The number of nodes reachable from the source node.
   uint64_t n_reached_nodes;
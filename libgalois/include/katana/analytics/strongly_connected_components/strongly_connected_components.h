@@ -0,0 +1,107 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_STRONGLYCONNECTEDCOMPONENTS_STRONGLYCONNECTEDCOMPONENTS_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_STRONGLYCONNECTEDCOMPONENTS_STRONGLYCONNECTEDCOMPONENTS_H_
+
+#include <iostream>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+
+namespace katana::analytics {
+
+/// A computational plan for StronglyConnectedComponents, specifying the
+/// algorithm and whether size 2 components are trimmed.
+class StronglyConnectedComponentsPlan : public Plan {
+public:
+  /// Algorithm selectors for StronglyConnectedComponents
+  enum Algorithm { kMultiStep, kForwardBackward, kColoring };
+
+  static const bool kDefaultTrim2 = true;
+
+private:
+  Algorithm algorithm_;
+  bool trim2_;
+
+  StronglyConnectedComponentsPlan(
+      Architecture architecture, Algorithm algorithm, bool trim2)
+      : Plan(architecture), algorithm_(algorithm), trim2_(trim2) {}
+
+public:
+  StronglyConnectedComponentsPlan()
+      : StronglyConnectedComponentsPlan(MultiStep()) {}
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  /// Whether pairs of nodes that only reach each other are removed as
+  /// components between rounds, besides single nodes without in- or
+  /// out-edges.
+  bool trim2() const { return trim2_; }
+
+  /// Multi-step: trim the trivial components, find the giant component with
+  /// a single forward-backward search from the node of highest degree, trim
+  /// again and decompose the rest, which is mostly small components, by
+  /// coloring.
+  ///
+  /// SLOTA, George M.; RAJAMANICKAM, Sivasankaran; MADDURI, Kamesh. BFS and
+  /// coloring-based parallel algorithms for strongly connected components and
+  /// related problems. IEEE International Parallel and Distributed Processing
+  /// Symposium, 2014.
+  static StronglyConnectedComponentsPlan MultiStep(
+      bool trim2 = kDefaultTrim2) {
+    return {kCPU, kMultiStep, trim2};
+  }
+
+  /// Forward-backward: trim, then split every remaining subgraph by the
+  /// nodes reached forward and backward from a pivot, whose intersection is
+  /// a component, and repeat on all the pieces at once.
+  ///
+  /// HONG, Sungpack; RODIA, Nicole C.; OLUKOTUN, Kunle. On fast parallel
+  /// detection of strongly connected components (SCC) in small-world graphs.
+  /// SC '13, 2013.
+  static StronglyConnectedComponentsPlan ForwardBackward(
+      bool trim2 = kDefaultTrim2) {
+    return {kCPU, kForwardBackward, trim2};
+  }
+
+  /// Coloring: trim, then propagate the largest node ID forward; each node
+  /// that keeps its own ID roots a component made of the nodes of its color
+  /// that reach it backward. Rounds take as many steps as the longest path,
+  /// so this suits graphs without a giant component.
+  static StronglyConnectedComponentsPlan Coloring(bool trim2 = kDefaultTrim2) {
+    return {kCPU, kColoring, trim2};
+  }
+};
+
+/// Compute the strongly connected components of pg, following edges in their
+/// direction. Create a node property with, for every node, the smallest node
+/// ID of its component, so the result does not depend on the plan.
+/// The property named output_property_name is created by this function and
+/// may not exist before the call. The created property has type uint32_t.
+KATANA_EXPORT Result<void> StronglyConnectedComponents(
+    PropertyGraph* pg, const std::string& output_property_name,
+    StronglyConnectedComponentsPlan plan = {});
+
+/// Check the property against a serial computation of the strongly connected
+/// components.
+KATANA_EXPORT Result<void> StronglyConnectedComponentsAssertValid(
+    PropertyGraph* pg, const std::string& property_name);
+
+struct KATANA_EXPORT StronglyConnectedComponentsStatistics {
+  /// Total number of components in the graph.
+  uint64_t total_components;
+  /// Total number of components with more than 1 node.
+  uint64_t total_non_trivial_components;
+  /// The number of nodes present in the largest component.
+  uint64_t largest_component_size;
+  /// The ratio of nodes present in the largest component.
+  double largest_component_ratio;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<StronglyConnectedComponentsStatistics> Compute(
+      katana::PropertyGraph* pg, const std::string& property_name);
+};
+
+}  // namespace katana::analytics
+
+#endif
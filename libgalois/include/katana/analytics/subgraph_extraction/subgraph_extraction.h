@@ -1,7 +1,13 @@
 #ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_SUBGRAPHEXTRACTION_SUBGRAPHEXTRACTION_H_
 #define KATANA_LIBGALOIS_KATANA_ANALYTICS_SUBGRAPHEXTRACTION_SUBGRAPHEXTRACTION_H_
 
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "katana/DynamicBitset.h"
 #include "katana/PropertyGraph.h"
+#include "katana/TemporalEdgeIndex.h"
 #include "katana/analytics/Plan.h"
 
 // API
@@ -47,17 +53,156 @@ public:
  *
  * By default only topology of the sub-graph is constructed.
  * The new sub-graph is independent of the original graph.
+ * Node i of the sub-graph is the i-th distinct node of node_vec, and the
+ * edges of each node are in order of their destination in the sub-graph.
+ *
+ * @param pg The graph to process.
+ * @param node_vec Set of node IDs
+ * @param plan
+ */
+KATANA_EXPORT katana::Result<std::unique_ptr<katana::PropertyGraph>>
+SubGraphExtraction(
+    katana::PropertyGraph* pg,
+    const std::vector<katana::PropertyGraph::Node>& node_vec,
+    SubGraphExtractionPlan plan = {});
+
+/**
+ * Construct a new sub-graph from the original graph, as above, and copy the
+ * named node and edge properties of its nodes and edges to it.
  *
  * @param pg The graph to process.
  * @param node_vec Set of node IDs
+ * @param node_properties_to_copy Names of the node properties to copy
+ * @param edge_properties_to_copy Names of the edge properties to copy
  * @param plan
  */
 KATANA_EXPORT katana::Result<std::unique_ptr<katana::PropertyGraph>>
 SubGraphExtraction(
     katana::PropertyGraph* pg,
     const std::vector<katana::PropertyGraph::Node>& node_vec,
+    const std::vector<std::string>& node_properties_to_copy,
+    const std::vector<std::string>& edge_properties_to_copy,
     SubGraphExtractionPlan plan = {});
-// const std::vector<std::string>& node_properties_to_copy, const std::vector<std::string>& edge_properties_to_copy);
+
+/**
+ * Construct the sub-graph of the nodes whose bit is set in nodes, as above,
+ * for instance the nodes selected by PropertyGraph::FilterNodes. Node i of
+ * the sub-graph is the node with the i-th set bit.
+ *
+ * @param pg The graph to process.
+ * @param nodes Bitset of pg->num_nodes() bits selecting the nodes
+ * @param node_properties_to_copy Names of the node properties to copy
+ * @param edge_properties_to_copy Names of the edge properties to copy
+ * @param plan
+ */
+KATANA_EXPORT katana::Result<std::unique_ptr<katana::PropertyGraph>>
+SubGraphExtraction(
+    katana::PropertyGraph* pg, const katana::DynamicBitset& nodes,
+    const std::vector<std::string>& node_properties_to_copy = {},
+    const std::vector<std::string>& edge_properties_to_copy = {},
+    SubGraphExtractionPlan plan = {});
+
+/**
+ * Find the nodes within num_hops out-edges of the seeds, for instance to
+ * extract their ego-network with SubGraphExtraction. The seeds come first, in
+ * the order given and without duplicates, followed by the nodes at each
+ * distance in turn, in increasing order of ID. Only the nodes reached are
+ * visited, so the cost does not depend on the size of the graph.
+ *
+ * @param pg The graph to process.
+ * @param seeds Node IDs to start from
+ * @param num_hops Largest distance from the seeds
+ */
+KATANA_EXPORT katana::Result<std::vector<katana::PropertyGraph::Node>>
+KHopNeighborhood(
+    katana::PropertyGraph* pg,
+    const std::vector<katana::PropertyGraph::Node>& seeds, uint32_t num_hops);
+
+/**
+ * Find the nodes within num_hops out-edges of the seeds, as above, following
+ * only the edges whose timestamp_property_name value is in window, e.g., the
+ * accounts reached by transfers of the last day. The edges of a node in the
+ * window are found by binary search in pg->GetTemporalEdgeIndex, which is
+ * built on the first call and cached, so edges outside the window are never
+ * scanned.
+ *
+ * @param pg The graph to process.
+ * @param seeds Node IDs to start from
+ * @param num_hops Largest distance from the seeds
+ * @param timestamp_property_name Edge property of timestamps
+ * @param window Timestamps of the edges to follow
+ */
+KATANA_EXPORT katana::Result<std::vector<katana::PropertyGraph::Node>>
+KHopNeighborhood(
+    katana::PropertyGraph* pg,
+    const std::vector<katana::PropertyGraph::Node>& seeds, uint32_t num_hops,
+    const std::string& timestamp_property_name,
+    const katana::TimeWindow& window);
+
+/// Decides whether an edge, given by its ID, is kept in the sub-graph. It is
+/// called in parallel.
+using SubGraphEdgePredicate =
+    std::function<bool(const katana::PropertyGraph::Edge&)>;
+
+/**
+ * Construct the sub-graph induced by the edges of the original graph for
+ * which keep_edge is true: those edges and their endpoints. The nodes of the
+ * sub-graph are in increasing order of their ID in the original graph and the
+ * edges of each node keep their order.
+ *
+ * @param pg The graph to process.
+ * @param keep_edge Decides whether an edge is kept
+ * @param node_properties_to_copy Names of the node properties to copy
+ * @param edge_properties_to_copy Names of the edge properties to copy
+ * @param subgraph_nodes If not null, set to the original ID of each node of
+ *     the sub-graph
+ */
+KATANA_EXPORT katana::Result<std::unique_ptr<katana::PropertyGraph>>
+EdgeInducedSubGraphExtraction(
+    katana::PropertyGraph* pg, const SubGraphEdgePredicate& keep_edge,
+    const std::vector<std::string>& node_properties_to_copy = {},
+    const std::vector<std::string>& edge_properties_to_copy = {},
+    std::vector<katana::PropertyGraph::Node>* subgraph_nodes = nullptr);
+
+/**
+ * Construct the sub-graph induced by the edges whose bit is set in edges, as
+ * above, for instance the edges selected by PropertyGraph::FilterEdges.
+ *
+ * @param pg The graph to process.
+ * @param edges Bitset of pg->num_edges() bits selecting the edges
+ * @param node_properties_to_copy Names of the node properties to copy
+ * @param edge_properties_to_copy Names of the edge properties to copy
+ * @param subgraph_nodes If not null, set to the original ID of each node of
+ *     the sub-graph
+ */
+KATANA_EXPORT katana::Result<std::unique_ptr<katana::PropertyGraph>>
+EdgeInducedSubGraphExtraction(
+    katana::PropertyGraph* pg, const katana::DynamicBitset& edges,
+    const std::vector<std::string>& node_properties_to_copy = {},
+    const std::vector<std::string>& edge_properties_to_copy = {},
+    std::vector<katana::PropertyGraph::Node>* subgraph_nodes = nullptr);
+
+/**
+ * Construct the sub-graph of the given edges and their endpoints, for
+ * instance a sample of the edges. The nodes of the sub-graph are in
+ * increasing order of their ID in the original graph and the edges of each
+ * node keep their order; duplicate edges are kept once. Only the given edges
+ * are visited, so the cost does not depend on the size of the graph.
+ *
+ * @param pg The graph to process.
+ * @param edge_vec Edge IDs
+ * @param node_properties_to_copy Names of the node properties to copy
+ * @param edge_properties_to_copy Names of the edge properties to copy
+ * @param subgraph_nodes If not null, set to the original ID of each node of
+ *     the sub-graph
+ */
+KATANA_EXPORT katana::Result<std::unique_ptr<katana::PropertyGraph>>
+EdgeSetSubGraphExtraction(
+    katana::PropertyGraph* pg,
+    const std::vector<katana::PropertyGraph::Edge>& edge_vec,
+    const std::vector<std::string>& node_properties_to_copy = {},
+    const std::vector<std::string>& edge_properties_to_copy = {},
+    std::vector<katana::PropertyGraph::Node>* subgraph_nodes = nullptr);
 
 }  // namespace katana::analytics
 
@@ -1,6 +1,8 @@
 #ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_TRIANGLECOUNT_TRIANGLECOUNT_H_
 #define KATANA_LIBGALOIS_KATANA_ANALYTICS_TRIANGLECOUNT_TRIANGLECOUNT_H_
 
+#include <iostream>
+
 #include "katana/PropertyGraph.h"
 #include "katana/analytics/Plan.h"
 
@@ -15,6 +17,7 @@ public:
     kNodeIteration,
     kEdgeIteration,
     kOrderedCount,
+    kWedgeSampling,
   };
 
   enum Relabeling {
@@ -25,19 +28,31 @@ public:
 
   static const Relabeling kDefaultRelabeling = kAutoRelabel;
   static const bool kDefaultEdgeSorted = false;
+  static const uint64_t kDefaultNumSamples = 1 << 20;
+  /// No limit on the sampling time
+  static const uint32_t kDefaultTimeBudgetMs = 0;
+  static constexpr double kDefaultConfidence = 0.95;
 
 private:
   Algorithm algorithm_;
   Relabeling relabeling_;
   bool edges_sorted_;
+  uint64_t num_samples_;
+  uint32_t time_budget_ms_;
+  double confidence_;
 
   TriangleCountPlan(
       Architecture architecture, Algorithm algorithm, bool edges_sorted,
-      Relabeling relabeling)
+      Relabeling relabeling, uint64_t num_samples = kDefaultNumSamples,
+      uint32_t time_budget_ms = kDefaultTimeBudgetMs,
+      double confidence = kDefaultConfidence)
       : Plan(architecture),
         algorithm_(algorithm),
         relabeling_(relabeling),
-        edges_sorted_(edges_sorted) {}
+        edges_sorted_(edges_sorted),
+        num_samples_(num_samples),
+        time_budget_ms_(time_budget_ms),
+        confidence_(confidence) {}
 
 public:
   TriangleCountPlan()
@@ -47,6 +62,13 @@ public:
   Algorithm algorithm() const { return algorithm_; }
   Relabeling relabeling() const { return relabeling_; }
   bool edges_sorted() const { return edges_sorted_; }
+  /// The most wedges kWedgeSampling samples
+  uint64_t num_samples() const { return num_samples_; }
+  /// Milliseconds after which kWedgeSampling stops sampling, or 0
+  uint32_t time_budget_ms() const { return time_budget_ms_; }
+  /// The probability that the intervals of a TriangleCountEstimate hold the
+  /// exact values
+  double confidence() const { return confidence_; }
 
   /**
    * The node-iterator algorithm from the following:
@@ -90,6 +112,35 @@ public:
       Relabeling relabeling = kDefaultRelabeling) {
     return {kCPU, kOrderedCount, edges_sorted, relabeling};
   }
+
+  /**
+   * Estimate the count from uniformly sampled wedges, i.e., paths of length
+   * two: there are three closed wedges per triangle, so the count is a third
+   * of the number of wedges times the fraction of sampled wedges that are
+   * closed. The edges need not be sorted and the nodes are not relabeled.
+   * Use TriangleCountApproximate to get the confidence interval.
+   *   C. Seshadhri, A. Pinar, T. G. Kolda. Triadic Measures on Graphs: The
+   *   Power of Wedge Sampling. SDM 2013.
+   *
+   * @param num_samples The most wedges to sample.
+   * @param time_budget_ms Stop sampling after this many milliseconds, or 0
+   *     to sample all num_samples wedges.
+   * @param confidence The probability that the confidence interval holds the
+   *     exact count, in (0, 1).
+   */
+  static TriangleCountPlan WedgeSampling(
+      uint64_t num_samples = kDefaultNumSamples,
+      uint32_t time_budget_ms = kDefaultTimeBudgetMs,
+      double confidence = kDefaultConfidence) {
+    return {
+        kCPU,
+        kWedgeSampling,
+        kDefaultEdgeSorted,
+        kNoRelabel,
+        num_samples,
+        time_budget_ms,
+        confidence};
+  }
 };
 
 /**
@@ -104,6 +155,42 @@ public:
 KATANA_EXPORT katana::Result<uint64_t> TriangleCount(
     PropertyGraph* pg, TriangleCountPlan plan = {});
 
+/// Estimates of the number of triangles and of the average local clustering
+/// coefficient with confidence intervals. The intervals come from Hoeffding's
+/// inequality, so they hold with at least the plan's confidence whatever the
+/// graph.
+struct KATANA_EXPORT TriangleCountEstimate {
+  double triangles;
+  double triangles_lower;
+  double triangles_upper;
+  /// The average over all nodes of the local clustering coefficient, where
+  /// nodes with fewer than two neighbors count as zero
+  double average_clustering;
+  double average_clustering_lower;
+  double average_clustering_upper;
+  double confidence;
+  /// The number of wedges sampled for each estimate
+  uint64_t num_samples;
+  /// The number of wedges in the graph
+  uint64_t num_wedges;
+
+  void Print(std::ostream& os = std::cout) const;
+};
+
+/**
+ * Estimate the number of triangles and the average local clustering
+ * coefficient of the graph by sampling wedges. The graph must be symmetric!
+ *
+ * The graph is neither copied nor sorted, so the estimate is ready after
+ * sampling the plan's num_samples or time_budget_ms.
+ *
+ * @param pg The graph to process.
+ * @param plan A TriangleCountPlan::WedgeSampling plan.
+ */
+KATANA_EXPORT katana::Result<TriangleCountEstimate> TriangleCountApproximate(
+    PropertyGraph* pg,
+    TriangleCountPlan plan = TriangleCountPlan::WedgeSampling());
+
 }  // namespace katana::analytics
 
 #endif
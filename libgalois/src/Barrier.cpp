@@ -19,7 +19,16 @@
 
 #include "katana/Barrier.h"
 
+#include <chrono>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "katana/Env.h"
+#include "katana/Executor_OnEach.h"
 #include "katana/Logging.h"
+#include "katana/Statistics.h"
 #include "katana/ThreadPool.h"
 
 // anchor vtable
@@ -28,15 +37,122 @@ katana::Barrier::~Barrier() = default;
 static katana::Barrier* kBarrier = nullptr;
 static unsigned kBarrierThreads = 0;
 
+namespace {
+
+constexpr unsigned kCalibrationWarmup = 16;
+constexpr unsigned kCalibrationRounds = 256;
+
+std::unique_ptr<katana::Barrier>
+CreateBarrier(const std::string& kind, unsigned active_threads) {
+  if (kind == "topo") {
+    return katana::CreateTopoBarrier(active_threads);
+  }
+  if (kind == "mcs") {
+    return katana::CreateMCSBarrier(active_threads);
+  }
+  if (kind == "counting") {
+    return katana::CreateCountingBarrier(active_threads);
+  }
+  if (kind == "dissemination") {
+    return katana::CreateDisseminationBarrier(active_threads);
+  }
+  return nullptr;
+}
+
+/// The barriers picked by KATANA_BARRIER, if it is set
+struct BarrierChoice {
+  katana::Barrier* system_barrier{nullptr};
+  // Barriers created here rather than passed to SetBarrier
+  std::vector<std::unique_ptr<katana::Barrier>> owned;
+  bool calibrate{false};
+  // The fastest barrier for each calibrated thread count
+  std::unordered_map<unsigned, katana::Barrier*> fastest;
+};
+
+BarrierChoice kChoice;
+
+/// \returns nanoseconds per Wait() of \p barrier with \p active_threads
+/// threads
+double
+TimeBarrier(katana::Barrier* barrier, unsigned active_threads) {
+  barrier->Reinit(active_threads);
+  std::chrono::steady_clock::duration elapsed{};
+  katana::on_each_gen(
+      [&](unsigned tid, unsigned) {
+        for (unsigned i = 0; i < kCalibrationWarmup; ++i) {
+          barrier->Wait();
+        }
+        auto start = std::chrono::steady_clock::now();
+        for (unsigned i = 0; i < kCalibrationRounds; ++i) {
+          barrier->Wait();
+        }
+        if (tid == 0) {
+          elapsed = std::chrono::steady_clock::now() - start;
+        }
+      },
+      std::make_tuple());
+  return std::chrono::duration<double, std::nano>(elapsed).count() /
+         kCalibrationRounds;
+}
+
+/// Time each candidate with the threads that will use it and keep the
+/// fastest. Must be called outside of parallel regions with activeThreads
+/// equal to \p active_threads.
+katana::Barrier*
+Calibrate(unsigned active_threads) {
+  auto it = kChoice.fastest.find(active_threads);
+  if (it != kChoice.fastest.end()) {
+    return it->second;
+  }
+
+  katana::Barrier* best = kChoice.system_barrier;
+  double best_ns = std::numeric_limits<double>::max();
+  for (auto& candidate : kChoice.owned) {
+    double ns = TimeBarrier(candidate.get(), active_threads);
+    katana::ReportStatSingle(
+        "Barrier",
+        fmt::format(
+            "{}NanosPerWaitWith{}Threads", candidate->name(), active_threads),
+        static_cast<uint64_t>(ns));
+    if (ns < best_ns) {
+      best_ns = ns;
+      best = candidate.get();
+    }
+  }
+
+  kChoice.fastest.emplace(active_threads, best);
+  return best;
+}
+
+}  // namespace
+
 void
 katana::internal::SetBarrier(katana::Barrier* barrier) {
   KATANA_LOG_VASSERT(
       !(barrier && kBarrier), "Double initialization of Barrier");
 
   kBarrier = barrier;
+  kChoice = BarrierChoice();
 
   if (barrier) {
     kBarrierThreads = GetThreadPool().getMaxUsableThreads();
+    kChoice.system_barrier = barrier;
+
+    std::string kind;
+    if (GetEnv("KATANA_BARRIER", &kind)) {
+      if (kind == "auto") {
+        kChoice.calibrate = true;
+        for (const char* k : {"topo", "mcs", "counting", "dissemination"}) {
+          kChoice.owned.emplace_back(CreateBarrier(k, kBarrierThreads));
+        }
+      } else if (auto chosen = CreateBarrier(kind, kBarrierThreads)) {
+        kBarrier = chosen.get();
+        kChoice.owned.emplace_back(std::move(chosen));
+      } else {
+        KATANA_LOG_WARN("unknown KATANA_BARRIER value: {}", kind);
+      }
+    }
+
     kBarrier->Reinit(kBarrierThreads);
   }
 }
@@ -48,6 +164,20 @@ katana::GetBarrier(unsigned active_threads) {
       std::min(active_threads, GetThreadPool().getMaxUsableThreads());
   active_threads = std::max(active_threads, 1U);
 
+  // Calibration runs a parallel region of its own, so it is only possible
+  // from the serial code that sets up a loop
+  if (kChoice.calibrate && active_threads > 1 &&
+      active_threads == getActiveThreads() && !GetThreadPool().isRunning()) {
+    Barrier* fastest = Calibrate(active_threads);
+    if (fastest != kBarrier) {
+      kBarrier = fastest;
+      kBarrierThreads = 0;
+      ReportParam(
+          "Barrier", fmt::format("KindWith{}Threads", active_threads),
+          kBarrier->name());
+    }
+  }
+
   if (active_threads != kBarrierThreads) {
     kBarrierThreads = active_threads;
     kBarrier->Reinit(kBarrierThreads);
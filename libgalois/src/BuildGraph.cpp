@@ -11,6 +11,7 @@
 #include <optional>
 #include <random>
 #include <sstream>
+#include <string_view>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -44,6 +45,7 @@ using NullMaps = std::pair<
 
 using katana::GraphComponents;
 using katana::ImportData;
+using katana::IntermediateID;
 using katana::ImportDataType;
 using katana::LabelRule;
 using katana::LabelsState;
@@ -720,6 +722,109 @@ SetEdgeID(
   return i;
 }
 
+// Store id, named by an edge before the node with that ID was added, to be
+// resolved by ResolveIntermediateIDs
+IntermediateID
+AddIntermediateID(
+    TopologyState* topology_builder, size_t edge, const std::string& id) {
+  IntermediateID entry{edge, topology_builder->intermediate_ids.size(),
+                       id.size()};
+  topology_builder->intermediate_ids.append(id);
+  return entry;
+}
+
+// Intermediate IDs are resolved in 2^kIDPartitionBits partitions by hash
+constexpr size_t kIDPartitionBits = 8;
+constexpr size_t kNumIDPartitions = size_t{1} << kIDPartitionBits;
+
+size_t
+IDPartition(uint64_t hash) {
+  // std::hash need not mix its high bits
+  return (hash * 0x9e3779b97f4a7c15ULL) >> (64 - kIDPartitionBits);
+}
+
+// Counting sort of the indexes of hashes by partition; each thread counts the
+// hashes of a block, and then places them after those of the same partition
+// in the blocks of earlier threads, so each partition is in index order.
+// Partition p is [(*partition_begins)[p], (*partition_begins)[p + 1]) of the
+// result.
+std::vector<uint64_t>
+PartitionByHash(
+    const std::vector<uint64_t>& hashes,
+    std::vector<uint64_t>* partition_begins) {
+  const size_t num_hashes = hashes.size();
+  const size_t num_threads = katana::getActiveThreads();
+  std::vector<uint64_t> offsets(num_threads * kNumIDPartitions);
+  katana::on_each([&](unsigned tid, unsigned total) {
+    auto [begin, end] = katana::block_range(size_t{0}, num_hashes, tid, total);
+    uint64_t* counts = &offsets[tid * kNumIDPartitions];
+    for (size_t i = begin; i < end; ++i) {
+      ++counts[IDPartition(hashes[i])];
+    }
+  });
+  partition_begins->resize(kNumIDPartitions + 1);
+  uint64_t sum = 0;
+  for (size_t p = 0; p < kNumIDPartitions; ++p) {
+    (*partition_begins)[p] = sum;
+    for (size_t t = 0; t < num_threads; ++t) {
+      uint64_t count = offsets[t * kNumIDPartitions + p];
+      offsets[t * kNumIDPartitions + p] = sum;
+      sum += count;
+    }
+  }
+  (*partition_begins)[kNumIDPartitions] = sum;
+
+  std::vector<uint64_t> order(num_hashes);
+  katana::on_each([&](unsigned tid, unsigned total) {
+    auto [begin, end] = katana::block_range(size_t{0}, num_hashes, tid, total);
+    uint64_t* next = &offsets[tid * kNumIDPartitions];
+    for (size_t i = begin; i < end; ++i) {
+      order[next[IDPartition(hashes[i])]++] = i;
+    }
+  });
+  return order;
+}
+
+// An open addressing table of the distinct strings of one partition of the
+// intermediate IDs
+class IDTable {
+public:
+  explicit IDTable(size_t num_ids) {
+    size_t size = 16;
+    while (size < 2 * num_ids) {
+      size *= 2;
+    }
+    slots_.resize(size, Slot{0, kEmpty});
+  }
+
+  // \returns the first index inserted with the same string as index, or
+  // index if there is none; id_of(index) is the string of index
+  template <typename IDOf>
+  uint64_t FindOrInsert(uint64_t hash, uint64_t index, const IDOf& id_of) {
+    const size_t mask = slots_.size() - 1;
+    for (size_t s = hash & mask;; s = (s + 1) & mask) {
+      Slot& slot = slots_[s];
+      if (slot.index == kEmpty) {
+        slot = Slot{hash, index};
+        return index;
+      }
+      if (slot.hash == hash && id_of(slot.index) == id_of(index)) {
+        return slot.index;
+      }
+    }
+  }
+
+private:
+  static constexpr uint64_t kEmpty = std::numeric_limits<uint64_t>::max();
+
+  struct Slot {
+    uint64_t hash;
+    uint64_t index;
+  };
+
+  std::vector<Slot> slots_;
+};
+
 /******************************************************************************/
 /* Functions for ensuring all arrow arrays are of the right length in the end */
 /******************************************************************************/
@@ -1318,8 +1423,8 @@ katana::PropertyGraphBuilder::AddEdgeSource(const std::string& source) {
         static_cast<uint32_t>(src_entry->second));
     topology_builder_.out_indices[src_entry->second]++;
   } else {
-    topology_builder_.sources_intermediate.insert(
-        std::pair<size_t, std::string>(edges_, source));
+    topology_builder_.sources_intermediate.emplace_back(
+        AddIntermediateID(&topology_builder_, edges_, source));
     topology_builder_.sources.emplace_back(
         std::numeric_limits<uint32_t>::max());
   }
@@ -1335,8 +1440,8 @@ katana::PropertyGraphBuilder::AddEdgeTarget(const std::string& target) {
     topology_builder_.destinations.emplace_back(
         static_cast<uint32_t>(dest_entry->second));
   } else {
-    topology_builder_.destinations_intermediate.insert(
-        std::pair<size_t, std::string>(edges_, target));
+    topology_builder_.destinations_intermediate.emplace_back(
+        AddIntermediateID(&topology_builder_, edges_, target));
     topology_builder_.destinations.emplace_back(
         std::numeric_limits<uint32_t>::max());
   }
@@ -1629,35 +1734,84 @@ katana::PropertyGraphBuilder::AddLabel(const std::string& name) {
 
 // Resolve string node IDs to node indexes, if a node does not exist create an
 // empty node
+//
+// The IDs are partitioned by hash and each partition is resolved on its own
+// thread, so that each distinct ID is looked up once. Missing nodes are then
+// created in order of the first edge naming them, destinations first.
 void
 katana::PropertyGraphBuilder::ResolveIntermediateIDs() {
   TopologyState* topology = &topology_builder_;
-
-  for (auto [index, str_id] : topology->destinations_intermediate) {
-    auto dest_index = topology->node_indexes.find(str_id);
-    uint32_t dest;
-    // if node does not exist, create it
-    if (dest_index == topology->node_indexes.end()) {
-      dest = nodes_;
-      this->AddNode(str_id);
-    } else {
-      dest = static_cast<uint32_t>(dest_index->second);
-    }
-    topology->destinations[index] = dest;
+  const size_t num_dests = topology->destinations_intermediate.size();
+  const size_t num_ids = num_dests + topology->sources_intermediate.size();
+  if (num_ids == 0) {
+    return;
   }
-
-  for (auto [index, str_id] : topology->sources_intermediate) {
-    auto src_index = topology->node_indexes.find(str_id);
-    uint32_t src;
-    if (src_index == topology->node_indexes.end()) {
-      src = nodes_;
-      this->AddNode(str_id);
-    } else {
-      src = static_cast<uint32_t>(src_index->second);
+  // intermediate ID i is destination i or source i - num_dests
+  auto entry = [&](size_t i) -> const IntermediateID& {
+    return i < num_dests ? topology->destinations_intermediate[i]
+                         : topology->sources_intermediate[i - num_dests];
+  };
+  const std::string_view arena = topology->intermediate_ids;
+  auto id_of = [&](size_t i) {
+    const IntermediateID& e = entry(i);
+    return arena.substr(e.offset, e.length);
+  };
+
+  std::vector<uint64_t> hashes(num_ids);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_ids),
+      [&](size_t i) { hashes[i] = std::hash<std::string_view>{}(id_of(i)); },
+      katana::no_stats());
+  std::vector<uint64_t> partition_begins;
+  std::vector<uint64_t> order = PartitionByHash(hashes, &partition_begins);
+
+  // first[i] is the first intermediate ID with the string of i, and for
+  // those, node[i] is their node, if it exists
+  constexpr uint32_t kMissing = std::numeric_limits<uint32_t>::max();
+  std::vector<uint64_t> first(num_ids);
+  std::vector<uint32_t> node(num_ids);
+  katana::do_all(
+      katana::iterate(size_t{0}, kNumIDPartitions),
+      [&](size_t p) {
+        IDTable table(partition_begins[p + 1] - partition_begins[p]);
+        for (uint64_t k = partition_begins[p]; k < partition_begins[p + 1];
+             ++k) {
+          uint64_t i = order[k];
+          first[i] = table.FindOrInsert(hashes[i], i, id_of);
+          if (first[i] == i) {
+            auto it = topology->node_indexes.find(std::string(id_of(i)));
+            node[i] = it == topology->node_indexes.end()
+                          ? kMissing
+                          : static_cast<uint32_t>(it->second);
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  // if a node does not exist, create it
+  for (size_t i = 0; i < num_ids; ++i) {
+    if (first[i] == i && node[i] == kMissing) {
+      node[i] = nodes_;
+      this->AddNode(std::string(id_of(i)));
     }
-    topology->sources[index] = src;
-    topology->out_indices[src]++;
   }
+
+  katana::do_all(
+      katana::iterate(size_t{0}, num_ids),
+      [&](size_t i) {
+        uint32_t n = node[first[i]];
+        if (i < num_dests) {
+          topology->destinations[entry(i).edge] = n;
+        } else {
+          topology->sources[entry(i).edge] = n;
+          __sync_fetch_and_add(&topology->out_indices[n], 1);
+        }
+      },
+      katana::no_stats());
+
+  topology->intermediate_ids = std::string();
+  topology->sources_intermediate = std::vector<IntermediateID>();
+  topology->destinations_intermediate = std::vector<IntermediateID>();
 }
 
 // Build CSR format and rearrange edge tables to correspond to the CSR
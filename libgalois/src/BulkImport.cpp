@@ -0,0 +1,718 @@
+#include "katana/BulkImport.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+
+#include <arrow/compute/api.h>
+#include <arrow/csv/api.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Reduction.h"
+#include "katana/URI.h"
+#include "tsuba/FileView.h"
+#include "tsuba/ParquetReader.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+
+/// Node ids are hashed into 2^kPartitionBits partitions, each with its own
+/// map, so that the maps are built in parallel without locks and each fits
+/// in cache better than one map of all ids
+constexpr size_t kPartitionBits = 10;
+constexpr size_t kNumPartitions = size_t{1} << kPartitionBits;
+
+/// The MurmurHash3 finalizer; the partition is taken from the high bits,
+/// which std::hash of an integer may not mix
+uint64_t
+Mix(uint64_t hash) {
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+/// Node ids are joined as int64_t for integer columns and as
+/// std::string_view into the column for string columns
+template <typename Key>
+Key
+GetKey(const arrow::Array& ids, int64_t i) {
+  if constexpr (std::is_same_v<Key, std::string_view>) {
+    arrow::util::string_view view =
+        static_cast<const arrow::LargeStringArray&>(ids).GetView(i);
+    return std::string_view(view.data(), view.size());
+  } else {
+    return static_cast<const arrow::Int64Array&>(ids).Value(i);
+  }
+}
+
+template <typename Key>
+uint64_t
+HashKey(Key key) {
+  return Mix(std::hash<Key>{}(key));
+}
+
+/// The type node ids are joined as, given the type of the id column
+katana::Result<std::shared_ptr<arrow::DataType>>
+KeyType(const arrow::DataType& type) {
+  if (arrow::is_integer(type.id())) {
+    return arrow::int64();
+  }
+  if (type.id() == arrow::Type::STRING ||
+      type.id() == arrow::Type::LARGE_STRING) {
+    return arrow::large_utf8();
+  }
+  return KATANA_ERROR(
+      katana::ErrorCode::InvalidArgument,
+      "ids must be integers or strings, not {}", type.ToString());
+}
+
+/// \returns the values of column as one array of the given type
+katana::Result<std::shared_ptr<arrow::Array>>
+CombinedAs(
+    const std::shared_ptr<arrow::ChunkedArray>& column,
+    const std::shared_ptr<arrow::DataType>& type) {
+  std::shared_ptr<arrow::Array> array =
+      KATANA_CHECKED(katana::CombinedArray(column));
+  if (array->type()->Equals(*type)) {
+    return array;
+  }
+  return KATANA_CHECKED(arrow::compute::Cast(*array, type));
+}
+
+katana::Result<int>
+ColumnIndex(const arrow::Table& table, const std::string& name) {
+  int index = table.schema()->GetFieldIndex(name);
+  if (index < 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotFound, "no column named {}", name);
+  }
+  return index;
+}
+
+/// A map from node ids to dense node ids: the build side of a partitioned
+/// hash join of the edge ends with the node ids
+template <typename Key>
+class NodeIdMap {
+public:
+  /// Map ids[i] to node i
+  katana::Result<void> Build(const arrow::Array& ids);
+
+  bool Find(Key key, Node* node) const {
+    const auto& partition = partitions_[Partition(HashKey(key))];
+    auto it = partition.find(key);
+    if (it == partition.end()) {
+      return false;
+    }
+    *node = it->second;
+    return true;
+  }
+
+private:
+  static size_t Partition(uint64_t hash) {
+    return hash >> (64 - kPartitionBits);
+  }
+
+  std::vector<std::unordered_map<Key, Node>> partitions_;
+};
+
+template <typename Key>
+katana::Result<void>
+NodeIdMap<Key>::Build(const arrow::Array& ids) {
+  if (ids.null_count() > 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "{} node ids are null",
+        ids.null_count());
+  }
+  const size_t num_ids = ids.length();
+  katana::NUMAArray<uint64_t> hashes;
+  hashes.allocateInterleaved(num_ids);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_ids),
+      [&](size_t i) { hashes[i] = HashKey(GetKey<Key>(ids, i)); },
+      katana::no_stats());
+
+  // Counting sort of the ids by partition: each thread counts the ids of its
+  // block, and then places them after those of the same partition in the
+  // blocks of earlier threads
+  const size_t num_threads = katana::getActiveThreads();
+  std::vector<uint64_t> offsets(num_threads * kNumPartitions);
+  katana::on_each([&](unsigned tid, unsigned total) {
+    KATANA_LOG_DEBUG_ASSERT(total == num_threads);
+    auto [begin, end] = katana::block_range(size_t{0}, num_ids, tid, total);
+    uint64_t* counts = &offsets[tid * kNumPartitions];
+    for (size_t i = begin; i < end; ++i) {
+      ++counts[Partition(hashes[i])];
+    }
+  });
+  std::vector<uint64_t> partition_begins(kNumPartitions + 1);
+  uint64_t sum = 0;
+  for (size_t p = 0; p < kNumPartitions; ++p) {
+    partition_begins[p] = sum;
+    for (size_t t = 0; t < num_threads; ++t) {
+      uint64_t count = offsets[t * kNumPartitions + p];
+      offsets[t * kNumPartitions + p] = sum;
+      sum += count;
+    }
+  }
+  partition_begins[kNumPartitions] = sum;
+
+  katana::NUMAArray<Node> order;
+  order.allocateInterleaved(num_ids);
+  katana::on_each([&](unsigned tid, unsigned total) {
+    auto [begin, end] = katana::block_range(size_t{0}, num_ids, tid, total);
+    uint64_t* next = &offsets[tid * kNumPartitions];
+    for (size_t i = begin; i < end; ++i) {
+      order[next[Partition(hashes[i])]++] = i;
+    }
+  });
+
+  partitions_.resize(kNumPartitions);
+  std::atomic<int64_t> duplicate{-1};
+  katana::do_all(
+      katana::iterate(size_t{0}, kNumPartitions),
+      [&](size_t p) {
+        auto& partition = partitions_[p];
+        partition.reserve(partition_begins[p + 1] - partition_begins[p]);
+        for (uint64_t k = partition_begins[p]; k < partition_begins[p + 1];
+             ++k) {
+          Node node = order[k];
+          if (!partition.emplace(GetKey<Key>(ids, node), node).second) {
+            duplicate.store(node, std::memory_order_relaxed);
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+  if (duplicate.load() >= 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "the id of node {} is not unique",
+        duplicate.load());
+  }
+  return katana::ResultSuccess();
+}
+
+/// Join the sources and destinations of the edges with the node ids
+template <typename Key>
+katana::Result<void>
+MapEdgeEnds(
+    const arrow::Array& node_ids, const arrow::Array& sources,
+    const arrow::Array& dests, katana::NUMAArray<Node>* edge_sources,
+    katana::NUMAArray<Node>* edge_dests) {
+  NodeIdMap<Key> map;
+  KATANA_CHECKED(map.Build(node_ids));
+
+  const size_t num_edges = sources.length();
+  edge_sources->allocateInterleaved(num_edges);
+  edge_dests->allocateInterleaved(num_edges);
+  std::atomic<int64_t> missing{-1};
+  katana::do_all(
+      katana::iterate(size_t{0}, num_edges),
+      [&](size_t e) {
+        if (!sources.IsValid(e) || !dests.IsValid(e) ||
+            !map.Find(GetKey<Key>(sources, e), &(*edge_sources)[e]) ||
+            !map.Find(GetKey<Key>(dests, e), &(*edge_dests)[e])) {
+          missing.store(e, std::memory_order_relaxed);
+        }
+      },
+      katana::no_stats());
+  if (missing.load() >= 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotFound,
+        "edge {} has a source or destination that is not a node id",
+        missing.load());
+  }
+  return katana::ResultSuccess();
+}
+
+/// A column of edge properties being put in the order of the CSR. Fixed
+/// width columns without nulls, e.g., from numpy, are gathered into output
+/// by BuildTopology in the loop that places the destinations; the others
+/// (width 0) are left to arrow::compute::Take.
+struct EdgeColumn {
+  std::shared_ptr<arrow::Array> input;
+  std::shared_ptr<arrow::Buffer> output;
+  const uint8_t* in{nullptr};
+  uint8_t* out{nullptr};
+  int width{0};
+};
+
+katana::Result<std::vector<EdgeColumn>>
+MakeEdgeColumns(const arrow::Table& table) {
+  std::vector<EdgeColumn> columns;
+  for (const auto& column : table.columns()) {
+    EdgeColumn c;
+    c.input = KATANA_CHECKED(katana::CombinedArray(column));
+    const auto* fixed =
+        dynamic_cast<const arrow::FixedWidthType*>(c.input->type().get());
+    if (fixed && fixed->id() != arrow::Type::DICTIONARY &&
+        fixed->bit_width() % 8 == 0 && c.input->null_count() == 0) {
+      c.width = fixed->bit_width() / 8;
+      // Empty arrays may have no buffer
+      if (const auto& values = c.input->data()->buffers[1]; values) {
+        c.in = values->data() + c.input->offset() * c.width;
+      }
+      c.output = KATANA_CHECKED(
+          arrow::AllocateBuffer(c.input->length() * c.width));
+      c.out = c.output->mutable_data();
+    }
+    columns.emplace_back(std::move(c));
+  }
+  return columns;
+}
+
+/// Copy row from of the input of c to row to of its output
+inline void
+CopyRow(const EdgeColumn& c, uint64_t from, uint64_t to) {
+  const uint8_t* in = c.in + from * c.width;
+  uint8_t* out = c.out + to * c.width;
+  // Constant sizes so that the common widths are a single move
+  switch (c.width) {
+  case 1:
+    *out = *in;
+    break;
+  case 2:
+    std::memcpy(out, in, 2);
+    break;
+  case 4:
+    std::memcpy(out, in, 4);
+    break;
+  case 8:
+    std::memcpy(out, in, 8);
+    break;
+  default:
+    std::memcpy(out, in, c.width);
+  }
+}
+
+/// An arrow view of edge_order, which must outlive it
+std::shared_ptr<arrow::Array>
+OrderArray(const katana::NUMAArray<uint64_t>& edge_order) {
+  return std::make_shared<arrow::UInt64Array>(
+      edge_order.size(),
+      arrow::Buffer::Wrap(edge_order.data(), edge_order.size()));
+}
+
+/// The columns of table in the order of the CSR, given edge_order from
+/// BuildTopology
+katana::Result<std::shared_ptr<arrow::Table>>
+FinishEdgeColumns(
+    const arrow::Table& table, const std::vector<EdgeColumn>& columns,
+    const std::shared_ptr<arrow::Array>& order_array) {
+  std::vector<std::shared_ptr<arrow::Array>> arrays;
+  for (const EdgeColumn& c : columns) {
+    if (c.width == 0) {
+      arrays.emplace_back(KATANA_CHECKED(
+          arrow::compute::Take(*c.input, *order_array)));
+    } else {
+      arrays.emplace_back(arrow::MakeArray(arrow::ArrayData::Make(
+          c.input->type(), order_array->length(), {nullptr, c.output}, 0)));
+    }
+  }
+  return arrow::Table::Make(table.schema(), arrays, order_array->length());
+}
+
+/// Build the CSR with a two pass counting sort of the edges by source:
+/// count the out-degree of every node, then place each edge at the next
+/// free position of its source. edge_order[i] is set to the input row of
+/// edge i of the CSR; the edges of a node are in input order. The fixed
+/// width columns are gathered along with the destinations.
+///
+/// Node ids are of any integer type and must be in [0, num_nodes).
+template <typename T>
+katana::GraphTopology
+BuildTopology(
+    size_t num_nodes, size_t num_edges, const T* sources, const T* dests,
+    const std::vector<EdgeColumn>& columns,
+    katana::NUMAArray<uint64_t>* edge_order) {
+  katana::NUMAArray<Edge> adj_indices;
+  adj_indices.allocateInterleaved(num_nodes);
+  katana::ParallelSTL::fill(adj_indices.begin(), adj_indices.end(), Edge{0});
+  katana::do_all(
+      katana::iterate(size_t{0}, num_edges),
+      [&](size_t e) { __sync_fetch_and_add(&adj_indices[sources[e]], 1); },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      adj_indices.begin(), adj_indices.end(), adj_indices.begin());
+
+  katana::NUMAArray<Edge> next;
+  next.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_nodes),
+      [&](size_t n) { next[n] = n == 0 ? 0 : adj_indices[n - 1]; },
+      katana::no_stats());
+  edge_order->allocateInterleaved(num_edges);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_edges),
+      [&](size_t e) {
+        (*edge_order)[__sync_fetch_and_add(&next[sources[e]], 1)] = e;
+      },
+      katana::no_stats());
+
+  // Concurrent placement leaves the edges of a node in any order
+  katana::do_all(
+      katana::iterate(size_t{0}, num_nodes),
+      [&](size_t n) {
+        uint64_t* order = edge_order->data();
+        std::sort(
+            order + (n == 0 ? 0 : adj_indices[n - 1]), order + adj_indices[n]);
+      },
+      katana::steal(), katana::no_stats());
+
+  std::vector<EdgeColumn> gathered;
+  std::copy_if(
+      columns.begin(), columns.end(), std::back_inserter(gathered),
+      [](const EdgeColumn& c) { return c.width != 0; });
+  katana::NUMAArray<Node> out_dests;
+  out_dests.allocateInterleaved(num_edges);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_edges),
+      [&](size_t i) {
+        uint64_t row = (*edge_order)[i];
+        out_dests[i] = static_cast<Node>(dests[row]);
+        for (const EdgeColumn& c : gathered) {
+          CopyRow(c, row, i);
+        }
+      },
+      katana::no_stats());
+
+  return katana::GraphTopology(std::move(adj_indices), std::move(out_dests));
+}
+
+/// Split the string column of table at index into one boolean column for
+/// each of its distinct values, true for the rows with that value
+katana::Result<std::shared_ptr<arrow::Table>>
+MakeLabels(const arrow::Table& table, int index) {
+  auto encoded = KATANA_CHECKED(katana::DictionaryEncode(table.column(index)));
+  auto array = std::static_pointer_cast<arrow::DictionaryArray>(
+      KATANA_CHECKED(katana::CombinedArray(encoded)));
+  auto names = std::static_pointer_cast<arrow::LargeStringArray>(
+      KATANA_CHECKED(arrow::compute::Cast(
+          *array->dictionary(), arrow::large_utf8())));
+  const auto& codes = static_cast<const arrow::Int32Array&>(*array->indices());
+
+  const size_t num_rows = array->length();
+  const size_t num_words = (num_rows + 63) / 64;
+  std::vector<std::shared_ptr<arrow::Buffer>> bitmaps;
+  std::vector<uint64_t*> words;
+  for (int64_t i = 0; i < names->length(); ++i) {
+    std::shared_ptr<arrow::Buffer> bitmap =
+        KATANA_CHECKED(arrow::AllocateBuffer(num_words * sizeof(uint64_t)));
+    words.emplace_back(reinterpret_cast<uint64_t*>(bitmap->mutable_data()));
+    bitmaps.emplace_back(std::move(bitmap));
+  }
+
+  // Each task writes one word of every label, so no word is shared
+  katana::do_all(
+      katana::iterate(size_t{0}, num_words),
+      [&](size_t w) {
+        for (uint64_t* label_words : words) {
+          label_words[w] = 0;
+        }
+        size_t end = std::min(num_rows, (w + 1) * 64);
+        for (size_t i = w * 64; i < end; ++i) {
+          if (array->IsValid(i)) {
+            words[codes.Value(i)][w] |= uint64_t{1} << (i % 64);
+          }
+        }
+      },
+      katana::no_stats());
+
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::Array>> columns;
+  for (int64_t i = 0; i < names->length(); ++i) {
+    fields.emplace_back(arrow::field(names->GetString(i), arrow::boolean()));
+    columns.emplace_back(
+        std::make_shared<arrow::BooleanArray>(num_rows, bitmaps[i]));
+  }
+  return arrow::Table::Make(arrow::schema(fields), columns, num_rows);
+}
+
+std::shared_ptr<arrow::Table>
+EmptyTable(int64_t num_rows) {
+  return arrow::Table::Make(
+      arrow::schema(std::vector<std::shared_ptr<arrow::Field>>{}),
+      std::vector<std::shared_ptr<arrow::Array>>{}, num_rows);
+}
+
+/// Remove the columns at indexes from table
+katana::Result<std::shared_ptr<arrow::Table>>
+RemoveColumns(std::shared_ptr<arrow::Table> table, std::vector<int> indexes) {
+  std::sort(indexes.begin(), indexes.end(), std::greater<int>());
+  for (int index : indexes) {
+    table = KATANA_CHECKED(table->RemoveColumn(index));
+  }
+  return table;
+}
+
+/// CSV readers make string columns; properties are large strings
+katana::Result<std::shared_ptr<arrow::Table>>
+StringsToLargeStrings(const std::shared_ptr<arrow::Table>& table) {
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (int i = 0; i < table->num_columns(); ++i) {
+    std::shared_ptr<arrow::ChunkedArray> column = table->column(i);
+    if (column->type()->id() == arrow::Type::STRING) {
+      std::vector<std::shared_ptr<arrow::Array>> chunks;
+      for (const auto& chunk : column->chunks()) {
+        chunks.emplace_back(
+            KATANA_CHECKED(arrow::compute::Cast(*chunk, arrow::large_utf8())));
+      }
+      column = std::make_shared<arrow::ChunkedArray>(
+          std::move(chunks), arrow::large_utf8());
+    }
+    fields.emplace_back(arrow::field(table->field(i)->name(), column->type()));
+    columns.emplace_back(std::move(column));
+  }
+  return arrow::Table::Make(arrow::schema(fields), columns, table->num_rows());
+}
+
+/// ImportEdgeList for node ids of type T
+template <typename T>
+katana::Result<katana::GraphComponents>
+ImportIdArrays(
+    const arrow::Array& sources, const arrow::Array& dests,
+    const std::shared_ptr<arrow::Table>& edge_properties) {
+  const size_t num_edges = sources.length();
+  const T* source_ids = sources.data()->GetValues<T>(1);
+  const T* dest_ids = dests.data()->GetValues<T>(1);
+
+  katana::GReduceMin<T> min_id;
+  katana::GReduceMax<T> max_id;
+  katana::do_all(
+      katana::iterate(size_t{0}, num_edges),
+      [&](size_t e) {
+        min_id.update(std::min(source_ids[e], dest_ids[e]));
+        max_id.update(std::max(source_ids[e], dest_ids[e]));
+      },
+      katana::no_stats());
+  size_t num_nodes = 0;
+  if (num_edges > 0) {
+    if constexpr (std::is_signed_v<T>) {
+      if (min_id.reduce() < 0) {
+        return KATANA_ERROR(
+            katana::ErrorCode::InvalidArgument, "negative node id: {}",
+            min_id.reduce());
+      }
+    }
+    num_nodes = static_cast<size_t>(max_id.reduce()) + 1;
+    if (num_nodes >= std::numeric_limits<Node>::max()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "too many nodes: {}",
+          num_nodes);
+    }
+  }
+
+  auto edge_columns = KATANA_CHECKED(MakeEdgeColumns(*edge_properties));
+  katana::NUMAArray<uint64_t> edge_order;
+  katana::GraphTopology topology = BuildTopology(
+      num_nodes, num_edges, source_ids, dest_ids, edge_columns, &edge_order);
+  auto properties = KATANA_CHECKED(FinishEdgeColumns(
+      *edge_properties, edge_columns, OrderArray(edge_order)));
+
+  return katana::GraphComponents(
+      katana::GraphComponent(EmptyTable(num_nodes), EmptyTable(num_nodes)),
+      katana::GraphComponent(properties, EmptyTable(num_edges)),
+      std::move(topology));
+}
+
+}  // namespace
+
+katana::Result<std::shared_ptr<arrow::Table>>
+katana::ReadImportTable(const std::string& path, SourceType format) {
+  katana::Uri uri = KATANA_CHECKED(katana::Uri::Make(path));
+  switch (format) {
+  case SourceType::kParquet: {
+    tsuba::ParquetReader::ReadOpts opts;
+    opts.use_threads = true;
+    auto reader = KATANA_CHECKED(tsuba::ParquetReader::Make(opts));
+    return KATANA_CHECKED_CONTEXT(reader->ReadTable(uri), "reading {}", path);
+  }
+  case SourceType::kCsv: {
+    auto file = std::make_shared<tsuba::FileView>();
+    KATANA_CHECKED_CONTEXT(file->Bind(uri.string(), true), "opening {}", path);
+    auto read_options = arrow::csv::ReadOptions::Defaults();
+    read_options.use_threads = true;
+    auto reader = KATANA_CHECKED(arrow::csv::TableReader::Make(
+        arrow::default_memory_pool(), file, read_options,
+        arrow::csv::ParseOptions::Defaults(),
+        arrow::csv::ConvertOptions::Defaults()));
+    std::shared_ptr<arrow::Table> table =
+        KATANA_CHECKED_CONTEXT(reader->Read(), "reading {}", path);
+    return StringsToLargeStrings(table);
+  }
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "only csv and parquet files can be imported");
+  }
+}
+
+katana::Result<katana::GraphComponents>
+katana::ImportTables(
+    const std::shared_ptr<arrow::Table>& nodes,
+    const std::shared_ptr<arrow::Table>& edges,
+    const BulkImportOptions& options) {
+  const int id_index = KATANA_CHECKED_CONTEXT(
+      ColumnIndex(*nodes, options.node_id_column), "node ids");
+  const int source_index = KATANA_CHECKED_CONTEXT(
+      ColumnIndex(*edges, options.edge_source_column), "edge sources");
+  const int dest_index = KATANA_CHECKED_CONTEXT(
+      ColumnIndex(*edges, options.edge_destination_column),
+      "edge destinations");
+  const size_t num_nodes = nodes->num_rows();
+  if (num_nodes >= std::numeric_limits<Node>::max()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "too many nodes: {}", num_nodes);
+  }
+
+  auto key_type = KATANA_CHECKED_CONTEXT(
+      KeyType(*nodes->column(id_index)->type()), "node ids");
+  auto node_ids = KATANA_CHECKED(CombinedAs(nodes->column(id_index), key_type));
+  auto sources = KATANA_CHECKED_CONTEXT(
+      CombinedAs(edges->column(source_index), key_type), "edge sources");
+  auto dests = KATANA_CHECKED_CONTEXT(
+      CombinedAs(edges->column(dest_index), key_type), "edge destinations");
+
+  katana::NUMAArray<Node> edge_sources;
+  katana::NUMAArray<Node> edge_dests;
+  if (key_type->id() == arrow::Type::INT64) {
+    KATANA_CHECKED(MapEdgeEnds<int64_t>(
+        *node_ids, *sources, *dests, &edge_sources, &edge_dests));
+  } else {
+    KATANA_CHECKED(MapEdgeEnds<std::string_view>(
+        *node_ids, *sources, *dests, &edge_sources, &edge_dests));
+  }
+  node_ids.reset();
+  sources.reset();
+  dests.reset();
+
+
+  std::shared_ptr<arrow::Table> node_properties = nodes;
+  std::shared_ptr<arrow::Table> node_labels = EmptyTable(num_nodes);
+  if (!options.node_label_column.empty()) {
+    int index = KATANA_CHECKED_CONTEXT(
+        ColumnIndex(*nodes, options.node_label_column), "node labels");
+    node_labels = KATANA_CHECKED(MakeLabels(*nodes, index));
+    node_properties = KATANA_CHECKED(RemoveColumns(nodes, {index}));
+  }
+
+  std::vector<int> edge_structure{source_index, dest_index};
+  std::shared_ptr<arrow::Table> edge_labels = EmptyTable(edges->num_rows());
+  if (!options.edge_type_column.empty()) {
+    int index = KATANA_CHECKED_CONTEXT(
+        ColumnIndex(*edges, options.edge_type_column), "edge types");
+    edge_labels = KATANA_CHECKED(MakeLabels(*edges, index));
+    edge_structure.emplace_back(index);
+  }
+  auto edge_properties = KATANA_CHECKED(RemoveColumns(edges, edge_structure));
+
+  // Put the edge rows in the order of the CSR
+  auto edge_columns = KATANA_CHECKED(MakeEdgeColumns(*edge_properties));
+  katana::NUMAArray<uint64_t> edge_order;
+  GraphTopology topology = BuildTopology(
+      num_nodes, edge_sources.size(), edge_sources.data(), edge_dests.data(),
+      edge_columns, &edge_order);
+  auto order_array = OrderArray(edge_order);
+  edge_properties = KATANA_CHECKED(
+      FinishEdgeColumns(*edge_properties, edge_columns, order_array));
+  if (edge_labels->num_columns() > 0) {
+    edge_labels =
+        KATANA_CHECKED(arrow::compute::Take(edge_labels, order_array)).table();
+  }
+
+  return GraphComponents(
+      GraphComponent(node_properties, node_labels),
+      GraphComponent(edge_properties, edge_labels), std::move(topology));
+}
+
+katana::Result<katana::GraphComponents>
+katana::ImportFiles(
+    const std::vector<std::string>& node_paths,
+    const std::vector<std::string>& edge_paths, SourceType format,
+    const BulkImportOptions& options) {
+  auto read = [&](const std::vector<std::string>& paths)
+      -> katana::Result<std::shared_ptr<arrow::Table>> {
+    std::vector<std::shared_ptr<arrow::Table>> tables;
+    for (const std::string& path : paths) {
+      tables.emplace_back(KATANA_CHECKED(ReadImportTable(path, format)));
+    }
+    if (tables.size() == 1) {
+      return tables[0];
+    }
+    return KATANA_CHECKED(arrow::ConcatenateTables(tables));
+  };
+  if (node_paths.empty() || edge_paths.empty()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "node and edge files are required");
+  }
+  auto nodes = KATANA_CHECKED_CONTEXT(read(node_paths), "reading nodes");
+  auto edges = KATANA_CHECKED_CONTEXT(read(edge_paths), "reading edges");
+  return ImportTables(nodes, edges, options);
+}
+
+katana::Result<katana::GraphComponents>
+katana::ImportEdgeList(
+    std::shared_ptr<arrow::Array> sources, std::shared_ptr<arrow::Array> dests,
+    std::shared_ptr<arrow::Table> edge_properties) {
+  if (sources->length() != dests->length()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "{} sources but {} destinations", sources->length(), dests->length());
+  }
+  if (!edge_properties) {
+    edge_properties = EmptyTable(sources->length());
+  } else if (edge_properties->num_rows() != sources->length()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "{} edges but {} rows of edge properties", sources->length(),
+        edge_properties->num_rows());
+  }
+  if (sources->null_count() > 0 || dests->null_count() > 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "sources and destinations cannot be null");
+  }
+  if (!sources->type()->Equals(*dests->type())) {
+    sources = KATANA_CHECKED_CONTEXT(
+        arrow::compute::Cast(*sources, arrow::int64()), "sources");
+    dests = KATANA_CHECKED_CONTEXT(
+        arrow::compute::Cast(*dests, arrow::int64()), "destinations");
+  }
+
+  switch (sources->type()->id()) {
+  case arrow::Type::INT8:
+    return ImportIdArrays<int8_t>(*sources, *dests, edge_properties);
+  case arrow::Type::UINT8:
+    return ImportIdArrays<uint8_t>(*sources, *dests, edge_properties);
+  case arrow::Type::INT16:
+    return ImportIdArrays<int16_t>(*sources, *dests, edge_properties);
+  case arrow::Type::UINT16:
+    return ImportIdArrays<uint16_t>(*sources, *dests, edge_properties);
+  case arrow::Type::INT32:
+    return ImportIdArrays<int32_t>(*sources, *dests, edge_properties);
+  case arrow::Type::UINT32:
+    return ImportIdArrays<uint32_t>(*sources, *dests, edge_properties);
+  case arrow::Type::INT64:
+    return ImportIdArrays<int64_t>(*sources, *dests, edge_properties);
+  case arrow::Type::UINT64:
+    return ImportIdArrays<uint64_t>(*sources, *dests, edge_properties);
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "node ids must be integers, not {}",
+        sources->type()->ToString());
+  }
+}
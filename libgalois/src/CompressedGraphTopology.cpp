@@ -0,0 +1,280 @@
+#include "katana/CompressedGraphTopology.h"
+
+#include <algorithm>
+#include <atomic>
+
+#include "katana/ErrorCode.h"
+#include "katana/Loops.h"
+#include "katana/ParallelSTL.h"
+
+namespace {
+
+using Edge = katana::GraphTopologyTypes::Edge;
+using Node = katana::GraphTopologyTypes::Node;
+
+/// \returns the source node of edge \p e
+Node
+SourceOf(const Edge* adj_indices, uint64_t num_nodes, Edge e) {
+  return static_cast<Node>(
+      std::upper_bound(adj_indices, adj_indices + num_nodes, e) - adj_indices);
+}
+
+/// Call fn(edge, src, rebase) for each edge in [begin, end) in order, where
+/// rebase is true if the edge's destination is encoded relative to its source
+/// rather than to the preceding destination. \p begin must be the first edge
+/// of a block.
+template <typename Fn>
+void
+ForEachEdgeInBlock(
+    const Edge* adj_indices, uint64_t num_nodes, Edge begin, Edge end,
+    const Fn& fn) {
+  Node src = SourceOf(adj_indices, num_nodes, begin);
+  for (Edge e = begin; e < end; ++e) {
+    while (adj_indices[src] <= e) {
+      ++src;
+    }
+    Edge node_begin = src > 0 ? adj_indices[src - 1] : 0;
+    fn(e, src, e == begin || e == node_begin);
+  }
+}
+
+/// Like katana::internal::ReadVarint but never reads at or past \p end.
+/// \returns nullptr if the varint is truncated
+const uint8_t*
+ReadVarintChecked(const uint8_t* pos, const uint8_t* end, uint64_t* val) {
+  uint64_t result = 0;
+  for (int shift = 0; shift < 64 && pos < end; shift += 7) {
+    uint8_t byte = *pos++;
+    result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) {
+      *val = result;
+      return pos;
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace
+
+katana::CompressedGraphTopology::CompressedGraphTopology(
+    const Edge* adj_indices, size_t num_nodes, size_t num_edges,
+    uint64_t edges_per_block, const uint64_t* block_offsets, size_t num_blocks,
+    const uint8_t* payload, size_t payload_size) noexcept
+    : num_edges_(num_edges), edges_per_block_(edges_per_block) {
+  adj_indices_.allocateInterleaved(num_nodes);
+  block_offsets_.allocateInterleaved(num_blocks + 1);
+  payload_.allocateInterleaved(payload_size);
+
+  katana::ParallelSTL::copy(
+      &adj_indices[0], &adj_indices[num_nodes], adj_indices_.begin());
+  katana::ParallelSTL::copy(
+      &block_offsets[0], &block_offsets[num_blocks + 1],
+      block_offsets_.begin());
+  katana::ParallelSTL::copy(
+      &payload[0], &payload[payload_size], payload_.begin());
+}
+
+katana::CompressedGraphTopology
+katana::CompressedGraphTopology::Make(
+    const GraphTopology& topology, uint64_t edges_per_block) noexcept {
+  KATANA_LOG_VASSERT(edges_per_block > 0, "blocks must hold at least one edge");
+
+  const uint64_t num_nodes = topology.num_nodes();
+  const uint64_t num_edges = topology.num_edges();
+  const Edge* adj = topology.adj_data();
+  const Node* dests = topology.dest_data();
+
+  CompressedGraphTopology ret;
+  ret.num_edges_ = num_edges;
+  ret.edges_per_block_ = edges_per_block;
+  ret.adj_indices_.allocateInterleaved(num_nodes);
+  katana::ParallelSTL::copy(&adj[0], &adj[num_nodes], ret.adj_indices_.begin());
+
+  const uint64_t num_blocks = (num_edges + edges_per_block - 1) / edges_per_block;
+  ret.block_offsets_.allocateInterleaved(num_blocks + 1);
+  ret.block_offsets_[0] = 0;
+
+  auto block_bounds = [&](uint64_t block) {
+    Edge begin = block * edges_per_block;
+    return std::make_pair(begin, std::min(begin + edges_per_block, num_edges));
+  };
+
+  // Size each block, then lay them out back to back
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_blocks),
+      [&](uint64_t block) {
+        auto [begin, end] = block_bounds(block);
+        uint64_t size = 0;
+        Node prev{0};
+        ForEachEdgeInBlock(
+            adj, num_nodes, begin, end, [&](Edge e, Node src, bool rebase) {
+              int64_t base = rebase ? src : prev;
+              size += internal::VarintSize(internal::ZigZagEncode(
+                  static_cast<int64_t>(dests[e]) - base));
+              prev = dests[e];
+            });
+        ret.block_offsets_[block + 1] = size;
+      },
+      katana::steal(), katana::no_stats());
+
+  katana::ParallelSTL::partial_sum(
+      ret.block_offsets_.begin(), ret.block_offsets_.end(),
+      ret.block_offsets_.begin());
+
+  ret.payload_.allocateInterleaved(ret.block_offsets_[num_blocks]);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_blocks),
+      [&](uint64_t block) {
+        auto [begin, end] = block_bounds(block);
+        uint8_t* pos = ret.payload_.data() + ret.block_offsets_[block];
+        Node prev{0};
+        ForEachEdgeInBlock(
+            adj, num_nodes, begin, end, [&](Edge e, Node src, bool rebase) {
+              int64_t base = rebase ? src : prev;
+              pos = internal::WriteVarint(
+                  pos, internal::ZigZagEncode(
+                           static_cast<int64_t>(dests[e]) - base));
+              prev = dests[e];
+            });
+        KATANA_LOG_DEBUG_ASSERT(
+            pos == ret.payload_.data() + ret.block_offsets_[block + 1]);
+      },
+      katana::steal(), katana::no_stats());
+
+  return ret;
+}
+
+template <typename Fn>
+katana::Result<void>
+katana::CompressedGraphTopology::DecodeChecked(const Fn& fn) const {
+  const uint64_t num_nodes = this->num_nodes();
+  const uint64_t num_blocks = this->num_blocks();
+
+  if (edges_per_block_ == 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "compressed topology has empty blocks");
+  }
+  if (num_blocks != (num_edges_ + edges_per_block_ - 1) / edges_per_block_ ||
+      (num_nodes > 0 && adj_indices_[num_nodes - 1] != num_edges_) ||
+      (num_nodes == 0 && num_edges_ != 0)) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "compressed topology sizes do not match: nodes: {} edges: {} "
+        "blocks: {}",
+        num_nodes, num_edges_, num_blocks);
+  }
+  if (block_offsets_.empty() ||
+      block_offsets_[num_blocks] != payload_.size() ||
+      !std::is_sorted(block_offsets_.begin(), block_offsets_.end()) ||
+      !std::is_sorted(adj_indices_.begin(), adj_indices_.end())) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "compressed topology index is corrupt");
+  }
+
+  std::atomic<bool> corrupt{false};
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_blocks),
+      [&](uint64_t block) {
+        Edge begin = block * edges_per_block_;
+        Edge end = std::min(begin + edges_per_block_, num_edges_);
+        const uint8_t* pos = payload_.data() + block_offsets_[block];
+        const uint8_t* block_end = payload_.data() + block_offsets_[block + 1];
+        Node prev{0};
+        ForEachEdgeInBlock(
+            adj_indices_.data(), num_nodes, begin, end,
+            [&](Edge e, Node src, bool rebase) {
+              if (pos == nullptr) {
+                return;
+              }
+              uint64_t raw;
+              pos = ReadVarintChecked(pos, block_end, &raw);
+              if (pos == nullptr) {
+                return;
+              }
+              int64_t base = rebase ? src : prev;
+              int64_t dest = base + internal::ZigZagDecode(raw);
+              if (dest < 0 || static_cast<uint64_t>(dest) >= num_nodes) {
+                pos = nullptr;
+                return;
+              }
+              prev = static_cast<Node>(dest);
+              fn(e, prev);
+            });
+        if (pos != block_end) {
+          corrupt = true;
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  if (corrupt) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "compressed topology payload is corrupt");
+  }
+  return ResultSuccess();
+}
+
+katana::Result<void>
+katana::CompressedGraphTopology::Validate() const {
+  return DecodeChecked([](Edge, Node) {});
+}
+
+katana::Result<katana::GraphTopology>
+katana::CompressedGraphTopology::Decompress() const {
+  NUMAArray<Edge> adj_indices;
+  adj_indices.allocateInterleaved(num_nodes());
+  katana::ParallelSTL::copy(
+      adj_indices_.begin(), adj_indices_.end(), adj_indices.begin());
+
+  NUMAArray<Node> dests;
+  dests.allocateInterleaved(num_edges_);
+  KATANA_CHECKED(DecodeChecked([&](Edge e, Node dest) { dests[e] = dest; }));
+
+  return GraphTopology(std::move(adj_indices), std::move(dests));
+}
+
+katana::CompressedGraphTopology::Node
+katana::CompressedGraphTopology::FirstSourceOfBlock(
+    uint64_t block) const noexcept {
+  return SourceOf(adj_indices_.data(), num_nodes(), block * edges_per_block_);
+}
+
+katana::CompressedGraphTopology::dests_range
+katana::CompressedGraphTopology::dests(Node node) const noexcept {
+  auto e_range = edges(node);
+  Edge begin = *e_range.begin();
+  Edge end = *e_range.end();
+
+  DestIterator last(nullptr, end, begin, end, node, edges_per_block_);
+  if (begin == end) {
+    return MakeStandardRange(last, last);
+  }
+
+  // Skip the edges of the nodes that precede this one in its first block
+  uint64_t block = begin / edges_per_block_;
+  const uint8_t* pos = payload_.data() + block_offsets_[block];
+  for (Edge e = block * edges_per_block_; e < begin; ++e) {
+    pos = internal::SkipVarint(pos);
+  }
+
+  return MakeStandardRange(
+      DestIterator(pos, begin, begin, end, node, edges_per_block_), last);
+}
+
+katana::CompressedGraphTopology::Node
+katana::CompressedGraphTopology::edge_dest(Edge edge_id) const noexcept {
+  KATANA_LOG_DEBUG_ASSERT(edge_id < num_edges_);
+
+  uint64_t block = edge_id / edges_per_block_;
+  Edge begin = block * edges_per_block_;
+  const uint8_t* pos = payload_.data() + block_offsets_[block];
+  Node dest{0};
+  ForEachEdgeInBlock(
+      adj_indices_.data(), num_nodes(), begin, edge_id + 1,
+      [&](Edge, Node src, bool rebase) {
+        uint64_t raw;
+        pos = internal::ReadVarint(pos, &raw);
+        int64_t base = rebase ? src : dest;
+        dest = static_cast<Node>(base + internal::ZigZagDecode(raw));
+      });
+  return dest;
+}
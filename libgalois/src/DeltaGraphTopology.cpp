@@ -0,0 +1,121 @@
+#include "katana/DeltaGraphTopology.h"
+
+#include <algorithm>
+
+#include "katana/ErrorCode.h"
+#include "katana/Loops.h"
+#include "katana/ParallelSTL.h"
+
+katana::DeltaGraphTopology::DeltaGraphTopology(GraphTopology&& base) noexcept
+    : base_(std::move(base)),
+      inserted_(base_.num_nodes()),
+      num_edges_(base_.num_edges()) {
+  deleted_.resize(base_.num_edges());
+}
+
+size_t
+katana::DeltaGraphTopology::degree(Node node) const noexcept {
+  auto e_range = edges(node);
+  return std::distance(e_range.begin(), e_range.end());
+}
+
+void
+katana::DeltaGraphTopology::AddNodes(uint64_t count) {
+  inserted_.resize(inserted_.size() + count);
+}
+
+katana::Result<katana::DeltaGraphTopology::Edge>
+katana::DeltaGraphTopology::InsertEdge(Node src, Node dst) {
+  if (src >= num_nodes() || dst >= num_nodes()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "edge ({}, {}) is out of range for a graph with {} nodes", src, dst,
+        num_nodes());
+  }
+
+  Edge id = base_.num_edges() + inserted_dests_.size();
+  inserted_dests_.emplace_back(dst);
+  inserted_[src].emplace_back(id);
+  ++num_edges_;
+  return id;
+}
+
+katana::Result<void>
+katana::DeltaGraphTopology::DeleteEdge(Node src, Node dst) {
+  if (src >= num_nodes() || dst >= num_nodes()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "edge ({}, {}) is out of range for a graph with {} nodes", src, dst,
+        num_nodes());
+  }
+
+  std::vector<Edge>& inserted = inserted_[src];
+  auto it = std::find_if(inserted.begin(), inserted.end(), [&](Edge e) {
+    return edge_dest(e) == dst;
+  });
+  if (it != inserted.end()) {
+    // Keep insertion order so that iteration order stays predictable
+    inserted.erase(it);
+    --num_edges_;
+    return ResultSuccess();
+  }
+
+  if (src < base_.num_nodes()) {
+    for (Edge e : base_.edges(src)) {
+      if (base_.edge_dest(e) == dst && !deleted_.test(e)) {
+        deleted_.set(e);
+        ++num_deleted_;
+        --num_edges_;
+        return ResultSuccess();
+      }
+    }
+  }
+
+  return KATANA_ERROR(
+      ErrorCode::NotFound, "no edge ({}, {}) to delete", src, dst);
+}
+
+katana::GraphTopology
+katana::DeltaGraphTopology::Materialize(PropIndexVec* old_edge_ids) const {
+  const uint64_t num_nodes = this->num_nodes();
+
+  AdjIndexVec adj_indices;
+  adj_indices.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(all_nodes()),
+      [&](Node node) { adj_indices[node] = degree(node); }, katana::steal(),
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      adj_indices.begin(), adj_indices.end(), adj_indices.begin());
+
+  const uint64_t num_edges = num_nodes > 0 ? adj_indices[num_nodes - 1] : 0;
+  KATANA_LOG_DEBUG_ASSERT(num_edges == num_edges_);
+
+  EdgeDestVec dests;
+  dests.allocateInterleaved(num_edges);
+  if (old_edge_ids != nullptr) {
+    old_edge_ids->allocateInterleaved(num_edges);
+  }
+
+  katana::do_all(
+      katana::iterate(all_nodes()),
+      [&](Node node) {
+        Edge out = node > 0 ? adj_indices[node - 1] : 0;
+        for (Edge e : edges(node)) {
+          dests[out] = edge_dest(e);
+          if (old_edge_ids != nullptr) {
+            (*old_edge_ids)[out] = e;
+          }
+          ++out;
+        }
+        KATANA_LOG_DEBUG_ASSERT(out == adj_indices[node]);
+      },
+      katana::steal(), katana::no_stats());
+
+  return GraphTopology(std::move(adj_indices), std::move(dests));
+}
+
+void
+katana::DeltaGraphTopology::Compact(PropIndexVec* old_edge_ids) {
+  *this = DeltaGraphTopology(Materialize(old_edge_ids));
+}
@@ -23,33 +23,262 @@
 
 #include "katana/DynamicBitset.h"
 
+#include <algorithm>
+
 #include "katana/Galois.h"
 
 KATANA_EXPORT katana::DynamicBitset katana::EmptyBitset;
 
+// The word kernels below are compiled for several instruction sets and the
+// best one for the running CPU is picked when the library is loaded
+#if defined(__x86_64__) && defined(__linux__) && defined(__has_attribute)
+#if __has_attribute(target_clones)
+#define KATANA_BITSET_CLONES                                                   \
+  __attribute__((target_clones("avx512f", "avx2", "default")))
+#define KATANA_POPCOUNT_CLONES                                                 \
+  __attribute__((target_clones("arch=icelake-server", "popcnt", "default")))
+#endif
+#endif
+#ifndef KATANA_BITSET_CLONES
+#define KATANA_BITSET_CLONES
+#define KATANA_POPCOUNT_CLONES
+#endif
+
+namespace {
+
+using Word = uint64_t;
+
+// Bulk operations assume that no bit is set concurrently, so they access the
+// words as plain integers, which lets the compiler vectorize them
+static_assert(sizeof(katana::CopyableAtomic<Word>) == sizeof(Word));
+static_assert(std::atomic<Word>::is_always_lock_free);
+
+/// Words per task of a parallel bulk operation. Bitsets of at most this many
+/// words are processed by the calling thread alone.
+constexpr size_t kWordsPerBlock = 4096;
+
+Word*
+Words(katana::DynamicBitset* bitset) {
+  return reinterpret_cast<Word*>(bitset->get_vec().data());
+}
+
+const Word*
+Words(const katana::DynamicBitset& bitset) {
+  return reinterpret_cast<const Word*>(bitset.get_vec().data());
+}
+
+/// The bits of the last word that are within the bitset
+Word
+LastWordMask(const katana::DynamicBitset& bitset) {
+  size_t used = bitset.size() % katana::DynamicBitset::kNumBitsInUint64;
+  return used == 0 ? ~Word{0} : (Word{1} << used) - 1;
+}
+
+/// Call fn(begin, end) on blocks of [0, num_words), in parallel if there is
+/// more than one block
+template <typename F>
+void
+ForEachBlock(size_t num_words, const F& fn) {
+  if (num_words <= kWordsPerBlock) {
+    fn(size_t{0}, num_words);
+    return;
+  }
+  size_t num_blocks = (num_words + kWordsPerBlock - 1) / kWordsPerBlock;
+  katana::do_all(
+      katana::iterate(size_t{0}, num_blocks),
+      [&](size_t block) {
+        size_t begin = block * kWordsPerBlock;
+        fn(begin, std::min(begin + kWordsPerBlock, num_words));
+      },
+      katana::steal(), katana::no_stats());
+}
+
+KATANA_BITSET_CLONES void
+OrWords(Word* __restrict dst, const Word* __restrict a, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    dst[i] |= a[i];
+  }
+}
+
+KATANA_BITSET_CLONES void
+AndWords(Word* __restrict dst, const Word* __restrict a, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    dst[i] &= a[i];
+  }
+}
+
+KATANA_BITSET_CLONES void
+XorWords(Word* __restrict dst, const Word* __restrict a, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    dst[i] ^= a[i];
+  }
+}
+
+KATANA_BITSET_CLONES void
+AndNotWords(Word* __restrict dst, const Word* __restrict a, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    dst[i] &= ~a[i];
+  }
+}
+
+KATANA_BITSET_CLONES void
+NotWords(Word* __restrict dst, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    dst[i] = ~dst[i];
+  }
+}
+
+// The two-source kernels allow dst to alias a source, so they cannot be
+// restrict; the loops are still simple enough to vectorize
+KATANA_BITSET_CLONES void
+OrWords(Word* dst, const Word* a, const Word* b, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    dst[i] = a[i] | b[i];
+  }
+}
+
+KATANA_BITSET_CLONES void
+AndWords(Word* dst, const Word* a, const Word* b, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    dst[i] = a[i] & b[i];
+  }
+}
+
+KATANA_BITSET_CLONES void
+XorWords(Word* dst, const Word* a, const Word* b, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    dst[i] = a[i] ^ b[i];
+  }
+}
+
+KATANA_BITSET_CLONES void
+AndNotWords(Word* dst, const Word* a, const Word* b, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    dst[i] = a[i] & ~b[i];
+  }
+}
+
+KATANA_POPCOUNT_CLONES size_t
+CountWords(const Word* a, size_t n) {
+  size_t ret = 0;
+  for (size_t i = 0; i < n; ++i) {
+    ret += __builtin_popcountll(a[i]);
+  }
+  return ret;
+}
+
+/// Count the set bits of words [begin, end), ignoring bits past the end of
+/// the bitset
+size_t
+CountRange(const katana::DynamicBitset& bitset, size_t begin, size_t end) {
+  const Word* words = Words(bitset);
+  size_t num_words = bitset.get_vec().size();
+  if (begin >= end) {
+    return 0;
+  }
+  if (end < num_words) {
+    return CountWords(words + begin, end - begin);
+  }
+  return CountWords(words + begin, end - 1 - begin) +
+         __builtin_popcountll(words[end - 1] & LastWordMask(bitset));
+}
+
+/// Write the positions of the set bits of words [begin, end) to out
+template <typename Integer>
+void
+ExtractRange(
+    const katana::DynamicBitset& bitset, size_t begin, size_t end,
+    Integer* out) {
+  const Word* words = Words(bitset);
+  size_t num_words = bitset.get_vec().size();
+  for (size_t i = begin; i < end; ++i) {
+    Word w = words[i];
+    if (i == num_words - 1) {
+      w &= LastWordMask(bitset);
+    }
+    Integer base = i * katana::DynamicBitset::kNumBitsInUint64;
+    while (w) {
+      *out++ = base + __builtin_ctzll(w);
+      w &= w - 1;
+    }
+  }
+}
+
+template <typename Integer>
+void
+ComputeOffsets(
+    const katana::DynamicBitset& bitset, std::vector<Integer>* offsets) {
+  size_t num_words = bitset.get_vec().size();
+  if (num_words == 0) {
+    return;
+  }
+
+  // Split the words into blocks; count the set bits of each block, then
+  // write each block's offsets starting at the prefix sum of the counts
+  size_t num_blocks = (num_words + kWordsPerBlock - 1) / kWordsPerBlock;
+  std::vector<size_t> block_offsets(num_blocks + 1);
+  ForEachBlock(num_words, [&](size_t begin, size_t end) {
+    size_t block = begin / kWordsPerBlock;
+    block_offsets[block + 1] = CountRange(bitset, begin, end);
+  });
+  for (size_t i = 1; i <= num_blocks; ++i) {
+    block_offsets[i] += block_offsets[i - 1];
+  }
+
+  size_t bitset_count = block_offsets[num_blocks];
+  if (bitset_count == 0) {
+    return;
+  }
+  size_t cur_size = offsets->size();
+  offsets->resize(cur_size + bitset_count);
+  Integer* out = offsets->data() + cur_size;
+  ForEachBlock(num_words, [&](size_t begin, size_t end) {
+    size_t block = begin / kWordsPerBlock;
+    ExtractRange(bitset, begin, end, out + block_offsets[block]);
+  });
+}
+
+}  // namespace
+
 void
 katana::DynamicBitset::bitwise_or(const DynamicBitset& other) {
   KATANA_LOG_DEBUG_ASSERT(size() == other.size());
-  const auto& other_bitvec = other.get_vec();
-  katana::do_all(
-      katana::iterate(size_t{0}, bitvec_.size()),
-      [&](size_t i) { bitvec_[i] |= other_bitvec[i]; }, katana::no_stats());
+  Word* dst = Words(this);
+  const Word* src = Words(other);
+  ForEachBlock(bitvec_.size(), [&](size_t begin, size_t end) {
+    OrWords(dst + begin, src + begin, end - begin);
+  });
+}
+
+void
+katana::DynamicBitset::bitwise_or(
+    const DynamicBitset& other1, const DynamicBitset& other2) {
+  KATANA_LOG_DEBUG_ASSERT(size() == other1.size());
+  KATANA_LOG_DEBUG_ASSERT(size() == other2.size());
+  Word* dst = Words(this);
+  const Word* src1 = Words(other1);
+  const Word* src2 = Words(other2);
+  ForEachBlock(bitvec_.size(), [&](size_t begin, size_t end) {
+    OrWords(dst + begin, src1 + begin, src2 + begin, end - begin);
+  });
 }
 
 void
 katana::DynamicBitset::bitwise_not() {
-  katana::do_all(
-      katana::iterate(size_t{0}, bitvec_.size()),
-      [&](size_t i) { bitvec_[i] = ~bitvec_[i]; }, katana::no_stats());
+  Word* dst = Words(this);
+  ForEachBlock(bitvec_.size(), [&](size_t begin, size_t end) {
+    NotWords(dst + begin, end - begin);
+  });
 }
 
 void
 katana::DynamicBitset::bitwise_and(const DynamicBitset& other) {
   KATANA_LOG_DEBUG_ASSERT(size() == other.size());
-  const auto& other_bitvec = other.get_vec();
-  katana::do_all(
-      katana::iterate(size_t{0}, bitvec_.size()),
-      [&](size_t i) { bitvec_[i] &= other_bitvec[i]; }, katana::no_stats());
+  Word* dst = Words(this);
+  const Word* src = Words(other);
+  ForEachBlock(bitvec_.size(), [&](size_t begin, size_t end) {
+    AndWords(dst + begin, src + begin, end - begin);
+  });
 }
 
 void
@@ -57,22 +286,45 @@ katana::DynamicBitset::bitwise_and(
     const DynamicBitset& other1, const DynamicBitset& other2) {
   KATANA_LOG_DEBUG_ASSERT(size() == other1.size());
   KATANA_LOG_DEBUG_ASSERT(size() == other2.size());
-  const auto& other_bitvec1 = other1.get_vec();
-  const auto& other_bitvec2 = other2.get_vec();
+  Word* dst = Words(this);
+  const Word* src1 = Words(other1);
+  const Word* src2 = Words(other2);
+  ForEachBlock(bitvec_.size(), [&](size_t begin, size_t end) {
+    AndWords(dst + begin, src1 + begin, src2 + begin, end - begin);
+  });
+}
 
-  katana::do_all(
-      katana::iterate(size_t{0}, bitvec_.size()),
-      [&](size_t i) { bitvec_[i] = other_bitvec1[i] & other_bitvec2[i]; },
-      katana::no_stats());
+void
+katana::DynamicBitset::bitwise_and_not(const DynamicBitset& other) {
+  KATANA_LOG_DEBUG_ASSERT(size() == other.size());
+  Word* dst = Words(this);
+  const Word* src = Words(other);
+  ForEachBlock(bitvec_.size(), [&](size_t begin, size_t end) {
+    AndNotWords(dst + begin, src + begin, end - begin);
+  });
+}
+
+void
+katana::DynamicBitset::bitwise_and_not(
+    const DynamicBitset& other1, const DynamicBitset& other2) {
+  KATANA_LOG_DEBUG_ASSERT(size() == other1.size());
+  KATANA_LOG_DEBUG_ASSERT(size() == other2.size());
+  Word* dst = Words(this);
+  const Word* src1 = Words(other1);
+  const Word* src2 = Words(other2);
+  ForEachBlock(bitvec_.size(), [&](size_t begin, size_t end) {
+    AndNotWords(dst + begin, src1 + begin, src2 + begin, end - begin);
+  });
 }
 
 void
 katana::DynamicBitset::bitwise_xor(const DynamicBitset& other) {
   KATANA_LOG_DEBUG_ASSERT(size() == other.size());
-  const auto& other_bitvec = other.get_vec();
-  katana::do_all(
-      katana::iterate(size_t{0}, bitvec_.size()),
-      [&](size_t i) { bitvec_[i] ^= other_bitvec[i]; }, katana::no_stats());
+  Word* dst = Words(this);
+  const Word* src = Words(other);
+  ForEachBlock(bitvec_.size(), [&](size_t begin, size_t end) {
+    XorWords(dst + begin, src + begin, end - begin);
+  });
 }
 
 void
@@ -80,90 +332,23 @@ katana::DynamicBitset::bitwise_xor(
     const DynamicBitset& other1, const DynamicBitset& other2) {
   KATANA_LOG_DEBUG_ASSERT(size() == other1.size());
   KATANA_LOG_DEBUG_ASSERT(size() == other2.size());
-  const auto& other_bitvec1 = other1.get_vec();
-  const auto& other_bitvec2 = other2.get_vec();
-
-  katana::do_all(
-      katana::iterate(size_t{0}, bitvec_.size()),
-      [&](size_t i) { bitvec_[i] = other_bitvec1[i] ^ other_bitvec2[i]; },
-      katana::no_stats());
+  Word* dst = Words(this);
+  const Word* src1 = Words(other1);
+  const Word* src2 = Words(other2);
+  ForEachBlock(bitvec_.size(), [&](size_t begin, size_t end) {
+    XorWords(dst + begin, src1 + begin, src2 + begin, end - begin);
+  });
 }
 
 size_t
 katana::DynamicBitset::count() const {
   katana::GAccumulator<size_t> ret;
-  katana::do_all(
-      katana::iterate(bitvec_.begin(), bitvec_.end()),
-      [&](uint64_t n) {
-#ifdef __GNUC__
-        ret += __builtin_popcountll(n);
-#else
-        n = n - ((n >> 1) & 0x5555555555555555UL);
-        n = (n & 0x3333333333333333UL) + ((n >> 2) & 0x3333333333333333UL);
-        ret += (((n + (n >> 4)) & 0xF0F0F0F0F0F0F0FUL) * 0x101010101010101UL) >>
-               56;
-#endif
-      },
-      katana::no_stats());
+  ForEachBlock(bitvec_.size(), [&](size_t begin, size_t end) {
+    ret += CountRange(*this, begin, end);
+  });
   return ret.reduce();
 }
 
-namespace {
-template <typename Integer>
-void
-ComputeOffsets(
-    const katana::DynamicBitset& bitset, std::vector<Integer>* offsets) {
-  // TODO uint32_t is somewhat dangerous; change in the future
-  uint32_t activeThreads = katana::getActiveThreads();
-  std::vector<Integer> tPrefixBitCounts(activeThreads);
-
-  // count how many bits are set on each thread
-  katana::on_each([&](unsigned tid, unsigned nthreads) {
-    auto [start, end] =
-        katana::block_range(size_t{0}, bitset.size(), tid, nthreads);
-
-    Integer count = 0;
-    for (Integer i = start; i < end; ++i) {
-      if (bitset.test(i)) {
-        ++count;
-      }
-    }
-
-    tPrefixBitCounts[tid] = count;
-  });
-
-  // calculate prefix sum of bits per thread
-  for (uint32_t i = 1; i < activeThreads; ++i) {
-    tPrefixBitCounts[i] += tPrefixBitCounts[i - 1];
-  }
-
-  // total num of set bits
-  Integer bitsetCount = tPrefixBitCounts[activeThreads - 1];
-
-  // calculate the indices of the set bits and save them to the offset
-  // vector
-  if (bitsetCount > 0) {
-    size_t cur_size = offsets->size();
-    offsets->resize(cur_size + bitsetCount);
-    katana::on_each([&](unsigned tid, unsigned nthreads) {
-      auto [start, end] =
-          katana::block_range(size_t{0}, bitset.size(), tid, nthreads);
-      Integer index = cur_size;
-      if (tid != 0) {
-        index += tPrefixBitCounts[tid - 1];
-      }
-
-      for (Integer i = start; i < end; ++i) {
-        if (bitset.test(i)) {
-          offsets->at(index) = i;
-          ++index;
-        }
-      }
-    });
-  }
-}
-}  //namespace
-
 template <>
 std::vector<uint32_t>
 katana::DynamicBitset::GetOffsets<uint32_t>() const {
@@ -0,0 +1,147 @@
+#include "katana/EdgeTiling2D.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "katana/ParallelSTL.h"
+
+namespace {
+
+/// Grids with more tiles are almost all empty tiles and their counts alone
+/// would not fit in memory
+constexpr uint64_t kMaxTiles = uint64_t{1} << 26;
+
+/// The position of (x, y) on the Hilbert curve over an n x n grid, n a
+/// power of 2
+uint64_t
+HilbertIndex(uint64_t n, uint64_t x, uint64_t y) {
+  uint64_t d = 0;
+  for (uint64_t s = n / 2; s > 0; s /= 2) {
+    uint64_t rx = (x & s) > 0;
+    uint64_t ry = (y & s) > 0;
+    d += s * s * ((3 * rx) ^ ry);
+    if (ry == 0) {
+      if (rx == 1) {
+        x = n - 1 - x;
+        y = n - 1 - y;
+      }
+      std::swap(x, y);
+    }
+  }
+  return d;
+}
+
+}  // namespace
+
+size_t
+katana::EdgeTiling2D::L2CacheBytes() {
+  long size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+  if (size > 0) {
+    return size;
+  }
+  return 1UL << 20;
+}
+
+katana::Result<katana::EdgeTiling2D>
+katana::EdgeTiling2D::Make(
+    const GraphTopology& topology, const Options& opts) {
+  size_t cache_bytes = opts.cache_bytes ? opts.cache_bytes : L2CacheBytes();
+  // Half the cache each for the state of sources and of destinations
+  uint64_t src_nodes = std::max<uint64_t>(
+      1, cache_bytes / 2 / std::max<size_t>(1, opts.bytes_per_source));
+  uint64_t dest_nodes = std::max<uint64_t>(
+      1, cache_bytes / 2 / std::max<size_t>(1, opts.bytes_per_dest));
+  return Make(topology, src_nodes, dest_nodes);
+}
+
+katana::Result<katana::EdgeTiling2D>
+katana::EdgeTiling2D::Make(
+    const GraphTopology& topology, uint64_t src_nodes, uint64_t dest_nodes) {
+  if (src_nodes == 0 || dest_nodes == 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "tiles must have nodes, not {} x {}",
+        src_nodes, dest_nodes);
+  }
+  uint64_t num_nodes = topology.num_nodes();
+  uint64_t num_rows = (num_nodes + src_nodes - 1) / src_nodes;
+  uint64_t num_cols = (num_nodes + dest_nodes - 1) / dest_nodes;
+  if (num_rows != 0 && num_cols > kMaxTiles / num_rows) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "{} x {} tiles of {} x {} nodes are too many", num_rows, num_cols,
+        src_nodes, dest_nodes);
+  }
+
+  EdgeTiling2D tiling;
+  tiling.src_nodes_ = src_nodes;
+  tiling.dest_nodes_ = dest_nodes;
+
+  // A row of tiles is only written by the thread that tiles its sources
+  NUMAArray<uint64_t> counts;
+  counts.allocateInterleaved(num_rows * num_cols);
+  ParallelSTL::fill(counts.begin(), counts.end(), uint64_t{0});
+  auto for_each_row_edge = [&](const auto& fn) {
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_rows),
+        [&](uint64_t row) {
+          Node end = std::min(num_nodes, (row + 1) * src_nodes);
+          for (Node src = row * src_nodes; src < end; ++src) {
+            for (auto e : topology.edges(src)) {
+              Node dest = topology.edge_dest(e);
+              fn(row * num_cols + dest / dest_nodes, src, dest);
+            }
+          }
+        },
+        katana::steal(), katana::no_stats(),
+        katana::loopname("EdgeTiling2D"));
+  };
+  for_each_row_edge([&](uint64_t tile, Node, Node) { ++counts[tile]; });
+
+  // Empty tiles are left out
+  uint64_t side = 1;
+  while (side < std::max(num_rows, num_cols)) {
+    side *= 2;
+  }
+  std::vector<std::pair<uint64_t, uint64_t>> order;
+  for (uint64_t tile = 0; tile < counts.size(); ++tile) {
+    if (counts[tile] != 0) {
+      order.emplace_back(
+          HilbertIndex(side, tile / num_cols, tile % num_cols), tile);
+    }
+  }
+  ParallelSTL::sort(order.begin(), order.end());
+
+  // Lay the tiles out in Hilbert order and turn counts into the position of
+  // the next edge of each tile
+  tiling.tiles_.allocateInterleaved(order.size());
+  uint64_t edge_begin = 0;
+  for (uint64_t i = 0; i < order.size(); ++i) {
+    uint64_t id = order[i].second;
+    uint64_t row = id / num_cols;
+    uint64_t col = id % num_cols;
+    uint64_t edge_end = edge_begin + counts[id];
+    tiling.tiles_[i] = Tile{
+        edge_begin,
+        edge_end,
+        static_cast<Node>(row * src_nodes),
+        static_cast<Node>(std::min(num_nodes, (row + 1) * src_nodes)),
+        static_cast<Node>(col * dest_nodes),
+        static_cast<Node>(std::min(num_nodes, (col + 1) * dest_nodes)),
+    };
+    counts[id] = edge_begin;
+    edge_begin = edge_end;
+  }
+  KATANA_LOG_DEBUG_ASSERT(edge_begin == topology.num_edges());
+
+  tiling.srcs_.allocateInterleaved(topology.num_edges());
+  tiling.dests_.allocateInterleaved(topology.num_edges());
+  for_each_row_edge([&](uint64_t tile, Node src, Node dest) {
+    uint64_t e = counts[tile]++;
+    tiling.srcs_[e] = src;
+    tiling.dests_[e] = dest;
+  });
+  return MakeResult(std::move(tiling));
+}
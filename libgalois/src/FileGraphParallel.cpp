@@ -17,15 +17,165 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include <algorithm>
 #include <condition_variable>
+#include <cstring>
+#include <limits>
 #include <mutex>
+#include <utility>
+#include <vector>
 
 #include "katana/FileGraph.h"
 #include "katana/HWTopo.h"
+#include "katana/Loops.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
 #include "katana/ThreadPool.h"
 
 namespace katana {
 
+namespace {
+
+/// Calls fn(new_src, new_dst) for each edge that edge (src, dst) of a graph
+/// adds to the graph derived from it by kind, in the order a serial loop adds
+/// them
+template <typename F>
+void
+ForDerivedEdges(
+    FileGraph::Derivation kind, const uint64_t* perm, uint64_t src,
+    uint64_t dst, const F& fn) {
+  switch (kind) {
+  case FileGraph::Derivation::kSymmetric:
+    fn(src, dst);
+    if (src != dst) {
+      fn(dst, src);
+    }
+    break;
+  case FileGraph::Derivation::kTranspose:
+    fn(dst, src);
+    break;
+  case FileGraph::Derivation::kPermute:
+    fn(perm[src], perm[dst]);
+    break;
+  }
+}
+
+/// Computes the out indexes, destinations and edge data of the graph derived
+/// from g by kind.
+///
+/// Edges are placed in three parallel passes over the edges of g: count the
+/// degrees of the new nodes, which a prefix sum turns into out indexes; put
+/// each new edge at the next free position of its source, with the id of the
+/// edge of g it comes from; and sort the edges of each node by those ids.
+/// Each edge of g adds at most one edge to a node, and a serial loop adds
+/// edges in the order of their ids, so sorting restores the serial order.
+template <typename Dst>
+void
+DeriveEdges(
+    FileGraph& g, FileGraph::Derivation kind, const uint64_t* perm,
+    size_t sizeof_edge_data, NUMAArray<uint64_t>* out_idx,
+    NUMAArray<Dst>* outs, NUMAArray<char>* edge_data) {
+  uint64_t num_nodes = g.size();
+  out_idx->allocateBlocked(num_nodes);
+  ParallelSTL::fill(out_idx->begin(), out_idx->end(), 0);
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t src) {
+        for (auto e : g.edges(src)) {
+          ForDerivedEdges(
+              kind, perm, src, g.getEdgeDst(e), [&](uint64_t n, uint64_t) {
+                __sync_fetch_and_add(&(*out_idx)[n], 1);
+              });
+        }
+      },
+      katana::steal(), katana::no_stats(),
+      katana::loopname("FileGraphDeriveDegrees"));
+
+  ParallelSTL::partial_sum(out_idx->begin(), out_idx->end(), out_idx->begin());
+  uint64_t num_edges = num_nodes == 0 ? 0 : (*out_idx)[num_nodes - 1];
+  auto begin = [&](uint64_t n) { return n == 0 ? 0 : (*out_idx)[n - 1]; };
+
+  NUMAArray<uint64_t> next;
+  next.allocateBlocked(num_nodes);
+  ParallelSTL::fill(next.begin(), next.end(), 0);
+  NUMAArray<uint64_t> ids;
+  ids.allocateBlocked(num_edges);
+  outs->allocateBlocked(num_edges);
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t src) {
+        for (auto e : g.edges(src)) {
+          ForDerivedEdges(
+              kind, perm, src, g.getEdgeDst(e), [&](uint64_t n, uint64_t dst) {
+                uint64_t idx = begin(n) + __sync_fetch_and_add(&next[n], 1);
+                ids[idx] = *e;
+                (*outs)[idx] = dst;
+              });
+        }
+      },
+      katana::steal(), katana::no_stats(),
+      katana::loopname("FileGraphDerivePlace"));
+
+  edge_data->allocateBlocked(num_edges * sizeof_edge_data);
+  const char* in_data =
+      sizeof_edge_data ? g.edge_data_begin<char>() : nullptr;
+  katana::PerThreadStorage<std::vector<std::pair<uint64_t, Dst>>> buffers;
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t first = begin(n);
+        uint64_t last = (*out_idx)[n];
+        if (!std::is_sorted(ids.begin() + first, ids.begin() + last)) {
+          auto& buffer = *buffers.getLocal();
+          buffer.clear();
+          for (uint64_t i = first; i < last; ++i) {
+            buffer.emplace_back(ids[i], (*outs)[i]);
+          }
+          std::sort(buffer.begin(), buffer.end());
+          for (uint64_t i = first; i < last; ++i) {
+            std::tie(ids[i], (*outs)[i]) = buffer[i - first];
+          }
+        }
+        if (sizeof_edge_data) {
+          for (uint64_t i = first; i < last; ++i) {
+            std::memcpy(
+                &(*edge_data)[i * sizeof_edge_data],
+                in_data + ids[i] * sizeof_edge_data, sizeof_edge_data);
+          }
+        }
+      },
+      katana::steal(), katana::no_stats(),
+      katana::loopname("FileGraphDeriveSort"));
+}
+
+}  // namespace
+
+void
+FileGraph::fromGraphParallel(
+    FileGraph& g, Derivation kind, const uint64_t* perm,
+    size_t sizeofEdgeData) {
+  NUMAArray<uint64_t> out_idx;
+  NUMAArray<char> edge_data;
+  if (g.size() <= std::numeric_limits<uint32_t>::max()) {
+    NUMAArray<uint32_t> outs;
+    DeriveEdges(g, kind, perm, sizeofEdgeData, &out_idx, &outs, &edge_data);
+    fromArrays(
+        out_idx.data(), out_idx.size(), outs.data(), outs.size(),
+        sizeofEdgeData ? edge_data.data() : nullptr, sizeofEdgeData, 0, 0,
+        false, 1);
+  } else {
+    NUMAArray<uint64_t> outs;
+    DeriveEdges(g, kind, perm, sizeofEdgeData, &out_idx, &outs, &edge_data);
+    fromArrays(
+        out_idx.data(), out_idx.size(), outs.data(), outs.size(),
+        sizeofEdgeData ? edge_data.data() : nullptr, sizeofEdgeData, 0, 0,
+        false, 2);
+  }
+}
+
 void
 FileGraph::fromFileInterleaved(
     const std::string& filename, size_t sizeofEdgeData) {
@@ -0,0 +1,392 @@
+#include "katana/GraphGenerators.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/EntityTypeManager.h"
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+
+/// Edges, nodes or property values generated with one random stream
+constexpr uint64_t kItemsPerBlock = uint64_t{1} << 16;
+
+/// Node ids are 32 bits
+constexpr uint64_t kMaxNodes = uint64_t{1} << 32;
+
+// Disjoint ranges of streams for the different uses of one seed
+constexpr uint64_t kEdgeStreams = 0;
+constexpr uint64_t kWeightStreams = uint64_t{1} << 60;
+constexpr uint64_t kNodeTypeStreams = uint64_t{2} << 60;
+constexpr uint64_t kEdgeTypeStreams = uint64_t{3} << 60;
+
+/// SplitMix64 random numbers. Each block of items has a stream of its own,
+/// so what is generated does not depend on which thread runs the block.
+class BlockRandom {
+public:
+  BlockRandom(uint64_t seed, uint64_t stream)
+      : state_(Mix(seed ^ Mix(stream + kGamma))) {}
+
+  static uint64_t Mix(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+  }
+
+  uint64_t Next() {
+    state_ += kGamma;
+    return Mix(state_);
+  }
+
+  /// Uniform in [0, 1)
+  double NextDouble() { return static_cast<double>(Next() >> 11) * 0x1.0p-53; }
+
+  /// Uniform in [0, n)
+  uint64_t NextBelow(uint64_t n) {
+    return static_cast<uint64_t>(
+        (static_cast<unsigned __int128>(Next()) * n) >> 64);
+  }
+
+private:
+  static constexpr uint64_t kGamma = 0x9e3779b97f4a7c15ULL;
+
+  uint64_t state_;
+};
+
+/// Call fn(random, i) for i in [0, num_items) in parallel, with the random
+/// stream of the block of i
+template <typename Fn>
+void
+ForEachInBlocks(
+    uint64_t num_items, uint64_t seed, uint64_t first_stream, const Fn& fn) {
+  uint64_t num_blocks = (num_items + kItemsPerBlock - 1) / kItemsPerBlock;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_blocks),
+      [&](uint64_t block) {
+        BlockRandom random(seed, first_stream + block);
+        uint64_t end = std::min(num_items, (block + 1) * kItemsPerBlock);
+        for (uint64_t i = block * kItemsPerBlock; i < end; ++i) {
+          fn(&random, i);
+        }
+      },
+      katana::steal(), katana::no_stats());
+}
+
+/// The topology of num_nodes nodes with the num_edges edges returned by
+/// gen(random) as (source, destination) pairs, built with a counting sort
+/// that generates the edges twice
+template <typename Gen>
+katana::GraphTopology
+BuildTopology(
+    uint64_t num_nodes, uint64_t num_edges, uint64_t seed, const Gen& gen) {
+  katana::GraphTopology::AdjIndexVec adj_indices;
+  adj_indices.allocateInterleaved(num_nodes);
+  katana::ParallelSTL::fill(adj_indices.begin(), adj_indices.end(), Edge{0});
+  ForEachInBlocks(
+      num_edges, seed, kEdgeStreams, [&](BlockRandom* random, uint64_t) {
+        Node src = gen(random).first;
+        __sync_fetch_and_add(&adj_indices[src], 1);
+      });
+  katana::ParallelSTL::partial_sum(
+      adj_indices.begin(), adj_indices.end(), adj_indices.begin());
+
+  katana::NUMAArray<Edge> cursors;
+  cursors.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { cursors[n] = n == 0 ? 0 : adj_indices[n - 1]; },
+      katana::no_stats());
+
+  katana::GraphTopology::EdgeDestVec dests;
+  dests.allocateInterleaved(num_edges);
+  ForEachInBlocks(
+      num_edges, seed, kEdgeStreams, [&](BlockRandom* random, uint64_t) {
+        auto [src, dest] = gen(random);
+        dests[__sync_fetch_and_add(&cursors[src], 1)] = dest;
+      });
+
+  // Threads placed the edges of a node in any order
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        Edge begin = n == 0 ? 0 : adj_indices[n - 1];
+        std::sort(dests.begin() + begin, dests.begin() + adj_indices[n]);
+      },
+      katana::steal(), katana::no_stats());
+
+  return katana::GraphTopology(std::move(adj_indices), std::move(dests));
+}
+
+katana::Result<void>
+CheckNumNodes(uint64_t num_nodes) {
+  if (num_nodes == 0 || num_nodes > kMaxNodes) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "number of nodes must be in [1, 2^32], not {}", num_nodes);
+  }
+  return katana::ResultSuccess();
+}
+
+/// A bijection on [0, 2^bits) chosen by seed
+class Scrambler {
+public:
+  Scrambler(uint32_t bits, uint64_t seed)
+      : bits_(bits),
+        mask_(bits == 64 ? ~uint64_t{0} : (uint64_t{1} << bits) - 1),
+        mult1_(BlockRandom::Mix(seed) | 1),
+        mult2_(BlockRandom::Mix(seed + 1) | 1),
+        add_(BlockRandom::Mix(seed + 2)) {}
+
+  uint64_t operator()(uint64_t x) const {
+    x = (x * mult1_ + add_) & mask_;
+    if (bits_ > 1) {
+      x ^= x >> (bits_ / 2);
+    }
+    return (x * mult2_) & mask_;
+  }
+
+private:
+  uint32_t bits_;
+  uint64_t mask_;
+  uint64_t mult1_;
+  uint64_t mult2_;
+  uint64_t add_;
+};
+
+/// Types named prefix0, prefix1, ... in manager
+katana::Result<std::vector<katana::EntityTypeID>>
+AddTypes(
+    katana::EntityTypeManager* manager, const std::string& prefix,
+    uint32_t num_types) {
+  std::vector<katana::EntityTypeID> types;
+  for (uint32_t i = 0; i < num_types; ++i) {
+    types.emplace_back(KATANA_CHECKED(
+        manager->GetOrAddEntityTypeID(prefix + std::to_string(i))));
+  }
+  return types;
+}
+
+/// size random picks from types, or unknown types if there are none
+katana::PropertyGraph::EntityTypeIDArray
+RandomTypes(
+    uint64_t size, const std::vector<katana::EntityTypeID>& types,
+    uint64_t seed, uint64_t first_stream) {
+  katana::PropertyGraph::EntityTypeIDArray ids;
+  ids.allocateInterleaved(size);
+  ForEachInBlocks(
+      size, seed, first_stream, [&](BlockRandom* random, uint64_t i) {
+        ids[i] = types.empty() ? katana::kUnknownEntityType
+                               : types[random->NextBelow(types.size())];
+      });
+  return ids;
+}
+
+}  // namespace
+
+katana::Result<katana::GraphTopology>
+katana::GenerateRmatTopology(const RmatOptions& opts) {
+  if (opts.scale > 32) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "scale must be at most 32, not {}",
+        opts.scale);
+  }
+  if (opts.a < 0 || opts.b < 0 || opts.c < 0 ||
+      opts.a + opts.b + opts.c > 1) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "R-MAT probabilities must be non-negative and sum to at most 1");
+  }
+  if (opts.edge_factor > std::numeric_limits<uint64_t>::max() >> opts.scale) {
+    return KATANA_ERROR(ErrorCode::InvalidArgument, "too many edges");
+  }
+
+  uint64_t num_nodes = uint64_t{1} << opts.scale;
+  uint64_t num_edges = opts.edge_factor << opts.scale;
+  double ab = opts.a + opts.b;
+  double abc = ab + opts.c;
+  Scrambler scramble(opts.scale, opts.seed);
+  return BuildTopology(
+      num_nodes, num_edges, opts.seed, [&](BlockRandom* random) {
+        uint64_t src = 0;
+        uint64_t dest = 0;
+        for (uint32_t level = 0; level < opts.scale; ++level) {
+          double r = random->NextDouble();
+          src <<= 1;
+          dest <<= 1;
+          if (r >= abc) {
+            src |= 1;
+            dest |= 1;
+          } else if (r >= ab) {
+            src |= 1;
+          } else if (r >= opts.a) {
+            dest |= 1;
+          }
+        }
+        if (opts.scramble_ids) {
+          src = scramble(src);
+          dest = scramble(dest);
+        }
+        return std::make_pair(Node(src), Node(dest));
+      });
+}
+
+katana::Result<katana::GraphTopology>
+katana::GenerateErdosRenyiTopology(
+    uint64_t num_nodes, uint64_t num_edges, uint64_t seed) {
+  KATANA_CHECKED(CheckNumNodes(num_nodes));
+  return BuildTopology(num_nodes, num_edges, seed, [&](BlockRandom* random) {
+    Node src = random->NextBelow(num_nodes);
+    Node dest = random->NextBelow(num_nodes);
+    return std::make_pair(src, dest);
+  });
+}
+
+katana::Result<katana::GraphTopology>
+katana::GenerateChungLuTopology(
+    uint64_t num_nodes, uint64_t num_edges, double exponent, uint64_t seed) {
+  KATANA_CHECKED(CheckNumNodes(num_nodes));
+  if (!(exponent > 2)) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "power-law exponent must be greater than 2, not {}", exponent);
+  }
+
+  // The expected degree of node i is proportional to (i + 1)^-beta; an
+  // endpoint is drawn by inverting the continuous approximation of their
+  // cumulative sum, (x / n)^(1 - beta)
+  double beta = 1 / (exponent - 1);
+  double inverse = 1 / (1 - beta);
+  auto endpoint = [&](BlockRandom* random) {
+    double x = num_nodes * std::pow(random->NextDouble(), inverse);
+    return static_cast<Node>(
+        std::min(static_cast<uint64_t>(x), num_nodes - 1));
+  };
+  return BuildTopology(num_nodes, num_edges, seed, [&](BlockRandom* random) {
+    Node src = endpoint(random);
+    Node dest = endpoint(random);
+    return std::make_pair(src, dest);
+  });
+}
+
+katana::Result<katana::GraphTopology>
+katana::GenerateGridTopology(uint64_t x, uint64_t y, uint64_t z) {
+  if (x == 0 || y == 0 || z == 0 || x > kMaxNodes / y ||
+      x * y > kMaxNodes / z) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "grid dimensions must be positive with at most 2^32 nodes");
+  }
+  uint64_t num_nodes = x * y * z;
+  uint64_t plane = x * y;
+
+  // The neighbors of n in increasing order of id
+  auto for_each_neighbor = [&](uint64_t n, auto fn) {
+    uint64_t i = n % x;
+    uint64_t j = n / x % y;
+    uint64_t k = n / plane;
+    if (k > 0) {
+      fn(n - plane);
+    }
+    if (j > 0) {
+      fn(n - x);
+    }
+    if (i > 0) {
+      fn(n - 1);
+    }
+    if (i + 1 < x) {
+      fn(n + 1);
+    }
+    if (j + 1 < y) {
+      fn(n + x);
+    }
+    if (k + 1 < z) {
+      fn(n + plane);
+    }
+  };
+
+  GraphTopology::AdjIndexVec adj_indices;
+  adj_indices.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        Edge degree = 0;
+        for_each_neighbor(n, [&](uint64_t) { ++degree; });
+        adj_indices[n] = degree;
+      },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      adj_indices.begin(), adj_indices.end(), adj_indices.begin());
+
+  GraphTopology::EdgeDestVec dests;
+  dests.allocateInterleaved(adj_indices[num_nodes - 1]);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        Edge e = n == 0 ? 0 : adj_indices[n - 1];
+        for_each_neighbor(n, [&](uint64_t m) { dests[e++] = m; });
+      },
+      katana::no_stats());
+
+  return GraphTopology(std::move(adj_indices), std::move(dests));
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::MakeGeneratedGraph(
+    GraphTopology&& topology, const GeneratedPropertiesOptions& opts) {
+  uint64_t num_nodes = topology.num_nodes();
+  uint64_t num_edges = topology.num_edges();
+
+  std::unique_ptr<PropertyGraph> pg;
+  if (opts.num_node_types > 0 || opts.num_edge_types > 0) {
+    constexpr uint32_t kMaxTypes = kInvalidEntityType - 1;
+    if (opts.num_node_types >= kMaxTypes || opts.num_edge_types >= kMaxTypes) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "at most {} types", kMaxTypes - 1);
+    }
+    EntityTypeManager node_manager;
+    EntityTypeManager edge_manager;
+    auto node_types = KATANA_CHECKED(
+        AddTypes(&node_manager, "node_type_", opts.num_node_types));
+    auto edge_types = KATANA_CHECKED(
+        AddTypes(&edge_manager, "edge_type_", opts.num_edge_types));
+    pg = KATANA_CHECKED(PropertyGraph::Make(
+        std::move(topology),
+        RandomTypes(num_nodes, node_types, opts.seed, kNodeTypeStreams),
+        RandomTypes(num_edges, edge_types, opts.seed, kEdgeTypeStreams),
+        std::move(node_manager), std::move(edge_manager)));
+  } else {
+    pg = KATANA_CHECKED(PropertyGraph::Make(std::move(topology)));
+  }
+
+  if (!opts.weight_property.empty()) {
+    if (opts.max_weight == 0) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "maximum weight must be positive");
+    }
+    std::shared_ptr<arrow::Buffer> buffer =
+        KATANA_CHECKED(arrow::AllocateBuffer(num_edges * sizeof(uint32_t)));
+    auto* weights = reinterpret_cast<uint32_t*>(buffer->mutable_data());
+    ForEachInBlocks(
+        num_edges, opts.seed, kWeightStreams,
+        [&](BlockRandom* random, uint64_t e) {
+          weights[e] = 1 + random->NextBelow(opts.max_weight);
+        });
+    auto array = std::make_shared<arrow::UInt32Array>(num_edges, buffer);
+    KATANA_CHECKED(pg->AddEdgeProperties(arrow::Table::Make(
+        arrow::schema({arrow::field(opts.weight_property, arrow::uint32())}),
+        {array})));
+  }
+
+  return pg;
+}
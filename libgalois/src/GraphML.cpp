@@ -11,6 +11,7 @@
 #include <optional>
 #include <random>
 #include <sstream>
+#include <string_view>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -277,6 +278,19 @@ ResolveValue(const std::string& val, ImportDataType type, bool is_list) {
 /* Functions for parsing GraphML files */
 /***************************************/
 
+// A node or edge parsed from a GraphML file, before it is added to a builder
+struct Element {
+  bool is_node;
+  // the id of a node
+  std::string id;
+  // the source and target of an edge
+  std::string source;
+  std::string target;
+  // the labels of a node, or the type of an edge
+  std::vector<std::string> labels;
+  std::vector<std::pair<std::string, std::string>> properties;
+};
+
 /*
  * reader should be pointing at the data element before calling
  *
@@ -334,15 +348,16 @@ ProcessData(xmlTextReaderPtr reader) {
  *
  * parses the node from a GraphML file into readable form
  */
-void
-ProcessNode(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
+Element
+ProcessNode(xmlTextReaderPtr reader) {
   auto minimum_depth = xmlTextReaderDepth(reader);
 
   int ret = xmlTextReaderMoveToNextAttribute(reader);
   xmlChar *name, *value;
 
-  std::string id;
-  std::vector<std::string> labels;
+  Element node{true};
+  std::string& id = node.id;
+  std::vector<std::string>& labels = node.labels;
 
   bool extractedLabels = false;  // neo4j includes these twice so only parse 1
 
@@ -376,11 +391,6 @@ ProcessNode(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
     ret = xmlTextReaderMoveToNextAttribute(reader);
   }
 
-  bool validNode = !id.empty();
-  if (validNode) {
-    builder->StartNode(id);
-  }
-
   // parse "data" xml nodes for properties
   ret = xmlTextReaderRead(reader);
   // will terminate when </node> reached or an improper read
@@ -408,18 +418,7 @@ ProcessNode(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
               extractedLabels = true;
             }
           } else if (property.first != std::string("IGNORE")) {
-            if (validNode) {
-              const std::string& value = property.second;
-              builder->AddValue(
-                  property.first,
-                  [&]() {
-                    return PropertyKey{
-                        property.first, ImportDataType::kString, false};
-                  },
-                  [&value](ImportDataType type, bool is_list) {
-                    return ResolveValue(value, type, is_list);
-                  });
-            }
+            node.properties.emplace_back(std::move(property));
           }
         }
       } else {
@@ -433,15 +432,7 @@ ProcessNode(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
     ret = xmlTextReaderRead(reader);
   }
 
-  // add labels if they exists
-  if (validNode) {
-    if (!labels.empty()) {
-      for (std::string label : labels) {
-        builder->AddLabel(label);
-      }
-    }
-    builder->FinishNode();
-  }
+  return node;
 }
 
 /*
@@ -449,15 +440,16 @@ ProcessNode(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
  *
  * parses the edge from a GraphML file into readable form
  */
-void
-ProcessEdge(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
+Element
+ProcessEdge(xmlTextReaderPtr reader) {
   auto minimum_depth = xmlTextReaderDepth(reader);
 
   int ret = xmlTextReaderMoveToNextAttribute(reader);
   xmlChar *name, *value;
 
-  std::string source;
-  std::string target;
+  Element edge{false};
+  std::string& source = edge.source;
+  std::string& target = edge.target;
   std::string type;
   bool extracted_type = false;  // neo4j includes these twice so only parse 1
 
@@ -489,11 +481,6 @@ ProcessEdge(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
     ret = xmlTextReaderMoveToNextAttribute(reader);
   }
 
-  bool valid_edge = !source.empty() && !target.empty();
-  if (valid_edge) {
-    valid_edge = builder->StartEdge(source, target);
-  }
-
   // parse "data" xml edges for properties
   ret = xmlTextReaderRead(reader);
   // will terminate when </edge> reached or an improper read
@@ -516,18 +503,7 @@ ProcessEdge(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
               extracted_type = true;
             }
           } else if (property.first != std::string("IGNORE")) {
-            if (valid_edge) {
-              const std::string& value = property.second;
-              builder->AddValue(
-                  property.first,
-                  [&]() {
-                    return PropertyKey{
-                        property.first, ImportDataType::kString, false};
-                  },
-                  [&value](ImportDataType type, bool is_list) {
-                    return ResolveValue(value, type, is_list);
-                  });
-            }
+            edge.properties.emplace_back(std::move(property));
           }
         }
       } else {
@@ -541,23 +517,58 @@ ProcessEdge(xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder) {
   }
 
   // add type if it exists
-  if (valid_edge) {
-    if (type.length() > 0) {
-      builder->AddLabel(type);
+  if (type.length() > 0) {
+    edge.labels.emplace_back(std::move(type));
+  }
+  return edge;
+}
+
+void
+AddProperties(const Element& element, katana::PropertyGraphBuilder* builder) {
+  for (const auto& [key, value] : element.properties) {
+    builder->AddValue(
+        key,
+        [&key = key]() {
+          return PropertyKey{key, ImportDataType::kString, false};
+        },
+        [&value = value](ImportDataType type, bool is_list) {
+          return ResolveValue(value, type, is_list);
+        });
+  }
+  for (const std::string& label : element.labels) {
+    builder->AddLabel(label);
+  }
+}
+
+// add a parsed node or edge to builder, if it is valid
+void
+AddElement(const Element& element, katana::PropertyGraphBuilder* builder) {
+  if (element.is_node) {
+    if (element.id.empty()) {
+      return;
+    }
+    builder->StartNode(element.id);
+    AddProperties(element, builder);
+    builder->FinishNode();
+  } else {
+    if (element.source.empty() || element.target.empty() ||
+        !builder->StartEdge(element.source, element.target)) {
+      return;
     }
+    AddProperties(element, builder);
     builder->FinishEdge();
   }
 }
 
 /*
- * reader should be pointing at the graph element before calling
+ * reader should be pointing at the graph element, or the element wrapping a
+ * chunk of it, before calling
  *
- * parses the graph structure from a GraphML file into Galois format
+ * parses the nodes and edges in the graph structure, passing each to add
  */
-void
-ProcessGraph(
-    xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder,
-    bool verbose) {
+template <typename AddFn>
+int
+ProcessElements(xmlTextReaderPtr reader, bool verbose, AddFn add) {
   auto minimum_depth = xmlTextReaderDepth(reader);
   int ret = xmlTextReaderRead(reader);
 
@@ -574,7 +585,7 @@ ProcessGraph(
     if (xmlTextReaderNodeType(reader) == 1) {
       // if elt is a "node" xml node read it in
       if (xmlStrEqual(name, BAD_CAST "node")) {
-        ProcessNode(reader, builder);
+        add(ProcessNode(reader));
       } else if (xmlStrEqual(name, BAD_CAST "edge")) {
         if (!finished_nodes) {
           finished_nodes = true;
@@ -583,7 +594,7 @@ ProcessGraph(
           }
         }
         // if elt is an "egde" xml node read it in
-        ProcessEdge(reader, builder);
+        add(ProcessEdge(reader));
       } else {
         KATANA_LOG_ERROR(
             "Found element: {}, which was ignored",
@@ -597,18 +608,243 @@ ProcessGraph(
   if (verbose) {
     std::cout << "Finished processing edges\n";
   }
+  return ret;
+}
+
+/*
+ * reader should be pointing at the graph element before calling
+ *
+ * parses the graph structure from a GraphML file into Galois format
+ */
+void
+ProcessGraph(
+    xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder,
+    bool verbose) {
+  ProcessElements(
+      reader, verbose, [&](Element&& e) { AddElement(e, builder); });
+}
+
+void
+AddKey(PropertyKey&& key, katana::PropertyGraphBuilder* builder) {
+  if (!key.id.empty() && key.id != std::string("label") &&
+      key.id != std::string("IGNORE")) {
+    if (key.for_node) {
+      builder->AddBuilder(std::move(key));
+    } else if (key.for_edge) {
+      builder->AddBuilder(std::move(key));
+    }
+  }
+}
+
+/*******************************************/
+/* Functions for parsing a GraphML file in */
+/* parallel                                */
+/*******************************************/
+
+// The graph element is split into pieces of about this many bytes, and the
+// file is read this many pieces per thread at a time
+constexpr size_t kPieceBytes = size_t{4} << 20;
+constexpr size_t kPiecesPerThread = 4;
+
+bool
+IsNameEnd(char c) {
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '>' ||
+         c == '/';
+}
+
+// \returns the offset of the first start tag of tag in buf at or after from,
+// or npos if there is none
+size_t
+FindStartTag(std::string_view buf, std::string_view tag, size_t from) {
+  for (size_t i = buf.find(tag, from); i != std::string_view::npos;
+       i = buf.find(tag, i + 1)) {
+    if (i + tag.size() < buf.size() && IsNameEnd(buf[i + tag.size()])) {
+      return i;
+    }
+  }
+  return std::string_view::npos;
+}
+
+// \returns the offset of the first node or edge start tag in buf at or after
+// from, or npos if there is none
+size_t
+FindElementStart(std::string_view buf, size_t from) {
+  return std::min(
+      FindStartTag(buf, "<node", from), FindStartTag(buf, "<edge", from));
+}
+
+katana::Result<std::string>
+ReadRange(std::ifstream* file, uint64_t begin, uint64_t end) {
+  std::string buf(end - begin, '\0');
+  file->seekg(begin);
+  if (!file->read(buf.data(), buf.size())) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "reading bytes {} to {}", begin,
+        end);
+  }
+  return buf;
+}
+
+// \returns the byte range of the contents of the graph element of file
+katana::Result<std::pair<uint64_t, uint64_t>>
+FindGraphBody(std::ifstream* file) {
+  file->seekg(0, std::ios::end);
+  const uint64_t size = file->tellg();
+
+  constexpr uint64_t kBlock = 1 << 20;
+  uint64_t begin = std::string_view::npos;
+  std::string head;
+  for (uint64_t read = 0; read < size && begin == std::string_view::npos;) {
+    uint64_t next = std::min(size, read + kBlock);
+    head += KATANA_CHECKED(ReadRange(file, read, next));
+    read = next;
+    size_t tag = FindStartTag(head, "<graph", 0);
+    if (tag != std::string_view::npos) {
+      size_t close = head.find('>', tag);
+      if (close != std::string_view::npos) {
+        begin = close + 1;
+      }
+    }
+  }
+  if (begin == std::string_view::npos) {
+    return KATANA_ERROR(katana::ErrorCode::InvalidArgument, "no graph element");
+  }
+
+  const uint64_t tail_begin = size - std::min(size - begin, kBlock);
+  std::string tail = KATANA_CHECKED(ReadRange(file, tail_begin, size));
+  size_t end = tail.rfind("</graph");
+  if (end == std::string::npos) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "no end of the graph element");
+  }
+  return std::make_pair(begin, tail_begin + end);
+}
+
+// parse a sequence of whole node and edge elements
+katana::Result<std::vector<Element>>
+ParsePiece(std::string_view piece) {
+  std::string doc = "<piece>";
+  doc += piece;
+  doc += "</piece>";
+  xmlTextReaderPtr reader =
+      xmlReaderForMemory(doc.data(), doc.size(), nullptr, nullptr, 0);
+  if (reader == NULL) {
+    return KATANA_ERROR(
+        katana::ErrorCode::OutOfMemory, "unable to create an xml reader");
+  }
+  std::vector<Element> elements;
+  int ret = xmlTextReaderRead(reader);
+  if (ret == 1) {
+    ret = ProcessElements(reader, false, [&](Element&& e) {
+      elements.emplace_back(std::move(e));
+    });
+  }
+  xmlFreeTextReader(reader);
+  if (ret < 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "incorrect xml format");
+  }
+  return elements;
+}
+
+// Split the graph element into pieces at node and edge element boundaries,
+// parse the pieces of each batch in parallel, and add their elements to the
+// builder in file order
+katana::Result<void>
+ProcessGraphParallel(
+    const std::string& infilename, katana::PropertyGraphBuilder* builder,
+    bool verbose) {
+  std::ifstream file(infilename, std::ios::binary);
+  if (!file) {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotFound, "Unable to open {}", infilename);
+  }
+  auto [pos, end] = KATANA_CHECKED(FindGraphBody(&file));
+
+  // libxml2 must be initialized before it is used by several threads
+  xmlInitParser();
+
+  const size_t num_pieces = kPiecesPerThread * katana::getActiveThreads();
+  size_t batch_bytes = num_pieces * kPieceBytes;
+  while (pos < end) {
+    std::string buf = KATANA_CHECKED(
+        ReadRange(&file, pos, std::min<uint64_t>(end, pos + batch_bytes)));
+    // leave the last element, which may be cut off, to the next batch
+    size_t usable = buf.size();
+    if (pos + buf.size() < end) {
+      size_t last = std::string_view::npos;
+      for (size_t i = FindElementStart(buf, 0); i != std::string_view::npos;
+           i = FindElementStart(buf, i + 1)) {
+        last = i;
+      }
+      if (last == std::string_view::npos || last == 0) {
+        // an element larger than the batch
+        batch_bytes *= 2;
+        continue;
+      }
+      usable = last;
+    }
+    std::string_view batch(buf.data(), usable);
+
+    std::vector<size_t> bounds{0};
+    for (size_t p = 1; p < num_pieces; ++p) {
+      size_t start =
+          FindElementStart(batch, std::max(bounds.back() + 1, p * kPieceBytes));
+      if (start == std::string_view::npos) {
+        break;
+      }
+      bounds.emplace_back(start);
+    }
+    bounds.emplace_back(usable);
+
+    std::vector<katana::Result<std::vector<Element>>> pieces(
+        bounds.size() - 1, std::vector<Element>());
+    katana::do_all(
+        katana::iterate(size_t{0}, pieces.size()),
+        [&](size_t p) {
+          pieces[p] =
+              ParsePiece(batch.substr(bounds[p], bounds[p + 1] - bounds[p]));
+        },
+        katana::steal(), katana::no_stats());
+    for (size_t p = 0; p < pieces.size(); ++p) {
+      std::vector<Element> elements = KATANA_CHECKED_CONTEXT(
+          std::move(pieces[p]), "parsing bytes {} to {} of {}",
+          pos + bounds[p], pos + bounds[p + 1], infilename);
+      for (const Element& element : elements) {
+        AddElement(element, builder);
+      }
+    }
+    pos += usable;
+  }
+  if (verbose) {
+    std::cout << "Finished processing nodes and edges\n";
+  }
+  return katana::ResultSuccess();
 }
 
 }  // end of unnamed namespace
 
 katana::Result<katana::GraphComponents>
 katana::ConvertGraphML(
-    const std::string& infilename, size_t chunk_size, bool verbose) {
+    const std::string& infilename, size_t chunk_size, bool verbose,
+    bool parallel) {
   xmlTextReaderPtr reader;
   int ret = 0;
 
   katana::PropertyGraphBuilder builder{chunk_size};
 
+  if (parallel) {
+    // the keys are declared before the graph, so they are read first
+    auto keys = katana::graphml::ProcessSchemaMapping(infilename).second;
+    for (PropertyKey& key : keys) {
+      AddKey(std::move(key), &builder);
+    }
+    KATANA_CHECKED_CONTEXT(
+        ProcessGraphParallel(infilename, &builder, verbose),
+        "Failed to parse {}", infilename);
+    return builder.Finish(verbose);
+  }
+
   bool finishedGraph = false;
   if (verbose) {
     std::cout << "Start converting GraphML file: " << infilename << "\n";
@@ -632,15 +868,7 @@ katana::ConvertGraphML(
       if (xmlTextReaderNodeType(reader) == 1) {
         // if elt is a "key" xml node read it in
         if (xmlStrEqual(name, BAD_CAST "key")) {
-          PropertyKey key = katana::graphml::ProcessKey(reader);
-          if (!key.id.empty() && key.id != std::string("label") &&
-              key.id != std::string("IGNORE")) {
-            if (key.for_node) {
-              builder.AddBuilder(std::move(key));
-            } else if (key.for_edge) {
-              builder.AddBuilder(std::move(key));
-            }
-          }
+          AddKey(katana::graphml::ProcessKey(reader), &builder);
         } else if (xmlStrEqual(name, BAD_CAST "graph")) {
           if (verbose) {
             std::cout << "Finished processing property headers\n";
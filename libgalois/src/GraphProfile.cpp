@@ -0,0 +1,192 @@
+#include "katana/GraphProfile.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "katana/DynamicBitset.h"
+#include "katana/Loops.h"
+#include "katana/Reduction.h"
+#include "katana/Timer.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+
+constexpr uint32_t kDegreeSamples = 1000;
+constexpr uint32_t kSymmetrySamples = 1024;
+/// Edges scanned by the diameter probe before it stops
+constexpr uint64_t kProbeEdges = uint64_t{1} << 22;
+/// Reverse edges are looked up by a scan when the edges are not sorted, so
+/// destinations of higher degree are not checked
+constexpr uint64_t kMaxScanDegree = 1 << 12;
+
+/// Fixed so that a graph always gets the same profile
+constexpr uint64_t kSeed = 0x9e3779b97f4a7c15ULL;
+
+void
+ProfileDegrees(const katana::GraphTopology& topo, katana::GraphProfile* p) {
+  katana::GReduceMax<uint64_t> max_degree;
+  katana::do_all(
+      katana::iterate(topo.all_nodes()),
+      [&](Node n) { max_degree.update(topo.edges(n).size()); },
+      katana::no_stats());
+  p->max_degree = max_degree.reduce();
+  if (p->num_edges == 0) {
+    return;
+  }
+
+  // This code has been copied from GAP benchmark suite
+  // (https://github.com/sbeamer/gapbs/blob/master/src/tc.cc
+  // WorthRelabelling())
+  std::mt19937_64 gen(kSeed);
+  std::uniform_int_distribution<uint64_t> dist(0, p->num_nodes - 1);
+  std::vector<uint64_t> samples;
+  samples.reserve(kDegreeSamples);
+  uint64_t sample_total = 0;
+  for (uint64_t tries = 0;
+       samples.size() < std::min<uint64_t>(kDegreeSamples, p->num_nodes) &&
+       tries < 16 * kDegreeSamples;
+       ++tries) {
+    uint64_t degree = topo.edges(dist(gen)).size();
+    if (degree != 0) {
+      samples.emplace_back(degree);
+      sample_total += degree;
+    }
+  }
+  if (samples.empty()) {
+    return;
+  }
+  std::sort(samples.begin(), samples.end());
+  double sample_average = static_cast<double>(sample_total) / samples.size();
+  double sample_median = samples[samples.size() / 2];
+  p->degree_skew = sample_average / sample_median;
+  p->power_law = p->num_nodes >= 10 && p->num_edges / p->num_nodes >= 10 &&
+                 p->degree_skew > 1.3;
+}
+
+/// A level synchronous breadth first search from a node of max degree
+void
+ProfileDiameter(const katana::GraphTopology& topo, katana::GraphProfile* p) {
+  if (p->num_edges == 0) {
+    return;
+  }
+  Node source = 0;
+  for (Node n : topo.all_nodes()) {
+    if (topo.edges(n).size() == p->max_degree) {
+      source = n;
+      break;
+    }
+  }
+
+  katana::DynamicBitset visited;
+  visited.resize(p->num_nodes);
+  visited.set(source);
+  std::vector<Node> frontier{source};
+  std::vector<Node> next;
+  uint64_t scanned = 0;
+  while (!frontier.empty() && scanned < kProbeEdges) {
+    for (Node n : frontier) {
+      for (Edge e : topo.edges(n)) {
+        Node dst = topo.edge_dest(e);
+        if (!visited.test(dst)) {
+          visited.set(dst);
+          next.emplace_back(dst);
+        }
+      }
+      scanned += topo.edges(n).size();
+    }
+    if (!next.empty()) {
+      p->probe_levels += 1;
+    }
+    std::swap(frontier, next);
+    next.clear();
+  }
+  p->diameter_class =
+      p->probe_levels >= katana::GraphProfile::kHighDiameterLevels
+          ? katana::GraphProfile::kHighDiameter
+          : katana::GraphProfile::kLowDiameter;
+}
+
+void
+ProfileSortedness(
+    const katana::GraphTopology& topo, katana::GraphProfile* p) {
+  katana::GAccumulator<uint64_t> unsorted;
+  katana::do_all(
+      katana::iterate(topo.all_nodes()),
+      [&](Node n) {
+        auto edges = topo.edges(n);
+        for (Edge e = *edges.begin() + 1; e < *edges.end(); ++e) {
+          if (topo.edge_dest(e - 1) > topo.edge_dest(e)) {
+            unsorted += 1;
+            return;
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+  if (p->num_nodes != 0) {
+    p->sorted_fraction =
+        1.0 - static_cast<double>(unsorted.reduce()) / p->num_nodes;
+  }
+  p->edges_sorted = unsorted.reduce() == 0;
+}
+
+bool
+HasEdge(
+    const katana::GraphTopology& topo, Node src, Node dst, bool sorted) {
+  auto edges = topo.edges(src);
+  if (sorted) {
+    auto it = std::lower_bound(
+        edges.begin(), edges.end(), dst,
+        [&](Edge e, Node n) { return topo.edge_dest(e) < n; });
+    return it != edges.end() && topo.edge_dest(*it) == dst;
+  }
+  return std::any_of(edges.begin(), edges.end(), [&](Edge e) {
+    return topo.edge_dest(e) == dst;
+  });
+}
+
+void
+ProfileSymmetry(const katana::GraphTopology& topo, katana::GraphProfile* p) {
+  if (p->num_edges == 0) {
+    return;
+  }
+  std::mt19937_64 gen(kSeed);
+  std::uniform_int_distribution<uint64_t> dist(0, p->num_nodes - 1);
+  for (uint32_t i = 0; i < kSymmetrySamples; ++i) {
+    Node src = dist(gen);
+    auto edges = topo.edges(src);
+    if (edges.empty()) {
+      continue;
+    }
+    Edge e = *edges.begin() + gen() % edges.size();
+    Node dst = topo.edge_dest(e);
+    if (!p->edges_sorted && topo.edges(dst).size() > kMaxScanDegree) {
+      continue;
+    }
+    if (!HasEdge(topo, dst, src, p->edges_sorted)) {
+      p->likely_symmetric = false;
+      return;
+    }
+  }
+}
+
+}  // namespace
+
+katana::GraphProfile
+katana::GraphProfile::Make(const GraphTopology& topo) noexcept {
+  katana::StatTimer timer("GraphProfile");
+  timer.start();
+
+  GraphProfile profile;
+  profile.num_nodes = topo.num_nodes();
+  profile.num_edges = topo.num_edges();
+  ProfileDegrees(topo, &profile);
+  ProfileDiameter(topo, &profile);
+  ProfileSortedness(topo, &profile);
+  ProfileSymmetry(topo, &profile);
+
+  timer.stop();
+  return profile;
+}
@@ -1,10 +1,26 @@
 #include "katana/GraphTopology.h"
 
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <iomanip>
 #include <iostream>
+#include <limits>
+#include <set>
 
+#include <arrow/api.h>
+#include <arrow/compute/api.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/Env.h"
+#include "katana/GraphHelpers.h"
+#include "katana/GraphProfile.h"
 #include "katana/Logging.h"
+#include "katana/MemoryAccounting.h"
+#include "katana/ParallelSTL.h"
 #include "katana/PropertyGraph.h"
 #include "katana/Random.h"
+#include "katana/TemporalEdgeIndex.h"
 
 void
 katana::GraphTopology::Print() noexcept {
@@ -22,15 +38,157 @@ katana::GraphTopology::Print() noexcept {
 
 katana::GraphTopology::GraphTopology(
     const Edge* adj_indices, size_t num_nodes, const Node* dests,
-    size_t num_edges) noexcept {
-  adj_indices_.allocateInterleaved(num_nodes);
-  dests_.allocateInterleaved(num_edges);
+    size_t num_edges, Placement placement) noexcept {
+  switch (placement) {
+  case Placement::kBorrowed:
+    // The buffers are only read unless Own() copies them first
+    adj_indices_ = NUMAArray<Edge>(const_cast<Edge*>(adj_indices), num_nodes);
+    dests_ = NUMAArray<Node>(const_cast<Node*>(dests), num_edges);
+    borrowed_ = true;
+    return;
+  case Placement::kInterleaved:
+    adj_indices_.allocateInterleaved(num_nodes);
+    dests_.allocateInterleaved(num_edges);
+    break;
+  case Placement::kBlocked: {
+    // Split nodes the way a blocked iterate over all_nodes() does and place
+    // each thread's edges with its nodes
+    const uint64_t num_threads = katana::activeThreads;
+    std::vector<uint64_t> node_ranges(num_threads + 1);
+    std::vector<uint64_t> edge_ranges(num_threads + 1);
+    for (uint64_t t = 0; t <= num_threads; ++t) {
+      node_ranges[t] = t * num_nodes / num_threads;
+      edge_ranges[t] = node_ranges[t] > 0 ? adj_indices[node_ranges[t] - 1] : 0;
+    }
+    adj_indices_.allocateSpecified(num_nodes, node_ranges);
+    dests_.allocateSpecified(num_edges, edge_ranges);
+    break;
+  }
+  default:
+    KATANA_LOG_FATAL("unknown placement: {}", static_cast<int>(placement));
+  }
 
   katana::ParallelSTL::copy(
       &adj_indices[0], &adj_indices[num_nodes], adj_indices_.begin());
   katana::ParallelSTL::copy(&dests[0], &dests[num_edges], dests_.begin());
 }
 
+void
+katana::GraphTopology::Own() noexcept {
+  GraphTopology copy(
+      adj_indices_.data(), adj_indices_.size(), dests_.data(), dests_.size());
+  adj_indices_ = std::move(copy.adj_indices_);
+  dests_ = std::move(copy.dests_);
+  borrowed_ = false;
+  owner_.reset();
+}
+
+namespace {
+
+struct SharedTopologyArrays {
+  katana::NUMAArray<katana::GraphTopology::Edge> adj_indices;
+  katana::NUMAArray<katana::GraphTopology::Node> dests;
+};
+
+}  // namespace
+
+void
+katana::GraphTopology::MoveToSharedStorage() noexcept {
+  if (borrowed_) {
+    // Either shared already or owned by someone else
+    return;
+  }
+  auto shared = std::make_shared<SharedTopologyArrays>();
+  shared->adj_indices = std::move(adj_indices_);
+  shared->dests = std::move(dests_);
+  adj_indices_ =
+      NUMAArray<Edge>(shared->adj_indices.data(), shared->adj_indices.size());
+  dests_ = NUMAArray<Node>(shared->dests.data(), shared->dests.size());
+  borrowed_ = true;
+  owner_ = std::move(shared);
+}
+
+katana::GraphTopology
+katana::GraphTopology::Share() const noexcept {
+  if (!shareable()) {
+    return Copy(*this);
+  }
+  GraphTopology shared(
+      adj_indices_.data(), adj_indices_.size(), dests_.data(), dests_.size(),
+      Placement::kBorrowed);
+  shared.owner_ = owner_;
+  shared.edge_balanced_partition_ = std::atomic_load(&edge_balanced_partition_);
+  return shared;
+}
+
+void
+katana::GraphTopology::Unshare() noexcept {
+  if (owner_ && owner_.use_count() > 1) {
+    Own();
+    MoveToSharedStorage();
+  }
+}
+
+std::shared_ptr<const katana::EdgeBalancedPartition>
+katana::GraphTopology::edge_balanced_partition() const {
+  std::shared_ptr<const EdgeBalancedPartition> partition =
+      std::atomic_load(&edge_balanced_partition_);
+  if (partition && partition->num_threads() == katana::activeThreads) {
+    return partition;
+  }
+
+  // Weigh each node like an edge so that runs of nodes without edges are
+  // split too
+  constexpr uint32_t kNodeWeight = 1;
+  partition = std::make_shared<const EdgeBalancedPartition>(
+      katana::determineUnitRangesFromPrefixSum(
+          katana::activeThreads, adj_indices_, num_nodes(), kNodeWeight));
+  std::atomic_store(&edge_balanced_partition_, partition);
+  return partition;
+}
+
+namespace {
+
+/// Compare arrays a and b of size elements in parallel, a block at a time
+template <typename T>
+bool
+ArraysEqual(const T* a, const T* b, uint64_t size) {
+  if (a == b) {
+    return true;
+  }
+  constexpr uint64_t kBlockSize = uint64_t{1} << 16;
+  katana::GReduceLogicalOr differ;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, (size + kBlockSize - 1) / kBlockSize),
+      [&](uint64_t block) {
+        uint64_t begin = block * kBlockSize;
+        uint64_t end = std::min(size, begin + kBlockSize);
+        if (std::memcmp(a + begin, b + begin, (end - begin) * sizeof(T)) != 0) {
+          differ.update(true);
+        }
+      },
+      katana::no_stats());
+  return !differ.reduce();
+}
+
+}  // namespace
+
+bool
+katana::GraphTopology::Equals(const GraphTopology& that) const noexcept {
+  if (this == &that) {
+    return true;
+  }
+  if (num_nodes() != that.num_nodes()) {
+    return false;
+  }
+  if (num_edges() != that.num_edges()) {
+    return false;
+  }
+
+  return ArraysEqual(adj_data(), that.adj_data(), num_nodes()) &&
+         ArraysEqual(dest_data(), that.dest_data(), num_edges());
+}
+
 katana::GraphTopology
 katana::GraphTopology::Copy(const GraphTopology& that) noexcept {
   return katana::GraphTopology(
@@ -135,12 +293,296 @@ katana::EdgeShuffleTopology::MakeOriginalCopy(const katana::PropertyGraph* pg) {
       std::move(edge_prop_indices)});
 }
 
+std::unique_ptr<katana::EdgeShuffleTopology>
+katana::EdgeShuffleTopology::MakeFromArrays(
+    const TransposeKind& tpose_state, const EdgeSortKind& edge_sort_state,
+    const Edge* adj_indices, size_t num_nodes, const Node* dests,
+    const PropertyIndex* edge_prop_indices, size_t num_edges) noexcept {
+  GraphTopology copy_topo(adj_indices, num_nodes, dests, num_edges);
+
+  GraphTopologyTypes::PropIndexVec edge_prop_indices_copy;
+  edge_prop_indices_copy.allocateInterleaved(num_edges);
+  katana::ParallelSTL::copy(
+      &edge_prop_indices[0], &edge_prop_indices[num_edges],
+      edge_prop_indices_copy.begin());
+
+  return std::make_unique<EdgeShuffleTopology>(EdgeShuffleTopology{
+      tpose_state, edge_sort_state, std::move(copy_topo.GetAdjIndices()),
+      std::move(copy_topo.GetDests()), std::move(edge_prop_indices_copy)});
+}
+
+std::unique_ptr<katana::EdgeShuffleTopology>
+katana::EdgeShuffleTopology::MakeUndirected(
+    const katana::PropertyGraph* pg,
+    const katana::EdgeShuffleTopology& in_topo) noexcept {
+  const GraphTopology& out_topo = pg->topology();
+  KATANA_LOG_DEBUG_ASSERT(in_topo.is_transposed());
+  KATANA_LOG_DEBUG_ASSERT(in_topo.num_edges() == out_topo.num_edges());
+
+  const uint64_t num_nodes = out_topo.num_nodes();
+  if (num_nodes == 0) {
+    EdgeShuffleTopology et;
+    et.edge_sort_state_ = EdgeSortKind::kSortedByDestID;
+    return std::make_unique<EdgeShuffleTopology>(std::move(et));
+  }
+
+  // (neighbor, original edge) pairs
+  using Neighbor = std::pair<Node, PropertyIndex>;
+  katana::PerThreadStorage<std::vector<Neighbor>> scratch;
+
+  // The neighbors of n, sorted, each with the smallest ID of the edges that
+  // join them. Computed once to count them and again to place them, rather
+  // than keeping every node's list.
+  auto neighbors_of = [&](Node n) -> const std::vector<Neighbor>& {
+    std::vector<Neighbor>& neighbors = *scratch.getLocal();
+    neighbors.clear();
+    for (Edge e : out_topo.edges(n)) {
+      if (out_topo.edge_dest(e) != n) {
+        neighbors.emplace_back(out_topo.edge_dest(e), e);
+      }
+    }
+    for (Edge e : in_topo.edges(n)) {
+      if (in_topo.edge_dest(e) != n) {
+        neighbors.emplace_back(
+            in_topo.edge_dest(e), in_topo.edge_property_index(e));
+      }
+    }
+    std::sort(neighbors.begin(), neighbors.end());
+    neighbors.erase(
+        std::unique(
+            neighbors.begin(), neighbors.end(),
+            [](const Neighbor& a, const Neighbor& b) {
+              return a.first == b.first;
+            }),
+        neighbors.end());
+    return neighbors;
+  };
+
+  AdjIndexVec adj_indices;
+  adj_indices.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(out_topo.all_nodes()),
+      [&](Node n) { adj_indices[n] = neighbors_of(n).size(); },
+      katana::steal(), katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      adj_indices.begin(), adj_indices.end(), adj_indices.begin());
+
+  const uint64_t num_edges = adj_indices[num_nodes - 1];
+  EdgeDestVec dests;
+  dests.allocateInterleaved(num_edges);
+  PropIndexVec edge_prop_indices;
+  edge_prop_indices.allocateInterleaved(num_edges);
+  katana::do_all(
+      katana::iterate(out_topo.all_nodes()),
+      [&](Node n) {
+        Edge e = n > 0 ? adj_indices[n - 1] : 0;
+        for (const auto& [neighbor, prop_index] : neighbors_of(n)) {
+          dests[e] = neighbor;
+          edge_prop_indices[e] = prop_index;
+          ++e;
+        }
+        KATANA_LOG_DEBUG_ASSERT(e == adj_indices[n]);
+      },
+      katana::steal(), katana::no_stats());
+
+  // TODO(amber): introduce a per-thread-container type that frees memory
+  // correctly
+  katana::on_each([&](unsigned, unsigned) {
+    // free up memory by resetting
+    *scratch.getLocal() = std::vector<Neighbor>();
+  });
+
+  return std::make_unique<EdgeShuffleTopology>(EdgeShuffleTopology{
+      TransposeKind::kNo, EdgeSortKind::kSortedByDestID,
+      std::move(adj_indices), std::move(dests), std::move(edge_prop_indices)});
+}
+
+namespace {
+
+constexpr uint64_t kEmptySlot = UINT64_MAX;
+constexpr uint64_t kHashMultiplier = UINT64_C(0x9E3779B97F4A7C15);
+
+/// Slot of \p dst in a hash table of \p size (a power of two, at least 2)
+uint64_t
+HubSlot(katana::GraphTopologyTypes::Node dst, uint64_t size) {
+  return (uint64_t{dst} * kHashMultiplier) >> (64 - __builtin_ctzll(size));
+}
+
+uint64_t
+NextPowerOfTwo(uint64_t val) {
+  uint64_t ret = 1;
+  while (ret < val) {
+    ret <<= 1;
+  }
+  return ret;
+}
+
+}  // namespace
+
+std::unique_ptr<katana::HubEdgeIndex>
+katana::HubEdgeIndex::Make(
+    const GraphTopology& topo, uint64_t min_degree,
+    uint64_t max_bytes) noexcept {
+  KATANA_LOG_VASSERT(min_degree > 0, "hubs must have at least one edge");
+  std::unique_ptr<HubEdgeIndex> ret(new HubEdgeIndex());
+  ret->min_degree_ = min_degree;
+
+  std::vector<Node> candidates;
+  for (Node node : topo.all_nodes()) {
+    if (topo.degree(node) >= min_degree) {
+      candidates.emplace_back(node);
+    }
+  }
+  // Highest degree first, since they gain the most from an index
+  std::sort(
+      candidates.begin(), candidates.end(), [&](Node n1, Node n2) {
+        auto d1 = topo.degree(n1);
+        auto d2 = topo.degree(n2);
+        return d1 > d2 || (d1 == d2 && n1 < n2);
+      });
+
+  std::vector<std::pair<Node, Node>> dest_ranges(candidates.size());
+  katana::do_all(
+      katana::iterate(size_t{0}, candidates.size()),
+      [&](size_t i) {
+        Node min_dest = std::numeric_limits<Node>::max();
+        Node max_dest = 0;
+        for (auto e : topo.edges(candidates[i])) {
+          min_dest = std::min(min_dest, topo.edge_dest(e));
+          max_dest = std::max(max_dest, topo.edge_dest(e));
+        }
+        dest_ranges[i] = {min_dest, max_dest};
+      },
+      katana::steal(), katana::no_stats());
+
+  uint64_t num_words = 0;
+  uint64_t total_bytes = 0;
+  for (size_t i = 0; i < candidates.size(); ++i) {
+    uint64_t degree = topo.degree(candidates[i]);
+    auto [min_dest, max_dest] = dest_ranges[i];
+    uint64_t bitmap_words = (uint64_t{max_dest} - min_dest) / 64 + 1;
+    // Hash tables are kept at most half full; slots pack a 32-bit offset
+    uint64_t hash_words = NextPowerOfTwo(2 * degree);
+    bool is_bitmap = bitmap_words <= hash_words ||
+                     degree >= std::numeric_limits<uint32_t>::max();
+    uint64_t size = is_bitmap ? bitmap_words : hash_words;
+    uint64_t bytes = size * sizeof(uint64_t) + sizeof(Hub);
+    if (total_bytes + bytes > max_bytes) {
+      continue;
+    }
+    total_bytes += bytes;
+    ret->hubs_.emplace_back(Hub{
+        .node = candidates[i],
+        .min_dest = min_dest,
+        .is_bitmap = is_bitmap,
+        .begin = num_words,
+        .size = size,
+    });
+    num_words += size;
+  }
+  std::sort(
+      ret->hubs_.begin(), ret->hubs_.end(),
+      [](const Hub& h1, const Hub& h2) { return h1.node < h2.node; });
+
+  ret->words_.allocateInterleaved(num_words);
+  katana::do_all(
+      katana::iterate(size_t{0}, ret->hubs_.size()),
+      [&](size_t i) {
+        const Hub& hub = ret->hubs_[i];
+        uint64_t* words = ret->words_.data() + hub.begin;
+        auto e_range = topo.edges(hub.node);
+        if (hub.is_bitmap) {
+          std::fill(words, words + hub.size, uint64_t{0});
+          for (auto e : e_range) {
+            uint64_t bit = topo.edge_dest(e) - hub.min_dest;
+            words[bit / 64] |= uint64_t{1} << (bit % 64);
+          }
+          return;
+        }
+        std::fill(words, words + hub.size, kEmptySlot);
+        uint64_t offset = 0;
+        for (auto e : e_range) {
+          Node dst = topo.edge_dest(e);
+          for (uint64_t slot = HubSlot(dst, hub.size);;
+               slot = (slot + 1) & (hub.size - 1)) {
+            if (words[slot] == kEmptySlot) {
+              words[slot] = (uint64_t{dst} << 32) | offset;
+              break;
+            }
+            if ((words[slot] >> 32) == dst) {
+              // Keep the first edge to each destination
+              break;
+            }
+          }
+          offset++;
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  return ret;
+}
+
+katana::HubEdgeIndex::LookupResult
+katana::HubEdgeIndex::Find(Node src, Node dst) const noexcept {
+  auto it = std::lower_bound(
+      hubs_.begin(), hubs_.end(), src,
+      [](const Hub& hub, Node node) { return hub.node < node; });
+  if (it == hubs_.end() || it->node != src) {
+    return LookupResult{};
+  }
+
+  const Hub& hub = *it;
+  const uint64_t* words = words_.data() + hub.begin;
+  if (hub.is_bitmap) {
+    if (dst < hub.min_dest || uint64_t{dst} - hub.min_dest >= hub.size * 64) {
+      return LookupResult{.kind = LookupKind::kAbsent};
+    }
+    uint64_t bit = dst - hub.min_dest;
+    bool present = (words[bit / 64] >> (bit % 64)) & 1;
+    return LookupResult{
+        .kind = present ? LookupKind::kPresent : LookupKind::kAbsent};
+  }
+
+  for (uint64_t slot = HubSlot(dst, hub.size);;
+       slot = (slot + 1) & (hub.size - 1)) {
+    if (words[slot] == kEmptySlot) {
+      return LookupResult{.kind = LookupKind::kAbsent};
+    }
+    if ((words[slot] >> 32) == dst) {
+      return LookupResult{
+          .kind = LookupKind::kPresent,
+          .edge_offset = words[slot] & UINT32_MAX,
+      };
+    }
+  }
+}
+
+void
+katana::EdgeShuffleTopology::BuildHubIndex(
+    uint64_t min_degree, uint64_t max_bytes) noexcept {
+  hub_index_ = HubEdgeIndex::Make(*this, min_degree, max_bytes);
+  KATANA_LOG_DEBUG(
+      "hub index: {} nodes with {} or more edges, {} bytes",
+      hub_index_->num_hubs(), min_degree, hub_index_->bytes());
+}
+
 katana::GraphTopologyTypes::edge_iterator
 katana::EdgeShuffleTopology::find_edge(
     const katana::GraphTopologyTypes::Node& src,
     const katana::GraphTopologyTypes::Node& dst) const noexcept {
   auto e_range = edges(src);
 
+  if (hub_index_ && e_range.size() >= hub_index_->min_degree()) {
+    auto res = hub_index_->Find(src, dst);
+    if (res.kind == HubEdgeIndex::LookupKind::kAbsent) {
+      return e_range.end();
+    }
+    if (res.kind == HubEdgeIndex::LookupKind::kPresent &&
+        res.edge_offset != UINT64_MAX) {
+      return e_range.begin() + res.edge_offset;
+    }
+  }
+
   constexpr size_t kBinarySearchThreshold = 64;
 
   if (e_range.size() > kBinarySearchThreshold &&
@@ -194,228 +636,925 @@ katana::EdgeShuffleTopology::find_edges(
   return ret_range;
 }
 
-void
-katana::EdgeShuffleTopology::SortEdgesByDestID() noexcept {
-  katana::do_all(
-      katana::iterate(Base::all_nodes()),
-      [&](Node node) {
-        // get this node's first and last edge
-        auto e_beg = *Base::edges(node).begin();
-        auto e_end = *Base::edges(node).end();
+namespace {
 
-        // get iterators to locations to sort in the vector
-        auto begin_sort_iter = katana::make_zip_iterator(
-            edge_prop_indices_.begin() + e_beg,
-            Base::GetDests().begin() + e_beg);
+struct KeyedEdge {
+  uint64_t key;
+  // Offset of the edge among the edges of its node
+  uint64_t pos;
+};
 
-        auto end_sort_iter = katana::make_zip_iterator(
-            edge_prop_indices_.begin() + e_end,
-            Base::GetDests().begin() + e_end);
+// Below this many edges a comparison sort beats the histogram passes
+constexpr uint64_t kRadixSortThreshold = 256;
 
-        // rearrange vector indices based on how the destinations of this
-        // graph will eventually be sorted sort function not based on vector
-        // being passed, but rather the type and destination of the graph
-        std::sort(
-            begin_sort_iter, end_sort_iter,
-            [&](const auto& tup1, const auto& tup2) {
-              auto dst1 = std::get<1>(tup1);
-              auto dst2 = std::get<1>(tup2);
-              static_assert(
-                  std::is_same_v<decltype(dst1), GraphTopology::Node>);
-              static_assert(
-                  std::is_same_v<decltype(dst2), GraphTopology::Node>);
-              return dst1 < dst2;
-            });
-      },
-      katana::steal(), katana::no_stats());
-  // remember to update sort state
-  edge_sort_state_ = EdgeSortKind::kSortedByDestID;
+/// Sort \p edges by key, breaking ties by position. Large ranges are LSD
+/// radix sorted a byte at a time, skipping the bytes on which all keys
+/// agree, so sorting by a 32-bit destination usually takes 2-4 passes.
+/// \p scratch must have room for \p n entries.
+void
+SortKeyedEdges(KeyedEdge* edges, uint64_t n, KeyedEdge* scratch) noexcept {
+  if (n <= kRadixSortThreshold) {
+    std::sort(edges, edges + n, [](const KeyedEdge& a, const KeyedEdge& b) {
+      return a.key < b.key || (a.key == b.key && a.pos < b.pos);
+    });
+    return;
+  }
+
+  uint64_t varying_bits = 0;
+  for (uint64_t i = 1; i < n; ++i) {
+    varying_bits |= edges[i].key ^ edges[0].key;
+  }
+
+  KeyedEdge* src = edges;
+  KeyedEdge* dst = scratch;
+  for (uint32_t shift = 0; shift < 64; shift += 8) {
+    if (((varying_bits >> shift) & 0xff) == 0) {
+      continue;
+    }
+    uint64_t offsets[256] = {};
+    for (uint64_t i = 0; i < n; ++i) {
+      offsets[(src[i].key >> shift) & 0xff]++;
+    }
+    uint64_t total = 0;
+    for (uint64_t& offset : offsets) {
+      uint64_t count = offset;
+      offset = total;
+      total += count;
+    }
+    // Scattering in order keeps each pass stable
+    for (uint64_t i = 0; i < n; ++i) {
+      dst[offsets[(src[i].key >> shift) & 0xff]++] = src[i];
+    }
+    std::swap(src, dst);
+  }
+  if (src != edges) {
+    std::copy(src, src + n, edges);
+  }
 }
 
+}  // namespace
+
+template <typename KeyFn>
 void
-katana::EdgeShuffleTopology::SortEdgesByTypeThenDest(
-    const PropertyGraph* pg) noexcept {
+katana::EdgeShuffleTopology::SortEdgesByKey(const KeyFn& key_of) noexcept {
+  // Edge offsets in the hub index are about to change
+  hub_index_.reset();
+
+  katana::PerThreadStorage<std::vector<KeyedEdge>> scratch;
+
   katana::do_all(
       katana::iterate(Base::all_nodes()),
       [&](Node node) {
         // get this node's first and last edge
         auto e_beg = *Base::edges(node).begin();
         auto e_end = *Base::edges(node).end();
+        uint64_t n = e_end - e_beg;
+        if (n < 2) {
+          return;
+        }
 
-        // get iterators to locations to sort in the vector
-        auto begin_sort_iter = katana::make_zip_iterator(
-            edge_prop_indices_.begin() + e_beg,
-            Base::GetDests().begin() + e_beg);
+        std::vector<KeyedEdge>& buf = *scratch.getLocal();
+        if (buf.size() < 2 * n) {
+          buf.resize(2 * n);
+        }
+        KeyedEdge* keyed = buf.data();
+        KeyedEdge* tmp = keyed + n;
 
-        auto end_sort_iter = katana::make_zip_iterator(
-            edge_prop_indices_.begin() + e_end,
-            Base::GetDests().begin() + e_end);
+        Node* dests = Base::GetDests().data() + e_beg;
+        PropertyIndex* prop_indices = edge_prop_indices_.data() + e_beg;
+        for (uint64_t i = 0; i < n; ++i) {
+          keyed[i] = KeyedEdge{key_of(dests[i], prop_indices[i]), i};
+        }
 
-        // rearrange vector indices based on how the destinations of this
-        // graph will eventually be sorted sort function not based on vector
-        // being passed, but rather the type and destination of the graph
-        std::sort(
-            begin_sort_iter, end_sort_iter,
-            [&](const auto& tup1, const auto& tup2) {
-              // get edge type and destinations
-              auto e1 = std::get<0>(tup1);
-              auto e2 = std::get<0>(tup2);
-              static_assert(
-                  std::is_same_v<decltype(e1), GraphTopology::PropertyIndex>);
-              static_assert(
-                  std::is_same_v<decltype(e2), GraphTopology::PropertyIndex>);
-
-              EntityType data1 = pg->GetTypeOfEdge(e1);
-              EntityType data2 = pg->GetTypeOfEdge(e2);
-              if (data1 != data2) {
-                return data1 < data2;
-              }
+        SortKeyedEdges(keyed, n, tmp);
 
-              auto dst1 = std::get<1>(tup1);
-              auto dst2 = std::get<1>(tup2);
-              static_assert(
-                  std::is_same_v<decltype(dst1), GraphTopology::Node>);
-              static_assert(
-                  std::is_same_v<decltype(dst2), GraphTopology::Node>);
-              return dst1 < dst2;
-            });
+        // Gather through the scratch space, then write back in sorted order
+        for (uint64_t i = 0; i < n; ++i) {
+          tmp[i] = KeyedEdge{dests[keyed[i].pos], prop_indices[keyed[i].pos]};
+        }
+        for (uint64_t i = 0; i < n; ++i) {
+          dests[i] = static_cast<Node>(tmp[i].key);
+          prop_indices[i] = tmp[i].pos;
+        }
       },
       katana::steal(), katana::no_stats());
 
+  // TODO(amber): introduce a per-thread-container type that frees memory
+  // correctly
+  katana::on_each([&](unsigned, unsigned) {
+    // free up memory by resetting
+    *scratch.getLocal() = std::vector<KeyedEdge>();
+  });
+}
+
+void
+katana::EdgeShuffleTopology::SortEdgesByDestID() noexcept {
+  SortEdgesByKey([](Node dest, PropertyIndex) { return uint64_t{dest}; });
   // remember to update sort state
-  edge_sort_state_ = EdgeSortKind::kSortedByEdgeType;
+  edge_sort_state_ = EdgeSortKind::kSortedByDestID;
 }
 
 void
-katana::EdgeShuffleTopology::SortEdgesByDestType(
-    const PropertyGraph*,
-    const katana::GraphTopologyTypes::PropIndexVec&) noexcept {
-  KATANA_LOG_FATAL("Not implemented yet");
+katana::EdgeShuffleTopology::SortEdgesByTypeThenDest(
+    const PropertyGraph* pg) noexcept {
+  // Pack (edge type, dest) into one key; types are at most 16 bits and nodes
+  // 32 bits
+  static_assert(sizeof(EntityType) + sizeof(Node) <= sizeof(uint64_t));
+  static_assert(std::is_same_v<EntityType, katana::EntityTypeID>);
+  SortEdgesByKey([pg](Node dest, PropertyIndex prop_index) {
+    uint64_t type = pg->GetTypeOfEdge(prop_index);
+    return (type << (8 * sizeof(Node))) | dest;
+  });
+
+  // remember to update sort state
+  edge_sort_state_ = EdgeSortKind::kSortedByEdgeType;
 }
 
-std::unique_ptr<katana::ShuffleTopology>
-katana::ShuffleTopology::MakeSortedByDegree(
-    const PropertyGraph*,
-    const katana::EdgeShuffleTopology& seed_topo) noexcept {
-  auto cmp = [&](const auto& i1, const auto& i2) {
-    auto d1 = seed_topo.degree(i1);
-    auto d2 = seed_topo.degree(i2);
-    if (d1 == d2) {
-      return d1 < d2;
-    }
-    return d1 < d2;
-  };
+void
+katana::EdgeShuffleTopology::SortEdgesByTimestamp(
+    const int64_t* timestamps) noexcept {
+  // Flipping the sign bit orders signed timestamps as unsigned keys
+  SortEdgesByKey([timestamps](Node, PropertyIndex prop_index) {
+    return static_cast<uint64_t>(timestamps[prop_index]) ^
+           (uint64_t{1} << 63);
+  });
 
-  return MakeNodeSortedTopo(seed_topo, cmp, NodeSortKind::kSortedByDegree);
+  edge_sort_state_ = EdgeSortKind::kSortedByTimestamp;
 }
 
-std::unique_ptr<katana::ShuffleTopology>
-katana::ShuffleTopology::MakeSortedByNodeType(
+void
+katana::EdgeShuffleTopology::SortEdgesByDestType(
     const PropertyGraph* pg,
-    const katana::EdgeShuffleTopology& seed_topo) noexcept {
-  auto cmp = [&](const auto& i1, const auto& i2) {
-    auto k1 = pg->GetTypeOfNode(i1);
-    auto k2 = pg->GetTypeOfNode(i2);
-    if (k1 == k2) {
-      return i1 < i2;
-    }
-    return k1 < k2;
-  };
+    const PropIndexVec& node_prop_indices) noexcept {
+  // Pack (dest node type, dest) into one key, as SortEdgesByTypeThenDest does
+  static_assert(sizeof(EntityType) + sizeof(Node) <= sizeof(uint64_t));
+  KATANA_LOG_DEBUG_ASSERT(
+      node_prop_indices.empty() || node_prop_indices.size() == num_nodes());
+  if (node_prop_indices.empty()) {
+    SortEdgesByKey([pg](Node dest, PropertyIndex) {
+      uint64_t type = pg->GetTypeOfNode(dest);
+      return (type << (8 * sizeof(Node))) | dest;
+    });
+  } else {
+    SortEdgesByKey([pg, &node_prop_indices](Node dest, PropertyIndex) {
+      uint64_t type = pg->GetTypeOfNode(node_prop_indices[dest]);
+      return (type << (8 * sizeof(Node))) | dest;
+    });
+  }
 
-  return MakeNodeSortedTopo(seed_topo, cmp, NodeSortKind::kSortedByNodeType);
+  edge_sort_state_ = EdgeSortKind::kSortedByNodeType;
 }
 
-std::unique_ptr<katana::CondensedTypeIDMap>
-katana::CondensedTypeIDMap::MakeFromEdgeTypes(
-    const katana::PropertyGraph* pg) noexcept {
-  TypeIDToIndexMap edge_type_to_index;
-  IndexToTypeIDMap edge_index_to_type;
-
-  katana::PerThreadStorage<katana::gstl::Set<EntityType>> edgeTypes;
+namespace {
+
+using Node = katana::GraphTopologyTypes::Node;
+using PropIndexVec = katana::GraphTopologyTypes::PropIndexVec;
+
+/// Stable, parallel counting sort of the nodes [0, num_nodes) into \p order
+/// by bucket_of(node) < num_buckets.
+///
+/// \returns the start of each bucket in \p order, plus num_nodes
+template <typename BucketFn>
+std::vector<uint64_t>
+BucketSortNodes(
+    uint64_t num_nodes, uint64_t num_buckets, const BucketFn& bucket_of,
+    PropIndexVec* order) noexcept {
+  KATANA_LOG_DEBUG_ASSERT(order->size() == num_nodes);
+  std::vector<uint64_t> bucket_begins(num_buckets + 1, num_nodes);
+  if (num_nodes == 0) {
+    return bucket_begins;
+  }
 
-  const auto& topo = pg->topology();
+  const uint64_t num_blocks =
+      std::min<uint64_t>(katana::activeThreads, num_nodes);
+  const uint64_t block_size = (num_nodes + num_blocks - 1) / num_blocks;
+  auto block_nodes = [&](uint64_t block) {
+    Node begin = block * block_size;
+    return katana::MakeStandardRange<katana::GraphTopologyTypes::node_iterator>(
+        begin, static_cast<Node>(std::min(begin + block_size, num_nodes)));
+  };
 
+  std::vector<uint64_t> offsets(num_blocks * num_buckets, 0);
   katana::do_all(
-      katana::iterate(Edge{0}, topo.num_edges()),
-      [&](const Edge& e) {
-        EntityType type = pg->GetTypeOfEdge(e);
-        edgeTypes.getLocal()->insert(type);
+      katana::iterate(uint64_t{0}, num_blocks),
+      [&](uint64_t block) {
+        uint64_t* counts = &offsets[block * num_buckets];
+        for (Node node : block_nodes(block)) {
+          counts[bucket_of(node)]++;
+        }
       },
       katana::no_stats());
 
-  // ordered map
-  std::set<EntityType> mergedSet;
-  for (uint32_t i = 0; i < katana::activeThreads; ++i) {
-    auto& edgeTypesSet = *edgeTypes.getRemote(i);
-    for (auto edgeType : edgeTypesSet) {
-      mergedSet.insert(edgeType);
+  // Prefix sum bucket-major, block-minor so that nodes in the same bucket
+  // stay in node ID order
+  uint64_t total = 0;
+  for (uint64_t bucket = 0; bucket < num_buckets; ++bucket) {
+    bucket_begins[bucket] = total;
+    for (uint64_t block = 0; block < num_blocks; ++block) {
+      uint64_t& offset = offsets[block * num_buckets + bucket];
+      uint64_t count = offset;
+      offset = total;
+      total += count;
     }
   }
+  KATANA_LOG_DEBUG_ASSERT(total == num_nodes);
 
-  // unordered map
-  uint32_t num_edge_types = 0u;
-  for (const auto& edgeType : mergedSet) {
-    edge_type_to_index[edgeType] = num_edge_types++;
-    edge_index_to_type.emplace_back(edgeType);
-  }
-
-  // TODO(amber): introduce a per-thread-container type that frees memory
-  // correctly
-  katana::on_each([&](unsigned, unsigned) {
-    // free up memory by resetting
-    *edgeTypes.getLocal() = gstl::Set<EntityType>();
-  });
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_blocks),
+      [&](uint64_t block) {
+        uint64_t* block_offsets = &offsets[block * num_buckets];
+        for (Node node : block_nodes(block)) {
+          (*order)[block_offsets[bucket_of(node)]++] = node;
+        }
+      },
+      katana::no_stats());
 
-  return std::make_unique<CondensedTypeIDMap>(CondensedTypeIDMap{
-      std::move(edge_type_to_index), std::move(edge_index_to_type)});
+  return bucket_begins;
 }
 
-katana::EdgeTypeAwareTopology::AdjIndexVec
-katana::EdgeTypeAwareTopology::CreatePerEdgeTypeAdjacencyIndex(
-    const PropertyGraph* pg, const CondensedTypeIDMap* edge_type_index,
-    const EdgeShuffleTopology* e_topo) noexcept {
-  if (e_topo->num_nodes() == 0) {
-    KATANA_LOG_VASSERT(
-        e_topo->num_edges() == 0, "Found graph with edges but no nodes");
-    return AdjIndexVec{};
-  }
+/// Nodes by increasing degree, ties in node ID order
+PropIndexVec
+NodesByDegree(const katana::EdgeShuffleTopology& seed_topo) noexcept {
+  PropIndexVec order;
+  order.allocateInterleaved(seed_topo.num_nodes());
+
+  // Nodes with degree kMaxCountedDegree or more share the last bucket, which
+  // is comparison sorted afterwards; there are at most num_edges /
+  // kMaxCountedDegree of them
+  constexpr uint64_t kMaxCountedDegree = 4096;
+  auto bucket_begins = BucketSortNodes(
+      seed_topo.num_nodes(), kMaxCountedDegree + 1,
+      [&](Node node) {
+        return std::min<uint64_t>(seed_topo.degree(node), kMaxCountedDegree);
+      },
+      &order);
+
+  katana::ParallelSTL::sort(
+      order.begin() + bucket_begins[kMaxCountedDegree], order.end(),
+      [&](const auto& i1, const auto& i2) {
+        auto d1 = seed_topo.degree(i1);
+        auto d2 = seed_topo.degree(i2);
+        if (d1 == d2) {
+          return i1 < i2;
+        }
+        return d1 < d2;
+      });
 
-  if (edge_type_index->num_unique_types() == 0) {
-    KATANA_LOG_VASSERT(
-        e_topo->num_edges() == 0, "Found graph with edges but no edge types");
-    // Graph has some nodes but no edges.
-    return AdjIndexVec{};
-  }
+  return order;
+}
 
-  const size_t sz = e_topo->num_nodes() * edge_type_index->num_unique_types();
-  AdjIndexVec adj_indices;
-  adj_indices.allocateInterleaved(sz);
+/// Breadth first traversal over the edges of \p seed_topo, starting a new
+/// traversal from each unvisited node of \p seeds in turn. If \p by_degree,
+/// the neighbors a node discovers are visited in increasing degree order.
+PropIndexVec
+BreadthFirstOrder(
+    const katana::EdgeShuffleTopology& seed_topo, const PropIndexVec& seeds,
+    bool by_degree) noexcept {
+  const uint64_t num_nodes = seed_topo.num_nodes();
+  PropIndexVec order;
+  order.allocateInterleaved(num_nodes);
+  std::vector<uint8_t> visited(num_nodes, 0);
+
+  // order doubles as the queue: [head, placed) is the frontier
+  uint64_t placed = 0;
+  for (auto seed : seeds) {
+    if (visited[seed]) {
+      continue;
+    }
+    visited[seed] = 1;
+    order[placed++] = seed;
+    for (uint64_t head = placed - 1; head < placed; ++head) {
+      Node node = order[head];
+      uint64_t discovered_begin = placed;
+      for (auto e : seed_topo.edges(node)) {
+        Node dest = seed_topo.edge_dest(e);
+        if (!visited[dest]) {
+          visited[dest] = 1;
+          order[placed++] = dest;
+        }
+      }
+      if (by_degree) {
+        std::sort(
+            order.begin() + discovered_begin, order.begin() + placed,
+            [&](const auto& i1, const auto& i2) {
+              auto d1 = seed_topo.degree(i1);
+              auto d2 = seed_topo.degree(i2);
+              if (d1 == d2) {
+                return i1 < i2;
+              }
+              return d1 < d2;
+            });
+      }
+    }
+  }
+  KATANA_LOG_DEBUG_ASSERT(placed == num_nodes);
+
+  return order;
+}
+
+/// Max priority queue of nodes whose priorities only change by one at a
+/// time, as in Gorder's unit heap. Nodes with the same priority are kept in
+/// a doubly linked list per priority, so every operation is O(1) amortized.
+class UnitHeap {
+public:
+  explicit UnitHeap(uint64_t num_nodes)
+      : keys_(num_nodes, 0),
+        next_(num_nodes),
+        prev_(num_nodes),
+        heads_(1, kNone),
+        removed_(num_nodes, 0) {
+    // Link in reverse so that ties pop in node ID order
+    for (uint64_t i = num_nodes; i > 0; --i) {
+      Link(i - 1);
+    }
+  }
+
+  void Increment(Node node) {
+    if (removed_[node]) {
+      return;
+    }
+    Unlink(node);
+    keys_[node]++;
+    if (keys_[node] >= heads_.size()) {
+      heads_.push_back(kNone);
+    }
+    Link(node);
+    max_key_ = std::max(max_key_, keys_[node]);
+  }
+
+  void Decrement(Node node) {
+    if (removed_[node] || keys_[node] == 0) {
+      return;
+    }
+    Unlink(node);
+    keys_[node]--;
+    Link(node);
+  }
+
+  void Remove(Node node) {
+    KATANA_LOG_DEBUG_ASSERT(!removed_[node]);
+    Unlink(node);
+    removed_[node] = 1;
+  }
+
+  /// Remove and return a node with the highest priority; the heap must not
+  /// be empty
+  Node PopMax() {
+    while (heads_[max_key_] == kNone) {
+      KATANA_LOG_DEBUG_ASSERT(max_key_ > 0);
+      max_key_--;
+    }
+    auto node = static_cast<Node>(heads_[max_key_]);
+    Remove(node);
+    return node;
+  }
+
+private:
+  static constexpr int64_t kNone = -1;
+
+  void Link(uint64_t node) {
+    int64_t& head = heads_[keys_[node]];
+    prev_[node] = kNone;
+    next_[node] = head;
+    if (head != kNone) {
+      prev_[head] = node;
+    }
+    head = node;
+  }
+
+  void Unlink(uint64_t node) {
+    if (prev_[node] != kNone) {
+      next_[prev_[node]] = next_[node];
+    } else {
+      heads_[keys_[node]] = next_[node];
+    }
+    if (next_[node] != kNone) {
+      prev_[next_[node]] = prev_[node];
+    }
+  }
+
+  std::vector<uint64_t> keys_;
+  std::vector<int64_t> next_;
+  std::vector<int64_t> prev_;
+  std::vector<int64_t> heads_;
+  std::vector<uint8_t> removed_;
+  uint64_t max_key_{0};
+};
+
+}  // namespace
+
+std::unique_ptr<katana::ShuffleTopology>
+katana::ShuffleTopology::MakeSortedByDegree(
+    const PropertyGraph*,
+    const katana::EdgeShuffleTopology& seed_topo) noexcept {
+  return MakeFromNodeOrder(
+      seed_topo, NodesByDegree(seed_topo), NodeSortKind::kSortedByDegree);
+}
+
+std::unique_ptr<katana::ShuffleTopology>
+katana::ShuffleTopology::MakeReverseCuthillMcKee(
+    const PropertyGraph*,
+    const katana::EdgeShuffleTopology& seed_topo) noexcept {
+  // Start each component from its lowest degree node
+  PropIndexVec order =
+      BreadthFirstOrder(seed_topo, NodesByDegree(seed_topo), true);
+  std::reverse(order.begin(), order.end());
+
+  return MakeFromNodeOrder(
+      seed_topo, std::move(order), NodeSortKind::kReverseCuthillMcKee);
+}
+
+std::unique_ptr<katana::ShuffleTopology>
+katana::ShuffleTopology::MakeBFSOrder(
+    const PropertyGraph*,
+    const katana::EdgeShuffleTopology& seed_topo) noexcept {
+  PropIndexVec seeds;
+  seeds.allocateInterleaved(seed_topo.num_nodes());
+  katana::ParallelSTL::iota(
+      seeds.begin(), seeds.end(), GraphTopologyTypes::PropertyIndex{0});
+
+  return MakeFromNodeOrder(
+      seed_topo, BreadthFirstOrder(seed_topo, seeds, false),
+      NodeSortKind::kBFSOrder);
+}
+
+std::unique_ptr<katana::ShuffleTopology>
+katana::ShuffleTopology::MakeGorder(
+    const PropertyGraph*,
+    const katana::EdgeShuffleTopology& seed_topo) noexcept {
+  // Window of the Gorder paper (Wei et al., SIGMOD 2016)
+  constexpr uint64_t kWindow = 5;
+  // Siblings through in-neighbors with more out-edges than this are
+  // ignored; they cost O(degree) per update and say little about locality
+  constexpr uint64_t kMaxSiblingDegree = 256;
+
+  const uint64_t num_nodes = seed_topo.num_nodes();
+  PropIndexVec order;
+  order.allocateInterleaved(num_nodes);
+  if (num_nodes == 0) {
+    return MakeFromNodeOrder(
+        seed_topo, std::move(order), NodeSortKind::kGorder);
+  }
+
+  // The placement score counts in-neighbors too, so build the transpose
+  std::vector<uint64_t> in_indices(num_nodes + 1, 0);
+  for (auto e : seed_topo.all_edges()) {
+    in_indices[seed_topo.edge_dest(e) + 1]++;
+  }
+  std::partial_sum(in_indices.begin(), in_indices.end(), in_indices.begin());
+  std::vector<Node> in_srcs(seed_topo.num_edges());
+  {
+    std::vector<uint64_t> fill(in_indices.begin(), in_indices.end() - 1);
+    for (Node src : seed_topo.all_nodes()) {
+      for (auto e : seed_topo.edges(src)) {
+        in_srcs[fill[seed_topo.edge_dest(e)]++] = src;
+      }
+    }
+  }
+
+  // Entering or leaving the window changes the score of each neighbor and
+  // of each sibling (a node sharing an in-neighbor) by one
+  UnitHeap heap(num_nodes);
+  auto update = [&](Node node, bool entering) {
+    auto apply = [&](Node other) {
+      if (entering) {
+        heap.Increment(other);
+      } else {
+        heap.Decrement(other);
+      }
+    };
+    for (auto e : seed_topo.edges(node)) {
+      apply(seed_topo.edge_dest(e));
+    }
+    for (uint64_t i = in_indices[node]; i < in_indices[node + 1]; ++i) {
+      Node parent = in_srcs[i];
+      apply(parent);
+      if (seed_topo.degree(parent) > kMaxSiblingDegree) {
+        continue;
+      }
+      for (auto e : seed_topo.edges(parent)) {
+        Node sibling = seed_topo.edge_dest(e);
+        if (sibling != node) {
+          apply(sibling);
+        }
+      }
+    }
+  };
+
+  // Start from the node with the most in-edges
+  Node first{0};
+  for (Node node : seed_topo.all_nodes()) {
+    if (in_indices[node + 1] - in_indices[node] >
+        in_indices[first + 1] - in_indices[first]) {
+      first = node;
+    }
+  }
+  order[0] = first;
+  heap.Remove(first);
+
+  for (uint64_t i = 1; i < num_nodes; ++i) {
+    update(order[i - 1], true);
+    if (i > kWindow) {
+      update(order[i - kWindow - 1], false);
+    }
+    order[i] = heap.PopMax();
+  }
+
+  return MakeFromNodeOrder(seed_topo, std::move(order), NodeSortKind::kGorder);
+}
+
+std::unique_ptr<katana::ShuffleTopology>
+katana::ShuffleTopology::MakeHubClustered(
+    const PropertyGraph*,
+    const katana::EdgeShuffleTopology& seed_topo) noexcept {
+  // Degree-based grouping (Faldu et al., IISWC 2019): groups are
+  // [0, avg/2), [avg/2, avg), [avg, 2avg), [2avg, 4avg), ... with the
+  // highest degree group placed first
+  constexpr uint64_t kNumGroups = 16;
+
+  const uint64_t num_nodes = seed_topo.num_nodes();
+  const uint64_t avg_degree =
+      std::max<uint64_t>(1, num_nodes > 0 ? seed_topo.num_edges() / num_nodes
+                                          : 0);
+  auto group_of = [&](Node node) -> uint64_t {
+    uint64_t degree = seed_topo.degree(node);
+    uint64_t group;
+    if (2 * degree < avg_degree) {
+      group = 0;
+    } else if (degree < avg_degree) {
+      group = 1;
+    } else {
+      // 2 + floor(log2(degree / avg_degree))
+      group = 2 + (63 - __builtin_clzll(degree / avg_degree));
+    }
+    return kNumGroups - 1 - std::min(group, kNumGroups - 1);
+  };
+
+  PropIndexVec order;
+  order.allocateInterleaved(num_nodes);
+  BucketSortNodes(num_nodes, kNumGroups, group_of, &order);
+
+  return MakeFromNodeOrder(
+      seed_topo, std::move(order), NodeSortKind::kHubCluster);
+}
+
+std::unique_ptr<katana::ShuffleTopology>
+katana::ShuffleTopology::MakeFromNodeOrder(
+    const katana::EdgeShuffleTopology& seed_topo,
+    PropIndexVec&& node_prop_indices,
+    const NodeSortKind& node_sort_todo) noexcept {
+  KATANA_LOG_DEBUG_ASSERT(node_prop_indices.size() == seed_topo.num_nodes());
+
+  GraphTopology::AdjIndexVec degrees;
+  degrees.allocateInterleaved(seed_topo.num_nodes());
+
+  katana::NUMAArray<GraphTopologyTypes::Node> old_to_new_map;
+  old_to_new_map.allocateInterleaved(seed_topo.num_nodes());
+  // TODO(amber): given 32-bit node ids, put a check here that
+  // node_prop_indices.size() < 2^32
+  katana::do_all(
+      katana::iterate(size_t{0}, node_prop_indices.size()),
+      [&](auto i) {
+        // node_prop_indices[i] gives old node id
+        old_to_new_map[node_prop_indices[i]] = i;
+        degrees[i] = seed_topo.degree(node_prop_indices[i]);
+      },
+      katana::no_stats());
+
+  KATANA_LOG_DEBUG_ASSERT(
+      node_sort_todo != NodeSortKind::kSortedByDegree ||
+      std::is_sorted(degrees.begin(), degrees.end()));
+
+  katana::ParallelSTL::partial_sum(
+      degrees.begin(), degrees.end(), degrees.begin());
+
+  GraphTopologyTypes::EdgeDestVec new_dest_vec;
+  new_dest_vec.allocateInterleaved(seed_topo.num_edges());
+
+  GraphTopologyTypes::PropIndexVec edge_prop_indices;
+  edge_prop_indices.allocateInterleaved(seed_topo.num_edges());
+
+  katana::do_all(
+      katana::iterate(seed_topo.all_nodes()),
+      [&](auto old_srd_id) {
+        auto new_srd_id = old_to_new_map[old_srd_id];
+        auto new_out_index = new_srd_id > 0 ? degrees[new_srd_id - 1] : 0;
+
+        for (auto e : seed_topo.edges(old_srd_id)) {
+          auto new_edge_dest = old_to_new_map[seed_topo.edge_dest(e)];
+
+          auto new_edge_id = new_out_index;
+          ++new_out_index;
+          KATANA_LOG_DEBUG_ASSERT(new_out_index <= degrees[new_srd_id]);
+
+          new_dest_vec[new_edge_id] = new_edge_dest;
+
+          // copy over edge_property_index mapping from old edge to new edge
+          edge_prop_indices[new_edge_id] = seed_topo.edge_property_index(e);
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  return std::make_unique<ShuffleTopology>(ShuffleTopology{
+      seed_topo.transpose_state(), node_sort_todo, seed_topo.edge_sort_state(),
+      std::move(degrees), std::move(node_prop_indices),
+      std::move(new_dest_vec), std::move(edge_prop_indices)});
+}
+
+std::unique_ptr<katana::ShuffleTopology>
+katana::ShuffleTopology::MakeSortedByNodeType(
+    const PropertyGraph* pg,
+    const katana::EdgeShuffleTopology& seed_topo) noexcept {
+  auto cmp = [&](const auto& i1, const auto& i2) {
+    auto k1 = pg->GetTypeOfNode(i1);
+    auto k2 = pg->GetTypeOfNode(i2);
+    if (k1 == k2) {
+      return i1 < i2;
+    }
+    return k1 < k2;
+  };
+
+  return MakeNodeSortedTopo(seed_topo, cmp, NodeSortKind::kSortedByNodeType);
+}
+
+namespace {
+
+/// The distinct types of the entities [0, num_entities), in order
+template <typename TypeFn>
+std::set<katana::EntityTypeID>
+DistinctTypes(uint64_t num_entities, const TypeFn& type_of) noexcept {
+  katana::PerThreadStorage<katana::gstl::Set<katana::EntityTypeID>> types;
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_entities),
+      [&](uint64_t i) { types.getLocal()->insert(type_of(i)); },
+      katana::no_stats());
+
+  // ordered map
+  std::set<katana::EntityTypeID> merged;
+  for (uint32_t i = 0; i < katana::activeThreads; ++i) {
+    for (auto type : *types.getRemote(i)) {
+      merged.insert(type);
+    }
+  }
+
+  // TODO(amber): introduce a per-thread-container type that frees memory
+  // correctly
+  katana::on_each([&](unsigned, unsigned) {
+    // free up memory by resetting
+    *types.getLocal() = katana::gstl::Set<katana::EntityTypeID>();
+  });
+
+  return merged;
+}
+
+}  // namespace
+
+std::unique_ptr<katana::CondensedTypeIDMap>
+katana::CondensedTypeIDMap::MakeFromEdgeTypes(
+    const katana::PropertyGraph* pg) noexcept {
+  TypeIDToIndexMap edge_type_to_index;
+  IndexToTypeIDMap edge_index_to_type;
+
+  std::set<EntityType> edge_types =
+      DistinctTypes(pg->topology().num_edges(), [pg](uint64_t e) {
+        return pg->GetTypeOfEdge(e);
+      });
+
+  // unordered map
+  uint32_t num_edge_types = 0u;
+  for (const auto& edgeType : edge_types) {
+    edge_type_to_index[edgeType] = num_edge_types++;
+    edge_index_to_type.emplace_back(edgeType);
+  }
+
+  return std::make_unique<CondensedTypeIDMap>(CondensedTypeIDMap{
+      std::move(edge_type_to_index), std::move(edge_index_to_type)});
+}
+
+std::unique_ptr<katana::CondensedTypeIDMap>
+katana::CondensedTypeIDMap::MakeFromNodeTypes(
+    const katana::PropertyGraph* pg) noexcept {
+  TypeIDToIndexMap node_type_to_index;
+  IndexToTypeIDMap node_index_to_type;
+
+  std::set<EntityType> node_types =
+      DistinctTypes(pg->topology().num_nodes(), [pg](uint64_t n) {
+        return pg->GetTypeOfNode(n);
+      });
+
+  uint32_t num_node_types = 0u;
+  for (const auto& node_type : node_types) {
+    node_type_to_index[node_type] = num_node_types++;
+    node_index_to_type.emplace_back(node_type);
+  }
+
+  return std::make_unique<CondensedTypeIDMap>(CondensedTypeIDMap{
+      std::move(node_type_to_index), std::move(node_index_to_type)});
+}
+
+template <typename Entity>
+std::unique_ptr<katana::EntityTypePartition<Entity>>
+katana::EntityTypePartition<Entity>::Make(
+    const EntityTypeManager& manager, const EntityType* entity_types,
+    size_t num_entities) noexcept {
+  const size_t num_types = manager.GetNumEntityTypes();
+
+  // The types that an entity of each most specific type has
+  std::vector<std::vector<EntityType>> types_of(num_types);
+  for (size_t x = 0; x < num_types; ++x) {
+    types_of[x].emplace_back(x);
+    if (x == katana::kUnknownEntityType) {
+      continue;
+    }
+    for (size_t t = 0; t < num_types; ++t) {
+      if (t != x && t != katana::kUnknownEntityType &&
+          manager.IsSubtypeOf(t, x)) {
+        types_of[x].emplace_back(t);
+      }
+    }
+  }
+
+  // Counting sort: count the entities of each type in each block, turn the
+  // counts into the position of each block's entities in their type's list,
+  // then place them. Blocks are placed in order, so each list is sorted.
+  constexpr size_t kEntitiesPerBlock = size_t{1} << 16;
+  const size_t num_blocks =
+      (num_entities + kEntitiesPerBlock - 1) / kEntitiesPerBlock;
+  std::vector<uint64_t> positions(num_blocks * num_types);
+  auto for_each_block = [&](const auto& fn) {
+    katana::do_all(
+        katana::iterate(size_t{0}, num_blocks),
+        [&](size_t block) {
+          uint64_t* block_positions = &positions[block * num_types];
+          size_t end =
+              std::min((block + 1) * kEntitiesPerBlock, num_entities);
+          for (size_t e = block * kEntitiesPerBlock; e < end; ++e) {
+            KATANA_LOG_DEBUG_ASSERT(entity_types[e] < num_types);
+            for (EntityType t : types_of[entity_types[e]]) {
+              fn(block_positions, t, e);
+            }
+          }
+        },
+        katana::steal(), katana::no_stats());
+  };
+
+  for_each_block([](uint64_t* block_positions, EntityType t, size_t) {
+    ++block_positions[t];
+  });
+
+  NUMAArray<uint64_t> offsets;
+  offsets.allocateInterleaved(num_types + 1);
+  uint64_t total = 0;
+  for (size_t t = 0; t < num_types; ++t) {
+    offsets[t] = total;
+    for (size_t block = 0; block < num_blocks; ++block) {
+      uint64_t count = positions[block * num_types + t];
+      positions[block * num_types + t] = total;
+      total += count;
+    }
+  }
+  offsets[num_types] = total;
+
+  NUMAArray<Entity> entities;
+  entities.allocateInterleaved(total);
+  for_each_block([&](uint64_t* block_positions, EntityType t, size_t e) {
+    entities[block_positions[t]++] = e;
+  });
+
+  return std::unique_ptr<EntityTypePartition<Entity>>(
+      new EntityTypePartition<Entity>(std::move(offsets), std::move(entities)));
+}
+
+template class katana::EntityTypePartition<katana::GraphTopologyTypes::Node>;
+template class katana::EntityTypePartition<katana::GraphTopologyTypes::Edge>;
+
+namespace {
+
+/// Build the index of the edges of each (node, type) pair of \p topo, whose
+/// edges are grouped by type_of(edge) within each node, in the index order
+/// of \p type_index
+template <typename TypeFn>
+katana::internal::PerTypeAdjIndex
+MakePerTypeAdjIndex(
+    const katana::EdgeShuffleTopology* topo,
+    const katana::CondensedTypeIDMap* type_index,
+    const TypeFn& type_of) noexcept {
+  using EntityType = katana::EntityTypeID;
+  using Edge = katana::GraphTopologyTypes::Edge;
+
+  katana::internal::PerTypeAdjIndex ret;
+  if (topo->num_nodes() == 0) {
+    KATANA_LOG_VASSERT(
+        topo->num_edges() == 0, "Found graph with edges but no nodes");
+    return ret;
+  }
+
+  if (type_index->num_unique_types() == 0) {
+    KATANA_LOG_VASSERT(
+        topo->num_edges() == 0, "Found graph with edges but no types");
+    // Graph has some nodes but no edges.
+    return ret;
+  }
+
+  const uint64_t num_nodes = topo->num_nodes();
+  const uint64_t num_types = type_index->num_unique_types();
+
+  // Edges are sorted by type within each node, so every type present at a
+  // node forms one run. Count the runs to decide which index is smaller.
+  katana::NUMAArray<uint64_t> node_runs;
+  node_runs.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(topo->all_nodes()),
+      [&](Node N) {
+        uint64_t runs = 0;
+        EntityType prev{};
+        for (auto e : topo->edges(N)) {
+          const EntityType type = type_of(e);
+          if (runs == 0 || type != prev) {
+            runs++;
+            prev = type;
+          }
+        }
+        node_runs[N] = runs;
+      },
+      katana::no_stats(), katana::steal());
+
+  katana::ParallelSTL::partial_sum(
+      node_runs.begin(), node_runs.end(), node_runs.begin());
+  const uint64_t num_runs = node_runs[num_nodes - 1];
+
+  const uint64_t dense_bytes = num_nodes * num_types * sizeof(Edge);
+  const uint64_t sparse_bytes = num_nodes * sizeof(uint64_t) +
+                                num_runs * (sizeof(uint32_t) + sizeof(Edge));
+
+  if (sparse_bytes < dense_bytes) {
+    ret.run_types.allocateInterleaved(num_runs);
+    ret.run_ends.allocateInterleaved(num_runs);
+
+    katana::do_all(
+        katana::iterate(topo->all_nodes()),
+        [&](Node N) {
+          uint64_t r = N > 0 ? node_runs[N - 1] : 0;
+          auto e_range = topo->edges(N);
+          for (auto it = e_range.begin(); it != e_range.end();) {
+            const EntityType type = type_of(*it);
+            while (it != e_range.end() && type_of(*it) == type) {
+              ++it;
+            }
+            ret.run_types[r] = type_index->GetIndex(type);
+            ret.run_ends[r] = *it;
+            KATANA_LOG_DEBUG_ASSERT(
+                r == (N > 0 ? node_runs[N - 1] : 0) ||
+                ret.run_types[r - 1] < ret.run_types[r]);
+            r++;
+          }
+          KATANA_LOG_DEBUG_ASSERT(r == node_runs[N]);
+        },
+        katana::no_stats(), katana::steal());
+
+    ret.node_runs = std::move(node_runs);
+    return ret;
+  }
+
+  auto& adj_indices = ret.dense;
+  adj_indices.allocateInterleaved(num_nodes * num_types);
 
   katana::do_all(
-      katana::iterate(e_topo->all_nodes()),
+      katana::iterate(topo->all_nodes()),
       [&](Node N) {
-        auto offset = N * edge_type_index->num_unique_types();
+        auto offset = N * num_types;
         uint32_t index = 0;
-        for (auto e : e_topo->edges(N)) {
-          // Since we sort the edges, we must use the
-          // edge_property_index because EdgeShuffleTopology rearranges the edges
-          const auto type = pg->GetTypeOfEdge(e_topo->edge_property_index(e));
-          while (type != edge_type_index->GetType(index)) {
+        for (auto e : topo->edges(N)) {
+          const EntityType type = type_of(e);
+          while (type != type_index->GetType(index)) {
             adj_indices[offset + index] = e;
             index++;
-            KATANA_LOG_DEBUG_ASSERT(
-                index < edge_type_index->num_unique_types());
+            KATANA_LOG_DEBUG_ASSERT(index < num_types);
           }
         }
-        auto e = *e_topo->edges(N).end();
-        while (index < edge_type_index->num_unique_types()) {
+        auto e = *topo->edges(N).end();
+        while (index < num_types) {
           adj_indices[offset + index] = e;
           index++;
         }
       },
       katana::no_stats(), katana::steal());
 
-  return adj_indices;
+  return ret;
+}
+
+}  // namespace
+
+katana::EdgeTypeAwareTopology::PerTypeAdjIndex
+katana::EdgeTypeAwareTopology::CreatePerEdgeTypeAdjacencyIndex(
+    const PropertyGraph* pg, const CondensedTypeIDMap* edge_type_index,
+    const EdgeShuffleTopology* e_topo) noexcept {
+  // Since we sort the edges, we must use the edge_property_index because
+  // EdgeShuffleTopology rearranges the edges
+  return MakePerTypeAdjIndex(e_topo, edge_type_index, [&](Edge e) {
+    return pg->GetTypeOfEdge(e_topo->edge_property_index(e));
+  });
 }
 
 std::unique_ptr<katana::EdgeTypeAwareTopology>
@@ -428,11 +1567,617 @@ katana::EdgeTypeAwareTopology::MakeFrom(
 
   KATANA_LOG_DEBUG_ASSERT(e_topo->num_edges() == pg->topology().num_edges());
 
-  AdjIndexVec per_type_adj_indices =
+  PerTypeAdjIndex per_type_adj_index =
       CreatePerEdgeTypeAdjacencyIndex(pg, edge_type_index, e_topo);
 
   return std::make_unique<EdgeTypeAwareTopology>(EdgeTypeAwareTopology{
-      pg, edge_type_index, e_topo, std::move(per_type_adj_indices)});
+      pg, edge_type_index, e_topo, std::move(per_type_adj_index)});
+}
+
+katana::DestTypeAwareTopology::PerTypeAdjIndex
+katana::DestTypeAwareTopology::CreatePerDestTypeAdjacencyIndex(
+    const PropertyGraph* pg, const CondensedTypeIDMap* node_type_index,
+    const EdgeShuffleTopology* e_topo) noexcept {
+  // Destinations are nodes of the PropertyGraph since an EdgeShuffleTopology
+  // does not renumber nodes
+  return MakePerTypeAdjIndex(e_topo, node_type_index, [&](Edge e) {
+    return pg->GetTypeOfNode(e_topo->edge_dest(e));
+  });
+}
+
+std::unique_ptr<katana::DestTypeAwareTopology>
+katana::DestTypeAwareTopology::MakeFrom(
+    const katana::PropertyGraph* pg,
+    const katana::CondensedTypeIDMap* node_type_index,
+    const katana::EdgeShuffleTopology* e_topo) noexcept {
+  KATANA_LOG_DEBUG_ASSERT(e_topo->has_edges_sorted_by(
+      EdgeShuffleTopology::EdgeSortKind::kSortedByNodeType));
+
+  KATANA_LOG_DEBUG_ASSERT(e_topo->num_edges() == pg->topology().num_edges());
+
+  PerTypeAdjIndex per_type_adj_index =
+      CreatePerDestTypeAdjacencyIndex(pg, node_type_index, e_topo);
+
+  return std::make_unique<DestTypeAwareTopology>(DestTypeAwareTopology{
+      node_type_index, e_topo, std::move(per_type_adj_index)});
+}
+
+namespace {
+
+size_t
+DefaultViewCacheBudget() {
+  int mb = 0;
+  if (katana::GetEnv("KATANA_VIEW_CACHE_MB", &mb) && mb > 0) {
+    return static_cast<size_t>(mb) << 20;
+  }
+  return katana::PGViewCache::kUnlimitedBudget;
+}
+
+size_t
+ApproxBytes(const katana::EdgeShuffleTopology& topo) {
+  using T = katana::GraphTopologyTypes;
+  return topo.num_nodes() * sizeof(T::Edge) +
+         topo.num_edges() * (sizeof(T::Node) + sizeof(T::PropertyIndex)) +
+         topo.hub_index_bytes();
+}
+
+/// Build a hub index on \p topo if KATANA_HUB_INDEX_MIN_DEGREE is set. The
+/// index is limited to the size of the topology's destination array.
+void
+MaybeBuildHubIndex(katana::EdgeShuffleTopology* topo) {
+  int min_degree = 0;
+  if (!katana::GetEnv("KATANA_HUB_INDEX_MIN_DEGREE", &min_degree) ||
+      min_degree <= 0 ||
+      !topo->has_edges_sorted_by(
+          katana::EdgeShuffleTopology::EdgeSortKind::kSortedByDestID)) {
+    return;
+  }
+  topo->BuildHubIndex(
+      min_degree,
+      topo->num_edges() * sizeof(katana::GraphTopologyTypes::Node));
+}
+
+size_t
+ApproxBytes(const katana::ShuffleTopology& topo) {
+  using T = katana::GraphTopologyTypes;
+  return ApproxBytes(static_cast<const katana::EdgeShuffleTopology&>(topo)) +
+         topo.num_nodes() * sizeof(T::PropertyIndex);
+}
+
+size_t
+ApproxBytes(const katana::CompactTopology<uint32_t>& topo) {
+  return topo.num_nodes() * sizeof(uint32_t) +
+         topo.num_edges() * (sizeof(uint32_t) + sizeof(uint32_t));
+}
+
+size_t
+ApproxBytes(const katana::EdgeTypeAwareTopology& topo) {
+  // The edge shuffled topology it wraps is accounted for separately
+  return topo.per_type_index_bytes();
+}
+
+size_t
+ApproxBytes(const katana::DestTypeAwareTopology& topo) {
+  return topo.per_type_index_bytes();
+}
+
+size_t
+ApproxBytes(const arrow::ArrayData& data) {
+  size_t bytes = 0;
+  for (const auto& buffer : data.buffers) {
+    if (buffer) {
+      bytes += buffer->size();
+    }
+  }
+  for (const auto& child : data.child_data) {
+    bytes += ApproxBytes(*child);
+  }
+  return bytes;
+}
+
+/// out[e] = in[indices[e]] for every edge e
+template <typename T, typename Index>
+void
+GatherAs(
+    const uint8_t* in_bytes, uint8_t* out_bytes, const Index* indices,
+    uint64_t num_edges) {
+  const T* in = reinterpret_cast<const T*>(in_bytes);
+  T* out = reinterpret_cast<T*>(out_bytes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t e) { out[e] = in[indices[e]]; }, katana::no_stats(),
+      katana::loopname("GatherEdgeProperty"));
+}
+
+/// Gather \p values of a fixed width type of whole bytes without nulls,
+/// copying whole values
+template <typename Index>
+katana::Result<std::shared_ptr<arrow::Array>>
+GatherFixedWidth(
+    const arrow::Array& values, const Index* indices, uint64_t num_edges) {
+  const auto& type = static_cast<const arrow::FixedWidthType&>(*values.type());
+  size_t width = type.bit_width() / 8;
+  std::shared_ptr<arrow::Buffer> buffer =
+      KATANA_CHECKED(arrow::AllocateBuffer(num_edges * width));
+  const uint8_t* in = values.data()->buffers[1]->data() +
+                      static_cast<size_t>(values.offset()) * width;
+  uint8_t* out = buffer->mutable_data();
+
+  switch (width) {
+  case 1:
+    GatherAs<uint8_t>(in, out, indices, num_edges);
+    break;
+  case 2:
+    GatherAs<uint16_t>(in, out, indices, num_edges);
+    break;
+  case 4:
+    GatherAs<uint32_t>(in, out, indices, num_edges);
+    break;
+  case 8:
+    GatherAs<uint64_t>(in, out, indices, num_edges);
+    break;
+  default:
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_edges),
+        [&](uint64_t e) {
+          std::memcpy(out + e * width, in + indices[e] * width, width);
+        },
+        katana::no_stats(), katana::loopname("GatherEdgeProperty"));
+  }
+
+  return arrow::MakeArray(arrow::ArrayData::Make(
+      values.type(), num_edges, {nullptr, std::move(buffer)}, 0));
+}
+
+/// The values of \p column in \p order. Primitive values are copied by a
+/// parallel loop; booleans, values with nulls and nested or variable width
+/// values are left to arrow's Take.
+katana::Result<std::shared_ptr<arrow::Array>>
+GatherInOrder(
+    const std::shared_ptr<arrow::ChunkedArray>& column,
+    const katana::EdgeOrder& order) {
+  // Random reads need one array rather than chunks
+  std::shared_ptr<arrow::Array> values =
+      KATANA_CHECKED(katana::CombinedArray(column));
+  uint64_t num_edges = order.num_edges();
+
+  const auto* fixed_width =
+      dynamic_cast<const arrow::FixedWidthType*>(values->type().get());
+  if (fixed_width && fixed_width->bit_width() % 8 == 0 &&
+      values->null_count() == 0) {
+    if (order.wide_indices()) {
+      return GatherFixedWidth(*values, order.wide_indices(), num_edges);
+    }
+    return GatherFixedWidth(*values, order.narrow_indices(), num_edges);
+  }
+
+  std::shared_ptr<arrow::Array> indices;
+  if (order.wide_indices()) {
+    indices = std::make_shared<arrow::UInt64Array>(
+        num_edges, arrow::Buffer::Wrap(order.wide_indices(), num_edges));
+  } else {
+    indices = std::make_shared<arrow::UInt32Array>(
+        num_edges, arrow::Buffer::Wrap(order.narrow_indices(), num_edges));
+  }
+  return KATANA_CHECKED(arrow::compute::Take(*values, *indices));
+}
+
+template <typename T>
+bool
+IsReady(const std::shared_future<T>& fut) {
+  return fut.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+/// Consider the entries of \p entries for eviction: those that are built and
+/// that only the cache refers to. If one was used less recently than
+/// \p oldest, \p evict is set to remove it.
+template <typename Entry>
+void
+FindEvictionCandidate(
+    std::vector<Entry>* entries, size_t* cached_bytes, uint64_t* oldest,
+    std::function<std::shared_ptr<const void>()>* evict) {
+  for (size_t i = 0; i < entries->size(); ++i) {
+    const Entry& entry = (*entries)[i];
+    if (!IsReady(entry.topo) || entry.topo.get().use_count() > 1 ||
+        entry.last_use >= *oldest) {
+      continue;
+    }
+    *oldest = entry.last_use;
+    *evict = [entries, cached_bytes, i]() -> std::shared_ptr<const void> {
+      std::shared_ptr<const void> topo = (*entries)[i].topo.get();
+      *cached_bytes -= (*entries)[i].bytes;
+      entries->erase(entries->begin() + i);
+      return topo;
+    };
+  }
+}
+
+/// Like FindEvictionCandidate, for entries built by the caller that asked
+/// for them, whose shared value is value_of(entry)
+template <typename Entry, typename ValueOf>
+void
+FindUnusedCandidate(
+    std::vector<Entry>* entries, size_t* cached_bytes, uint64_t* oldest,
+    std::function<std::shared_ptr<const void>()>* evict,
+    const ValueOf& value_of) {
+  for (size_t i = 0; i < entries->size(); ++i) {
+    const Entry& entry = (*entries)[i];
+    if (value_of(entry).use_count() > 1 || entry.last_use >= *oldest) {
+      continue;
+    }
+    *oldest = entry.last_use;
+    *evict = [entries, cached_bytes, i,
+              value_of]() -> std::shared_ptr<const void> {
+      std::shared_ptr<const void> value = value_of((*entries)[i]);
+      *cached_bytes -= (*entries)[i].bytes;
+      entries->erase(entries->begin() + i);
+      return value;
+    };
+  }
+}
+
+}  // namespace
+
+katana::PGViewCache::PGViewCache() noexcept
+    : byte_budget_(DefaultViewCacheBudget()) {}
+
+katana::PGViewCache::PGViewCache(PGViewCache&& other) noexcept
+    : edge_shuff_topos_(std::move(other.edge_shuff_topos_)),
+      fully_shuff_topos_(std::move(other.fully_shuff_topos_)),
+      edge_type_aware_topos_(std::move(other.edge_type_aware_topos_)),
+      dest_type_aware_topos_(std::move(other.dest_type_aware_topos_)),
+      undirected_topos_(std::move(other.undirected_topos_)),
+      compact_topos_(std::move(other.compact_topos_)),
+      ordered_edge_props_(std::move(other.ordered_edge_props_)),
+      temporal_indexes_(std::move(other.temporal_indexes_)),
+      edge_type_id_map_(std::move(other.edge_type_id_map_)),
+      node_type_id_map_(std::move(other.node_type_id_map_)),
+      node_type_partition_(std::move(other.node_type_partition_)),
+      edge_type_partition_(std::move(other.edge_type_partition_)),
+      graph_profile_(std::move(other.graph_profile_)),
+      byte_budget_(other.byte_budget_),
+      cached_bytes_(std::exchange(other.cached_bytes_, 0)),
+      clock_(other.clock_) {}
+
+katana::PGViewCache&
+katana::PGViewCache::operator=(PGViewCache&& other) noexcept {
+  edge_shuff_topos_ = std::move(other.edge_shuff_topos_);
+  fully_shuff_topos_ = std::move(other.fully_shuff_topos_);
+  edge_type_aware_topos_ = std::move(other.edge_type_aware_topos_);
+  dest_type_aware_topos_ = std::move(other.dest_type_aware_topos_);
+  undirected_topos_ = std::move(other.undirected_topos_);
+  compact_topos_ = std::move(other.compact_topos_);
+  ordered_edge_props_ = std::move(other.ordered_edge_props_);
+  temporal_indexes_ = std::move(other.temporal_indexes_);
+  edge_type_id_map_ = std::move(other.edge_type_id_map_);
+  node_type_id_map_ = std::move(other.node_type_id_map_);
+  node_type_partition_ = std::move(other.node_type_partition_);
+  edge_type_partition_ = std::move(other.edge_type_partition_);
+  graph_profile_ = std::move(other.graph_profile_);
+  byte_budget_ = other.byte_budget_;
+  cached_bytes_ = std::exchange(other.cached_bytes_, 0);
+  clock_ = other.clock_;
+  return *this;
+}
+
+size_t
+katana::PGViewCache::byte_budget() const noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return byte_budget_;
+}
+
+void
+katana::PGViewCache::set_byte_budget(size_t bytes) noexcept {
+  std::vector<std::shared_ptr<const void>> evicted;
+  std::lock_guard<std::mutex> lock(mutex_);
+  byte_budget_ = bytes;
+  evicted = EvictLocked();
+}
+
+size_t
+katana::PGViewCache::cached_bytes() const noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return cached_bytes_;
+}
+
+std::shared_ptr<const katana::NodeTypePartition>
+katana::PGViewCache::BuildOrGetNodeTypePartition(
+    const katana::PropertyGraph* pg) noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!node_type_partition_) {
+    // Like the edge type index, cheap enough to build under the lock
+    node_type_partition_ = NodeTypePartition::Make(
+        pg->GetNodeTypeManager(), pg->node_type_data(), pg->num_nodes());
+  }
+  return node_type_partition_;
+}
+
+std::shared_ptr<const katana::EdgeTypePartition>
+katana::PGViewCache::BuildOrGetEdgeTypePartition(
+    const katana::PropertyGraph* pg) noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!edge_type_partition_) {
+    edge_type_partition_ = EdgeTypePartition::Make(
+        pg->GetEdgeTypeManager(), pg->edge_type_data(), pg->num_edges());
+  }
+  return edge_type_partition_;
+}
+
+std::shared_ptr<const katana::GraphProfile>
+katana::PGViewCache::BuildOrGetGraphProfile(
+    const katana::PropertyGraph* pg) noexcept {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (graph_profile_) {
+      return graph_profile_;
+    }
+  }
+  // Built without the lock since it reads every edge; if two threads race,
+  // both profiles are the same and the first one stored wins
+  auto profile = std::make_shared<const GraphProfile>(
+      GraphProfile::Make(*GetOriginalTopology(pg)));
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!graph_profile_) {
+    graph_profile_ = std::move(profile);
+  }
+  return graph_profile_;
+}
+
+void
+katana::PGViewCache::DropTypePartitions() noexcept {
+  std::shared_ptr<NodeTypePartition> node_type_partition;
+  std::shared_ptr<EdgeTypePartition> edge_type_partition;
+  std::lock_guard<std::mutex> lock(mutex_);
+  // Freed after releasing the lock
+  node_type_partition = std::move(node_type_partition_);
+  edge_type_partition = std::move(edge_type_partition_);
+}
+
+std::vector<std::shared_ptr<const void>>
+katana::PGViewCache::EvictLocked() noexcept {
+  std::vector<std::shared_ptr<const void>> evicted;
+  while (cached_bytes_ > byte_budget_) {
+    uint64_t oldest = UINT64_MAX;
+    std::function<std::shared_ptr<const void>()> evict;
+    FindEvictionCandidate(
+        &edge_shuff_topos_, &cached_bytes_, &oldest, &evict);
+    FindEvictionCandidate(
+        &fully_shuff_topos_, &cached_bytes_, &oldest, &evict);
+    FindEvictionCandidate(
+        &edge_type_aware_topos_, &cached_bytes_, &oldest, &evict);
+    FindEvictionCandidate(
+        &dest_type_aware_topos_, &cached_bytes_, &oldest, &evict);
+    FindEvictionCandidate(
+        &undirected_topos_, &cached_bytes_, &oldest, &evict);
+    FindEvictionCandidate(&compact_topos_, &cached_bytes_, &oldest, &evict);
+    FindUnusedCandidate(
+        &ordered_edge_props_, &cached_bytes_, &oldest, &evict,
+        [](const OrderedEdgeProperty& entry) { return entry.values; });
+    FindUnusedCandidate(
+        &temporal_indexes_, &cached_bytes_, &oldest, &evict,
+        [](const TemporalIndexEntry& entry) { return entry.index; });
+    if (!evict) {
+      KATANA_LOG_DEBUG(
+          "view cache over budget ({} > {} bytes) but every entry is in use",
+          cached_bytes_, byte_budget_);
+      break;
+    }
+    evicted.emplace_back(evict());
+  }
+  return evicted;
+}
+
+template <typename Topo, typename Matches, typename Build>
+std::shared_ptr<Topo>
+katana::PGViewCache::FindOrBuild(
+    std::vector<CacheEntry<Topo>>* entries, const CacheEntry<Topo>& key,
+    const Matches& matches, const Build& build) noexcept {
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (auto it = entries->begin(); it != entries->end();) {
+    if (!IsReady(it->topo)) {
+      if (it->tpose_kind == key.tpose_kind &&
+          it->edge_sort_kind == key.edge_sort_kind &&
+          it->node_sort_kind == key.node_sort_kind) {
+        // Someone else is building it; wait without holding the lock
+        it->last_use = ++clock_;
+        auto pending = it->topo;
+        lock.unlock();
+        return pending.get();
+      }
+      ++it;
+      continue;
+    }
+    const std::shared_ptr<Topo>& topo = it->topo.get();
+    if (!topo->is_valid()) {
+      cached_bytes_ -= it->bytes;
+      it = entries->erase(it);
+      continue;
+    }
+    if (matches(*topo)) {
+      it->last_use = ++clock_;
+      return topo;
+    }
+    ++it;
+  }
+
+  std::promise<std::shared_ptr<Topo>> promise;
+  CacheEntry<Topo> entry = key;
+  entry.topo = promise.get_future().share();
+  entry.id = ++clock_;
+  entry.last_use = entry.id;
+  uint64_t id = entry.id;
+  entries->emplace_back(std::move(entry));
+  lock.unlock();
+
+  std::shared_ptr<Topo> topo;
+  {
+    MemoryCategoryScope memory_category(MemoryCategory::kViews);
+    topo = build();
+  }
+  size_t bytes = ApproxBytes(*topo);
+  promise.set_value(topo);
+
+  std::vector<std::shared_ptr<const void>> evicted;
+  lock.lock();
+  auto it = std::find_if(
+      entries->begin(), entries->end(),
+      [&](const CacheEntry<Topo>& e) { return e.id == id; });
+  if (it != entries->end()) {
+    it->bytes = bytes;
+    cached_bytes_ += bytes;
+  }
+  // topo is referenced here, so it cannot be evicted itself
+  evicted = EvictLocked();
+  lock.unlock();
+
+  return topo;
+}
+
+katana::Result<std::shared_ptr<arrow::Array>>
+katana::PGViewCache::BuildOrGetEdgePropertyInOrder(
+    const PropertyGraph* pg, const EdgeOrder& order,
+    const std::string& name) noexcept {
+  std::shared_ptr<arrow::ChunkedArray> column =
+      KATANA_CHECKED(pg->GetEdgeProperty(name));
+  if (order.is_original()) {
+    // Already in order, so there is nothing to gather or cache
+    return katana::CombinedArray(column);
+  }
+  if (order.num_rows() != static_cast<uint64_t>(column->length())) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "edge order is of {} edges but edge property {} has {} values",
+        order.num_rows(), std::quoted(name), column->length());
+  }
+
+  auto same_order = [&](const OrderedEdgeProperty& entry) {
+    return !entry.order.owner_before(order.topology()) &&
+           !order.topology().owner_before(entry.order);
+  };
+  // Finds the entry for these values, dropping stale entries on the way.
+  // Dropped values go to *dropped, to be freed after releasing mutex_.
+  auto find_locked = [&](std::vector<std::shared_ptr<const void>>* dropped)
+      -> std::shared_ptr<arrow::Array> {
+    for (auto it = ordered_edge_props_.begin();
+         it != ordered_edge_props_.end();) {
+      if (it->order.expired() || it->column.expired()) {
+        cached_bytes_ -= it->bytes;
+        dropped->emplace_back(std::move(it->values));
+        it = ordered_edge_props_.erase(it);
+        continue;
+      }
+      if (it->name == name && it->column.lock() == column && same_order(*it)) {
+        it->last_use = ++clock_;
+        return it->values;
+      }
+      ++it;
+    }
+    return nullptr;
+  };
+
+  {
+    std::vector<std::shared_ptr<const void>> dropped;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (auto values = find_locked(&dropped)) {
+      return values;
+    }
+  }
+
+  std::shared_ptr<arrow::Array> values;
+  {
+    MemoryCategoryScope memory_category(MemoryCategory::kViews);
+    values = KATANA_CHECKED_CONTEXT(
+        GatherInOrder(column, order), "gathering edge property {}",
+        std::quoted(name));
+  }
+  size_t bytes = ApproxBytes(*values->data());
+
+  std::vector<std::shared_ptr<const void>> dropped;
+  std::lock_guard<std::mutex> lock(mutex_);
+  // Another thread may have gathered the same values meanwhile
+  if (auto cached = find_locked(&dropped)) {
+    return cached;
+  }
+  ordered_edge_props_.emplace_back(OrderedEdgeProperty{
+      .order = order.topology(),
+      .column = column,
+      .name = name,
+      .values = values,
+      .last_use = ++clock_,
+      .bytes = bytes,
+  });
+  cached_bytes_ += bytes;
+  // values is referenced here, so it cannot be evicted itself
+  for (auto& evicted : EvictLocked()) {
+    dropped.emplace_back(std::move(evicted));
+  }
+  return values;
+}
+
+katana::Result<std::shared_ptr<const katana::TemporalEdgeIndex>>
+katana::PGViewCache::BuildOrGetTemporalEdgeIndex(
+    const PropertyGraph* pg, const std::string& timestamp_property,
+    EdgeShuffleTopology::TransposeKind tpose_kind) noexcept {
+  std::shared_ptr<arrow::ChunkedArray> column =
+      KATANA_CHECKED(pg->GetEdgeProperty(timestamp_property));
+
+  // Finds the index, dropping those of replaced columns on the way. Dropped
+  // indexes go to *dropped, to be freed after releasing mutex_.
+  auto find_locked = [&](std::vector<std::shared_ptr<const void>>* dropped)
+      -> std::shared_ptr<const TemporalEdgeIndex> {
+    for (auto it = temporal_indexes_.begin(); it != temporal_indexes_.end();) {
+      if (it->column.expired()) {
+        cached_bytes_ -= it->bytes;
+        dropped->emplace_back(std::move(it->index));
+        it = temporal_indexes_.erase(it);
+        continue;
+      }
+      if (it->name == timestamp_property && it->tpose_kind == tpose_kind &&
+          it->column.lock() == column) {
+        it->last_use = ++clock_;
+        return it->index;
+      }
+      ++it;
+    }
+    return nullptr;
+  };
+
+  {
+    std::vector<std::shared_ptr<const void>> dropped;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (auto index = find_locked(&dropped)) {
+      return index;
+    }
+  }
+
+  std::shared_ptr<const TemporalEdgeIndex> index;
+  {
+    MemoryCategoryScope memory_category(MemoryCategory::kViews);
+    index = KATANA_CHECKED(
+        TemporalEdgeIndex::Make(pg, timestamp_property, tpose_kind));
+  }
+  size_t bytes = index->bytes();
+
+  std::vector<std::shared_ptr<const void>> dropped;
+  std::lock_guard<std::mutex> lock(mutex_);
+  // Another thread may have built the same index meanwhile
+  if (auto cached = find_locked(&dropped)) {
+    return cached;
+  }
+  temporal_indexes_.emplace_back(TemporalIndexEntry{
+      .name = timestamp_property,
+      .tpose_kind = tpose_kind,
+      .column = column,
+      .index = index,
+      .last_use = ++clock_,
+      .bytes = bytes,
+  });
+  cached_bytes_ += bytes;
+  // index is referenced here, so it cannot be evicted itself
+  for (auto& evicted : EvictLocked()) {
+    dropped.emplace_back(std::move(evicted));
+  }
+  return index;
 }
 
 const katana::GraphTopology*
@@ -441,18 +2186,34 @@ katana::PGViewCache::GetOriginalTopology(
   return &pg->topology();
 }
 
-katana::CondensedTypeIDMap*
+std::shared_ptr<katana::CondensedTypeIDMap>
 katana::PGViewCache::BuildOrGetEdgeTypeIndex(
     const katana::PropertyGraph* pg) noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
   if (edge_type_id_map_ && edge_type_id_map_->is_valid()) {
-    return edge_type_id_map_.get();
+    return edge_type_id_map_;
   }
 
+  // Building the index is cheap compared to the topologies, so it is built
+  // under the lock
   edge_type_id_map_ = CondensedTypeIDMap::MakeFromEdgeTypes(pg);
   KATANA_LOG_DEBUG_ASSERT(edge_type_id_map_);
-  return edge_type_id_map_.get();
+  return edge_type_id_map_;
 };
 
+std::shared_ptr<katana::CondensedTypeIDMap>
+katana::PGViewCache::BuildOrGetNodeTypeIndex(
+    const katana::PropertyGraph* pg) noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (node_type_id_map_ && node_type_id_map_->is_valid()) {
+    return node_type_id_map_;
+  }
+
+  node_type_id_map_ = CondensedTypeIDMap::MakeFromNodeTypes(pg);
+  KATANA_LOG_DEBUG_ASSERT(node_type_id_map_);
+  return node_type_id_map_;
+}
+
 template <typename Topo>
 [[maybe_unused]] bool
 CheckTopology(const katana::PropertyGraph* pg, const Topo* t) noexcept {
@@ -460,83 +2221,214 @@ CheckTopology(const katana::PropertyGraph* pg, const Topo* t) noexcept {
          (pg->num_edges() == t->num_edges());
 }
 
-katana::EdgeShuffleTopology*
+std::shared_ptr<katana::EdgeShuffleTopology>
 katana::PGViewCache::BuildOrGetEdgeShuffTopo(
     const katana::PropertyGraph* pg,
     const katana::EdgeShuffleTopology::TransposeKind& tpose_kind,
     const katana::EdgeShuffleTopology::EdgeSortKind& sort_kind) noexcept {
-  auto pred = [&](const auto& topo_ptr) {
-    return topo_ptr->is_valid() && topo_ptr->has_transpose_state(tpose_kind) &&
-           topo_ptr->has_edges_sorted_by(sort_kind);
+  auto matches = [&](const EdgeShuffleTopology& topo) {
+    return topo.has_transpose_state(tpose_kind) &&
+           topo.has_edges_sorted_by(sort_kind);
+  };
+  auto build = [&]() -> std::shared_ptr<EdgeShuffleTopology> {
+    // Prefer a copy stored with the graph over rebuilding it
+    auto load_res = pg->LoadDerivedTopology(tpose_kind, sort_kind);
+    if (!load_res) {
+      KATANA_LOG_WARN(
+          "rebuilding derived topology, loading it failed: {}",
+          load_res.error());
+    }
+    std::shared_ptr<EdgeShuffleTopology> topo;
+    if (load_res && load_res.value()) {
+      topo = std::move(load_res.value());
+    } else {
+      topo = EdgeShuffleTopology::Make(pg, tpose_kind, sort_kind);
+    }
+    MaybeBuildHubIndex(topo.get());
+    return topo;
   };
-  auto it =
-      std::find_if(edge_shuff_topos_.begin(), edge_shuff_topos_.end(), pred);
 
-  if (it != edge_shuff_topos_.end()) {
-    KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, it->get()));
-    return it->get();
-  } else {
-    edge_shuff_topos_.emplace_back(
-        EdgeShuffleTopology::Make(pg, tpose_kind, sort_kind));
-    KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, edge_shuff_topos_.back().get()));
-    return edge_shuff_topos_.back().get();
+  auto topo = FindOrBuild(
+      &edge_shuff_topos_,
+      CacheEntry<EdgeShuffleTopology>{
+          .tpose_kind = tpose_kind,
+          .edge_sort_kind = sort_kind,
+          .node_sort_kind = ShuffleTopology::NodeSortKind::kAny,
+      },
+      matches, build);
+  KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, topo.get()));
+  return topo;
+}
+
+std::vector<std::shared_ptr<const katana::EdgeShuffleTopology>>
+katana::PGViewCache::GetEdgeShuffTopos() const noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<std::shared_ptr<const EdgeShuffleTopology>> ret;
+  for (const auto& entry : edge_shuff_topos_) {
+    if (IsReady(entry.topo) && entry.topo.get()->is_valid()) {
+      ret.emplace_back(entry.topo.get());
+    }
   }
+  return ret;
 }
 
-katana::ShuffleTopology*
+std::shared_ptr<katana::ShuffleTopology>
 katana::PGViewCache::BuildOrGetShuffTopo(
     const katana::PropertyGraph* pg,
     const katana::EdgeShuffleTopology::TransposeKind& tpose_kind,
     const katana::ShuffleTopology::NodeSortKind& node_sort_todo,
     const katana::EdgeShuffleTopology::EdgeSortKind& edge_sort_todo) noexcept {
-  auto pred = [&](const auto& topo_ptr) {
-    return topo_ptr->is_valid() && topo_ptr->has_transpose_state(tpose_kind) &&
-           topo_ptr->has_edges_sorted_by(edge_sort_todo) &&
-           topo_ptr->has_nodes_sorted_by(node_sort_todo);
+  auto matches = [&](const ShuffleTopology& topo) {
+    return topo.has_transpose_state(tpose_kind) &&
+           topo.has_edges_sorted_by(edge_sort_todo) &&
+           topo.has_nodes_sorted_by(node_sort_todo);
   };
-
-  auto it =
-      std::find_if(fully_shuff_topos_.begin(), fully_shuff_topos_.end(), pred);
-
-  if (it != fully_shuff_topos_.end()) {
-    KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, it->get()));
-    return it->get();
-  } else {
+  auto build = [&]() -> std::shared_ptr<ShuffleTopology> {
     auto e_topo = BuildOrGetEdgeShuffTopo(pg, tpose_kind, edge_sort_todo);
     KATANA_LOG_DEBUG_ASSERT(e_topo->has_transpose_state(tpose_kind));
+    std::shared_ptr<ShuffleTopology> topo = ShuffleTopology::MakeFromTopo(
+        pg, *e_topo, node_sort_todo, edge_sort_todo);
+    MaybeBuildHubIndex(topo.get());
+    return topo;
+  };
 
-    fully_shuff_topos_.emplace_back(ShuffleTopology::MakeFromTopo(
-        pg, *e_topo, node_sort_todo, edge_sort_todo));
-
-    KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, fully_shuff_topos_.back().get()));
-    return fully_shuff_topos_.back().get();
-  }
+  auto topo = FindOrBuild(
+      &fully_shuff_topos_,
+      CacheEntry<ShuffleTopology>{
+          .tpose_kind = tpose_kind,
+          .edge_sort_kind = edge_sort_todo,
+          .node_sort_kind = node_sort_todo,
+      },
+      matches, build);
+  KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, topo.get()));
+  return topo;
 }
 
-katana::EdgeTypeAwareTopology*
+std::shared_ptr<katana::EdgeTypeAwareTopology>
 katana::PGViewCache::BuildOrGetEdgeTypeAwareTopo(
     const katana::PropertyGraph* pg,
     const katana::EdgeShuffleTopology::TransposeKind& tpose_kind) noexcept {
-  auto pred = [&](const auto& topo_ptr) {
-    return topo_ptr->is_valid() && topo_ptr->has_transpose_state(tpose_kind);
+  auto matches = [&](const EdgeTypeAwareTopology& topo) {
+    return topo.has_transpose_state(tpose_kind);
   };
-  auto it = std::find_if(
-      edge_type_aware_topos_.begin(), edge_type_aware_topos_.end(), pred);
-
-  if (it != edge_type_aware_topos_.end()) {
-    KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, it->get()));
-    return it->get();
-  } else {
+  auto build = [&]() -> std::shared_ptr<EdgeTypeAwareTopology> {
     auto sorted_topo = BuildOrGetEdgeShuffTopo(
         pg, tpose_kind, EdgeShuffleTopology::EdgeSortKind::kSortedByEdgeType);
     auto edge_type_index = BuildOrGetEdgeTypeIndex(pg);
-    edge_type_aware_topos_.emplace_back(
-        EdgeTypeAwareTopology::MakeFrom(pg, edge_type_index, sorted_topo));
+    // The result points into both; keep them alive for as long as it is
+    return std::shared_ptr<EdgeTypeAwareTopology>(
+        EdgeTypeAwareTopology::MakeFrom(
+            pg, edge_type_index.get(), sorted_topo.get())
+            .release(),
+        [sorted_topo, edge_type_index](EdgeTypeAwareTopology* topo) {
+          delete topo;
+        });
+  };
+
+  auto topo = FindOrBuild(
+      &edge_type_aware_topos_,
+      CacheEntry<EdgeTypeAwareTopology>{
+          .tpose_kind = tpose_kind,
+          .edge_sort_kind =
+              EdgeShuffleTopology::EdgeSortKind::kSortedByEdgeType,
+          .node_sort_kind = ShuffleTopology::NodeSortKind::kAny,
+      },
+      matches, build);
+  KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, topo.get()));
+  return topo;
+}
 
-    KATANA_LOG_DEBUG_ASSERT(
-        CheckTopology(pg, edge_type_aware_topos_.back().get()));
-    return edge_type_aware_topos_.back().get();
+std::shared_ptr<katana::DestTypeAwareTopology>
+katana::PGViewCache::BuildOrGetDestTypeAwareTopo(
+    const katana::PropertyGraph* pg,
+    const katana::EdgeShuffleTopology::TransposeKind& tpose_kind) noexcept {
+  auto matches = [&](const DestTypeAwareTopology& topo) {
+    return topo.has_transpose_state(tpose_kind);
+  };
+  auto build = [&]() -> std::shared_ptr<DestTypeAwareTopology> {
+    auto sorted_topo = BuildOrGetEdgeShuffTopo(
+        pg, tpose_kind, EdgeShuffleTopology::EdgeSortKind::kSortedByNodeType);
+    auto node_type_index = BuildOrGetNodeTypeIndex(pg);
+    // The result points into both; keep them alive for as long as it is
+    return std::shared_ptr<DestTypeAwareTopology>(
+        DestTypeAwareTopology::MakeFrom(
+            pg, node_type_index.get(), sorted_topo.get())
+            .release(),
+        [sorted_topo, node_type_index](DestTypeAwareTopology* topo) {
+          delete topo;
+        });
+  };
+
+  auto topo = FindOrBuild(
+      &dest_type_aware_topos_,
+      CacheEntry<DestTypeAwareTopology>{
+          .tpose_kind = tpose_kind,
+          .edge_sort_kind =
+              EdgeShuffleTopology::EdgeSortKind::kSortedByNodeType,
+          .node_sort_kind = ShuffleTopology::NodeSortKind::kAny,
+      },
+      matches, build);
+  KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, topo.get()));
+  return topo;
+}
+
+std::shared_ptr<katana::EdgeShuffleTopology>
+katana::PGViewCache::BuildOrGetUndirectedTopo(
+    const katana::PropertyGraph* pg) noexcept {
+  auto matches = [](const EdgeShuffleTopology&) { return true; };
+  auto build = [&]() -> std::shared_ptr<EdgeShuffleTopology> {
+    auto in_topo = BuildOrGetEdgeShuffTopo(
+        pg, EdgeShuffleTopology::TransposeKind::kYes,
+        EdgeShuffleTopology::EdgeSortKind::kAny);
+    std::shared_ptr<EdgeShuffleTopology> topo =
+        EdgeShuffleTopology::MakeUndirected(pg, *in_topo);
+    MaybeBuildHubIndex(topo.get());
+    return topo;
+  };
+
+  auto topo = FindOrBuild(
+      &undirected_topos_,
+      CacheEntry<EdgeShuffleTopology>{
+          .tpose_kind = EdgeShuffleTopology::TransposeKind::kNo,
+          .edge_sort_kind = EdgeShuffleTopology::EdgeSortKind::kSortedByDestID,
+          .node_sort_kind = ShuffleTopology::NodeSortKind::kAny,
+      },
+      matches, build);
+  // Duplicate edges and self-loops are dropped, so only the nodes match
+  KATANA_LOG_DEBUG_ASSERT(topo->num_nodes() == pg->num_nodes());
+  return topo;
+}
+
+std::shared_ptr<katana::CompactTopology<uint32_t>>
+katana::PGViewCache::BuildOrGetCompactTopo(
+    const katana::PropertyGraph* pg,
+    const katana::EdgeShuffleTopology::TransposeKind& tpose_kind,
+    const katana::EdgeShuffleTopology::EdgeSortKind& sort_kind) noexcept {
+  using Compact = CompactTopology<uint32_t>;
+  if (pg->num_edges() > std::numeric_limits<uint32_t>::max()) {
+    return nullptr;
   }
+
+  auto matches = [&](const Compact& topo) {
+    return topo.has_transpose_state(tpose_kind) &&
+           topo.has_edges_sorted_by(sort_kind);
+  };
+  auto build = [&]() -> std::shared_ptr<Compact> {
+    // Once copied, the wide topology is only kept if the cache has room
+    auto wide_topo = BuildOrGetEdgeShuffTopo(pg, tpose_kind, sort_kind);
+    return Compact::Make(*wide_topo);
+  };
+
+  auto topo = FindOrBuild(
+      &compact_topos_,
+      CacheEntry<Compact>{
+          .tpose_kind = tpose_kind,
+          .edge_sort_kind = sort_kind,
+          .node_sort_kind = ShuffleTopology::NodeSortKind::kAny,
+      },
+      matches, build);
+  KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, topo.get()));
+  return topo;
 }
 
 katana::GraphTopology
@@ -1,5 +1,6 @@
 #include "katana/HWTopo.h"
 
+#include <sstream>
 #include <stdexcept>
 
 std::vector<int>
@@ -36,3 +37,21 @@ katana::parseCPUList(const std::string& line) {
 
   return vals;
 }
+
+double
+katana::parseCgroupCPUMax(const std::string& in) {
+  std::istringstream fields(in);
+  std::string quota;
+  double period = 0;
+  if (!(fields >> quota >> period) || quota == "max" || period <= 0) {
+    return 0;
+  }
+  try {
+    double cpus = std::stod(quota) / period;
+    return cpus > 0 ? cpus : 0;
+  } catch (const std::invalid_argument&) {
+    return 0;
+  } catch (const std::out_of_range&) {
+    return 0;
+  }
+}
@@ -84,6 +84,7 @@ makeHWTopo() {
         .numaNode = socket,
         .osContext = i,
         .osNumaNode = socket,
+        .capacity = kMaxThreadCapacity,
     });
   }
 
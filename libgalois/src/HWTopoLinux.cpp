@@ -23,12 +23,15 @@
 #include <array>
 #include <cassert>
 #include <cerrno>
+#include <cstdlib>
 #include <cstring>
 #include <fstream>
 #include <functional>
 #include <memory>
 #include <mutex>
 #include <set>
+#include <sstream>
+#include <string>
 
 #include "katana/HWTopo.h"
 #include "katana/SimpleLock.h"
@@ -54,6 +57,8 @@ struct cpuinfo {
   unsigned numaNode;  // from libnuma
   bool valid;         // from cpuset
   bool smt;           // computed
+  bool efficient;     // from sysfs, an efficiency core of a hybrid CPU
+  unsigned capacity;  // from sysfs
 };
 
 bool
@@ -64,6 +69,12 @@ operator<(const cpuinfo& lhs, const cpuinfo& rhs) {
   if (lhs.physid != rhs.physid) {
     return lhs.physid < rhs.physid;
   }
+  if (lhs.efficient != rhs.efficient) {
+    return lhs.efficient < rhs.efficient;
+  }
+  if (lhs.capacity != rhs.capacity) {
+    return lhs.capacity > rhs.capacity;
+  }
   if (lhs.coreid != rhs.coreid) {
     return lhs.coreid < rhs.coreid;
   }
@@ -251,6 +262,121 @@ markValid(std::vector<cpuinfo>& info) {
   }
 }
 
+//! The first line of a file, or an empty string if it cannot be read
+std::string
+readLine(const std::string& path) {
+  std::ifstream file(path);
+  std::string line;
+  std::getline(file, line);
+  return line;
+}
+
+/**
+ * Mark efficiency cores and compute capacities from sysfs: cpu_capacity
+ * where the kernel provides it (e.g., ARM big.LITTLE), else the maximum
+ * frequency, relative to the fastest cpu. Intel hybrid CPUs list their
+ * efficiency cores in /sys/devices/cpu_atom/cpus.
+ */
+void
+markCapacity(std::vector<cpuinfo>& info) {
+  auto atoms = katana::parseCPUList(readLine("/sys/devices/cpu_atom/cpus"));
+  std::sort(atoms.begin(), atoms.end());
+
+  std::vector<uint64_t> raw(info.size());
+  uint64_t max_raw = 0;
+  for (unsigned i = 0; i < info.size(); ++i) {
+    std::string dir =
+        "/sys/devices/system/cpu/cpu" + std::to_string(info[i].proc);
+    std::string value = readLine(dir + "/cpu_capacity");
+    if (value.empty()) {
+      value = readLine(dir + "/cpufreq/cpuinfo_max_freq");
+    }
+    raw[i] = std::strtoull(value.c_str(), nullptr, 10);
+    max_raw = std::max(max_raw, raw[i]);
+    info[i].efficient =
+        std::binary_search(atoms.begin(), atoms.end(), info[i].proc);
+  }
+
+  for (unsigned i = 0; i < info.size(); ++i) {
+    info[i].capacity =
+        raw[i] == 0 ? katana::kMaxThreadCapacity
+                    : std::max<uint64_t>(
+                          1, raw[i] * katana::kMaxThreadCapacity / max_raw);
+  }
+}
+
+/**
+ * The CPUs that the cgroup CPU controller lets this process use, or 0 if
+ * unlimited. The quota of a cgroup is the smallest one along its path, and
+ * in a container the path in /proc/self/cgroup may not exist under the
+ * mount, which then holds the container's own cgroup.
+ */
+double
+cgroupCPUQuota() {
+  double quota = 0;
+  auto limit = [&](double cpus) {
+    if (cpus > 0 && (quota == 0 || cpus < quota)) {
+      quota = cpus;
+    }
+  };
+  auto forEachAncestor = [](const std::string& mount, const std::string& path,
+                            const std::function<void(const std::string&)>& fn) {
+    std::string dir = mount + (path == "/" ? "" : path);
+    while (true) {
+      fn(dir);
+      size_t slash = dir.rfind('/');
+      if (dir.size() <= mount.size() || slash == std::string::npos) {
+        break;
+      }
+      dir.resize(std::max(slash, mount.size()));
+    }
+  };
+
+  std::ifstream cgroups("/proc/self/cgroup");
+  std::string line;
+  // Each line is hierarchy-ID:controller-list:cgroup-path
+  while (std::getline(cgroups, line)) {
+    size_t first = line.find(':');
+    size_t second = line.find(':', first + 1);
+    if (first == std::string::npos || second == std::string::npos) {
+      continue;
+    }
+    std::string controllers = line.substr(first + 1, second - first - 1);
+    std::string path = line.substr(second + 1);
+
+    if (controllers.empty()) {
+      // cgroup v2
+      forEachAncestor("/sys/fs/cgroup", path, [&](const std::string& dir) {
+        limit(katana::parseCgroupCPUMax(readLine(dir + "/cpu.max")));
+      });
+      continue;
+    }
+
+    // cgroup v1, whose cpu controller may be mounted with cpuacct
+    std::istringstream names(controllers);
+    std::string name;
+    bool has_cpu = false;
+    while (std::getline(names, name, ',')) {
+      has_cpu = has_cpu || name == "cpu";
+    }
+    if (!has_cpu) {
+      continue;
+    }
+    for (const char* mount :
+         {"/sys/fs/cgroup/cpu", "/sys/fs/cgroup/cpu,cpuacct",
+          "/sys/fs/cgroup/cpuacct,cpu"}) {
+      forEachAncestor(mount, path, [&](const std::string& dir) {
+        std::string quota_us = readLine(dir + "/cpu.cfs_quota_us");
+        std::string period_us = readLine(dir + "/cpu.cfs_period_us");
+        if (!quota_us.empty() && !period_us.empty()) {
+          limit(katana::parseCgroupCPUMax(quota_us + " " + period_us));
+        }
+      });
+    }
+  }
+  return quota;
+}
+
 katana::HWTopoInfo
 makeHWTopo() {
   katana::MachineTopoInfo retMTI;
@@ -265,8 +391,19 @@ makeHWTopo() {
           info.begin(), info.end(), [](const cpuinfo& c) { return c.valid; }),
       info.end());
 
+  markCapacity(info);
   std::sort(info.begin(), info.end());
   markSMT(info);
+
+  if (double quota = cgroupCPUQuota(); quota > 0) {
+    size_t usable = std::max<size_t>(1, static_cast<size_t>(quota));
+    if (usable < info.size()) {
+      KATANA_LOG_DEBUG(
+          "cgroup CPU quota of {} allows {} of {} cpus", quota, usable,
+          info.size());
+      info.resize(usable);
+    }
+  }
   retMTI.maxSockets = countSockets(info);
   retMTI.maxThreads = info.size();
   retMTI.maxCores = countCores(info);
@@ -296,7 +433,7 @@ makeHWTopo() {
         i, leader, repid,
         (unsigned)std::distance(
             numaNodes.begin(), numaNodes.find(info[i].numaNode)),
-        mid, info[i].proc, info[i].numaNode});
+        mid, info[i].proc, info[i].numaNode, info[i].capacity});
   }
 
   return {
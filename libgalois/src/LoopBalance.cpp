@@ -0,0 +1,104 @@
+#include "katana/LoopBalance.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "katana/Env.h"
+#include "katana/Executor_OnEach.h"
+#include "katana/ProgressTracer.h"
+#include "katana/Statistics.h"
+
+bool
+katana::LoopBalance::IsEnabled() {
+  static const bool enabled = [] {
+    bool value = false;
+    GetEnv("KATANA_LOOP_BALANCE", &value);
+    return value;
+  }();
+  return enabled;
+}
+
+katana::LoopBalance::LoopBalance(const char* loopname) : loopname_(loopname) {
+  if (IsEnabled()) {
+    threads_ = std::make_unique<PerThreadStorage<ThreadStats>>();
+  }
+}
+
+void
+katana::LoopBalance::Report() {
+  if (!threads_) {
+    return;
+  }
+
+  // Threads that ran the loop are idle from when they run out of work until
+  // the last one does
+  uint64_t end_ns = 0;
+  for (unsigned i = 0; i < threads_->size(); ++i) {
+    end_ns = std::max(end_ns, threads_->getRemote(i)->end_ns);
+  }
+
+  const char* loopname = loopname_;
+  PerThreadStorage<ThreadStats>& threads = *threads_;
+  on_each_gen(
+      [&](unsigned, unsigned) {
+        const ThreadStats& stats = *threads.getLocal();
+        if (stats.begin_ns == 0) {
+          return;
+        }
+        ReportStatSum(loopname, "BusyTime", stats.busy_ns);
+        ReportStatSum(
+            loopname, "IdleTime", end_ns - stats.begin_ns - stats.busy_ns);
+        ReportStatSum(loopname, "Chunks", stats.chunks);
+        ReportStatSum(loopname, "StealAttempts", stats.steal_attempts);
+        ReportStatSum(loopname, "Steals", stats.steals);
+      },
+      std::make_tuple());
+
+  if (!GetTracer().HasActiveSpan()) {
+    return;
+  }
+
+  uint64_t num_threads = 0;
+  uint64_t min_busy = std::numeric_limits<uint64_t>::max();
+  uint64_t max_busy = 0;
+  uint64_t total_busy = 0;
+  uint64_t total_idle = 0;
+  uint64_t chunks = 0;
+  uint64_t steal_attempts = 0;
+  uint64_t steals = 0;
+  for (unsigned i = 0; i < threads.size(); ++i) {
+    const ThreadStats& stats = *threads.getRemote(i);
+    if (stats.begin_ns == 0) {
+      continue;
+    }
+    ++num_threads;
+    min_busy = std::min(min_busy, stats.busy_ns);
+    max_busy = std::max(max_busy, stats.busy_ns);
+    total_busy += stats.busy_ns;
+    total_idle += end_ns - stats.begin_ns - stats.busy_ns;
+    chunks += stats.chunks;
+    steal_attempts += stats.steal_attempts;
+    steals += stats.steals;
+  }
+  if (num_threads == 0) {
+    return;
+  }
+
+  // Imbalance is how much longer the busiest thread worked than the average
+  // one; 1 is perfectly even
+  double avg_busy = static_cast<double>(total_busy) / num_threads;
+  GetTracer().GetActiveSpan().Log(
+      "loop balance",
+      {
+          {"loop", loopname},
+          {"threads", num_threads},
+          {"busy_min_ns", min_busy},
+          {"busy_max_ns", max_busy},
+          {"busy_avg_ns", avg_busy},
+          {"idle_total_ns", total_idle},
+          {"imbalance", avg_busy > 0 ? max_busy / avg_busy : 1.0},
+          {"chunks", chunks},
+          {"steal_attempts", steal_attempts},
+          {"steals", steals},
+      });
+}
@@ -0,0 +1,218 @@
+#include "katana/LoopCounters.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "katana/Env.h"
+#include "katana/Executor_OnEach.h"
+#include "katana/Logging.h"
+#include "katana/Statistics.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+using Counts = std::array<uint64_t, katana::LoopCounters::kNumEvents>;
+
+#ifdef __linux__
+
+struct EventConfig {
+  uint32_t type;
+  uint64_t config;
+};
+
+constexpr uint64_t
+CacheMiss(uint64_t cache) {
+  return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+         (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+// Read misses of the NUMA node cache are reads from the memory of another
+// node
+constexpr std::array<EventConfig, katana::LoopCounters::kNumEvents> kEvents{{
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_HW_CACHE, CacheMiss(PERF_COUNT_HW_CACHE_NODE)},
+    {PERF_TYPE_HW_CACHE, CacheMiss(PERF_COUNT_HW_CACHE_DTLB)},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_STALLED_CYCLES_BACKEND},
+}};
+
+/// The counters of the calling thread, opened the first time it runs a
+/// counted loop and kept open for the life of the thread
+class ThreadCounters {
+public:
+  ThreadCounters() {
+    for (size_t i = 0; i < kEvents.size(); ++i) {
+      perf_event_attr attr{};
+      attr.size = sizeof(attr);
+      attr.type = kEvents[i].type;
+      attr.config = kEvents[i].config;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      attr.read_format =
+          PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+      fds_[i] = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+      if (fds_[i] < 0) {
+        unavailable_.fetch_or(1U << i, std::memory_order_relaxed);
+      }
+    }
+  }
+
+  ~ThreadCounters() {
+    for (int fd : fds_) {
+      if (fd >= 0) {
+        close(fd);
+      }
+    }
+  }
+
+  ThreadCounters(const ThreadCounters&) = delete;
+  ThreadCounters& operator=(const ThreadCounters&) = delete;
+
+  static ThreadCounters& Get() {
+    thread_local ThreadCounters counters;
+    return counters;
+  }
+
+  /// The events no thread could open
+  static uint32_t unavailable() {
+    return unavailable_.load(std::memory_order_relaxed);
+  }
+
+  bool valid(size_t i) const { return fds_[i] >= 0; }
+
+  /// The counts so far, scaled up for the time the kernel multiplexed each
+  /// event out
+  Counts Read() const {
+    Counts counts{};
+    for (size_t i = 0; i < kEvents.size(); ++i) {
+      uint64_t values[3];
+      if (fds_[i] < 0 || read(fds_[i], values, sizeof(values)) !=
+                             static_cast<ssize_t>(sizeof(values))) {
+        continue;
+      }
+      counts[i] = values[2] > 0 ? static_cast<uint64_t>(
+                                      static_cast<double>(values[0]) *
+                                      values[1] / values[2])
+                                : 0;
+    }
+    return counts;
+  }
+
+  Counts& start() { return start_; }
+
+private:
+  static std::atomic<uint32_t> unavailable_;
+
+  std::array<int, katana::LoopCounters::kNumEvents> fds_;
+  Counts start_{};
+};
+
+std::atomic<uint32_t> ThreadCounters::unavailable_{0};
+
+void
+WarnUnavailable() {
+  static std::atomic<bool> warned{false};
+  uint32_t unavailable = ThreadCounters::unavailable();
+  if (unavailable == 0 || warned.exchange(true)) {
+    return;
+  }
+  std::string names;
+  for (int i = 0; i < katana::LoopCounters::kNumEvents; ++i) {
+    if (unavailable & (1U << i)) {
+      names += names.empty() ? "" : ", ";
+      names += katana::LoopCounters::EventName(
+          static_cast<katana::LoopCounters::Event>(i));
+    }
+  }
+  KATANA_LOG_WARN(
+      "KATANA_LOOP_COUNTERS: cannot count {}; see perf_event_paranoid",
+      names);
+}
+
+#endif
+
+}  // namespace
+
+const char*
+katana::LoopCounters::EventName(Event event) {
+  switch (event) {
+  case kCycles:
+    return "Cycles";
+  case kLLCMisses:
+    return "LLCMisses";
+  case kRemoteDRAMAccesses:
+    return "RemoteDRAMAccesses";
+  case kDTLBMisses:
+    return "DTLBMisses";
+  case kStalledCycles:
+    return "StalledCycles";
+  default:
+    return "Unknown";
+  }
+}
+
+bool
+katana::LoopCounters::IsEnabled() {
+  static const bool enabled = [] {
+    bool value = false;
+    GetEnv("KATANA_LOOP_COUNTERS", &value);
+#ifndef __linux__
+    if (value) {
+      KATANA_LOG_WARN("KATANA_LOOP_COUNTERS needs Linux perf_event");
+      value = false;
+    }
+#endif
+    return value;
+  }();
+  return enabled;
+}
+
+void
+katana::LoopCounters::start() {
+#ifdef __linux__
+  if (!IsEnabled()) {
+    return;
+  }
+  running_ = true;
+  on_each_gen(
+      [](unsigned, unsigned) {
+        ThreadCounters& counters = ThreadCounters::Get();
+        counters.start() = counters.Read();
+      },
+      std::make_tuple());
+  WarnUnavailable();
+#endif
+}
+
+void
+katana::LoopCounters::stop() {
+#ifdef __linux__
+  if (!running_) {
+    return;
+  }
+  running_ = false;
+  const char* loopname = loopname_;
+  on_each_gen(
+      [loopname](unsigned, unsigned) {
+        ThreadCounters& counters = ThreadCounters::Get();
+        Counts end = counters.Read();
+        for (int i = 0; i < kNumEvents; ++i) {
+          if (counters.valid(i)) {
+            // Scaled counts of multiplexed events can go back a little
+            uint64_t begin = counters.start()[i];
+            ReportStatSum(
+                loopname, EventName(static_cast<Event>(i)),
+                end[i] > begin ? end[i] - begin : 0);
+          }
+        }
+      },
+      std::make_tuple());
+#endif
+}
@@ -19,7 +19,17 @@
 
 #include "katana/NumaMem.h"
 
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
 #include <cassert>
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+#include <string>
 
 #include "katana/PageAlloc.h"
 #include "katana/ThreadPool.h"
@@ -143,6 +153,14 @@ largeFree(void* ptr, size_t bytes) {
 void
 katana::internal::largeFreer::operator()(void* ptr) const {
   largeFree(ptr, bytes);
+  MemoryAccounting::Release(category, bytes);
+}
+
+static internal::largeFreer
+chargeLarge(size_t bytes) {
+  MemoryCategory category = CurrentMemoryCategory();
+  MemoryAccounting::ChargeOrDie(category, bytes);
+  return internal::largeFreer{bytes, category};
 }
 
 // round data to a multiple of mult
@@ -166,6 +184,7 @@ katana::largeMallocInterleaved(size_t bytes, unsigned numThreads) {
   // yes this is a comment in a ifdef, but if libnuma improves, this is where
   // the alloc would go
 #endif
+  internal::largeFreer freer = chargeLarge(bytes);
   // Get a non-prefaulted allocation
   void* data = allocPages(bytes / allocSize(), false);
 
@@ -174,7 +193,7 @@ katana::largeMallocInterleaved(size_t bytes, unsigned numThreads) {
     // true = round robin paging
     pageIn(data, bytes, allocSize(), numThreads, true);
 
-  return LAptr{data, internal::largeFreer{bytes}};
+  return LAptr{data, freer};
 }
 
 LAptr
@@ -182,8 +201,8 @@ katana::largeMallocLocal(size_t bytes) {
   // round up to hugePageSize
   bytes = roundup(bytes, allocSize());
   // Get a prefaulted allocation
-  return LAptr{
-      allocPages(bytes / allocSize(), true), internal::largeFreer{bytes}};
+  internal::largeFreer freer = chargeLarge(bytes);
+  return LAptr{allocPages(bytes / allocSize(), true), freer};
 }
 
 LAptr
@@ -191,20 +210,21 @@ katana::largeMallocFloating(size_t bytes) {
   // round up to hugePageSize
   bytes = roundup(bytes, allocSize());
   // Get a non-prefaulted allocation
-  return LAptr{
-      allocPages(bytes / allocSize(), false), internal::largeFreer{bytes}};
+  internal::largeFreer freer = chargeLarge(bytes);
+  return LAptr{allocPages(bytes / allocSize(), false), freer};
 }
 
 LAptr
 katana::largeMallocBlocked(size_t bytes, unsigned numThreads) {
   // round up to hugePageSize
   bytes = roundup(bytes, allocSize());
+  internal::largeFreer freer = chargeLarge(bytes);
   // Get a non-prefaulted allocation
   void* data = allocPages(bytes / allocSize(), false);
   if (data)
     // false = blocked paging
     pageIn(data, bytes, allocSize(), numThreads, false);
-  return LAptr{data, internal::largeFreer{bytes}};
+  return LAptr{data, freer};
 }
 
 /**
@@ -228,6 +248,7 @@ katana::largeMallocSpecified(
   // ceiling to nearest page
   bytes = roundup(bytes, allocSize());
 
+  internal::largeFreer freer = chargeLarge(bytes);
   void* data = allocPages(bytes / allocSize(), false);
 
   // NUMA aware page in based on element distribution specified in threadRanges
@@ -235,7 +256,7 @@ katana::largeMallocSpecified(
     pageInSpecified(
         data, bytes, allocSize(), numThreads, threadRanges, elementSize);
 
-  return LAptr{data, internal::largeFreer{bytes}};
+  return LAptr{data, freer};
 }
 // Explicit template declarations since the template is defined in the .h
 // file
@@ -245,3 +266,82 @@ template LAptr katana::largeMallocSpecified<std::vector<uint32_t>>(
 template LAptr katana::largeMallocSpecified<std::vector<uint64_t>>(
     size_t bytes, uint32_t numThreads, std::vector<uint64_t>& threadRanges,
     size_t elementSize);
+
+katana::PagePlacement
+katana::GetPagePlacement(const void* ptr, size_t bytes, size_t max_samples) {
+  PagePlacement ret;
+  if (ptr == nullptr || bytes == 0) {
+    return ret;
+  }
+
+  constexpr size_t kBasePageSize = 4096;
+  const uintptr_t begin = reinterpret_cast<uintptr_t>(ptr);
+  const uintptr_t end = begin + bytes;
+  const size_t num_pages = (bytes + kBasePageSize - 1) / kBasePageSize;
+  const size_t num_samples =
+      std::min(num_pages, std::max<size_t>(max_samples, 1));
+
+#ifdef __linux__
+  // Page sizes are per mapping; the mappings overlapping the region are
+  // listed in smaps
+  std::ifstream smaps("/proc/self/smaps");
+  std::string line;
+  uint64_t vm_begin = 0;
+  uint64_t vm_end = 0;
+  while (std::getline(smaps, line)) {
+    uint64_t a = 0;
+    uint64_t b = 0;
+    uint64_t kb = 0;
+    if (std::sscanf(line.c_str(), "%" SCNx64 "-%" SCNx64, &a, &b) == 2) {
+      vm_begin = a;
+      vm_end = b;
+      continue;
+    }
+    uint64_t overlap_begin = std::max<uint64_t>(vm_begin, begin);
+    uint64_t overlap_end = std::min<uint64_t>(vm_end, end);
+    if (overlap_begin >= overlap_end) {
+      continue;
+    }
+    uint64_t overlap = overlap_end - overlap_begin;
+    if (std::sscanf(line.c_str(), "KernelPageSize: %" SCNu64 " kB", &kb) ==
+            1 &&
+        kb * 1024 > kBasePageSize) {
+      ret.huge_page_bytes += overlap;
+    } else if (
+        std::sscanf(line.c_str(), "AnonHugePages: %" SCNu64 " kB", &kb) == 1) {
+      ret.huge_page_bytes += kb * 1024 * overlap / (vm_end - vm_begin);
+    }
+  }
+  ret.huge_page_bytes = std::min<uint64_t>(ret.huge_page_bytes, bytes);
+#endif
+
+#if defined(__linux__) && defined(SYS_move_pages)
+  std::vector<void*> pages(num_samples);
+  std::vector<int> status(num_samples, -1);
+  for (size_t i = 0; i < num_samples; ++i) {
+    size_t page = i * num_pages / num_samples;
+    pages[i] = reinterpret_cast<void*>(
+        (begin + page * kBasePageSize) & ~(kBasePageSize - 1));
+  }
+  // With no target nodes, move_pages only reports where each page is
+  if (syscall(
+          SYS_move_pages, 0, num_samples, pages.data(), nullptr,
+          status.data(), 0) != 0) {
+    std::fill(status.begin(), status.end(), -1);
+  }
+  for (int node : status) {
+    if (node < 0) {
+      ret.sampled_pages_unknown++;
+      continue;
+    }
+    if (static_cast<size_t>(node) >= ret.sampled_pages_per_node.size()) {
+      ret.sampled_pages_per_node.resize(node + 1);
+    }
+    ret.sampled_pages_per_node[node]++;
+  }
+#else
+  ret.sampled_pages_unknown = num_samples;
+#endif
+
+  return ret;
+}
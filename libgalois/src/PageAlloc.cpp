@@ -19,8 +19,12 @@
 
 #include "katana/PageAlloc.h"
 
+#include <atomic>
+#include <cstdint>
 #include <mutex>
+#include <string>
 
+#include "katana/Env.h"
 #include "katana/Logging.h"
 #include "katana/SimpleLock.h"
 
@@ -34,6 +38,10 @@ const size_t hugePageSize = 2 * 1024 * 1024;
 // protect mmap, munmap since linux has issues
 static katana::SimpleLock allocLock;
 
+static std::atomic<uint64_t> numHugeTLBPages;
+static std::atomic<uint64_t> numTransparentPages;
+static std::atomic<uint64_t> numRegularPages;
+
 // mmap flags
 #if defined(MAP_ANONYMOUS)
 static const int _MAP_ANON = MAP_ANONYMOUS;
@@ -64,6 +72,15 @@ katana::allocSize() {
   return hugePageSize;
 }
 
+katana::PageBackingCounts
+katana::pageBackingCounts() {
+  PageBackingCounts ret;
+  ret.hugetlb = numHugeTLBPages.load(std::memory_order_relaxed);
+  ret.transparent = numTransparentPages.load(std::memory_order_relaxed);
+  ret.regular = numRegularPages.load(std::memory_order_relaxed);
+  return ret;
+}
+
 #ifdef KATANA_USE_JEMALLOC
 
 void*
@@ -72,6 +89,7 @@ katana::allocPages(unsigned num, [[maybe_unused]] bool preFault) {
     return nullptr;
   }
   KATANA_DEBUG_WARN_ONCE("not using huge pages due to jemalloc");
+  numRegularPages.fetch_add(num, std::memory_order_relaxed);
   return malloc(num * hugePageSize);
 }
 
@@ -82,6 +100,39 @@ katana::freePages(void* ptr, [[maybe_unused]] unsigned num) {
 
 #else
 
+namespace {
+
+/// The page sizes allocPages may use, set with KATANA_HUGE_PAGES
+enum class HugePages {
+  /// Reserved huge pages, then transparent huge pages, then regular pages
+  kHugeTLB,
+  /// Transparent huge pages, then regular pages
+  kTransparent,
+  /// Regular pages only
+  kNone,
+};
+
+HugePages
+HugePagesFromEnv() {
+  static const HugePages policy = [] {
+    std::string value;
+    if (!katana::GetEnv("KATANA_HUGE_PAGES", &value) || value == "hugetlb") {
+      return HugePages::kHugeTLB;
+    }
+    if (value == "transparent") {
+      return HugePages::kTransparent;
+    }
+    if (value == "none") {
+      return HugePages::kNone;
+    }
+    KATANA_WARN_ONCE("unknown KATANA_HUGE_PAGES {}, using hugetlb", value);
+    return HugePages::kHugeTLB;
+  }();
+  return policy;
+}
+
+}  // namespace
+
 static void*
 trymmap(size_t size, int flag) {
   std::lock_guard<katana::SimpleLock> lg(allocLock);
@@ -93,17 +144,74 @@ trymmap(size_t size, int flag) {
   return ptr;
 }
 
+#ifdef MADV_HUGEPAGE
+//! Map \p size bytes aligned to hugePageSize so that transparent huge pages
+//! can back all of it; an unaligned mapping of a huge page's size straddles
+//! two huge page frames and can only ever get regular pages
+static void*
+trymmapAligned(size_t size) {
+  char* raw = static_cast<char*>(trymmap(size + hugePageSize, _MAP));
+  if (!raw) {
+    return nullptr;
+  }
+  uintptr_t addr = reinterpret_cast<uintptr_t>(raw);
+  size_t head = (hugePageSize - addr % hugePageSize) % hugePageSize;
+  size_t tail = hugePageSize - head;
+
+  std::lock_guard<katana::SimpleLock> lg(allocLock);
+  if (head) {
+    munmap(raw, head);
+  }
+  if (tail) {
+    munmap(raw + head + size, tail);
+  }
+  return raw + head;
+}
+#endif
+
 void*
 katana::allocPages(unsigned num, bool preFault) {
   if (num == 0) {
     return nullptr;
   }
 
-  void* ptr = trymmap(num * hugePageSize, preFault ? _MAP_HUGE_POP : _MAP_HUGE);
-  if (!ptr) {
-    KATANA_DEBUG_WARN_ONCE(
-        "huge page alloc failed, falling back to regular pages");
+  HugePages policy = HugePagesFromEnv();
+  void* ptr = nullptr;
+  if (policy == HugePages::kHugeTLB) {
+    ptr = trymmap(num * hugePageSize, preFault ? _MAP_HUGE_POP : _MAP_HUGE);
+  }
+  if (ptr) {
+#ifdef MAP_HUGETLB
+    numHugeTLBPages.fetch_add(num, std::memory_order_relaxed);
+#else
+    numRegularPages.fetch_add(num, std::memory_order_relaxed);
+#endif
+  } else {
+    if (policy == HugePages::kHugeTLB) {
+      KATANA_DEBUG_WARN_ONCE(
+          "huge page alloc failed, falling back to regular pages");
+    }
+#ifdef MADV_HUGEPAGE
+    // Without reserved huge pages, transparent huge pages can still back the
+    // region; map without populating so that the advice applies on fault
+    if (policy != HugePages::kNone) {
+      ptr = trymmapAligned(num * hugePageSize);
+    }
+    if (ptr) {
+      numTransparentPages.fetch_add(num, std::memory_order_relaxed);
+      madvise(ptr, num * hugePageSize, MADV_HUGEPAGE);
+      if (preFault) {
+        for (size_t x = 0; x < num * hugePageSize; x += 4096) {
+          static_cast<char*>(ptr)[x] = 0;
+        }
+      }
+      return ptr;
+    }
+#endif
     ptr = trymmap(num * hugePageSize, preFault ? _MAP_POP : _MAP);
+    if (ptr) {
+      numRegularPages.fetch_add(num, std::memory_order_relaxed);
+    }
   }
 
   if (!ptr) {
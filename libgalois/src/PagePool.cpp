@@ -39,6 +39,16 @@ katana::numPagePoolAllocForThread(unsigned tid) {
   return PA->count(tid);
 }
 
+int
+katana::numPagePoolFreeForThread(unsigned tid) {
+  return PA->freeCount(tid);
+}
+
+int
+katana::numPagePoolNodeReuseForThread(unsigned tid) {
+  return PA->nodeReuseCount(tid);
+}
+
 void*
 katana::pagePoolAlloc() {
   return PA->pageAlloc();
@@ -0,0 +1,284 @@
+#include "katana/ParallelismProfile.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "katana/CacheLineStorage.h"
+#include "katana/Env.h"
+#include "katana/JSON.h"
+#include "katana/Logging.h"
+#include "katana/Result.h"
+#include "katana/ThreadPool.h"
+#include "katana/Threads.h"
+
+namespace {
+
+struct RoundRecord {
+  uint64_t invocation;
+  uint64_t parallelism;
+  uint64_t work;
+  uint64_t max_thread_work;
+  uint64_t time_ns;
+  unsigned threads;
+};
+
+struct LoopRecord {
+  std::string loopname;
+  std::string kind;
+  uint64_t invocations{0};
+  std::vector<RoundRecord> rounds;
+};
+
+/// The loops recorded for one file, in the order they first ran
+struct Profile {
+  std::string path;
+  std::vector<LoopRecord> loops;
+  std::unordered_map<std::string, size_t> index;
+
+  LoopRecord& Get(const char* loopname, const char* kind) {
+    auto [it, inserted] = index.emplace(loopname, loops.size());
+    if (inserted) {
+      loops.emplace_back(LoopRecord{loopname, kind, 0, {}});
+    }
+    return loops[it->second];
+  }
+};
+
+/// The profiles being recorded: the one named by the environment for the
+/// whole run, then those of the live scopes
+struct State {
+  std::mutex mutex;
+  std::vector<std::unique_ptr<Profile>> profiles;
+  Profile* env_profile{nullptr};
+  std::atomic<size_t> num_profiles{0};
+  // A loop is being recorded
+  std::atomic<bool> busy{false};
+  // The threads of a do_all round are counting their iterations
+  std::atomic<bool> counting{false};
+  std::vector<katana::CacheLineStorage<uint64_t>> thread_work;
+
+  State() {
+    std::string path;
+    if (katana::GetEnv("KATANA_PARALLELISM_PROFILE", &path) && !path.empty()) {
+      profiles.emplace_back(std::make_unique<Profile>(Profile{path, {}, {}}));
+      env_profile = profiles.back().get();
+      num_profiles = 1;
+    }
+  }
+
+  static State& Get() {
+    static State state;
+    return state;
+  }
+
+  void Record(
+      const char* loopname, const char* kind, uint64_t parallelism,
+      uint64_t work, uint64_t max_thread_work, uint64_t time_ns) {
+    unsigned threads = katana::getActiveThreads();
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& profile : profiles) {
+      LoopRecord& loop = profile->Get(loopname, kind);
+      loop.rounds.emplace_back(RoundRecord{
+          loop.invocations - 1, parallelism, work, max_thread_work, time_ns,
+          threads});
+    }
+  }
+};
+
+uint64_t
+NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+nlohmann::json
+ToJson(const LoopRecord& loop) {
+  uint64_t work = 0;
+  uint64_t parallelism = 0;
+  uint64_t max_parallelism = 0;
+  uint64_t time_ns = 0;
+  uint64_t starved_rounds = 0;
+  uint64_t starved_time_ns = 0;
+  nlohmann::json rounds = nlohmann::json::array();
+  for (const RoundRecord& round : loop.rounds) {
+    work += round.work;
+    parallelism += round.parallelism;
+    max_parallelism = std::max(max_parallelism, round.parallelism);
+    time_ns += round.time_ns;
+    if (round.parallelism < round.threads) {
+      ++starved_rounds;
+      starved_time_ns += round.time_ns;
+    }
+    rounds.push_back({
+        {"invocation", round.invocation},
+        {"parallelism", round.parallelism},
+        {"work", round.work},
+        {"max_thread_work", round.max_thread_work},
+        {"threads", round.threads},
+        {"time_ns", round.time_ns},
+    });
+  }
+  double average_parallelism =
+      loop.rounds.empty() ? 0.0
+                          : static_cast<double>(parallelism) /
+                                static_cast<double>(loop.rounds.size());
+  return {
+      {"loopname", loop.loopname},
+      {"kind", loop.kind},
+      {"invocations", loop.invocations},
+      {"critical_path", loop.rounds.size()},
+      {"work", work},
+      {"average_parallelism", average_parallelism},
+      {"max_parallelism", max_parallelism},
+      {"starved_rounds", starved_rounds},
+      {"starved_time_ns", starved_time_ns},
+      {"time_ns", time_ns},
+      {"rounds", std::move(rounds)},
+  };
+}
+
+katana::Result<void>
+Write(const Profile& profile) {
+  nlohmann::json loops = nlohmann::json::array();
+  for (const LoopRecord& loop : profile.loops) {
+    loops.push_back(ToJson(loop));
+  }
+  nlohmann::json obj = {{"loops", std::move(loops)}};
+  std::string contents = KATANA_CHECKED(katana::JsonDump(obj));
+
+  std::ofstream out(profile.path, std::ios::trunc);
+  if (!out) {
+    return KATANA_ERROR(katana::ResultErrno(), "opening {}", profile.path);
+  }
+  out << contents;
+  out.close();
+  if (!out) {
+    return KATANA_ERROR(katana::ResultErrno(), "writing {}", profile.path);
+  }
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+katana::ParallelismProfile::Scope::Scope(std::string path)
+    : path_(std::move(path)) {
+  if (path_.empty()) {
+    return;
+  }
+  State& state = State::Get();
+  std::lock_guard<std::mutex> lock(state.mutex);
+  state.profiles.emplace_back(
+      std::make_unique<Profile>(Profile{path_, {}, {}}));
+  state.num_profiles = state.profiles.size();
+}
+
+katana::ParallelismProfile::Scope::~Scope() {
+  if (path_.empty()) {
+    return;
+  }
+  State& state = State::Get();
+  std::unique_ptr<Profile> profile;
+  {
+    std::lock_guard<std::mutex> lock(state.mutex);
+    // Scopes end in the reverse order they began
+    profile = std::move(state.profiles.back());
+    state.profiles.pop_back();
+    state.num_profiles = state.profiles.size();
+  }
+  if (auto res = Write(*profile); !res) {
+    KATANA_LOG_WARN("writing parallelism profile: {}", res.error());
+  }
+}
+
+katana::ParallelismProfile::Loop::Loop(const char* loopname, const char* kind)
+    : loopname_(loopname), kind_(kind) {
+  if (!IsEnabled()) {
+    return;
+  }
+  State& state = State::Get();
+  recording_ = true;
+  state.busy = true;
+  std::lock_guard<std::mutex> lock(state.mutex);
+  for (auto& profile : state.profiles) {
+    ++profile->Get(loopname_, kind_).invocations;
+  }
+}
+
+katana::ParallelismProfile::Loop::~Loop() {
+  if (recording_) {
+    State::Get().busy = false;
+  }
+}
+
+void
+katana::ParallelismProfile::Loop::BeginRound() {
+  State& state = State::Get();
+  unsigned max_threads = GetThreadPool().getMaxThreads();
+  if (state.thread_work.size() < max_threads) {
+    state.thread_work.resize(max_threads);
+  }
+  for (auto& work : state.thread_work) {
+    work.get() = 0;
+  }
+  state.counting = true;
+  round_start_ns_ = NowNs();
+}
+
+void
+katana::ParallelismProfile::Loop::EndRound() {
+  uint64_t time_ns = NowNs() - round_start_ns_;
+  State& state = State::Get();
+  state.counting = false;
+  uint64_t work = 0;
+  uint64_t max_thread_work = 0;
+  for (auto& thread_work : state.thread_work) {
+    work += thread_work.get();
+    max_thread_work = std::max(max_thread_work, thread_work.get());
+  }
+  state.Record(loopname_, kind_, work, work, max_thread_work, time_ns);
+}
+
+void
+katana::ParallelismProfile::Loop::EndRound(
+    uint64_t parallelism, uint64_t work) {
+  uint64_t time_ns = NowNs() - round_start_ns_;
+  State& state = State::Get();
+  state.counting = false;
+  state.Record(loopname_, kind_, parallelism, work, 0, time_ns);
+}
+
+bool
+katana::ParallelismProfile::IsEnabled() {
+  State& state = State::Get();
+  return state.num_profiles.load(std::memory_order_relaxed) > 0 &&
+         !state.busy.load(std::memory_order_relaxed);
+}
+
+void
+katana::ParallelismProfile::AddWork(uint64_t n) {
+  State& state = State::Get();
+  if (state.counting.load(std::memory_order_relaxed)) {
+    state.thread_work[ThreadPool::getTID()].get() += n;
+  }
+}
+
+void
+katana::ParallelismProfile::DumpAtExit() {
+  State& state = State::Get();
+  std::lock_guard<std::mutex> lock(state.mutex);
+  if (!state.env_profile) {
+    return;
+  }
+  if (auto res = Write(*state.env_profile); !res) {
+    KATANA_LOG_WARN("writing parallelism profile: {}", res.error());
+  }
+}
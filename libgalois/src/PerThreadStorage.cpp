@@ -19,7 +19,13 @@
 
 #include "katana/PerThreadStorage.h"
 
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 #include <atomic>
+#include <cstring>
 #include <mutex>
 
 #include "katana/PageAlloc.h"
@@ -35,6 +41,16 @@ katana::getPTSBackend() {
 
 KATANA_EXPORT thread_local char* katana::pssBase;
 
+char*
+katana::internal::PerThreadBase() noexcept {
+  return ptsBase;
+}
+
+char*
+katana::internal::PerSocketBase() noexcept {
+  return pssBase;
+}
+
 katana::PerBackend&
 katana::getPPSBackend() {
   static katana::PerBackend b;
@@ -52,6 +68,43 @@ alloc() {
   return toReturn;
 }
 
+//! Ask for the pages of [ptr, ptr + len) to be placed on node when first
+//! touched; without NUMA support they go wherever they are touched
+static void
+preferNode(
+    [[maybe_unused]] void* ptr, [[maybe_unused]] size_t len,
+    [[maybe_unused]] unsigned node) {
+#if defined(__linux__) && defined(SYS_mbind)
+  // MPOL_PREFERRED from numaif.h, which comes with the libnuma headers
+  constexpr int kMpolPreferred = 1;
+  constexpr unsigned kBits = 8 * sizeof(unsigned long);
+  std::vector<unsigned long> mask(node / kBits + 1);
+  mask[node / kBits] = 1UL << (node % kBits);
+  syscall(
+      SYS_mbind, ptr, len, kMpolPreferred, mask.data(),
+      mask.size() * kBits + 1, 0);
+#endif
+}
+
+//! Storage for a thread that has not started yet. Its pages go to the node
+//! of the thread whoever touches them first, so it is not prefaulted by the
+//! caller, and pages fresh from the OS are zero, so it is not cleared either
+static char*
+allocUnstarted([[maybe_unused]] unsigned tid) {
+#ifdef KATANA_USE_JEMALLOC
+  char* b = static_cast<char*>(alloc());
+  memset(b, 0, ptAllocSize);
+  return b;
+#else
+  void* b = katana::allocPages(1, false);
+  if (b == nullptr) {
+    KATANA_DIE("per-thread storage out of memory");
+  }
+  preferNode(b, ptAllocSize, katana::GetThreadPool().getOSNumaNode(tid));
+  return static_cast<char*>(b);
+#endif
+}
+
 constexpr unsigned MAX_SIZE = 30;
 // PerBackend storage is typically cache-aligned. Simplify bookkeeping at the
 // expense of fragmentation by restricting all allocations to be cache-aligned.
@@ -75,6 +128,8 @@ katana::PerBackend::nextLog2(unsigned size) {
 
 unsigned
 katana::PerBackend::allocOffset(const unsigned sz) {
+  initRemotes();
+
   unsigned ll = nextLog2(sz);
   unsigned size = (1 << ll);
 
@@ -166,22 +221,57 @@ katana::PerBackend::initCommon(unsigned maxT) {
 }
 
 char*
-katana::PerBackend::initPerThread(unsigned maxT) {
-  initCommon(maxT);
-  char* b = heads[ThreadPool::getTID()] = (char*)alloc();
+katana::PerBackend::adoptOrAlloc(unsigned id) {
+  if (char* b = heads[id].load()) {
+    return b;
+  }
+  char* b = (char*)alloc();
   memset(b, 0, ptAllocSize);
+  char* expected = nullptr;
+  if (!heads[id].compare_exchange_strong(expected, b)) {
+    katana::freePages(b, 1);
+    return expected;
+  }
   return b;
 }
 
+void
+katana::PerBackend::initRemotes() {
+  if (remotesReady.load(std::memory_order_acquire)) {
+    return;
+  }
+  auto& tp = GetThreadPool();
+  for (unsigned t = 0; t < tp.getMaxThreads(); ++t) {
+    unsigned owner = perSocket ? tp.getLeader(t) : t;
+    char* expected = nullptr;
+    if (!heads[owner].load()) {
+      char* b = allocUnstarted(owner);
+      if (!heads[owner].compare_exchange_strong(expected, b)) {
+        katana::freePages(b, 1);
+      }
+    }
+    expected = nullptr;
+    heads[t].compare_exchange_strong(expected, heads[owner].load());
+  }
+  remotesReady.store(true, std::memory_order_release);
+}
+
+char*
+katana::PerBackend::initPerThread(unsigned maxT) {
+  initCommon(maxT);
+  return adoptOrAlloc(ThreadPool::getTID());
+}
+
 char*
 katana::PerBackend::initPerSocket(unsigned maxT) {
+  if (!heads) {
+    perSocket = true;
+  }
   initCommon(maxT);
   unsigned id = ThreadPool::getTID();
   unsigned leader = ThreadPool::getLeader();
   if (id == leader) {
-    char* b = heads[id] = (char*)alloc();
-    memset(b, 0, ptAllocSize);
-    return b;
+    return adoptOrAlloc(id);
   }
   char* expected = nullptr;
   // wait for leader to fix up socket
@@ -195,8 +285,13 @@ katana::PerBackend::initPerSocket(unsigned maxT) {
 void
 katana::initPTS(unsigned maxT) {
   if (!ptsBase) {
-    // unguarded initialization as initPTS will run in the master thread
-    // before any other threads are generated
+    // ptsBase is thread local, but heads is shared. Workers may run this
+    // while other threads, or allocOffset through initRemotes, are filling
+    // in heads. That is safe: heads itself is created by the master thread
+    // before any worker starts, initRemotes may already have installed this
+    // thread's block, which adoptOrAlloc then adopts, and otherwise
+    // adoptOrAlloc installs a new block with a CAS, keeping whichever block
+    // won.
     ptsBase = getPTSBackend().initPerThread(maxT);
   }
   if (!pssBase) {
@@ -0,0 +1,519 @@
+#include "katana/PropertyFilter.h"
+
+#include <algorithm>
+#include <functional>
+
+#include <fmt/format.h>
+
+#include "katana/ArrowVisitor.h"
+#include "katana/Galois.h"
+#include "katana/PropertyGraph.h"
+
+namespace katana {
+
+namespace {
+
+using Word = uint64_t;
+
+constexpr size_t kBitsPerWord = DynamicBitset::kNumBitsInUint64;
+
+/// Words of the bitset computed by one task
+constexpr size_t kWordsPerTask = 1024;
+
+static_assert(sizeof(CopyableAtomic<Word>) == sizeof(Word));
+
+/// Set each word of selected to the bits of its 64 entities, calling
+/// match(id) for each entity id; words are computed in parallel and each is
+/// written once, as a plain integer
+template <typename Match>
+void
+FillWords(DynamicBitset* selected, const Match& match) {
+  Word* words = reinterpret_cast<Word*>(selected->get_vec().data());
+  size_t num_words = selected->get_vec().size();
+  size_t num_entities = selected->size();
+  size_t num_tasks = (num_words + kWordsPerTask - 1) / kWordsPerTask;
+  katana::do_all(
+      katana::iterate(size_t{0}, num_tasks),
+      [&](size_t task) {
+        size_t end = std::min((task + 1) * kWordsPerTask, num_words);
+        for (size_t w = task * kWordsPerTask; w < end; ++w) {
+          size_t first = w * kBitsPerWord;
+          size_t n = std::min(kBitsPerWord, num_entities - first);
+          Word word = 0;
+          for (size_t i = 0; i < n; ++i) {
+            word |= Word{match(first + i)} << i;
+          }
+          words[w] = word;
+        }
+      },
+      katana::steal(), katana::no_stats());
+}
+
+/// As FillWords, also clearing the bits of the entities that are null in
+/// array
+template <typename Match>
+void
+FillWords(
+    const arrow::Array& array, DynamicBitset* selected, const Match& match) {
+  if (array.null_count() == 0) {
+    FillWords(selected, match);
+    return;
+  }
+  FillWords(selected, [&](size_t id) {
+    return array.IsValid(id) && match(id);
+  });
+}
+
+/// Set selected to the entities for which compare(value, key) is true, where
+/// get(id) is the value of entity id
+template <typename Get, typename Key>
+void
+SelectCompare(
+    const arrow::Array& array, PropertyPredicate::Op op, const Get& get,
+    const Key& key, DynamicBitset* selected) {
+  using Op = PropertyPredicate::Op;
+  switch (op) {
+  case Op::kEqual:
+    FillWords(array, selected, [&](size_t id) { return get(id) == key; });
+    break;
+  case Op::kNotEqual:
+    FillWords(array, selected, [&](size_t id) { return get(id) != key; });
+    break;
+  case Op::kLess:
+    FillWords(array, selected, [&](size_t id) { return get(id) < key; });
+    break;
+  case Op::kLessEqual:
+    FillWords(array, selected, [&](size_t id) { return get(id) <= key; });
+    break;
+  case Op::kGreater:
+    FillWords(array, selected, [&](size_t id) { return get(id) > key; });
+    break;
+  case Op::kGreaterEqual:
+    FillWords(array, selected, [&](size_t id) { return get(id) >= key; });
+    break;
+  }
+}
+
+/// Set selected to the entities whose value is one of keys, which are sorted
+template <typename Get, typename Key>
+void
+SelectIn(
+    const arrow::Array& array, const Get& get, const std::vector<Key>& keys,
+    DynamicBitset* selected) {
+  // Short lists are faster to scan than to search
+  constexpr size_t kMaxScannedKeys = 8;
+  if (keys.size() <= kMaxScannedKeys) {
+    FillWords(array, selected, [&](size_t id) {
+      return std::find(keys.begin(), keys.end(), get(id)) != keys.end();
+    });
+    return;
+  }
+  FillWords(array, selected, [&](size_t id) {
+    return std::binary_search(keys.begin(), keys.end(), get(id));
+  });
+}
+
+/// Evaluates a comparison or an IN-list over a property column, which is
+/// visited with its type
+class ColumnVisitor {
+public:
+  using ReturnType = void;
+  using ResultType = Result<ReturnType>;
+
+  ColumnVisitor(
+      bool is_in, PropertyPredicate::Op op,
+      const std::vector<std::shared_ptr<arrow::Scalar>>& values,
+      DynamicBitset* selected)
+      : is_in_(is_in), op_(op), values_(values), selected_(selected) {}
+
+  template <typename ArrowType, typename ArrayType>
+  arrow::enable_if_t<
+      (arrow::is_number_type<ArrowType>::value &&
+       !std::is_same_v<ArrowType, arrow::HalfFloatType>) ||
+          arrow::is_boolean_type<ArrowType>::value,
+      ResultType>
+  Call(const ArrayType& array) {
+    using ScalarType = typename arrow::TypeTraits<ArrowType>::ScalarType;
+    using CType = typename arrow::TypeTraits<ArrowType>::CType;
+
+    // Keys of boolean properties are bytes, which unlike std::vector<bool>
+    // can be sorted
+    using KeyType = std::conditional_t<
+        arrow::is_boolean_type<ArrowType>::value, uint8_t, CType>;
+
+    std::vector<KeyType> keys;
+    for (const auto& value : values_) {
+      auto scalar = KATANA_CHECKED(Cast(value, array.type()));
+      if (scalar->is_valid) {
+        keys.emplace_back(static_cast<const ScalarType&>(*scalar).value);
+      }
+    }
+    if constexpr (arrow::is_boolean_type<ArrowType>::value) {
+      return Select(array, [&](size_t id) { return array.Value(id); }, &keys);
+    } else {
+      const CType* data = array.raw_values();
+      return Select(array, [data](size_t id) { return data[id]; }, &keys);
+    }
+  }
+
+  template <typename ArrowType, typename ArrayType>
+  arrow::enable_if_string_like<ArrowType, ResultType> Call(
+      const ArrayType& array) {
+    using ScalarType = typename arrow::TypeTraits<ArrowType>::ScalarType;
+
+    // Strings of any width are taken as they are rather than cast
+    std::vector<std::string> strings;
+    for (const auto& value : values_) {
+      if (value && value->is_valid &&
+          arrow::is_base_binary_like(value->type->id())) {
+        strings.emplace_back(
+            static_cast<const arrow::BaseBinaryScalar&>(*value)
+                .value->ToString());
+        continue;
+      }
+      auto scalar = KATANA_CHECKED(Cast(value, array.type()));
+      if (scalar->is_valid) {
+        strings.emplace_back(
+            static_cast<const ScalarType&>(*scalar).value->ToString());
+      }
+    }
+    std::vector<std::string_view> keys(strings.begin(), strings.end());
+    return Select(
+        array,
+        [&](size_t id) {
+          auto view = array.GetView(id);
+          return std::string_view(view.data(), view.size());
+        },
+        &keys);
+  }
+
+  template <typename ArrowType, typename ArrayType>
+  arrow::enable_if_t<
+      !((arrow::is_number_type<ArrowType>::value &&
+         !std::is_same_v<ArrowType, arrow::HalfFloatType>) ||
+        arrow::is_boolean_type<ArrowType>::value ||
+        arrow::is_string_like_type<ArrowType>::value),
+      ResultType>
+  Call(const ArrayType& array) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "cannot filter on values of type {}",
+        array.type()->ToString());
+  }
+
+private:
+  static Result<std::shared_ptr<arrow::Scalar>> Cast(
+      const std::shared_ptr<arrow::Scalar>& value,
+      const std::shared_ptr<arrow::DataType>& type) {
+    if (!value) {
+      return KATANA_ERROR(ErrorCode::InvalidArgument, "value is null");
+    }
+    if (!value->is_valid) {
+      return arrow::MakeNullScalar(type);
+    }
+    if (value->type->Equals(*type)) {
+      return value;
+    }
+    auto cast_result = value->CastTo(type);
+    if (!cast_result.ok()) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "cannot compare {} with values of {}: {}",
+          value->ToString(), type->ToString(), cast_result.status());
+    }
+    return cast_result.ValueOrDie();
+  }
+
+  template <typename Get, typename Key>
+  ResultType Select(
+      const arrow::Array& array, const Get& get, std::vector<Key>* keys) {
+    if (is_in_) {
+      std::sort(keys->begin(), keys->end());
+      keys->erase(std::unique(keys->begin(), keys->end()), keys->end());
+      SelectIn(array, get, *keys, selected_);
+    } else if (keys->empty()) {
+      // Nothing compares with a null value
+      selected_->reset();
+    } else {
+      SelectCompare(array, op_, get, keys->front(), selected_);
+    }
+    return ResultSuccess();
+  }
+
+  bool is_in_;
+  PropertyPredicate::Op op_;
+  const std::vector<std::shared_ptr<arrow::Scalar>>& values_;
+  DynamicBitset* selected_;
+};
+
+/// Set selected to the entities whose code is set in matches
+template <typename CodeType>
+void
+SelectCodes(
+    const arrow::DictionaryArray& array, const std::vector<uint8_t>& matches,
+    DynamicBitset* selected) {
+  const CodeType* codes =
+      array.indices()->data()->template GetValues<CodeType>(1);
+  FillWords(array, selected, [&](size_t id) {
+    return matches[codes[id]] != 0;
+  });
+}
+
+/// Evaluate a comparison or an IN-list over a dictionary encoded column:
+/// once for each distinct value, on the dictionary, and then for each entity
+/// by looking up its code, so entities are never decoded
+Result<void>
+SelectDictionary(
+    const arrow::DictionaryArray& array, ColumnVisitor* visitor,
+    DynamicBitset* dictionary_selected, DynamicBitset* selected) {
+  const arrow::Array& dictionary = *array.dictionary();
+  dictionary_selected->resize(dictionary.length());
+  if (dictionary.length() > 0) {
+    KATANA_CHECKED(VisitArrow(dictionary, *visitor));
+  }
+  std::vector<uint8_t> matches(dictionary.length());
+  for (size_t code = 0; code < matches.size(); ++code) {
+    matches[code] = dictionary_selected->test(code);
+  }
+
+  switch (array.indices()->type_id()) {
+  case arrow::Type::INT8:
+    SelectCodes<int8_t>(array, matches, selected);
+    break;
+  case arrow::Type::UINT8:
+    SelectCodes<uint8_t>(array, matches, selected);
+    break;
+  case arrow::Type::INT16:
+    SelectCodes<int16_t>(array, matches, selected);
+    break;
+  case arrow::Type::UINT16:
+    SelectCodes<uint16_t>(array, matches, selected);
+    break;
+  case arrow::Type::INT32:
+    SelectCodes<int32_t>(array, matches, selected);
+    break;
+  case arrow::Type::UINT32:
+    SelectCodes<uint32_t>(array, matches, selected);
+    break;
+  case arrow::Type::INT64:
+    SelectCodes<int64_t>(array, matches, selected);
+    break;
+  case arrow::Type::UINT64:
+    SelectCodes<uint64_t>(array, matches, selected);
+    break;
+  default:
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "dictionary codes of type {}",
+        array.indices()->type()->ToString());
+  }
+  return ResultSuccess();
+}
+
+const char*
+OpToString(PropertyPredicate::Op op) {
+  using Op = PropertyPredicate::Op;
+  switch (op) {
+  case Op::kEqual:
+    return "==";
+  case Op::kNotEqual:
+    return "!=";
+  case Op::kLess:
+    return "<";
+  case Op::kLessEqual:
+    return "<=";
+  case Op::kGreater:
+    return ">";
+  case Op::kGreaterEqual:
+    return ">=";
+  }
+  return "?";
+}
+
+}  // namespace
+
+/// The nodes or the edges of a graph
+struct PropertyPredicate::Entities {
+  size_t num_entities;
+  std::function<Result<std::shared_ptr<arrow::ChunkedArray>>(
+      const std::string&)>
+      get_property;
+  const EntityTypeManager& type_manager;
+  const EntityTypeID* entity_type_ids;
+};
+
+PropertyPredicate
+PropertyPredicate::Compare(
+    const std::string& property_name, Op op,
+    std::shared_ptr<arrow::Scalar> value) {
+  return PropertyPredicate(std::make_shared<const Node>(
+      Node{Kind::kCompare, op, property_name, {std::move(value)}, {}}));
+}
+
+PropertyPredicate
+PropertyPredicate::Between(
+    const std::string& property_name, std::shared_ptr<arrow::Scalar> low,
+    std::shared_ptr<arrow::Scalar> high) {
+  return And({
+      Compare(property_name, Op::kGreaterEqual, std::move(low)),
+      Compare(property_name, Op::kLessEqual, std::move(high)),
+  });
+}
+
+PropertyPredicate
+PropertyPredicate::In(
+    const std::string& property_name,
+    std::vector<std::shared_ptr<arrow::Scalar>> values) {
+  return PropertyPredicate(std::make_shared<const Node>(
+      Node{Kind::kIn, Op::kEqual, property_name, std::move(values), {}}));
+}
+
+PropertyPredicate
+PropertyPredicate::HasType(const std::string& type_name) {
+  return PropertyPredicate(std::make_shared<const Node>(
+      Node{Kind::kHasType, Op::kEqual, type_name, {}, {}}));
+}
+
+PropertyPredicate
+PropertyPredicate::And(std::vector<PropertyPredicate> operands) {
+  return PropertyPredicate(std::make_shared<const Node>(
+      Node{Kind::kAnd, Op::kEqual, {}, {}, std::move(operands)}));
+}
+
+PropertyPredicate
+PropertyPredicate::Or(std::vector<PropertyPredicate> operands) {
+  return PropertyPredicate(std::make_shared<const Node>(
+      Node{Kind::kOr, Op::kEqual, {}, {}, std::move(operands)}));
+}
+
+PropertyPredicate
+PropertyPredicate::Not(PropertyPredicate operand) {
+  return PropertyPredicate(std::make_shared<const Node>(
+      Node{Kind::kNot, Op::kEqual, {}, {}, {std::move(operand)}}));
+}
+
+Result<void>
+PropertyPredicate::Evaluate(
+    const Entities& entities, DynamicBitset* selected) const {
+  selected->resize(entities.num_entities);
+
+  switch (node_->kind) {
+  case Kind::kCompare:
+  case Kind::kIn: {
+    auto column = KATANA_CHECKED_CONTEXT(
+        entities.get_property(node_->name), "filtering on {}", node_->name);
+    if (column->length() == 0) {
+      return ResultSuccess();
+    }
+    std::shared_ptr<arrow::Array> array =
+        KATANA_CHECKED(CombinedArray(column));
+    if (array->type_id() == arrow::Type::DICTIONARY) {
+      DynamicBitset dictionary_selected;
+      ColumnVisitor visitor(
+          node_->kind == Kind::kIn, node_->op, node_->values,
+          &dictionary_selected);
+      KATANA_CHECKED_CONTEXT(
+          SelectDictionary(
+              static_cast<const arrow::DictionaryArray&>(*array), &visitor,
+              &dictionary_selected, selected),
+          "filtering on {}", node_->name);
+      return ResultSuccess();
+    }
+    ColumnVisitor visitor(
+        node_->kind == Kind::kIn, node_->op, node_->values, selected);
+    KATANA_CHECKED_CONTEXT(
+        VisitArrow(*array, visitor), "filtering on {}", node_->name);
+    return ResultSuccess();
+  }
+  case Kind::kHasType: {
+    const EntityTypeManager& manager = entities.type_manager;
+    if (!manager.HasAtomicType(node_->name)) {
+      return KATANA_ERROR(
+          ErrorCode::NotFound, "no type named {}", node_->name);
+    }
+    // The types intersecting the atomic type, as a table that is small
+    // enough to stay in cache
+    std::vector<uint8_t> has_type(manager.GetNumEntityTypes());
+    manager.GetSupertypes(manager.GetEntityTypeID(node_->name))
+        .ForEach([&](EntityTypeID t) { has_type[t] = 1; });
+    const EntityTypeID* types = entities.entity_type_ids;
+    FillWords(selected, [&](size_t id) { return has_type[types[id]] != 0; });
+    return ResultSuccess();
+  }
+  case Kind::kAnd:
+  case Kind::kOr: {
+    bool is_and = node_->kind == Kind::kAnd;
+    if (node_->operands.empty()) {
+      FillWords(selected, [is_and](size_t) { return is_and; });
+      return ResultSuccess();
+    }
+    KATANA_CHECKED(node_->operands[0].Evaluate(entities, selected));
+    DynamicBitset operand_selected;
+    for (size_t i = 1; i < node_->operands.size(); ++i) {
+      KATANA_CHECKED(
+          node_->operands[i].Evaluate(entities, &operand_selected));
+      if (is_and) {
+        selected->bitwise_and(operand_selected);
+      } else {
+        selected->bitwise_or(operand_selected);
+      }
+    }
+    return ResultSuccess();
+  }
+  case Kind::kNot:
+    KATANA_CHECKED(node_->operands[0].Evaluate(entities, selected));
+    selected->bitwise_not();
+    return ResultSuccess();
+  }
+  return KATANA_ERROR(ErrorCode::InvalidArgument, "unknown predicate");
+}
+
+Result<DynamicBitset>
+PropertyPredicate::SelectNodes(const PropertyGraph& pg) const {
+  Entities nodes{
+      pg.num_nodes(),
+      [&pg](const std::string& name) { return pg.GetNodeProperty(name); },
+      pg.GetNodeTypeManager(), pg.node_type_data()};
+  DynamicBitset selected;
+  KATANA_CHECKED(Evaluate(nodes, &selected));
+  return Result<DynamicBitset>(std::move(selected));
+}
+
+Result<DynamicBitset>
+PropertyPredicate::SelectEdges(const PropertyGraph& pg) const {
+  Entities edges{
+      pg.num_edges(),
+      [&pg](const std::string& name) { return pg.GetEdgeProperty(name); },
+      pg.GetEdgeTypeManager(), pg.edge_type_data()};
+  DynamicBitset selected;
+  KATANA_CHECKED(Evaluate(edges, &selected));
+  return Result<DynamicBitset>(std::move(selected));
+}
+
+std::string
+PropertyPredicate::ToString() const {
+  std::string ret;
+  switch (node_->kind) {
+  case Kind::kCompare:
+    return fmt::format(
+        "{} {} {}", node_->name, OpToString(node_->op),
+        node_->values[0] ? node_->values[0]->ToString() : "null");
+  case Kind::kIn:
+    for (const auto& value : node_->values) {
+      ret += ret.empty() ? "" : ", ";
+      ret += value ? value->ToString() : "null";
+    }
+    return fmt::format("{} IN ({})", node_->name, ret);
+  case Kind::kHasType:
+    return fmt::format("HAS_TYPE({})", node_->name);
+  case Kind::kAnd:
+  case Kind::kOr:
+    for (const auto& operand : node_->operands) {
+      ret += ret.empty() ? "" : (node_->kind == Kind::kAnd ? " AND " : " OR ");
+      ret += operand.ToString();
+    }
+    return fmt::format("({})", ret);
+  case Kind::kNot:
+    return fmt::format("NOT {}", node_->operands[0].ToString());
+  }
+  return ret;
+}
+
+}  // namespace katana
@@ -3,18 +3,34 @@
 #include <stdio.h>
 #include <sys/mman.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <iomanip>
+#include <limits>
+#include <map>
 #include <memory>
 #include <utility>
 
+#include <arrow/compute/api.h>
+
 #include "katana/ArrowInterchange.h"
+#include "katana/CompressedGraphTopology.h"
+#include "katana/Env.h"
 #include "katana/Iterators.h"
 #include "katana/Logging.h"
 #include "katana/Loops.h"
+#include "katana/MemoryAccounting.h"
 #include "katana/NUMAArray.h"
+#include "katana/NumaMem.h"
 #include "katana/PerThreadStorage.h"
 #include "katana/Platform.h"
 #include "katana/Properties.h"
+#include "katana/Reduction.h"
 #include "katana/Result.h"
+#include "katana/Statistics.h"
+#include "katana/Threads.h"
+#include "tsuba/CSRTopology.h"
 #include "tsuba/Errors.h"
 #include "tsuba/FileFrame.h"
 #include "tsuba/RDG.h"
@@ -31,32 +47,211 @@ GetGraphSize(uint64_t num_nodes, uint64_t num_edges) {
          (num_edges * sizeof(uint32_t));
 }
 
-[[maybe_unused]] bool
+/// Check, in parallel, that the adjacency indices of a topology are
+/// nondecreasing and end at num_edges and that every destination is a node
+katana::Result<void>
 CheckTopology(
     const uint64_t* out_indices, const uint64_t num_nodes,
     const uint32_t* out_dests, const uint64_t num_edges) {
-  bool has_bad_adj = false;
+  const uint64_t last_index = num_nodes > 0 ? out_indices[num_nodes - 1] : 0;
+  if (last_index != num_edges) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "last adjacency index {} differs from the number of edges {}",
+        last_index, num_edges);
+  }
 
+  katana::GReduceMin<uint64_t> first_bad_adj;
   katana::do_all(
-      katana::iterate(uint64_t{0}, num_nodes),
+      katana::iterate(uint64_t{1}, num_nodes),
       [&](auto n) {
-        if (out_indices[n] > num_edges) {
-          has_bad_adj = true;
+        if (out_indices[n - 1] > out_indices[n]) {
+          first_bad_adj.update(n);
         }
       },
       katana::no_stats());
+  if (uint64_t n = first_bad_adj.reduce(); n < num_nodes) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "adjacency index {} of node {} is less than {} of node {}",
+        out_indices[n], n, out_indices[n - 1], n - 1);
+  }
 
-  bool has_bad_dest = false;
+  katana::GReduceMin<uint64_t> first_bad_dest;
   katana::do_all(
       katana::iterate(uint64_t{0}, num_edges),
       [&](auto e) {
         if (out_dests[e] >= num_nodes) {
+          first_bad_dest.update(e);
+        }
+      },
+      katana::no_stats());
+  if (uint64_t e = first_bad_dest.reduce(); e < num_edges) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "destination {} of edge {} is not one of the {} nodes", out_dests[e],
+        e, num_nodes);
+  }
+
+  return katana::ResultSuccess();
+}
+
+/// ReadCompressedTopology copies a kCompressedCSRTopologyVersion topology
+/// file (see tsuba/CSRTopology.h) without decoding its destinations
+katana::Result<katana::CompressedGraphTopology>
+ReadCompressedTopology(const tsuba::FileView& file_view) {
+  const auto* data = file_view.ptr<uint8_t>();
+  tsuba::CSRTopologyHeader header;
+  tsuba::CompressedCSRTopologyHeader compressed_header;
+  const uint64_t index_offset = sizeof(header);
+  if (file_view.size() < index_offset) {
+    return katana::ErrorCode::InvalidArgument;
+  }
+  std::memcpy(&header, data, sizeof(header));
+
+  const uint64_t compressed_header_offset =
+      index_offset + header.num_nodes * sizeof(uint64_t);
+  if (file_view.size() < compressed_header_offset + sizeof(compressed_header)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "file_view size: {} too small for {} nodes", file_view.size(),
+        header.num_nodes);
+  }
+  std::memcpy(
+      &compressed_header, data + compressed_header_offset,
+      sizeof(compressed_header));
+
+  uint64_t expected_size =
+      tsuba::CompressedCSRTopologyFileSize(header, compressed_header);
+  if (file_view.size() < expected_size) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "file_view size: {} expected {}",
+        file_view.size(), expected_size);
+  }
+
+  const uint64_t offsets_offset =
+      compressed_header_offset + sizeof(compressed_header);
+  const uint64_t payload_offset =
+      offsets_offset + (compressed_header.num_blocks + 1) * sizeof(uint64_t);
+  return katana::CompressedGraphTopology(
+      reinterpret_cast<const uint64_t*>(data + index_offset), header.num_nodes,
+      header.num_edges, compressed_header.edges_per_block,
+      reinterpret_cast<const uint64_t*>(data + offsets_offset),
+      compressed_header.num_blocks, data + payload_offset,
+      compressed_header.payload_size);
+}
+
+/// MapCompressedTopology decodes a kCompressedCSRTopologyVersion topology
+/// file into an uncompressed topology
+katana::Result<katana::GraphTopology>
+MapCompressedTopology(const tsuba::FileView& file_view) {
+  katana::CompressedGraphTopology compressed =
+      KATANA_CHECKED(ReadCompressedTopology(file_view));
+  return compressed.Decompress();
+}
+
+/// MapWideTopology copies a kCSRTopology64Version topology, whose
+/// destinations are stored as uint64_t, into a GraphTopology if its node IDs
+/// fit in GraphTopology::Node. Larger graphs have to be loaded in partitions,
+/// e.g., with tsuba::LoadPartitionedSlice, whose local IDs fit.
+katana::Result<katana::GraphTopology>
+MapWideTopology(const tsuba::FileView& file_view) {
+  using Node = katana::GraphTopology::Node;
+  using Edge = katana::GraphTopology::Edge;
+
+  tsuba::CSRTopologyHeader header;
+  if (file_view.size() < sizeof(header)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "topology file is too small");
+  }
+  std::memcpy(&header, file_view.ptr<uint8_t>(), sizeof(header));
+  uint64_t expected_size = tsuba::CSRTopologyFileSize(header);
+  if (file_view.size() < expected_size) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "file_view size: {} expected {}",
+        file_view.size(), expected_size);
+  }
+  if (header.num_nodes > uint64_t{std::numeric_limits<Node>::max()} + 1) {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotImplemented,
+        "{} nodes do not fit in 32-bit node IDs; load the graph in partitions",
+        header.num_nodes);
+  }
+
+  const uint64_t* out_indices =
+      file_view.ptr<uint64_t>(sizeof(tsuba::CSRTopologyHeader));
+  const uint64_t* out_dests = out_indices + header.num_nodes;
+
+  katana::NUMAArray<Edge> adj_indices;
+  katana::NUMAArray<Node> dests;
+  adj_indices.allocateInterleaved(header.num_nodes);
+  dests.allocateInterleaved(header.num_edges);
+  katana::ParallelSTL::copy(
+      out_indices, out_indices + header.num_nodes, adj_indices.begin());
+
+  std::atomic<bool> has_bad_dest = false;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, header.num_edges),
+      [&](uint64_t e) {
+        if (out_dests[e] >= header.num_nodes) {
           has_bad_dest = true;
         }
+        dests[e] = static_cast<Node>(out_dests[e]);
       },
       katana::no_stats());
+  if (has_bad_dest) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "destination out of range");
+  }
+
+  return katana::GraphTopology(std::move(adj_indices), std::move(dests));
+}
 
-  return !has_bad_adj && !has_bad_dest;
+/// \returns the placement requested by KATANA_TOPOLOGY_PLACEMENT. Unless a
+/// NUMA placement is requested, the topology reads the mapped file.
+katana::GraphTopology::Placement
+TopologyPlacementFromEnv() {
+  std::string placement;
+  if (!katana::GetEnv("KATANA_TOPOLOGY_PLACEMENT", &placement) ||
+      placement == "borrowed") {
+    return katana::GraphTopology::Placement::kBorrowed;
+  }
+  if (placement == "interleaved") {
+    return katana::GraphTopology::Placement::kInterleaved;
+  }
+  if (placement == "blocked") {
+    return katana::GraphTopology::Placement::kBlocked;
+  }
+  KATANA_WARN_ONCE(
+      "unknown KATANA_TOPOLOGY_PLACEMENT {}, using the mapped file", placement);
+  return katana::GraphTopology::Placement::kBorrowed;
+}
+
+/// Report the page sizes and NUMA nodes backing \p array as statistics
+void
+ReportPlacement(const std::string& name, const void* array, size_t bytes) {
+  katana::PagePlacement placement = katana::GetPagePlacement(array, bytes);
+  katana::ReportStatSingle("PropertyGraph", name + "Bytes", bytes);
+  katana::ReportStatSingle(
+      "PropertyGraph", name + "HugePageBytes", placement.huge_page_bytes);
+  for (size_t i = 0; i < placement.sampled_pages_per_node.size(); ++i) {
+    katana::ReportStatSingle(
+        "PropertyGraph", fmt::format("{}SampledPagesOnNode{}", name, i),
+        placement.sampled_pages_per_node[i]);
+  }
+  katana::ReportStatSingle(
+      "PropertyGraph", name + "SampledPagesUnknown",
+      placement.sampled_pages_unknown);
+}
+
+void
+ReportTopologyPlacement(const katana::GraphTopology& topo) {
+  ReportPlacement(
+      "TopologyAdjIndices", topo.adj_data(),
+      topo.num_nodes() * sizeof(katana::GraphTopology::Edge));
+  ReportPlacement(
+      "TopologyDests", topo.dest_data(),
+      topo.num_edges() * sizeof(katana::GraphTopology::Node));
 }
 
 /// MapTopology takes a file buffer of a topology file and extracts the
@@ -75,6 +270,9 @@ CheckTopology(
 ///
 /// Since property graphs store their edge data separately, we will
 /// ignore the size_of_edge_data (data[1]).
+///
+/// Compressed topology files (version 3) are decoded by MapCompressedTopology
+/// and files with 64-bit destinations (version 2) by MapWideTopology.
 katana::Result<katana::GraphTopology>
 MapTopology(const tsuba::FileView& file_view) {
   const auto* data = file_view.ptr<uint64_t>();
@@ -82,7 +280,20 @@ MapTopology(const tsuba::FileView& file_view) {
     return katana::ErrorCode::InvalidArgument;
   }
 
-  if (data[0] != 1) {
+  if (data[0] == tsuba::kCompressedCSRTopologyVersion) {
+    katana::GraphTopology topo =
+        KATANA_CHECKED(MapCompressedTopology(file_view));
+    ReportTopologyPlacement(topo);
+    return katana::GraphTopology(std::move(topo));
+  }
+
+  if (data[0] == tsuba::kCSRTopology64Version) {
+    katana::GraphTopology topo = KATANA_CHECKED(MapWideTopology(file_view));
+    ReportTopologyPlacement(topo);
+    return katana::GraphTopology(std::move(topo));
+  }
+
+  if (data[0] != tsuba::kCSRTopologyVersion) {
     return katana::ErrorCode::InvalidArgument;
   }
 
@@ -103,7 +314,13 @@ MapTopology(const tsuba::FileView& file_view) {
 
   KATANA_LOG_DEBUG_ASSERT(
       CheckTopology(out_indices, num_nodes, out_dests, num_edges));
-  return katana::GraphTopology(out_indices, num_nodes, out_dests, num_edges);
+  // A borrowed topology reads file_view, which the RDG keeps bound until the
+  // topology of the graph is replaced or dropped
+  katana::GraphTopology topo(
+      out_indices, num_nodes, out_dests, num_edges,
+      TopologyPlacementFromEnv());
+  ReportTopologyPlacement(topo);
+  return katana::GraphTopology(std::move(topo));
 }
 
 katana::Result<std::unique_ptr<tsuba::FileFrame>>
@@ -143,31 +360,211 @@ WriteTopology(const katana::GraphTopology& topology) {
   return std::unique_ptr<tsuba::FileFrame>(std::move(ff));
 }
 
+katana::Result<void>
+WriteToFrame(tsuba::FileFrame* ff, const void* buf, uint64_t size) {
+  if (size == 0) {
+    return katana::ResultSuccess();
+  }
+  arrow::Status aro_sts = ff->Write(buf, size);
+  if (!aro_sts.ok()) {
+    return tsuba::ArrowToTsuba(aro_sts.code());
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<std::unique_ptr<tsuba::FileFrame>>
+WriteCompressedTopology(const katana::GraphTopology& topology) {
+  auto ff = std::make_unique<tsuba::FileFrame>();
+  if (auto res = ff->Init(); !res) {
+    return res.error();
+  }
+  katana::CompressedGraphTopology compressed =
+      katana::CompressedGraphTopology::Make(topology);
+
+  tsuba::CSRTopologyHeader header{
+      .version = tsuba::kCompressedCSRTopologyVersion,
+      .edge_type_size = 0,
+      .num_nodes = compressed.num_nodes(),
+      .num_edges = compressed.num_edges(),
+  };
+  tsuba::CompressedCSRTopologyHeader compressed_header{
+      .edges_per_block = compressed.edges_per_block(),
+      .num_blocks = compressed.num_blocks(),
+      .payload_size = compressed.payload_size(),
+  };
+  KATANA_LOG_DEBUG(
+      "compressed topology destinations from {} to {} bytes",
+      compressed.num_edges() * sizeof(katana::GraphTopology::Node),
+      compressed.payload_size());
+
+  auto write = [&ff](const void* buf, uint64_t size) {
+    return WriteToFrame(ff.get(), buf, size);
+  };
+
+  KATANA_CHECKED(write(&header, sizeof(header)));
+  KATANA_CHECKED(write(
+      compressed.adj_data(), compressed.num_nodes() * sizeof(uint64_t)));
+  KATANA_CHECKED(write(&compressed_header, sizeof(compressed_header)));
+  KATANA_CHECKED(write(
+      compressed.block_offset_data(),
+      (compressed.num_blocks() + 1) * sizeof(uint64_t)));
+  KATANA_CHECKED(
+      write(compressed.payload_data(), compressed.payload_size()));
+
+  uint64_t padding =
+      katana::AlignUp<uint64_t>(compressed.payload_size()) -
+      compressed.payload_size();
+  uint64_t zeros = 0;
+  KATANA_CHECKED(write(&zeros, padding));
+
+  return std::unique_ptr<tsuba::FileFrame>(std::move(ff));
+}
+
+/// WriteDerivedTopology serializes an edge shuffled topology in the
+/// kDerivedCSRTopologyVersion format (see tsuba/CSRTopology.h)
+katana::Result<std::unique_ptr<tsuba::FileFrame>>
+WriteDerivedTopology(const katana::EdgeShuffleTopology& topology) {
+  auto ff = std::make_unique<tsuba::FileFrame>();
+  KATANA_CHECKED(ff->Init());
+
+  tsuba::CSRTopologyHeader header{
+      .version = tsuba::kDerivedCSRTopologyVersion,
+      .edge_type_size = 0,
+      .num_nodes = topology.num_nodes(),
+      .num_edges = topology.num_edges(),
+  };
+  const uint64_t dests_size =
+      header.num_edges * sizeof(katana::GraphTopology::Node);
+  uint64_t zeros = 0;
+
+  KATANA_CHECKED(WriteToFrame(ff.get(), &header, sizeof(header)));
+  KATANA_CHECKED(WriteToFrame(
+      ff.get(), topology.adj_data(), header.num_nodes * sizeof(uint64_t)));
+  KATANA_CHECKED(WriteToFrame(ff.get(), topology.dest_data(), dests_size));
+  KATANA_CHECKED(WriteToFrame(
+      ff.get(), &zeros, katana::AlignUp<uint64_t>(dests_size) - dests_size));
+  KATANA_CHECKED(WriteToFrame(
+      ff.get(), topology.edge_prop_index_data(),
+      header.num_edges * sizeof(katana::GraphTopology::PropertyIndex)));
+
+  return std::unique_ptr<tsuba::FileFrame>(std::move(ff));
+}
+
+/// MapDerivedTopology copies a kDerivedCSRTopologyVersion file into an edge
+/// shuffled topology with the given states
+katana::Result<std::unique_ptr<katana::EdgeShuffleTopology>>
+MapDerivedTopology(
+    const tsuba::FileView& file_view,
+    const katana::EdgeShuffleTopology::TransposeKind& tpose_state,
+    const katana::EdgeShuffleTopology::EdgeSortKind& edge_sort_state) {
+  const auto* data = file_view.ptr<uint8_t>();
+  tsuba::CSRTopologyHeader header;
+  if (file_view.size() < sizeof(header)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "derived topology file too small: {}", file_view.size());
+  }
+  std::memcpy(&header, data, sizeof(header));
+
+  if (header.version != tsuba::kDerivedCSRTopologyVersion) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "unexpected derived topology version: {}", header.version);
+  }
+  uint64_t expected_size = tsuba::DerivedCSRTopologyFileSize(header);
+  if (file_view.size() < expected_size) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "file_view size: {} expected {}",
+        file_view.size(), expected_size);
+  }
+
+  const uint64_t dests_offset =
+      sizeof(header) + header.num_nodes * sizeof(uint64_t);
+  const uint64_t prop_indices_offset =
+      dests_offset +
+      katana::AlignUp<uint64_t>(
+          header.num_edges * sizeof(katana::GraphTopology::Node));
+
+  const auto* out_indices =
+      reinterpret_cast<const uint64_t*>(data + sizeof(header));
+  const auto* out_dests =
+      reinterpret_cast<const uint32_t*>(data + dests_offset);
+  const auto* prop_indices =
+      reinterpret_cast<const uint64_t*>(data + prop_indices_offset);
+
+  // Unlike the main topology, a derived one is checked in every build: its
+  // edge property indices address the property arrays of the graph, so a
+  // stale or damaged file would read past them
+  KATANA_CHECKED_CONTEXT(
+      CheckTopology(
+          out_indices, header.num_nodes, out_dests, header.num_edges),
+      "checking derived topology");
+  katana::GReduceMin<uint64_t> first_bad_index;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, header.num_edges),
+      [&](auto e) {
+        if (prop_indices[e] >= header.num_edges) {
+          first_bad_index.update(e);
+        }
+      },
+      katana::no_stats());
+  if (uint64_t e = first_bad_index.reduce(); e < header.num_edges) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "edge property index {} of edge {} is not one of the {} edges",
+        prop_indices[e], e, header.num_edges);
+  }
+
+  return katana::EdgeShuffleTopology::MakeFromArrays(
+      tpose_state, edge_sort_state, out_indices, header.num_nodes, out_dests,
+      prop_indices, header.num_edges);
+}
+
 /// MapEntityTypeIDsFromFile takes a file buffer of a node or edge Type set ID file
 /// and extracts the property graph type set ids from it. It is an alternative way
 /// of extracting EntityTypeIDs and extraction from properties will be depreciated in
 /// favor of this method.
+///
+/// Each type ID in the file is id_size bytes; files stored before type IDs
+/// were widened hold 8 bit IDs, which are widened here.
 katana::Result<katana::PropertyGraph::EntityTypeIDArray>
-MapEntityTypeIDsArray(const tsuba::FileView& file_view) {
-  const auto* data = file_view.ptr<uint64_t>();
-  const int64_t type_ID_array_size = data[0];
-
-  if (file_view.size() == 0) {
+MapEntityTypeIDsArray(const tsuba::FileView& file_view, size_t id_size) {
+  if (file_view.size() < sizeof(uint64_t)) {
     return katana::ErrorCode::InvalidArgument;
   }
 
-  const katana::EntityTypeID* type_IDs_array =
-      reinterpret_cast<const katana::EntityTypeID*>(&data[1]);
+  const auto* data = file_view.ptr<uint64_t>();
+  const int64_t type_ID_array_size = data[0];
 
-  KATANA_LOG_DEBUG_ASSERT(type_IDs_array != nullptr);
+  if (file_view.size() < sizeof(uint64_t) + type_ID_array_size * id_size) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "type id array of {} bytes is too small for {} type ids of {} bytes",
+        file_view.size(), type_ID_array_size, id_size);
+  }
 
   // allocate type IDs array
   katana::PropertyGraph::EntityTypeIDArray entity_type_id_array;
   entity_type_id_array.allocateInterleaved(type_ID_array_size);
 
-  katana::ParallelSTL::copy(
-      &type_IDs_array[0], &type_IDs_array[type_ID_array_size],
-      entity_type_id_array.begin());
+  auto copy = [&](const auto* type_IDs_array) {
+    KATANA_LOG_DEBUG_ASSERT(type_IDs_array != nullptr);
+    katana::ParallelSTL::copy(
+        &type_IDs_array[0], &type_IDs_array[type_ID_array_size],
+        entity_type_id_array.begin());
+  };
+  switch (id_size) {
+  case sizeof(uint8_t):
+    copy(reinterpret_cast<const uint8_t*>(&data[1]));
+    break;
+  case sizeof(katana::EntityTypeID):
+    copy(reinterpret_cast<const katana::EntityTypeID*>(&data[1]));
+    break;
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unsupported type id size {}",
+        id_size);
+  }
 
   return katana::MakeResult(std::move(entity_type_id_array));
 }
@@ -208,22 +605,107 @@ MakeDefaultEntityTypeIDArray(size_t vec_sz) {
   return type_ids;
 }
 
+/// Move the contents of array into shared storage and leave array borrowing
+/// them. \returns the owner of the storage.
+template <typename T>
+std::shared_ptr<const void>
+MoveArrayToSharedStorage(katana::NUMAArray<T>* array) {
+  auto shared = std::make_shared<katana::NUMAArray<T>>(std::move(*array));
+  *array = katana::NUMAArray<T>(shared->data(), shared->size());
+  return shared;
+}
+
+/// An array that borrows the contents of array
+template <typename T>
+katana::NUMAArray<T>
+BorrowArray(const katana::NUMAArray<T>& array) {
+  // The contents are only read; changes replace the array
+  return katana::NUMAArray<T>(const_cast<T*>(array.data()), array.size());
+}
+
+/// WritePropertyIndexes serializes the indexes that are not stored in rdg,
+/// or all of them if rewrite_all
+template <typename node_or_edge>
+katana::Result<void>
+WritePropertyIndexes(
+    const std::vector<std::unique_ptr<katana::PropertyIndex<node_or_edge>>>&
+        indexes,
+    bool is_edge_property, const tsuba::RDG& rdg, bool rewrite_all,
+    std::vector<tsuba::PropertyIndexFrame>* frames) {
+  const auto& stored = rdg.property_indexes();
+  for (const auto& index : indexes) {
+    tsuba::PropertyIndexInfo info{
+        .property_name = index->column_name(),
+        .is_edge_property = is_edge_property,
+        .kind = static_cast<int32_t>(index->kind()),
+        .num_entities = index->num_entities(),
+    };
+    bool is_stored = std::any_of(
+        stored.begin(), stored.end(),
+        [&](const tsuba::PropertyIndexInfo& other) {
+          return other.property_name == info.property_name &&
+                 other.is_edge_property == is_edge_property &&
+                 other.kind == info.kind;
+        });
+    if (is_stored && !rewrite_all) {
+      continue;
+    }
+    KATANA_LOG_DEBUG("persisting property index {}", info.property_name);
+    frames->emplace_back(tsuba::PropertyIndexFrame{
+        .info = std::move(info),
+        .ff = KATANA_CHECKED(index->Write()),
+    });
+  }
+  return katana::ResultSuccess();
+}
+
+/// BuildPropertyIndex maps the index of the same kind over the same property
+/// stored in rdg if there is one, and builds index from its property
+/// otherwise
+template <typename node_or_edge>
+katana::Result<void>
+BuildPropertyIndex(
+    const tsuba::RDG& rdg, bool is_edge_property,
+    katana::PropertyIndex<node_or_edge>* index) {
+  const auto& stored = rdg.property_indexes();
+  auto it = std::find_if(
+      stored.begin(), stored.end(), [&](const tsuba::PropertyIndexInfo& info) {
+        return info.property_name == index->column_name() &&
+               info.is_edge_property == is_edge_property &&
+               info.kind == static_cast<int32_t>(index->kind()) &&
+               info.num_entities == index->num_entities();
+      });
+  if (it != stored.end()) {
+    std::shared_ptr<tsuba::FileView> file =
+        KATANA_CHECKED(rdg.MapPropertyIndex(*it));
+    auto res = index->BuildFromFile(std::move(file));
+    if (res) {
+      return katana::ResultSuccess();
+    }
+    KATANA_LOG_WARN("rebuilding property index {}: {}", it->path, res.error());
+  }
+  return index->BuildFromProperty();
+}
+
 }  // namespace
 
 katana::Result<std::unique_ptr<katana::PropertyGraph>>
 katana::PropertyGraph::Make(
     std::unique_ptr<tsuba::RDGFile> rdg_file, tsuba::RDG&& rdg) {
+  MemoryCategoryScope memory_category(MemoryCategory::kTopology);
   katana::GraphTopology topo =
       KATANA_CHECKED(MapTopology(rdg.topology_file_storage()));
 
   if (rdg.IsEntityTypeIDsOutsideProperties()) {
     KATANA_LOG_DEBUG("loading EntityType data from outside properties");
 
-    EntityTypeIDArray node_type_ids = KATANA_CHECKED(
-        MapEntityTypeIDsArray(rdg.node_entity_type_id_array_file_storage()));
+    EntityTypeIDArray node_type_ids = KATANA_CHECKED(MapEntityTypeIDsArray(
+        rdg.node_entity_type_id_array_file_storage(),
+        rdg.EntityTypeIDStorageSize()));
 
-    EntityTypeIDArray edge_type_ids = KATANA_CHECKED(
-        MapEntityTypeIDsArray(rdg.edge_entity_type_id_array_file_storage()));
+    EntityTypeIDArray edge_type_ids = KATANA_CHECKED(MapEntityTypeIDsArray(
+        rdg.edge_entity_type_id_array_file_storage(),
+        rdg.EntityTypeIDStorageSize()));
 
     KATANA_ASSERT(topo.num_nodes() == node_type_ids.size());
     KATANA_ASSERT(topo.num_edges() == edge_type_ids.size());
@@ -280,6 +762,30 @@ katana::PropertyGraph::Make(
       std::make_unique<tsuba::RDGFile>(std::move(rdg_file)), std::move(rdg));
 }
 
+katana::Result<katana::CompressedGraphTopology>
+katana::PropertyGraph::LoadCompressedTopology(const std::string& rdg_name) {
+  tsuba::RDGFile rdg_file{
+      KATANA_CHECKED(tsuba::Open(rdg_name, tsuba::kReadOnly))};
+  tsuba::RDGLoadOptions opts;
+  opts.node_properties = std::vector<std::string>{};
+  opts.edge_properties = std::vector<std::string>{};
+  tsuba::RDG rdg = KATANA_CHECKED(tsuba::RDG::Make(rdg_file, opts));
+
+  MemoryCategoryScope memory_category(MemoryCategory::kTopology);
+  const tsuba::FileView& file_view = rdg.topology_file_storage();
+  if (file_view.size() >= sizeof(uint64_t) &&
+      *file_view.ptr<uint64_t>() == tsuba::kCompressedCSRTopologyVersion) {
+    // Callers index node arrays with the destinations they decode, so check
+    // them once here rather than on every dests() call
+    katana::CompressedGraphTopology topo =
+        KATANA_CHECKED(ReadCompressedTopology(file_view));
+    KATANA_CHECKED(topo.Validate());
+    return katana::Result<katana::CompressedGraphTopology>(std::move(topo));
+  }
+  katana::GraphTopology topo = KATANA_CHECKED(MapTopology(file_view));
+  return katana::CompressedGraphTopology::Make(topo);
+}
+
 katana::Result<std::unique_ptr<katana::PropertyGraph>>
 katana::PropertyGraph::Make(katana::GraphTopology&& topo_to_assign) {
   return std::make_unique<katana::PropertyGraph>(
@@ -314,13 +820,103 @@ katana::Result<std::unique_ptr<katana::PropertyGraph>>
 katana::PropertyGraph::Copy(
     const std::vector<std::string>& node_properties,
     const std::vector<std::string>& edge_properties) const {
-  // TODO(gill): This should copy the RDG in memory without reloading from storage.
-  tsuba::RDGLoadOptions opts;
-  opts.partition_id_to_load = partition_id();
-  opts.node_properties = node_properties;
-  opts.edge_properties = edge_properties;
+  auto copy = std::make_unique<PropertyGraph>();
+  copy->topology_ = topology_.Share();
+  copy->node_entity_type_manager_ = node_entity_type_manager_;
+  copy->edge_entity_type_manager_ = edge_entity_type_manager_;
+  copy->node_entity_type_ids_ = BorrowArray(node_entity_type_ids_);
+  copy->node_entity_type_ids_owner_ = node_entity_type_ids_owner_;
+  copy->edge_entity_type_ids_ = BorrowArray(edge_entity_type_ids_);
+  copy->edge_entity_type_ids_owner_ = edge_entity_type_ids_owner_;
+
+  // Arrow arrays are immutable, so the tables of the copy reference the
+  // columns of this. A column referenced by both is replaced rather than
+  // overwritten by an upsert.
+  auto share_columns = [](const std::vector<std::string>& names,
+                          auto get_property, auto get_schema,
+                          auto add_properties) -> Result<void> {
+    arrow::FieldVector fields;
+    std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+    for (const auto& name : names) {
+      std::shared_ptr<arrow::ChunkedArray> column =
+          KATANA_CHECKED(get_property(name));
+      fields.emplace_back(get_schema()->GetFieldByName(name));
+      columns.emplace_back(std::move(column));
+    }
+    if (columns.empty()) {
+      return ResultSuccess();
+    }
+    return add_properties(
+        arrow::Table::Make(arrow::schema(fields), std::move(columns)));
+  };
+  KATANA_CHECKED(share_columns(
+      node_properties, [&](const auto& name) { return GetNodeProperty(name); },
+      [&]() { return loaded_node_schema(); },
+      [&](const auto& t) { return copy->AddNodeProperties(t); }));
+  KATANA_CHECKED(share_columns(
+      edge_properties, [&](const auto& name) { return GetEdgeProperty(name); },
+      [&]() { return loaded_edge_schema(); },
+      [&](const auto& t) { return copy->AddEdgeProperties(t); }));
+
+  return MakeResult(std::move(copy));
+}
+
+void
+katana::PropertyGraph::MoveToSharedStorage() noexcept {
+  topology_.MoveToSharedStorage();
+  MoveNodeTypeIDsToSharedStorage();
+  MoveEdgeTypeIDsToSharedStorage();
+}
+
+void
+katana::PropertyGraph::MoveNodeTypeIDsToSharedStorage() noexcept {
+  node_entity_type_ids_owner_ =
+      MoveArrayToSharedStorage(&node_entity_type_ids_);
+}
 
-  return Make(rdg_dir(), opts);
+void
+katana::PropertyGraph::MoveEdgeTypeIDsToSharedStorage() noexcept {
+  edge_entity_type_ids_owner_ =
+      MoveArrayToSharedStorage(&edge_entity_type_ids_);
+}
+
+std::shared_ptr<const katana::PropertyGraphSnapshot>
+katana::PropertyGraph::Snapshot() {
+  std::lock_guard<std::mutex> lock(*version_mutex_);
+  if (auto snapshot = snapshot_.lock()) {
+    return snapshot;
+  }
+
+  const GraphTopology* topology = &topology_;
+  if (!topology_.shareable()) {
+    // Read straight from a mapped file, which goes away when the topology is
+    // replaced
+    if (!mapped_topology_copy_.shareable()) {
+      mapped_topology_copy_ = GraphTopology::Copy(topology_);
+      mapped_topology_copy_.MoveToSharedStorage();
+    }
+    topology = &mapped_topology_copy_;
+  }
+
+  std::shared_ptr<PropertyGraphSnapshot> snapshot(new PropertyGraphSnapshot);
+  snapshot->version_ = version_;
+  snapshot->topology_ = topology->Share();
+  snapshot->node_properties_ = rdg_.node_properties();
+  snapshot->edge_properties_ = rdg_.edge_properties();
+  snapshot->node_entity_type_ids_ = BorrowArray(node_entity_type_ids_);
+  snapshot->node_entity_type_ids_owner_ = node_entity_type_ids_owner_;
+  snapshot->edge_entity_type_ids_ = BorrowArray(edge_entity_type_ids_);
+  snapshot->edge_entity_type_ids_owner_ = edge_entity_type_ids_owner_;
+  snapshot_ = snapshot;
+  return snapshot;
+}
+
+void
+katana::PropertyGraph::UnshareTopology() noexcept {
+  VersionChange change(this);
+  topology_.Unshare();
+  mapped_topology_copy_ = GraphTopology{};
+  change.Commit();
 }
 
 katana::Result<void>
@@ -335,6 +931,12 @@ katana::PropertyGraph::Validate() {
   //  return ErrorCode::InvalidArgument;
   //}
 
+  KATANA_CHECKED_CONTEXT(
+      CheckTopology(
+          topology().adj_data(), num_nodes(), topology().dest_data(),
+          num_edges()),
+      "checking topology");
+
   uint64_t num_node_rows =
       static_cast<uint64_t>(rdg_.node_properties()->num_rows());
   if (num_node_rows == 0) {
@@ -397,12 +999,23 @@ katana::PropertyGraph::ConstructEntityTypeIDs() {
   // only relevant to actually construct when EntityTypeIDs are expected in properties
   // when EntityTypeIDs are not expected in properties then we have nothing to do here
   KATANA_LOG_WARN("Loading types from properties.");
+  VersionChange change(this);
+  // The old types are dropped before the new ones are built, so even a
+  // failed construction changes the graph
+  change.Commit();
+  // Cached type partitions and topologies sorted by type describe the old
+  // types
+  size_t byte_budget = pg_view_cache_.byte_budget();
+  pg_view_cache_ = PGViewCache();
+  pg_view_cache_.set_byte_budget(byte_budget);
   node_entity_type_manager_ = EntityTypeManager{};
   node_entity_type_ids_ = EntityTypeIDArray{};
   node_entity_type_ids_.allocateInterleaved(num_nodes());
   KATANA_CHECKED(EntityTypeManager::AssignEntityTypeIDsFromProperties(
       num_nodes(), rdg_.node_properties(), &node_entity_type_manager_,
       &node_entity_type_ids_));
+  MoveNodeTypeIDsToSharedStorage();
+  KATANA_CHECKED(rdg_.UnbindNodeEntityTypeIDArrayFileStorage());
 
   edge_entity_type_manager_ = EntityTypeManager{};
   edge_entity_type_ids_ = EntityTypeIDArray{};
@@ -410,6 +1023,8 @@ katana::PropertyGraph::ConstructEntityTypeIDs() {
   KATANA_CHECKED(EntityTypeManager::AssignEntityTypeIDsFromProperties(
       num_edges(), rdg_.edge_properties(), &edge_entity_type_manager_,
       &edge_entity_type_ids_));
+  MoveEdgeTypeIDsToSharedStorage();
+  KATANA_CHECKED(rdg_.UnbindEdgeEntityTypeIDArrayFileStorage());
 
   return katana::ResultSuccess();
 }
@@ -428,17 +1043,26 @@ katana::PropertyGraph::DoWrite(
     KATANA_LOG_DEBUG("topology file store invalid, writing");
   }
 
-  std::unique_ptr<tsuba::FileFrame> topology_res =
-      !rdg_.topology_file_storage().Valid()
-          ? KATANA_CHECKED(WriteTopology(topology()))
-          : nullptr;
+  bool compress_topology = false;
+  katana::GetEnv("KATANA_COMPRESS_TOPOLOGY", &compress_topology);
+
+  std::unique_ptr<tsuba::FileFrame> topology_res = nullptr;
+  if (!rdg_.topology_file_storage().Valid()) {
+    topology_res = compress_topology
+                       ? KATANA_CHECKED(WriteCompressedTopology(topology()))
+                       : KATANA_CHECKED(WriteTopology(topology()));
+  }
+
+  // Type ID arrays stored with narrower IDs are rewritten at the current width
+  bool type_ids_narrow =
+      rdg_.EntityTypeIDStorageSize() != sizeof(katana::EntityTypeID);
 
   if (!rdg_.node_entity_type_id_array_file_storage().Valid()) {
     KATANA_LOG_DEBUG("node_entity_type_id_array file store invalid, writing");
   }
 
   std::unique_ptr<tsuba::FileFrame> node_entity_type_id_array_res =
-      !rdg_.node_entity_type_id_array_file_storage().Valid()
+      !rdg_.node_entity_type_id_array_file_storage().Valid() || type_ids_narrow
           ? KATANA_CHECKED(WriteEntityTypeIDsArray(node_entity_type_ids_))
           : nullptr;
 
@@ -447,15 +1071,118 @@ katana::PropertyGraph::DoWrite(
   }
 
   std::unique_ptr<tsuba::FileFrame> edge_entity_type_id_array_res =
-      !rdg_.edge_entity_type_id_array_file_storage().Valid()
+      !rdg_.edge_entity_type_id_array_file_storage().Valid() || type_ids_narrow
           ? KATANA_CHECKED(WriteEntityTypeIDsArray(edge_entity_type_ids_))
           : nullptr;
 
+  bool persist_derived = false;
+  katana::GetEnv("KATANA_PERSIST_DERIVED_TOPOLOGIES", &persist_derived);
+
+  std::vector<tsuba::DerivedTopologyFrame> derived_topology_res;
+  if (persist_derived) {
+    // Derived topologies already in storage stay valid unless the topology
+    // or entity types are rewritten or the graph is stored somewhere new
+    bool rewrite_all = topology_res || node_entity_type_id_array_res ||
+                       edge_entity_type_id_array_res ||
+                       tsuba::GetRDGDir(handle) != rdg_.rdg_dir();
+    const auto& stored = rdg_.derived_topologies();
+
+    for (const auto& topo : pg_view_cache_.GetEdgeShuffTopos()) {
+      if (!topo->is_transposed() &&
+          topo->edge_sort_state() == EdgeShuffleTopology::EdgeSortKind::kAny) {
+        // A plain copy of the topology is cheaper to rebuild than to load
+        continue;
+      }
+      tsuba::DerivedTopologyInfo info{
+          .transpose_state = static_cast<int32_t>(topo->transpose_state()),
+          .edge_sort_state = static_cast<int32_t>(topo->edge_sort_state()),
+          .num_nodes = topo->num_nodes(),
+          .num_edges = topo->num_edges(),
+      };
+      bool is_stored = std::any_of(
+          stored.begin(), stored.end(),
+          [&](const tsuba::DerivedTopologyInfo& other) {
+            return other.transpose_state == info.transpose_state &&
+                   other.edge_sort_state == info.edge_sort_state;
+          });
+      if (is_stored && !rewrite_all) {
+        continue;
+      }
+      KATANA_LOG_DEBUG(
+          "persisting derived topology transpose: {} edge sort: {}",
+          info.transpose_state, info.edge_sort_state);
+      derived_topology_res.emplace_back(tsuba::DerivedTopologyFrame{
+          .info = std::move(info),
+          .ff = KATANA_CHECKED(WriteDerivedTopology(*topo)),
+      });
+    }
+  }
+
+  // Stored indexes stay valid until their property is upserted or removed,
+  // which drops them from the RDG, or the graph is stored somewhere new
+  bool rewrite_indexes = tsuba::GetRDGDir(handle) != rdg_.rdg_dir();
+  std::vector<tsuba::PropertyIndexFrame> property_index_res;
+  KATANA_CHECKED(WritePropertyIndexes(
+      node_indexes_, false, rdg_, rewrite_indexes, &property_index_res));
+  KATANA_CHECKED(WritePropertyIndexes(
+      edge_indexes_, true, rdg_, rewrite_indexes, &property_index_res));
+
+  rdg_.set_digest_threads(katana::getActiveThreads());
   return rdg_.Store(
       handle, command_line, versioning_action, std::move(topology_res),
       std::move(node_entity_type_id_array_res),
       std::move(edge_entity_type_id_array_res), node_entity_type_manager(),
-      edge_entity_type_manager());
+      edge_entity_type_manager(), std::move(derived_topology_res),
+      std::move(property_index_res));
+}
+
+katana::Result<std::unique_ptr<katana::EdgeShuffleTopology>>
+katana::PropertyGraph::LoadDerivedTopology(
+    const EdgeShuffleTopology::TransposeKind& tpose_kind,
+    const EdgeShuffleTopology::EdgeSortKind& sort_kind) const {
+  const auto& stored = rdg_.derived_topologies();
+  auto find = [&](bool exact) {
+    return std::find_if(
+        stored.begin(), stored.end(),
+        [&](const tsuba::DerivedTopologyInfo& info) {
+          if (info.transpose_state != static_cast<int32_t>(tpose_kind) ||
+              info.num_nodes != num_nodes() || info.num_edges != num_edges()) {
+            return false;
+          }
+          if (exact) {
+            return info.edge_sort_state == static_cast<int32_t>(sort_kind);
+          }
+          // kAny accepts any known sort order
+          return sort_kind == EdgeShuffleTopology::EdgeSortKind::kAny &&
+                 info.edge_sort_state >= 0 &&
+                 info.edge_sort_state <=
+                     static_cast<int32_t>(
+                         EdgeShuffleTopology::EdgeSortKind::kSortedByNodeType);
+        });
+  };
+  auto it = find(true);
+  if (it == stored.end()) {
+    it = find(false);
+  }
+  if (it == stored.end()) {
+    return std::unique_ptr<EdgeShuffleTopology>();
+  }
+
+  auto file_view = KATANA_CHECKED(rdg_.MapDerivedTopology(*it));
+  std::unique_ptr<EdgeShuffleTopology> topo =
+      KATANA_CHECKED_CONTEXT(
+          MapDerivedTopology(
+              *file_view, tpose_kind,
+              static_cast<EdgeShuffleTopology::EdgeSortKind>(
+                  it->edge_sort_state)),
+          "loading derived topology {}", it->path);
+  if (topo->num_nodes() != num_nodes() || topo->num_edges() != num_edges()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "derived topology {} does not match the graph: nodes: {} edges: {}",
+        it->path, topo->num_nodes(), topo->num_edges());
+  }
+  return std::unique_ptr<EdgeShuffleTopology>(std::move(topo));
 }
 
 katana::Result<void>
@@ -511,6 +1238,94 @@ katana::PropertyGraph::WriteView(const std::string& command_line) {
   return WriteView(rdg_.rdg_dir().string(), command_line);
 }
 
+namespace {
+
+/// Whether the entity type ids[i] of manager and other_ids[i] of
+/// other_manager have the same atomic type names for every i. The TypeIDs
+/// can change, but their string interpretation cannot, so each ID is first
+/// mapped to a key shared by the IDs of either manager with the same names,
+/// and the keys are compared in parallel.
+bool
+EntityTypeIDsEqual(
+    const katana::EntityTypeManager& manager,
+    const katana::NUMAArray<katana::EntityTypeID>& ids,
+    const katana::EntityTypeManager& other_manager,
+    const katana::NUMAArray<katana::EntityTypeID>& other_ids) {
+  if (ids.size() != other_ids.size()) {
+    return false;
+  }
+
+  // IDs without names never match
+  constexpr uint64_t kInvalidKey = std::numeric_limits<uint64_t>::max();
+  constexpr uint64_t kOtherInvalidKey = kInvalidKey - 1;
+  std::map<katana::TypeNameSet, uint64_t> names_to_key;
+  auto keys_of = [&](const katana::EntityTypeManager& m, uint64_t invalid) {
+    std::vector<uint64_t> keys(m.GetNumEntityTypes(), invalid);
+    for (size_t id = 0; id < keys.size(); ++id) {
+      auto names =
+          m.EntityTypeToTypeNameSet(static_cast<katana::EntityTypeID>(id));
+      if (names) {
+        keys[id] = names_to_key
+                       .emplace(std::move(names.value()), names_to_key.size())
+                       .first->second;
+      }
+    }
+    return keys;
+  };
+  const std::vector<uint64_t> keys = keys_of(manager, kInvalidKey);
+  const std::vector<uint64_t> other_keys =
+      keys_of(other_manager, kOtherInvalidKey);
+
+  katana::GReduceLogicalOr differ;
+  katana::do_all(
+      katana::iterate(size_t{0}, ids.size()),
+      [&](size_t i) {
+        uint64_t key = ids[i] < keys.size() ? keys[ids[i]] : kInvalidKey;
+        uint64_t other_key = other_ids[i] < other_keys.size()
+                                 ? other_keys[other_ids[i]]
+                                 : kOtherInvalidKey;
+        if (key != other_key) {
+          differ.update(true);
+        }
+      },
+      katana::no_stats());
+  return !differ.reduce();
+}
+
+/// Whether the property columns a and b hold the same values. The content
+/// digests recorded when the properties were stored, if both are known,
+/// settle it without reading the columns. Otherwise the columns are digested
+/// in parallel; different digests settle it only if they are canonical, and
+/// arrow compares the rest.
+bool
+PropertyColumnsEqual(
+    const std::shared_ptr<arrow::ChunkedArray>& a,
+    const std::string& a_stored_digest,
+    const std::shared_ptr<arrow::ChunkedArray>& b,
+    const std::string& b_stored_digest) {
+  if (a == b) {
+    return true;
+  }
+  if (a->length() != b->length() || !a->type()->Equals(b->type())) {
+    return false;
+  }
+  if (!a_stored_digest.empty() && a_stored_digest == b_stored_digest) {
+    return true;
+  }
+  unsigned num_threads = katana::getActiveThreads();
+  if (katana::ContentDigest(a, num_threads) ==
+      katana::ContentDigest(b, num_threads)) {
+    return true;
+  }
+  if (katana::IsContentDigestCanonical(a) &&
+      katana::IsContentDigestCanonical(b)) {
+    return false;
+  }
+  return a->Equals(b);
+}
+
+}  // namespace
+
 bool
 katana::PropertyGraph::Equals(const PropertyGraph* other) const {
   if (!topology().Equals(other->topology())) {
@@ -525,33 +1340,16 @@ katana::PropertyGraph::Equals(const PropertyGraph* other) const {
     return false;
   }
 
-  // The TypeIDs can change, but their string interpretation cannot
-  if (node_entity_type_ids_.size() != other->node_entity_type_ids_.size()) {
+  if (!EntityTypeIDsEqual(
+          node_entity_type_manager_, node_entity_type_ids_,
+          other->node_entity_type_manager_, other->node_entity_type_ids_)) {
     return false;
   }
-  for (size_t i = 0; i < node_entity_type_ids_.size(); ++i) {
-    auto tns = node_entity_type_manager_.EntityTypeToTypeNameSet(
-        node_entity_type_ids_[i]);
-    auto otns = other->node_entity_type_manager_.EntityTypeToTypeNameSet(
-        other->node_entity_type_ids_[i]);
-    if (tns != otns) {
-      return false;
-    }
-  }
-
-  // The TypeIDs can change, but their string interpretation cannot
-  if (edge_entity_type_ids_.size() != other->edge_entity_type_ids_.size()) {
+  if (!EntityTypeIDsEqual(
+          edge_entity_type_manager_, edge_entity_type_ids_,
+          other->edge_entity_type_manager_, other->edge_entity_type_ids_)) {
     return false;
   }
-  for (size_t i = 0; i < edge_entity_type_ids_.size(); ++i) {
-    auto tns = edge_entity_type_manager_.EntityTypeToTypeNameSet(
-        edge_entity_type_ids_[i]);
-    auto otns = other->edge_entity_type_manager_.EntityTypeToTypeNameSet(
-        other->edge_entity_type_ids_[i]);
-    if (tns != otns) {
-      return false;
-    }
-  }
 
   const auto& node_props = rdg_.node_properties();
   const auto& edge_props = rdg_.edge_properties();
@@ -564,14 +1362,22 @@ katana::PropertyGraph::Equals(const PropertyGraph* other) const {
     return false;
   }
   for (const auto& prop_name : node_props->ColumnNames()) {
-    if (!node_props->GetColumnByName(prop_name)->Equals(
-            other_node_props->GetColumnByName(prop_name))) {
+    auto other_col = other_node_props->GetColumnByName(prop_name);
+    if (other_col == nullptr ||
+        !PropertyColumnsEqual(
+            node_props->GetColumnByName(prop_name),
+            rdg_.NodePropertyContentDigest(prop_name), other_col,
+            other->rdg_.NodePropertyContentDigest(prop_name))) {
       return false;
     }
   }
   for (const auto& prop_name : edge_props->ColumnNames()) {
-    if (!edge_props->GetColumnByName(prop_name)->Equals(
-            other_edge_props->GetColumnByName(prop_name))) {
+    auto other_col = other_edge_props->GetColumnByName(prop_name);
+    if (other_col == nullptr ||
+        !PropertyColumnsEqual(
+            edge_props->GetColumnByName(prop_name),
+            rdg_.EdgePropertyContentDigest(prop_name), other_col,
+            other->rdg_.EdgePropertyContentDigest(prop_name))) {
       return false;
     }
   }
@@ -601,13 +1407,16 @@ katana::PropertyGraph::ReportDiff(const PropertyGraph* other) const {
       edge_entity_type_manager_.ReportDiff(other->edge_entity_type_manager()));
 
   // The TypeIDs can change, but their string interpretation cannot
-  bool match = true;
-  if (node_entity_type_ids_.size() != other->node_entity_type_ids_.size()) {
+  if (EntityTypeIDsEqual(
+          node_entity_type_manager_, node_entity_type_ids_,
+          other->node_entity_type_manager_, other->node_entity_type_ids_)) {
+    fmt::format_to(std::back_inserter(buf), "node_entity_type_ids Match!\n");
+  } else if (
+      node_entity_type_ids_.size() != other->node_entity_type_ids_.size()) {
     fmt::format_to(
         std::back_inserter(buf),
         "node_entity_type_ids differ. size {} vs. {}\n",
         node_entity_type_ids_size(), other->node_entity_type_ids_size());
-    match = false;
   } else {
     for (size_t i = 0; i < node_entity_type_ids_.size(); ++i) {
       auto tns_res = node_entity_type_manager_.EntityTypeToTypeNameSet(
@@ -619,7 +1428,6 @@ katana::PropertyGraph::ReportDiff(const PropertyGraph* other) const {
             std::back_inserter(buf),
             "node error types index {} entity lhs {} entity rhs_{}\n", i,
             node_entity_type_ids_[i], other->node_entity_type_ids_[i]);
-        match = false;
         break;
       }
       auto tns = tns_res.value();
@@ -630,22 +1438,21 @@ katana::PropertyGraph::ReportDiff(const PropertyGraph* other) const {
             "node_entity_type_ids differ. {:4} {} {} {} {}\n", i,
             node_entity_type_ids_[i], fmt::join(tns, ", "),
             other->node_entity_type_ids_[i], fmt::join(otns, ", "));
-        match = false;
       }
     }
   }
-  if (match) {
-    fmt::format_to(std::back_inserter(buf), "node_entity_type_ids Match!\n");
-  }
 
   // The TypeIDs can change, but their string interpretation cannot
-  match = true;
-  if (edge_entity_type_ids_.size() != other->edge_entity_type_ids_.size()) {
+  if (EntityTypeIDsEqual(
+          edge_entity_type_manager_, edge_entity_type_ids_,
+          other->edge_entity_type_manager_, other->edge_entity_type_ids_)) {
+    fmt::format_to(std::back_inserter(buf), "edge_entity_type_ids Match!\n");
+  } else if (
+      edge_entity_type_ids_.size() != other->edge_entity_type_ids_.size()) {
     fmt::format_to(
         std::back_inserter(buf),
         "edge_entity_type_ids differ. size {} vs. {}\n",
         edge_entity_type_ids_size(), other->edge_entity_type_ids_size());
-    match = false;
   } else {
     for (size_t i = 0; i < edge_entity_type_ids_.size(); ++i) {
       auto tns_res = edge_entity_type_manager_.EntityTypeToTypeNameSet(
@@ -657,7 +1464,6 @@ katana::PropertyGraph::ReportDiff(const PropertyGraph* other) const {
             std::back_inserter(buf),
             "edge error types index {} entity lhs {} entity rhs_{}\n", i,
             edge_entity_type_ids_[i], other->edge_entity_type_ids_[i]);
-        match = false;
         break;
       }
       auto tns = tns_res.value();
@@ -668,13 +1474,9 @@ katana::PropertyGraph::ReportDiff(const PropertyGraph* other) const {
             "edge_entity_type_ids differ. {:4} {} {} {} {}\n", i,
             edge_entity_type_ids_[i], fmt::join(tns, ", "),
             other->edge_entity_type_ids_[i], fmt::join(otns, ", "));
-        match = false;
       }
     }
   }
-  if (match) {
-    fmt::format_to(std::back_inserter(buf), "edge_entity_type_ids Match!\n");
-  }
 
   const auto& node_props = rdg_.node_properties();
   const auto& edge_props = rdg_.edge_properties();
@@ -697,7 +1499,10 @@ katana::PropertyGraph::ReportDiff(const PropertyGraph* other) const {
       fmt::format_to(
           std::back_inserter(buf), "Only first has node property {}\n",
           prop_name);
-    } else if (!my_col->Equals(other_col)) {
+    } else if (!PropertyColumnsEqual(
+                   my_col, rdg_.NodePropertyContentDigest(prop_name),
+                   other_col,
+                   other->rdg_.NodePropertyContentDigest(prop_name))) {
       fmt::format_to(
           std::back_inserter(buf), "Node property {:15} {:12} differs\n",
           prop_name, fmt::format("({})", my_col->type()->name()));
@@ -721,8 +1526,10 @@ katana::PropertyGraph::ReportDiff(const PropertyGraph* other) const {
       fmt::format_to(
           std::back_inserter(buf), "Only first has edge property {}\n",
           prop_name);
-    } else if (!edge_props->GetColumnByName(prop_name)->Equals(
-                   other_edge_props->GetColumnByName(prop_name))) {
+    } else if (!PropertyColumnsEqual(
+                   my_col, rdg_.EdgePropertyContentDigest(prop_name),
+                   other_col,
+                   other->rdg_.EdgePropertyContentDigest(prop_name))) {
       fmt::format_to(
           std::back_inserter(buf), "Edge property {:15} {:12} differs\n",
           prop_name, fmt::format("({})", my_col->type()->name()));
@@ -745,6 +1552,17 @@ katana::PropertyGraph::ReportDiff(const PropertyGraph* other) const {
 katana::Result<std::shared_ptr<arrow::ChunkedArray>>
 katana::PropertyGraph::GetNodeProperty(const std::string& name) const {
   auto ret = rdg_.node_properties()->GetColumnByName(name);
+  if (!ret && rdg_.load_properties_on_access() &&
+      full_node_schema()->GetFieldIndex(name) != -1) {
+    // Loading changes which properties are in memory but not the properties
+    // of the graph, so it is done through const accessors as well
+    VersionChange change(const_cast<PropertyGraph*>(this));
+    KATANA_CHECKED_CONTEXT(
+        const_cast<tsuba::RDG&>(rdg_).LoadNodeProperty(name),
+        "loading node property {} on access", std::quoted(name));
+    change.Commit();
+    ret = rdg_.node_properties()->GetColumnByName(name);
+  }
   if (ret) {
     return MakeResult(std::move(ret));
   }
@@ -755,6 +1573,17 @@ katana::PropertyGraph::GetNodeProperty(const std::string& name) const {
 katana::Result<std::shared_ptr<arrow::ChunkedArray>>
 katana::PropertyGraph::GetEdgeProperty(const std::string& name) const {
   auto ret = rdg_.edge_properties()->GetColumnByName(name);
+  if (!ret && rdg_.load_properties_on_access() &&
+      full_edge_schema()->GetFieldIndex(name) != -1) {
+    // Loading changes which properties are in memory but not the properties
+    // of the graph, so it is done through const accessors as well
+    VersionChange change(const_cast<PropertyGraph*>(this));
+    KATANA_CHECKED_CONTEXT(
+        const_cast<tsuba::RDG&>(rdg_).LoadEdgeProperty(name),
+        "loading edge property {} on access", std::quoted(name));
+    change.Commit();
+    ret = rdg_.edge_properties()->GetColumnByName(name);
+  }
   if (ret) {
     return MakeResult(std::move(ret));
   }
@@ -783,7 +1612,10 @@ katana::PropertyGraph::AddNodeProperties(
         ErrorCode::InvalidArgument, "expected {} rows found {} instead",
         topology().num_nodes(), props->num_rows());
   }
-  return rdg_.AddNodeProperties(props);
+  VersionChange change(this);
+  KATANA_CHECKED(rdg_.AddNodeProperties(props));
+  change.Commit();
+  return ResultSuccess();
 }
 
 katana::Result<void>
@@ -798,12 +1630,37 @@ katana::PropertyGraph::UpsertNodeProperties(
         ErrorCode::InvalidArgument, "expected {} rows found {} instead",
         topology().num_nodes(), props->num_rows());
   }
-  return rdg_.UpsertNodeProperties(props);
+  VersionChange change(this);
+  KATANA_CHECKED(rdg_.UpsertNodeProperties(props));
+  change.Commit();
+
+  // Rebuild the indexes over the new values
+  for (const auto& field : props->fields()) {
+    auto it = std::find_if(
+        node_indexes_.begin(), node_indexes_.end(), [&](const auto& index) {
+          return index->column_name() == field->name();
+        });
+    if (it != node_indexes_.end()) {
+      PropertyIndexKind kind = (*it)->kind();
+      node_indexes_.erase(it);
+      KATANA_CHECKED(MakeNodeIndex(field->name(), kind));
+    }
+  }
+  return ResultSuccess();
 }
 
 katana::Result<void>
 katana::PropertyGraph::RemoveNodeProperty(int i) {
-  return rdg_.RemoveNodeProperty(i);
+  VersionChange change(this);
+  std::string name = rdg_.node_properties()->field(i)->name();
+  KATANA_CHECKED(rdg_.RemoveNodeProperty(i));
+  change.Commit();
+  node_indexes_.erase(
+      std::remove_if(
+          node_indexes_.begin(), node_indexes_.end(),
+          [&](const auto& index) { return index->column_name() == name; }),
+      node_indexes_.end());
+  return ResultSuccess();
 }
 
 katana::Result<void>
@@ -811,19 +1668,27 @@ katana::PropertyGraph::RemoveNodeProperty(const std::string& prop_name) {
   auto col_names = rdg_.node_properties()->ColumnNames();
   auto pos = std::find(col_names.cbegin(), col_names.cend(), prop_name);
   if (pos != col_names.cend()) {
-    return rdg_.RemoveNodeProperty(std::distance(col_names.cbegin(), pos));
+    return RemoveNodeProperty(
+        static_cast<int>(std::distance(col_names.cbegin(), pos)));
   }
   return katana::ErrorCode::PropertyNotFound;
 }
 
 katana::Result<void>
 katana::PropertyGraph::UnloadNodeProperty(int i) {
-  return rdg_.UnloadNodeProperty(i);
+  VersionChange change(this);
+  rdg_.set_digest_threads(katana::getActiveThreads());
+  KATANA_CHECKED(rdg_.UnloadNodeProperty(i));
+  change.Commit();
+  return ResultSuccess();
 }
 
 katana::Result<void>
 katana::PropertyGraph::LoadNodeProperty(const std::string& name, int i) {
-  return rdg_.LoadNodeProperty(name, i);
+  VersionChange change(this);
+  KATANA_CHECKED(rdg_.LoadNodeProperty(name, i));
+  change.Commit();
+  return ResultSuccess();
 }
 /// Load a node property by name if it is absent and append its column to
 /// the table do nothing otherwise
@@ -835,11 +1700,23 @@ katana::PropertyGraph::EnsureNodePropertyLoaded(const std::string& name) {
   return LoadNodeProperty(name);
 }
 
+katana::Result<void>
+katana::PropertyGraph::PrefetchNodeProperties(
+    const std::vector<std::string>& names) {
+  return rdg_.PrefetchNodeProperties(names);
+}
+
 std::vector<std::string>
 katana::PropertyGraph::ListNodeProperties() const {
   return rdg_.ListNodeProperties();
 }
 
+katana::Result<void>
+katana::PropertyGraph::PrefetchEdgeProperties(
+    const std::vector<std::string>& names) {
+  return rdg_.PrefetchEdgeProperties(names);
+}
+
 std::vector<std::string>
 katana::PropertyGraph::ListEdgeProperties() const {
   return rdg_.ListEdgeProperties();
@@ -850,7 +1727,8 @@ katana::PropertyGraph::UnloadNodeProperty(const std::string& prop_name) {
   auto col_names = rdg_.node_properties()->ColumnNames();
   auto pos = std::find(col_names.cbegin(), col_names.cend(), prop_name);
   if (pos != col_names.cend()) {
-    return rdg_.UnloadNodeProperty(std::distance(col_names.cbegin(), pos));
+    return UnloadNodeProperty(
+        static_cast<int>(std::distance(col_names.cbegin(), pos)));
   }
   return katana::ErrorCode::PropertyNotFound;
 }
@@ -867,7 +1745,10 @@ katana::PropertyGraph::AddEdgeProperties(
         ErrorCode::InvalidArgument, "expected {} rows found {} instead",
         topology().num_edges(), props->num_rows());
   }
-  return rdg_.AddEdgeProperties(props);
+  VersionChange change(this);
+  KATANA_CHECKED(rdg_.AddEdgeProperties(props));
+  change.Commit();
+  return ResultSuccess();
 }
 
 katana::Result<void>
@@ -882,12 +1763,125 @@ katana::PropertyGraph::UpsertEdgeProperties(
         ErrorCode::InvalidArgument, "expected {} rows found {} instead",
         topology().num_edges(), props->num_rows());
   }
-  return rdg_.UpsertEdgeProperties(props);
+  VersionChange change(this);
+  KATANA_CHECKED(rdg_.UpsertEdgeProperties(props));
+  change.Commit();
+
+  // Rebuild the indexes over the new values
+  for (const auto& field : props->fields()) {
+    auto it = std::find_if(
+        edge_indexes_.begin(), edge_indexes_.end(), [&](const auto& index) {
+          return index->column_name() == field->name();
+        });
+    if (it != edge_indexes_.end()) {
+      PropertyIndexKind kind = (*it)->kind();
+      edge_indexes_.erase(it);
+      KATANA_CHECKED(MakeEdgeIndex(field->name(), kind));
+    }
+  }
+  return ResultSuccess();
+}
+
+katana::Result<void>
+katana::PropertyGraph::ReplaceTopology(
+    GraphTopology&& topo, EntityTypeIDArray&& node_entity_type_ids,
+    EntityTypeIDArray&& edge_entity_type_ids,
+    const std::shared_ptr<arrow::Table>& node_props,
+    const std::shared_ptr<arrow::Table>& edge_props) {
+  auto check = [](const char* what, uint64_t expected,
+                  uint64_t found) -> Result<void> {
+    if (expected != found) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "expected {} {} found {} instead",
+          expected, what, found);
+    }
+    return ResultSuccess();
+  };
+  if (node_props) {
+    KATANA_CHECKED(check(
+        "node type ids", topo.num_nodes(), node_entity_type_ids.size()));
+    KATANA_CHECKED(check("node rows", topo.num_nodes(), node_props->num_rows()));
+  } else {
+    KATANA_CHECKED(check("nodes", num_nodes(), topo.num_nodes()));
+  }
+  if (edge_props) {
+    KATANA_CHECKED(check(
+        "edge type ids", topo.num_edges(), edge_entity_type_ids.size()));
+    KATANA_CHECKED(check("edge rows", topo.num_edges(), edge_props->num_rows()));
+  } else {
+    KATANA_CHECKED(check("edges", num_edges(), topo.num_edges()));
+  }
+
+  VersionChange change(this);
+
+  // Cached views and type partitions describe the old topology
+  size_t byte_budget = pg_view_cache_.byte_budget();
+  pg_view_cache_ = PGViewCache();
+  pg_view_cache_.set_byte_budget(byte_budget);
+
+  topology_ = std::move(topo);
+  topology_.MoveToSharedStorage();
+  mapped_topology_copy_ = GraphTopology{};
+  change.Commit();
+  KATANA_CHECKED(rdg_.UnbindTopologyFileStorage());
+
+  // Indexes are rebuilt over the new rows
+  auto replace_rows = [](const std::shared_ptr<arrow::Table>& props,
+                         auto* indexes, auto drop, auto add,
+                         auto make_index) -> Result<void> {
+    std::vector<std::pair<std::string, PropertyIndexKind>> kinds;
+    for (const auto& index : *indexes) {
+      kinds.emplace_back(index->column_name(), index->kind());
+    }
+    indexes->clear();
+    drop();
+    if (props->num_columns() > 0) {
+      KATANA_CHECKED(add(props));
+    }
+    for (const auto& [name, kind] : kinds) {
+      if (props->GetColumnByName(name)) {
+        KATANA_CHECKED(make_index(name, kind));
+      }
+    }
+    return ResultSuccess();
+  };
+  if (node_props) {
+    node_entity_type_ids_ = std::move(node_entity_type_ids);
+    MoveNodeTypeIDsToSharedStorage();
+    KATANA_CHECKED(rdg_.UnbindNodeEntityTypeIDArrayFileStorage());
+    KATANA_CHECKED(replace_rows(
+        node_props, &node_indexes_, [&]() { rdg_.DropNodeProperties(); },
+        [&](const auto& t) { return rdg_.AddNodeProperties(t); },
+        [&](const auto& name, auto kind) {
+          return MakeNodeIndex(name, kind);
+        }));
+  }
+  if (edge_props) {
+    edge_entity_type_ids_ = std::move(edge_entity_type_ids);
+    MoveEdgeTypeIDsToSharedStorage();
+    KATANA_CHECKED(rdg_.UnbindEdgeEntityTypeIDArrayFileStorage());
+    KATANA_CHECKED(replace_rows(
+        edge_props, &edge_indexes_, [&]() { rdg_.DropEdgeProperties(); },
+        [&](const auto& t) { return rdg_.AddEdgeProperties(t); },
+        [&](const auto& name, auto kind) {
+          return MakeEdgeIndex(name, kind);
+        }));
+  }
+  return ResultSuccess();
 }
 
 katana::Result<void>
 katana::PropertyGraph::RemoveEdgeProperty(int i) {
-  return rdg_.RemoveEdgeProperty(i);
+  VersionChange change(this);
+  std::string name = rdg_.edge_properties()->field(i)->name();
+  KATANA_CHECKED(rdg_.RemoveEdgeProperty(i));
+  change.Commit();
+  edge_indexes_.erase(
+      std::remove_if(
+          edge_indexes_.begin(), edge_indexes_.end(),
+          [&](const auto& index) { return index->column_name() == name; }),
+      edge_indexes_.end());
+  return ResultSuccess();
 }
 
 katana::Result<void>
@@ -895,19 +1889,27 @@ katana::PropertyGraph::RemoveEdgeProperty(const std::string& prop_name) {
   auto col_names = rdg_.edge_properties()->ColumnNames();
   auto pos = std::find(col_names.cbegin(), col_names.cend(), prop_name);
   if (pos != col_names.cend()) {
-    return rdg_.RemoveEdgeProperty(std::distance(col_names.cbegin(), pos));
+    return RemoveEdgeProperty(
+        static_cast<int>(std::distance(col_names.cbegin(), pos)));
   }
   return katana::ErrorCode::PropertyNotFound;
 }
 
 katana::Result<void>
 katana::PropertyGraph::UnloadEdgeProperty(int i) {
-  return rdg_.UnloadEdgeProperty(i);
+  VersionChange change(this);
+  rdg_.set_digest_threads(katana::getActiveThreads());
+  KATANA_CHECKED(rdg_.UnloadEdgeProperty(i));
+  change.Commit();
+  return ResultSuccess();
 }
 
 katana::Result<void>
 katana::PropertyGraph::LoadEdgeProperty(const std::string& name, int i) {
-  return rdg_.LoadEdgeProperty(name, i);
+  VersionChange change(this);
+  KATANA_CHECKED(rdg_.LoadEdgeProperty(name, i));
+  change.Commit();
+  return ResultSuccess();
 }
 
 /// Load an edge property by name if it is absent and append its column to
@@ -925,14 +1927,16 @@ katana::PropertyGraph::UnloadEdgeProperty(const std::string& prop_name) {
   auto col_names = rdg_.edge_properties()->ColumnNames();
   auto pos = std::find(col_names.cbegin(), col_names.cend(), prop_name);
   if (pos != col_names.cend()) {
-    return rdg_.UnloadEdgeProperty(std::distance(col_names.cbegin(), pos));
+    return UnloadEdgeProperty(
+        static_cast<int>(std::distance(col_names.cbegin(), pos)));
   }
   return katana::ErrorCode::PropertyNotFound;
 }
 
 // Build an index over nodes.
 katana::Result<void>
-katana::PropertyGraph::MakeNodeIndex(const std::string& column_name) {
+katana::PropertyGraph::MakeNodeIndex(
+    const std::string& column_name, katana::PropertyIndexKind kind) {
   for (const auto& existing_index : node_indexes_) {
     if (existing_index->column_name() == column_name) {
       return KATANA_ERROR(
@@ -941,18 +1945,20 @@ katana::PropertyGraph::MakeNodeIndex(const std::string& column_name) {
     }
   }
 
+  MemoryCategoryScope memory_category(MemoryCategory::kIndexes);
+
   // Get a view of the property.
   std::shared_ptr<arrow::ChunkedArray> chunked_property =
       KATANA_CHECKED(GetNodeProperty(column_name));
-  KATANA_LOG_ASSERT(chunked_property->num_chunks() == 1);
-  std::shared_ptr<arrow::Array> property = chunked_property->chunk(0);
+  std::shared_ptr<arrow::Array> property =
+      KATANA_CHECKED(katana::CombinedArray(chunked_property));
 
   // Create an index based on the type of the field.
   std::unique_ptr<katana::PropertyIndex<GraphTopology::Node>> index =
       KATANA_CHECKED(katana::MakeTypedIndex<katana::GraphTopology::Node>(
-          column_name, num_nodes(), property));
+          column_name, num_nodes(), property, kind));
 
-  KATANA_CHECKED(index->BuildFromProperty());
+  KATANA_CHECKED(BuildPropertyIndex(rdg_, false, index.get()));
 
   node_indexes_.push_back(std::move(index));
 
@@ -961,7 +1967,8 @@ katana::PropertyGraph::MakeNodeIndex(const std::string& column_name) {
 
 // Build an index over edges.
 katana::Result<void>
-katana::PropertyGraph::MakeEdgeIndex(const std::string& column_name) {
+katana::PropertyGraph::MakeEdgeIndex(
+    const std::string& column_name, katana::PropertyIndexKind kind) {
   for (const auto& existing_index : edge_indexes_) {
     if (existing_index->column_name() == column_name) {
       return KATANA_ERROR(
@@ -970,18 +1977,20 @@ katana::PropertyGraph::MakeEdgeIndex(const std::string& column_name) {
     }
   }
 
+  MemoryCategoryScope memory_category(MemoryCategory::kIndexes);
+
   // Get a view of the property.
   std::shared_ptr<arrow::ChunkedArray> chunked_property =
       KATANA_CHECKED(GetEdgeProperty(column_name));
-  KATANA_LOG_ASSERT(chunked_property->num_chunks() == 1);
-  std::shared_ptr<arrow::Array> property = chunked_property->chunk(0);
+  std::shared_ptr<arrow::Array> property =
+      KATANA_CHECKED(katana::CombinedArray(chunked_property));
 
   // Create an index based on the type of the field.
   std::unique_ptr<katana::PropertyIndex<katana::GraphTopology::Edge>> index =
       KATANA_CHECKED(katana::MakeTypedIndex<katana::GraphTopology::Edge>(
-          column_name, num_edges(), property));
+          column_name, num_edges(), property, kind));
 
-  KATANA_CHECKED(index->BuildFromProperty());
+  KATANA_CHECKED(BuildPropertyIndex(rdg_, true, index.get()));
 
   edge_indexes_.push_back(std::move(index));
 
@@ -992,6 +2001,7 @@ katana::Result<std::unique_ptr<katana::NUMAArray<uint64_t>>>
 katana::SortAllEdgesByDest(katana::PropertyGraph* pg) {
   // TODO(amber): This function will soon change so that it produces a new sorted
   // topology instead of modifying an existing one. The const_cast will go away
+  pg->UnshareTopology();
   const auto& topo = pg->topology();
 
   auto permutation_vec = std::make_unique<katana::NUMAArray<uint64_t>>();
@@ -1058,6 +2068,7 @@ katana::FindEdgeSortedByDest(
 // TODO(amber): this method should return a new sorted topology
 katana::Result<void>
 katana::SortNodesByDegree(katana::PropertyGraph* pg) {
+  pg->UnshareTopology();
   const auto& topo = pg->topology();
 
   uint64_t num_nodes = topo.num_nodes();
@@ -1283,6 +2294,339 @@ katana::CreateTransposeGraphTopology(const GraphTopology& topology) {
   return katana::PropertyGraph::Make(std::move(transpose_topo));
 }
 
+namespace {
+
+/// Rows of a column gathered by each task of TakeRows
+constexpr uint64_t kTakeSliceSize = uint64_t{1} << 20;
+
+/// Gather the rows indices of columns in parallel. Each column is combined
+/// into one array first (without a copy when it has one chunk), so that
+/// tasks take from an array instead of each concatenating the chunks again.
+katana::Result<std::shared_ptr<arrow::Table>>
+TakeRows(
+    const std::shared_ptr<arrow::Schema>& schema,
+    const std::vector<std::shared_ptr<arrow::ChunkedArray>>& columns,
+    const katana::NUMAArray<uint64_t>& indices) {
+  size_t num_columns = columns.size();
+  std::vector<std::shared_ptr<arrow::Array>> combined;
+  for (const auto& column : columns) {
+    combined.emplace_back(KATANA_CHECKED(katana::CombinedArray(column)));
+  }
+
+  auto index_array = std::make_shared<arrow::UInt64Array>(
+      indices.size(), arrow::Buffer::Wrap(indices.data(), indices.size()));
+  uint64_t num_slices = (indices.size() + kTakeSliceSize - 1) / kTakeSliceSize;
+  std::vector<std::shared_ptr<arrow::Array>> slices(num_columns * num_slices);
+  std::vector<arrow::Status> statuses(slices.size());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, slices.size()),
+      [&](uint64_t task) {
+        uint64_t c = task / num_slices;
+        uint64_t begin = (task % num_slices) * kTakeSliceSize;
+        auto slice = index_array->Slice(
+            begin, std::min(kTakeSliceSize, indices.size() - begin));
+        auto taken = arrow::compute::Take(*combined[c], *slice);
+        if (taken.ok()) {
+          slices[task] = taken.ValueOrDie();
+        } else {
+          statuses[task] = taken.status();
+        }
+      },
+      katana::steal(), katana::no_stats(), katana::loopname("TakeRows"));
+  for (const auto& status : statuses) {
+    if (!status.ok()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::ArrowError, "taking property rows: {}",
+          status.ToString());
+    }
+  }
+
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> taken(num_columns);
+  for (size_t c = 0; c < num_columns; ++c) {
+    std::vector<std::shared_ptr<arrow::Array>> chunks(
+        slices.begin() + c * num_slices, slices.begin() + (c + 1) * num_slices);
+    taken[c] = std::make_shared<arrow::ChunkedArray>(
+        std::move(chunks), schema->field(c)->type());
+  }
+  return arrow::Table::Make(schema, taken, indices.size());
+}
+
+/// PermuteNodes, optionally sorting the edges of each node by their new
+/// destinations
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+PermuteNodesImpl(
+    const katana::PropertyGraph& pg,
+    const katana::NUMAArray<katana::GraphTopology::Node>& old_ids,
+    bool sort_edges_by_dest) {
+  using katana::ErrorCode;
+  using katana::GraphTopology;
+  using katana::PropertyGraph;
+
+  const GraphTopology& topo = pg.topology();
+  uint64_t num_nodes = topo.num_nodes();
+  uint64_t num_edges = topo.num_edges();
+  if (old_ids.size() != num_nodes) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "permutation has {} nodes, graph has {}",
+        old_ids.size(), num_nodes);
+  }
+
+  // Check that old_ids is a permutation while inverting it
+  katana::NUMAArray<GraphTopology::Node> new_ids;
+  new_ids.allocateInterleaved(num_nodes);
+  katana::ParallelSTL::fill(
+      new_ids.begin(), new_ids.end(),
+      std::numeric_limits<GraphTopology::Node>::max());
+  bool is_permutation = true;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t i) {
+        GraphTopology::Node old_id = old_ids[i];
+        if (old_id >= num_nodes ||
+            !__sync_bool_compare_and_swap(
+                &new_ids[old_id],
+                std::numeric_limits<GraphTopology::Node>::max(),
+                static_cast<GraphTopology::Node>(i))) {
+          is_permutation = false;
+        }
+      },
+      katana::no_stats());
+  if (!is_permutation) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "node ids are not a permutation");
+  }
+
+  katana::NUMAArray<GraphTopology::Edge> out_indices;
+  out_indices.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t i) { out_indices[i] = topo.edges(old_ids[i]).size(); },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      out_indices.begin(), out_indices.end(), out_indices.begin());
+
+  katana::NUMAArray<GraphTopology::Node> out_dests;
+  out_dests.allocateInterleaved(num_edges);
+  katana::NUMAArray<uint64_t> edge_ids;
+  edge_ids.allocateInterleaved(num_edges);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t i) {
+        GraphTopology::Edge first = i == 0 ? 0 : out_indices[i - 1];
+        GraphTopology::Edge new_e = first;
+        for (GraphTopology::Edge e : topo.edges(old_ids[i])) {
+          out_dests[new_e] = new_ids[topo.edge_dest(e)];
+          edge_ids[new_e] = e;
+          ++new_e;
+        }
+        if (sort_edges_by_dest) {
+          // Parallel edges keep their order
+          std::sort(
+              katana::make_zip_iterator(&out_dests[first], &edge_ids[first]),
+              katana::make_zip_iterator(&out_dests[new_e], &edge_ids[new_e]),
+              [](const auto& a, const auto& b) {
+                return std::get<0>(a) < std::get<0>(b) ||
+                       (std::get<0>(a) == std::get<0>(b) &&
+                        std::get<1>(a) < std::get<1>(b));
+              });
+        }
+      },
+      katana::steal(), katana::no_stats(), katana::loopname("PermuteEdges"));
+
+  PropertyGraph::EntityTypeIDArray node_types;
+  node_types.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t i) { node_types[i] = pg.GetTypeOfNode(old_ids[i]); },
+      katana::no_stats());
+  PropertyGraph::EntityTypeIDArray edge_types;
+  edge_types.allocateInterleaved(num_edges);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t e) { edge_types[e] = pg.GetTypeOfEdge(edge_ids[e]); },
+      katana::no_stats());
+
+  katana::EntityTypeManager node_type_manager = pg.GetNodeTypeManager();
+  katana::EntityTypeManager edge_type_manager = pg.GetEdgeTypeManager();
+  auto permuted = KATANA_CHECKED(PropertyGraph::Make(
+      GraphTopology(std::move(out_indices), std::move(out_dests)),
+      std::move(node_types), std::move(edge_types),
+      std::move(node_type_manager), std::move(edge_type_manager)));
+
+  katana::NUMAArray<uint64_t> node_rows;
+  node_rows.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t i) { node_rows[i] = old_ids[i]; }, katana::no_stats());
+
+  if (pg.GetNumNodeProperties() > 0) {
+    std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+    for (int i = 0; i < pg.GetNumNodeProperties(); ++i) {
+      columns.emplace_back(pg.GetNodeProperty(i));
+    }
+    KATANA_CHECKED(permuted->AddNodeProperties(KATANA_CHECKED(
+        TakeRows(pg.loaded_node_schema(), columns, node_rows))));
+  }
+  if (pg.GetNumEdgeProperties() > 0) {
+    std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+    for (int i = 0; i < pg.GetNumEdgeProperties(); ++i) {
+      columns.emplace_back(pg.GetEdgeProperty(i));
+    }
+    KATANA_CHECKED(permuted->AddEdgeProperties(KATANA_CHECKED(
+        TakeRows(pg.loaded_edge_schema(), columns, edge_ids))));
+  }
+
+  return permuted;
+}
+
+}  // namespace
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::PermuteNodes(
+    const PropertyGraph& pg, const NUMAArray<GraphTopology::Node>& old_ids) {
+  return PermuteNodesImpl(pg, old_ids, false);
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::RelabelNodesByDegree(
+    const PropertyGraph& pg, const std::string& old_id_property) {
+  const GraphTopology& topo = pg.topology();
+  uint64_t num_nodes = topo.num_nodes();
+
+  // Descending degree, like SortNodesByDegree
+  using DegreeNodePair = std::pair<uint64_t, GraphTopology::Node>;
+  katana::NUMAArray<DegreeNodePair> dn_pairs;
+  dn_pairs.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(topo.all_nodes()),
+      [&](GraphTopology::Node n) {
+        dn_pairs[n] = DegreeNodePair(topo.degree(n), n);
+      },
+      katana::no_stats());
+  katana::ParallelSTL::sort(
+      dn_pairs.begin(), dn_pairs.end(), std::greater<DegreeNodePair>());
+
+  katana::NUMAArray<GraphTopology::Node> old_ids;
+  old_ids.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t i) { old_ids[i] = dn_pairs[i].second; }, katana::no_stats());
+  dn_pairs.destroy();
+  dn_pairs.deallocate();
+
+  auto relabeled = KATANA_CHECKED(PermuteNodesImpl(pg, old_ids, true));
+
+  if (!old_id_property.empty()) {
+    std::shared_ptr<arrow::Buffer> buffer = KATANA_CHECKED(
+        arrow::AllocateBuffer(num_nodes * sizeof(GraphTopology::Node)));
+    katana::ParallelSTL::copy(
+        old_ids.begin(), old_ids.end(),
+        reinterpret_cast<GraphTopology::Node*>(buffer->mutable_data()));
+    auto values = std::make_shared<arrow::UInt32Array>(num_nodes, buffer);
+    KATANA_CHECKED(relabeled->AddNodeProperties(arrow::Table::Make(
+        arrow::schema({arrow::field(old_id_property, arrow::uint32())}),
+        {values})));
+  }
+
+  return relabeled;
+}
+
+namespace {
+
+/// The node ids of a query, of any integer type, checked against topo
+katana::Result<katana::NUMAArray<uint64_t>>
+QueryNodes(const katana::GraphTopology& topo, const arrow::Array& nodes) {
+  if (!arrow::is_integer(nodes.type_id())) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "node ids must be integers, not {}",
+        nodes.type()->ToString());
+  }
+  if (nodes.null_count() != 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "node ids must not be null");
+  }
+  // The default cast fails on negative ids
+  auto cast = KATANA_CHECKED(arrow::compute::Cast(nodes, arrow::uint64()));
+  const uint64_t* ids = cast->data()->GetValues<uint64_t>(1);
+
+  katana::NUMAArray<uint64_t> ret;
+  ret.allocateInterleaved(nodes.length());
+  katana::GReduceMax<uint64_t> max_id;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, ret.size()),
+      [&](uint64_t i) {
+        ret[i] = ids[i];
+        max_id.update(ids[i]);
+      },
+      katana::no_stats());
+  if (ret.size() > 0 && max_id.reduce() >= topo.num_nodes()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "node id {} out of range",
+        max_id.reduce());
+  }
+  return ret;
+}
+
+}  // namespace
+
+katana::Result<std::shared_ptr<arrow::UInt64Array>>
+katana::GetDegrees(const GraphTopology& topo, const arrow::Array& nodes) {
+  auto ids = KATANA_CHECKED(QueryNodes(topo, nodes));
+  std::shared_ptr<arrow::Buffer> buffer =
+      KATANA_CHECKED(arrow::AllocateBuffer(ids.size() * sizeof(uint64_t)));
+  auto* degrees = reinterpret_cast<uint64_t*>(buffer->mutable_data());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, ids.size()),
+      [&](uint64_t i) { degrees[i] = topo.edges(ids[i]).size(); },
+      katana::no_stats());
+  return std::make_shared<arrow::UInt64Array>(ids.size(), buffer);
+}
+
+katana::Result<std::shared_ptr<arrow::LargeListArray>>
+katana::GetNeighbors(const GraphTopology& topo, const arrow::Array& nodes) {
+  auto ids = KATANA_CHECKED(QueryNodes(topo, nodes));
+  std::shared_ptr<arrow::Buffer> offset_buffer = KATANA_CHECKED(
+      arrow::AllocateBuffer((ids.size() + 1) * sizeof(int64_t)));
+  auto* offsets = reinterpret_cast<int64_t*>(offset_buffer->mutable_data());
+  offsets[0] = 0;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, ids.size()),
+      [&](uint64_t i) { offsets[i + 1] = topo.edges(ids[i]).size(); },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      offsets + 1, offsets + ids.size() + 1, offsets + 1);
+
+  uint64_t num_dests = offsets[ids.size()];
+  std::shared_ptr<arrow::Buffer> dest_buffer = KATANA_CHECKED(
+      arrow::AllocateBuffer(num_dests * sizeof(GraphTopology::Node)));
+  auto* dests =
+      reinterpret_cast<GraphTopology::Node*>(dest_buffer->mutable_data());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, ids.size()),
+      [&](uint64_t i) {
+        int64_t out = offsets[i];
+        for (GraphTopology::Edge e : topo.edges(ids[i])) {
+          dests[out++] = topo.edge_dest(e);
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  return std::make_shared<arrow::LargeListArray>(
+      arrow::large_list(arrow::uint32()), ids.size(), offset_buffer,
+      std::make_shared<arrow::UInt32Array>(num_dests, dest_buffer));
+}
+
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+katana::GatherNodeProperty(
+    const PropertyGraph& pg, const std::string& name,
+    const arrow::Array& nodes) {
+  auto ids = KATANA_CHECKED(QueryNodes(pg.topology(), nodes));
+  auto column = KATANA_CHECKED(pg.GetNodeProperty(name));
+  auto schema = arrow::schema({arrow::field(name, column->type())});
+  auto table = KATANA_CHECKED(TakeRows(schema, {column}, ids));
+  return table->column(0);
+}
+
 katana::Result<katana::PropertyIndex<katana::GraphTopology::Node>*>
 katana::PropertyGraph::GetNodePropertyIndex(
     const std::string& property_name) const {
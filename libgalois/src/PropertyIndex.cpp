@@ -1,37 +1,126 @@
 #include "katana/PropertyIndex.h"
 
+#include <cstring>
+
+#include "katana/Galois.h"
+#include "katana/ParallelSTL.h"
 #include "katana/PropertyGraph.h"
+#include "katana/Reduction.h"
+#include "tsuba/Errors.h"
 
 namespace katana {
 
+namespace {
+
+template <typename node_or_edge, typename c_type, typename OrderedIndex>
+std::unique_ptr<PropertyIndex<node_or_edge>>
+MakeIndexOfKind(
+    PropertyIndexKind kind, const std::string& column_name,
+    size_t num_entities, const std::shared_ptr<arrow::Array>& property) {
+  if (kind == PropertyIndexKind::kHash) {
+    return std::make_unique<HashPropertyIndex<node_or_edge, c_type>>(
+        column_name, num_entities, property);
+  }
+  return std::make_unique<OrderedIndex>(column_name, num_entities, property);
+}
+
+template <typename node_or_edge, typename c_type>
+std::unique_ptr<PropertyIndex<node_or_edge>>
+MakePrimitiveIndex(
+    PropertyIndexKind kind, const std::string& column_name,
+    size_t num_entities, const std::shared_ptr<arrow::Array>& property) {
+  return MakeIndexOfKind<
+      node_or_edge, c_type, PrimitivePropertyIndex<node_or_edge, c_type>>(
+      kind, column_name, num_entities, property);
+}
+
+template <typename node_or_edge, typename code_type>
+Result<std::unique_ptr<PropertyIndex<node_or_edge>>>
+MakeDictionaryIndexOfCodes(
+    const std::string& column_name, size_t num_entities,
+    const std::shared_ptr<arrow::Array>& property) {
+  return Result<std::unique_ptr<PropertyIndex<node_or_edge>>>(
+      std::make_unique<DictionaryPropertyIndex<node_or_edge, code_type>>(
+          column_name, num_entities, property));
+}
+
+template <typename node_or_edge>
+Result<std::unique_ptr<PropertyIndex<node_or_edge>>>
+MakeDictionaryIndex(
+    PropertyIndexKind kind, const std::string& column_name,
+    size_t num_entities, const std::shared_ptr<arrow::Array>& property) {
+  const auto& type =
+      static_cast<const arrow::DictionaryType&>(*property->type());
+  if (type.value_type()->id() != arrow::Type::LARGE_STRING) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "Dictionary column has values unknown for indexing: {}",
+        type.value_type()->ToString());
+  }
+  if (kind != PropertyIndexKind::kOrdered) {
+    // Lookups search the dictionary, which an ordered index already does
+    // without hashing the property
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "Dictionary columns only have ordered indexes");
+  }
+
+  switch (type.index_type()->id()) {
+  case arrow::Type::INT8:
+    return MakeDictionaryIndexOfCodes<node_or_edge, int8_t>(
+        column_name, num_entities, property);
+  case arrow::Type::INT16:
+    return MakeDictionaryIndexOfCodes<node_or_edge, int16_t>(
+        column_name, num_entities, property);
+  case arrow::Type::INT32:
+    return MakeDictionaryIndexOfCodes<node_or_edge, int32_t>(
+        column_name, num_entities, property);
+  case arrow::Type::INT64:
+    return MakeDictionaryIndexOfCodes<node_or_edge, int64_t>(
+        column_name, num_entities, property);
+  default:
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "Dictionary column has codes unknown for indexing: {}",
+        type.index_type()->ToString());
+  }
+}
+
+}  // namespace
+
 // Switch statement over creation of per-type indexes.
 template <typename node_or_edge>
 Result<std::unique_ptr<PropertyIndex<node_or_edge>>>
 MakeTypedIndex(
     const std::string& column_name, size_t num_entities,
-    std::shared_ptr<arrow::Array> property) {
+    std::shared_ptr<arrow::Array> property, PropertyIndexKind kind) {
   std::unique_ptr<PropertyIndex<node_or_edge>> index;
 
   switch (property->type_id()) {
   case arrow::Type::BOOL:
-    index = std::make_unique<PrimitivePropertyIndex<node_or_edge, bool>>(
-        column_name, num_entities, property);
+    index = MakePrimitiveIndex<node_or_edge, bool>(
+        kind, column_name, num_entities, property);
     break;
   case arrow::Type::UINT8:
-    index = std::make_unique<PrimitivePropertyIndex<node_or_edge, uint8_t>>(
-        column_name, num_entities, property);
+    index = MakePrimitiveIndex<node_or_edge, uint8_t>(
+        kind, column_name, num_entities, property);
     break;
   case arrow::Type::INT64:
-    index = std::make_unique<PrimitivePropertyIndex<node_or_edge, int64_t>>(
-        column_name, num_entities, property);
+    index = MakePrimitiveIndex<node_or_edge, int64_t>(
+        kind, column_name, num_entities, property);
     break;
   case arrow::Type::DOUBLE:
-    index = std::make_unique<PrimitivePropertyIndex<node_or_edge, double_t>>(
-        column_name, num_entities, property);
+    index = MakePrimitiveIndex<node_or_edge, double_t>(
+        kind, column_name, num_entities, property);
     break;
   case arrow::Type::LARGE_STRING:
-    index = std::make_unique<StringPropertyIndex<node_or_edge>>(
-        column_name, num_entities, property);
+    index = MakeIndexOfKind<
+        node_or_edge, std::string_view, StringPropertyIndex<node_or_edge>>(
+        kind, column_name, num_entities, property);
+    break;
+  case arrow::Type::DICTIONARY:
+    index = KATANA_CHECKED(MakeDictionaryIndex<node_or_edge>(
+        kind, column_name, num_entities, property));
     break;
   default:
     return KATANA_ERROR(
@@ -43,43 +132,451 @@ MakeTypedIndex(
   return Result<std::unique_ptr<PropertyIndex<node_or_edge>>>(std::move(index));
 }
 
-template <typename node_or_edge, typename c_type>
+namespace {
+
+// Lay out the keys first[0], first[stride], ... first[(n - 1) * stride] as
+// the 1-indexed Eytzinger order of a complete binary search tree: tree[k] has
+// the children tree[2 * k] and tree[2 * k + 1]. ranks[k] is the position of
+// tree[k] among the keys. Returns the number of keys placed so far.
+template <typename T>
+size_t
+FillEytzinger(
+    const T* first, size_t stride, size_t n, size_t placed, size_t k, T* tree,
+    size_t* ranks) {
+  if (k <= n) {
+    placed = FillEytzinger(first, stride, n, placed, 2 * k, tree, ranks);
+    tree[k] = first[placed * stride];
+    ranks[k] = placed;
+    ++placed;
+    placed = FillEytzinger(first, stride, n, placed, 2 * k + 1, tree, ranks);
+  }
+  return placed;
+}
+
+uint64_t
+AlignToFile(uint64_t offset) {
+  return (offset + kPropertyIndexFileAlignment - 1) /
+         kPropertyIndexFileAlignment * kPropertyIndexFileAlignment;
+}
+
+// The offset of the first array of a stored index with num_arrays arrays
+uint64_t
+FirstArrayOffset(uint64_t num_arrays) {
+  return AlignToFile(
+      sizeof(PropertyIndexFileHeader) + num_arrays * sizeof(uint64_t));
+}
+
 Result<void>
-PrimitivePropertyIndex<node_or_edge, c_type>::BuildFromProperty() {
-  if (static_cast<uint64_t>(property_->length()) < num_entities_) {
+CheckPropertyLength(const arrow::Array& property, size_t num_entities) {
+  if (static_cast<uint64_t>(property.length()) < num_entities) {
     return KATANA_ERROR(
         ErrorCode::InvalidArgument, "Property does not contain all entities");
   }
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+template <typename node_or_edge>
+template <typename IsValid, typename Less>
+void
+PropertyIndex<node_or_edge>::SortIds(
+    size_t num_entities, IsValid is_valid, Less less) {
+  sorted_ids_.Allocate(num_entities);
+  katana::ParallelSTL::iota(
+      sorted_ids_.begin(), sorted_ids_.end(), node_or_edge{0});
+
+  katana::GAccumulator<size_t> num_valid;
+  katana::do_all(
+      katana::iterate(size_t{0}, num_entities),
+      [&](size_t i) {
+        if (is_valid(i)) {
+          num_valid += 1;
+        }
+      },
+      katana::no_stats());
+  size_ = num_valid.reduce();
+
+  if (size_ == num_entities) {
+    katana::ParallelSTL::sort(sorted_ids_.begin(), sorted_ids_.end(), less);
+    return;
+  }
+  // Ids without a value sort after all others and are left past end().
+  katana::ParallelSTL::sort(
+      sorted_ids_.begin(), sorted_ids_.end(),
+      [&](node_or_edge a, node_or_edge b) {
+        bool valid_a = is_valid(a);
+        bool valid_b = is_valid(b);
+        if (valid_a != valid_b) {
+          return valid_a;
+        }
+        return valid_a ? less(a, b) : a < b;
+      });
+}
+
+template <typename node_or_edge>
+Result<std::unique_ptr<tsuba::FileFrame>>
+PropertyIndex<node_or_edge>::Write() {
+  const std::vector<internal::IndexArrayBase*> index_arrays = arrays();
+  PropertyIndexFileHeader header{
+      .kind = static_cast<uint64_t>(kind()),
+      .num_entities = num_entities_,
+      .size = size_,
+      .num_arrays = index_arrays.size(),
+  };
+  std::vector<uint64_t> array_sizes;
+  uint64_t file_size = FirstArrayOffset(header.num_arrays);
+  for (const internal::IndexArrayBase* array : index_arrays) {
+    array_sizes.emplace_back(array->num_bytes());
+    file_size += AlignToFile(array->num_bytes());
+  }
+
+  auto ff = std::make_unique<tsuba::FileFrame>();
+  KATANA_CHECKED(ff->Init(file_size));
+  const uint8_t zeros[kPropertyIndexFileAlignment] = {};
+  uint64_t offset = 0;
+  auto write = [&](const void* data, uint64_t size) -> Result<void> {
+    if (size == 0) {
+      return katana::ResultSuccess();
+    }
+    arrow::Status status = ff->Write(data, size);
+    if (!status.ok()) {
+      return KATANA_ERROR(
+          tsuba::ArrowToTsuba(status.code()), "writing index of {}: {}",
+          column_name_, status);
+    }
+    offset += size;
+    return katana::ResultSuccess();
+  };
+  auto pad = [&]() { return write(zeros, AlignToFile(offset) - offset); };
+
+  KATANA_CHECKED(write(&header, sizeof(header)));
+  KATANA_CHECKED(
+      write(array_sizes.data(), array_sizes.size() * sizeof(uint64_t)));
+  KATANA_CHECKED(pad());
+  for (const internal::IndexArrayBase* array : index_arrays) {
+    KATANA_CHECKED(write(array->bytes(), array->num_bytes()));
+    KATANA_CHECKED(pad());
+  }
+
+  return std::unique_ptr<tsuba::FileFrame>(std::move(ff));
+}
+
+template <typename node_or_edge>
+Result<void>
+PropertyIndex<node_or_edge>::BuildFromFile(
+    std::shared_ptr<tsuba::FileView> file) {
+  PropertyIndexFileHeader header;
+  if (file->size() < sizeof(header)) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "property index file too small: {}",
+        file->size());
+  }
+  std::memcpy(&header, file->ptr<uint8_t>(), sizeof(header));
+
+  const std::vector<internal::IndexArrayBase*> index_arrays = arrays();
+  if (header.version != kPropertyIndexFileVersion) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "unexpected property index version: {}",
+        header.version);
+  }
+  if (header.kind != static_cast<uint64_t>(kind()) ||
+      header.num_arrays != index_arrays.size() ||
+      header.num_entities != num_entities_ || header.size > num_entities_) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "property index file does not match the index of {}: kind: {} "
+        "arrays: {} entities: {}",
+        column_name_, header.kind, header.num_arrays, header.num_entities);
+  }
 
-  // TODO(osh): Index build should be parallelized.
-  for (node_or_edge i = 0; i < num_entities_; ++i) {
-    // The keys inserted are the node ids - the set translates these into
-    // property values.
-    if (property_->IsValid(i)) {
-      set_.insert(IndexID{i});
+  uint64_t offset = FirstArrayOffset(header.num_arrays);
+  if (file->size() < offset) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "property index file too small: {}",
+        file->size());
+  }
+  const auto* array_sizes = file->ptr<uint64_t>(sizeof(header));
+  for (size_t i = 0; i < index_arrays.size(); ++i) {
+    if (array_sizes[i] > file->size() - offset) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "property index file too small for array {}: {}", i, file->size());
     }
+    index_arrays[i]->Map(file->ptr<uint8_t>(offset), array_sizes[i]);
+    offset += std::min(AlignToFile(array_sizes[i]), file->size() - offset);
+  }
+  size_ = header.size;
+  file_ = std::move(file);
+
+  if (sorted_ids_.size() != num_entities_) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "stored index of {} has {} ids",
+        column_name_, sorted_ids_.size());
   }
+  return FinishBuildFromFile();
+}
+
+template <typename node_or_edge, typename c_type>
+Result<void>
+PrimitivePropertyIndex<node_or_edge, c_type>::BuildFromProperty() {
+  KATANA_CHECKED(CheckPropertyLength(*property_, this->num_entities()));
+
+  const ArrowArrayType& property = *property_;
+  this->SortIds(
+      this->num_entities(),
+      [&](node_or_edge i) { return property.IsValid(i); },
+      [&](node_or_edge a, node_or_edge b) {
+        c_type value_a = property.Value(a);
+        c_type value_b = property.Value(b);
+        return value_a < value_b || (!(value_b < value_a) && a < b);
+      });
+
+  const size_t size = this->size_;
+  keys_.Allocate(size);
+  katana::do_all(
+      katana::iterate(size_t{0}, size),
+      [&](size_t i) { keys_[i] = property.Value(this->sorted_ids_[i]); },
+      katana::no_stats());
+
+  const size_t num_blocks = (size + kBlockSize - 1) / kBlockSize;
+  block_keys_.Allocate(num_blocks + 1);
+  block_ranks_.Allocate(num_blocks + 1);
+  FillEytzinger(
+      keys_.data(), kBlockSize, num_blocks, 0, 1, block_keys_.data(),
+      block_ranks_.data());
+
+  return katana::ResultSuccess();
+}
+
+template <typename node_or_edge, typename c_type>
+Result<void>
+PrimitivePropertyIndex<node_or_edge, c_type>::FinishBuildFromFile() {
+  KATANA_CHECKED(CheckPropertyLength(*property_, this->num_entities()));
 
+  const size_t num_blocks = (this->size_ + kBlockSize - 1) / kBlockSize;
+  if (keys_.size() != this->size_ || block_keys_.size() != num_blocks + 1 ||
+      block_ranks_.size() != num_blocks + 1) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "stored index of {} has {} keys and {} blocks for {} entries",
+        this->column_name(), keys_.size(), block_keys_.size(), this->size_);
+  }
   return katana::ResultSuccess();
 }
 
 template <typename node_or_edge>
 Result<void>
 StringPropertyIndex<node_or_edge>::BuildFromProperty() {
-  if (static_cast<uint64_t>(property_->length()) < num_entities_) {
+  KATANA_CHECKED(CheckPropertyLength(*property_, this->num_entities()));
+
+  this->SortIds(
+      this->num_entities(),
+      [&](node_or_edge i) { return property_->IsValid(i); },
+      [&](node_or_edge a, node_or_edge b) {
+        int order = GetValue(a).compare(GetValue(b));
+        return order < 0 || (order == 0 && a < b);
+      });
+
+  return katana::ResultSuccess();
+}
+
+template <typename node_or_edge>
+Result<void>
+StringPropertyIndex<node_or_edge>::FinishBuildFromFile() {
+  return CheckPropertyLength(*property_, this->num_entities());
+}
+
+template <typename node_or_edge, typename code_type>
+void
+DictionaryPropertyIndex<node_or_edge, code_type>::RankCodes() {
+  const size_t num_codes = dictionary_->length();
+  ranked_codes_.clear();
+  for (size_t code = 0; code < num_codes; ++code) {
+    if (dictionary_->IsValid(code)) {
+      ranked_codes_.emplace_back(code);
+    }
+  }
+  std::sort(
+      ranked_codes_.begin(), ranked_codes_.end(),
+      [&](code_type a, code_type b) {
+        int order = GetValue(a).compare(GetValue(b));
+        return order < 0 || (order == 0 && a < b);
+      });
+  code_ranks_.assign(num_codes, ranked_codes_.size());
+  for (size_t rank = 0; rank < ranked_codes_.size(); ++rank) {
+    code_ranks_[ranked_codes_[rank]] = rank;
+  }
+}
+
+template <typename node_or_edge, typename code_type>
+Result<void>
+DictionaryPropertyIndex<node_or_edge, code_type>::BuildFromProperty() {
+  KATANA_CHECKED(CheckPropertyLength(*property_, this->num_entities()));
+
+  RankCodes();
+  const uint64_t num_ranks = ranked_codes_.size();
+  auto rank = [&](node_or_edge id) { return code_ranks_[codes_[id]]; };
+  this->SortIds(
+      this->num_entities(),
+      [&](node_or_edge i) {
+        return property_->IsValid(i) && rank(i) != num_ranks;
+      },
+      [&](node_or_edge a, node_or_edge b) {
+        uint64_t rank_a = rank(a);
+        uint64_t rank_b = rank(b);
+        return rank_a < rank_b || (rank_a == rank_b && a < b);
+      });
+
+  const node_or_edge* ids = this->sorted_ids_.data();
+  const size_t size = this->size_;
+  rank_offsets_.Allocate(num_ranks + 1);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_ranks + 1),
+      [&](uint64_t r) {
+        auto before = [&](node_or_edge id) { return rank(id) < r; };
+        rank_offsets_[r] = std::partition_point(ids, ids + size, before) - ids;
+      },
+      katana::no_stats());
+
+  return katana::ResultSuccess();
+}
+
+template <typename node_or_edge, typename code_type>
+Result<void>
+DictionaryPropertyIndex<node_or_edge, code_type>::FinishBuildFromFile() {
+  KATANA_CHECKED(CheckPropertyLength(*property_, this->num_entities()));
+
+  RankCodes();
+  const size_t num_ranks = ranked_codes_.size();
+  if (rank_offsets_.size() != num_ranks + 1 ||
+      rank_offsets_[num_ranks] != this->size_) {
     return KATANA_ERROR(
-        ErrorCode::InvalidArgument, "Property does not contain all entities");
+        ErrorCode::InvalidArgument,
+        "stored index of {} has {} offsets for {} dictionary values",
+        this->column_name(), rank_offsets_.size(), num_ranks);
   }
+  return katana::ResultSuccess();
+}
 
-  // TODO(osh): Index build should be parallelized.
-  for (node_or_edge i = 0; i < num_entities_; ++i) {
-    // The keys inserted are the node ids - the set translates these into
-    // property values.
-    if (property_->IsValid(i)) {
-      set_.insert(IndexID{i});
-    }
+template <typename node_or_edge, typename c_type>
+Result<void>
+HashPropertyIndex<node_or_edge, c_type>::BuildFromProperty() {
+  KATANA_CHECKED(CheckPropertyLength(*property_, this->num_entities()));
+
+  const ArrowArrayType& property = *property_;
+  katana::NUMAArray<uint64_t> hashes;
+  hashes.allocateInterleaved(this->num_entities());
+  katana::do_all(
+      katana::iterate(size_t{0}, this->num_entities()),
+      [&](size_t i) {
+        hashes[i] = property.IsValid(i) ? Hash(GetValue(i)) : 0;
+      },
+      katana::no_stats());
+
+  // Sorting by hash first puts equal values next to each other without
+  // comparing most values.
+  this->SortIds(
+      this->num_entities(),
+      [&](node_or_edge i) { return property.IsValid(i); },
+      [&](node_or_edge a, node_or_edge b) {
+        if (hashes[a] != hashes[b]) {
+          return hashes[a] < hashes[b];
+        }
+        c_type value_a = GetValue(a);
+        c_type value_b = GetValue(b);
+        return value_a < value_b || (!(value_b < value_a) && a < b);
+      });
+
+  // Number the groups of equal values: after the prefix sum, group_ids[i]
+  // is one plus the group of sorted_ids_[i].
+  const size_t size = this->size_;
+  const node_or_edge* ids = this->sorted_ids_.data();
+  auto starts_group = [&](size_t i) {
+    return i == 0 || hashes[ids[i - 1]] != hashes[ids[i]] ||
+           !(GetValue(ids[i - 1]) == GetValue(ids[i]));
+  };
+  katana::NUMAArray<uint64_t> group_ids;
+  group_ids.allocateInterleaved(size);
+  katana::do_all(
+      katana::iterate(size_t{0}, size),
+      [&](size_t i) { group_ids[i] = starts_group(i) ? 1 : 0; },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      group_ids.begin(), group_ids.end(), group_ids.begin());
+  const size_t num_groups = size == 0 ? 0 : group_ids[size - 1];
+  if (num_groups >= kGroupMask) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "Too many distinct values for a hash index: {}", num_groups);
   }
 
+  group_offsets_.Allocate(num_groups + 1);
+  katana::do_all(
+      katana::iterate(size_t{0}, size),
+      [&](size_t i) {
+        if (i == 0 || group_ids[i] != group_ids[i - 1]) {
+          group_offsets_[group_ids[i] - 1] = i;
+        }
+      },
+      katana::no_stats());
+  group_offsets_[num_groups] = size;
+
+  // A power of two number of buckets, at least two, with at least twice as
+  // many slots as groups.
+  size_t num_buckets = 2;
+  shift_ = 63;
+  while (num_buckets * kSlotsPerBucket < 2 * num_groups) {
+    num_buckets *= 2;
+    --shift_;
+  }
+  buckets_.Allocate(num_buckets);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_buckets),
+      [&](size_t b) {
+        for (std::atomic<uint64_t>& slot : buckets_[b].slots) {
+          slot.store(0, std::memory_order_relaxed);
+        }
+      },
+      katana::no_stats());
+
+  const size_t mask = num_buckets - 1;
+  katana::do_all(
+      katana::iterate(size_t{0}, num_groups),
+      [&](size_t group) {
+        const uint64_t hash = hashes[ids[group_offsets_[group]]];
+        const uint64_t entry = ((hash & kGroupMask) << 32) | (group + 1);
+        for (size_t b = hash >> shift_;; b = (b + 1) & mask) {
+          for (std::atomic<uint64_t>& slot : buckets_[b].slots) {
+            uint64_t empty = 0;
+            if (slot.load(std::memory_order_relaxed) == 0 &&
+                slot.compare_exchange_strong(
+                    empty, entry, std::memory_order_relaxed)) {
+              return;
+            }
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  return katana::ResultSuccess();
+}
+
+template <typename node_or_edge, typename c_type>
+Result<void>
+HashPropertyIndex<node_or_edge, c_type>::FinishBuildFromFile() {
+  KATANA_CHECKED(CheckPropertyLength(*property_, this->num_entities()));
+
+  const size_t num_buckets = buckets_.size();
+  if (group_offsets_.empty() || num_buckets < 2 ||
+      (num_buckets & (num_buckets - 1)) != 0 ||
+      buckets_.num_bytes() % sizeof(Bucket) != 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "stored index of {} has {} groups and {} buckets",
+        this->column_name(), group_offsets_.size(), num_buckets);
+  }
+  shift_ = __builtin_clzll(num_buckets) + 1;
   return katana::ResultSuccess();
 }
 
@@ -94,13 +591,29 @@ template class PrimitivePropertyIndex<GraphTopology::Edge, double_t>;
 template class StringPropertyIndex<GraphTopology::Node>;
 template class StringPropertyIndex<GraphTopology::Edge>;
 
+template class HashPropertyIndex<GraphTopology::Node, int64_t>;
+template class HashPropertyIndex<GraphTopology::Edge, int64_t>;
+template class HashPropertyIndex<GraphTopology::Node, double_t>;
+template class HashPropertyIndex<GraphTopology::Edge, double_t>;
+template class HashPropertyIndex<GraphTopology::Node, std::string_view>;
+template class HashPropertyIndex<GraphTopology::Edge, std::string_view>;
+
+template class DictionaryPropertyIndex<GraphTopology::Node, int8_t>;
+template class DictionaryPropertyIndex<GraphTopology::Edge, int8_t>;
+template class DictionaryPropertyIndex<GraphTopology::Node, int16_t>;
+template class DictionaryPropertyIndex<GraphTopology::Edge, int16_t>;
+template class DictionaryPropertyIndex<GraphTopology::Node, int32_t>;
+template class DictionaryPropertyIndex<GraphTopology::Edge, int32_t>;
+template class DictionaryPropertyIndex<GraphTopology::Node, int64_t>;
+template class DictionaryPropertyIndex<GraphTopology::Edge, int64_t>;
+
 template Result<std::unique_ptr<PropertyIndex<GraphTopology::Node>>>
 MakeTypedIndex(
     const std::string& column_name, size_t num_entities,
-    std::shared_ptr<arrow::Array> property);
+    std::shared_ptr<arrow::Array> property, PropertyIndexKind kind);
 template Result<std::unique_ptr<PropertyIndex<GraphTopology::Edge>>>
 MakeTypedIndex(
     const std::string& column_name, size_t num_entities,
-    std::shared_ptr<arrow::Array> property);
+    std::shared_ptr<arrow::Array> property, PropertyIndexKind kind);
 
 }  // namespace katana
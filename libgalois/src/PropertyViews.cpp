@@ -12,9 +12,11 @@ katana::internal::ExtractArrays(
           std::quoted(property));
     }
     if (column->num_chunks() != 1) {
-      // Katana form graphs only contain single chunk property columns.
+      // Views of several chunks are ChunkedPropertyViews
       return KATANA_ERROR(
-          ErrorCode::NotImplemented, "property is in the wrong format");
+          ErrorCode::NotImplemented,
+          "property {} has {} chunks; use a ChunkedPropertyView",
+          std::quoted(property), column->num_chunks());
     }
     ret.emplace_back(column->chunks()[0].get());
   }
@@ -30,9 +32,11 @@ katana::internal::ExtractArrays(
   for (auto& property : properties) {
     auto column = KATANA_CHECKED(pview.GetProperty(property));
     if (column->num_chunks() != 1) {
-      // Katana form graphs only contain single chunk property columns.
+      // Views of several chunks are ChunkedPropertyViews
       return KATANA_ERROR(
-          ErrorCode::NotImplemented, "property is in the wrong format");
+          ErrorCode::NotImplemented,
+          "property {} has {} chunks; use a ChunkedPropertyView",
+          std::quoted(property), column->num_chunks());
     }
     ret.emplace_back(column->chunks()[0].get());
   }
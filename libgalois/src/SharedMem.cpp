@@ -19,9 +19,17 @@
 
 #include "katana/SharedMem.h"
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
 #include <memory>
+#include <mutex>
+#include <string>
 
 #include "katana/Barrier.h"
+#include "katana/CompilerSpecific.h"
+#include "katana/Env.h"
 #include "katana/PagePool.h"
 #include "katana/TerminationDetection.h"
 #include "katana/ThreadPool.h"
@@ -202,11 +210,196 @@ public:
   }
 };
 
+// Termination detection with a scalable non-zero indicator (SNZI) of active
+// threads: a counter per socket plus a root counting the sockets with active
+// threads, so that threads going idle or active mostly touch a socket local
+// cache line and an idle thread can check if anyone is working by reading one
+// word.
+//
+// Every change of a thread between active and idle starts a new epoch. A
+// thread that sees no active threads remembers the epoch; if it is still
+// idle in the same epoch after another pass over its work, it confirms the
+// epoch. Termination happens once every thread confirms the same epoch, which
+// means that all threads found no work in a pass that started after the last
+// thread went idle.
+//
+// Idle threads back off exponentially and, after many idle rounds, park
+// until another thread changes state or a short timeout passes, so idle
+// cores do not spin through the long tail of an asynchronous loop.
+class SnziTerminationDetection : public katana::TerminationDetection {
+  // Rounds of idle spinning before a thread parks
+  static constexpr unsigned kParkAfter = 64;
+  static constexpr unsigned kMaxSpinShift = 10;
+  static constexpr std::chrono::microseconds kParkTimeout{100};
+  // Low bits of confirmed_ count the threads that confirmed the epoch in the
+  // high bits
+  static constexpr unsigned kCountBits = 16;
+  static constexpr uint64_t kCountMask = (uint64_t{1} << kCountBits) - 1;
+
+  struct ThreadState {
+    bool active;
+    unsigned idle_rounds;
+    uint64_t seen_epoch;
+    uint64_t confirmed_epoch;
+  };
+
+  katana::PerThreadStorage<ThreadState> data_;
+  katana::PerSocketStorage<katana::CacheLineStorage<std::atomic<unsigned>>>
+      socket_active_;
+  katana::CacheLineStorage<std::atomic<unsigned>> root_;
+  katana::CacheLineStorage<std::atomic<uint64_t>> epoch_;
+  katana::CacheLineStorage<std::atomic<uint64_t>> confirmed_;
+  katana::CacheLineStorage<std::atomic<unsigned>> parked_;
+
+  std::mutex park_lock_;
+  std::condition_variable park_cond_;
+
+  unsigned active_threads_;
+
+  void WakeParked() {
+    if (parked_.data.load() != 0) {
+      std::lock_guard<std::mutex> lock(park_lock_);
+      park_cond_.notify_all();
+    }
+  }
+
+  void Arrive() {
+    epoch_.data.fetch_add(1);
+    auto& socket = socket_active_.getLocal()->data;
+    if (socket.fetch_add(1) == 0) {
+      root_.data.fetch_add(1);
+    }
+    WakeParked();
+  }
+
+  void Depart() {
+    epoch_.data.fetch_add(1);
+    auto& socket = socket_active_.getLocal()->data;
+    if (socket.fetch_sub(1) == 1 && root_.data.fetch_sub(1) == 1) {
+      // The last active thread; let parked threads confirm quickly
+      WakeParked();
+    }
+  }
+
+  void Confirm(uint64_t epoch) {
+    uint64_t tag = epoch << kCountBits;
+    uint64_t old = confirmed_.data.load();
+    uint64_t next;
+    do {
+      // A thread preempted between reading the epoch and confirming it must
+      // not reset the count of a newer epoch; it confirms that one later
+      if ((old & ~kCountMask) > tag || epoch_.data.load() != epoch) {
+        return;
+      }
+      next = (old & ~kCountMask) == tag ? old + 1 : tag + 1;
+    } while (!confirmed_.data.compare_exchange_weak(old, next));
+
+    if ((next & kCountMask) == active_threads_) {
+      SetTerminated();
+      WakeParked();
+    }
+  }
+
+  void Idle(ThreadState& ts) {
+    ++ts.idle_rounds;
+    if (ts.idle_rounds < kParkAfter) {
+      unsigned spins = 1U << std::min(ts.idle_rounds, kMaxSpinShift);
+      for (unsigned i = 0; i < spins; ++i) {
+        katana::asmPause();
+      }
+      return;
+    }
+
+    std::unique_lock<std::mutex> lock(park_lock_);
+    uint64_t epoch = epoch_.data.load();
+    parked_.data.fetch_add(1);
+    park_cond_.wait_for(lock, kParkTimeout, [&] {
+      return epoch_.data.load() != epoch || !Working();
+    });
+    parked_.data.fetch_sub(1);
+  }
+
+protected:
+  void Init(unsigned active_threads) override {
+    KATANA_LOG_DEBUG_ASSERT(active_threads <= kCountMask);
+    active_threads_ = active_threads;
+    auto& tp = katana::GetThreadPool();
+    for (unsigned i = 0; i < tp.getMaxSockets(); ++i) {
+      socket_active_.getRemote(tp.getLeaderForSocket(i))->data = 0;
+    }
+    root_.data = 0;
+    confirmed_.data = 0;
+    epoch_.data.fetch_add(1);
+  }
+
+public:
+  void InitializeThread() override {
+    ThreadState& ts = *data_.getLocal();
+    ts.active = true;
+    ts.idle_rounds = 0;
+    ts.seen_epoch = 0;
+    ts.confirmed_epoch = 0;
+    ResetTerminated();
+    Arrive();
+  }
+
+  void SignalWorked(bool work_happened) override {
+    KATANA_LOG_DEBUG_ASSERT(!(work_happened && !Working()));
+    ThreadState& ts = *data_.getLocal();
+    if (work_happened) {
+      ts.idle_rounds = 0;
+      if (!ts.active) {
+        ts.active = true;
+        Arrive();
+      }
+      return;
+    }
+
+    if (ts.active) {
+      ts.active = false;
+      Depart();
+      return;
+    }
+
+    if (root_.data.load() == 0) {
+      uint64_t epoch = epoch_.data.load();
+      if (ts.seen_epoch != epoch) {
+        ts.seen_epoch = epoch;
+        return;
+      }
+      if (ts.confirmed_epoch != epoch) {
+        ts.confirmed_epoch = epoch;
+        Confirm(epoch);
+        return;
+      }
+    }
+
+    Idle(ts);
+  }
+};
+
+std::unique_ptr<katana::TerminationDetection>
+CreateTerminationDetection() {
+  std::string kind;
+  if (katana::GetEnv("KATANA_TERMINATION", &kind)) {
+    if (kind == "snzi") {
+      return std::make_unique<SnziTerminationDetection>();
+    }
+    if (kind == "tree") {
+      return std::make_unique<TreeTerminationDetection>();
+    }
+    if (kind != "ring") {
+      KATANA_LOG_WARN("unknown KATANA_TERMINATION value: {}", kind);
+    }
+  }
+  return std::make_unique<LocalTerminationDetection>();
+}
+
 }  // namespace
 
 struct katana::SharedMem::Impl {
   struct Dependents {
-    LocalTerminationDetection term;
+    std::unique_ptr<katana::TerminationDetection> term;
     std::unique_ptr<Barrier> barrier;
     internal::PageAllocState<> page_pool;
   };
@@ -223,9 +416,10 @@ katana::SharedMem::SharedMem() : impl_(std::make_unique<Impl>()) {
   impl_->deps = std::make_unique<Impl::Dependents>();
   impl_->deps->barrier =
       katana::CreateTopoBarrier(impl_->thread_pool.getMaxUsableThreads());
+  impl_->deps->term = CreateTerminationDetection();
 
   internal::SetBarrier(impl_->deps->barrier.get());
-  internal::SetTerminationDetection(&impl_->deps->term);
+  internal::SetTerminationDetection(impl_->deps->term.get());
   internal::setPagePoolState(&impl_->deps->page_pool);
 }
 
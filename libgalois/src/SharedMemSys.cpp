@@ -20,7 +20,9 @@
 #include "katana/SharedMemSys.h"
 
 #include "katana/CommBackend.h"
+#include "katana/EventRecorder.h"
 #include "katana/Logging.h"
+#include "katana/ParallelismProfile.h"
 #include "katana/Plugin.h"
 #include "katana/SharedMem.h"
 #include "katana/Statistics.h"
@@ -48,9 +50,13 @@ katana::SharedMemSys::SharedMemSys(std::unique_ptr<ProgressTracer> tracer)
   katana::ProgressTracer::Set(std::move(tracer));
 
   katana::internal::setSysStatManager(&impl_->stat_manager);
+  katana::EventRecorder::InstallDumpSignal();
 }
 
 katana::SharedMemSys::~SharedMemSys() {
+  katana::EventRecorder::DumpAtExit();
+  katana::ParallelismProfile::DumpAtExit();
+  katana::ReportMemoryAccounting();
   katana::PrintStats();
   katana::internal::setSysStatManager(nullptr);
 
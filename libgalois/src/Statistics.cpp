@@ -26,9 +26,12 @@
 #include <iostream>
 #include <sstream>
 
+#include <nlohmann/json.hpp>
+
 #include "katana/Env.h"
 #include "katana/Executor_OnEach.h"
 #include "katana/Logging.h"
+#include "katana/MemoryAccounting.h"
 #include "katana/PerThreadStorage.h"
 #include "tsuba/file.h"
 
@@ -46,6 +49,17 @@ PrintHeader(std::ostream& out, const char* sep) {
   out << "\n";
 }
 
+template <typename T>
+T
+JsonValue(const T& value) {
+  return value;
+}
+
+std::string
+JsonValue(const katana::gstl::Str& value) {
+  return std::string(value.begin(), value.end());
+}
+
 template <typename T>
 struct StatImpl {
   using MergedStats = katana::internal::VecStatManager<T>;
@@ -125,6 +139,27 @@ struct StatImpl {
       }
     }
   }
+
+  void PrintJson(nlohmann::json* out) const {
+    for (auto i = result_.cbegin(), end_i = result_.cend(); i != end_i; ++i) {
+      const auto& s = result_.stat(i);
+      nlohmann::json stat = {
+          {"stat_type", StatKind()},
+          {"region", JsonValue(result_.region(i))},
+          {"category", JsonValue(result_.category(i))},
+          {"total_type", katana::StatTotal::str(s.totalTy())},
+          {"total", JsonValue(s.total())},
+      };
+      if (CheckPrintingThreadVals()) {
+        nlohmann::json values = nlohmann::json::array();
+        for (const auto& v : s.values()) {
+          values.push_back(JsonValue(v));
+        }
+        stat["thread_values"] = std::move(values);
+      }
+      out->push_back(std::move(stat));
+    }
+  }
 };
 
 }  // end unnamed namespace
@@ -151,6 +186,17 @@ katana::StatManager::IsPrintingThreadVals() const {
   return CheckPrintingThreadVals();
 }
 
+void
+katana::StatManager::PrintStatsJson(std::ostream& out) {
+  MergeStats();
+
+  nlohmann::json stats = nlohmann::json::array();
+  impl_->int_stats_.PrintJson(&stats);
+  impl_->fp_stats_.PrintJson(&stats);
+  impl_->str_stats_.PrintJson(&stats);
+  out << stats.dump(2) << "\n";
+}
+
 void
 katana::StatManager::PrintStats(std::ostream& out) {
   MergeStats();
@@ -254,7 +300,14 @@ katana::StatManager::Print() {
   }
   // n.b. Assumes that stats fit in memory
   std::ostringstream out;
-  PrintStats(out);
+  const std::string suffix = ".json";
+  const std::string& path = impl_->outfile_;
+  if (path.size() >= suffix.size() &&
+      path.compare(path.size() - suffix.size(), suffix.size(), suffix) == 0) {
+    PrintStatsJson(out);
+  } else {
+    PrintStats(out);
+  }
 
   std::string stats = out.str();
   if (stats.empty()) {
@@ -295,8 +348,37 @@ katana::reportPageAlloc(const char* category) {
   katana::on_each_gen(
       [category](unsigned int tid, unsigned int) {
         ReportStatSum("PageAlloc", category, numPagePoolAllocForThread(tid));
+        ReportStatSum(
+            "PageAlloc", std::string(category) + "FreePages",
+            numPagePoolFreeForThread(tid));
+        ReportStatSum(
+            "PageAlloc", std::string(category) + "NodeReusePages",
+            numPagePoolNodeReuseForThread(tid));
       },
       std::make_tuple());
+
+  PageBackingCounts backing = pageBackingCounts();
+  ReportStatSingle(
+      "PageAlloc", std::string(category) + "HugeTLBPages", backing.hugetlb);
+  ReportStatSingle(
+      "PageAlloc", std::string(category) + "TransparentHugePages",
+      backing.transparent);
+  ReportStatSingle(
+      "PageAlloc", std::string(category) + "RegularPages", backing.regular);
+}
+
+void
+katana::ReportMemoryAccounting() {
+  for (int i = 0; i < static_cast<int>(MemoryCategory::kNumCategories); ++i) {
+    auto category = static_cast<MemoryCategory>(i);
+    std::string name = MemoryCategoryName(category);
+    ReportStatSingle(
+        "MemoryAccounting", name + "Bytes",
+        MemoryAccounting::current(category));
+    ReportStatSingle(
+        "MemoryAccounting", name + "PeakBytes",
+        MemoryAccounting::peak(category));
+  }
 }
 
 void
@@ -0,0 +1,96 @@
+#include "katana/TemporalEdgeIndex.h"
+
+#include <iomanip>
+
+#include <arrow/api.h>
+#include <arrow/compute/api.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/Loops.h"
+#include "katana/PropertyGraph.h"
+
+namespace {
+
+/// The values of \p column as 64-bit integers
+katana::Result<std::shared_ptr<arrow::Int64Array>>
+TimestampsAsInt64(
+    const std::shared_ptr<arrow::ChunkedArray>& column,
+    const std::string& name) {
+  std::shared_ptr<arrow::Array> values =
+      KATANA_CHECKED(katana::CombinedArray(column));
+  if (values->null_count() > 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "timestamp property {} has {} null values", std::quoted(name),
+        values->null_count());
+  }
+
+  switch (values->type_id()) {
+  case arrow::Type::INT64:
+    break;
+  // Stored as 64-bit integers already
+  case arrow::Type::TIMESTAMP:
+  case arrow::Type::DATE64:
+  case arrow::Type::TIME64:
+  case arrow::Type::DURATION:
+    values = KATANA_CHECKED(values->View(arrow::int64()));
+    break;
+  case arrow::Type::DATE32:
+  case arrow::Type::TIME32:
+    values = KATANA_CHECKED(values->View(arrow::int32()));
+    values = KATANA_CHECKED(arrow::compute::Cast(*values, arrow::int64()));
+    break;
+  case arrow::Type::INT8:
+  case arrow::Type::INT16:
+  case arrow::Type::INT32:
+  case arrow::Type::UINT8:
+  case arrow::Type::UINT16:
+  case arrow::Type::UINT32:
+  case arrow::Type::UINT64:
+    values = KATANA_CHECKED_CONTEXT(
+        arrow::compute::Cast(*values, arrow::int64()),
+        "timestamp property {}", std::quoted(name));
+    break;
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError,
+        "timestamp property {} has type {}, not an integer or temporal type",
+        std::quoted(name), values->type()->ToString());
+  }
+  return std::static_pointer_cast<arrow::Int64Array>(values);
+}
+
+}  // namespace
+
+katana::Result<std::unique_ptr<katana::TemporalEdgeIndex>>
+katana::TemporalEdgeIndex::Make(
+    const PropertyGraph* pg, const std::string& timestamp_property,
+    EdgeShuffleTopology::TransposeKind tpose_kind) noexcept {
+  auto column = KATANA_CHECKED(pg->GetEdgeProperty(timestamp_property));
+  std::shared_ptr<arrow::Int64Array> timestamps =
+      KATANA_CHECKED(TimestampsAsInt64(column, timestamp_property));
+  const int64_t* raw = timestamps->raw_values();
+
+  std::shared_ptr<EdgeShuffleTopology> topo =
+      tpose_kind == EdgeShuffleTopology::TransposeKind::kYes
+          ? EdgeShuffleTopology::MakeTransposeCopy(pg)
+          : EdgeShuffleTopology::MakeOriginalCopy(pg);
+  topo->SortEdgesByTimestamp(raw);
+
+  NUMAArray<int64_t> times;
+  times.allocateBlocked(topo->num_edges());
+  katana::do_all(
+      katana::iterate(topo->all_edges()),
+      [&](Edge e) { times[e] = raw[topo->edge_property_index(e)]; },
+      katana::no_stats(), katana::loopname("TemporalEdgeIndexTimes"));
+
+  return std::unique_ptr<TemporalEdgeIndex>(
+      new TemporalEdgeIndex(std::move(topo), std::move(times)));
+}
+
+size_t
+katana::TemporalEdgeIndex::bytes() const noexcept {
+  return num_nodes() * sizeof(Edge) +
+         num_edges() *
+             (sizeof(Node) + sizeof(PropertyIndex) + sizeof(int64_t));
+}
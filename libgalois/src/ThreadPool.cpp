@@ -23,6 +23,7 @@
 #include <iostream>
 
 #include "katana/Env.h"
+#include "katana/EventRecorder.h"
 #include "katana/HWTopo.h"
 #include "katana/Logging.h"
 
@@ -39,23 +40,17 @@ using katana::ThreadPool;
 thread_local ThreadPool::per_signal ThreadPool::my_box;
 
 ThreadPool::ThreadPool()
-    : mi(getHWTopo().machineTopoInfo),
-      reserved(0),
-      masterFastmode(false),
-      running(false) {
+    : reserved(0), masterFastmode(false), running(false) {
+  HWTopoInfo topo = getHWTopo();
+  mi = topo.machineTopoInfo;
+  threadTopo = std::move(topo.threadTopoInfo);
   signals.resize(mi.maxThreads);
   initThread(0);
 
-  for (unsigned i = 1; i < mi.maxThreads; ++i) {
-    std::thread t(&ThreadPool::threadLoop, this, i);
-    threads.emplace_back(std::move(t));
-  }
-
-  // we don't want signals to have to contain atomics, since they are set once
-  while (std::any_of(signals.begin(), signals.end(), [](per_signal* p) {
-    return !p || !p->done;
-  })) {
-    std::atomic_thread_fence(std::memory_order_seq_cst);
+  // Other threads start when a parallel region first uses them, so short
+  // runs do not pay for starting and binding threads they never use
+  if (GetEnv("KATANA_EAGER_THREADS")) {
+    spawnThreads(mi.maxThreads);
   }
 }
 
@@ -69,7 +64,26 @@ ThreadPool::~ThreadPool() {
 void
 ThreadPool::destroyCommon() {
   beKind();  // reset fastmode
-  run(mi.maxThreads, []() { throw shutdown_ty(); });
+  run(getNumSpawnedThreads(), []() { throw shutdown_ty(); });
+}
+
+void
+ThreadPool::spawnThreads(unsigned num) {
+  unsigned begin = getNumSpawnedThreads();
+  if (num <= begin) {
+    return;
+  }
+  for (unsigned i = begin; i < num; ++i) {
+    std::thread t(&ThreadPool::threadLoop, this, i);
+    threads.emplace_back(std::move(t));
+  }
+
+  // we don't want signals to have to contain atomics, since they are set once
+  while (std::any_of(
+      signals.begin() + begin, signals.begin() + num,
+      [](per_signal* p) { return !p || !p->done; })) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+  }
 }
 
 void
@@ -129,7 +143,7 @@ getNth(std::atomic<T*>& headptr, unsigned off) {
 void
 ThreadPool::initThread(unsigned tid) {
   signals[tid] = &my_box;
-  my_box.topo = getHWTopo().threadTopoInfo[tid];
+  my_box.topo = threadTopo[tid];
   // Initialize
   initPTS(mi.maxThreads);
 
@@ -226,15 +240,27 @@ ThreadPool::cascade(bool fastmode) {
   }
 }
 
+void
+ThreadPool::beginRun() {
+  // Claim the pool before touching work so that a rejected caller cannot
+  // clobber the running region
+  bool was_running = false;
+  if (!running.compare_exchange_strong(was_running, true)) {
+    KATANA_LOG_FATAL(
+        "Recursive or concurrent thread pool execution not supported; start "
+        "parallel regions from one application thread at a time");
+  }
+}
+
 void
 ThreadPool::runInternal(unsigned num) {
   // sanitize num
   // seq write to starting should make work safe
-  KATANA_LOG_VASSERT(!running, "Recursive thread pool execution not supported");
-  running = true;
+  KATANA_LOG_DEBUG_ASSERT(running);
   num = std::min(std::max(1U, num), getMaxUsableThreads());
   // my_box is tid 0
   auto& me = my_box;
+  spawnThreads(num);
   me.wbegin = 1;
   me.wend = num;
 
@@ -247,12 +273,17 @@ ThreadPool::runInternal(unsigned num) {
   } catch (const shutdown_ty&) {
     return;
   } catch (const fastmode_ty& fm) {
+  } catch (...) {
+    // let the children finish with work before the pool is released
+    decascade();
+    work = nullptr;
+    throw;
   }
   // wait for children
   decascade();
   // Clean up
   work = nullptr;
-  running = false;
+  katana::EventRecorder::DumpIfRequested();
 }
 
 void
@@ -265,6 +296,8 @@ ThreadPool::runDedicated(std::function<void(void)>& f) {
   ++reserved;
 
   KATANA_LOG_VASSERT(reserved < mi.maxThreads, "Too many dedicated threads");
+  // Dedicated threads are taken from the top of the pool
+  spawnThreads(mi.maxThreads);
   work = [&f]() { throw dedicated_ty{f}; };
   auto* child = signals[mi.maxThreads - reserved];
   child->wbegin = 0;
@@ -38,3 +38,17 @@ unsigned int
 katana::getActiveThreads() noexcept {
   return katana::activeThreads;
 }
+
+katana::internal::ScopedActiveThreads::ScopedActiveThreads(
+    unsigned int num) noexcept
+    : prev_(katana::activeThreads) {
+  if (!katana::GetThreadPool().isRunning()) {
+    katana::activeThreads = std::max(std::min(num, prev_), 1U);
+  }
+}
+
+katana::internal::ScopedActiveThreads::~ScopedActiveThreads() {
+  if (katana::activeThreads != prev_) {
+    katana::activeThreads = prev_;
+  }
+}
@@ -0,0 +1,342 @@
+#include "katana/analytics/AutoTune.h"
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "katana/DynamicBitset.h"
+#include "katana/JSON.h"
+#include "katana/Logging.h"
+#include "katana/URI.h"
+#include "katana/analytics/Utils.h"
+#include "katana/analytics/subgraph_extraction/subgraph_extraction.h"
+#include "tsuba/file.h"
+
+namespace {
+
+using katana::analytics::AutoTuneOptions;
+using katana::analytics::BfsPlan;
+using katana::analytics::ConnectedComponentsPlan;
+using katana::analytics::SsspPlan;
+using Node = katana::PropertyGraph::Node;
+
+/// Choices are kept next to the RDG rather than in it, so that recording one
+/// does not need a new version of the graph
+const char* const kPlansFile = "katana_plans.json";
+
+template <typename PlanT>
+struct Candidate {
+  /// Identifies the plan in the stored choices, so it must be stable
+  std::string name;
+  PlanT plan;
+};
+
+/// Run a plan from source, writing to the node property named output
+template <typename PlanT>
+using Trial = std::function<katana::Result<void>(
+    katana::PropertyGraph* pg, Node source, const std::string& output,
+    const PlanT& plan)>;
+
+std::vector<Candidate<BfsPlan>>
+BfsCandidates() {
+  std::vector<Candidate<BfsPlan>> candidates;
+  for (auto [alpha, beta] : std::vector<std::pair<uint32_t, uint32_t>>{
+           {BfsPlan::kDefaultAlpha, BfsPlan::kDefaultBeta},
+           {5, 18},
+           {15, 24},
+           {30, 12}}) {
+    candidates.push_back(
+        {fmt::format("SynchronousDirectOpt/alpha={},beta={}", alpha, beta),
+         BfsPlan::SynchronousDirectOpt(alpha, beta)});
+  }
+  for (ptrdiff_t tile : {64, 256, 1024}) {
+    candidates.push_back(
+        {fmt::format("AsynchronousTile/tile={}", tile),
+         BfsPlan::AsynchronousTile(tile)});
+    candidates.push_back(
+        {fmt::format("SynchronousTile/tile={}", tile),
+         BfsPlan::SynchronousTile(tile)});
+  }
+  return candidates;
+}
+
+std::vector<Candidate<SsspPlan>>
+SsspCandidates() {
+  std::vector<Candidate<SsspPlan>> candidates;
+  for (unsigned delta : {8, 10, 13, 16}) {
+    candidates.push_back(
+        {fmt::format("DeltaStep/delta={}", delta),
+         SsspPlan::DeltaStep(delta)});
+    candidates.push_back(
+        {fmt::format("DeltaStepBarrier/delta={}", delta),
+         SsspPlan::DeltaStepBarrier(delta)});
+  }
+  for (ptrdiff_t tile : {128, 512, 2048}) {
+    candidates.push_back(
+        {fmt::format(
+             "DeltaTile/delta={},tile={}", SsspPlan::kDefaultDelta, tile),
+         SsspPlan::DeltaTile(SsspPlan::kDefaultDelta, tile)});
+  }
+  candidates.push_back({"DeltaStepAdaptive", SsspPlan::DeltaStepAdaptive()});
+  candidates.push_back({"MultiQueue", SsspPlan::MultiQueue()});
+  return candidates;
+}
+
+std::vector<Candidate<ConnectedComponentsPlan>>
+ConnectedComponentsCandidates() {
+  std::vector<Candidate<ConnectedComponentsPlan>> candidates;
+  for (uint32_t sample : {1, 2, 4}) {
+    candidates.push_back(
+        {fmt::format("Afforest/neighbor_sample={}", sample),
+         ConnectedComponentsPlan::Afforest(sample)});
+    candidates.push_back(
+        {fmt::format("EdgeAfforest/neighbor_sample={}", sample),
+         ConnectedComponentsPlan::EdgeAfforest(sample)});
+  }
+  for (ptrdiff_t tile : {128, 512}) {
+    candidates.push_back(
+        {fmt::format("EdgeTiledAfforest/tile={}", tile),
+         ConnectedComponentsPlan::EdgeTiledAfforest(tile)});
+  }
+  candidates.push_back(
+      {"Asynchronous", ConnectedComponentsPlan::Asynchronous()});
+  candidates.push_back(
+      {"BlockedAsynchronous", ConnectedComponentsPlan::BlockedAsynchronous()});
+  return candidates;
+}
+
+std::string
+PlansUri(const katana::PropertyGraph& pg) {
+  return katana::Uri::JoinPath(pg.rdg_dir(), kPlansFile);
+}
+
+/// The stored choices for pg, or an empty object if there are none. A
+/// missing or unreadable file only means the plans are tuned again.
+nlohmann::json
+LoadChoices(const katana::PropertyGraph& pg) {
+  nlohmann::json empty = nlohmann::json::object();
+  if (pg.rdg_dir().empty()) {
+    return empty;
+  }
+  std::string uri = PlansUri(pg);
+  tsuba::StatBuf stat;
+  if (!tsuba::FileStat(uri, &stat)) {
+    return empty;
+  }
+  std::string contents(stat.size, '\0');
+  if (auto res = tsuba::FileGet(uri, contents.data(), 0, stat.size); !res) {
+    KATANA_LOG_WARN("reading {}: {}", uri, res.error());
+    return empty;
+  }
+  auto res = katana::JsonParse<nlohmann::json>(contents);
+  if (!res || !res.value().is_object()) {
+    KATANA_LOG_WARN("ignoring malformed {}", uri);
+    return empty;
+  }
+  return std::move(res.value());
+}
+
+katana::Result<void>
+StoreChoice(
+    const katana::PropertyGraph& pg, const std::string& key,
+    const std::string& name) {
+  if (pg.rdg_dir().empty()) {
+    return katana::ResultSuccess();
+  }
+  nlohmann::json choices = LoadChoices(pg);
+  choices[key] = {
+      {"num_nodes", pg.num_nodes()},
+      {"num_edges", pg.num_edges()},
+      {"plan", name},
+  };
+  std::string contents = KATANA_CHECKED(katana::JsonDump(choices));
+  return tsuba::FileStore(PlansUri(pg), contents);
+}
+
+/// The node with the most out edges, as a source that reaches much of the
+/// graph
+Node
+MaxDegreeNode(const katana::PropertyGraph& pg) {
+  const katana::GraphTopology& topo = pg.topology();
+  Node best = 0;
+  for (Node n : topo.all_nodes()) {
+    if (topo.edges(n).size() > topo.edges(best).size()) {
+      best = n;
+    }
+  }
+  return best;
+}
+
+/// The subgraph induced by the first max_nodes nodes found by a breadth
+/// first search from the node of highest degree, continued from the next
+/// unvisited node whenever a component is exhausted. Unlike a uniform sample,
+/// this keeps the neighborhoods, and so the degrees and diameter, that the
+/// plans are sensitive to.
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+Sample(
+    katana::PropertyGraph* pg, uint64_t max_nodes,
+    const std::vector<std::string>& edge_properties) {
+  const katana::GraphTopology& topo = pg->topology();
+  katana::DynamicBitset visited;
+  visited.resize(topo.num_nodes());
+  std::vector<Node> nodes;
+  nodes.reserve(max_nodes);
+
+  std::deque<Node> queue;
+  Node next_root = 0;
+  queue.push_back(MaxDegreeNode(*pg));
+  visited.set(queue.front());
+  while (nodes.size() < max_nodes) {
+    if (queue.empty()) {
+      while (visited.test(next_root)) {
+        ++next_root;
+      }
+      queue.push_back(next_root);
+      visited.set(next_root);
+    }
+    Node n = queue.front();
+    queue.pop_front();
+    nodes.emplace_back(n);
+    for (auto e : topo.edges(n)) {
+      Node dst = topo.edge_dest(e);
+      if (!visited.test(dst)) {
+        visited.set(dst);
+        queue.push_back(dst);
+      }
+    }
+  }
+  std::sort(nodes.begin(), nodes.end());
+
+  return katana::analytics::SubGraphExtraction(
+      pg, nodes, {}, edge_properties);
+}
+
+uint64_t
+NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+/// Return the candidate stored under key for pg or, if there is none, the
+/// fastest candidate on pg or a sample of it.
+template <typename PlanT>
+katana::Result<PlanT>
+Tune(
+    katana::PropertyGraph* pg, const std::string& key,
+    const std::vector<Candidate<PlanT>>& candidates,
+    const std::vector<std::string>& edge_properties, const Trial<PlanT>& trial,
+    const AutoTuneOptions& options) {
+  if (options.reuse_stored) {
+    nlohmann::json choices = LoadChoices(*pg);
+    auto it = choices.find(key);
+    if (it != choices.end() && it->is_object() &&
+        it->value("num_nodes", uint64_t{0}) == pg->num_nodes() &&
+        it->value("num_edges", uint64_t{0}) == pg->num_edges()) {
+      std::string name = it->value("plan", "");
+      for (const auto& candidate : candidates) {
+        if (candidate.name == name) {
+          return candidate.plan;
+        }
+      }
+      // A plan that is no longer a candidate is tuned again
+    }
+  }
+
+  std::unique_ptr<katana::PropertyGraph> sample;
+  katana::PropertyGraph* calibration_graph = pg;
+  if (pg->num_nodes() > options.max_sample_nodes) {
+    sample = KATANA_CHECKED_CONTEXT(
+        Sample(pg, options.max_sample_nodes, edge_properties),
+        "sampling graph");
+    calibration_graph = sample.get();
+  }
+  Node source = MaxDegreeNode(*calibration_graph);
+
+  const Candidate<PlanT>* best = nullptr;
+  uint64_t best_ns = std::numeric_limits<uint64_t>::max();
+  for (const auto& candidate : candidates) {
+    uint64_t candidate_ns = std::numeric_limits<uint64_t>::max();
+    for (uint32_t run = 0; run < std::max(options.runs, uint32_t{1}); ++run) {
+      katana::analytics::TemporaryPropertyGuard output(
+          calibration_graph->NodeMutablePropertyView());
+      uint64_t start = NowNs();
+      auto res =
+          trial(calibration_graph, source, output.name(), candidate.plan);
+      uint64_t ns = NowNs() - start;
+      if (!res) {
+        // Plans may not support every graph, e.g., every weight type
+        KATANA_LOG_DEBUG("{} {}: {}", key, candidate.name, res.error());
+        candidate_ns = std::numeric_limits<uint64_t>::max();
+        break;
+      }
+      candidate_ns = std::min(candidate_ns, ns);
+    }
+    KATANA_LOG_DEBUG("{} {}: {} ns", key, candidate.name, candidate_ns);
+    if (candidate_ns < best_ns) {
+      best = &candidate;
+      best_ns = candidate_ns;
+    }
+  }
+  if (best == nullptr) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "no {} plan runs on the graph",
+        key);
+  }
+
+  if (options.store) {
+    if (auto res = StoreChoice(*pg, key, best->name); !res) {
+      KATANA_LOG_WARN("storing {} plan: {}", key, res.error());
+    }
+  }
+  return best->plan;
+}
+
+}  // namespace
+
+katana::Result<BfsPlan>
+katana::analytics::AutoTuneBfsPlan(
+    PropertyGraph* pg, const AutoTuneOptions& options) {
+  Trial<BfsPlan> trial = [](PropertyGraph* g, Node source,
+                            const std::string& output, const BfsPlan& plan) {
+    return Bfs(g, source, output, plan);
+  };
+  return Tune(pg, "bfs", BfsCandidates(), {}, trial, options);
+}
+
+katana::Result<SsspPlan>
+katana::analytics::AutoTuneSsspPlan(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const AutoTuneOptions& options) {
+  if (!pg->HasEdgeProperty(edge_weight_property_name)) {
+    return KATANA_ERROR(
+        ErrorCode::PropertyNotFound, "no edge property {}",
+        edge_weight_property_name);
+  }
+  Trial<SsspPlan> trial = [&](PropertyGraph* g, Node source,
+                              const std::string& output,
+                              const SsspPlan& plan) {
+    return Sssp(g, source, edge_weight_property_name, output, plan);
+  };
+  return Tune(
+      pg, "sssp/" + edge_weight_property_name, SsspCandidates(),
+      {edge_weight_property_name}, trial, options);
+}
+
+katana::Result<ConnectedComponentsPlan>
+katana::analytics::AutoTuneConnectedComponentsPlan(
+    PropertyGraph* pg, const AutoTuneOptions& options) {
+  Trial<ConnectedComponentsPlan> trial =
+      [](PropertyGraph* g, Node, const std::string& output,
+         const ConnectedComponentsPlan& plan) {
+        return ConnectedComponents(g, output, plan);
+      };
+  return Tune(
+      pg, "connected_components", ConnectedComponentsCandidates(), {}, trial,
+      options);
+}
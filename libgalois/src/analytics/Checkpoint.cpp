@@ -0,0 +1,244 @@
+#include "katana/analytics/Checkpoint.h"
+
+#include <chrono>
+#include <unordered_set>
+
+#include <nlohmann/json.hpp>
+
+#include "katana/JSON.h"
+#include "katana/Logging.h"
+#include "katana/URI.h"
+#include "tsuba/Errors.h"
+#include "tsuba/FileFrame.h"
+#include "tsuba/WriteGroup.h"
+#include "tsuba/file.h"
+
+namespace {
+
+/// Store frames, then commit them by storing manifest at manifest_uri, and
+/// only then delete the files of the checkpoint they replace
+katana::Result<void>
+StoreCheckpoint(
+    const std::string& directory,
+    const std::vector<std::shared_ptr<tsuba::FileFrame>>& frames,
+    const std::string& manifest_uri, const std::string& manifest,
+    const std::unordered_set<std::string>& replaced) {
+  auto write_group = KATANA_CHECKED(tsuba::WriteGroup::Make());
+  for (const auto& ff : frames) {
+    write_group->StartStore(ff);
+  }
+  KATANA_CHECKED_CONTEXT(write_group->Finish(), "storing checkpoint");
+  KATANA_CHECKED_CONTEXT(
+      tsuba::FileStore(manifest_uri, manifest), "committing checkpoint");
+  if (!replaced.empty()) {
+    // The new checkpoint is committed, so a failure only leaves garbage
+    if (auto res = tsuba::FileDelete(directory, replaced); !res) {
+      KATANA_LOG_WARN("deleting old checkpoint: {}", res.error());
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+katana::Result<std::unique_ptr<katana::analytics::Checkpointer>>
+katana::analytics::Checkpointer::Make(
+    const std::string& directory, uint32_t interval) {
+  if (directory.empty()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "checkpoint directory is empty");
+  }
+  if (interval == 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "checkpoint interval must be positive");
+  }
+  return std::unique_ptr<Checkpointer>(new Checkpointer(directory, interval));
+}
+
+katana::analytics::Checkpointer::~Checkpointer() {
+  if (auto res = Wait(); !res) {
+    KATANA_LOG_WARN("checkpoint: {}", res.error());
+  }
+}
+
+std::string
+katana::analytics::Checkpointer::ManifestUri() const {
+  return katana::Uri::JoinPath(directory_, key_ + ".checkpoint");
+}
+
+std::string
+katana::analytics::Checkpointer::FileName(
+    uint64_t sequence, const std::string& buffer) const {
+  return fmt::format("{}.{}.{}", key_, sequence, buffer);
+}
+
+void
+katana::analytics::Checkpointer::Begin(const std::string& key) {
+  if (auto res = Wait(); !res) {
+    KATANA_LOG_WARN("checkpoint of {}: {}", key_, res.error());
+  }
+  key_ = key;
+  buffers_.clear();
+  sequence_ = 0;
+  next_sequence_ = 0;
+  has_committed_ = false;
+}
+
+void
+katana::analytics::Checkpointer::AddBuffer(
+    const std::string& name, void* data, size_t size) {
+  buffers_.emplace_back(Buffer{name, data, size});
+}
+
+katana::Result<bool>
+katana::analytics::Checkpointer::Restore() {
+  KATANA_CHECKED(Wait());
+
+  std::string uri = ManifestUri();
+  tsuba::StatBuf stat;
+  if (!tsuba::FileStat(uri, &stat)) {
+    return false;
+  }
+  std::string contents(stat.size, '\0');
+  KATANA_CHECKED_CONTEXT(
+      tsuba::FileGet(uri, contents.data(), 0, stat.size), "reading {}", uri);
+  nlohmann::json manifest = KATANA_CHECKED_CONTEXT(
+      katana::JsonParse<nlohmann::json>(contents), "parsing {}", uri);
+
+  uint64_t sequence = 0;
+  try {
+    if (manifest.at("key").get<std::string>() != key_) {
+      return false;
+    }
+    sequence = manifest.at("sequence").get<uint64_t>();
+    const nlohmann::json& saved = manifest.at("buffers");
+    if (saved.size() != buffers_.size()) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "checkpoint {} has {} buffers, but {} were added", uri,
+          saved.size(), buffers_.size());
+    }
+    for (size_t i = 0; i < buffers_.size(); ++i) {
+      const Buffer& buffer = buffers_[i];
+      auto name = saved[i].at("name").get<std::string>();
+      auto size = saved[i].at("size").get<uint64_t>();
+      if (name != buffer.name || size != buffer.size) {
+        return KATANA_ERROR(
+            ErrorCode::InvalidArgument,
+            "checkpoint {} has buffer {} of {} bytes, not {} of {} bytes", uri,
+            name, size, buffer.name, buffer.size);
+      }
+    }
+  } catch (const nlohmann::json::exception& exp) {
+    return KATANA_ERROR(
+        ErrorCode::JSONParseFailed, "malformed checkpoint {}: {}", uri,
+        exp.what());
+  }
+
+  // Wait for every read, even after a failure, since they fill the buffers
+  std::vector<std::future<CopyableResult<void>>> reads;
+  for (const Buffer& buffer : buffers_) {
+    if (buffer.size == 0) {
+      continue;
+    }
+    reads.emplace_back(tsuba::FileGetAsync(
+        katana::Uri::JoinPath(directory_, FileName(sequence, buffer.name)),
+        buffer.data, 0, buffer.size));
+  }
+  Result<void> result = ResultSuccess();
+  for (auto& read : reads) {
+    if (auto res = read.get(); !res && result) {
+      result = ErrorInfo(res.error());
+    }
+  }
+  KATANA_CHECKED_CONTEXT(result, "restoring checkpoint {}", uri);
+
+  sequence_ = sequence;
+  next_sequence_ = sequence + 1;
+  has_committed_ = true;
+  return true;
+}
+
+katana::Result<void>
+katana::analytics::Checkpointer::Save(uint64_t round) {
+  if (round % interval_ != 0) {
+    return ResultSuccess();
+  }
+  if (in_flight_.valid() &&
+      in_flight_.wait_for(std::chrono::seconds(0)) !=
+          std::future_status::ready) {
+    ++num_skipped_;
+    return ResultSuccess();
+  }
+  KATANA_CHECKED(Wait());
+
+  uint64_t sequence = next_sequence_++;
+  std::vector<std::shared_ptr<tsuba::FileFrame>> frames;
+  nlohmann::json saved = nlohmann::json::array();
+  for (const Buffer& buffer : buffers_) {
+    auto ff = std::make_shared<tsuba::FileFrame>();
+    KATANA_CHECKED(ff->Init(buffer.size));
+    ff->Bind(katana::Uri::JoinPath(
+        directory_, FileName(sequence, buffer.name)));
+    if (buffer.size > 0) {
+      if (arrow::Status st = ff->Write(buffer.data, buffer.size); !st.ok()) {
+        return KATANA_ERROR(
+            tsuba::ArrowToTsuba(st.code()), "copying {}: {}", buffer.name, st);
+      }
+    }
+    frames.emplace_back(std::move(ff));
+    saved.push_back({{"name", buffer.name}, {"size", buffer.size}});
+  }
+  nlohmann::json manifest = {
+      {"key", key_},
+      {"round", round},
+      {"sequence", sequence},
+      {"buffers", saved},
+  };
+  std::string contents = KATANA_CHECKED(katana::JsonDump(manifest));
+
+  std::unordered_set<std::string> replaced;
+  if (has_committed_) {
+    for (const Buffer& buffer : buffers_) {
+      replaced.emplace(FileName(sequence_, buffer.name));
+    }
+  }
+
+  pending_sequence_ = sequence;
+  in_flight_ = std::async(
+      std::launch::async,
+      [directory = directory_, frames = std::move(frames),
+       uri = ManifestUri(), contents = std::move(contents),
+       replaced = std::move(replaced)]() -> CopyableResult<void> {
+        KATANA_CHECKED(
+            StoreCheckpoint(directory, frames, uri, contents, replaced));
+        return CopyableResultSuccess();
+      });
+  ++num_saved_;
+  return ResultSuccess();
+}
+
+katana::Result<void>
+katana::analytics::Checkpointer::Wait() {
+  if (!in_flight_.valid()) {
+    return ResultSuccess();
+  }
+  KATANA_CHECKED(in_flight_.get());
+  sequence_ = pending_sequence_;
+  has_committed_ = true;
+  return ResultSuccess();
+}
+
+katana::Result<void>
+katana::analytics::Checkpointer::Complete() {
+  KATANA_CHECKED(Wait());
+  if (!has_committed_) {
+    return ResultSuccess();
+  }
+  std::unordered_set<std::string> files{key_ + ".checkpoint"};
+  for (const Buffer& buffer : buffers_) {
+    files.emplace(FileName(sequence_, buffer.name));
+  }
+  has_committed_ = false;
+  return tsuba::FileDelete(directory_, files);
+}
@@ -36,32 +36,7 @@ katana::analytics::SourcePicker::PickNext() {
 bool
 katana::analytics::IsApproximateDegreeDistributionPowerLaw(
     const PropertyGraph& graph) {
-  if (graph.num_nodes() < 10) {
-    return false;
-  }
-  uint32_t averageDegree = graph.num_edges() / graph.num_nodes();
-  if (averageDegree < 10) {
-    return false;
-  }
-  katana::StatTimer autoAlgoTimer("IsApproximateDegreeDistributionPowerLaw");
-  autoAlgoTimer.start();
-  SourcePicker sp(graph);
-  uint32_t num_samples = 1000;
-  if (num_samples > graph.num_nodes()) {
-    num_samples = graph.num_nodes();
-  }
-  uint32_t sample_total = 0;
-  std::vector<uint32_t> samples(num_samples);
-  for (uint32_t trial = 0; trial < num_samples; trial++) {
-    auto node = sp.PickNext();
-    samples[trial] = graph.edges(node).size();
-    sample_total += samples[trial];
-  }
-  std::sort(samples.begin(), samples.end());
-  double sample_average = static_cast<double>(sample_total) / num_samples;
-  double sample_median = samples[num_samples / 2];
-  autoAlgoTimer.stop();
-  return sample_average / 1.3 > sample_median;
+  return graph.GetGraphProfile()->power_law;
 }
 
 thread_local int
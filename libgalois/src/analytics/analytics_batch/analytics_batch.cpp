@@ -0,0 +1,280 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2020, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "katana/analytics/analytics_batch/analytics_batch.h"
+
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/NeighborPrefetch.h"
+#include "katana/Reduction.h"
+#include "katana/Statistics.h"
+#include "katana/Timer.h"
+#include "katana/analytics/Utils.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+
+/// The state of every analytic for one node, kept together so that the
+/// shared passes read a neighbor with one cache line
+struct NodeState {
+  float rank;
+  /// Number of edges entering the node: the out-degree of the transposed
+  /// graph, which divides the rank
+  std::atomic<uint32_t> in_degree;
+  std::atomic<uint64_t> component;
+};
+
+struct Gathered {
+  float rank_sum;
+  uint64_t component;
+};
+
+constexpr uint64_t kNoComponent = std::numeric_limits<uint64_t>::max();
+
+/// One pass that counts the in-degrees and runs the first step of label
+/// propagation, which only needs the node IDs
+void
+DegreePass(
+    const katana::GraphTopology& topo, bool components,
+    katana::NUMAArray<NodeState>* state) {
+  katana::do_all(
+      katana::iterate(topo.all_nodes()),
+      [&](Node n) {
+        uint64_t component = n;
+        for (auto e : topo.edges(n)) {
+          Node dest = topo.edge_dest(e);
+          (*state)[dest].in_degree.fetch_add(1, std::memory_order_relaxed);
+          component = std::min<uint64_t>(component, dest);
+        }
+        if (components) {
+          (*state)[n].component.store(component, std::memory_order_relaxed);
+        }
+      },
+      katana::steal(), katana::chunk_size<PagerankPlan::kChunkSize>(),
+      katana::loopname("AnalyticsBatchDegrees"));
+}
+
+/// One pass running an iteration of each active analytic on every node
+template <bool kPagerank, bool kComponents>
+void
+SharedPass(
+    const katana::GraphTopology& topo, const PagerankPlan& plan,
+    katana::PrefetchDistance* prefetch_distance,
+    katana::NUMAArray<NodeState>* state, katana::GAccumulator<float>* diff,
+    katana::GReduceLogicalOr* changed) {
+  float base_score = (1.0f - plan.alpha()) / topo.num_nodes();
+
+  katana::GatherNeighborsPrefetched(
+      topo, *state, prefetch_distance, Gathered{0.0f, kNoComponent},
+      [&](Gathered acc, auto, Node dest) {
+        const NodeState& d = (*state)[dest];
+        if constexpr (kPagerank) {
+          acc.rank_sum +=
+              d.rank / d.in_degree.load(std::memory_order_relaxed);
+        }
+        if constexpr (kComponents) {
+          acc.component = std::min(
+              acc.component, d.component.load(std::memory_order_relaxed));
+        }
+        return acc;
+      },
+      [&](Node n, const Gathered& acc) {
+        NodeState& s = (*state)[n];
+        if constexpr (kPagerank) {
+          // as in PullTopological, ranks are updated in place
+          float value = acc.rank_sum * plan.alpha() + base_score;
+          *diff += std::fabs(value - s.rank);
+          s.rank = value;
+        }
+        if constexpr (kComponents) {
+          if (acc.component < s.component.load(std::memory_order_relaxed)) {
+            s.component.store(acc.component, std::memory_order_relaxed);
+            changed->update(true);
+          }
+        }
+      },
+      katana::loopname("AnalyticsBatchSharedPass"));
+}
+
+template <typename T, typename ArrayType, typename ValueFn>
+katana::Result<std::shared_ptr<arrow::Array>>
+MakeColumn(uint64_t num_nodes, const ValueFn& value) {
+  std::shared_ptr<arrow::Buffer> buffer =
+      KATANA_CHECKED(arrow::AllocateBuffer(num_nodes * sizeof(T)));
+  auto* values = reinterpret_cast<T*>(buffer->mutable_data());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { values[n] = value(n); }, katana::no_stats());
+  return std::make_shared<ArrayType>(num_nodes, buffer);
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::AnalyticsBatch::Run(PropertyGraph* pg) const {
+  KATANA_CHECKED(CheckArchitecture(pagerank_plan_.value_or(PagerankPlan())));
+
+  std::vector<std::string> names;
+  for (const std::string* name :
+       {&out_degree_property_name_, &in_degree_property_name_,
+        &pagerank_property_name_, &connected_components_property_name_}) {
+    if (name->empty()) {
+      continue;
+    }
+    if (pg->HasNodeProperty(*name)) {
+      return KATANA_ERROR(
+          katana::ErrorCode::AlreadyExists, "property {} already exists",
+          *name);
+    }
+    names.emplace_back(*name);
+  }
+  if (std::unordered_set<std::string>(names.begin(), names.end()).size() !=
+      names.size()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "the properties of a batch must have distinct names");
+  }
+  if (names.empty()) {
+    return katana::ResultSuccess();
+  }
+
+  bool pagerank = !pagerank_property_name_.empty();
+  bool components = !connected_components_property_name_.empty();
+  PagerankPlan plan = pagerank_plan_.value_or(PagerankPlan::PullTopological());
+  if (pagerank && plan.algorithm() != PagerankPlan::kPullTopological) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "a batch computes Page Rank with the pull topological algorithm");
+  }
+
+  const katana::GraphTopology& topo = pg->topology();
+  const uint64_t num_nodes = topo.num_nodes();
+
+  katana::NUMAArray<NodeState> state;
+  state.allocateInterleaved(num_nodes);
+  float init_rank = 1.0f / num_nodes;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        state[n].rank = init_rank;
+        state[n].in_degree.store(0, std::memory_order_relaxed);
+        state[n].component.store(n, std::memory_order_relaxed);
+      },
+      katana::no_stats(), katana::loopname("AnalyticsBatchInit"));
+
+  katana::StatTimer exec_time("AnalyticsBatch");
+  exec_time.start();
+
+  uint64_t num_passes = 0;
+  if (!in_degree_property_name_.empty() || pagerank || components) {
+    DegreePass(topo, components, &state);
+    num_passes++;
+  }
+
+  unsigned int pagerank_iterations = 0;
+  bool pagerank_active = pagerank && plan.max_iterations() > 0;
+  // the degree pass has done the first step of label propagation, which
+  // changed the labels unless every node is its own component
+  bool components_active = components;
+
+  katana::GAccumulator<float> diff;
+  katana::GReduceLogicalOr changed;
+  // Tuned by the first pass over this graph and reused by the others
+  katana::PrefetchDistance prefetch_distance;
+  while (pagerank_active || components_active) {
+    diff.reset();
+    changed.reset();
+    if (pagerank_active && components_active) {
+      SharedPass<true, true>(
+          topo, plan, &prefetch_distance, &state, &diff, &changed);
+    } else if (pagerank_active) {
+      SharedPass<true, false>(
+          topo, plan, &prefetch_distance, &state, &diff, &changed);
+    } else {
+      SharedPass<false, true>(
+          topo, plan, &prefetch_distance, &state, &diff, &changed);
+    }
+    num_passes++;
+
+    if (pagerank_active) {
+      pagerank_iterations++;
+      pagerank_active = diff.reduce() > plan.tolerance() &&
+                        pagerank_iterations < plan.max_iterations();
+    }
+    if (components_active) {
+      components_active = changed.reduce();
+    }
+  }
+
+  exec_time.stop();
+  katana::ReportStatSingle("AnalyticsBatch", "EdgePasses", num_passes);
+  if (pagerank) {
+    katana::ReportStatSingle(
+        "AnalyticsBatch", "PagerankIterations", pagerank_iterations);
+  }
+
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::Array>> columns;
+  if (!out_degree_property_name_.empty()) {
+    fields.emplace_back(
+        arrow::field(out_degree_property_name_, arrow::uint32()));
+    columns.emplace_back(KATANA_CHECKED((
+        MakeColumn<uint32_t, arrow::UInt32Array>(num_nodes, [&](uint64_t n) {
+          return topo.edges(n).size();
+        }))));
+  }
+  if (!in_degree_property_name_.empty()) {
+    fields.emplace_back(
+        arrow::field(in_degree_property_name_, arrow::uint32()));
+    columns.emplace_back(KATANA_CHECKED((
+        MakeColumn<uint32_t, arrow::UInt32Array>(num_nodes, [&](uint64_t n) {
+          return state[n].in_degree.load(std::memory_order_relaxed);
+        }))));
+  }
+  if (pagerank) {
+    fields.emplace_back(
+        arrow::field(pagerank_property_name_, arrow::float32()));
+    columns.emplace_back(KATANA_CHECKED(
+        (MakeColumn<float, arrow::FloatArray>(
+            num_nodes, [&](uint64_t n) { return state[n].rank; }))));
+  }
+  if (components) {
+    fields.emplace_back(
+        arrow::field(connected_components_property_name_, arrow::uint64()));
+    columns.emplace_back(KATANA_CHECKED((
+        MakeColumn<uint64_t, arrow::UInt64Array>(num_nodes, [&](uint64_t n) {
+          return state[n].component.load(std::memory_order_relaxed);
+        }))));
+  }
+
+  return pg->AddNodeProperties(
+      arrow::Table::Make(arrow::schema(fields), columns));
+}
@@ -0,0 +1,282 @@
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#include "betweenness_centrality_impl.h"
+#include "katana/AtomicHelpers.h"
+#include "katana/Bag.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/gstl.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using Frontier = katana::InsertBag<Node, 4096>;
+
+constexpr uint32_t kUnvisited = std::numeric_limits<uint32_t>::max();
+constexpr unsigned kBatchChunkSize = 64U;
+
+/// The state of a node for one source of a batch: its distance, its number
+/// of shortest paths, its dependency and, at most, one frontier entry
+constexpr size_t kBytesPerNodePerSource =
+    sizeof(uint32_t) + sizeof(float) + sizeof(float) + sizeof(Node);
+
+/**
+ * Brandes' algorithm for a batch of sources at once, level by level.
+ *
+ * The state of every source is kept for every node, node-major, so a node's
+ * lanes, one per source, are contiguous and one scan of its edges serves all
+ * sources. A node is in the frontier of a level if it is at that distance
+ * from any source of the batch. The backward phase pulls dependencies along
+ * out-edges, checking distances, so neither successor lists nor marked edges
+ * are kept.
+ */
+class BrandesBatch {
+public:
+  BrandesBatch(const katana::GraphTopology& topology, size_t width)
+      : topology_(topology), width_(width) {
+    size_t size = topology_.num_nodes() * width_;
+    distance_.allocateBlocked(size);
+    sigma_.allocateBlocked(size);
+    delta_.allocateBlocked(size);
+    frontier_level_.allocateBlocked(topology_.num_nodes());
+  }
+
+  /// Add the dependencies of every node on sources, at most width of them,
+  /// to centrality and, if not null, to sums and squares
+  void Run(
+      const uint32_t* sources, size_t num_sources,
+      katana::NUMAArray<float>* centrality,
+      katana::NUMAArray<double>* sums = nullptr,
+      katana::NUMAArray<double>* squares = nullptr) {
+    KATANA_LOG_DEBUG_ASSERT(num_sources <= width_);
+    num_sources_ = num_sources;
+    Reset();
+
+    katana::gstl::Vector<Frontier> frontiers;
+    frontiers.emplace_back();
+    for (size_t s = 0; s < num_sources_; ++s) {
+      Node source = sources[s];
+      distance_[source * width_ + s] = 0;
+      sigma_[source * width_ + s] = 1;
+      // The same node may be drawn more than once
+      if (frontier_level_[source].exchange(0) != 0) {
+        frontiers[0].push(source);
+      }
+    }
+
+    for (uint32_t level = 0; !frontiers[level].empty(); ++level) {
+      frontiers.emplace_back();
+      Forward(level, &frontiers[level], &frontiers[level + 1]);
+    }
+
+    // The last frontier is empty and the first holds the sources, whose
+    // dependencies on themselves are not counted
+    for (uint32_t level = frontiers.size() - 2; level > 0; --level) {
+      Backward(level, &frontiers[level], centrality, sums, squares);
+    }
+  }
+
+private:
+  void Reset() {
+    katana::ParallelSTL::fill(distance_.begin(), distance_.end(), kUnvisited);
+    katana::ParallelSTL::fill(sigma_.begin(), sigma_.end(), 0.0F);
+    katana::ParallelSTL::fill(delta_.begin(), delta_.end(), 0.0F);
+    katana::ParallelSTL::fill(
+        frontier_level_.begin(), frontier_level_.end(), kUnvisited);
+  }
+
+  /// Count the shortest paths through the nodes at level and find the nodes
+  /// at the next level
+  void Forward(uint32_t level, Frontier* current, Frontier* next) {
+    katana::do_all(
+        katana::iterate(*current),
+        [&](Node n) {
+          const size_t n_lanes = n * width_;
+          for (auto e : topology_.edges(n)) {
+            Node dest = topology_.edge_dest(e);
+            const size_t dest_lanes = dest * width_;
+            bool found = false;
+            for (size_t s = 0; s < num_sources_; ++s) {
+              if (distance_[n_lanes + s].load(std::memory_order_relaxed) !=
+                  level) {
+                continue;
+              }
+              std::atomic<uint32_t>& dest_distance = distance_[dest_lanes + s];
+              uint32_t distance = dest_distance.load(std::memory_order_relaxed);
+              if (distance == kUnvisited) {
+                if (dest_distance.compare_exchange_strong(
+                        distance, level + 1)) {
+                  distance = level + 1;
+                  found = true;
+                }
+              }
+              if (distance == level + 1) {
+                katana::atomicAdd(
+                    sigma_[dest_lanes + s],
+                    sigma_[n_lanes + s].load(std::memory_order_relaxed));
+              }
+            }
+            if (found &&
+                frontier_level_[dest].exchange(level + 1) != level + 1) {
+              next->push(dest);
+            }
+          }
+        },
+        katana::steal(), katana::chunk_size<kBatchChunkSize>(),
+        katana::no_stats(), katana::loopname("BatchedBCForward"));
+  }
+
+  /// Compute the dependencies of the nodes at level from those of the next
+  void Backward(
+      uint32_t level, Frontier* current, katana::NUMAArray<float>* centrality,
+      katana::NUMAArray<double>* sums, katana::NUMAArray<double>* squares) {
+    katana::do_all(
+        katana::iterate(*current),
+        [&](Node n) {
+          const size_t n_lanes = n * width_;
+          for (auto e : topology_.edges(n)) {
+            const size_t dest_lanes = topology_.edge_dest(e) * width_;
+            for (size_t s = 0; s < num_sources_; ++s) {
+              if (distance_[n_lanes + s].load(std::memory_order_relaxed) ==
+                      level &&
+                  distance_[dest_lanes + s].load(std::memory_order_relaxed) ==
+                      level + 1) {
+                delta_[n_lanes + s] +=
+                    (1.0F + delta_[dest_lanes + s]) /
+                    sigma_[dest_lanes + s].load(std::memory_order_relaxed);
+              }
+            }
+          }
+
+          float total = 0;
+          for (size_t s = 0; s < num_sources_; ++s) {
+            if (distance_[n_lanes + s].load(std::memory_order_relaxed) !=
+                level) {
+              continue;
+            }
+            float& delta = delta_[n_lanes + s];
+            delta *= sigma_[n_lanes + s].load(std::memory_order_relaxed);
+            total += delta;
+            if (sums) {
+              (*sums)[n] += delta;
+              (*squares)[n] += double{delta} * delta;
+            }
+          }
+          // A node is in one frontier per level, so no other thread adds to
+          // its centrality now
+          (*centrality)[n] += total;
+        },
+        katana::steal(), katana::chunk_size<kBatchChunkSize>(),
+        katana::no_stats(), katana::loopname("BatchedBCBackward"));
+  }
+
+  const katana::GraphTopology& topology_;
+  size_t width_;
+  size_t num_sources_{0};
+  katana::NUMAArray<std::atomic<uint32_t>> distance_;
+  katana::NUMAArray<std::atomic<float>> sigma_;
+  katana::NUMAArray<float> delta_;
+  // The last level whose frontier a node was added to
+  katana::NUMAArray<std::atomic<uint32_t>> frontier_level_;
+};
+
+template <typename T>
+void
+FillZero(katana::NUMAArray<T>* array, size_t size) {
+  array->allocateBlocked(size);
+  katana::ParallelSTL::fill(array->begin(), array->end(), T{0});
+}
+
+}  // namespace
+
+katana::Result<void>
+BetweennessCentralityBatched(
+    katana::PropertyGraph* pg, BetweennessCentralitySources sources,
+    const std::string& output_property_name, BetweennessCentralityPlan plan) {
+  const katana::GraphTopology& topology = pg->topology();
+  size_t num_nodes = topology.num_nodes();
+
+  katana::NUMAArray<float> centrality;
+  FillZero(&centrality, num_nodes);
+
+  // The sources in batches, unless sampled
+  std::vector<uint32_t> source_vector;
+  bool adaptive =
+      std::holds_alternative<BetweennessCentralityAdaptiveSources>(sources);
+  if (std::holds_alternative<std::vector<uint32_t>>(sources)) {
+    source_vector = std::get<std::vector<uint32_t>>(sources);
+  } else if (!adaptive) {
+    uint64_t num_sources = sources == kBetweennessCentralityAllNodes
+                               ? num_nodes
+                               : std::min<uint64_t>(
+                                     std::get<uint32_t>(sources), num_nodes);
+    source_vector.resize(num_sources);
+    std::iota(source_vector.begin(), source_vector.end(), 0);
+  }
+  for (uint32_t source : source_vector) {
+    if (source >= num_nodes) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "source {} is not a node",
+          source);
+    }
+  }
+
+  size_t width = std::max<size_t>(
+      1, plan.max_batch_bytes() /
+             std::max<size_t>(1, num_nodes * kBytesPerNodePerSource));
+  if (!adaptive) {
+    width = std::min(width, std::max<size_t>(1, source_vector.size()));
+  }
+  katana::ReportStatSingle("BetweennessCentrality", "BatchWidth", width);
+
+  katana::StatTimer exec_time("Batched", "BetweennessCentrality");
+  exec_time.start();
+  BrandesBatch batch(topology, width);
+  auto run = [&](const std::vector<uint32_t>& batch_sources,
+                 katana::NUMAArray<double>* sums,
+                 katana::NUMAArray<double>* squares) {
+    for (size_t begin = 0; begin < batch_sources.size(); begin += width) {
+      size_t size = std::min(width, batch_sources.size() - begin);
+      batch.Run(
+          batch_sources.data() + begin, size, &centrality, sums, squares);
+    }
+  };
+
+  double scale = 1;
+  if (adaptive) {
+    BetweennessCentralityAdaptiveSampler sampler(
+        num_nodes, std::get<BetweennessCentralityAdaptiveSources>(sources));
+    katana::NUMAArray<double> sums;
+    katana::NUMAArray<double> squares;
+    FillZero(&sums, num_nodes);
+    FillZero(&squares, num_nodes);
+    while (!sampler.done()) {
+      run(sampler.NextBatch(), &sums, &squares);
+      sampler.Update(
+          [&](uint64_t n) { return std::make_pair(sums[n], squares[n]); });
+    }
+    katana::ReportStatSingle(
+        "BetweennessCentrality", "Sources", sampler.num_samples());
+    scale = sampler.scale();
+  } else {
+    run(source_vector, nullptr, nullptr);
+  }
+  exec_time.stop();
+
+  arrow::FloatBuilder builder;
+  KATANA_CHECKED(builder.Resize(num_nodes));
+  for (size_t n = 0; n < num_nodes; ++n) {
+    builder.UnsafeAppend(centrality[n] * scale);
+  }
+  std::shared_ptr<arrow::Array> values = KATANA_CHECKED(builder.Finish());
+  KATANA_CHECKED(pg->AddNodeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field(output_property_name, arrow::float32())}),
+      {values})));
+  return katana::ResultSuccess();
+}
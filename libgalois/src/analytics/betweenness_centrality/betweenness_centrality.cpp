@@ -30,6 +30,17 @@ katana::analytics::BetweennessCentrality(
     katana::PropertyGraph* pg, const std::string& output_property_name,
     const BetweennessCentralitySources& sources,
     BetweennessCentralityPlan plan) {
+  if (const auto* adaptive =
+          std::get_if<BetweennessCentralityAdaptiveSources>(&sources)) {
+    if (!(adaptive->epsilon > 0 && adaptive->epsilon < 1) ||
+        !(adaptive->delta > 0 && adaptive->delta < 1)) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "epsilon and delta must be in (0, 1), got {} and {}",
+          adaptive->epsilon, adaptive->delta);
+    }
+  }
+
   switch (plan.algorithm()) {
     //TODO (gill) Needs bidirectional graph (CSR_CSC)
     //   case Asynchronous:
@@ -41,6 +52,14 @@ katana::analytics::BetweennessCentrality(
     return BetweennessCentralityLevel(pg, sources, output_property_name, plan);
   case BetweennessCentralityPlan::kOuter:
     return BetweennessCentralityOuter(pg, sources, output_property_name, plan);
+  case BetweennessCentralityPlan::kBatched:
+    if (plan.max_batch_bytes() == 0) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "the memory for batches of sources must be positive");
+    }
+    return BetweennessCentralityBatched(
+        pg, sources, output_property_name, plan);
   default:
     return katana::ErrorCode::InvalidArgument;
   }
@@ -1,9 +1,113 @@
 #ifndef KATANA_LIBGALOIS_ANALYTICS_BETWEENNESSCENTRALITY_BETWEENNESSCENTRALITYIMPL_H_
 #define KATANA_LIBGALOIS_ANALYTICS_BETWEENNESSCENTRALITY_BETWEENNESSCENTRALITYIMPL_H_
 
+#include <cmath>
+#include <random>
+#include <utility>
+#include <vector>
+
 #include "katana/analytics/Utils.h"
 #include "katana/analytics/betweenness_centrality/betweenness_centrality.h"
 
+/// Draws the sources of BetweennessCentralityAdaptiveSources in batches and
+/// decides after each batch whether to stop. Batches double in size, from
+/// the first number of sources at which the empirical Bernstein bound can be
+/// within epsilon, up to the number at which Hoeffding's bound is.
+class BetweennessCentralityAdaptiveSampler {
+public:
+  BetweennessCentralityAdaptiveSampler(
+      uint64_t num_nodes,
+      const katana::analytics::BetweennessCentralityAdaptiveSources& params)
+      : num_nodes_(num_nodes),
+        epsilon_(params.epsilon),
+        generator_(params.seed) {
+    if (num_nodes_ == 0) {
+      done_ = true;
+      return;
+    }
+    // Half of delta goes to Hoeffding's bound over all nodes, half to the
+    // Bernstein bounds over all nodes and checks
+    max_samples_ = std::ceil(
+        std::log(4.0 * num_nodes_ / params.delta) /
+        (2.0 * epsilon_ * epsilon_));
+    uint64_t max_checks = std::ceil(std::log2(max_samples_ + 1.0)) + 2;
+    // Two sided, so each side of each bound gets a quarter of delta over the
+    // number of nodes and checks
+    log_term_ = std::log(8.0 * max_checks * num_nodes_ / params.delta);
+    // Fewer samples cannot get the second term of the bound within epsilon
+    uint64_t min_samples = std::ceil(7.0 * log_term_ / (3.0 * epsilon_)) + 1;
+    next_check_ = std::min(max_samples_, std::max<uint64_t>(2, min_samples));
+  }
+
+  bool done() const { return done_; }
+
+  uint64_t num_samples() const { return num_samples_; }
+
+  /// The factor from the sums of dependencies over the sampled sources to
+  /// estimates of the centralities
+  double scale() const {
+    return num_samples_ ? static_cast<double>(num_nodes_) / num_samples_ : 0;
+  }
+
+  /// The sources of the next batch
+  const std::vector<uint32_t>& NextBatch() {
+    std::uniform_int_distribution<uint32_t> dist(0, num_nodes_ - 1);
+    batch_.clear();
+    for (; num_samples_ < next_check_; ++num_samples_) {
+      batch_.emplace_back(dist(generator_));
+    }
+    return batch_;
+  }
+
+  /// Decide whether to stop after the last batch. sums(n) returns the sum
+  /// over the sampled sources so far of the dependencies of n and the sum of
+  /// their squares
+  template <typename SumsFn>
+  void Update(const SumsFn& sums) {
+    if (num_samples_ >= max_samples_) {
+      done_ = true;
+      return;
+    }
+
+    // Dependencies are at most n - 2, so this maps them to [0, 1)
+    double norm = num_nodes_ > 1 ? 1.0 / (num_nodes_ - 1) : 1.0;
+    double m = num_samples_;
+    katana::GReduceMax<double> max_variance;
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes_),
+        [&](uint64_t n) {
+          std::pair<double, double> s = sums(n);
+          double mean = s.first * norm / m;
+          double variance =
+              (s.second * norm * norm - m * mean * mean) / (m - 1);
+          max_variance.update(variance);
+        },
+        katana::no_stats(), katana::loopname("BCSampleVariance"));
+
+    // Empirical Bernstein bound of Maurer and Pontil
+    double radius = std::sqrt(
+                        2.0 * std::max(max_variance.reduce(), 0.0) *
+                        log_term_ / m) +
+                    7.0 * log_term_ / (3.0 * (m - 1));
+    if (radius <= epsilon_) {
+      done_ = true;
+      return;
+    }
+    next_check_ = std::min(max_samples_, 2 * num_samples_);
+  }
+
+private:
+  uint64_t num_nodes_;
+  double epsilon_;
+  std::mt19937_64 generator_;
+  uint64_t max_samples_{0};
+  double log_term_{0};
+  uint64_t next_check_{0};
+  uint64_t num_samples_{0};
+  bool done_{false};
+  std::vector<uint32_t> batch_;
+};
+
 katana::Result<void> BetweennessCentralityOuter(
     katana::PropertyGraph* pg,
     katana::analytics::BetweennessCentralitySources sources,
@@ -16,4 +120,10 @@ katana::Result<void> BetweennessCentralityLevel(
     const std::string& output_property_name,
     katana::analytics::BetweennessCentralityPlan plan);
 
+katana::Result<void> BetweennessCentralityBatched(
+    katana::PropertyGraph* pg,
+    katana::analytics::BetweennessCentralitySources sources,
+    const std::string& output_property_name,
+    katana::analytics::BetweennessCentralityPlan plan);
+
 #endif
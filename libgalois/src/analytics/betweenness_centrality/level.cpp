@@ -22,6 +22,12 @@ struct BCLevelNodeDataTy {
   float dependency;
   float bc;
 };
+/// Sums over the sources of adaptive sampling of the dependencies of a node
+/// and of their squares
+struct LevelDependencySums {
+  double sum;
+  double squares;
+};
 struct NodeBC : public katana::PODProperty<float> {};
 using NodeDataLevel = std::tuple<>;
 using EdgeDataLevel = std::tuple<>;
@@ -160,13 +166,15 @@ LevelSSSP(
  * dependency values.
  *
  * @param graph LevelGraph to do backward Brandes dependency prop on
+ * @param dependency_sums if not null, dependencies are also added to it
  */
 void
 LevelBackwardBrandes(
     LevelGraph* graph,
     katana::gstl::Vector<LevelWorklistType>* vector_of_worklists,
     katana::NUMAArray<BCLevelNodeDataTy>* graph_data,
-    katana::DynamicBitset* active_edges) {
+    katana::DynamicBitset* active_edges,
+    katana::NUMAArray<LevelDependencySums>* dependency_sums) {
   // minus 3 because last one is empty, one after is leaf nodes, and one
   // to correct indexing to 0 index
   if (vector_of_worklists->size() >= 3) {
@@ -202,6 +210,11 @@ LevelBackwardBrandes(
             src_data.dependency *= src_data.num_shortest_paths;
             // accumulate dependency into bc
             src_data.bc += src_data.dependency;
+            if (dependency_sums) {
+              auto& sums = (*dependency_sums)[n];
+              sums.sum += src_data.dependency;
+              sums.squares += double{src_data.dependency} * src_data.dependency;
+            }
           },
           katana::steal(), katana::chunk_size<kLevelChunkSize>(),
           katana::no_stats(), katana::loopname("Brandes"));
@@ -212,12 +225,12 @@ LevelBackwardBrandes(
   }
 }
 
-//! Gets the BC value from the AoS node data in the graph and adds it to the
-//! property graph for use by stats/output verification
+//! Gets the BC value from the AoS node data in the graph, times scale, and
+//! adds it to the property graph for use by stats/output verification
 katana::Result<void>
 ExtractBC(
     katana::PropertyGraph* pg, const LevelGraph& array_of_struct_graph,
-    const katana::NUMAArray<BCLevelNodeDataTy>& graph_data,
+    const katana::NUMAArray<BCLevelNodeDataTy>& graph_data, double scale,
     const std::string& output_property_name) {
   // construct the new property
   if (auto result =
@@ -238,7 +251,7 @@ ExtractBC(
   katana::do_all(
       katana::iterate(array_of_struct_graph),
       [&](LevelGNode node_id) {
-        float bc_value = graph_data[node_id].bc;
+        float bc_value = graph_data[node_id].bc * scale;
         new_graph.GetData<NodeBC>(node_id) = bc_value;
       },
       katana::loopname("ExtractBC"), katana::no_stats());
@@ -279,6 +292,51 @@ BetweennessCentralityLevel(
   prealloc_time.stop();
   katana::ReportPageAllocGuard page_alloc;
 
+  katana::NUMAArray<BCLevelNodeDataTy> graph_data;
+  katana::DynamicBitset active_edges;
+  // graph initialization, then main loop
+  LevelInitializeGraph(&graph, &graph_data, &active_edges);
+
+  katana::StatTimer exec_time("Level", "BetweennessCentrality");
+
+  auto process_source =
+      [&](LevelGNode src_node,
+          katana::NUMAArray<LevelDependencySums>* dependency_sums) {
+        exec_time.start();
+        LevelInitializeIteration(&graph, src_node, &graph_data, &active_edges);
+        // worklist; last one will be empty
+        katana::gstl::Vector<LevelWorklistType> worklists =
+            LevelSSSP(&graph, src_node, &graph_data, &active_edges);
+        LevelBackwardBrandes(
+            &graph, &worklists, &graph_data, &active_edges, dependency_sums);
+        exec_time.stop();
+      };
+
+  if (std::holds_alternative<BetweennessCentralityAdaptiveSources>(sources)) {
+    BetweennessCentralityAdaptiveSampler sampler(
+        graph.size(), std::get<BetweennessCentralityAdaptiveSources>(sources));
+    katana::NUMAArray<LevelDependencySums> dependency_sums;
+    dependency_sums.allocateBlocked(graph.size());
+    katana::do_all(
+        katana::iterate(graph),
+        [&](LevelGNode n) { dependency_sums[n] = LevelDependencySums{0, 0}; },
+        katana::no_stats());
+
+    while (!sampler.done()) {
+      for (LevelGNode src_node : sampler.NextBatch()) {
+        process_source(src_node, &dependency_sums);
+      }
+      sampler.Update([&](uint64_t n) {
+        const LevelDependencySums& sums = dependency_sums[n];
+        return std::make_pair(sums.sum, sums.squares);
+      });
+    }
+    katana::ReportStatSingle(
+        "BetweennessCentrality", "Sources", sampler.num_samples());
+    return ExtractBC(
+        pg, graph, graph_data, sampler.scale(), output_property_name);
+  }
+
   // If particular set of sources was specified, use them
   std::vector<uint32_t> source_vector;
   if (std::holds_alternative<std::vector<uint32_t>>(sources)) {
@@ -297,13 +355,6 @@ BetweennessCentralityLevel(
     loop_end = source_vector.size();
   }
 
-  katana::NUMAArray<BCLevelNodeDataTy> graph_data;
-  katana::DynamicBitset active_edges;
-  // graph initialization, then main loop
-  LevelInitializeGraph(&graph, &graph_data, &active_edges);
-
-  katana::StatTimer exec_time("Level", "BetweennessCentrality");
-
   // loop over all specified sources for SSSP/Brandes calculation
   for (uint64_t i = 0; i < loop_end; i++) {
     LevelGNode src_node;
@@ -318,15 +369,9 @@ BetweennessCentralityLevel(
     }
 
     // here begins main computation
-    exec_time.start();
-    LevelInitializeIteration(&graph, src_node, &graph_data, &active_edges);
-    // worklist; last one will be empty
-    katana::gstl::Vector<LevelWorklistType> worklists =
-        LevelSSSP(&graph, src_node, &graph_data, &active_edges);
-    LevelBackwardBrandes(&graph, &worklists, &graph_data, &active_edges);
-    exec_time.stop();
+    process_source(src_node, nullptr);
   }
 
   // Get the BC proporty into the property graph by extracting from AoS
-  return ExtractBC(pg, graph, graph_data, output_property_name);
+  return ExtractBC(pg, graph, graph_data, 1, output_property_name);
 }
@@ -27,12 +27,20 @@ class BCOuter {
   katana::PerThreadStorage<int*> per_thread_distance_;
   katana::PerThreadStorage<float*> per_thread_delta_;
   katana::PerThreadStorage<katana::gdeque<OuterGNode>*> per_thread_successor_;
+  // Sums of dependencies and of their squares, kept only for adaptive
+  // sampling
+  bool track_sums_;
+  katana::PerThreadStorage<double*> per_thread_sums_;
+  katana::PerThreadStorage<double*> per_thread_squares_;
 
 public:
   /**
    * Constructor initializes thread local storage.
+   *
+   * @param track_sums Also keep the sums needed by DependencySums
    */
-  BCOuter(const OuterGraph& g) : graph_(g), num_nodes_(g.num_nodes()) {
+  BCOuter(const OuterGraph& g, bool track_sums = false)
+      : graph_(g), num_nodes_(g.num_nodes()), track_sums_(track_sums) {
     InitializeLocal();
   }
 
@@ -98,6 +106,14 @@ public:
     // save result of this source's BC, reset all local values for next
     // source
     float* Vec = *centrality_measure_.getLocal();
+    if (track_sums_) {
+      double* sums = *per_thread_sums_.getLocal();
+      double* squares = *per_thread_squares_.getLocal();
+      for (int i = 0; i < num_nodes_; ++i) {
+        sums[i] += delta[i];
+        squares[i] += double{delta[i]} * delta[i];
+      }
+    }
     for (int i = 0; i < num_nodes_; ++i) {
       Vec[i] += delta[i];
       delta[i] = 0;
@@ -154,8 +170,21 @@ public:
     }
   }
 
+  /**
+   * The sums over the sources so far of the dependencies of node n and of
+   * their squares; only kept if track_sums was passed to the constructor.
+   */
+  std::pair<double, double> DependencySums(size_t n) const {
+    std::pair<double, double> total{0, 0};
+    for (unsigned j = 0; j < katana::getActiveThreads(); ++j) {
+      total.first += (*per_thread_sums_.getRemote(j))[n];
+      total.second += (*per_thread_squares_.getRemote(j))[n];
+    }
+    return total;
+  }
+
   katana::Result<std::shared_ptr<arrow::FloatArray>> ExtractBCValues(
-      size_t begin, size_t end) {
+      size_t begin, size_t end, double scale = 1) {
     arrow::FloatBuilder builder;
     if (auto r = builder.Resize(end - begin); !r.ok()) {
       return katana::ErrorCode::ArrowError;
@@ -167,7 +196,7 @@ public:
         bc += (*centrality_measure_.getRemote(j))[begin];
       }
 
-      if (auto r = builder.Append(bc); !r.ok()) {
+      if (auto r = builder.Append(bc * scale); !r.ok()) {
         return katana::ErrorCode::ArrowError;
       }
     }
@@ -209,6 +238,13 @@ private:
       this->InitArray(per_thread_distance_.getLocal());
       this->InitArray(per_thread_delta_.getLocal());
       this->InitArray(per_thread_successor_.getLocal());
+      if (track_sums_) {
+        this->InitArray(per_thread_sums_.getLocal());
+        this->InitArray(per_thread_squares_.getLocal());
+      } else {
+        *per_thread_sums_.getLocal() = nullptr;
+        *per_thread_squares_.getLocal() = nullptr;
+      }
     });
   }
 
@@ -222,6 +258,8 @@ private:
       this->DeleteArray(per_thread_distance_.getLocal());
       this->DeleteArray(per_thread_delta_.getLocal());
       this->DeleteArray(per_thread_successor_.getLocal());
+      this->DeleteArray(per_thread_sums_.getLocal());
+      this->DeleteArray(per_thread_squares_.getLocal());
     });
   }
 };
@@ -254,7 +292,9 @@ BetweennessCentralityOuter(
   }
   OuterGraph graph = pg_result.value();
 
-  BCOuter bc_outer(graph);
+  bool adaptive =
+      std::holds_alternative<BetweennessCentralityAdaptiveSources>(sources);
+  BCOuter bc_outer(graph, adaptive);
 
   // preallocate pages for use in algorithm
   katana::EnsurePreallocated(
@@ -288,14 +328,27 @@ BetweennessCentralityOuter(
   // execute algorithm
   katana::StatTimer exec_time("Betweenness Centrality Outer");
   exec_time.start();
-  if (sources == kBetweennessCentralityAllNodes) {
+  double scale = 1;
+  if (adaptive) {
+    BetweennessCentralityAdaptiveSampler sampler(
+        graph.num_nodes(),
+        std::get<BetweennessCentralityAdaptiveSources>(sources));
+    while (!sampler.done()) {
+      // A batch of sources is processed in parallel
+      bc_outer.Run(sampler.NextBatch());
+      sampler.Update([&](uint64_t n) { return bc_outer.DependencySums(n); });
+    }
+    katana::ReportStatSingle(
+        "BetweennessCentrality", "Sources", sampler.num_samples());
+    scale = sampler.scale();
+  } else if (sources == kBetweennessCentralityAllNodes) {
     bc_outer.Run(katana::iterate(*pg));
   } else {
     bc_outer.Run(source_vector);
   }
   exec_time.stop();
 
-  auto data_result = bc_outer.ExtractBCValues(0, graph.num_nodes());
+  auto data_result = bc_outer.ExtractBCValues(0, graph.num_nodes(), scale);
   if (!data_result) {
     return data_result.error();
   }
@@ -19,9 +19,19 @@
 
 #include "katana/analytics/bfs/bfs.h"
 
+#include <algorithm>
+#include <atomic>
 #include <deque>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <thread>
 #include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
+#include "katana/Bag.h"
 #include "katana/DynamicBitset.h"
 #include "katana/ErrorCode.h"
 #include "katana/Result.h"
@@ -48,6 +58,8 @@ struct BfsImplementation
 };
 
 using Graph = BfsImplementation::Graph;
+using DistanceGraph =
+    katana::TypedPropertyGraph<std::tuple<BfsNodeDistance>, std::tuple<>>;
 using GNode = Graph::Node;
 using Dist = BfsImplementation::Dist;
 using BiDirGraphView = katana::TypedPropertyGraphView<
@@ -117,6 +129,110 @@ struct OneTilePushWrap {
   }
 };
 
+/// A bidirectional view of a graph whose in-edges are built by a background
+/// thread while the first, top-down, levels of SynchronousDirectOpt run.
+///
+/// The thread pool only runs one parallel loop at a time, so the transpose is
+/// built serially with a counting sort next to the parallel top-down levels.
+/// Until in_edges_ready() is true only out-edges may be used. If the search
+/// finishes first, the build is abandoned.
+class LazyBiDirGraph : public katana::GraphTopologyTypes {
+public:
+  explicit LazyBiDirGraph(const katana::GraphTopology& topo)
+      : topo_(topo), builder_([this]() { BuildInEdges(); }) {}
+
+  LazyBiDirGraph(const LazyBiDirGraph&) = delete;
+  LazyBiDirGraph& operator=(const LazyBiDirGraph&) = delete;
+
+  ~LazyBiDirGraph() {
+    cancel_.store(true, std::memory_order_relaxed);
+    builder_.join();
+  }
+
+  bool in_edges_ready() const {
+    return ready_.load(std::memory_order_acquire);
+  }
+
+  uint64_t num_nodes() const { return topo_.num_nodes(); }
+  uint64_t num_edges() const { return topo_.num_edges(); }
+
+  iterator begin() const { return topo_.all_nodes().begin(); }
+  iterator end() const { return topo_.all_nodes().end(); }
+
+  edges_range edges(Node node) const { return topo_.edges(node); }
+  Node edge_dest(Edge edge_id) const { return topo_.edge_dest(edge_id); }
+  size_t degree(Node node) const { return topo_.edges(node).size(); }
+
+  edges_range in_edges(Node node) const {
+    KATANA_LOG_DEBUG_ASSERT(in_edges_ready());
+    return katana::MakeStandardRange<edge_iterator>(
+        in_indices_[node], in_indices_[node + 1]);
+  }
+  Node in_edge_dest(Edge edge_id) const { return in_srcs_[edge_id]; }
+
+private:
+  // Check for cancellation after about this many edges
+  static constexpr uint64_t kCancelInterval = UINT64_C(1) << 20;
+
+  void BuildInEdges() {
+    const uint64_t num_nodes = topo_.num_nodes();
+    const uint64_t num_edges = topo_.num_edges();
+    const Edge* adj = topo_.adj_data();
+    const Node* dests = topo_.dest_data();
+    auto cancelled = [&](uint64_t e) {
+      return e % kCancelInterval == 0 &&
+             cancel_.load(std::memory_order_relaxed);
+    };
+
+    in_indices_.assign(num_nodes + 1, 0);
+    for (Edge e = 0; e < num_edges; ++e) {
+      if (cancelled(e)) {
+        return;
+      }
+      ++in_indices_[dests[e] + 1];
+    }
+    std::partial_sum(
+        in_indices_.begin(), in_indices_.end(), in_indices_.begin());
+
+    // Scatter using in_indices_[n] as the cursor of n, which leaves it at the
+    // start of n + 1; shift the indices back afterwards
+    in_srcs_.resize(num_edges);
+    Edge e = 0;
+    for (Node src = 0; src < num_nodes; ++src) {
+      for (; e < adj[src]; ++e) {
+        if (cancelled(e)) {
+          return;
+        }
+        in_srcs_[in_indices_[dests[e]]++] = src;
+      }
+    }
+    for (uint64_t n = num_nodes; n > 0; --n) {
+      in_indices_[n] = in_indices_[n - 1];
+    }
+    in_indices_[0] = 0;
+
+    ready_.store(true, std::memory_order_release);
+  }
+
+  const katana::GraphTopology& topo_;
+  std::vector<Edge> in_indices_;
+  std::vector<Node> in_srcs_;
+  std::atomic<bool> cancel_{false};
+  std::atomic<bool> ready_{false};
+  // Declared last so that it starts after the other members are constructed
+  std::thread builder_;
+};
+
+bool
+InEdgesReady(const BiDirGraphView&) {
+  return true;
+}
+
+bool
+InEdgesReady(const LazyBiDirGraph& graph) {
+  return graph.in_edges_ready();
+}
+
 template <typename WL>
 void
 WlToBitset(const WL& wl, katana::DynamicBitset* bitset) {
@@ -125,15 +241,29 @@ WlToBitset(const WL& wl, katana::DynamicBitset* bitset) {
       katana::chunk_size<kChunkSize>(), katana::loopname("WlToBitset"));
 }
 
-template <typename G, typename WL>
+template <typename WL>
 void
-BitsetToWl(const G& graph, const katana::DynamicBitset& bitset, WL* wl) {
+BitsetToWl(const katana::DynamicBitset& bitset, WL* wl) {
   wl->clear();
+  // Visit a word of the bitset at a time so that empty stretches of the
+  // frontier are skipped 64 nodes at once
+  const auto& words = bitset.get_vec();
+  // Bits of the last word past the end of the bitset may be stale
+  const size_t used = bitset.size() % katana::DynamicBitset::kNumBitsInUint64;
+  const uint64_t last_word_mask =
+      used == 0 ? ~uint64_t{0} : (uint64_t{1} << used) - 1;
   katana::do_all(
-      katana::iterate(graph),
-      [&](const GNode& src) {
-        if (bitset.test(src)) {
-          wl->push(src);
+      katana::iterate(size_t{0}, words.size()),
+      [&](size_t i) {
+        uint64_t word = words[i].load(std::memory_order_relaxed);
+        if (i + 1 == words.size()) {
+          word &= last_word_mask;
+        }
+        while (word) {
+          wl->push(GNode(
+              i * katana::DynamicBitset::kNumBitsInUint64 +
+              __builtin_ctzll(word)));
+          word &= word - 1;
         }
       },
       katana::chunk_size<kChunkSize>(), katana::loopname("BitsetToWl"));
@@ -270,12 +400,13 @@ SynchronousAlgo(
   }
 }
 
-template <bool CONCURRENT, typename P>
+/// Stops early, between levels, if context is cancelled
+template <bool CONCURRENT, typename BiDirGraph, typename P>
 void
 SynchronousDirectOpt(
-    const BiDirGraphView& bidir_view, katana::NUMAArray<GNode>* node_data,
+    const BiDirGraph& bidir_view, katana::NUMAArray<GNode>* node_data,
     const GNode source, const P& pushWrap, const uint32_t alpha,
-    const uint32_t beta) {
+    const uint32_t beta, const katana::analytics::AnalyticsContext* context) {
   using Cont = typename std::conditional<
       CONCURRENT, katana::InsertBag<GNode>, katana::SerStack<GNode>>::type;
   using Loop = typename std::conditional<
@@ -316,10 +447,12 @@ SynchronousDirectOpt(
   katana::GAccumulator<uint64_t> writes_pull;
   katana::GAccumulator<uint64_t> writes_push;
 
-  while (!next_frontier->empty()) {
+  while (!next_frontier->empty() &&
+         !katana::analytics::IsCancelled(context)) {
     std::swap(frontier, next_frontier);
     next_frontier->clear();
-    if (scout_count > edges_to_check / alpha) {
+    // Bottom-up steps need in-edges
+    if (scout_count > edges_to_check / alpha && InEdgesReady(bidir_view)) {
       wl_to_bitset_timer.start();
       WlToBitset(*frontier, &front_bitset);
       wl_to_bitset_timer.stop();
@@ -352,7 +485,7 @@ SynchronousDirectOpt(
       } while (work_items.reduce() >= old_num_work_items ||
                (work_items.reduce() > num_nodes / beta));
       bitset_to_wl_timer.start();
-      BitsetToWl(bidir_view, front_bitset, next_frontier.get());
+      BitsetToWl(front_bitset, next_frontier.get());
       bitset_to_wl_timer.stop();
       scout_count = 1;
     } else {
@@ -427,46 +560,75 @@ ComputeParentFromDistance(
       katana::loopname(std::string("ComputeParentFromDistance").c_str()));
 }
 
+/// \p bidir_view is null for algorithms that build their own in-edges
 template <bool CONCURRENT>
 katana::Result<void>
 RunAlgo(
-    BfsPlan algo, Graph* graph, const BiDirGraphView& bidir_view,
-    const GNode& source) {
+    BfsPlan algo, const katana::GraphTopology& topology, Graph* graph,
+    const BiDirGraphView* bidir_view, const GNode& source,
+    katana::analytics::AnalyticsContext* context) {
   BfsImplementation impl{algo.edge_tile_size()};
   katana::StatTimer exec_time("BFS");
 
   switch (algo.algorithm()) {
   case BfsPlan::kSynchronousDirectOpt: {
     // Set up node data
-    katana::NUMAArray<GNode> node_data;
-    node_data.allocateInterleaved(graph->num_nodes());
-    InitNodeDataVec(BfsImplementation::kDistanceInfinity, &node_data);
+    katana::NUMAArray<GNode> local_node_data;
+    katana::NUMAArray<GNode>* node_data = katana::analytics::ScratchArray(
+        context, "BfsParent", graph->num_nodes(), &local_node_data);
+    InitNodeDataVec(BfsImplementation::kDistanceInfinity, node_data);
 
     exec_time.start();
     SynchronousDirectOpt<CONCURRENT>(
-        bidir_view, &node_data, source, NodePushWrap(), algo.alpha(),
-        algo.beta());
+        *bidir_view, node_data, source, NodePushWrap(), algo.alpha(),
+        algo.beta(), context);
+    exec_time.stop();
+    KATANA_CHECKED(katana::analytics::CheckCancelled(context));
+
+    UpdateGraphNodeData(graph, *node_data);
+    break;
+  }
+  case BfsPlan::kSynchronousDirectOptLazyTranspose: {
+    katana::NUMAArray<GNode> local_node_data;
+    katana::NUMAArray<GNode>* node_data = katana::analytics::ScratchArray(
+        context, "BfsParent", graph->num_nodes(), &local_node_data);
+    InitNodeDataVec(BfsImplementation::kDistanceInfinity, node_data);
+
+    exec_time.start();
+    {
+      LazyBiDirGraph lazy_view(topology);
+      SynchronousDirectOpt<CONCURRENT>(
+          lazy_view, node_data, source, NodePushWrap(), algo.alpha(),
+          algo.beta(), context);
+      katana::ReportStatSingle(
+          "BFS", "LazyTransposeReady", lazy_view.in_edges_ready());
+    }
     exec_time.stop();
+    KATANA_CHECKED(katana::analytics::CheckCancelled(context));
 
-    UpdateGraphNodeData(graph, node_data);
+    UpdateGraphNodeData(graph, *node_data);
     break;
   }
   case BfsPlan::kAsynchronous: {
-    katana::NUMAArray<GNode> node_parent;
-    katana::NUMAArray<Dist> node_dist;
-    node_parent.allocateInterleaved(graph->num_nodes());
-    node_dist.allocateInterleaved(graph->num_nodes());
+    katana::NUMAArray<GNode> local_node_parent;
+    katana::NUMAArray<Dist> local_node_dist;
+    katana::NUMAArray<GNode>* node_parent = katana::analytics::ScratchArray(
+        context, "BfsParent", graph->num_nodes(), &local_node_parent);
+    katana::NUMAArray<Dist>* node_dist = katana::analytics::ScratchArray(
+        context, "BfsDistance", graph->num_nodes(), &local_node_dist);
 
-    InitNodeDataVec(BfsImplementation::kDistanceInfinity, &node_parent);
-    InitNodeDataVec(BfsImplementation::kDistanceInfinity, &node_dist);
+    InitNodeDataVec(BfsImplementation::kDistanceInfinity, node_parent);
+    InitNodeDataVec(BfsImplementation::kDistanceInfinity, node_dist);
 
     exec_time.start();
     AsynchronousAlgo<CONCURRENT, UpdateRequest>(
-        *graph, source, &node_dist, ReqPushWrap(), OutEdgeRangeFn{graph});
-    ComputeParentFromDistance(bidir_view, &node_parent, node_dist, source);
+        *graph, source, node_dist, ReqPushWrap(), OutEdgeRangeFn{graph});
+    // The asynchronous search has no rounds to stop between
+    KATANA_CHECKED(katana::analytics::CheckCancelled(context));
+    ComputeParentFromDistance(*bidir_view, node_parent, *node_dist, source);
     exec_time.stop();
 
-    UpdateGraphNodeData(graph, node_parent);
+    UpdateGraphNodeData(graph, *node_parent);
     break;
   }
   default:
@@ -480,19 +642,13 @@ RunAlgo(
 
 katana::Result<void>
 BfsImpl(
-    Graph* graph, const BiDirGraphView& bidir_view, size_t start_node,
-    BfsPlan algo) {
+    const katana::GraphTopology& topology, Graph* graph,
+    const BiDirGraphView* bidir_view, size_t start_node, BfsPlan algo,
+    katana::analytics::AnalyticsContext* context) {
   if (start_node >= graph->num_nodes()) {
     return katana::ErrorCode::InvalidArgument;
   }
 
-  if (algo.algorithm() != BfsPlan::kSynchronousDirectOpt &&
-      algo.algorithm() != BfsPlan::kAsynchronous) {
-    return KATANA_ERROR(
-        katana::ErrorCode::NotImplemented, "Unsupported algorithm: {}",
-        algo.algorithm());
-  }
-
   auto it = graph->begin();
   std::advance(it, start_node);
   GNode source = *it;
@@ -501,28 +657,357 @@ BfsImpl(
   katana::EnsurePreallocated(8, approxNodeData);
   katana::ReportPageAllocGuard page_alloc;
 
-  if (auto res = RunAlgo<true>(algo, graph, bidir_view, source); !res) {
+  if (auto res =
+          RunAlgo<true>(algo, topology, graph, bidir_view, source, context);
+      !res) {
     return res.error();
   }
 
   return katana::ResultSuccess();
 }
 
+/// Run MS-BFS from sources, which has at most batch_words * 64 entries, and
+/// write the distance from sources[i] to n into dist[i * num_nodes + n].
+/// Rows of dist must be initialized to kDistanceInfinity.
+///
+/// Word w of a node's seen bits has bit b set if source w * 64 + b reached
+/// the node; frontier and next are the same for the current and the next
+/// level. Each level pushes the frontier bits of every node along its edges
+/// and then keeps, at every node, the bits it has not seen before.
+void
+MultiSourceBfsBatch(
+    const katana::GraphTopology& topology, const uint32_t* sources,
+    size_t num_sources, size_t batch_words, uint32_t* dist) {
+  const size_t num_nodes = topology.num_nodes();
+  katana::NUMAArray<uint64_t> seen;
+  katana::NUMAArray<uint64_t> frontier;
+  katana::NUMAArray<uint64_t> next;
+  seen.allocateInterleaved(num_nodes * batch_words);
+  frontier.allocateInterleaved(num_nodes * batch_words);
+  next.allocateInterleaved(num_nodes * batch_words);
+  katana::ParallelSTL::fill(seen.begin(), seen.end(), 0);
+  katana::ParallelSTL::fill(frontier.begin(), frontier.end(), 0);
+  katana::ParallelSTL::fill(next.begin(), next.end(), 0);
+
+  for (size_t i = 0; i < num_sources; ++i) {
+    uint64_t bit = uint64_t{1} << (i % 64);
+    seen[sources[i] * batch_words + i / 64] |= bit;
+    frontier[sources[i] * batch_words + i / 64] |= bit;
+    dist[i * num_nodes + sources[i]] = 0;
+  }
+
+  katana::GReduceLogicalOr active;
+  for (uint32_t level = 1;; ++level) {
+    katana::do_all(
+        katana::iterate(size_t{0}, num_nodes),
+        [&](size_t src) {
+          const uint64_t* src_frontier = &frontier[src * batch_words];
+          if (std::all_of(
+                  src_frontier, src_frontier + batch_words,
+                  [](uint64_t w) { return w == 0; })) {
+            return;
+          }
+          for (auto e : topology.edges(src)) {
+            size_t dst = topology.edge_dest(e) * batch_words;
+            for (size_t w = 0; w < batch_words; ++w) {
+              uint64_t bits = src_frontier[w] & ~seen[dst + w];
+              // Skip the atomic if the bits are already on their way
+              if (bits && (next[dst + w] & bits) != bits) {
+                __sync_fetch_and_or(&next[dst + w], bits);
+              }
+            }
+          }
+        },
+        katana::steal(), katana::chunk_size<kChunkSize>(),
+        katana::loopname("MultiSourceBfs-expand"));
+
+    active.reset();
+    katana::do_all(
+        katana::iterate(size_t{0}, num_nodes),
+        [&](size_t n) {
+          for (size_t w = 0; w < batch_words; ++w) {
+            size_t i = n * batch_words + w;
+            uint64_t bits = next[i] & ~seen[i];
+            next[i] = 0;
+            frontier[i] = bits;
+            if (!bits) {
+              continue;
+            }
+            seen[i] |= bits;
+            active.update(true);
+            for (; bits; bits &= bits - 1) {
+              size_t source = w * 64 + __builtin_ctzll(bits);
+              dist[source * num_nodes + n] = level;
+            }
+          }
+        },
+        katana::chunk_size<kChunkSize>(),
+        katana::loopname("MultiSourceBfs-identify"));
+
+    if (!active.reduce()) {
+      break;
+    }
+  }
+}
+
+katana::Result<katana::NUMAArray<uint32_t>>
+MultiSourceBfsImpl(
+    const katana::GraphTopology& topology,
+    const std::vector<uint32_t>& sources, BfsPlan plan) {
+  if (plan.algorithm() != BfsPlan::kMultiSource) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "multi-source BFS requires the MultiSource plan, not {}",
+        plan.algorithm());
+  }
+  uint32_t batch_size = plan.batch_size();
+  if (batch_size == 0 || batch_size % 64 != 0 ||
+      batch_size > BfsPlan::kMaxBatchSize) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "batch size must be a multiple of 64 up to {}: {}",
+        BfsPlan::kMaxBatchSize, batch_size);
+  }
+  const size_t num_nodes = topology.num_nodes();
+  for (auto source : sources) {
+    if (source >= num_nodes) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "source {} is not a node",
+          source);
+    }
+  }
+
+  katana::NUMAArray<uint32_t> dist;
+  dist.allocateInterleaved(sources.size() * num_nodes);
+  katana::ParallelSTL::fill(
+      dist.begin(), dist.end(), BfsImplementation::kDistanceInfinity);
+
+  katana::StatTimer exec_time("MultiSourceBfs");
+  exec_time.start();
+  for (size_t begin = 0; begin < sources.size(); begin += batch_size) {
+    size_t num = std::min<size_t>(batch_size, sources.size() - begin);
+    MultiSourceBfsBatch(
+        topology, &sources[begin], num, (num + 63) / 64,
+        &dist[begin * num_nodes]);
+  }
+  exec_time.stop();
+
+  return dist;
+}
+
+/// The BFS tree of one side of a bidirectional search: the node each node
+/// was reached from and its distance from the root of the side
+struct PathSearchSide {
+  struct Visit {
+    GNode from;
+    uint32_t dist;
+  };
+  std::unordered_map<GNode, Visit> visited;
+  std::vector<GNode> frontier;
+
+  explicit PathSearchSide(GNode root) {
+    visited.emplace(root, Visit{root, 0});
+    frontier.emplace_back(root);
+  }
+
+  /// Walk from node back to the root of the side
+  void AppendPathToRoot(GNode node, std::vector<GNode>* path) const {
+    for (;;) {
+      path->emplace_back(node);
+      GNode from = visited.at(node).from;
+      if (from == node) {
+        return;
+      }
+      node = from;
+    }
+  }
+};
+
+/// Expand one level of side over the edges given by for_each_neighbor and
+/// return the node on the shortest path through side and other found on the
+/// level, if any. The searches meet on this level, so a shorter meeting
+/// found later in the level must still be taken.
+template <typename ForEachNeighbor>
+std::optional<GNode>
+ExpandPathSearchLevel(
+    PathSearchSide* side, const PathSearchSide& other,
+    const ForEachNeighbor& for_each_neighbor) {
+  std::vector<GNode> next;
+  std::optional<GNode> meet;
+  uint32_t best = std::numeric_limits<uint32_t>::max();
+  for (GNode u : side->frontier) {
+    uint32_t dist = side->visited.at(u).dist + 1;
+    for_each_neighbor(u, [&](GNode v) {
+      if (!side->visited.emplace(v, PathSearchSide::Visit{u, dist}).second) {
+        return;
+      }
+      next.emplace_back(v);
+      if (auto it = other.visited.find(v); it != other.visited.end() &&
+                                           dist + it->second.dist < best) {
+        best = dist + it->second.dist;
+        meet = v;
+      }
+    });
+  }
+  side->frontier = std::move(next);
+  return meet;
+}
+
+template <typename View>
+std::vector<GNode>
+BidirectionalBfs(const View& view, GNode source, GNode target) {
+  if (source == target) {
+    return {source};
+  }
+  PathSearchSide forward(source);
+  PathSearchSide backward(target);
+  auto out_neighbors = [&](GNode u, const auto& fn) {
+    for (auto e : view.edges(u)) {
+      fn(view.edge_dest(e));
+    }
+  };
+  auto in_neighbors = [&](GNode u, const auto& fn) {
+    for (auto e : view.in_edges(u)) {
+      fn(view.in_edge_dest(e));
+    }
+  };
+
+  while (!forward.frontier.empty() && !backward.frontier.empty()) {
+    // Grow the smaller search; the two frontiers only need to meet
+    std::optional<GNode> meet =
+        forward.frontier.size() <= backward.frontier.size()
+            ? ExpandPathSearchLevel(&forward, backward, out_neighbors)
+            : ExpandPathSearchLevel(&backward, forward, in_neighbors);
+    if (meet) {
+      std::vector<GNode> path;
+      forward.AppendPathToRoot(*meet, &path);
+      std::reverse(path.begin(), path.end());
+      path.pop_back();
+      backward.AppendPathToRoot(*meet, &path);
+      return path;
+    }
+  }
+  return {};
+}
+
+/// Level synchronous BFS over the edges of index in window
+katana::NUMAArray<uint32_t>
+TimeWindowBfsImpl(
+    const katana::TemporalEdgeIndex& index, GNode source,
+    const katana::TimeWindow& window) {
+  constexpr uint32_t kInfinity = BfsImplementation::kDistanceInfinity;
+  katana::NUMAArray<std::atomic<uint32_t>> dist;
+  dist.allocateBlocked(index.num_nodes());
+  katana::do_all(
+      katana::iterate(index.all_nodes()),
+      [&](GNode n) { dist[n].store(kInfinity, std::memory_order_relaxed); },
+      katana::no_stats());
+  dist[source].store(0, std::memory_order_relaxed);
+
+  katana::InsertBag<GNode> current;
+  katana::InsertBag<GNode> next;
+  current.push(source);
+  for (uint32_t level = 1; !current.empty(); ++level) {
+    katana::do_all(
+        katana::iterate(current),
+        [&](GNode n) {
+          for (auto e : index.edges(n, window)) {
+            GNode dest = index.edge_dest(e);
+            uint32_t expected = kInfinity;
+            if (dist[dest].load(std::memory_order_relaxed) == kInfinity &&
+                dist[dest].compare_exchange_strong(
+                    expected, level, std::memory_order_relaxed)) {
+              next.push(dest);
+            }
+          }
+        },
+        katana::steal(), katana::loopname("TimeWindowBfs"));
+    current.clear();
+    current.swap(next);
+  }
+
+  katana::NUMAArray<uint32_t> result;
+  result.allocateBlocked(index.num_nodes());
+  katana::do_all(
+      katana::iterate(index.all_nodes()),
+      [&](GNode n) { result[n] = dist[n].load(std::memory_order_relaxed); },
+      katana::no_stats());
+  return result;
+}
+
+katana::NUMAArray<uint32_t>
+CompressedBfsImpl(
+    const katana::CompressedGraphTopology& topology, GNode source) {
+  constexpr uint32_t kInfinity = BfsImplementation::kDistanceInfinity;
+  katana::NUMAArray<std::atomic<uint32_t>> dist;
+  dist.allocateBlocked(topology.num_nodes());
+  katana::do_all(
+      katana::iterate(topology.all_nodes()),
+      [&](GNode n) { dist[n].store(kInfinity, std::memory_order_relaxed); },
+      katana::no_stats());
+  dist[source].store(0, std::memory_order_relaxed);
+
+  katana::InsertBag<GNode> current;
+  katana::InsertBag<GNode> next;
+  current.push(source);
+  for (uint32_t level = 1; !current.empty(); ++level) {
+    katana::do_all(
+        katana::iterate(current),
+        [&](GNode n) {
+          for (GNode dest : topology.dests(n)) {
+            uint32_t expected = kInfinity;
+            if (dist[dest].load(std::memory_order_relaxed) == kInfinity &&
+                dist[dest].compare_exchange_strong(
+                    expected, level, std::memory_order_relaxed)) {
+              next.push(dest);
+            }
+          }
+        },
+        katana::steal(), katana::loopname("CompressedBfs"));
+    current.clear();
+    current.swap(next);
+  }
+
+  katana::NUMAArray<uint32_t> result;
+  result.allocateBlocked(topology.num_nodes());
+  katana::do_all(
+      katana::iterate(topology.all_nodes()),
+      [&](GNode n) { result[n] = dist[n].load(std::memory_order_relaxed); },
+      katana::no_stats());
+  return result;
+}
+
 }  // namespace
 
 katana::Result<void>
 katana::analytics::Bfs(
     PropertyGraph* pg, GNode start_node,
-    const std::string& output_property_name, BfsPlan algo) {
+    const std::string& output_property_name, BfsPlan algo,
+    AnalyticsContext* context) {
+  KATANA_CHECKED(CheckArchitecture(algo));
+  auto profile = ProfileParallelism(algo);
+
   if (auto result = ConstructNodeProperties<std::tuple<BfsNodeParent>>(
           pg, {output_property_name});
       !result) {
     return result.error();
   }
 
+  if (algo.algorithm() != BfsPlan::kSynchronousDirectOpt &&
+      algo.algorithm() != BfsPlan::kSynchronousDirectOptLazyTranspose &&
+      algo.algorithm() != BfsPlan::kAsynchronous) {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotImplemented, "Unsupported algorithm: {}",
+        algo.algorithm());
+  }
+
   auto graph = KATANA_CHECKED(Graph::Make(pg, {output_property_name}, {}));
-  auto bidir_view =
-      KATANA_CHECKED(BiDirGraphView::Make(pg, {output_property_name}, {}));
+  // The lazy transpose variant builds its in-edges while it runs
+  std::optional<BiDirGraphView> bidir_view;
+  if (algo.algorithm() != BfsPlan::kSynchronousDirectOptLazyTranspose) {
+    bidir_view =
+        KATANA_CHECKED(BiDirGraphView::Make(pg, {output_property_name}, {}));
+  }
 
   /*
   auto pg_result = Graph::Make(pg, {output_property_name}, {});
@@ -531,7 +1016,114 @@ katana::analytics::Bfs(
   }
   */
 
-  return BfsImpl(&graph, bidir_view, start_node, algo);
+  auto res = BfsImpl(
+      pg->topology(), &graph, bidir_view ? &bidir_view.value() : nullptr,
+      start_node, algo, context);
+  if (!res && res.error() == katana::ErrorCode::Cancelled) {
+    KATANA_CHECKED(pg->RemoveNodeProperty(output_property_name));
+  }
+  return res;
+}
+
+katana::Result<std::vector<uint32_t>>
+katana::analytics::BfsPath(
+    PropertyGraph* pg, uint32_t source, uint32_t target) {
+  if (source >= pg->num_nodes() || target >= pg->num_nodes()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "{} or {} is not a node", source,
+        target);
+  }
+  auto view = pg->BuildView<katana::PropertyGraphViews::BiDirectional>();
+  return BidirectionalBfs(view, source, target);
+}
+
+katana::Result<katana::NUMAArray<uint32_t>>
+katana::analytics::MultiSourceBfsDistances(
+    PropertyGraph* pg, const std::vector<uint32_t>& sources, BfsPlan plan) {
+  return MultiSourceBfsImpl(pg->topology(), sources, plan);
+}
+
+katana::Result<void>
+katana::analytics::MultiSourceBfs(
+    PropertyGraph* pg, const std::vector<uint32_t>& sources,
+    const std::vector<std::string>& output_property_names, BfsPlan plan) {
+  if (sources.size() != output_property_names.size()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "{} sources but {} output properties", sources.size(),
+        output_property_names.size());
+  }
+  std::unordered_set<std::string> names;
+  for (const auto& name : output_property_names) {
+    if (!names.insert(name).second) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "output property {} is given more than once", name);
+    }
+  }
+
+  katana::NUMAArray<uint32_t> dist =
+      KATANA_CHECKED(MultiSourceBfsImpl(pg->topology(), sources, plan));
+
+  const size_t num_nodes = pg->num_nodes();
+  for (size_t i = 0; i < sources.size(); ++i) {
+    KATANA_CHECKED(ConstructNodeProperties<std::tuple<BfsNodeDistance>>(
+        pg, {output_property_names[i]}));
+    auto graph = KATANA_CHECKED(
+        DistanceGraph::Make(pg, {output_property_names[i]}, {}));
+    katana::do_all(
+        katana::iterate(graph),
+        [&](GNode n) {
+          graph.GetData<BfsNodeDistance>(n) = dist[i * num_nodes + n];
+        },
+        katana::no_stats());
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::analytics::TimeWindowBfs(
+    PropertyGraph* pg, uint32_t start_node,
+    const std::string& timestamp_property_name, const TimeWindow& window,
+    const std::string& output_property_name) {
+  if (start_node >= pg->num_nodes()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "source {} is not a node",
+        start_node);
+  }
+  auto index =
+      KATANA_CHECKED(pg->GetTemporalEdgeIndex(timestamp_property_name));
+
+  katana::StatTimer exec_time("TimeWindowBfs");
+  exec_time.start();
+  katana::NUMAArray<uint32_t> dist =
+      TimeWindowBfsImpl(*index, start_node, window);
+  exec_time.stop();
+
+  KATANA_CHECKED(ConstructNodeProperties<std::tuple<BfsNodeDistance>>(
+      pg, {output_property_name}));
+  auto graph =
+      KATANA_CHECKED(DistanceGraph::Make(pg, {output_property_name}, {}));
+  katana::do_all(
+      katana::iterate(graph),
+      [&](GNode n) { graph.GetData<BfsNodeDistance>(n) = dist[n]; },
+      katana::no_stats());
+  return katana::ResultSuccess();
+}
+
+katana::Result<katana::NUMAArray<uint32_t>>
+katana::analytics::CompressedBfsDistances(
+    const CompressedGraphTopology& topology, uint32_t start_node) {
+  if (start_node >= topology.num_nodes()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "source {} is not a node",
+        start_node);
+  }
+  katana::StatTimer exec_time("CompressedBfs");
+  exec_time.start();
+  katana::NUMAArray<uint32_t> dist = CompressedBfsImpl(topology, start_node);
+  exec_time.stop();
+  return dist;
 }
 
 template <bool CONCURRENT, typename LevelVec>
@@ -689,6 +1281,36 @@ katana::analytics::BfsAssertValid(
   return CheckParentByLevel(bidir_view, source, levels);
 }
 
+katana::Result<void>
+katana::analytics::MultiSourceBfsAssertValid(
+    PropertyGraph* pg, const GNode source, const std::string& property_name) {
+  // The distance property has the same type as the parent property
+  auto graph = KATANA_CHECKED(DistanceGraph::Make(pg, {property_name}, {}));
+
+  katana::NUMAArray<Dist> levels;
+  levels.allocateInterleaved(graph.num_nodes());
+  katana::ParallelSTL::fill(
+      levels.begin(), levels.end(), BfsImplementation::kDistanceInfinity);
+  ComputeLevels<true>(graph, source, levels);
+
+  katana::GAccumulator<size_t> num_wrong;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) {
+        if (graph.GetData<BfsNodeDistance>(n) != levels[n]) {
+          num_wrong += 1;
+        }
+      },
+      katana::no_stats());
+  if (num_wrong.reduce() > 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "{} nodes have a distance from {} other than their BFS level",
+        num_wrong.reduce(), source);
+  }
+  return katana::ResultSuccess();
+}
+
 katana::Result<BfsStatistics>
 katana::analytics::BfsStatistics::Compute(
     katana::PropertyGraph* pg, const std::string& property_name) {
@@ -0,0 +1,977 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2020, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "katana/analytics/bipartite_matching/bipartite_matching.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+#include "katana/SimpleLock.h"
+#include "katana/Statistics.h"
+#include "katana/Timer.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+constexpr uint32_t kUnmatched = kBipartiteMatchingUnmatched;
+/// Per node term of the global relabel interval
+constexpr uint64_t kAlpha = 6;
+/// Work is accumulated per thread and published in batches of this size
+constexpr int64_t kWorkBatch = 1024;
+/// The factor by which epsilon shrinks between auction phases
+constexpr double kEpsilonScaling = 4;
+constexpr unsigned kChunkSize = 16;
+
+using Mates = katana::NUMAArray<std::atomic<uint32_t>>;
+
+/// The edges between the two sides. The arcs of a node are its neighbors on
+/// the other side over its out-edges followed by its in-edges. If only the left
+/// nodes need arcs, the right nodes have none. For the auction, each arc has
+/// the weight of its edge.
+struct BipartiteGraph {
+  katana::NUMAArray<uint64_t> offsets;
+  katana::NUMAArray<uint32_t> dests;
+  katana::NUMAArray<double> weights;
+
+  uint32_t num_nodes() const { return offsets.size() - 1; }
+  uint64_t begin(uint32_t n) const { return offsets[n]; }
+  uint64_t end(uint32_t n) const { return offsets[n + 1]; }
+};
+
+template <typename View>
+void
+BuildBipartiteGraph(
+    const View& view, const katana::NUMAArray<uint8_t>& is_left,
+    bool left_only, const katana::NUMAArray<double>* edge_weights,
+    BipartiteGraph* graph) {
+  const uint64_t num_nodes = view.num_nodes();
+  katana::NUMAArray<uint64_t> counts;
+  counts.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t count = 0;
+        if (is_left[n] || !left_only) {
+          for (auto e : view.edges(n)) {
+            count += is_left[view.edge_dest(e)] != is_left[n];
+          }
+          for (auto e : view.in_edges(n)) {
+            count += is_left[view.in_edge_dest(e)] != is_left[n];
+          }
+        }
+        counts[n] = count;
+      },
+      katana::steal(), katana::no_stats());
+  graph->offsets.allocateBlocked(num_nodes + 1);
+  graph->offsets[0] = 0;
+  katana::ParallelSTL::partial_sum(
+      counts.begin(), counts.end(), graph->offsets.begin() + 1);
+
+  const uint64_t num_arcs = graph->offsets[num_nodes];
+  graph->dests.allocateBlocked(num_arcs);
+  if (edge_weights) {
+    graph->weights.allocateBlocked(num_arcs);
+  }
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        if (!is_left[n] && left_only) {
+          return;
+        }
+        uint64_t arc = graph->offsets[n];
+        for (auto e : view.edges(n)) {
+          auto dest = view.edge_dest(e);
+          if (is_left[dest] == is_left[n]) {
+            continue;
+          }
+          graph->dests[arc] = dest;
+          if (edge_weights) {
+            graph->weights[arc] = (*edge_weights)[view.edge_property_index(e)];
+          }
+          ++arc;
+        }
+        for (auto e : view.in_edges(n)) {
+          auto dest = view.in_edge_dest(e);
+          if (is_left[dest] == is_left[n]) {
+            continue;
+          }
+          graph->dests[arc] = dest;
+          if (edge_weights) {
+            graph->weights[arc] =
+                (*edge_weights)[view.in_edge_property_index(e)];
+          }
+          ++arc;
+        }
+      },
+      katana::steal(), katana::no_stats(),
+      katana::loopname("BipartiteMatchingBuildGraph"));
+}
+
+void
+InitMates(uint32_t num_nodes, Mates* mates) {
+  mates->allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(uint32_t{0}, num_nodes),
+      [&](uint32_t n) {
+        (*mates)[n].store(kUnmatched, std::memory_order_relaxed);
+      },
+      katana::no_stats());
+}
+
+/// Set the mates of the left nodes from the mates of the right nodes
+void
+SetLeftMates(const katana::NUMAArray<uint8_t>& is_left, Mates* mates) {
+  const uint32_t num_nodes = mates->size();
+  katana::do_all(
+      katana::iterate(uint32_t{0}, num_nodes),
+      [&](uint32_t n) {
+        if (is_left[n]) {
+          (*mates)[n].store(kUnmatched, std::memory_order_relaxed);
+        }
+      },
+      katana::no_stats());
+  katana::do_all(
+      katana::iterate(uint32_t{0}, num_nodes),
+      [&](uint32_t n) {
+        uint32_t mate = (*mates)[n].load(std::memory_order_relaxed);
+        if (!is_left[n] && mate != kUnmatched) {
+          (*mates)[mate].store(n, std::memory_order_relaxed);
+        }
+      },
+      katana::no_stats());
+}
+
+/// Match each left node to the first of its right neighbors that is still
+/// free, if any
+void
+GreedyMatching(
+    const BipartiteGraph& graph, const katana::NUMAArray<uint8_t>& is_left,
+    Mates* mates) {
+  katana::do_all(
+      katana::iterate(uint32_t{0}, graph.num_nodes()),
+      [&](uint32_t n) {
+        if (!is_left[n]) {
+          return;
+        }
+        for (uint64_t arc = graph.begin(n); arc < graph.end(n); ++arc) {
+          uint32_t right = graph.dests[arc];
+          uint32_t unmatched = kUnmatched;
+          if ((*mates)[right].load(std::memory_order_relaxed) == kUnmatched &&
+              (*mates)[right].compare_exchange_strong(
+                  unmatched, n, std::memory_order_relaxed)) {
+            (*mates)[n].store(right, std::memory_order_relaxed);
+            return;
+          }
+        }
+      },
+      katana::steal(), katana::no_stats(),
+      katana::loopname("BipartiteMatchingGreedy"));
+}
+
+/// Asynchronous push-relabel. Only the mates of the right nodes are kept up
+/// to date while discharging; each left node that is not the mate of a right
+/// node is free. Labels of right nodes estimate the length of the shortest
+/// alternating path to a free right node.
+class PushRelabel {
+public:
+  PushRelabel(
+      const BipartiteGraph& graph, const katana::NUMAArray<uint8_t>& is_left,
+      Mates* mates)
+      : graph_(graph),
+        is_left_(is_left),
+        mates_(*mates),
+        num_nodes_(graph.num_nodes()) {
+    double interval = kAlpha * num_nodes_ + graph.dests.size() / 2;
+    global_relabel_interval_ = std::max(interval, double{kWorkBatch});
+    labels_.allocateBlocked(num_nodes_);
+  }
+
+  /// Compute a maximum matching, starting from the matching in the mates
+  void Run() {
+    using WL = katana::PerSocketChunkFIFO<kChunkSize>;
+    for (;;) {
+      katana::InsertBag<uint32_t> active;
+      GlobalRelabel(&active);
+      if (active.empty()) {
+        break;
+      }
+      work_.store(0);
+      katana::for_each(
+          katana::iterate(active),
+          [&](uint32_t n, auto& ctx) {
+            if (AddWork(Discharge(n, ctx))) {
+              ctx.breakLoop();
+            }
+          },
+          katana::disable_conflict_detection(), katana::parallel_break(),
+          katana::wl<WL>(), katana::loopname("BipartiteMatchingDischarge"));
+    }
+  }
+
+  uint64_t num_global_relabels() const { return num_global_relabels_; }
+
+private:
+  /// Set the labels to the alternating distances from the free right nodes
+  /// and collect the free left nodes that reach one. Also brings the mates
+  /// of the left nodes up to date.
+  void GlobalRelabel(katana::InsertBag<uint32_t>* active) {
+    ++num_global_relabels_;
+    SetLeftMates(is_left_, &mates_);
+
+    katana::InsertBag<uint32_t> frontiers[2];
+    katana::do_all(
+        katana::iterate(uint32_t{0}, num_nodes_),
+        [&](uint32_t n) {
+          bool free_right = !is_left_[n] && graph_.begin(n) < graph_.end(n) &&
+                            mates_[n].load(std::memory_order_relaxed) ==
+                                kUnmatched;
+          labels_[n].store(
+              free_right ? 0 : num_nodes_, std::memory_order_relaxed);
+          if (free_right) {
+            frontiers[0].push(n);
+          }
+        },
+        katana::no_stats());
+
+    for (uint32_t level = 0; !frontiers[level / 2 % 2].empty(); level += 2) {
+      auto& current = frontiers[level / 2 % 2];
+      auto& next = frontiers[(level / 2 + 1) % 2];
+      katana::do_all(
+          katana::iterate(current),
+          [&](uint32_t right) {
+            for (uint64_t arc = graph_.begin(right); arc < graph_.end(right);
+                 ++arc) {
+              uint32_t left = graph_.dests[arc];
+              uint32_t mate = mates_[left].load(std::memory_order_relaxed);
+              uint32_t unreached = num_nodes_;
+              if (mate == right ||
+                  labels_[left].load(std::memory_order_relaxed) !=
+                      num_nodes_ ||
+                  !labels_[left].compare_exchange_strong(
+                      unreached, level + 1, std::memory_order_relaxed)) {
+                continue;
+              }
+              if (mate == kUnmatched) {
+                active->push(left);
+              } else {
+                // Only left reaches its mate
+                labels_[mate].store(level + 2, std::memory_order_relaxed);
+                next.push(mate);
+              }
+            }
+          },
+          katana::steal(), katana::chunk_size<kChunkSize>(),
+          katana::no_stats(),
+          katana::loopname("BipartiteMatchingGlobalRelabel"));
+      current.clear();
+    }
+  }
+
+  /// Match the free left node n to its lowest right neighbor, whose mate
+  /// becomes free, and relabel that neighbor to two more than the second
+  /// lowest. Does nothing if no neighbor reaches a free right node. Returns
+  /// the work done.
+  template <typename Context>
+  int64_t Discharge(uint32_t n, Context& ctx) {
+    const uint64_t begin = graph_.begin(n);
+    const uint64_t end = graph_.end(n);
+    uint32_t lowest = num_nodes_;
+    uint32_t second = num_nodes_;
+    uint32_t target = kUnmatched;
+    for (uint64_t arc = begin; arc < end; ++arc) {
+      uint32_t right = graph_.dests[arc];
+      uint32_t label = labels_[right].load(std::memory_order_relaxed);
+      if (label < lowest) {
+        second = lowest;
+        lowest = label;
+        target = right;
+      } else if (label < second) {
+        second = label;
+      }
+    }
+    if (lowest >= num_nodes_) {
+      return end - begin;
+    }
+    uint32_t displaced = mates_[target].exchange(n, std::memory_order_relaxed);
+    labels_[target].store(
+        std::min<uint64_t>(uint64_t{second} + 2, num_nodes_),
+        std::memory_order_relaxed);
+    if (displaced != kUnmatched) {
+      ctx.push(displaced);
+    }
+    return end - begin;
+  }
+
+  /// Publish local work in batches; returns whether the total since the last
+  /// global relabel has reached the interval
+  bool AddWork(int64_t amount) {
+    int64_t& local = *local_work_.getLocal();
+    local += amount;
+    if (local < kWorkBatch) {
+      return false;
+    }
+    int64_t total = work_.fetch_add(local) + local;
+    local = 0;
+    return total >= global_relabel_interval_;
+  }
+
+  const BipartiteGraph& graph_;
+  const katana::NUMAArray<uint8_t>& is_left_;
+  Mates& mates_;
+  const uint32_t num_nodes_;
+  int64_t global_relabel_interval_;
+
+  katana::NUMAArray<std::atomic<uint32_t>> labels_;
+
+  std::atomic<int64_t> work_{0};
+  katana::PerThreadStorage<int64_t> local_work_{0};
+  uint64_t num_global_relabels_{0};
+};
+
+/// Parallel Pothen-Fan with lookahead and fairness. Right nodes are claimed
+/// at most once per phase, so the augmenting paths found in a phase are
+/// vertex-disjoint and can be flipped without locks.
+class PothenFan {
+public:
+  PothenFan(const BipartiteGraph& graph, Mates* mates)
+      : graph_(graph), mates_(*mates), num_nodes_(graph.num_nodes()) {
+    visited_.allocateBlocked(num_nodes_);
+    lookahead_.allocateBlocked(num_nodes_);
+    katana::do_all(
+        katana::iterate(uint32_t{0}, num_nodes_),
+        [&](uint32_t n) {
+          visited_[n].store(0, std::memory_order_relaxed);
+          lookahead_[n] = graph_.begin(n);
+        },
+        katana::no_stats());
+  }
+
+  /// Compute a maximum matching, starting from the matching in the mates
+  void Run(const katana::NUMAArray<uint8_t>& is_left) {
+    katana::InsertBag<uint32_t> free[2];
+    katana::do_all(
+        katana::iterate(uint32_t{0}, num_nodes_),
+        [&](uint32_t n) {
+          if (is_left[n] && graph_.begin(n) < graph_.end(n) &&
+              mates_[n].load(std::memory_order_relaxed) == kUnmatched) {
+            free[0].push(n);
+          }
+        },
+        katana::no_stats());
+
+    // Phase 0 marks nodes not visited in any phase
+    for (uint32_t phase = 1;; ++phase) {
+      ++num_phases_;
+      auto& current = free[(phase - 1) % 2];
+      auto& next = free[phase % 2];
+      katana::GAccumulator<uint64_t> augmented;
+      katana::do_all(
+          katana::iterate(current),
+          [&](uint32_t n) {
+            if (Search(n, phase)) {
+              augmented += 1;
+            }
+          },
+          katana::steal(), katana::loopname("BipartiteMatchingPothenFan"));
+      // With no path found, every right node reachable from a free left node
+      // was visited without reaching a free one
+      if (augmented.reduce() == 0) {
+        break;
+      }
+      katana::do_all(
+          katana::iterate(current),
+          [&](uint32_t n) {
+            if (mates_[n].load(std::memory_order_relaxed) == kUnmatched) {
+              next.push(n);
+            }
+          },
+          katana::no_stats());
+      current.clear();
+    }
+  }
+
+  uint64_t num_phases() const { return num_phases_; }
+
+private:
+  struct Frame {
+    uint32_t left;
+    uint64_t scanned;
+  };
+
+  bool Claim(uint32_t right, uint32_t phase) {
+    return visited_[right].load(std::memory_order_relaxed) != phase &&
+           visited_[right].exchange(phase, std::memory_order_relaxed) != phase;
+  }
+
+  /// Search depth first from the free left node root for an augmenting path
+  /// and flip it if one is found
+  bool Search(uint32_t root, uint32_t phase) {
+    // Alternate the scan direction so that no neighbor is always tried last
+    const bool forward = phase % 2 == 1;
+    std::vector<Frame>& stack = *stacks_.getLocal();
+    std::vector<uint32_t>& path = *paths_.getLocal();
+    stack.clear();
+    path.clear();
+    stack.push_back(Frame{root, 0});
+    while (!stack.empty()) {
+      const uint32_t left = stack.back().left;
+      const uint64_t begin = graph_.begin(left);
+      const uint64_t end = graph_.end(left);
+
+      // A right node that is passed over is matched, or claimed in this phase
+      // and about to be, and stays matched, so the lookahead never returns
+      for (uint64_t& arc = lookahead_[left]; arc < end; ++arc) {
+        uint32_t right = graph_.dests[arc];
+        if (mates_[right].load(std::memory_order_relaxed) == kUnmatched &&
+            Claim(right, phase)) {
+          ++arc;
+          Augment(stack, path, right);
+          return true;
+        }
+      }
+
+      uint32_t mate = kUnmatched;
+      while (stack.back().scanned < end - begin) {
+        uint64_t offset = stack.back().scanned++;
+        uint32_t right =
+            graph_.dests[forward ? begin + offset : end - 1 - offset];
+        if (!Claim(right, phase)) {
+          continue;
+        }
+        mate = mates_[right].load(std::memory_order_relaxed);
+        if (mate == kUnmatched) {
+          Augment(stack, path, right);
+          return true;
+        }
+        path.push_back(right);
+        break;
+      }
+      if (mate != kUnmatched) {
+        stack.push_back(Frame{mate, 0});
+      } else {
+        stack.pop_back();
+        if (!path.empty()) {
+          path.pop_back();
+        }
+      }
+    }
+    return false;
+  }
+
+  /// Match the deepest left node of the search to the free right node and
+  /// every other one to the right node through which the search left it
+  void Augment(
+      const std::vector<Frame>& stack, const std::vector<uint32_t>& path,
+      uint32_t right) {
+    for (size_t i = stack.size(); i-- > 0;) {
+      uint32_t left = stack[i].left;
+      mates_[left].store(right, std::memory_order_relaxed);
+      mates_[right].store(left, std::memory_order_relaxed);
+      if (i > 0) {
+        right = path[i - 1];
+      }
+    }
+  }
+
+  const BipartiteGraph& graph_;
+  Mates& mates_;
+  const uint32_t num_nodes_;
+
+  /// The last phase in which each right node was claimed
+  katana::NUMAArray<std::atomic<uint32_t>> visited_;
+  /// The next arc of each left node to look ahead through
+  katana::NUMAArray<uint64_t> lookahead_;
+  katana::PerThreadStorage<std::vector<Frame>> stacks_;
+  katana::PerThreadStorage<std::vector<uint32_t>> paths_;
+  uint64_t num_phases_{0};
+};
+
+/// Parallel forward auction. Only the mates of the right nodes, their owners,
+/// are kept up to date while bidding. Leaving a left node unassigned is an
+/// option worth 0.
+class Auction {
+public:
+  Auction(
+      const BipartiteGraph& graph, const katana::NUMAArray<uint8_t>& is_left,
+      Mates* mates)
+      : graph_(graph),
+        is_left_(is_left),
+        mates_(*mates),
+        num_nodes_(graph.num_nodes()) {
+    prices_.allocateBlocked(num_nodes_);
+    locks_.allocateBlocked(num_nodes_);
+    katana::do_all(
+        katana::iterate(uint32_t{0}, num_nodes_),
+        [&](uint32_t n) {
+          prices_[n].store(0, std::memory_order_relaxed);
+          locks_.constructAt(n);
+        },
+        katana::no_stats());
+  }
+
+  /// Compute a matching within num_left_nodes * final_epsilon of the maximum
+  /// weight
+  void Run(double final_epsilon) {
+    katana::GReduceMax<double> max_weight;
+    katana::do_all(
+        katana::iterate(uint64_t{0}, graph_.weights.size()),
+        [&](uint64_t arc) { max_weight.update(graph_.weights[arc]); },
+        katana::no_stats());
+    if (!(max_weight.reduce() > 0)) {
+      return;
+    }
+    double epsilon =
+        std::max(max_weight.reduce() / kEpsilonScaling, final_epsilon);
+    for (;;) {
+      ++num_phases_;
+      Phase(epsilon);
+      if (epsilon <= final_epsilon) {
+        break;
+      }
+      epsilon = std::max(epsilon / kEpsilonScaling, final_epsilon);
+    }
+    SetLeftMates(is_left_, &mates_);
+  }
+
+  uint64_t num_phases() const { return num_phases_; }
+
+private:
+  void Phase(double epsilon) {
+    Repair(epsilon);
+    katana::InsertBag<uint32_t> bidders;
+    katana::do_all(
+        katana::iterate(uint32_t{0}, num_nodes_),
+        [&](uint32_t n) {
+          if (is_left_[n] && graph_.begin(n) < graph_.end(n) &&
+              mates_[n].load(std::memory_order_relaxed) == kUnmatched) {
+            bidders.push(n);
+          }
+        },
+        katana::no_stats());
+
+    using WL = katana::PerSocketChunkFIFO<kChunkSize>;
+    katana::for_each(
+        katana::iterate(bidders),
+        [&](uint32_t n, auto& ctx) { Bid(n, epsilon, ctx); },
+        katana::disable_conflict_detection(), katana::wl<WL>(),
+        katana::loopname("BipartiteMatchingAuction"));
+  }
+
+  /// Keep the prices but restore, for a new epsilon, the conditions under
+  /// which the final matching is near optimal: unassigned right nodes have
+  /// price 0, and each assigned left node is within epsilon of its most
+  /// valuable option. Unassigning a left node frees its right node, whose
+  /// price then drops, so repeat until no left node is unassigned.
+  void Repair(double epsilon) {
+    for (;;) {
+      katana::do_all(
+          katana::iterate(uint32_t{0}, num_nodes_),
+          [&](uint32_t n) {
+            if (!is_left_[n] &&
+                mates_[n].load(std::memory_order_relaxed) == kUnmatched) {
+              prices_[n].store(0, std::memory_order_relaxed);
+            }
+          },
+          katana::no_stats());
+      SetLeftMates(is_left_, &mates_);
+
+      katana::GReduceLogicalOr unassigned;
+      katana::do_all(
+          katana::iterate(uint32_t{0}, num_nodes_),
+          [&](uint32_t n) {
+            uint32_t mate = mates_[n].load(std::memory_order_relaxed);
+            if (!is_left_[n] || mate == kUnmatched) {
+              return;
+            }
+            double best = 0;
+            double own = -std::numeric_limits<double>::infinity();
+            for (uint64_t arc = graph_.begin(n); arc < graph_.end(n); ++arc) {
+              uint32_t right = graph_.dests[arc];
+              double value = graph_.weights[arc] -
+                             prices_[right].load(std::memory_order_relaxed);
+              best = std::max(best, value);
+              if (right == mate) {
+                own = std::max(own, value);
+              }
+            }
+            if (own < best - epsilon) {
+              mates_[mate].store(kUnmatched, std::memory_order_relaxed);
+              mates_[n].store(kUnmatched, std::memory_order_relaxed);
+              unassigned.update(true);
+            }
+          },
+          katana::steal(), katana::no_stats(),
+          katana::loopname("BipartiteMatchingAuctionRepair"));
+      if (!unassigned.reduce()) {
+        break;
+      }
+    }
+  }
+
+  /// Bid for the most valuable right neighbor of n, raising its price so
+  /// that it is worth epsilon less to n than the second most valuable option,
+  /// and push the left node that it outbids
+  template <typename Context>
+  void Bid(uint32_t n, double epsilon, Context& ctx) {
+    for (;;) {
+      double best = -std::numeric_limits<double>::infinity();
+      double second = 0;
+      double target_price = 0;
+      uint32_t target = kUnmatched;
+      for (uint64_t arc = graph_.begin(n); arc < graph_.end(n); ++arc) {
+        uint32_t right = graph_.dests[arc];
+        double price = prices_[right].load(std::memory_order_relaxed);
+        double value = graph_.weights[arc] - price;
+        if (value > best) {
+          second = std::max(second, best);
+          best = value;
+          target = right;
+          target_price = price;
+        } else if (value > second) {
+          second = value;
+        }
+      }
+      if (!(best > 0)) {
+        return;
+      }
+      double bid = target_price + best - second + epsilon;
+
+      uint32_t outbid = kUnmatched;
+      locks_[target].lock();
+      // The price may have risen past the bid since it was read
+      bool won = bid > prices_[target].load(std::memory_order_relaxed);
+      if (won) {
+        outbid = mates_[target].load(std::memory_order_relaxed);
+        mates_[target].store(n, std::memory_order_relaxed);
+        prices_[target].store(bid, std::memory_order_relaxed);
+      }
+      locks_[target].unlock();
+      if (won) {
+        if (outbid != kUnmatched) {
+          ctx.push(outbid);
+        }
+        return;
+      }
+    }
+  }
+
+  const BipartiteGraph& graph_;
+  const katana::NUMAArray<uint8_t>& is_left_;
+  Mates& mates_;
+  const uint32_t num_nodes_;
+
+  katana::NUMAArray<std::atomic<double>> prices_;
+  katana::NUMAArray<katana::SimpleLock> locks_;
+  uint64_t num_phases_{0};
+};
+
+/// Whether each node has the atomic node type left_node_type_name
+katana::Result<katana::NUMAArray<uint8_t>>
+ReadSides(katana::PropertyGraph* pg, const std::string& left_node_type_name) {
+  if (!pg->HasAtomicNodeType(left_node_type_name)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotFound, "no atomic node type named {}",
+        left_node_type_name);
+  }
+  katana::EntityTypeID left_type =
+      pg->GetNodeEntityTypeID(left_node_type_name);
+  katana::NUMAArray<uint8_t> is_left;
+  is_left.allocateBlocked(pg->num_nodes());
+  katana::do_all(
+      katana::iterate(pg->topology().all_nodes()),
+      [&](auto n) { is_left[n] = pg->DoesNodeHaveType(n, left_type); },
+      katana::no_stats());
+  return katana::Result<katana::NUMAArray<uint8_t>>(std::move(is_left));
+}
+
+template <typename T>
+katana::Result<void>
+CopyWeights(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    katana::NUMAArray<double>* weights) {
+  auto values =
+      KATANA_CHECKED(pg->GetEdgePropertyTyped<T>(edge_weight_property_name));
+  weights->allocateBlocked(values->length());
+  katana::GReduceLogicalOr is_nan;
+  katana::do_all(
+      katana::iterate(int64_t{0}, values->length()),
+      [&](int64_t i) {
+        (*weights)[i] = static_cast<double>(values->Value(i));
+        if constexpr (std::is_floating_point_v<T>) {
+          is_nan.update(std::isnan((*weights)[i]));
+        }
+      },
+      katana::no_stats());
+  if (is_nan.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "edge weights may not be NaN");
+  }
+  return katana::ResultSuccess();
+}
+
+/// The weights as doubles, indexed by edge property index
+katana::Result<katana::NUMAArray<double>>
+ReadWeights(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name) {
+  katana::NUMAArray<double> weights;
+  KATANA_CHECKED(
+      DispatchOnEdgePropertyType(pg, edge_weight_property_name, [&](auto tag) {
+        return CopyWeights<decltype(tag)>(
+            pg, edge_weight_property_name, &weights);
+      }));
+  return katana::Result<katana::NUMAArray<double>>(std::move(weights));
+}
+
+katana::Result<void>
+WriteMates(
+    katana::PropertyGraph* pg, const Mates& mates,
+    const std::string& output_property_name) {
+  const uint64_t num_nodes = pg->num_nodes();
+  std::shared_ptr<arrow::Buffer> buffer =
+      KATANA_CHECKED(arrow::AllocateBuffer(num_nodes * sizeof(uint32_t)));
+  auto* values = reinterpret_cast<uint32_t*>(buffer->mutable_data());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { values[n] = mates[n].load(); }, katana::no_stats());
+  auto array = std::make_shared<arrow::UInt32Array>(num_nodes, buffer);
+  return pg->AddNodeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field(output_property_name, arrow::uint32())}),
+      {array}));
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::BipartiteMatching(
+    PropertyGraph* pg, const std::string& left_node_type_name,
+    const std::string& output_property_name, BipartiteMatchingPlan plan) {
+  if (plan.algorithm() != BipartiteMatchingPlan::kPushRelabel &&
+      plan.algorithm() != BipartiteMatchingPlan::kPothenFan) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "maximum cardinality matching uses push-relabel or Pothen-Fan");
+  }
+  auto is_left = KATANA_CHECKED(ReadSides(pg, left_node_type_name));
+
+  // Augmenting paths are only searched from the left
+  bool left_only = plan.algorithm() == BipartiteMatchingPlan::kPothenFan;
+  BipartiteGraph graph;
+  {
+    auto view = pg->BuildView<katana::PropertyGraphViews::BiDirectional>();
+    BuildBipartiteGraph(view, is_left, left_only, nullptr, &graph);
+  }
+  Mates mates;
+  InitMates(pg->num_nodes(), &mates);
+
+  katana::StatTimer exec_time("BipartiteMatching");
+  exec_time.start();
+  GreedyMatching(graph, is_left, &mates);
+  if (plan.algorithm() == BipartiteMatchingPlan::kPushRelabel) {
+    PushRelabel algo(graph, is_left, &mates);
+    algo.Run();
+    katana::ReportStatSingle(
+        "BipartiteMatching", "GlobalRelabels", algo.num_global_relabels());
+  } else {
+    PothenFan algo(graph, &mates);
+    algo.Run(is_left);
+    katana::ReportStatSingle("BipartiteMatching", "Phases", algo.num_phases());
+  }
+  exec_time.stop();
+
+  return WriteMates(pg, mates, output_property_name);
+}
+
+katana::Result<void>
+katana::analytics::MaximumWeightBipartiteMatching(
+    PropertyGraph* pg, const std::string& left_node_type_name,
+    const std::string& edge_weight_property_name,
+    const std::string& output_property_name, BipartiteMatchingPlan plan) {
+  if (plan.algorithm() != BipartiteMatchingPlan::kAuction) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "maximum weight matching uses the auction");
+  }
+  if (!(plan.epsilon() >= 0)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "epsilon must be non-negative, got {}", plan.epsilon());
+  }
+  auto is_left = KATANA_CHECKED(ReadSides(pg, left_node_type_name));
+  auto weights = KATANA_CHECKED(ReadWeights(pg, edge_weight_property_name));
+
+  BipartiteGraph graph;
+  {
+    auto view = pg->BuildView<katana::PropertyGraphViews::BiDirectional>();
+    BuildBipartiteGraph(view, is_left, true, &weights, &graph);
+  }
+  double epsilon = plan.epsilon();
+  if (epsilon == 0) {
+    katana::GAccumulator<uint64_t> num_left;
+    katana::do_all(
+        katana::iterate(uint32_t{0}, graph.num_nodes()),
+        [&](uint32_t n) { num_left += is_left[n]; }, katana::no_stats());
+    epsilon = 1.0 / (num_left.reduce() + 1);
+  }
+  Mates mates;
+  InitMates(pg->num_nodes(), &mates);
+
+  katana::StatTimer exec_time("MaximumWeightBipartiteMatching");
+  exec_time.start();
+  Auction algo(graph, is_left, &mates);
+  algo.Run(epsilon);
+  katana::ReportStatSingle(
+      "MaximumWeightBipartiteMatching", "Phases", algo.num_phases());
+  exec_time.stop();
+
+  return WriteMates(pg, mates, output_property_name);
+}
+
+katana::Result<void>
+katana::analytics::BipartiteMatchingAssertValid(
+    PropertyGraph* pg, const std::string& left_node_type_name,
+    const std::string& property_name) {
+  auto is_left = KATANA_CHECKED(ReadSides(pg, left_node_type_name));
+  auto mates =
+      KATANA_CHECKED(pg->GetNodePropertyTyped<uint32_t>(property_name));
+  const auto& topology = pg->topology();
+  const uint64_t num_nodes = topology.num_nodes();
+
+  katana::GReduceLogicalOr not_mutual;
+  katana::do_all(
+      katana::iterate(topology.all_nodes()),
+      [&](auto n) {
+        uint32_t mate = mates->Value(n);
+        if (mate != kUnmatched) {
+          not_mutual.update(
+              mate >= num_nodes || mates->Value(mate) != n ||
+              is_left[mate] == is_left[n]);
+        }
+      },
+      katana::no_stats());
+  if (not_mutual.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "mates are not mutual pairs of a left and a right node");
+  }
+
+  // Whether some out-edge of each node leads to its mate
+  katana::NUMAArray<uint8_t> joined;
+  joined.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(topology.all_nodes()),
+      [&](auto n) {
+        uint32_t mate = mates->Value(n);
+        joined[n] = false;
+        for (auto e : topology.edges(n)) {
+          if (topology.edge_dest(e) == mate) {
+            joined[n] = true;
+            break;
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+  katana::GReduceLogicalOr not_joined;
+  katana::do_all(
+      katana::iterate(topology.all_nodes()),
+      [&](auto n) {
+        uint32_t mate = mates->Value(n);
+        not_joined.update(
+            mate != kUnmatched && !joined[n] && !joined[mate]);
+      },
+      katana::no_stats());
+  if (not_joined.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "matched nodes are not joined by an edge");
+  }
+  return katana::ResultSuccess();
+}
+
+void
+katana::analytics::BipartiteMatchingStatistics::Print(std::ostream& os) const {
+  os << "Number of matched pairs = " << num_matched_pairs << std::endl;
+  os << "Total weight = " << total_weight << std::endl;
+}
+
+katana::Result<BipartiteMatchingStatistics>
+katana::analytics::BipartiteMatchingStatistics::Compute(
+    katana::PropertyGraph* pg, const std::string& property_name,
+    const std::string& edge_weight_property_name) {
+  auto mates =
+      KATANA_CHECKED(pg->GetNodePropertyTyped<uint32_t>(property_name));
+  const auto& topology = pg->topology();
+
+  katana::GAccumulator<uint64_t> num_matched_pairs;
+  katana::do_all(
+      katana::iterate(topology.all_nodes()),
+      [&](auto n) {
+        uint32_t mate = mates->Value(n);
+        if (mate != kUnmatched && n < mate) {
+          num_matched_pairs += 1;
+        }
+      },
+      katana::no_stats());
+  if (edge_weight_property_name.empty()) {
+    return BipartiteMatchingStatistics{num_matched_pairs.reduce(), 0};
+  }
+
+  auto weights = KATANA_CHECKED(ReadWeights(pg, edge_weight_property_name));
+  // The heaviest out-edge of each node to its mate
+  katana::NUMAArray<double> heaviest;
+  heaviest.allocateBlocked(topology.num_nodes());
+  katana::do_all(
+      katana::iterate(topology.all_nodes()),
+      [&](auto n) {
+        uint32_t mate = mates->Value(n);
+        heaviest[n] = -std::numeric_limits<double>::infinity();
+        for (auto e : topology.edges(n)) {
+          if (topology.edge_dest(e) == mate) {
+            heaviest[n] = std::max(
+                heaviest[n], weights[topology.edge_property_index(e)]);
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+  katana::GAccumulator<double> total_weight;
+  katana::do_all(
+      katana::iterate(topology.all_nodes()),
+      [&](auto n) {
+        uint32_t mate = mates->Value(n);
+        if (mate != kUnmatched && n < mate) {
+          double weight = std::max(heaviest[n], heaviest[mate]);
+          if (std::isfinite(weight)) {
+            total_weight += weight;
+          }
+        }
+      },
+      katana::no_stats());
+  return BipartiteMatchingStatistics{
+      num_matched_pairs.reduce(), total_weight.reduce()};
+}
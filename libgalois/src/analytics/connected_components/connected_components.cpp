@@ -19,7 +19,13 @@
 
 #include "katana/analytics/connected_components/connected_components.h"
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 #include "katana/ArrowRandomAccessBuilder.h"
+#include "katana/HashMapReducer.h"
+#include "katana/Random.h"
 #include "katana/TypedPropertyGraph.h"
 
 using namespace katana::analytics;
@@ -29,6 +35,11 @@ const int ConnectedComponentsPlan::kChunkSize = 1;
 namespace {
 
 const unsigned int kInfinity = std::numeric_limits<unsigned int>::max();
+
+/// Seeds the nodes sampled to find the largest component, so that runs
+/// sample the same nodes
+constexpr uint64_t kComponentSampleSeed = 0xCC5A3F1E9B2D4067;
+
 struct ConnectedComponentsNode
     : public katana::UnionFindNode<ConnectedComponentsNode> {
   using ComponentType = ConnectedComponentsNode*;
@@ -596,8 +607,7 @@ approxLargestComponent(Graph* graph, uint32_t component_sample_frequency) {
   using pair_type = std::pair<ComponentType, int>;
 
   map_type comp_freq(component_sample_frequency);
-  std::random_device rd;
-  std::mt19937 rng(rd());
+  katana::CounterRng rng(kComponentSampleSeed, 0);
   std::uniform_int_distribution<uint32_t> dist(0, graph->size() - 1);
   for (uint32_t i = 0; i < component_sample_frequency; i++) {
     ComponentType ndata = graph->template GetData<NodeIndex>(dist(rng));
@@ -630,8 +640,7 @@ approxLargestComponent(
   using pair_type = std::pair<ComponentType, int>;
 
   map_type comp_freq(component_sample_frequency);
-  std::random_device rd;
-  std::mt19937 rng(rd());
+  katana::CounterRng rng(kComponentSampleSeed, 0);
   std::uniform_int_distribution<uint32_t> dist(0, graph->size() - 1);
   for (uint32_t i = 0; i < component_sample_frequency; i++) {
     const auto& ndata = parent_array_[dist(rng)];
@@ -1139,6 +1148,9 @@ katana::Result<void>
 katana::analytics::ConnectedComponents(
     PropertyGraph* pg, const std::string& output_property_name,
     ConnectedComponentsPlan plan) {
+  KATANA_CHECKED(CheckArchitecture(plan));
+  auto profile = ProfileParallelism(plan);
+
   switch (plan.algorithm()) {
   case ConnectedComponentsPlan::kSerial:
     return ConnectedComponentsWithWrap<ConnectedComponentsSerialAlgo>(
@@ -1178,6 +1190,101 @@ katana::analytics::ConnectedComponents(
   }
 }
 
+katana::Result<void>
+katana::analytics::ConnectedComponentsIncremental(
+    PropertyGraph* pg, const std::string& property_name,
+    const std::vector<std::pair<uint32_t, uint32_t>>& new_edges) {
+  using ComponentType = uint64_t;
+  struct NodeComponent : public katana::PODProperty<ComponentType> {};
+
+  using NodeData = std::tuple<NodeComponent>;
+  using EdgeData = std::tuple<>;
+  typedef katana::TypedPropertyGraph<NodeData, EdgeData> Graph;
+  typedef typename Graph::Node GNode;
+
+  for (const auto& [src, dest] : new_edges) {
+    if (src >= pg->num_nodes() || dest >= pg->num_nodes()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "edge ({}, {}) is out of range",
+          src, dest);
+    }
+  }
+
+  auto graph = KATANA_CHECKED(Graph::Make(pg, {property_name}, {}));
+
+  katana::StatTimer execTime("ConnectedComponentIncremental");
+  execTime.start();
+
+  // The union-find is over the labels of the endpoints of the new edges,
+  // in increasing order. Merges point larger elements to smaller ones, so
+  // every merged component ends up with the smallest of its labels.
+  std::vector<ComponentType> labels;
+  labels.reserve(2 * new_edges.size());
+  for (const auto& [src, dest] : new_edges) {
+    labels.emplace_back(graph.GetData<NodeComponent>(src));
+    labels.emplace_back(graph.GetData<NodeComponent>(dest));
+  }
+  katana::ParallelSTL::sort(labels.begin(), labels.end());
+  labels.erase(std::unique(labels.begin(), labels.end()), labels.end());
+
+  auto label_index = [&](GNode n) {
+    return std::distance(
+        labels.begin(),
+        std::lower_bound(
+            labels.begin(), labels.end(), graph.GetData<NodeComponent>(n)));
+  };
+
+  std::vector<ConnectedComponentsNode> components(labels.size());
+  katana::do_all(
+      katana::iterate(new_edges),
+      [&](const std::pair<uint32_t, uint32_t>& edge) {
+        auto a = label_index(edge.first);
+        auto b = label_index(edge.second);
+        if (a != b) {
+          components[a].merge(&components[b]);
+        }
+      },
+      katana::loopname("IncrementalMerge"));
+
+  // The labels that change, in increasing order
+  std::vector<std::pair<ComponentType, ComponentType>> relabel;
+  for (size_t i = 0; i < labels.size(); ++i) {
+    auto rep = components[i].findAndCompress() - components.data();
+    if (static_cast<size_t>(rep) != i) {
+      relabel.emplace_back(labels[i], labels[rep]);
+    }
+  }
+
+  katana::GAccumulator<uint64_t> rewritten;
+  if (!relabel.empty()) {
+    katana::do_all(
+        katana::iterate(graph),
+        [&](const GNode& n) {
+          auto& label = graph.GetData<NodeComponent>(n);
+          if (label < relabel.front().first || label > relabel.back().first) {
+            return;
+          }
+          auto it = std::lower_bound(
+              relabel.begin(), relabel.end(), label,
+              [](const std::pair<ComponentType, ComponentType>& entry,
+                 ComponentType l) { return entry.first < l; });
+          if (it != relabel.end() && it->first == label) {
+            label = it->second;
+            rewritten += 1;
+          }
+        },
+        katana::loopname("IncrementalRelabel"));
+  }
+  execTime.stop();
+
+  katana::ReportStatSingle(
+      "ConnectedComponentIncremental", "MergedComponents", relabel.size());
+  katana::ReportStatSingle(
+      "ConnectedComponentIncremental", "RewrittenNodes", rewritten.reduce());
+
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 katana::analytics::ConnectedComponentsAssertValid(
     PropertyGraph* pg, const std::string& property_name) {
@@ -1238,36 +1345,17 @@ katana::analytics::ConnectedComponentsStatistics::Compute(
 
   auto graph = pg_result.value();
 
-  using Map = katana::gstl::Map<ComponentType, int>;
-
-  auto reduce = [](Map& lhs, Map&& rhs) -> Map& {
-    Map v{std::move(rhs)};
-
-    for (auto& kv : v) {
-      if (lhs.count(kv.first) == 0) {
-        lhs[kv.first] = 0;
-      }
-      lhs[kv.first] += kv.second;
-    }
-
-    return lhs;
-  };
-
-  auto mapIdentity = []() { return Map(); };
-
-  auto accumMap = katana::make_reducible(reduce, mapIdentity);
-
-  katana::GAccumulator<size_t> accumReps;
+  katana::GHashMapReducer<ComponentType, int> accumMap;
 
   katana::do_all(
       katana::iterate(graph),
       [&](const GNode& x) {
         auto& n = graph.template GetData<NodeComponent>(x);
-        accumMap.update(Map{std::make_pair(n, 1)});
+        accumMap.update(n, 1);
       },
       katana::loopname("CountLargest"));
 
-  Map& map = accumMap.reduce();
+  const auto& map = accumMap.reduce();
   size_t reps = map.size();
 
   using ComponentSizePair = std::pair<ComponentType, int>;
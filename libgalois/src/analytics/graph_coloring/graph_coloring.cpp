@@ -0,0 +1,382 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2020, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "katana/analytics/graph_coloring/graph_coloring.h"
+
+#include <atomic>
+#include <limits>
+#include <vector>
+
+#include "katana/Bag.h"
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+#include "katana/Statistics.h"
+#include "katana/Timer.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/Utils.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+constexpr int kChunkSize = 64;
+constexpr uint32_t kUncolored = std::numeric_limits<uint32_t>::max();
+
+struct NodeColor : public katana::PODProperty<uint32_t> {};
+
+using NodeData = std::tuple<NodeColor>;
+using EdgeData = std::tuple<>;
+
+typedef katana::TypedPropertyGraph<NodeData, EdgeData> Graph;
+typedef typename Graph::Node GNode;
+
+uint32_t
+Hash(uint32_t val) {
+  val = ((val >> 16) ^ val) * 0x45d9f3b;
+  val = ((val >> 16) ^ val) * 0x45d9f3b;
+  return (val >> 16) ^ val;
+}
+
+/// Node a beats node b if it has a higher priority, or the same priority and
+/// a smaller ID
+class Priorities {
+public:
+  Priorities(const Graph& graph, GraphColoringPlan::Priority priority) {
+    priorities_.allocateBlocked(graph.size());
+    katana::do_all(
+        katana::iterate(graph),
+        [&](const GNode& n) {
+          uint64_t p = Hash(n);
+          if (priority == GraphColoringPlan::kDegree) {
+            p |= uint64_t{graph.edges(n).size()} << 32;
+          }
+          priorities_[n] = p;
+        },
+        katana::no_stats(), katana::loopname("GraphColoring-priorities"));
+  }
+
+  bool Beats(GNode a, GNode b) const {
+    return priorities_[a] > priorities_[b] ||
+           (priorities_[a] == priorities_[b] && a < b);
+  }
+
+private:
+  katana::NUMAArray<uint64_t> priorities_;
+};
+
+/// Per-thread set of the colors of the neighbors of one node. Clear is
+/// constant time: a color is in the set if it is marked with the current
+/// stamp.
+class ForbiddenColors {
+public:
+  void Clear(size_t degree) {
+    if (marks_.size() <= degree) {
+      marks_.resize(degree + 1, 0);
+    }
+    if (++stamp_ == 0) {
+      std::fill(marks_.begin(), marks_.end(), 0);
+      stamp_ = 1;
+    }
+  }
+
+  /// Colors larger than the degree passed to Clear never matter, since a
+  /// node has a free color at most its degree
+  void Insert(uint32_t color) {
+    if (color < marks_.size()) {
+      marks_[color] = stamp_;
+    }
+  }
+
+  uint32_t SmallestFree() const {
+    uint32_t color = 0;
+    while (marks_[color] == stamp_) {
+      color++;
+    }
+    return color;
+  }
+
+private:
+  std::vector<uint32_t> marks_;
+  uint32_t stamp_{0};
+};
+
+/// Color each node once all of its neighbors that beat it are colored,
+/// starting from the nodes that beat all of their neighbors.
+void
+JonesPlassmann(
+    const Graph& graph, const Priorities& priorities,
+    katana::NUMAArray<std::atomic<uint32_t>>* colors) {
+  katana::NUMAArray<std::atomic<uint32_t>> waiting;
+  waiting.allocateBlocked(graph.size());
+  katana::InsertBag<GNode> roots;
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& src) {
+        uint32_t count = 0;
+        for (auto e : graph.edges(src)) {
+          auto dest = *graph.GetEdgeDest(e);
+          count += dest != src && priorities.Beats(dest, src);
+        }
+        waiting[src].store(count, std::memory_order_relaxed);
+        (*colors)[src].store(kUncolored, std::memory_order_relaxed);
+        if (count == 0) {
+          roots.push(src);
+        }
+      },
+      katana::steal(), katana::loopname("GraphColoring-JP-init"));
+
+  katana::PerThreadStorage<ForbiddenColors> forbidden;
+  katana::for_each(
+      katana::iterate(roots),
+      [&](const GNode& src, auto& ctx) {
+        ForbiddenColors& local = *forbidden.getLocal();
+        local.Clear(graph.edges(src).size());
+        for (auto e : graph.edges(src)) {
+          auto dest = *graph.GetEdgeDest(e);
+          if (dest != src && priorities.Beats(dest, src)) {
+            local.Insert((*colors)[dest].load(std::memory_order_relaxed));
+          }
+        }
+        (*colors)[src].store(local.SmallestFree(), std::memory_order_relaxed);
+
+        // The release of the last decrement makes the color visible to the
+        // thread that colors dest
+        for (auto e : graph.edges(src)) {
+          auto dest = *graph.GetEdgeDest(e);
+          if (dest != src && priorities.Beats(src, dest) &&
+              waiting[dest].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            ctx.push(dest);
+          }
+        }
+      },
+      katana::disable_conflict_detection(),
+      katana::wl<katana::PerSocketChunkFIFO<kChunkSize>>(),
+      katana::loopname("GraphColoring-JP"));
+}
+
+/// Color all uncolored nodes at once, then uncolor the losers of conflicts,
+/// until there are none.
+void
+Speculative(
+    const Graph& graph, const Priorities& priorities,
+    katana::NUMAArray<std::atomic<uint32_t>>* colors) {
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) {
+        (*colors)[n].store(kUncolored, std::memory_order_relaxed);
+      },
+      katana::no_stats());
+
+  auto cur = std::make_unique<katana::InsertBag<GNode>>();
+  auto next = std::make_unique<katana::InsertBag<GNode>>();
+  katana::PerThreadStorage<ForbiddenColors> forbidden;
+  size_t rounds = 0;
+
+  bool first = true;
+  while (first || !cur->empty()) {
+    auto color = [&](const GNode& src) {
+      ForbiddenColors& local = *forbidden.getLocal();
+      local.Clear(graph.edges(src).size());
+      for (auto e : graph.edges(src)) {
+        auto dest = *graph.GetEdgeDest(e);
+        if (dest != src) {
+          local.Insert((*colors)[dest].load(std::memory_order_relaxed));
+        }
+      }
+      (*colors)[src].store(local.SmallestFree(), std::memory_order_relaxed);
+    };
+    auto detect = [&](const GNode& src) {
+      uint32_t src_color = (*colors)[src].load(std::memory_order_relaxed);
+      for (auto e : graph.edges(src)) {
+        auto dest = *graph.GetEdgeDest(e);
+        if (dest != src && priorities.Beats(dest, src) &&
+            (*colors)[dest].load(std::memory_order_relaxed) == src_color) {
+          next->push(src);
+          return;
+        }
+      }
+    };
+
+    // Losers are only uncolored after detection, so that both ends of a
+    // conflict see it
+    if (first) {
+      katana::do_all(
+          katana::iterate(graph), color, katana::steal(),
+          katana::loopname("GraphColoring-speculate"));
+      katana::do_all(
+          katana::iterate(graph), detect, katana::steal(),
+          katana::loopname("GraphColoring-detect"));
+    } else {
+      katana::do_all(
+          katana::iterate(*cur), color, katana::steal(),
+          katana::loopname("GraphColoring-speculate"));
+      katana::do_all(
+          katana::iterate(*cur), detect, katana::steal(),
+          katana::loopname("GraphColoring-detect"));
+    }
+    katana::do_all(
+        katana::iterate(*next),
+        [&](const GNode& n) {
+          (*colors)[n].store(kUncolored, std::memory_order_relaxed);
+        },
+        katana::no_stats());
+
+    cur->clear();
+    std::swap(cur, next);
+    first = false;
+    rounds += 1;
+  }
+
+  katana::ReportStatSingle("GraphColoring-Speculative", "rounds", rounds);
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::GraphColoring(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    GraphColoringPlan plan) {
+  if (auto result =
+          ConstructNodeProperties<NodeData>(pg, {output_property_name});
+      !result) {
+    return result.error();
+  }
+
+  auto pg_result = Graph::Make(pg, {output_property_name}, {});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  Graph graph = pg_result.value();
+
+  katana::NUMAArray<std::atomic<uint32_t>> colors;
+  colors.allocateBlocked(graph.size());
+
+  katana::StatTimer exec_time("GraphColoring");
+  exec_time.start();
+  Priorities priorities(graph, plan.priority());
+  switch (plan.algorithm()) {
+  case GraphColoringPlan::kJonesPlassmann:
+    JonesPlassmann(graph, priorities, &colors);
+    break;
+  case GraphColoringPlan::kSpeculative:
+    Speculative(graph, priorities, &colors);
+    break;
+  default:
+    return katana::ErrorCode::InvalidArgument;
+  }
+  exec_time.stop();
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) {
+        graph.GetData<NodeColor>(n) =
+            colors[n].load(std::memory_order_relaxed);
+      },
+      katana::no_stats(), katana::loopname("GraphColoring-output"));
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::analytics::GraphColoringAssertValid(
+    katana::PropertyGraph* pg, const std::string& property_name) {
+  auto pg_result = Graph::Make(pg, {property_name}, {});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  Graph graph = pg_result.value();
+
+  katana::GReduceLogicalOr has_error;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& src) {
+        uint32_t src_color = graph.GetData<NodeColor>(src);
+        if (src_color == kUncolored) {
+          has_error.update(true);
+          return;
+        }
+        for (auto e : graph.edges(src)) {
+          auto dest = graph.GetEdgeDest(e);
+          if (*dest != src && graph.GetData<NodeColor>(dest) == src_color) {
+            has_error.update(true);
+            return;
+          }
+        }
+      },
+      katana::no_stats(), katana::loopname("GraphColoring-check"));
+  if (has_error.reduce()) {
+    return katana::ErrorCode::AssertionFailed;
+  }
+
+  return katana::ResultSuccess();
+}
+
+void
+katana::analytics::GraphColoringStatistics::Print(std::ostream& os) const {
+  os << "Number of colors = " << num_colors << std::endl;
+  os << "Largest color class = " << largest_color_class << std::endl;
+}
+
+katana::Result<GraphColoringStatistics>
+katana::analytics::GraphColoringStatistics::Compute(
+    katana::PropertyGraph* pg, const std::string& property_name) {
+  auto property_result = pg->GetNodePropertyTyped<uint32_t>(property_name);
+  if (!property_result) {
+    return property_result.error();
+  }
+  auto property = property_result.value();
+
+  katana::GReduceMax<uint32_t> max_color;
+  katana::do_all(
+      katana::iterate(int64_t{0}, property->length()),
+      [&](int64_t i) { max_color.update(property->Value(i)); },
+      katana::no_stats());
+  if (property->length() > 0 && max_color.reduce() == kUncolored) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "some nodes are not colored");
+  }
+  uint32_t num_colors = property->length() > 0 ? max_color.reduce() + 1 : 0;
+
+  katana::NUMAArray<std::atomic<uint64_t>> class_sizes;
+  class_sizes.allocateBlocked(num_colors);
+  katana::do_all(
+      katana::iterate(uint32_t{0}, num_colors),
+      [&](uint32_t c) { class_sizes[c].store(0, std::memory_order_relaxed); },
+      katana::no_stats());
+  katana::do_all(
+      katana::iterate(int64_t{0}, property->length()),
+      [&](int64_t i) {
+        class_sizes[property->Value(i)].fetch_add(
+            1, std::memory_order_relaxed);
+      },
+      katana::no_stats());
+
+  katana::GReduceMax<uint64_t> largest;
+  katana::do_all(
+      katana::iterate(uint32_t{0}, num_colors),
+      [&](uint32_t c) {
+        largest.update(class_sizes[c].load(std::memory_order_relaxed));
+      },
+      katana::no_stats());
+
+  return GraphColoringStatistics{num_colors, largest.reduce()};
+}
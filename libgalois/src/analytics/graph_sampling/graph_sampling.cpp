@@ -0,0 +1,385 @@
+#include "katana/analytics/graph_sampling/graph_sampling.h"
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <unordered_set>
+#include <utility>
+
+#include "katana/Bag.h"
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Random.h"
+#include "katana/Timer.h"
+#include "katana/analytics/subgraph_extraction/subgraph_extraction.h"
+
+namespace {
+
+using namespace katana::analytics;
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+
+// Each use of the random numbers counts from a step of its own, so the
+// numbers drawn for different decisions about the same item are independent
+constexpr uint64_t kStepsPerUse = uint64_t{1} << 48;
+constexpr uint64_t kCandidateSteps = 0;
+constexpr uint64_t kJumpSteps = 1 * kStepsPerUse;
+constexpr uint64_t kWalkSteps = 2 * kStepsPerUse;
+constexpr uint64_t kRestartSteps = 3 * kStepsPerUse;
+constexpr uint64_t kBurnSteps = 4 * kStepsPerUse;
+
+/// Blocks of random numbers a decision may use before it would draw from
+/// the next decision's blocks
+constexpr uint64_t kBlocksPerDraw = 4;
+
+/// Steps each walker takes between merges of the visited nodes
+constexpr uint64_t kWalkStepsPerRound = 32;
+
+/// A uniformly random integer in [0, n)
+uint64_t
+UniformBelow(katana::CounterRng* rng, uint64_t n) {
+  return std::uniform_int_distribution<uint64_t>(0, n - 1)(*rng);
+}
+
+/// sample_size distinct ids uniformly picked from [0, n), in the order they
+/// were picked. Candidate i is drawn with the random numbers of item i, and
+/// candidates are drawn in rounds until enough are distinct, so the result
+/// does not depend on the threads, and the work is proportional to
+/// sample_size unless it is close to n.
+std::vector<uint64_t>
+UniformSample(uint64_t n, uint64_t sample_size, uint64_t seed) {
+  std::vector<uint64_t> sample;
+  if (sample_size >= n) {
+    sample.resize(n);
+    std::iota(sample.begin(), sample.end(), uint64_t{0});
+    return sample;
+  }
+
+  if (sample_size > n / 2) {
+    // Rejection would draw too many duplicates: order all ids by a random
+    // key and take the first ones
+    std::vector<std::pair<uint64_t, uint64_t>> keys(n);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, n),
+        [&](uint64_t i) {
+          katana::CounterRng rng(seed, i, kCandidateSteps);
+          keys[i] = {(uint64_t{rng()} << 32) | rng(), i};
+        },
+        katana::no_stats());
+    std::nth_element(keys.begin(), keys.begin() + sample_size, keys.end());
+    keys.resize(sample_size);
+    katana::ParallelSTL::sort(keys.begin(), keys.end());
+    for (const auto& key : keys) {
+      sample.emplace_back(key.second);
+    }
+    return sample;
+  }
+
+  // (id, index of the candidate that picked it first)
+  std::vector<std::pair<uint64_t, uint64_t>> candidates;
+  uint64_t num_drawn = 0;
+  uint64_t num_distinct = 0;
+  while (num_distinct < sample_size) {
+    uint64_t missing = sample_size - num_distinct;
+    uint64_t batch = missing + missing / 4 + 64;
+    candidates.resize(num_distinct + batch);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, batch),
+        [&](uint64_t i) {
+          katana::CounterRng rng(seed, num_drawn + i, kCandidateSteps);
+          candidates[num_distinct + i] = {
+              UniformBelow(&rng, n), num_drawn + i};
+        },
+        katana::no_stats());
+    num_drawn += batch;
+    katana::ParallelSTL::sort(candidates.begin(), candidates.end());
+    candidates.erase(
+        std::unique(
+            candidates.begin(), candidates.end(),
+            [](const auto& a, const auto& b) { return a.first == b.first; }),
+        candidates.end());
+    num_distinct = candidates.size();
+  }
+
+  katana::ParallelSTL::sort(
+      candidates.begin(), candidates.end(),
+      [](const auto& a, const auto& b) { return a.second < b.second; });
+  candidates.resize(sample_size);
+  for (const auto& candidate : candidates) {
+    sample.emplace_back(candidate.first);
+  }
+  return sample;
+}
+
+/// The nodes visited in order, without duplicates
+class Sample {
+public:
+  explicit Sample(uint64_t size) : size_(size) {}
+
+  bool full() const { return nodes_.size() >= size_; }
+
+  bool contains(Node n) const { return seen_.count(n) > 0; }
+
+  /// Add n if it is new and the sample is not full
+  bool Add(Node n) {
+    if (full() || !seen_.insert(n).second) {
+      return false;
+    }
+    nodes_.emplace_back(n);
+    return true;
+  }
+
+  std::vector<Node> Release() { return std::move(nodes_); }
+
+private:
+  uint64_t size_;
+  std::vector<Node> nodes_;
+  std::unordered_set<Node> seen_;
+};
+
+struct Walker {
+  Node start;
+  Node current;
+  uint64_t jumps;
+};
+
+std::vector<Node>
+RandomWalkSample(
+    const katana::GraphTopology& topology, uint64_t sample_size,
+    uint64_t seed, const GraphSamplingPlan& plan) {
+  uint64_t num_nodes = topology.num_nodes();
+  uint64_t num_walkers = plan.number_of_walkers();
+  Sample sample(sample_size);
+
+  std::vector<Walker> walkers(num_walkers);
+  auto jump = [&](uint64_t w) {
+    Walker& walker = walkers[w];
+    katana::CounterRng rng(
+        seed, w, kJumpSteps + walker.jumps++ * kBlocksPerDraw);
+    walker.start = UniformBelow(&rng, num_nodes);
+    walker.current = walker.start;
+  };
+  for (uint64_t w = 0; w < num_walkers; ++w) {
+    jump(w);
+    sample.Add(walkers[w].start);
+  }
+
+  // Node visited by walker w at step s of a round, at s * num_walkers + w
+  std::vector<Node> visits(kWalkStepsPerRound * num_walkers);
+  bool stalled = false;
+  for (uint64_t round = 0; !sample.full(); ++round) {
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_walkers),
+        [&](uint64_t w) {
+          Walker& walker = walkers[w];
+          for (uint64_t s = 0; s < kWalkStepsPerRound; ++s) {
+            uint64_t step = round * kWalkStepsPerRound + s;
+            katana::CounterRng rng(
+                seed, w, kWalkSteps + step * kBlocksPerDraw);
+            auto edges = topology.edges(walker.current);
+            if ((s == 0 && stalled) ||
+                (edges.empty() && walker.current == walker.start)) {
+              jump(w);
+            } else if (edges.empty() ||
+                       rng.NextDouble() < plan.restart_probability()) {
+              walker.current = walker.start;
+            } else {
+              Edge e = *edges.begin() + UniformBelow(&rng, edges.size());
+              walker.current = topology.edge_dest(e);
+            }
+            visits[s * num_walkers + w] = walker.current;
+          }
+        },
+        katana::steal(), katana::loopname("GraphSamplingRandomWalk"));
+
+    bool added = false;
+    for (Node n : visits) {
+      added |= sample.Add(n);
+    }
+    stalled = !added;
+  }
+  return sample.Release();
+}
+
+/// Forest fire and snowball sampling: each node of the frontier picks up to
+/// count_of(rng) of its unvisited out-neighbors, which form the next
+/// frontier in increasing order of ID
+template <typename CountOf>
+std::vector<Node>
+BurnSample(
+    const katana::GraphTopology& topology, uint64_t sample_size,
+    uint64_t seed, const CountOf& count_of) {
+  uint64_t num_nodes = topology.num_nodes();
+  Sample sample(sample_size);
+  std::vector<Node> frontier;
+  uint64_t restarts = 0;
+
+  while (!sample.full()) {
+    if (frontier.empty()) {
+      // The fire died out; light another one at an unvisited node, which
+      // exists because the sample is smaller than the graph
+      Node n;
+      do {
+        katana::CounterRng rng(seed, restarts++, kRestartSteps);
+        n = UniformBelow(&rng, num_nodes);
+      } while (sample.contains(n));
+      sample.Add(n);
+      frontier = {n};
+      continue;
+    }
+
+    katana::InsertBag<Node> burnt;
+    katana::do_all(
+        katana::iterate(frontier),
+        [&](Node n) {
+          std::vector<Node> unvisited;
+          for (Edge e : topology.edges(n)) {
+            Node dest = topology.edge_dest(e);
+            if (!sample.contains(dest)) {
+              unvisited.emplace_back(dest);
+            }
+          }
+          std::sort(unvisited.begin(), unvisited.end());
+          unvisited.erase(
+              std::unique(unvisited.begin(), unvisited.end()),
+              unvisited.end());
+
+          // A node burns once, so its numbers are keyed by its ID
+          katana::CounterRng rng(seed, n, kBurnSteps);
+          uint64_t count =
+              std::min<uint64_t>(count_of(&rng), unvisited.size());
+          for (uint64_t i = 0; i < count; ++i) {
+            uint64_t j = i + UniformBelow(&rng, unvisited.size() - i);
+            std::swap(unvisited[i], unvisited[j]);
+            burnt.push(unvisited[i]);
+          }
+        },
+        katana::steal(), katana::loopname("GraphSamplingBurn"));
+
+    std::vector<Node> next(burnt.begin(), burnt.end());
+    katana::ParallelSTL::sort(next.begin(), next.end());
+    next.erase(std::unique(next.begin(), next.end()), next.end());
+    frontier.clear();
+    for (Node n : next) {
+      if (sample.Add(n)) {
+        frontier.emplace_back(n);
+      }
+    }
+  }
+  return sample.Release();
+}
+
+katana::Result<void>
+CheckPlan(const GraphSamplingPlan& plan) {
+  switch (plan.algorithm()) {
+  case GraphSamplingPlan::kUniformNode:
+  case GraphSamplingPlan::kUniformEdge:
+    return katana::ResultSuccess();
+  case GraphSamplingPlan::kRandomWalk:
+    if (!(plan.restart_probability() >= 0 &&
+          plan.restart_probability() <= 1)) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "restart probability must be in [0, 1], not {}",
+          plan.restart_probability());
+    }
+    if (plan.number_of_walkers() == 0) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "no walkers to sample with");
+    }
+    return katana::ResultSuccess();
+  case GraphSamplingPlan::kForestFire:
+    if (!(plan.burn_probability() >= 0 && plan.burn_probability() < 1)) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "burn probability must be in [0, 1), not {}",
+          plan.burn_probability());
+    }
+    return katana::ResultSuccess();
+  case GraphSamplingPlan::kSnowball:
+    if (plan.fanout() == 0) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "fanout must be positive");
+    }
+    return katana::ResultSuccess();
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unknown sampling algorithm");
+  }
+}
+
+}  // namespace
+
+katana::Result<std::vector<katana::PropertyGraph::Node>>
+katana::analytics::GraphSampleNodes(
+    katana::PropertyGraph* pg, uint64_t sample_size, uint64_t seed,
+    GraphSamplingPlan plan) {
+  KATANA_CHECKED(CheckPlan(plan));
+  const katana::GraphTopology& topology = pg->topology();
+  uint64_t num_nodes = topology.num_nodes();
+  sample_size = std::min(sample_size, num_nodes);
+  if (sample_size == 0) {
+    return std::vector<Node>();
+  }
+
+  katana::StatTimer execTime("Graph-Sampling");
+  execTime.start();
+  std::vector<Node> nodes;
+  switch (plan.algorithm()) {
+  case GraphSamplingPlan::kUniformNode: {
+    std::vector<uint64_t> ids = UniformSample(num_nodes, sample_size, seed);
+    nodes.assign(ids.begin(), ids.end());
+    break;
+  }
+  case GraphSamplingPlan::kRandomWalk:
+    nodes = RandomWalkSample(topology, sample_size, seed, plan);
+    break;
+  case GraphSamplingPlan::kForestFire: {
+    std::geometric_distribution<uint64_t> burns(1 - plan.burn_probability());
+    nodes = BurnSample(topology, sample_size, seed, [&](CounterRng* rng) {
+      auto dist = burns;
+      return dist(*rng);
+    });
+    break;
+  }
+  case GraphSamplingPlan::kSnowball:
+    nodes = BurnSample(topology, sample_size, seed, [&](CounterRng*) {
+      return uint64_t{plan.fanout()};
+    });
+    break;
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "the nodes of a uniform edge sample do not induce it; use "
+        "GraphSample");
+  }
+  execTime.stop();
+  return nodes;
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::analytics::GraphSample(
+    katana::PropertyGraph* pg, uint64_t sample_size, uint64_t seed,
+    const std::vector<std::string>& node_properties_to_copy,
+    const std::vector<std::string>& edge_properties_to_copy,
+    GraphSamplingPlan plan, std::vector<Node>* sample_nodes) {
+  if (plan.algorithm() == GraphSamplingPlan::kUniformEdge) {
+    std::vector<uint64_t> ids =
+        UniformSample(pg->num_edges(), sample_size, seed);
+    std::vector<Edge> edges(ids.begin(), ids.end());
+    return EdgeSetSubGraphExtraction(
+        pg, edges, node_properties_to_copy, edge_properties_to_copy,
+        sample_nodes);
+  }
+
+  std::vector<Node> nodes =
+      KATANA_CHECKED(GraphSampleNodes(pg, sample_size, seed, plan));
+  auto sample = KATANA_CHECKED(SubGraphExtraction(
+      pg, nodes, node_properties_to_copy, edge_properties_to_copy));
+  if (sample_nodes) {
+    *sample_nodes = std::move(nodes);
+  }
+  return katana::Result<std::unique_ptr<katana::PropertyGraph>>(
+      std::move(sample));
+}
@@ -0,0 +1,1202 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2020, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "katana/analytics/hypergraph_partition/hypergraph_partition.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+#include "katana/Statistics.h"
+#include "katana/Timer.h"
+#include "katana/analytics/Utils.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+constexpr uint32_t kNone = std::numeric_limits<uint32_t>::max();
+constexpr uint32_t kMaxLevels = 64;
+/// The number of seeds of greedy growing tried on the coarsest hypergraph
+constexpr uint32_t kInitialTries = 4;
+/// Coarsening stops when a level has more than this fraction of the nodes
+/// of the previous level
+constexpr double kMinCoarseningRatio = 0.95;
+/// Subproblems with fewer pins than this are bisected serially, concurrently
+/// with other subproblems
+constexpr uint64_t kMinParallelPins = uint64_t{1} << 16;
+
+uint32_t
+Hash(uint32_t val) {
+  val = ((val >> 16) ^ val) * 0x45d9f3b;
+  val = ((val >> 16) ^ val) * 0x45d9f3b;
+  return (val >> 16) ^ val;
+}
+
+/// Call fn on each of [begin, end), in a parallel loop if parallel and
+/// serially otherwise. Subproblems that run concurrently use serial loops,
+/// since parallel loops do not nest.
+template <typename Fn>
+void
+Loop(bool parallel, uint64_t begin, uint64_t end, const Fn& fn) {
+  if (!parallel) {
+    for (uint64_t i = begin; i < end; ++i) {
+      fn(i);
+    }
+    return;
+  }
+  katana::do_all(
+      katana::iterate(begin, end), fn, katana::steal(), katana::no_stats());
+}
+
+/// The sum of fn over [begin, end), computed as by Loop
+template <typename Fn>
+uint64_t
+Sum(bool parallel, uint64_t begin, uint64_t end, const Fn& fn) {
+  if (!parallel) {
+    uint64_t sum = 0;
+    for (uint64_t i = begin; i < end; ++i) {
+      sum += fn(i);
+    }
+    return sum;
+  }
+  katana::GAccumulator<uint64_t> sum;
+  katana::do_all(
+      katana::iterate(begin, end), [&](uint64_t i) { sum += fn(i); },
+      katana::steal(), katana::no_stats());
+  return sum.reduce();
+}
+
+/// Replace [begin, end) with its inclusive prefix sums
+template <typename T>
+void
+PrefixSum(bool parallel, T* begin, T* end) {
+  if (parallel) {
+    katana::ParallelSTL::partial_sum(begin, end, begin);
+  } else {
+    std::partial_sum(begin, end, begin);
+  }
+}
+
+/// A hypergraph with node and hyperedge weights in compressed sparse row
+/// form, in both directions. Every hyperedge has at least two distinct pins.
+struct Hypergraph {
+  /// pin_offsets[h] to pin_offsets[h + 1] are the pins of h, sorted
+  std::vector<uint64_t> pin_offsets{0};
+  std::vector<uint32_t> pins;
+  std::vector<uint32_t> hedge_weights;
+  /// incidence_offsets[n] to incidence_offsets[n + 1] are the hyperedges
+  /// of n, sorted
+  std::vector<uint64_t> incidence_offsets{0};
+  std::vector<uint32_t> incidence;
+  std::vector<uint32_t> node_weights;
+  uint64_t total_weight{0};
+
+  uint32_t num_nodes() const { return node_weights.size(); }
+  uint32_t num_hedges() const { return hedge_weights.size(); }
+};
+
+/// Build the pins of graph from unsorted pins with duplicates: the pins of
+/// candidate hyperedge h are scratch[bounds[h]] to
+/// scratch[bounds[h] + counts[h]] and its weight is weights[h]. Hyperedges
+/// with fewer than two distinct pins cannot be cut and are dropped, and
+/// hyperedges with the same pins are merged into the first of them, summing
+/// their weights.
+void
+CompactPins(
+    bool parallel, const std::vector<uint64_t>& bounds,
+    const std::vector<uint32_t>& weights, std::vector<uint64_t>* counts,
+    std::vector<uint32_t>* scratch, Hypergraph* graph) {
+  const uint64_t num_candidates = counts->size();
+  std::vector<uint64_t> keys(num_candidates);
+  Loop(parallel, 0, num_candidates, [&](uint64_t h) {
+    uint32_t* begin = scratch->data() + bounds[h];
+    uint32_t* end = begin + (*counts)[h];
+    std::sort(begin, end);
+    end = std::unique(begin, end);
+    (*counts)[h] = end - begin;
+    keys[h] = (*counts)[h];
+    for (uint32_t* it = begin; it != end; ++it) {
+      keys[h] = (keys[h] ^ Hash(*it)) * 0x9e3779b97f4a7c15;
+    }
+  });
+
+  // Candidates with equal pins have equal keys, so they are next to each
+  // other in key order
+  std::vector<uint32_t> order(num_candidates);
+  std::iota(order.begin(), order.end(), 0);
+  auto by_key = [&](uint32_t a, uint32_t b) {
+    return keys[a] < keys[b] || (keys[a] == keys[b] && a < b);
+  };
+  if (parallel) {
+    katana::ParallelSTL::sort(order.begin(), order.end(), by_key);
+  } else {
+    std::sort(order.begin(), order.end(), by_key);
+  }
+  std::vector<uint32_t> representatives(num_candidates);
+  std::vector<uint32_t> merged_weights(weights);
+  auto same_pins = [&](uint32_t a, uint32_t b) {
+    return (*counts)[a] == (*counts)[b] &&
+           std::equal(
+               scratch->data() + bounds[a],
+               scratch->data() + bounds[a] + (*counts)[a],
+               scratch->data() + bounds[b]);
+  };
+  Loop(parallel, 0, num_candidates, [&](uint64_t i) {
+    if (i > 0 && keys[order[i - 1]] == keys[order[i]]) {
+      return;
+    }
+    uint64_t end = i + 1;
+    while (end < num_candidates && keys[order[end]] == keys[order[i]]) {
+      ++end;
+    }
+    for (uint64_t a = i; a < end; ++a) {
+      representatives[order[a]] = order[a];
+      if ((*counts)[order[a]] < 2) {
+        continue;
+      }
+      for (uint64_t b = i; b < a; ++b) {
+        if (representatives[order[b]] == order[b] &&
+            same_pins(order[b], order[a])) {
+          representatives[order[a]] = order[b];
+          merged_weights[order[b]] += weights[order[a]];
+          break;
+        }
+      }
+    }
+  });
+
+  // ids[h] is the hyperedge of candidate h, if it is kept
+  std::vector<uint32_t> ids(num_candidates + 1);
+  ids[0] = 0;
+  Loop(parallel, 0, num_candidates, [&](uint64_t h) {
+    ids[h + 1] = (*counts)[h] >= 2 && representatives[h] == h;
+  });
+  PrefixSum(parallel, ids.data() + 1, ids.data() + ids.size());
+  const uint32_t num_hedges = ids[num_candidates];
+
+  graph->hedge_weights.resize(num_hedges);
+  graph->pin_offsets.resize(num_hedges + 1);
+  graph->pin_offsets[0] = 0;
+  Loop(parallel, 0, num_candidates, [&](uint64_t h) {
+    if (ids[h] != ids[h + 1]) {
+      graph->pin_offsets[ids[h] + 1] = (*counts)[h];
+      graph->hedge_weights[ids[h]] = merged_weights[h];
+    }
+  });
+  PrefixSum(
+      parallel, graph->pin_offsets.data() + 1,
+      graph->pin_offsets.data() + graph->pin_offsets.size());
+  graph->pins.resize(graph->pin_offsets[num_hedges]);
+  Loop(parallel, 0, num_candidates, [&](uint64_t h) {
+    if (ids[h] != ids[h + 1]) {
+      std::copy_n(
+          scratch->data() + bounds[h], (*counts)[h],
+          graph->pins.data() + graph->pin_offsets[ids[h]]);
+    }
+  });
+}
+
+/// Build the incidence lists of graph, the transpose of its pins
+void
+BuildIncidence(bool parallel, Hypergraph* graph) {
+  const uint32_t num_nodes = graph->num_nodes();
+  std::vector<std::atomic<uint64_t>> cursors(num_nodes);
+  Loop(parallel, 0, graph->num_hedges(), [&](uint64_t h) {
+    for (uint64_t i = graph->pin_offsets[h]; i < graph->pin_offsets[h + 1];
+         ++i) {
+      cursors[graph->pins[i]].fetch_add(1, std::memory_order_relaxed);
+    }
+  });
+  graph->incidence_offsets.resize(num_nodes + 1);
+  graph->incidence_offsets[0] = 0;
+  Loop(parallel, 0, num_nodes, [&](uint64_t n) {
+    graph->incidence_offsets[n + 1] = cursors[n].load();
+  });
+  PrefixSum(
+      parallel, graph->incidence_offsets.data() + 1,
+      graph->incidence_offsets.data() + graph->incidence_offsets.size());
+  Loop(parallel, 0, num_nodes, [&](uint64_t n) {
+    cursors[n].store(graph->incidence_offsets[n]);
+  });
+
+  graph->incidence.resize(graph->pins.size());
+  Loop(parallel, 0, graph->num_hedges(), [&](uint64_t h) {
+    for (uint64_t i = graph->pin_offsets[h]; i < graph->pin_offsets[h + 1];
+         ++i) {
+      uint64_t slot =
+          cursors[graph->pins[i]].fetch_add(1, std::memory_order_relaxed);
+      graph->incidence[slot] = h;
+    }
+  });
+  Loop(parallel, 0, num_nodes, [&](uint64_t n) {
+    std::sort(
+        graph->incidence.begin() + graph->incidence_offsets[n],
+        graph->incidence.begin() + graph->incidence_offsets[n + 1]);
+  });
+}
+
+/// The hypergraph of view whose hyperedges are the nodes with is_hedge set
+/// and whose pins are their other neighbors, with unit weights. node_ids
+/// gets the hypergraph node of each node of view that is not a hyperedge.
+template <typename View>
+void
+BuildHypergraph(
+    const View& view, const katana::NUMAArray<uint8_t>& is_hedge,
+    std::vector<uint32_t>* node_ids, Hypergraph* graph) {
+  const uint64_t num_nodes = view.num_nodes();
+  // Exclusive prefix counts of hyperedges and of other nodes
+  std::vector<uint32_t> hedge_ids(num_nodes + 1);
+  node_ids->resize(num_nodes + 1);
+  hedge_ids[0] = 0;
+  (*node_ids)[0] = 0;
+  Loop(true, 0, num_nodes, [&](uint64_t n) {
+    hedge_ids[n + 1] = is_hedge[n];
+    (*node_ids)[n + 1] = !is_hedge[n];
+  });
+  PrefixSum(true, hedge_ids.data() + 1, hedge_ids.data() + hedge_ids.size());
+  PrefixSum(
+      true, node_ids->data() + 1, node_ids->data() + node_ids->size());
+  const uint32_t num_candidates = hedge_ids[num_nodes];
+
+  std::vector<uint64_t> bounds(num_candidates + 1);
+  bounds[0] = 0;
+  Loop(true, 0, num_nodes, [&](uint64_t n) {
+    if (is_hedge[n]) {
+      bounds[hedge_ids[n] + 1] = view.edges(n).size() + view.in_edges(n).size();
+    }
+  });
+  PrefixSum(true, bounds.data() + 1, bounds.data() + bounds.size());
+
+  std::vector<uint32_t> scratch(bounds[num_candidates]);
+  std::vector<uint64_t> counts(num_candidates);
+  Loop(true, 0, num_nodes, [&](uint64_t n) {
+    if (!is_hedge[n]) {
+      return;
+    }
+    uint32_t h = hedge_ids[n];
+    uint32_t* out = scratch.data() + bounds[h];
+    for (auto e : view.edges(n)) {
+      uint64_t dest = view.edge_dest(e);
+      if (!is_hedge[dest]) {
+        *out++ = (*node_ids)[dest];
+      }
+    }
+    for (auto e : view.in_edges(n)) {
+      uint64_t dest = view.in_edge_dest(e);
+      if (!is_hedge[dest]) {
+        *out++ = (*node_ids)[dest];
+      }
+    }
+    counts[h] = out - (scratch.data() + bounds[h]);
+  });
+  std::vector<uint32_t> weights(num_candidates, 1);
+  CompactPins(true, bounds, weights, &counts, &scratch, graph);
+
+  graph->node_weights.assign(num_nodes - num_candidates, 1);
+  graph->total_weight = num_nodes - num_candidates;
+  BuildIncidence(true, graph);
+}
+
+/// Contract fine into coarse by merging nodes that share a hyperedge: each
+/// node picks the incident hyperedge with the most weight per pin, ties
+/// broken by a hash of the hyperedge and seed, and the nodes that pick the
+/// same hyperedge are merged in order into groups of at most
+/// max_node_weight. Hyperedges within a group vanish and hyperedges with the
+/// same pins are kept separately. coarse_ids gets the coarse node of each
+/// fine node. This does not depend on the schedule.
+void
+Coarsen(
+    bool parallel, const Hypergraph& fine, uint64_t max_node_weight,
+    uint32_t seed, Hypergraph* coarse, std::vector<uint32_t>* coarse_ids) {
+  const uint32_t num_fine = fine.num_nodes();
+  std::vector<uint32_t> choice(num_fine);
+  Loop(parallel, 0, num_fine, [&](uint64_t n) {
+    uint32_t best = kNone;
+    double best_score = 0;
+    for (uint64_t i = fine.incidence_offsets[n];
+         i < fine.incidence_offsets[n + 1]; ++i) {
+      uint32_t h = fine.incidence[i];
+      double score = static_cast<double>(fine.hedge_weights[h]) /
+                     (fine.pin_offsets[h + 1] - fine.pin_offsets[h] - 1);
+      if (best == kNone || score > best_score ||
+          (score == best_score && Hash(h ^ seed) > Hash(best ^ seed))) {
+        best = h;
+        best_score = score;
+      }
+    }
+    choice[n] = best;
+  });
+
+  // Each node is grouped by the one hyperedge it picked, so the groups of
+  // different hyperedges are formed independently
+  std::vector<uint32_t> leaders(num_fine);
+  std::vector<uint64_t> group_weights(num_fine);
+  Loop(parallel, 0, num_fine, [&](uint64_t n) {
+    leaders[n] = n;
+    group_weights[n] = fine.node_weights[n];
+  });
+  Loop(parallel, 0, fine.num_hedges(), [&](uint64_t h) {
+    uint32_t leader = kNone;
+    for (uint64_t i = fine.pin_offsets[h]; i < fine.pin_offsets[h + 1]; ++i) {
+      uint32_t n = fine.pins[i];
+      if (choice[n] != h) {
+        continue;
+      }
+      if (leader == kNone ||
+          group_weights[leader] + fine.node_weights[n] > max_node_weight) {
+        leader = n;
+        continue;
+      }
+      leaders[n] = leader;
+      group_weights[leader] += fine.node_weights[n];
+    }
+  });
+
+  // Nodes left alone join the lightest group of a neighbor with room for
+  // them, by the group weights before any joins
+  auto alone = [&](uint32_t n) {
+    return leaders[n] == n && group_weights[n] == fine.node_weights[n];
+  };
+  std::vector<uint32_t> joined(num_fine);
+  Loop(parallel, 0, num_fine, [&](uint64_t n) {
+    joined[n] = leaders[n];
+    if (!alone(n)) {
+      return;
+    }
+    for (uint64_t i = fine.incidence_offsets[n];
+         i < fine.incidence_offsets[n + 1]; ++i) {
+      uint32_t h = fine.incidence[i];
+      for (uint64_t j = fine.pin_offsets[h]; j < fine.pin_offsets[h + 1];
+           ++j) {
+        uint32_t leader = leaders[fine.pins[j]];
+        if (alone(leader) ||
+            group_weights[leader] + fine.node_weights[n] > max_node_weight) {
+          continue;
+        }
+        if (joined[n] == n ||
+            group_weights[leader] < group_weights[joined[n]] ||
+            (group_weights[leader] == group_weights[joined[n]] &&
+             leader < joined[n])) {
+          joined[n] = leader;
+        }
+      }
+    }
+  });
+
+  std::vector<uint32_t> ids(num_fine + 1);
+  ids[0] = 0;
+  Loop(parallel, 0, num_fine, [&](uint64_t n) {
+    ids[n + 1] = joined[n] == n;
+  });
+  PrefixSum(parallel, ids.data() + 1, ids.data() + ids.size());
+  const uint32_t num_coarse = ids[num_fine];
+  coarse_ids->resize(num_fine);
+  std::vector<std::atomic<uint64_t>> coarse_weights(num_coarse);
+  Loop(parallel, 0, num_fine, [&](uint64_t n) {
+    (*coarse_ids)[n] = ids[joined[n]];
+    coarse_weights[ids[joined[n]]].fetch_add(
+        fine.node_weights[n], std::memory_order_relaxed);
+  });
+  coarse->node_weights.resize(num_coarse);
+  Loop(parallel, 0, num_coarse, [&](uint64_t c) {
+    coarse->node_weights[c] = coarse_weights[c].load();
+  });
+  coarse->total_weight = fine.total_weight;
+
+  std::vector<uint32_t> scratch(fine.pins.size());
+  std::vector<uint64_t> counts(fine.num_hedges());
+  Loop(parallel, 0, fine.num_hedges(), [&](uint64_t h) {
+    for (uint64_t i = fine.pin_offsets[h]; i < fine.pin_offsets[h + 1]; ++i) {
+      scratch[i] = (*coarse_ids)[fine.pins[i]];
+    }
+    counts[h] = fine.pin_offsets[h + 1] - fine.pin_offsets[h];
+  });
+  CompactPins(
+      parallel, fine.pin_offsets, fine.hedge_weights, &counts, &scratch,
+      coarse);
+  BuildIncidence(parallel, coarse);
+}
+
+/// The weight of the hyperedges of graph with pins on both sides
+uint64_t
+CountSides(
+    bool parallel, const Hypergraph& graph, const std::vector<uint8_t>& sides,
+    std::vector<std::array<uint32_t, 2>>* side_pins) {
+  side_pins->resize(graph.num_hedges());
+  return Sum(parallel, 0, graph.num_hedges(), [&](uint64_t h) -> uint64_t {
+    std::array<uint32_t, 2>& count = (*side_pins)[h];
+    count = {0, 0};
+    for (uint64_t i = graph.pin_offsets[h]; i < graph.pin_offsets[h + 1];
+         ++i) {
+      ++count[sides[graph.pins[i]]];
+    }
+    return count[0] > 0 && count[1] > 0 ? graph.hedge_weights[h] : 0;
+  });
+}
+
+/// Greedy bisection refinement. In each round, the gain in cut weight of
+/// moving each node to the other side is computed in parallel, and the nodes
+/// with positive gain, or on a side heavier than its maximum weight, move in
+/// order of gain while both sides stay within max_weights. Moves computed
+/// together may interact, so a round that increases the cut without
+/// restoring balance is undone. Returns the cut weight.
+uint64_t
+RefineBisection(
+    bool parallel, const Hypergraph& graph,
+    const std::array<uint64_t, 2>& max_weights, uint32_t refinement_rounds,
+    std::vector<uint8_t>* sides) {
+  const uint32_t num_nodes = graph.num_nodes();
+  std::vector<std::array<uint32_t, 2>> side_pins;
+  uint64_t cut = CountSides(parallel, graph, *sides, &side_pins);
+  std::array<uint64_t, 2> weights;
+  weights[1] = Sum(parallel, 0, num_nodes, [&](uint64_t n) -> uint64_t {
+    return (*sides)[n] ? graph.node_weights[n] : 0;
+  });
+  weights[0] = graph.total_weight - weights[1];
+
+  std::vector<int64_t> gains(num_nodes);
+  std::vector<uint32_t> ranks(num_nodes + 1);
+  std::vector<uint32_t> candidates;
+  std::vector<uint8_t> previous;
+  for (uint32_t round = 0; round < refinement_rounds; ++round) {
+    bool balanced =
+        weights[0] <= max_weights[0] && weights[1] <= max_weights[1];
+    ranks[0] = 0;
+    Loop(parallel, 0, num_nodes, [&](uint64_t n) {
+      uint8_t from = (*sides)[n];
+      int64_t gain = 0;
+      for (uint64_t i = graph.incidence_offsets[n];
+           i < graph.incidence_offsets[n + 1]; ++i) {
+        uint32_t h = graph.incidence[i];
+        if (side_pins[h][from] == 1) {
+          gain += graph.hedge_weights[h];
+        }
+        if (side_pins[h][1 - from] == 0) {
+          gain -= graph.hedge_weights[h];
+        }
+      }
+      gains[n] = gain;
+      ranks[n + 1] = gain > 0 || weights[from] > max_weights[from];
+    });
+    PrefixSum(parallel, ranks.data() + 1, ranks.data() + ranks.size());
+    candidates.resize(ranks[num_nodes]);
+    if (candidates.empty()) {
+      break;
+    }
+    Loop(parallel, 0, num_nodes, [&](uint64_t n) {
+      if (ranks[n] != ranks[n + 1]) {
+        candidates[ranks[n]] = n;
+      }
+    });
+    auto by_gain = [&](uint32_t a, uint32_t b) {
+      return gains[a] > gains[b] || (gains[a] == gains[b] && a < b);
+    };
+    if (parallel) {
+      katana::ParallelSTL::sort(candidates.begin(), candidates.end(), by_gain);
+    } else {
+      std::sort(candidates.begin(), candidates.end(), by_gain);
+    }
+
+    previous = *sides;
+    std::array<uint64_t, 2> previous_weights = weights;
+    uint64_t num_moves = 0;
+    for (uint32_t n : candidates) {
+      uint8_t from = (*sides)[n];
+      uint64_t weight = graph.node_weights[n];
+      if ((gains[n] <= 0 && weights[from] <= max_weights[from]) ||
+          weights[1 - from] + weight > max_weights[1 - from]) {
+        continue;
+      }
+      (*sides)[n] = 1 - from;
+      weights[from] -= weight;
+      weights[1 - from] += weight;
+      ++num_moves;
+    }
+    if (num_moves == 0) {
+      break;
+    }
+    uint64_t next_cut = CountSides(parallel, graph, *sides, &side_pins);
+    if (balanced && next_cut >= cut) {
+      if (next_cut > cut) {
+        *sides = std::move(previous);
+        weights = previous_weights;
+        CountSides(parallel, graph, *sides, &side_pins);
+      }
+      break;
+    }
+    cut = next_cut;
+  }
+  return cut;
+}
+
+/// Greedy hypergraph growing: side 0 grows from seed, adding the node with
+/// the most hyperedge weight connecting it to side 0, until it has at least
+/// target weight. The rest of the nodes are side 1.
+void
+GrowBisection(
+    const Hypergraph& graph, uint64_t target, uint32_t seed,
+    std::vector<uint8_t>* sides) {
+  const uint32_t num_nodes = graph.num_nodes();
+  sides->assign(num_nodes, 1);
+  std::vector<uint64_t> gains(num_nodes);
+  std::vector<uint8_t> reached(graph.num_hedges());
+  std::priority_queue<std::pair<uint64_t, uint32_t>> frontier;
+
+  uint64_t weight = 0;
+  uint32_t next_seed = 0;
+  while (weight < target) {
+    uint32_t n = kNone;
+    while (!frontier.empty()) {
+      auto [gain, candidate] = frontier.top();
+      frontier.pop();
+      if ((*sides)[candidate] == 1 && gains[candidate] == gain) {
+        n = candidate;
+        break;
+      }
+    }
+    if (n == kNone) {
+      // Start at the next node from seed on side 1, e.g., in another
+      // component
+      while (next_seed < num_nodes &&
+             (*sides)[(seed + next_seed) % num_nodes] == 0) {
+        ++next_seed;
+      }
+      if (next_seed == num_nodes) {
+        break;
+      }
+      n = (seed + next_seed) % num_nodes;
+    }
+
+    (*sides)[n] = 0;
+    weight += graph.node_weights[n];
+    for (uint64_t i = graph.incidence_offsets[n];
+         i < graph.incidence_offsets[n + 1]; ++i) {
+      uint32_t h = graph.incidence[i];
+      if (reached[h]) {
+        continue;
+      }
+      reached[h] = 1;
+      for (uint64_t j = graph.pin_offsets[h]; j < graph.pin_offsets[h + 1];
+           ++j) {
+        uint32_t pin = graph.pins[j];
+        if ((*sides)[pin] == 1) {
+          gains[pin] += graph.hedge_weights[h];
+          frontier.emplace(gains[pin], pin);
+        }
+      }
+    }
+  }
+}
+
+/// Multilevel bisection of graph into a side 0 of about target0 weight and
+/// a side 1 with the rest, each of at most max_weights
+std::vector<uint8_t>
+Bisect(
+    bool parallel, const Hypergraph& graph, uint64_t target0,
+    const std::array<uint64_t, 2>& max_weights,
+    const HypergraphPartitionPlan& plan, uint32_t seed) {
+  // levels[l] is coarsened from levels[l - 1], or from graph for l = 0, and
+  // coarse_ids[l] maps that finer level to levels[l]
+  std::vector<Hypergraph> levels;
+  std::vector<std::vector<uint32_t>> coarse_ids;
+  auto level = [&](size_t l) -> const Hypergraph& {
+    return l == 0 ? graph : levels[l - 1];
+  };
+
+  const uint64_t coarsest_nodes =
+      2 * uint64_t{std::max<uint32_t>(plan.coarsest_nodes_per_partition(), 1)};
+  const uint64_t max_node_weight =
+      std::max<uint64_t>(2, 1.5 * graph.total_weight / coarsest_nodes);
+  while (level(levels.size()).num_nodes() > coarsest_nodes &&
+         levels.size() < kMaxLevels) {
+    const Hypergraph& fine = level(levels.size());
+    Hypergraph coarse;
+    std::vector<uint32_t> ids;
+    Coarsen(
+        parallel, fine, max_node_weight, Hash(seed + levels.size()), &coarse,
+        &ids);
+    bool stalled =
+        coarse.num_nodes() > kMinCoarseningRatio * fine.num_nodes();
+    levels.emplace_back(std::move(coarse));
+    coarse_ids.emplace_back(std::move(ids));
+    if (stalled) {
+      break;
+    }
+  }
+
+  // Keep the best of a few growings of the coarsest level, preferring
+  // balance to cut
+  const Hypergraph& coarsest = level(levels.size());
+  std::vector<uint8_t> sides;
+  uint64_t best_excess = 0;
+  uint64_t best_cut = 0;
+  for (uint32_t attempt = 0; attempt < kInitialTries; ++attempt) {
+    std::vector<uint8_t> attempt_sides;
+    uint32_t start =
+        coarsest.num_nodes() > 0 ? Hash(seed ^ attempt) % coarsest.num_nodes()
+                                 : 0;
+    GrowBisection(coarsest, target0, start, &attempt_sides);
+    uint64_t cut = RefineBisection(
+        false, coarsest, max_weights, plan.refinement_rounds(),
+        &attempt_sides);
+    uint64_t weight1 = 0;
+    for (uint32_t n = 0; n < coarsest.num_nodes(); ++n) {
+      weight1 += attempt_sides[n] ? coarsest.node_weights[n] : 0;
+    }
+    uint64_t weight0 = coarsest.total_weight - weight1;
+    uint64_t excess = (weight0 > max_weights[0] ? weight0 - max_weights[0]
+                                                : 0) +
+                      (weight1 > max_weights[1] ? weight1 - max_weights[1]
+                                                : 0);
+    if (attempt == 0 || excess < best_excess ||
+        (excess == best_excess && cut < best_cut)) {
+      sides = std::move(attempt_sides);
+      best_excess = excess;
+      best_cut = cut;
+    }
+  }
+
+  for (size_t l = levels.size(); l-- > 0;) {
+    // Project the bisection of levels[l] to the level it was coarsened from
+    const Hypergraph& fine = level(l);
+    const std::vector<uint32_t>& ids = coarse_ids[l];
+    std::vector<uint8_t> fine_sides(fine.num_nodes());
+    Loop(parallel, 0, fine.num_nodes(), [&](uint64_t n) {
+      fine_sides[n] = sides[ids[n]];
+    });
+    sides = std::move(fine_sides);
+    levels[l] = Hypergraph();
+    RefineBisection(
+        parallel, fine, max_weights, plan.refinement_rounds(), &sides);
+  }
+  return sides;
+}
+
+/// A part of the hypergraph that is split into num_parts partitions
+/// starting at first_part
+struct Subproblem {
+  std::shared_ptr<const Hypergraph> graph;
+  /// The node of the whole hypergraph of each node of graph
+  std::vector<uint32_t> nodes;
+  uint32_t first_part{0};
+  uint32_t num_parts{0};
+
+  uint64_t num_pins() const { return graph->pins.size(); }
+};
+
+/// The subproblem of the nodes on side of parent, with each hyperedge
+/// restricted to its pins on that side
+Subproblem
+Extract(
+    bool parallel, const Subproblem& parent,
+    const std::vector<uint8_t>& sides, uint8_t side, uint32_t first_part,
+    uint32_t num_parts) {
+  const Hypergraph& graph = *parent.graph;
+  const uint32_t num_nodes = graph.num_nodes();
+  std::vector<uint32_t> ids(num_nodes + 1);
+  ids[0] = 0;
+  Loop(parallel, 0, num_nodes, [&](uint64_t n) {
+    ids[n + 1] = sides[n] == side;
+  });
+  PrefixSum(parallel, ids.data() + 1, ids.data() + ids.size());
+
+  auto child = std::make_shared<Hypergraph>();
+  Subproblem sub{nullptr, {}, first_part, num_parts};
+  sub.nodes.resize(ids[num_nodes]);
+  child->node_weights.resize(ids[num_nodes]);
+  Loop(parallel, 0, num_nodes, [&](uint64_t n) {
+    if (sides[n] == side) {
+      sub.nodes[ids[n]] = parent.nodes[n];
+      child->node_weights[ids[n]] = graph.node_weights[n];
+    }
+  });
+  child->total_weight =
+      Sum(parallel, 0, child->num_nodes(), [&](uint64_t n) -> uint64_t {
+        return child->node_weights[n];
+      });
+
+  std::vector<uint32_t> scratch(graph.pins.size());
+  std::vector<uint64_t> counts(graph.num_hedges());
+  Loop(parallel, 0, graph.num_hedges(), [&](uint64_t h) {
+    uint32_t* out = scratch.data() + graph.pin_offsets[h];
+    for (uint64_t i = graph.pin_offsets[h]; i < graph.pin_offsets[h + 1];
+         ++i) {
+      if (sides[graph.pins[i]] == side) {
+        *out++ = ids[graph.pins[i]];
+      }
+    }
+    counts[h] = out - (scratch.data() + graph.pin_offsets[h]);
+  });
+  CompactPins(
+      parallel, graph.pin_offsets, graph.hedge_weights, &counts, &scratch,
+      child.get());
+  BuildIncidence(parallel, child.get());
+  sub.graph = std::move(child);
+  return sub;
+}
+
+/// Assign the nodes of sub to its partition if it has one, and otherwise
+/// bisect it, the first half for the first ceil(num_parts / 2) partitions,
+/// and add the halves to children
+void
+Split(
+    bool parallel, const Subproblem& sub, double imbalance,
+    const HypergraphPartitionPlan& plan, std::vector<uint32_t>* parts,
+    std::vector<Subproblem>* children) {
+  if (sub.num_parts == 1) {
+    Loop(parallel, 0, sub.nodes.size(), [&](uint64_t n) {
+      (*parts)[sub.nodes[n]] = sub.first_part;
+    });
+    return;
+  }
+  const uint32_t parts0 = (sub.num_parts + 1) / 2;
+  const double total = sub.graph->total_weight;
+  const double share0 = total * parts0 / sub.num_parts;
+  const std::array<uint64_t, 2> max_weights{
+      static_cast<uint64_t>(std::ceil((1.0 + imbalance) * share0)),
+      static_cast<uint64_t>(std::ceil((1.0 + imbalance) * (total - share0)))};
+  std::vector<uint8_t> sides = Bisect(
+      parallel, *sub.graph, std::llround(share0), max_weights, plan,
+      Hash(sub.first_part));
+  children->emplace_back(
+      Extract(parallel, sub, sides, 0, sub.first_part, parts0));
+  children->emplace_back(Extract(
+      parallel, sub, sides, 1, sub.first_part + parts0,
+      sub.num_parts - parts0));
+}
+
+/// The partition of each node of graph by recursive bisection. Each level of
+/// the recursion is balanced within imbalance' such that
+/// (1 + imbalance')^depth = 1 + imbalance. The subproblems of a level are
+/// independent: those with at least a thread's share of the pins are
+/// bisected with parallel loops, one after another, and the rest run
+/// concurrently, each serially on one thread.
+std::vector<uint32_t>
+RecursiveBisection(
+    std::shared_ptr<const Hypergraph> graph, uint32_t num_partitions,
+    const HypergraphPartitionPlan& plan) {
+  std::vector<uint32_t> parts(graph->num_nodes());
+  const double depth = std::max(1.0, std::ceil(std::log2(num_partitions)));
+  const double imbalance = std::pow(1.0 + plan.imbalance(), 1.0 / depth) - 1.0;
+
+  std::vector<uint32_t> identity(graph->num_nodes());
+  std::iota(identity.begin(), identity.end(), 0);
+  std::vector<Subproblem> current;
+  current.emplace_back(
+      Subproblem{std::move(graph), std::move(identity), 0, num_partitions});
+  uint64_t num_levels = 0;
+  while (!current.empty()) {
+    const uint64_t total_pins = std::accumulate(
+        current.begin(), current.end(), uint64_t{0},
+        [](uint64_t sum, const Subproblem& sub) {
+          return sum + sub.num_pins();
+        });
+    const uint64_t num_threads = katana::getActiveThreads();
+    std::vector<std::vector<Subproblem>> children(current.size());
+    std::vector<uint32_t> concurrent;
+    for (uint32_t i = 0; i < current.size(); ++i) {
+      uint64_t pins = current[i].num_pins();
+      if (pins >= kMinParallelPins && pins * num_threads >= total_pins) {
+        Split(true, current[i], imbalance, plan, &parts, &children[i]);
+      } else {
+        concurrent.emplace_back(i);
+      }
+    }
+    katana::do_all(
+        katana::iterate(concurrent),
+        [&](uint32_t i) {
+          Split(false, current[i], imbalance, plan, &parts, &children[i]);
+        },
+        katana::steal(), katana::chunk_size<1>(), katana::no_stats(),
+        katana::loopname("HypergraphPartition-Subproblems"));
+
+    std::vector<Subproblem> next;
+    for (auto& halves : children) {
+      for (auto& sub : halves) {
+        next.emplace_back(std::move(sub));
+      }
+    }
+    current = std::move(next);
+    ++num_levels;
+  }
+  katana::ReportStatSingle("HypergraphPartition", "Levels", num_levels);
+  return parts;
+}
+
+/// Tries to add weight to a partition without exceeding max_weight
+bool
+TryAdd(
+    std::atomic<uint64_t>* part_weight, uint64_t weight, uint64_t max_weight) {
+  uint64_t current = part_weight->load(std::memory_order_relaxed);
+  do {
+    if (current + weight > max_weight) {
+      return false;
+    }
+  } while (!part_weight->compare_exchange_weak(
+      current, current + weight, std::memory_order_relaxed));
+  return true;
+}
+
+/// The sum of the weights of the hyperedges of a node that have pins in
+/// each partition
+class Connectivity {
+public:
+  explicit Connectivity(uint32_t num_partitions) : weights_(num_partitions) {}
+
+  void Clear() {
+    for (uint32_t p : touched_) {
+      weights_[p] = 0;
+    }
+    touched_.clear();
+  }
+
+  void Add(uint32_t p, uint64_t weight) {
+    if (weights_[p] == 0) {
+      touched_.emplace_back(p);
+    }
+    weights_[p] += weight;
+  }
+
+  uint64_t weight(uint32_t p) const { return weights_[p]; }
+
+  const std::vector<uint32_t>& touched() const { return touched_; }
+
+private:
+  std::vector<uint64_t> weights_;
+  std::vector<uint32_t> touched_;
+};
+
+/// Direct k-way refinement. Each round starts by computing the pins of each
+/// hyperedge in each partition as sorted runs of (partition, count); then
+/// each node moves to the partition that most reduces the connectivity cut,
+/// or that keeps it and is lighter, if the partition stays within
+/// max_weight. Alternate rounds only move nodes to partitions with larger or
+/// smaller IDs, and a round that increases the cut is undone.
+void
+RefineKWay(
+    const Hypergraph& graph, uint32_t num_partitions, uint64_t max_weight,
+    uint32_t refinement_rounds, std::vector<uint32_t>* parts) {
+  const uint32_t num_nodes = graph.num_nodes();
+  katana::NUMAArray<std::atomic<uint64_t>> part_weights;
+  part_weights.allocateBlocked(num_partitions);
+  auto compute_weights = [&]() {
+    katana::do_all(
+        katana::iterate(uint32_t{0}, num_partitions),
+        [&](uint32_t p) { part_weights[p].store(0); }, katana::no_stats());
+    katana::do_all(
+        katana::iterate(uint32_t{0}, num_nodes),
+        [&](uint32_t n) {
+          part_weights[(*parts)[n]].fetch_add(
+              graph.node_weights[n], std::memory_order_relaxed);
+        },
+        katana::no_stats());
+  };
+  compute_weights();
+
+  // The runs of hyperedge h are runs[pin_offsets[h]] to run_ends[h], each a
+  // partition in the high half and a count in the low half
+  std::vector<uint64_t> runs(graph.pins.size());
+  std::vector<uint64_t> run_ends(graph.num_hedges());
+  auto compute_runs = [&]() {
+    return Sum(true, 0, graph.num_hedges(), [&](uint64_t h) -> uint64_t {
+      uint64_t* begin = runs.data() + graph.pin_offsets[h];
+      uint64_t* end = runs.data() + graph.pin_offsets[h + 1];
+      for (uint64_t i = graph.pin_offsets[h]; i < graph.pin_offsets[h + 1];
+           ++i) {
+        runs[i] = (uint64_t{(*parts)[graph.pins[i]]} << 32) | 1;
+      }
+      std::sort(begin, end);
+      uint64_t* out = begin;
+      for (uint64_t* it = begin; it != end; ++it) {
+        if (out != begin && ((*(out - 1)) >> 32) == (*it >> 32)) {
+          *(out - 1) += 1;
+        } else {
+          *out++ = *it;
+        }
+      }
+      run_ends[h] = out - runs.data();
+      return uint64_t{graph.hedge_weights[h]} * ((out - begin) - 1);
+    });
+  };
+
+  katana::PerThreadStorage<Connectivity> connectivity(num_partitions);
+  std::vector<uint32_t> previous = *parts;
+  uint64_t cut = compute_runs();
+  uint32_t idle_rounds = 0;
+  for (uint32_t round = 0; round < 2 * refinement_rounds && idle_rounds < 2;
+       ++round) {
+    bool upward = round % 2 == 0;
+    katana::GAccumulator<uint64_t> num_moves;
+    katana::do_all(
+        katana::iterate(uint32_t{0}, num_nodes),
+        [&](uint32_t n) {
+          uint32_t from = (*parts)[n];
+          Connectivity& c = *connectivity.getLocal();
+          c.Clear();
+          // The weight of the hyperedges that n alone keeps in from
+          int64_t removal = 0;
+          int64_t total = 0;
+          for (uint64_t i = graph.incidence_offsets[n];
+               i < graph.incidence_offsets[n + 1]; ++i) {
+            uint32_t h = graph.incidence[i];
+            uint64_t weight = graph.hedge_weights[h];
+            total += weight;
+            for (uint64_t r = graph.pin_offsets[h]; r < run_ends[h]; ++r) {
+              uint32_t p = runs[r] >> 32;
+              if (p != from) {
+                c.Add(p, weight);
+              } else if ((runs[r] & 0xffffffff) == 1) {
+                removal += weight;
+              }
+            }
+          }
+          uint64_t weight = graph.node_weights[n];
+          uint32_t to = kNone;
+          int64_t best_gain = 0;
+          for (uint32_t p : c.touched()) {
+            if ((p > from) != upward) {
+              continue;
+            }
+            int64_t gain =
+                removal + static_cast<int64_t>(c.weight(p)) - total;
+            if (gain < best_gain || (gain == best_gain && to != kNone)) {
+              continue;
+            }
+            if (gain == 0 &&
+                part_weights[p].load(std::memory_order_relaxed) + weight >=
+                    part_weights[from].load(std::memory_order_relaxed)) {
+              continue;
+            }
+            to = p;
+            best_gain = gain;
+          }
+          if (to == kNone || !TryAdd(&part_weights[to], weight, max_weight)) {
+            return;
+          }
+          (*parts)[n] = to;
+          part_weights[from].fetch_sub(weight, std::memory_order_relaxed);
+          num_moves += 1;
+        },
+        katana::steal(), katana::no_stats(),
+        katana::loopname("HypergraphPartition-RefineKWay"));
+
+    uint64_t next_cut = compute_runs();
+    if (next_cut > cut) {
+      *parts = previous;
+      compute_weights();
+      compute_runs();
+      break;
+    }
+    idle_rounds =
+        num_moves.reduce() == 0 || next_cut == cut ? idle_rounds + 1 : 0;
+    cut = next_cut;
+    previous = *parts;
+  }
+}
+
+katana::Result<katana::NUMAArray<uint8_t>>
+ReadHyperedges(
+    katana::PropertyGraph* pg, const std::string& hyperedge_node_type_name) {
+  if (!pg->HasAtomicNodeType(hyperedge_node_type_name)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotFound, "no atomic node type named {}",
+        hyperedge_node_type_name);
+  }
+  katana::EntityTypeID hyperedge_type =
+      pg->GetNodeEntityTypeID(hyperedge_node_type_name);
+  katana::NUMAArray<uint8_t> is_hedge;
+  is_hedge.allocateBlocked(pg->num_nodes());
+  katana::do_all(
+      katana::iterate(pg->topology().all_nodes()),
+      [&](auto n) { is_hedge[n] = pg->DoesNodeHaveType(n, hyperedge_type); },
+      katana::no_stats());
+  return katana::Result<katana::NUMAArray<uint8_t>>(std::move(is_hedge));
+}
+
+katana::Result<void>
+WriteParts(
+    katana::PropertyGraph* pg, const katana::NUMAArray<uint8_t>& is_hedge,
+    const std::vector<uint32_t>& node_ids, const std::vector<uint32_t>& parts,
+    const std::string& output_property_name) {
+  const uint64_t num_nodes = pg->num_nodes();
+  std::shared_ptr<arrow::Buffer> buffer =
+      KATANA_CHECKED(arrow::AllocateBuffer(num_nodes * sizeof(uint32_t)));
+  auto* values = reinterpret_cast<uint32_t*>(buffer->mutable_data());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        values[n] = is_hedge[n] ? kHypergraphPartitionHyperedge
+                                : parts[node_ids[n]];
+      },
+      katana::no_stats());
+  auto array = std::make_shared<arrow::UInt32Array>(num_nodes, buffer);
+  return pg->AddNodeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field(output_property_name, arrow::uint32())}),
+      {array}));
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::HypergraphPartition(
+    katana::PropertyGraph* pg, const std::string& hyperedge_node_type_name,
+    uint32_t num_partitions, const std::string& output_property_name,
+    HypergraphPartitionPlan plan) {
+  if (num_partitions == 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "number of partitions must be positive");
+  }
+  if (!(plan.imbalance() >= 0)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "imbalance must be non-negative, got {}", plan.imbalance());
+  }
+  if (plan.algorithm() != HypergraphPartitionPlan::kRecursiveBisection) {
+    return katana::ErrorCode::InvalidArgument;
+  }
+  auto is_hedge = KATANA_CHECKED(ReadHyperedges(pg, hyperedge_node_type_name));
+
+  auto graph = std::make_shared<Hypergraph>();
+  std::vector<uint32_t> node_ids;
+  {
+    auto view = pg->BuildView<katana::PropertyGraphViews::BiDirectional>();
+    BuildHypergraph(view, is_hedge, &node_ids, graph.get());
+  }
+
+  katana::StatTimer exec_time("HypergraphPartition");
+  exec_time.start();
+  std::vector<uint32_t> parts =
+      RecursiveBisection(graph, num_partitions, plan);
+  const uint64_t max_weight = std::ceil(
+      (1.0 + plan.imbalance()) * graph->total_weight / num_partitions);
+  RefineKWay(
+      *graph, num_partitions, max_weight, plan.refinement_rounds(), &parts);
+  exec_time.stop();
+
+  return WriteParts(pg, is_hedge, node_ids, parts, output_property_name);
+}
+
+void
+katana::analytics::HypergraphPartitionStatistics::Print(
+    std::ostream& os) const {
+  os << "Number of partitions = " << num_partitions << std::endl;
+  os << "Cut hyperedges = " << cut_hyperedges << std::endl;
+  os << "Connectivity cut = " << connectivity_cut << std::endl;
+  os << "Largest partition size = " << largest_partition_size << std::endl;
+  os << "Imbalance = " << imbalance << std::endl;
+}
+
+katana::Result<HypergraphPartitionStatistics>
+katana::analytics::HypergraphPartitionStatistics::Compute(
+    katana::PropertyGraph* pg, const std::string& property_name) {
+  auto property =
+      KATANA_CHECKED(pg->GetNodePropertyTyped<uint32_t>(property_name));
+  auto is_hedge = [&](uint64_t n) {
+    return property->Value(n) == kHypergraphPartitionHyperedge;
+  };
+
+  katana::GReduceMax<uint32_t> max_part;
+  katana::GAccumulator<uint64_t> num_nodes;
+  katana::do_all(
+      katana::iterate(int64_t{0}, property->length()),
+      [&](int64_t i) {
+        if (!is_hedge(i)) {
+          max_part.update(property->Value(i));
+          num_nodes += 1;
+        }
+      },
+      katana::no_stats());
+  uint32_t num_partitions = num_nodes.reduce() > 0 ? max_part.reduce() + 1 : 0;
+
+  katana::NUMAArray<std::atomic<uint64_t>> sizes;
+  sizes.allocateBlocked(num_partitions);
+  katana::do_all(
+      katana::iterate(uint32_t{0}, num_partitions),
+      [&](uint32_t p) { sizes[p].store(0, std::memory_order_relaxed); },
+      katana::no_stats());
+  katana::do_all(
+      katana::iterate(int64_t{0}, property->length()),
+      [&](int64_t i) {
+        if (!is_hedge(i)) {
+          sizes[property->Value(i)].fetch_add(1, std::memory_order_relaxed);
+        }
+      },
+      katana::no_stats());
+  katana::GReduceMax<uint64_t> largest;
+  katana::do_all(
+      katana::iterate(uint32_t{0}, num_partitions),
+      [&](uint32_t p) { largest.update(sizes[p].load()); },
+      katana::no_stats());
+
+  auto view = pg->BuildView<katana::PropertyGraphViews::BiDirectional>();
+  katana::PerThreadStorage<std::vector<uint32_t>> spans;
+  katana::GAccumulator<uint64_t> cut_hyperedges;
+  katana::GAccumulator<uint64_t> connectivity_cut;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, view.num_nodes()),
+      [&](uint64_t n) {
+        if (!is_hedge(n)) {
+          return;
+        }
+        std::vector<uint32_t>& span = *spans.getLocal();
+        span.clear();
+        for (auto e : view.edges(n)) {
+          uint64_t dest = view.edge_dest(e);
+          if (!is_hedge(dest)) {
+            span.emplace_back(property->Value(dest));
+          }
+        }
+        for (auto e : view.in_edges(n)) {
+          uint64_t dest = view.in_edge_dest(e);
+          if (!is_hedge(dest)) {
+            span.emplace_back(property->Value(dest));
+          }
+        }
+        std::sort(span.begin(), span.end());
+        uint64_t num_spanned =
+            std::unique(span.begin(), span.end()) - span.begin();
+        if (num_spanned > 1) {
+          cut_hyperedges += 1;
+          connectivity_cut += num_spanned - 1;
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  double average =
+      num_partitions > 0 ? static_cast<double>(num_nodes.reduce()) /
+                               num_partitions
+                         : 0;
+  return HypergraphPartitionStatistics{
+      num_partitions, cut_hyperedges.reduce(), connectivity_cut.reduce(),
+      largest.reduce(), average > 0 ? largest.reduce() / average : 0};
+}
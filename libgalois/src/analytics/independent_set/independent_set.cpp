@@ -25,7 +25,9 @@
 #include <vector>
 
 #include "katana/Bag.h"
+#include "katana/DynamicBitset.h"
 #include "katana/Galois.h"
+#include "katana/NUMAArray.h"
 #include "katana/ParallelSTL.h"
 #include "katana/Properties.h"
 #include "katana/Reduction.h"
@@ -173,8 +175,6 @@ struct TransactionalAlgo {
   }
 
   void operator()(Graph* graph [[maybe_unused]]) {
-    //    using DWL = katana::Deterministic<>;
-    //
     //    using BSWL = katana::BulkSynchronous<
     //        typename katana::PerSocketChunkFIFO<kChunkSize>>;
 
@@ -182,9 +182,6 @@ struct TransactionalAlgo {
       //    case kNondeterministic:
       //      run<BSWL>(graph);
       //      break;
-      //    case kDeterministicBase:
-      //      run<DWL>(graph);
-      //      break;
     default:
       static_assert(algo == -1, "Unknown algorithm");
     }
@@ -340,7 +337,6 @@ struct PrioAlgo {
   void operator()(Graph* graph) {
     katana::GAccumulator<size_t> rounds;
     katana::GReduceLogicalOr unmatched;
-    katana::PerThreadStorage<std::mt19937*> generator;
 
     float avg_degree = graph->num_edges() / graph->size();
     uint8_t in = ~1;
@@ -435,7 +431,6 @@ struct EdgeTiledPrioAlgo {
   void operator()(Graph* graph) {
     katana::GAccumulator<size_t> rounds;
     katana::GReduceLogicalOr unmatched;
-    katana::PerThreadStorage<std::mt19937*> generator;
     katana::InsertBag<EdgeTile> works;
     constexpr int kEdgeTileSize = 64;
 
@@ -561,6 +556,163 @@ struct EdgeTiledPrioAlgo {
   }
 };
 
+/// Priorities of LubyAlgo for IndependentSetPlan::kLuby. The top bits order
+/// nodes by increasing degree, in powers of two, and the rest by a hash of
+/// the ID.
+struct DegreeHashPriority {
+  template <typename Graph>
+  uint32_t operator()(const Graph& graph, typename Graph::Node n) const {
+    uint64_t degree = graph.edges(n).size();
+    uint32_t degree_bits = 0;
+    for (; degree > 0 && degree_bits < 255; degree >>= 1) {
+      degree_bits++;
+    }
+    return ((255 - degree_bits) << 24) | (hash(n) & 0xffffff);
+  }
+};
+
+/// Priorities of LubyAlgo for IndependentSetPlan::kDeterministic: a hash of
+/// the ID, so nodes are taken in a fixed pseudo-random order. Ordering by ID
+/// alone would take a round per node on a path.
+struct HashPriority {
+  template <typename Graph>
+  uint32_t operator()(const Graph&, typename Graph::Node n) const {
+    return hash(n);
+  }
+};
+
+/// Bulk-synchronous Luby-style algorithm. Node a beats node b if it has a
+/// higher priority, or the same priority and a smaller ID. In each round,
+/// the undecided nodes that beat all of their undecided neighbors join the
+/// set and their neighbors leave it. All state lives in bitsets and a
+/// compact array of priorities, and edges are scanned in tiles so that high
+/// degree nodes are spread among threads.
+template <typename Priority>
+struct LubyAlgo {
+  struct NodeFlag : public katana::PODProperty<uint8_t, MatchFlag> {};
+  using NodeData = std::tuple<NodeFlag>;
+  using EdgeData = std::tuple<>;
+
+  typedef katana::TypedPropertyGraph<NodeData, EdgeData> Graph;
+  typedef typename Graph::Node GNode;
+
+  struct EdgeTile {
+    GNode src;
+    typename Graph::edge_iterator beg;
+    typename Graph::edge_iterator end;
+  };
+
+  void Initialize(Graph*) {}
+
+  void operator()(Graph* graph) {
+    constexpr int kEdgeTileSize = 64;
+    uint64_t num_nodes = graph->size();
+
+    katana::NUMAArray<uint32_t> priority;
+    priority.allocateBlocked(num_nodes);
+    katana::DynamicBitset undecided;
+    undecided.resize(num_nodes);
+    katana::DynamicBitset in_set;
+    in_set.resize(num_nodes);
+    katana::DynamicBitset winner;
+    winner.resize(num_nodes);
+
+    auto cur = std::make_unique<katana::InsertBag<EdgeTile>>();
+    auto next = std::make_unique<katana::InsertBag<EdgeTile>>();
+
+    Priority priority_fn;
+    katana::do_all(
+        katana::iterate(*graph),
+        [&](const GNode& src) {
+          priority[src] = priority_fn(*graph, src);
+          auto beg = graph->edge_begin(src);
+          const auto end = graph->edge_end(src);
+          if (beg == end) {
+            // Isolated nodes are always in the set
+            in_set.set(src);
+            return;
+          }
+          undecided.set(src);
+          while (beg < end) {
+            auto tile_end = beg + std::min<int64_t>(kEdgeTileSize, end - beg);
+            cur->push_back(EdgeTile{src, beg, tile_end});
+            beg = tile_end;
+          }
+        },
+        katana::loopname("IndependentSet-init-luby"), katana::steal());
+
+    auto beats = [&](GNode a, GNode b) {
+      return priority[a] > priority[b] ||
+             (priority[a] == priority[b] && a < b);
+    };
+
+    size_t rounds = 0;
+    auto& undecided_words = undecided.get_vec();
+    auto& winner_words = winner.get_vec();
+    while (!cur->empty()) {
+      katana::do_all(
+          katana::iterate(size_t{0}, undecided_words.size()),
+          [&](size_t i) {
+            winner_words[i] =
+                undecided_words[i].load(std::memory_order_relaxed);
+          },
+          katana::no_stats(), katana::loopname("IndependentSet-luby-reset"));
+
+      katana::do_all(
+          katana::iterate(*cur),
+          [&](const EdgeTile& tile) {
+            for (auto edge = tile.beg; edge != tile.end; ++edge) {
+              auto dest = graph->GetEdgeDest(edge);
+              if (*dest != tile.src && undecided.test(*dest) &&
+                  beats(*dest, tile.src)) {
+                winner.reset(tile.src);
+                return;
+              }
+            }
+          },
+          katana::loopname("IndependentSet-luby-execute"), katana::steal());
+
+      katana::do_all(
+          katana::iterate(*cur),
+          [&](const EdgeTile& tile) {
+            if (!winner.test(tile.src)) {
+              return;
+            }
+            in_set.set(tile.src);
+            for (auto edge = tile.beg; edge != tile.end; ++edge) {
+              undecided.reset(*graph->GetEdgeDest(edge));
+            }
+          },
+          katana::loopname("IndependentSet-luby-match"), katana::steal());
+
+      katana::do_all(
+          katana::iterate(*cur),
+          [&](const EdgeTile& tile) {
+            if (winner.test(tile.src)) {
+              undecided.reset(tile.src);
+            } else if (undecided.test(tile.src)) {
+              next->push_back(tile);
+            }
+          },
+          katana::loopname("IndependentSet-luby-compact"));
+
+      cur->clear();
+      std::swap(cur, next);
+      rounds += 1;
+    }
+
+    katana::do_all(
+        katana::iterate(*graph),
+        [&](const GNode& src) {
+          graph->template GetData<NodeFlag>(src) =
+              in_set.test(src) ? MatchFlag::kMatched : MatchFlag::KOtherMatched;
+        },
+        katana::loopname("IndependentSet-luby-output"));
+
+    katana::ReportStatSingle("IndependentSet-LubyAlgo", "rounds", rounds);
+  }
+};
+
 struct IsBad {
   struct NodeFlag : public katana::PODProperty<uint8_t> {};
   using NodeData = std::tuple<NodeFlag>;
@@ -668,10 +820,14 @@ katana::analytics::IndependentSet(
     return Run<SerialAlgo>(pg, output_property_name);
   case IndependentSetPlan::kPull:
     return Run<PullAlgo>(pg, output_property_name);
+  case IndependentSetPlan::kDeterministic:
+    return Run<LubyAlgo<HashPriority>>(pg, output_property_name);
   case IndependentSetPlan::kPriority:
     return Run<PrioAlgo>(pg, output_property_name);
   case IndependentSetPlan::kEdgeTiledPriority:
     return Run<EdgeTiledPrioAlgo>(pg, output_property_name);
+  case IndependentSetPlan::kLuby:
+    return Run<LubyAlgo<DegreeHashPriority>>(pg, output_property_name);
   default:
     return katana::ErrorCode::InvalidArgument;
   }
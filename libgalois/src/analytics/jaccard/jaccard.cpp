@@ -19,6 +19,7 @@
 
 #include "katana/analytics/jaccard/jaccard.h"
 
+#include "katana/SetIntersection.h"
 #include "katana/Statistics.h"
 #include "katana/TypedPropertyGraph.h"
 #include "katana/analytics/Utils.h"
@@ -35,35 +36,34 @@ namespace {
 
 struct IntersectWithSortedEdgeList {
 private:
-  const GNode base_;
-  const Graph& graph_;
+  const GNode* dests_;
+  const katana::GraphTopology& topology_;
+  const GNode* base_begin_;
+  size_t base_size_;
+  // Set if base is a hub, since it is intersected with every node
+  katana::IntersectionBitmap base_bitmap_;
 
 public:
-  IntersectWithSortedEdgeList(const Graph& graph, GNode base)
-      : base_(base), graph_(graph) {}
+  IntersectWithSortedEdgeList(
+      const Graph&, const katana::GraphTopology& topology, GNode base)
+      : dests_(topology.dest_data()),
+        topology_(topology),
+        base_begin_(dests_ + *topology.edges(base).begin()),
+        base_size_(topology.degree(base)) {
+    if (base_size_ >= katana::kIntersectBitmapMinSize) {
+      base_bitmap_.Assign(base_begin_, base_size_, topology.num_nodes());
+    }
+  }
 
-  uint32_t operator()(GNode n2) {
-    uint32_t intersection_size = 0;
-    // Iterate over the edges of both n2 and base in sync, based on the
-    // assumption that edges lists are sorted.
-    auto edges_n2_iter = graph_.edge_begin(n2);
-    auto edges_n2_end = graph_.edge_end(n2);
-    auto edges_base_iter = graph_.edge_begin(base_);
-    auto edges_base_end = graph_.edge_end(base_);
-    while (edges_n2_iter != edges_n2_end && edges_base_iter != edges_base_end) {
-      auto edge_n2_dst = graph_.GetEdgeDest(*edges_n2_iter);
-      auto edge_base_dst = graph_.GetEdgeDest(*edges_base_iter);
-      if (edge_n2_dst == edge_base_dst) {
-        intersection_size++;
-        edges_n2_iter++;
-        edges_base_iter++;
-      } else if (edge_n2_dst > edge_base_dst) {
-        edges_base_iter++;
-      } else if (edge_n2_dst < edge_base_dst) {
-        edges_n2_iter++;
-      }
+  uint32_t operator()(GNode n2) const {
+    // The edge lists of both n2 and base are sorted
+    const GNode* n2_begin = dests_ + *topology_.edges(n2).begin();
+    size_t n2_size = topology_.degree(n2);
+    if (base_bitmap_.size() > 0) {
+      return katana::CountCommon(
+          base_bitmap_, base_begin_, base_size_, n2_begin, n2_size);
     }
-    return intersection_size;
+    return katana::CountCommon(base_begin_, base_size_, n2_begin, n2_size);
   }
 };
 
@@ -73,7 +73,8 @@ private:
   const Graph& graph_;
 
 public:
-  IntersectWithUnsortedEdgeList(const Graph& graph, GNode base)
+  IntersectWithUnsortedEdgeList(
+      const Graph& graph, const katana::GraphTopology&, GNode base)
       : graph_(graph) {
     // Collect all the neighbors of the base node into a hash set.
     for (const auto& e : graph.edges(base)) {
@@ -98,7 +99,8 @@ katana::Result<void>
 JaccardImpl(
     katana::TypedPropertyGraph<std::tuple<JaccardSimilarity>, std::tuple<>>&
         graph,
-    size_t compare_node, JaccardPlan /*plan*/) {
+    const katana::GraphTopology& topology, size_t compare_node,
+    JaccardPlan /*plan*/) {
   if (compare_node >= graph.size()) {
     return katana::ErrorCode::InvalidArgument;
   }
@@ -114,7 +116,7 @@ JaccardImpl(
 
   uint32_t base_size = graph.edges(base).size();
 
-  IntersectAlgorithm intersect_with_base{graph, base};
+  IntersectAlgorithm intersect_with_base{graph, topology, base};
 
   // Compute the similarity for each node
   katana::do_all(katana::iterate(graph), [&](const GNode& n2) {
@@ -154,17 +156,22 @@ katana::analytics::Jaccard(
   }
 
   katana::Result<void> r = katana::ResultSuccess();
-  switch (plan.edge_sorting()) {
+  JaccardPlan::EdgeSorting edge_sorting = plan.edge_sorting();
+  if (edge_sorting == JaccardPlan::kUnknown) {
+    // The profile is cached, so the edges are checked once per graph
+    edge_sorting = pg->GetGraphProfile()->edges_sorted ? JaccardPlan::kSorted
+                                                       : JaccardPlan::kUnsorted;
+  }
+
+  switch (edge_sorting) {
   case JaccardPlan::kUnknown:
-    // TODO(amp): It would be possible to start with the sorted case and then
-    //  fail to the unsorted case if unsorted nodes are detected.
   case JaccardPlan::kUnsorted:
     r = JaccardImpl<IntersectWithUnsortedEdgeList>(
-        pg_result.value(), compare_node, plan);
+        pg_result.value(), pg->topology(), compare_node, plan);
     break;
   case JaccardPlan::kSorted:
     r = JaccardImpl<IntersectWithSortedEdgeList>(
-        pg_result.value(), compare_node, plan);
+        pg_result.value(), pg->topology(), compare_node, plan);
     break;
   }
 
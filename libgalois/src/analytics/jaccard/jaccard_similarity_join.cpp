@@ -0,0 +1,575 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2020, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "katana/AtomicHelpers.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Statistics.h"
+#include "katana/analytics/jaccard/jaccard.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+
+/// At most this many members of each MinHash bucket, around the node itself,
+/// are compared to a node, so huge buckets of near duplicates stay linear
+constexpr uint64_t kMinHashBucketScan = 256;
+
+/// A similar node with its similarity
+using Match = std::pair<double, Node>;
+
+/// Whether a is a better match than b: more similar, or as similar with a
+/// smaller id, so that results do not depend on the order of candidates
+bool
+Better(const Match& a, const Match& b) {
+  return a.first > b.first || (a.first == b.first && a.second < b.second);
+}
+
+/// An open addressing hash map from nodes to counts that is cleared through
+/// the slots it used, so that it grows with the nodes one node reaches, at
+/// most its two-hop neighborhood, rather than with the graph.
+class NodeCounts {
+public:
+  void Clear() {
+    for (uint64_t slot : used_) {
+      slots_[slot].first = kEmpty;
+    }
+    used_.clear();
+  }
+
+  /// The count of node, added with a count of zero if absent, and whether it
+  /// was added
+  std::pair<uint32_t*, bool> Insert(Node node) {
+    if (2 * (used_.size() + 1) > slots_.size()) {
+      Grow();
+    }
+    uint64_t slot = Probe(node);
+    bool added = slots_[slot].first == kEmpty;
+    if (added) {
+      slots_[slot] = {node, 0};
+      used_.emplace_back(slot);
+    }
+    return {&slots_[slot].second, added};
+  }
+
+  bool Contains(Node node) const {
+    return !slots_.empty() && slots_[Probe(node)].first == node;
+  }
+
+private:
+  static constexpr Node kEmpty = std::numeric_limits<Node>::max();
+  static constexpr uint64_t kMinSlotsLog2 = 4;
+
+  uint64_t Probe(Node node) const {
+    uint64_t mask = slots_.size() - 1;
+    uint64_t slot = (node * UINT64_C(0x9e3779b97f4a7c15)) >> (64 - slots_log2_);
+    while (slots_[slot].first != kEmpty && slots_[slot].first != node) {
+      slot = (slot + 1) & mask;
+    }
+    return slot;
+  }
+
+  void Grow() {
+    std::vector<std::pair<Node, uint32_t>> old_slots(
+        uint64_t{1} << (slots_.empty() ? kMinSlotsLog2 : slots_log2_ + 1),
+        {kEmpty, 0});
+    old_slots.swap(slots_);
+    slots_log2_ = slots_log2_ == 0 ? kMinSlotsLog2 : slots_log2_ + 1;
+    std::vector<uint64_t> old_used;
+    old_used.swap(used_);
+    for (uint64_t old_slot : old_used) {
+      uint64_t slot = Probe(old_slots[old_slot].first);
+      slots_[slot] = old_slots[old_slot];
+      used_.emplace_back(slot);
+    }
+  }
+
+  std::vector<std::pair<Node, uint32_t>> slots_;
+  uint64_t slots_log2_{0};
+  std::vector<uint64_t> used_;
+};
+
+/// The per-thread state of a join, cleared for each node
+struct JoinScratch {
+  /// shared neighbors of each candidate of the current node
+  NodeCounts shared;
+  /// the neighbors of the current node
+  NodeCounts members;
+  std::vector<Node> candidates;
+  /// bounded heap of the best matches, with the worst at the front
+  std::vector<Match> top;
+
+  void Reset() {
+    shared.Clear();
+    members.Clear();
+    candidates.clear();
+  }
+
+  void Push(double similarity, Node node, uint32_t top_k) {
+    Match match{similarity, node};
+    if (top.size() < top_k) {
+      top.emplace_back(match);
+      std::push_heap(top.begin(), top.end(), Better);
+    } else if (Better(match, top.front())) {
+      std::pop_heap(top.begin(), top.end(), Better);
+      top.back() = match;
+      std::push_heap(top.begin(), top.end(), Better);
+    }
+  }
+};
+
+/// The top matches of every node: node n has counts[n] matches, best first,
+/// at [n * top_k, n * top_k + counts[n])
+struct JoinMatches {
+  uint32_t top_k;
+  katana::NUMAArray<uint64_t> counts;
+  katana::NUMAArray<Node> nodes;
+  katana::NUMAArray<double> similarities;
+
+  JoinMatches(uint64_t num_nodes, uint32_t top_k_) : top_k(top_k_) {
+    counts.allocateBlocked(num_nodes);
+    nodes.allocateBlocked(num_nodes * top_k);
+    similarities.allocateBlocked(num_nodes * top_k);
+    katana::ParallelSTL::fill(counts.begin(), counts.end(), uint64_t{0});
+  }
+
+  void Store(Node n, JoinScratch* scratch) {
+    std::sort_heap(scratch->top.begin(), scratch->top.end(), Better);
+    counts[n] = scratch->top.size();
+    for (size_t i = 0; i < scratch->top.size(); ++i) {
+      similarities[n * top_k + i] = scratch->top[i].first;
+      nodes[n * top_k + i] = scratch->top[i].second;
+    }
+    scratch->top.clear();
+  }
+};
+
+/// Join by exact similarities. Each node u is a set of tokens, its
+/// neighbors, and is compared with the nodes that share a token in the
+/// prefixes of both, found through an inverted index from tokens to the nodes
+/// whose prefix holds them. With tokens ordered from rarest to most common, a
+/// pair with similarity at least t shares a token in prefixes of
+/// |u| - ceil(t * |u|) + 1 tokens, which are short for large t. For t = 0 the
+/// prefixes are whole, the index is the transpose, and the join visits every
+/// two-hop wedge, counting shared neighbors on the way.
+void
+ExactJoin(
+    const katana::GraphTopology& topology, double min_similarity,
+    JoinMatches* matches) {
+  uint64_t num_nodes = topology.num_nodes();
+  uint64_t num_edges = topology.num_edges();
+  const Node* dests = topology.dest_data();
+  bool prefix_filtering = min_similarity > 0;
+
+  // The number of nodes with each token
+  katana::NUMAArray<std::atomic<uint64_t>> frequency;
+  frequency.allocateBlocked(num_nodes + 1);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes + 1),
+      [&](uint64_t n) { frequency[n] = 0; }, katana::no_stats());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t e) { katana::atomicAdd(frequency[dests[e]], uint64_t{1}); },
+      katana::no_stats(), katana::loopname("JaccardJoinTokenFrequency"));
+
+  // The tokens of each node, rarest first when filtering prefixes
+  katana::NUMAArray<Node> tokens;
+  tokens.allocateBlocked(num_edges);
+  katana::NUMAArray<uint32_t> prefix_size;
+  prefix_size.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(topology.all_nodes()),
+      [&](Node n) {
+        auto edges = topology.edges(n);
+        Node* begin = tokens.data() + *edges.begin();
+        Node* end = tokens.data() + *edges.end();
+        std::copy(dests + *edges.begin(), dests + *edges.end(), begin);
+        uint32_t degree = end - begin;
+        if (!prefix_filtering) {
+          prefix_size[n] = degree;
+          return;
+        }
+        std::sort(begin, end, [&](Node a, Node b) {
+          uint64_t frequency_a = frequency[a];
+          uint64_t frequency_b = frequency[b];
+          return frequency_a < frequency_b ||
+                 (frequency_a == frequency_b && a < b);
+        });
+        uint32_t overlap = std::ceil(min_similarity * degree - 1e-9);
+        prefix_size[n] = std::min(degree, degree - overlap + 1);
+      },
+      katana::steal(), katana::loopname("JaccardJoinPrefixes"));
+
+  // The inverted index from each token to the nodes whose prefix holds it,
+  // with the nodes of token w at [offsets[w], offsets[w + 1])
+  katana::NUMAArray<uint64_t> offsets;
+  offsets.allocateBlocked(num_nodes + 1);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes + 1),
+      [&](uint64_t n) { frequency[n] = 0; }, katana::no_stats());
+  katana::do_all(
+      katana::iterate(topology.all_nodes()),
+      [&](Node n) {
+        const Node* begin = tokens.data() + *topology.edges(n).begin();
+        for (uint32_t i = 0; i < prefix_size[n]; ++i) {
+          katana::atomicAdd(frequency[begin[i] + 1], uint64_t{1});
+        }
+      },
+      katana::steal(), katana::loopname("JaccardJoinIndexSizes"));
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes + 1),
+      [&](uint64_t n) { offsets[n] = frequency[n]; }, katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      offsets.begin(), offsets.end(), offsets.begin());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes + 1),
+      [&](uint64_t n) { frequency[n] = offsets[n]; }, katana::no_stats());
+  katana::NUMAArray<Node> index;
+  index.allocateBlocked(offsets[num_nodes]);
+  katana::do_all(
+      katana::iterate(topology.all_nodes()),
+      [&](Node n) {
+        const Node* begin = tokens.data() + *topology.edges(n).begin();
+        for (uint32_t i = 0; i < prefix_size[n]; ++i) {
+          index[katana::atomicAdd(frequency[begin[i]], uint64_t{1})] = n;
+        }
+      },
+      katana::steal(), katana::loopname("JaccardJoinIndex"));
+
+  katana::PerThreadStorage<JoinScratch> scratches;
+  katana::do_all(
+      katana::iterate(topology.all_nodes()),
+      [&](Node u) {
+        uint32_t degree_u = topology.degree(u);
+        if (degree_u == 0) {
+          return;
+        }
+        JoinScratch& scratch = *scratches.getLocal();
+        scratch.Reset();
+        const Node* begin = tokens.data() + *topology.edges(u).begin();
+
+        if (prefix_filtering) {
+          for (uint32_t i = 0; i < degree_u; ++i) {
+            scratch.members.Insert(begin[i]);
+          }
+        }
+        for (uint32_t i = 0; i < prefix_size[u]; ++i) {
+          Node w = begin[i];
+          for (uint64_t j = offsets[w]; j < offsets[w + 1]; ++j) {
+            Node v = index[j];
+            if (v == u) {
+              continue;
+            }
+            auto [count, added] = scratch.shared.Insert(v);
+            if (added) {
+              scratch.candidates.emplace_back(v);
+            }
+            ++*count;
+          }
+        }
+
+        for (Node v : scratch.candidates) {
+          uint32_t degree_v = topology.degree(v);
+          uint32_t shared = *scratch.shared.Insert(v).first;
+          if (prefix_filtering) {
+            // Sizes too different for the similarity to reach the threshold
+            if (degree_v < min_similarity * degree_u ||
+                degree_u < min_similarity * degree_v) {
+              continue;
+            }
+            shared = 0;
+            for (Edge e : topology.edges(v)) {
+              shared += scratch.members.Contains(dests[e]);
+            }
+          }
+          double similarity =
+              static_cast<double>(shared) / (degree_u + degree_v - shared);
+          if (similarity >= min_similarity) {
+            scratch.Push(similarity, v, matches->top_k);
+          }
+        }
+        matches->Store(u, &scratch);
+      },
+      katana::steal(), katana::loopname("JaccardJoinExact"));
+}
+
+/// The splitmix64 finalizer
+uint64_t
+Mix(uint64_t x) {
+  x += UINT64_C(0x9e3779b97f4a7c15);
+  x = (x ^ (x >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+  x = (x ^ (x >> 27)) * UINT64_C(0x94d049bb133111eb);
+  return x ^ (x >> 31);
+}
+
+/// Join by MinHash. The signature of a node holds, for each of
+/// num_bands * rows_per_band hash functions, the smallest hash of its
+/// neighbors; two signatures agree on a hash with probability equal to the
+/// similarity of the nodes. Nodes are compared if they agree on every hash
+/// of some band, found by sorting the nodes by the hash of each band, and the
+/// similarity is estimated as the fraction of hashes they agree on.
+void
+MinHashJoin(
+    const katana::GraphTopology& topology,
+    const JaccardSimilarityJoinPlan& plan, JoinMatches* matches) {
+  uint64_t num_nodes = topology.num_nodes();
+  uint32_t num_bands = plan.num_bands();
+  uint32_t rows = plan.rows_per_band();
+  uint32_t num_hashes = num_bands * rows;
+  const Node* dests = topology.dest_data();
+
+  std::vector<uint64_t> seeds(num_hashes);
+  for (uint32_t i = 0; i < num_hashes; ++i) {
+    seeds[i] = Mix(plan.seed() * num_hashes + i);
+  }
+
+  katana::NUMAArray<uint32_t> signatures;
+  signatures.allocateBlocked(num_nodes * num_hashes);
+  katana::do_all(
+      katana::iterate(topology.all_nodes()),
+      [&](Node n) {
+        uint32_t* signature = signatures.data() + n * num_hashes;
+        std::fill(signature, signature + num_hashes, UINT32_MAX);
+        for (Edge e : topology.edges(n)) {
+          for (uint32_t i = 0; i < num_hashes; ++i) {
+            signature[i] = std::min(
+                signature[i],
+                static_cast<uint32_t>(Mix(dests[e] ^ seeds[i]) >> 32));
+          }
+        }
+      },
+      katana::steal(), katana::loopname("JaccardJoinSignatures"));
+
+  auto band_key = [&](Node n, uint32_t band) {
+    const uint32_t* row = signatures.data() + n * num_hashes + band * rows;
+    uint64_t key = Mix(band);
+    for (uint32_t i = 0; i < rows; ++i) {
+      key = Mix(key ^ row[i]);
+    }
+    return key;
+  };
+
+  // The nodes with edges sorted by the key of each band
+  using KeyedNode = std::pair<uint64_t, Node>;
+  uint64_t num_active = 0;
+  for (Node n : topology.all_nodes()) {
+    num_active += topology.degree(n) > 0;
+  }
+  std::vector<katana::NUMAArray<KeyedNode>> buckets(num_bands);
+  for (uint32_t band = 0; band < num_bands; ++band) {
+    auto& bucket = buckets[band];
+    bucket.allocateBlocked(num_active);
+    std::atomic<uint64_t> size{0};
+    katana::do_all(
+        katana::iterate(topology.all_nodes()),
+        [&](Node n) {
+          if (topology.degree(n) > 0) {
+            bucket[katana::atomicAdd(size, uint64_t{1})] = {
+                band_key(n, band), n};
+          }
+        },
+        katana::no_stats());
+    katana::ParallelSTL::sort(bucket.begin(), bucket.end());
+  }
+
+  katana::PerThreadStorage<JoinScratch> scratches;
+  katana::do_all(
+      katana::iterate(topology.all_nodes()),
+      [&](Node u) {
+        if (topology.degree(u) == 0) {
+          return;
+        }
+        JoinScratch& scratch = *scratches.getLocal();
+        scratch.Reset();
+        const uint32_t* signature_u = signatures.data() + u * num_hashes;
+
+        for (uint32_t band = 0; band < num_bands; ++band) {
+          const auto& bucket = buckets[band];
+          KeyedNode self{band_key(u, band), u};
+          auto position = std::lower_bound(bucket.begin(), bucket.end(), self);
+          auto range = std::equal_range(
+              bucket.begin(), bucket.end(), self,
+              [](const KeyedNode& a, const KeyedNode& b) {
+                return a.first < b.first;
+              });
+          auto first = range.first;
+          auto last = range.second;
+          if (static_cast<uint64_t>(last - first) > kMinHashBucketScan) {
+            uint64_t half = kMinHashBucketScan / 2;
+            first = position - std::min<uint64_t>(half, position - first);
+            last = first + std::min<uint64_t>(kMinHashBucketScan, last - first);
+          }
+          for (auto it = first; it != last; ++it) {
+            Node v = it->second;
+            if (v == u || !scratch.shared.Insert(v).second) {
+              continue;
+            }
+            const uint32_t* signature_v = signatures.data() + v * num_hashes;
+            uint32_t agree = 0;
+            for (uint32_t i = 0; i < num_hashes; ++i) {
+              agree += signature_u[i] == signature_v[i];
+            }
+            double similarity = static_cast<double>(agree) / num_hashes;
+            if (similarity > 0 && similarity >= plan.min_similarity()) {
+              scratch.Push(similarity, v, matches->top_k);
+            }
+          }
+        }
+        matches->Store(u, &scratch);
+      },
+      katana::steal(), katana::loopname("JaccardJoinMinHash"));
+}
+
+katana::Result<JoinMatches>
+JaccardSimilarityJoinImpl(
+    katana::PropertyGraph* pg, const JaccardSimilarityJoinPlan& plan) {
+  if (plan.top_k() == 0 ||
+      !(plan.min_similarity() >= 0 && plan.min_similarity() <= 1)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "top_k must be positive and min_similarity in [0, 1], got {} and {}",
+        plan.top_k(), plan.min_similarity());
+  }
+  if (plan.algorithm() == JaccardSimilarityJoinPlan::kMinHash &&
+      (plan.num_bands() == 0 || plan.rows_per_band() == 0)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "MinHash needs at least one band of at least one row, got {} of {}",
+        plan.num_bands(), plan.rows_per_band());
+  }
+
+  const katana::GraphTopology& topology = pg->topology();
+  uint64_t num_nodes = topology.num_nodes();
+  uint32_t top_k = std::min<uint64_t>(plan.top_k(), num_nodes);
+
+  katana::ReportPageAllocGuard page_alloc;
+  katana::StatTimer exec_time("JaccardSimilarityJoin");
+  exec_time.start();
+
+  JoinMatches matches(num_nodes, top_k);
+  switch (plan.algorithm()) {
+  case JaccardSimilarityJoinPlan::kExact:
+    ExactJoin(topology, plan.min_similarity(), &matches);
+    break;
+  case JaccardSimilarityJoinPlan::kMinHash:
+    MinHashJoin(topology, plan, &matches);
+    break;
+  default:
+    return katana::ErrorCode::InvalidArgument;
+  }
+
+  exec_time.stop();
+  return katana::Result<JoinMatches>(std::move(matches));
+}
+
+}  // namespace
+
+katana::Result<JaccardSimilarityJoinResult>
+katana::analytics::JaccardSimilarityJoin(
+    katana::PropertyGraph* pg, JaccardSimilarityJoinPlan plan) {
+  JoinMatches matches = KATANA_CHECKED(JaccardSimilarityJoinImpl(pg, plan));
+  uint64_t num_nodes = matches.counts.size();
+
+  katana::NUMAArray<uint64_t> offsets;
+  offsets.allocateBlocked(num_nodes);
+  katana::ParallelSTL::partial_sum(
+      matches.counts.begin(), matches.counts.end(), offsets.begin());
+  uint64_t num_pairs = num_nodes > 0 ? offsets[num_nodes - 1] : 0;
+
+  JaccardSimilarityJoinResult result;
+  result.sources.resize(num_pairs);
+  result.destinations.resize(num_pairs);
+  result.similarities.resize(num_pairs);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t begin = offsets[n] - matches.counts[n];
+        for (uint64_t i = 0; i < matches.counts[n]; ++i) {
+          result.sources[begin + i] = n;
+          result.destinations[begin + i] = matches.nodes[n * matches.top_k + i];
+          result.similarities[begin + i] =
+              matches.similarities[n * matches.top_k + i];
+        }
+      },
+      katana::no_stats(), katana::loopname("JaccardJoinEdgeList"));
+  return result;
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::analytics::JaccardSimilarityGraph(
+    katana::PropertyGraph* pg, const std::string& similarity_property_name,
+    JaccardSimilarityJoinPlan plan) {
+  JoinMatches matches = KATANA_CHECKED(JaccardSimilarityJoinImpl(pg, plan));
+  uint64_t num_nodes = matches.counts.size();
+
+  katana::NUMAArray<Edge> out_indices;
+  out_indices.allocateInterleaved(num_nodes);
+  katana::ParallelSTL::partial_sum(
+      matches.counts.begin(), matches.counts.end(), out_indices.begin());
+  uint64_t num_pairs = num_nodes > 0 ? out_indices[num_nodes - 1] : 0;
+
+  katana::NUMAArray<Node> out_dests;
+  out_dests.allocateInterleaved(num_pairs);
+  std::vector<double> similarities(num_pairs);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t begin = out_indices[n] - matches.counts[n];
+        for (uint64_t i = 0; i < matches.counts[n]; ++i) {
+          out_dests[begin + i] = matches.nodes[n * matches.top_k + i];
+          similarities[begin + i] = matches.similarities[n * matches.top_k + i];
+        }
+      },
+      katana::no_stats(), katana::loopname("JaccardJoinGraph"));
+
+  katana::GraphTopology topology{std::move(out_indices), std::move(out_dests)};
+  auto similarity_graph =
+      KATANA_CHECKED(katana::PropertyGraph::Make(std::move(topology)));
+
+  arrow::DoubleBuilder builder;
+  if (auto r = builder.AppendValues(similarities); !r.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "building similarities: {}",
+        r.ToString());
+  }
+  std::shared_ptr<arrow::Array> values;
+  if (auto r = builder.Finish(&values); !r.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "building similarities: {}",
+        r.ToString());
+  }
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field(similarity_property_name, arrow::float64())}),
+      {values});
+  KATANA_CHECKED(similarity_graph->AddEdgeProperties(table));
+  return katana::Result<std::unique_ptr<katana::PropertyGraph>>(
+      std::move(similarity_graph));
+}
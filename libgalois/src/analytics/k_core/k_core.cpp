@@ -19,7 +19,17 @@
 
 #include "katana/analytics/k_core/k_core.h"
 
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
 #include "katana/ArrowRandomAccessBuilder.h"
+#include "katana/Frontier.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Reduction.h"
 #include "katana/Statistics.h"
 #include "katana/TypedPropertyGraph.h"
 
@@ -36,6 +46,10 @@ struct KCoreNodeCurrentDegree : public katana::AtomicPODProperty<uint32_t> {};
 
 struct KCoreNodeAlive : public katana::PODProperty<uint32_t> {};
 
+struct KCoreNodeCoreNumber : public katana::PODProperty<uint32_t> {};
+
+struct KCoreNodeDegeneracyRank : public katana::PODProperty<uint32_t> {};
+
 using NodeData = std::tuple<KCoreNodeCurrentDegree>;
 using EdgeData = std::tuple<>;
 typedef katana::TypedPropertyGraph<NodeData, EdgeData> Graph;
@@ -163,6 +177,125 @@ AsyncCascadeKCore(Graph* graph, uint32_t k_core_number) {
       katana::loopname("KCore Asynchronous"));
 }
 
+//! Number of values of k whose nodes are kept in buckets at a time
+constexpr static const uint32_t kBucketWindow = 64;
+constexpr static const uint32_t kUnpeeled =
+    std::numeric_limits<uint32_t>::max();
+
+/**
+ * Compute the core number of every node by peeling: for k = 0, 1, ..., the
+ * nodes of degree at most k are removed a frontier at a time, each frontier
+ * lowering the degrees of the neighbors of its nodes and so making the next
+ * one, and get core number k. Nodes wait in buckets by degree for a window
+ * of kBucketWindow values of k, so only refilling the window, not each
+ * value of k, scans the graph. When done, the degree of each node is
+ * replaced by its core number.
+ *
+ * @param graph Graph to operate on
+ * @param peel_steps If not null, filled with the index of the frontier that
+ * peeled each node
+ */
+void
+BucketPeelingKCore(
+    Graph* graph, katana::NUMAArray<uint32_t>* peel_steps = nullptr) {
+  uint64_t num_nodes = graph->num_nodes();
+  katana::NUMAArray<uint32_t> core;
+  core.allocateBlocked(num_nodes);
+  katana::ParallelSTL::fill(core.begin(), core.end(), kUnpeeled);
+
+  auto degree = [&](GNode node) -> auto& {
+    return graph->GetData<KCoreNodeCurrentDegree>(node);
+  };
+
+  std::vector<katana::InsertBag<GNode>> buckets(kBucketWindow);
+  katana::Frontier current(num_nodes);
+  katana::Frontier next(num_nodes);
+  uint64_t num_peeled = 0;
+  uint32_t step = 0;
+  if (peel_steps) {
+    peel_steps->allocateBlocked(num_nodes);
+  }
+
+  while (num_peeled < num_nodes) {
+    //! Refill the window, starting at the smallest degree left.
+    katana::GReduceMin<uint32_t> min_degree;
+    katana::do_all(
+        katana::iterate(*graph),
+        [&](const GNode& node) {
+          if (core[node] == kUnpeeled) {
+            min_degree.update(degree(node));
+          }
+        },
+        katana::loopname("KCore Bucket Base"), katana::no_stats());
+    uint32_t base = min_degree.reduce();
+    katana::do_all(
+        katana::iterate(*graph),
+        [&](const GNode& node) {
+          uint32_t node_degree = degree(node);
+          if (core[node] == kUnpeeled && node_degree - base < kBucketWindow) {
+            buckets[node_degree - base].push(node);
+          }
+        },
+        katana::loopname("KCore Bucket Fill"), katana::no_stats());
+
+    for (uint32_t k = base; k - base < kBucketWindow && num_peeled < num_nodes;
+         ++k) {
+      //! Buckets may hold nodes peeled since they were added.
+      auto& bucket = buckets[k - base];
+      katana::do_all(
+          katana::iterate(bucket),
+          [&](const GNode& node) {
+            if (core[node] == kUnpeeled && degree(node) <= k) {
+              current.Push(node);
+            }
+          },
+          katana::loopname("KCore Bucket Pop"), katana::no_stats());
+      bucket.clear();
+      current.Seal();
+
+      while (!current.empty()) {
+        num_peeled += current.Size();
+        current.ForEachActive(
+            [&](uint32_t node) {
+              core[node] = k;
+              if (peel_steps) {
+                (*peel_steps)[node] = step;
+              }
+            },
+            katana::loopname("KCore Peel"), katana::no_stats());
+        ++step;
+        current.ForEachActive(
+            [&](uint32_t node) {
+              for (auto e : graph->edges(node)) {
+                auto dest = *graph->GetEdgeDest(e);
+                if (core[dest] != kUnpeeled) {
+                  continue;
+                }
+                uint32_t old_degree = katana::atomicSub(degree(dest), 1u);
+                if (old_degree == k + 1) {
+                  //! This thread put the degree of dest at k.
+                  next.Push(dest);
+                } else if (old_degree - 1 - base < kBucketWindow &&
+                           old_degree - 1 > k) {
+                  buckets[old_degree - 1 - base].push(dest);
+                }
+              }
+            },
+            katana::loopname("KCore Bucket Peeling"));
+        next.Seal();
+        std::swap(current, next);
+        next.Clear();
+      }
+      current.Clear();
+    }
+  }
+
+  katana::do_all(
+      katana::iterate(*graph),
+      [&](const GNode& node) { degree(node) = core[node]; },
+      katana::loopname("KCore Core Numbers"), katana::no_stats());
+}
+
 /**
  * After computation is finished, the nodes left in the core
  * are marked as alive.
@@ -215,6 +348,11 @@ KCoreImpl(
   case KCorePlan::kAsynchronous:
     AsyncCascadeKCore(graph, k_core_number);
     break;
+  case KCorePlan::kBucketPeeling:
+    //! Leaves core numbers in place of the degrees, which marks nodes alive
+    //! just like the degrees left by the cascades.
+    BucketPeelingKCore(graph);
+    break;
   default:
     return katana::ErrorCode::AssertionFailed;
   }
@@ -262,6 +400,361 @@ katana::analytics::KCore(
   return KCoreMarkAliveNodes(&graph_final, k_core_number);
 }
 
+katana::Result<void>
+katana::analytics::KCoreNumbers(
+    katana::PropertyGraph* pg, const std::string& output_property_name) {
+  katana::analytics::TemporaryPropertyGuard temporary_property{
+      pg->NodeMutablePropertyView()};
+  KATANA_CHECKED(ConstructNodeProperties<std::tuple<KCoreNodeCurrentDegree>>(
+      pg, {temporary_property.name()}));
+  auto graph =
+      KATANA_CHECKED(Graph::Make(pg, {temporary_property.name()}, {}));
+  KATANA_CHECKED(KCoreImpl(&graph, KCorePlan::BucketPeeling(), 0));
+
+  KATANA_CHECKED(ConstructNodeProperties<std::tuple<KCoreNodeCoreNumber>>(
+      pg, {output_property_name}));
+  using CoreNumberGraph = katana::TypedPropertyGraph<
+      std::tuple<KCoreNodeCoreNumber, KCoreNodeCurrentDegree>, std::tuple<>>;
+  auto graph_final = KATANA_CHECKED(CoreNumberGraph::Make(
+      pg, {output_property_name, temporary_property.name()}, {}));
+  katana::do_all(
+      katana::iterate(graph_final),
+      [&](const GNode& node) {
+        graph_final.GetData<KCoreNodeCoreNumber>(node) =
+            graph_final.GetData<KCoreNodeCurrentDegree>(node);
+      },
+      katana::loopname("KCore Write Core Numbers"), katana::no_stats());
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::analytics::KCoreDegeneracyOrder(
+    katana::PropertyGraph* pg, const std::string& output_property_name) {
+  katana::analytics::TemporaryPropertyGuard temporary_property{
+      pg->NodeMutablePropertyView()};
+  KATANA_CHECKED(ConstructNodeProperties<std::tuple<KCoreNodeCurrentDegree>>(
+      pg, {temporary_property.name()}));
+  auto graph =
+      KATANA_CHECKED(Graph::Make(pg, {temporary_property.name()}, {}));
+
+  katana::StatTimer exec_time("KCoreDegeneracyOrder");
+  exec_time.start();
+  DegreeCounting(&graph);
+  katana::NUMAArray<uint32_t> peel_steps;
+  BucketPeelingKCore(&graph, &peel_steps);
+
+  //! Every node of a frontier had at most k neighbors left when it was
+  //! peeled, so ordering by frontier, ties by id, is a degeneracy ordering.
+  uint64_t num_nodes = graph.num_nodes();
+  katana::NUMAArray<uint64_t> keys;
+  keys.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t node) {
+        keys[node] = (uint64_t{peel_steps[node]} << 32) | node;
+      },
+      katana::no_stats());
+  katana::ParallelSTL::sort(keys.begin(), keys.end());
+  exec_time.stop();
+
+  KATANA_CHECKED(ConstructNodeProperties<std::tuple<KCoreNodeDegeneracyRank>>(
+      pg, {output_property_name}));
+  using RankGraph = katana::TypedPropertyGraph<
+      std::tuple<KCoreNodeDegeneracyRank>, std::tuple<>>;
+  auto graph_final =
+      KATANA_CHECKED(RankGraph::Make(pg, {output_property_name}, {}));
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t rank) {
+        uint32_t node = keys[rank] & std::numeric_limits<uint32_t>::max();
+        graph_final.GetData<KCoreNodeDegeneracyRank>(node) = rank;
+      },
+      katana::loopname("KCore Write Degeneracy Ranks"), katana::no_stats());
+  return katana::ResultSuccess();
+}
+
+namespace {
+
+struct KCoreNodeAtomicCoreNumber : public katana::AtomicPODProperty<uint32_t> {
+};
+
+using CoreNumberGraph = katana::TypedPropertyGraph<
+    std::tuple<KCoreNodeAtomicCoreNumber>, std::tuple<>>;
+using EdgeList = std::vector<std::pair<uint32_t, uint32_t>>;
+
+/// The neighbors of each node of the graph less the inserted edges not
+/// applied yet
+class IncrementalNeighbors {
+public:
+  explicit IncrementalNeighbors(const CoreNumberGraph& graph)
+      : graph_(graph) {}
+
+  void Exclude(uint32_t src, uint32_t dest) {
+    excluded_[src].emplace_back(dest);
+    excluded_[dest].emplace_back(src);
+  }
+
+  void Include(uint32_t src, uint32_t dest) {
+    Remove(src, dest);
+    Remove(dest, src);
+  }
+
+  template <typename Fn>
+  void ForEach(uint32_t node, const Fn& fn) const {
+    auto it = excluded_.find(node);
+    if (it == excluded_.end()) {
+      for (auto e : graph_.edges(node)) {
+        fn(*graph_.GetEdgeDest(e));
+      }
+      return;
+    }
+    //! Each excluded edge hides one of the parallel edges it matches.
+    std::vector<uint32_t> skip = it->second;
+    for (auto e : graph_.edges(node)) {
+      uint32_t dest = *graph_.GetEdgeDest(e);
+      auto match = std::find(skip.begin(), skip.end(), dest);
+      if (match != skip.end()) {
+        *match = skip.back();
+        skip.pop_back();
+      } else {
+        fn(dest);
+      }
+    }
+  }
+
+private:
+  void Remove(uint32_t src, uint32_t dest) {
+    auto it = excluded_.find(src);
+    auto& dests = it->second;
+    *std::find(dests.begin(), dests.end(), dest) = dests.back();
+    dests.pop_back();
+    if (dests.empty()) {
+      excluded_.erase(it);
+    }
+  }
+
+  const CoreNumberGraph& graph_;
+  std::unordered_map<uint32_t, std::vector<uint32_t>> excluded_;
+};
+
+/**
+ * Lower the core number of each node of the worklist, and of the nodes this
+ * affects, to the h-index of the core numbers of its neighbors until none
+ * changes. Starting from numbers no lower than the core numbers, this ends at
+ * the core numbers.
+ *
+ * @param graph Graph to operate on
+ * @param neighbors Neighbors of the nodes in graph
+ * @param worklist Nodes whose number may be too high
+ * @param can_change Whether the number of a node may be too high
+ */
+template <typename CanChange>
+void
+CoreNumberDescent(
+    CoreNumberGraph* graph, const IncrementalNeighbors& neighbors,
+    const std::vector<uint32_t>& worklist, const CanChange& can_change) {
+  auto core = [&](uint32_t node) -> auto& {
+    return graph->GetData<KCoreNodeAtomicCoreNumber>(node);
+  };
+
+  katana::for_each(
+      katana::iterate(worklist),
+      [&](uint32_t node, auto& ctx) {
+        std::vector<uint32_t> values;
+        neighbors.ForEach(node, [&](uint32_t dest) {
+          values.emplace_back(core(dest).load(std::memory_order_relaxed));
+        });
+        uint32_t number = core(node).load(std::memory_order_relaxed);
+        uint32_t cap = std::min<uint64_t>(number, values.size());
+        std::vector<uint32_t> counts(cap + 1);
+        for (uint32_t value : values) {
+          ++counts[std::min(value, cap)];
+        }
+        //! The largest h with h neighbors of number at least h
+        uint32_t h = cap;
+        uint32_t at_least = counts[cap];
+        while (at_least < h) {
+          --h;
+          at_least += counts[h];
+        }
+        if (h >= number) {
+          return;
+        }
+
+        uint32_t old_number = katana::atomicMin(core(node), h);
+        if (old_number <= h) {
+          return;
+        }
+        //! Only neighbors that counted this node may now have too few.
+        neighbors.ForEach(node, [&](uint32_t dest) {
+          uint32_t dest_number = core(dest).load(std::memory_order_relaxed);
+          if (dest_number > h && dest_number <= old_number &&
+              can_change(dest)) {
+            ctx.push(dest);
+          }
+        });
+      },
+      katana::disable_conflict_detection(),
+      katana::chunk_size<KCorePlan::kChunkSize>(),
+      katana::loopname("KCore Incremental Descent"));
+}
+
+/**
+ * Find the nodes whose core number may rise once the round's edges with the
+ * given roots are inserted: those connected to a root by nodes of the same
+ * core number, all with more neighbors of at least that number than it.
+ *
+ * @param graph Graph to operate on
+ * @param neighbors Neighbors of the nodes in graph, with the round's edges
+ * @param roots Roots of the edges of the round
+ * @returns The nodes, sorted
+ */
+std::vector<uint32_t>
+SubcoreCandidates(
+    CoreNumberGraph* graph, const IncrementalNeighbors& neighbors,
+    const std::vector<uint32_t>& roots) {
+  auto core = [&](uint32_t node) {
+    return graph->GetData<KCoreNodeAtomicCoreNumber>(node).load(
+        std::memory_order_relaxed);
+  };
+  auto can_rise = [&](uint32_t node) {
+    uint32_t number = core(node);
+    uint32_t count = 0;
+    neighbors.ForEach(
+        node, [&](uint32_t dest) { count += core(dest) >= number; });
+    return count > number;
+  };
+
+  std::vector<uint32_t> frontier;
+  for (uint32_t root : roots) {
+    if (can_rise(root)) {
+      frontier.emplace_back(root);
+    }
+  }
+  std::sort(frontier.begin(), frontier.end());
+  frontier.erase(std::unique(frontier.begin(), frontier.end()), frontier.end());
+  std::vector<uint32_t> visited = frontier;
+
+  while (!frontier.empty()) {
+    katana::InsertBag<uint32_t> reached;
+    katana::do_all(
+        katana::iterate(frontier),
+        [&](uint32_t node) {
+          uint32_t number = core(node);
+          neighbors.ForEach(node, [&](uint32_t dest) {
+            if (core(dest) == number &&
+                !std::binary_search(visited.begin(), visited.end(), dest) &&
+                can_rise(dest)) {
+              reached.push(dest);
+            }
+          });
+        },
+        katana::steal(), katana::loopname("KCore Incremental Subcore"));
+
+    frontier.assign(reached.begin(), reached.end());
+    katana::ParallelSTL::sort(frontier.begin(), frontier.end());
+    frontier.erase(
+        std::unique(frontier.begin(), frontier.end()), frontier.end());
+    std::vector<uint32_t> merged(visited.size() + frontier.size());
+    std::merge(
+        visited.begin(), visited.end(), frontier.begin(), frontier.end(),
+        merged.begin());
+    visited = std::move(merged);
+  }
+  return visited;
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::KCoreNumbersIncremental(
+    katana::PropertyGraph* pg, const std::string& core_number_property_name,
+    const EdgeList& inserted_edges, const EdgeList& deleted_edges) {
+  for (const auto& edges : {&inserted_edges, &deleted_edges}) {
+    for (const auto& [src, dest] : *edges) {
+      if (src >= pg->num_nodes() || dest >= pg->num_nodes()) {
+        return KATANA_ERROR(
+            katana::ErrorCode::InvalidArgument,
+            "edge ({}, {}) is out of range", src, dest);
+      }
+      if (src == dest) {
+        return KATANA_ERROR(
+            katana::ErrorCode::InvalidArgument,
+            "self loop on {} is not supported", src);
+      }
+    }
+  }
+
+  auto graph = KATANA_CHECKED(
+      CoreNumberGraph::Make(pg, {core_number_property_name}, {}));
+  auto core = [&](uint32_t node) -> auto& {
+    return graph.GetData<KCoreNodeAtomicCoreNumber>(node);
+  };
+
+  katana::StatTimer exec_time("KCoreIncremental");
+  exec_time.start();
+
+  //! Deletions first, on the graph without the inserted edges: the old core
+  //! numbers bound the new ones from above.
+  IncrementalNeighbors neighbors(graph);
+  for (const auto& [src, dest] : inserted_edges) {
+    neighbors.Exclude(src, dest);
+  }
+  std::vector<uint32_t> ends;
+  for (const auto& [src, dest] : deleted_edges) {
+    ends.emplace_back(src);
+    ends.emplace_back(dest);
+  }
+  std::sort(ends.begin(), ends.end());
+  ends.erase(std::unique(ends.begin(), ends.end()), ends.end());
+  CoreNumberDescent(&graph, neighbors, ends, [](uint32_t) { return true; });
+
+  //! Insertions in rounds of edges that share no root
+  EdgeList pending = inserted_edges;
+  while (!pending.empty()) {
+    std::vector<uint32_t> roots;
+    std::unordered_set<uint32_t> taken;
+    EdgeList deferred;
+    for (const auto& edge : pending) {
+      const auto& [src, dest] = edge;
+      uint32_t src_number = core(src).load(std::memory_order_relaxed);
+      uint32_t dest_number = core(dest).load(std::memory_order_relaxed);
+      bool src_is_root = src_number <= dest_number;
+      bool dest_is_root = dest_number <= src_number;
+      if ((src_is_root && taken.count(src)) ||
+          (dest_is_root && taken.count(dest))) {
+        deferred.emplace_back(edge);
+        continue;
+      }
+      if (src_is_root) {
+        taken.insert(src);
+        roots.emplace_back(src);
+      }
+      if (dest_is_root) {
+        taken.insert(dest);
+        roots.emplace_back(dest);
+      }
+      neighbors.Include(src, dest);
+    }
+    pending = std::move(deferred);
+
+    std::vector<uint32_t> candidates =
+        SubcoreCandidates(&graph, neighbors, roots);
+    katana::do_all(
+        katana::iterate(candidates),
+        [&](uint32_t node) {
+          core(node).fetch_add(1, std::memory_order_relaxed);
+        },
+        katana::no_stats());
+    CoreNumberDescent(&graph, neighbors, candidates, [&](uint32_t node) {
+      return std::binary_search(candidates.begin(), candidates.end(), node);
+    });
+  }
+
+  exec_time.stop();
+  return katana::ResultSuccess();
+}
+
 // Doxygen doesn't correctly handle implementation annotations that do not
 // appear in the declaration.
 /// \cond DO_NOT_DOCUMENT
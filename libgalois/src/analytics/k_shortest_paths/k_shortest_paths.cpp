@@ -0,0 +1,481 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2020, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "katana/analytics/k_shortest_paths/k_shortest_paths.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <optional>
+#include <queue>
+#include <set>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "katana/AtomicHelpers.h"
+#include "katana/Bag.h"
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/Reduction.h"
+#include "katana/Timer.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Node = uint32_t;
+
+constexpr unsigned kChunkSize = 64;
+constexpr Node kNoNode = std::numeric_limits<Node>::max();
+
+/// A path from the source to the target. prefix[i] is the distance from the
+/// source to nodes[i], and the path was found by a spur search from
+/// nodes[deviation].
+template <typename Dist>
+struct Candidate {
+  Dist distance;
+  std::vector<Node> nodes;
+  std::vector<Dist> prefix;
+  size_t deviation;
+
+  friend bool operator<(const Candidate& a, const Candidate& b) {
+    return a.distance != b.distance ? a.distance < b.distance
+                                    : a.nodes < b.nodes;
+  }
+};
+
+/// The shortest path tree to the target: the distance from each node to the
+/// target, and the next node on its tree path and the weight of the edge to
+/// it. Distances let spur searches be A* searches, and tree paths end them
+/// right away when allowed.
+template <typename Dist>
+struct ReverseTree {
+  static constexpr Dist kInfinity = std::numeric_limits<Dist>::max();
+
+  katana::NUMAArray<Dist> distance;
+  katana::NUMAArray<Node> next;
+  katana::NUMAArray<Dist> next_weight;
+};
+
+/// Compute the shortest path tree to target with delta-stepping over
+/// in-edges. Among the tight edges out of a node, the tree uses the one to
+/// the node with fewest tree edges to the target, then to the smallest ID,
+/// so the tree does not depend on the schedule.
+template <typename Dist, typename View, typename WeightFn>
+void
+ComputeReverseTree(
+    const View& view, const WeightFn& weight, Node target, unsigned delta,
+    ReverseTree<Dist>* tree) {
+  constexpr Dist kInfinity = ReverseTree<Dist>::kInfinity;
+  uint64_t num_nodes = view.num_nodes();
+
+  katana::NUMAArray<std::atomic<Dist>> distance;
+  distance.allocateBlocked(num_nodes);
+  tree->distance.allocateBlocked(num_nodes);
+  tree->next.allocateBlocked(num_nodes);
+  tree->next_weight.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        distance[n].store(kInfinity, std::memory_order_relaxed);
+        tree->next[n] = kNoNode;
+      },
+      katana::no_stats());
+  distance[target].store(0, std::memory_order_relaxed);
+
+  struct UpdateRequest {
+    Node node;
+    Dist distance;
+  };
+  struct UpdateRequestIndexer {
+    unsigned shift;
+    unsigned int operator()(const UpdateRequest& req) const {
+      return static_cast<uint64_t>(req.distance) >> shift;
+    }
+  };
+  using OBIM = katana::OrderedByIntegerMetric<
+      UpdateRequestIndexer, katana::PerSocketChunkFIFO<kChunkSize>>;
+
+  katana::InsertBag<UpdateRequest> init;
+  init.push(UpdateRequest{target, 0});
+  katana::for_each(
+      katana::iterate(init),
+      [&](const UpdateRequest& req, auto& ctx) {
+        if (distance[req.node].load(std::memory_order_relaxed) <
+            req.distance) {
+          return;
+        }
+        for (auto e : view.in_edges(req.node)) {
+          Node src = view.in_edge_dest(e);
+          Dist new_dist = req.distance + weight(view.in_edge_property_index(e));
+          if (katana::atomicMin(distance[src], new_dist) > new_dist) {
+            ctx.push(UpdateRequest{src, new_dist});
+          }
+        }
+      },
+      katana::wl<OBIM>(UpdateRequestIndexer{delta}),
+      katana::disable_conflict_detection(),
+      katana::loopname("KShortestPaths-ReverseSssp"));
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        tree->distance[n] = distance[n].load(std::memory_order_relaxed);
+      },
+      katana::no_stats());
+
+  // Build the tree a level of tree edges at a time
+  katana::NUMAArray<std::atomic<Node>> parent;
+  parent.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { parent[n].store(kNoNode, std::memory_order_relaxed); },
+      katana::no_stats());
+  tree->next[target] = target;
+  tree->next_weight[target] = 0;
+
+  auto frontier = std::make_unique<katana::InsertBag<Node>>();
+  auto reached = std::make_unique<katana::InsertBag<Node>>();
+  frontier->push(target);
+  while (!frontier->empty()) {
+    katana::do_all(
+        katana::iterate(*frontier),
+        [&](Node node) {
+          for (auto e : view.in_edges(node)) {
+            Node src = view.in_edge_dest(e);
+            Dist w = weight(view.in_edge_property_index(e));
+            if (tree->next[src] == kNoNode &&
+                tree->distance[node] + w == tree->distance[src]) {
+              if (katana::atomicMin(parent[src], node) == kNoNode) {
+                reached->push(src);
+              }
+            }
+          }
+        },
+        katana::steal(), katana::loopname("KShortestPaths-ReverseTree"));
+    frontier->clear();
+
+    katana::do_all(
+        katana::iterate(*reached),
+        [&](Node src) {
+          Node next = parent[src].load(std::memory_order_relaxed);
+          Dist w = kInfinity;
+          for (auto e : view.edges(src)) {
+            if (view.edge_dest(e) == next) {
+              Dist candidate = weight(view.edge_property_index(e));
+              if (tree->distance[next] + candidate == tree->distance[src]) {
+                w = std::min(w, candidate);
+              }
+            }
+          }
+          tree->next[src] = next;
+          tree->next_weight[src] = w;
+          frontier->push(src);
+        },
+        katana::steal(), katana::loopname("KShortestPaths-ReverseTreeLink"));
+    reached->clear();
+  }
+}
+
+/// Find a shortest path from nodes[spur] of path to the target that avoids
+/// the nodes before the spur node in path and does not start with an edge to
+/// a node in blocked_next, with a distance from the source of at most
+/// bound. With a tree, the tree path from the spur node is used when it is
+/// allowed, and an A* search guided by the tree distances otherwise; without
+/// one, this is a Dijkstra search.
+template <typename Dist, typename View, typename WeightFn>
+std::optional<Candidate<Dist>>
+SpurPath(
+    const View& view, const WeightFn& weight, const ReverseTree<Dist>* tree,
+    Node target, const Candidate<Dist>& path,
+    const std::unordered_map<Node, size_t>& position, size_t spur,
+    const std::vector<Node>& blocked_next, Dist bound) {
+  constexpr Dist kInfinity = ReverseTree<Dist>::kInfinity;
+  Node spur_node = path.nodes[spur];
+  Dist root_distance = path.prefix[spur];
+
+  auto is_root = [&](Node n) {
+    auto it = position.find(n);
+    return it != position.end() && it->second < spur;
+  };
+  auto is_blocked_next = [&](Node n) {
+    return std::find(blocked_next.begin(), blocked_next.end(), n) !=
+           blocked_next.end();
+  };
+  // A lower bound on the distance from n to the target
+  auto estimate_to_target = [&](Node n) -> Dist {
+    return tree ? tree->distance[n] : 0;
+  };
+
+  Candidate<Dist> ret;
+  ret.nodes.assign(path.nodes.begin(), path.nodes.begin() + spur);
+  ret.prefix.assign(path.prefix.begin(), path.prefix.begin() + spur);
+  ret.deviation = spur;
+
+  if (tree && (tree->distance[spur_node] == kInfinity ||
+               root_distance + tree->distance[spur_node] > bound)) {
+    return std::nullopt;
+  }
+
+  // The tree path is a shortest path even without the blocked nodes and
+  // edges, so it is the answer if it avoids them
+  if (tree && !is_blocked_next(tree->next[spur_node])) {
+    bool allowed = true;
+    for (Node n = tree->next[spur_node]; n != target; n = tree->next[n]) {
+      if (is_root(n)) {
+        allowed = false;
+        break;
+      }
+    }
+    if (allowed) {
+      Dist distance = root_distance;
+      for (Node n = spur_node;; n = tree->next[n]) {
+        ret.nodes.emplace_back(n);
+        ret.prefix.emplace_back(distance);
+        if (n == target) {
+          break;
+        }
+        distance += tree->next_weight[n];
+      }
+      ret.distance = distance;
+      return ret;
+    }
+  }
+
+  struct Visit {
+    Node from;
+    Dist distance;
+  };
+  using QueueItem = std::pair<Dist, Node>;
+  std::unordered_map<Node, Visit> visited;
+  std::priority_queue<
+      QueueItem, std::vector<QueueItem>, std::greater<QueueItem>>
+      queue;
+  visited.emplace(spur_node, Visit{spur_node, 0});
+  queue.emplace(estimate_to_target(spur_node), spur_node);
+
+  while (!queue.empty()) {
+    auto [estimate, u] = queue.top();
+    queue.pop();
+    Dist g = visited.at(u).distance;
+    if (estimate > g + estimate_to_target(u)) {
+      continue;
+    }
+    if (u == target) {
+      std::vector<Node> spur_nodes;
+      for (Node n = u;; n = visited.at(n).from) {
+        spur_nodes.emplace_back(n);
+        if (n == spur_node) {
+          break;
+        }
+      }
+      std::reverse(spur_nodes.begin(), spur_nodes.end());
+      for (Node n : spur_nodes) {
+        ret.nodes.emplace_back(n);
+        ret.prefix.emplace_back(root_distance + visited.at(n).distance);
+      }
+      ret.distance = root_distance + g;
+      return ret;
+    }
+
+    for (auto e : view.edges(u)) {
+      Node v = view.edge_dest(e);
+      if ((tree && tree->distance[v] == kInfinity) || is_root(v) ||
+          (u == spur_node && is_blocked_next(v))) {
+        continue;
+      }
+      Dist new_dist = g + weight(view.edge_property_index(e));
+      if (root_distance + new_dist + estimate_to_target(v) > bound) {
+        continue;
+      }
+      auto [it, inserted] = visited.try_emplace(v, Visit{u, new_dist});
+      if (!inserted) {
+        if (new_dist >= it->second.distance) {
+          continue;
+        }
+        it->second = Visit{u, new_dist};
+      }
+      queue.emplace(new_dist + estimate_to_target(v), v);
+    }
+  }
+  return std::nullopt;
+}
+
+/// Yen's algorithm. With Lawler's rule, only the spur nodes from the
+/// deviation of the last path on are searched; the AStar plan also guides
+/// the spur searches by the shortest path tree to the target.
+template <typename Dist, typename View, typename WeightFn>
+std::vector<SsspPath>
+YenKShortestPaths(
+    const View& view, const WeightFn& weight, Node source, Node target,
+    uint32_t k, const KShortestPathsPlan& plan) {
+  constexpr Dist kInfinity = ReverseTree<Dist>::kInfinity;
+  std::vector<SsspPath> ret;
+  bool lawler = plan.algorithm() != KShortestPathsPlan::kYen;
+
+  std::optional<ReverseTree<Dist>> tree;
+  if (plan.algorithm() == KShortestPathsPlan::kAStar) {
+    tree.emplace();
+    ComputeReverseTree(view, weight, target, plan.delta(), &*tree);
+    if (tree->distance[source] == kInfinity) {
+      return ret;
+    }
+  }
+  const ReverseTree<Dist>* tree_ptr = tree ? &*tree : nullptr;
+
+  std::vector<Candidate<Dist>> paths;
+  std::set<Candidate<Dist>> candidates;
+  Candidate<Dist> root;
+  root.nodes.emplace_back(source);
+  root.prefix.emplace_back(0);
+  root.deviation = 0;
+  auto first = SpurPath(
+      view, weight, tree_ptr, target, root, {}, 0, {},
+      std::numeric_limits<Dist>::max());
+  if (!first) {
+    return ret;
+  }
+  paths.emplace_back(std::move(*first));
+
+  while (paths.size() < k) {
+    const Candidate<Dist>& last = paths.back();
+    std::unordered_map<Node, size_t> position;
+    for (size_t i = 0; i < last.nodes.size(); ++i) {
+      position.emplace(last.nodes[i], i);
+    }
+
+    // Candidates beyond the number of paths still needed are useless
+    size_t needed = k - paths.size();
+    Dist bound = std::numeric_limits<Dist>::max();
+    if (candidates.size() >= needed) {
+      bound = std::next(candidates.begin(), needed - 1)->distance;
+    }
+
+    size_t num_spurs = last.nodes.size() - 1;
+    std::vector<std::optional<Candidate<Dist>>> spurs(num_spurs);
+    katana::do_all(
+        katana::iterate(lawler ? last.deviation : 0, num_spurs),
+        [&](size_t spur) {
+          // Block the next node of every path with the same root
+          std::vector<Node> blocked_next;
+          for (const auto& p : paths) {
+            if (p.nodes.size() > spur + 1 &&
+                std::equal(
+                    last.nodes.begin(), last.nodes.begin() + spur + 1,
+                    p.nodes.begin())) {
+              blocked_next.emplace_back(p.nodes[spur + 1]);
+            }
+          }
+          spurs[spur] = SpurPath(
+              view, weight, tree_ptr, target, last, position, spur,
+              blocked_next, bound);
+        },
+        katana::steal(), katana::chunk_size<1>(),
+        katana::loopname("KShortestPaths-Spur"));
+
+    for (auto& spur : spurs) {
+      if (spur) {
+        candidates.emplace(std::move(*spur));
+      }
+    }
+    if (candidates.empty()) {
+      break;
+    }
+    auto next = candidates.extract(candidates.begin());
+    paths.emplace_back(std::move(next.value()));
+  }
+
+  for (const auto& path : paths) {
+    ret.emplace_back(
+        SsspPath{path.nodes, static_cast<double>(path.distance)});
+  }
+  return ret;
+}
+
+template <typename Weight>
+katana::Result<std::vector<SsspPath>>
+KShortestPathsWithWeight(
+    katana::PropertyGraph* pg, uint32_t source, uint32_t target, uint32_t k,
+    const std::string& edge_weight_property_name, KShortestPathsPlan plan) {
+  // Sum integer weights exactly
+  using Dist = std::conditional_t<
+      std::is_floating_point_v<Weight>, double,
+      std::conditional_t<std::is_signed_v<Weight>, int64_t, uint64_t>>;
+
+  auto weights = KATANA_CHECKED(
+      pg->GetEdgePropertyTyped<Weight>(edge_weight_property_name));
+  if constexpr (std::is_signed_v<Weight>) {
+    katana::GReduceLogicalOr negative;
+    katana::do_all(
+        katana::iterate(int64_t{0}, weights->length()),
+        [&](int64_t i) { negative.update(weights->Value(i) < 0); },
+        katana::no_stats());
+    if (negative.reduce()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "edge weights must not be negative");
+    }
+  }
+
+  auto view = pg->BuildView<katana::PropertyGraphViews::BiDirectional>();
+  auto weight = [&](uint64_t property_index) {
+    return static_cast<Dist>(weights->Value(property_index));
+  };
+
+  katana::StatTimer exec_time("KShortestPaths");
+  exec_time.start();
+  std::vector<SsspPath> paths;
+  switch (plan.algorithm()) {
+  case KShortestPathsPlan::kYen:
+  case KShortestPathsPlan::kLawler:
+  case KShortestPathsPlan::kAStar:
+    paths = YenKShortestPaths<Dist>(view, weight, source, target, k, plan);
+    break;
+  default:
+    return katana::ErrorCode::InvalidArgument;
+  }
+  exec_time.stop();
+  return paths;
+}
+
+}  // namespace
+
+katana::Result<std::vector<SsspPath>>
+katana::analytics::KShortestPaths(
+    PropertyGraph* pg, uint32_t source, uint32_t target, uint32_t k,
+    const std::string& edge_weight_property_name, KShortestPathsPlan plan) {
+  if (source >= pg->num_nodes() || target >= pg->num_nodes()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "{} or {} is not a node", source,
+        target);
+  }
+  if (k == 0) {
+    return std::vector<SsspPath>{};
+  }
+  if (source == target) {
+    return std::vector<SsspPath>{SsspPath{{source}, 0}};
+  }
+  return DispatchOnEdgePropertyType(
+      pg, edge_weight_property_name, [&](auto tag) {
+        return KShortestPathsWithWeight<decltype(tag)>(
+            pg, source, target, k, edge_weight_property_name, plan);
+      });
+}
@@ -19,7 +19,14 @@
 
 #include "katana/analytics/k_truss/k_truss.h"
 
+#include <atomic>
+#include <limits>
+
 #include "katana/ArrowRandomAccessBuilder.h"
+#include "katana/AtomicHelpers.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Reduction.h"
 #include "katana/TypedPropertyGraph.h"
 
 using namespace katana::analytics;
@@ -29,6 +36,8 @@ using NodeData = std::tuple<>;
 struct EdgeFlag : public katana::PODProperty<uint32_t> {};
 using EdgeData = std::tuple<EdgeFlag>;
 
+struct EdgeTrussNumber : public katana::PODProperty<uint32_t> {};
+
 typedef katana::TypedPropertyGraph<NodeData, EdgeData> Graph;
 typedef typename Graph::Node GNode;
 
@@ -177,7 +186,7 @@ BSPTrussJacobiAlgo(SortedGraphView* g, uint32_t k) {
         katana::iterate(*cur),
         PickUnsupportedEdges{g, k - 2, unsupported, *next}, katana::steal());
 
-    if (std::distance(unsupported.begin(), unsupported.end()) == 0) {
+    if (unsupported.empty()) {
       break;
     }
 
@@ -247,14 +256,14 @@ BSPTrussAlgo(SortedGraphView* g, unsigned int k) {
         }
       },
       katana::steal());
-  curSize = std::distance(cur->begin(), cur->end());
+  curSize = cur->size();
 
   //! Remove unsupported edges until no more edges can be removed.
   while (true) {
     katana::do_all(
         katana::iterate(*cur), KeepSupportedEdges{g, k - 2, *next},
         katana::steal());
-    nextSize = std::distance(next->begin(), next->end());
+    nextSize = next->size();
 
     if (curSize == nextSize) {
       //! Every edge in *cur is kept, done
@@ -301,7 +310,7 @@ BSPCoreAlgo(SortedGraphView* g, uint32_t k) {
 
   katana::do_all(
       katana::iterate(*g), KeepValidNodes{g, k, *next}, katana::steal());
-  nextSize = std::distance(next->begin(), next->end());
+  nextSize = next->size();
 
   while (curSize != nextSize) {
     cur->clear();
@@ -310,7 +319,7 @@ BSPCoreAlgo(SortedGraphView* g, uint32_t k) {
 
     katana::do_all(
         katana::iterate(*cur), KeepValidNodes{g, k, *next}, katana::steal());
-    nextSize = std::distance(next->begin(), next->end());
+    nextSize = next->size();
   }
   return katana::ResultSuccess();
 }
@@ -344,6 +353,226 @@ BSPCoreThenTrussAlgo(SortedGraphView* g, uint32_t k) {
   return katana::ResultSuccess();
 }
 
+/**
+ * Call fn(e_uw, e_vw) for each common neighbor w of src and dest other than
+ * themselves, with e_uw and e_vw the edges from src and from dest to w.
+ */
+template <typename View, typename Fn>
+void
+ForEachTriangleEdge(
+    const View& g, typename View::Node src, typename View::Node dest,
+    const Fn& fn) {
+  auto srcI = g.edges(src).begin(), srcE = g.edges(src).end(),
+       dstI = g.edges(dest).begin(), dstE = g.edges(dest).end();
+  while (srcI != srcE && dstI != dstE) {
+    auto sN = g.edge_dest(*srcI), dN = g.edge_dest(*dstI);
+    if (sN < dN) {
+      ++srcI;
+    } else if (dN < sN) {
+      ++dstI;
+    } else {
+      if (sN != src && sN != dest) {
+        fn(*srcI, *dstI);
+      }
+      ++srcI;
+      ++dstI;
+    }
+  }
+}
+
+/// An edge being peeled, in either direction
+template <typename View>
+struct PeelEdge {
+  typename View::Node src;
+  typename View::Edge edge;
+};
+
+/**
+ * Compute the trussness of every edge: the largest k such that the edge is
+ * in the k-truss. Edges are peeled in rounds by increasing support, the
+ * number of triangles left that hold them; peeling an edge lowers the support
+ * of the other two edges of each of its triangles, and edges whose support
+ * falls to the current level join the next round. Support and trussness are
+ * kept per undirected edge in arrays indexed by the property index of its
+ * direction from its smaller endpoint, so support is counted by intersecting
+ * adjacency lists only once per edge and then maintained incrementally.
+ *
+ * @param g Graph to operate on, with edges sorted by destination
+ * @returns trussness of every edge, indexed by edge property index
+ */
+template <typename View>
+katana::NUMAArray<uint32_t>
+TrussDecomposition(const View& g) {
+  using Node = typename View::Node;
+  using Edge = PeelEdge<View>;
+  constexpr uint32_t kUnpeeled = std::numeric_limits<uint32_t>::max();
+
+  uint64_t num_edges = g.num_edges();
+  katana::NUMAArray<uint64_t> canonical;
+  katana::NUMAArray<std::atomic<uint32_t>> support;
+  katana::NUMAArray<uint32_t> round;
+  katana::NUMAArray<uint32_t> trussness;
+  canonical.allocateBlocked(num_edges);
+  support.allocateBlocked(num_edges);
+  round.allocateBlocked(num_edges);
+  trussness.allocateBlocked(num_edges);
+  katana::ParallelSTL::fill(round.begin(), round.end(), kUnpeeled);
+  //! Edges in no triangle, including self loops, are in the 2-truss.
+  katana::ParallelSTL::fill(trussness.begin(), trussness.end(), 2);
+
+  auto remaining = std::make_unique<katana::InsertBag<Edge>>();
+  katana::do_all(
+      katana::iterate(g),
+      [&](Node n) {
+        for (auto e : g.edges(n)) {
+          auto dest = g.edge_dest(e);
+          auto index = g.edge_property_index(e);
+          if (dest > n) {
+            canonical[index] = index;
+            remaining->push(Edge{n, e});
+          } else if (dest < n) {
+            canonical[index] =
+                g.edge_property_index(*g.find_edge(dest, n));
+          } else {
+            canonical[index] = index;
+          }
+        }
+      },
+      katana::steal(), katana::loopname("KTruss Canonical Edges"));
+
+  auto index_of = [&](const Edge& e) {
+    return canonical[g.edge_property_index(e.edge)];
+  };
+
+  katana::do_all(
+      katana::iterate(*remaining),
+      [&](const Edge& e) {
+        uint32_t count = 0;
+        ForEachTriangleEdge(
+            g, e.src, g.edge_dest(e.edge), [&](auto, auto) { ++count; });
+        support[index_of(e)] = count;
+      },
+      katana::steal(), katana::loopname("KTruss Support"));
+
+  auto current = std::make_unique<katana::InsertBag<Edge>>();
+  auto next = std::make_unique<katana::InsertBag<Edge>>();
+  uint32_t num_rounds = 0;
+
+  while (!remaining->empty()) {
+    katana::GReduceMin<uint32_t> min_support;
+    katana::do_all(
+        katana::iterate(*remaining),
+        [&](const Edge& e) {
+          min_support.update(support[index_of(e)]);
+        },
+        katana::loopname("KTruss Level"), katana::no_stats());
+    uint32_t level = min_support.reduce();
+
+    katana::do_all(
+        katana::iterate(*remaining),
+        [&](const Edge& e) {
+          if (support[index_of(e)] <= level) {
+            current->push(e);
+          }
+        },
+        katana::loopname("KTruss Level Edges"), katana::no_stats());
+
+    while (!current->empty()) {
+      uint32_t r = num_rounds++;
+      katana::do_all(
+          katana::iterate(*current),
+          [&](const Edge& e) {
+            auto index = index_of(e);
+            round[index] = r;
+            trussness[index] = level + 2;
+          },
+          katana::loopname("KTruss Peel"), katana::no_stats());
+
+      auto decrement = [&](uint64_t index, const Edge& e) {
+        if (katana::atomicSub(support[index], 1u) == level + 1) {
+          //! This thread put the support at the level.
+          next->push(e);
+        }
+      };
+      katana::do_all(
+          katana::iterate(*current),
+          [&](const Edge& e) {
+            auto self = index_of(e);
+            auto dest = g.edge_dest(e.edge);
+            ForEachTriangleEdge(
+                g, e.src, dest, [&](auto e_uw, auto e_vw) {
+                  auto a = canonical[g.edge_property_index(e_uw)];
+                  auto b = canonical[g.edge_property_index(e_vw)];
+                  uint32_t round_a = round[a];
+                  uint32_t round_b = round[b];
+                  if (round_a < r || round_b < r) {
+                    //! The triangle went with an edge of an earlier round.
+                    return;
+                  }
+                  //! A triangle with two edges in this round lowers the
+                  //! third only once, from the edge of smaller index.
+                  if (round_a != r && (round_b != r || self < b)) {
+                    decrement(a, Edge{e.src, e_uw});
+                  }
+                  if (round_b != r && (round_a != r || self < a)) {
+                    decrement(b, Edge{dest, e_vw});
+                  }
+                });
+          },
+          katana::steal(), katana::loopname("KTruss Decomposition"));
+
+      current->clear();
+      std::swap(current, next);
+    }
+
+    auto left = std::make_unique<katana::InsertBag<Edge>>();
+    katana::do_all(
+        katana::iterate(*remaining),
+        [&](const Edge& e) {
+          if (round[index_of(e)] == kUnpeeled) {
+            left->push(e);
+          }
+        },
+        katana::loopname("KTruss Remaining"), katana::no_stats());
+    std::swap(remaining, left);
+  }
+
+  //! Copy the trussness of each edge to its other direction.
+  katana::do_all(
+      katana::iterate(g),
+      [&](Node n) {
+        for (auto e : g.edges(n)) {
+          auto index = g.edge_property_index(e);
+          trussness[index] = trussness[canonical[index]];
+        }
+      },
+      katana::steal(), katana::loopname("KTruss Copy Trussness"));
+
+  return trussness;
+}
+
+/// TrussDecompositionAlgo:
+/// 1. Compute the trussness of each edge.
+/// 2. Remove edges whose trussness is below k.
+katana::Result<void>
+TrussDecompositionAlgo(SortedGraphView* g, uint32_t k) {
+  if (k <= 2) {
+    return katana::ErrorCode::InvalidArgument;
+  }
+
+  katana::NUMAArray<uint32_t> trussness = TrussDecomposition(*g);
+  katana::do_all(
+      katana::iterate(*g),
+      [&](GNode n) {
+        for (auto e : g->edges(n)) {
+          g->template GetEdgeData<EdgeFlag>(e) =
+              trussness[g->edge_property_index(e)] >= k ? valid : removed;
+        }
+      },
+      katana::steal());
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 katana::analytics::KTruss(
     katana::PropertyGraph* pg, uint32_t k_truss_number,
@@ -387,11 +616,43 @@ katana::analytics::KTruss(
     return BSPTrussJacobiAlgo(&graph, k_truss_number);
   case KTrussPlan::kBspCoreThenTruss:
     return BSPCoreThenTrussAlgo(&graph, k_truss_number);
+  case KTrussPlan::kTrussDecomposition:
+    return TrussDecompositionAlgo(&graph, k_truss_number);
   default:
     return katana::ErrorCode::InvalidArgument;
   }
 }
 
+katana::Result<void>
+katana::analytics::KTrussNumbers(
+    katana::PropertyGraph* pg, const std::string& output_property_name) {
+  katana::ReportPageAllocGuard page_alloc;
+
+  using TrussNumberGraphView = katana::TypedPropertyGraphView<
+      katana::PropertyGraphViews::EdgesSortedByDestID, NodeData,
+      std::tuple<EdgeTrussNumber>>;
+  KATANA_CHECKED(ConstructEdgeProperties<std::tuple<EdgeTrussNumber>>(
+      pg, {output_property_name}));
+  auto graph = KATANA_CHECKED(
+      TrussNumberGraphView::Make(pg, {}, {output_property_name}));
+
+  katana::StatTimer exec_time("KTruss");
+  exec_time.start();
+  katana::NUMAArray<uint32_t> trussness = TrussDecomposition(graph);
+  exec_time.stop();
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](GNode n) {
+        for (auto e : graph.edges(n)) {
+          graph.GetEdgeData<EdgeTrussNumber>(e) =
+              trussness[graph.edge_property_index(e)];
+        }
+      },
+      katana::steal(), katana::loopname("KTruss Write Truss Numbers"));
+  return katana::ResultSuccess();
+}
+
 // Doxygen doesn't correctly handle implementation annotations that do not
 // appear in the declaration.
 /// \cond DO_NOT_DOCUMENT
@@ -0,0 +1,288 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2020, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "katana/analytics/label_propagation/label_propagation.h"
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+#include <vector>
+
+#include "katana/Bag.h"
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+#include "katana/Statistics.h"
+#include "katana/Timer.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using View = katana::PropertyGraphViews::BiDirectional;
+
+/// Neighborhoods with at most this many labels are counted by linear search,
+/// larger ones by sorting
+constexpr size_t kLinearLabels = 32;
+
+/// The per-thread buffers in which the labels of a neighborhood are counted
+struct Histogram {
+  std::vector<uint32_t> labels;
+  std::vector<std::pair<uint32_t, uint32_t>> counts;
+
+  /// The most frequent label, preferring current and then the smallest label
+  /// among ties; current if there are no labels
+  uint32_t MostFrequent(uint32_t current) {
+    counts.clear();
+    if (labels.size() <= kLinearLabels) {
+      for (uint32_t label : labels) {
+        auto it = std::find_if(counts.begin(), counts.end(), [&](auto& c) {
+          return c.first == label;
+        });
+        if (it == counts.end()) {
+          counts.emplace_back(label, 1);
+        } else {
+          it->second += 1;
+        }
+      }
+    } else {
+      std::sort(labels.begin(), labels.end());
+      for (uint32_t label : labels) {
+        if (counts.empty() || counts.back().first != label) {
+          counts.emplace_back(label, 0);
+        }
+        counts.back().second += 1;
+      }
+    }
+
+    uint32_t best = current;
+    uint32_t best_count = 0;
+    for (const auto& [label, count] : counts) {
+      if (label == current && count >= best_count) {
+        best = label;
+        best_count = count;
+      } else if (
+          count > best_count ||
+          (count == best_count && best != current && label < best)) {
+        best = label;
+        best_count = count;
+      }
+    }
+    return best;
+  }
+};
+
+/// Propagate labels from the frontier until few enough nodes change
+void
+Propagate(
+    const View& view, const LabelPropagationPlan& plan,
+    katana::NUMAArray<std::atomic<uint32_t>>* labels) {
+  const uint64_t num_nodes = view.num_nodes();
+  katana::NUMAArray<std::atomic<uint8_t>> queued;
+  queued.allocateBlocked(num_nodes);
+  katana::ParallelSTL::fill(queued.begin(), queued.end(), uint8_t{1});
+
+  katana::InsertBag<Node> frontier;
+  katana::do_all(
+      katana::iterate(view.all_nodes()), [&](Node n) { frontier.push(n); },
+      katana::no_stats());
+  katana::InsertBag<Node> next;
+  katana::PerThreadStorage<Histogram> histograms;
+
+  auto enqueue = [&](Node n) {
+    if (!queued[n].exchange(1, std::memory_order_relaxed)) {
+      next.push(n);
+    }
+  };
+
+  for (uint32_t round = 0; round < plan.max_iterations() && !frontier.empty();
+       ++round) {
+    katana::GAccumulator<uint64_t> changed;
+    katana::do_all(
+        katana::iterate(frontier),
+        [&](Node n) {
+          queued[n].store(0, std::memory_order_relaxed);
+          Histogram& histogram = *histograms.getLocal();
+          histogram.labels.clear();
+          for (auto e : view.edges(n)) {
+            if (Node d = view.edge_dest(e); d != n) {
+              histogram.labels.emplace_back(
+                  (*labels)[d].load(std::memory_order_relaxed));
+            }
+          }
+          for (auto e : view.in_edges(n)) {
+            if (Node d = view.in_edge_dest(e); d != n) {
+              histogram.labels.emplace_back(
+                  (*labels)[d].load(std::memory_order_relaxed));
+            }
+          }
+
+          uint32_t current = (*labels)[n].load(std::memory_order_relaxed);
+          uint32_t label = histogram.MostFrequent(current);
+          if (label == current) {
+            return;
+          }
+          (*labels)[n].store(label, std::memory_order_relaxed);
+          changed += 1;
+          for (auto e : view.edges(n)) {
+            enqueue(view.edge_dest(e));
+          }
+          for (auto e : view.in_edges(n)) {
+            enqueue(view.in_edge_dest(e));
+          }
+        },
+        katana::steal(), katana::no_stats(),
+        katana::loopname("LabelPropagation"));
+
+    frontier.clear();
+    frontier.swap(next);
+    if (changed.reduce() <
+        plan.changed_fraction_threshold() * static_cast<double>(num_nodes)) {
+      break;
+    }
+  }
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::LabelPropagation(
+    PropertyGraph* pg, const std::string& output_property_name,
+    LabelPropagationPlan plan) {
+  if (plan.algorithm() != LabelPropagationPlan::kFrontier) {
+    return katana::ErrorCode::InvalidArgument;
+  }
+  if (!(plan.changed_fraction_threshold() >= 0 &&
+        plan.changed_fraction_threshold() <= 1)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "changed fraction threshold must be in [0, 1], not {}",
+        plan.changed_fraction_threshold());
+  }
+  const uint64_t num_nodes = pg->num_nodes();
+  std::shared_ptr<arrow::Buffer> buffer =
+      KATANA_CHECKED(arrow::AllocateBuffer(num_nodes * sizeof(uint32_t)));
+  auto* output = reinterpret_cast<uint32_t*>(buffer->mutable_data());
+
+  {
+    View view = pg->BuildView<View>();
+    katana::StatTimer exec_time("LabelPropagation");
+    exec_time.start();
+    katana::NUMAArray<std::atomic<uint32_t>> labels;
+    labels.allocateBlocked(num_nodes);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) { labels[n].store(n, std::memory_order_relaxed); },
+        katana::no_stats());
+
+    Propagate(view, plan, &labels);
+
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) {
+          output[n] = labels[n].load(std::memory_order_relaxed);
+        },
+        katana::no_stats());
+    exec_time.stop();
+  }
+
+  auto array = std::make_shared<arrow::UInt32Array>(num_nodes, buffer);
+  return pg->AddNodeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field(output_property_name, arrow::uint32())}),
+      {array}));
+}
+
+katana::Result<void>
+katana::analytics::LabelPropagationAssertValid(
+    PropertyGraph* pg, const std::string& property_name) {
+  auto labels =
+      KATANA_CHECKED(pg->GetNodePropertyTyped<uint32_t>(property_name));
+  const uint64_t num_nodes = pg->num_nodes();
+
+  katana::GReduceLogicalOr wrong;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        if (labels->IsNull(n) || labels->Value(n) >= num_nodes) {
+          wrong.update(true);
+        }
+      },
+      katana::no_stats());
+  if (wrong.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed, "labels must be node IDs");
+  }
+  return katana::ResultSuccess();
+}
+
+void
+katana::analytics::LabelPropagationStatistics::Print(std::ostream& os) const {
+  os << "Total number of communities = " << total_communities << std::endl;
+  os << "Total number of non trivial communities = "
+     << total_non_trivial_communities << std::endl;
+  os << "Number of nodes in the largest community = "
+     << largest_community_size << std::endl;
+  os << "Ratio of nodes in the largest community = " << largest_community_ratio
+     << std::endl;
+}
+
+katana::Result<LabelPropagationStatistics>
+katana::analytics::LabelPropagationStatistics::Compute(
+    katana::PropertyGraph* pg, const std::string& property_name) {
+  KATANA_CHECKED(LabelPropagationAssertValid(pg, property_name));
+  auto labels =
+      KATANA_CHECKED(pg->GetNodePropertyTyped<uint32_t>(property_name));
+  const uint64_t num_nodes = pg->num_nodes();
+
+  // Labels are node IDs, so sizes can be counted by label
+  katana::NUMAArray<std::atomic<uint64_t>> sizes;
+  sizes.allocateBlocked(num_nodes);
+  katana::ParallelSTL::fill(sizes.begin(), sizes.end(), uint64_t{0});
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        sizes[labels->Value(n)].fetch_add(1, std::memory_order_relaxed);
+      },
+      katana::no_stats());
+
+  katana::GAccumulator<uint64_t> total;
+  katana::GAccumulator<uint64_t> non_trivial;
+  katana::GReduceMax<uint64_t> largest;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t size = sizes[n].load(std::memory_order_relaxed);
+        if (size > 0) {
+          total += 1;
+        }
+        if (size > 1) {
+          non_trivial += 1;
+        }
+        largest.update(size);
+      },
+      katana::no_stats());
+
+  uint64_t largest_size = largest.reduce();
+  double ratio = num_nodes > 0 ? double(largest_size) / num_nodes : 0;
+  return LabelPropagationStatistics{
+      total.reduce(), non_trivial.reduce(), largest_size, ratio};
+}
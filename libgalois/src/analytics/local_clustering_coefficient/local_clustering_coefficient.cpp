@@ -19,7 +19,12 @@
 
 #include "katana/analytics/local_clustering_coefficient/local_clustering_coefficient.h"
 
+#include <algorithm>
+#include <limits>
+#include <vector>
+
 #include "katana/AtomicHelpers.h"
+#include "katana/SetIntersection.h"
 
 using namespace katana::analytics;
 
@@ -36,6 +41,47 @@ using SortedGraphView =
     katana::TypedPropertyGraphView<SortedPropertyGraphView, NodeData, EdgeData>;
 using Node = SortedGraphView::Node;
 
+/**
+ * Calls fn(v, w) for every triangle (n, v, w) with w <= v <= n.
+ *
+ * For each neighbor v <= n, the neighbors of v up to v are intersected with
+ * the neighbors of n up to v. The neighbors of n are kept in bitmap if n is a
+ * hub.
+ */
+template <typename F>
+void
+ForEachOrderedTriangle(
+    const SortedGraphView& graph, Node n, katana::IntersectionBitmap* bitmap,
+    const F& fn) {
+  const Node* first = graph.dest_data() + *graph.edges(n).begin();
+  const Node* last = std::upper_bound(
+      first, graph.dest_data() + *graph.edges(n).end(), n);
+  size_t num_lower = last - first;
+
+  bool use_bitmap = num_lower >= katana::kIntersectBitmapMinSize;
+  if (use_bitmap) {
+    bitmap->Assign(first, num_lower, graph.num_nodes());
+  }
+
+  for (const Node* it_n = first; it_n != last; ++it_n) {
+    Node v = *it_n;
+    const Node* v_first = graph.dest_data() + *graph.edges(v).begin();
+    const Node* v_last = std::upper_bound(
+        v_first, graph.dest_data() + *graph.edges(v).end(), v);
+    size_t num_v = v_last - v_first;
+    size_t num_n = it_n - first + 1;
+    auto on_common = [&](Node dst_v) { fn(v, dst_v); };
+    if (use_bitmap) {
+      katana::ForEachCommon(*bitmap, first, num_n, v_first, num_v, on_common);
+    } else {
+      katana::ForEachCommon(first, num_n, v_first, num_v, on_common);
+    }
+  }
+  if (use_bitmap) {
+    bitmap->Clear();
+  }
+}
+
 struct LocalClusteringCoefficientAtomics {
   /**
    * Counts the number of triangles for each node
@@ -47,30 +93,14 @@ struct LocalClusteringCoefficientAtomics {
    */
   template <typename CountVec>
   void OrderedCountFunc(
-      const SortedGraphView& graph, Node n, CountVec* count_vec) {
+      const SortedGraphView& graph, Node n, katana::IntersectionBitmap* bitmap,
+      CountVec* count_vec) {
     // TODO(amber): replace with NodeIteratingAlgo for triangle counting
-    for (auto edges_n : graph.edges(n)) {
-      auto v = graph.edge_dest(edges_n);
-      if (v > n) {
-        break;
-      }
-      auto e_it_n = graph.edges(n).begin();
-
-      for (auto edges_v : graph.edges(v)) {
-        auto dst_v = graph.edge_dest(edges_v);
-        if (dst_v > v) {
-          break;
-        }
-        while (graph.edge_dest(*e_it_n) < dst_v) {
-          e_it_n++;
-        }
-        if (dst_v == graph.edge_dest(*e_it_n)) {
-          __sync_fetch_and_add(&(*count_vec)[n], uint32_t{1});
-          __sync_fetch_and_add(&(*count_vec)[v], uint32_t{1});
-          __sync_fetch_and_add(&(*count_vec)[dst_v], uint32_t{1});
-        }
-      }
-    }
+    ForEachOrderedTriangle(graph, n, bitmap, [&](Node v, Node dst_v) {
+      __sync_fetch_and_add(&(*count_vec)[n], uint32_t{1});
+      __sync_fetch_and_add(&(*count_vec)[v], uint32_t{1});
+      __sync_fetch_and_add(&(*count_vec)[dst_v], uint32_t{1});
+    });
   }
 
   void ComputeLocalClusteringCoefficient(SortedGraphView* graph) {
@@ -81,10 +111,11 @@ struct LocalClusteringCoefficientAtomics {
         per_node_triangles.begin(), per_node_triangles.end(), uint32_t{0});
 
     // Count triangles
+    katana::PerThreadStorage<katana::IntersectionBitmap> bitmaps;
     katana::do_all(
         katana::iterate(*graph),
         [&](const Node& n) {
-          OrderedCountFunc(*graph, n, &per_node_triangles);
+          OrderedCountFunc(*graph, n, bitmaps.getLocal(), &per_node_triangles);
         },
         katana::chunk_size<kChunkSize>(), katana::steal(),
         katana::loopname("TriangleCount_OrderedCountAlgo"));
@@ -132,30 +163,14 @@ struct LocalClusteringCoefficientPerThread {
  * is sorted.
  */
   void OrderedCountFunc(
-      const SortedGraphView& graph, Node n, IterPair per_thread_count_range) {
+      const SortedGraphView& graph, Node n, katana::IntersectionBitmap* bitmap,
+      IterPair per_thread_count_range) {
     // TODO(amber): replace with NodeIteratingAlgo for triangle counting
-    for (auto edges_n : graph.edges(n)) {
-      auto v = graph.edge_dest(edges_n);
-      if (v > n) {
-        break;
-      }
-      auto e_it_n = graph.edges(n).begin();
-
-      for (auto edges_v : graph.edges(v)) {
-        auto dst_v = graph.edge_dest(edges_v);
-        if (dst_v > v) {
-          break;
-        }
-        while (graph.edge_dest(*e_it_n) < dst_v) {
-          e_it_n++;
-        }
-        if (dst_v == graph.edge_dest(*e_it_n)) {
-          *(per_thread_count_range.first + n) += 1;
-          *(per_thread_count_range.first + v) += 1;
-          *(per_thread_count_range.first + dst_v) += 1;
-        }
-      }
-    }
+    ForEachOrderedTriangle(graph, n, bitmap, [&](Node v, Node dst_v) {
+      *(per_thread_count_range.first + n) += 1;
+      *(per_thread_count_range.first + v) += 1;
+      *(per_thread_count_range.first + dst_v) += 1;
+    });
   }
 
   /*
@@ -174,6 +189,7 @@ struct LocalClusteringCoefficientPerThread {
         all_thread_count_vec.begin(), all_thread_count_vec.end(), uint32_t{0});
 
     katana::PerThreadStorage<IterPair> per_thread_node_triangle_count;
+    katana::PerThreadStorage<katana::IntersectionBitmap> bitmaps;
 
     katana::on_each([&](const unsigned tid, const unsigned numT) {
       *per_thread_node_triangle_count.getLocal() = katana::block_range(
@@ -184,7 +200,8 @@ struct LocalClusteringCoefficientPerThread {
         katana::iterate(graph),
         [&](const Node& n) {
           OrderedCountFunc(
-              graph, n, *per_thread_node_triangle_count.getLocal());
+              graph, n, bitmaps.getLocal(),
+              *per_thread_node_triangle_count.getLocal());
         },
         katana::chunk_size<kChunkSize>(), katana::steal(),
         katana::loopname("TriangleCount_OrderedCountAlgo"));
@@ -237,6 +254,112 @@ struct LocalClusteringCoefficientPerThread {
     return katana::ResultSuccess();
   }
 };
+/**
+ * A small direct-mapped cache of the triangle counts of the nodes a thread
+ * has seen last. A count is added to the shared counts with one atomic
+ * add when its entry is taken by another node and when the thread is done,
+ * so the counts of hubs, which are in most triangles, are combined locally
+ * instead of contending for one cache line.
+ */
+class TriangleCountCache {
+public:
+  TriangleCountCache() : entries_(kNumEntries, Entry{kNoNode, 0}) {}
+
+  void Add(Node n, katana::NUMAArray<uint32_t>* counts) {
+    Entry& entry = entries_[n & (kNumEntries - 1)];
+    if (entry.node != n) {
+      Flush(&entry, counts);
+      entry.node = n;
+    }
+    ++entry.count;
+  }
+
+  void FlushAll(katana::NUMAArray<uint32_t>* counts) {
+    for (Entry& entry : entries_) {
+      Flush(&entry, counts);
+    }
+  }
+
+private:
+  // 32 KiB per thread
+  static constexpr size_t kNumEntries = size_t{1} << 12;
+  static constexpr Node kNoNode = std::numeric_limits<Node>::max();
+
+  struct Entry {
+    Node node;
+    uint32_t count;
+  };
+
+  static void Flush(Entry* entry, katana::NUMAArray<uint32_t>* counts) {
+    if (entry->count > 0) {
+      __sync_fetch_and_add(&(*counts)[entry->node], entry->count);
+    }
+    entry->node = kNoNode;
+    entry->count = 0;
+  }
+
+  std::vector<Entry> entries_;
+};
+
+struct LocalClusteringCoefficientHybrid {
+  /**
+   * Counts the number of triangles for each node in the graph, combining
+   * the counts of recently seen nodes in a per-thread cache before adding
+   * them to shared counts with atomics. Memory is O(num_nodes) plus a fixed
+   * amount per thread.
+   *
+   * It assumes that edgelist of each node is sorted.
+   */
+  void OrderedCountAlgo(
+      const SortedGraphView& graph, katana::NUMAArray<uint32_t>* counts) {
+    katana::PerThreadStorage<TriangleCountCache> caches;
+    katana::PerThreadStorage<katana::IntersectionBitmap> bitmaps;
+
+    katana::do_all(
+        katana::iterate(graph),
+        [&](const Node& n) {
+          TriangleCountCache* cache = caches.getLocal();
+          ForEachOrderedTriangle(
+              graph, n, bitmaps.getLocal(), [&](Node v, Node dst_v) {
+                cache->Add(n, counts);
+                cache->Add(v, counts);
+                cache->Add(dst_v, counts);
+              });
+        },
+        katana::chunk_size<kChunkSize>(), katana::steal(),
+        katana::loopname("TriangleCount_OrderedCountAlgo"));
+
+    katana::on_each(
+        [&](unsigned, unsigned) { caches.getLocal()->FlushAll(counts); });
+  }
+
+  katana::Result<void> operator()(SortedGraphView* graph) {
+    katana::StatTimer execTime(
+        "LocalClusteringCoefficient", "LocalClusteringCoefficient");
+    execTime.start();
+
+    katana::NUMAArray<uint32_t> per_node_triangles;
+    per_node_triangles.allocateInterleaved(graph->num_nodes());
+    katana::ParallelSTL::fill(
+        per_node_triangles.begin(), per_node_triangles.end(), uint32_t{0});
+
+    OrderedCountAlgo(*graph, &per_node_triangles);
+
+    katana::do_all(
+        katana::iterate(*graph),
+        [&](Node n) {
+          auto degree = graph->degree(n);
+          graph->template GetData<NodeClusteringCoefficient>(n) =
+              degree > 1 ? static_cast<double>(2 * per_node_triangles[n]) /
+                               (degree * (degree - 1))
+                         : 0.0;
+        },
+        katana::no_stats());
+
+    execTime.stop();
+    return katana::ResultSuccess();
+  }
+};
 }  // namespace
 
 template <typename Algorithm>
@@ -320,6 +443,10 @@ katana::analytics::LocalClusteringCoefficient(
     return LocalClusteringCoefficientWithWrap<
         LocalClusteringCoefficientPerThread>(pg, output_property_name);
   }
+  case LocalClusteringCoefficientPlan::kOrderedCountHybrid: {
+    return LocalClusteringCoefficientWithWrap<
+        LocalClusteringCoefficientHybrid>(pg, output_property_name);
+  }
   default:
     return katana::ErrorCode::InvalidArgument;
   }
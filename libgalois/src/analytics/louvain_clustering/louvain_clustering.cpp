@@ -22,6 +22,7 @@
 #include <deque>
 #include <type_traits>
 
+#include "katana/HashMapReducer.h"
 #include "katana/TypedPropertyGraph.h"
 #include "katana/analytics/ClusteringImplementationBase.h"
 
@@ -31,62 +32,35 @@ namespace {
 template <typename EdgeWeightType>
 struct LouvainClusteringImplementation
     : public katana::analytics::ClusteringImplementationBase<
-          katana::TypedPropertyGraph<
-              std::tuple<
-                  PreviousCommunityID, CurrentCommunityID,
-                  DegreeWeight<EdgeWeightType>>,
-              std::tuple<EdgeWeight<EdgeWeightType>>>,
-          EdgeWeightType, CommunityType<EdgeWeightType>> {
-  using NodeData = std::tuple<
-      PreviousCommunityID, CurrentCommunityID, DegreeWeight<EdgeWeightType>>;
-  using EdgeData = std::tuple<EdgeWeight<EdgeWeightType>>;
+          ClusteringLevelGraph<EdgeWeightType>, EdgeWeightType,
+          CommunityType<EdgeWeightType>> {
   using CommTy = CommunityType<EdgeWeightType>;
   using CommunityArray = katana::NUMAArray<CommTy>;
 
-  using Graph = katana::TypedPropertyGraph<NodeData, EdgeData>;
+  using Graph = ClusteringLevelGraph<EdgeWeightType>;
   using GNode = typename Graph::Node;
 
   using Base = katana::analytics::ClusteringImplementationBase<
       Graph, EdgeWeightType, CommTy>;
 
-  katana::Result<double> LouvainWithoutLockingDoAll(
-      katana::PropertyGraph* pg, double lower,
-      double modularity_threshold_per_round, uint32_t& iter) {
-    katana::StatTimer TimerClusteringTotal("Timer_Clustering_Total");
-    TimerClusteringTotal.start();
-
-    auto graph_result = Graph::Make(pg);
-    if (!graph_result) {
-      return graph_result.error();
-    }
-    Graph graph = graph_result.value();
-
-    CommunityArray c_info;    // Community info
+  /**
+   * Moves nodes to the neighboring cluster with the largest modularity gain
+   * in rounds, until a round gains less than modularity_threshold_per_round.
+   * Returns the modularity of the clusters.
+   */
+  double MoveNodesDoAll(
+      Graph& graph, CommunityArray& c_info, double constant_for_second_term,
+      double lower, double modularity_threshold_per_round, uint32_t& iter) {
     CommunityArray c_update;  // Used for updating community
 
     /* Variables needed for Modularity calculation */
-    double constant_for_second_term;
     double prev_mod = lower;
     double curr_mod = -1;
     uint32_t num_iter = iter;
 
     /*** Initialization ***/
-    c_info.allocateBlocked(graph.num_nodes());
     c_update.allocateBlocked(graph.num_nodes());
 
-    /* Initialization each node to its own cluster */
-    katana::do_all(katana::iterate(graph), [&](GNode n) {
-      graph.template GetData<CurrentCommunityID>(n) = n;
-      graph.template GetData<PreviousCommunityID>(n) = n;
-    });
-
-    /* Calculate the weighted degree sum for each vertex */
-    Base::template SumVertexDegreeWeight<EdgeWeightType>(&graph, c_info);
-
-    /* Compute the total weight (2m) and 1/2m terms */
-    constant_for_second_term =
-        Base::template CalConstantForSecondTerm<EdgeWeightType>(graph);
-
     katana::StatTimer TimerClusteringWhile("Timer_Clustering_While");
     TimerClusteringWhile.start();
     while (true) {
@@ -163,30 +137,99 @@ struct LouvainClusteringImplementation
 
     iter = num_iter;
 
-    c_info.destroy();
-    c_info.deallocate();
-
     c_update.destroy();
     c_update.deallocate();
 
-    TimerClusteringTotal.stop();
     return prev_mod;
   }
 
+  katana::Result<double> LouvainWithoutLockingDoAll(
+      Graph* graph_ptr, double lower, double modularity_threshold_per_round,
+      uint32_t& iter) {
+    katana::StatTimer TimerClusteringTotal("Timer_Clustering_Total");
+    katana::TimerGuard TimerClusteringGuard(TimerClusteringTotal);
+
+    Graph& graph = *graph_ptr;
+
+    CommunityArray c_info;  // Community info
+
+    /*** Initialization ***/
+    c_info.allocateBlocked(graph.num_nodes());
+
+    /* Initialization each node to its own cluster */
+    katana::do_all(katana::iterate(graph), [&](GNode n) {
+      graph.template GetData<CurrentCommunityID>(n) = n;
+      graph.template GetData<PreviousCommunityID>(n) = n;
+    });
+
+    /* Calculate the weighted degree sum for each vertex */
+    Base::template SumVertexDegreeWeight<EdgeWeightType>(&graph, c_info);
+
+    /* Compute the total weight (2m) and 1/2m terms */
+    double constant_for_second_term =
+        Base::template CalConstantForSecondTerm<EdgeWeightType>(graph);
+
+    double mod = MoveNodesDoAll(
+        graph, c_info, constant_for_second_term, lower,
+        modularity_threshold_per_round, iter);
+
+    c_info.destroy();
+    c_info.deallocate();
+
+    return mod;
+  }
+
+  /**
+   * One level of the Leiden algorithm. Nodes start in the clusters given by
+   * their PreviousCommunityID and move as in LouvainWithoutLockingDoAll.
+   * Then the clusters are refined into the sub-clusters that make up the
+   * nodes of the next level, which are stored in PreviousCommunityID.
+   */
+  katana::Result<double> LeidenDoAll(
+      Graph* graph_ptr, double lower, double modularity_threshold_per_round,
+      uint32_t& iter) {
+    katana::StatTimer TimerClusteringTotal("Timer_Clustering_Total");
+    katana::TimerGuard TimerClusteringGuard(TimerClusteringTotal);
+
+    Graph& graph = *graph_ptr;
+
+    CommunityArray c_info;  // Community info
+    c_info.allocateBlocked(graph.num_nodes());
+
+    /* Calculate the weighted degree sum for each vertex */
+    Base::template SumVertexDegreeWeight<EdgeWeightType>(&graph, c_info);
+    Base::template InitClustersFromPrevious<EdgeWeightType>(&graph, c_info);
+
+    /* Compute the total weight (2m) and 1/2m terms */
+    double constant_for_second_term =
+        Base::template CalConstantForSecondTerm<EdgeWeightType>(graph);
+
+    double mod = MoveNodesDoAll(
+        graph, c_info, constant_for_second_term, lower,
+        modularity_threshold_per_round, iter);
+
+    katana::StatTimer TimerRefinement("Timer_Refinement");
+    TimerRefinement.start();
+    Base::template RefineClusters<EdgeWeightType>(
+        &graph, c_info, constant_for_second_term);
+    TimerRefinement.stop();
+
+    c_info.destroy();
+    c_info.deallocate();
+
+    return mod;
+  }
+
   // TODO The function arguments are  similar to
   // the non-deterministic one. Need to figure how to
   // do remove duplication
   katana::Result<double> LouvainDeterministic(
-      katana::PropertyGraph* pg, double lower,
-      double modularity_threshold_per_round, uint32_t& iter) {
+      Graph* graph_ptr, double lower, double modularity_threshold_per_round,
+      uint32_t& iter) {
     katana::StatTimer TimerClusteringTotal("Timer_Clustering_Total");
     katana::TimerGuard TimerClusteringGuard(TimerClusteringTotal);
 
-    auto graph_result = Graph::Make(pg);
-    if (!graph_result) {
-      return graph_result.error();
-    }
-    Graph graph = graph_result.value();
+    Graph& graph = *graph_ptr;
 
     CommunityArray c_info;        // Community info
     CommunityArray c_update_add;  // Used for updating community
@@ -353,23 +396,38 @@ struct LouvainClusteringImplementation
     return prev_mod;
   }
 
+  /**
+   * Moves every node of the original graph from its node of graph to the
+   * NodePropType of that node
+   */
+  template <typename NodePropType>
+  static void ProjectClusters(
+      const Graph& graph, katana::NUMAArray<uint64_t>& clusters_orig) {
+    katana::do_all(
+        katana::iterate((uint64_t)0, clusters_orig.size()), [&](GNode n) {
+          if (clusters_orig[n] != Base::UNASSIGNED) {
+            KATANA_LOG_DEBUG_ASSERT(clusters_orig[n] < graph.num_nodes());
+            clusters_orig[n] =
+                graph.template GetData<NodePropType>(clusters_orig[n]);
+          }
+        });
+  }
+
 public:
   katana::Result<void> LouvainClustering(
       katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
-      const std::vector<std::string>& temp_node_property_names,
       katana::NUMAArray<uint64_t>& clusters_orig, LouvainClusteringPlan plan) {
-    TemporaryPropertyGuard temp_edge_property{pg->EdgeMutablePropertyView()};
-    std::vector<std::string> temp_edge_property_names = {
-        temp_edge_property.name()};
+    const bool leiden = plan.algorithm() == LouvainClusteringPlan::kLeiden;
 
     /*
-     * Construct temp property graph. This graph gets coarsened as the
-     * computation proceeds.
+     * Construct the first level of the graph. The computation proceeds by
+     * coarsening graph_curr into graph_next and swapping them, so that
+     * each level reuses the memory of the level before last.
      */
-    std::unique_ptr<katana::PropertyGraph> pg_mutable;
-
-    Graph graph_curr = KATANA_CHECKED(
-        Graph::Make(pg, temp_node_property_names, {edge_weight_property_name}));
+    Graph graph_curr = KATANA_CHECKED(Graph::Make(
+        pg, edge_weight_property_name, plan.edge_weight_tolerance()));
+    Graph graph_next;
+    ClusteringCoarseningBuffers<EdgeWeightType> buffers;
 
     /*
     * Vertex following optimization
@@ -387,57 +445,49 @@ public:
         clusters_orig[n] = graph_curr.template GetData<CurrentCommunityID>(n);
       });
 
-      auto pg_empty = std::make_unique<katana::PropertyGraph>();
-
       // Build new graph to remove the isolated nodes
-      auto coarsened_graph_result =
-          Base::template GraphCoarsening<NodeData, EdgeData, EdgeWeightType>(
-              graph_curr, pg_empty.get(), num_unique_clusters,
-              temp_node_property_names, temp_edge_property_names);
-      if (!coarsened_graph_result) {
-        return coarsened_graph_result.error();
-      }
-
-      pg_mutable = std::move(coarsened_graph_result.value());
+      Base::template GraphCoarsening<EdgeWeightType>(
+          graph_curr, num_unique_clusters, &buffers, &graph_next);
+      std::swap(graph_curr, graph_next);
 
     } else {
       /*
-       * Initialize node cluster id.
+       * Initialize node cluster id. Leiden starts from singleton clusters
+       * and keeps track of the node of the current level.
        */
-      katana::do_all(
-          katana::iterate(graph_curr), [&](GNode n) { clusters_orig[n] = -1; });
-
-      auto pg_dup = KATANA_CHECKED(Base::template DuplicateGraph<NodeData>(
-          pg, edge_weight_property_name, temp_edge_property_names[0]));
-
-      pg_mutable = std::move(pg_dup);
+      katana::do_all(katana::iterate(graph_curr), [&](GNode n) {
+        clusters_orig[n] = leiden ? n : -1;
+        graph_curr.template GetData<PreviousCommunityID>(n) = n;
+      });
     }
 
-    KATANA_LOG_ASSERT(pg_mutable);
-
     double prev_mod = -1;  // Previous modularity
     double curr_mod = -1;  // Current modularity
     uint32_t phase = 0;
 
-    std::unique_ptr<katana::PropertyGraph> pg_curr = std::move(pg_mutable);
     uint32_t iter = 0;
     uint64_t num_nodes_orig = clusters_orig.size();
     while (true) {
       iter++;
       phase++;
 
-      Graph graph_curr = KATANA_CHECKED(Graph::Make(pg_curr.get()));
       if (graph_curr.num_nodes() > plan.min_graph_size()) {
         switch (plan.algorithm()) {
         case LouvainClusteringPlan::kDoAll: {
           curr_mod = KATANA_CHECKED(LouvainWithoutLockingDoAll(
-              pg_curr.get(), curr_mod, plan.modularity_threshold_per_round(),
+              &graph_curr, curr_mod, plan.modularity_threshold_per_round(),
               iter));
           break;
         }
         case LouvainClusteringPlan::kDeterministic: {
           curr_mod = KATANA_CHECKED(LouvainDeterministic(
-              pg_curr.get(), curr_mod, plan.modularity_threshold_per_round(),
+              &graph_curr, curr_mod, plan.modularity_threshold_per_round(),
+              iter));
+          break;
+        }
+        case LouvainClusteringPlan::kLeiden: {
+          curr_mod = KATANA_CHECKED(LeidenDoAll(
+              &graph_curr, curr_mod, plan.modularity_threshold_per_round(),
               iter));
           break;
         }
@@ -446,6 +496,10 @@ public:
               katana::ErrorCode::InvalidArgument, "Unknown algorithm");
         }
       } else {
+        if (leiden) {
+          // The nodes of this level start in the clusters of the last one
+          ProjectClusters<PreviousCommunityID>(graph_curr, clusters_orig);
+        }
         break;
       }
 
@@ -454,37 +508,34 @@ public:
 
       if (iter < plan.max_iterations() &&
           (curr_mod - prev_mod) > plan.modularity_threshold_total()) {
-        if (!plan.enable_vf() && phase == 1) {
-          KATANA_LOG_DEBUG_ASSERT(num_nodes_orig == graph_curr.num_nodes());
-          katana::do_all(katana::iterate(graph_curr), [&](GNode n) {
-            clusters_orig[n] =
-                graph_curr.template GetData<CurrentCommunityID>(n);
-          });
+        if (leiden) {
+          // The next level has a node per sub-cluster
+          num_unique_clusters =
+              Base::template RenumberClustersContiguously<PreviousCommunityID>(
+                  &graph_curr);
+          ProjectClusters<PreviousCommunityID>(graph_curr, clusters_orig);
+          Base::template GraphCoarsening<EdgeWeightType, PreviousCommunityID>(
+              graph_curr, num_unique_clusters, &buffers, &graph_next);
         } else {
-          katana::do_all(
-              katana::iterate((uint64_t)0, num_nodes_orig), [&](GNode n) {
-                if (clusters_orig[n] != Base::UNASSIGNED) {
-                  KATANA_LOG_DEBUG_ASSERT(
-                      clusters_orig[n] < graph_curr.num_nodes());
-                  clusters_orig[n] =
-                      graph_curr.template GetData<CurrentCommunityID>(
-                          clusters_orig[n]);
-                }
-              });
-        }
-
-        auto coarsened_graph_result =
-            Base::template GraphCoarsening<NodeData, EdgeData, EdgeWeightType>(
-                graph_curr, pg_curr.get(), num_unique_clusters,
-                temp_node_property_names, temp_edge_property_names);
-        if (!coarsened_graph_result) {
-          return coarsened_graph_result.error();
+          if (!plan.enable_vf() && phase == 1) {
+            KATANA_LOG_DEBUG_ASSERT(num_nodes_orig == graph_curr.num_nodes());
+            katana::do_all(katana::iterate(graph_curr), [&](GNode n) {
+              clusters_orig[n] =
+                  graph_curr.template GetData<CurrentCommunityID>(n);
+            });
+          } else {
+            ProjectClusters<CurrentCommunityID>(graph_curr, clusters_orig);
+          }
+          Base::template GraphCoarsening<EdgeWeightType>(
+              graph_curr, num_unique_clusters, &buffers, &graph_next);
         }
-
-        pg_curr = std::move(coarsened_graph_result.value());
+        std::swap(graph_curr, graph_next);
 
         prev_mod = curr_mod;
       } else {
+        if (leiden) {
+          ProjectClusters<CurrentCommunityID>(graph_curr, clusters_orig);
+        }
         break;
       }
     }
@@ -523,21 +574,6 @@ LouvainClusteringWithWrap(
       std::is_integral_v<EdgeWeightType> ||
       std::is_floating_point_v<EdgeWeightType>);
 
-  std::vector<TemporaryPropertyGuard> temp_node_properties(3);
-  std::generate_n(
-      temp_node_properties.begin(), temp_node_properties.size(),
-      [&]() { return TemporaryPropertyGuard{pg->NodeMutablePropertyView()}; });
-  std::vector<std::string> temp_node_property_names(
-      temp_node_properties.size());
-  std::transform(
-      temp_node_properties.begin(), temp_node_properties.end(),
-      temp_node_property_names.begin(),
-      [](const TemporaryPropertyGuard& p) { return p.name(); });
-
-  using Impl = LouvainClusteringImplementation<EdgeWeightType>;
-  KATANA_CHECKED(ConstructNodeProperties<typename Impl::NodeData>(
-      pg, temp_node_property_names));
-
   /*
    * To keep track of communities for nodes in the original graph.
    * Community will be set to -1 for isolated nodes
@@ -547,8 +583,7 @@ LouvainClusteringWithWrap(
 
   LouvainClusteringImplementation<EdgeWeightType> impl{};
   KATANA_CHECKED(impl.LouvainClustering(
-      pg, edge_weight_property_name, temp_node_property_names, clusters_orig,
-      plan));
+      pg, edge_weight_property_name, clusters_orig, plan));
 
   KATANA_CHECKED(ConstructNodeProperties<std::tuple<CurrentCommunityID>>(
       pg, {output_property_name}));
@@ -591,34 +626,11 @@ katana::analytics::LouvainClustering(
         pg, temporary_edge_property.name(), output_property_name, plan);
   }
 
-  switch (KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
-              ->type()
-              ->id()) {
-  case arrow::UInt32Type::type_id:
-    return LouvainClusteringWithWrap<uint32_t>(
-        pg, edge_weight_property_name, output_property_name, plan);
-  case arrow::Int32Type::type_id:
-    return LouvainClusteringWithWrap<int32_t>(
-        pg, edge_weight_property_name, output_property_name, plan);
-  case arrow::UInt64Type::type_id:
-    return LouvainClusteringWithWrap<uint64_t>(
-        pg, edge_weight_property_name, output_property_name, plan);
-  case arrow::Int64Type::type_id:
-    return LouvainClusteringWithWrap<int64_t>(
-        pg, edge_weight_property_name, output_property_name, plan);
-  case arrow::FloatType::type_id:
-    return LouvainClusteringWithWrap<float>(
-        pg, edge_weight_property_name, output_property_name, plan);
-  case arrow::DoubleType::type_id:
-    return LouvainClusteringWithWrap<double>(
-        pg, edge_weight_property_name, output_property_name, plan);
-  default:
-    return KATANA_ERROR(
-        katana::ErrorCode::TypeError, "Unsupported type: {}",
-        KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
-            ->type()
-            ->ToString());
-  }
+  return DispatchOnEdgePropertyType(
+      pg, edge_weight_property_name, [&](auto tag) {
+        return LouvainClusteringWithWrap<decltype(tag)>(
+            pg, edge_weight_property_name, output_property_name, plan);
+      });
 }
 
 /// \cond DO_NOT_DOCUMENT
@@ -677,36 +689,17 @@ katana::analytics::LouvainClusteringStatistics::Compute(
   }
   auto graph = graph_result.value();
 
-  using Map = katana::gstl::Map<uint64_t, uint64_t>;
-
-  auto reduce = [](Map& lhs, Map&& rhs) -> Map& {
-    Map v{std::move(rhs)};
-
-    for (auto& kv : v) {
-      if (lhs.count(kv.first) == 0) {
-        lhs[kv.first] = 0;
-      }
-      lhs[kv.first] += kv.second;
-    }
-
-    return lhs;
-  };
-
-  auto mapIdentity = []() { return Map(); };
-
-  auto accumMap = katana::make_reducible(reduce, mapIdentity);
-
-  katana::GAccumulator<size_t> accumReps;
+  katana::GHashMapReducer<uint64_t, uint64_t> accumMap;
 
   katana::do_all(
       katana::iterate(graph),
       [&](const uint32_t& x) {
         auto& n = graph.template GetData<PreviousCommunityID>(x);
-        accumMap.update(Map{std::make_pair(n, uint64_t{1})});
+        accumMap.update(n, 1);
       },
       katana::loopname("CountLargest"));
 
-  Map& map = accumMap.reduce();
+  const auto& map = accumMap.reduce();
   size_t reps = map.size();
 
   using ClusterSizePair = std::pair<uint32_t, uint32_t>;
@@ -763,46 +756,11 @@ katana::analytics::LouvainClusteringStatistics::Compute(
     }
     modularity = modularity_result.value();
   } else {
-    switch (KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
-                ->type()
-                ->id()) {
-    case arrow::UInt32Type::type_id: {
-      modularity = KATANA_CHECKED(CalModularityWrap<uint32_t>(
-          pg, edge_weight_property_name, property_name));
-      break;
-    }
-    case arrow::Int32Type::type_id: {
-      modularity = KATANA_CHECKED(CalModularityWrap<int32_t>(
-          pg, edge_weight_property_name, property_name));
-      break;
-    }
-    case arrow::UInt64Type::type_id: {
-      modularity = KATANA_CHECKED(CalModularityWrap<uint64_t>(
-          pg, edge_weight_property_name, property_name));
-      break;
-    }
-    case arrow::Int64Type::type_id: {
-      modularity = KATANA_CHECKED(CalModularityWrap<int64_t>(
-          pg, edge_weight_property_name, property_name));
-      break;
-    }
-    case arrow::FloatType::type_id: {
-      modularity = KATANA_CHECKED(CalModularityWrap<float>(
-          pg, edge_weight_property_name, property_name));
-      break;
-    }
-    case arrow::DoubleType::type_id: {
-      modularity = KATANA_CHECKED(CalModularityWrap<double>(
-          pg, edge_weight_property_name, property_name));
-      break;
-    }
-    default:
-      return KATANA_ERROR(
-          katana::ErrorCode::TypeError, "Unsupported type: {}",
-          KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
-              ->type()
-              ->ToString());
-    }
+    modularity = KATANA_CHECKED(DispatchOnEdgePropertyType(
+        pg, edge_weight_property_name, [&](auto tag) {
+          return CalModularityWrap<decltype(tag)>(
+              pg, edge_weight_property_name, property_name);
+        }));
   }
   return LouvainClusteringStatistics{
       reps, non_trivial_clusters.reduce(), largest_cluster_size,
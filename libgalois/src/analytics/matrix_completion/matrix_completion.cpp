@@ -0,0 +1,459 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2020, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "katana/analytics/matrix_completion/matrix_completion.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/DynamicBitset.h"
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+#include "katana/Timer.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Node = uint32_t;
+
+/// The latent vectors of all nodes, stored contiguously
+struct LatentVectors {
+  float* values;
+  uint32_t size;
+
+  float* operator[](Node n) const { return values + uint64_t{n} * size; }
+};
+
+float
+InnerProduct(const float* a, const float* b, uint32_t size) {
+  float sum = 0;
+  for (uint32_t i = 0; i < size; ++i) {
+    sum += a[i] * b[i];
+  }
+  return sum;
+}
+
+/// Deterministic pseudo-random initial values, uniform in
+/// [0, 1 / sqrt(size)), which keeps initial predictions below 1
+void
+InitializeLatentVectors(uint64_t num_nodes, const LatentVectors& latent) {
+  float top = 1.0 / std::sqrt(static_cast<double>(latent.size));
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        float* vector = latent[n];
+        for (uint32_t i = 0; i < latent.size; ++i) {
+          // splitmix64
+          uint64_t z = (n * latent.size + i + 1) * 0x9e3779b97f4a7c15ULL;
+          z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+          z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+          z ^= z >> 31;
+          vector[i] = top * ((z >> 40) * (1.0 / (uint64_t{1} << 24)));
+        }
+      },
+      katana::no_stats(), katana::loopname("MatrixCompletionInitialize"));
+}
+
+/// Sum of the squared errors of the predicted ratings
+template <typename View>
+double
+SquaredError(
+    const View& view, const katana::NUMAArray<float>& ratings,
+    const LatentVectors& latent) {
+  katana::GAccumulator<double> error;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, view.num_nodes()),
+      [&](uint64_t user) {
+        double local = 0;
+        for (auto e : view.edges(user)) {
+          float e_error = ratings[view.edge_property_index(e)] -
+                          InnerProduct(
+                              latent[user], latent[view.edge_dest(e)],
+                              latent.size);
+          local += e_error * e_error;
+        }
+        error += local;
+      },
+      katana::steal(), katana::no_stats(),
+      katana::loopname("MatrixCompletionError"));
+  return error.reduce();
+}
+
+/// Whether to stop after a round that changed the squared error from last
+/// to error
+bool
+Converged(double last, double error, double tolerance) {
+  if (!std::isfinite(error) || error == 0) {
+    return true;
+  }
+  return last > 0 && std::abs((last - error) / last) < tolerance;
+}
+
+/// Lock-free blocked SGD. The out-edges of view must be sorted by
+/// destination.
+template <typename View>
+void
+SGD(const View& view, const katana::NUMAArray<float>& ratings,
+    const LatentVectors& latent, const MatrixCompletionPlan& plan) {
+  const uint64_t num_nodes = view.num_nodes();
+  const uint64_t users_per_block =
+      std::max<uint32_t>(plan.users_per_block(), 1);
+  const uint64_t items_per_block =
+      std::max<uint32_t>(plan.items_per_block(), 1);
+  const uint64_t num_user_blocks =
+      (num_nodes + users_per_block - 1) / users_per_block;
+  const uint64_t num_item_blocks = std::max<uint64_t>(
+      1, (num_nodes + items_per_block - 1) / items_per_block);
+  const float lambda = plan.lambda();
+  const uint32_t size = latent.size;
+
+  // Next edge of each user of a block
+  katana::PerThreadStorage<std::vector<uint64_t>> cursors;
+  double last = -1;
+  for (uint32_t round = 0; round < plan.max_iterations(); ++round) {
+    const float step =
+        plan.learning_rate() * 1.5 /
+        (1.0 + plan.decay_rate() * std::pow(round + 1, 1.5));
+    katana::GAccumulator<double> error;
+
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_user_blocks),
+        [&](uint64_t user_block) {
+          uint64_t user_begin = user_block * users_per_block;
+          uint64_t user_end =
+              std::min(user_begin + users_per_block, num_nodes);
+          uint64_t first_item_block = user_block % num_item_blocks;
+          uint64_t first_item = first_item_block * items_per_block;
+
+          std::vector<uint64_t>& cursor = *cursors.getLocal();
+          cursor.clear();
+          for (uint64_t user = user_begin; user < user_end; ++user) {
+            auto edges = view.edges(user);
+            cursor.emplace_back(*std::partition_point(
+                edges.begin(), edges.end(),
+                [&](auto e) { return view.edge_dest(e) < first_item; }));
+          }
+
+          double local_error = 0;
+          for (uint64_t b = 0; b < num_item_blocks; ++b) {
+            uint64_t item_block = (first_item_block + b) % num_item_blocks;
+            uint64_t item_end = (item_block + 1) * items_per_block;
+            for (uint64_t user = user_begin; user < user_end; ++user) {
+              auto edges = view.edges(user);
+              uint64_t& e = cursor[user - user_begin];
+              if (item_block == 0) {
+                // Wrapped around to the first items
+                e = *edges.begin();
+              }
+              float* user_vector = latent[user];
+              for (uint64_t end = *edges.end();
+                   e != end && view.edge_dest(e) < item_end; ++e) {
+                float* item_vector = latent[view.edge_dest(e)];
+                float e_error =
+                    ratings[view.edge_property_index(e)] -
+                    InnerProduct(user_vector, item_vector, size);
+                for (uint32_t i = 0; i < size; ++i) {
+                  float prev_user = user_vector[i];
+                  float prev_item = item_vector[i];
+                  user_vector[i] +=
+                      step * (e_error * prev_item - lambda * prev_user);
+                  item_vector[i] +=
+                      step * (e_error * prev_user - lambda * prev_item);
+                }
+                local_error += e_error * e_error;
+              }
+            }
+          }
+          error += local_error;
+        },
+        katana::steal(), katana::chunk_size<1>(),
+        katana::loopname("MatrixCompletionSGD"));
+
+    // The error of the round is measured before each update
+    double round_error = error.reduce();
+    if (Converged(last, round_error, plan.tolerance())) {
+      break;
+    }
+    last = round_error;
+  }
+}
+
+/// Solve a x = b in place of b for a symmetric positive definite matrix a of
+/// which only the lower triangle is used; a is overwritten by its Cholesky
+/// factor. Returns false if a is not positive definite.
+bool
+CholeskySolve(double* a, double* b, uint32_t size) {
+  for (uint32_t j = 0; j < size; ++j) {
+    double diagonal = a[j * size + j];
+    for (uint32_t k = 0; k < j; ++k) {
+      diagonal -= a[j * size + k] * a[j * size + k];
+    }
+    if (!(diagonal > 0)) {
+      return false;
+    }
+    diagonal = std::sqrt(diagonal);
+    a[j * size + j] = diagonal;
+    for (uint32_t i = j + 1; i < size; ++i) {
+      double value = a[i * size + j];
+      for (uint32_t k = 0; k < j; ++k) {
+        value -= a[i * size + k] * a[j * size + k];
+      }
+      a[i * size + j] = value / diagonal;
+    }
+  }
+  // Forward substitution with L, then back substitution with L^T
+  for (uint32_t i = 0; i < size; ++i) {
+    double value = b[i];
+    for (uint32_t k = 0; k < i; ++k) {
+      value -= a[i * size + k] * b[k];
+    }
+    b[i] = value / a[i * size + i];
+  }
+  for (uint32_t i = size; i-- > 0;) {
+    double value = b[i];
+    for (uint32_t k = i + 1; k < size; ++k) {
+      value -= a[k * size + i] * b[k];
+    }
+    b[i] = value / a[i * size + i];
+  }
+  return true;
+}
+
+/// Solve for the latent vector of each node with edges from edges_of and the
+/// latent vectors of their other endpoints fixed: minimize the squared
+/// errors of the ratings plus lambda times the squared norm times the
+/// number of ratings
+template <typename EdgesFn, typename OtherFn, typename IndexFn>
+void
+AlsHalfStep(
+    uint64_t num_nodes, const EdgesFn& edges_of, const OtherFn& other,
+    const IndexFn& property_index, const katana::NUMAArray<float>& ratings,
+    const LatentVectors& latent, double lambda, const char* loopname) {
+  const uint32_t size = latent.size;
+  struct Scratch {
+    std::vector<double> a;
+    std::vector<double> b;
+  };
+  katana::PerThreadStorage<Scratch> scratch;
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        auto edges = edges_of(n);
+        uint64_t degree = std::distance(edges.begin(), edges.end());
+        if (degree == 0) {
+          return;
+        }
+        Scratch& s = *scratch.getLocal();
+        s.a.assign(uint64_t{size} * size, 0.0);
+        s.b.assign(size, 0.0);
+        for (auto e : edges) {
+          const float* x = latent[other(e)];
+          double rating = ratings[property_index(e)];
+          for (uint32_t i = 0; i < size; ++i) {
+            for (uint32_t j = 0; j <= i; ++j) {
+              s.a[i * size + j] += double{x[i]} * x[j];
+            }
+            s.b[i] += rating * x[i];
+          }
+        }
+        for (uint32_t i = 0; i < size; ++i) {
+          s.a[i * size + i] += lambda * degree;
+        }
+        if (CholeskySolve(s.a.data(), s.b.data(), size)) {
+          std::copy(s.b.begin(), s.b.end(), latent[n]);
+        }
+      },
+      katana::steal(), katana::loopname(loopname));
+}
+
+template <typename View>
+void
+ALS(const View& view, const katana::NUMAArray<float>& ratings,
+    const LatentVectors& latent, const MatrixCompletionPlan& plan) {
+  double last = -1;
+  for (uint32_t round = 0; round < plan.max_iterations(); ++round) {
+    AlsHalfStep(
+        view.num_nodes(), [&](uint64_t n) { return view.edges(n); },
+        [&](auto e) { return view.edge_dest(e); },
+        [&](auto e) { return view.edge_property_index(e); }, ratings, latent,
+        plan.lambda(), "MatrixCompletionALSUsers");
+    AlsHalfStep(
+        view.num_nodes(), [&](uint64_t n) { return view.in_edges(n); },
+        [&](auto e) { return view.in_edge_dest(e); },
+        [&](auto e) { return view.in_edge_property_index(e); }, ratings,
+        latent, plan.lambda(), "MatrixCompletionALSItems");
+
+    double error = SquaredError(view, ratings, latent);
+    if (Converged(last, error, plan.tolerance())) {
+      break;
+    }
+    last = error;
+  }
+}
+
+template <typename T>
+katana::Result<void>
+CopyRatings(
+    katana::PropertyGraph* pg, const std::string& rating_property_name,
+    katana::NUMAArray<float>* ratings) {
+  auto values =
+      KATANA_CHECKED(pg->GetEdgePropertyTyped<T>(rating_property_name));
+  ratings->allocateBlocked(values->length());
+  katana::do_all(
+      katana::iterate(int64_t{0}, values->length()),
+      [&](int64_t i) { (*ratings)[i] = values->Value(i); }, katana::no_stats());
+  return katana::ResultSuccess();
+}
+
+/// The ratings as floats, indexed by edge property index
+katana::Result<katana::NUMAArray<float>>
+ReadRatings(
+    katana::PropertyGraph* pg, const std::string& rating_property_name) {
+  katana::NUMAArray<float> ratings;
+  KATANA_CHECKED(
+      DispatchOnEdgePropertyType(pg, rating_property_name, [&](auto tag) {
+        return CopyRatings<decltype(tag)>(pg, rating_property_name, &ratings);
+      }));
+  return katana::Result<katana::NUMAArray<float>>(std::move(ratings));
+}
+
+/// Check that no node is both a user and an item
+katana::Result<void>
+CheckBipartite(katana::PropertyGraph* pg) {
+  const auto& topology = pg->topology();
+  katana::DynamicBitset is_item;
+  is_item.resize(topology.num_nodes());
+  katana::do_all(
+      katana::iterate(topology.all_edges()),
+      [&](auto e) { is_item.set(topology.edge_dest(e)); }, katana::no_stats());
+
+  katana::GReduceMin<uint64_t> both;
+  katana::do_all(
+      katana::iterate(topology.all_nodes()),
+      [&](auto n) {
+        if (is_item.test(n) && !topology.edges(n).empty()) {
+          both.update(n);
+        }
+      },
+      katana::no_stats());
+  if (both.reduce() != std::numeric_limits<uint64_t>::max()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "node {} has both in- and out-edges", both.reduce());
+  }
+  return katana::ResultSuccess();
+}
+
+/// The latent vectors of a FixedSizeList property
+katana::Result<LatentVectors>
+GetLatentVectors(
+    katana::PropertyGraph* pg, const std::string& output_property_name) {
+  auto property = KATANA_CHECKED(pg->GetNodeProperty(output_property_name));
+  auto list =
+      std::dynamic_pointer_cast<arrow::FixedSizeListArray>(property->chunk(0));
+  auto values =
+      list ? std::dynamic_pointer_cast<arrow::FloatArray>(list->values())
+           : nullptr;
+  if (!values) {
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError,
+        "latent vectors must be fixed size lists of floats, got {}",
+        property->type()->ToString());
+  }
+  return LatentVectors{
+      const_cast<float*>(values->raw_values()) +
+          uint64_t{list->value_offset(0)},
+      static_cast<uint32_t>(list->value_length())};
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::MatrixCompletion(
+    PropertyGraph* pg, const std::string& rating_property_name,
+    const std::string& output_property_name, MatrixCompletionPlan plan) {
+  if (plan.latent_vector_size() == 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "latent vector size must be positive");
+  }
+  KATANA_CHECKED(CheckBipartite(pg));
+  auto ratings = KATANA_CHECKED(ReadRatings(pg, rating_property_name));
+
+  uint64_t num_values = pg->num_nodes() * uint64_t{plan.latent_vector_size()};
+  std::shared_ptr<arrow::Buffer> buffer =
+      KATANA_CHECKED(arrow::AllocateBuffer(num_values * sizeof(float)));
+  LatentVectors latent{
+      reinterpret_cast<float*>(buffer->mutable_data()),
+      plan.latent_vector_size()};
+  InitializeLatentVectors(pg->num_nodes(), latent);
+
+  katana::StatTimer exec_time("MatrixCompletion");
+  exec_time.start();
+  switch (plan.algorithm()) {
+  case MatrixCompletionPlan::kSGD: {
+    auto view =
+        pg->BuildView<katana::PropertyGraphViews::EdgesSortedByDestID>();
+    SGD(view, ratings, latent, plan);
+    break;
+  }
+  case MatrixCompletionPlan::kALS: {
+    auto view = pg->BuildView<katana::PropertyGraphViews::BiDirectional>();
+    ALS(view, ratings, latent, plan);
+    break;
+  }
+  default:
+    return katana::ErrorCode::InvalidArgument;
+  }
+  exec_time.stop();
+
+  auto values = std::make_shared<arrow::FloatArray>(num_values, buffer);
+  std::shared_ptr<arrow::Array> list = KATANA_CHECKED(
+      arrow::FixedSizeListArray::FromArrays(values, plan.latent_vector_size()));
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field(output_property_name, list->type())}),
+      {list});
+  return pg->AddNodeProperties(table);
+}
+
+void
+katana::analytics::MatrixCompletionStatistics::Print(std::ostream& os) const {
+  os << "RMSE = " << rmse << std::endl;
+}
+
+katana::Result<MatrixCompletionStatistics>
+katana::analytics::MatrixCompletionStatistics::Compute(
+    katana::PropertyGraph* pg, const std::string& rating_property_name,
+    const std::string& output_property_name) {
+  auto ratings = KATANA_CHECKED(ReadRatings(pg, rating_property_name));
+  auto latent = KATANA_CHECKED(GetLatentVectors(pg, output_property_name));
+  double error = SquaredError(pg->topology(), ratings, latent);
+  uint64_t num_edges = pg->num_edges();
+  return MatrixCompletionStatistics{
+      num_edges > 0 ? std::sqrt(error / num_edges) : 0.0};
+}
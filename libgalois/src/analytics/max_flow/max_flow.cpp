@@ -0,0 +1,660 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2020, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "katana/analytics/max_flow/max_flow.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <type_traits>
+
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+#include "katana/Statistics.h"
+#include "katana/Timer.h"
+#include "katana/analytics/Utils.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+/// Per node term of the Cherkassky-Goldberg global relabel interval
+constexpr uint64_t kAlpha = 6;
+/// The work charged for each relabel, on top of the arcs scanned
+constexpr int64_t kBeta = 12;
+/// Work is accumulated per thread and published in batches of this size
+constexpr int64_t kWorkBatch = 1024;
+constexpr unsigned kChunkSize = 16;
+
+/// The residual graph. Each edge u -> v gives an arc u -> v, whose residual
+/// capacity starts at the edge capacity, and a reverse arc v -> u, whose
+/// residual capacity is the flow on the edge. The arcs of a node are its
+/// out-edges followed by its in-edges.
+struct ResidualGraph {
+  katana::NUMAArray<uint64_t> offsets;
+  katana::NUMAArray<uint32_t> dests;
+  katana::NUMAArray<uint64_t> reverse;
+  katana::NUMAArray<std::atomic<int64_t>> residual;
+  /// The reverse arc of each edge, by edge property index
+  katana::NUMAArray<uint64_t> flow_arcs;
+
+  uint64_t num_nodes() const { return offsets.size() - 1; }
+};
+
+template <typename View>
+void
+BuildResidualGraph(
+    const View& view, const katana::NUMAArray<int64_t>& capacities,
+    ResidualGraph* graph) {
+  const uint64_t num_nodes = view.num_nodes();
+  katana::NUMAArray<uint64_t> counts;
+  counts.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        counts[n] = view.edges(n).size() + view.in_edges(n).size();
+      },
+      katana::no_stats());
+  graph->offsets.allocateBlocked(num_nodes + 1);
+  graph->offsets[0] = 0;
+  katana::ParallelSTL::partial_sum(
+      counts.begin(), counts.end(), graph->offsets.begin() + 1);
+
+  const uint64_t num_arcs = graph->offsets[num_nodes];
+  graph->dests.allocateBlocked(num_arcs);
+  graph->reverse.allocateBlocked(num_arcs);
+  graph->residual.allocateBlocked(num_arcs);
+  graph->flow_arcs.allocateBlocked(capacities.size());
+  katana::NUMAArray<uint64_t> capacity_arcs;
+  capacity_arcs.allocateBlocked(capacities.size());
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t arc = graph->offsets[n];
+        for (auto e : view.edges(n)) {
+          auto index = view.edge_property_index(e);
+          graph->dests[arc] = view.edge_dest(e);
+          graph->residual[arc].store(
+              capacities[index], std::memory_order_relaxed);
+          capacity_arcs[index] = arc++;
+        }
+        for (auto e : view.in_edges(n)) {
+          graph->dests[arc] = view.in_edge_dest(e);
+          graph->residual[arc].store(0, std::memory_order_relaxed);
+          graph->flow_arcs[view.in_edge_property_index(e)] = arc++;
+        }
+      },
+      katana::steal(), katana::no_stats(),
+      katana::loopname("MaxFlowBuildResidualGraph"));
+  katana::do_all(
+      katana::iterate(uint64_t{0}, capacities.size()),
+      [&](uint64_t i) {
+        graph->reverse[capacity_arcs[i]] = graph->flow_arcs[i];
+        graph->reverse[graph->flow_arcs[i]] = capacity_arcs[i];
+      },
+      katana::no_stats());
+}
+
+/// Breadth first search from root over the arcs with residual capacity,
+/// backward over the arcs into each node if backward, never entering
+/// blocked. Sets the distance from root of the nodes reached and the number
+/// of nodes for the others, and returns the number of arcs scanned.
+uint64_t
+ResidualBfs(
+    const ResidualGraph& graph, uint32_t root, uint64_t blocked, bool backward,
+    katana::NUMAArray<std::atomic<uint32_t>>* distances) {
+  const uint32_t num_nodes = graph.num_nodes();
+  katana::do_all(
+      katana::iterate(uint32_t{0}, num_nodes),
+      [&](uint32_t n) {
+        (*distances)[n].store(num_nodes, std::memory_order_relaxed);
+      },
+      katana::no_stats());
+  (*distances)[root].store(0, std::memory_order_relaxed);
+
+  katana::GAccumulator<uint64_t> scanned;
+  katana::InsertBag<uint32_t> frontiers[2];
+  frontiers[0].push(root);
+  for (uint32_t level = 1; !frontiers[(level - 1) % 2].empty(); ++level) {
+    auto& current = frontiers[(level - 1) % 2];
+    auto& next = frontiers[level % 2];
+    katana::do_all(
+        katana::iterate(current),
+        [&](uint32_t n) {
+          uint64_t end = graph.offsets[n + 1];
+          scanned += end - graph.offsets[n];
+          for (uint64_t arc = graph.offsets[n]; arc < end; ++arc) {
+            uint32_t dest = graph.dests[arc];
+            uint64_t along = backward ? graph.reverse[arc] : arc;
+            if (dest == blocked ||
+                graph.residual[along].load(std::memory_order_relaxed) <= 0) {
+              continue;
+            }
+            uint32_t unreached = num_nodes;
+            if ((*distances)[dest].load(std::memory_order_relaxed) ==
+                    num_nodes &&
+                (*distances)[dest].compare_exchange_strong(
+                    unreached, level, std::memory_order_relaxed)) {
+              next.push(dest);
+            }
+          }
+        },
+        katana::steal(), katana::chunk_size<kChunkSize>(), katana::no_stats(),
+        katana::loopname("MaxFlowResidualBfs"));
+    current.clear();
+  }
+  return scanned.reduce();
+}
+
+/// Asynchronous push-relabel over a residual graph. The source and sink are
+/// never discharged; in each phase the node toward which excess flows, the
+/// target, has height 0 and the other terminal is never entered.
+class PushRelabel {
+public:
+  PushRelabel(
+      ResidualGraph* graph, uint32_t source, uint32_t sink,
+      const MaxFlowPlan& plan)
+      : graph_(*graph),
+        num_nodes_(graph->num_nodes()),
+        source_(source),
+        sink_(sink),
+        gap_relabeling_(plan.gap_relabeling()) {
+    double interval = plan.global_relabel_frequency() *
+                      (kAlpha * num_nodes_ + graph->dests.size() / 2);
+    global_relabel_interval_ = std::max(interval, double{kWorkBatch});
+
+    excess_.allocateBlocked(num_nodes_);
+    heights_.allocateBlocked(num_nodes_);
+    height_counts_.allocateBlocked(num_nodes_);
+    locks_.allocateBlocked(num_nodes_);
+    katana::do_all(
+        katana::iterate(uint32_t{0}, num_nodes_),
+        [&](uint32_t n) {
+          excess_[n].store(0, std::memory_order_relaxed);
+          locks_[n].store(false, std::memory_order_relaxed);
+        },
+        katana::no_stats());
+  }
+
+  /// Compute a maximum flow, leaving it in the reverse arcs of the residual
+  /// graph
+  void Run() {
+    for (uint64_t arc = graph_.offsets[source_];
+         arc < graph_.offsets[source_ + 1]; ++arc) {
+      uint32_t dest = graph_.dests[arc];
+      int64_t capacity = graph_.residual[arc].load();
+      if (dest == source_ || capacity <= 0) {
+        continue;
+      }
+      graph_.residual[arc].store(0);
+      graph_.residual[graph_.reverse[arc]].fetch_add(capacity);
+      excess_[dest].fetch_add(capacity);
+      excess_[source_].fetch_sub(capacity);
+    }
+
+    // Push as much excess as possible to the sink, then return the rest to
+    // the source
+    Phase(sink_, source_);
+    Phase(source_, sink_);
+  }
+
+  uint64_t num_global_relabels() const { return num_global_relabels_; }
+
+  uint64_t num_gaps() { return num_gaps_.reduce(); }
+
+private:
+  void Phase(uint32_t target, uint32_t blocked) {
+    target_ = target;
+    blocked_ = blocked;
+    using WL = katana::PerSocketChunkFIFO<kChunkSize>;
+    for (;;) {
+      katana::InsertBag<uint32_t> active;
+      GlobalRelabel(&active);
+      if (active.empty()) {
+        break;
+      }
+      work_.store(0);
+      katana::for_each(
+          katana::iterate(active),
+          [&](uint32_t n, auto& ctx) {
+            if (Process(n, ctx)) {
+              ctx.breakLoop();
+            }
+          },
+          katana::disable_conflict_detection(), katana::parallel_break(),
+          katana::wl<WL>(), katana::loopname("MaxFlowDischarge"));
+    }
+  }
+
+  /// Set the heights to the distances to the target in the residual graph
+  /// and collect the nodes with excess that can reach it
+  void GlobalRelabel(katana::InsertBag<uint32_t>* active) {
+    ++num_global_relabels_;
+    ResidualBfs(graph_, target_, blocked_, true, &heights_);
+    katana::do_all(
+        katana::iterate(uint32_t{0}, num_nodes_),
+        [&](uint32_t n) {
+          height_counts_[n].store(0, std::memory_order_relaxed);
+        },
+        katana::no_stats());
+    katana::do_all(
+        katana::iterate(uint32_t{0}, num_nodes_),
+        [&](uint32_t n) {
+          uint32_t height = heights_[n].load(std::memory_order_relaxed);
+          if (height == num_nodes_) {
+            return;
+          }
+          height_counts_[height].fetch_add(1, std::memory_order_relaxed);
+          if (n != target_ && excess_[n].load() > 0) {
+            active->push(n);
+          }
+        },
+        katana::no_stats(), katana::loopname("MaxFlowGlobalRelabel"));
+  }
+
+  /// Discharge a node unless another thread is already discharging it.
+  /// Returns whether enough work has been done to globally relabel.
+  template <typename Context>
+  bool Process(uint32_t n, Context& ctx) {
+    if (locks_[n].exchange(true, std::memory_order_acquire)) {
+      return false;
+    }
+    int64_t work = 0;
+    for (;;) {
+      work += Discharge(n, ctx);
+      locks_[n].store(false, std::memory_order_release);
+      // Excess pushed to n while it was locked was not scheduled
+      if (excess_[n].load() <= 0 ||
+          heights_[n].load(std::memory_order_relaxed) >= num_nodes_ ||
+          locks_[n].exchange(true, std::memory_order_acquire)) {
+        break;
+      }
+    }
+    return AddWork(work);
+  }
+
+  /// Push the excess of n to lower neighbors, relabeling n to one more than
+  /// its lowest neighbor whenever it has none, until it has no excess or
+  /// cannot reach the target. Returns the work done.
+  template <typename Context>
+  int64_t Discharge(uint32_t n, Context& ctx) {
+    const uint64_t begin = graph_.offsets[n];
+    const uint64_t end = graph_.offsets[n + 1];
+    int64_t work = 0;
+    while (excess_[n].load(std::memory_order_relaxed) > 0) {
+      uint32_t height = heights_[n].load(std::memory_order_relaxed);
+      if (height >= num_nodes_) {
+        break;
+      }
+      uint32_t min_height = num_nodes_;
+      bool emptied = false;
+      work += end - begin;
+      for (uint64_t arc = begin; arc < end; ++arc) {
+        int64_t residual = graph_.residual[arc].load(std::memory_order_relaxed);
+        if (residual <= 0) {
+          continue;
+        }
+        uint32_t dest = graph_.dests[arc];
+        uint32_t dest_height = heights_[dest].load(std::memory_order_relaxed);
+        if (dest_height >= height) {
+          min_height = std::min(min_height, dest_height);
+          continue;
+        }
+        // Only this thread decreases the excess of n and the residual
+        // capacities of its arcs, so both are at least what was read
+        int64_t excess = excess_[n].load(std::memory_order_relaxed);
+        int64_t amount = std::min(excess, residual);
+        graph_.residual[arc].fetch_sub(amount);
+        graph_.residual[graph_.reverse[arc]].fetch_add(amount);
+        excess_[n].fetch_sub(amount);
+        if (excess_[dest].fetch_add(amount) <= 0 && dest != target_) {
+          ctx.push(dest);
+        }
+        if (amount == excess) {
+          emptied = true;
+          break;
+        }
+      }
+      if (!emptied) {
+        Relabel(n, height, min_height);
+        work += kBeta;
+      }
+    }
+    return work;
+  }
+
+  void Relabel(uint32_t n, uint32_t height, uint32_t min_height) {
+    uint32_t new_height = std::min(min_height + 1, num_nodes_);
+    if (gap_relabeling_) {
+      // If n was the last node at its height, no node above it can reach
+      // the target. A gap seen through racing updates may be spurious; the
+      // global relabel that ends each phase repairs it.
+      if (height_counts_[height].fetch_sub(1) == 1 &&
+          new_height < num_nodes_) {
+        new_height = num_nodes_;
+        num_gaps_ += 1;
+      }
+      if (new_height < num_nodes_) {
+        height_counts_[new_height].fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+    heights_[n].store(new_height, std::memory_order_relaxed);
+  }
+
+  /// Publish local work in batches; returns whether the total since the last
+  /// global relabel has reached the interval
+  bool AddWork(int64_t amount) {
+    int64_t& local = *local_work_.getLocal();
+    local += amount;
+    if (local < kWorkBatch) {
+      return false;
+    }
+    int64_t total = work_.fetch_add(local) + local;
+    local = 0;
+    return total >= global_relabel_interval_;
+  }
+
+  ResidualGraph& graph_;
+  const uint32_t num_nodes_;
+  const uint32_t source_;
+  const uint32_t sink_;
+  const bool gap_relabeling_;
+  int64_t global_relabel_interval_;
+  uint32_t target_{0};
+  uint32_t blocked_{0};
+
+  katana::NUMAArray<std::atomic<int64_t>> excess_;
+  katana::NUMAArray<std::atomic<uint32_t>> heights_;
+  katana::NUMAArray<std::atomic<uint32_t>> height_counts_;
+  katana::NUMAArray<std::atomic<bool>> locks_;
+
+  std::atomic<int64_t> work_{0};
+  katana::PerThreadStorage<int64_t> local_work_{0};
+  uint64_t num_global_relabels_{0};
+  katana::GAccumulator<uint64_t> num_gaps_;
+};
+
+template <typename T>
+katana::Result<void>
+CopyCapacities(
+    katana::PropertyGraph* pg, const std::string& capacity_property_name,
+    katana::NUMAArray<int64_t>* capacities) {
+  auto values =
+      KATANA_CHECKED(pg->GetEdgePropertyTyped<T>(capacity_property_name));
+  capacities->allocateBlocked(values->length());
+  katana::GReduceLogicalOr invalid;
+  katana::do_all(
+      katana::iterate(int64_t{0}, values->length()),
+      [&](int64_t i) {
+        T value = values->Value(i);
+        if constexpr (std::is_signed_v<T>) {
+          invalid.update(value < 0);
+        } else {
+          invalid.update(
+              uint64_t{value} >
+              uint64_t{std::numeric_limits<int64_t>::max()});
+        }
+        (*capacities)[i] = static_cast<int64_t>(value);
+      },
+      katana::no_stats());
+  if (invalid.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "capacities must be in [0, 2^63)");
+  }
+  return katana::ResultSuccess();
+}
+
+/// The capacities as 64 bit integers, indexed by edge property index
+katana::Result<katana::NUMAArray<int64_t>>
+ReadCapacities(
+    katana::PropertyGraph* pg, const std::string& capacity_property_name) {
+  katana::NUMAArray<int64_t> capacities;
+  // Floating point capacities are not supported
+  using CapacityTypes = katana::CTypeList<uint32_t, int32_t, uint64_t, int64_t>;
+  KATANA_CHECKED(DispatchOnEdgePropertyType<CapacityTypes>(
+      pg, capacity_property_name, [&](auto tag) {
+        return CopyCapacities<decltype(tag)>(
+            pg, capacity_property_name, &capacities);
+      }));
+  return katana::Result<katana::NUMAArray<int64_t>>(std::move(capacities));
+}
+
+katana::Result<void>
+CheckTerminals(katana::PropertyGraph* pg, uint32_t source, uint32_t sink) {
+  if (source >= pg->num_nodes() || sink >= pg->num_nodes()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "source {} and sink {} must be nodes of a graph with {} nodes", source,
+        sink, pg->num_nodes());
+  }
+  if (source == sink) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "source and sink must differ, got {}", source);
+  }
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::MaxFlow(
+    PropertyGraph* pg, uint32_t source, uint32_t sink,
+    const std::string& capacity_property_name,
+    const std::string& output_flow_property_name,
+    const std::string& output_cut_property_name, MaxFlowPlan plan) {
+  KATANA_CHECKED(CheckTerminals(pg, source, sink));
+  if (!(plan.global_relabel_frequency() > 0)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "global relabel frequency must be positive, got {}",
+        plan.global_relabel_frequency());
+  }
+  auto capacities =
+      KATANA_CHECKED(ReadCapacities(pg, capacity_property_name));
+
+  ResidualGraph graph;
+  {
+    auto view = pg->BuildView<katana::PropertyGraphViews::BiDirectional>();
+    BuildResidualGraph(view, capacities, &graph);
+  }
+  // The excess of every node is bounded by the capacity out of the source
+  int64_t source_capacity = 0;
+  for (uint64_t arc = graph.offsets[source]; arc < graph.offsets[source + 1];
+       ++arc) {
+    if (__builtin_add_overflow(
+            source_capacity, graph.residual[arc].load(), &source_capacity)) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "total capacity out of the source must be below 2^63");
+    }
+  }
+
+  katana::StatTimer exec_time("MaxFlow");
+  exec_time.start();
+  switch (plan.algorithm()) {
+  case MaxFlowPlan::kPushRelabel: {
+    PushRelabel algo(&graph, source, sink, plan);
+    algo.Run();
+    katana::ReportStatSingle(
+        "MaxFlow", "GlobalRelabels", algo.num_global_relabels());
+    katana::ReportStatSingle("MaxFlow", "Gaps", algo.num_gaps());
+    break;
+  }
+  default:
+    return katana::ErrorCode::InvalidArgument;
+  }
+  exec_time.stop();
+
+  const uint64_t num_edges = capacities.size();
+  std::shared_ptr<arrow::Buffer> flow_buffer =
+      KATANA_CHECKED(arrow::AllocateBuffer(num_edges * sizeof(uint64_t)));
+  auto* flows = reinterpret_cast<uint64_t*>(flow_buffer->mutable_data());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t i) { flows[i] = graph.residual[graph.flow_arcs[i]].load(); },
+      katana::no_stats());
+  auto flow_array =
+      std::make_shared<arrow::UInt64Array>(num_edges, flow_buffer);
+  KATANA_CHECKED(pg->AddEdgeProperties(arrow::Table::Make(
+      arrow::schema(
+          {arrow::field(output_flow_property_name, arrow::uint64())}),
+      {flow_array})));
+
+  // The source side of the minimum cut is what the source still reaches
+  const uint64_t num_nodes = pg->num_nodes();
+  katana::NUMAArray<std::atomic<uint32_t>> distances;
+  distances.allocateBlocked(num_nodes);
+  ResidualBfs(graph, source, num_nodes, false, &distances);
+  std::shared_ptr<arrow::Buffer> cut_buffer =
+      KATANA_CHECKED(arrow::AllocateBuffer(num_nodes * sizeof(uint8_t)));
+  uint8_t* cut = cut_buffer->mutable_data();
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { cut[n] = distances[n].load() < num_nodes; },
+      katana::no_stats());
+  auto cut_array = std::make_shared<arrow::UInt8Array>(num_nodes, cut_buffer);
+  return pg->AddNodeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field(output_cut_property_name, arrow::uint8())}),
+      {cut_array}));
+}
+
+katana::Result<void>
+katana::analytics::MaxFlowAssertValid(
+    PropertyGraph* pg, uint32_t source, uint32_t sink,
+    const std::string& capacity_property_name,
+    const std::string& flow_property_name) {
+  KATANA_CHECKED(CheckTerminals(pg, source, sink));
+  auto capacities =
+      KATANA_CHECKED(ReadCapacities(pg, capacity_property_name));
+  auto flows =
+      KATANA_CHECKED(pg->GetEdgePropertyTyped<uint64_t>(flow_property_name));
+
+  katana::GReduceLogicalOr over_capacity;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, capacities.size()),
+      [&](uint64_t i) {
+        over_capacity.update(flows->Value(i) > uint64_t(capacities[i]));
+      },
+      katana::no_stats());
+  if (over_capacity.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed, "flow exceeds capacity");
+  }
+
+  const auto& topology = pg->topology();
+  katana::NUMAArray<std::atomic<int64_t>> net;
+  net.allocateBlocked(topology.num_nodes());
+  katana::do_all(
+      katana::iterate(topology.all_nodes()),
+      [&](auto n) { net[n].store(0, std::memory_order_relaxed); },
+      katana::no_stats());
+  katana::do_all(
+      katana::iterate(topology.all_nodes()),
+      [&](auto n) {
+        for (auto e : topology.edges(n)) {
+          int64_t flow = flows->Value(topology.edge_property_index(e));
+          net[n].fetch_sub(flow, std::memory_order_relaxed);
+          net[topology.edge_dest(e)].fetch_add(
+              flow, std::memory_order_relaxed);
+        }
+      },
+      katana::steal(), katana::no_stats());
+  katana::GReduceLogicalOr unbalanced;
+  katana::do_all(
+      katana::iterate(topology.all_nodes()),
+      [&](auto n) {
+        unbalanced.update(n != source && n != sink && net[n].load() != 0);
+      },
+      katana::no_stats());
+  if (unbalanced.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed, "flow is not conserved");
+  }
+
+  ResidualGraph graph;
+  {
+    auto view = pg->BuildView<katana::PropertyGraphViews::BiDirectional>();
+    BuildResidualGraph(view, capacities, &graph);
+  }
+  katana::do_all(
+      katana::iterate(uint64_t{0}, capacities.size()),
+      [&](uint64_t i) {
+        uint64_t flow_arc = graph.flow_arcs[i];
+        int64_t flow = flows->Value(i);
+        graph.residual[flow_arc].store(flow);
+        graph.residual[graph.reverse[flow_arc]].store(capacities[i] - flow);
+      },
+      katana::no_stats());
+  katana::NUMAArray<std::atomic<uint32_t>> distances;
+  distances.allocateBlocked(topology.num_nodes());
+  ResidualBfs(graph, source, topology.num_nodes(), false, &distances);
+  if (distances[sink].load() < topology.num_nodes()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "the residual graph has a path from source to sink");
+  }
+  return katana::ResultSuccess();
+}
+
+void
+katana::analytics::MaxFlowStatistics::Print(std::ostream& os) const {
+  os << "Flow value = " << flow_value << std::endl;
+  os << "Number of cut edges = " << num_cut_edges << std::endl;
+}
+
+katana::Result<MaxFlowStatistics>
+katana::analytics::MaxFlowStatistics::Compute(
+    katana::PropertyGraph* pg, uint32_t source,
+    const std::string& flow_property_name,
+    const std::string& cut_property_name) {
+  auto flows =
+      KATANA_CHECKED(pg->GetEdgePropertyTyped<uint64_t>(flow_property_name));
+  auto cut =
+      KATANA_CHECKED(pg->GetNodePropertyTyped<uint8_t>(cut_property_name));
+
+  const auto& topology = pg->topology();
+  katana::GAccumulator<int64_t> flow_value;
+  katana::GAccumulator<uint64_t> num_cut_edges;
+  katana::do_all(
+      katana::iterate(topology.all_nodes()),
+      [&](auto n) {
+        for (auto e : topology.edges(n)) {
+          auto dest = topology.edge_dest(e);
+          int64_t flow = flows->Value(topology.edge_property_index(e));
+          if (n == source && dest != source) {
+            flow_value += flow;
+          } else if (dest == source && n != source) {
+            flow_value -= flow;
+          }
+          if (cut->Value(n) && !cut->Value(dest)) {
+            num_cut_edges += 1;
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+  return MaxFlowStatistics{
+      static_cast<uint64_t>(flow_value.reduce()), num_cut_edges.reduce()};
+}
@@ -0,0 +1,573 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2020, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "katana/analytics/minimum_spanning_forest/minimum_spanning_forest.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <type_traits>
+
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Reduction.h"
+#include "katana/Statistics.h"
+#include "katana/Timer.h"
+#include "katana/UnionFind.h"
+#include "katana/analytics/Utils.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+constexpr uint32_t kNone = std::numeric_limits<uint32_t>::max();
+/// Filter-Kruskal pivots on the median of this many sampled edges
+constexpr uint32_t kPivotSamples = 63;
+
+/// An edge seen from one of its endpoints
+template <typename Weight>
+struct Arc {
+  Weight weight;
+  /// The edge property index, which breaks ties between equal weights
+  uint64_t id;
+  uint32_t dest;
+};
+
+template <typename Weight>
+struct WeightedEdge {
+  Weight weight;
+  uint64_t id;
+  uint32_t src;
+  uint32_t dest;
+};
+
+/// The strict total order on edges: by weight, then by edge property index
+struct Lighter {
+  template <typename E>
+  bool operator()(const E& a, const E& b) const {
+    return a.weight < b.weight || (a.weight == b.weight && a.id < b.id);
+  }
+};
+
+/// An undirected graph in compressed sparse row form, without self loops and
+/// with only the lightest of parallel edges
+template <typename Weight>
+struct Level {
+  /// offsets[n] to offsets[n + 1] are the arcs of n
+  katana::NUMAArray<uint64_t> offsets;
+  katana::NUMAArray<Arc<Weight>> arcs;
+
+  uint64_t num_nodes() const { return offsets.size() - 1; }
+};
+
+/// Build the arcs of level from unsorted arcs with duplicates: the arcs of
+/// node n are scratch[bounds[n]] to scratch[bounds[n] + counts[n]]
+template <typename Weight>
+void
+CompactArcs(
+    const katana::NUMAArray<uint64_t>& bounds,
+    katana::NUMAArray<uint64_t>* counts,
+    katana::NUMAArray<Arc<Weight>>* scratch, Level<Weight>* level) {
+  const uint64_t num_nodes = counts->size();
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        Arc<Weight>* begin = scratch->data() + bounds[n];
+        Arc<Weight>* end = begin + (*counts)[n];
+        std::sort(begin, end, [](const auto& a, const auto& b) {
+          return a.dest < b.dest || (a.dest == b.dest && Lighter()(a, b));
+        });
+        // Keep the lightest arc to each destination
+        Arc<Weight>* out =
+            std::unique(begin, end, [](const auto& a, const auto& b) {
+              return a.dest == b.dest;
+            });
+        (*counts)[n] = out - begin;
+      },
+      katana::steal(), katana::no_stats(),
+      katana::loopname("MinimumSpanningForestCompact"));
+
+  level->offsets.allocateBlocked(num_nodes + 1);
+  level->offsets[0] = 0;
+  katana::ParallelSTL::partial_sum(
+      counts->begin(), counts->end(), level->offsets.begin() + 1);
+  level->arcs.allocateBlocked(level->offsets[num_nodes]);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        const Arc<Weight>* begin = scratch->data() + bounds[n];
+        std::copy(
+            begin, begin + (*counts)[n],
+            level->arcs.data() + level->offsets[n]);
+      },
+      katana::no_stats());
+}
+
+template <typename View, typename Weight>
+void
+BuildFinestLevel(
+    const View& view, const katana::NUMAArray<Weight>& weights,
+    Level<Weight>* level) {
+  const uint64_t num_nodes = view.num_nodes();
+  katana::NUMAArray<uint64_t> counts;
+  counts.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        counts[n] = view.edges(n).size() + view.in_edges(n).size();
+      },
+      katana::no_stats());
+  katana::NUMAArray<uint64_t> bounds;
+  bounds.allocateBlocked(num_nodes + 1);
+  bounds[0] = 0;
+  katana::ParallelSTL::partial_sum(
+      counts.begin(), counts.end(), bounds.begin() + 1);
+
+  katana::NUMAArray<Arc<Weight>> scratch;
+  scratch.allocateBlocked(bounds[num_nodes]);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        Arc<Weight>* out = scratch.data() + bounds[n];
+        for (auto e : view.edges(n)) {
+          uint32_t dest = view.edge_dest(e);
+          if (dest != n) {
+            uint64_t id = view.edge_property_index(e);
+            *out++ = Arc<Weight>{weights[id], id, dest};
+          }
+        }
+        for (auto e : view.in_edges(n)) {
+          uint32_t dest = view.in_edge_dest(e);
+          if (dest != n) {
+            uint64_t id = view.in_edge_property_index(e);
+            *out++ = Arc<Weight>{weights[id], id, dest};
+          }
+        }
+        counts[n] = out - (scratch.data() + bounds[n]);
+      },
+      katana::steal(), katana::no_stats(),
+      katana::loopname("MinimumSpanningForestBuild"));
+  CompactArcs(bounds, &counts, &scratch, level);
+}
+
+/// Contract the components joined by the lightest arc of each node of level
+/// into the next level, marking those edges in forest. Nodes without arcs
+/// are dropped.
+template <typename Weight>
+Level<Weight>
+BoruvkaRound(const Level<Weight>& level, uint8_t* forest) {
+  const uint64_t num_nodes = level.num_nodes();
+  katana::NUMAArray<uint32_t> targets;
+  targets.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        const Arc<Weight>* begin = level.arcs.data() + level.offsets[n];
+        const Arc<Weight>* end = level.arcs.data() + level.offsets[n + 1];
+        if (begin == end) {
+          targets[n] = kNone;
+          return;
+        }
+        const Arc<Weight>* lightest = std::min_element(begin, end, Lighter());
+        targets[n] = lightest->dest;
+        forest[lightest->id] = 1;
+      },
+      katana::steal(), katana::no_stats(),
+      katana::loopname("MinimumSpanningForestLightest"));
+
+  // The lightest arcs form trees whose roots are pairs of nodes that picked
+  // each other, since the order on edges is strict; the smaller node of each
+  // pair becomes the root
+  katana::NUMAArray<std::atomic<uint32_t>> parents;
+  parents.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint32_t target = targets[n];
+        bool root = target == kNone || (targets[target] == n && n < target);
+        parents[n].store(root ? n : target, std::memory_order_relaxed);
+      },
+      katana::no_stats());
+  for (bool changed = true; changed;) {
+    katana::GReduceLogicalOr jumped;
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) {
+          uint32_t parent = parents[n].load(std::memory_order_relaxed);
+          uint32_t grandparent =
+              parents[parent].load(std::memory_order_relaxed);
+          if (parent != grandparent) {
+            parents[n].store(grandparent, std::memory_order_relaxed);
+            jumped.update(true);
+          }
+        },
+        katana::no_stats(), katana::loopname("MinimumSpanningForestJump"));
+    changed = jumped.reduce();
+  }
+
+  // Number the roots of the components that had arcs
+  katana::NUMAArray<uint64_t> labels;
+  labels.allocateBlocked(num_nodes + 1);
+  labels[0] = 0;
+  katana::NUMAArray<uint64_t> is_root;
+  is_root.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        is_root[n] = targets[n] != kNone && parents[n].load() == n;
+      },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      is_root.begin(), is_root.end(), labels.begin() + 1);
+  const uint64_t next_num_nodes = labels[num_nodes];
+  auto label = [&](uint32_t n) -> uint32_t {
+    return labels[parents[n].load(std::memory_order_relaxed)];
+  };
+
+  // Reserve space for the arcs of each node within its new node
+  katana::NUMAArray<std::atomic<uint64_t>> sizes;
+  sizes.allocateBlocked(next_num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, next_num_nodes),
+      [&](uint64_t n) { sizes[n].store(0, std::memory_order_relaxed); },
+      katana::no_stats());
+  katana::NUMAArray<uint64_t> positions;
+  positions.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        if (targets[n] == kNone) {
+          return;
+        }
+        uint32_t component = label(n);
+        uint64_t count = 0;
+        for (uint64_t a = level.offsets[n]; a < level.offsets[n + 1]; ++a) {
+          count += label(level.arcs[a].dest) != component;
+        }
+        positions[n] = sizes[component].fetch_add(count);
+      },
+      katana::steal(), katana::no_stats());
+
+  katana::NUMAArray<uint64_t> counts;
+  counts.allocateBlocked(next_num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, next_num_nodes),
+      [&](uint64_t n) { counts[n] = sizes[n].load(); }, katana::no_stats());
+  katana::NUMAArray<uint64_t> bounds;
+  bounds.allocateBlocked(next_num_nodes + 1);
+  bounds[0] = 0;
+  katana::ParallelSTL::partial_sum(
+      counts.begin(), counts.end(), bounds.begin() + 1);
+
+  katana::NUMAArray<Arc<Weight>> scratch;
+  scratch.allocateBlocked(bounds[next_num_nodes]);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        if (targets[n] == kNone) {
+          return;
+        }
+        uint32_t component = label(n);
+        Arc<Weight>* out = scratch.data() + bounds[component] + positions[n];
+        for (uint64_t a = level.offsets[n]; a < level.offsets[n + 1]; ++a) {
+          uint32_t dest = label(level.arcs[a].dest);
+          if (dest != component) {
+            *out++ = Arc<Weight>{level.arcs[a].weight, level.arcs[a].id, dest};
+          }
+        }
+      },
+      katana::steal(), katana::no_stats(),
+      katana::loopname("MinimumSpanningForestContract"));
+
+  Level<Weight> next;
+  CompactArcs(bounds, &counts, &scratch, &next);
+  return next;
+}
+
+template <typename Weight>
+void
+Boruvka(Level<Weight> level, uint8_t* forest) {
+  uint64_t rounds = 0;
+  while (level.num_nodes() > 0) {
+    level = BoruvkaRound(level, forest);
+    ++rounds;
+  }
+  katana::ReportStatSingle("MinimumSpanningForest", "Rounds", rounds);
+}
+
+struct ForestNode : public katana::UnionFindNode<ForestNode> {
+  ForestNode() : katana::UnionFindNode<ForestNode>(this) {}
+};
+
+template <typename Weight>
+class FilterKruskal {
+public:
+  FilterKruskal(uint64_t num_nodes, uint64_t base_case_size, uint8_t* forest)
+      : base_case_size_(base_case_size), forest_(forest) {
+    components_.allocateBlocked(num_nodes);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) { components_.constructAt(n); }, katana::no_stats());
+  }
+
+  void Run(WeightedEdge<Weight>* begin, WeightedEdge<Weight>* end) {
+    if (uint64_t(end - begin) <= base_case_size_) {
+      Kruskal(begin, end);
+      return;
+    }
+    WeightedEdge<Weight> pivot = Pivot(begin, end);
+    WeightedEdge<Weight>* middle = katana::ParallelSTL::partition(
+        begin, end, [&](const auto& e) { return !Lighter()(pivot, e); });
+    if (middle == end) {
+      Kruskal(begin, end);
+      return;
+    }
+    Run(begin, middle);
+    // Heavy edges within a component can never join the forest
+    WeightedEdge<Weight>* remaining = katana::ParallelSTL::partition(
+        middle, end, [&](const auto& e) {
+          return components_[e.src].find() != components_[e.dest].find();
+        });
+    Run(middle, remaining);
+  }
+
+private:
+  void Kruskal(WeightedEdge<Weight>* begin, WeightedEdge<Weight>* end) {
+    katana::ParallelSTL::sort(begin, end, Lighter());
+    for (WeightedEdge<Weight>* e = begin; e != end; ++e) {
+      if (components_[e->src].merge(&components_[e->dest])) {
+        forest_[e->id] = 1;
+      }
+    }
+  }
+
+  /// The median of a sample of the edges
+  WeightedEdge<Weight> Pivot(
+      WeightedEdge<Weight>* begin, WeightedEdge<Weight>* end) {
+    WeightedEdge<Weight> samples[kPivotSamples];
+    for (auto& sample : samples) {
+      // splitmix64
+      uint64_t z = (state_ += 0x9E3779B97F4A7C15ULL);
+      z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+      z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+      sample = begin[(z ^ (z >> 31)) % uint64_t(end - begin)];
+    }
+    std::nth_element(
+        samples, samples + kPivotSamples / 2, samples + kPivotSamples,
+        Lighter());
+    return samples[kPivotSamples / 2];
+  }
+
+  const uint64_t base_case_size_;
+  uint8_t* forest_;
+  katana::NUMAArray<ForestNode> components_;
+  uint64_t state_{0};
+};
+
+template <typename Weight>
+void
+FilterKruskalForest(
+    const katana::GraphTopology& topology,
+    const katana::NUMAArray<Weight>& weights, uint64_t base_case_size,
+    uint8_t* forest) {
+  katana::NUMAArray<WeightedEdge<Weight>> edges;
+  edges.allocateBlocked(topology.num_edges());
+  katana::do_all(
+      katana::iterate(topology.all_nodes()),
+      [&](auto n) {
+        for (auto e : topology.edges(n)) {
+          uint64_t id = topology.edge_property_index(e);
+          edges[e] = WeightedEdge<Weight>{
+              weights[id], id, static_cast<uint32_t>(n),
+              static_cast<uint32_t>(topology.edge_dest(e))};
+        }
+      },
+      katana::steal(), katana::no_stats());
+  WeightedEdge<Weight>* end = katana::ParallelSTL::partition(
+      edges.begin(), edges.end(),
+      [](const auto& e) { return e.src != e.dest; });
+
+  FilterKruskal<Weight> algo(topology.num_nodes(), base_case_size, forest);
+  algo.Run(edges.begin(), end);
+}
+
+/// The weights, indexed by edge property index
+template <typename Weight>
+katana::Result<katana::NUMAArray<Weight>>
+ReadWeights(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name) {
+  auto values = KATANA_CHECKED(
+      pg->GetEdgePropertyTyped<Weight>(edge_weight_property_name));
+  katana::NUMAArray<Weight> weights;
+  weights.allocateBlocked(values->length());
+  katana::GReduceLogicalOr is_nan;
+  katana::do_all(
+      katana::iterate(int64_t{0}, values->length()),
+      [&](int64_t i) {
+        weights[i] = values->Value(i);
+        if constexpr (std::is_floating_point_v<Weight>) {
+          is_nan.update(std::isnan(weights[i]));
+        }
+      },
+      katana::no_stats());
+  if (is_nan.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "edge weights may not be NaN");
+  }
+  return katana::Result<katana::NUMAArray<Weight>>(std::move(weights));
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::MinimumSpanningForest(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name, MinimumSpanningForestPlan plan) {
+  if (plan.algorithm() != MinimumSpanningForestPlan::kBoruvka &&
+      plan.algorithm() != MinimumSpanningForestPlan::kFilterKruskal) {
+    return katana::ErrorCode::InvalidArgument;
+  }
+  const uint64_t num_edges = pg->num_edges();
+  std::shared_ptr<arrow::Buffer> buffer =
+      KATANA_CHECKED(arrow::AllocateBuffer(num_edges * sizeof(uint8_t)));
+  uint8_t* forest = buffer->mutable_data();
+  katana::ParallelSTL::fill(forest, forest + num_edges, uint8_t{0});
+
+  katana::StatTimer exec_time("MinimumSpanningForest");
+  KATANA_CHECKED(DispatchOnEdgePropertyType(
+      pg, edge_weight_property_name, [&](auto tag) -> katana::Result<void> {
+        using Weight = decltype(tag);
+        auto weights =
+            KATANA_CHECKED(ReadWeights<Weight>(pg, edge_weight_property_name));
+        exec_time.start();
+        if (plan.algorithm() == MinimumSpanningForestPlan::kBoruvka) {
+          Level<Weight> finest;
+          {
+            auto view =
+                pg->BuildView<katana::PropertyGraphViews::BiDirectional>();
+            BuildFinestLevel(view, weights, &finest);
+          }
+          Boruvka(std::move(finest), forest);
+        } else {
+          FilterKruskalForest(
+              pg->topology(), weights, plan.base_case_size(), forest);
+        }
+        exec_time.stop();
+        return katana::ResultSuccess();
+      }));
+
+  auto array = std::make_shared<arrow::UInt8Array>(num_edges, buffer);
+  return pg->AddEdgeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field(output_property_name, arrow::uint8())}),
+      {array}));
+}
+
+katana::Result<void>
+katana::analytics::MinimumSpanningForestAssertValid(
+    PropertyGraph* pg, const std::string& property_name) {
+  auto forest =
+      KATANA_CHECKED(pg->GetEdgePropertyTyped<uint8_t>(property_name));
+  const auto& topology = pg->topology();
+
+  katana::NUMAArray<ForestNode> components;
+  components.allocateBlocked(topology.num_nodes());
+  katana::do_all(
+      katana::iterate(topology.all_nodes()),
+      [&](auto n) { components.constructAt(n); }, katana::no_stats());
+
+  // Merging the ends of an edge fails exactly when they are already
+  // connected, in whichever order the edges are merged
+  katana::GReduceLogicalOr cycle;
+  katana::do_all(
+      katana::iterate(topology.all_nodes()),
+      [&](auto n) {
+        for (auto e : topology.edges(n)) {
+          if (forest->Value(topology.edge_property_index(e)) &&
+              !components[n].merge(&components[topology.edge_dest(e)])) {
+            cycle.update(true);
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+  if (cycle.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed, "forest edges form a cycle");
+  }
+
+  katana::GReduceLogicalOr disconnected;
+  katana::do_all(
+      katana::iterate(topology.all_nodes()),
+      [&](auto n) {
+        for (auto e : topology.edges(n)) {
+          if (components[n].find() !=
+              components[topology.edge_dest(e)].find()) {
+            disconnected.update(true);
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+  if (disconnected.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "forest does not span a connected component");
+  }
+  return katana::ResultSuccess();
+}
+
+void
+katana::analytics::MinimumSpanningForestStatistics::Print(
+    std::ostream& os) const {
+  os << "Number of forest edges = " << num_forest_edges << std::endl;
+  os << "Number of trees = " << num_trees << std::endl;
+  os << "Total weight = " << total_weight << std::endl;
+}
+
+katana::Result<MinimumSpanningForestStatistics>
+katana::analytics::MinimumSpanningForestStatistics::Compute(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& property_name) {
+  auto forest =
+      KATANA_CHECKED(pg->GetEdgePropertyTyped<uint8_t>(property_name));
+
+  katana::GAccumulator<uint64_t> num_forest_edges;
+  katana::GAccumulator<double> total_weight;
+  KATANA_CHECKED(DispatchOnEdgePropertyType(
+      pg, edge_weight_property_name, [&](auto tag) -> katana::Result<void> {
+        using Weight = decltype(tag);
+        auto weights = KATANA_CHECKED(
+            pg->GetEdgePropertyTyped<Weight>(edge_weight_property_name));
+        katana::do_all(
+            katana::iterate(int64_t{0}, forest->length()),
+            [&](int64_t i) {
+              if (forest->Value(i)) {
+                num_forest_edges += 1;
+                total_weight += weights->Value(i);
+              }
+            },
+            katana::no_stats());
+        return katana::ResultSuccess();
+      }));
+
+  uint64_t num_edges = num_forest_edges.reduce();
+  return MinimumSpanningForestStatistics{
+      num_edges, pg->num_nodes() - num_edges, total_weight.reduce()};
+}
@@ -0,0 +1,231 @@
+#include "katana/analytics/out_of_core/out_of_core.h"
+
+#include <atomic>
+#include <cmath>
+#include <limits>
+
+#include "katana/AtomicHelpers.h"
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Reduction.h"
+#include "katana/Statistics.h"
+#include "katana/Timer.h"
+#include "tsuba/RDGEdgeStream.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+constexpr uint32_t kUnreached = std::numeric_limits<uint32_t>::max();
+
+/// An open RDG and a stream of its edges
+struct EdgeSource {
+  std::unique_ptr<tsuba::RDGFile> rdg_file;
+  std::unique_ptr<tsuba::RDGEdgeStream> stream;
+};
+
+katana::Result<EdgeSource>
+OpenEdges(const std::string& rdg_name, const OutOfCorePlan& plan) {
+  EdgeSource source;
+  source.rdg_file = std::make_unique<tsuba::RDGFile>(
+      KATANA_CHECKED(tsuba::Open(rdg_name, tsuba::kReadOnly)));
+  tsuba::RDGEdgeStream::Options opts;
+  opts.block_bytes = plan.block_bytes();
+  opts.max_resident_blocks = plan.max_resident_blocks();
+  source.stream = KATANA_CHECKED_CONTEXT(
+      tsuba::RDGEdgeStream::Make(*source.rdg_file, opts), "streaming {}",
+      rdg_name);
+  return std::move(source);
+}
+
+/// Call visit(src, dest) for every edge, one block at a time, in parallel
+/// within a block
+template <typename Visit>
+katana::Result<void>
+ForEachEdge(tsuba::RDGEdgeStream* stream, const char* loopname, Visit visit) {
+  KATANA_CHECKED(stream->Rewind());
+  while (true) {
+    const tsuba::RDGEdgeStream::Block* block = KATANA_CHECKED(stream->Next());
+    if (block == nullptr) {
+      return katana::ResultSuccess();
+    }
+    katana::do_all(
+        katana::iterate(block->first_node(), block->end_node()),
+        [&](uint64_t src) {
+          auto [begin, end] = block->edges(src);
+          for (uint64_t e = begin; e < end; ++e) {
+            visit(src, block->dest(e));
+          }
+        },
+        katana::steal(), katana::no_stats(), katana::loopname(loopname));
+  }
+}
+
+template <typename Builder, typename T>
+katana::Result<std::shared_ptr<arrow::Array>>
+ToArrow(const katana::NUMAArray<std::atomic<T>>& values) {
+  Builder builder;
+  KATANA_CHECKED(builder.Resize(values.size()));
+  for (const auto& value : values) {
+    builder.UnsafeAppend(value.load(std::memory_order_relaxed));
+  }
+  return KATANA_CHECKED(builder.Finish());
+}
+
+}  // namespace
+
+katana::Result<std::shared_ptr<arrow::Array>>
+katana::analytics::OutOfCorePagerank(
+    const std::string& rdg_name, const PagerankPlan& pagerank_plan,
+    const OutOfCorePlan& plan) {
+  EdgeSource source = KATANA_CHECKED(OpenEdges(rdg_name, plan));
+  tsuba::RDGEdgeStream* stream = source.stream.get();
+  uint64_t num_nodes = stream->num_nodes();
+
+  katana::NUMAArray<std::atomic<float>> rank;
+  katana::NUMAArray<std::atomic<float>> sum;
+  katana::NUMAArray<float> contribution;
+  rank.allocateBlocked(num_nodes);
+  sum.allocateBlocked(num_nodes);
+  contribution.allocateBlocked(num_nodes);
+  katana::ParallelSTL::fill(rank.begin(), rank.end(), 1.0F / num_nodes);
+
+  katana::StatTimer exec_time("OutOfCore", "Pagerank");
+  exec_time.start();
+  float base_score = (1.0F - pagerank_plan.alpha()) / num_nodes;
+  unsigned iteration = 0;
+  katana::GAccumulator<float> change;
+  while (iteration < pagerank_plan.max_iterations()) {
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) {
+          uint64_t degree = stream->out_degree(n);
+          contribution[n] =
+              degree == 0 ? 0 : rank[n].load(std::memory_order_relaxed) /
+                                    static_cast<float>(degree);
+          sum[n].store(0, std::memory_order_relaxed);
+        },
+        katana::no_stats());
+
+    KATANA_CHECKED(ForEachEdge(
+        stream, "OutOfCorePagerank", [&](uint64_t src, uint64_t dest) {
+          katana::atomicAdd(sum[dest], contribution[src]);
+        }));
+
+    change.reset();
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) {
+          float value = base_score + pagerank_plan.alpha() *
+                                         sum[n].load(std::memory_order_relaxed);
+          change += std::fabs(value - rank[n].load(std::memory_order_relaxed));
+          rank[n].store(value, std::memory_order_relaxed);
+        },
+        katana::no_stats());
+    ++iteration;
+    if (change.reduce() <= pagerank_plan.tolerance()) {
+      break;
+    }
+  }
+  exec_time.stop();
+  katana::ReportStatSingle("OutOfCorePagerank", "Iterations", iteration);
+  return ToArrow<arrow::FloatBuilder>(rank);
+}
+
+katana::Result<std::shared_ptr<arrow::Array>>
+katana::analytics::OutOfCoreBfs(
+    const std::string& rdg_name, uint64_t source_node,
+    const OutOfCorePlan& plan) {
+  EdgeSource source = KATANA_CHECKED(OpenEdges(rdg_name, plan));
+  tsuba::RDGEdgeStream* stream = source.stream.get();
+  uint64_t num_nodes = stream->num_nodes();
+  if (source_node >= num_nodes) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "source {} is not a node",
+        source_node);
+  }
+
+  katana::NUMAArray<std::atomic<uint32_t>> level;
+  level.allocateBlocked(num_nodes);
+  katana::ParallelSTL::fill(level.begin(), level.end(), kUnreached);
+  level[source_node] = 0;
+
+  katana::StatTimer exec_time("OutOfCore", "Bfs");
+  exec_time.start();
+  uint32_t current = 0;
+  katana::GReduceLogicalOr found;
+  do {
+    found.reset();
+    KATANA_CHECKED(ForEachEdge(
+        stream, "OutOfCoreBfs", [&](uint64_t src, uint64_t dest) {
+          if (level[src].load(std::memory_order_relaxed) != current) {
+            return;
+          }
+          uint32_t unreached = kUnreached;
+          if (level[dest].compare_exchange_strong(unreached, current + 1)) {
+            found.update(true);
+          }
+        }));
+    ++current;
+  } while (found.reduce());
+  exec_time.stop();
+  katana::ReportStatSingle("OutOfCoreBfs", "Levels", current);
+  return ToArrow<arrow::UInt32Builder>(level);
+}
+
+katana::Result<std::shared_ptr<arrow::Array>>
+katana::analytics::OutOfCoreConnectedComponents(
+    const std::string& rdg_name, const OutOfCorePlan& plan) {
+  EdgeSource source = KATANA_CHECKED(OpenEdges(rdg_name, plan));
+  tsuba::RDGEdgeStream* stream = source.stream.get();
+  uint64_t num_nodes = stream->num_nodes();
+
+  katana::NUMAArray<std::atomic<uint64_t>> component;
+  component.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { component[n].store(n, std::memory_order_relaxed); },
+      katana::no_stats());
+
+  katana::StatTimer exec_time("OutOfCore", "ConnectedComponents");
+  exec_time.start();
+  uint64_t passes = 0;
+  katana::GReduceLogicalOr changed;
+  do {
+    changed.reset();
+    KATANA_CHECKED(ForEachEdge(
+        stream, "OutOfCoreConnectedComponents",
+        [&](uint64_t src, uint64_t dest) {
+          uint64_t src_component =
+              component[src].load(std::memory_order_relaxed);
+          uint64_t dest_component =
+              component[dest].load(std::memory_order_relaxed);
+          if (src_component < dest_component) {
+            katana::atomicMin(component[dest], src_component);
+            changed.update(true);
+          } else if (dest_component < src_component) {
+            katana::atomicMin(component[src], dest_component);
+            changed.update(true);
+          }
+        }));
+    // Components are nodes of the same component with smaller IDs, so
+    // following them in memory shortens the passes over the edges
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) {
+          uint64_t c = component[n].load(std::memory_order_relaxed);
+          uint64_t next = component[c].load(std::memory_order_relaxed);
+          while (next != c) {
+            c = next;
+            next = component[c].load(std::memory_order_relaxed);
+          }
+          katana::atomicMin(component[n], c);
+        },
+        katana::no_stats());
+    ++passes;
+  } while (changed.reduce());
+  exec_time.stop();
+  katana::ReportStatSingle("OutOfCoreConnectedComponents", "Passes", passes);
+  return ToArrow<arrow::UInt64Builder>(component);
+}
@@ -21,10 +21,14 @@
 #define KATANA_LIBGALOIS_ANALYTICS_PAGERANK_PAGERANKIMPL_H_
 
 #include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include <boost/uuid/uuid_generators.hpp>
 #include <boost/uuid/uuid_io.hpp>
 
+#include "katana/NUMAArray.h"
 #include "katana/Properties.h"
 #include "katana/PropertyGraph.h"
 #include "katana/analytics/Utils.h"
@@ -35,11 +39,18 @@ using NodeValue = katana::PODProperty<PRTy>;
 
 katana::Result<void> PagerankPullTopological(
     katana::PropertyGraph* pg, const std::string& output_property_name,
-    katana::analytics::PagerankPlan plan);
+    katana::analytics::PagerankPlan plan,
+    katana::analytics::AnalyticsContext* context);
 
 katana::Result<void> PagerankPullResidual(
     katana::PropertyGraph* pg, const std::string& output_property_name,
-    katana::analytics::PagerankPlan plan);
+    katana::analytics::PagerankPlan plan,
+    katana::analytics::AnalyticsContext* context);
+
+katana::Result<void> PagerankPullBlocked(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    katana::analytics::PagerankPlan plan,
+    katana::analytics::AnalyticsContext* context);
 
 katana::Result<void> PagerankPushAsynchronous(
     katana::PropertyGraph* pg, const std::string& output_property_name,
@@ -49,4 +60,16 @@ katana::Result<void> PagerankPushSynchronous(
     katana::PropertyGraph* pg, const std::string& output_property_name,
     katana::analytics::PagerankPlan plan);
 
+katana::Result<katana::NUMAArray<PRTy>> PersonalizedPagerankPullTopological(
+    const katana::PropertyGraph& pg,
+    const std::vector<std::vector<uint32_t>>& seed_sets,
+    katana::analytics::PagerankPlan plan);
+
+katana::Result<void> PagerankPushIncremental(
+    katana::PropertyGraph* pg, const std::string& previous_rank_property_name,
+    const std::vector<std::pair<uint32_t, uint32_t>>& inserted_edges,
+    const std::vector<std::pair<uint32_t, uint32_t>>& deleted_edges,
+    const std::string& output_property_name,
+    katana::analytics::PagerankPlan plan);
+
 #endif
@@ -17,9 +17,21 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <vector>
+
 #include <arrow/type.h>
 
+#include "katana/NeighborPrefetch.h"
+#include "katana/ParallelSTL.h"
 #include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/Checkpoint.h"
 #include "katana/analytics/Utils.h"
 #include "pagerank-impl.h"
 
@@ -79,12 +91,14 @@ InitNodeDataResidual(
 void
 ComputeOutDeg(
     const katana::PropertyGraph& graph,
-    katana::NUMAArray<PagerankValueAndOutDegreeTy>* node_data) {
+    katana::NUMAArray<PagerankValueAndOutDegreeTy>* node_data,
+    katana::analytics::AnalyticsContext* context) {
   katana::StatTimer out_degree_timer("computeOutDegFunc");
   out_degree_timer.start();
 
-  katana::NUMAArray<std::atomic<size_t>> vec;
-  vec.allocateInterleaved(graph.size());
+  katana::NUMAArray<std::atomic<size_t>> local_vec;
+  auto& vec = *katana::analytics::ScratchArray(
+      context, "PagerankDegree", graph.size(), &local_vec);
 
   katana::do_all(
       katana::iterate(graph),
@@ -111,12 +125,13 @@ ComputeOutDeg(
   out_degree_timer.stop();
 }
 void
-ComputeOutDeg(Graph* graph) {
+ComputeOutDeg(Graph* graph, katana::analytics::AnalyticsContext* context) {
   katana::StatTimer out_degree_timer("computeOutDegFunc");
   out_degree_timer.start();
 
-  katana::NUMAArray<std::atomic<size_t>> vec;
-  vec.allocateInterleaved(graph->size());
+  katana::NUMAArray<std::atomic<size_t>> local_vec;
+  auto& vec = *katana::analytics::ScratchArray(
+      context, "PagerankDegree", graph->size(), &local_vec);
 
   katana::do_all(
       katana::iterate(*graph),
@@ -154,13 +169,32 @@ ComputeOutDeg(Graph* graph) {
  * the next pagerank.
  */
 //! [scalarreduction]
-void
+katana::Result<void>
 ComputePRResidual(
     Graph* graph, DeltaArray& delta, ResidualArray& residual,
-    katana::analytics::PagerankPlan plan) {
+    katana::analytics::PagerankPlan plan,
+    const katana::analytics::AnalyticsContext* context) {
   unsigned int iterations = 0;
   katana::GAccumulator<unsigned int> accum;
 
+  //! The ranks and residuals are the state between iterations; deltas are
+  //! recomputed from the residuals.
+  katana::analytics::Checkpointer* checkpointer =
+      katana::analytics::GetCheckpointer(context);
+  if (checkpointer) {
+    checkpointer->Begin(fmt::format(
+        "PagerankPullResidual-{}-{}-{}-{}", graph->num_nodes(),
+        graph->num_edges(), plan.alpha(), plan.tolerance()));
+    if (graph->size() > 0) {
+      checkpointer->AddBuffer(
+          "value", &graph->GetData<PagerankValueAndOutDegree>(0),
+          graph->size() * sizeof(PagerankValueAndOutDegreeTy));
+    }
+    checkpointer->Add("residual", &residual);
+    checkpointer->Add("iteration", &iterations);
+    KATANA_CHECKED(checkpointer->Restore());
+  }
+
   while (true) {
     katana::do_all(
         katana::iterate(*graph),
@@ -204,11 +238,24 @@ ComputePRResidual(
     std::cout << "iteration: " << iterations << "\n";
 #endif
     iterations++;
-    if (iterations >= plan.max_iterations() || !accum.reduce()) {
+    bool done = iterations >= plan.max_iterations() || !accum.reduce();
+    if (checkpointer && !done) {
+      KATANA_CHECKED(checkpointer->Save(iterations));
+    }
+    if (done || katana::analytics::IsCancelled(context)) {
       break;
     }
     accum.reset();
   }  ///< End while(true).
+
+  if (checkpointer) {
+    //! A cancelled run resumes from its last checkpoint
+    if (katana::analytics::IsCancelled(context)) {
+      return checkpointer->Wait();
+    }
+    return checkpointer->Complete();
+  }
+  return katana::ResultSuccess();
   //! [scalarreduction]
 }
 
@@ -216,62 +263,446 @@ ComputePRResidual(
  * PageRank pull topological.
  * Always calculate the new pagerank for each iteration.
  */
-void
+katana::Result<void>
 ComputePRTopological(
     const katana::PropertyGraph& graph, katana::analytics::PagerankPlan plan,
-    katana::NUMAArray<PagerankValueAndOutDegreeTy>* node_data) {
+    katana::NUMAArray<PagerankValueAndOutDegreeTy>* node_data,
+    const katana::analytics::AnalyticsContext* context) {
   unsigned int iteration = 0;
   katana::GAccumulator<float> accum;
 
+  katana::analytics::Checkpointer* checkpointer =
+      katana::analytics::GetCheckpointer(context);
+  if (checkpointer) {
+    checkpointer->Begin(fmt::format(
+        "PagerankPullTopological-{}-{}-{}", graph.num_nodes(),
+        graph.num_edges(), plan.alpha()));
+    checkpointer->Add("node_data", node_data);
+    checkpointer->Add("iteration", &iteration);
+    KATANA_CHECKED(checkpointer->Restore());
+  }
+
   float base_score = (1.0f - plan.alpha()) / graph.size();
+  //! Tuned on the first gather over this graph.
+  katana::PrefetchDistance prefetch_distance;
   while (true) {
-    katana::do_all(
-        katana::iterate(graph),
-        [&](const GNode& src) {
-          float sum = 0.0;
-
-          for (auto jj : graph.edges(src)) {
-            auto dest = graph.GetEdgeDest(jj);
-            auto& ddata = (*node_data)[*dest];
-            sum += ddata.value / ddata.out;
-          }
-
+    katana::GatherNeighborsPrefetched(
+        graph.topology(), *node_data, &prefetch_distance, 0.0f,
+        [&](float sum, auto, GNode dest) {
+          const auto& ddata = (*node_data)[dest];
+          return sum + ddata.value / ddata.out;
+        },
+        [&](GNode src, float sum) {
           //! New value of pagerank after computing contributions from
           //! incoming edges in the original graph.
           float value = sum * plan.alpha() + base_score;
           //! Find the delta in new and old pagerank values.
-          //float diff = std::fabs(value - sdata.value);
           float diff = std::fabs(value - (*node_data)[src].value);
 
           //! Do not update pagerank before the diff is computed since
           //! there is a data dependence on the pagerank value.
-          auto& sdata = (*node_data)[src].value;
-          sdata = value;
+          (*node_data)[src].value = value;
           accum += diff;
         },
-        katana::steal(),
-        katana::chunk_size<katana::analytics::PagerankPlan::kChunkSize>(),
         katana::loopname("Pagerank Topological"));
 
 #if DEBUG
     std::cout << "iteration: " << iteration << " max delta: " << delta << "\n";
 #endif
+    iteration += 1;
+    bool done = accum.reduce() <= plan.tolerance() ||
+                iteration >= plan.max_iterations();
+    if (checkpointer && !done) {
+      KATANA_CHECKED(checkpointer->Save(iteration));
+    }
+    if (done || katana::analytics::IsCancelled(context)) {
+      break;
+    }
+    accum.reset();
+  }  ///< End while(true).
+
+  katana::ReportStatSingle("PageRank", "Iterations", iteration);
+  if (checkpointer) {
+    //! A cancelled run resumes from its last checkpoint
+    if (katana::analytics::IsCancelled(context)) {
+      return checkpointer->Wait();
+    }
+    return checkpointer->Complete();
+  }
+  return katana::ResultSuccess();
+}
+
+//! Contributions as stored by PullBlocked: floats or the upper halves of
+//! floats (bfloat16), rounded to nearest even
+template <typename Stored>
+Stored EncodeContribution(PRTy value);
+
+template <>
+float
+EncodeContribution<float>(PRTy value) {
+  return value;
+}
+
+template <>
+uint16_t
+EncodeContribution<uint16_t>(PRTy value) {
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  bits += 0x7fff + ((bits >> 16) & 1);
+  return bits >> 16;
+}
+
+PRTy
+DecodeContribution(float stored) {
+  return stored;
+}
+
+PRTy
+DecodeContribution(uint16_t stored) {
+  uint32_t bits = uint32_t{stored} << 16;
+  PRTy value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+//! The layout of propagation blocking, which does not change between
+//! iterations. Sources are split into chunks of about the same number of
+//! out-edges. The out-edges of the nodes of a chunk that go to a bin
+//! are written to a segment of the bin, in the order of the out-edges, and
+//! the segments of a bin are next to each other.
+struct PropagationBins {
+  //! A bin has 2^kBinShift nodes; their sums take 256 KB, which fits in the
+  //! L2 cache
+  static constexpr uint32_t kBinShift = 16;
+
+  //! The out-edges of the original graph, i.e., the transpose of the graph
+  //! pagerank runs on, as cached for the views of that graph
+  std::shared_ptr<const katana::EdgeShuffleTopology> out;
+  //! out_indices[n] is the end of the out-edges of n
+  const uint64_t* out_indices;
+  const uint32_t* out_dests;
+
+  size_t num_bins;
+  std::vector<GNode> chunk_begins;
+  //! Where chunk c starts writing to bin b: cursors[c * num_bins + b]
+  std::vector<uint64_t> cursors;
+  std::vector<uint64_t> bin_begins;
+  //! The destination of every entry of the bins
+  katana::NUMAArray<uint32_t> bin_dests;
+
+  uint64_t out_begin(GNode n) const { return n ? out_indices[n - 1] : 0; }
+  size_t num_chunks() const { return chunk_begins.size() - 1; }
+
+  //! The out-edges of the original graph of graph, built on first use
+  static std::shared_ptr<const katana::EdgeShuffleTopology> OutEdges(
+      katana::PropertyGraph* graph) {
+    return graph->BuildEdgeShuffleTopology(
+        katana::EdgeShuffleTopology::TransposeKind::kYes,
+        katana::EdgeShuffleTopology::EdgeSortKind::kAny);
+  }
+
+  explicit PropagationBins(katana::PropertyGraph* graph)
+      : out(OutEdges(graph)),
+        out_indices(out->adj_data()),
+        out_dests(out->dest_data()) {
+    const size_t num_nodes = graph->size();
+    const uint64_t num_edges = graph->num_edges();
+
+    num_bins = (num_nodes + (1 << kBinShift) - 1) >> kBinShift;
+    const size_t num_chunks = std::max<size_t>(
+        1, std::min<size_t>(4 * katana::getActiveThreads(), num_nodes));
+    chunk_begins.resize(num_chunks + 1);
+    for (size_t c = 0; c < num_chunks; ++c) {
+      chunk_begins[c] = std::distance(
+          out_indices,
+          std::lower_bound(
+              out_indices, out_indices + num_nodes,
+              num_edges * c / num_chunks));
+    }
+    chunk_begins[0] = 0;
+    chunk_begins[num_chunks] = num_nodes;
+
+    cursors.resize(num_chunks * num_bins);
+    katana::do_all(
+        katana::iterate(size_t{0}, num_chunks),
+        [&](size_t c) {
+          uint64_t* counts = &cursors[c * num_bins];
+          for (auto e = out_begin(chunk_begins[c]);
+               e < out_begin(chunk_begins[c + 1]); ++e) {
+            ++counts[out_dests[e] >> kBinShift];
+          }
+        },
+        katana::no_stats());
+    bin_begins.resize(num_bins + 1);
+    uint64_t position = 0;
+    for (size_t b = 0; b < num_bins; ++b) {
+      bin_begins[b] = position;
+      for (size_t c = 0; c < num_chunks; ++c) {
+        uint64_t count = cursors[c * num_bins + b];
+        cursors[c * num_bins + b] = position;
+        position += count;
+      }
+    }
+    bin_begins[num_bins] = position;
+
+    bin_dests.allocateInterleaved(num_edges);
+    Scatter(
+        [](GNode) { return 0; },
+        [&](int, uint32_t dest, uint64_t slot) { bin_dests[slot] = dest; },
+        "FillBins");
+  }
+
+  //! For every source src with out-edges, compute v = source_fn(src) and
+  //! call edge_fn(v, dest, slot) for each of its out-edges, where slot is
+  //! the entry of the edge in the bins. Every chunk writes its segments
+  //! sequentially.
+  template <typename SourceFn, typename EdgeFn>
+  void Scatter(
+      const SourceFn& source_fn, const EdgeFn& edge_fn,
+      const char* loopname) const {
+    katana::do_all(
+        katana::iterate(size_t{0}, num_chunks()),
+        [&](size_t c) {
+          std::vector<uint64_t> cursor(
+              cursors.begin() + c * num_bins,
+              cursors.begin() + (c + 1) * num_bins);
+          for (GNode src = chunk_begins[c]; src < chunk_begins[c + 1]; ++src) {
+            uint64_t begin = out_begin(src);
+            uint64_t end = out_indices[src];
+            if (begin == end) {
+              continue;
+            }
+            auto v = source_fn(src);
+            for (uint64_t e = begin; e < end; ++e) {
+              uint32_t dest = out_dests[e];
+              edge_fn(v, dest, cursor[dest >> kBinShift]++);
+            }
+          }
+        },
+        katana::loopname(loopname));
+  }
+};
+
+//! The PropagationBins of the last call with an AnalyticsContext; they are
+//! reused while the graph's transpose is the same
+struct CachedPropagationBins {
+  std::unique_ptr<PropagationBins> bins;
+};
+
+//! The bins for graph, from context if it holds bins built from the same
+//! topology, else built, and kept in context if there is one
+const PropagationBins&
+GetPropagationBins(
+    katana::PropertyGraph* graph, katana::analytics::AnalyticsContext* context,
+    std::unique_ptr<PropagationBins>* local) {
+  std::unique_ptr<PropagationBins>* bins = local;
+  if (context) {
+    bins = &context->Get<CachedPropagationBins>("PagerankBins")->bins;
+  }
+  // The cached bins keep their transpose alive, so one built for a new
+  // topology never has the same address
+  if (!*bins || (*bins)->out != PropagationBins::OutEdges(graph)) {
+    bins->reset();
+    *bins = std::make_unique<PropagationBins>(graph);
+  }
+  return **bins;
+}
+
+/**
+ * PageRank pull topological with propagation blocking. Every iteration
+ * computes the new ranks from those of the previous one only (Jacobi), while
+ * ComputePRTopological reads ranks already updated in the same iteration,
+ * so both converge to the same ranks but not through the same iterates.
+ */
+template <typename Stored>
+void
+ComputePRBlocked(
+    const katana::PropertyGraph& graph, const PropagationBins& bins,
+    katana::analytics::PagerankPlan plan, katana::NUMAArray<Stored>* values,
+    katana::NUMAArray<PRTy>* sums, katana::NUMAArray<PRTy>* rank) {
+  const size_t num_nodes = graph.size();
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) {
+        (*rank)[n] = 1.0f / num_nodes;
+        (*sums)[n] = 0;
+      },
+      katana::no_stats(), katana::loopname("initNodeData"));
+
+  const PRTy base_score = (1.0f - plan.alpha()) / num_nodes;
+  katana::GAccumulator<float> accum;
+  unsigned int iteration = 0;
+  while (true) {
+    // Binning: one contribution per source, written to every bin its
+    // out-edges go to
+    bins.Scatter(
+        [&](GNode src) {
+          uint64_t out_degree = bins.out_indices[src] - bins.out_begin(src);
+          return EncodeContribution<Stored>((*rank)[src] / out_degree);
+        },
+        [&](Stored contribution, uint32_t, uint64_t slot) {
+          (*values)[slot] = contribution;
+        },
+        "PagerankBinning");
+
+    // Accumulation: the sums of a bin stay in cache
+    katana::do_all(
+        katana::iterate(size_t{0}, bins.num_bins),
+        [&](size_t b) {
+          for (uint64_t i = bins.bin_begins[b]; i < bins.bin_begins[b + 1];
+               ++i) {
+            (*sums)[bins.bin_dests[i]] += DecodeContribution((*values)[i]);
+          }
+          GNode begin = b << bins.kBinShift;
+          GNode end = std::min<size_t>(
+              size_t{b + 1} << bins.kBinShift, num_nodes);
+          for (GNode n = begin; n < end; ++n) {
+            float value = (*sums)[n] * plan.alpha() + base_score;
+            accum += std::fabs(value - (*rank)[n]);
+            (*rank)[n] = value;
+            (*sums)[n] = 0;
+          }
+        },
+        katana::steal(), katana::loopname("PagerankAccumulate"));
+
     iteration += 1;
     if (accum.reduce() <= plan.tolerance() ||
         iteration >= plan.max_iterations()) {
       break;
     }
     accum.reset();
-
-  }  ///< End while(true).
+  }
 
   katana::ReportStatSingle("PageRank", "Iterations", iteration);
 }
 
+//! Run ComputePRBlocked with contributions stored as Stored, in scratch
+//! arrays of context if there is one
+template <typename Stored>
+void
+ComputePRBlockedWithScratch(
+    const katana::PropertyGraph& graph, const PropagationBins& bins,
+    katana::analytics::PagerankPlan plan,
+    katana::analytics::AnalyticsContext* context,
+    katana::NUMAArray<PRTy>* rank) {
+  katana::NUMAArray<Stored> local_values;
+  auto* values = katana::analytics::ScratchArray(
+      context, "PagerankContributions", graph.num_edges(), &local_values);
+  katana::NUMAArray<PRTy> local_sums;
+  auto* sums = katana::analytics::ScratchArray(
+      context, "PagerankSums", graph.size(), &local_sums);
+  ComputePRBlocked(graph, bins, plan, values, sums, rank);
+}
+
+//! The personalized ranks of a node for the seed sets of a batch, one lane
+//! per set
+struct alignas(64) PersonalizedLanes {
+  PRTy lane[katana::analytics::PagerankPlan::kPersonalizedBatchWidth];
+};
+
+//! Compute the personalized ranks for seed_sets[first, first + width) and
+//! store them in rows first to first + width of scores. inv_out holds the
+//! inverse out-degree of each node in the original graph; prefetch_distance
+//! is tuned by the first batch of a call and reused by the others.
+void
+ComputePersonalizedBatch(
+    const katana::PropertyGraph& graph, katana::analytics::PagerankPlan plan,
+    const katana::NUMAArray<PRTy>& inv_out,
+    const std::vector<std::vector<uint32_t>>& seed_sets, size_t first,
+    size_t width, katana::PrefetchDistance* prefetch_distance,
+    katana::NUMAArray<PRTy>* scores) {
+  constexpr size_t kWidth =
+      katana::analytics::PagerankPlan::kPersonalizedBatchWidth;
+  constexpr uint32_t kNotSeed = std::numeric_limits<uint32_t>::max();
+  const size_t num_nodes = graph.size();
+
+  // Only seeds restart walks; they index their restart lanes in restart
+  std::vector<PersonalizedLanes> restart;
+  katana::NUMAArray<uint32_t> restart_index;
+  restart_index.allocateInterleaved(num_nodes);
+  katana::ParallelSTL::fill(
+      restart_index.begin(), restart_index.end(), kNotSeed);
+  for (size_t k = 0; k < width; ++k) {
+    const auto& seeds = seed_sets[first + k];
+    for (uint32_t seed : seeds) {
+      if (restart_index[seed] == kNotSeed) {
+        restart_index[seed] = restart.size();
+        restart.emplace_back(PersonalizedLanes{});
+      }
+      restart[restart_index[seed]].lane[k] +=
+          (1.0f - plan.alpha()) / seeds.size();
+    }
+  }
+
+  katana::NUMAArray<PersonalizedLanes> rank;
+  rank.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) {
+        rank[n] = restart_index[n] == kNotSeed ? PersonalizedLanes{}
+                                               : restart[restart_index[n]];
+      },
+      katana::no_stats(), katana::loopname("InitPersonalized"));
+
+  std::array<katana::GAccumulator<PRTy>, kWidth> lane_diff;
+  unsigned int iteration = 0;
+  while (true) {
+    katana::GatherNeighborsPrefetched(
+        graph.topology(), rank, prefetch_distance, PersonalizedLanes{},
+        [&](PersonalizedLanes sum, auto, GNode dest) {
+          const PersonalizedLanes& ddata = rank[dest];
+          const PRTy share = inv_out[dest];
+          for (size_t k = 0; k < kWidth; ++k) {
+            sum.lane[k] += ddata.lane[k] * share;
+          }
+          return sum;
+        },
+        [&](GNode src, const PersonalizedLanes& sum) {
+          const PersonalizedLanes* src_restart =
+              restart_index[src] == kNotSeed ? nullptr
+                                             : &restart[restart_index[src]];
+          PersonalizedLanes& sdata = rank[src];
+          for (size_t k = 0; k < kWidth; ++k) {
+            PRTy value = sum.lane[k] * plan.alpha() +
+                         (src_restart ? src_restart->lane[k] : 0);
+            lane_diff[k] += std::fabs(value - sdata.lane[k]);
+            sdata.lane[k] = value;
+          }
+        },
+        katana::loopname("Pagerank Personalized"));
+
+    iteration += 1;
+    bool converged = std::all_of(
+        lane_diff.begin(), lane_diff.end(),
+        [&](katana::GAccumulator<PRTy>& d) {
+          return d.reduce() <= plan.tolerance();
+        });
+    if (converged || iteration >= plan.max_iterations()) {
+      break;
+    }
+    for (auto& d : lane_diff) {
+      d.reset();
+    }
+  }
+  katana::ReportStatSingle("PageRank", "PersonalizedIterations", iteration);
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) {
+        for (size_t k = 0; k < width; ++k) {
+          (*scores)[(first + k) * num_nodes + n] = rank[n].lane[k];
+        }
+      },
+      katana::no_stats(), katana::loopname("ExtractPersonalized"));
+}
+
+//! Store value(n) for every node n to a new property
+template <typename ValueFn>
 katana::Result<void>
 ExtractValueFromTopoGraph(
     katana::PropertyGraph* pg, const std::string& output_property_name,
-    const katana::NUMAArray<PagerankValueAndOutDegreeTy>& node_data) {
+    const ValueFn& value) {
   if (auto result =
           katana::analytics::ConstructNodeProperties<std::tuple<NodeValue>>(
               pg, {output_property_name});
@@ -289,7 +720,7 @@ ExtractValueFromTopoGraph(
 
   katana::do_all(
       katana::iterate(*pg),
-      [&](uint32_t i) { graph.GetData<NodeValue>(i) = node_data[i].value; },
+      [&](uint32_t i) { graph.GetData<NodeValue>(i) = value(i); },
       katana::loopname("Extract pagerank"), katana::no_stats());
 
   return katana::ResultSuccess();
@@ -300,29 +731,65 @@ ExtractValueFromTopoGraph(
 katana::Result<void>
 PagerankPullTopological(
     katana::PropertyGraph* pg, const std::string& output_property_name,
-    katana::analytics::PagerankPlan plan) {
+    katana::analytics::PagerankPlan plan,
+    katana::analytics::AnalyticsContext* context) {
   katana::EnsurePreallocated(2, 3 * pg->num_nodes() * sizeof(NodeData));
   katana::ReportPageAllocGuard page_alloc;
 
   // NUMA-awere temporary node data
-  katana::NUMAArray<PagerankValueAndOutDegreeTy> node_data;
-  node_data.allocateInterleaved(pg->num_nodes());
+  katana::NUMAArray<PagerankValueAndOutDegreeTy> local_node_data;
+  auto& node_data = *katana::analytics::ScratchArray(
+      context, "PagerankNodeData", pg->num_nodes(), &local_node_data);
 
   InitNodeDataTopological(*pg, &node_data);
-  ComputeOutDeg(*pg, &node_data);
+  ComputeOutDeg(*pg, &node_data, context);
 
   katana::StatTimer exec_time("PagerankPullTopological");
   exec_time.start();
-  ComputePRTopological(*pg, plan, &node_data);
+  KATANA_CHECKED(ComputePRTopological(*pg, plan, &node_data, context));
   exec_time.stop();
+  KATANA_CHECKED(katana::analytics::CheckCancelled(context));
 
-  return ExtractValueFromTopoGraph(pg, output_property_name, node_data);
+  return ExtractValueFromTopoGraph(
+      pg, output_property_name, [&](uint32_t n) { return node_data[n].value; });
+}
+
+katana::Result<void>
+PagerankPullBlocked(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    katana::analytics::PagerankPlan plan,
+    katana::analytics::AnalyticsContext* context) {
+  katana::ReportPageAllocGuard page_alloc;
+
+  katana::NUMAArray<PRTy> local_rank;
+  auto& rank = *katana::analytics::ScratchArray(
+      context, "PagerankRank", pg->num_nodes(), &local_rank);
+  std::unique_ptr<PropagationBins> local_bins;
+  const PropagationBins& bins = GetPropagationBins(pg, context, &local_bins);
+
+  katana::StatTimer exec_time("PagerankPullBlocked");
+  exec_time.start();
+  switch (plan.contribution_precision()) {
+  case katana::analytics::PagerankPlan::kFloat32:
+    ComputePRBlockedWithScratch<float>(*pg, bins, plan, context, &rank);
+    break;
+  case katana::analytics::PagerankPlan::kBFloat16:
+    ComputePRBlockedWithScratch<uint16_t>(*pg, bins, plan, context, &rank);
+    break;
+  default:
+    return katana::ErrorCode::InvalidArgument;
+  }
+  exec_time.stop();
+
+  return ExtractValueFromTopoGraph(
+      pg, output_property_name, [&](uint32_t n) { return rank[n]; });
 }
 
 katana::Result<void>
 PagerankPullResidual(
     katana::PropertyGraph* pg, const std::string& output_property_name,
-    katana::analytics::PagerankPlan plan) {
+    katana::analytics::PagerankPlan plan,
+    katana::analytics::AnalyticsContext* context) {
   katana::EnsurePreallocated(2, 3 * pg->num_nodes() * sizeof(NodeData));
   katana::ReportPageAllocGuard page_alloc;
 
@@ -338,18 +805,93 @@ PagerankPullResidual(
   }
   Graph graph = graph_result.value();
 
-  DeltaArray delta;
-  delta.allocateInterleaved(pg->num_nodes());
-  ResidualArray residual;
-  residual.allocateInterleaved(pg->num_nodes());
+  DeltaArray local_delta;
+  DeltaArray& delta = *katana::analytics::ScratchArray(
+      context, "PagerankDelta", pg->num_nodes(), &local_delta);
+  ResidualArray local_residual;
+  ResidualArray& residual = *katana::analytics::ScratchArray(
+      context, "PagerankResidual", pg->num_nodes(), &local_residual);
 
   InitNodeDataResidual(&graph, delta, residual, plan);
-  ComputeOutDeg(&graph);
+  ComputeOutDeg(&graph, context);
 
   katana::StatTimer exec_time("PagerankPullResidual");
   exec_time.start();
-  ComputePRResidual(&graph, delta, residual, plan);
+  KATANA_CHECKED(ComputePRResidual(&graph, delta, residual, plan, context));
   exec_time.stop();
 
+  // The ranks are computed in the output property
+  if (katana::analytics::IsCancelled(context)) {
+    KATANA_CHECKED(pg->RemoveNodeProperty(output_property_name));
+    return katana::analytics::CheckCancelled(context);
+  }
+
   return katana::ResultSuccess();
 }
+
+katana::Result<katana::NUMAArray<PRTy>>
+PersonalizedPagerankPullTopological(
+    const katana::PropertyGraph& pg,
+    const std::vector<std::vector<uint32_t>>& seed_sets,
+    katana::analytics::PagerankPlan plan) {
+  if (plan.algorithm() != katana::analytics::PagerankPlan::kPullTopological) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "personalized pagerank requires the pull topological plan");
+  }
+  for (const auto& seeds : seed_sets) {
+    if (seeds.empty()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "seed sets may not be empty");
+    }
+    for (uint32_t seed : seeds) {
+      if (seed >= pg.num_nodes()) {
+        return KATANA_ERROR(
+            katana::ErrorCode::InvalidArgument, "seed {} is out of range",
+            seed);
+      }
+    }
+  }
+
+  // The in-degree in the transposed graph is the out-degree in the original
+  katana::NUMAArray<std::atomic<uint32_t>> out_degree;
+  out_degree.allocateInterleaved(pg.num_nodes());
+  katana::do_all(
+      katana::iterate(pg), [&](const GNode& n) { out_degree[n] = 0; },
+      katana::no_stats());
+  katana::do_all(
+      katana::iterate(pg),
+      [&](const GNode& src) {
+        for (auto nbr : pg.edges(src)) {
+          out_degree[*pg.GetEdgeDest(nbr)].fetch_add(1);
+        }
+      },
+      katana::steal(), katana::loopname("ComputeOutDeg"));
+  katana::NUMAArray<PRTy> inv_out;
+  inv_out.allocateInterleaved(pg.num_nodes());
+  katana::do_all(
+      katana::iterate(pg),
+      [&](const GNode& n) {
+        inv_out[n] = out_degree[n] ? 1.0f / out_degree[n] : 0;
+      },
+      katana::no_stats());
+
+  katana::NUMAArray<PRTy> scores;
+  scores.allocateInterleaved(seed_sets.size() * pg.num_nodes());
+
+  katana::StatTimer exec_time("PagerankPersonalized");
+  exec_time.start();
+  constexpr size_t kWidth =
+      katana::analytics::PagerankPlan::kPersonalizedBatchWidth;
+  // Graphs differ in how far ahead neighbors need to be fetched
+  katana::PrefetchDistance prefetch_distance;
+  for (size_t first = 0; first < seed_sets.size(); first += kWidth) {
+    ComputePersonalizedBatch(
+        pg, plan, inv_out, seed_sets, first,
+        std::min(kWidth, seed_sets.size() - first), &prefetch_distance,
+        &scores);
+  }
+  exec_time.stop();
+
+  return scores;
+}
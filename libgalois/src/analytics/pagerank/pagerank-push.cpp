@@ -17,6 +17,12 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <utility>
+#include <vector>
+
 #include "katana/AtomicHelpers.h"
 #include "katana/Properties.h"
 #include "katana/TypedPropertyGraph.h"
@@ -45,6 +51,46 @@ InitializeNodeResidual(Graph& graph, katana::analytics::PagerankPlan plan) {
       katana::no_stats(), katana::loopname("Initialize"));
 }
 
+//! Push residuals until every residual is within the tolerance, starting
+//! from the nodes in active. Residuals may be negative, as they are after
+//! deleting edges, so their magnitudes are compared with the tolerance.
+template <typename Range>
+void
+PushResidualAsynchronous(
+    Graph* graph, const Range& active, katana::analytics::PagerankPlan plan) {
+  typedef katana::PerSocketChunkFIFO<
+      katana::analytics::PagerankPlan::kChunkSize>
+      WL;
+  katana::for_each(
+      active,
+      [&](const GNode& src, auto& ctx) {
+        auto& src_residual = graph->GetData<NodeResidual>(src);
+        if (std::fabs(src_residual) > plan.tolerance()) {
+          PRTy old_residual = src_residual.exchange(0.0);
+          auto& src_value = graph->GetData<NodeValue>(src);
+          src_value += old_residual;
+          int src_nout = graph->edges(src).size();
+          if (src_nout > 0) {
+            PRTy delta = old_residual * plan.alpha() / src_nout;
+            //! For each out-going neighbors.
+            for (const auto& jj : graph->edges(src)) {
+              auto dest = graph->GetEdgeDest(jj);
+              auto& dest_residual = graph->GetData<NodeResidual>(dest);
+              if (delta != 0) {
+                auto old = atomicAdd(dest_residual, delta);
+                if ((std::fabs(old) < plan.tolerance()) &&
+                    (std::fabs(old + delta) >= plan.tolerance())) {
+                  ctx.push(*dest);
+                }
+              }
+            }
+          }
+        }
+      },
+      katana::loopname("PushResidualAsynchronous"),
+      katana::disable_conflict_detection(), katana::wl<WL>());
+}
+
 }  // namespace
 
 katana::Result<void>
@@ -72,37 +118,7 @@ PagerankPushAsynchronous(
 
   InitializeNodeResidual(graph, plan);
 
-  typedef katana::PerSocketChunkFIFO<
-      katana::analytics::PagerankPlan::kChunkSize>
-      WL;
-  katana::for_each(
-      katana::iterate(graph),
-      [&](const GNode& src, auto& ctx) {
-        auto& src_residual = graph.GetData<NodeResidual>(src);
-        if (src_residual > plan.tolerance()) {
-          PRTy old_residual = src_residual.exchange(0.0);
-          auto& src_value = graph.GetData<NodeValue>(src);
-          src_value += old_residual;
-          int src_nout = graph.edges(src).size();
-          if (src_nout > 0) {
-            PRTy delta = old_residual * plan.alpha() / src_nout;
-            //! For each out-going neighbors.
-            for (const auto& jj : graph.edges(src)) {
-              auto dest = graph.GetEdgeDest(jj);
-              auto& dest_residual = graph.GetData<NodeResidual>(dest);
-              if (delta > 0) {
-                auto old = atomicAdd(dest_residual, delta);
-                if ((old < plan.tolerance()) &&
-                    (old + delta >= plan.tolerance())) {
-                  ctx.push(*dest);
-                }
-              }
-            }
-          }
-        }
-      },
-      katana::loopname("PushResidualAsynchronous"),
-      katana::disable_conflict_detection(), katana::wl<WL>());
+  PushResidualAsynchronous(&graph, katana::iterate(graph), plan);
 
   return katana::ResultSuccess();
 }
@@ -212,3 +228,121 @@ PagerankPushSynchronous(
   }
   return katana::ResultSuccess();
 }
+
+katana::Result<void>
+PagerankPushIncremental(
+    katana::PropertyGraph* pg, const std::string& previous_rank_property_name,
+    const std::vector<std::pair<uint32_t, uint32_t>>& inserted_edges,
+    const std::vector<std::pair<uint32_t, uint32_t>>& deleted_edges,
+    const std::string& output_property_name,
+    katana::analytics::PagerankPlan plan) {
+  struct EdgeChange {
+    GNode src;
+    GNode dest;
+    bool inserted;
+  };
+
+  std::vector<EdgeChange> changes;
+  changes.reserve(inserted_edges.size() + deleted_edges.size());
+  for (const auto& [src, dest] : inserted_edges) {
+    changes.emplace_back(EdgeChange{src, dest, true});
+  }
+  for (const auto& [src, dest] : deleted_edges) {
+    changes.emplace_back(EdgeChange{src, dest, false});
+  }
+  for (const auto& change : changes) {
+    if (change.src >= pg->num_nodes() || change.dest >= pg->num_nodes()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "edge ({}, {}) is out of range",
+          change.src, change.dest);
+    }
+  }
+  std::sort(
+      changes.begin(), changes.end(),
+      [](const EdgeChange& a, const EdgeChange& b) { return a.src < b.src; });
+
+  auto previous_result =
+      katana::TypedPropertyGraph<std::tuple<NodeValue>, std::tuple<>>::Make(
+          pg, {previous_rank_property_name}, {});
+  if (!previous_result) {
+    return previous_result.error();
+  }
+  auto previous = previous_result.value();
+
+  katana::analytics::TemporaryPropertyGuard temporary_property{
+      pg->NodeMutablePropertyView()};
+
+  if (auto result = katana::analytics::ConstructNodeProperties<NodeData>(
+          pg, {output_property_name, temporary_property.name()});
+      !result) {
+    return result.error();
+  }
+
+  auto graph_result =
+      Graph::Make(pg, {output_property_name, temporary_property.name()}, {});
+  if (!graph_result) {
+    return graph_result.error();
+  }
+  Graph graph = graph_result.value();
+
+  // The changes of each source are contiguous; find where they start and
+  // the out-degree each source had before them
+  std::vector<size_t> source_begins;
+  std::vector<int64_t> old_degrees;
+  for (size_t i = 0; i < changes.size(); ++i) {
+    if (i == 0 || changes[i].src != changes[i - 1].src) {
+      source_begins.emplace_back(i);
+      old_degrees.emplace_back(graph.edges(changes[i].src).size());
+    }
+    old_degrees.back() += changes[i].inserted ? -1 : 1;
+    if (old_degrees.back() < 0) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "node {} has more inserted out-edges than out-edges", changes[i].src);
+    }
+  }
+  source_begins.emplace_back(changes.size());
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) {
+        graph.GetData<NodeValue>(n) = previous.GetData<NodeValue>(n);
+        graph.GetData<NodeResidual>(n) = 0;
+      },
+      katana::no_stats(), katana::loopname("Initialize"));
+
+  // With converged ranks, the residual of a node is alpha times the rank its
+  // in-neighbors give it minus what they gave it when the ranks were
+  // computed. Only the out-neighbors of a changed source see a difference:
+  // its share changes on every current out-edge, inserted edges gave nothing
+  // before and deleted edges give nothing now.
+  katana::InsertBag<GNode> affected;
+  katana::do_all(
+      katana::iterate(size_t{0}, old_degrees.size()),
+      [&](size_t i) {
+        GNode src = changes[source_begins[i]].src;
+        int64_t new_degree = graph.edges(src).size();
+        PRTy value = graph.GetData<NodeValue>(src);
+        PRTy new_share = new_degree ? plan.alpha() * value / new_degree : 0;
+        PRTy old_share =
+            old_degrees[i] ? plan.alpha() * value / old_degrees[i] : 0;
+
+        for (const auto& jj : graph.edges(src)) {
+          auto dest = graph.GetEdgeDest(jj);
+          atomicAdd(graph.GetData<NodeResidual>(dest), new_share - old_share);
+          affected.push(*dest);
+        }
+        for (size_t c = source_begins[i]; c < source_begins[i + 1]; ++c) {
+          GNode dest = changes[c].dest;
+          atomicAdd(
+              graph.GetData<NodeResidual>(dest),
+              changes[c].inserted ? old_share : -old_share);
+          affected.push(dest);
+        }
+      },
+      katana::steal(), katana::loopname("SeedResidual"));
+
+  PushResidualAsynchronous(&graph, katana::iterate(affected), plan);
+
+  return katana::ResultSuccess();
+}
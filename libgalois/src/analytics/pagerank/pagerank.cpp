@@ -23,12 +23,18 @@
 katana::Result<void>
 katana::analytics::Pagerank(
     katana::PropertyGraph* pg, const std::string& output_property_name,
-    katana::analytics::PagerankPlan plan) {
+    katana::analytics::PagerankPlan plan,
+    katana::analytics::AnalyticsContext* context) {
+  KATANA_CHECKED(CheckArchitecture(plan));
+  auto profile = ProfileParallelism(plan);
+
   switch (plan.algorithm()) {
   case PagerankPlan::kPullResidual:
-    return PagerankPullResidual(pg, output_property_name, plan);
+    return PagerankPullResidual(pg, output_property_name, plan, context);
   case PagerankPlan::kPullTopological:
-    return PagerankPullTopological(pg, output_property_name, plan);
+    return PagerankPullTopological(pg, output_property_name, plan, context);
+  case PagerankPlan::kPullBlocked:
+    return PagerankPullBlocked(pg, output_property_name, plan, context);
   case PagerankPlan::kPushAsynchronous:
     return PagerankPushAsynchronous(pg, output_property_name, plan);
   case PagerankPlan::kPushSynchronous:
@@ -38,6 +44,59 @@ katana::analytics::Pagerank(
   }
 }
 
+katana::Result<void>
+katana::analytics::PagerankIncremental(
+    katana::PropertyGraph* pg, const std::string& previous_rank_property_name,
+    const std::vector<std::pair<uint32_t, uint32_t>>& inserted_edges,
+    const std::vector<std::pair<uint32_t, uint32_t>>& deleted_edges,
+    const std::string& output_property_name,
+    katana::analytics::PagerankPlan plan) {
+  return PagerankPushIncremental(
+      pg, previous_rank_property_name, inserted_edges, deleted_edges,
+      output_property_name, plan);
+}
+
+katana::Result<void>
+katana::analytics::PersonalizedPagerank(
+    katana::PropertyGraph* pg,
+    const std::vector<std::vector<uint32_t>>& seed_sets,
+    const std::vector<std::string>& output_property_names,
+    katana::analytics::PagerankPlan plan) {
+  if (seed_sets.size() != output_property_names.size()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "{} seed sets but {} output properties", seed_sets.size(),
+        output_property_names.size());
+  }
+
+  katana::NUMAArray<PRTy> scores =
+      KATANA_CHECKED(PersonalizedPagerankPullTopological(*pg, seed_sets, plan));
+
+  using RankGraph = TypedPropertyGraph<std::tuple<NodeValue>, std::tuple<>>;
+  const size_t num_nodes = pg->num_nodes();
+  for (size_t i = 0; i < seed_sets.size(); ++i) {
+    KATANA_CHECKED(ConstructNodeProperties<std::tuple<NodeValue>>(
+        pg, {output_property_names[i]}));
+    auto graph =
+        KATANA_CHECKED(RankGraph::Make(pg, {output_property_names[i]}, {}));
+    katana::do_all(
+        katana::iterate(graph),
+        [&](uint32_t n) {
+          graph.GetData<NodeValue>(n) = scores[i * num_nodes + n];
+        },
+        katana::no_stats());
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<katana::NUMAArray<float>>
+katana::analytics::PersonalizedPagerankScores(
+    katana::PropertyGraph* pg,
+    const std::vector<std::vector<uint32_t>>& seed_sets,
+    katana::analytics::PagerankPlan plan) {
+  return PersonalizedPagerankPullTopological(*pg, seed_sets, plan);
+}
+
 /// \cond DO_NOT_DOCUMENT
 katana::Result<void>
 katana::analytics::PagerankAssertValid(
@@ -0,0 +1,738 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2020, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "katana/analytics/partition/partition.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+#include "katana/Statistics.h"
+#include "katana/Timer.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/Utils.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+constexpr uint32_t kNone = std::numeric_limits<uint32_t>::max();
+constexpr uint32_t kMatchingRounds = 4;
+constexpr uint32_t kMaxLevels = 64;
+constexpr uint32_t kBalanceRounds = 8;
+/// Coarsening stops when a level has more than this fraction of the nodes
+/// of the previous level
+constexpr double kMinCoarseningRatio = 0.95;
+
+uint32_t
+Hash(uint32_t val) {
+  val = ((val >> 16) ^ val) * 0x45d9f3b;
+  val = ((val >> 16) ^ val) * 0x45d9f3b;
+  return (val >> 16) ^ val;
+}
+
+/// An undirected graph with node and edge weights in compressed sparse row
+/// form, without self loops or parallel edges
+struct Level {
+  /// offsets[n] to offsets[n + 1] are the edges of n
+  katana::NUMAArray<uint64_t> offsets;
+  katana::NUMAArray<uint32_t> dests;
+  katana::NUMAArray<uint32_t> edge_weights;
+  katana::NUMAArray<uint32_t> node_weights;
+  uint64_t total_weight{0};
+
+  uint64_t num_nodes() const { return node_weights.size(); }
+};
+
+/// Build the edges of level from unsorted edges with duplicates: the edges
+/// of node n are scratch[bounds[n]] to scratch[bounds[n] + counts[n]], each
+/// a destination in the high half and a weight in the low half
+void
+CompactEdges(
+    const katana::NUMAArray<uint64_t>& bounds,
+    katana::NUMAArray<uint64_t>* counts, katana::NUMAArray<uint64_t>* scratch,
+    Level* level) {
+  const uint64_t num_nodes = counts->size();
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t* begin = scratch->data() + bounds[n];
+        uint64_t* end = begin + (*counts)[n];
+        std::sort(begin, end);
+        // Merge edges with the same destination, summing their weights
+        uint64_t* out = begin;
+        for (uint64_t* it = begin; it != end; ++it) {
+          if (out != begin && ((*(out - 1)) >> 32) == (*it >> 32)) {
+            *(out - 1) += *it & 0xffffffff;
+          } else {
+            *out++ = *it;
+          }
+        }
+        (*counts)[n] = out - begin;
+      },
+      katana::steal(), katana::no_stats(),
+      katana::loopname("Partition-CompactEdges"));
+
+  level->offsets.allocateBlocked(num_nodes + 1);
+  level->offsets[0] = 0;
+  katana::ParallelSTL::partial_sum(
+      counts->begin(), counts->end(), level->offsets.begin() + 1);
+  uint64_t num_edges = level->offsets[num_nodes];
+  level->dests.allocateBlocked(num_edges);
+  level->edge_weights.allocateBlocked(num_edges);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        const uint64_t* in = scratch->data() + bounds[n];
+        for (uint64_t e = level->offsets[n]; e < level->offsets[n + 1];
+             ++e, ++in) {
+          level->dests[e] = *in >> 32;
+          level->edge_weights[e] = *in & 0xffffffff;
+        }
+      },
+      katana::no_stats(), katana::loopname("Partition-WriteEdges"));
+}
+
+/// The finest level: the out- and in-edges of each node of view, with unit
+/// weights
+template <typename View>
+void
+BuildFinestLevel(const View& view, Level* level) {
+  const uint64_t num_nodes = view.num_nodes();
+  katana::NUMAArray<uint64_t> counts;
+  counts.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        counts[n] = view.edges(n).size() + view.in_edges(n).size();
+      },
+      katana::no_stats());
+  katana::NUMAArray<uint64_t> bounds;
+  bounds.allocateBlocked(num_nodes + 1);
+  bounds[0] = 0;
+  katana::ParallelSTL::partial_sum(
+      counts.begin(), counts.end(), bounds.begin() + 1);
+
+  katana::NUMAArray<uint64_t> scratch;
+  scratch.allocateBlocked(bounds[num_nodes]);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t* out = scratch.data() + bounds[n];
+        for (auto e : view.edges(n)) {
+          uint64_t dest = view.edge_dest(e);
+          if (dest != n) {
+            *out++ = (dest << 32) | 1;
+          }
+        }
+        for (auto e : view.in_edges(n)) {
+          uint64_t dest = view.in_edge_dest(e);
+          if (dest != n) {
+            *out++ = (dest << 32) | 1;
+          }
+        }
+        counts[n] = out - (scratch.data() + bounds[n]);
+      },
+      katana::steal(), katana::no_stats(),
+      katana::loopname("Partition-FinestEdges"));
+  CompactEdges(bounds, &counts, &scratch, level);
+
+  level->node_weights.allocateBlocked(num_nodes);
+  katana::ParallelSTL::fill(
+      level->node_weights.begin(), level->node_weights.end(), 1);
+  level->total_weight = num_nodes;
+}
+
+/// A heavy edge matching of fine: in each round, every unmatched node
+/// proposes to the unmatched neighbor with the heaviest edge to it whose
+/// weight together with its own is at most max_node_weight, and mutual
+/// proposals are matched. Ties are broken by a hash of the node IDs, so the
+/// matching does not depend on the schedule
+katana::NUMAArray<uint32_t>
+HeavyEdgeMatching(const Level& fine, uint64_t max_node_weight) {
+  const uint64_t num_nodes = fine.num_nodes();
+  katana::NUMAArray<uint32_t> match;
+  match.allocateBlocked(num_nodes);
+  katana::ParallelSTL::fill(match.begin(), match.end(), kNone);
+  katana::NUMAArray<uint32_t> proposal;
+  proposal.allocateBlocked(num_nodes);
+
+  for (uint32_t round = 0; round < kMatchingRounds; ++round) {
+    katana::GAccumulator<uint64_t> num_proposals;
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) {
+          proposal[n] = kNone;
+          if (match[n] != kNone) {
+            return;
+          }
+          uint32_t best = kNone;
+          uint64_t best_key = 0;
+          for (uint64_t e = fine.offsets[n]; e < fine.offsets[n + 1]; ++e) {
+            uint32_t dest = fine.dests[e];
+            if (match[dest] != kNone ||
+                fine.node_weights[n] + fine.node_weights[dest] >
+                    max_node_weight) {
+              continue;
+            }
+            uint64_t key = (uint64_t{fine.edge_weights[e]} << 32) |
+                           Hash(dest ^ Hash(n + round));
+            if (best == kNone || key > best_key) {
+              best = dest;
+              best_key = key;
+            }
+          }
+          proposal[n] = best;
+          num_proposals += best != kNone;
+        },
+        katana::steal(), katana::no_stats(),
+        katana::loopname("Partition-Propose"));
+    if (num_proposals.reduce() == 0) {
+      break;
+    }
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) {
+          uint32_t other = proposal[n];
+          if (other != kNone && proposal[other] == n) {
+            match[n] = other;
+          }
+        },
+        katana::no_stats(), katana::loopname("Partition-Match"));
+  }
+  return match;
+}
+
+/// Contract the matching of fine into coarse, and record the coarse node of
+/// each fine node in coarse_ids
+void
+Contract(
+    const Level& fine, const katana::NUMAArray<uint32_t>& match,
+    Level* coarse, katana::NUMAArray<uint32_t>* coarse_ids) {
+  const uint64_t num_fine = fine.num_nodes();
+  // A coarse node is represented by the smaller of its fine nodes
+  coarse_ids->allocateBlocked(num_fine);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_fine),
+      [&](uint64_t n) { (*coarse_ids)[n] = match[n] == kNone || n < match[n]; },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      coarse_ids->begin(), coarse_ids->end(), coarse_ids->begin());
+  const uint64_t num_coarse = num_fine > 0 ? (*coarse_ids)[num_fine - 1] : 0;
+
+  katana::NUMAArray<uint32_t> representatives;
+  representatives.allocateBlocked(num_coarse);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_fine),
+      [&](uint64_t n) {
+        if (match[n] == kNone || n < match[n]) {
+          (*coarse_ids)[n] -= 1;
+          representatives[(*coarse_ids)[n]] = n;
+        }
+      },
+      katana::no_stats());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_fine),
+      [&](uint64_t n) {
+        if (match[n] != kNone && match[n] < n) {
+          (*coarse_ids)[n] = (*coarse_ids)[match[n]];
+        }
+      },
+      katana::no_stats());
+
+  katana::NUMAArray<uint64_t> counts;
+  counts.allocateBlocked(num_coarse);
+  coarse->node_weights.allocateBlocked(num_coarse);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_coarse),
+      [&](uint64_t c) {
+        uint32_t a = representatives[c];
+        uint32_t b = match[a];
+        counts[c] = fine.offsets[a + 1] - fine.offsets[a];
+        coarse->node_weights[c] = fine.node_weights[a];
+        if (b != kNone) {
+          counts[c] += fine.offsets[b + 1] - fine.offsets[b];
+          coarse->node_weights[c] += fine.node_weights[b];
+        }
+      },
+      katana::no_stats());
+  coarse->total_weight = fine.total_weight;
+  katana::NUMAArray<uint64_t> bounds;
+  bounds.allocateBlocked(num_coarse + 1);
+  bounds[0] = 0;
+  katana::ParallelSTL::partial_sum(
+      counts.begin(), counts.end(), bounds.begin() + 1);
+
+  katana::NUMAArray<uint64_t> scratch;
+  scratch.allocateBlocked(bounds[num_coarse]);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_coarse),
+      [&](uint64_t c) {
+        uint64_t* out = scratch.data() + bounds[c];
+        for (uint32_t n : {representatives[c], match[representatives[c]]}) {
+          if (n == kNone) {
+            continue;
+          }
+          for (uint64_t e = fine.offsets[n]; e < fine.offsets[n + 1]; ++e) {
+            uint64_t dest = (*coarse_ids)[fine.dests[e]];
+            if (dest != c) {
+              *out++ = (dest << 32) | fine.edge_weights[e];
+            }
+          }
+        }
+        counts[c] = out - (scratch.data() + bounds[c]);
+      },
+      katana::steal(), katana::no_stats(),
+      katana::loopname("Partition-ContractEdges"));
+  CompactEdges(bounds, &counts, &scratch, coarse);
+}
+
+/// Greedy graph growing: each partition in turn grows from an unassigned
+/// node, adding the unassigned node with the heaviest edges to it, until it
+/// has its share of the remaining weight. This runs serially on the coarsest
+/// level.
+void
+InitialPartition(
+    const Level& level, uint32_t num_partitions,
+    katana::NUMAArray<uint32_t>* parts) {
+  const uint64_t num_nodes = level.num_nodes();
+  parts->allocateBlocked(num_nodes);
+  std::fill(parts->begin(), parts->end(), kNone);
+  // Connectivity of unassigned nodes to the growing partition
+  std::vector<uint64_t> gains(num_nodes);
+  std::priority_queue<std::pair<uint64_t, uint32_t>> frontier;
+
+  uint64_t remaining = level.total_weight;
+  uint64_t next_seed = 0;
+  for (uint32_t p = 0; p < num_partitions; ++p) {
+    uint64_t target = remaining / (num_partitions - p);
+    uint64_t weight = 0;
+    std::vector<uint32_t> touched;
+    while (weight < target || p + 1 == num_partitions) {
+      uint32_t n = kNone;
+      while (!frontier.empty()) {
+        auto [gain, candidate] = frontier.top();
+        frontier.pop();
+        if ((*parts)[candidate] == kNone && gains[candidate] == gain) {
+          n = candidate;
+          break;
+        }
+      }
+      if (n == kNone) {
+        // Start at the next unassigned node, e.g., in another component
+        while (next_seed < num_nodes && (*parts)[next_seed] != kNone) {
+          ++next_seed;
+        }
+        if (next_seed == num_nodes) {
+          break;
+        }
+        n = next_seed;
+      }
+
+      (*parts)[n] = p;
+      weight += level.node_weights[n];
+      for (uint64_t e = level.offsets[n]; e < level.offsets[n + 1]; ++e) {
+        uint32_t dest = level.dests[e];
+        if ((*parts)[dest] == kNone) {
+          if (gains[dest] == 0) {
+            touched.emplace_back(dest);
+          }
+          gains[dest] += level.edge_weights[e];
+          frontier.emplace(gains[dest], dest);
+        }
+      }
+    }
+    remaining -= weight;
+    for (uint32_t n : touched) {
+      gains[n] = 0;
+    }
+    frontier = {};
+  }
+}
+
+/// Tries to add weight to a partition without exceeding max_weight
+bool
+TryAdd(
+    std::atomic<uint64_t>* part_weight, uint64_t weight, uint64_t max_weight) {
+  uint64_t current = part_weight->load(std::memory_order_relaxed);
+  do {
+    if (current + weight > max_weight) {
+      return false;
+    }
+  } while (!part_weight->compare_exchange_weak(
+      current, current + weight, std::memory_order_relaxed));
+  return true;
+}
+
+/// The sum of the weights of the edges from a node to each partition
+class Connectivity {
+public:
+  explicit Connectivity(uint32_t num_partitions) : weights_(num_partitions) {}
+
+  void Compute(
+      const Level& level, const katana::NUMAArray<uint32_t>& parts,
+      uint64_t n) {
+    for (uint32_t p : touched_) {
+      weights_[p] = 0;
+    }
+    touched_.clear();
+    for (uint64_t e = level.offsets[n]; e < level.offsets[n + 1]; ++e) {
+      uint32_t p = parts[level.dests[e]];
+      if (weights_[p] == 0) {
+        touched_.emplace_back(p);
+      }
+      weights_[p] += level.edge_weights[e];
+    }
+  }
+
+  uint64_t weight(uint32_t p) const { return weights_[p]; }
+
+  const std::vector<uint32_t>& touched() const { return touched_; }
+
+private:
+  std::vector<uint64_t> weights_;
+  std::vector<uint32_t> touched_;
+};
+
+/// Move nodes out of partitions heavier than max_weight, to the neighboring
+/// partition with the most connectivity that can take them, or else to the
+/// lightest partition
+void
+Balance(
+    const Level& level, uint32_t num_partitions, uint64_t max_weight,
+    katana::NUMAArray<uint32_t>* parts,
+    katana::NUMAArray<std::atomic<uint64_t>>* part_weights,
+    katana::PerThreadStorage<Connectivity>* connectivity) {
+  for (uint32_t round = 0; round < kBalanceRounds; ++round) {
+    uint32_t lightest = 0;
+    bool balanced = true;
+    for (uint32_t p = 0; p < num_partitions; ++p) {
+      uint64_t weight = (*part_weights)[p].load(std::memory_order_relaxed);
+      balanced &= weight <= max_weight;
+      if (weight < (*part_weights)[lightest].load(std::memory_order_relaxed)) {
+        lightest = p;
+      }
+    }
+    if (balanced) {
+      return;
+    }
+
+    katana::do_all(
+        katana::iterate(uint64_t{0}, level.num_nodes()),
+        [&](uint64_t n) {
+          uint32_t from = (*parts)[n];
+          uint64_t weight = level.node_weights[n];
+          std::atomic<uint64_t>& from_weight = (*part_weights)[from];
+          if (from_weight.load(std::memory_order_relaxed) <= max_weight) {
+            return;
+          }
+          Connectivity& c = *connectivity->getLocal();
+          c.Compute(level, *parts, n);
+          uint32_t to = kNone;
+          for (uint32_t p : c.touched()) {
+            if (p != from &&
+                (to == kNone || c.weight(p) > c.weight(to) ||
+                 (c.weight(p) == c.weight(to) && p < to)) &&
+                (*part_weights)[p].load(std::memory_order_relaxed) + weight <=
+                    max_weight) {
+              to = p;
+            }
+          }
+          if (to == kNone) {
+            to = lightest;
+          }
+          if (to == from || !TryAdd(&(*part_weights)[to], weight, max_weight)) {
+            return;
+          }
+          (*parts)[n] = to;
+          from_weight.fetch_sub(weight, std::memory_order_relaxed);
+        },
+        katana::steal(), katana::no_stats(),
+        katana::loopname("Partition-Balance"));
+  }
+}
+
+/// Greedy refinement: each boundary node moves to the neighboring partition
+/// that most reduces the edge cut, or that keeps it and is lighter, if the
+/// partition stays within max_weight. Alternate rounds only move nodes to
+/// partitions with larger or smaller IDs, so that neighbors do not swap
+/// partitions at the same time.
+void
+Refine(
+    const Level& level, uint32_t num_partitions, uint64_t max_weight,
+    uint32_t refinement_rounds, katana::NUMAArray<uint32_t>* parts,
+    katana::NUMAArray<std::atomic<uint64_t>>* part_weights,
+    katana::PerThreadStorage<Connectivity>* connectivity) {
+  Balance(
+      level, num_partitions, max_weight, parts, part_weights, connectivity);
+
+  uint32_t idle_rounds = 0;
+  for (uint32_t round = 0; round < 2 * refinement_rounds && idle_rounds < 2;
+       ++round) {
+    bool upward = round % 2 == 0;
+    katana::GAccumulator<uint64_t> num_moves;
+    katana::do_all(
+        katana::iterate(uint64_t{0}, level.num_nodes()),
+        [&](uint64_t n) {
+          uint32_t from = (*parts)[n];
+          Connectivity& c = *connectivity->getLocal();
+          c.Compute(level, *parts, n);
+          if (c.touched().size() == 1 && c.touched()[0] == from) {
+            return;
+          }
+          uint64_t weight = level.node_weights[n];
+          int64_t internal = c.weight(from);
+          uint32_t to = kNone;
+          int64_t best_gain = 0;
+          for (uint32_t p : c.touched()) {
+            if (p == from || (p > from) != upward) {
+              continue;
+            }
+            int64_t gain = static_cast<int64_t>(c.weight(p)) - internal;
+            if (gain < best_gain || (gain == best_gain && to != kNone)) {
+              continue;
+            }
+            if (gain == 0 &&
+                (*part_weights)[p].load(std::memory_order_relaxed) + weight >=
+                    (*part_weights)[from].load(std::memory_order_relaxed)) {
+              continue;
+            }
+            to = p;
+            best_gain = gain;
+          }
+          if (to == kNone ||
+              !TryAdd(&(*part_weights)[to], weight, max_weight)) {
+            return;
+          }
+          (*parts)[n] = to;
+          (*part_weights)[from].fetch_sub(weight, std::memory_order_relaxed);
+          num_moves += 1;
+        },
+        katana::steal(), katana::no_stats(),
+        katana::loopname("Partition-Refine"));
+    idle_rounds = num_moves.reduce() == 0 ? idle_rounds + 1 : 0;
+  }
+}
+
+/// The partition of each node of finest
+katana::NUMAArray<uint32_t>
+MultilevelPartition(
+    Level finest, uint32_t num_partitions, const PartitionPlan& plan) {
+  std::vector<Level> levels;
+  std::vector<katana::NUMAArray<uint32_t>> coarse_ids;
+  levels.emplace_back(std::move(finest));
+
+  const uint64_t coarsest_nodes =
+      uint64_t{num_partitions} *
+      std::max<uint32_t>(plan.coarsest_nodes_per_partition(), 1);
+  const uint64_t max_node_weight = std::max<uint64_t>(
+      2, 1.5 * levels.front().total_weight / coarsest_nodes);
+  katana::StatTimer coarsen_time("Partition-Coarsen");
+  coarsen_time.start();
+  while (levels.back().num_nodes() > coarsest_nodes &&
+         levels.size() < kMaxLevels) {
+    const Level& fine = levels.back();
+    katana::NUMAArray<uint32_t> match =
+        HeavyEdgeMatching(fine, max_node_weight);
+    Level coarse;
+    katana::NUMAArray<uint32_t> ids;
+    Contract(fine, match, &coarse, &ids);
+    bool stalled =
+        coarse.num_nodes() > kMinCoarseningRatio * fine.num_nodes();
+    levels.emplace_back(std::move(coarse));
+    coarse_ids.emplace_back(std::move(ids));
+    if (stalled) {
+      break;
+    }
+  }
+  coarsen_time.stop();
+  katana::ReportStatSingle("Partition", "Levels", levels.size());
+
+  const uint64_t max_weight = std::ceil(
+      (1.0 + plan.imbalance()) * levels.front().total_weight /
+      num_partitions);
+  katana::NUMAArray<std::atomic<uint64_t>> part_weights;
+  part_weights.allocateBlocked(num_partitions);
+  katana::PerThreadStorage<Connectivity> connectivity(num_partitions);
+
+  katana::NUMAArray<uint32_t> parts;
+  InitialPartition(levels.back(), num_partitions, &parts);
+  katana::StatTimer refine_time("Partition-Refine");
+  refine_time.start();
+  for (size_t l = levels.size(); l-- > 0;) {
+    const Level& level = levels[l];
+    if (l + 1 < levels.size()) {
+      // Project the partition of the coarser level
+      katana::NUMAArray<uint32_t> fine_parts;
+      fine_parts.allocateBlocked(level.num_nodes());
+      const katana::NUMAArray<uint32_t>& ids = coarse_ids[l];
+      katana::do_all(
+          katana::iterate(uint64_t{0}, level.num_nodes()),
+          [&](uint64_t n) { fine_parts[n] = parts[ids[n]]; },
+          katana::no_stats(), katana::loopname("Partition-Project"));
+      parts = std::move(fine_parts);
+      levels[l + 1] = Level();
+    }
+
+    katana::do_all(
+        katana::iterate(uint32_t{0}, num_partitions),
+        [&](uint32_t p) { part_weights[p].store(0); }, katana::no_stats());
+    katana::do_all(
+        katana::iterate(uint64_t{0}, level.num_nodes()),
+        [&](uint64_t n) {
+          part_weights[parts[n]].fetch_add(
+              level.node_weights[n], std::memory_order_relaxed);
+        },
+        katana::no_stats());
+    Refine(
+        level, num_partitions, max_weight, plan.refinement_rounds(), &parts,
+        &part_weights, &connectivity);
+  }
+  refine_time.stop();
+  return parts;
+}
+
+struct NodePartition : public katana::PODProperty<uint32_t> {};
+
+using NodeData = std::tuple<NodePartition>;
+using EdgeData = std::tuple<>;
+
+typedef katana::TypedPropertyGraph<NodeData, EdgeData> Graph;
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::Partition(
+    katana::PropertyGraph* pg, uint32_t num_partitions,
+    const std::string& output_property_name, PartitionPlan plan) {
+  if (num_partitions == 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "number of partitions must be positive");
+  }
+  if (!(plan.imbalance() >= 0)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "imbalance must be non-negative, got {}", plan.imbalance());
+  }
+  if (auto result =
+          ConstructNodeProperties<NodeData>(pg, {output_property_name});
+      !result) {
+    return result.error();
+  }
+
+  auto pg_result = Graph::Make(pg, {output_property_name}, {});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  Graph graph = pg_result.value();
+
+  katana::StatTimer exec_time("Partition");
+  exec_time.start();
+  Level finest;
+  {
+    auto view = pg->BuildView<katana::PropertyGraphViews::BiDirectional>();
+    BuildFinestLevel(view, &finest);
+  }
+  katana::NUMAArray<uint32_t> parts;
+  switch (plan.algorithm()) {
+  case PartitionPlan::kMultilevel:
+    parts = MultilevelPartition(std::move(finest), num_partitions, plan);
+    break;
+  default:
+    return katana::ErrorCode::InvalidArgument;
+  }
+  exec_time.stop();
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const Graph::Node& n) { graph.GetData<NodePartition>(n) = parts[n]; },
+      katana::no_stats(), katana::loopname("Partition-output"));
+
+  return katana::ResultSuccess();
+}
+
+void
+katana::analytics::PartitionStatistics::Print(std::ostream& os) const {
+  os << "Number of partitions = " << num_partitions << std::endl;
+  os << "Edge cut = " << edge_cut << std::endl;
+  os << "Largest partition size = " << largest_partition_size << std::endl;
+  os << "Imbalance = " << imbalance << std::endl;
+}
+
+katana::Result<PartitionStatistics>
+katana::analytics::PartitionStatistics::Compute(
+    katana::PropertyGraph* pg, const std::string& property_name) {
+  auto property =
+      KATANA_CHECKED(pg->GetNodePropertyTyped<uint32_t>(property_name));
+
+  katana::GReduceMax<uint32_t> max_part;
+  katana::do_all(
+      katana::iterate(int64_t{0}, property->length()),
+      [&](int64_t i) { max_part.update(property->Value(i)); },
+      katana::no_stats());
+  uint32_t num_partitions = property->length() > 0 ? max_part.reduce() + 1 : 0;
+
+  katana::NUMAArray<std::atomic<uint64_t>> sizes;
+  sizes.allocateBlocked(num_partitions);
+  katana::do_all(
+      katana::iterate(uint32_t{0}, num_partitions),
+      [&](uint32_t p) { sizes[p].store(0, std::memory_order_relaxed); },
+      katana::no_stats());
+  katana::do_all(
+      katana::iterate(int64_t{0}, property->length()),
+      [&](int64_t i) {
+        sizes[property->Value(i)].fetch_add(1, std::memory_order_relaxed);
+      },
+      katana::no_stats());
+  katana::GReduceMax<uint64_t> largest;
+  katana::do_all(
+      katana::iterate(uint32_t{0}, num_partitions),
+      [&](uint32_t p) { largest.update(sizes[p].load()); },
+      katana::no_stats());
+
+  const auto& topology = pg->topology();
+  katana::GAccumulator<uint64_t> edge_cut;
+  katana::do_all(
+      katana::iterate(topology.all_nodes()),
+      [&](auto n) {
+        for (auto e : topology.edges(n)) {
+          edge_cut +=
+              property->Value(n) != property->Value(topology.edge_dest(e));
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  double average =
+      num_partitions > 0 ? static_cast<double>(pg->num_nodes()) / num_partitions
+                         : 0;
+  return PartitionStatistics{
+      num_partitions, edge_cut.reduce(), largest.reduce(),
+      average > 0 ? largest.reduce() / average : 0};
+}
@@ -0,0 +1,409 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2020, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "katana/analytics/pattern_matching/pattern_matching.h"
+
+#include <algorithm>
+#include <numeric>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+#include "katana/SetIntersection.h"
+#include "katana/Statistics.h"
+#include "katana/Timer.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using View = katana::PropertyGraphViews::BiDirectional;
+
+/// The sorted, duplicate free neighbors of every node along the edges of one
+/// type in one direction, contiguous so that they can be intersected
+struct Adjacency {
+  std::vector<uint64_t> indices;
+  std::vector<uint32_t> neighbors;
+
+  const uint32_t* begin(Node n) const { return neighbors.data() + indices[n]; }
+  size_t size(Node n) const { return indices[n + 1] - indices[n]; }
+};
+
+/// Which adjacency a pattern edge is checked against
+struct AdjacencyKey {
+  bool out;
+  std::optional<katana::EntityTypeID> type;
+
+  bool operator==(const AdjacencyKey& other) const {
+    return out == other.out && type == other.type;
+  }
+};
+
+template <typename F>
+void
+ForEachNeighbor(
+    const katana::PropertyGraph& pg, const View& view, const AdjacencyKey& key,
+    Node n, const F& fn) {
+  auto matches = [&](auto property_index) {
+    return !key.type || pg.DoesEdgeHaveType(property_index, *key.type);
+  };
+  if (key.out) {
+    for (auto e : view.edges(n)) {
+      if (matches(view.edge_property_index(e))) {
+        fn(view.edge_dest(e));
+      }
+    }
+  } else {
+    for (auto e : view.in_edges(n)) {
+      if (matches(view.in_edge_property_index(e))) {
+        fn(view.in_edge_dest(e));
+      }
+    }
+  }
+}
+
+Adjacency
+BuildAdjacency(
+    const katana::PropertyGraph& pg, const View& view,
+    const AdjacencyKey& key) {
+  const uint64_t num_nodes = view.num_nodes();
+  // Gather every neighbor, then sort and deduplicate in place and compact
+  std::vector<uint64_t> raw_indices(num_nodes + 1, 0);
+  katana::do_all(
+      katana::iterate(view.all_nodes()),
+      [&](Node n) {
+        uint64_t count = 0;
+        ForEachNeighbor(pg, view, key, n, [&](Node) { ++count; });
+        raw_indices[n + 1] = count;
+      },
+      katana::steal(), katana::no_stats());
+  std::partial_sum(raw_indices.begin(), raw_indices.end(), raw_indices.begin());
+
+  std::vector<uint32_t> raw(raw_indices.back());
+  Adjacency adjacency;
+  adjacency.indices.assign(num_nodes + 1, 0);
+  katana::do_all(
+      katana::iterate(view.all_nodes()),
+      [&](Node n) {
+        auto begin = raw.begin() + raw_indices[n];
+        auto end = begin;
+        ForEachNeighbor(pg, view, key, n, [&](Node d) { *end++ = d; });
+        std::sort(begin, end);
+        adjacency.indices[n + 1] = std::unique(begin, end) - begin;
+      },
+      katana::steal(), katana::no_stats());
+  std::partial_sum(
+      adjacency.indices.begin(), adjacency.indices.end(),
+      adjacency.indices.begin());
+
+  adjacency.neighbors.resize(adjacency.indices.back());
+  katana::do_all(
+      katana::iterate(view.all_nodes()),
+      [&](Node n) {
+        std::copy_n(
+            raw.begin() + raw_indices[n], adjacency.size(n),
+            adjacency.neighbors.begin() + adjacency.indices[n]);
+      },
+      katana::no_stats());
+  return adjacency;
+}
+
+/// The candidates of a pattern node are neighbors of the node bound at
+/// position bound in the adjacency of index adjacency
+struct Constraint {
+  uint32_t bound;
+  uint32_t adjacency;
+};
+
+/// A pattern node in the order in which nodes are bound
+struct Step {
+  uint32_t pattern_node;
+  std::optional<katana::EntityTypeID> type;
+  std::vector<Constraint> constraints;
+};
+
+struct JoinPlan {
+  std::vector<Step> steps;
+  std::vector<AdjacencyKey> adjacency_keys;
+};
+
+katana::Result<void>
+Validate(const katana::PropertyGraph& pg, const PatternQuery& query) {
+  const auto& nodes = query.nodes();
+  if (nodes.empty()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "pattern has no nodes");
+  }
+  for (const auto& node : nodes) {
+    if (node.type && !pg.GetNodeTypeManager().HasEntityType(*node.type)) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "unknown node type {}",
+          *node.type);
+    }
+  }
+  for (const auto& edge : query.edges()) {
+    if (edge.src >= nodes.size() || edge.dst >= nodes.size()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "pattern edge {} -> {} is out of range", edge.src, edge.dst);
+    }
+    if (edge.src == edge.dst) {
+      return KATANA_ERROR(
+          katana::ErrorCode::NotImplemented,
+          "self loops in patterns are not supported");
+    }
+    if (edge.type && !pg.GetEdgeTypeManager().HasEntityType(*edge.type)) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "unknown edge type {}",
+          *edge.type);
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+/// Bind first the node with the most pattern edges, then always the node
+/// with the most edges to the bound ones, so that candidates are
+/// intersections of as many lists as possible
+katana::Result<JoinPlan>
+Compile(const PatternQuery& query) {
+  const auto& nodes = query.nodes();
+  const auto& edges = query.edges();
+  const uint32_t num_nodes = nodes.size();
+
+  std::vector<uint32_t> degrees(num_nodes, 0);
+  for (const auto& edge : edges) {
+    degrees[edge.src] += 1;
+    degrees[edge.dst] += 1;
+  }
+  std::vector<uint32_t> position(num_nodes, num_nodes);
+  JoinPlan plan;
+
+  for (uint32_t placed = 0; placed < num_nodes; ++placed) {
+    uint32_t best = num_nodes;
+    uint32_t best_links = 0;
+    for (uint32_t n = 0; n < num_nodes; ++n) {
+      if (position[n] != num_nodes) {
+        continue;
+      }
+      uint32_t links = 0;
+      for (const auto& edge : edges) {
+        links += (edge.src == n && position[edge.dst] != num_nodes) ||
+                 (edge.dst == n && position[edge.src] != num_nodes);
+      }
+      if (best == num_nodes || links > best_links ||
+          (links == best_links && degrees[n] > degrees[best])) {
+        best = n;
+        best_links = links;
+      }
+    }
+    if (placed > 0 && best_links == 0) {
+      return KATANA_ERROR(
+          katana::ErrorCode::NotImplemented,
+          "patterns must be connected");
+    }
+
+    Step step{best, nodes[best].type, {}};
+    for (const auto& edge : edges) {
+      std::optional<AdjacencyKey> key;
+      uint32_t other = 0;
+      if (edge.dst == best && position[edge.src] != num_nodes) {
+        key = AdjacencyKey{true, edge.type};
+        other = edge.src;
+      } else if (edge.src == best && position[edge.dst] != num_nodes) {
+        key = AdjacencyKey{false, edge.type};
+        other = edge.dst;
+      }
+      if (!key) {
+        continue;
+      }
+      auto& keys = plan.adjacency_keys;
+      auto it = std::find(keys.begin(), keys.end(), *key);
+      if (it == keys.end()) {
+        it = keys.insert(keys.end(), *key);
+      }
+      uint32_t adjacency = it - keys.begin();
+      step.constraints.emplace_back(Constraint{position[other], adjacency});
+    }
+    position[best] = placed;
+    plan.steps.emplace_back(std::move(step));
+  }
+  return plan;
+}
+
+/// The buffers of the depth-first search of one thread
+struct Scratch {
+  /// The node bound at every step
+  std::vector<uint32_t> bound;
+  /// The node matched to every pattern node
+  std::vector<uint32_t> match;
+  /// Per step, the neighbor lists to intersect and two buffers for partial
+  /// intersections
+  std::vector<std::vector<std::pair<const uint32_t*, size_t>>> lists;
+  std::vector<std::vector<uint32_t>> candidates;
+  std::vector<std::vector<uint32_t>> partial;
+};
+
+class Matcher {
+public:
+  Matcher(
+      const katana::PropertyGraph& pg, const View& view, JoinPlan plan,
+      uint32_t num_pattern_nodes)
+      : pg_(pg), view_(view), plan_(std::move(plan)) {
+    for (const auto& key : plan_.adjacency_keys) {
+      adjacencies_.emplace_back(BuildAdjacency(pg_, view_, key));
+    }
+    const size_t num_steps = plan_.steps.size();
+    for (unsigned i = 0; i < scratch_.size(); ++i) {
+      Scratch& scratch = *scratch_.getRemote(i);
+      scratch.bound.resize(num_steps);
+      scratch.match.resize(num_pattern_nodes);
+      scratch.lists.resize(num_steps);
+      scratch.candidates.resize(num_steps);
+      scratch.partial.resize(num_steps);
+    }
+  }
+
+  /// Call on_match(match) for every match, in parallel
+  template <typename F>
+  void Run(const F& on_match) {
+    const Step& first = plan_.steps[0];
+    katana::do_all(
+        katana::iterate(view_.all_nodes()),
+        [&](Node n) {
+          if (first.type && !pg_.DoesNodeHaveType(n, *first.type)) {
+            return;
+          }
+          Scratch& scratch = *scratch_.getLocal();
+          scratch.bound[0] = n;
+          scratch.match[first.pattern_node] = n;
+          Extend(1, &scratch, on_match);
+        },
+        katana::steal(), katana::chunk_size<1>(),
+        katana::loopname("PatternMatching"));
+  }
+
+private:
+  /// The candidates of step, which has at least one constraint
+  std::pair<const uint32_t*, size_t> Candidates(
+      uint32_t level, Scratch* scratch) {
+    const Step& step = plan_.steps[level];
+    auto& lists = scratch->lists[level];
+    lists.clear();
+    for (const Constraint& c : step.constraints) {
+      const Adjacency& adjacency = adjacencies_[c.adjacency];
+      Node n = scratch->bound[c.bound];
+      lists.emplace_back(adjacency.begin(n), adjacency.size(n));
+    }
+    // Intersecting the shortest lists first keeps partial results small
+    std::sort(lists.begin(), lists.end(), [](const auto& a, const auto& b) {
+      return a.second < b.second;
+    });
+    if (lists.size() == 1) {
+      return lists[0];
+    }
+
+    auto& candidates = scratch->candidates[level];
+    auto& partial = scratch->partial[level];
+    candidates.clear();
+    katana::ForEachCommon(
+        lists[0].first, lists[0].second, lists[1].first, lists[1].second,
+        [&](uint32_t id) { candidates.emplace_back(id); });
+    for (size_t i = 2; i < lists.size() && !candidates.empty(); ++i) {
+      partial.clear();
+      katana::ForEachCommon(
+          candidates.data(), candidates.size(), lists[i].first,
+          lists[i].second, [&](uint32_t id) { partial.emplace_back(id); });
+      std::swap(candidates, partial);
+    }
+    return {candidates.data(), candidates.size()};
+  }
+
+  template <typename F>
+  void Extend(uint32_t level, Scratch* scratch, const F& on_match) {
+    if (level == plan_.steps.size()) {
+      on_match(scratch->match);
+      return;
+    }
+    const Step& step = plan_.steps[level];
+    auto [candidates, size] = Candidates(level, scratch);
+    const uint32_t* bound_begin = scratch->bound.data();
+    const uint32_t* bound_end = bound_begin + level;
+    for (size_t i = 0; i < size; ++i) {
+      Node n = candidates[i];
+      // Matches are injective
+      if (std::find(bound_begin, bound_end, n) != bound_end) {
+        continue;
+      }
+      if (step.type && !pg_.DoesNodeHaveType(n, *step.type)) {
+        continue;
+      }
+      scratch->bound[level] = n;
+      scratch->match[step.pattern_node] = n;
+      Extend(level + 1, scratch, on_match);
+    }
+  }
+
+  const katana::PropertyGraph& pg_;
+  const View& view_;
+  JoinPlan plan_;
+  std::vector<Adjacency> adjacencies_;
+  katana::PerThreadStorage<Scratch> scratch_;
+};
+
+template <typename F>
+katana::Result<void>
+Match(
+    katana::PropertyGraph* pg, const PatternQuery& query,
+    const PatternMatchingPlan& plan, const F& on_match) {
+  if (plan.algorithm() != PatternMatchingPlan::kGenericJoin) {
+    return katana::ErrorCode::InvalidArgument;
+  }
+  KATANA_CHECKED(Validate(*pg, query));
+  JoinPlan join_plan = KATANA_CHECKED(Compile(query));
+
+  View view = pg->BuildView<View>();
+  katana::StatTimer exec_time("PatternMatching");
+  exec_time.start();
+  Matcher matcher(*pg, view, std::move(join_plan), query.nodes().size());
+  matcher.Run(on_match);
+  exec_time.stop();
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+katana::Result<uint64_t>
+katana::analytics::PatternMatchCount(
+    PropertyGraph* pg, const PatternQuery& query, PatternMatchingPlan plan) {
+  katana::GAccumulator<uint64_t> count;
+  KATANA_CHECKED(Match(
+      pg, query, plan, [&](const std::vector<uint32_t>&) { count += 1; }));
+  return count.reduce();
+}
+
+katana::Result<void>
+katana::analytics::PatternMatchEnumerate(
+    PropertyGraph* pg, const PatternQuery& query, const PatternMatchSink& sink,
+    PatternMatchingPlan plan) {
+  return Match(pg, query, plan, sink);
+}
@@ -19,6 +19,14 @@
 
 #include "katana/analytics/random_walks/random_walks.h"
 
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "katana/Bag.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Random.h"
 #include "katana/TypedPropertyGraph.h"
 
 using namespace katana::analytics;
@@ -29,146 +37,457 @@ namespace {
 
 using SortedPropertyGraphView = katana::PropertyGraphViews::EdgesSortedByDestID;
 
-struct Node2VecAlgo {
-  using NodeData = std::tuple<>;
-  using EdgeData = std::tuple<>;
+/// Where generated walks go: chunks of walks are written into buffer, which
+/// has room for chunk_size walks of stride node ids, and handed to flush,
+/// which returns the buffer for the next chunk
+struct WalkOutput {
+  uint32_t stride;
+  uint32_t* buffer;
+  uint64_t chunk_size;
+  std::function<katana::Result<uint32_t*>(uint32_t* buffer, uint64_t num_walks)>
+      flush;
+};
 
-  using SortedGraphView = katana::TypedPropertyGraphView<
-      SortedPropertyGraphView, NodeData, EdgeData>;
-  using GNode = typename SortedGraphView::Node;
+/// Seeds the random numbers of the first pass of walks; each later pass adds
+/// one
+constexpr uint64_t kRandomWalksSeed = 0x5EED0F5A1C3B7D29;
 
-  const RandomWalksPlan& plan_;
-  Node2VecAlgo(const RandomWalksPlan& plan) : plan_(plan) {}
+/// Generates the walks of one pass over the start nodes into output.
+/// walk(n, generator, walk) writes a walk from n into walk, which has room
+/// for output->stride node ids, and returns its number of nodes, or 0 to
+/// drop it. Each walk draws from a generator keyed by seed and its index, so
+/// the walks do not depend on the number of threads or on scheduling.
+template <typename WalkFn>
+katana::Result<void>
+GenerateWalks(
+    uint64_t num_nodes, const RandomWalksPlan& plan, const WalkFn& walk,
+    uint64_t seed,
+    katana::PerThreadStorage<std::vector<uint32_t>>* walks_local,
+    WalkOutput* output) {
+  uint64_t total_walks = num_nodes * plan.number_of_walks();
+  uint32_t stride = output->stride;
+
+  for (uint64_t begin = 0; begin < total_walks; begin += output->chunk_size) {
+    uint64_t end = std::min(total_walks, begin + output->chunk_size);
+    std::atomic<uint64_t> num_walks{0};
 
-  GNode FindSampleNeighbor(
-      const SortedGraphView& graph, const GNode& n,
-      const katana::NUMAArray<uint64_t>& degree, const double prob) {
-    if (degree[n] == 0) {
-      return graph.num_nodes();
-    }
-    double total_wt = degree[n];
+    katana::do_all(
+        katana::iterate(begin, end),
+        [&](uint64_t idx) {
+          std::vector<uint32_t>& walk_local = *walks_local->getLocal();
+          walk_local.resize(stride);
+
+          katana::CounterRng generator(seed, idx);
+          uint32_t length =
+              walk(idx % num_nodes, &generator, walk_local.data());
+          if (length == 0) {
+            return;
+          }
+          KATANA_LOG_DEBUG_ASSERT(length <= stride);
+          std::fill(
+              walk_local.begin() + length, walk_local.end(),
+              kRandomWalkPadding);
+
+          uint64_t slot = num_walks.fetch_add(1, std::memory_order_relaxed);
+          std::copy(
+              walk_local.begin(), walk_local.end(),
+              output->buffer + slot * stride);
+        },
+        katana::steal(), katana::chunk_size<RandomWalksPlan::kChunkSize>(),
+        katana::loopname("Random walks"), katana::no_stats());
 
-    uint32_t edge_index = std::floor(prob * total_wt);
-    auto ei = graph.edges(n).begin() + edge_index;
-    return graph.edge_dest(*ei);
+    output->buffer =
+        KATANA_CHECKED(output->flush(output->buffer, num_walks.load()));
+  }
+  return katana::ResultSuccess();
+}
+
+/// Samples the first order step of a walk: an edge of a node, uniformly or,
+/// if the walk is weighted, in proportion to the edge weights. A weighted
+/// step is a lookup in the alias table of the node if it has one and a
+/// binary search of the prefix sums of its edge weights otherwise, so no
+/// neighbor list is scanned.
+class EdgeSampler {
+public:
+  /// Nodes of lower degree are left to the binary search, which costs about
+  /// as much as an alias table lookup on them
+  static constexpr uint64_t kAliasTableMinDegree = 32;
+  static constexpr uint64_t kAliasTableBytesPerEdge =
+      sizeof(float) + sizeof(uint32_t);
+
+  template <typename Graph>
+  void InitializeDegrees(const Graph& graph) {
+    degree_.allocateBlocked(graph.size());
+    katana::do_all(katana::iterate(graph), [&](typename Graph::Node n) {
+      // Treat this as O(1) time because subtracting iterators is just pointer
+      // or number subtraction. So don't use steal().
+      degree_[n] = graph.edges(n).size();
+    });
   }
 
-  void GraphRandomWalk(
-      const SortedGraphView& graph,
-      katana::InsertBag<std::vector<uint32_t>>* walks,
-      const katana::NUMAArray<uint64_t>& degree) {
-    katana::PerThreadStorage<std::mt19937> generator;
-    katana::PerThreadStorage<std::uniform_real_distribution<double>*>
-        distribution;
-
-    for (uint32_t i = 0; i < distribution.size(); i++) {
-      *distribution.getRemote(i) =
-          new std::uniform_real_distribution<double>(0.0, 1.0);
+  /// Make the steps weighted by weights, indexed by the edges of graph, and
+  /// build alias tables in at most max_alias_bytes
+  template <typename Graph>
+  katana::Result<void> InitializeWeights(
+      const Graph& graph, const katana::NUMAArray<double>& weights,
+      uint64_t max_alias_bytes) {
+    prefix_.allocateBlocked(weights.size());
+    std::atomic<bool> negative{false};
+    katana::do_all(
+        katana::iterate(graph),
+        [&](typename Graph::Node n) {
+          double sum = 0;
+          for (auto e : graph.edges(n)) {
+            if (weights[e] < 0) {
+              negative.store(true, std::memory_order_relaxed);
+            }
+            sum += weights[e];
+            prefix_[e] = sum;
+          }
+        },
+        katana::steal(), katana::no_stats());
+    if (negative.load()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "edge weights of random walks must not be negative");
     }
+    BuildAliasTables(graph, max_alias_bytes);
+    return katana::ResultSuccess();
+  }
 
-    double prob_forward = 1.0 / plan_.forward_probability();
-    double prob_backward = 1.0 / plan_.backward_probability();
+  uint64_t degree(uint32_t n) const { return degree_[n]; }
 
-    double upper_bound = 1.0;
+  /// Whether a walk can step away from n
+  template <typename Graph>
+  bool CanStep(const Graph& graph, uint32_t n) const {
+    return degree_[n] != 0 &&
+           (prefix_.empty() || prefix_[*graph.edges(n).end() - 1] > 0);
+  }
 
-    upper_bound = (upper_bound > prob_forward) ? upper_bound : prob_forward;
-    upper_bound = (upper_bound > prob_backward) ? upper_bound : prob_backward;
+  /// Pick an edge of n, which must satisfy CanStep
+  template <typename Graph>
+  auto Sample(
+      const Graph& graph, uint32_t n, katana::CounterRng* generator) const {
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+    auto first = graph.edges(n).begin();
+    uint64_t degree = degree_[n];
+    double x = dist(*generator);
+    if (prefix_.empty()) {
+      return first + std::min<uint64_t>(x * degree, degree - 1);
+    }
+    if (has_alias_table(n)) {
+      // The integer part of x * degree picks a column of the table and the
+      // fractional part decides between the column and its alias
+      double column = x * degree;
+      uint64_t i = std::min<uint64_t>(column, degree - 1);
+      uint64_t slot = alias_begin_[n] + i;
+      return first + (column - i < alias_prob_[slot] ? i : alias_[slot]);
+    }
+    const double* begin = &prefix_[*first];
+    const double* it = std::upper_bound(
+        begin, begin + degree - 1, x * begin[degree - 1]);
+    return first + (it - begin);
+  }
 
-    double lower_bound = 1.0;
+private:
+  static constexpr uint64_t kNoAliasTable =
+      std::numeric_limits<uint64_t>::max();
 
-    lower_bound = (lower_bound < prob_forward) ? lower_bound : prob_forward;
-    lower_bound = (lower_bound < prob_backward) ? lower_bound : prob_backward;
+  bool has_alias_table(uint32_t n) const {
+    return !alias_begin_.empty() && alias_begin_[n] != kNoAliasTable;
+  }
 
-    uint64_t total_walks = graph.size() * plan_.number_of_walks();
+  /// Smallest degree of the nodes that get an alias table: the highest
+  /// degree ones whose tables fit in max_bytes
+  template <typename Graph>
+  uint64_t AliasTableMinDegree(const Graph& graph, uint64_t max_bytes) const {
+    katana::InsertBag<uint64_t> bag;
+    katana::do_all(
+        katana::iterate(graph),
+        [&](typename Graph::Node n) {
+          if (degree_[n] >= kAliasTableMinDegree) {
+            bag.push(degree_[n]);
+          }
+        },
+        katana::no_stats());
+    std::vector<uint64_t> degrees(bag.begin(), bag.end());
+    katana::ParallelSTL::sort(
+        degrees.begin(), degrees.end(), std::greater<uint64_t>());
+
+    uint64_t max_edges = max_bytes / kAliasTableBytesPerEdge;
+    uint64_t num_edges = 0;
+    for (size_t i = 0; i < degrees.size(); ++i) {
+      num_edges += degrees[i];
+      if (num_edges > max_edges) {
+        // Nodes with the degree of the first one that does not fit are left
+        // out with it
+        return degrees[i] + 1;
+      }
+    }
+    return kAliasTableMinDegree;
+  }
+
+  /// Build the alias tables, by Vose's method, of the nodes of degree at
+  /// least AliasTableMinDegree
+  template <typename Graph>
+  void BuildAliasTables(const Graph& graph, uint64_t max_bytes) {
+    uint64_t min_degree = AliasTableMinDegree(graph, max_bytes);
 
+    alias_begin_.allocateBlocked(graph.size());
     katana::do_all(
-        katana::iterate(uint64_t(0), total_walks),
-        [&](uint64_t idx) {
-          GNode n = idx % graph.size();
+        katana::iterate(graph),
+        [&](typename Graph::Node n) {
+          alias_begin_[n] = degree_[n] >= min_degree ? degree_[n] : 0;
+        },
+        katana::no_stats());
+    katana::ParallelSTL::partial_sum(
+        alias_begin_.begin(), alias_begin_.end(), alias_begin_.begin());
+    uint64_t num_slots = graph.size() ? alias_begin_[graph.size() - 1] : 0;
+    if (num_slots == 0) {
+      alias_begin_.destroy();
+      alias_begin_.deallocate();
+      return;
+    }
+    alias_prob_.allocateBlocked(num_slots);
+    alias_.allocateBlocked(num_slots);
 
-          //check if n has no neighbor
-          if (degree[n] == 0) {
+    katana::PerThreadStorage<std::vector<uint32_t>> smalls;
+    katana::PerThreadStorage<std::vector<uint32_t>> larges;
+    katana::PerThreadStorage<std::vector<double>> scaled_weights;
+    katana::do_all(
+        katana::iterate(graph),
+        [&](typename Graph::Node n) {
+          uint64_t degree = degree_[n];
+          if (degree < min_degree) {
+            alias_begin_[n] = kNoAliasTable;
             return;
           }
+          uint64_t begin = alias_begin_[n] - degree;
+          alias_begin_[n] = begin;
+
+          const double* prefix = &prefix_[*graph.edges(n).begin()];
+          double total = prefix[degree - 1];
+          std::vector<uint32_t>& small = *smalls.getLocal();
+          std::vector<uint32_t>& large = *larges.getLocal();
+          // The weights scaled so that they average 1
+          std::vector<double>& scaled = *scaled_weights.getLocal();
+          small.clear();
+          large.clear();
+          scaled.resize(degree);
+          for (uint64_t i = 0; i < degree; ++i) {
+            double weight = prefix[i] - (i ? prefix[i - 1] : 0.0);
+            scaled[i] = total > 0 ? weight * degree / total : 1.0;
+            (scaled[i] < 1.0 ? small : large).emplace_back(i);
+          }
+          while (!small.empty() && !large.empty()) {
+            uint32_t s = small.back();
+            small.pop_back();
+            uint32_t l = large.back();
+            alias_prob_[begin + s] = scaled[s];
+            alias_[begin + s] = l;
+            scaled[l] -= 1.0 - scaled[s];
+            if (scaled[l] < 1.0) {
+              large.pop_back();
+              small.emplace_back(l);
+            }
+          }
+          // What is left has weight 1 up to rounding
+          for (uint32_t i : small) {
+            alias_prob_[begin + i] = 1.0;
+            alias_[begin + i] = i;
+          }
+          for (uint32_t i : large) {
+            alias_prob_[begin + i] = 1.0;
+            alias_[begin + i] = i;
+          }
+        },
+        katana::steal(), katana::no_stats());
+  }
 
-          std::uniform_real_distribution<double>* dist =
-              *distribution.getLocal();
+  katana::NUMAArray<uint64_t> degree_;
+  /// Running sums of the edge weights of each node, indexed by edge; empty
+  /// if the walk is unweighted
+  katana::NUMAArray<double> prefix_;
+  /// Per node, the first slot of its alias table or kNoAliasTable
+  katana::NUMAArray<uint64_t> alias_begin_;
+  katana::NUMAArray<float> alias_prob_;
+  katana::NUMAArray<uint32_t> alias_;
+};
 
-          std::vector<uint32_t> walk;
-          walk.push_back(n);
+struct Node2VecAlgo {
+  using NodeData = std::tuple<>;
+  using EdgeData = std::tuple<>;
 
-          //random value between 0 and 1
-          double prob = (*dist)(*generator.getLocal());
+  using SortedGraphView = katana::TypedPropertyGraphView<
+      SortedPropertyGraphView, NodeData, EdgeData>;
+  using GNode = typename SortedGraphView::Node;
 
-          //Assumption: All edges have weight 1
-          auto nbr = FindSampleNeighbor(graph, n, degree, prob);
-          KATANA_LOG_ASSERT(nbr < graph.num_nodes());
+  const RandomWalksPlan& plan_;
+  double prob_forward_;
+  double prob_backward_;
+  double upper_bound_;
+  double lower_bound_;
+
+  Node2VecAlgo(const RandomWalksPlan& plan)
+      : plan_(plan),
+        prob_forward_(1.0 / plan.forward_probability()),
+        prob_backward_(1.0 / plan.backward_probability()) {
+    upper_bound_ = std::max({1.0, prob_forward_, prob_backward_});
+    lower_bound_ = std::min({1.0, prob_forward_, prob_backward_});
+  }
 
-          walk.push_back(std::move(nbr));
+  GNode FindSampleNeighbor(
+      const SortedGraphView& graph, const EdgeSampler& sampler, const GNode& n,
+      katana::CounterRng* generator) const {
+    return graph.edge_dest(*sampler.Sample(graph, n, generator));
+  }
 
-          for (uint32_t current_walk = 2; current_walk <= plan_.walk_length();
-               current_walk++) {
-            uint32_t curr = walk[current_walk - 1];
-            uint32_t prev = walk[current_walk - 2];
+  uint32_t Walk(
+      const SortedGraphView& graph, const EdgeSampler& sampler, GNode n,
+      katana::CounterRng* generator, uint32_t* walk) const {
+    //check if n has no neighbor
+    if (!sampler.CanStep(graph, n)) {
+      return 0;
+    }
 
-            //check if n has no neighbor
-            if (degree[curr] == 0) {
-              break;
-            }
-            //acceptance-rejection sampling
-            while (true) {
-              //sample x
-              double prob = (*dist)(*generator.getLocal());
-
-              auto nbr = FindSampleNeighbor(graph, curr, degree, prob);
-              KATANA_LOG_ASSERT(nbr < graph.num_nodes());
-
-              //sample y
-              double y = (*dist)(*generator.getLocal());
-              y = y * upper_bound;
-
-              if (y <= lower_bound) {
-                //accept this sample
-                walk.push_back(std::move(nbr));
-                break;
-              } else {
-                //compute transition probability
-                double alpha;
-
-                //check if nbr is same as the previous node on this walk
-                if (nbr == prev) {
-                  alpha = prob_backward;
-                }  //check if nbr is also a neighbor of the previous node on this walk
-                else if (graph.has_edge(prev, nbr)) {
-                  alpha = 1.0;
-                } else {
-                  alpha = prob_forward;
-                }
-
-                if (y <= alpha) {
-                  //accept y
-                  walk.push_back(std::move(nbr));
-                  break;
-                }
-              }
-            }
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+
+    uint32_t length = 0;
+    walk[length++] = n;
+
+    auto nbr = FindSampleNeighbor(graph, sampler, n, generator);
+    walk[length++] = nbr;
+
+    for (uint32_t current_walk = 2; current_walk <= plan_.walk_length();
+         current_walk++) {
+      uint32_t curr = walk[current_walk - 1];
+      uint32_t prev = walk[current_walk - 2];
+
+      //check if n has no neighbor
+      if (!sampler.CanStep(graph, curr)) {
+        break;
+      }
+      //acceptance-rejection sampling: propose a first order step and accept
+      //it with its second order bias over upper_bound_
+      while (true) {
+        //sample x
+        auto nbr = FindSampleNeighbor(graph, sampler, curr, generator);
+
+        //sample y
+        double y = dist(*generator);
+        y = y * upper_bound_;
+
+        if (y <= lower_bound_) {
+          //accept this sample
+          walk[length++] = nbr;
+          break;
+        } else {
+          //compute transition probability
+          double alpha;
+
+          //check if nbr is same as the previous node on this walk
+          if (nbr == prev) {
+            alpha = prob_backward_;
+          }  //check if nbr is also a neighbor of the previous node on this walk
+          else if (graph.has_edge(prev, nbr)) {
+            alpha = 1.0;
+          } else {
+            alpha = prob_forward_;
           }
 
-          walks->push(std::move(walk));
-        },
-        katana::steal(), katana::chunk_size<RandomWalksPlan::kChunkSize>(),
-        katana::loopname("Node2vec walks"), katana::no_stats());
+          if (y <= alpha) {
+            //accept y
+            walk[length++] = nbr;
+            break;
+          }
+        }
+      }
+    }
+    return length;
+  }
+
+  template <typename Generate>
+  katana::Result<void> operator()(
+      const SortedGraphView& graph, const EdgeSampler& sampler,
+      const Generate& generate) {
+    return generate(
+        [&](GNode n, katana::CounterRng* generator,
+            uint32_t* walk) -> uint32_t {
+          return Walk(graph, sampler, n, generator, walk);
+        });
+  }
+};
 
-    for (uint32_t i = 0; i < distribution.size(); i++) {
-      delete (*distribution.getRemote(i));
+/// Node2Vec walks over the edges of a TemporalEdgeIndex in a time window.
+/// A first order step is a uniform pick among the edges of the node in the
+/// window and the second order bias is applied by rejection sampling as in
+/// Node2VecAlgo.
+struct TimeWindowNode2VecAlgo {
+  const katana::TemporalEdgeIndex& index_;
+  katana::TimeWindow window_;
+  Node2VecAlgo bias_;
+
+  TimeWindowNode2VecAlgo(
+      const katana::TemporalEdgeIndex& index, const katana::TimeWindow& window,
+      const RandomWalksPlan& plan)
+      : index_(index), window_(window), bias_(plan) {}
+
+  /// The destination of a uniformly picked edge of n in the window, which
+  /// must have one
+  uint32_t Step(uint32_t n, katana::CounterRng* generator) const {
+    auto edges = index_.edges(n, window_);
+    std::uniform_int_distribution<uint64_t> dist(0, edges.size() - 1);
+    return index_.edge_dest(*edges.begin() + dist(*generator));
+  }
+
+  /// Whether src has an edge to dst in the window. Only needed when a step
+  /// is not accepted outright, so the scan is rare unless the bias is strong.
+  bool HasEdge(uint32_t src, uint32_t dst) const {
+    for (auto e : index_.edges(src, window_)) {
+      if (index_.edge_dest(e) == dst) {
+        return true;
+      }
     }
+    return false;
   }
 
-  void operator()(
-      const SortedGraphView& graph,
-      katana::InsertBag<std::vector<uint32_t>>* walks,
-      const katana::NUMAArray<uint64_t>& degree) {
-    GraphRandomWalk(graph, walks, degree);
+  uint32_t Walk(
+      uint32_t n, katana::CounterRng* generator, uint32_t* walk) const {
+    if (index_.edges(n, window_).empty()) {
+      return 0;
+    }
+
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+
+    uint32_t length = 0;
+    walk[length++] = n;
+    walk[length++] = Step(n, generator);
+
+    for (uint32_t current_walk = 2; current_walk <= bias_.plan_.walk_length();
+         current_walk++) {
+      uint32_t curr = walk[current_walk - 1];
+      uint32_t prev = walk[current_walk - 2];
+      if (index_.edges(curr, window_).empty()) {
+        break;
+      }
+      while (true) {
+        uint32_t nbr = Step(curr, generator);
+        double y = dist(*generator) * bias_.upper_bound_;
+        double alpha = 1.0;
+        if (y > bias_.lower_bound_) {
+          if (nbr == prev) {
+            alpha = bias_.prob_backward_;
+          } else if (!HasEdge(prev, nbr)) {
+            alpha = bias_.prob_forward_;
+          }
+        }
+        if (y <= bias_.lower_bound_ || y <= alpha) {
+          walk[length++] = nbr;
+          break;
+        }
+      }
+    }
+    return length;
   }
 };
 
@@ -182,6 +501,15 @@ struct Edge2VecAlgo {
       SortedPropertyGraphView, NodeData, EdgeData>;
   using GNode = typename SortedGraphView::Node;
 
+  /// Sums over the walks of an iteration of the number of edges of each type
+  /// in a walk and of the products of the numbers of two types, from which
+  /// the correlation of the types is computed
+  struct EdgeTypeSums {
+    uint64_t num_walks{0};
+    std::vector<uint64_t> counts;
+    std::vector<uint64_t> products;
+  };
+
   const RandomWalksPlan& plan_;
   Edge2VecAlgo(const RandomWalksPlan& plan) : plan_(plan) {}
 
@@ -199,238 +527,117 @@ struct Edge2VecAlgo {
   }
 
   std::pair<GNode, EdgeType::ViewType::value_type> FindSampleNeighbor(
-      const SortedGraphView& graph, const GNode& n,
-      const katana::NUMAArray<uint64_t>& degree, const double prob) {
-    if (degree[n] == 0) {
-      return std::make_pair(graph.num_nodes(), 1);
-    }
-    double total_wt = degree[n];
-
-    uint32_t edge_index = std::floor(prob * total_wt);
-    auto ei = graph.edges(n).begin() + edge_index;
+      const SortedGraphView& graph, const EdgeSampler& sampler, const GNode& n,
+      katana::CounterRng* generator) const {
+    auto ei = sampler.Sample(graph, n, generator);
     return std::make_pair(
         graph.edge_dest(*ei), graph.GetEdgeData<EdgeType>(*ei));
   }
 
-  void GraphRandomWalk(
-      const SortedGraphView& graph,
-      katana::InsertBag<std::vector<uint32_t>>* walks,
-      katana::InsertBag<std::vector<uint32_t>>* types_walks,
-      const katana::NUMAArray<uint64_t>& degree) {
-    katana::PerThreadStorage<std::mt19937> generator;
-    katana::PerThreadStorage<std::uniform_real_distribution<double>*>
-        distribution;
-
-    for (uint32_t i = 0; i < distribution.size(); i++) {
-      *distribution.getRemote(i) =
-          new std::uniform_real_distribution<double>(0.0, 1.0);
+  /// Like Node2VecAlgo::Walk, but also writes the edge type of every step
+  /// into types. Walks that reach a node without neighbors are dropped.
+  uint32_t Walk(
+      const SortedGraphView& graph, const EdgeSampler& sampler, GNode n,
+      katana::CounterRng* generator, uint32_t* walk, uint32_t* types) const {
+    //check if n has no neighbor
+    if (!sampler.CanStep(graph, n)) {
+      return 0;
     }
 
     double prob_forward = 1.0 / plan_.forward_probability();
     double prob_backward = 1.0 / plan_.backward_probability();
+    double upper_bound = std::max({1.0, prob_forward, prob_backward});
 
-    double upper_bound = 1.0;
-
-    upper_bound = (upper_bound > prob_forward) ? upper_bound : prob_forward;
-    upper_bound = (upper_bound > prob_backward) ? upper_bound : prob_backward;
-
-    uint64_t total_walks = graph.size() * plan_.number_of_walks();
-
-    katana::do_all(
-        katana::iterate(uint64_t(0), total_walks),
-        [&](uint64_t idx) {
-          GNode n = idx % graph.size();
-
-          //check if n has no neighbor
-          if (degree[n] == 0) {
-            return;
-          }
-
-          std::uniform_real_distribution<double>* dist =
-              *distribution.getLocal();
-
-          std::vector<uint32_t> walk;
-          std::vector<uint32_t> types_vec;
-
-          walk.push_back(n);
-
-          //random value between 0 and 1
-          double prob = (*dist)(*generator.getLocal());
-
-          //Assumption: All edges have weight 1
-          auto nbr_pair = FindSampleNeighbor(graph, n, degree, prob);
-          KATANA_LOG_ASSERT(nbr_pair.first < graph.num_nodes());
-
-          walk.push_back(std::move(nbr_pair.first));
-          types_vec.push_back(nbr_pair.second);
-
-          for (uint32_t current_walk = 2; current_walk <= plan_.walk_length();
-               current_walk++) {
-            uint32_t curr = walk[walk.size() - 1];
-            //check if n has no neighbor
-            if (degree[curr] == 0) {
-              return;
-            }
-            uint32_t prev = walk[walk.size() - 2];
-
-            uint32_t p1 = types_vec.back();  //last element of types_vec
-
-            //acceptance-rejection sampling
-            while (true) {
-              //sample x
-              double prob = (*dist)(*generator.getLocal());
-
-              auto nbr_type_pair =
-                  FindSampleNeighbor(graph, curr, degree, prob);
-              KATANA_LOG_ASSERT(nbr_pair.first < graph.num_nodes());
-
-              GNode nbr = nbr_type_pair.first;
-              EdgeType::ViewType::value_type p2 = nbr_type_pair.second;
-
-              //sample y
-              double y = (*dist)(*generator.getLocal());
-              y = y * upper_bound;
-
-              //compute transition probability
-              double alpha;
-
-              //check if nbr is same as the previous node on this walk
-              if (nbr == prev) {
-                alpha = prob_backward;
-              }  //check if nbr is also a neighbor of the previous node on this walk
-              else if (graph.has_edge(prev, nbr)) {
-                alpha = 1.0;
-              } else {
-                alpha = prob_forward;
-              }
-
-              alpha = alpha * transition_matrix_[p1][p2];
-              if (alpha >= y) {
-                //accept y
-                walk.push_back(std::move(nbr));
-                types_vec.push_back(p2);
-                break;
-              }
-            }  //end while
-
-          }  //end for
-
-          (*walks).push(std::move(walk));
-          (*types_walks).push(std::move(types_vec));
-        },
-        katana::steal(), katana::chunk_size<RandomWalksPlan::kChunkSize>(),
-        katana::loopname("Edge2vec walks"), katana::no_stats());
-  }
-
-  //compute the histogram of edge types for each walk
-  std::vector<std::vector<uint32_t>> ComputeNumEdgeTypeVectors(
-      const katana::InsertBag<std::vector<uint32_t>>& types_walks) {
-    std::vector<std::vector<uint32_t>> num_edge_types_walks;
-
-    katana::PerThreadStorage<std::vector<std::vector<uint32_t>>>
-        per_thread_num_edge_types_walks;
-    katana::do_all(
-        katana::iterate(types_walks),
-        [&](const std::vector<uint32_t>& types_walk) {
-          std::vector<uint32_t> num_edge_types(
-              plan_.number_of_edge_types() + 1, 0);
-
-          for (auto type : types_walk) {
-            num_edge_types[type]++;
-          }
-
-          per_thread_num_edge_types_walks.getLocal()->emplace_back(
-              std::move(num_edge_types));
-        });
-
-    for (unsigned j = 0; j < katana::getActiveThreads(); ++j) {
-      for (auto num_edge_types :
-           *per_thread_num_edge_types_walks.getRemote(j)) {
-        num_edge_types_walks.push_back(std::move(num_edge_types));
-      }
-    }
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
 
-    return num_edge_types_walks;
-  }
+    uint32_t length = 0;
+    walk[length++] = n;
 
-  std::vector<std::vector<uint32_t>> TransformVectors(
-      const std::vector<std::vector<uint32_t>>& num_edge_types_walks) {
-    uint32_t rows = num_edge_types_walks.size();
-    std::vector<std::vector<uint32_t>> transformed_num_edge_types_walks;
-    transformed_num_edge_types_walks.resize(plan_.number_of_edge_types() + 1);
+    auto nbr_pair = FindSampleNeighbor(graph, sampler, n, generator);
 
-    katana::do_all(
-        katana::iterate(uint32_t(0), plan_.number_of_edge_types() + 1),
-        [&](uint32_t j) {
-          for (uint32_t i = 0; i < rows; i++) {
-            transformed_num_edge_types_walks[j].push_back(
-                num_edge_types_walks[i][j]);
-          }
-        });
+    types[length - 1] = nbr_pair.second;
+    walk[length++] = nbr_pair.first;
 
-    return transformed_num_edge_types_walks;
-  }
-
-  std::vector<double> ComputeMeans(const std::vector<std::vector<uint32_t>>&
-                                       transformed_num_edge_types_walks) {
-    std::vector<double> means(plan_.number_of_edge_types() + 1);
-
-    for (uint32_t i = 1; i <= plan_.number_of_edge_types(); i++) {
-      uint32_t sum = 0;
-      for (auto n : transformed_num_edge_types_walks[i]) {
-        sum += n;
+    for (uint32_t current_walk = 2; current_walk <= plan_.walk_length();
+         current_walk++) {
+      uint32_t curr = walk[length - 1];
+      //check if n has no neighbor
+      if (!sampler.CanStep(graph, curr)) {
+        return 0;
       }
-
-      means[i] = ((double)sum) / (transformed_num_edge_types_walks[i].size());
-    }
-
-    return means;
+      uint32_t prev = walk[length - 2];
+
+      uint32_t p1 = types[length - 2];  //type of the last step
+
+      //acceptance-rejection sampling
+      while (true) {
+        //sample x
+        auto nbr_type_pair =
+            FindSampleNeighbor(graph, sampler, curr, generator);
+
+        GNode nbr = nbr_type_pair.first;
+        EdgeType::ViewType::value_type p2 = nbr_type_pair.second;
+
+        //sample y
+        double y = dist(*generator);
+        y = y * upper_bound;
+
+        //compute transition probability
+        double alpha;
+
+        //check if nbr is same as the previous node on this walk
+        if (nbr == prev) {
+          alpha = prob_backward;
+        }  //check if nbr is also a neighbor of the previous node on this walk
+        else if (graph.has_edge(prev, nbr)) {
+          alpha = 1.0;
+        } else {
+          alpha = prob_forward;
+        }
+
+        alpha = alpha * transition_matrix_[p1][p2];
+        if (alpha >= y) {
+          //accept y
+          types[length - 1] = p2;
+          walk[length++] = nbr;
+          break;
+        }
+      }  //end while
+
+    }  //end for
+
+    return length;
   }
 
   double sigmoidCal(const double pears) {
     return 1 / (1 + exp(-pears));  //exact sig
   }
 
+  /// The Pearson correlation of the numbers of edges of types i and j in
+  /// the walks
   double pearsonCorr(
-      const uint32_t i, const uint32_t j,
-      const std::vector<std::vector<uint32_t>>&
-          transformed_num_edge_types_walks,
-      const std::vector<double>& means) {
-    const std::vector<uint32_t>& x = transformed_num_edge_types_walks[i];
-    const std::vector<uint32_t>& y = transformed_num_edge_types_walks[j];
-
-    double sum = 0.0;
-    double sig1 = 0.0;
-    double sig2 = 0.0;
-
-    for (uint32_t m = 0; m < x.size(); m++) {
-      sum += ((double)x[m] - means[i]) * ((double)y[m] - means[j]);
-      sig1 += ((double)x[m] - means[i]) * ((double)x[m] - means[i]);
-      sig2 += ((double)y[m] - means[j]) * ((double)y[m] - means[j]);
-    }
-
-    sum = sum / x.size();
-
-    sig1 = sig1 / x.size();
-    sig1 = sqrt(sig1);
-
-    sig2 = sig2 / x.size();
-    sig2 = sqrt(sig2);
+      const uint32_t i, const uint32_t j, const EdgeTypeSums& sums) {
+    uint32_t num_types = plan_.number_of_edge_types() + 1;
+    double n = sums.num_walks;
+    double mean_i = sums.counts[i] / n;
+    double mean_j = sums.counts[j] / n;
+
+    double sum = sums.products[i * num_types + j] / n - mean_i * mean_j;
+    double sig1 = std::sqrt(
+        sums.products[i * num_types + i] / n - mean_i * mean_i);
+    double sig2 = std::sqrt(
+        sums.products[j * num_types + j] / n - mean_j * mean_j);
 
     double corr = sum / (sig1 * sig2);
     return corr;
   }
 
-  void ComputeTransitionMatrix(
-      const std::vector<std::vector<uint32_t>>&
-          transformed_num_edge_types_walks,
-      const std::vector<double>& means) {
+  void ComputeTransitionMatrix(const EdgeTypeSums& sums) {
     katana::do_all(
         katana::iterate(uint32_t(1), plan_.number_of_edge_types() + 1),
         [&](uint32_t i) {
           for (uint32_t j = 1; j <= plan_.number_of_edge_types(); j++) {
-            double pearson_corr =
-                pearsonCorr(i, j, transformed_num_edge_types_walks, means);
+            double pearson_corr = pearsonCorr(i, j, sums);
             double sigmoid = sigmoidCal(pearson_corr);
 
             transition_matrix_[i][j] = sigmoid;
@@ -438,88 +645,307 @@ struct Edge2VecAlgo {
         });
   }
 
-  void operator()(
-      const SortedGraphView& graph,
-      katana::InsertBag<std::vector<uint32_t>>* walks,
-      const katana::NUMAArray<uint64_t>& degree) {
+  template <typename Generate>
+  katana::Result<void> operator()(
+      const SortedGraphView& graph, const EdgeSampler& sampler,
+      const Generate& generate) {
     uint32_t iterations = plan_.max_iterations();
+    uint32_t num_types = plan_.number_of_edge_types() + 1;
 
     Initialize();
 
     for (uint32_t iter = 0; iter < iterations; iter++) {
       //E step; generate walks
-      katana::InsertBag<std::vector<uint32_t>> types_walks;
-
-      GraphRandomWalk(graph, walks, &types_walks, degree);
+      katana::PerThreadStorage<EdgeTypeSums> per_thread_sums;
+      katana::PerThreadStorage<std::vector<uint32_t>> per_thread_types;
+
+      KATANA_CHECKED(generate([&](GNode n, katana::CounterRng* generator,
+                                  uint32_t* walk) -> uint32_t {
+        std::vector<uint32_t>& types = *per_thread_types.getLocal();
+        types.resize(plan_.walk_stride() + num_types);
+        uint32_t length =
+            Walk(graph, sampler, n, generator, walk, types.data());
+        if (length == 0) {
+          return 0;
+        }
+
+        //compute the histogram of edge types of the walk
+        uint32_t* num_edge_types = types.data() + plan_.walk_stride();
+        std::fill(num_edge_types, num_edge_types + num_types, 0);
+        for (uint32_t k = 0; k + 1 < length; k++) {
+          num_edge_types[types[k]]++;
+        }
+
+        EdgeTypeSums& sums = *per_thread_sums.getLocal();
+        if (sums.counts.empty()) {
+          sums.counts.resize(num_types);
+          sums.products.resize(num_types * num_types);
+        }
+        sums.num_walks++;
+        for (uint32_t i = 0; i < num_types; i++) {
+          sums.counts[i] += num_edge_types[i];
+          for (uint32_t j = 0; j < num_types; j++) {
+            sums.products[i * num_types + j] +=
+                uint64_t{num_edge_types[i]} * num_edge_types[j];
+          }
+        }
+        return length;
+      }));
 
       //Update transition matrix
-      std::vector<std::vector<uint32_t>> num_edge_types_walks =
-          ComputeNumEdgeTypeVectors(types_walks);
-
-      std::vector<std::vector<uint32_t>> transformed_num_edge_types_walks =
-          TransformVectors(num_edge_types_walks);
-
-      std::vector<double> means =
-          ComputeMeans(transformed_num_edge_types_walks);
+      EdgeTypeSums sums;
+      sums.counts.resize(num_types);
+      sums.products.resize(num_types * num_types);
+      for (unsigned t = 0; t < per_thread_sums.size(); ++t) {
+        const EdgeTypeSums& local = *per_thread_sums.getRemote(t);
+        if (local.counts.empty()) {
+          continue;
+        }
+        sums.num_walks += local.num_walks;
+        for (uint32_t k = 0; k < num_types; k++) {
+          sums.counts[k] += local.counts[k];
+        }
+        for (uint32_t k = 0; k < num_types * num_types; k++) {
+          sums.products[k] += local.products[k];
+        }
+      }
 
-      ComputeTransitionMatrix(transformed_num_edge_types_walks, means);
+      ComputeTransitionMatrix(sums);
     }
+    return katana::ResultSuccess();
   }
 };
 
-template <typename Graph>
-void
-InitializeDegrees(const Graph& graph, katana::NUMAArray<uint64_t>* degree) {
-  katana::do_all(katana::iterate(graph), [&](typename Graph::Node n) {
-    // Treat this as O(1) time because subtracting iterators is just pointer
-    // or number subtraction. So don't use steal().
-    (*degree)[n] = graph.edges(n).size();
-  });
+template <typename WeightType>
+katana::Result<void>
+LoadEdgeWeights(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    katana::NUMAArray<double>* weights) {
+  using EdgeWeight = katana::PODProperty<WeightType>;
+  using WeightGraphView = katana::TypedPropertyGraphView<
+      SortedPropertyGraphView, std::tuple<>, std::tuple<EdgeWeight>>;
+  auto graph = KATANA_CHECKED(
+      WeightGraphView::Make(pg, {}, {edge_weight_property_name}));
+  weights->allocateBlocked(graph.num_edges());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, graph.num_edges()),
+      [&](uint64_t e) {
+        (*weights)[e] = graph.template GetEdgeData<EdgeWeight>(e);
+      },
+      katana::no_stats());
+  return katana::ResultSuccess();
+}
+
+/// The weights in edge_weight_property_name of the edges of the sorted view
+/// of pg
+katana::Result<void>
+LoadEdgeWeights(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    katana::NUMAArray<double>* weights) {
+  return DispatchOnEdgePropertyType(
+      pg, edge_weight_property_name, [&](auto tag) {
+        return LoadEdgeWeights<decltype(tag)>(
+            pg, edge_weight_property_name, weights);
+      });
 }
 
 }  //namespace
 
 template <typename Algorithm>
-static katana::Result<std::vector<std::vector<uint32_t>>>
+static katana::Result<void>
 RandomWalksWithWrap(
-    const typename Algorithm::SortedGraphView& graph, RandomWalksPlan plan) {
+    katana::PropertyGraph* pg, const typename Algorithm::SortedGraphView& graph,
+    const std::string& edge_weight_property_name, RandomWalksPlan plan,
+    WalkOutput* output) {
   katana::ReportPageAllocGuard page_alloc;
 
   Algorithm algo(plan);
 
-  katana::NUMAArray<uint64_t> degree;
-  degree.allocateBlocked(graph.size());
-  InitializeDegrees(graph, &degree);
+  EdgeSampler sampler;
+  sampler.InitializeDegrees(graph);
+  if (!edge_weight_property_name.empty()) {
+    katana::NUMAArray<double> weights;
+    KATANA_CHECKED(LoadEdgeWeights(pg, edge_weight_property_name, &weights));
+    KATANA_CHECKED(sampler.InitializeWeights(
+        graph, weights, plan.alias_table_max_bytes()));
+  }
 
-  katana::StatTimer execTime("RandomWalks");
-  execTime.start();
-  katana::InsertBag<std::vector<uint32_t>> walks;
-  algo(graph, &walks, degree);
-  execTime.stop();
+  katana::PerThreadStorage<std::vector<uint32_t>> walks_local;
 
-  std::vector<std::vector<uint32_t>> walks_in_vector;
-  walks_in_vector.reserve(plan.number_of_walks());
-  std::move(walks.begin(), walks.end(), std::back_inserter(walks_in_vector));
-  return walks_in_vector;
+  katana::StatTimer execTime("RandomWalks");
+  katana::TimerGuard exec_time_guard(execTime);
+  uint64_t seed = kRandomWalksSeed;
+  return algo(graph, sampler, [&](const auto& walk) {
+    return GenerateWalks(
+        graph.size(), plan, walk, seed++, &walks_local, output);
+  });
 }
 
-katana::Result<std::vector<std::vector<uint32_t>>>
-katana::analytics::RandomWalks(PropertyGraph* pg, RandomWalksPlan plan) {
+static katana::Result<void>
+RandomWalksImpl(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const RandomWalksPlan& plan, WalkOutput* output) {
   switch (plan.algorithm()) {
   case RandomWalksPlan::kNode2Vec: {
     auto graph =
         KATANA_CHECKED(Node2VecAlgo::SortedGraphView::Make(pg, {}, {}));
-    return RandomWalksWithWrap<Node2VecAlgo>(graph, plan);
+    return RandomWalksWithWrap<Node2VecAlgo>(
+        pg, graph, edge_weight_property_name, plan, output);
   }
   case RandomWalksPlan::kEdge2Vec: {
     TemporaryPropertyGuard tmp_edge_prop{pg->NodeMutablePropertyView()};
     auto graph = KATANA_CHECKED(
         Edge2VecAlgo::SortedGraphView::Make(pg, {}, {tmp_edge_prop.name()}));
-    return RandomWalksWithWrap<Edge2VecAlgo>(graph, plan);
+    return RandomWalksWithWrap<Edge2VecAlgo>(
+        pg, graph, edge_weight_property_name, plan, output);
   }
   default:
-    return ErrorCode::InvalidArgument;
+    return katana::ErrorCode::InvalidArgument;
+  }
+}
+
+uint64_t
+katana::analytics::RandomWalksMaxWalks(
+    const PropertyGraph& pg, const RandomWalksPlan& plan) {
+  uint64_t passes = plan.algorithm() == RandomWalksPlan::kEdge2Vec
+                        ? plan.max_iterations()
+                        : 1;
+  return pg.num_nodes() * plan.number_of_walks() * passes;
+}
+
+katana::Result<uint64_t>
+katana::analytics::RandomWalks(
+    PropertyGraph* pg, uint32_t* walks, uint64_t capacity,
+    RandomWalksPlan plan) {
+  uint64_t max_walks = RandomWalksMaxWalks(*pg, plan);
+  if (capacity < max_walks) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "walk buffer holds {} walks but up to {} may be generated", capacity,
+        max_walks);
   }
+
+  uint32_t* begin = walks;
+  WalkOutput output{
+      plan.walk_stride(), walks, std::max(pg->num_nodes(), uint64_t{1}),
+      [&](uint32_t* buffer, uint64_t num_walks) -> Result<uint32_t*> {
+        return buffer + num_walks * plan.walk_stride();
+      }};
+  KATANA_CHECKED(RandomWalksImpl(pg, "", plan, &output));
+  return (output.buffer - begin) / plan.walk_stride();
+}
+
+katana::Result<void>
+katana::analytics::RandomWalks(
+    PropertyGraph* pg, const RandomWalksSink& sink, uint64_t chunk_size,
+    RandomWalksPlan plan) {
+  return RandomWalks(pg, "", sink, chunk_size, plan);
+}
+
+katana::Result<void>
+katana::analytics::RandomWalks(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const RandomWalksSink& sink, uint64_t chunk_size, RandomWalksPlan plan) {
+  if (chunk_size == 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "chunk size must be positive");
+  }
+
+  katana::NUMAArray<uint32_t> buffer;
+  buffer.allocateInterleaved(chunk_size * plan.walk_stride());
+  WalkOutput output{
+      plan.walk_stride(), buffer.data(), chunk_size,
+      [&](uint32_t* buffer, uint64_t num_walks) -> Result<uint32_t*> {
+        if (num_walks > 0) {
+          KATANA_CHECKED(sink(buffer, num_walks));
+        }
+        return buffer;
+      }};
+  return RandomWalksImpl(pg, edge_weight_property_name, plan, &output);
+}
+
+katana::Result<void>
+katana::analytics::TimeWindowRandomWalks(
+    PropertyGraph* pg, const std::string& timestamp_property_name,
+    const TimeWindow& window, const RandomWalksSink& sink, uint64_t chunk_size,
+    RandomWalksPlan plan) {
+  if (chunk_size == 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "chunk size must be positive");
+  }
+  if (plan.algorithm() != RandomWalksPlan::kNode2Vec) {
+    return KATANA_ERROR(
+        ErrorCode::NotImplemented,
+        "time window random walks only support Node2Vec");
+  }
+  auto index =
+      KATANA_CHECKED(pg->GetTemporalEdgeIndex(timestamp_property_name));
+  TimeWindowNode2VecAlgo algo(*index, window, plan);
+
+  katana::NUMAArray<uint32_t> buffer;
+  buffer.allocateInterleaved(chunk_size * plan.walk_stride());
+  WalkOutput output{
+      plan.walk_stride(), buffer.data(), chunk_size,
+      [&](uint32_t* buffer, uint64_t num_walks) -> Result<uint32_t*> {
+        if (num_walks > 0) {
+          KATANA_CHECKED(sink(buffer, num_walks));
+        }
+        return buffer;
+      }};
+
+  katana::PerThreadStorage<std::vector<uint32_t>> walks_local;
+
+  katana::StatTimer execTime("TimeWindowRandomWalks");
+  katana::TimerGuard exec_time_guard(execTime);
+  return GenerateWalks(
+      index->num_nodes(), plan,
+      [&](uint32_t n, katana::CounterRng* generator, uint32_t* walk) {
+        return algo.Walk(n, generator, walk);
+      },
+      kRandomWalksSeed, &walks_local, &output);
+}
+
+katana::Result<std::vector<std::vector<uint32_t>>>
+katana::analytics::RandomWalks(PropertyGraph* pg, RandomWalksPlan plan) {
+  uint32_t stride = plan.walk_stride();
+  std::vector<std::vector<uint32_t>> walks_in_vector;
+  KATANA_CHECKED(RandomWalks(
+      pg,
+      [&](const uint32_t* walks, uint64_t num_walks) -> Result<void> {
+        for (uint64_t i = 0; i < num_walks; ++i) {
+          const uint32_t* walk = walks + i * stride;
+          walks_in_vector.emplace_back(
+              walk, std::find(walk, walk + stride, kRandomWalkPadding));
+        }
+        return katana::ResultSuccess();
+      },
+      kRandomWalksDefaultChunkSize, plan));
+  return walks_in_vector;
+}
+
+katana::analytics::RandomWalksSink
+katana::analytics::MakeRandomWalksRecordBatchSink(
+    uint32_t walk_stride,
+    std::function<Result<void>(const std::shared_ptr<arrow::RecordBatch>&)>
+        batch_sink) {
+  return [walk_stride, batch_sink = std::move(batch_sink)](
+             const uint32_t* walks, uint64_t num_walks) -> Result<void> {
+    uint64_t num_ids = num_walks * walk_stride;
+    auto values = std::make_shared<arrow::UInt32Array>(
+        num_ids, arrow::Buffer::Wrap(walks, num_ids));
+    auto list_result =
+        arrow::FixedSizeListArray::FromArrays(values, walk_stride);
+    if (!list_result.ok()) {
+      return KATANA_ERROR(
+          ErrorCode::ArrowError, "making walk list array: {}",
+          list_result.status().ToString());
+    }
+    std::shared_ptr<arrow::Array> list = list_result.ValueOrDie();
+    auto batch = arrow::RecordBatch::Make(
+        arrow::schema({arrow::field("walk", list->type())}), num_walks,
+        {list});
+    return batch_sink(batch);
+  };
 }
 
 /// \cond DO_NOT_DOCUMENT
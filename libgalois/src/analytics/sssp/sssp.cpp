@@ -19,10 +19,23 @@
 
 #include "katana/analytics/sssp/sssp.h"
 
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <queue>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 #include "katana/Reduction.h"
 #include "katana/Statistics.h"
 #include "katana/TypedPropertyGraph.h"
 #include "katana/analytics/BfsSsspImplementationBase.h"
+#include "katana/analytics/NarrowEdgeWeights.h"
 #include "katana/gstl.h"
 
 using namespace katana::analytics;
@@ -69,11 +82,14 @@ struct SsspImplementation : public katana::analytics::BfsSsspImplementationBase<
   using OBIM = katana::OrderedByIntegerMetric<UpdateRequestIndexer, PSchunk>;
   using OBIMBarrier = typename katana::OrderedByIntegerMetric<
       UpdateRequestIndexer, PSchunk>::template with_barrier<true>::type;
+  using MultiQueue = katana::MultiQueue<>;
 
-  template <typename T, typename OBIMTy = OBIM, typename P, typename R>
+  template <
+      typename T, typename OBIMTy = OBIM, typename EdgeWeights, typename P,
+      typename R>
   static void DeltaStepAlgo(
       katana::NUMAArray<std::atomic<Weight>>* node_data,
-      katana::NUMAArray<Weight>* edge_data, Graph* graph,
+      EdgeWeights* edge_data, Graph* graph,
       const typename Graph::Node& source, const P& pushWrap, const R& edgeRange,
       unsigned stepShift) {
     //! [reducible for self-defined stats]
@@ -84,38 +100,47 @@ struct SsspImplementation : public katana::analytics::BfsSsspImplementationBase<
     katana::InsertBag<T> init_bag;
     pushWrap(init_bag, source, 0, "parallel");
 
-    katana::for_each(
-        katana::iterate(init_bag),
-        [&](const T& item, auto& ctx) {
-          const auto& sdata = (*node_data)[item.src];
+    auto relax = [&](const T& item, auto& ctx) {
+      const auto& sdata = (*node_data)[item.src];
 
-          if (sdata < item.dist) {
-            if (kTrackWork) {
-              WLEmptyWork += 1;
-            }
-            return;
-          }
+      if (sdata < item.dist) {
+        if (kTrackWork) {
+          WLEmptyWork += 1;
+        }
+        return;
+      }
 
-          for (auto ii : edgeRange(item)) {
-            auto dest = graph->GetEdgeDest(ii);
-            auto& ddist = (*node_data)[*dest];
-            Dist ew = (*edge_data)[ii];
-            Dist new_dist = sdata + ew;
-            Dist old_dist = katana::atomicMin(ddist, new_dist);
-            if (new_dist < old_dist) {
-              if (kTrackWork) {
-                //! [per-thread contribution of self-defined stats]
-                if (old_dist != kDistanceInfinity) {
-                  BadWork += 1;
-                }
-                //! [per-thread contribution of self-defined stats]
-              }
-              pushWrap(ctx, *dest, new_dist);
+      for (auto ii : edgeRange(item)) {
+        auto dest = graph->GetEdgeDest(ii);
+        auto& ddist = (*node_data)[*dest];
+        Dist ew = (*edge_data)[ii];
+        Dist new_dist = sdata + ew;
+        Dist old_dist = katana::atomicMin(ddist, new_dist);
+        if (new_dist < old_dist) {
+          if (kTrackWork) {
+            //! [per-thread contribution of self-defined stats]
+            if (old_dist != kDistanceInfinity) {
+              BadWork += 1;
             }
+            //! [per-thread contribution of self-defined stats]
           }
-        },
-        katana::wl<OBIMTy>(UpdateRequestIndexer{stepShift}),
-        katana::disable_conflict_detection(), katana::loopname("SSSP"));
+          pushWrap(ctx, *dest, new_dist);
+        }
+      }
+    };
+
+    // MultiQueue orders items by UpdateRequest::operator< and needs no
+    // indexer
+    if constexpr (std::is_same_v<OBIMTy, MultiQueue>) {
+      katana::for_each(
+          katana::iterate(init_bag), relax, katana::wl<OBIMTy>(),
+          katana::disable_conflict_detection(), katana::loopname("SSSP"));
+    } else {
+      katana::for_each(
+          katana::iterate(init_bag), relax,
+          katana::wl<OBIMTy>(UpdateRequestIndexer{stepShift}),
+          katana::disable_conflict_detection(), katana::loopname("SSSP"));
+    }
 
     if (kTrackWork) {
       //! [report self-defined stats]
@@ -125,9 +150,10 @@ struct SsspImplementation : public katana::analytics::BfsSsspImplementationBase<
     }
   }
 
+  template <typename EdgeWeights>
   static void DeltaStepFusionAlgo(
       katana::NUMAArray<std::atomic<Weight>>* node_data,
-      katana::NUMAArray<Weight>* edge_data, Graph* graph,
+      EdgeWeights* edge_data, Graph* graph,
       const typename Graph::Node& source, unsigned stepShift) {
     constexpr size_t kMaxFusion = 1000;
 
@@ -225,6 +251,155 @@ struct SsspImplementation : public katana::analytics::BfsSsspImplementationBase<
     }
   }
 
+  // The delta steps that EstimateDeltaShift and DeltaStepAdaptiveAlgo may
+  // pick, as powers of two. Integral distances cannot use fractional steps.
+  static constexpr int kMinAdaptiveShift =
+      std::is_integral_v<Dist> ? 0 : std::numeric_limits<Dist>::min_exponent;
+  static constexpr int kMaxAdaptiveShift =
+      std::is_integral_v<Dist> ? std::numeric_limits<Dist>::digits - 3
+                               : std::numeric_limits<Dist>::max_exponent - 3;
+
+  /// Meyer and Sanders show that a delta of about max weight / degree is
+  /// work efficient for uniformly random weights. Estimate it as
+  /// 2 * mean weight / average degree from a sample of the edges, rounded to
+  /// a power of two.
+  template <typename EdgeWeights>
+  static int EstimateDeltaShift(
+      const Graph& graph, const EdgeWeights& edge_data) {
+    constexpr uint64_t kSampleEdges = 1 << 12;
+
+    uint64_t num_edges = graph.num_edges();
+    if (num_edges == 0) {
+      return kMinAdaptiveShift;
+    }
+    uint64_t stride = std::max<uint64_t>(1, num_edges / kSampleEdges);
+    double sum = 0;
+    uint64_t samples = 0;
+    for (uint64_t e = 0; e < num_edges; e += stride) {
+      sum += static_cast<double>(edge_data[e]);
+      ++samples;
+    }
+    double average_degree = static_cast<double>(num_edges) / graph.size();
+    double delta = 2 * (sum / samples) / std::max(1.0, average_degree);
+    if (!(delta > 0)) {
+      return kMinAdaptiveShift;
+    }
+    return std::clamp(
+        static_cast<int>(std::lround(std::log2(delta))), kMinAdaptiveShift,
+        kMaxAdaptiveShift);
+  }
+
+  /// Delta stepping where delta is estimated before the run and adjusted
+  /// between rounds. A round relaxes, asynchronously, every pending node
+  /// whose distance is below low + delta, where low is the smallest pending
+  /// distance, and defers the others. Nodes that enter the current bucket
+  /// are relaxed in the same loop without a barrier, i.e., buckets are
+  /// fused, and empty buckets are skipped because rounds start at low.
+  ///
+  /// After each round, delta doubles if the round relaxed too few nodes to
+  /// keep the threads busy and halves if too many of its relaxations were
+  /// wasted, i.e., improved a distance that was already finite.
+  template <typename EdgeWeights>
+  static void DeltaStepAdaptiveAlgo(
+      katana::NUMAArray<std::atomic<Weight>>* node_data,
+      EdgeWeights* edge_data, Graph* graph,
+      const typename Graph::Node& source) {
+    // The wasted relaxations a round may make per relaxed node before delta
+    // shrinks
+    constexpr double kMaxWastedRatio = 0.25;
+
+    const size_t min_round_work = katana::getActiveThreads() * kChunkSize;
+
+    int shift = EstimateDeltaShift(*graph, *edge_data);
+    katana::ReportStatSingle("SSSP", "InitialDeltaShift", shift);
+
+    katana::InsertBag<UpdateRequest> pending;
+    katana::InsertBag<UpdateRequest> deferred;
+    pending.push(UpdateRequest{source, 0});
+
+    katana::GAccumulator<size_t> relaxed;
+    katana::GAccumulator<size_t> wasted;
+    katana::GReduceMin<Dist> deferred_low;
+
+    size_t total_wasted = 0;
+    Dist low = 0;
+    size_t rounds = 0;
+
+    while (true) {
+      ++rounds;
+      relaxed.reset();
+      wasted.reset();
+      deferred_low.reset();
+
+      Dist delta;
+      if constexpr (std::is_integral_v<Dist>) {
+        delta = Dist{1} << shift;
+      } else {
+        delta = std::ldexp(Dist{1}, shift);
+      }
+      Dist bound = delta < kDistanceInfinity - low ? low + delta
+                                                   : kDistanceInfinity;
+
+      auto defer = [&](const typename Graph::Node& n, Dist dist) {
+        deferred.push(UpdateRequest{n, dist});
+        deferred_low.update(dist);
+      };
+
+      katana::for_each(
+          katana::iterate(pending),
+          [&](const UpdateRequest& item, auto& ctx) {
+            Dist sdist = (*node_data)[item.src];
+            if (sdist < item.dist) {
+              return;
+            }
+            if (sdist >= bound) {
+              defer(item.src, sdist);
+              return;
+            }
+            relaxed += 1;
+
+            for (auto ii : graph->edges(item.src)) {
+              auto dest = graph->GetEdgeDest(ii);
+              Dist new_dist = sdist + (*edge_data)[ii];
+              Dist old_dist = katana::atomicMin((*node_data)[*dest], new_dist);
+              if (new_dist < old_dist) {
+                if (old_dist != kDistanceInfinity) {
+                  wasted += 1;
+                }
+                if (new_dist < bound) {
+                  ctx.push(UpdateRequest{*dest, new_dist});
+                } else {
+                  defer(*dest, new_dist);
+                }
+              }
+            }
+          },
+          katana::wl<PSchunk>(), katana::disable_conflict_detection(),
+          katana::loopname("SSSP"));
+
+      pending.clear();
+      pending.swap(deferred);
+
+      total_wasted += wasted.reduce();
+      low = deferred_low.reduce();
+      if (low == std::numeric_limits<Dist>::max()) {
+        break;
+      }
+
+      size_t round_relaxed = relaxed.reduce();
+      size_t round_wasted = wasted.reduce();
+      if (round_relaxed < min_round_work) {
+        shift = std::min(shift + 1, kMaxAdaptiveShift);
+      } else if (round_wasted > kMaxWastedRatio * round_relaxed) {
+        shift = std::max(shift - 1, kMinAdaptiveShift);
+      }
+    }
+
+    katana::ReportStatSingle("SSSP", "rounds", rounds);
+    katana::ReportStatSingle("SSSP", "FinalDeltaShift", shift);
+    katana::ReportStatSingle("SSSP", "WastedRelaxations", total_wasted);
+  }
+
   template <typename T, typename P, typename R>
   static void SerDeltaAlgo(
       Graph* graph, const typename Graph::Node& source, const P& pushWrap,
@@ -401,7 +576,9 @@ struct SsspImplementation : public katana::analytics::BfsSsspImplementationBase<
   }
 
 public:
-  katana::Result<void> SSSP(Graph& graph, size_t start_node, SsspPlan plan) {
+  katana::Result<void> SSSP(
+      Graph& graph, size_t start_node, SsspPlan plan,
+      katana::analytics::AnalyticsContext* context) {
     if (start_node >= graph.size()) {
       return katana::ErrorCode::InvalidArgument;
     }
@@ -414,22 +591,37 @@ public:
     katana::EnsurePreallocated(1, approxNodeData);
     katana::ReportPageAllocGuard page_alloc;
 
-    katana::NUMAArray<std::atomic<Weight>> node_data;
-    katana::NUMAArray<Weight> edge_data;
-    bool use_block = false;
-    if (use_block) {
-      node_data.allocateBlocked(graph.size());
-      edge_data.allocateBlocked(graph.num_edges());
-    } else {
-      node_data.allocateInterleaved(graph.size());
-      edge_data.allocateInterleaved(graph.num_edges());
+    katana::NUMAArray<std::atomic<Weight>> local_node_data;
+    auto& node_data = *katana::analytics::ScratchArray(
+        context, "SsspDistance", graph.size(), &local_node_data);
+
+    // The kernels that scan an array of the weights read them packed into 8
+    // or 16 bits when that changes them by no more than the plan allows
+    auto narrow_weights = katana::analytics::NarrowEdgeWeights<Weight>::Make(
+        graph.num_edges(),
+        [&](typename Graph::Edge e) -> Weight {
+          return graph.template GetEdgeData<EdgeWeight>(e);
+        },
+        plan.edge_weight_tolerance());
+    const bool packed = narrow_weights.width() > 0;
+    katana::ReportStatSingle(
+        "SSSP", "EdgeWeightBits",
+        packed ? narrow_weights.width() : sizeof(Weight) * CHAR_BIT);
+
+    katana::NUMAArray<Weight> local_edge_data;
+    katana::NUMAArray<Weight>* full_edge_data = &local_edge_data;
+    if (!packed) {
+      full_edge_data = katana::analytics::ScratchArray(
+          context, "SsspEdgeWeight", graph.num_edges(), &local_edge_data);
     }
 
     katana::do_all(katana::iterate(graph), [&](const typename Graph::Node& n) {
       graph.template GetData<NodeDistance>(n) = kDistanceInfinity;
       node_data[n] = kDistanceInfinity;
-      for (auto e : graph.edges(n)) {
-        edge_data[e] = graph.template GetEdgeData<EdgeWeight>(e);
+      if (!packed) {
+        for (auto e : graph.edges(n)) {
+          (*full_edge_data)[e] = graph.template GetEdgeData<EdgeWeight>(e);
+        }
       }
     });
 
@@ -439,57 +631,81 @@ public:
     katana::StatTimer execTime("SSSP");
     execTime.start();
 
-    if (plan.algorithm() == SsspPlan::kAutomatic) {
-      plan = SsspPlan(&graph.GetPropertyGraph());
-    }
+    auto run = [&](auto* edge_data) -> katana::Result<void> {
+      if (plan.algorithm() == SsspPlan::kAutomatic) {
+        // The profile of the graph picks the algorithm and the weights pick
+        // delta; bucket indices are computed with int shifts
+        SsspPlan chosen(&graph.GetPropertyGraph());
+        unsigned delta =
+            std::clamp(EstimateDeltaShift(graph, *edge_data), 0, 30);
+        plan = chosen.algorithm() == SsspPlan::kDeltaStep
+                   ? SsspPlan::DeltaStep(delta)
+                   : SsspPlan::DeltaStepBarrier(delta);
+        katana::ReportStatSingle("SSSP", "AutomaticDeltaShift", delta);
+      }
 
-    switch (plan.algorithm()) {
-    case SsspPlan::kDeltaTile:
-      DeltaStepAlgo<SrcEdgeTile>(
-          &node_data, &edge_data, &graph, source,
-          SrcEdgeTilePushWrap{&graph, *this}, TileRangeFn(), plan.delta());
-      break;
-    case SsspPlan::kDeltaStep:
-      DeltaStepAlgo<UpdateRequest>(
-          &node_data, &edge_data, &graph, source, ReqPushWrap(),
-          OutEdgeRangeFn{&graph}, plan.delta());
-      break;
-    case SsspPlan::kDeltaStepBarrier:
-      DeltaStepAlgo<UpdateRequest, OBIMBarrier>(
-          &node_data, &edge_data, &graph, source, ReqPushWrap(),
-          OutEdgeRangeFn{&graph}, plan.delta());
-      break;
-    case SsspPlan::kDeltaStepFusion:
-      DeltaStepFusionAlgo(&node_data, &edge_data, &graph, source, plan.delta());
-      break;
-    case SsspPlan::kSerialDeltaTile:
-      SerDeltaAlgo<SrcEdgeTile>(
-          &graph, source, SrcEdgeTilePushWrap{&graph, *this}, TileRangeFn(),
-          plan.delta());
-      break;
-    case SsspPlan::kSerialDelta:
-      SerDeltaAlgo<UpdateRequest>(
-          &graph, source, ReqPushWrap(), OutEdgeRangeFn{&graph}, plan.delta());
-      break;
-    case SsspPlan::kDijkstraTile:
-      DijkstraAlgo<SrcEdgeTile>(
-          &graph, source, SrcEdgeTilePushWrap{&graph, *this}, TileRangeFn());
-      break;
-    case SsspPlan::kDijkstra:
-      DijkstraAlgo<UpdateRequest>(
-          &graph, source, ReqPushWrap(), OutEdgeRangeFn{&graph});
-      break;
-    case SsspPlan::kTopological:
-      TopoAlgo(&graph, source);
-      break;
-    case SsspPlan::kTopologicalTile:
-      TopoTileAlgo(&graph, source);
-      break;
-    default:
-      return katana::ErrorCode::InvalidArgument;
-    }
+      switch (plan.algorithm()) {
+      case SsspPlan::kDeltaTile:
+        DeltaStepAlgo<SrcEdgeTile>(
+            &node_data, edge_data, &graph, source,
+            SrcEdgeTilePushWrap{&graph, *this}, TileRangeFn(), plan.delta());
+        break;
+      case SsspPlan::kDeltaStep:
+        DeltaStepAlgo<UpdateRequest>(
+            &node_data, edge_data, &graph, source, ReqPushWrap(),
+            OutEdgeRangeFn{&graph}, plan.delta());
+        break;
+      case SsspPlan::kDeltaStepBarrier:
+        DeltaStepAlgo<UpdateRequest, OBIMBarrier>(
+            &node_data, edge_data, &graph, source, ReqPushWrap(),
+            OutEdgeRangeFn{&graph}, plan.delta());
+        break;
+      case SsspPlan::kDeltaStepFusion:
+        DeltaStepFusionAlgo(
+            &node_data, edge_data, &graph, source, plan.delta());
+        break;
+      case SsspPlan::kDeltaStepAdaptive:
+        DeltaStepAdaptiveAlgo(&node_data, edge_data, &graph, source);
+        break;
+      case SsspPlan::kMultiQueue:
+        DeltaStepAlgo<UpdateRequest, MultiQueue>(
+            &node_data, edge_data, &graph, source, ReqPushWrap(),
+            OutEdgeRangeFn{&graph}, plan.delta());
+        break;
+      case SsspPlan::kSerialDeltaTile:
+        SerDeltaAlgo<SrcEdgeTile>(
+            &graph, source, SrcEdgeTilePushWrap{&graph, *this}, TileRangeFn(),
+            plan.delta());
+        break;
+      case SsspPlan::kSerialDelta:
+        SerDeltaAlgo<UpdateRequest>(
+            &graph, source, ReqPushWrap(), OutEdgeRangeFn{&graph},
+            plan.delta());
+        break;
+      case SsspPlan::kDijkstraTile:
+        DijkstraAlgo<SrcEdgeTile>(
+            &graph, source, SrcEdgeTilePushWrap{&graph, *this}, TileRangeFn());
+        break;
+      case SsspPlan::kDijkstra:
+        DijkstraAlgo<UpdateRequest>(
+            &graph, source, ReqPushWrap(), OutEdgeRangeFn{&graph});
+        break;
+      case SsspPlan::kTopological:
+        TopoAlgo(&graph, source);
+        break;
+      case SsspPlan::kTopologicalTile:
+        TopoTileAlgo(&graph, source);
+        break;
+      default:
+        return katana::ErrorCode::InvalidArgument;
+      }
+      return katana::ResultSuccess();
+    };
+    KATANA_CHECKED(narrow_weights.Visit(full_edge_data, run));
 
     execTime.stop();
+    // The worklist algorithms have no rounds to stop between
+    KATANA_CHECKED(katana::analytics::CheckCancelled(context));
 
     katana::do_all(katana::iterate(graph), [&](const typename Graph::Node& n) {
       graph.template GetData<NodeDistance>(n) = node_data[n].load();
@@ -505,10 +721,11 @@ Sssp(
     katana::TypedPropertyGraph<
         std::tuple<SsspNodeDistance<Weight>>,
         std::tuple<SsspEdgeWeight<Weight>>>& pg,
-    size_t start_node, SsspPlan plan) {
+    size_t start_node, SsspPlan plan,
+    katana::analytics::AnalyticsContext* context) {
   static_assert(std::is_integral_v<Weight> || std::is_floating_point_v<Weight>);
   SsspImplementation<Weight> impl{{plan.edge_tile_size()}};
-  return impl.SSSP(pg, start_node, plan);
+  return impl.SSSP(pg, start_node, plan, context);
 }
 
 template <typename Weight>
@@ -516,7 +733,8 @@ static katana::Result<void>
 SSSPWithWrap(
     katana::PropertyGraph* pg, size_t start_node,
     const std::string& edge_weight_property_name,
-    const std::string& output_property_name, SsspPlan plan) {
+    const std::string& output_property_name, SsspPlan plan,
+    katana::analytics::AnalyticsContext* context) {
   if (auto r = ConstructNodeProperties<std::tuple<SsspNodeDistance<Weight>>>(
           pg, {output_property_name});
       !r) {
@@ -537,7 +755,11 @@ SSSPWithWrap(
     return graph.error();
   }
 
-  return Sssp(graph.value(), start_node, plan);
+  auto res = Sssp(graph.value(), start_node, plan, context);
+  if (!res && res.error() == katana::ErrorCode::Cancelled) {
+    KATANA_CHECKED(pg->RemoveNodeProperty(output_property_name));
+  }
+  return res;
 }
 
 }  // namespace
@@ -546,35 +768,20 @@ katana::Result<void>
 katana::analytics::Sssp(
     PropertyGraph* pg, size_t start_node,
     const std::string& edge_weight_property_name,
-    const std::string& output_property_name, SsspPlan plan) {
-  switch (KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
-              ->type()
-              ->id()) {
-  case arrow::UInt32Type::type_id:
-    return SSSPWithWrap<uint32_t>(
-        pg, start_node, edge_weight_property_name, output_property_name, plan);
-  case arrow::Int32Type::type_id:
-    return SSSPWithWrap<int32_t>(
-        pg, start_node, edge_weight_property_name, output_property_name, plan);
-  case arrow::UInt64Type::type_id:
-    return SSSPWithWrap<uint64_t>(
-        pg, start_node, edge_weight_property_name, output_property_name, plan);
-  case arrow::Int64Type::type_id:
-    return SSSPWithWrap<int64_t>(
-        pg, start_node, edge_weight_property_name, output_property_name, plan);
-  case arrow::FloatType::type_id:
-    return SSSPWithWrap<float>(
-        pg, start_node, edge_weight_property_name, output_property_name, plan);
-  case arrow::DoubleType::type_id:
-    return SSSPWithWrap<double>(
-        pg, start_node, edge_weight_property_name, output_property_name, plan);
-  default:
-    return KATANA_ERROR(
-        katana::ErrorCode::TypeError, "Unsupported type: {}",
-        KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
-            ->type()
-            ->ToString());
-  }
+    const std::string& output_property_name, SsspPlan plan,
+    AnalyticsContext* context) {
+  KATANA_CHECKED(CheckArchitecture(plan));
+  auto profile = ProfileParallelism(plan);
+
+  // The weights are not read until the output property and the views are
+  // built, so start loading them now if they are absent
+  KATANA_CHECKED(pg->PrefetchEdgeProperties({edge_weight_property_name}));
+  return DispatchOnEdgePropertyType(
+      pg, edge_weight_property_name, [&](auto tag) {
+        return SSSPWithWrap<decltype(tag)>(
+            pg, start_node, edge_weight_property_name, output_property_name,
+            plan, context);
+      });
 }
 
 namespace {
@@ -618,33 +825,10 @@ katana::analytics::SsspAssertValid(
     katana::PropertyGraph* pg, size_t start_node,
     const std::string& edge_weight_property_name,
     const std::string& output_property_name) {
-  switch (
-      KATANA_CHECKED(pg->GetNodeProperty(output_property_name))->type()->id()) {
-  case arrow::UInt32Type::type_id:
-    return SsspValidateImpl<uint32_t>(
-        pg, start_node, edge_weight_property_name, output_property_name);
-  case arrow::Int32Type::type_id:
-    return SsspValidateImpl<int32_t>(
-        pg, start_node, edge_weight_property_name, output_property_name);
-  case arrow::UInt64Type::type_id:
-    return SsspValidateImpl<uint64_t>(
-        pg, start_node, edge_weight_property_name, output_property_name);
-  case arrow::Int64Type::type_id:
-    return SsspValidateImpl<int64_t>(
-        pg, start_node, edge_weight_property_name, output_property_name);
-  case arrow::FloatType::type_id:
-    return SsspValidateImpl<float>(
+  return DispatchOnNodePropertyType(pg, output_property_name, [&](auto tag) {
+    return SsspValidateImpl<decltype(tag)>(
         pg, start_node, edge_weight_property_name, output_property_name);
-  case arrow::DoubleType::type_id:
-    return SsspValidateImpl<double>(
-        pg, start_node, edge_weight_property_name, output_property_name);
-  default:
-    return KATANA_ERROR(
-        katana::ErrorCode::TypeError, "Unsupported type: {}",
-        KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
-            ->type()
-            ->ToString());
-  }
+  });
 }
 
 namespace {
@@ -691,27 +875,9 @@ ComputeStatistics(
 katana::Result<SsspStatistics>
 SsspStatistics::Compute(
     PropertyGraph* pg, const std::string& output_property_name) {
-  switch (
-      KATANA_CHECKED(pg->GetNodeProperty(output_property_name))->type()->id()) {
-  case arrow::UInt32Type::type_id:
-    return ComputeStatistics<uint32_t>(pg, output_property_name);
-  case arrow::Int32Type::type_id:
-    return ComputeStatistics<int32_t>(pg, output_property_name);
-  case arrow::UInt64Type::type_id:
-    return ComputeStatistics<uint64_t>(pg, output_property_name);
-  case arrow::Int64Type::type_id:
-    return ComputeStatistics<int64_t>(pg, output_property_name);
-  case arrow::FloatType::type_id:
-    return ComputeStatistics<float>(pg, output_property_name);
-  case arrow::DoubleType::type_id:
-    return ComputeStatistics<double>(pg, output_property_name);
-  default:
-    return KATANA_ERROR(
-        katana::ErrorCode::TypeError, "Unsupported type: {}",
-        KATANA_CHECKED(pg->GetEdgeProperty(output_property_name))
-            ->type()
-            ->ToString());
-  }
+  return DispatchOnNodePropertyType(pg, output_property_name, [&](auto tag) {
+    return ComputeStatistics<decltype(tag)>(pg, output_property_name);
+  });
 }
 
 void
@@ -720,3 +886,178 @@ SsspStatistics::Print(std::ostream& os) const {
   os << "Maximum distance = " << max_distance << std::endl;
   os << "Average distance = " << average_visited_distance << std::endl;
 }
+
+namespace {
+
+/// One side of a bidirectional Dijkstra search: tentative distances from the
+/// side's root, the node each node was reached from, and the queue of nodes
+/// to settle
+template <typename Dist>
+struct PathSearchSide {
+  using Node = uint32_t;
+  struct Visit {
+    Node from;
+    Dist dist;
+  };
+  using QueueItem = std::pair<Dist, Node>;
+
+  std::unordered_map<Node, Visit> visited;
+  std::priority_queue<
+      QueueItem, std::vector<QueueItem>, std::greater<QueueItem>>
+      queue;
+
+  explicit PathSearchSide(Node root) {
+    visited.emplace(root, Visit{root, 0});
+    queue.emplace(0, root);
+  }
+
+  /// Drop queue entries that were improved after they were pushed
+  void SkipStale() {
+    while (!queue.empty() &&
+           queue.top().first > visited.at(queue.top().second).dist) {
+      queue.pop();
+    }
+  }
+
+  void AppendPathToRoot(Node node, std::vector<Node>* path) const {
+    for (;;) {
+      path->emplace_back(node);
+      Node from = visited.at(node).from;
+      if (from == node) {
+        return;
+      }
+      node = from;
+    }
+  }
+};
+
+/// Settle the closest node of side and relax the edges given by
+/// for_each_neighbor, updating best and meet if a shorter path through both
+/// sides appears. Settled nodes are final only if no edge can shorten a
+/// path, so a negative weight is an error as soon as its edge is relaxed.
+template <typename Dist, typename ForEachNeighbor>
+katana::Result<void>
+SettlePathSearchNode(
+    PathSearchSide<Dist>* side, const PathSearchSide<Dist>& other,
+    const ForEachNeighbor& for_each_neighbor, Dist* best,
+    std::optional<uint32_t>* meet) {
+  auto [dist, u] = side->queue.top();
+  side->queue.pop();
+  bool negative = false;
+  for_each_neighbor(u, [&](uint32_t v, auto weight) {
+    if (negative) {
+      return;
+    }
+    if constexpr (std::is_signed_v<decltype(weight)>) {
+      if (weight < 0) {
+        negative = true;
+        return;
+      }
+    }
+    Dist new_dist = dist + static_cast<Dist>(weight);
+    auto [it, inserted] = side->visited.try_emplace(
+        v, typename PathSearchSide<Dist>::Visit{u, new_dist});
+    if (!inserted) {
+      if (new_dist >= it->second.dist) {
+        return;
+      }
+      it->second = {u, new_dist};
+    }
+    side->queue.emplace(new_dist, v);
+    if (auto o = other.visited.find(v);
+        o != other.visited.end() && new_dist + o->second.dist < *best) {
+      *best = new_dist + o->second.dist;
+      *meet = v;
+    }
+  });
+  if (negative) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "edge weights must not be negative; an edge of {} has one", u);
+  }
+  return katana::ResultSuccess();
+}
+
+template <typename Weight>
+katana::Result<SsspPath>
+BidirectionalDijkstra(
+    katana::PropertyGraph* pg, uint32_t source, uint32_t target,
+    const std::string& edge_weight_property_name) {
+  // Sum integer weights exactly
+  using Dist = std::conditional_t<
+      std::is_floating_point_v<Weight>, double,
+      std::conditional_t<std::is_signed_v<Weight>, int64_t, uint64_t>>;
+
+  auto weights = KATANA_CHECKED(
+      pg->GetEdgePropertyTyped<Weight>(edge_weight_property_name));
+  auto view = pg->BuildView<katana::PropertyGraphViews::BiDirectional>();
+
+  SsspPath ret{{}, std::numeric_limits<double>::infinity()};
+  if (source == target) {
+    ret.nodes.emplace_back(source);
+    ret.distance = 0;
+    return ret;
+  }
+
+  PathSearchSide<Dist> forward(source);
+  PathSearchSide<Dist> backward(target);
+  auto out_neighbors = [&](uint32_t u, const auto& fn) {
+    for (auto e : view.edges(u)) {
+      fn(view.edge_dest(e), weights->Value(view.edge_property_index(e)));
+    }
+  };
+  auto in_neighbors = [&](uint32_t u, const auto& fn) {
+    for (auto e : view.in_edges(u)) {
+      fn(view.in_edge_dest(e), weights->Value(view.in_edge_property_index(e)));
+    }
+  };
+
+  Dist best = std::numeric_limits<Dist>::max();
+  std::optional<uint32_t> meet;
+  for (;;) {
+    forward.SkipStale();
+    backward.SkipStale();
+    if (forward.queue.empty() || backward.queue.empty()) {
+      break;
+    }
+    // Every path not found yet is at least this long
+    if (meet &&
+        forward.queue.top().first + backward.queue.top().first >= best) {
+      break;
+    }
+    if (forward.queue.top().first <= backward.queue.top().first) {
+      KATANA_CHECKED(SettlePathSearchNode(
+          &forward, backward, out_neighbors, &best, &meet));
+    } else {
+      KATANA_CHECKED(SettlePathSearchNode(
+          &backward, forward, in_neighbors, &best, &meet));
+    }
+  }
+
+  if (meet) {
+    forward.AppendPathToRoot(*meet, &ret.nodes);
+    std::reverse(ret.nodes.begin(), ret.nodes.end());
+    ret.nodes.pop_back();
+    backward.AppendPathToRoot(*meet, &ret.nodes);
+    ret.distance = static_cast<double>(best);
+  }
+  return ret;
+}
+
+}  // namespace
+
+katana::Result<SsspPath>
+katana::analytics::SsspPointToPoint(
+    PropertyGraph* pg, uint32_t source, uint32_t target,
+    const std::string& edge_weight_property_name) {
+  if (source >= pg->num_nodes() || target >= pg->num_nodes()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "{} or {} is not a node", source,
+        target);
+  }
+  return DispatchOnEdgePropertyType(
+      pg, edge_weight_property_name, [&](auto tag) {
+        return BidirectionalDijkstra<decltype(tag)>(
+            pg, source, target, edge_weight_property_name);
+      });
+}
@@ -0,0 +1,583 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2020, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "katana/analytics/strongly_connected_components/strongly_connected_components.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "katana/AtomicHelpers.h"
+#include "katana/Bag.h"
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Reduction.h"
+#include "katana/Statistics.h"
+#include "katana/Timer.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+using View = katana::PropertyGraphViews::BiDirectional;
+
+constexpr uint32_t kNone = std::numeric_limits<uint32_t>::max();
+/// Returned by UniqueActive when there is more than one neighbor
+constexpr uint32_t kMany = kNone - 1;
+
+/// Bits of State::marks set by the searches of a forward-backward round
+constexpr uint8_t kForward = 1;
+constexpr uint8_t kBackward = 2;
+
+/// The state shared by the phases. Every node whose component is not known
+/// yet belongs to a subgraph, its color, and no component spans two
+/// subgraphs, so the phases only follow edges within a subgraph.
+struct State {
+  const View& view;
+  /// A node of the component of every node, or kNone if not known yet
+  katana::NUMAArray<std::atomic<uint32_t>> labels;
+  katana::NUMAArray<uint32_t> colors;
+  uint32_t num_colors{1};
+  /// The nodes whose component is not known, up to date after Compact
+  katana::InsertBag<Node> remaining;
+
+  explicit State(const View& v) : view(v) {
+    const uint64_t num_nodes = view.num_nodes();
+    labels.allocateBlocked(num_nodes);
+    colors.allocateBlocked(num_nodes);
+    katana::do_all(
+        katana::iterate(view.all_nodes()),
+        [&](Node n) {
+          labels[n].store(kNone, std::memory_order_relaxed);
+          colors[n] = 0;
+          remaining.push(n);
+        },
+        katana::no_stats());
+  }
+
+  bool Active(Node n, uint32_t color) const {
+    return labels[n].load(std::memory_order_relaxed) == kNone &&
+           colors[n] == color;
+  }
+
+  /// Set the component of n if not set yet; returns whether it was set
+  bool Claim(Node n, uint32_t label) {
+    uint32_t expected = kNone;
+    return labels[n].compare_exchange_strong(
+        expected, label, std::memory_order_relaxed);
+  }
+
+  void Compact() {
+    katana::InsertBag<Node> next;
+    katana::do_all(
+        katana::iterate(remaining),
+        [&](Node n) {
+          if (labels[n].load(std::memory_order_relaxed) == kNone) {
+            next.push(n);
+          }
+        },
+        katana::no_stats());
+    remaining.swap(next);
+  }
+};
+
+/// The only active neighbor of n other than n among dests of edges, kNone
+/// if there is none and kMany if there is more than one
+template <typename Edges, typename Dest>
+uint32_t
+UniqueActive(
+    const State& s, Node n, const Edges& edges, const Dest& dest) {
+  uint32_t color = s.colors[n];
+  uint32_t found = kNone;
+  for (auto e : edges) {
+    Node d = dest(e);
+    if (d == n || d == found || !s.Active(d, color)) {
+      continue;
+    }
+    if (found != kNone) {
+      return kMany;
+    }
+    found = d;
+  }
+  return found;
+}
+
+uint32_t
+UniqueActiveIn(const State& s, Node n) {
+  return UniqueActive(s, n, s.view.in_edges(n), [&](auto e) {
+    return s.view.in_edge_dest(e);
+  });
+}
+
+uint32_t
+UniqueActiveOut(const State& s, Node n) {
+  return UniqueActive(
+      s, n, s.view.edges(n), [&](auto e) { return s.view.edge_dest(e); });
+}
+
+/// Make every node without active in- or out-neighbors its own component,
+/// which may let its neighbors go too
+void
+Trim1(State* s) {
+  katana::for_each(
+      katana::iterate(s->remaining),
+      [&](Node n, auto& ctx) {
+        if (UniqueActiveIn(*s, n) != kNone && UniqueActiveOut(*s, n) != kNone) {
+          return;
+        }
+        if (!s->Claim(n, n)) {
+          return;
+        }
+        uint32_t color = s->colors[n];
+        for (auto e : s->view.edges(n)) {
+          if (Node d = s->view.edge_dest(e); s->Active(d, color)) {
+            ctx.push(d);
+          }
+        }
+        for (auto e : s->view.in_edges(n)) {
+          if (Node d = s->view.in_edge_dest(e); s->Active(d, color)) {
+            ctx.push(d);
+          }
+        }
+      },
+      katana::disable_conflict_detection(),
+      katana::loopname("StronglyConnectedComponentsTrim1"));
+}
+
+/// Make every pair of nodes whose only active in-neighbors (or out-neighbors)
+/// are each other a component. Returns whether any pair was found.
+bool
+Trim2(State* s) {
+  katana::GReduceLogicalOr found;
+  katana::do_all(
+      katana::iterate(s->remaining),
+      [&](Node n) {
+        if (s->labels[n].load(std::memory_order_relaxed) != kNone) {
+          return;
+        }
+        for (auto unique : {UniqueActiveIn, UniqueActiveOut}) {
+          uint32_t m = unique(*s, n);
+          if (m < kMany && unique(*s, m) == n) {
+            // Both ends may find the pair; both label it the same
+            uint32_t label = std::min(n, m);
+            s->labels[n].store(label, std::memory_order_relaxed);
+            s->labels[m].store(label, std::memory_order_relaxed);
+            found.update(true);
+            return;
+          }
+        }
+      },
+      katana::steal(), katana::no_stats(),
+      katana::loopname("StronglyConnectedComponentsTrim2"));
+  return found.reduce();
+}
+
+void
+Trim(State* s, bool trim2) {
+  Trim1(s);
+  if (trim2 && Trim2(s)) {
+    Trim1(s);
+  }
+  s->Compact();
+}
+
+/// Mark with bit the nodes reached from sources through active nodes of the
+/// same color, following out-edges or in-edges
+template <bool kOut>
+void
+Reach(
+    State* s, const std::vector<Node>& sources,
+    katana::NUMAArray<std::atomic<uint8_t>>* marks, uint8_t bit) {
+  auto visit = [&](Node n, Node d, auto& ctx) {
+    if (s->Active(d, s->colors[n]) && !((*marks)[d].fetch_or(bit) & bit)) {
+      ctx.push(d);
+    }
+  };
+  katana::for_each(
+      katana::iterate(sources.begin(), sources.end()),
+      [&](Node n, auto& ctx) {
+        if constexpr (kOut) {
+          for (auto e : s->view.edges(n)) {
+            visit(n, s->view.edge_dest(e), ctx);
+          }
+        } else {
+          for (auto e : s->view.in_edges(n)) {
+            visit(n, s->view.in_edge_dest(e), ctx);
+          }
+        }
+      },
+      katana::disable_conflict_detection(),
+      katana::loopname("StronglyConnectedComponentsReach"));
+}
+
+/// One forward-backward step on every subgraph at once: the nodes reached
+/// both forward and backward from a pivot are its component, and the rest of
+/// the subgraph splits into the nodes reached only forward, only backward,
+/// or neither, which become new subgraphs
+void
+ForwardBackwardRound(State* s) {
+  const uint32_t num_colors = s->num_colors;
+
+  // The pivot of each subgraph is its node with the largest product of in-
+  // and out-degree, which likely belongs to a large component
+  katana::NUMAArray<std::atomic<uint64_t>> best;
+  best.allocateBlocked(num_colors);
+  katana::ParallelSTL::fill(best.begin(), best.end(), uint64_t{0});
+  katana::do_all(
+      katana::iterate(s->remaining),
+      [&](Node n) {
+        uint64_t score = std::min<uint64_t>(
+            (s->view.edges(n).size() + 1) * (s->view.in_edges(n).size() + 1),
+            kNone);
+        katana::atomicMax(best[s->colors[n]], (score << 32) | n);
+      },
+      katana::no_stats());
+
+  std::vector<Node> pivots;
+  katana::NUMAArray<std::atomic<uint8_t>> marks;
+  marks.allocateBlocked(s->view.num_nodes());
+  katana::ParallelSTL::fill(marks.begin(), marks.end(), uint8_t{0});
+  for (uint32_t c = 0; c < num_colors; ++c) {
+    uint64_t key = best[c].load(std::memory_order_relaxed);
+    if (key != 0) {
+      Node pivot = key & kNone;
+      pivots.emplace_back(pivot);
+      marks[pivot].store(kForward | kBackward, std::memory_order_relaxed);
+    }
+  }
+  Reach<true>(s, pivots, &marks, kForward);
+  Reach<false>(s, pivots, &marks, kBackward);
+
+  // New subgraphs are numbered densely by old color and kind
+  katana::NUMAArray<uint32_t> new_colors;
+  new_colors.allocateBlocked(uint64_t{num_colors} * 3 + 1);
+  katana::ParallelSTL::fill(new_colors.begin(), new_colors.end(), 0u);
+  katana::do_all(
+      katana::iterate(s->remaining),
+      [&](Node n) {
+        uint8_t mark = marks[n].load(std::memory_order_relaxed);
+        uint32_t color = s->colors[n];
+        if (mark == (kForward | kBackward)) {
+          s->labels[n].store(
+              best[color].load(std::memory_order_relaxed) & kNone,
+              std::memory_order_relaxed);
+        } else {
+          new_colors[uint64_t{color} * 3 + mark] = 1;
+        }
+      },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      new_colors.begin(), new_colors.end(), new_colors.begin());
+  katana::do_all(
+      katana::iterate(s->remaining),
+      [&](Node n) {
+        uint8_t mark = marks[n].load(std::memory_order_relaxed);
+        if (mark != (kForward | kBackward)) {
+          s->colors[n] = new_colors[uint64_t{s->colors[n]} * 3 + mark] - 1;
+        }
+      },
+      katana::no_stats());
+  s->num_colors = new_colors[uint64_t{num_colors} * 3];
+  s->Compact();
+}
+
+/// One coloring step: the largest node ID is propagated forward, and every
+/// node that keeps its own ID is the root of a component made of the nodes
+/// of its color that reach it
+void
+ColoringRound(State* s) {
+  katana::NUMAArray<std::atomic<uint32_t>> max_ids;
+  max_ids.allocateBlocked(s->view.num_nodes());
+  katana::do_all(
+      katana::iterate(s->remaining),
+      [&](Node n) { max_ids[n].store(n, std::memory_order_relaxed); },
+      katana::no_stats());
+
+  katana::for_each(
+      katana::iterate(s->remaining),
+      [&](Node n, auto& ctx) {
+        uint32_t id = max_ids[n].load(std::memory_order_relaxed);
+        uint32_t color = s->colors[n];
+        for (auto e : s->view.edges(n)) {
+          Node d = s->view.edge_dest(e);
+          if (s->Active(d, color) && katana::atomicMax(max_ids[d], id) < id) {
+            ctx.push(d);
+          }
+        }
+      },
+      katana::disable_conflict_detection(),
+      katana::loopname("StronglyConnectedComponentsColor"));
+
+  katana::InsertBag<Node> roots;
+  katana::do_all(
+      katana::iterate(s->remaining),
+      [&](Node n) {
+        if (max_ids[n].load(std::memory_order_relaxed) == n && s->Claim(n, n)) {
+          roots.push(n);
+        }
+      },
+      katana::no_stats());
+
+  katana::for_each(
+      katana::iterate(roots),
+      [&](Node n, auto& ctx) {
+        uint32_t id = max_ids[n].load(std::memory_order_relaxed);
+        uint32_t color = s->colors[n];
+        for (auto e : s->view.in_edges(n)) {
+          Node src = s->view.in_edge_dest(e);
+          if (s->colors[src] == color &&
+              max_ids[src].load(std::memory_order_relaxed) == id &&
+              s->Claim(src, id)) {
+            ctx.push(src);
+          }
+        }
+      },
+      katana::disable_conflict_detection(),
+      katana::loopname("StronglyConnectedComponentsColorBackward"));
+  s->Compact();
+}
+
+/// Number every component by its smallest node
+void
+WriteSmallestIDs(const State& s, uint32_t* output) {
+  const uint64_t num_nodes = s.view.num_nodes();
+  katana::NUMAArray<std::atomic<uint32_t>> smallest;
+  smallest.allocateBlocked(num_nodes);
+  katana::ParallelSTL::fill(smallest.begin(), smallest.end(), kNone);
+  katana::do_all(
+      katana::iterate(s.view.all_nodes()),
+      [&](Node n) {
+        katana::atomicMin(
+            smallest[s.labels[n].load(std::memory_order_relaxed)], n);
+      },
+      katana::no_stats());
+  katana::do_all(
+      katana::iterate(s.view.all_nodes()),
+      [&](Node n) {
+        output[n] = smallest[s.labels[n].load(std::memory_order_relaxed)].load(
+            std::memory_order_relaxed);
+      },
+      katana::no_stats());
+}
+
+/// Tarjan's algorithm, numbering every component by its smallest node
+std::vector<uint32_t>
+SerialComponents(const katana::GraphTopology& topology) {
+  const uint64_t num_nodes = topology.num_nodes();
+  std::vector<uint32_t> index(num_nodes, kNone);
+  std::vector<uint32_t> low(num_nodes);
+  std::vector<uint32_t> components(num_nodes, kNone);
+  std::vector<Node> stack;
+  struct Frame {
+    Node node;
+    Edge next;
+  };
+  std::vector<Frame> frames;
+  uint32_t counter = 0;
+
+  auto open = [&](Node n) {
+    index[n] = low[n] = counter++;
+    stack.emplace_back(n);
+    frames.emplace_back(Frame{n, *topology.edges(n).begin()});
+  };
+
+  for (Node root : topology.all_nodes()) {
+    if (index[root] != kNone) {
+      continue;
+    }
+    open(root);
+    while (!frames.empty()) {
+      Node n = frames.back().node;
+      if (frames.back().next < *topology.edges(n).end()) {
+        Node d = topology.edge_dest(frames.back().next++);
+        if (index[d] == kNone) {
+          open(d);
+        } else if (components[d] == kNone) {
+          // d is on the stack
+          low[n] = std::min(low[n], index[d]);
+        }
+        continue;
+      }
+      frames.pop_back();
+      if (!frames.empty()) {
+        Node parent = frames.back().node;
+        low[parent] = std::min(low[parent], low[n]);
+      }
+      if (low[n] == index[n]) {
+        auto begin = std::find(stack.rbegin(), stack.rend(), n).base() - 1;
+        Node smallest = *std::min_element(begin, stack.end());
+        for (auto it = begin; it != stack.end(); ++it) {
+          components[*it] = smallest;
+        }
+        stack.erase(begin, stack.end());
+      }
+    }
+  }
+  return components;
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::StronglyConnectedComponents(
+    PropertyGraph* pg, const std::string& output_property_name,
+    StronglyConnectedComponentsPlan plan) {
+  if (plan.algorithm() != StronglyConnectedComponentsPlan::kMultiStep &&
+      plan.algorithm() != StronglyConnectedComponentsPlan::kForwardBackward &&
+      plan.algorithm() != StronglyConnectedComponentsPlan::kColoring) {
+    return katana::ErrorCode::InvalidArgument;
+  }
+  const uint64_t num_nodes = pg->num_nodes();
+  std::shared_ptr<arrow::Buffer> buffer =
+      KATANA_CHECKED(arrow::AllocateBuffer(num_nodes * sizeof(uint32_t)));
+  auto* output = reinterpret_cast<uint32_t*>(buffer->mutable_data());
+
+  {
+    View view = pg->BuildView<View>();
+    katana::StatTimer exec_time("StronglyConnectedComponents");
+    exec_time.start();
+    State state(view);
+    Trim(&state, plan.trim2());
+
+    switch (plan.algorithm()) {
+    case StronglyConnectedComponentsPlan::kMultiStep:
+      if (!state.remaining.empty()) {
+        ForwardBackwardRound(&state);
+        Trim(&state, plan.trim2());
+      }
+      while (!state.remaining.empty()) {
+        ColoringRound(&state);
+        Trim(&state, plan.trim2());
+      }
+      break;
+    case StronglyConnectedComponentsPlan::kForwardBackward:
+      while (!state.remaining.empty()) {
+        ForwardBackwardRound(&state);
+        Trim(&state, plan.trim2());
+      }
+      break;
+    case StronglyConnectedComponentsPlan::kColoring:
+      while (!state.remaining.empty()) {
+        ColoringRound(&state);
+        Trim(&state, plan.trim2());
+      }
+      break;
+    }
+
+    WriteSmallestIDs(state, output);
+    exec_time.stop();
+  }
+
+  auto array = std::make_shared<arrow::UInt32Array>(num_nodes, buffer);
+  return pg->AddNodeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field(output_property_name, arrow::uint32())}),
+      {array}));
+}
+
+katana::Result<void>
+katana::analytics::StronglyConnectedComponentsAssertValid(
+    PropertyGraph* pg, const std::string& property_name) {
+  auto components =
+      KATANA_CHECKED(pg->GetNodePropertyTyped<uint32_t>(property_name));
+  std::vector<uint32_t> expected = SerialComponents(pg->topology());
+
+  katana::GReduceLogicalOr wrong;
+  katana::do_all(
+      katana::iterate(pg->topology().all_nodes()),
+      [&](Node n) {
+        if (components->IsNull(n) || components->Value(n) != expected[n]) {
+          wrong.update(true);
+        }
+      },
+      katana::no_stats());
+  if (wrong.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "components differ from a serial computation");
+  }
+  return katana::ResultSuccess();
+}
+
+void
+katana::analytics::StronglyConnectedComponentsStatistics::Print(
+    std::ostream& os) const {
+  os << "Total number of components = " << total_components << std::endl;
+  os << "Total number of non trivial components = "
+     << total_non_trivial_components << std::endl;
+  os << "Number of nodes in the largest component = "
+     << largest_component_size << std::endl;
+  os << "Ratio of nodes in the largest component = " << largest_component_ratio
+     << std::endl;
+}
+
+katana::Result<StronglyConnectedComponentsStatistics>
+katana::analytics::StronglyConnectedComponentsStatistics::Compute(
+    katana::PropertyGraph* pg, const std::string& property_name) {
+  auto components =
+      KATANA_CHECKED(pg->GetNodePropertyTyped<uint32_t>(property_name));
+  const uint64_t num_nodes = pg->num_nodes();
+
+  // Components are numbered by a node, so sizes can be counted by number
+  katana::NUMAArray<std::atomic<uint64_t>> sizes;
+  sizes.allocateBlocked(num_nodes);
+  katana::ParallelSTL::fill(sizes.begin(), sizes.end(), uint64_t{0});
+  katana::GReduceLogicalOr out_of_range;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint32_t c = components->Value(n);
+        if (c >= num_nodes) {
+          out_of_range.update(true);
+          return;
+        }
+        sizes[c].fetch_add(1, std::memory_order_relaxed);
+      },
+      katana::no_stats());
+  if (out_of_range.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "component IDs must be node IDs");
+  }
+
+  katana::GAccumulator<uint64_t> total;
+  katana::GAccumulator<uint64_t> non_trivial;
+  katana::GReduceMax<uint64_t> largest;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t size = sizes[n].load(std::memory_order_relaxed);
+        if (size > 0) {
+          total += 1;
+        }
+        if (size > 1) {
+          non_trivial += 1;
+        }
+        largest.update(size);
+      },
+      katana::no_stats());
+
+  uint64_t largest_size = largest.reduce();
+  double ratio = num_nodes > 0 ? double(largest_size) / num_nodes : 0;
+  return StronglyConnectedComponentsStatistics{
+      total.reduce(), non_trivial.reduce(), largest_size, ratio};
+}
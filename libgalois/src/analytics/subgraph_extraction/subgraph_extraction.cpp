@@ -19,8 +19,17 @@
 
 #include "katana/analytics/subgraph_extraction/subgraph_extraction.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <iostream>
+#include <unordered_set>
 
+#include <arrow/compute/api.h>
+
+#include "katana/Bag.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
 #include "katana/PropertyGraph.h"
 #include "katana/TypedPropertyGraph.h"
 #include "katana/analytics/Utils.h"
@@ -28,67 +37,241 @@
 namespace {
 
 using namespace katana::analytics;
-using edge_iterator = boost::counting_iterator<uint64_t>;
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+
+/// Indices at most this many are gathered by one call to arrow Take
+constexpr uint64_t kTakeSliceSize = 1 << 16;
+
+/// Gather values[indices[i]] into a new array, in parallel. Fixed width
+/// values are copied directly; other types go through arrow Take over
+/// slices of the indices.
+katana::Result<std::shared_ptr<arrow::Array>>
+GatherArray(
+    const std::shared_ptr<arrow::Array>& values,
+    const katana::NUMAArray<uint64_t>& indices) {
+  uint64_t num_values = indices.size();
+  const auto& type = values->type();
+  const auto* fixed_width =
+      dynamic_cast<const arrow::FixedWidthType*>(type.get());
 
-using SortedGraphView = katana::PropertyGraphViews::EdgesSortedByDestID;
-using Node = SortedGraphView::Node;
-using Edge = SortedGraphView::Edge;
+  if (fixed_width && fixed_width->bit_width() % 8 == 0 &&
+      type->id() != arrow::Type::DICTIONARY) {
+    uint64_t width = fixed_width->bit_width() / 8;
+    std::shared_ptr<arrow::Buffer> data =
+        KATANA_CHECKED(arrow::AllocateBuffer(num_values * width));
+    const uint8_t* source =
+        values->data()->buffers[1]->data() + values->offset() * width;
+    uint8_t* dest = data->mutable_data();
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_values),
+        [&](uint64_t i) {
+          std::memcpy(dest + i * width, source + indices[i] * width, width);
+        },
+        katana::no_stats(), katana::loopname("SubGraphGatherValues"));
+
+    std::shared_ptr<arrow::Buffer> validity;
+    int64_t null_count = 0;
+    if (values->null_count() > 0) {
+      // Each output byte of the bitmap is written by one iteration
+      uint64_t num_bytes = (num_values + 7) / 8;
+      auto bitmap = KATANA_CHECKED(arrow::AllocateBuffer(num_bytes));
+      const uint8_t* source_bitmap = values->null_bitmap_data();
+      uint8_t* dest_bitmap = bitmap->mutable_data();
+      katana::GAccumulator<int64_t> nulls;
+      katana::do_all(
+          katana::iterate(uint64_t{0}, num_bytes),
+          [&](uint64_t byte) {
+            uint8_t bits = 0;
+            for (uint64_t i = byte * 8; i < std::min(num_values, byte * 8 + 8);
+                 ++i) {
+              if (arrow::BitUtil::GetBit(
+                      source_bitmap, values->offset() + indices[i])) {
+                bits |= uint8_t{1} << (i % 8);
+              } else {
+                nulls += 1;
+              }
+            }
+            dest_bitmap[byte] = bits;
+          },
+          katana::no_stats(), katana::loopname("SubGraphGatherNulls"));
+      validity = std::move(bitmap);
+      null_count = nulls.reduce();
+    }
 
+    return arrow::MakeArray(arrow::ArrayData::Make(
+        type, num_values, {validity, std::move(data)}, null_count));
+  }
+
+  auto index_array = std::make_shared<arrow::UInt64Array>(
+      num_values, arrow::Buffer::Wrap(indices.data(), num_values));
+  uint64_t num_slices = (num_values + kTakeSliceSize - 1) / kTakeSliceSize;
+  std::vector<std::shared_ptr<arrow::Array>> slices(num_slices);
+  std::vector<arrow::Status> statuses(num_slices);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_slices),
+      [&](uint64_t s) {
+        uint64_t begin = s * kTakeSliceSize;
+        auto slice = index_array->Slice(
+            begin, std::min(kTakeSliceSize, num_values - begin));
+        auto taken = arrow::compute::Take(*values, *slice);
+        if (taken.ok()) {
+          slices[s] = taken.ValueOrDie();
+        } else {
+          statuses[s] = taken.status();
+        }
+      },
+      katana::no_stats(), katana::loopname("SubGraphTake"));
+  for (const auto& status : statuses) {
+    if (!status.ok()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::ArrowError, "gathering property values: {}",
+          status.ToString());
+    }
+  }
+  if (slices.empty()) {
+    return KATANA_CHECKED(arrow::MakeArrayOfNull(type, 0));
+  }
+  if (slices.size() == 1) {
+    return slices[0];
+  }
+  return KATANA_CHECKED(arrow::Concatenate(slices));
+}
+
+/// Gather the named properties into a table with a row for each index.
+/// get_property(name) returns the property of the original graph.
+template <typename GetProperty>
+katana::Result<std::shared_ptr<arrow::Table>>
+GatherProperties(
+    const std::vector<std::string>& names, const GetProperty& get_property,
+    const katana::NUMAArray<uint64_t>& indices) {
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::Array>> columns;
+  for (const auto& name : names) {
+    std::shared_ptr<arrow::ChunkedArray> property =
+        KATANA_CHECKED(get_property(name));
+    fields.emplace_back(arrow::field(name, property->type()));
+    columns.emplace_back(KATANA_CHECKED(
+        GatherArray(KATANA_CHECKED(katana::CombinedArray(property)), indices)));
+  }
+  return arrow::Table::Make(arrow::schema(fields), columns, indices.size());
+}
+
+/// Make the sub-graph with the given topology, copying node properties from
+/// the original nodes node_indices and edge properties from the original
+/// edges edge_indices.
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+MakeSubGraph(
+    katana::PropertyGraph* pg, katana::NUMAArray<Edge>&& out_indices,
+    katana::NUMAArray<Node>&& out_dests,
+    const katana::NUMAArray<uint64_t>& node_indices,
+    const katana::NUMAArray<uint64_t>& edge_indices,
+    const std::vector<std::string>& node_properties_to_copy,
+    const std::vector<std::string>& edge_properties_to_copy) {
+  katana::GraphTopology sub_g_topo{
+      std::move(out_indices), std::move(out_dests)};
+  auto sub_g =
+      KATANA_CHECKED(katana::PropertyGraph::Make(std::move(sub_g_topo)));
+
+  if (!node_properties_to_copy.empty()) {
+    auto table = KATANA_CHECKED(GatherProperties(
+        node_properties_to_copy,
+        [&](const std::string& name) { return pg->GetNodeProperty(name); },
+        node_indices));
+    KATANA_CHECKED(sub_g->AddNodeProperties(table));
+  }
+  if (!edge_properties_to_copy.empty()) {
+    auto table = KATANA_CHECKED(GatherProperties(
+        edge_properties_to_copy,
+        [&](const std::string& name) { return pg->GetEdgeProperty(name); },
+        edge_indices));
+    KATANA_CHECKED(sub_g->AddEdgeProperties(table));
+  }
+  return katana::Result<std::unique_ptr<katana::PropertyGraph>>(
+      std::move(sub_g));
+}
+
+/// Build the sub-graph of node_set, whose nodes are distinct. Each edge is
+/// mapped to the sub-graph by a binary search in the nodes sorted by ID, so
+/// the cost depends only on the degrees of the nodes in the set.
 katana::Result<std::unique_ptr<katana::PropertyGraph>>
 SubGraphNodeSet(
-    const SortedGraphView& graph, const std::vector<Node>& node_set) {
+    katana::PropertyGraph* pg, const std::vector<Node>& node_set,
+    const std::vector<std::string>& node_properties_to_copy,
+    const std::vector<std::string>& edge_properties_to_copy) {
+  const katana::GraphTopology& topology = pg->topology();
   uint64_t num_nodes = node_set.size();
+
+  // (original ID, sub-graph ID) sorted by original ID
+  std::vector<std::pair<Node, Node>> lookup(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { lookup[n] = {node_set[n], n}; }, katana::no_stats());
+  katana::ParallelSTL::sort(lookup.begin(), lookup.end());
+  auto find = [&](Node original) -> const std::pair<Node, Node>* {
+    auto it = std::lower_bound(
+        lookup.begin(), lookup.end(), std::make_pair(original, Node{0}));
+    return it != lookup.end() && it->first == original ? &*it : nullptr;
+  };
+
   // Subgraph topology : out indices
   katana::NUMAArray<Edge> out_indices;
   out_indices.allocateInterleaved(num_nodes);
-
-  katana::gstl::Vector<katana::gstl::Vector<Node>> subgraph_edges;
-  subgraph_edges.resize(num_nodes);
-
   katana::do_all(
-      katana::iterate(Node(0), Node(num_nodes)),
-      [&](const Node& n) {
-        Node src = node_set[n];
-
-        auto last = graph.edges(src).end();
-        for (Node m = 0; m < num_nodes; ++m) {
-          auto dest = node_set[m];
-          // Binary search on the edges sorted by destination id
-          for (auto edge_it = graph.find_edge(src, dest);
-               edge_it != last && graph.edge_dest(*edge_it) == dest;
-               ++edge_it) {
-            subgraph_edges[n].push_back(m);
-          }
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        Edge count = 0;
+        for (Edge e : topology.edges(node_set[n])) {
+          count += find(topology.edge_dest(e)) != nullptr;
         }
-        out_indices[n] = subgraph_edges[n].size();
+        out_indices[n] = count;
       },
       katana::steal(), katana::loopname("SubgraphExtraction"));
 
   // Prefix sum
   katana::ParallelSTL::partial_sum(
       out_indices.begin(), out_indices.end(), out_indices.begin());
-  uint64_t num_edges = out_indices[num_nodes - 1];
+  uint64_t num_edges = num_nodes > 0 ? out_indices[num_nodes - 1] : 0;
 
-  // Subgraph topology : out dests
+  // Subgraph topology : out dests, in order of destination in the subgraph
   katana::NUMAArray<Node> out_dests;
   out_dests.allocateInterleaved(num_edges);
+  katana::NUMAArray<uint64_t> edge_indices;
+  edge_indices.allocateInterleaved(num_edges);
+  katana::NUMAArray<uint64_t> node_indices;
+  node_indices.allocateInterleaved(num_nodes);
 
   katana::do_all(
-      katana::iterate(Node(0), Node(num_nodes)),
-      [&](const Node& n) {
-        uint64_t offset = n == 0 ? 0 : out_indices[n - 1];
-        for (Node dest : subgraph_edges[n]) {
-          out_dests[offset] = dest;
-          offset++;
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        node_indices[n] = topology.node_property_index(node_set[n]);
+        uint64_t begin = n == 0 ? 0 : out_indices[n - 1];
+        uint64_t offset = begin;
+        for (Edge e : topology.edges(node_set[n])) {
+          if (const auto* match = find(topology.edge_dest(e)); match) {
+            out_dests[offset] = match->second;
+            edge_indices[offset] = topology.edge_property_index(e);
+            offset++;
+          }
+        }
+        // Sort by destination, keeping parallel edges in order
+        std::vector<std::pair<Node, uint64_t>> sorted;
+        for (uint64_t i = begin; i < offset; ++i) {
+          sorted.emplace_back(out_dests[i], edge_indices[i]);
+        }
+        std::stable_sort(
+            sorted.begin(), sorted.end(),
+            [](const auto& a, const auto& b) { return a.first < b.first; });
+        for (uint64_t i = begin; i < offset; ++i) {
+          out_dests[i] = sorted[i - begin].first;
+          edge_indices[i] = sorted[i - begin].second;
         }
       },
       katana::steal(), katana::loopname("ConstructTopology"));
 
-  katana::GraphTopology sub_g_topo{
-      std::move(out_indices), std::move(out_dests)};
-  auto sub_g_res = katana::PropertyGraph::Make(std::move(sub_g_topo));
-
-  return sub_g_res;
+  return MakeSubGraph(
+      pg, std::move(out_indices), std::move(out_dests), node_indices,
+      edge_indices, node_properties_to_copy, edge_properties_to_copy);
 }
 }  // namespace
 
@@ -96,10 +279,24 @@ katana::Result<std::unique_ptr<katana::PropertyGraph>>
 katana::analytics::SubGraphExtraction(
     katana::PropertyGraph* pg, const std::vector<Node>& node_vec,
     SubGraphExtractionPlan plan) {
+  return SubGraphExtraction(pg, node_vec, {}, {}, plan);
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::analytics::SubGraphExtraction(
+    katana::PropertyGraph* pg, const std::vector<Node>& node_vec,
+    const std::vector<std::string>& node_properties_to_copy,
+    const std::vector<std::string>& edge_properties_to_copy,
+    SubGraphExtractionPlan plan) {
   // Remove duplicates from the node vector
   std::unordered_set<uint32_t> set;
   std::vector<uint32_t> dedup_node_vec;
   for (auto n : node_vec) {
+    if (n >= pg->num_nodes()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "node {} is not in the graph",
+          n);
+    }
     if (set.insert(n).second) {  // If n wasn't already present.
       dedup_node_vec.push_back(n);
     }
@@ -109,18 +306,315 @@ katana::analytics::SubGraphExtraction(
     return std::make_unique<katana::PropertyGraph>();
   }
 
-  SortedGraphView sg = pg->BuildView<SortedGraphView>();
-
   katana::StatTimer execTime("SubGraph-Extraction");
   switch (plan.algorithm()) {
   case SubGraphExtractionPlan::kNodeSet: {
     execTime.start();
-    auto subgraph = SubGraphNodeSet(sg, dedup_node_vec);
+    auto subgraph = KATANA_CHECKED(SubGraphNodeSet(
+        pg, dedup_node_vec, node_properties_to_copy, edge_properties_to_copy));
     execTime.stop();
-    KATANA_LOG_DEBUG_ASSERT(subgraph);
-    return std::move(subgraph.value());
+    return katana::Result<std::unique_ptr<katana::PropertyGraph>>(
+        std::move(subgraph));
   }
   default:
     return katana::ErrorCode::InvalidArgument;
   }
 }
+
+namespace {
+
+/// KHopNeighborhood over the out-edges given by edges_of(n), a range of
+/// edges of topo
+template <typename Topo, typename EdgesOf>
+katana::Result<std::vector<Node>>
+KHopNeighborhoodImpl(
+    const Topo& topology, const std::vector<Node>& seeds, uint32_t num_hops,
+    const EdgesOf& edges_of) {
+  std::vector<Node> neighborhood;
+  std::unordered_set<Node> seen;
+  for (Node n : seeds) {
+    if (n >= topology.num_nodes()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "node {} is not in the graph",
+          n);
+    }
+    if (seen.insert(n).second) {
+      neighborhood.push_back(n);
+    }
+  }
+
+  // All nodes reached so far, sorted for lookups from the parallel loop
+  std::vector<Node> visited = neighborhood;
+  std::sort(visited.begin(), visited.end());
+
+  uint64_t level_begin = 0;
+  for (uint32_t hop = 0;
+       hop < num_hops && level_begin < neighborhood.size(); ++hop) {
+    katana::InsertBag<Node> reached;
+    katana::do_all(
+        katana::iterate(
+            neighborhood.begin() + level_begin, neighborhood.end()),
+        [&](Node n) {
+          for (auto e : edges_of(n)) {
+            Node dest = topology.edge_dest(e);
+            if (!std::binary_search(visited.begin(), visited.end(), dest)) {
+              reached.push(dest);
+            }
+          }
+        },
+        katana::steal(), katana::loopname("KHopNeighborhood"));
+
+    std::vector<Node> level(reached.begin(), reached.end());
+    katana::ParallelSTL::sort(level.begin(), level.end());
+    level.erase(std::unique(level.begin(), level.end()), level.end());
+
+    level_begin = neighborhood.size();
+    neighborhood.insert(neighborhood.end(), level.begin(), level.end());
+    std::vector<Node> merged(visited.size() + level.size());
+    std::merge(
+        visited.begin(), visited.end(), level.begin(), level.end(),
+        merged.begin());
+    visited = std::move(merged);
+  }
+  return neighborhood;
+}
+
+}  // namespace
+
+katana::Result<std::vector<katana::PropertyGraph::Node>>
+katana::analytics::KHopNeighborhood(
+    katana::PropertyGraph* pg, const std::vector<Node>& seeds,
+    uint32_t num_hops) {
+  const katana::GraphTopology& topology = pg->topology();
+  return KHopNeighborhoodImpl(
+      topology, seeds, num_hops, [&](Node n) { return topology.edges(n); });
+}
+
+katana::Result<std::vector<katana::PropertyGraph::Node>>
+katana::analytics::KHopNeighborhood(
+    katana::PropertyGraph* pg, const std::vector<Node>& seeds,
+    uint32_t num_hops, const std::string& timestamp_property_name,
+    const katana::TimeWindow& window) {
+  auto index =
+      KATANA_CHECKED(pg->GetTemporalEdgeIndex(timestamp_property_name));
+  return KHopNeighborhoodImpl(*index, seeds, num_hops, [&](Node n) {
+    return index->edges(n, window);
+  });
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::analytics::EdgeInducedSubGraphExtraction(
+    katana::PropertyGraph* pg, const SubGraphEdgePredicate& keep_edge,
+    const std::vector<std::string>& node_properties_to_copy,
+    const std::vector<std::string>& edge_properties_to_copy,
+    std::vector<Node>* subgraph_nodes) {
+  const katana::GraphTopology& topology = pg->topology();
+  uint64_t num_nodes = topology.num_nodes();
+  uint64_t num_edges = topology.num_edges();
+
+  katana::StatTimer execTime("SubGraph-Extraction");
+  execTime.start();
+
+  // Keep the edges, and mark their endpoints with a 1
+  katana::NUMAArray<uint8_t> kept;
+  kept.allocateBlocked(num_edges);
+  katana::NUMAArray<std::atomic<Node>> marks;
+  marks.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { marks[n].store(0, std::memory_order_relaxed); },
+      katana::no_stats());
+  katana::do_all(
+      katana::iterate(topology.all_nodes()),
+      [&](Node n) {
+        for (Edge e : topology.edges(n)) {
+          kept[e] = keep_edge(e);
+          if (kept[e]) {
+            marks[n].store(1, std::memory_order_relaxed);
+            marks[topology.edge_dest(e)].store(1, std::memory_order_relaxed);
+          }
+        }
+      },
+      katana::steal(), katana::loopname("SubGraphKeepEdges"));
+
+  // The sub-graph ID of each kept node is the number of kept nodes before it
+  katana::NUMAArray<Node> ids;
+  ids.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { ids[n] = marks[n].load(std::memory_order_relaxed); },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(ids.begin(), ids.end(), ids.begin());
+  uint64_t num_sub_nodes = num_nodes > 0 ? ids[num_nodes - 1] : 0;
+
+  katana::NUMAArray<uint64_t> node_indices;
+  node_indices.allocateInterleaved(num_sub_nodes);
+  katana::NUMAArray<Edge> out_indices;
+  out_indices.allocateInterleaved(num_sub_nodes);
+  katana::do_all(
+      katana::iterate(topology.all_nodes()),
+      [&](Node n) {
+        if (!marks[n].load(std::memory_order_relaxed)) {
+          return;
+        }
+        Edge count = 0;
+        for (Edge e : topology.edges(n)) {
+          count += kept[e];
+        }
+        node_indices[ids[n] - 1] = topology.node_property_index(n);
+        out_indices[ids[n] - 1] = count;
+      },
+      katana::steal(), katana::loopname("SubgraphExtraction"));
+  katana::ParallelSTL::partial_sum(
+      out_indices.begin(), out_indices.end(), out_indices.begin());
+  uint64_t num_sub_edges =
+      num_sub_nodes > 0 ? out_indices[num_sub_nodes - 1] : 0;
+
+  katana::NUMAArray<Node> out_dests;
+  out_dests.allocateInterleaved(num_sub_edges);
+  katana::NUMAArray<uint64_t> edge_indices;
+  edge_indices.allocateInterleaved(num_sub_edges);
+  katana::do_all(
+      katana::iterate(topology.all_nodes()),
+      [&](Node n) {
+        if (!marks[n].load(std::memory_order_relaxed)) {
+          return;
+        }
+        Node sub_n = ids[n] - 1;
+        uint64_t offset = sub_n == 0 ? 0 : out_indices[sub_n - 1];
+        for (Edge e : topology.edges(n)) {
+          if (kept[e]) {
+            out_dests[offset] = ids[topology.edge_dest(e)] - 1;
+            edge_indices[offset] = topology.edge_property_index(e);
+            offset++;
+          }
+        }
+      },
+      katana::steal(), katana::loopname("ConstructTopology"));
+
+  if (subgraph_nodes) {
+    subgraph_nodes->assign(node_indices.begin(), node_indices.end());
+  }
+  auto subgraph = KATANA_CHECKED(MakeSubGraph(
+      pg, std::move(out_indices), std::move(out_dests), node_indices,
+      edge_indices, node_properties_to_copy, edge_properties_to_copy));
+  execTime.stop();
+  return katana::Result<std::unique_ptr<katana::PropertyGraph>>(
+      std::move(subgraph));
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::analytics::SubGraphExtraction(
+    katana::PropertyGraph* pg, const katana::DynamicBitset& nodes,
+    const std::vector<std::string>& node_properties_to_copy,
+    const std::vector<std::string>& edge_properties_to_copy,
+    SubGraphExtractionPlan plan) {
+  if (nodes.size() != pg->num_nodes()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "node bitset has {} bits for {} nodes", nodes.size(), pg->num_nodes());
+  }
+  return SubGraphExtraction(
+      pg, nodes.GetOffsets<Node>(), node_properties_to_copy,
+      edge_properties_to_copy, plan);
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::analytics::EdgeInducedSubGraphExtraction(
+    katana::PropertyGraph* pg, const katana::DynamicBitset& edges,
+    const std::vector<std::string>& node_properties_to_copy,
+    const std::vector<std::string>& edge_properties_to_copy,
+    std::vector<Node>* subgraph_nodes) {
+  if (edges.size() != pg->num_edges()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "edge bitset has {} bits for {} edges", edges.size(), pg->num_edges());
+  }
+  return EdgeInducedSubGraphExtraction(
+      pg, [&edges](const Edge& e) { return edges.test(e); },
+      node_properties_to_copy, edge_properties_to_copy, subgraph_nodes);
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::analytics::EdgeSetSubGraphExtraction(
+    katana::PropertyGraph* pg, const std::vector<Edge>& edge_vec,
+    const std::vector<std::string>& node_properties_to_copy,
+    const std::vector<std::string>& edge_properties_to_copy,
+    std::vector<Node>* subgraph_nodes) {
+  const katana::GraphTopology& topology = pg->topology();
+  for (Edge e : edge_vec) {
+    if (e >= topology.num_edges()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "edge {} is not in the graph",
+          e);
+    }
+  }
+
+  katana::StatTimer execTime("SubGraph-Extraction");
+  execTime.start();
+
+  // Edges in order of ID are in order of source
+  std::vector<Edge> edges = edge_vec;
+  katana::ParallelSTL::sort(edges.begin(), edges.end());
+  edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+  uint64_t num_sub_edges = edges.size();
+
+  katana::NUMAArray<Node> sources;
+  sources.allocateInterleaved(num_sub_edges);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_sub_edges),
+      [&](uint64_t i) { sources[i] = topology.edge_source(edges[i]); },
+      katana::no_stats());
+
+  std::vector<Node> nodes(2 * num_sub_edges);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_sub_edges),
+      [&](uint64_t i) {
+        nodes[2 * i] = sources[i];
+        nodes[2 * i + 1] = topology.edge_dest(edges[i]);
+      },
+      katana::no_stats());
+  katana::ParallelSTL::sort(nodes.begin(), nodes.end());
+  nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+  uint64_t num_sub_nodes = nodes.size();
+  auto sub_id = [&](Node n) -> Node {
+    return std::lower_bound(nodes.begin(), nodes.end(), n) - nodes.begin();
+  };
+
+  katana::NUMAArray<uint64_t> node_indices;
+  node_indices.allocateInterleaved(num_sub_nodes);
+  katana::NUMAArray<Edge> out_indices;
+  out_indices.allocateInterleaved(num_sub_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_sub_nodes),
+      [&](uint64_t n) {
+        node_indices[n] = topology.node_property_index(nodes[n]);
+        // One past the last edge of the node
+        out_indices[n] =
+            std::upper_bound(sources.begin(), sources.end(), nodes[n]) -
+            sources.begin();
+      },
+      katana::no_stats());
+
+  katana::NUMAArray<Node> out_dests;
+  out_dests.allocateInterleaved(num_sub_edges);
+  katana::NUMAArray<uint64_t> edge_indices;
+  edge_indices.allocateInterleaved(num_sub_edges);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_sub_edges),
+      [&](uint64_t i) {
+        out_dests[i] = sub_id(topology.edge_dest(edges[i]));
+        edge_indices[i] = topology.edge_property_index(edges[i]);
+      },
+      katana::no_stats(), katana::loopname("ConstructTopology"));
+
+  if (subgraph_nodes) {
+    *subgraph_nodes = std::move(nodes);
+  }
+  auto subgraph = KATANA_CHECKED(MakeSubGraph(
+      pg, std::move(out_indices), std::move(out_dests), node_indices,
+      edge_indices, node_properties_to_copy, edge_properties_to_copy));
+  execTime.stop();
+  return katana::Result<std::unique_ptr<katana::PropertyGraph>>(
+      std::move(subgraph));
+}
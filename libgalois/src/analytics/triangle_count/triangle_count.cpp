@@ -19,6 +19,14 @@
 
 #include "katana/analytics/triangle_count/triangle_count.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <random>
+
+#include "katana/NUMAArray.h"
+#include "katana/SetIntersection.h"
 #include "katana/analytics/Utils.h"
 
 using namespace katana::analytics;
@@ -31,75 +39,17 @@ using edge_iterator = SortedGraphView::edge_iterator;
 constexpr static const unsigned kChunkSize = 64U;
 
 /**
- * Like std::lower_bound but doesn't dereference iterators. Returns the first
- * element for which comp is not true.
+ * Neighbors of a node as a sorted array.
  */
-template <typename Iterator, typename Compare>
-Iterator
-LowerBound(Iterator first, Iterator last, Compare comp) {
-  using difference_type =
-      typename std::iterator_traits<Iterator>::difference_type;
-
-  Iterator it;
-  difference_type count;
-  difference_type half;
-
-  count = std::distance(first, last);
-  while (count > 0) {
-    it = first;
-    half = count / 2;
-    std::advance(it, half);
-    if (comp(it)) {
-      first = ++it;
-      count -= half + 1;
-    } else {
-      count = half;
-    }
-  }
-  return first;
-}
-
-/**
- * std::set_intersection over edge_iterators.
- */
-template <typename G>
-size_t
-CountEqual(
-    const G& g, typename G::edge_iterator aa, typename G::edge_iterator ea,
-    typename G::edge_iterator bb, typename G::edge_iterator eb) {
-  size_t retval = 0;
-  while (aa != ea && bb != eb) {
-    typename G::Node a = g.edge_dest(*aa);
-    typename G::Node b = g.edge_dest(*bb);
-    if (a < b) {
-      ++aa;
-    } else if (b < a) {
-      ++bb;
-    } else {
-      retval += 1;
-      ++aa;
-      ++bb;
-    }
-  }
-  return retval;
-}
+struct NeighborRange {
+  const Node* begin;
+  const Node* end;
 
-template <typename G>
-struct LessThan {
-  const G& g;
-  typename G::Node n;
-  LessThan(const G& g, typename G::Node n) : g(g), n(n) {}
-  bool operator()(typename G::edge_iterator it) { return g.edge_dest(*it) < n; }
-};
+  NeighborRange(const SortedGraphView& g, Node n)
+      : begin(g.dest_data() + *g.edges(n).begin()),
+        end(g.dest_data() + *g.edges(n).end()) {}
 
-template <typename G>
-struct GreaterThanOrEqual {
-  const G& g;
-  typename G::Node n;
-  GreaterThanOrEqual(const G& g, typename G::Node n) : g(g), n(n) {}
-  bool operator()(typename G::edge_iterator it) {
-    return n >= g.edge_dest(*it);
-  }
+  size_t size() const { return end - begin; }
 };
 
 /**
@@ -111,38 +61,52 @@ struct GreaterThanOrEqual {
  *       triangle += 1
  * </code>
  *
+ * Each lower neighbor a of v closes a triangle with every upper neighbor of v
+ * that is also a neighbor of a, so the pairs are counted by intersecting
+ * neighbors(a) with the upper neighbors of v. Those are kept in a bitmap if v
+ * is a hub.
+ *
  * Thomas Schank. Algorithmic Aspects of Triangle-Based Network Analysis. PhD
  * Thesis. Universitat Karlsruhe. 2007.
  */
 size_t
 NodeIteratingAlgo(const SortedGraphView* graph) {
   katana::GAccumulator<size_t> numTriangles;
+  katana::PerThreadStorage<katana::IntersectionBitmap> bitmaps;
 
   katana::do_all(
       katana::iterate(*graph),
       [&](const Node& n) {
         // Partition neighbors
         // [first, ea) [n] [bb, last)
-        edge_iterator first = graph->edges(n).begin();
-        edge_iterator last = graph->edges(n).end();
-        edge_iterator ea =
-            LowerBound(first, last, LessThan<SortedGraphView>(*graph, n));
-        edge_iterator bb = LowerBound(
-            first, last, GreaterThanOrEqual<SortedGraphView>(*graph, n));
-
-        for (; bb != last; ++bb) {
-          Node B = graph->edge_dest(*bb);
-          for (auto aa = first; aa != ea; ++aa) {
-            Node A = graph->edge_dest(*aa);
-            edge_iterator vv = graph->edges(A).begin();
-            edge_iterator ev = graph->edges(A).end();
-            edge_iterator it =
-                LowerBound(vv, ev, LessThan<SortedGraphView>(*graph, B));
-            if (it != ev && graph->edge_dest(*it) == B) {
-              numTriangles += 1;
-            }
-          }
+        NeighborRange neighbors(*graph, n);
+        const Node* ea = std::lower_bound(neighbors.begin, neighbors.end, n);
+        const Node* bb = std::upper_bound(ea, neighbors.end, n);
+        size_t num_upper = neighbors.end - bb;
+
+        katana::IntersectionBitmap* upper = nullptr;
+        if (num_upper >= katana::kIntersectBitmapMinSize &&
+            ea - neighbors.begin > 1) {
+          upper = bitmaps.getLocal();
+          upper->Assign(bb, num_upper, graph->num_nodes());
         }
+
+        size_t numTriangles_local = 0;
+        for (const Node* aa = neighbors.begin; aa != ea; ++aa) {
+          NeighborRange a_neighbors(*graph, *aa);
+          const Node* above_n =
+              std::upper_bound(a_neighbors.begin, a_neighbors.end, n);
+          size_t num_above_n = a_neighbors.end - above_n;
+          numTriangles_local +=
+              upper ? katana::CountCommon(
+                          *upper, bb, num_upper, above_n, num_above_n)
+                    : katana::CountCommon(
+                          bb, num_upper, above_n, num_above_n);
+        }
+        if (upper) {
+          upper->Clear();
+        }
+        numTriangles += numTriangles_local;
       },
       katana::chunk_size<kChunkSize>(), katana::steal(),
       katana::loopname("TriangleCount_NodeIteratingAlgo"));
@@ -152,31 +116,41 @@ NodeIteratingAlgo(const SortedGraphView* graph) {
 
 /**
  * Lambda function to count triangles
+ *
+ * For each neighbor v <= n, the neighbors of v up to v are intersected with
+ * the neighbors of n up to v, which are the first ones.
  */
 void
 OrderedCountFunc(
     const SortedGraphView* graph, Node n,
+    katana::IntersectionBitmap* bitmap,
     katana::GAccumulator<size_t>& numTriangles) {
+  NeighborRange neighbors(*graph, n);
+  const Node* last = std::upper_bound(neighbors.begin, neighbors.end, n);
+  size_t num_lower = last - neighbors.begin;
+
+  bool use_bitmap = num_lower >= katana::kIntersectBitmapMinSize;
+  if (use_bitmap) {
+    bitmap->Assign(neighbors.begin, num_lower, graph->num_nodes());
+  }
+
   size_t numTriangles_local = 0;
-  for (auto edges_n : graph->edges(n)) {
-    Node v = graph->edge_dest(edges_n);
-    if (v > n) {
-      break;
-    }
-    edge_iterator it_n = graph->edges(n).begin();
-
-    for (auto edges_v : graph->edges(v)) {
-      auto dst_v = graph->edge_dest(edges_v);
-      if (dst_v > v) {
-        break;
-      }
-      while (graph->edge_dest(*it_n) < dst_v) {
-        it_n++;
-      }
-      if (dst_v == graph->edge_dest(*it_n)) {
-        numTriangles_local += 1;
-      }
-    }
+  for (const Node* it_n = neighbors.begin; it_n != last; ++it_n) {
+    Node v = *it_n;
+    NeighborRange v_neighbors(*graph, v);
+    const Node* v_last =
+        std::upper_bound(v_neighbors.begin, v_neighbors.end, v);
+    size_t num_v = v_last - v_neighbors.begin;
+    size_t num_n = it_n - neighbors.begin + 1;
+    numTriangles_local +=
+        use_bitmap ? katana::CountCommon(
+                         *bitmap, neighbors.begin, num_n, v_neighbors.begin,
+                         num_v)
+                   : katana::CountCommon(
+                         neighbors.begin, num_n, v_neighbors.begin, num_v);
+  }
+  if (use_bitmap) {
+    bitmap->Clear();
   }
   numTriangles += numTriangles_local;
 }
@@ -187,9 +161,12 @@ OrderedCountFunc(
 size_t
 OrderedCountAlgo(const SortedGraphView* graph) {
   katana::GAccumulator<size_t> numTriangles;
+  katana::PerThreadStorage<katana::IntersectionBitmap> bitmaps;
   katana::do_all(
       katana::iterate(*graph),
-      [&](const Node& n) { OrderedCountFunc(graph, n, numTriangles); },
+      [&](const Node& n) {
+        OrderedCountFunc(graph, n, bitmaps.getLocal(), numTriangles);
+      },
       katana::chunk_size<kChunkSize>(), katana::steal(),
       katana::loopname("TriangleCount_OrderedCountAlgo"));
 
@@ -206,6 +183,9 @@ OrderedCountAlgo(const SortedGraphView* graph) {
  *         triangle += 1
  * </code>
  *
+ * Consecutive items mostly share their source, so a thread keeps the
+ * neighbors of a hub source in a bitmap until it moves on to another source.
+ *
  * Thomas Schank. Algorithmic Aspects of Triangle-Based Network Analysis. PhD
  * Thesis. Universitat Karlsruhe. 2007.
  */
@@ -219,6 +199,7 @@ EdgeIteratingAlgo(const SortedGraphView* graph) {
 
   katana::InsertBag<WorkItem> items;
   katana::GAccumulator<size_t> numTriangles;
+  katana::PerThreadStorage<katana::IntersectionBitmap> bitmaps;
 
   katana::do_all(
       katana::iterate(*graph),
@@ -232,26 +213,33 @@ EdgeIteratingAlgo(const SortedGraphView* graph) {
       },
       katana::loopname("TriangleCount_Initialize"));
 
+  // The cost of an item depends on the degrees of its endpoints, so spread
+  // the items of the threads with the heaviest nodes over all threads
+  katana::NUMAArray<WorkItem> flat_items;
+  items.Flatten(&flat_items);
+  items.clear();
+
   katana::do_all(
-      katana::iterate(items),
+      katana::iterate(flat_items),
       [&](const WorkItem& w) {
         // Compute intersection of range (w.src, w.dst) in neighbors of
         // w.src and w.dst
-        edge_iterator abegin = graph->edges(w.src).begin();
-        edge_iterator aend = graph->edges(w.src).end();
-        edge_iterator bbegin = graph->edges(w.dst).begin();
-        edge_iterator bend = graph->edges(w.dst).end();
-
-        edge_iterator aa = LowerBound(
-            abegin, aend, GreaterThanOrEqual<SortedGraphView>(*graph, w.src));
-        edge_iterator ea =
-            LowerBound(abegin, aend, LessThan<SortedGraphView>(*graph, w.dst));
-        edge_iterator bb = LowerBound(
-            bbegin, bend, GreaterThanOrEqual<SortedGraphView>(*graph, w.src));
-        edge_iterator eb =
-            LowerBound(bbegin, bend, LessThan<SortedGraphView>(*graph, w.dst));
-
-        numTriangles += CountEqual(*graph, aa, ea, bb, eb);
+        NeighborRange a(*graph, w.src);
+        NeighborRange b(*graph, w.dst);
+        const Node* aa = std::upper_bound(a.begin, a.end, w.src);
+        const Node* ea = std::lower_bound(aa, a.end, w.dst);
+        const Node* bb = std::upper_bound(b.begin, b.end, w.src);
+        const Node* eb = std::lower_bound(bb, b.end, w.dst);
+
+        katana::IntersectionBitmap* bitmap = bitmaps.getLocal();
+        if (bitmap->members() != a.begin &&
+            a.size() >= katana::kIntersectBitmapMinSize) {
+          bitmap->Assign(a.begin, a.size(), graph->num_nodes());
+        }
+        numTriangles += bitmap->members() == a.begin
+                            ? katana::CountCommon(
+                                  *bitmap, aa, ea - aa, bb, eb - bb)
+                            : katana::CountCommon(aa, ea - aa, bb, eb - bb);
       },
       katana::loopname("TriangleCount_EdgeIteratingAlgo"),
       katana::chunk_size<kChunkSize>(), katana::steal());
@@ -259,9 +247,167 @@ EdgeIteratingAlgo(const SortedGraphView* graph) {
   return numTriangles.reduce();
 }
 
+/**
+ * Whether a and b are adjacent, by scanning the edges of the one with the
+ * lower degree, which need not be sorted.
+ */
+bool
+IsAdjacent(const katana::GraphTopology& topo, Node a, Node b) {
+  if (topo.degree(a) > topo.degree(b)) {
+    std::swap(a, b);
+  }
+  for (auto e : topo.edges(a)) {
+    if (topo.edge_dest(e) == b) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Whether a wedge at center picked uniformly with gen is closed.
+ */
+template <typename Gen>
+bool
+SampleWedge(const katana::GraphTopology& topo, Node center, Gen* gen) {
+  uint64_t degree = topo.degree(center);
+  uint64_t first = *topo.edges(center).begin();
+  uint64_t i = std::uniform_int_distribution<uint64_t>(0, degree - 1)(*gen);
+  uint64_t j = std::uniform_int_distribution<uint64_t>(0, degree - 2)(*gen);
+  if (j >= i) {
+    ++j;
+  }
+  Node a = topo.edge_dest(first + i);
+  Node b = topo.edge_dest(first + j);
+  return a != b && a != center && b != center && IsAdjacent(topo, a, b);
+}
+
+/**
+ * Wedge sampling. Triangles come from wedges drawn uniformly among all
+ * wedges, and the average clustering coefficient from one wedge at each of
+ * nodes drawn uniformly among those with at least two neighbors. Samples are
+ * drawn in fixed blocks, each with its own generator, so the estimate does
+ * not depend on the number of threads unless the time budget runs out.
+ */
+katana::Result<TriangleCountEstimate>
+WedgeSamplingAlgo(
+    const katana::GraphTopology& topo, const TriangleCountPlan& plan) {
+  constexpr uint64_t kSamplesPerBlock = 1024;
+  constexpr uint64_t kSeed = 0x5eed;
+
+  if (!(plan.confidence() > 0 && plan.confidence() < 1)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "confidence must be in (0, 1)");
+  }
+
+  // Prefix sums of the number of wedges at each node and of the number of
+  // nodes that have any
+  Node num_nodes = topo.num_nodes();
+  katana::NUMAArray<uint64_t> wedges;
+  katana::NUMAArray<uint32_t> centers;
+  wedges.allocateBlocked(num_nodes);
+  centers.allocateBlocked(num_nodes);
+  katana::do_all(
+      katana::iterate(topo),
+      [&](Node n) {
+        uint64_t degree = topo.degree(n);
+        wedges[n] = degree < 2 ? 0 : degree * (degree - 1) / 2;
+        centers[n] = degree < 2 ? 0 : 1;
+      },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      wedges.begin(), wedges.end(), wedges.begin());
+  katana::ParallelSTL::partial_sum(
+      centers.begin(), centers.end(), centers.begin());
+  uint64_t num_wedges = num_nodes == 0 ? 0 : wedges[num_nodes - 1];
+  uint64_t num_centers = num_nodes == 0 ? 0 : centers[num_nodes - 1];
+
+  uint64_t num_samples = num_wedges == 0 ? 0 : plan.num_samples();
+  uint64_t num_blocks = (num_samples + kSamplesPerBlock - 1) / kSamplesPerBlock;
+  auto deadline = std::chrono::steady_clock::now() +
+                  std::chrono::milliseconds(plan.time_budget_ms());
+  std::atomic<bool> out_of_time{false};
+
+  katana::GAccumulator<uint64_t> sampled;
+  katana::GAccumulator<uint64_t> closed;
+  katana::GAccumulator<uint64_t> closed_at_centers;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_blocks),
+      [&](uint64_t block) {
+        if (plan.time_budget_ms() > 0 &&
+            (out_of_time.load(std::memory_order_relaxed) ||
+             std::chrono::steady_clock::now() > deadline)) {
+          out_of_time.store(true, std::memory_order_relaxed);
+          return;
+        }
+        std::mt19937_64 gen(kSeed + block);
+        std::uniform_int_distribution<uint64_t> wedge_dist(0, num_wedges - 1);
+        std::uniform_int_distribution<uint32_t> center_dist(
+            0, num_centers - 1);
+        uint64_t begin = block * kSamplesPerBlock;
+        uint64_t end = std::min(begin + kSamplesPerBlock, num_samples);
+        uint64_t local_closed = 0;
+        uint64_t local_closed_at_centers = 0;
+        for (uint64_t i = begin; i < end; ++i) {
+          Node n = std::upper_bound(
+                       wedges.begin(), wedges.end(), wedge_dist(gen)) -
+                   wedges.begin();
+          local_closed += SampleWedge(topo, n, &gen);
+          n = std::upper_bound(
+                  centers.begin(), centers.end(), center_dist(gen)) -
+              centers.begin();
+          local_closed_at_centers += SampleWedge(topo, n, &gen);
+        }
+        sampled += end - begin;
+        closed += local_closed;
+        closed_at_centers += local_closed_at_centers;
+      },
+      katana::steal(), katana::loopname("TriangleCount_WedgeSamplingAlgo"));
+
+  TriangleCountEstimate estimate{};
+  estimate.confidence = plan.confidence();
+  estimate.num_samples = sampled.reduce();
+  estimate.num_wedges = num_wedges;
+  if (num_wedges == 0) {
+    return estimate;
+  }
+
+  // Hoeffding: a mean of k samples in [0, 1] is off by more than epsilon with
+  // probability at most 2 exp(-2 k epsilon^2)
+  double k = estimate.num_samples;
+  double epsilon =
+      k == 0 ? 1 : std::sqrt(std::log(2 / (1 - plan.confidence())) / (2 * k));
+  double closed_fraction = k == 0 ? 0 : closed.reduce() / k;
+  double closed_at_centers_fraction =
+      k == 0 ? 0 : closed_at_centers.reduce() / k;
+
+  double triangles_per_closed = num_wedges / 3.0;
+  estimate.triangles = closed_fraction * triangles_per_closed;
+  estimate.triangles_lower =
+      std::max(closed_fraction - epsilon, 0.0) * triangles_per_closed;
+  estimate.triangles_upper =
+      std::min(closed_fraction + epsilon, 1.0) * triangles_per_closed;
+
+  double centers_fraction = static_cast<double>(num_centers) / num_nodes;
+  estimate.average_clustering = closed_at_centers_fraction * centers_fraction;
+  estimate.average_clustering_lower =
+      std::max(closed_at_centers_fraction - epsilon, 0.0) * centers_fraction;
+  estimate.average_clustering_upper =
+      std::min(closed_at_centers_fraction + epsilon, 1.0) * centers_fraction;
+
+  katana::ReportStatSingle(
+      "TriangleCount", "WedgeSamples", estimate.num_samples);
+  return estimate;
+}
+
 katana::Result<uint64_t>
 katana::analytics::TriangleCount(
     katana::PropertyGraph* pg, TriangleCountPlan plan) {
+  if (plan.algorithm() == TriangleCountPlan::kWedgeSampling) {
+    auto estimate = KATANA_CHECKED(TriangleCountApproximate(pg, plan));
+    return static_cast<uint64_t>(std::llround(estimate.triangles));
+  }
+
   katana::StatTimer timer_graph_read("GraphReadingTime", "TriangleCount");
   katana::StatTimer timer_auto_algo("AutoRelabel", "TriangleCount");
 
@@ -343,3 +489,32 @@ katana::analytics::TriangleCount(
 
   return total_count;
 }
+
+katana::Result<TriangleCountEstimate>
+katana::analytics::TriangleCountApproximate(
+    katana::PropertyGraph* pg, TriangleCountPlan plan) {
+  if (plan.algorithm() != TriangleCountPlan::kWedgeSampling) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "TriangleCountApproximate requires a WedgeSampling plan");
+  }
+
+  katana::StatTimer execTime("TriangleCountApproximate", "TriangleCount");
+  execTime.start();
+  auto estimate = KATANA_CHECKED(WedgeSamplingAlgo(pg->topology(), plan));
+  execTime.stop();
+
+  return estimate;
+}
+
+void
+katana::analytics::TriangleCountEstimate::Print(std::ostream& os) const {
+  os << "Estimated triangles = " << triangles << " [" << triangles_lower
+     << ", " << triangles_upper << "]" << std::endl;
+  os << "Estimated average clustering coefficient = " << average_clustering
+     << " [" << average_clustering_lower << ", " << average_clustering_upper
+     << "]" << std::endl;
+  os << "Confidence = " << confidence << std::endl;
+  os << "Sampled wedges = " << num_samples << " of " << num_wedges
+     << std::endl;
+}
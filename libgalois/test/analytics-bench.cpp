@@ -0,0 +1,496 @@
+/// Benchmarks of the katana::analytics routines, every plan of Bfs, Sssp,
+/// Pagerank and ConnectedComponents and the default plan of the others, on
+/// generated graphs (RMAT, uniform random and 2D grid) at several scales and
+/// on RDGs given on the command line, each at several thread counts.
+///
+///   unit-analytics-bench [--scales=12,16,20] [--threads=1,8] [<RDG>...]
+///       [--benchmark_out=results.json --benchmark_out_format=json]
+///
+/// Benchmarks are named <routine>/<plan>/<graph>/threads:<n>, and report the
+/// nodes and edges of their graph and the edges traversed per second, so the
+/// JSON output of two runs can be compared with the compare.py tool of
+/// Google Benchmark. Generated graphs do not depend on the number of threads.
+/// KTruss is left out because it reorders the graph it runs on.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+#include <benchmark/benchmark.h>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Strings.h"
+#include "katana/ThreadPool.h"
+#include "katana/analytics/betweenness_centrality/betweenness_centrality.h"
+#include "katana/analytics/bfs/bfs.h"
+#include "katana/analytics/connected_components/connected_components.h"
+#include "katana/analytics/graph_coloring/graph_coloring.h"
+#include "katana/analytics/independent_set/independent_set.h"
+#include "katana/analytics/jaccard/jaccard.h"
+#include "katana/analytics/k_core/k_core.h"
+#include "katana/analytics/local_clustering_coefficient/local_clustering_coefficient.h"
+#include "katana/analytics/louvain_clustering/louvain_clustering.h"
+#include "katana/analytics/pagerank/pagerank.h"
+#include "katana/analytics/sssp/sssp.h"
+#include "katana/analytics/triangle_count/triangle_count.h"
+
+namespace {
+
+using namespace katana::analytics;
+
+using Node = katana::GraphTopology::Node;
+
+constexpr uint32_t kEdgeFactor = 16;
+constexpr uint32_t kMaxWeight = 100;
+const char* const kWeight = "weight";
+const char* const kOutput = "output";
+
+/// A deterministic stream of random numbers for each key
+uint64_t
+Mix(uint64_t x) {
+  x += 0x9e3779b97f4a7c15ULL;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+/// Build a CSR from edges encoded as source << 32 | destination
+katana::GraphTopology
+FromEdges(uint64_t num_nodes, katana::NUMAArray<uint64_t>* edges) {
+  katana::ParallelSTL::sort(edges->begin(), edges->end());
+
+  katana::GraphTopology::AdjIndexVec indices;
+  indices.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        indices[n] =
+            std::lower_bound(edges->begin(), edges->end(), (n + 1) << 32) -
+            edges->begin();
+      },
+      katana::no_stats());
+
+  katana::GraphTopology::EdgeDestVec dests;
+  dests.allocateInterleaved(edges->size());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, edges->size()),
+      [&](uint64_t e) { dests[e] = static_cast<Node>((*edges)[e]); },
+      katana::no_stats());
+  return katana::GraphTopology(std::move(indices), std::move(dests));
+}
+
+/// Graph500 RMAT with 2^scale nodes and kEdgeFactor edges per node
+katana::GraphTopology
+MakeRmat(uint32_t scale) {
+  constexpr double kA = 0.57;
+  constexpr double kB = 0.19;
+  constexpr double kC = 0.19;
+
+  const uint64_t num_nodes = uint64_t{1} << scale;
+  katana::NUMAArray<uint64_t> edges;
+  edges.allocateInterleaved(num_nodes * kEdgeFactor);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, edges.size()),
+      [&](uint64_t e) {
+        uint64_t src = 0;
+        uint64_t dst = 0;
+        uint64_t state = e;
+        for (uint32_t bit = 0; bit < scale; ++bit) {
+          state = Mix(state);
+          double r = static_cast<double>(state >> 11) * 0x1.0p-53;
+          if (r >= kA + kB + kC) {
+            src |= uint64_t{1} << bit;
+            dst |= uint64_t{1} << bit;
+          } else if (r >= kA + kB) {
+            src |= uint64_t{1} << bit;
+          } else if (r >= kA) {
+            dst |= uint64_t{1} << bit;
+          }
+        }
+        edges[e] = src << 32 | dst;
+      },
+      katana::no_stats());
+  return FromEdges(num_nodes, &edges);
+}
+
+/// 2D grid of about 2^scale nodes with edges in both directions between
+/// neighbors
+katana::GraphTopology
+MakeGrid(uint32_t scale) {
+  const uint64_t side = uint64_t{1} << (scale / 2);
+  const uint64_t num_nodes = side * side;
+  katana::NUMAArray<uint64_t> edges;
+  edges.allocateInterleaved(4 * side * (side - 1));
+  katana::do_all(
+      katana::iterate(uint64_t{0}, side * (side - 1)),
+      [&](uint64_t i) {
+        // Edge i goes right along a row and down a column, both ways
+        uint64_t row = i / (side - 1);
+        uint64_t col = i % (side - 1);
+        uint64_t right = row * side + col;
+        uint64_t down = col * side + row;
+        edges[4 * i] = right << 32 | (right + 1);
+        edges[4 * i + 1] = (right + 1) << 32 | right;
+        edges[4 * i + 2] = down << 32 | (down + side);
+        edges[4 * i + 3] = (down + side) << 32 | down;
+      },
+      katana::no_stats());
+  return FromEdges(num_nodes, &edges);
+}
+
+/// Add random weights in [1, kMaxWeight] unless pg already has them
+void
+AddWeights(katana::PropertyGraph* pg) {
+  if (pg->HasEdgeProperty(kWeight)) {
+    return;
+  }
+  katana::NUMAArray<uint32_t> weights;
+  weights.allocateInterleaved(pg->num_edges());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, pg->num_edges()),
+      [&](uint64_t e) { weights[e] = 1 + Mix(e) % kMaxWeight; },
+      katana::no_stats());
+  arrow::UInt32Builder builder;
+  KATANA_LOG_ASSERT(builder.AppendValues(weights.begin(), weights.end()).ok());
+  std::shared_ptr<arrow::Array> array;
+  KATANA_LOG_ASSERT(builder.Finish(&array).ok());
+  auto res = pg->AddEdgeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field(kWeight, arrow::uint32())}), {array}));
+  KATANA_LOG_VASSERT(res, "adding weights: {}", res.error());
+}
+
+/// The form of a graph that a routine needs
+enum class Variant { kDirected, kSymmetric, kTranspose };
+
+/// A graph to benchmark on and the way to make it
+struct GraphSpec {
+  std::string name;
+  std::function<std::unique_ptr<katana::PropertyGraph>()> make;
+};
+
+/// The variants of the graph of the running benchmark. Benchmarks are
+/// registered graph by graph, so only one graph is kept in memory.
+class GraphCache {
+public:
+  katana::PropertyGraph* Get(const GraphSpec& spec, Variant variant) {
+    if (spec.name != name_) {
+      for (auto& graph : graphs_) {
+        graph.reset();
+      }
+      name_ = spec.name;
+    }
+    auto& graph = graphs_[static_cast<int>(variant)];
+    if (graph) {
+      return graph.get();
+    }
+    auto& directed = graphs_[static_cast<int>(Variant::kDirected)];
+    if (!directed) {
+      directed = spec.make();
+      AddWeights(directed.get());
+    }
+    if (variant == Variant::kSymmetric) {
+      auto res = katana::CreateSymmetricGraph(directed.get());
+      KATANA_LOG_VASSERT(res, "symmetrizing {}: {}", spec.name, res.error());
+      graph = std::move(res.value());
+    } else if (variant == Variant::kTranspose) {
+      auto res = katana::CreateTransposeGraphTopology(directed->topology());
+      KATANA_LOG_VASSERT(res, "transposing {}: {}", spec.name, res.error());
+      graph = std::move(res.value());
+    }
+    AddWeights(graph.get());
+    return graph.get();
+  }
+
+private:
+  std::string name_;
+  std::unique_ptr<katana::PropertyGraph> graphs_[3];
+};
+
+GraphCache graph_cache;
+
+/// The node with the most out edges, as a source that reaches much of the
+/// graph
+uint32_t
+MaxDegreeNode(const katana::PropertyGraph& pg) {
+  const katana::GraphTopology& topo = pg.topology();
+  return katana::ParallelSTL::map_reduce(
+      topo.all_nodes().begin(), topo.all_nodes().end(),
+      [&](Node n) { return n; },
+      [&](Node a, Node b) {
+        size_t da = topo.edges(a).size();
+        size_t db = topo.edges(b).size();
+        return da > db || (da == db && a < b) ? a : b;
+      },
+      Node{0});
+}
+
+using Run =
+    std::function<katana::Result<void>(katana::PropertyGraph*, uint32_t)>;
+
+/// A routine with one plan; run writes its result to kOutput
+struct Kernel {
+  std::string name;
+  Variant variant;
+  Run run;
+};
+
+void
+RunKernel(
+    benchmark::State& state, const GraphSpec& spec, const Kernel& kernel) {
+  katana::setActiveThreads(state.range(0));
+  katana::PropertyGraph* pg = graph_cache.Get(spec, kernel.variant);
+  uint32_t source = MaxDegreeNode(*pg);
+
+  for (auto _ : state) {
+    auto res = kernel.run(pg, source);
+    state.PauseTiming();
+    if (!res) {
+      state.SkipWithError(fmt::format("{}", res.error()).c_str());
+      state.ResumeTiming();
+      break;
+    }
+    if (pg->HasNodeProperty(kOutput)) {
+      KATANA_LOG_ASSERT(pg->RemoveNodeProperty(kOutput));
+    }
+    state.ResumeTiming();
+  }
+
+  state.counters["nodes"] = pg->num_nodes();
+  state.counters["edges"] = pg->num_edges();
+  state.counters["edges_per_second"] = benchmark::Counter(
+      static_cast<double>(pg->num_edges()) * state.iterations(),
+      benchmark::Counter::kIsRate);
+}
+
+std::vector<Kernel>
+Kernels() {
+  std::vector<Kernel> kernels;
+  auto add = [&](std::string name, Variant variant, Run run) {
+    kernels.emplace_back(Kernel{std::move(name), variant, std::move(run)});
+  };
+
+  for (const auto& [name, plan] : std::vector<std::pair<std::string, BfsPlan>>{
+           {"AsynchronousTile", BfsPlan::AsynchronousTile()},
+           {"Asynchronous", BfsPlan::Asynchronous()},
+           {"SynchronousTile", BfsPlan::SynchronousTile()},
+           {"Synchronous", BfsPlan::Synchronous()},
+           {"SynchronousDirectOpt", BfsPlan::SynchronousDirectOpt()},
+           {"SynchronousDirectOptLazyTranspose",
+            BfsPlan::SynchronousDirectOptLazyTranspose()},
+       }) {
+    add("Bfs/" + name, Variant::kDirected,
+        [plan = plan](katana::PropertyGraph* pg, uint32_t source) {
+          return Bfs(pg, source, kOutput, plan);
+        });
+  }
+  add("Bfs/MultiSource", Variant::kDirected,
+      [](katana::PropertyGraph* pg, uint32_t source) -> katana::Result<void> {
+        std::vector<uint32_t> sources(BfsPlan::kDefaultBatchSize);
+        for (size_t i = 0; i < sources.size(); ++i) {
+          sources[i] = (source + i) % pg->num_nodes();
+        }
+        KATANA_CHECKED(MultiSourceBfsDistances(pg, sources));
+        return katana::ResultSuccess();
+      });
+
+  for (const auto& [name, plan] :
+       std::vector<std::pair<std::string, SsspPlan>>{
+           {"DeltaTile", SsspPlan::DeltaTile()},
+           {"DeltaStep", SsspPlan::DeltaStep()},
+           {"DeltaStepBarrier", SsspPlan::DeltaStepBarrier()},
+           {"DeltaStepFusion", SsspPlan::DeltaStepFusion()},
+           {"DeltaStepAdaptive", SsspPlan::DeltaStepAdaptive()},
+           {"MultiQueue", SsspPlan::MultiQueue()},
+           {"SerialDeltaTile", SsspPlan::SerialDeltaTile()},
+           {"SerialDelta", SsspPlan::SerialDelta()},
+           {"DijkstraTile", SsspPlan::DijkstraTile()},
+           {"Dijkstra", SsspPlan::Dijkstra()},
+           {"Topological", SsspPlan::Topological()},
+           {"TopologicalTile", SsspPlan::TopologicalTile()},
+           {"Automatic", SsspPlan()},
+       }) {
+    add("Sssp/" + name, Variant::kDirected,
+        [plan = plan](katana::PropertyGraph* pg, uint32_t source) {
+          return Sssp(pg, source, kWeight, kOutput, plan);
+        });
+  }
+
+  // The pull algorithms run on the transpose
+  for (const auto& [name, variant, plan] :
+       std::vector<std::tuple<std::string, Variant, PagerankPlan>>{
+           {"PullTopological", Variant::kTranspose,
+            PagerankPlan::PullTopological()},
+           {"PullResidual", Variant::kTranspose, PagerankPlan::PullResidual()},
+           {"PullBlocked", Variant::kTranspose, PagerankPlan::PullBlocked()},
+           {"PullBlockedBFloat16", Variant::kTranspose,
+            PagerankPlan::PullBlocked(
+                PagerankPlan::kDefaultTolerance,
+                PagerankPlan::kDefaultMaxIterations,
+                PagerankPlan::kDefaultAlpha, PagerankPlan::kBFloat16)},
+           {"PushSynchronous", Variant::kDirected,
+            PagerankPlan::PushSynchronous()},
+           {"PushAsynchronous", Variant::kDirected,
+            PagerankPlan::PushAsynchronous()},
+       }) {
+    add("Pagerank/" + name, variant,
+        [plan = plan](katana::PropertyGraph* pg, uint32_t) {
+          return Pagerank(pg, kOutput, plan);
+        });
+  }
+
+  for (const auto& [name, plan] :
+       std::vector<std::pair<std::string, ConnectedComponentsPlan>>{
+           {"Serial", ConnectedComponentsPlan::Serial()},
+           {"LabelProp", ConnectedComponentsPlan::LabelProp()},
+           {"Synchronous", ConnectedComponentsPlan::Synchronous()},
+           {"Asynchronous", ConnectedComponentsPlan::Asynchronous()},
+           {"EdgeAsynchronous", ConnectedComponentsPlan::EdgeAsynchronous()},
+           {"EdgeTiledAsynchronous",
+            ConnectedComponentsPlan::EdgeTiledAsynchronous()},
+           {"BlockedAsynchronous",
+            ConnectedComponentsPlan::BlockedAsynchronous()},
+           {"Afforest", ConnectedComponentsPlan::Afforest()},
+           {"EdgeAfforest", ConnectedComponentsPlan::EdgeAfforest()},
+           {"EdgeTiledAfforest", ConnectedComponentsPlan::EdgeTiledAfforest()},
+       }) {
+    add("ConnectedComponents/" + name, Variant::kSymmetric,
+        [plan = plan](katana::PropertyGraph* pg, uint32_t) {
+          return ConnectedComponents(pg, kOutput, plan);
+        });
+  }
+
+  add("BetweennessCentrality/Default", Variant::kDirected,
+      [](katana::PropertyGraph* pg, uint32_t) {
+        return BetweennessCentrality(pg, kOutput, uint32_t{16});
+      });
+  add("GraphColoring/Default", Variant::kSymmetric,
+      [](katana::PropertyGraph* pg, uint32_t) {
+        return GraphColoring(pg, kOutput);
+      });
+  add("IndependentSet/Default", Variant::kSymmetric,
+      [](katana::PropertyGraph* pg, uint32_t) {
+        return IndependentSet(pg, kOutput);
+      });
+  add("Jaccard/Default", Variant::kDirected,
+      [](katana::PropertyGraph* pg, uint32_t source) {
+        return Jaccard(pg, source, kOutput);
+      });
+  add("KCore/Default", Variant::kSymmetric,
+      [](katana::PropertyGraph* pg, uint32_t) {
+        return KCore(pg, 10, kOutput);
+      });
+  add("KCoreNumbers/Default", Variant::kSymmetric,
+      [](katana::PropertyGraph* pg, uint32_t) {
+        return KCoreNumbers(pg, kOutput);
+      });
+  add("LocalClusteringCoefficient/Default", Variant::kSymmetric,
+      [](katana::PropertyGraph* pg, uint32_t) {
+        return LocalClusteringCoefficient(pg, kOutput);
+      });
+  add("LouvainClustering/Default", Variant::kSymmetric,
+      [](katana::PropertyGraph* pg, uint32_t) {
+        return LouvainClustering(pg, kWeight, kOutput);
+      });
+  add("TriangleCount/Default", Variant::kSymmetric,
+      [](katana::PropertyGraph* pg, uint32_t) -> katana::Result<void> {
+        KATANA_CHECKED(TriangleCount(pg));
+        return katana::ResultSuccess();
+      });
+  return kernels;
+}
+
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph(katana::GraphTopology&& topo) {
+  auto res = katana::PropertyGraph::Make(std::move(topo));
+  KATANA_LOG_VASSERT(res, "making graph: {}", res.error());
+  return std::move(res.value());
+}
+
+std::vector<GraphSpec>
+Graphs(
+    const std::vector<uint32_t>& scales, const std::vector<std::string>& rdgs) {
+  std::vector<GraphSpec> graphs;
+  for (uint32_t scale : scales) {
+    graphs.emplace_back(GraphSpec{
+        fmt::format("rmat{}", scale),
+        [scale]() { return MakeGraph(MakeRmat(scale)); }});
+    graphs.emplace_back(GraphSpec{
+        fmt::format("uniform{}", scale), [scale]() {
+          return MakeGraph(katana::CreateUniformRandomTopology(
+              size_t{1} << scale, kEdgeFactor));
+        }});
+    graphs.emplace_back(GraphSpec{
+        fmt::format("grid{}", scale),
+        [scale]() { return MakeGraph(MakeGrid(scale)); }});
+  }
+  for (const auto& rdg : rdgs) {
+    graphs.emplace_back(GraphSpec{rdg, [rdg]() {
+                                    auto res = katana::PropertyGraph::Make(rdg);
+                                    KATANA_LOG_VASSERT(
+                                        res, "loading {}: {}", rdg,
+                                        res.error());
+                                    return std::move(res.value());
+                                  }});
+  }
+  return graphs;
+}
+
+std::vector<uint32_t>
+ParseList(const std::string& list) {
+  std::vector<uint32_t> values;
+  for (const auto& value : katana::SplitView(list, ",")) {
+    values.emplace_back(std::stoul(std::string(value)));
+  }
+  return values;
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  katana::SharedMemSys G;
+
+  uint32_t max_threads = katana::GetThreadPool().getMaxThreads();
+  std::vector<uint32_t> scales = {12, 16, 20};
+  std::vector<uint32_t> threads = {1};
+  if (max_threads > 1) {
+    threads.emplace_back(max_threads);
+  }
+  std::vector<std::string> rdgs;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (katana::HasPrefix(arg, "--scales=")) {
+      scales = ParseList(arg.substr(9));
+    } else if (katana::HasPrefix(arg, "--threads=")) {
+      threads = ParseList(arg.substr(10));
+    } else {
+      rdgs.emplace_back(arg);
+    }
+  }
+
+  std::vector<Kernel> kernels = Kernels();
+  for (const GraphSpec& graph : Graphs(scales, rdgs)) {
+    for (const Kernel& kernel : kernels) {
+      auto* b = ::benchmark::RegisterBenchmark(
+          fmt::format("{}/{}", kernel.name, graph.name).c_str(),
+          [graph, kernel](benchmark::State& state) {
+            RunKernel(state, graph, kernel);
+          });
+      for (uint32_t t : threads) {
+        b->Arg(std::min(t, max_threads));
+      }
+      b->ArgName("threads")->Unit(benchmark::kMillisecond)->UseRealTime();
+    }
+  }
+
+  ::benchmark::RunSpecifiedBenchmarks();
+}
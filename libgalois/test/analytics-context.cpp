@@ -0,0 +1,225 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/URI.h"
+#include "katana/analytics/AnalyticsContext.h"
+#include "katana/analytics/Checkpoint.h"
+#include "katana/analytics/bfs/bfs.h"
+#include "katana/analytics/pagerank/pagerank.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+void
+TestReuse() {
+  constexpr uint32_t kSize = 1 << 12;
+
+  katana::analytics::AnalyticsContext context;
+  katana::NUMAArray<uint32_t>* first = context.Array<uint32_t>("a", kSize);
+  KATANA_LOG_ASSERT(first->size() == kSize);
+  katana::do_all(katana::iterate(uint32_t{0}, kSize), [&](uint32_t i) {
+    (*first)[i] = i;
+  });
+
+  // The same name and size returns the same memory
+  katana::NUMAArray<uint32_t>* second = context.Array<uint32_t>("a", kSize);
+  KATANA_LOG_ASSERT(second == first);
+  KATANA_LOG_ASSERT(second->data() == first->data());
+  KATANA_LOG_ASSERT((*second)[kSize - 1] == kSize - 1);
+  KATANA_LOG_ASSERT(context.num_allocations() == 1);
+
+  // A new size reallocates, another name or type is another array
+  KATANA_LOG_ASSERT(
+      context.Array<uint32_t>("a", 2 * kSize)->size() == 2 * kSize);
+  KATANA_LOG_ASSERT(context.Array<uint32_t>("b", kSize) != first);
+  context.Array<std::atomic<uint64_t>>("a", kSize);
+  KATANA_LOG_ASSERT(context.num_allocations() == 4);
+
+  context.Clear();
+  KATANA_LOG_ASSERT(context.Array<uint32_t>("a", kSize)->size() == kSize);
+  KATANA_LOG_ASSERT(context.num_allocations() == 5);
+}
+
+void
+TestScratchArray() {
+  katana::analytics::AnalyticsContext context;
+  katana::NUMAArray<float> local;
+
+  katana::NUMAArray<float>* array =
+      katana::analytics::ScratchArray(&context, "a", 16, &local);
+  KATANA_LOG_ASSERT(array->size() == 16);
+  KATANA_LOG_ASSERT(local.empty());
+
+  array = katana::analytics::ScratchArray(nullptr, "a", 16, &local);
+  KATANA_LOG_ASSERT(array == &local);
+  KATANA_LOG_ASSERT(local.size() == 16);
+}
+
+/// A cancelled call fails without leaving its output property behind
+void
+TestCancel() {
+  constexpr uint32_t kNodes = 1024;
+  std::vector<katana::GraphTopology::Edge> indices;
+  std::vector<katana::GraphTopology::Node> dests;
+  for (uint32_t n = 0; n < kNodes; ++n) {
+    dests.emplace_back((n + 1) % kNodes);
+    indices.emplace_back(dests.size());
+  }
+  auto pg_res = katana::PropertyGraph::Make(katana::GraphTopology(
+      indices.data(), indices.size(), dests.data(), dests.size()));
+  KATANA_LOG_VASSERT(pg_res, "making graph: {}", pg_res.error());
+  katana::PropertyGraph* pg = pg_res.value().get();
+
+  katana::analytics::AnalyticsContext context;
+  context.Cancel();
+  KATANA_LOG_ASSERT(katana::analytics::IsCancelled(&context));
+  KATANA_LOG_ASSERT(!katana::analytics::IsCancelled(nullptr));
+
+  auto bfs_res = katana::analytics::Bfs(pg, 0, "bfs", {}, &context);
+  KATANA_LOG_ASSERT(
+      !bfs_res && bfs_res.error() == katana::ErrorCode::Cancelled);
+  auto pr_res = katana::analytics::Pagerank(pg, "rank", {}, &context);
+  KATANA_LOG_ASSERT(!pr_res && pr_res.error() == katana::ErrorCode::Cancelled);
+  KATANA_LOG_ASSERT(pg->GetNumNodeProperties() == 0);
+
+  context.ResetCancelled();
+  KATANA_LOG_ASSERT(katana::analytics::Bfs(pg, 0, "bfs", {}, &context));
+  KATANA_LOG_ASSERT(katana::analytics::Pagerank(pg, "rank", {}, &context));
+  KATANA_LOG_ASSERT(pg->GetNumNodeProperties() == 2);
+}
+
+/// A fresh local directory for checkpoints
+std::string
+CheckpointDirectory() {
+  auto uri_res = katana::Uri::MakeRand("/tmp/checkpoint");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string dir(uri_res.value().path());
+  fs::create_directories(dir);
+  return dir;
+}
+
+void
+TestCheckpointer() {
+  std::string dir = CheckpointDirectory();
+  auto make_res = katana::analytics::Checkpointer::Make(dir);
+  KATANA_LOG_ASSERT(make_res);
+  katana::analytics::Checkpointer* checkpointer = make_res.value().get();
+
+  katana::NUMAArray<uint64_t> values;
+  values.allocateInterleaved(1000);
+  uint32_t round = 0;
+  auto begin = [&]() {
+    checkpointer->Begin("test");
+    checkpointer->Add("values", &values);
+    checkpointer->Add("round", &round);
+  };
+
+  begin();
+  auto restore_res = checkpointer->Restore();
+  KATANA_LOG_ASSERT(restore_res && !restore_res.value());
+  for (round = 1; round <= 3; ++round) {
+    for (size_t i = 0; i < values.size(); ++i) {
+      values[i] = i * round;
+    }
+    KATANA_LOG_ASSERT(checkpointer->Save(round));
+    KATANA_LOG_ASSERT(checkpointer->Wait());
+  }
+
+  // A new run resumes from the last round
+  std::fill(values.begin(), values.end(), 0);
+  round = 0;
+  begin();
+  restore_res = checkpointer->Restore();
+  KATANA_LOG_VASSERT(restore_res, "{}", restore_res.error());
+  KATANA_LOG_ASSERT(restore_res.value());
+  KATANA_LOG_ASSERT(round == 3);
+  for (size_t i = 0; i < values.size(); ++i) {
+    KATANA_LOG_ASSERT(values[i] == i * 3);
+  }
+
+  // Other state does not fit
+  katana::NUMAArray<uint64_t> other;
+  other.allocateInterleaved(10);
+  checkpointer->Begin("test");
+  checkpointer->Add("values", &other);
+  checkpointer->Add("round", &round);
+  KATANA_LOG_ASSERT(!checkpointer->Restore());
+
+  // Nothing is left after a completed run
+  begin();
+  KATANA_LOG_ASSERT(checkpointer->Restore());
+  KATANA_LOG_ASSERT(checkpointer->Complete());
+  begin();
+  restore_res = checkpointer->Restore();
+  KATANA_LOG_ASSERT(restore_res && !restore_res.value());
+
+  fs::remove_all(dir);
+}
+
+/// A cancelled Pagerank resumes from its checkpoint and gets the ranks of an
+/// uninterrupted run
+void
+TestPagerankResume(katana::analytics::PagerankPlan plan) {
+  auto pg_res = katana::PropertyGraph::Make(
+      katana::CreateUniformRandomTopology(1024, 8));
+  KATANA_LOG_ASSERT(pg_res);
+  katana::PropertyGraph* pg = pg_res.value().get();
+
+  KATANA_LOG_ASSERT(katana::analytics::Pagerank(pg, "expected", plan));
+
+  std::string dir = CheckpointDirectory();
+  auto make_res = katana::analytics::Checkpointer::Make(dir);
+  KATANA_LOG_ASSERT(make_res);
+  katana::analytics::Checkpointer* checkpointer = make_res.value().get();
+  katana::analytics::AnalyticsContext context;
+  context.SetCheckpointer(checkpointer);
+
+  // Stops after the first iteration, which is checkpointed
+  context.Cancel();
+  auto res = katana::analytics::Pagerank(pg, "rank", plan, &context);
+  KATANA_LOG_ASSERT(!res && res.error() == katana::ErrorCode::Cancelled);
+  KATANA_LOG_ASSERT(checkpointer->num_saved() == 1);
+
+  context.ResetCancelled();
+  res = katana::analytics::Pagerank(pg, "rank", plan, &context);
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  // The first iteration was not run again
+  KATANA_LOG_ASSERT(
+      checkpointer->num_saved() + checkpointer->num_skipped() ==
+      plan.max_iterations() - 1);
+
+  auto expected =
+      katana::CombinedArray(pg->GetNodeProperty("expected").value());
+  auto rank = katana::CombinedArray(pg->GetNodeProperty("rank").value());
+  KATANA_LOG_ASSERT(expected && rank);
+  KATANA_LOG_ASSERT(expected.value()->Equals(*rank.value()));
+
+  fs::remove_all(dir);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys Katana_runtime;
+
+  TestReuse();
+  TestScratchArray();
+  TestCancel();
+  TestCheckpointer();
+  TestPagerankResume(
+      katana::analytics::PagerankPlan::PullTopological(0, 10));
+  TestPagerankResume(katana::analytics::PagerankPlan::PullResidual(0, 10));
+
+  return 0;
+}
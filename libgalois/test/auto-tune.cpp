@@ -0,0 +1,109 @@
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/AutoTune.h"
+
+namespace {
+
+using namespace katana::analytics;
+
+constexpr uint32_t kSide = 64;
+
+/// A kSide by kSide grid with edges in both directions between neighbors
+/// and weights that grow along rows
+std::unique_ptr<katana::PropertyGraph>
+MakeGrid() {
+  std::vector<katana::GraphTopology::Edge> indices;
+  std::vector<katana::GraphTopology::Node> dests;
+  std::vector<uint32_t> weights;
+  for (uint32_t row = 0; row < kSide; ++row) {
+    for (uint32_t col = 0; col < kSide; ++col) {
+      uint32_t n = row * kSide + col;
+      for (int64_t d : {-int64_t{kSide}, int64_t{-1}, int64_t{1},
+                        int64_t{kSide}}) {
+        if ((col == 0 && d == -1) || (col == kSide - 1 && d == 1) ||
+            n + d < 0 || n + d >= kSide * kSide) {
+          continue;
+        }
+        dests.emplace_back(n + d);
+        weights.emplace_back(1 + col);
+      }
+      indices.emplace_back(dests.size());
+    }
+  }
+
+  auto pg_res = katana::PropertyGraph::Make(katana::GraphTopology(
+      indices.data(), indices.size(), dests.data(), dests.size()));
+  KATANA_LOG_VASSERT(pg_res, "making graph: {}", pg_res.error());
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_res.value());
+
+  arrow::UInt32Builder builder;
+  KATANA_LOG_ASSERT(builder.AppendValues(weights).ok());
+  std::shared_ptr<arrow::Array> array;
+  KATANA_LOG_ASSERT(builder.Finish(&array).ok());
+  auto res = pg->AddEdgeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("weight", arrow::uint32())}), {array}));
+  KATANA_LOG_VASSERT(res, "adding weights: {}", res.error());
+  return pg;
+}
+
+/// The plans chosen must run, on the whole graph and not only the sample
+void
+TestTune(katana::PropertyGraph* pg, const AutoTuneOptions& options) {
+  auto bfs_plan = AutoTuneBfsPlan(pg, options);
+  KATANA_LOG_VASSERT(bfs_plan, "tuning bfs: {}", bfs_plan.error());
+  auto bfs_res = Bfs(pg, 0, "bfs", bfs_plan.value());
+  KATANA_LOG_VASSERT(bfs_res, "bfs: {}", bfs_res.error());
+  KATANA_LOG_ASSERT(BfsAssertValid(pg, 0, "bfs"));
+
+  auto sssp_plan = AutoTuneSsspPlan(pg, "weight", options);
+  KATANA_LOG_VASSERT(sssp_plan, "tuning sssp: {}", sssp_plan.error());
+  auto sssp_res = Sssp(pg, 0, "weight", "sssp", sssp_plan.value());
+  KATANA_LOG_VASSERT(sssp_res, "sssp: {}", sssp_res.error());
+  KATANA_LOG_ASSERT(SsspAssertValid(pg, 0, "weight", "sssp"));
+
+  auto cc_plan = AutoTuneConnectedComponentsPlan(pg, options);
+  KATANA_LOG_VASSERT(cc_plan, "tuning cc: {}", cc_plan.error());
+  auto cc_res = ConnectedComponents(pg, "cc", cc_plan.value());
+  KATANA_LOG_VASSERT(cc_res, "cc: {}", cc_res.error());
+  KATANA_LOG_ASSERT(ConnectedComponentsAssertValid(pg, "cc"));
+
+  // Tuning leaves no properties behind
+  for (const char* name : {"bfs", "sssp", "cc"}) {
+    KATANA_LOG_ASSERT(pg->RemoveNodeProperty(name));
+  }
+  KATANA_LOG_ASSERT(pg->GetNumNodeProperties() == 0);
+}
+
+void
+TestMissingWeight(katana::PropertyGraph* pg) {
+  auto res = AutoTuneSsspPlan(pg, "no such property");
+  KATANA_LOG_ASSERT(!res);
+  KATANA_LOG_ASSERT(res.error() == katana::ErrorCode::PropertyNotFound);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  std::unique_ptr<katana::PropertyGraph> pg = MakeGrid();
+
+  AutoTuneOptions options;
+  options.runs = 1;
+  TestTune(pg.get(), options);
+
+  // Calibrate on a sample of a quarter of the grid
+  options.max_sample_nodes = kSide * kSide / 4;
+  TestTune(pg.get(), options);
+
+  TestMissingWeight(pg.get());
+
+  return 0;
+}
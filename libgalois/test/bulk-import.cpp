@@ -0,0 +1,312 @@
+#include <fstream>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+#include <boost/filesystem.hpp>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/BulkImport.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/URI.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+constexpr size_t kNumNodes = 1000;
+constexpr size_t kNumEdges = 5000;
+
+/// The id of node i; ids are not in node order
+int64_t
+Id(size_t i) {
+  return (i * 7) % kNumNodes + 100;
+}
+
+std::string
+StringId(size_t i) {
+  return "n" + std::to_string(Id(i));
+}
+
+std::optional<std::string>
+Label(size_t i) {
+  if (i % 10 == 0) {
+    return std::nullopt;
+  }
+  static const char* kLabels[] = {"a", "b", "c"};
+  return kLabels[i % 3];
+}
+
+size_t
+Source(size_t e) {
+  return (e * 13) % kNumNodes;
+}
+
+size_t
+Dest(size_t e) {
+  return (e * 31 + 5) % kNumNodes;
+}
+
+std::string
+Type(size_t e) {
+  return e % 2 == 0 ? "x" : "y";
+}
+
+template <typename Builder, typename F>
+std::shared_ptr<arrow::Array>
+MakeArray(size_t size, F value) {
+  Builder builder;
+  for (size_t i = 0; i < size; ++i) {
+    auto v = value(i);
+    if constexpr (std::is_same_v<decltype(v), std::optional<std::string>>) {
+      KATANA_LOG_ASSERT((v ? builder.Append(*v) : builder.AppendNull()).ok());
+    } else {
+      KATANA_LOG_ASSERT(builder.Append(v).ok());
+    }
+  }
+  std::shared_ptr<arrow::Array> array;
+  KATANA_LOG_ASSERT(builder.Finish(&array).ok());
+  return array;
+}
+
+std::shared_ptr<arrow::Table>
+MakeTable(
+    const std::vector<std::string>& names,
+    const std::vector<std::shared_ptr<arrow::Array>>& columns) {
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  for (size_t i = 0; i < names.size(); ++i) {
+    fields.emplace_back(arrow::field(names[i], columns[i]->type()));
+  }
+  return arrow::Table::Make(arrow::schema(fields), columns);
+}
+
+/// Node and edge tables with ids from id(i)
+template <typename Builder, typename F>
+std::pair<std::shared_ptr<arrow::Table>, std::shared_ptr<arrow::Table>>
+MakeTables(F id) {
+  auto nodes = MakeTable(
+      {"id", "age", "label"},
+      {MakeArray<Builder>(kNumNodes, id),
+       MakeArray<arrow::Int64Builder>(kNumNodes, [](size_t i) { return i; }),
+       MakeArray<arrow::LargeStringBuilder>(kNumNodes, Label)});
+  auto edges = MakeTable(
+      {"weight", "src", "type", "dst"},
+      {MakeArray<arrow::UInt64Builder>(kNumEdges, [](size_t e) { return e; }),
+       MakeArray<Builder>(kNumEdges, [&](size_t e) { return id(Source(e)); }),
+       MakeArray<arrow::LargeStringBuilder>(
+           kNumEdges, [](size_t e) { return std::optional(Type(e)); }),
+       MakeArray<Builder>(kNumEdges, [&](size_t e) { return id(Dest(e)); })});
+  return {nodes, edges};
+}
+
+/// Check that column name of labels is true exactly where expected is
+template <typename F>
+void
+CheckLabel(const arrow::Table& labels, const std::string& name, F expected) {
+  auto column = labels.GetColumnByName(name);
+  KATANA_LOG_VASSERT(column, "no label {}", name);
+  auto array = katana::CombinedArray(column);
+  KATANA_LOG_ASSERT(array);
+  const auto& bools = static_cast<const arrow::BooleanArray&>(*array.value());
+  for (int64_t i = 0; i < bools.length(); ++i) {
+    KATANA_LOG_VASSERT(
+        bools.IsValid(i) && bools.Value(i) == expected(i), "label {} of {}",
+        name, i);
+  }
+}
+
+void
+CheckComponents(const katana::GraphComponents& g) {
+  const katana::GraphTopology& topo = g.topology;
+  KATANA_LOG_ASSERT(topo.num_nodes() == kNumNodes);
+  KATANA_LOG_ASSERT(topo.num_edges() == kNumEdges);
+
+  // Node properties are every column but the labels
+  const arrow::Table& nodes = *g.nodes.properties;
+  KATANA_LOG_ASSERT(nodes.num_columns() == 2);
+  KATANA_LOG_ASSERT(nodes.GetColumnByName("id"));
+  auto ages = katana::CombinedArray(nodes.GetColumnByName("age"));
+  KATANA_LOG_ASSERT(ages);
+  for (size_t i = 0; i < kNumNodes; ++i) {
+    KATANA_LOG_ASSERT(
+        static_cast<const arrow::Int64Array&>(*ages.value()).Value(i) ==
+        static_cast<int64_t>(i));
+  }
+  KATANA_LOG_ASSERT(g.nodes.labels->num_columns() == 3);
+  for (const char* label : {"a", "b", "c"}) {
+    CheckLabel(*g.nodes.labels, label, [&](size_t i) {
+      return Label(i) == label;
+    });
+  }
+
+  // Edges are sorted by source, and in input order for each source
+  const arrow::Table& edges = *g.edges.properties;
+  KATANA_LOG_ASSERT(edges.num_columns() == 1);
+  auto weights = katana::CombinedArray(edges.GetColumnByName("weight"));
+  KATANA_LOG_ASSERT(weights);
+  const auto& input_rows =
+      static_cast<const arrow::UInt64Array&>(*weights.value());
+  std::vector<size_t> degrees(kNumNodes);
+  for (size_t e = 0; e < kNumEdges; ++e) {
+    ++degrees[Source(e)];
+  }
+  for (size_t n = 0; n < kNumNodes; ++n) {
+    auto range = topo.edges(n);
+    KATANA_LOG_VASSERT(
+        range.size() == degrees[n], "degree of {} is {}, expected {}", n,
+        range.size(), degrees[n]);
+    std::optional<uint64_t> prev;
+    for (auto e : range) {
+      uint64_t row = input_rows.Value(e);
+      KATANA_LOG_ASSERT(Source(row) == n && topo.edge_dest(e) == Dest(row));
+      KATANA_LOG_ASSERT(!prev || *prev < row);
+      prev = row;
+    }
+  }
+  KATANA_LOG_ASSERT(g.edges.labels->num_columns() == 2);
+  CheckLabel(*g.edges.labels, "x", [&](size_t e) {
+    return Type(input_rows.Value(e)) == "x";
+  });
+}
+
+void
+TestImport() {
+  katana::BulkImportOptions opts;
+  opts.node_label_column = "label";
+  opts.edge_type_column = "type";
+
+  auto [nodes, edges] = MakeTables<arrow::LargeStringBuilder>(
+      [](size_t i) { return std::optional(StringId(i)); });
+  auto g = katana::ImportTables(nodes, edges, opts);
+  KATANA_LOG_VASSERT(g, "{}", g.error());
+  CheckComponents(g.value());
+  KATANA_LOG_ASSERT(katana::ConvertToPropertyGraph(std::move(g.value())));
+
+  // Integer ids of any width
+  auto [int_nodes, int_edges] = MakeTables<arrow::Int32Builder>(
+      [](size_t i) { return static_cast<int32_t>(Id(i)); });
+  auto int_g = katana::ImportTables(int_nodes, int_edges, opts);
+  KATANA_LOG_VASSERT(int_g, "{}", int_g.error());
+  CheckComponents(int_g.value());
+}
+
+void
+TestErrors() {
+  katana::BulkImportOptions opts;
+
+  // Duplicate node ids
+  auto [nodes, edges] = MakeTables<arrow::Int64Builder>(
+      [](size_t i) { return Id(i % (kNumNodes - 1)); });
+  KATANA_LOG_ASSERT(!katana::ImportTables(nodes, edges, opts));
+
+  // An edge to an id that is not a node
+  auto [nodes2, edges2] = MakeTables<arrow::Int64Builder>(Id);
+  auto unknown = MakeTable(
+      {"src", "dst"},
+      {MakeArray<arrow::Int64Builder>(1, [](size_t) { return Id(0); }),
+       MakeArray<arrow::Int64Builder>(1, [](size_t) { return int64_t{-1}; })});
+  KATANA_LOG_ASSERT(katana::ImportTables(nodes2, edges2, opts));
+  KATANA_LOG_ASSERT(!katana::ImportTables(nodes2, unknown, opts));
+
+  // Missing columns
+  opts.edge_source_column = "source";
+  KATANA_LOG_ASSERT(!katana::ImportTables(nodes2, edges2, opts));
+}
+
+/// Ids that are already node ids, with a fixed width property that is
+/// gathered with the destinations and a string property that is not
+void
+TestEdgeList() {
+  auto sources = MakeArray<arrow::Int64Builder>(
+      kNumEdges, [](size_t e) { return static_cast<int64_t>(Source(e)); });
+  auto dests = MakeArray<arrow::UInt32Builder>(
+      kNumEdges, [](size_t e) { return static_cast<uint32_t>(Dest(e)); });
+  auto properties = MakeTable(
+      {"weight", "type"},
+      {MakeArray<arrow::UInt64Builder>(kNumEdges, [](size_t e) { return e; }),
+       MakeArray<arrow::LargeStringBuilder>(
+           kNumEdges, [](size_t e) { return std::optional(Type(e)); })});
+
+  auto g = katana::ImportEdgeList(sources, dests, properties);
+  KATANA_LOG_VASSERT(g, "{}", g.error());
+  const katana::GraphTopology& topo = g.value().topology;
+  KATANA_LOG_ASSERT(topo.num_nodes() == kNumNodes);
+  KATANA_LOG_ASSERT(topo.num_edges() == kNumEdges);
+  KATANA_LOG_ASSERT(g.value().nodes.properties->num_rows() == kNumNodes);
+
+  const arrow::Table& edges = *g.value().edges.properties;
+  auto weights = katana::CombinedArray(edges.GetColumnByName("weight"));
+  auto types = katana::CombinedArray(edges.GetColumnByName("type"));
+  KATANA_LOG_ASSERT(weights && types);
+  const auto& rows = static_cast<const arrow::UInt64Array&>(*weights.value());
+  const auto& type_strings =
+      static_cast<const arrow::LargeStringArray&>(*types.value());
+  for (size_t n = 0; n < kNumNodes; ++n) {
+    std::optional<uint64_t> prev;
+    for (auto e : topo.edges(n)) {
+      uint64_t row = rows.Value(e);
+      KATANA_LOG_ASSERT(Source(row) == n && topo.edge_dest(e) == Dest(row));
+      KATANA_LOG_ASSERT(type_strings.GetString(e) == Type(row));
+      KATANA_LOG_ASSERT(!prev || *prev < row);
+      prev = row;
+    }
+  }
+  KATANA_LOG_ASSERT(katana::ConvertToPropertyGraph(std::move(g.value())));
+
+  auto negative = MakeArray<arrow::Int64Builder>(
+      kNumEdges, [](size_t e) { return e == 7 ? int64_t{-1} : int64_t{0}; });
+  KATANA_LOG_ASSERT(!katana::ImportEdgeList(negative, dests, nullptr));
+  // Lengths differ
+  KATANA_LOG_ASSERT(
+      !katana::ImportEdgeList(sources, negative->Slice(1), nullptr));
+}
+
+void
+TestCsv() {
+  auto uri_res = katana::Uri::MakeRand("/tmp/bulkimport");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string dir(uri_res.value().path());  // path() because local
+  fs::create_directories(dir);
+  std::string nodes_path = dir + "/nodes.csv";
+  std::string edges_path = dir + "/edges.csv";
+  {
+    std::ofstream nodes(nodes_path);
+    nodes << "id,name\n";
+    for (size_t i = 0; i < kNumNodes; ++i) {
+      nodes << StringId(i) << ",name" << i << "\n";
+    }
+    std::ofstream edges(edges_path);
+    edges << "src,dst,weight\n";
+    for (size_t e = 0; e < kNumEdges; ++e) {
+      edges << StringId(Source(e)) << "," << StringId(Dest(e)) << "," << e
+            << "\n";
+    }
+  }
+
+  auto g = katana::ImportFiles(
+      {nodes_path}, {edges_path, edges_path}, katana::SourceType::kCsv,
+      katana::BulkImportOptions());
+  fs::remove_all(dir);
+  KATANA_LOG_VASSERT(g, "{}", g.error());
+  KATANA_LOG_ASSERT(g.value().topology.num_nodes() == kNumNodes);
+  KATANA_LOG_ASSERT(g.value().topology.num_edges() == 2 * kNumEdges);
+  auto names = g.value().nodes.properties->GetColumnByName("name");
+  KATANA_LOG_ASSERT(names && names->type()->Equals(arrow::large_utf8()));
+  KATANA_LOG_ASSERT(g.value().nodes.labels->num_columns() == 0);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestImport();
+  TestErrors();
+  TestEdgeList();
+  TestCsv();
+
+  return 0;
+}
@@ -0,0 +1,137 @@
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyViews.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+/// The value of element i, or nullopt if it is null
+std::optional<uint32_t>
+Value(size_t i) {
+  if (i % 11 == 0) {
+    return std::nullopt;
+  }
+  return i * 3;
+}
+
+/// Make a column of values Value(0)... split into chunks of the given sizes
+std::shared_ptr<arrow::ChunkedArray>
+MakeColumn(const std::vector<size_t>& chunk_sizes) {
+  std::vector<std::shared_ptr<arrow::Array>> chunks;
+  size_t i = 0;
+  for (size_t chunk_size : chunk_sizes) {
+    arrow::UInt32Builder builder;
+    for (size_t end = i + chunk_size; i < end; ++i) {
+      auto v = Value(i);
+      KATANA_LOG_ASSERT((v ? builder.Append(*v) : builder.AppendNull()).ok());
+    }
+    std::shared_ptr<arrow::Array> chunk;
+    KATANA_LOG_ASSERT(builder.Finish(&chunk).ok());
+    chunks.emplace_back(chunk);
+  }
+  return std::make_shared<arrow::ChunkedArray>(chunks, arrow::uint32());
+}
+
+size_t
+Sum(const std::vector<size_t>& sizes) {
+  size_t sum = 0;
+  for (size_t size : sizes) {
+    sum += size;
+  }
+  return sum;
+}
+
+void
+CheckView(const std::vector<size_t>& chunk_sizes) {
+  using View = katana::ChunkedPropertyView<katana::UInt32Property>;
+  auto view_result = View::Make(MakeColumn(chunk_sizes));
+  KATANA_LOG_VASSERT(view_result, "{}", view_result.error());
+  View view = std::move(view_result.value());
+
+  size_t size = Sum(chunk_sizes);
+  KATANA_LOG_ASSERT(view.size() == size);
+  for (size_t i = 0; i < size; ++i) {
+    auto v = Value(i);
+    KATANA_LOG_VASSERT(view.IsValid(i) == v.has_value(), "element {}", i);
+    if (v) {
+      KATANA_LOG_VASSERT(
+          view[i] == *v, "element {} is {}, expected {}", i, view[i], *v);
+    }
+    auto [c, j] = view.Locate(i);
+    KATANA_LOG_ASSERT(view.chunk_begin(c) + j == i && i < view.chunk_end(c));
+  }
+
+  // Writes through the view reach the chunks
+  katana::DoAllChunkAligned(
+      &view, [](auto& chunk, size_t i, size_t j) { chunk[j] = i + 1; }, 100);
+  for (size_t i = 0; i < size; ++i) {
+    KATANA_LOG_ASSERT(view.GetValue(i) == i + 1);
+  }
+}
+
+void
+TestViews() {
+  CheckView({});
+  CheckView({1});
+  CheckView({1000});
+  // Empty chunks are skipped
+  CheckView({0, 500, 0, 700, 0});
+  // Many chunks smaller than a lookup block
+  CheckView(std::vector<size_t>(300, 5));
+  // Mixed sizes, so a block may hold several chunk boundaries
+  CheckView({3, 1, 4, 1000, 5, 9, 2, 6, 5000, 3, 5, 8, 9, 70});
+
+  // A chunk of the wrong type is an error
+  std::vector<std::shared_ptr<arrow::Array>> chunks{
+      MakeColumn({10})->chunk(0)};
+  auto wrong = katana::ChunkedPropertyView<katana::UInt64Property>::Make(
+      std::make_shared<arrow::ChunkedArray>(chunks));
+  KATANA_LOG_ASSERT(!wrong);
+}
+
+void
+TestGraphProperty() {
+  constexpr size_t kNumNodes = 1000;
+  LinePolicy policy{2};
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<uint32_t>(kNumNodes, 0, &policy);
+
+  std::vector<size_t> chunk_sizes{100, 250, 650};
+  auto column = MakeColumn(chunk_sizes);
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field("value", arrow::uint32())}), {column});
+  KATANA_LOG_ASSERT(g->AddNodeProperties(table));
+
+  auto view_result =
+      katana::MakeNodeChunkedPropertyView<katana::UInt32Property>(
+          g.get(), "value");
+  KATANA_LOG_VASSERT(view_result, "{}", view_result.error());
+  KATANA_LOG_ASSERT(view_result.value().num_chunks() == chunk_sizes.size());
+  KATANA_LOG_ASSERT(view_result.value()[kNumNodes - 1] == *Value(999));
+
+  KATANA_LOG_ASSERT(
+      !katana::MakeNodeChunkedPropertyView<katana::UInt32Property>(
+          g.get(), "missing"));
+
+  // Single array views still require one chunk
+  KATANA_LOG_ASSERT(!katana::internal::MakeNodePropertyViews<
+                    std::tuple<katana::UInt32Property>>(g.get(), {"value"}));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestViews();
+  TestGraphProperty();
+
+  return 0;
+}
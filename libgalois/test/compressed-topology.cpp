@@ -0,0 +1,250 @@
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "katana/CompressedGraphTopology.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/URI.h"
+#include "katana/analytics/bfs/bfs.h"
+#include "tsuba/CSRTopology.h"
+
+void
+TestRoundTrip(const katana::GraphTopology& topo, uint64_t edges_per_block) {
+  katana::CompressedGraphTopology compressed =
+      katana::CompressedGraphTopology::Make(topo, edges_per_block);
+  KATANA_LOG_ASSERT(compressed.num_nodes() == topo.num_nodes());
+  KATANA_LOG_ASSERT(compressed.num_edges() == topo.num_edges());
+
+  for (auto node : topo.all_nodes()) {
+    KATANA_LOG_ASSERT(compressed.degree(node) == topo.degree(node));
+    auto e = *topo.edges(node).begin();
+    for (auto it = compressed.dests(node).begin(),
+              end = compressed.dests(node).end();
+         it != end; ++it, ++e) {
+      KATANA_LOG_ASSERT(it.edge() == e);
+      KATANA_LOG_ASSERT(*it == topo.edge_dest(e));
+    }
+    KATANA_LOG_ASSERT(e == *topo.edges(node).end());
+  }
+
+  for (auto e : topo.all_edges()) {
+    KATANA_LOG_ASSERT(compressed.edge_dest(e) == topo.edge_dest(e));
+  }
+
+  auto decompressed_res = compressed.Decompress();
+  KATANA_LOG_ASSERT(decompressed_res);
+  KATANA_LOG_ASSERT(decompressed_res.value().Equals(topo));
+}
+
+void
+TestCorrupt(const katana::GraphTopology& topo) {
+  katana::CompressedGraphTopology compressed =
+      katana::CompressedGraphTopology::Make(topo);
+  KATANA_LOG_ASSERT(compressed.payload_size() > 0);
+
+  // Claim one less byte of payload than was written
+  std::vector<uint64_t> offsets(
+      compressed.block_offset_data(),
+      compressed.block_offset_data() + compressed.num_blocks() + 1);
+  offsets.back() -= 1;
+  katana::CompressedGraphTopology truncated(
+      compressed.adj_data(), compressed.num_nodes(), compressed.num_edges(),
+      compressed.edges_per_block(), offsets.data(), compressed.num_blocks(),
+      compressed.payload_data(), compressed.payload_size() - 1);
+  KATANA_LOG_ASSERT(!truncated.Decompress());
+  KATANA_LOG_ASSERT(!truncated.Validate());
+  KATANA_LOG_ASSERT(compressed.Validate());
+
+  // Drop the last node, so that the edges into it point past the end
+  std::vector<katana::GraphTopology::Edge> adj_indices{1, 1, 1};
+  std::vector<katana::GraphTopology::Node> dests{2};
+  katana::CompressedGraphTopology to_last =
+      katana::CompressedGraphTopology::Make(katana::GraphTopology(
+          adj_indices.data(), adj_indices.size(), dests.data(), dests.size()));
+  katana::CompressedGraphTopology past_end(
+      to_last.adj_data(), 2, to_last.num_edges(), to_last.edges_per_block(),
+      to_last.block_offset_data(), to_last.num_blocks(),
+      to_last.payload_data(), to_last.payload_size());
+  KATANA_LOG_ASSERT(to_last.Validate());
+  KATANA_LOG_ASSERT(!past_end.Validate());
+
+  // Adjacency indices that decrease
+  std::vector<katana::GraphTopology::Edge> unsorted{2, 1, 3};
+  std::vector<katana::GraphTopology::Node> chain_dests{1, 2, 0};
+  std::vector<katana::GraphTopology::Edge> sorted{1, 2, 3};
+  katana::CompressedGraphTopology chain =
+      katana::CompressedGraphTopology::Make(katana::GraphTopology(
+          sorted.data(), sorted.size(), chain_dests.data(),
+          chain_dests.size()));
+  katana::CompressedGraphTopology decreasing(
+      unsorted.data(), unsorted.size(), chain.num_edges(),
+      chain.edges_per_block(), chain.block_offset_data(), chain.num_blocks(),
+      chain.payload_data(), chain.payload_size());
+  KATANA_LOG_ASSERT(chain.Validate());
+  KATANA_LOG_ASSERT(!decreasing.Validate());
+}
+
+std::vector<uint32_t>
+SerialBfs(const katana::GraphTopology& topo, uint32_t source) {
+  std::vector<uint32_t> dist(
+      topo.num_nodes(), std::numeric_limits<uint32_t>::max());
+  std::deque<uint32_t> queue{source};
+  dist[source] = 0;
+  while (!queue.empty()) {
+    uint32_t n = queue.front();
+    queue.pop_front();
+    for (auto e : topo.edges(n)) {
+      uint32_t dest = topo.edge_dest(e);
+      if (dist[dest] == std::numeric_limits<uint32_t>::max()) {
+        dist[dest] = dist[n] + 1;
+        queue.push_back(dest);
+      }
+    }
+  }
+  return dist;
+}
+
+/// A compressed graph on storage is loaded and searched without
+/// decompressing it
+void
+TestLoadCompressed(const katana::GraphTopology& topo, bool compress) {
+  auto pg_res =
+      katana::PropertyGraph::Make(katana::GraphTopology::Copy(topo));
+  KATANA_LOG_ASSERT(pg_res);
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/compressedtopology");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  if (compress) {
+    setenv("KATANA_COMPRESS_TOPOLOGY", "1", 1);
+  }
+  auto write_res = pg_res.value()->Write(rdg_dir, "compressed-topology");
+  unsetenv("KATANA_COMPRESS_TOPOLOGY");
+  if (!write_res) {
+    boost::filesystem::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_res.error());
+  }
+
+  auto compressed_res = katana::PropertyGraph::LoadCompressedTopology(rdg_dir);
+  boost::filesystem::remove_all(rdg_dir);
+  KATANA_LOG_ASSERT(compressed_res);
+  const katana::CompressedGraphTopology& compressed = compressed_res.value();
+  KATANA_LOG_ASSERT(compressed.num_nodes() == topo.num_nodes());
+  KATANA_LOG_ASSERT(compressed.num_edges() == topo.num_edges());
+
+  for (uint32_t source : {0U, static_cast<uint32_t>(topo.num_nodes() / 2)}) {
+    auto dist_res =
+        katana::analytics::CompressedBfsDistances(compressed, source);
+    KATANA_LOG_ASSERT(dist_res);
+    std::vector<uint32_t> expected = SerialBfs(topo, source);
+    for (size_t n = 0; n < expected.size(); ++n) {
+      KATANA_LOG_VASSERT(
+          dist_res.value()[n] == expected[n], "node {}: {} != {}", n,
+          dist_res.value()[n], expected[n]);
+    }
+  }
+
+  KATANA_LOG_ASSERT(!katana::analytics::CompressedBfsDistances(
+      compressed, compressed.num_nodes()));
+}
+
+/// A compressed graph on storage whose destinations are corrupt fails to
+/// load instead of being searched
+void
+TestLoadCorrupt(const katana::GraphTopology& topo) {
+  auto pg_res =
+      katana::PropertyGraph::Make(katana::GraphTopology::Copy(topo));
+  KATANA_LOG_ASSERT(pg_res);
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/compressedtopology");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  setenv("KATANA_COMPRESS_TOPOLOGY", "1", 1);
+  auto write_res = pg_res.value()->Write(rdg_dir, "compressed-topology");
+  unsetenv("KATANA_COMPRESS_TOPOLOGY");
+  if (!write_res) {
+    boost::filesystem::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_res.error());
+  }
+
+  // Overwrite the payload with bytes that each decode to a delta of -64,
+  // i.e., to destinations before node 0
+  uint64_t num_corrupted = 0;
+  for (const auto& entry : boost::filesystem::directory_iterator(rdg_dir)) {
+    if (entry.path().filename().string().rfind("topology", 0) != 0) {
+      continue;
+    }
+    std::fstream file(
+        entry.path().string(),
+        std::ios::in | std::ios::out | std::ios::binary);
+    tsuba::CSRTopologyHeader header;
+    tsuba::CompressedCSRTopologyHeader compressed_header;
+    uint64_t compressed_header_offset =
+        sizeof(header) + topo.num_nodes() * sizeof(uint64_t);
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    KATANA_LOG_ASSERT(
+        file && header.version == tsuba::kCompressedCSRTopologyVersion);
+    file.seekg(compressed_header_offset);
+    file.read(
+        reinterpret_cast<char*>(&compressed_header), sizeof(compressed_header));
+    KATANA_LOG_ASSERT(file);
+    uint64_t payload_offset = compressed_header_offset +
+                              sizeof(compressed_header) +
+                              (compressed_header.num_blocks + 1) *
+                                  sizeof(uint64_t);
+    std::string garbage(compressed_header.payload_size, '\x7f');
+    file.seekp(payload_offset);
+    file.write(garbage.data(), garbage.size());
+    KATANA_LOG_ASSERT(file);
+    ++num_corrupted;
+  }
+  KATANA_LOG_ASSERT(num_corrupted == 1);
+
+  auto compressed_res = katana::PropertyGraph::LoadCompressedTopology(rdg_dir);
+  boost::filesystem::remove_all(rdg_dir);
+  KATANA_LOG_ASSERT(
+      !compressed_res &&
+      compressed_res.error() == katana::ErrorCode::InvalidArgument);
+}
+
+int
+main() {
+  katana::SharedMemSys S;
+
+  constexpr size_t kNumNodes = 1000;
+  constexpr size_t kEdgesPerNode = 5;
+
+  katana::GraphTopology topo =
+      katana::CreateUniformRandomTopology(kNumNodes, kEdgesPerNode);
+
+  TestRoundTrip(topo, 1);
+  TestRoundTrip(topo, 3);
+  TestRoundTrip(
+      topo, katana::CompressedGraphTopology::kDefaultEdgesPerBlock);
+  TestRoundTrip(katana::GraphTopology{}, 16);
+
+  // Nodes without edges, both leading and trailing
+  std::vector<katana::GraphTopology::Edge> adj_indices{0, 3, 3, 5, 5};
+  std::vector<katana::GraphTopology::Node> dests{2, 0, 4, 1, 1};
+  katana::GraphTopology sparse(
+      adj_indices.data(), adj_indices.size(), dests.data(), dests.size());
+  TestRoundTrip(sparse, 1);
+  TestRoundTrip(sparse, 2);
+
+  TestCorrupt(topo);
+
+  TestLoadCompressed(topo, true);
+  TestLoadCompressed(topo, false);
+  TestLoadCorrupt(topo);
+
+  return 0;
+}
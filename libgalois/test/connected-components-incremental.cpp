@@ -0,0 +1,142 @@
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/connected_components/connected_components.h"
+
+namespace {
+
+using EdgeList = std::vector<std::pair<uint32_t, uint32_t>>;
+
+constexpr uint32_t kNumNodes = 3000;
+
+/// The symmetric graph with edges in both directions
+std::unique_ptr<katana::PropertyGraph>
+MakeSymmetric(const EdgeList& edges) {
+  std::vector<std::vector<uint32_t>> adjacency(kNumNodes);
+  for (const auto& [src, dest] : edges) {
+    adjacency[src].emplace_back(dest);
+    adjacency[dest].emplace_back(src);
+  }
+  katana::GraphTopology::AdjIndexVec adj_indices;
+  adj_indices.allocateInterleaved(kNumNodes);
+  katana::GraphTopology::EdgeDestVec dests;
+  dests.allocateInterleaved(2 * edges.size());
+  uint64_t end = 0;
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    for (uint32_t dest : adjacency[n]) {
+      dests[end++] = dest;
+    }
+    adj_indices[n] = end;
+  }
+  auto res = katana::PropertyGraph::Make(
+      katana::GraphTopology(std::move(adj_indices), std::move(dests)));
+  KATANA_LOG_VASSERT(res, "making graph: {}", res.error());
+  return std::move(res.value());
+}
+
+std::shared_ptr<arrow::UInt64Array>
+Components(katana::PropertyGraph* pg, const std::string& name) {
+  auto res = pg->GetNodePropertyTyped<uint64_t>(name);
+  KATANA_LOG_VASSERT(res, "getting {}: {}", name, res.error());
+  return res.value();
+}
+
+/// Insert the edges incrementally and compare with recomputing: the
+/// components must be the same and each must keep the smallest of the labels
+/// its nodes had
+void
+CheckInsert(const EdgeList& before, const EdgeList& inserted) {
+  auto old_graph = MakeSymmetric(before);
+  KATANA_LOG_ASSERT(
+      katana::analytics::ConnectedComponents(old_graph.get(), "component"));
+
+  EdgeList after = before;
+  after.insert(after.end(), inserted.begin(), inserted.end());
+  auto new_graph = MakeSymmetric(after);
+
+  auto old_components = old_graph->GetNodeProperty("component");
+  KATANA_LOG_ASSERT(old_components);
+  KATANA_LOG_ASSERT(new_graph->AddNodeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("component", arrow::uint64())}),
+      {old_components.value()})));
+
+  auto res = katana::analytics::ConnectedComponentsIncremental(
+      new_graph.get(), "component", inserted);
+  KATANA_LOG_VASSERT(res, "updating: {}", res.error());
+  KATANA_LOG_ASSERT(
+      katana::analytics::ConnectedComponents(new_graph.get(), "expected"));
+
+  auto old_labels = Components(old_graph.get(), "component");
+  auto updated = Components(new_graph.get(), "component");
+  auto expected = Components(new_graph.get(), "expected");
+  std::unordered_map<uint64_t, uint64_t> smallest;
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    auto [it, inserted_label] =
+        smallest.emplace(expected->Value(n), old_labels->Value(n));
+    if (!inserted_label) {
+      it->second = std::min(it->second, old_labels->Value(n));
+    }
+  }
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    KATANA_LOG_VASSERT(
+        updated->Value(n) == smallest.at(expected->Value(n)),
+        "node {} has component {}, expected {}", n, updated->Value(n),
+        smallest.at(expected->Value(n)));
+  }
+}
+
+EdgeList
+RandomEdges(std::mt19937* gen, uint64_t num_edges) {
+  std::uniform_int_distribution<uint32_t> node(0, kNumNodes - 1);
+  EdgeList edges;
+  while (edges.size() < num_edges) {
+    edges.emplace_back(node(*gen), node(*gen));
+  }
+  return edges;
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  // Sparse enough to leave many components
+  std::mt19937 gen(0);
+  EdgeList edges = RandomEdges(&gen, kNumNodes / 2);
+
+  for (uint64_t batch : {1, 100, 1000}) {
+    CheckInsert(edges, RandomEdges(&gen, batch));
+  }
+
+  // A chain through many components merges them all in one batch
+  EdgeList chain;
+  for (uint32_t n = kNumNodes - 1; n > kNumNodes - 500; --n) {
+    chain.emplace_back(n, n - 1);
+  }
+  CheckInsert(edges, chain);
+
+  // Edges within a component change nothing
+  CheckInsert(edges, EdgeList(edges.begin(), edges.begin() + 100));
+
+  auto pg = MakeSymmetric(edges);
+  KATANA_LOG_ASSERT(
+      katana::analytics::ConnectedComponents(pg.get(), "component"));
+  auto missing = katana::analytics::ConnectedComponentsIncremental(
+      pg.get(), "component", {{0, kNumNodes}});
+  KATANA_LOG_ASSERT(
+      !missing && missing.error() == katana::ErrorCode::InvalidArgument);
+
+  return 0;
+}
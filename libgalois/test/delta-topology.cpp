@@ -0,0 +1,112 @@
+#include <algorithm>
+#include <set>
+#include <vector>
+
+#include "katana/DeltaGraphTopology.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+
+// The multiset of destinations of each node
+using Reference = std::vector<std::multiset<Node>>;
+
+Reference
+MakeReference(const katana::GraphTopology& topo) {
+  Reference ret(topo.num_nodes());
+  for (auto node : topo.all_nodes()) {
+    for (auto e : topo.edges(node)) {
+      ret[node].insert(topo.edge_dest(e));
+    }
+  }
+  return ret;
+}
+
+template <typename Topo>
+void
+CheckMatches(const Topo& topo, const Reference& expected) {
+  KATANA_LOG_ASSERT(topo.num_nodes() == expected.size());
+  uint64_t num_edges = 0;
+  for (auto node : topo.all_nodes()) {
+    std::multiset<Node> dests;
+    for (auto e : topo.edges(node)) {
+      dests.insert(topo.edge_dest(e));
+    }
+    KATANA_LOG_VASSERT(dests == expected[node], "node {}", node);
+    KATANA_LOG_ASSERT(topo.degree(node) == expected[node].size());
+    num_edges += dests.size();
+  }
+  KATANA_LOG_ASSERT(topo.num_edges() == num_edges);
+}
+
+void
+TestUpdates(const katana::GraphTopology& base) {
+  katana::DeltaGraphTopology delta(katana::GraphTopology::Copy(base));
+  Reference expected = MakeReference(base);
+  CheckMatches(delta, expected);
+  KATANA_LOG_ASSERT(delta.delta_size() == 0);
+
+  delta.AddNodes(2);
+  expected.resize(expected.size() + 2);
+  Node new_node = delta.num_nodes() - 1;
+
+  // Delete the first edge of every third node and insert two edges at every
+  // fifth
+  for (Node node = 0; node < base.num_nodes(); ++node) {
+    if (node % 3 == 0 && base.degree(node) > 0) {
+      Node dst = base.edge_dest(*base.edges(node).begin());
+      KATANA_LOG_ASSERT(delta.DeleteEdge(node, dst));
+      expected[node].erase(expected[node].find(dst));
+    }
+    if (node % 5 == 0) {
+      auto res = delta.InsertEdge(node, new_node);
+      KATANA_LOG_ASSERT(res);
+      KATANA_LOG_ASSERT(delta.edge_dest(res.value()) == new_node);
+      KATANA_LOG_ASSERT(delta.InsertEdge(new_node, node));
+      expected[node].insert(new_node);
+      expected[new_node].insert(node);
+    }
+  }
+  CheckMatches(delta, expected);
+
+  // Deleting an inserted edge, then an edge that does not exist
+  KATANA_LOG_ASSERT(delta.DeleteEdge(0, new_node));
+  expected[0].erase(expected[0].find(new_node));
+  KATANA_LOG_ASSERT(!delta.DeleteEdge(0, new_node));
+  KATANA_LOG_ASSERT(!delta.InsertEdge(0, delta.num_nodes()));
+  CheckMatches(delta, expected);
+
+  KATANA_LOG_ASSERT(delta.NeedsCompaction(0));
+
+  katana::GraphTopology::PropIndexVec old_edge_ids;
+  katana::GraphTopology materialized = delta.Materialize(&old_edge_ids);
+  CheckMatches(materialized, expected);
+  for (auto e : materialized.all_edges()) {
+    KATANA_LOG_ASSERT(
+        materialized.edge_dest(e) == delta.edge_dest(old_edge_ids[e]));
+  }
+
+  delta.Compact();
+  KATANA_LOG_ASSERT(delta.delta_size() == 0);
+  KATANA_LOG_ASSERT(delta.base().Equals(materialized));
+  CheckMatches(delta, expected);
+}
+
+int
+main() {
+  katana::SharedMemSys S;
+
+  constexpr size_t kNumNodes = 1000;
+  constexpr size_t kEdgesPerNode = 5;
+
+  TestUpdates(katana::CreateUniformRandomTopology(kNumNodes, kEdgesPerNode));
+
+  std::vector<Edge> adj_indices{0, 3, 3, 5, 5};
+  std::vector<Node> dests{2, 0, 4, 1, 1};
+  TestUpdates(katana::GraphTopology(
+      adj_indices.data(), adj_indices.size(), dests.data(), dests.size()));
+
+  return 0;
+}
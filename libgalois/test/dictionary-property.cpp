@@ -0,0 +1,210 @@
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+#include <boost/filesystem.hpp>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/ArrowInterchange.h"
+#include "katana/Logging.h"
+#include "katana/Properties.h"
+#include "katana/PropertyFilter.h"
+#include "katana/PropertyGraph.h"
+#include "katana/PropertyIndex.h"
+#include "katana/SharedMemSys.h"
+#include "katana/URI.h"
+
+namespace fs = boost::filesystem;
+
+using P = katana::PropertyPredicate;
+
+namespace {
+
+constexpr size_t kNumNodes = 10000;
+
+/// The country of node i, or nullopt if it is null
+std::optional<std::string>
+Country(size_t i) {
+  if (i % 13 == 0) {
+    return std::nullopt;
+  }
+  static const char* kCountries[] = {"us", "fr", "de", "jp", "br"};
+  return kCountries[(i * 7) % 5];
+}
+
+/// Add the dictionary encoded node property country
+void
+AddCountries(katana::PropertyGraph* g) {
+  arrow::LargeStringBuilder builder;
+  for (size_t i = 0; i < g->num_nodes(); ++i) {
+    auto c = Country(i);
+    KATANA_LOG_ASSERT((c ? builder.Append(*c) : builder.AppendNull()).ok());
+  }
+  std::shared_ptr<arrow::Array> strings;
+  KATANA_LOG_ASSERT(builder.Finish(&strings).ok());
+  auto encoded =
+      katana::DictionaryEncode(std::make_shared<arrow::ChunkedArray>(strings));
+  KATANA_LOG_VASSERT(encoded, "{}", encoded.error());
+  KATANA_LOG_ASSERT(g->AddNodeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("country", encoded.value()->type())}),
+      {encoded.value()})));
+}
+
+/// Check that the country property of g is dictionary encoded and decodes
+/// to Country(i)
+void
+CheckCountries(const katana::PropertyGraph& g) {
+  auto column = g.GetNodeProperty("country");
+  KATANA_LOG_VASSERT(column, "{}", column.error());
+  KATANA_LOG_VASSERT(
+      column.value()->type()->id() == arrow::Type::DICTIONARY,
+      "country is {}", column.value()->type()->ToString());
+  auto array = katana::CombinedArray(column.value());
+  KATANA_LOG_ASSERT(array);
+
+  using View = katana::DictionaryPropertyReadOnlyView<int32_t>;
+  auto view_result =
+      View::Make(static_cast<const arrow::DictionaryArray&>(*array.value()));
+  KATANA_LOG_VASSERT(view_result, "{}", view_result.error());
+  const View& view = view_result.value();
+  KATANA_LOG_ASSERT(view.num_codes() == 5);
+  const auto& dictionary =
+      static_cast<const arrow::LargeStringArray&>(*view.dictionary());
+  for (size_t i = 0; i < g.num_nodes(); ++i) {
+    auto c = Country(i);
+    KATANA_LOG_VASSERT(view.IsValid(i) == c.has_value(), "node {}", i);
+    if (c) {
+      KATANA_LOG_VASSERT(
+          dictionary.GetString(view[i]) == *c, "node {} is {}, expected {}", i,
+          dictionary.GetString(view[i]), *c);
+    }
+  }
+
+  // Codes of another width are a type error
+  KATANA_LOG_ASSERT(!katana::DictionaryPropertyReadOnlyView<int64_t>::Make(
+      static_cast<const arrow::DictionaryArray&>(*array.value())));
+}
+
+template <typename Expected>
+void
+CheckFilter(
+    const katana::PropertyGraph& g, const P& predicate,
+    const Expected& expected) {
+  auto selected = g.FilterNodes(predicate);
+  KATANA_LOG_VASSERT(
+      selected, "{}: {}", predicate.ToString(), selected.error());
+  for (size_t i = 0; i < g.num_nodes(); ++i) {
+    KATANA_LOG_VASSERT(
+        selected.value().test(i) == expected(i), "{}: node {}",
+        predicate.ToString(), i);
+  }
+}
+
+void
+TestFilters(const katana::PropertyGraph& g) {
+  auto str = [](const std::string& v) { return arrow::MakeScalar(v); };
+
+  CheckFilter(g, P::Compare("country", P::Op::kEqual, str("fr")), [](size_t i) {
+    return Country(i) == "fr";
+  });
+  CheckFilter(
+      g, P::Compare("country", P::Op::kLess, str("fr")),
+      [](size_t i) { return Country(i) && *Country(i) < "fr"; });
+  CheckFilter(
+      g, P::In("country", {str("jp"), str("us"), str("xx")}),
+      [](size_t i) { return Country(i) == "jp" || Country(i) == "us"; });
+  CheckFilter(
+      g, P::Not(P::Compare("country", P::Op::kEqual, str("de"))),
+      [](size_t i) { return Country(i) != "de"; });
+  KATANA_LOG_ASSERT(!g.FilterNodes(
+      P::Compare("country", P::Op::kEqual, arrow::MakeScalar(int64_t{1}))));
+}
+
+void
+TestIndex(katana::PropertyGraph* g) {
+  using Index =
+      katana::DictionaryPropertyIndex<katana::GraphTopology::Node, int32_t>;
+  KATANA_LOG_ASSERT(
+      !g->MakeNodeIndex("country", katana::PropertyIndexKind::kHash));
+  auto made = g->MakeNodeIndex("country");
+  KATANA_LOG_VASSERT(made, "{}", made.error());
+  const Index* index = nullptr;
+  for (const auto& i : g->node_indexes()) {
+    if (i->column_name() == "country") {
+      index = static_cast<const Index*>(i.get());
+    }
+  }
+  KATANA_LOG_ASSERT(index != nullptr);
+
+  size_t num_valid = 0;
+  for (size_t i = 0; i < g->num_nodes(); ++i) {
+    num_valid += Country(i).has_value();
+  }
+  KATANA_LOG_ASSERT(index->size() == num_valid);
+
+  // Ids are in order of their values, and of their ids for equal values
+  std::optional<std::string> prev_country;
+  size_t prev_id = 0;
+  for (auto it = index->begin(); it != index->end(); ++it) {
+    auto c = Country(*it);
+    KATANA_LOG_ASSERT(c);
+    KATANA_LOG_ASSERT(
+        !prev_country || *prev_country < *c ||
+        (*prev_country == *c && prev_id < *it));
+    prev_country = c;
+    prev_id = *it;
+  }
+
+  auto [first, last] = index->EqualRange("jp");
+  KATANA_LOG_ASSERT(first != last);
+  for (auto it = first; it != last; ++it) {
+    KATANA_LOG_ASSERT(Country(*it) == "jp");
+  }
+  KATANA_LOG_ASSERT(index->Find("jp") == first);
+  KATANA_LOG_ASSERT(index->Find("it") == index->end());
+  KATANA_LOG_ASSERT(index->LowerBound("it") == index->LowerBound("jp"));
+  KATANA_LOG_ASSERT(index->UpperBound("jp") == last);
+  KATANA_LOG_ASSERT(index->LowerBound("zz") == index->end());
+  KATANA_LOG_ASSERT(index->UpperBound("") == index->begin());
+}
+
+void
+TestRoundTrip(katana::PropertyGraph* g) {
+  auto uri_res = katana::Uri::MakeRand("/tmp/dictionaryproperty");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  auto write_result = g->Write(rdg_dir, "dictionary-property");
+  if (!write_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+  auto make_result =
+      katana::PropertyGraph::Make(rdg_dir, tsuba::RDGLoadOptions());
+  fs::remove_all(rdg_dir);
+  KATANA_LOG_VASSERT(make_result, "making result: {}", make_result.error());
+
+  // The property is read back encoded
+  CheckCountries(*make_result.value());
+  TestFilters(*make_result.value());
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  LinePolicy policy{2};
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<uint32_t>(kNumNodes, 0, &policy);
+  AddCountries(g.get());
+
+  CheckCountries(*g);
+  TestFilters(*g);
+  TestIndex(g.get());
+  TestRoundTrip(g.get());
+
+  return 0;
+}
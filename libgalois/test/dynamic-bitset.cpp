@@ -0,0 +1,120 @@
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "katana/DynamicBitset.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+
+namespace {
+
+std::vector<bool>
+RandomBits(size_t n, std::mt19937* gen) {
+  std::vector<bool> ret(n);
+  std::bernoulli_distribution dist(0.3);
+  for (size_t i = 0; i < n; ++i) {
+    ret[i] = dist(*gen);
+  }
+  return ret;
+}
+
+void
+Fill(const std::vector<bool>& bits, katana::DynamicBitset* bitset) {
+  bitset->resize(bits.size());
+  bitset->reset();
+  for (size_t i = 0; i < bits.size(); ++i) {
+    if (bits[i]) {
+      bitset->set(i);
+    }
+  }
+}
+
+template <typename F>
+void
+CheckEqual(
+    const katana::DynamicBitset& bitset, size_t n, const F& expected_bit) {
+  size_t expected_count = 0;
+  std::vector<uint64_t> expected_offsets;
+  for (size_t i = 0; i < n; ++i) {
+    bool expected = expected_bit(i);
+    KATANA_LOG_ASSERT(bitset.test(i) == expected);
+    if (expected) {
+      ++expected_count;
+      expected_offsets.emplace_back(i);
+    }
+  }
+  KATANA_LOG_ASSERT(bitset.count() == expected_count);
+  KATANA_LOG_ASSERT(bitset.GetOffsets<uint64_t>() == expected_offsets);
+
+  std::vector<uint32_t> appended{7};
+  bitset.AppendOffsets(&appended);
+  KATANA_LOG_ASSERT(appended.size() == expected_count + 1);
+  KATANA_LOG_ASSERT(appended[0] == 7);
+  for (size_t i = 0; i < expected_count; ++i) {
+    KATANA_LOG_ASSERT(appended[i + 1] == expected_offsets[i]);
+  }
+}
+
+// Sizes that are not multiples of 64 exercise the last word; large sizes
+// exercise the parallel paths
+void
+TestBitwise(size_t n) {
+  std::mt19937 gen(n);
+  std::vector<bool> a_bits = RandomBits(n, &gen);
+  std::vector<bool> b_bits = RandomBits(n, &gen);
+
+  katana::DynamicBitset a;
+  katana::DynamicBitset b;
+  katana::DynamicBitset c;
+  Fill(a_bits, &a);
+  Fill(b_bits, &b);
+  c.resize(n);
+
+  CheckEqual(a, n, [&](size_t i) { return a_bits[i]; });
+
+  c.bitwise_or(a, b);
+  CheckEqual(c, n, [&](size_t i) { return a_bits[i] || b_bits[i]; });
+
+  c.bitwise_and(a, b);
+  CheckEqual(c, n, [&](size_t i) { return a_bits[i] && b_bits[i]; });
+
+  c.bitwise_xor(a, b);
+  CheckEqual(c, n, [&](size_t i) { return a_bits[i] != b_bits[i]; });
+
+  c.bitwise_and_not(a, b);
+  CheckEqual(c, n, [&](size_t i) { return a_bits[i] && !b_bits[i]; });
+
+  c.bitwise_or(b);
+  CheckEqual(c, n, [&](size_t i) { return a_bits[i] || b_bits[i]; });
+
+  c.bitwise_and_not(a);
+  CheckEqual(c, n, [&](size_t i) { return !a_bits[i] && b_bits[i]; });
+
+  c.bitwise_xor(b);
+  CheckEqual(c, n, [&](size_t i) { return a_bits[i] && b_bits[i]; });
+
+  // The destination may alias the sources
+  c.bitwise_xor(c, c);
+  CheckEqual(c, n, [&](size_t) { return false; });
+
+  // Complemented bits past the end must not be counted
+  c.bitwise_not();
+  CheckEqual(c, n, [&](size_t) { return true; });
+
+  c.bitwise_and(a);
+  CheckEqual(c, n, [&](size_t i) { return a_bits[i]; });
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys Katana_runtime;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxThreads());
+
+  for (size_t n : {0, 1, 63, 64, 1000, 1 << 20, (1 << 20) + 13}) {
+    TestBitwise(n);
+  }
+
+  return 0;
+}
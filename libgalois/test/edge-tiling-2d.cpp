@@ -0,0 +1,109 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+#include "katana/AtomicHelpers.h"
+#include "katana/EdgeTiling2D.h"
+#include "katana/GraphTopology.h"
+#include "katana/Logging.h"
+#include "katana/NUMAArray.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+
+void
+TestTiling(
+    const katana::GraphTopology& topology, const katana::EdgeTiling2D& tiling,
+    bool check_curve) {
+  KATANA_LOG_ASSERT(tiling.num_edges() == topology.num_edges());
+
+  std::vector<std::pair<Node, Node>> expected;
+  for (Node n : topology.all_nodes()) {
+    for (auto e : topology.edges(n)) {
+      expected.emplace_back(n, topology.edge_dest(e));
+    }
+  }
+  std::vector<std::pair<Node, Node>> tiled;
+  uint64_t edge_begin = 0;
+  for (uint64_t t = 0; t < tiling.num_tiles(); ++t) {
+    const katana::EdgeTiling2D::Tile& tile = tiling.tile(t);
+    KATANA_LOG_ASSERT(tile.edge_begin == edge_begin);
+    KATANA_LOG_ASSERT(tile.edge_begin < tile.edge_end);
+    for (uint64_t e = tile.edge_begin; e < tile.edge_end; ++e) {
+      Node src = tiling.edge_src(e);
+      Node dest = tiling.edge_dest(e);
+      KATANA_LOG_ASSERT(tile.src_begin <= src && src < tile.src_end);
+      KATANA_LOG_ASSERT(tile.dest_begin <= dest && dest < tile.dest_end);
+      tiled.emplace_back(src, dest);
+    }
+    edge_begin = tile.edge_end;
+
+    // Consecutive tiles of a full square grid are neighbors on the curve
+    if (check_curve && t > 0) {
+      const katana::EdgeTiling2D::Tile& prev = tiling.tile(t - 1);
+      int64_t rows = std::abs(
+          static_cast<int64_t>(tile.src_begin) - prev.src_begin);
+      int64_t cols = std::abs(
+          static_cast<int64_t>(tile.dest_begin) - prev.dest_begin);
+      KATANA_LOG_ASSERT(
+          (rows == 0 && cols == int64_t(tiling.dest_nodes_per_tile())) ||
+          (cols == 0 && rows == int64_t(tiling.src_nodes_per_tile())));
+    }
+  }
+  std::sort(expected.begin(), expected.end());
+  std::sort(tiled.begin(), tiled.end());
+  KATANA_LOG_ASSERT(expected == tiled);
+
+  katana::NUMAArray<std::atomic<uint64_t>> in_degree;
+  in_degree.allocateInterleaved(topology.num_nodes());
+  for (auto& d : in_degree) {
+    d = 0;
+  }
+  tiling.ForEachEdge(
+      [&](Node, Node dest) { katana::atomicAdd(in_degree[dest], 1UL); });
+  std::vector<uint64_t> expected_in_degree(topology.num_nodes());
+  for (const auto& edge : expected) {
+    ++expected_in_degree[edge.second];
+  }
+  for (Node n : topology.all_nodes()) {
+    KATANA_LOG_ASSERT(in_degree[n] == expected_in_degree[n]);
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  katana::GraphTopology topology =
+      katana::CreateUniformRandomTopology(4096, 8);
+
+  // 8 x 8 tiles, none empty
+  auto square = katana::EdgeTiling2D::Make(topology, 512, 512);
+  KATANA_LOG_VASSERT(square, "{}", square.error());
+  KATANA_LOG_ASSERT(square.value().num_tiles() == 64);
+  TestTiling(topology, square.value(), true);
+
+  auto uneven = katana::EdgeTiling2D::Make(topology, 1000, 300);
+  KATANA_LOG_VASSERT(uneven, "{}", uneven.error());
+  TestTiling(topology, uneven.value(), false);
+
+  katana::EdgeTiling2D::Options opts;
+  opts.cache_bytes = 4096;
+  auto sized = katana::EdgeTiling2D::Make(topology, opts);
+  KATANA_LOG_VASSERT(sized, "{}", sized.error());
+  KATANA_LOG_ASSERT(sized.value().dest_nodes_per_tile() == 512);
+  TestTiling(topology, sized.value(), false);
+
+  KATANA_LOG_ASSERT(katana::EdgeTiling2D::L2CacheBytes() > 0);
+  KATANA_LOG_ASSERT(!katana::EdgeTiling2D::Make(topology, 0, 512));
+
+  return 0;
+}
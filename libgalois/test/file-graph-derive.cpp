@@ -0,0 +1,137 @@
+#include <utility>
+#include <vector>
+
+#include "katana/FileGraph.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+
+namespace {
+
+using Graph = katana::FileGraph;
+/// The (destination, data) of the edges of each node, in order
+using Edges = std::vector<std::vector<std::pair<uint64_t, int>>>;
+
+constexpr size_t kNumNodes = 1000;
+constexpr size_t kNumEdges = 20000;
+
+/// Edges with self loops and multi-edges; edge e has data e
+Edges
+MakeEdges() {
+  Edges edges(kNumNodes);
+  for (size_t e = 0; e < kNumEdges; ++e) {
+    uint64_t src = (e * 13) % kNumNodes;
+    uint64_t dst = e % 50 == 0 ? src : (e * 31 + 5) % kNumNodes;
+    edges[src].emplace_back(dst, e);
+    if (e % 97 == 0) {
+      edges[src].emplace_back(dst, e + kNumEdges);
+    }
+  }
+  return edges;
+}
+
+template <typename EdgeTy>
+void
+Build(const Edges& edges, Graph* out) {
+  using EdgeData = katana::NUMAArray<EdgeTy>;
+  size_t num_edges = 0;
+  for (const auto& node_edges : edges) {
+    num_edges += node_edges.size();
+  }
+
+  katana::FileGraphWriter writer;
+  writer.setNumNodes(edges.size());
+  writer.setNumEdges(num_edges);
+  writer.setSizeofEdgeData(EdgeData::size_of::value);
+  writer.phase1();
+  for (size_t src = 0; src < edges.size(); ++src) {
+    writer.incrementDegree(src, edges[src].size());
+  }
+  writer.phase2();
+  std::vector<int> data(num_edges);
+  for (size_t src = 0; src < edges.size(); ++src) {
+    for (const auto& [dst, d] : edges[src]) {
+      data[writer.addNeighbor(src, dst)] = d;
+    }
+  }
+  auto* raw_data = writer.finish<typename EdgeData::value_type>();
+  if constexpr (EdgeData::has_value) {
+    std::copy(data.begin(), data.end(), raw_data);
+  }
+  *out = std::move(writer);
+}
+
+template <typename EdgeTy>
+void
+CheckEdges(Graph& g, const Edges& expected) {
+  KATANA_LOG_ASSERT(g.size() == expected.size());
+  for (size_t n = 0; n < expected.size(); ++n) {
+    KATANA_LOG_VASSERT(
+        static_cast<size_t>(*g.edge_end(n) - *g.edge_begin(n)) ==
+            expected[n].size(),
+        "node {} has {} edges, expected {}", n,
+        *g.edge_end(n) - *g.edge_begin(n), expected[n].size());
+    size_t i = 0;
+    for (auto e : g.edges(n)) {
+      KATANA_LOG_VASSERT(
+          g.getEdgeDst(e) == expected[n][i].first,
+          "edge {} of {} is to {}, expected {}", i, n, g.getEdgeDst(e),
+          expected[n][i].first);
+      if constexpr (!std::is_void_v<EdgeTy>) {
+        KATANA_LOG_ASSERT(g.getEdgeData<EdgeTy>(e) == expected[n][i].second);
+      }
+      ++i;
+    }
+  }
+}
+
+template <typename EdgeTy>
+void
+TestDerive(const Edges& edges) {
+  Graph g;
+  Build<EdgeTy>(edges, &g);
+
+  // Expected results are those of serial loops over the edges
+  Edges symmetric(kNumNodes);
+  Edges transpose(kNumNodes);
+  Edges permuted(kNumNodes);
+  std::vector<uint64_t> perm(kNumNodes);
+  for (size_t n = 0; n < kNumNodes; ++n) {
+    perm[n] = (n * 7 + 3) % kNumNodes;
+  }
+  for (size_t src = 0; src < kNumNodes; ++src) {
+    for (const auto& [dst, d] : edges[src]) {
+      symmetric[src].emplace_back(dst, d);
+      if (src != dst) {
+        symmetric[dst].emplace_back(src, d);
+      }
+      transpose[dst].emplace_back(src, d);
+      permuted[perm[src]].emplace_back(perm[dst], d);
+    }
+  }
+
+  Graph out;
+  katana::makeSymmetric<EdgeTy>(g, out);
+  CheckEdges<EdgeTy>(out, symmetric);
+  katana::makeTranspose<EdgeTy>(g, out);
+  CheckEdges<EdgeTy>(out, transpose);
+  katana::permute<EdgeTy>(g, perm, out);
+  CheckEdges<EdgeTy>(out, permuted);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  Edges edges = MakeEdges();
+  TestDerive<int>(edges);
+  TestDerive<void>(edges);
+
+  // The empty graph
+  TestDerive<int>(Edges(kNumNodes));
+
+  return 0;
+}
@@ -0,0 +1,196 @@
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+
+namespace {
+
+struct Node : public katana::Lockable {
+  bool in_set{false};
+  uint32_t dist{std::numeric_limits<uint32_t>::max()};
+};
+
+constexpr uint32_t kN = 2000;
+
+// Node i is adjacent to i +- 1 and i +- 7 (mod kN)
+std::vector<uint32_t>
+Neighbors(uint32_t i) {
+  return std::vector<uint32_t>{
+      (i + 1) % kN, (i + kN - 1) % kN, (i + 7) % kN, (i + kN - 7) % kN};
+}
+
+uint32_t
+Priority(uint32_t i) {
+  return (static_cast<uint64_t>(i) * 7919) % kN;
+}
+
+uint32_t
+Weight(uint32_t i, uint32_t j) {
+  return 1 + (i * 31 + j * 17) % 13;
+}
+
+// Greedy maximal independent set in priority order; an ordered executor
+// must give exactly the serial result
+std::vector<bool>
+SerialIndependentSet() {
+  std::vector<uint32_t> order(kN);
+  for (uint32_t i = 0; i < kN; ++i) {
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(), [](uint32_t a, uint32_t b) {
+    return Priority(a) < Priority(b);
+  });
+
+  std::vector<bool> ret(kN);
+  for (uint32_t i : order) {
+    bool in_set = true;
+    for (uint32_t j : Neighbors(i)) {
+      in_set = in_set && !ret[j];
+    }
+    ret[i] = in_set;
+  }
+  return ret;
+}
+
+template <typename... Args>
+std::vector<bool>
+IndependentSet(Args&&... args) {
+  std::vector<Node> nodes(kN);
+  std::vector<uint32_t> items(kN);
+  for (uint32_t i = 0; i < kN; ++i) {
+    items[i] = i;
+  }
+
+  katana::for_each_ordered(
+      items.begin(), items.end(),
+      [](uint32_t a, uint32_t b) { return Priority(a) <= Priority(b); },
+      [&](uint32_t i) {
+        katana::acquire(&nodes[i], katana::MethodFlag::WRITE);
+        for (uint32_t j : Neighbors(i)) {
+          katana::acquire(&nodes[j], katana::MethodFlag::WRITE);
+        }
+      },
+      [&](uint32_t i, auto&) {
+        for (uint32_t j : Neighbors(i)) {
+          if (nodes[j].in_set) {
+            return;
+          }
+        }
+        nodes[i].in_set = true;
+      },
+      std::forward<Args>(args)...);
+
+  std::vector<bool> ret(kN);
+  for (uint32_t i = 0; i < kN; ++i) {
+    ret[i] = nodes[i].in_set;
+  }
+  return ret;
+}
+
+using Item = std::pair<uint32_t, uint32_t>;
+
+std::vector<uint32_t>
+SerialShortestPaths() {
+  std::vector<uint32_t> dist(kN, std::numeric_limits<uint32_t>::max());
+  std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue;
+  queue.emplace(0, 0);
+  while (!queue.empty()) {
+    auto [d, i] = queue.top();
+    queue.pop();
+    if (dist[i] <= d) {
+      continue;
+    }
+    dist[i] = d;
+    for (uint32_t j : Neighbors(i)) {
+      queue.emplace(d + Weight(i, j), j);
+    }
+  }
+  return dist;
+}
+
+// Dijkstra's algorithm with new items pushed by the operator
+std::vector<uint32_t>
+ShortestPaths() {
+  std::vector<Node> nodes(kN);
+  std::vector<Item> items{{0, 0}};
+
+  katana::for_each_ordered(
+      items.begin(), items.end(),
+      [](const Item& a, const Item& b) { return a.first <= b.first; },
+      [&](const Item& item) {
+        katana::acquire(&nodes[item.second], katana::MethodFlag::WRITE);
+      },
+      [&](const Item& item, auto& ctx) {
+        auto [d, i] = item;
+        if (nodes[i].dist <= d) {
+          return;
+        }
+        nodes[i].dist = d;
+        for (uint32_t j : Neighbors(i)) {
+          ctx.push(Item{d + Weight(i, j), j});
+        }
+      });
+
+  std::vector<uint32_t> ret(kN);
+  for (uint32_t i = 0; i < kN; ++i) {
+    ret[i] = nodes[i].dist;
+  }
+  return ret;
+}
+
+// Item 0 pushes 5, which precedes the other items of the first window
+template <typename... Args>
+std::vector<uint32_t>
+CommitSequence(Args&&... args) {
+  std::vector<uint32_t> items{0, 10, 20};
+  std::vector<uint32_t> sequence;
+  katana::for_each_ordered(
+      items.begin(), items.end(),
+      [](uint32_t a, uint32_t b) { return a <= b; }, [](uint32_t) {},
+      [&](uint32_t i, auto& ctx) {
+        sequence.emplace_back(i);
+        if (i == 0) {
+          ctx.push(5U);
+        }
+      },
+      std::forward<Args>(args)...);
+  return sequence;
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys Katana_runtime;
+
+  std::vector<bool> independent_set = SerialIndependentSet();
+  std::vector<uint32_t> dist = SerialShortestPaths();
+
+  for (unsigned threads : {1U, katana::GetThreadPool().getMaxThreads()}) {
+    katana::setActiveThreads(threads);
+    KATANA_LOG_ASSERT(IndependentSet() == independent_set);
+    KATANA_LOG_ASSERT(
+        IndependentSet([](uint32_t i) { return i % 2 == 0; }) ==
+        independent_set);
+    KATANA_LOG_ASSERT(ShortestPaths() == dist);
+
+    // Rejecting the items that 5 may precede keeps priority order
+    KATANA_LOG_ASSERT(
+        CommitSequence([](uint32_t i) { return i < 5; }) ==
+        (std::vector<uint32_t>{0, 5, 10, 20}));
+  }
+
+  // Without a stability test, a pushed item runs after the window that
+  // pushed it, so 5 commits after 10 and 20
+  katana::setActiveThreads(1);
+  KATANA_LOG_ASSERT(
+      CommitSequence() == (std::vector<uint32_t>{0, 10, 20, 5}));
+
+  return 0;
+}
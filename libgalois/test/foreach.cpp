@@ -17,11 +17,13 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include <atomic>
 #include <iostream>
 #include <vector>
 
 #include "katana/Bag.h"
 #include "katana/Galois.h"
+#include "katana/Logging.h"
 
 void
 function_pointer(int x, katana::UserContext<int>&) {
@@ -48,5 +50,64 @@ main() {
   katana::do_all(katana::iterate(v), [&b](int x) { b.push(x); });
   katana::for_each(katana::iterate(b), function_object());
 
+  // Every pushed item is processed exactly once while chunk sizes adapt
+  std::atomic<int> count{0};
+  std::vector<int> roots{1};
+  katana::for_each(
+      katana::iterate(roots),
+      [&count](int x, katana::UserContext<int>& ctx) {
+        ++count;
+        if (x < (1 << 16)) {
+          ctx.push(2 * x);
+          ctx.push(2 * x + 1);
+        }
+      },
+      katana::wl<katana::AdaptivePerSocketChunkFIFO<>>(),
+      katana::loopname("adaptive-chunk"));
+  KATANA_LOG_ASSERT(count == (1 << 17) - 1);
+
+  count = 0;
+  katana::for_each(
+      katana::iterate(roots),
+      [&count](int x, katana::UserContext<int>& ctx) {
+        ++count;
+        if (x < (1 << 16)) {
+          ctx.push(2 * x);
+          ctx.push(2 * x + 1);
+        }
+      },
+      katana::wl<katana::MultiQueue<>>(), katana::loopname("multi-queue"));
+  KATANA_LOG_ASSERT(count == (1 << 17) - 1);
+
+  // Small rounds run on fewer threads but still visit every item, and the
+  // thread count is restored afterwards
+  unsigned threads = katana::getActiveThreads();
+  for (int n : {1, 100, 10000}) {
+    std::atomic<int> visited{0};
+    std::atomic<unsigned> max_tid{0};
+    katana::do_all(
+        katana::iterate(0, n),
+        [&](int) {
+          ++visited;
+          unsigned tid = katana::ThreadPool::getTID();
+          unsigned prev = max_tid.load();
+          while (prev < tid && !max_tid.compare_exchange_weak(prev, tid)) {
+          }
+        },
+        katana::auto_threads(1000), katana::steal(),
+        katana::loopname("auto-threads"));
+    KATANA_LOG_ASSERT(visited == n);
+    KATANA_LOG_ASSERT(max_tid < static_cast<unsigned>((n + 999) / 1000));
+    KATANA_LOG_ASSERT(katana::getActiveThreads() == threads);
+
+    std::vector<int> items(n, 0);
+    count = 0;
+    katana::for_each(
+        katana::iterate(items),
+        [&count](int, katana::UserContext<int>&) { ++count; },
+        katana::auto_threads(1000), katana::loopname("auto-threads-foreach"));
+    KATANA_LOG_ASSERT(count == n);
+  }
+
   return 0;
 }
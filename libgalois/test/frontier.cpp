@@ -0,0 +1,97 @@
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "katana/Frontier.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+
+namespace {
+
+using Representation = katana::Frontier::Representation;
+
+// Push every stride-th node twice and check that each is visited once
+void
+TestRound(
+    katana::Frontier* frontier, uint32_t num_nodes, uint32_t stride,
+    Representation expected) {
+  std::atomic<uint32_t> added{0};
+  katana::do_all(katana::iterate(uint32_t{0}, num_nodes), [&](uint32_t i) {
+    if (i % stride == 0) {
+      added += frontier->Push(i);
+      KATANA_LOG_ASSERT(!frontier->Push(i));
+    }
+  });
+  frontier->Seal();
+
+  uint32_t expected_size = (num_nodes + stride - 1) / stride;
+  KATANA_LOG_ASSERT(added == expected_size);
+  KATANA_LOG_ASSERT(frontier->Size() == expected_size);
+  KATANA_LOG_ASSERT(frontier->representation() == expected);
+  KATANA_LOG_ASSERT(frontier->bitset().count() == expected_size);
+
+  std::vector<std::atomic<uint32_t>> visits(num_nodes);
+  frontier->ForEachActive(
+      [&](uint32_t node) { ++visits[node]; }, katana::loopname("Visit"));
+  for (uint32_t i = 0; i < num_nodes; ++i) {
+    KATANA_LOG_ASSERT(visits[i] == (i % stride == 0 ? 1U : 0U));
+    KATANA_LOG_ASSERT(frontier->Contains(i) == (i % stride == 0));
+  }
+
+  frontier->Clear();
+  KATANA_LOG_ASSERT(frontier->bitset().count() == 0);
+}
+
+void
+TestRepresentations() {
+  constexpr uint32_t kNumNodes = 1 << 20;
+
+  katana::Frontier frontier(kNumNodes);
+  // Reuse one frontier to check that Clear() resets every representation
+  TestRound(&frontier, kNumNodes, 1 << 12, Representation::kSparse);
+  TestRound(&frontier, kNumNodes, 1 << 7, Representation::kCompressed);
+  TestRound(&frontier, kNumNodes, 3, Representation::kDense);
+  TestRound(&frontier, kNumNodes, 1 << 12, Representation::kSparse);
+
+  katana::Frontier moved(std::move(frontier));
+  TestRound(&moved, kNumNodes, 1 << 6, Representation::kCompressed);
+}
+
+// A BFS over a path must take one level per node
+void
+TestLevels() {
+  constexpr uint32_t kNumNodes = 1000;
+
+  katana::Frontier current(kNumNodes);
+  katana::Frontier next(kNumNodes);
+  current.Push(0);
+  current.Seal();
+
+  uint32_t levels = 0;
+  while (!current.empty()) {
+    current.ForEachActive([&](uint32_t node) {
+      if (node + 1 < kNumNodes) {
+        next.Push(node + 1);
+      }
+    });
+    next.Seal();
+    std::swap(current, next);
+    next.Clear();
+    ++levels;
+  }
+  KATANA_LOG_ASSERT(levels == kNumNodes);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys Katana_runtime;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxThreads());
+
+  TestRepresentations();
+  TestLevels();
+
+  return 0;
+}
@@ -0,0 +1,189 @@
+#include <algorithm>
+#include <memory>
+#include <set>
+
+#include <arrow/api.h>
+
+#include "katana/Galois.h"
+#include "katana/GraphGenerators.h"
+#include "katana/Logging.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+
+katana::GraphTopology
+Check(katana::Result<katana::GraphTopology> res) {
+  KATANA_LOG_VASSERT(res, "generating: {}", res.error());
+  return std::move(res.value());
+}
+
+/// Every row is sorted with destinations in range
+void
+CheckRows(const katana::GraphTopology& topo) {
+  for (Node n : topo.all_nodes()) {
+    auto edges = topo.edges(n);
+    for (auto e : edges) {
+      KATANA_LOG_ASSERT(topo.edge_dest(e) < topo.num_nodes());
+      if (e != *edges.begin()) {
+        KATANA_LOG_ASSERT(topo.edge_dest(e - 1) <= topo.edge_dest(e));
+      }
+    }
+  }
+}
+
+/// A generator gives the same graph for any number of threads and
+/// different graphs for different seeds
+template <typename Gen>
+void
+CheckDeterministic(const Gen& gen) {
+  katana::setActiveThreads(1);
+  katana::GraphTopology one = Check(gen(1));
+  katana::setActiveThreads(4);
+  katana::GraphTopology four = Check(gen(1));
+  KATANA_LOG_ASSERT(one.Equals(four));
+  KATANA_LOG_ASSERT(!one.Equals(Check(gen(2))));
+  CheckRows(one);
+}
+
+void
+TestRmat() {
+  katana::RmatOptions opts;
+  opts.scale = 10;
+  opts.edge_factor = 8;
+  CheckDeterministic([&](uint64_t seed) {
+    opts.seed = seed;
+    return katana::GenerateRmatTopology(opts);
+  });
+
+  katana::GraphTopology rmat = Check(katana::GenerateRmatTopology(opts));
+  KATANA_LOG_ASSERT(rmat.num_nodes() == 1024);
+  KATANA_LOG_ASSERT(rmat.num_edges() == 8 * 1024);
+  // Without scrambling, node 0 is in the densest quadrant at every level
+  size_t max_degree = 0;
+  for (Node n : rmat.all_nodes()) {
+    max_degree = std::max(max_degree, rmat.degree(n));
+  }
+  KATANA_LOG_ASSERT(rmat.degree(0) == max_degree);
+
+  katana::RmatOptions bad;
+  bad.a = 0.9;
+  KATANA_LOG_ASSERT(!katana::GenerateRmatTopology(bad));
+  bad = katana::RmatOptions();
+  bad.scale = 33;
+  KATANA_LOG_ASSERT(!katana::GenerateRmatTopology(bad));
+}
+
+void
+TestKronecker() {
+  CheckDeterministic([](uint64_t seed) {
+    return katana::GenerateRmatTopology(
+        katana::RmatOptions::Graph500(10, seed));
+  });
+
+  // Scrambling relabels nodes without changing the degree distribution
+  katana::RmatOptions opts;
+  opts.scale = 10;
+  katana::GraphTopology plain = Check(katana::GenerateRmatTopology(opts));
+  opts.scramble_ids = true;
+  katana::GraphTopology scrambled = Check(katana::GenerateRmatTopology(opts));
+  std::multiset<size_t> plain_degrees;
+  std::multiset<size_t> scrambled_degrees;
+  for (Node n : plain.all_nodes()) {
+    plain_degrees.insert(plain.degree(n));
+    scrambled_degrees.insert(scrambled.degree(n));
+  }
+  KATANA_LOG_ASSERT(plain_degrees == scrambled_degrees);
+  KATANA_LOG_ASSERT(!plain.Equals(scrambled));
+}
+
+void
+TestErdosRenyi() {
+  CheckDeterministic([](uint64_t seed) {
+    return katana::GenerateErdosRenyiTopology(1000, 200000, seed);
+  });
+  katana::GraphTopology er =
+      Check(katana::GenerateErdosRenyiTopology(1000, 200000));
+  KATANA_LOG_ASSERT(er.num_nodes() == 1000);
+  KATANA_LOG_ASSERT(er.num_edges() == 200000);
+
+  KATANA_LOG_ASSERT(!katana::GenerateErdosRenyiTopology(0, 1));
+}
+
+void
+TestChungLu() {
+  CheckDeterministic([](uint64_t seed) {
+    return katana::GenerateChungLuTopology(1000, 200000, 2.5, seed);
+  });
+  katana::GraphTopology cl =
+      Check(katana::GenerateChungLuTopology(1000, 200000));
+  KATANA_LOG_ASSERT(cl.num_edges() == 200000);
+  // Low ids have the highest expected degrees
+  KATANA_LOG_ASSERT(cl.degree(0) > cl.degree(999));
+
+  KATANA_LOG_ASSERT(!katana::GenerateChungLuTopology(1000, 1, 2.0));
+}
+
+void
+TestGrid() {
+  katana::GraphTopology grid = Check(katana::GenerateGridTopology(4, 3, 2));
+  KATANA_LOG_ASSERT(grid.num_nodes() == 24);
+  // 2 * (edges along x + along y + along z)
+  KATANA_LOG_ASSERT(grid.num_edges() == 2 * (3 * 3 * 2 + 4 * 2 * 2 + 4 * 3));
+  CheckRows(grid);
+  // Corner, edge and interior of the x by y plane
+  KATANA_LOG_ASSERT(grid.degree(0) == 3);
+  KATANA_LOG_ASSERT(grid.degree(1) == 4);
+  KATANA_LOG_ASSERT(grid.degree(5) == 5);
+
+  katana::GraphTopology line = Check(katana::GenerateGridTopology(5, 1));
+  KATANA_LOG_ASSERT(line.num_edges() == 8);
+
+  KATANA_LOG_ASSERT(!katana::GenerateGridTopology(0, 1));
+  KATANA_LOG_ASSERT(!katana::GenerateGridTopology(1 << 20, 1 << 20));
+}
+
+void
+TestProperties() {
+  katana::GeneratedPropertiesOptions opts;
+  opts.max_weight = 10;
+  opts.num_node_types = 3;
+  opts.num_edge_types = 2;
+  auto res = katana::MakeGeneratedGraph(
+      Check(katana::GenerateErdosRenyiTopology(100, 1000)), opts);
+  KATANA_LOG_VASSERT(res, "making graph: {}", res.error());
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(res.value());
+
+  auto weights_res = pg->GetEdgeProperty("weight");
+  KATANA_LOG_ASSERT(weights_res);
+  auto weights = std::static_pointer_cast<arrow::UInt32Array>(
+      weights_res.value()->chunk(0));
+  KATANA_LOG_ASSERT(weights->length() == 1000);
+  for (int64_t i = 0; i < weights->length(); ++i) {
+    KATANA_LOG_ASSERT(weights->Value(i) >= 1 && weights->Value(i) <= 10);
+  }
+
+  katana::EntityTypeID type_0 = pg->GetNodeEntityTypeID("node_type_0");
+  KATANA_LOG_ASSERT(type_0 != katana::kInvalidEntityType);
+  KATANA_LOG_ASSERT(pg->GetEdgeEntityTypeID("edge_type_1") !=
+                    katana::kInvalidEntityType);
+  for (Node n : pg->topology().all_nodes()) {
+    KATANA_LOG_ASSERT(pg->GetTypeOfNode(n) != katana::kUnknownEntityType);
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestRmat();
+  TestKronecker();
+  TestErdosRenyi();
+  TestChungLu();
+  TestGrid();
+  TestProperties();
+
+  return 0;
+}
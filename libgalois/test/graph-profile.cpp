@@ -0,0 +1,122 @@
+#include <cstdint>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/GraphProfile.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+
+katana::GraphTopology
+FromAdjacency(const std::vector<std::vector<Node>>& adjacency) {
+  std::vector<Edge> indices;
+  std::vector<Node> dests;
+  for (const auto& edges : adjacency) {
+    dests.insert(dests.end(), edges.begin(), edges.end());
+    indices.emplace_back(dests.size());
+  }
+  return katana::GraphTopology(
+      indices.data(), indices.size(), dests.data(), dests.size());
+}
+
+/// A side by side grid with edges in both directions between neighbors
+katana::GraphTopology
+MakeGrid(uint32_t side) {
+  std::vector<std::vector<Node>> adjacency(side * side);
+  for (uint32_t row = 0; row < side; ++row) {
+    for (uint32_t col = 0; col < side; ++col) {
+      auto& edges = adjacency[row * side + col];
+      if (row > 0) {
+        edges.emplace_back((row - 1) * side + col);
+      }
+      if (col > 0) {
+        edges.emplace_back(row * side + col - 1);
+      }
+      if (col + 1 < side) {
+        edges.emplace_back(row * side + col + 1);
+      }
+      if (row + 1 < side) {
+        edges.emplace_back((row + 1) * side + col);
+      }
+    }
+  }
+  return FromAdjacency(adjacency);
+}
+
+void
+TestGrid() {
+  katana::GraphProfile profile = katana::GraphProfile::Make(MakeGrid(64));
+  KATANA_LOG_ASSERT(profile.num_nodes == 64 * 64);
+  KATANA_LOG_ASSERT(profile.max_degree == 4);
+  KATANA_LOG_ASSERT(!profile.power_law);
+  KATANA_LOG_ASSERT(
+      profile.diameter_class == katana::GraphProfile::kHighDiameter);
+  KATANA_LOG_ASSERT(profile.edges_sorted);
+  KATANA_LOG_ASSERT(profile.sorted_fraction == 1);
+  KATANA_LOG_ASSERT(profile.likely_symmetric);
+}
+
+/// Many nodes with a few edges to a handful of hubs that link to everything,
+/// in descending order
+void
+TestHubs() {
+  constexpr uint32_t kNodes = 4096;
+  constexpr uint32_t kHubs = 4;
+  std::vector<std::vector<Node>> adjacency(kNodes);
+  for (Node n = 0; n < kNodes; ++n) {
+    if (n < kHubs) {
+      for (Node dst = kNodes; dst-- > 0;) {
+        if (dst != n) {
+          adjacency[n].emplace_back(dst);
+        }
+      }
+    } else {
+      for (Node hub = 0; hub < kHubs; ++hub) {
+        adjacency[n].emplace_back(hub);
+      }
+      // Enough edges that the average degree is high
+      for (Node i = 1; i <= 16; ++i) {
+        adjacency[n].emplace_back((n + i) % kNodes);
+      }
+    }
+  }
+
+  katana::GraphProfile profile =
+      katana::GraphProfile::Make(FromAdjacency(adjacency));
+  KATANA_LOG_ASSERT(profile.max_degree == kNodes - 1);
+  KATANA_LOG_ASSERT(
+      profile.diameter_class == katana::GraphProfile::kLowDiameter);
+  KATANA_LOG_ASSERT(profile.probe_levels <= 2);
+  KATANA_LOG_ASSERT(!profile.edges_sorted);
+  KATANA_LOG_ASSERT(profile.sorted_fraction < 1);
+  // Node n links to n + 1, but not the other way around
+  KATANA_LOG_ASSERT(!profile.likely_symmetric);
+}
+
+void
+TestCached() {
+  auto pg_res = katana::PropertyGraph::Make(MakeGrid(16));
+  KATANA_LOG_VASSERT(pg_res, "making graph: {}", pg_res.error());
+  const katana::PropertyGraph& pg = *pg_res.value();
+
+  std::shared_ptr<const katana::GraphProfile> first = pg.GetGraphProfile();
+  KATANA_LOG_ASSERT(first->num_nodes == 16 * 16);
+  KATANA_LOG_ASSERT(pg.GetGraphProfile() == first);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestGrid();
+  TestHubs();
+  TestCached();
+
+  return 0;
+}
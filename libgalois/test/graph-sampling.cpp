@@ -0,0 +1,140 @@
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/Galois.h"
+#include "katana/GraphGenerators.h"
+#include "katana/Logging.h"
+#include "katana/analytics/graph_sampling/graph_sampling.h"
+
+namespace {
+
+using katana::analytics::GraphSamplingPlan;
+using Node = katana::GraphTopology::Node;
+
+constexpr uint64_t kNumNodes = 1 << 14;
+constexpr uint64_t kSampleSize = 500;
+
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph() {
+  auto topology = katana::GenerateErdosRenyiTopology(kNumNodes, 8 * kNumNodes);
+  KATANA_LOG_VASSERT(topology, "generating: {}", topology.error());
+  auto res = katana::MakeGeneratedGraph(std::move(topology.value()), {});
+  KATANA_LOG_VASSERT(res, "making graph: {}", res.error());
+  return std::move(res.value());
+}
+
+std::vector<Node>
+SampleNodes(
+    katana::PropertyGraph* pg, uint64_t size, uint64_t seed,
+    const GraphSamplingPlan& plan) {
+  auto res = katana::analytics::GraphSampleNodes(pg, size, seed, plan);
+  KATANA_LOG_VASSERT(res, "sampling: {}", res.error());
+  return std::move(res.value());
+}
+
+/// Samples have the requested number of distinct nodes and do not depend on
+/// the number of threads
+void
+TestNodes(katana::PropertyGraph* pg, const GraphSamplingPlan& plan) {
+  katana::setActiveThreads(1);
+  std::vector<Node> one = SampleNodes(pg, kSampleSize, 7, plan);
+  katana::setActiveThreads(4);
+  std::vector<Node> four = SampleNodes(pg, kSampleSize, 7, plan);
+  KATANA_LOG_ASSERT(one == four);
+  KATANA_LOG_ASSERT(one != SampleNodes(pg, kSampleSize, 8, plan));
+
+  KATANA_LOG_ASSERT(one.size() == kSampleSize);
+  std::unordered_set<Node> distinct(one.begin(), one.end());
+  KATANA_LOG_ASSERT(distinct.size() == kSampleSize);
+  for (Node n : one) {
+    KATANA_LOG_ASSERT(n < kNumNodes);
+  }
+
+  // Asking for more nodes than there are gives all of them
+  std::vector<Node> all = SampleNodes(pg, 2 * kNumNodes, 7, plan);
+  KATANA_LOG_ASSERT(all.size() == kNumNodes);
+}
+
+/// Walks and fires move along edges, so most sampled nodes have an edge
+/// from an earlier one
+void
+TestConnected(katana::PropertyGraph* pg, const GraphSamplingPlan& plan) {
+  std::vector<Node> nodes;
+  auto res = katana::analytics::GraphSample(
+      pg, kSampleSize, 1, {}, {}, plan, &nodes);
+  KATANA_LOG_VASSERT(res, "sampling: {}", res.error());
+  std::unique_ptr<katana::PropertyGraph> sample = std::move(res.value());
+  KATANA_LOG_ASSERT(sample->num_nodes() == kSampleSize);
+  KATANA_LOG_ASSERT(nodes.size() == kSampleSize);
+  // An Erdos-Renyi sample of 500 nodes of 16K with average degree 8 has
+  // about 120 edges
+  KATANA_LOG_VASSERT(
+      sample->num_edges() >= kSampleSize / 2, "{} edges",
+      sample->num_edges());
+}
+
+void
+TestUniformEdge(katana::PropertyGraph* pg) {
+  std::vector<Node> nodes;
+  auto res = katana::analytics::GraphSample(
+      pg, kSampleSize, 3, {}, {"weight"}, GraphSamplingPlan::UniformEdge(),
+      &nodes);
+  KATANA_LOG_VASSERT(res, "sampling: {}", res.error());
+  std::unique_ptr<katana::PropertyGraph> sample = std::move(res.value());
+  KATANA_LOG_ASSERT(sample->num_edges() == kSampleSize);
+  KATANA_LOG_ASSERT(sample->num_nodes() == nodes.size());
+  KATANA_LOG_ASSERT(std::is_sorted(nodes.begin(), nodes.end()));
+
+  // Every edge of the sample is an edge of the graph with its weight
+  const katana::GraphTopology& topology = pg->topology();
+  auto weights = std::static_pointer_cast<arrow::UInt32Array>(
+      pg->GetEdgeProperty("weight").value()->chunk(0));
+  auto sample_weights = std::static_pointer_cast<arrow::UInt32Array>(
+      sample->GetEdgeProperty("weight").value()->chunk(0));
+  for (Node n : sample->topology().all_nodes()) {
+    for (auto e : sample->topology().edges(n)) {
+      Node dest = nodes[sample->topology().edge_dest(e)];
+      bool found = false;
+      for (auto original : topology.edges(nodes[n])) {
+        found |= topology.edge_dest(original) == dest &&
+                 weights->Value(original) == sample_weights->Value(e);
+      }
+      KATANA_LOG_ASSERT(found);
+    }
+  }
+
+  KATANA_LOG_ASSERT(!katana::analytics::GraphSampleNodes(
+      pg, kSampleSize, 3, GraphSamplingPlan::UniformEdge()));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  std::unique_ptr<katana::PropertyGraph> pg = MakeGraph();
+
+  TestNodes(pg.get(), GraphSamplingPlan::UniformNode());
+  TestNodes(pg.get(), GraphSamplingPlan::RandomWalk());
+  TestNodes(pg.get(), GraphSamplingPlan::ForestFire());
+  TestNodes(pg.get(), GraphSamplingPlan::Snowball());
+
+  TestConnected(pg.get(), GraphSamplingPlan::RandomWalk());
+  TestConnected(pg.get(), GraphSamplingPlan::ForestFire());
+  TestConnected(pg.get(), GraphSamplingPlan::Snowball(3));
+
+  TestUniformEdge(pg.get());
+
+  KATANA_LOG_ASSERT(!katana::analytics::GraphSampleNodes(
+      pg.get(), kSampleSize, 0, GraphSamplingPlan::ForestFire(1.0)));
+  KATANA_LOG_ASSERT(!katana::analytics::GraphSampleNodes(
+      pg.get(), kSampleSize, 0, GraphSamplingPlan::Snowball(0)));
+
+  return 0;
+}
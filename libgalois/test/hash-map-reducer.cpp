@@ -0,0 +1,90 @@
+#include <cstdint>
+#include <map>
+
+#include "katana/Galois.h"
+#include "katana/HashMapReducer.h"
+#include "katana/Logging.h"
+
+namespace {
+
+void
+TestMap() {
+  katana::PartitionedHashMap<uint64_t, uint64_t> map;
+  auto plus = [](uint64_t a, uint64_t b) { return a + b; };
+
+  constexpr uint64_t kN = 10000;
+  for (uint64_t i = 0; i < 3 * kN; ++i) {
+    map.Upsert(i % kN, 1, plus);
+  }
+  map[kN] += 5;
+
+  KATANA_LOG_ASSERT(map.size() == kN + 1);
+  KATANA_LOG_ASSERT(*map.find(kN) == 5);
+  KATANA_LOG_ASSERT(map.find(kN + 1) == nullptr);
+
+  std::map<uint64_t, uint64_t> expected;
+  for (const auto& [key, value] : map) {
+    KATANA_LOG_ASSERT(expected.emplace(key, value).second);
+  }
+  KATANA_LOG_ASSERT(expected.size() == kN + 1);
+  for (uint64_t i = 0; i < kN; ++i) {
+    KATANA_LOG_ASSERT(expected[i] == 3);
+  }
+
+  map.clear();
+  KATANA_LOG_ASSERT(map.empty());
+  KATANA_LOG_ASSERT(map.begin() == map.end());
+
+  // A single partition
+  katana::PartitionedHashMap<uint64_t, uint64_t> one(0);
+  one.Upsert(7, 1, plus);
+  one.Upsert(7, 1, plus);
+  KATANA_LOG_ASSERT(one.num_partitions() == 1);
+  KATANA_LOG_ASSERT(*one.find(7) == 2);
+}
+
+void
+TestReducer() {
+  constexpr uint32_t kN = 100000;
+  constexpr uint32_t kKeys = 1000;
+
+  katana::GHashMapReducer<uint32_t, uint64_t> counts;
+  for (uint64_t round = 1; round <= 2; ++round) {
+    katana::do_all(katana::iterate(uint32_t{0}, kN), [&](uint32_t i) {
+      counts.update(i % kKeys, 1);
+    });
+
+    // The result accumulates over reductions
+    const auto& map = counts.reduce();
+    KATANA_LOG_ASSERT(map.size() == kKeys);
+    for (uint32_t key = 0; key < kKeys; ++key) {
+      KATANA_LOG_ASSERT(*map.find(key) == round * kN / kKeys);
+    }
+  }
+
+  counts.reset();
+  KATANA_LOG_ASSERT(counts.reduce().empty());
+
+  auto max = [](uint64_t a, uint64_t b) { return a > b ? a : b; };
+  katana::GHashMapReducer<uint32_t, uint64_t, decltype(max)> maxes(max);
+  katana::do_all(katana::iterate(uint32_t{0}, kN), [&](uint32_t i) {
+    maxes.update(i % kKeys, i);
+  });
+  const auto& map = maxes.reduce();
+  for (uint32_t key = 0; key < kKeys; ++key) {
+    KATANA_LOG_ASSERT(*map.find(key) == kN - kKeys + key);
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys Katana_runtime;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxThreads());
+
+  TestMap();
+  TestReducer();
+
+  return 0;
+}
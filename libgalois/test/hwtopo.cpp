@@ -35,7 +35,8 @@ printMyTopo() {
               << " socket: " << c.socket << " numaNode: " << c.numaNode
               << " cumulativeMaxSocket: " << c.cumulativeMaxSocket
               << " osContext: " << c.osContext
-              << " osNumaNode: " << c.osNumaNode << "\n";
+              << " osNumaNode: " << c.osNumaNode
+              << " capacity: " << c.capacity << "\n";
   }
 }
 
@@ -82,5 +83,20 @@ main() {
       "parse range", parseCPUList("     0-4   \n"),
       std::vector<int>{0, 1, 2, 3, 4});
 
+  auto testQuota = [](const std::string& in, double expected) {
+    if (parseCgroupCPUMax(in) != expected) {
+      std::cerr << "test quota \"" << in << "\" failed: "
+                << parseCgroupCPUMax(in) << " != " << expected << "\n";
+      std::abort();
+    }
+  };
+  testQuota("max 100000\n", 0);
+  testQuota("150000 100000\n", 1.5);
+  testQuota("400000 100000", 4);
+  testQuota("-1 100000", 0);
+  testQuota("100000 0", 0);
+  testQuota("", 0);
+  testQuota("garbage", 0);
+
   return 0;
 }
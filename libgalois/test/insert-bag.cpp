@@ -0,0 +1,99 @@
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "katana/Bag.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/NUMAArray.h"
+#include "katana/PODVector.h"
+
+namespace {
+
+template <typename Bag, typename Array>
+void
+CheckFlattened(const Bag& bag, const Array& array) {
+  size_t i = 0;
+  for (const auto& item : bag) {
+    KATANA_LOG_ASSERT(i < array.size());
+    KATANA_LOG_ASSERT(array[i] == item);
+    ++i;
+  }
+  KATANA_LOG_ASSERT(i == array.size());
+}
+
+// Thread t pushes about t times as much as thread 0, so the kBalanced mode
+// has something to balance
+template <typename Bag>
+void
+Fill(Bag* bag, uint32_t n) {
+  katana::do_all(
+      katana::iterate(uint32_t{0}, n),
+      [&](uint32_t i) {
+        for (uint32_t j = 0; j <= katana::ThreadPool::getTID(); ++j) {
+          bag->push(i * 8 + j);
+        }
+      },
+      katana::no_stats());
+}
+
+template <unsigned BlockSize>
+void
+TestFlatten(uint32_t n) {
+  using Bag = katana::InsertBag<uint64_t, BlockSize>;
+  Bag bag;
+  Fill(&bag, n);
+  KATANA_LOG_ASSERT(bag.size() == static_cast<size_t>(std::distance(
+                                      bag.begin(), bag.end())));
+
+  for (auto mode : {Bag::FlattenMode::kLocal, Bag::FlattenMode::kBalanced}) {
+    katana::NUMAArray<uint64_t> array;
+    bag.Flatten(&array, mode);
+    CheckFlattened(bag, array);
+    // Reuse the array
+    bag.Flatten(&array, mode);
+    CheckFlattened(bag, array);
+
+    katana::PODVector<uint64_t> vec;
+    bag.Flatten(&vec, mode);
+    CheckFlattened(bag, vec);
+  }
+}
+
+void
+TestFlattenNonTrivial() {
+  katana::InsertBag<std::string> bag;
+  katana::do_all(katana::iterate(0, 5000), [&](int i) {
+    bag.push(std::string(i % 50, 'a') + std::to_string(i));
+  });
+  katana::NUMAArray<std::string> array;
+  bag.Flatten(&array, decltype(bag)::FlattenMode::kBalanced);
+  CheckFlattened(bag, array);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys Katana_runtime;
+
+  for (unsigned threads : {1U, katana::GetThreadPool().getMaxThreads()}) {
+    katana::setActiveThreads(threads);
+    for (uint32_t n : {0U, 1U, 1000U, 100000U}) {
+      TestFlatten<0>(n);
+      TestFlatten<256>(n);
+    }
+    TestFlattenNonTrivial();
+  }
+
+  // Elements pushed by threads that are no longer active are still copied
+  katana::InsertBag<uint64_t> bag;
+  Fill(&bag, 10000);
+  katana::setActiveThreads(1);
+  katana::NUMAArray<uint64_t> array;
+  bag.Flatten(&array);
+  CheckFlattened(bag, array);
+
+  return 0;
+}
@@ -0,0 +1,105 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/jaccard/jaccard.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+
+/// Nodes with a few distinct neighbors each, drawn from a small pool so
+/// that many pairs overlap; some nodes have no edges
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph() {
+  constexpr uint32_t kNumNodes = 80;
+  constexpr uint32_t kPool = 12;
+  std::mt19937 generator(3);
+  std::uniform_int_distribution<uint32_t> degree_dist(0, 6);
+  std::uniform_int_distribution<Node> pool_dist(0, kPool - 1);
+
+  std::vector<Edge> adj_indices;
+  std::vector<Node> dests;
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    std::set<Node> neighbors;
+    uint32_t degree = degree_dist(generator);
+    while (neighbors.size() < degree) {
+      neighbors.insert(pool_dist(generator));
+    }
+    // Unsorted edges, which the join must handle
+    std::vector<Node> shuffled(neighbors.begin(), neighbors.end());
+    std::shuffle(shuffled.begin(), shuffled.end(), generator);
+    dests.insert(dests.end(), shuffled.begin(), shuffled.end());
+    adj_indices.emplace_back(dests.size());
+  }
+  auto pg_res = katana::PropertyGraph::Make(katana::GraphTopology(
+      adj_indices.data(), adj_indices.size(), dests.data(), dests.size()));
+  KATANA_LOG_ASSERT(pg_res);
+  return std::move(pg_res.value());
+}
+
+/// The exact join matches the top pairs found by calling Jaccard per node
+void
+TestExactJoin(
+    katana::PropertyGraph* pg, uint32_t top_k, double min_similarity) {
+  auto join_res = katana::analytics::JaccardSimilarityJoin(
+      pg, katana::analytics::JaccardSimilarityJoinPlan::Exact(
+              top_k, min_similarity));
+  KATANA_LOG_VASSERT(join_res, "{}", join_res.error());
+  const katana::analytics::JaccardSimilarityJoinResult& join =
+      join_res.value();
+
+  size_t pair = 0;
+  for (Node u = 0; u < pg->num_nodes(); ++u) {
+    std::vector<std::pair<double, Node>> expected;
+    if (pg->topology().degree(u) > 0) {
+      KATANA_LOG_ASSERT(katana::analytics::Jaccard(
+          pg, u, "similarity", katana::analytics::JaccardPlan::Unsorted()));
+      auto similarity_res = pg->GetNodePropertyTyped<double>("similarity");
+      KATANA_LOG_ASSERT(similarity_res);
+      auto similarity = similarity_res.value();
+      for (Node v = 0; v < pg->num_nodes(); ++v) {
+        double s = similarity->Value(v);
+        if (v != u && pg->topology().degree(v) > 0 && s > 0 &&
+            s >= min_similarity) {
+          expected.emplace_back(s, v);
+        }
+      }
+      KATANA_LOG_ASSERT(pg->RemoveNodeProperty("similarity"));
+    }
+    std::sort(expected.begin(), expected.end(), [](auto a, auto b) {
+      return a.first > b.first || (a.first == b.first && a.second < b.second);
+    });
+    expected.resize(std::min<size_t>(expected.size(), top_k));
+
+    for (const auto& [s, v] : expected) {
+      KATANA_LOG_VASSERT(
+          pair < join.sources.size() && join.sources[pair] == u &&
+              join.destinations[pair] == v && join.similarities[pair] == s,
+          "node {}: expected {} with similarity {}", u, v, s);
+      ++pair;
+    }
+  }
+  KATANA_LOG_ASSERT(pair == join.sources.size());
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  auto pg = MakeGraph();
+  TestExactJoin(pg.get(), 5, 0);
+  TestExactJoin(pg.get(), 5, 0.3);
+  TestExactJoin(pg.get(), 100, 0);
+
+  return 0;
+}
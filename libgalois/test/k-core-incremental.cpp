@@ -0,0 +1,157 @@
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/k_core/k_core.h"
+
+namespace {
+
+using EdgeList = std::vector<std::pair<uint32_t, uint32_t>>;
+
+constexpr uint32_t kNumNodes = 2000;
+
+/// The symmetric graph with edges in both directions
+std::unique_ptr<katana::PropertyGraph>
+MakeSymmetric(const EdgeList& edges) {
+  std::vector<std::vector<uint32_t>> adjacency(kNumNodes);
+  for (const auto& [src, dest] : edges) {
+    adjacency[src].emplace_back(dest);
+    adjacency[dest].emplace_back(src);
+  }
+  katana::GraphTopology::AdjIndexVec adj_indices;
+  adj_indices.allocateInterleaved(kNumNodes);
+  katana::GraphTopology::EdgeDestVec dests;
+  dests.allocateInterleaved(2 * edges.size());
+  uint64_t end = 0;
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    std::sort(adjacency[n].begin(), adjacency[n].end());
+    for (uint32_t dest : adjacency[n]) {
+      dests[end++] = dest;
+    }
+    adj_indices[n] = end;
+  }
+  auto res = katana::PropertyGraph::Make(
+      katana::GraphTopology(std::move(adj_indices), std::move(dests)));
+  KATANA_LOG_VASSERT(res, "making graph: {}", res.error());
+  return std::move(res.value());
+}
+
+std::shared_ptr<arrow::UInt32Array>
+CoreNumbers(katana::PropertyGraph* pg, const std::string& name) {
+  auto res = pg->GetNodePropertyTyped<uint32_t>(name);
+  KATANA_LOG_VASSERT(res, "getting {}: {}", name, res.error());
+  return res.value();
+}
+
+/// Apply the changes incrementally and compare with recomputing
+void
+CheckUpdate(
+    const EdgeList& before, const EdgeList& inserted,
+    const EdgeList& deleted) {
+  auto old_graph = MakeSymmetric(before);
+  KATANA_LOG_ASSERT(katana::analytics::KCoreNumbers(old_graph.get(), "core"));
+
+  std::multiset<std::pair<uint32_t, uint32_t>> after(
+      before.begin(), before.end());
+  for (const auto& edge : deleted) {
+    auto it = after.find(edge);
+    KATANA_LOG_ASSERT(it != after.end());
+    after.erase(it);
+  }
+  after.insert(inserted.begin(), inserted.end());
+  auto new_graph = MakeSymmetric(EdgeList(after.begin(), after.end()));
+
+  auto old_cores = old_graph->GetNodeProperty("core");
+  KATANA_LOG_ASSERT(old_cores);
+  KATANA_LOG_ASSERT(new_graph->AddNodeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("core", arrow::uint32())}),
+      {old_cores.value()})));
+
+  auto res = katana::analytics::KCoreNumbersIncremental(
+      new_graph.get(), "core", inserted, deleted);
+  KATANA_LOG_VASSERT(res, "updating: {}", res.error());
+  KATANA_LOG_ASSERT(
+      katana::analytics::KCoreNumbers(new_graph.get(), "expected"));
+
+  auto updated = CoreNumbers(new_graph.get(), "core");
+  auto expected = CoreNumbers(new_graph.get(), "expected");
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    KATANA_LOG_VASSERT(
+        updated->Value(n) == expected->Value(n),
+        "node {} has core number {}, expected {}", n, updated->Value(n),
+        expected->Value(n));
+  }
+}
+
+EdgeList
+RandomEdges(std::mt19937* gen, uint64_t num_edges) {
+  std::uniform_int_distribution<uint32_t> node(0, kNumNodes - 1);
+  EdgeList edges;
+  while (edges.size() < num_edges) {
+    uint32_t src = node(*gen);
+    uint32_t dest = node(*gen);
+    if (src != dest) {
+      edges.emplace_back(src, dest);
+    }
+  }
+  return edges;
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  std::mt19937 gen(0);
+  EdgeList edges = RandomEdges(&gen, 6 * kNumNodes);
+
+  // Insertions only, one at a time and in batches with shared roots
+  for (uint64_t batch : {1, 10, 1000}) {
+    EdgeList before(edges.begin() + batch, edges.end());
+    EdgeList inserted(edges.begin(), edges.begin() + batch);
+    CheckUpdate(before, inserted, {});
+  }
+
+  // Many edges on one node rise its core number by more than one
+  EdgeList star;
+  for (uint32_t n = 1; n < 100; ++n) {
+    star.emplace_back(0, n);
+  }
+  CheckUpdate(edges, star, {});
+
+  // Deletions only
+  for (uint64_t batch : {1, 10, 1000}) {
+    EdgeList deleted(edges.begin(), edges.begin() + batch);
+    CheckUpdate(edges, {}, deleted);
+  }
+
+  // Both, with a dense region that forms and one that dissolves
+  EdgeList clique;
+  for (uint32_t a = 0; a < 30; ++a) {
+    for (uint32_t b = a + 1; b < 30; ++b) {
+      clique.emplace_back(a, b);
+    }
+  }
+  EdgeList with_clique = edges;
+  with_clique.insert(with_clique.end(), clique.begin(), clique.end());
+  CheckUpdate(with_clique, RandomEdges(&gen, 500), clique);
+  CheckUpdate(edges, clique, EdgeList(edges.begin(), edges.begin() + 500));
+
+  // Self loops are rejected
+  auto pg = MakeSymmetric(edges);
+  KATANA_LOG_ASSERT(katana::analytics::KCoreNumbers(pg.get(), "core"));
+  KATANA_LOG_ASSERT(!katana::analytics::KCoreNumbersIncremental(
+      pg.get(), "core", {{1, 1}}, {}));
+
+  return 0;
+}
@@ -0,0 +1,170 @@
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/k_core/k_core.h"
+
+namespace {
+
+using EdgeList = std::vector<std::pair<uint32_t, uint32_t>>;
+
+/// The symmetric graph with edges in both directions
+std::unique_ptr<katana::PropertyGraph>
+MakeSymmetric(uint32_t num_nodes, const EdgeList& edges) {
+  std::vector<std::vector<uint32_t>> adjacency(num_nodes);
+  for (const auto& [src, dest] : edges) {
+    adjacency[src].emplace_back(dest);
+    adjacency[dest].emplace_back(src);
+  }
+  katana::GraphTopology::AdjIndexVec adj_indices;
+  adj_indices.allocateInterleaved(num_nodes);
+  katana::GraphTopology::EdgeDestVec dests;
+  dests.allocateInterleaved(2 * edges.size());
+  uint64_t end = 0;
+  for (uint32_t n = 0; n < num_nodes; ++n) {
+    for (uint32_t dest : adjacency[n]) {
+      dests[end++] = dest;
+    }
+    adj_indices[n] = end;
+  }
+  auto res = katana::PropertyGraph::Make(
+      katana::GraphTopology(std::move(adj_indices), std::move(dests)));
+  KATANA_LOG_VASSERT(res, "making graph: {}", res.error());
+  return std::move(res.value());
+}
+
+/// Core numbers by removing a node of least degree at a time
+std::vector<uint32_t>
+SerialCoreNumbers(uint32_t num_nodes, const EdgeList& edges) {
+  std::vector<std::vector<uint32_t>> adjacency(num_nodes);
+  for (const auto& [src, dest] : edges) {
+    adjacency[src].emplace_back(dest);
+    adjacency[dest].emplace_back(src);
+  }
+  std::vector<uint32_t> degree(num_nodes);
+  for (uint32_t n = 0; n < num_nodes; ++n) {
+    degree[n] = adjacency[n].size();
+  }
+  std::vector<bool> removed(num_nodes);
+  std::vector<uint32_t> core(num_nodes);
+  uint32_t k = 0;
+  for (uint32_t i = 0; i < num_nodes; ++i) {
+    uint32_t min_node = num_nodes;
+    for (uint32_t n = 0; n < num_nodes; ++n) {
+      if (!removed[n] &&
+          (min_node == num_nodes || degree[n] < degree[min_node])) {
+        min_node = n;
+      }
+    }
+    k = std::max(k, degree[min_node]);
+    core[min_node] = k;
+    removed[min_node] = true;
+    for (uint32_t dest : adjacency[min_node]) {
+      if (!removed[dest]) {
+        --degree[dest];
+      }
+    }
+  }
+  return core;
+}
+
+std::shared_ptr<arrow::UInt32Array>
+GetProperty(katana::PropertyGraph* pg, const std::string& name) {
+  auto res = pg->GetNodePropertyTyped<uint32_t>(name);
+  KATANA_LOG_VASSERT(res, "getting {}: {}", name, res.error());
+  return res.value();
+}
+
+/// KCoreNumbers, KCore with bucket peeling and KCoreDegeneracyOrder agree
+/// with the serial peeling
+void
+CheckCores(
+    uint32_t num_nodes, const EdgeList& edges,
+    const std::vector<uint32_t>& expected) {
+  auto pg = MakeSymmetric(num_nodes, edges);
+  KATANA_LOG_ASSERT(katana::analytics::KCoreNumbers(pg.get(), "core"));
+  auto core = GetProperty(pg.get(), "core");
+  uint32_t degeneracy = 0;
+  for (uint32_t n = 0; n < num_nodes; ++n) {
+    KATANA_LOG_VASSERT(
+        core->Value(n) == expected[n],
+        "node {} has core number {}, expected {}", n, core->Value(n),
+        expected[n]);
+    degeneracy = std::max(degeneracy, expected[n]);
+  }
+
+  for (uint32_t k : {1u, 2u, degeneracy}) {
+    std::string name = "in-" + std::to_string(k);
+    KATANA_LOG_ASSERT(katana::analytics::KCore(
+        pg.get(), k, name, katana::analytics::KCorePlan::BucketPeeling()));
+    auto alive = GetProperty(pg.get(), name);
+    for (uint32_t n = 0; n < num_nodes; ++n) {
+      KATANA_LOG_VASSERT(
+          alive->Value(n) == (expected[n] >= k), "node {} in the {}-core", n,
+          k);
+    }
+  }
+
+  KATANA_LOG_ASSERT(katana::analytics::KCoreDegeneracyOrder(pg.get(), "rank"));
+  auto rank = GetProperty(pg.get(), "rank");
+  std::vector<bool> seen(num_nodes);
+  for (uint32_t n = 0; n < num_nodes; ++n) {
+    KATANA_LOG_ASSERT(rank->Value(n) < num_nodes && !seen[rank->Value(n)]);
+    seen[rank->Value(n)] = true;
+    uint32_t later = 0;
+    for (auto e : pg->topology().edges(n)) {
+      uint32_t dest = pg->topology().edge_dest(e);
+      later += rank->Value(dest) > rank->Value(n);
+      KATANA_LOG_ASSERT(
+          rank->Value(dest) > rank->Value(n) || expected[dest] <= expected[n]);
+    }
+    KATANA_LOG_VASSERT(
+        later <= degeneracy, "node {} has {} later neighbors, degeneracy {}", n,
+        later, degeneracy);
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  // A 4-clique 0-3 (3-core), a triangle 6-8 (2-core) hanging off the path
+  // 3-4-5 (1-core), and 9 alone
+  EdgeList small{{0, 1}, {0, 2}, {0, 3}, {1, 2}, {1, 3}, {2, 3}, {3, 4},
+                 {4, 5}, {4, 6}, {6, 7}, {6, 8}, {7, 8}};
+  std::vector<uint32_t> small_cores{3, 3, 3, 3, 1, 1, 2, 2, 2, 0};
+  KATANA_LOG_ASSERT(SerialCoreNumbers(10, small) == small_cores);
+  CheckCores(10, small, small_cores);
+
+  // Enough degrees to need more than one bucket window
+  constexpr uint32_t kNumNodes = 500;
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<uint32_t> node(0, kNumNodes - 1);
+  EdgeList edges;
+  for (uint32_t a = 0; a < 80; ++a) {
+    for (uint32_t b = a + 1; b < 80; ++b) {
+      edges.emplace_back(a, b);
+    }
+  }
+  while (edges.size() < 10 * kNumNodes) {
+    uint32_t src = node(gen);
+    uint32_t dest = node(gen);
+    if (src != dest) {
+      edges.emplace_back(src, dest);
+    }
+  }
+  CheckCores(kNumNodes, edges, SerialCoreNumbers(kNumNodes, edges));
+
+  return 0;
+}
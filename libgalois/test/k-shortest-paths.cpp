@@ -0,0 +1,203 @@
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/k_shortest_paths/k_shortest_paths.h"
+
+namespace {
+
+using KShortestPathsPlan = katana::analytics::KShortestPathsPlan;
+
+/// Edge weights by source and destination
+using WeightMap = std::map<std::pair<uint32_t, uint32_t>, uint32_t>;
+
+std::unique_ptr<katana::PropertyGraph>
+MakeWeightedGraph(uint32_t num_nodes, const WeightMap& weights) {
+  std::vector<katana::GraphTopology::Edge> adj_indices;
+  std::vector<katana::GraphTopology::Node> dests;
+  arrow::UInt32Builder builder;
+  auto it = weights.begin();
+  for (uint32_t n = 0; n < num_nodes; ++n) {
+    for (; it != weights.end() && it->first.first == n; ++it) {
+      dests.emplace_back(it->first.second);
+      KATANA_LOG_ASSERT(builder.Append(it->second).ok());
+    }
+    adj_indices.emplace_back(dests.size());
+  }
+  auto pg_res = katana::PropertyGraph::Make(katana::GraphTopology(
+      adj_indices.data(), adj_indices.size(), dests.data(), dests.size()));
+  KATANA_LOG_ASSERT(pg_res);
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_res.value());
+
+  std::shared_ptr<arrow::Array> array;
+  KATANA_LOG_ASSERT(builder.Finish(&array).ok());
+  KATANA_LOG_ASSERT(pg->AddEdgeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("weight", array->type())}), {array})));
+  return pg;
+}
+
+/// The distances of all simple paths from source to target, shortest first
+std::vector<double>
+EnumeratePaths(
+    uint32_t num_nodes, const WeightMap& weights, uint32_t source,
+    uint32_t target) {
+  std::vector<double> distances;
+  std::vector<bool> on_path(num_nodes);
+  auto visit = [&](auto& self, uint32_t n, double distance) -> void {
+    if (n == target) {
+      distances.emplace_back(distance);
+      return;
+    }
+    on_path[n] = true;
+    for (auto it = weights.lower_bound({n, 0});
+         it != weights.end() && it->first.first == n; ++it) {
+      if (!on_path[it->first.second]) {
+        self(self, it->first.second, distance + it->second);
+      }
+    }
+    on_path[n] = false;
+  };
+  visit(visit, source, 0);
+  std::sort(distances.begin(), distances.end());
+  return distances;
+}
+
+/// The k shortest paths of every plan are distinct simple paths of the
+/// graph, of the distances of the k shortest ones found by enumeration;
+/// which of the paths of equal distance are returned may differ
+void
+CheckAgainstEnumeration(
+    uint32_t num_nodes, const WeightMap& weights, uint32_t source,
+    uint32_t target, uint32_t k) {
+  auto pg = MakeWeightedGraph(num_nodes, weights);
+  std::vector<double> all = EnumeratePaths(num_nodes, weights, source, target);
+  std::vector<double> expected(
+      all.begin(), all.begin() + std::min<size_t>(k, all.size()));
+
+  for (const KShortestPathsPlan& plan :
+       {KShortestPathsPlan::Yen(), KShortestPathsPlan::Lawler(),
+        KShortestPathsPlan::AStar(1)}) {
+    auto res = katana::analytics::KShortestPaths(
+        pg.get(), source, target, k, "weight", plan);
+    KATANA_LOG_VASSERT(res, "{}", res.error());
+    const auto& paths = res.value();
+
+    std::vector<double> distances;
+    std::set<std::vector<uint32_t>> distinct;
+    for (const auto& path : paths) {
+      KATANA_LOG_ASSERT(path.nodes.front() == source);
+      KATANA_LOG_ASSERT(path.nodes.back() == target);
+      std::set<uint32_t> nodes(path.nodes.begin(), path.nodes.end());
+      KATANA_LOG_ASSERT(nodes.size() == path.nodes.size());
+      double distance = 0;
+      for (size_t i = 0; i + 1 < path.nodes.size(); ++i) {
+        auto it = weights.find({path.nodes[i], path.nodes[i + 1]});
+        KATANA_LOG_ASSERT(it != weights.end());
+        distance += it->second;
+      }
+      KATANA_LOG_ASSERT(distance == path.distance);
+      distances.emplace_back(path.distance);
+      distinct.emplace(path.nodes);
+    }
+    KATANA_LOG_ASSERT(distinct.size() == paths.size());
+    KATANA_LOG_VASSERT(
+        distances.size() == expected.size(),
+        "algorithm {}: {} paths from {} to {}, expected {}",
+        static_cast<int>(plan.algorithm()), paths.size(), source, target,
+        expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+      KATANA_LOG_VASSERT(
+          distances[i] == expected[i],
+          "algorithm {}: path {} from {} to {} of distance {}, expected {}",
+          static_cast<int>(plan.algorithm()), i, source, target, distances[i],
+          expected[i]);
+    }
+  }
+}
+
+/// A grid of unit weights, in which all paths right and down from a node tie,
+/// with a few edges back to make cycles
+void
+TestGrid() {
+  constexpr uint32_t kSide = 4;
+  WeightMap weights;
+  for (uint32_t row = 0; row < kSide; ++row) {
+    for (uint32_t col = 0; col < kSide; ++col) {
+      uint32_t n = row * kSide + col;
+      if (col + 1 < kSide) {
+        weights[{n, n + 1}] = 1;
+      }
+      if (row + 1 < kSide) {
+        weights[{n, n + kSide}] = 1;
+      }
+    }
+  }
+  weights[{5, 0}] = 1;
+  weights[{10, 6}] = 1;
+  weights[{14, 9}] = 2;
+
+  constexpr uint32_t kNumNodes = kSide * kSide;
+  for (uint32_t k : {1, 5, 20, 1000}) {
+    CheckAgainstEnumeration(kNumNodes, weights, 0, kNumNodes - 1, k);
+    CheckAgainstEnumeration(kNumNodes, weights, 1, 14, k);
+  }
+}
+
+/// Random graphs of small weights, so that many paths tie
+void
+TestRandom() {
+  constexpr uint32_t kNumNodes = 10;
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<uint32_t> node(0, kNumNodes - 1);
+  std::uniform_int_distribution<uint32_t> weight(1, 3);
+  for (int graph = 0; graph < 5; ++graph) {
+    WeightMap weights;
+    while (weights.size() < 3 * kNumNodes) {
+      uint32_t src = node(gen);
+      uint32_t dest = node(gen);
+      if (src != dest) {
+        weights[{src, dest}] = weight(gen);
+      }
+    }
+    for (int pair = 0; pair < 3; ++pair) {
+      uint32_t source = node(gen);
+      uint32_t target = node(gen);
+      if (source == target) {
+        continue;
+      }
+      for (uint32_t k : {1, 4, 30}) {
+        CheckAgainstEnumeration(kNumNodes, weights, source, target, k);
+      }
+    }
+  }
+}
+
+/// No path at all: the target has no in-edges
+void
+TestUnreachable() {
+  WeightMap weights{{{0, 1}, 1}, {{1, 0}, 1}};
+  CheckAgainstEnumeration(3, weights, 0, 2, 3);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestGrid();
+  TestRandom();
+  TestUnreachable();
+
+  return 0;
+}
@@ -0,0 +1,113 @@
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/LC_CSR_Graph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph() {
+  auto pg_res =
+      katana::PropertyGraph::Make(katana::CreateUniformRandomTopology(1000, 4));
+  KATANA_LOG_VASSERT(pg_res, "making graph: {}", pg_res.error());
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_res.value());
+
+  arrow::UInt32Builder builder;
+  for (uint64_t e = 0; e < pg->topology().num_edges(); ++e) {
+    KATANA_LOG_ASSERT(builder.Append(e * 7 % 101).ok());
+  }
+  std::shared_ptr<arrow::Array> array;
+  KATANA_LOG_ASSERT(builder.Finish(&array).ok());
+  auto res = pg->AddEdgeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("weight", arrow::uint32())}), {array}));
+  KATANA_LOG_VASSERT(res, "adding weights: {}", res.error());
+  return pg;
+}
+
+template <typename Graph>
+void
+TestWeighted(const katana::PropertyGraph& pg) {
+  Graph graph;
+  auto res = graph.constructFrom(pg, "weight");
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+
+  const katana::GraphTopology& topology = pg.topology();
+  KATANA_LOG_ASSERT(graph.size() == topology.num_nodes());
+  KATANA_LOG_ASSERT(graph.sizeEdges() == topology.num_edges());
+
+  auto weights = std::static_pointer_cast<arrow::UInt32Array>(
+      pg.GetEdgeProperty("weight").value()->chunk(0));
+  // The edge data is the property itself, not a copy
+  KATANA_LOG_ASSERT(
+      &graph.getEdgeData(graph.edge_begin(0)) == weights->raw_values());
+
+  katana::do_all(katana::iterate(graph), [&](uint32_t n) {
+    uint64_t sum = 0;
+    auto e = topology.edges(n).begin();
+    for (auto ii : graph.edges(n, katana::MethodFlag::UNPROTECTED)) {
+      KATANA_LOG_ASSERT(*ii == *e);
+      KATANA_LOG_ASSERT(graph.getEdgeDst(ii) == topology.edge_dest(*e));
+      sum += graph.getEdgeData(ii);
+      ++e;
+    }
+    KATANA_LOG_ASSERT(e == topology.edges(n).end());
+    graph.getData(n, katana::MethodFlag::UNPROTECTED) = sum;
+  });
+
+  for (uint32_t n = 0; n < topology.num_nodes(); ++n) {
+    uint64_t expected = 0;
+    for (auto e : topology.edges(n)) {
+      expected += weights->Value(e);
+    }
+    KATANA_LOG_VASSERT(
+        graph.getData(n) == expected, "node {}: {} != {}", n, graph.getData(n),
+        expected);
+  }
+}
+
+void
+TestUnweighted(const katana::PropertyGraph& pg) {
+  katana::LC_CSR_Graph<uint32_t, void>::with_no_lockable<true>::type graph;
+  auto res = graph.constructFrom(pg);
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  KATANA_LOG_ASSERT(
+      graph.getEdgePrefixSum().data() == pg.topology().adj_data());
+  for (uint32_t n = 0; n < pg.topology().num_nodes(); ++n) {
+    KATANA_LOG_ASSERT(graph.getDegree(n) == pg.topology().degree(n));
+  }
+}
+
+void
+TestErrors(const katana::PropertyGraph& pg) {
+  katana::LC_CSR_Graph<uint32_t, float> wrong_type;
+  KATANA_LOG_ASSERT(!wrong_type.constructFrom(pg, "weight"));
+
+  katana::LC_CSR_Graph<uint32_t, uint32_t> missing;
+  KATANA_LOG_ASSERT(!missing.constructFrom(pg, "no-such-property"));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  std::unique_ptr<katana::PropertyGraph> pg = MakeGraph();
+
+  TestWeighted<katana::LC_CSR_Graph<uint64_t, uint32_t>>(*pg);
+  TestWeighted<katana::LC_CSR_Graph<uint64_t, uint32_t>::with_numa_alloc<
+      true>::type>(*pg);
+  TestWeighted<katana::LC_CSR_Graph<uint64_t, uint32_t>::
+                   with_out_of_line_lockable<true>::type>(*pg);
+  TestUnweighted(*pg);
+  TestErrors(*pg);
+
+  return 0;
+}
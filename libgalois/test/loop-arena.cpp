@@ -0,0 +1,90 @@
+#include <atomic>
+#include <cstdint>
+#include <memory_resource>
+#include <unordered_map>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/LoopArena.h"
+#include "katana/Logging.h"
+#include "katana/PageAlloc.h"
+
+namespace {
+
+void
+TestThreadArena() {
+  katana::ThreadArena arena;
+
+  auto* a = static_cast<char*>(arena.allocate(3, 1));
+  auto* b = static_cast<uint64_t*>(arena.allocate(8, 8));
+  KATANA_LOG_ASSERT(reinterpret_cast<uintptr_t>(b) % 8 == 0);
+  KATANA_LOG_ASSERT(reinterpret_cast<char*>(b) > a);
+
+  katana::ThreadArena::Mark mark = arena.GetMark();
+  void* c = arena.allocate(64, 16);
+  arena.Rewind(mark);
+  KATANA_LOG_ASSERT(arena.allocate(64, 16) == c);
+
+  // Larger than a page
+  std::vector<char, std::pmr::polymorphic_allocator<char>> big(
+      2 * katana::allocSize(), 'x', &arena);
+  KATANA_LOG_ASSERT(big.back() == 'x');
+
+  // Fill more than one page
+  size_t capacity = arena.capacity();
+  {
+    katana::ArenaScope scope(&arena);
+    for (size_t i = 0; i < 2 * katana::allocSize() / 1024; ++i) {
+      KATANA_LOG_ASSERT(arena.allocate(1024, 8));
+    }
+    KATANA_LOG_ASSERT(arena.capacity() > capacity);
+  }
+  // Rewinding keeps the pages for reuse
+  capacity = arena.capacity();
+  for (size_t i = 0; i < 2 * katana::allocSize() / 1024; ++i) {
+    KATANA_LOG_ASSERT(arena.allocate(1024, 8));
+  }
+  KATANA_LOG_ASSERT(arena.capacity() == capacity);
+}
+
+void
+TestLoopArena() {
+  constexpr uint32_t kN = 10000;
+
+  katana::LoopArena arena;
+  std::atomic<uint64_t> total{0};
+
+  for (int round = 0; round < 3; ++round) {
+    katana::do_all(
+        katana::iterate(uint32_t{0}, kN),
+        [&](uint32_t i) {
+          katana::ArenaScope scope(arena.Local());
+          std::pmr::unordered_map<uint32_t, uint32_t> counts(arena.Local());
+          std::pmr::vector<uint32_t> buf(arena.Local());
+          for (uint32_t j = 0; j < 32; ++j) {
+            buf.emplace_back(i + j);
+            counts[j % 7] += 1;
+          }
+          total += buf.size() + counts.size();
+        },
+        katana::steal());
+    arena.Reset();
+  }
+
+  KATANA_LOG_ASSERT(total == 3 * kN * (32 + 7));
+  // Each iteration rewinds, so no thread ever needs more than one page
+  KATANA_LOG_ASSERT(
+      arena.capacity() <= katana::getActiveThreads() * katana::allocSize());
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys Katana_runtime;
+
+  TestThreadArena();
+  TestLoopArena();
+
+  return 0;
+}
@@ -0,0 +1,64 @@
+#include <atomic>
+#include <cstdlib>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/LoopBalance.h"
+#include "katana/ProgressTracer.h"
+
+int
+main() {
+  setenv("KATANA_LOOP_BALANCE", "1", 1);
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxThreads());
+  KATANA_LOG_ASSERT(katana::LoopBalance::IsEnabled());
+
+  // Summaries are logged to the active span
+  auto scope = katana::GetTracer().StartActiveSpan("loop-balance");
+
+  // Uneven work so that threads that finish early steal
+  constexpr uint64_t kSize = 1 << 12;
+  std::atomic<uint64_t> sum{0};
+  std::atomic<uint64_t> sink{0};
+  katana::do_all(
+      katana::iterate(uint64_t{0}, kSize),
+      [&](uint64_t i) {
+        uint64_t x = i;
+        for (uint64_t j = 0; j < (i < kSize / 8 ? 1000 : 1); ++j) {
+          x = x * 31 + j;
+        }
+        sum += i;
+        sink += x;
+      },
+      katana::steal(), katana::chunk_size<16>(),
+      katana::loopname("BalancedDoAll"));
+  KATANA_LOG_ASSERT(sum == kSize * (kSize - 1) / 2);
+
+  std::atomic<uint64_t> visited{0};
+  katana::for_each(
+      katana::iterate({uint64_t{1}}),
+      [&](uint64_t i, auto& ctx) {
+        ++visited;
+        if (2 * i < kSize) {
+          ctx.push(2 * i);
+          ctx.push(2 * i + 1);
+        }
+      },
+      katana::loopname("BalancedForEach"));
+  KATANA_LOG_ASSERT(visited == kSize - 1);
+
+  // A thread that never ran its part is not reported
+  katana::LoopBalance balance("Direct");
+  katana::on_each([&](unsigned tid, unsigned) {
+    if (tid == 0) {
+      return;
+    }
+    balance.BeginThread();
+    uint64_t start = balance.StartBusy();
+    balance.StopBusy(start, true);
+    balance.EndThread(1, 2, 1);
+  });
+  balance.Report();
+
+  return 0;
+}
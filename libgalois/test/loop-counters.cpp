@@ -0,0 +1,53 @@
+#include <atomic>
+#include <cstdlib>
+#include <string>
+
+#include "katana/Galois.h"
+#include "katana/LoopCounters.h"
+#include "katana/Logging.h"
+
+int
+main() {
+  // Loops must run the same whether or not the events can be counted here
+  setenv("KATANA_LOOP_COUNTERS", "1", 1);
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxThreads());
+
+#ifdef __linux__
+  KATANA_LOG_ASSERT(katana::LoopCounters::IsEnabled());
+#endif
+
+  constexpr uint64_t kSize = 1 << 16;
+  std::atomic<uint64_t> sum{0};
+  katana::do_all(
+      katana::iterate(uint64_t{0}, kSize), [&](uint64_t i) { sum += i; },
+      katana::loopname("CountedDoAll"));
+  KATANA_LOG_ASSERT(sum == kSize * (kSize - 1) / 2);
+
+  std::atomic<uint64_t> visited{0};
+  katana::for_each(
+      katana::iterate({uint64_t{1}}),
+      [&](uint64_t i, auto& ctx) {
+        ++visited;
+        if (2 * i < kSize) {
+          ctx.push(2 * i);
+          ctx.push(2 * i + 1);
+        }
+      },
+      katana::loopname("CountedForEach"));
+  KATANA_LOG_ASSERT(visited == kSize - 1);
+
+  std::atomic<uint64_t> threads{0};
+  katana::on_each(
+      [&](unsigned, unsigned) { ++threads; },
+      katana::loopname("CountedOnEach"));
+  KATANA_LOG_ASSERT(threads == katana::getActiveThreads());
+
+  for (int i = 0; i < katana::LoopCounters::kNumEvents; ++i) {
+    KATANA_LOG_ASSERT(
+        std::string(katana::LoopCounters::EventName(
+            static_cast<katana::LoopCounters::Event>(i))) != "Unknown");
+  }
+
+  return 0;
+}
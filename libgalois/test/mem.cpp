@@ -19,7 +19,10 @@
 
 #include "katana/Mem.h"
 
+#include <atomic>
+
 #include "katana/Galois.h"
+#include "katana/PagePool.h"
 #include "katana/gIO.h"
 
 using namespace katana;
@@ -70,5 +73,31 @@ main() {
     KATANA_LOG_ASSERT(allocated);
   }
 
+  // A page freed by one thread is reused by another thread on the same NUMA
+  // node before the OS is asked for more
+  katana::setActiveThreads(katana::GetThreadPool().getMaxThreads());
+  void* page = pagePoolAlloc();
+  pagePoolFree(page);
+  int os_before = numPagePoolAllocTotal();
+  std::atomic<bool> tried{false};
+  katana::on_each([&](unsigned tid, unsigned) {
+    auto& tp = katana::GetThreadPool();
+    if (tid == 0 || tp.getNumaNode(tid) != tp.getNumaNode(0) ||
+        tried.exchange(true)) {
+      return;
+    }
+    if (numPagePoolFreeForThread(tid) == 0) {
+      void* p = pagePoolAlloc();
+      KATANA_LOG_ASSERT(numPagePoolNodeReuseForThread(tid) == 1);
+      pagePoolFree(p);
+    }
+  });
+  KATANA_LOG_ASSERT(numPagePoolAllocTotal() == os_before);
+
+  PageBackingCounts backing = pageBackingCounts();
+  KATANA_LOG_ASSERT(
+      backing.hugetlb + backing.transparent + backing.regular >=
+      static_cast<uint64_t>(numPagePoolAllocTotal()));
+
   return 0;
 }
@@ -0,0 +1,137 @@
+#include <algorithm>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/LC_Morph_Graph.h"
+#include "katana/Logging.h"
+#include "katana/MorphGraph.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+constexpr unsigned kNumNodes = 64;
+
+/// The destinations of node i: some nodes more than once, and i itself
+std::vector<unsigned>
+Neighbors(unsigned i) {
+  std::vector<unsigned> ret;
+  for (unsigned j = 0; j < kNumNodes; j += 1 + i % 5) {
+    ret.emplace_back(j);
+    ret.emplace_back(kNumNodes - 1 - j);
+  }
+  ret.emplace_back(i);
+  return ret;
+}
+
+template <typename Graph>
+std::vector<typename Graph::GraphNode>
+Dests(
+    const std::vector<typename Graph::GraphNode>& nodes,
+    const std::vector<unsigned>& ids) {
+  std::vector<typename Graph::GraphNode> ret;
+  for (unsigned id : ids) {
+    ret.emplace_back(nodes[id]);
+  }
+  return ret;
+}
+
+/// Adding edges in bulk and one at a time must give graphs with the same
+/// edges
+template <typename Graph>
+void
+TestMorphGraph() {
+  Graph bulk;
+  Graph single;
+  std::vector<typename Graph::GraphNode> bulk_nodes;
+  std::vector<typename Graph::GraphNode> single_nodes;
+  for (unsigned i = 0; i < kNumNodes; ++i) {
+    bulk_nodes.emplace_back(bulk.createNode(i));
+    bulk.addNode(bulk_nodes.back());
+    single_nodes.emplace_back(single.createNode(i));
+    single.addNode(single_nodes.back());
+  }
+
+  for (unsigned i = 0; i < kNumNodes; ++i) {
+    std::vector<unsigned> ids = Neighbors(i);
+    // Half the edges first, so that bulk insertion skips existing ones
+    std::vector<unsigned> first(ids.begin(), ids.begin() + ids.size() / 2);
+    bulk.addEdgesBulk(bulk_nodes[i], Dests<Graph>(bulk_nodes, first));
+    bulk.addEdgesBulk(bulk_nodes[i], Dests<Graph>(bulk_nodes, ids));
+    for (unsigned id : ids) {
+      single.addEdge(single_nodes[i], single_nodes[id]);
+    }
+  }
+
+  KATANA_LOG_ASSERT(bulk.addEdgesBulk(bulk_nodes[0], bulk_nodes) == 0);
+
+  for (unsigned i = 0; i < kNumNodes; ++i) {
+    std::vector<unsigned> bulk_dests;
+    for (auto e : bulk.edges(bulk_nodes[i])) {
+      bulk_dests.emplace_back(bulk.getData(bulk.getEdgeDst(e)));
+    }
+    std::vector<unsigned> single_dests;
+    for (auto e : single.edges(single_nodes[i])) {
+      single_dests.emplace_back(single.getData(single.getEdgeDst(e)));
+    }
+    std::sort(bulk_dests.begin(), bulk_dests.end());
+    std::sort(single_dests.begin(), single_dests.end());
+    KATANA_LOG_VASSERT(
+        bulk_dests == single_dests, "node {}: {} != {} edges", i,
+        bulk_dests.size(), single_dests.size());
+  }
+}
+
+void
+TestLCMorphGraph() {
+  using Graph = katana::LC_Morph_Graph<unsigned, unsigned>;
+  Graph graph;
+  std::vector<Graph::GraphNode> nodes;
+  for (unsigned i = 0; i < kNumNodes; ++i) {
+    int num_edges = Neighbors(i).size();
+    nodes.emplace_back(graph.createNode(num_edges, i));
+  }
+  // More edges than fit in a page
+  Graph::GraphNode hub = graph.createNode(1 << 20, kNumNodes);
+
+  for (unsigned i = 0; i < kNumNodes; ++i) {
+    std::vector<unsigned> ids = Neighbors(i);
+    std::vector<unsigned> unique_ids = ids;
+    std::sort(unique_ids.begin(), unique_ids.end());
+    unique_ids.erase(
+        std::unique(unique_ids.begin(), unique_ids.end()), unique_ids.end());
+
+    graph.addEdge(nodes[i], nodes[ids[0]], katana::MethodFlag::WRITE);
+    size_t num_added = graph.addEdgesBulk(nodes[i], Dests<Graph>(nodes, ids));
+    KATANA_LOG_ASSERT(num_added == unique_ids.size() - 1);
+
+    std::vector<unsigned> dests;
+    for (auto e : graph.edges(nodes[i])) {
+      dests.emplace_back(graph.getData(graph.getEdgeDst(e)));
+    }
+    std::sort(dests.begin(), dests.end());
+    KATANA_LOG_ASSERT(dests == unique_ids);
+  }
+
+  std::vector<Graph::GraphNode> hub_dests;
+  for (unsigned i = 0; i < (1 << 20); ++i) {
+    hub_dests.emplace_back(nodes[i % kNumNodes]);
+  }
+  KATANA_LOG_ASSERT(graph.addEdgesBulk(hub, hub_dests) == kNumNodes);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestMorphGraph<katana::MorphGraph<unsigned, unsigned, true>>();
+  TestMorphGraph<katana::MorphGraph<unsigned, unsigned, true, true>>();
+  TestMorphGraph<katana::MorphGraph<unsigned, unsigned, false>>();
+  TestMorphGraph<
+      katana::MorphGraph<unsigned, unsigned, false, false, false, true>>();
+  TestMorphGraph<katana::MorphGraph<unsigned, void, true, true>>();
+  TestLCMorphGraph();
+
+  return 0;
+}
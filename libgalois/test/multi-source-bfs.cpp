@@ -0,0 +1,118 @@
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/bfs/bfs.h"
+
+namespace {
+
+constexpr uint32_t kUnreached = std::numeric_limits<uint32_t>::max();
+
+/// The depth of every node in the tree that single source Bfs finds from
+/// source, which is its distance in hops, or kUnreached
+std::vector<uint32_t>
+SingleSourceLevels(katana::PropertyGraph* pg, uint32_t source) {
+  KATANA_LOG_ASSERT(katana::analytics::Bfs(pg, source, "parent"));
+  auto parent_res = pg->GetNodePropertyTyped<uint32_t>("parent");
+  KATANA_LOG_ASSERT(parent_res);
+  auto parent = parent_res.value();
+
+  const uint32_t num_nodes = pg->num_nodes();
+  std::vector<uint32_t> levels(num_nodes, kUnreached);
+  levels[source] = 0;
+  std::vector<uint32_t> path;
+  for (uint32_t n = 0; n < num_nodes; ++n) {
+    // Walk up to a node whose level is known, then number the path down
+    path.clear();
+    uint32_t m = n;
+    while (levels[m] == kUnreached && parent->Value(m) < num_nodes) {
+      path.emplace_back(m);
+      m = parent->Value(m);
+    }
+    if (levels[m] == kUnreached) {
+      continue;
+    }
+    for (auto it = path.rbegin(); it != path.rend(); ++it) {
+      levels[*it] = levels[m] + 1;
+      m = *it;
+    }
+  }
+  KATANA_LOG_ASSERT(pg->RemoveNodeProperty("parent"));
+  return levels;
+}
+
+/// Every row of the distance matrix matches a single source search, across
+/// batch boundaries and for repeated sources
+void
+TestDistances(
+    katana::PropertyGraph* pg, const std::vector<uint32_t>& sources,
+    uint32_t batch_size) {
+  auto dist_res = katana::analytics::MultiSourceBfsDistances(
+      pg, sources, katana::analytics::BfsPlan::MultiSource(batch_size));
+  KATANA_LOG_VASSERT(dist_res, "{}", dist_res.error());
+  const katana::NUMAArray<uint32_t>& dist = dist_res.value();
+
+  const uint32_t num_nodes = pg->num_nodes();
+  for (size_t i = 0; i < sources.size(); ++i) {
+    std::vector<uint32_t> expected = SingleSourceLevels(pg, sources[i]);
+    for (uint32_t n = 0; n < num_nodes; ++n) {
+      KATANA_LOG_VASSERT(
+          dist[i * num_nodes + n] == expected[n],
+          "batch {}: distance from {} to {} is {}, expected {}", batch_size,
+          sources[i], n, dist[i * num_nodes + n], expected[n]);
+    }
+  }
+}
+
+void
+TestProperties(katana::PropertyGraph* pg) {
+  std::vector<uint32_t> sources{3, 14, 15};
+  std::vector<std::string> names{"level-3", "level-14", "level-15"};
+  KATANA_LOG_ASSERT(katana::analytics::MultiSourceBfs(pg, sources, names));
+  for (size_t i = 0; i < sources.size(); ++i) {
+    auto res =
+        katana::analytics::MultiSourceBfsAssertValid(pg, sources[i], names[i]);
+    KATANA_LOG_VASSERT(res, "{}", res.error());
+    KATANA_LOG_ASSERT(pg->RemoveNodeProperty(names[i]));
+  }
+
+  // A repeated source must not reuse a property name
+  auto repeated = katana::analytics::MultiSourceBfs(
+      pg, {3, 3}, {"level-3", "level-3"});
+  KATANA_LOG_ASSERT(!repeated);
+  KATANA_LOG_ASSERT(repeated.error() == katana::ErrorCode::InvalidArgument);
+  KATANA_LOG_ASSERT(!pg->HasNodeProperty("level-3"));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  auto pg_res = katana::PropertyGraph::Make(
+      katana::CreateUniformRandomTopology(1000, 2));
+  KATANA_LOG_ASSERT(pg_res);
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_res.value());
+
+  std::mt19937 generator(7);
+  std::uniform_int_distribution<uint32_t> node_dist(0, pg->num_nodes() - 1);
+  std::vector<uint32_t> sources;
+  for (int i = 0; i < 70; ++i) {
+    sources.emplace_back(node_dist(generator));
+  }
+  // Repeated within a batch and across batches of 64
+  sources[10] = sources[0];
+  sources[66] = sources[1];
+
+  TestDistances(pg.get(), sources, 64);
+  TestDistances(pg.get(), sources, 128);
+  TestProperties(pg.get());
+
+  return 0;
+}
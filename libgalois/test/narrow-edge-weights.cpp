@@ -0,0 +1,111 @@
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/analytics/NarrowEdgeWeights.h"
+
+namespace {
+
+template <typename Weight>
+katana::analytics::NarrowEdgeWeights<Weight>
+Pack(const std::vector<Weight>& weights, double tolerance = 0) {
+  return katana::analytics::NarrowEdgeWeights<Weight>::Make(
+      weights.size(), [&](uint64_t e) { return weights[e]; }, tolerance);
+}
+
+/// Every weight decodes within tolerance, through both accessors
+template <typename Weight>
+void
+CheckDecoded(
+    const katana::analytics::NarrowEdgeWeights<Weight>& packed,
+    const std::vector<Weight>& weights, double tolerance = 0) {
+  packed.Visit(&weights, [&](auto* view) {
+    for (size_t e = 0; e < weights.size(); ++e) {
+      Weight w = (*view)[e];
+      KATANA_LOG_ASSERT(w == packed[e]);
+      double error = w < weights[e] ? static_cast<double>(weights[e] - w)
+                                    : static_cast<double>(w - weights[e]);
+      KATANA_LOG_ASSERT(error <= tolerance);
+    }
+    return 0;
+  });
+  KATANA_LOG_ASSERT(packed.max_error() <= tolerance);
+}
+
+void
+TestIntegers() {
+  // Small integers fit in 8 bits
+  std::vector<int64_t> small{-20, 7, 100, 3, -20, 230};
+  auto packed = Pack(small);
+  KATANA_LOG_ASSERT(packed.width() == 8);
+  KATANA_LOG_ASSERT(packed.max_error() == 0);
+  CheckDecoded(packed, small);
+
+  // A common difference extends the range: 1000 * k fits in 8 bits
+  std::vector<uint32_t> multiples;
+  for (uint32_t k = 0; k < 256; ++k) {
+    multiples.emplace_back(5 + 1000 * k);
+  }
+  auto packed_multiples = Pack(multiples);
+  KATANA_LOG_ASSERT(packed_multiples.width() == 8);
+  CheckDecoded(packed_multiples, multiples);
+
+  // The whole range of a type does not fit
+  std::vector<int32_t> extremes{
+      std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max(),
+      0};
+  KATANA_LOG_ASSERT(Pack(extremes).width() == 0);
+
+  std::vector<int32_t> wide;
+  for (int32_t k = 0; k < 1000; ++k) {
+    wide.emplace_back(k * k);
+  }
+  KATANA_LOG_ASSERT(Pack(wide).width() == 0);
+  auto packed_wide = Pack(wide, 8);
+  KATANA_LOG_ASSERT(packed_wide.width() == 16);
+  CheckDecoded(packed_wide, wide, 8);
+}
+
+void
+TestFloatingPoint() {
+  // Integral floats are packed exactly
+  std::vector<float> integral{1, 2, 4, 8, 3000, 65000};
+  auto packed = Pack(integral);
+  KATANA_LOG_ASSERT(packed.width() == 16);
+  CheckDecoded(packed, integral);
+
+  // Equal weights need no grid
+  std::vector<double> equal(100, 0.3);
+  KATANA_LOG_ASSERT(Pack(equal).width() == 8);
+  CheckDecoded(Pack(equal), equal);
+
+  // Arbitrary fractions only within a tolerance
+  std::vector<double> fractions;
+  for (int k = 0; k < 1000; ++k) {
+    fractions.emplace_back(0.1 + k * 0.0371);
+  }
+  KATANA_LOG_ASSERT(Pack(fractions).width() == 0);
+  auto packed_fractions = Pack(fractions, 0.1);
+  KATANA_LOG_ASSERT(packed_fractions.width() == 8);
+  CheckDecoded(packed_fractions, fractions, 0.1);
+  packed_fractions = Pack(fractions, 0.001);
+  KATANA_LOG_ASSERT(packed_fractions.width() == 16);
+  CheckDecoded(packed_fractions, fractions, 0.001);
+
+  std::vector<double> infinite{1, std::numeric_limits<double>::infinity()};
+  KATANA_LOG_ASSERT(Pack(infinite, 1).width() == 0);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys Katana_runtime;
+
+  TestIntegers();
+  TestFloatingPoint();
+
+  return 0;
+}
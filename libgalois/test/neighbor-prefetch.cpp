@@ -0,0 +1,148 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/GraphTopology.h"
+#include "katana/Logging.h"
+#include "katana/NeighborPrefetch.h"
+
+namespace {
+
+// A random graph where node i has i % 17 edges
+katana::GraphTopology
+MakeTopology(uint32_t num_nodes) {
+  std::mt19937 gen(num_nodes);
+  std::uniform_int_distribution<uint32_t> dist(0, num_nodes - 1);
+
+  katana::NUMAArray<uint64_t> adj_indices;
+  adj_indices.allocateInterleaved(num_nodes);
+  std::vector<uint32_t> dests;
+  for (uint32_t n = 0; n < num_nodes; ++n) {
+    for (uint32_t i = 0; i < n % 17; ++i) {
+      dests.emplace_back(dist(gen));
+    }
+    adj_indices[n] = dests.size();
+  }
+  katana::NUMAArray<uint32_t> dests_array;
+  dests_array.allocateInterleaved(dests.size());
+  std::copy(dests.begin(), dests.end(), dests_array.begin());
+  return katana::GraphTopology(std::move(adj_indices), std::move(dests_array));
+}
+
+void
+TestGather(uint32_t num_nodes, katana::PrefetchDistance* distance) {
+  katana::GraphTopology topo = MakeTopology(num_nodes);
+  std::vector<uint64_t> weight(num_nodes);
+  for (uint32_t n = 0; n < num_nodes; ++n) {
+    weight[n] = n * 3 + 1;
+  }
+
+  std::vector<uint64_t> expected(num_nodes, 0);
+  for (uint32_t n = 0; n < num_nodes; ++n) {
+    for (auto e : topo.edges(n)) {
+      expected[n] += weight[topo.edge_dest(e)];
+    }
+  }
+
+  std::vector<uint64_t> sums(num_nodes, ~uint64_t{0});
+  katana::GatherNeighborsPrefetched(
+      topo, weight.data(), distance, uint64_t{0},
+      [&](uint64_t sum, uint64_t, uint32_t dest) {
+        return sum + weight[dest];
+      },
+      [&](uint32_t n, uint64_t sum) {
+        KATANA_LOG_ASSERT(sums[n] == ~uint64_t{0});
+        sums[n] = sum;
+      });
+  KATANA_LOG_ASSERT(sums == expected);
+
+  for (uint32_t n = 0; n < num_nodes; n += 97) {
+    uint64_t sum = 0;
+    auto e = *topo.edges(n).begin();
+    katana::ForEachNeighborPrefetched(
+        topo, n, weight, distance->value() % 64,
+        [&](uint64_t edge, uint32_t dest) {
+          KATANA_LOG_ASSERT(edge == e++);
+          sum += weight[dest];
+        });
+    KATANA_LOG_ASSERT(sum == expected[n]);
+  }
+}
+
+/// Values indexed like an array that count how often they are indexed
+struct CountingProps {
+  const uint64_t* values;
+  std::atomic<uint64_t>* reads;
+
+  const uint64_t& operator[](size_t i) const {
+    reads->fetch_add(1, std::memory_order_relaxed);
+    return values[i];
+  }
+};
+
+/// Each neighbor is prefetched once, and none at distance zero
+void
+TestPrefetchCount(unsigned d) {
+  katana::GraphTopology topo = MakeTopology(3000);
+  std::vector<uint64_t> weight(topo.num_nodes(), 1);
+  std::atomic<uint64_t> reads{0};
+  CountingProps props{weight.data(), &reads};
+  uint64_t expected = d > 0 ? topo.num_edges() : 0;
+
+  katana::PrefetchDistance distance(d);
+  katana::GatherNeighborsPrefetched(
+      topo, props, &distance, uint64_t{0},
+      [&](uint64_t sum, uint64_t, uint32_t dest) {
+        return sum + weight[dest];
+      },
+      [&](uint32_t, uint64_t) {});
+  KATANA_LOG_VASSERT(
+      reads == expected, "distance {}: {} prefetches for {} edges", d,
+      reads.load(), topo.num_edges());
+
+  reads = 0;
+  for (uint32_t n = 0; n < topo.num_nodes(); ++n) {
+    katana::ForEachNeighborPrefetched(
+        topo, n, props, d, [&](uint64_t, uint32_t) {});
+  }
+  KATANA_LOG_VASSERT(
+      reads == expected, "distance {}: {} prefetches for {} edges", d,
+      reads.load(), topo.num_edges());
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys Katana_runtime;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxThreads());
+
+  // Too few edges to tune
+  katana::PrefetchDistance small;
+  TestGather(1000, &small);
+  KATANA_LOG_ASSERT(!small.tuned());
+
+  katana::PrefetchDistance tuned;
+  TestGather(1 << 18, &tuned);
+  KATANA_LOG_ASSERT(tuned.tuned());
+  bool is_candidate = false;
+  for (unsigned d : katana::PrefetchDistance::kCandidates) {
+    is_candidate = is_candidate || d == tuned.value();
+  }
+  KATANA_LOG_ASSERT(is_candidate);
+  // Reuses the tuned distance
+  TestGather(1 << 18, &tuned);
+
+  for (unsigned d : {0U, 1U, 8U, 1000U}) {
+    katana::PrefetchDistance fixed(d);
+    TestGather(5000, &fixed);
+    KATANA_LOG_ASSERT(fixed.value() == d);
+    TestPrefetchCount(d);
+  }
+
+  return 0;
+}
@@ -0,0 +1,66 @@
+#include <atomic>
+#include <cstdint>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/NUMAArray.h"
+
+namespace {
+
+void
+TestReplicated() {
+  constexpr uint32_t kSize = 1 << 16;
+
+  katana::NUMAArray<uint32_t> array;
+  array.allocateReplicated(kSize);
+
+  for (uint32_t round = 0; round < 3; ++round) {
+    katana::do_all(katana::iterate(uint32_t{0}, kSize), [&](uint32_t i) {
+      array[i] = i * 7 + round;
+    });
+    array.syncReplicas();
+
+    std::atomic<uint32_t> mismatches{0};
+    katana::do_all(
+        katana::iterate(uint32_t{0}, kSize),
+        [&](uint32_t i) {
+          // Gather from all over the array, as a random read kernel would
+          uint32_t j = (i * 2654435761U) % kSize;
+          if (array.get(j) != j * 7 + round) {
+            ++mismatches;
+          }
+        },
+        katana::steal());
+    KATANA_LOG_ASSERT(mismatches == 0);
+  }
+
+  auto moved = std::move(array);
+  KATANA_LOG_ASSERT(moved.size() == kSize);
+  KATANA_LOG_ASSERT(moved.get(kSize - 1) == (kSize - 1) * 7 + 2);
+  KATANA_LOG_ASSERT(array.empty());
+}
+
+void
+TestNotReplicated() {
+  katana::NUMAArray<uint32_t> array;
+  array.allocateInterleaved(16);
+  array.construct(5U);
+  array.syncReplicas();
+  KATANA_LOG_ASSERT(array.localData() == array.data());
+  KATANA_LOG_ASSERT(array.get(3) == 5);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys Katana_runtime;
+
+  for (unsigned threads : {1U, katana::GetThreadPool().getMaxThreads()}) {
+    katana::setActiveThreads(threads);
+    TestReplicated();
+    TestNotReplicated();
+  }
+
+  return 0;
+}
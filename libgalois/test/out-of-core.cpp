@@ -0,0 +1,159 @@
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+#include <boost/filesystem.hpp>
+
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/URI.h"
+#include "katana/analytics/out_of_core/out_of_core.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+
+/// Distances from source, by brute force
+std::vector<uint32_t>
+Distances(const katana::GraphTopology& topology, Node source) {
+  std::vector<uint32_t> dist(
+      topology.num_nodes(), std::numeric_limits<uint32_t>::max());
+  std::vector<Node> level{source};
+  dist[source] = 0;
+  for (uint32_t d = 1; !level.empty(); ++d) {
+    std::vector<Node> next;
+    for (Node n : level) {
+      for (auto e : topology.edges(n)) {
+        Node dest = topology.edge_dest(e);
+        if (dist[dest] == std::numeric_limits<uint32_t>::max()) {
+          dist[dest] = d;
+          next.emplace_back(dest);
+        }
+      }
+    }
+    level = std::move(next);
+  }
+  return dist;
+}
+
+/// The smallest node of the weak component of every node, by union-find
+std::vector<uint64_t>
+Components(const katana::GraphTopology& topology) {
+  std::vector<uint64_t> parent(topology.num_nodes());
+  std::iota(parent.begin(), parent.end(), 0);
+  auto find = [&](uint64_t n) {
+    while (parent[n] != n) {
+      n = parent[n] = parent[parent[n]];
+    }
+    return n;
+  };
+  for (Node n : topology.all_nodes()) {
+    for (auto e : topology.edges(n)) {
+      uint64_t a = find(n);
+      uint64_t b = find(topology.edge_dest(e));
+      parent[std::max(a, b)] = std::min(a, b);
+    }
+  }
+  for (uint64_t n = 0; n < parent.size(); ++n) {
+    parent[n] = find(n);
+  }
+  return parent;
+}
+
+/// PageRank after the given number of rounds, sequentially
+std::vector<float>
+Ranks(const katana::GraphTopology& topology, float alpha, unsigned rounds) {
+  uint64_t num_nodes = topology.num_nodes();
+  std::vector<float> rank(num_nodes, 1.0F / num_nodes);
+  for (unsigned round = 0; round < rounds; ++round) {
+    std::vector<float> sum(num_nodes, 0);
+    for (Node n : topology.all_nodes()) {
+      uint64_t degree = topology.degree(n);
+      for (auto e : topology.edges(n)) {
+        sum[topology.edge_dest(e)] += rank[n] / degree;
+      }
+    }
+    for (uint64_t n = 0; n < num_nodes; ++n) {
+      rank[n] = (1 - alpha) / num_nodes + alpha * sum[n];
+    }
+  }
+  return rank;
+}
+
+void
+TestAnalytics(
+    const katana::GraphTopology& topology, const std::string& rdg_dir,
+    const katana::analytics::OutOfCorePlan& plan) {
+  auto bfs_res = katana::analytics::OutOfCoreBfs(rdg_dir, 0, plan);
+  KATANA_LOG_VASSERT(bfs_res, "{}", bfs_res.error());
+  auto levels = std::static_pointer_cast<arrow::UInt32Array>(bfs_res.value());
+  std::vector<uint32_t> expected_levels = Distances(topology, 0);
+  for (Node n : topology.all_nodes()) {
+    KATANA_LOG_VASSERT(
+        levels->Value(n) == expected_levels[n], "node {}: {} != {}", n,
+        levels->Value(n), expected_levels[n]);
+  }
+
+  auto cc_res = katana::analytics::OutOfCoreConnectedComponents(rdg_dir, plan);
+  KATANA_LOG_VASSERT(cc_res, "{}", cc_res.error());
+  auto components =
+      std::static_pointer_cast<arrow::UInt64Array>(cc_res.value());
+  std::vector<uint64_t> expected_components = Components(topology);
+  for (Node n : topology.all_nodes()) {
+    KATANA_LOG_ASSERT(components->Value(n) == expected_components[n]);
+  }
+
+  constexpr unsigned kRounds = 10;
+  katana::analytics::PagerankPlan pagerank_plan(
+      katana::analytics::kCPU,
+      katana::analytics::PagerankPlan::kPullTopological, 0, kRounds, 0.85);
+  auto pr_res =
+      katana::analytics::OutOfCorePagerank(rdg_dir, pagerank_plan, plan);
+  KATANA_LOG_VASSERT(pr_res, "{}", pr_res.error());
+  auto ranks = std::static_pointer_cast<arrow::FloatArray>(pr_res.value());
+  std::vector<float> expected_ranks = Ranks(topology, 0.85, kRounds);
+  for (Node n : topology.all_nodes()) {
+    KATANA_LOG_VASSERT(
+        std::fabs(ranks->Value(n) - expected_ranks[n]) < 1e-6,
+        "node {}: {} != {}", n, ranks->Value(n), expected_ranks[n]);
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  auto pg_res =
+      katana::PropertyGraph::Make(katana::CreateUniformRandomTopology(4096, 3));
+  KATANA_LOG_ASSERT(pg_res);
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_res.value());
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/outofcore");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());
+  auto write_res = pg->Write(rdg_dir, "out-of-core");
+  KATANA_LOG_VASSERT(write_res, "{}", write_res.error());
+
+  // Blocks of 1000 edges, so nodes span blocks
+  for (uint32_t resident : {1, 2, 3}) {
+    TestAnalytics(
+        pg->topology(), rdg_dir,
+        katana::analytics::OutOfCorePlan::Blocks(4000, resident));
+  }
+  TestAnalytics(
+      pg->topology(), rdg_dir, katana::analytics::OutOfCorePlan());
+
+  KATANA_LOG_ASSERT(!katana::analytics::OutOfCoreBfs(rdg_dir, 1 << 20));
+
+  fs::remove_all(rdg_dir);
+  return 0;
+}
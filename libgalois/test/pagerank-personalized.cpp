@@ -0,0 +1,110 @@
+#include <cmath>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/pagerank/pagerank.h"
+
+namespace {
+
+using PagerankPlan = katana::analytics::PagerankPlan;
+
+constexpr uint32_t kNumNodes = 2000;
+
+/// Personalized ranks of one seed set by power iteration in double, on the
+/// transposed graph pg: the edges of n come from its in-neighbors
+std::vector<double>
+PowerIteration(
+    const katana::PropertyGraph& pg, const std::vector<uint32_t>& seeds,
+    double alpha) {
+  const katana::GraphTopology& topo = pg.topology();
+  std::vector<uint32_t> out_degree(kNumNodes);
+  for (auto e : topo.all_edges()) {
+    ++out_degree[topo.edge_dest(e)];
+  }
+  std::vector<double> restart(kNumNodes);
+  for (uint32_t seed : seeds) {
+    restart[seed] += (1 - alpha) / seeds.size();
+  }
+
+  std::vector<double> rank = restart;
+  std::vector<double> next(kNumNodes);
+  for (int iteration = 0; iteration < 1000; ++iteration) {
+    double diff = 0;
+    for (uint32_t n = 0; n < kNumNodes; ++n) {
+      double sum = 0;
+      for (auto e : topo.edges(n)) {
+        uint32_t src = topo.edge_dest(e);
+        sum += rank[src] / out_degree[src];
+      }
+      next[n] = alpha * sum + restart[n];
+      diff += std::abs(next[n] - rank[n]);
+    }
+    rank.swap(next);
+    if (diff < 1e-12) {
+      break;
+    }
+  }
+  return rank;
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  auto pg_res = katana::PropertyGraph::Make(
+      katana::CreateUniformRandomTopology(kNumNodes, 5));
+  KATANA_LOG_ASSERT(pg_res);
+  katana::PropertyGraph* pg = pg_res.value().get();
+
+  // More than a batch, so the last batch is partial; one seed is listed
+  // twice
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<uint32_t> node(0, kNumNodes - 1);
+  std::uniform_int_distribution<uint32_t> set_size(1, 5);
+  std::vector<std::vector<uint32_t>> seed_sets;
+  while (seed_sets.size() < PagerankPlan::kPersonalizedBatchWidth + 5) {
+    std::vector<uint32_t> seeds(set_size(gen));
+    for (uint32_t& seed : seeds) {
+      seed = node(gen);
+    }
+    seed_sets.emplace_back(std::move(seeds));
+  }
+  seed_sets[3].emplace_back(seed_sets[3].front());
+
+  PagerankPlan plan = PagerankPlan::PullTopological(1e-7, 1000);
+  auto batched_res =
+      katana::analytics::PersonalizedPagerankScores(pg, seed_sets, plan);
+  KATANA_LOG_VASSERT(batched_res, "{}", batched_res.error());
+  const katana::NUMAArray<float>& batched = batched_res.value();
+
+  for (size_t i = 0; i < seed_sets.size(); ++i) {
+    std::vector<double> expected =
+        PowerIteration(*pg, seed_sets[i], plan.alpha());
+    auto single_res = katana::analytics::PersonalizedPagerankScores(
+        pg, {seed_sets[i]}, plan);
+    KATANA_LOG_VASSERT(single_res, "{}", single_res.error());
+    for (uint32_t n = 0; n < kNumNodes; ++n) {
+      float rank = batched[i * kNumNodes + n];
+      KATANA_LOG_VASSERT(
+          std::abs(rank - expected[n]) < 1e-5,
+          "seed set {}: node {} has rank {}, expected {}", i, n, rank,
+          expected[n]);
+      KATANA_LOG_ASSERT(std::abs(single_res.value()[n] - expected[n]) < 1e-5);
+    }
+  }
+
+  // Seeds must be nodes and sets must not be empty
+  KATANA_LOG_ASSERT(!katana::analytics::PersonalizedPagerankScores(
+      pg, {{kNumNodes}}, plan));
+  KATANA_LOG_ASSERT(!katana::analytics::PersonalizedPagerankScores(
+      pg, std::vector<std::vector<uint32_t>>(1), plan));
+
+  return 0;
+}
@@ -0,0 +1,130 @@
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <nlohmann/json.hpp>
+#include <unistd.h>
+
+#include "katana/Galois.h"
+#include "katana/JSON.h"
+#include "katana/Logging.h"
+#include "katana/ParallelismProfile.h"
+
+namespace {
+
+constexpr uint64_t kSize = 1 << 12;
+constexpr int kRounds = 3;
+
+/// Run a bulk-synchronous loop and a for_each whose items form a binary
+/// tree, level by level
+void
+RunLoops() {
+  for (int r = 0; r < kRounds; ++r) {
+    std::atomic<uint64_t> sum{0};
+    katana::do_all(
+        katana::iterate(uint64_t{0}, kSize), [&](uint64_t i) { sum += i; },
+        katana::loopname("ProfiledDoAll"), katana::no_stats());
+    KATANA_LOG_ASSERT(sum == kSize * (kSize - 1) / 2);
+  }
+
+  std::atomic<uint64_t> visited{0};
+  katana::for_each(
+      katana::iterate({uint64_t{1}}),
+      [&](uint64_t i, auto& ctx) {
+        ++visited;
+        if (2 * i < kSize) {
+          ctx.push(2 * i);
+          ctx.push(2 * i + 1);
+        }
+      },
+      katana::loopname("ProfiledForEach"),
+      katana::disable_conflict_detection());
+  KATANA_LOG_ASSERT(visited == kSize - 1);
+
+  katana::do_all(katana::iterate(uint64_t{0}, kSize), [](uint64_t) {});
+}
+
+nlohmann::json
+ReadProfile(const std::string& path) {
+  std::ifstream in(path);
+  KATANA_LOG_VASSERT(in, "no profile at {}", path);
+  std::stringstream contents;
+  contents << in.rdbuf();
+  auto res = katana::JsonParse<nlohmann::json>(contents.str());
+  KATANA_LOG_VASSERT(res, "parsing {}: {}", path, res.error());
+  return res.value();
+}
+
+const nlohmann::json&
+FindLoop(const nlohmann::json& profile, const std::string& loopname) {
+  for (const auto& loop : profile["loops"]) {
+    if (loop["loopname"] == loopname) {
+      return loop;
+    }
+  }
+  KATANA_LOG_FATAL("loop {} not profiled", loopname);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  KATANA_LOG_ASSERT(!katana::ParallelismProfile::IsEnabled());
+
+  std::string path = std::filesystem::temp_directory_path() /
+                     ("parallelism-profile-" + std::to_string(getpid()) +
+                      ".json");
+  {
+    katana::ParallelismProfile::Scope scope(path);
+    KATANA_LOG_ASSERT(katana::ParallelismProfile::IsEnabled());
+    RunLoops();
+  }
+  KATANA_LOG_ASSERT(!katana::ParallelismProfile::IsEnabled());
+
+  nlohmann::json profile = ReadProfile(path);
+  std::remove(path.c_str());
+
+  // Unnamed loops and the loops run by the executors are not recorded
+  KATANA_LOG_VASSERT(
+      profile["loops"].size() == 2, "{} loops profiled",
+      profile["loops"].size());
+
+  const nlohmann::json& do_all = FindLoop(profile, "ProfiledDoAll");
+  KATANA_LOG_ASSERT(do_all["kind"] == "do_all");
+  KATANA_LOG_ASSERT(do_all["invocations"] == kRounds);
+  KATANA_LOG_ASSERT(do_all["critical_path"] == kRounds);
+  KATANA_LOG_ASSERT(do_all["work"] == kRounds * kSize);
+  KATANA_LOG_ASSERT(do_all["starved_rounds"] == 0);
+  for (const auto& round : do_all["rounds"]) {
+    KATANA_LOG_ASSERT(round["parallelism"] == kSize);
+    KATANA_LOG_ASSERT(round["max_thread_work"] <= kSize);
+    KATANA_LOG_ASSERT(round["threads"] == 4);
+  }
+
+  // One round per level of the tree, each twice the one before
+  const nlohmann::json& for_each = FindLoop(profile, "ProfiledForEach");
+  KATANA_LOG_ASSERT(for_each["kind"] == "for_each");
+  KATANA_LOG_ASSERT(for_each["invocations"] == 1);
+  KATANA_LOG_ASSERT(for_each["critical_path"] == 12);
+  KATANA_LOG_ASSERT(for_each["work"] == kSize - 1);
+  KATANA_LOG_ASSERT(for_each["max_parallelism"] == kSize / 2);
+  // Levels 0 and 1 have fewer items than threads
+  KATANA_LOG_ASSERT(for_each["starved_rounds"] == 2);
+  uint64_t expected = 1;
+  for (const auto& round : for_each["rounds"]) {
+    KATANA_LOG_ASSERT(round["parallelism"] == expected);
+    KATANA_LOG_ASSERT(round["work"] == expected);
+    expected *= 2;
+  }
+
+  // Profiled loops run the same as usual
+  RunLoops();
+
+  return 0;
+}
@@ -0,0 +1,206 @@
+#include <cstdint>
+#include <mutex>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/pattern_matching/pattern_matching.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+using katana::analytics::PatternMatchCount;
+using katana::analytics::PatternMatchEnumerate;
+using katana::analytics::PatternQuery;
+
+struct TypedEdge {
+  Node src;
+  Node dst;
+  katana::EntityTypeID type;
+};
+
+/// A graph whose nodes and edges each have one atomic type; edges must be
+/// in order of source
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph(
+    const std::vector<katana::EntityTypeID>& node_types,
+    const std::vector<TypedEdge>& edges,
+    katana::EntityTypeManager&& node_manager,
+    katana::EntityTypeManager&& edge_manager) {
+  std::vector<Edge> indices(node_types.size(), 0);
+  std::vector<Node> dests;
+  for (const auto& edge : edges) {
+    dests.emplace_back(edge.dst);
+    for (Node n = edge.src; n < node_types.size(); ++n) {
+      indices[n] = dests.size();
+    }
+  }
+  katana::PropertyGraph::EntityTypeIDArray node_type_ids;
+  node_type_ids.allocateBlocked(node_types.size());
+  for (size_t i = 0; i < node_types.size(); ++i) {
+    node_type_ids[i] = node_types[i];
+  }
+  katana::PropertyGraph::EntityTypeIDArray edge_type_ids;
+  edge_type_ids.allocateBlocked(edges.size());
+  for (size_t i = 0; i < edges.size(); ++i) {
+    edge_type_ids[i] = edges[i].type;
+  }
+
+  auto pg_res = katana::PropertyGraph::Make(
+      katana::GraphTopology(
+          indices.data(), indices.size(), dests.data(), dests.size()),
+      std::move(node_type_ids), std::move(edge_type_ids),
+      std::move(node_manager), std::move(edge_manager));
+  KATANA_LOG_VASSERT(pg_res, "making graph: {}", pg_res.error());
+  return std::move(pg_res.value());
+}
+
+katana::EntityTypeID
+AddType(katana::EntityTypeManager* manager, const std::string& name) {
+  auto res = manager->GetOrAddEntityTypeID(name);
+  KATANA_LOG_VASSERT(res, "adding type {}: {}", name, res.error());
+  return res.value();
+}
+
+uint64_t
+Count(katana::PropertyGraph* pg, const PatternQuery& query) {
+  auto res = PatternMatchCount(pg, query);
+  KATANA_LOG_VASSERT(res, "counting matches: {}", res.error());
+  return res.value();
+}
+
+PatternQuery
+MakeCycle(uint32_t length) {
+  PatternQuery cycle;
+  for (uint32_t i = 0; i < length; ++i) {
+    cycle.AddNode();
+  }
+  for (uint32_t i = 0; i < length; ++i) {
+    cycle.AddEdge(i, (i + 1) % length);
+  }
+  return cycle;
+}
+
+PatternQuery
+MakeDiamond(
+    std::optional<katana::EntityTypeID> source_type,
+    std::optional<katana::EntityTypeID> edge_type) {
+  PatternQuery diamond;
+  uint32_t a = diamond.AddNode(source_type);
+  uint32_t b = diamond.AddNode();
+  uint32_t c = diamond.AddNode();
+  uint32_t d = diamond.AddNode();
+  diamond.AddEdge(a, b, edge_type);
+  diamond.AddEdge(a, c, edge_type);
+  diamond.AddEdge(b, d, edge_type);
+  diamond.AddEdge(c, d, edge_type);
+  return diamond;
+}
+
+/// A directed 4-cycle 0..3 of type A nodes and x edges, and a diamond 4..7
+/// of type B nodes and y edges, with a parallel edge 4 -> 5
+void
+TestTypedPatterns() {
+  katana::EntityTypeManager node_manager;
+  katana::EntityTypeID a_type = AddType(&node_manager, "A");
+  katana::EntityTypeID b_type = AddType(&node_manager, "B");
+  katana::EntityTypeManager edge_manager;
+  katana::EntityTypeID x_type = AddType(&edge_manager, "x");
+  katana::EntityTypeID y_type = AddType(&edge_manager, "y");
+
+  std::vector<katana::EntityTypeID> node_types{
+      a_type, a_type, a_type, a_type, b_type, b_type, b_type, b_type};
+  std::vector<TypedEdge> edges{
+      {0, 1, x_type}, {1, 2, x_type}, {2, 3, x_type}, {3, 0, x_type},
+      {4, 5, y_type}, {4, 5, y_type}, {4, 6, y_type}, {5, 7, y_type},
+      {6, 7, y_type}};
+  auto pg = MakeGraph(
+      node_types, edges, std::move(node_manager), std::move(edge_manager));
+
+  // One cycle, matched once per rotation
+  KATANA_LOG_ASSERT(Count(pg.get(), MakeCycle(4)) == 4);
+  KATANA_LOG_ASSERT(Count(pg.get(), MakeCycle(3)) == 0);
+
+  // One diamond, matched with its middle nodes either way
+  KATANA_LOG_ASSERT(
+      Count(pg.get(), MakeDiamond(std::nullopt, std::nullopt)) == 2);
+  KATANA_LOG_ASSERT(Count(pg.get(), MakeDiamond(b_type, y_type)) == 2);
+  KATANA_LOG_ASSERT(Count(pg.get(), MakeDiamond(a_type, std::nullopt)) == 0);
+  KATANA_LOG_ASSERT(Count(pg.get(), MakeDiamond(std::nullopt, x_type)) == 0);
+
+  std::mutex mutex;
+  std::set<std::vector<uint32_t>> matches;
+  auto res = PatternMatchEnumerate(
+      pg.get(), MakeDiamond(std::nullopt, std::nullopt),
+      [&](const std::vector<uint32_t>& match) {
+        std::lock_guard<std::mutex> lock(mutex);
+        matches.emplace(match);
+      });
+  KATANA_LOG_VASSERT(res, "enumerating matches: {}", res.error());
+  std::set<std::vector<uint32_t>> expected{{4, 5, 6, 7}, {4, 6, 5, 7}};
+  KATANA_LOG_ASSERT(matches == expected);
+
+  PatternQuery disconnected;
+  disconnected.AddNode();
+  disconnected.AddNode();
+  KATANA_LOG_ASSERT(!PatternMatchCount(pg.get(), disconnected));
+
+  PatternQuery loop;
+  loop.AddEdge(loop.AddNode(), 0);
+  KATANA_LOG_ASSERT(!PatternMatchCount(pg.get(), loop));
+}
+
+/// Directed triangles of a random graph against a brute force count
+void
+TestTriangles() {
+  constexpr Node kNumNodes = 200;
+  constexpr uint32_t kDegree = 6;
+  katana::EntityTypeManager node_manager;
+  katana::EntityTypeID node_type = AddType(&node_manager, "N");
+  katana::EntityTypeManager edge_manager;
+  katana::EntityTypeID edge_type = AddType(&edge_manager, "E");
+
+  std::vector<TypedEdge> edges;
+  std::set<std::pair<Node, Node>> linked;
+  uint64_t state = 42;
+  for (Node src = 0; src < kNumNodes; ++src) {
+    for (uint32_t i = 0; i < kDegree; ++i) {
+      state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+      Node dst = (state >> 33) % 32 + (src / 32) * 32;
+      if (dst != src && dst < kNumNodes) {
+        edges.emplace_back(TypedEdge{src, dst, edge_type});
+        linked.emplace(src, dst);
+      }
+    }
+  }
+  uint64_t expected = 0;
+  for (auto [a, b] : linked) {
+    for (Node c = 0; c < kNumNodes; ++c) {
+      expected += c != a && c != b && linked.count({b, c}) &&
+                  linked.count({c, a});
+    }
+  }
+  KATANA_LOG_ASSERT(expected > 0);
+
+  auto pg = MakeGraph(
+      std::vector<katana::EntityTypeID>(kNumNodes, node_type), edges,
+      std::move(node_manager), std::move(edge_manager));
+  KATANA_LOG_ASSERT(Count(pg.get(), MakeCycle(3)) == expected);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxThreads());
+
+  TestTypedPatterns();
+  TestTriangles();
+
+  return 0;
+}
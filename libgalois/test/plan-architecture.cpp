@@ -0,0 +1,74 @@
+#include <memory>
+#include <string>
+
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/bfs/bfs.h"
+#include "katana/analytics/connected_components/connected_components.h"
+#include "katana/analytics/pagerank/pagerank.h"
+#include "katana/analytics/sssp/sssp.h"
+
+namespace {
+
+/// A call with a plan for another architecture than the CPU fails without
+/// creating its output property
+void
+CheckNotImplemented(
+    const katana::Result<void>& res, katana::PropertyGraph* pg,
+    const std::string& output_property_name) {
+  KATANA_LOG_ASSERT(!res);
+  KATANA_LOG_VASSERT(
+      res.error() == katana::ErrorCode::NotImplemented, "{}", res.error());
+  KATANA_LOG_ASSERT(!pg->HasNodeProperty(output_property_name));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  auto pg_res = katana::PropertyGraph::Make(
+      katana::CreateUniformRandomTopology(100, 2));
+  KATANA_LOG_ASSERT(pg_res);
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_res.value());
+
+  for (auto architecture :
+       {katana::analytics::kGPU, katana::analytics::kDistributedCPU,
+        katana::analytics::kDistributedGPU}) {
+    katana::analytics::BfsPlan bfs_plan;
+    bfs_plan.set_architecture(architecture);
+    KATANA_LOG_ASSERT(bfs_plan.architecture() == architecture);
+    CheckNotImplemented(
+        katana::analytics::Bfs(pg.get(), 0, "bfs", bfs_plan), pg.get(), "bfs");
+
+    // The architecture is checked before the weights are looked up
+    katana::analytics::SsspPlan sssp_plan;
+    sssp_plan.set_architecture(architecture);
+    CheckNotImplemented(
+        katana::analytics::Sssp(pg.get(), 0, "no-weights", "sssp", sssp_plan),
+        pg.get(), "sssp");
+
+    katana::analytics::PagerankPlan pagerank_plan;
+    pagerank_plan.set_architecture(architecture);
+    CheckNotImplemented(
+        katana::analytics::Pagerank(pg.get(), "pagerank", pagerank_plan),
+        pg.get(), "pagerank");
+
+    katana::analytics::ConnectedComponentsPlan cc_plan;
+    cc_plan.set_architecture(architecture);
+    CheckNotImplemented(
+        katana::analytics::ConnectedComponents(pg.get(), "cc", cc_plan),
+        pg.get(), "cc");
+  }
+
+  // The CPU still runs
+  katana::analytics::BfsPlan cpu_plan;
+  cpu_plan.set_architecture(katana::analytics::kGPU);
+  cpu_plan.set_architecture(katana::analytics::kCPU);
+  KATANA_LOG_ASSERT(katana::analytics::Bfs(pg.get(), 0, "bfs", cpu_plan));
+  KATANA_LOG_ASSERT(pg->HasNodeProperty("bfs"));
+
+  return 0;
+}
@@ -0,0 +1,263 @@
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/bfs/bfs.h"
+#include "katana/analytics/sssp/sssp.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+
+template <typename Weight>
+std::unique_ptr<katana::PropertyGraph>
+MakeWeightedGraph(
+    katana::GraphTopology&& topo, const std::vector<Weight>& weights) {
+  auto pg_res = katana::PropertyGraph::Make(std::move(topo));
+  KATANA_LOG_ASSERT(pg_res);
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_res.value());
+  KATANA_LOG_ASSERT(weights.size() == pg->num_edges());
+
+  typename arrow::CTypeTraits<Weight>::BuilderType builder;
+  KATANA_LOG_ASSERT(builder.AppendValues(weights).ok());
+  std::shared_ptr<arrow::Array> array;
+  KATANA_LOG_ASSERT(builder.Finish(&array).ok());
+  KATANA_LOG_ASSERT(pg->AddEdgeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("weight", array->type())}), {array})));
+  return pg;
+}
+
+/// The lightest edge from src to dest, or nullopt if there is none
+template <typename Weight>
+std::optional<Weight>
+LightestEdge(
+    const katana::PropertyGraph& pg, const std::vector<Weight>& weights,
+    Node src, Node dest) {
+  std::optional<Weight> lightest;
+  for (auto e : pg.topology().edges(src)) {
+    if (pg.topology().edge_dest(e) == dest &&
+        (!lightest || weights[e] < *lightest)) {
+      lightest = weights[e];
+    }
+  }
+  return lightest;
+}
+
+bool
+HasEdge(const katana::PropertyGraph& pg, Node src, Node dest) {
+  for (auto e : pg.topology().edges(src)) {
+    if (pg.topology().edge_dest(e) == dest) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/// BfsPath finds a path exactly as long as the one Bfs finds
+void
+CheckBfsPath(katana::PropertyGraph* pg, Node source, Node target) {
+  auto path_res = katana::analytics::BfsPath(pg, source, target);
+  KATANA_LOG_VASSERT(path_res, "{}", path_res.error());
+  const std::vector<uint32_t>& path = path_res.value();
+
+  KATANA_LOG_ASSERT(katana::analytics::Bfs(pg, source, "parent"));
+  auto parent_res = pg->GetNodePropertyTyped<uint32_t>("parent");
+  KATANA_LOG_ASSERT(parent_res);
+  auto parent = parent_res.value();
+
+  // Walk the BFS tree up from target
+  std::optional<size_t> hops = 0;
+  for (Node n = target; n != source; n = parent->Value(n)) {
+    if (parent->Value(n) >= pg->num_nodes()) {
+      hops.reset();
+      break;
+    }
+    ++*hops;
+  }
+  KATANA_LOG_ASSERT(pg->RemoveNodeProperty("parent"));
+
+  if (!hops) {
+    KATANA_LOG_VASSERT(
+        path.empty(), "{} reached {} but Bfs did not", source, target);
+    return;
+  }
+  KATANA_LOG_VASSERT(
+      path.size() == *hops + 1, "path of {} nodes, Bfs found {} hops",
+      path.size(), *hops);
+  KATANA_LOG_ASSERT(path.front() == source && path.back() == target);
+  for (size_t i = 0; i + 1 < path.size(); ++i) {
+    KATANA_LOG_ASSERT(HasEdge(*pg, path[i], path[i + 1]));
+  }
+}
+
+/// SsspPointToPoint finds a path as short as the one Sssp finds
+template <typename Weight>
+void
+CheckSsspPath(
+    katana::PropertyGraph* pg, const std::vector<Weight>& weights,
+    Node source, Node target) {
+  auto path_res =
+      katana::analytics::SsspPointToPoint(pg, source, target, "weight");
+  KATANA_LOG_VASSERT(path_res, "{}", path_res.error());
+  const katana::analytics::SsspPath& path = path_res.value();
+
+  KATANA_LOG_ASSERT(katana::analytics::Sssp(
+      pg, source, "weight", "distance",
+      katana::analytics::SsspPlan::Dijkstra()));
+  auto dist_res = pg->GetNodePropertyTyped<Weight>("distance");
+  KATANA_LOG_ASSERT(dist_res);
+  Weight expected = dist_res.value()->Value(target);
+  KATANA_LOG_ASSERT(pg->RemoveNodeProperty("distance"));
+
+  if (expected >= std::numeric_limits<Weight>::max() / 4) {
+    KATANA_LOG_VASSERT(
+        path.nodes.empty() &&
+            path.distance == std::numeric_limits<double>::infinity(),
+        "{} reached {} but Sssp did not", source, target);
+    return;
+  }
+  KATANA_LOG_VASSERT(
+      path.distance == static_cast<double>(expected),
+      "distance {} from {} to {}, Sssp found {}", path.distance, source,
+      target, expected);
+  KATANA_LOG_ASSERT(
+      path.nodes.front() == source && path.nodes.back() == target);
+  Weight length = 0;
+  for (size_t i = 0; i + 1 < path.nodes.size(); ++i) {
+    auto w = LightestEdge(*pg, weights, path.nodes[i], path.nodes[i + 1]);
+    KATANA_LOG_ASSERT(w);
+    length += *w;
+  }
+  KATANA_LOG_ASSERT(length == expected);
+}
+
+template <typename Weight>
+void
+TestRandomGraph(uint32_t seed) {
+  katana::GraphTopology topo = katana::CreateUniformRandomTopology(300, 3);
+  std::mt19937 generator(seed);
+  std::uniform_int_distribution<int> weight_dist(0, 50);
+  std::vector<Weight> weights;
+  for (size_t e = 0; e < topo.num_edges(); ++e) {
+    weights.emplace_back(weight_dist(generator));
+  }
+  auto pg = MakeWeightedGraph(std::move(topo), weights);
+
+  std::uniform_int_distribution<Node> node_dist(0, pg->num_nodes() - 1);
+  for (int i = 0; i < 10; ++i) {
+    Node source = node_dist(generator);
+    Node target = node_dist(generator);
+    CheckBfsPath(pg.get(), source, target);
+    CheckSsspPath(pg.get(), weights, source, target);
+  }
+  CheckBfsPath(pg.get(), 7, 7);
+  CheckSsspPath(pg.get(), weights, 7, 7);
+}
+
+/// 0 -> 1 -> 2 and 0 -> 2 directly but heavier; 3 has no edges
+void
+TestSmallGraph() {
+  std::vector<katana::GraphTopology::Edge> adj_indices{2, 3, 3, 3};
+  std::vector<Node> dests{1, 2, 2};
+  std::vector<uint32_t> weights{1, 10, 1};
+  auto pg = MakeWeightedGraph(
+      katana::GraphTopology(
+          adj_indices.data(), adj_indices.size(), dests.data(), dests.size()),
+      weights);
+
+  for (Node source = 0; source < 4; ++source) {
+    for (Node target = 0; target < 4; ++target) {
+      CheckBfsPath(pg.get(), source, target);
+      CheckSsspPath(pg.get(), weights, source, target);
+    }
+  }
+
+  auto shortest =
+      katana::analytics::SsspPointToPoint(pg.get(), 0, 2, "weight");
+  KATANA_LOG_ASSERT(shortest);
+  KATANA_LOG_ASSERT(shortest.value().distance == 2);
+  KATANA_LOG_ASSERT(
+      (shortest.value().nodes == std::vector<uint32_t>{0, 1, 2}));
+
+  auto unreachable = katana::analytics::BfsPath(pg.get(), 0, 3);
+  KATANA_LOG_ASSERT(unreachable && unreachable.value().empty());
+
+  auto same = katana::analytics::SsspPointToPoint(pg.get(), 3, 3, "weight");
+  KATANA_LOG_ASSERT(same);
+  KATANA_LOG_ASSERT(same.value().distance == 0);
+  KATANA_LOG_ASSERT((same.value().nodes == std::vector<uint32_t>{3}));
+}
+
+/// A negative weight is reported when the search reaches its edge, also
+/// when it is far from both the source and the target
+void
+TestNegativeWeights() {
+  std::vector<katana::GraphTopology::Edge> adj_indices{1, 2, 2};
+  std::vector<Node> dests{1, 2};
+  std::vector<int32_t> weights{4, -1};
+  auto pg = MakeWeightedGraph(
+      katana::GraphTopology(
+          adj_indices.data(), adj_indices.size(), dests.data(), dests.size()),
+      weights);
+
+  auto res = katana::analytics::SsspPointToPoint(pg.get(), 0, 2, "weight");
+  KATANA_LOG_ASSERT(!res);
+  KATANA_LOG_ASSERT(res.error() == katana::ErrorCode::InvalidArgument);
+
+  // The chain 0 -> 1 -> ... -> 9 with weight 1, except -1 on 4 -> 5
+  constexpr Node kChain = 10;
+  std::vector<katana::GraphTopology::Edge> chain_indices;
+  std::vector<Node> chain_dests;
+  std::vector<float> chain_weights;
+  for (Node n = 0; n < kChain; ++n) {
+    if (n + 1 < kChain) {
+      chain_dests.emplace_back(n + 1);
+      chain_weights.emplace_back(n == 4 ? -1 : 1);
+    }
+    chain_indices.emplace_back(chain_dests.size());
+  }
+  auto chain = MakeWeightedGraph(
+      katana::GraphTopology(
+          chain_indices.data(), chain_indices.size(), chain_dests.data(),
+          chain_dests.size()),
+      chain_weights);
+  auto far = katana::analytics::SsspPointToPoint(chain.get(), 0, 9, "weight");
+  KATANA_LOG_ASSERT(!far && far.error() == katana::ErrorCode::InvalidArgument);
+  // A search that never reaches the edge is not affected by it
+  auto before =
+      katana::analytics::SsspPointToPoint(chain.get(), 0, 3, "weight");
+  KATANA_LOG_VASSERT(before, "{}", before.error());
+  KATANA_LOG_ASSERT(before.value().distance == 3);
+  auto after =
+      katana::analytics::SsspPointToPoint(chain.get(), 6, 9, "weight");
+  KATANA_LOG_VASSERT(after, "{}", after.error());
+  KATANA_LOG_ASSERT(after.value().distance == 3);
+  auto backwards =
+      katana::analytics::SsspPointToPoint(chain.get(), 9, 0, "weight");
+  KATANA_LOG_VASSERT(backwards, "{}", backwards.error());
+  KATANA_LOG_ASSERT(backwards.value().nodes.empty());
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestRandomGraph<uint32_t>(1);
+  TestRandomGraph<int64_t>(2);
+  TestRandomGraph<double>(3);
+  TestSmallGraph();
+  TestNegativeWeights();
+
+  return 0;
+}
@@ -1,11 +1,17 @@
 #include <arrow/api.h>
 #include <boost/filesystem.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <utility>
+#include <vector>
 
 #include "TestTypedPropertyGraph.h"
 #include "katana/Logging.h"
 #include "katana/PropertyGraph.h"
 #include "katana/SharedMemSys.h"
 #include "katana/URI.h"
+#include "tsuba/CSRTopology.h"
 
 namespace {
 
@@ -335,6 +341,153 @@ TestRoundTrip() {
   }
 }
 
+void
+TestLoadOnAccess() {
+  constexpr size_t test_length = 10;
+  using ValueType = int32_t;
+
+  RandomPolicy policy{1};
+  auto g = MakeFileGraph<uint32_t>(test_length, 0, &policy);
+  KATANA_LOG_ASSERT(
+      g->AddNodeProperties(MakeProps<ValueType>("node-a", test_length)));
+  KATANA_LOG_ASSERT(
+      g->AddNodeProperties(MakeProps<ValueType>("node-b", test_length)));
+  KATANA_LOG_ASSERT(
+      g->AddEdgeProperties(MakeProps<ValueType>("edge-a", test_length)));
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  auto write_result = g->Write(rdg_dir, command_line);
+  if (!write_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  tsuba::RDGLoadOptions opts;
+  opts.load_properties_on_access = true;
+  auto make_result = katana::PropertyGraph::Make(rdg_dir, opts);
+  if (!make_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> g2 = std::move(make_result.value());
+
+  // Nothing is loaded until it is accessed
+  KATANA_LOG_ASSERT(g2->GetNumNodeProperties() == 0);
+  KATANA_LOG_ASSERT(g2->GetNumEdgeProperties() == 0);
+  KATANA_LOG_ASSERT(g2->full_node_schema()->num_fields() == 2);
+
+  KATANA_LOG_ASSERT(g2->PrefetchEdgeProperties({"edge-a", "missing"}));
+  KATANA_LOG_ASSERT(g2->GetNumEdgeProperties() == 0);
+
+  auto node_b = g2->GetNodeProperty("node-b");
+  KATANA_LOG_VASSERT(node_b, "{}", node_b.error());
+  KATANA_LOG_ASSERT(g2->GetNumNodeProperties() == 1);
+  KATANA_LOG_ASSERT(!g2->HasNodeProperty("node-a"));
+
+  auto edge_a = g2->GetEdgeProperty("edge-a");
+  KATANA_LOG_VASSERT(edge_a, "{}", edge_a.error());
+  KATANA_LOG_ASSERT(g2->GetNumEdgeProperties() == 1);
+
+  KATANA_LOG_ASSERT(!g2->GetNodeProperty("missing"));
+
+  KATANA_LOG_ASSERT(
+      node_b.value()->Equals(g->GetNodeProperty("node-b").value()));
+  KATANA_LOG_ASSERT(
+      edge_a.value()->Equals(g->GetEdgeProperty("edge-a").value()));
+
+  // The selected properties load while the graph is in use
+  tsuba::RDGLoadOptions background_opts;
+  background_opts.load_properties_in_background = true;
+  background_opts.node_properties = {"node-a"};
+  make_result = katana::PropertyGraph::Make(rdg_dir, background_opts);
+  if (!make_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> g3 = std::move(make_result.value());
+  KATANA_LOG_ASSERT(g3->num_edges() == g->num_edges());
+  KATANA_LOG_ASSERT(g3->GetNumNodeProperties() == 0);
+  KATANA_LOG_ASSERT(g3->GetNumEdgeProperties() == 0);
+
+  KATANA_LOG_ASSERT(g3->EnsureEdgePropertyLoaded("edge-a"));
+  KATANA_LOG_ASSERT(g3->GetNumEdgeProperties() == 1);
+  auto node_a = g3->GetNodeProperty("node-a");
+  KATANA_LOG_VASSERT(node_a, "{}", node_a.error());
+  // Unselected properties still load on access
+  KATANA_LOG_ASSERT(g3->GetNodeProperty("node-b"));
+  KATANA_LOG_ASSERT(g3->GetNumNodeProperties() == 2);
+  fs::remove_all(rdg_dir);
+
+  KATANA_LOG_ASSERT(
+      node_a.value()->Equals(g->GetNodeProperty("node-a").value()));
+  KATANA_LOG_ASSERT(g3->GetEdgeProperty("edge-a").value()->Equals(
+      g->GetEdgeProperty("edge-a").value()));
+}
+
+/// Many properties loaded through a few loads at a time, each decoding its
+/// columns in parallel, eagerly and in the background
+void
+TestManyPropertiesParallelDecode() {
+  constexpr size_t test_length = 1000;
+  constexpr int kNumNodeProperties = 64;
+  constexpr int kNumEdgeProperties = 16;
+
+  RandomPolicy policy{3};
+  auto g = MakeFileGraph<uint32_t>(test_length, 0, &policy);
+  for (int i = 0; i < kNumNodeProperties; ++i) {
+    KATANA_LOG_ASSERT(g->AddNodeProperties(
+        MakeProps<int64_t>(fmt::format("node-{}", i), test_length)));
+  }
+  for (int i = 0; i < kNumEdgeProperties; ++i) {
+    KATANA_LOG_ASSERT(g->AddEdgeProperties(
+        MakeProps<double>(fmt::format("edge-{}", i), g->num_edges())));
+  }
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  auto write_result = g->Write(rdg_dir, command_line);
+  if (!write_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  for (bool in_background : {false, true}) {
+    tsuba::RDGLoadOptions opts;
+    opts.max_concurrent_property_loads = 3;
+    opts.parallel_property_decode = true;
+    opts.load_properties_in_background = in_background;
+    auto make_result = katana::PropertyGraph::Make(rdg_dir, opts);
+    if (!make_result) {
+      fs::remove_all(rdg_dir);
+      KATANA_LOG_FATAL("making result: {}", make_result.error());
+    }
+    std::unique_ptr<katana::PropertyGraph> g2 = std::move(make_result.value());
+
+    for (int i = 0; i < kNumNodeProperties; ++i) {
+      std::string name = fmt::format("node-{}", i);
+      auto prop = g2->GetNodeProperty(name);
+      KATANA_LOG_VASSERT(prop, "{}: {}", name, prop.error());
+      KATANA_LOG_ASSERT(
+          prop.value()->Equals(g->GetNodeProperty(name).value()));
+    }
+    for (int i = 0; i < kNumEdgeProperties; ++i) {
+      std::string name = fmt::format("edge-{}", i);
+      auto prop = g2->GetEdgeProperty(name);
+      KATANA_LOG_VASSERT(prop, "{}: {}", name, prop.error());
+      KATANA_LOG_ASSERT(
+          prop.value()->Equals(g->GetEdgeProperty(name).value()));
+    }
+    KATANA_LOG_ASSERT(g2->GetNumNodeProperties() == kNumNodeProperties);
+    KATANA_LOG_ASSERT(g2->GetNumEdgeProperties() == kNumEdgeProperties);
+  }
+  fs::remove_all(rdg_dir);
+}
+
 void
 TestGarbageMetadata() {
   auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
@@ -437,6 +590,221 @@ TestTopologyAccess() {
   }
   KATANA_LOG_ASSERT(n_nodes == 10);
 }
+
+std::shared_ptr<arrow::Table>
+MakeParityProps(const std::string& name, size_t size, bool even) {
+  arrow::BooleanBuilder builder;
+  for (size_t i = 0; i < size; ++i) {
+    KATANA_LOG_ASSERT(builder.Append((i % 2 == 0) == even).ok());
+  }
+  std::shared_ptr<arrow::Array> array;
+  KATANA_LOG_ASSERT(builder.Finish(&array).ok());
+  return arrow::Table::Make(
+      arrow::schema({arrow::field(name, arrow::boolean())}), {array});
+}
+
+void
+TestDerivedTopologiesAfterNodeTypeChange() {
+  using katana::EdgeShuffleTopology;
+  constexpr size_t test_length = 100;
+  constexpr auto kNo = EdgeShuffleTopology::TransposeKind::kNo;
+  constexpr auto kByNodeType =
+      EdgeShuffleTopology::EdgeSortKind::kSortedByNodeType;
+
+  setenv("KATANA_PERSIST_DERIVED_TOPOLOGIES", "1", 1);
+
+  RandomPolicy policy{3};
+  auto g = MakeFileGraph<uint32_t>(test_length, 0, &policy);
+  KATANA_LOG_ASSERT(
+      g->AddNodeProperties(MakeParityProps("a", test_length, true)));
+  KATANA_LOG_ASSERT(g->ConstructEntityTypeIDs());
+  KATANA_LOG_ASSERT(g->BuildEdgeShuffleTopology(kNo, kByNodeType));
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  auto write_result = g->Write(rdg_dir, command_line);
+  if (!write_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  auto g2_res = katana::PropertyGraph::Make(rdg_dir, tsuba::RDGLoadOptions());
+  KATANA_LOG_ASSERT(g2_res);
+  auto g2 = std::move(g2_res.value());
+  auto loaded_res = g2->LoadDerivedTopology(kNo, kByNodeType);
+  KATANA_LOG_ASSERT(loaded_res && loaded_res.value() != nullptr);
+
+  // flip the types of all nodes; the stored sorted topology is now stale
+  KATANA_LOG_ASSERT(
+      g2->UpsertNodeProperties(MakeParityProps("a", test_length, false)));
+  KATANA_LOG_ASSERT(g2->ConstructEntityTypeIDs());
+  auto commit_result = g2->Commit(command_line);
+  if (!commit_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("commit result: {}", commit_result.error());
+  }
+
+  auto g3_res = katana::PropertyGraph::Make(rdg_dir, tsuba::RDGLoadOptions());
+  fs::remove_all(rdg_dir);
+  unsetenv("KATANA_PERSIST_DERIVED_TOPOLOGIES");
+  KATANA_LOG_ASSERT(g3_res);
+  auto g3 = std::move(g3_res.value());
+  auto stale_res = g3->LoadDerivedTopology(kNo, kByNodeType);
+  KATANA_LOG_ASSERT(stale_res && stale_res.value() == nullptr);
+
+  KATANA_LOG_ASSERT(g3->GetTypeOfNode(0) != g->GetTypeOfNode(0));
+  auto topo = g3->BuildEdgeShuffleTopology(kNo, kByNodeType);
+  KATANA_LOG_ASSERT(topo);
+  for (size_t n = 0; n < test_length; ++n) {
+    katana::EntityTypeID prev = 0;
+    for (auto e : topo->edges(n)) {
+      katana::EntityTypeID type = g3->GetTypeOfNode(topo->edge_dest(e));
+      KATANA_LOG_VASSERT(
+          type >= prev, "edges of node {} not sorted by node type", n);
+      prev = type;
+    }
+  }
+}
+
+/// The edges of each node of two topologies derived with the same states
+/// are the same, up to the order of edges that their sort order ties
+void
+CheckSameDerivedTopology(
+    const katana::EdgeShuffleTopology& loaded,
+    const katana::EdgeShuffleTopology& built) {
+  KATANA_LOG_ASSERT(loaded.num_nodes() == built.num_nodes());
+  KATANA_LOG_ASSERT(loaded.num_edges() == built.num_edges());
+  KATANA_LOG_ASSERT(loaded.transpose_state() == built.transpose_state());
+  KATANA_LOG_ASSERT(loaded.edge_sort_state() == built.edge_sort_state());
+  bool by_dest = built.edge_sort_state() ==
+                 katana::EdgeShuffleTopology::EdgeSortKind::kSortedByDestID;
+  for (size_t n = 0; n < built.num_nodes(); ++n) {
+    KATANA_LOG_ASSERT(*loaded.edges(n).end() == *built.edges(n).end());
+    std::vector<std::pair<uint32_t, uint64_t>> loaded_edges;
+    std::vector<std::pair<uint32_t, uint64_t>> built_edges;
+    for (auto e : built.edges(n)) {
+      loaded_edges.emplace_back(
+          loaded.edge_dest(e), loaded.edge_property_index(e));
+      built_edges.emplace_back(
+          built.edge_dest(e), built.edge_property_index(e));
+      if (by_dest && loaded_edges.size() > 1) {
+        KATANA_LOG_ASSERT(
+            loaded_edges[loaded_edges.size() - 2].first <=
+            loaded_edges.back().first);
+      }
+    }
+    std::sort(loaded_edges.begin(), loaded_edges.end());
+    std::sort(built_edges.begin(), built_edges.end());
+    KATANA_LOG_VASSERT(
+        loaded_edges == built_edges, "edges of node {} differ", n);
+  }
+}
+
+/// Point the last edge of every stored derived topology in rdg_dir at an
+/// edge property index past the last edge
+void
+CorruptDerivedTopologies(const std::string& rdg_dir) {
+  uint64_t num_corrupted = 0;
+  for (const auto& entry : fs::directory_iterator(rdg_dir)) {
+    if (entry.path().filename().string().rfind("derived_topology", 0) != 0) {
+      continue;
+    }
+    std::fstream file(
+        entry.path().string(),
+        std::ios::in | std::ios::out | std::ios::binary);
+    tsuba::CSRTopologyHeader header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    KATANA_LOG_ASSERT(
+        file && header.version == tsuba::kDerivedCSRTopologyVersion);
+    file.seekp(
+        tsuba::DerivedCSRTopologyFileSize(header) - sizeof(uint64_t));
+    file.write(
+        reinterpret_cast<const char*>(&header.num_edges), sizeof(uint64_t));
+    KATANA_LOG_ASSERT(file);
+    ++num_corrupted;
+  }
+  KATANA_LOG_ASSERT(num_corrupted > 0);
+}
+
+void
+TestDerivedTopologiesRoundTrip() {
+  using katana::EdgeShuffleTopology;
+  using TransposeKind = EdgeShuffleTopology::TransposeKind;
+  using EdgeSortKind = EdgeShuffleTopology::EdgeSortKind;
+  constexpr size_t test_length = 100;
+  const std::vector<std::pair<TransposeKind, EdgeSortKind>> kinds{
+      {TransposeKind::kYes, EdgeSortKind::kAny},
+      {TransposeKind::kYes, EdgeSortKind::kSortedByDestID},
+      {TransposeKind::kNo, EdgeSortKind::kSortedByDestID},
+  };
+
+  setenv("KATANA_PERSIST_DERIVED_TOPOLOGIES", "1", 1);
+
+  RandomPolicy policy{3};
+  auto g = MakeFileGraph<uint32_t>(test_length, 0, &policy);
+  for (const auto& [tpose_kind, sort_kind] : kinds) {
+    KATANA_LOG_ASSERT(g->BuildEdgeShuffleTopology(tpose_kind, sort_kind));
+  }
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  auto write_result = g->Write(rdg_dir, command_line);
+  if (!write_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  // Stored topologies match the ones built from the reloaded graph
+  auto g2_res = katana::PropertyGraph::Make(rdg_dir, tsuba::RDGLoadOptions());
+  KATANA_LOG_ASSERT(g2_res);
+  auto g2 = std::move(g2_res.value());
+  for (const auto& [tpose_kind, sort_kind] : kinds) {
+    auto loaded_res = g2->LoadDerivedTopology(tpose_kind, sort_kind);
+    KATANA_LOG_ASSERT(loaded_res && loaded_res.value() != nullptr);
+    auto built = EdgeShuffleTopology::Make(g2.get(), tpose_kind, sort_kind);
+    CheckSameDerivedTopology(*loaded_res.value(), *built);
+  }
+
+  // A stored topology whose edge property indices are out of range fails
+  // to load, and views rebuild it instead
+  CorruptDerivedTopologies(rdg_dir);
+  auto corrupt_res =
+      katana::PropertyGraph::Make(rdg_dir, tsuba::RDGLoadOptions());
+  KATANA_LOG_ASSERT(corrupt_res);
+  for (const auto& [tpose_kind, sort_kind] : kinds) {
+    KATANA_LOG_ASSERT(
+        !corrupt_res.value()->LoadDerivedTopology(tpose_kind, sort_kind));
+    auto rebuilt =
+        corrupt_res.value()->BuildEdgeShuffleTopology(tpose_kind, sort_kind);
+    KATANA_LOG_ASSERT(rebuilt);
+    CheckSameDerivedTopology(
+        *rebuilt,
+        *EdgeShuffleTopology::Make(g2.get(), tpose_kind, sort_kind));
+  }
+
+  // Rewriting the topology drops the stored ones
+  KATANA_LOG_ASSERT(g2->ReplaceTopology(
+      katana::GraphTopology::Copy(g2->topology()), {}, {}, nullptr, nullptr));
+  auto commit_result = g2->Commit(command_line);
+  if (!commit_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("commit result: {}", commit_result.error());
+  }
+
+  auto g3_res = katana::PropertyGraph::Make(rdg_dir, tsuba::RDGLoadOptions());
+  fs::remove_all(rdg_dir);
+  unsetenv("KATANA_PERSIST_DERIVED_TOPOLOGIES");
+  KATANA_LOG_ASSERT(g3_res);
+  for (const auto& [tpose_kind, sort_kind] : kinds) {
+    auto dropped_res =
+        g3_res.value()->LoadDerivedTopology(tpose_kind, sort_kind);
+    KATANA_LOG_ASSERT(dropped_res && dropped_res.value() == nullptr);
+  }
+}
 }  // namespace
 
 int
@@ -452,11 +820,15 @@ main(int argc, char** argv) {
   command_line = cmdout.str();
 
   TestRoundTrip();
+  TestLoadOnAccess();
+  TestManyPropertiesParallelDecode();
   TestGarbageMetadata();
   TestSimplePGs();
   TestTopologyAccess();
   TestTypesFromPropertiesCompareTypesFromStorage();
   TestCompositeTypesFromPropertiesCompareCompositeTypesFromStorage();
+  TestDerivedTopologiesAfterNodeTypeChange();
+  TestDerivedTopologiesRoundTrip();
 
   return 0;
 }
@@ -0,0 +1,254 @@
+#include <optional>
+#include <string>
+
+#include <arrow/api.h>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyFilter.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/subgraph_extraction/subgraph_extraction.h"
+
+using P = katana::PropertyPredicate;
+
+namespace {
+
+// Enough nodes for several parallel tasks and a partial last bitset word
+constexpr size_t kNumNodes = 100000;
+
+/// The age of node i, or nullopt if it is null
+std::optional<int64_t>
+Age(size_t i) {
+  if (i % 17 == 0) {
+    return std::nullopt;
+  }
+  return i % 100;
+}
+
+std::string
+Name(size_t i) {
+  return "n" + std::to_string(i % 10);
+}
+
+bool
+IsPerson(size_t i) {
+  return i % 3 == 0;
+}
+
+bool
+IsRobot(size_t i) {
+  return i % 5 == 0;
+}
+
+template <typename BuilderType>
+std::shared_ptr<arrow::ChunkedArray>
+Finish(BuilderType* builder) {
+  std::shared_ptr<arrow::Array> array;
+  KATANA_LOG_ASSERT(builder->Finish(&array).ok());
+  return std::make_shared<arrow::ChunkedArray>(array);
+}
+
+/// Make the node properties, including the uint8 Person and Robot properties
+/// from which the node types are constructed
+std::shared_ptr<arrow::Table>
+MakeNodeProperties(size_t num_nodes) {
+  arrow::Int64Builder age;
+  arrow::LargeStringBuilder name;
+  arrow::DoubleBuilder score;
+  arrow::UInt8Builder person;
+  arrow::UInt8Builder robot;
+  for (size_t i = 0; i < num_nodes; ++i) {
+    auto a = Age(i);
+    KATANA_LOG_ASSERT((a ? age.Append(*a) : age.AppendNull()).ok());
+    KATANA_LOG_ASSERT(name.Append(Name(i)).ok());
+    KATANA_LOG_ASSERT(score.Append(i * 0.5).ok());
+    KATANA_LOG_ASSERT(person.Append(IsPerson(i)).ok());
+    KATANA_LOG_ASSERT(robot.Append(IsRobot(i)).ok());
+  }
+  return arrow::Table::Make(
+      arrow::schema({
+          arrow::field("age", arrow::int64()),
+          arrow::field("name", arrow::large_utf8()),
+          arrow::field("score", arrow::float64()),
+          arrow::field("Person", arrow::uint8()),
+          arrow::field("Robot", arrow::uint8()),
+      }),
+      {Finish(&age), Finish(&name), Finish(&score), Finish(&person),
+       Finish(&robot)});
+}
+
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph() {
+  LinePolicy policy{3};
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<uint32_t>(kNumNodes, 0, &policy);
+  KATANA_LOG_ASSERT(g->AddNodeProperties(MakeNodeProperties(kNumNodes)));
+
+  arrow::UInt32Builder weight;
+  for (size_t i = 0; i < g->num_edges(); ++i) {
+    KATANA_LOG_ASSERT(weight.Append(i % 7).ok());
+  }
+  KATANA_LOG_ASSERT(g->AddEdgeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("weight", arrow::uint32())}),
+      {Finish(&weight)})));
+
+  auto types_result = g->ConstructEntityTypeIDs();
+  KATANA_LOG_VASSERT(
+      types_result, "could not construct types: {}", types_result.error());
+  return g;
+}
+
+template <typename Expected>
+void
+CheckSelection(
+    const katana::DynamicBitset& selected, size_t num_entities,
+    const Expected& expected, const std::string& what) {
+  KATANA_LOG_VASSERT(
+      selected.size() == num_entities, "{}: {} bits for {} entities", what,
+      selected.size(), num_entities);
+  size_t num_expected = 0;
+  for (size_t i = 0; i < num_entities; ++i) {
+    bool e = expected(i);
+    num_expected += e;
+    KATANA_LOG_VASSERT(
+        selected.test(i) == e, "{}: entity {} is {}selected", what, i,
+        e ? "not " : "");
+  }
+  KATANA_LOG_VASSERT(
+      selected.count() == num_expected, "{}: {} set bits, expected {}", what,
+      selected.count(), num_expected);
+}
+
+template <typename Expected>
+void
+CheckNodes(
+    const katana::PropertyGraph& g, const P& predicate,
+    const Expected& expected) {
+  auto selected = g.FilterNodes(predicate);
+  KATANA_LOG_VASSERT(
+      selected, "{}: {}", predicate.ToString(), selected.error());
+  CheckSelection(
+      selected.value(), g.num_nodes(), expected, predicate.ToString());
+}
+
+void
+TestNodeFilters(const katana::PropertyGraph& g) {
+  auto i64 = [](int64_t v) { return arrow::MakeScalar(v); };
+  auto str = [](const std::string& v) { return arrow::MakeScalar(v); };
+
+  CheckNodes(g, P::Compare("age", P::Op::kEqual, i64(42)), [](size_t i) {
+    return Age(i) == 42;
+  });
+  CheckNodes(g, P::Compare("age", P::Op::kNotEqual, i64(42)), [](size_t i) {
+    return Age(i) && Age(i) != 42;
+  });
+  CheckNodes(g, P::Compare("age", P::Op::kLess, i64(10)), [](size_t i) {
+    return Age(i) && *Age(i) < 10;
+  });
+  CheckNodes(g, P::Compare("age", P::Op::kGreaterEqual, i64(90)), [](size_t i) {
+    return Age(i) && *Age(i) >= 90;
+  });
+  CheckNodes(g, P::Between("age", i64(18), i64(65)), [](size_t i) {
+    return Age(i) && *Age(i) >= 18 && *Age(i) <= 65;
+  });
+
+  // A null property value is selected only through Not
+  CheckNodes(g, P::Not(P::Compare("age", P::Op::kLess, i64(10))), [](size_t i) {
+    return !Age(i) || *Age(i) >= 10;
+  });
+
+  // Values are cast to the type of the property
+  CheckNodes(
+      g, P::Compare("age", P::Op::kLessEqual, arrow::MakeScalar(int32_t{5})),
+      [](size_t i) { return Age(i) && *Age(i) <= 5; });
+  CheckNodes(
+      g, P::Compare("score", P::Op::kGreater, arrow::MakeScalar(int64_t{400})),
+      [](size_t i) { return i * 0.5 > 400; });
+
+  std::vector<std::shared_ptr<arrow::Scalar>> ages;
+  for (int64_t a : {3, 5, 7, 11, 13, 17, 19, 23, 29, 31}) {
+    ages.emplace_back(i64(a));
+  }
+  CheckNodes(g, P::In("age", ages), [](size_t i) {
+    auto a = Age(i);
+    return a && (*a == 3 || *a == 5 || *a == 7 || *a == 11 || *a == 13 ||
+                 *a == 17 || *a == 19 || *a == 23 || *a == 29 || *a == 31);
+  });
+  CheckNodes(g, P::In("age", {}), [](size_t) { return false; });
+
+  CheckNodes(
+      g, P::Compare("name", P::Op::kEqual, str("n3")),
+      [](size_t i) { return Name(i) == "n3"; });
+  CheckNodes(
+      g, P::In("name", {str("n1"), str("n2")}),
+      [](size_t i) { return Name(i) == "n1" || Name(i) == "n2"; });
+
+  CheckNodes(g, P::HasType("Person"), IsPerson);
+  CheckNodes(
+      g, P::And({P::HasType("Person"), P::HasType("Robot")}),
+      [](size_t i) { return IsPerson(i) && IsRobot(i); });
+  CheckNodes(
+      g, P::Or({P::HasType("Person"), P::HasType("Robot")}),
+      [](size_t i) { return IsPerson(i) || IsRobot(i); });
+  CheckNodes(
+      g,
+      P::And({
+          P::HasType("Person"),
+          P::Not(P::HasType("Robot")),
+          P::Between("age", i64(18), i64(65)),
+      }),
+      [](size_t i) {
+        return IsPerson(i) && !IsRobot(i) && Age(i) && *Age(i) >= 18 &&
+               *Age(i) <= 65;
+      });
+  CheckNodes(g, P::And({}), [](size_t) { return true; });
+  CheckNodes(g, P::Or({}), [](size_t) { return false; });
+
+  KATANA_LOG_ASSERT(
+      !g.FilterNodes(P::Compare("missing", P::Op::kEqual, i64(1))));
+  KATANA_LOG_ASSERT(!g.FilterNodes(P::HasType("Missing")));
+  KATANA_LOG_ASSERT(
+      !g.FilterNodes(P::Compare("age", P::Op::kEqual, str("not a number"))));
+}
+
+void
+TestEdgeFilters(const katana::PropertyGraph& g) {
+  P predicate = P::In(
+      "weight",
+      {arrow::MakeScalar(uint32_t{0}), arrow::MakeScalar(uint32_t{4})});
+  auto selected = g.FilterEdges(predicate);
+  KATANA_LOG_VASSERT(selected, "{}", selected.error());
+  CheckSelection(
+      selected.value(), g.num_edges(),
+      [](size_t i) { return i % 7 == 0 || i % 7 == 4; }, predicate.ToString());
+}
+
+void
+TestSubGraphExtraction(katana::PropertyGraph* g) {
+  auto selected = g->FilterNodes(P::HasType("Robot"));
+  KATANA_LOG_ASSERT(selected);
+  auto subgraph_result = katana::analytics::SubGraphExtraction(
+      g, selected.value(), {"age"}, {});
+  KATANA_LOG_VASSERT(subgraph_result, "{}", subgraph_result.error());
+  auto subgraph = std::move(subgraph_result.value());
+  KATANA_LOG_ASSERT(subgraph->num_nodes() == selected.value().count());
+
+  auto wrong_size = katana::DynamicBitset();
+  wrong_size.resize(g->num_nodes() + 1);
+  KATANA_LOG_ASSERT(!katana::analytics::SubGraphExtraction(g, wrong_size));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  std::unique_ptr<katana::PropertyGraph> g = MakeGraph();
+  TestNodeFilters(*g);
+  TestEdgeFilters(*g);
+  TestSubGraphExtraction(g.get());
+
+  return 0;
+}
@@ -0,0 +1,96 @@
+#include <string>
+#include <vector>
+
+#include "katana/BuildGraph.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+void
+CheckEdges(
+    const katana::GraphTopology& topo, uint32_t node,
+    const std::vector<uint32_t>& expected) {
+  auto range = topo.edges(node);
+  KATANA_LOG_VASSERT(
+      range.size() == expected.size(), "node {} has {} edges, expected {}",
+      node, range.size(), expected.size());
+  size_t i = 0;
+  for (auto e : range) {
+    KATANA_LOG_VASSERT(
+        topo.edge_dest(e) == expected[i], "edge {} of {} is to {}, expected {}",
+        i, node, topo.edge_dest(e), expected[i]);
+    ++i;
+  }
+}
+
+void
+TestForwardReferences() {
+  katana::PropertyGraphBuilder builder(3);
+  builder.StartNode("a");
+  builder.FinishNode();
+  builder.AddEdge("a", "c");
+  builder.AddEdge("c", "a");
+  builder.AddEdge("d", "b");
+  builder.AddEdge("c", "d");
+  builder.StartNode("b");
+  builder.FinishNode();
+  builder.StartNode("c");
+  builder.FinishNode();
+
+  auto result = builder.Finish(false);
+  KATANA_LOG_VASSERT(result, "{}", result.error());
+  const katana::GraphTopology& topo = result.value().topology;
+
+  // d is never added, so it is created as a placeholder after c
+  KATANA_LOG_ASSERT(topo.num_nodes() == 4);
+  KATANA_LOG_ASSERT(topo.num_edges() == 4);
+  CheckEdges(topo, 0, {2});
+  CheckEdges(topo, 1, {});
+  CheckEdges(topo, 2, {0, 3});
+  CheckEdges(topo, 3, {1});
+}
+
+void
+TestManyForwardReferences() {
+  constexpr size_t kNumNodes = 2000;
+  constexpr size_t kNumEdges = 20000;
+  auto source = [](size_t e) { return (e * 13) % kNumNodes; };
+  auto dest = [](size_t e) { return (e * 31 + 5) % kNumNodes; };
+  auto id = [](size_t n) { return "node" + std::to_string(n); };
+
+  katana::PropertyGraphBuilder builder(100);
+  for (size_t e = 0; e < kNumEdges; ++e) {
+    builder.AddEdge(id(source(e)), id(dest(e)));
+  }
+  for (size_t n = 0; n < kNumNodes; ++n) {
+    builder.StartNode(id(n));
+    builder.FinishNode();
+  }
+
+  auto result = builder.Finish(false);
+  KATANA_LOG_VASSERT(result, "{}", result.error());
+  const katana::GraphTopology& topo = result.value().topology;
+  KATANA_LOG_ASSERT(topo.num_nodes() == kNumNodes);
+  KATANA_LOG_ASSERT(topo.num_edges() == kNumEdges);
+
+  std::vector<std::vector<uint32_t>> expected(kNumNodes);
+  for (size_t e = 0; e < kNumEdges; ++e) {
+    expected[source(e)].emplace_back(dest(e));
+  }
+  for (size_t n = 0; n < kNumNodes; ++n) {
+    CheckEdges(topo, n, expected[n]);
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestForwardReferences();
+  TestManyForwardReferences();
+
+  return 0;
+}
@@ -316,5 +316,21 @@ main() {
   KATANA_LOG_VASSERT(
       g1->ReportDiff(g3.get()) == out3, "{}{}", g1->ReportDiff(g3.get()), out3);
 
+  // Equal values chunked differently
+  auto g4 = CreateGraph1();
+  KATANA_LOG_ASSERT(g4->Validate());
+  auto n0 = g4->GetNodeProperty("n0").value();
+  arrow::ArrayVector chunks = n0->Slice(0, 37)->chunks();
+  for (const auto& chunk : n0->Slice(37)->chunks()) {
+    chunks.emplace_back(chunk);
+  }
+  auto rechunked = arrow::Table::Make(
+      arrow::schema({arrow::field("n0", n0->type())}),
+      {std::make_shared<arrow::ChunkedArray>(chunks)});
+  KATANA_LOG_ASSERT(g4->UpsertNodeProperties(rechunked));
+  KATANA_LOG_ASSERT(g1->Equals(g4.get()));
+  KATANA_LOG_VASSERT(
+      g1->ReportDiff(g4.get()) == out1, "{}{}", g1->ReportDiff(g4.get()), out1);
+
   return 0;
 }
@@ -1,6 +1,16 @@
+#include <algorithm>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include <arrow/api.h>
+
 #include "katana/Logging.h"
+#include "katana/Loops.h"
 #include "katana/PropertyGraph.h"
 #include "katana/SharedMemSys.h"
+#include "katana/ThreadPool.h"
+#include "katana/Threads.h"
 
 void
 TestEdgeSource(const katana::GraphTopology& topo) noexcept {
@@ -12,6 +22,701 @@ TestEdgeSource(const katana::GraphTopology& topo) noexcept {
   }
 }
 
+/// A borrowed topology reads the buffers it is given, and views of it are
+/// built from copies
+void
+TestBorrowed(const katana::GraphTopology& topo) noexcept {
+  katana::GraphTopology borrowed(
+      topo.adj_data(), topo.num_nodes(), topo.dest_data(), topo.num_edges(),
+      katana::GraphTopology::Placement::kBorrowed);
+  KATANA_LOG_ASSERT(borrowed.borrowed());
+  KATANA_LOG_ASSERT(borrowed.adj_data() == topo.adj_data());
+  KATANA_LOG_ASSERT(borrowed.dest_data() == topo.dest_data());
+  KATANA_LOG_ASSERT(borrowed.Equals(topo));
+
+  katana::GraphTopology copy = katana::GraphTopology::Copy(borrowed);
+  KATANA_LOG_ASSERT(!copy.borrowed());
+  KATANA_LOG_ASSERT(copy.dest_data() != topo.dest_data());
+
+  auto pg_res = katana::PropertyGraph::Make(std::move(borrowed));
+  KATANA_LOG_ASSERT(pg_res);
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_res.value());
+  using SortedView = katana::PropertyGraphViews::EdgesSortedByDestID;
+  SortedView sorted = pg->BuildView<SortedView>();
+  KATANA_LOG_ASSERT(sorted.num_edges() == topo.num_edges());
+  // Sorting the view leaves the borrowed buffers alone
+  KATANA_LOG_ASSERT(pg->topology().Equals(topo));
+}
+
+using SortedView = katana::PropertyGraphViews::EdgesSortedByDestID;
+using BiDirView = katana::PropertyGraphViews::BiDirectional;
+using UndirectedView = katana::PropertyGraphViews::Undirected;
+
+void
+CheckSortedView(const katana::PropertyGraph* pg, const SortedView& sorted) {
+  for (auto node : sorted.all_nodes()) {
+    KATANA_LOG_ASSERT(sorted.degree(node) == pg->topology().degree(node));
+    katana::GraphTopology::Node prev{0};
+    for (auto e : sorted.edges(node)) {
+      KATANA_LOG_ASSERT(sorted.edge_dest(e) >= prev);
+      prev = sorted.edge_dest(e);
+    }
+  }
+}
+
+void
+CheckBiDirView(const katana::PropertyGraph* pg, const BiDirView& bidir) {
+  uint64_t num_in_edges = 0;
+  for (auto node : bidir.all_nodes()) {
+    num_in_edges += bidir.in_degree(node);
+  }
+  KATANA_LOG_ASSERT(num_in_edges == pg->num_edges());
+}
+
+/// Views stay usable when the cache is over budget, since eviction skips the
+/// topologies they pin
+void
+TestViewCacheBudget(katana::GraphTopology&& topo) noexcept {
+  auto pg_res = katana::PropertyGraph::Make(std::move(topo));
+  KATANA_LOG_ASSERT(pg_res);
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_res.value());
+
+  pg->SetViewCacheByteBudget(1);
+  SortedView sorted = pg->BuildView<SortedView>();
+  auto sorted_topo = pg->BuildEdgeShuffleTopology(
+      katana::EdgeShuffleTopology::TransposeKind::kNo,
+      katana::EdgeShuffleTopology::EdgeSortKind::kSortedByDestID);
+  BiDirView bidir = pg->BuildView<BiDirView>();
+  // Found in the cache rather than rebuilt: the cache is over its one byte
+  // budget, but sorted pins the topology
+  SortedView sorted_again = pg->BuildView<SortedView>();
+  KATANA_LOG_ASSERT(
+      pg->BuildEdgeShuffleTopology(
+          katana::EdgeShuffleTopology::TransposeKind::kNo,
+          katana::EdgeShuffleTopology::EdgeSortKind::kSortedByDestID) ==
+      sorted_topo);
+
+  CheckSortedView(pg.get(), sorted);
+  CheckSortedView(pg.get(), sorted_again);
+  CheckBiDirView(pg.get(), bidir);
+}
+
+/// The budgeted cache used from several threads: pool threads look up views
+/// while the cache evicts, then views are built and dropped in turn on all
+/// threads within a budget of about one topology
+void
+TestViewCacheThreads(katana::GraphTopology&& topo) noexcept {
+  auto pg_res = katana::PropertyGraph::Make(std::move(topo));
+  KATANA_LOG_ASSERT(pg_res);
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_res.value());
+
+  unsigned old_threads = katana::getActiveThreads();
+  katana::setActiveThreads(
+      std::min(4U, katana::GetThreadPool().getMaxThreads()));
+
+  katana::PGViewCache cache;
+  cache.set_byte_budget(katana::PGViewCache::kUnlimitedBudget);
+  size_t pinned_bytes = 0;
+  size_t sorted_bytes = 0;
+  {
+    SortedView sorted = cache.BuildView<SortedView>(pg.get());
+    sorted_bytes = cache.cached_bytes();
+    BiDirView bidir = cache.BuildView<BiDirView>(pg.get());
+    pinned_bytes = cache.cached_bytes();
+    // Cached but not pinned, so the first eviction drops it
+    cache.BuildView<UndirectedView>(pg.get());
+    KATANA_LOG_ASSERT(cache.cached_bytes() > pinned_bytes);
+
+    auto sorted_topo = cache.BuildEdgeShuffTopo(
+        pg.get(), katana::EdgeShuffleTopology::TransposeKind::kNo,
+        katana::EdgeShuffleTopology::EdgeSortKind::kSortedByDestID);
+    // Every lookup is a hit, since views pin what they are built from, so
+    // no thread starts a nested parallel loop to build one
+    katana::on_each([&](unsigned tid, unsigned) {
+      if (tid == 0) {
+        cache.set_byte_budget(1);
+      }
+      for (int i = 0; i < 100; ++i) {
+        SortedView s = cache.BuildView<SortedView>(pg.get());
+        BiDirView b = cache.BuildView<BiDirView>(pg.get());
+        KATANA_LOG_ASSERT(s.num_edges() == pg->num_edges());
+        KATANA_LOG_ASSERT(b.num_edges() == pg->num_edges());
+        KATANA_LOG_ASSERT(
+            cache.BuildEdgeShuffTopo(
+                pg.get(), katana::EdgeShuffleTopology::TransposeKind::kNo,
+                katana::EdgeShuffleTopology::EdgeSortKind::kSortedByDestID) ==
+            sorted_topo);
+      }
+    });
+    KATANA_LOG_ASSERT(cache.cached_bytes() == pinned_bytes);
+    CheckSortedView(pg.get(), sorted);
+    CheckBiDirView(pg.get(), bidir);
+  }
+
+  // Each build evicts the topologies of the views dropped before it
+  cache.set_byte_budget(sorted_bytes);
+  for (int round = 0; round < 3; ++round) {
+    {
+      SortedView sorted = cache.BuildView<SortedView>(pg.get());
+      KATANA_LOG_ASSERT(cache.cached_bytes() <= sorted_bytes);
+      CheckSortedView(pg.get(), sorted);
+    }
+    {
+      BiDirView bidir = cache.BuildView<BiDirView>(pg.get());
+      CheckBiDirView(pg.get(), bidir);
+    }
+    {
+      UndirectedView undirected = cache.BuildView<UndirectedView>(pg.get());
+      KATANA_LOG_ASSERT(undirected.num_nodes() == pg->num_nodes());
+    }
+  }
+  cache.set_byte_budget(1);
+  KATANA_LOG_ASSERT(cache.cached_bytes() == 0);
+
+  katana::setActiveThreads(old_threads);
+}
+
+void
+TestSortedByDegree(katana::GraphTopology&& topo) noexcept {
+  auto pg_res = katana::PropertyGraph::Make(std::move(topo));
+  KATANA_LOG_ASSERT(pg_res);
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_res.value());
+
+  using DegreeView =
+      katana::PropertyGraphViews::NodesSortedByDegreeEdgesSortedByDestID;
+  DegreeView view = pg->BuildView<DegreeView>();
+  KATANA_LOG_ASSERT(view.num_edges() == pg->num_edges());
+
+  size_t prev_degree = 0;
+  for (auto node : view.all_nodes()) {
+    KATANA_LOG_ASSERT(view.degree(node) >= prev_degree);
+    prev_degree = view.degree(node);
+    katana::GraphTopology::Node prev_dest{0};
+    for (auto e : view.edges(node)) {
+      KATANA_LOG_ASSERT(view.edge_dest(e) >= prev_dest);
+      prev_dest = view.edge_dest(e);
+    }
+  }
+}
+
+/// A reordered view must be a renumbering of the original graph
+template <typename View>
+void
+TestReordered(katana::PropertyGraph* pg) noexcept {
+  View view = pg->BuildView<View>();
+  KATANA_LOG_ASSERT(view.num_nodes() == pg->num_nodes());
+  KATANA_LOG_ASSERT(view.num_edges() == pg->num_edges());
+
+  std::vector<uint32_t> new_ids(pg->num_nodes(), UINT32_MAX);
+  for (auto node : view.all_nodes()) {
+    auto old_id = view.node_property_index(node);
+    KATANA_LOG_ASSERT(old_id < pg->num_nodes());
+    KATANA_LOG_ASSERT(new_ids[old_id] == UINT32_MAX);
+    new_ids[old_id] = node;
+  }
+
+  for (auto node : view.all_nodes()) {
+    auto old_id = view.node_property_index(node);
+    KATANA_LOG_ASSERT(view.degree(node) == pg->topology().degree(old_id));
+    for (auto e : pg->topology().edges(old_id)) {
+      KATANA_LOG_ASSERT(
+          view.has_edge(node, new_ids[pg->topology().edge_dest(e)]));
+    }
+  }
+}
+
+void
+TestCompactTopology(katana::PropertyGraph* pg) noexcept {
+  using SortedView = katana::PropertyGraphViews::EdgesSortedByDestID;
+  using AnyWidthView = katana::PropertyGraphViews::EdgesSortedByDestIDAnyWidth;
+
+  SortedView sorted = pg->BuildView<SortedView>();
+  AnyWidthView any_width = pg->BuildView<AnyWidthView>();
+  KATANA_LOG_ASSERT(any_width.is_compact());
+
+  any_width.Visit([&](const auto& topo) {
+    KATANA_LOG_ASSERT(topo.num_nodes() == sorted.num_nodes());
+    KATANA_LOG_ASSERT(topo.num_edges() == sorted.num_edges());
+    for (auto node : topo.all_nodes()) {
+      KATANA_LOG_ASSERT(topo.degree(node) == sorted.degree(node));
+      auto sorted_e = *sorted.edges(node).begin();
+      for (auto e : topo.edges(node)) {
+        KATANA_LOG_ASSERT(topo.edge_dest(e) == sorted.edge_dest(sorted_e));
+        KATANA_LOG_ASSERT(
+            topo.edge_property_index(e) ==
+            sorted.edge_property_index(sorted_e));
+        KATANA_LOG_ASSERT(topo.has_edge(node, topo.edge_dest(e)));
+        ++sorted_e;
+      }
+    }
+  });
+}
+
+/// Lookups through the hub index must agree with the plain adjacency lists
+void
+TestHubIndex(katana::PropertyGraph* pg, uint64_t max_bytes) noexcept {
+  using Topo = katana::EdgeShuffleTopology;
+  auto plain = Topo::Make(
+      pg, Topo::TransposeKind::kNo, Topo::EdgeSortKind::kSortedByDestID);
+  auto indexed = Topo::Make(
+      pg, Topo::TransposeKind::kNo, Topo::EdgeSortKind::kSortedByDestID);
+  indexed->BuildHubIndex(1, max_bytes);
+  KATANA_LOG_ASSERT(indexed->hub_index_bytes() <= max_bytes);
+
+  for (auto src : plain->all_nodes()) {
+    for (auto dst : plain->all_nodes()) {
+      KATANA_LOG_ASSERT(
+          *plain->find_edge(src, dst) == *indexed->find_edge(src, dst));
+      KATANA_LOG_ASSERT(
+          plain->has_edge(src, dst) == indexed->has_edge(src, dst));
+    }
+  }
+}
+
+void
+TestEdgeBalancedPartition(const katana::GraphTopology& topo) noexcept {
+  auto partition = topo.edge_balanced_partition();
+  KATANA_LOG_ASSERT(partition == topo.edge_balanced_partition());
+  KATANA_LOG_ASSERT(partition->num_threads() == katana::getActiveThreads());
+
+  const auto& ranges = partition->thread_ranges();
+  KATANA_LOG_ASSERT(ranges.front() == 0);
+  KATANA_LOG_ASSERT(ranges.back() == topo.num_nodes());
+  KATANA_LOG_ASSERT(std::is_sorted(ranges.begin(), ranges.end()));
+
+  katana::NUMAArray<uint32_t> visits;
+  visits.allocateInterleaved(topo.num_nodes());
+  std::fill(visits.begin(), visits.end(), 0);
+  katana::do_all(
+      katana::iterate(*partition),
+      [&](auto node) { __sync_fetch_and_add(&visits[node], 1); },
+      katana::steal());
+  for (auto node : topo.all_nodes()) {
+    KATANA_LOG_ASSERT(visits[node] == 1);
+  }
+}
+
+/// A table with one uint8 property per type name, so that
+/// ConstructEntityTypeIDs gives entity i type names[j] iff i % (j + 2) == 0
+std::shared_ptr<arrow::Table>
+MakeTypeProperties(size_t num_entities, const std::vector<std::string>& names) {
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (size_t j = 0; j < names.size(); ++j) {
+    arrow::UInt8Builder builder;
+    for (size_t i = 0; i < num_entities; ++i) {
+      KATANA_LOG_ASSERT(builder.Append(i % (j + 2) == 0).ok());
+    }
+    std::shared_ptr<arrow::Array> array;
+    KATANA_LOG_ASSERT(builder.Finish(&array).ok());
+    fields.emplace_back(arrow::field(names[j], arrow::uint8()));
+    columns.emplace_back(std::make_shared<arrow::ChunkedArray>(array));
+  }
+  return arrow::Table::Make(arrow::schema(fields), columns);
+}
+
+/// Check that partition lists, in order, the entities for which has_type is
+/// true, and that a loop over a list visits exactly them
+template <typename Partition, typename HasType>
+void
+CheckTypePartition(
+    const Partition& partition, size_t num_entities, size_t num_types,
+    const HasType& has_type) noexcept {
+  KATANA_LOG_ASSERT(partition.num_types() == num_types);
+  for (size_t t = 0; t < num_types; ++t) {
+    std::vector<uint64_t> expected;
+    for (size_t i = 0; i < num_entities; ++i) {
+      if (has_type(i, t)) {
+        expected.emplace_back(i);
+      }
+    }
+    auto entities = partition.entities(t);
+    KATANA_LOG_ASSERT(std::equal(
+        entities.begin(), entities.end(), expected.begin(), expected.end()));
+
+    katana::NUMAArray<uint32_t> visits;
+    visits.allocateInterleaved(num_entities);
+    std::fill(visits.begin(), visits.end(), 0);
+    katana::do_all(katana::iterate(entities), [&](auto id) {
+      __sync_fetch_and_add(&visits[id], 1);
+    });
+    for (size_t i = 0; i < num_entities; ++i) {
+      KATANA_LOG_ASSERT(visits[i] == (has_type(i, t) ? 1 : 0));
+    }
+  }
+  KATANA_LOG_ASSERT(partition.entities(num_types).empty());
+}
+
+void
+TestTypePartition(katana::GraphTopology&& topo) noexcept {
+  auto pg_res = katana::PropertyGraph::Make(std::move(topo));
+  KATANA_LOG_ASSERT(pg_res);
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_res.value());
+
+  KATANA_LOG_ASSERT(pg->AddNodeProperties(
+      MakeTypeProperties(pg->num_nodes(), {"Even", "Third", "Fourth"})));
+  KATANA_LOG_ASSERT(
+      pg->AddEdgeProperties(MakeTypeProperties(pg->num_edges(), {"Even"})));
+  KATANA_LOG_ASSERT(pg->ConstructEntityTypeIDs());
+
+  auto nodes = pg->GetNodeTypePartition();
+  KATANA_LOG_ASSERT(nodes == pg->GetNodeTypePartition());
+  CheckTypePartition(
+      *nodes, pg->num_nodes(), pg->GetNumNodeEntityTypes(),
+      [&](size_t n, size_t t) {
+        if (t == katana::kUnknownEntityType) {
+          return pg->GetTypeOfNode(n) == katana::kUnknownEntityType;
+        }
+        return pg->DoesNodeHaveType(n, t);
+      });
+  // Each node of type Even and Fourth is also in the list of Even
+  auto even = pg->GetNodeEntityTypeID("Even");
+  KATANA_LOG_ASSERT(nodes->num_entities(even) == (pg->num_nodes() + 1) / 2);
+
+  auto edges = pg->GetEdgeTypePartition();
+  CheckTypePartition(
+      *edges, pg->num_edges(), pg->GetNumEdgeEntityTypes(),
+      [&](size_t e, size_t t) {
+        if (t == katana::kUnknownEntityType) {
+          return pg->GetTypeOfEdge(e) == katana::kUnknownEntityType;
+        }
+        return pg->DoesEdgeHaveType(e, t);
+      });
+
+  // New types replace the cached partitions
+  KATANA_LOG_ASSERT(pg->ConstructEntityTypeIDs());
+  KATANA_LOG_ASSERT(nodes != pg->GetNodeTypePartition());
+}
+
+/// The edges of each node to nodes of each type are those found by brute
+/// force, sorted by destination
+void
+TestDestTypeAware(katana::GraphTopology&& topo) noexcept {
+  auto pg_res = katana::PropertyGraph::Make(std::move(topo));
+  KATANA_LOG_ASSERT(pg_res);
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_res.value());
+
+  KATANA_LOG_ASSERT(pg->AddNodeProperties(
+      MakeTypeProperties(pg->num_nodes(), {"Even", "Third", "Fourth"})));
+  KATANA_LOG_ASSERT(pg->ConstructEntityTypeIDs());
+
+  using View = katana::PropertyGraphViews::DestTypeAware;
+  View view = pg->BuildView<View>();
+  const katana::GraphTopology& original = pg->topology();
+  KATANA_LOG_ASSERT(view.num_edges() == original.num_edges());
+
+  size_t num_types = 0;
+  for (auto type : view.GetDistinctNodeTypes()) {
+    KATANA_LOG_ASSERT(view.DoesNodeTypeExist(type));
+    ++num_types;
+  }
+  // Unknown, Even, Third, Even and Third, and Even and Fourth, ...
+  KATANA_LOG_ASSERT(num_types > 3);
+
+  for (auto n : original.all_nodes()) {
+    size_t degree = 0;
+    for (auto type : view.GetDistinctNodeTypes()) {
+      std::vector<uint32_t> expected;
+      for (auto e : original.edges(n)) {
+        if (pg->GetTypeOfNode(original.edge_dest(e)) == type) {
+          expected.emplace_back(original.edge_dest(e));
+        }
+      }
+      std::sort(expected.begin(), expected.end());
+
+      std::vector<uint32_t> found;
+      for (auto e : view.edges(n, type)) {
+        KATANA_LOG_ASSERT(
+            original.edge_dest(view.edge_property_index(e)) ==
+            view.edge_dest(e));
+        found.emplace_back(view.edge_dest(e));
+      }
+      KATANA_LOG_ASSERT(found == expected);
+      KATANA_LOG_ASSERT(view.degree(n, type) == expected.size());
+      for (auto dest : expected) {
+        KATANA_LOG_ASSERT(view.IsConnected(n, dest, type));
+      }
+      degree += found.size();
+    }
+    KATANA_LOG_ASSERT(degree == view.degree(n));
+  }
+}
+
+/// A table with one uint64 property, name, whose value is the row
+std::shared_ptr<arrow::Table>
+MakeRowProperty(size_t num_entities, const std::string& name) {
+  arrow::UInt64Builder builder;
+  for (size_t i = 0; i < num_entities; ++i) {
+    KATANA_LOG_ASSERT(builder.Append(i).ok());
+  }
+  std::shared_ptr<arrow::Array> array;
+  KATANA_LOG_ASSERT(builder.Finish(&array).ok());
+  return arrow::Table::Make(
+      arrow::schema({arrow::field(name, arrow::uint64())}), {array});
+}
+
+std::shared_ptr<arrow::UInt64Array>
+Rows(const katana::Result<std::shared_ptr<arrow::ChunkedArray>>& property) {
+  KATANA_LOG_ASSERT(property);
+  auto array = katana::CombinedArray(property.value());
+  KATANA_LOG_ASSERT(array);
+  return std::static_pointer_cast<arrow::UInt64Array>(array.value());
+}
+
+/// Node i of a permuted graph must be node old_ids[i], with its type,
+/// properties and edges in order
+void
+TestPermuteNodes(katana::GraphTopology&& topo) noexcept {
+  auto pg_res = katana::PropertyGraph::Make(std::move(topo));
+  KATANA_LOG_ASSERT(pg_res);
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_res.value());
+  KATANA_LOG_ASSERT(pg->AddNodeProperties(
+      MakeTypeProperties(pg->num_nodes(), {"Even", "Third"})));
+  KATANA_LOG_ASSERT(
+      pg->AddEdgeProperties(MakeTypeProperties(pg->num_edges(), {"Even"})));
+  KATANA_LOG_ASSERT(pg->ConstructEntityTypeIDs());
+  KATANA_LOG_ASSERT(
+      pg->AddNodeProperties(MakeRowProperty(pg->num_nodes(), "row")));
+  KATANA_LOG_ASSERT(
+      pg->AddEdgeProperties(MakeRowProperty(pg->num_edges(), "row")));
+
+  size_t num_nodes = pg->num_nodes();
+  katana::NUMAArray<uint32_t> old_ids;
+  old_ids.allocateInterleaved(num_nodes);
+  std::vector<uint32_t> new_ids(num_nodes);
+  for (size_t i = 0; i < num_nodes; ++i) {
+    old_ids[i] = (i * 7 + 3) % num_nodes;
+    new_ids[old_ids[i]] = i;
+  }
+
+  auto permuted_res = katana::PermuteNodes(*pg, old_ids);
+  KATANA_LOG_VASSERT(permuted_res, "{}", permuted_res.error());
+  const katana::PropertyGraph& permuted = *permuted_res.value();
+  const katana::GraphTopology& topo_in = pg->topology();
+  const katana::GraphTopology& topo_out = permuted.topology();
+  KATANA_LOG_ASSERT(topo_out.num_nodes() == num_nodes);
+  KATANA_LOG_ASSERT(topo_out.num_edges() == topo_in.num_edges());
+
+  auto node_rows = Rows(permuted.GetNodeProperty("row"));
+  auto edge_rows = Rows(permuted.GetEdgeProperty("row"));
+  for (size_t i = 0; i < num_nodes; ++i) {
+    uint32_t old_id = old_ids[i];
+    KATANA_LOG_ASSERT(node_rows->Value(i) == old_id);
+    KATANA_LOG_ASSERT(permuted.GetTypeOfNode(i) == pg->GetTypeOfNode(old_id));
+    auto old_edges = topo_in.edges(old_id);
+    auto new_edges = topo_out.edges(i);
+    KATANA_LOG_ASSERT(old_edges.size() == new_edges.size());
+    auto old_e = old_edges.begin();
+    for (auto e : new_edges) {
+      KATANA_LOG_ASSERT(
+          topo_out.edge_dest(e) == new_ids[topo_in.edge_dest(*old_e)]);
+      KATANA_LOG_ASSERT(edge_rows->Value(e) == *old_e);
+      KATANA_LOG_ASSERT(permuted.GetTypeOfEdge(e) == pg->GetTypeOfEdge(*old_e));
+      ++old_e;
+    }
+  }
+
+  // Ids that are not a permutation
+  old_ids[0] = old_ids[1];
+  KATANA_LOG_ASSERT(!katana::PermuteNodes(*pg, old_ids));
+}
+
+/// A graph relabeled by degree must have its nodes by descending degree and
+/// its edges by destination, with the types and properties of the originals
+void
+TestRelabelNodesByDegree(katana::GraphTopology&& topo) noexcept {
+  auto pg_res = katana::PropertyGraph::Make(std::move(topo));
+  KATANA_LOG_ASSERT(pg_res);
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_res.value());
+  KATANA_LOG_ASSERT(pg->AddNodeProperties(
+      MakeTypeProperties(pg->num_nodes(), {"Even", "Third"})));
+  KATANA_LOG_ASSERT(pg->ConstructEntityTypeIDs());
+  KATANA_LOG_ASSERT(
+      pg->AddNodeProperties(MakeRowProperty(pg->num_nodes(), "row")));
+  KATANA_LOG_ASSERT(
+      pg->AddEdgeProperties(MakeRowProperty(pg->num_edges(), "row")));
+
+  auto relabeled_res = katana::RelabelNodesByDegree(*pg, "old_id");
+  KATANA_LOG_VASSERT(relabeled_res, "{}", relabeled_res.error());
+  const katana::PropertyGraph& relabeled = *relabeled_res.value();
+  const katana::GraphTopology& topo_in = pg->topology();
+  const katana::GraphTopology& topo_out = relabeled.topology();
+  KATANA_LOG_ASSERT(topo_out.num_nodes() == topo_in.num_nodes());
+  KATANA_LOG_ASSERT(topo_out.num_edges() == topo_in.num_edges());
+
+  auto old_id_res = relabeled.GetNodeProperty("old_id");
+  KATANA_LOG_ASSERT(old_id_res);
+  auto old_id_array = katana::CombinedArray(old_id_res.value());
+  KATANA_LOG_ASSERT(old_id_array);
+  auto old_ids =
+      std::static_pointer_cast<arrow::UInt32Array>(old_id_array.value());
+  std::vector<uint32_t> new_ids(topo_in.num_nodes());
+  for (size_t i = 0; i < topo_out.num_nodes(); ++i) {
+    new_ids[old_ids->Value(i)] = i;
+  }
+
+  auto node_rows = Rows(relabeled.GetNodeProperty("row"));
+  auto edge_rows = Rows(relabeled.GetEdgeProperty("row"));
+  for (size_t i = 0; i < topo_out.num_nodes(); ++i) {
+    uint32_t old_id = old_ids->Value(i);
+    KATANA_LOG_ASSERT(node_rows->Value(i) == old_id);
+    KATANA_LOG_ASSERT(relabeled.GetTypeOfNode(i) == pg->GetTypeOfNode(old_id));
+    KATANA_LOG_ASSERT(topo_out.degree(i) == topo_in.degree(old_id));
+    if (i > 0) {
+      KATANA_LOG_ASSERT(topo_out.degree(i - 1) >= topo_out.degree(i));
+    }
+
+    std::vector<std::pair<uint32_t, uint64_t>> expected;
+    for (auto e : topo_in.edges(old_id)) {
+      expected.emplace_back(new_ids[topo_in.edge_dest(e)], e);
+    }
+    std::sort(expected.begin(), expected.end());
+    auto it = expected.begin();
+    for (auto e : topo_out.edges(i)) {
+      KATANA_LOG_ASSERT(topo_out.edge_dest(e) == it->first);
+      KATANA_LOG_ASSERT(edge_rows->Value(e) == it->second);
+      ++it;
+    }
+  }
+}
+
+/// Value e of an edge property gathered into the order of a view must be the
+/// property of edge e of the view
+template <typename Topo>
+void
+CheckInOrder(
+    const Topo& topo, const std::shared_ptr<arrow::Array>& rows,
+    const std::shared_ptr<arrow::Array>& names) {
+  KATANA_LOG_ASSERT(rows->length() == static_cast<int64_t>(topo.num_edges()));
+  auto row_values = std::static_pointer_cast<arrow::UInt64Array>(rows);
+  auto name_values = std::static_pointer_cast<arrow::StringArray>(names);
+  for (auto e : topo.all_edges()) {
+    uint64_t row = topo.edge_property_index(e);
+    KATANA_LOG_ASSERT(row_values->Value(e) == row);
+    KATANA_LOG_ASSERT(name_values->GetString(e) == std::to_string(row));
+  }
+}
+
+void
+TestEdgePropertyInOrder(katana::GraphTopology&& topo) noexcept {
+  auto pg_res = katana::PropertyGraph::Make(std::move(topo));
+  KATANA_LOG_ASSERT(pg_res);
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_res.value());
+  KATANA_LOG_ASSERT(
+      pg->AddEdgeProperties(MakeRowProperty(pg->num_edges(), "row")));
+  // Strings take the general path
+  arrow::StringBuilder builder;
+  for (size_t i = 0; i < pg->num_edges(); ++i) {
+    KATANA_LOG_ASSERT(builder.Append(std::to_string(i)).ok());
+  }
+  std::shared_ptr<arrow::Array> names;
+  KATANA_LOG_ASSERT(builder.Finish(&names).ok());
+  KATANA_LOG_ASSERT(pg->AddEdgeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("name", arrow::utf8())}), {names})));
+
+  auto in_order = [&](const katana::EdgeOrder& order, const std::string& name) {
+    auto res = pg->GetEdgePropertyInOrder(order, name);
+    KATANA_LOG_VASSERT(res, "{}", res.error());
+    return res.value();
+  };
+
+  using SortedView = katana::PropertyGraphViews::EdgesSortedByDestID;
+  using BiDirView = katana::PropertyGraphViews::BiDirectional;
+  using CompactView = katana::PropertyGraphViews::EdgesSortedByDestIDAnyWidth;
+
+  SortedView sorted = pg->BuildView<SortedView>();
+  auto sorted_rows = in_order(sorted.edge_order(), "row");
+  CheckInOrder(sorted, sorted_rows, in_order(sorted.edge_order(), "name"));
+  // Cached
+  KATANA_LOG_ASSERT(in_order(sorted.edge_order(), "row") == sorted_rows);
+
+  BiDirView bidir = pg->BuildView<BiDirView>();
+  CheckInOrder(
+      pg->topology(), in_order(bidir.edge_order(), "row"),
+      in_order(bidir.edge_order(), "name"));
+  auto in_rows = std::static_pointer_cast<arrow::UInt64Array>(
+      in_order(bidir.in_edge_order(), "row"));
+  auto in_names = std::static_pointer_cast<arrow::StringArray>(
+      in_order(bidir.in_edge_order(), "name"));
+  for (auto node : bidir.all_nodes()) {
+    for (auto e : bidir.in_edges(node)) {
+      uint64_t row = bidir.in_edge_property_index(e);
+      KATANA_LOG_ASSERT(in_rows->Value(e) == row);
+      KATANA_LOG_ASSERT(in_names->GetString(e) == std::to_string(row));
+    }
+  }
+
+  CompactView compact = pg->BuildView<CompactView>();
+  KATANA_LOG_ASSERT(compact.is_compact());
+  auto compact_rows = in_order(compact.edge_order(), "row");
+  auto compact_names = in_order(compact.edge_order(), "name");
+  compact.Visit([&](const auto& topo) {
+    CheckInOrder(topo, compact_rows, compact_names);
+  });
+
+  // Gathered properties that no one holds are dropped to fit the budget
+  sorted_rows.reset();
+  pg->SetViewCacheByteBudget(1);
+  CheckInOrder(
+      sorted, in_order(sorted.edge_order(), "row"),
+      in_order(sorted.edge_order(), "name"));
+
+  KATANA_LOG_ASSERT(!pg->GetEdgePropertyInOrder(sorted.edge_order(), "none"));
+}
+
+/// Each node's neighbors in an undirected view are those joined to it by an
+/// edge in either direction, sorted, with the smallest ID among those edges
+void
+TestUndirected(katana::GraphTopology&& topo) noexcept {
+  auto pg_res = katana::PropertyGraph::Make(std::move(topo));
+  KATANA_LOG_ASSERT(pg_res);
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_res.value());
+  KATANA_LOG_ASSERT(
+      pg->AddEdgeProperties(MakeRowProperty(pg->num_edges(), "row")));
+
+  const katana::GraphTopology& original = pg->topology();
+  std::vector<std::map<uint32_t, uint64_t>> expected(original.num_nodes());
+  for (auto src : original.all_nodes()) {
+    for (auto e : original.edges(src)) {
+      auto dst = original.edge_dest(e);
+      if (src == dst) {
+        continue;
+      }
+      for (auto [n, neighbor] : {std::pair{src, dst}, std::pair{dst, src}}) {
+        auto [it, inserted] = expected[n].emplace(neighbor, e);
+        if (!inserted) {
+          it->second = std::min<uint64_t>(it->second, e);
+        }
+      }
+    }
+  }
+
+  using View = katana::PropertyGraphViews::Undirected;
+  View view = pg->BuildView<View>();
+  KATANA_LOG_ASSERT(view.num_nodes() == original.num_nodes());
+  for (auto n : view.all_nodes()) {
+    std::vector<std::pair<uint32_t, uint64_t>> found;
+    for (auto e : view.edges(n)) {
+      found.emplace_back(view.edge_dest(e), view.edge_property_index(e));
+      KATANA_LOG_ASSERT(view.has_edge(view.edge_dest(e), n));
+    }
+    KATANA_LOG_ASSERT(std::equal(
+        found.begin(), found.end(), expected[n].begin(), expected[n].end(),
+        [](const auto& a, const auto& b) {
+          return a.first == b.first && a.second == b.second;
+        }));
+  }
+
+  auto rows = pg->GetEdgePropertyInOrder(view.edge_order(), "row");
+  KATANA_LOG_VASSERT(rows, "{}", rows.error());
+  auto row_values = std::static_pointer_cast<arrow::UInt64Array>(rows.value());
+  KATANA_LOG_ASSERT(
+      row_values->length() == static_cast<int64_t>(view.num_edges()));
+  for (auto e : view.all_edges()) {
+    KATANA_LOG_ASSERT(row_values->Value(e) == view.edge_property_index(e));
+  }
+}
+
 int
 main() {
   katana::SharedMemSys S;
@@ -24,5 +729,51 @@ main() {
 
   TestEdgeSource(topo);
 
+  TestEdgeBalancedPartition(topo);
+
+  TestBorrowed(topo);
+
+  TestViewCacheBudget(
+      katana::CreateUniformRandomTopology(kNumNodes, kEdgesPerNode));
+
+  TestViewCacheThreads(
+      katana::CreateUniformRandomTopology(kNumNodes, kEdgesPerNode));
+
+  TestSortedByDegree(
+      katana::CreateUniformRandomTopology(kNumNodes, kEdgesPerNode));
+
+  TestTypePartition(
+      katana::CreateUniformRandomTopology(kNumNodes, kEdgesPerNode));
+
+  TestDestTypeAware(
+      katana::CreateUniformRandomTopology(kNumNodes, kEdgesPerNode));
+
+  TestPermuteNodes(
+      katana::CreateUniformRandomTopology(kNumNodes, kEdgesPerNode));
+
+  TestRelabelNodesByDegree(
+      katana::CreateUniformRandomTopology(kNumNodes, kEdgesPerNode));
+
+  TestEdgePropertyInOrder(
+      katana::CreateUniformRandomTopology(kNumNodes, kEdgesPerNode));
+
+  TestUndirected(
+      katana::CreateUniformRandomTopology(kNumNodes, kEdgesPerNode));
+
+  auto pg_res = katana::PropertyGraph::Make(
+      katana::CreateUniformRandomTopology(kNumNodes, kEdgesPerNode));
+  KATANA_LOG_ASSERT(pg_res);
+  katana::PropertyGraph* pg = pg_res.value().get();
+  TestReordered<katana::PropertyGraphViews::ReverseCuthillMcKee>(pg);
+  TestReordered<katana::PropertyGraphViews::BFSOrder>(pg);
+  TestReordered<katana::PropertyGraphViews::Gorder>(pg);
+  TestReordered<katana::PropertyGraphViews::HubClustered>(pg);
+
+  TestCompactTopology(pg);
+
+  TestHubIndex(pg, UINT64_MAX);
+  // Only some hubs fit
+  TestHubIndex(pg, 4096);
+
   return 0;
 }
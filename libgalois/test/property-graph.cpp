@@ -1,3 +1,6 @@
+#include <thread>
+#include <vector>
+
 #include <arrow/api.h>
 #include <arrow/type.h>
 #include <arrow/type_traits.h>
@@ -126,6 +129,137 @@ TestError1(size_t num_nodes, size_t line_width) {
       "Should return PropertyNotFound when node property doesn't exist.");
 }
 
+/// Test that Copy shares state with the graph until either one changes
+void
+TestCopy(size_t num_nodes, size_t line_width) {
+  LinePolicy policy{line_width};
+
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<DataType>(num_nodes, 2, &policy);
+
+  auto copy_res = g->Copy({"0"}, {"0", "1"});
+  KATANA_LOG_VASSERT(copy_res, "{}", copy_res.error());
+  std::unique_ptr<katana::PropertyGraph> copy = std::move(copy_res.value());
+
+  KATANA_LOG_ASSERT(g->topology().shareable());
+  KATANA_LOG_ASSERT(copy->topology().adj_data() == g->topology().adj_data());
+  KATANA_LOG_ASSERT(copy->topology().dest_data() == g->topology().dest_data());
+  KATANA_LOG_ASSERT(copy->node_type_data() == g->node_type_data());
+  KATANA_LOG_ASSERT(copy->edge_type_data() == g->edge_type_data());
+  KATANA_LOG_ASSERT(copy->GetNumNodeProperties() == 1);
+  KATANA_LOG_ASSERT(copy->GetNumEdgeProperties() == 2);
+  KATANA_LOG_ASSERT(
+      copy->GetNodeProperty(0)->chunk(0)->data()->buffers[1] ==
+      g->GetNodeProperty(0)->chunk(0)->data()->buffers[1]);
+
+  // Changing the copy leaves the graph alone
+  arrow::Int64Builder builder;
+  for (size_t i = 0; i < copy->num_nodes(); ++i) {
+    KATANA_LOG_ASSERT(builder.Append(-1).ok());
+  }
+  std::shared_ptr<arrow::Array> values;
+  KATANA_LOG_ASSERT(builder.Finish(&values).ok());
+  KATANA_LOG_ASSERT(copy->UpsertNodeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("0", arrow::int64())}), {values})));
+  KATANA_LOG_ASSERT(copy->AddNodeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("scratch", arrow::int64())}), {values})));
+  KATANA_LOG_ASSERT(!g->HasNodeProperty("scratch"));
+  auto original = std::static_pointer_cast<arrow::Int64Array>(
+      g->GetNodeProperty(0)->chunk(0));
+  for (int64_t i = 0; i < original->length(); ++i) {
+    KATANA_LOG_ASSERT(original->Value(i) != -1);
+  }
+
+  // The copy outlives the graph
+  size_t num_edges = g->num_edges();
+  g.reset();
+  KATANA_LOG_ASSERT(copy->num_edges() == num_edges);
+  size_t degrees = 0;
+  for (auto n : copy->topology().all_nodes()) {
+    degrees += copy->topology().edges(n).size();
+    KATANA_LOG_ASSERT(copy->GetTypeOfNode(n) == katana::kUnknownEntityType);
+  }
+  KATANA_LOG_ASSERT(degrees == num_edges);
+}
+
+/// Test that a snapshot keeps its version while writers change the graph
+void
+TestSnapshot(size_t num_nodes, size_t line_width) {
+  LinePolicy policy{line_width};
+
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<DataType>(num_nodes, 1, &policy);
+
+  auto snapshot = g->Snapshot();
+  KATANA_LOG_ASSERT(g->Snapshot() == snapshot);
+  KATANA_LOG_ASSERT(snapshot->num_edges() == g->num_edges());
+  KATANA_LOG_ASSERT(
+      snapshot->topology().adj_data() == g->topology().adj_data());
+  auto pinned_res = snapshot->GetNodeProperty("0");
+  KATANA_LOG_ASSERT(pinned_res);
+  auto pinned = std::static_pointer_cast<arrow::Int64Array>(
+      pinned_res.value()->chunk(0));
+  std::vector<int64_t> expected(
+      pinned->raw_values(), pinned->raw_values() + pinned->length());
+
+  auto make_table = [&](const std::string& name, int64_t value) {
+    arrow::Int64Builder builder;
+    for (size_t i = 0; i < g->num_nodes(); ++i) {
+      KATANA_LOG_ASSERT(builder.Append(value).ok());
+    }
+    std::shared_ptr<arrow::Array> values;
+    KATANA_LOG_ASSERT(builder.Finish(&values).ok());
+    return arrow::Table::Make(
+        arrow::schema({arrow::field(name, arrow::int64())}), {values});
+  };
+
+  // Readers take snapshots while a writer changes the graph; each snapshot
+  // sees either all or none of a change
+  constexpr int kRounds = 50;
+  KATANA_LOG_ASSERT(g->UpsertNodeProperties(make_table("0", -1)));
+  std::thread reader([&]() {
+    for (int i = 0; i < 4 * kRounds; ++i) {
+      auto current = g->Snapshot();
+      auto values = current->GetNodeProperty("0");
+      KATANA_LOG_ASSERT(values);
+      auto column = values.value()->chunk(0);
+      auto first = std::static_pointer_cast<arrow::Int64Array>(column);
+      for (int64_t j = 1; j < first->length(); ++j) {
+        KATANA_LOG_ASSERT(first->Value(j) == first->Value(0));
+      }
+      KATANA_LOG_ASSERT(current->version() >= snapshot->version());
+    }
+  });
+  for (int i = 0; i < kRounds; ++i) {
+    KATANA_LOG_ASSERT(g->UpsertNodeProperties(make_table("0", i)));
+  }
+  reader.join();
+
+  KATANA_LOG_ASSERT(g->AddNodeProperties(make_table("added", 1)));
+  KATANA_LOG_ASSERT(g->RemoveNodeProperty("added"));
+  auto latest = g->Snapshot();
+  KATANA_LOG_ASSERT(latest != snapshot);
+  KATANA_LOG_ASSERT(latest->version() > snapshot->version());
+  KATANA_LOG_ASSERT(!latest->GetNodeProperty("added"));
+
+  // A change that fails leaves the graph, and so its version, alone
+  KATANA_LOG_ASSERT(!g->AddNodeProperties(make_table("0", 2)));
+  KATANA_LOG_ASSERT(g->Snapshot() == latest);
+
+  // The pinned version is unchanged and outlives the graph
+  KATANA_LOG_ASSERT(snapshot->node_properties()->num_columns() == 1);
+  g.reset();
+  latest.reset();
+  for (int64_t i = 0; i < pinned->length(); ++i) {
+    KATANA_LOG_ASSERT(pinned->Value(i) == expected[i]);
+  }
+  size_t degrees = 0;
+  for (auto n : snapshot->topology().all_nodes()) {
+    degrees += snapshot->topology().degree(n);
+  }
+  KATANA_LOG_ASSERT(degrees == snapshot->num_edges());
+}
+
 int
 main() {
   katana::SharedMemSys S;
@@ -134,6 +268,8 @@ main() {
   TestIterate3(10, 3);
   TestIterate4(10, 3);
   TestError1(10, 3);
+  TestCopy(10, 3);
+  TestSnapshot(10, 3);
 
   return 0;
 }
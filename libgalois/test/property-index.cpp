@@ -1,16 +1,21 @@
 #include <arrow/api.h>
 #include <arrow/type.h>
 #include <arrow/type_traits.h>
+#include <boost/filesystem.hpp>
 
 #include "TestTypedPropertyGraph.h"
 #include "katana/Logging.h"
 #include "katana/Properties.h"
 #include "katana/PropertyIndex.h"
+#include "katana/URI.h"
+
+namespace fs = boost::filesystem;
 
 template <typename node_or_edge>
 struct NodeOrEdge {
   static katana::Result<katana::PropertyIndex<node_or_edge>*> MakeIndex(
-      katana::PropertyGraph* pg, const std::string& column_name);
+      katana::PropertyGraph* pg, const std::string& column_name,
+      katana::PropertyIndexKind kind = katana::PropertyIndexKind::kOrdered);
   static katana::Result<void> AddProperties(
       katana::PropertyGraph* pg, std::shared_ptr<arrow::Table> properties);
   static size_t num_entities(katana::PropertyGraph* pg);
@@ -21,8 +26,10 @@ using Edge = NodeOrEdge<katana::GraphTopology::Edge>;
 
 template <>
 katana::Result<katana::PropertyIndex<katana::GraphTopology::Node>*>
-Node::MakeIndex(katana::PropertyGraph* pg, const std::string& column_name) {
-  auto result = pg->MakeNodeIndex(column_name);
+Node::MakeIndex(
+    katana::PropertyGraph* pg, const std::string& column_name,
+    katana::PropertyIndexKind kind) {
+  auto result = pg->MakeNodeIndex(column_name, kind);
   if (!result) {
     return result.error();
   }
@@ -38,8 +45,10 @@ Node::MakeIndex(katana::PropertyGraph* pg, const std::string& column_name) {
 
 template <>
 katana::Result<katana::PropertyIndex<katana::GraphTopology::Edge>*>
-Edge::MakeIndex(katana::PropertyGraph* pg, const std::string& column_name) {
-  auto result = pg->MakeEdgeIndex(column_name);
+Edge::MakeIndex(
+    katana::PropertyGraph* pg, const std::string& column_name,
+    katana::PropertyIndexKind kind) {
+  auto result = pg->MakeEdgeIndex(column_name, kind);
   if (!result) {
     return result.error();
   }
@@ -197,6 +206,16 @@ TestPrimitiveIndex(size_t num_nodes, size_t line_width) {
   it = nonuniform_index->UpperBound(44);
   KATANA_LOG_ASSERT(it != nonuniform_index->end());
   KATANA_LOG_ASSERT(typed_prop->Value(*it) == 46);
+
+  // Every entity is indexed, in order of value.
+  KATANA_LOG_ASSERT(nonuniform_index->size() == num_entities);
+  for (it = nonuniform_index->begin(); it + 1 < nonuniform_index->end(); ++it) {
+    KATANA_LOG_ASSERT(typed_prop->Value(*it) < typed_prop->Value(*(it + 1)));
+  }
+  it = nonuniform_index->UpperBound(typed_prop->Value(num_entities - 1));
+  KATANA_LOG_ASSERT(it == nonuniform_index->end());
+  it = nonuniform_index->LowerBound(0);
+  KATANA_LOG_ASSERT(it == nonuniform_index->begin());
 }
 
 template <typename node_or_edge>
@@ -265,6 +284,177 @@ TestStringIndex(size_t num_nodes, size_t line_width) {
   KATANA_LOG_ASSERT(typed_prop->GetView(*it) == "aaam");
 }
 
+template <typename node_or_edge, typename c_type, typename ArrayType>
+void
+CheckHashIndex(
+    const katana::HashPropertyIndex<node_or_edge, c_type>& index,
+    const ArrayType& property, size_t num_entities, size_t num_distinct) {
+  KATANA_LOG_ASSERT(index.kind() == katana::PropertyIndexKind::kHash);
+  KATANA_LOG_ASSERT(index.size() == num_entities);
+  KATANA_LOG_ASSERT(index.num_distinct_values() == num_distinct);
+
+  // Every entity is in the range of its own value, exactly once.
+  std::vector<bool> found(num_entities, false);
+  size_t num_found = 0;
+  for (node_or_edge id = 0; id < num_entities; ++id) {
+    if (found[id]) {
+      continue;
+    }
+    auto [first, last] = index.EqualRange(property.GetView(id));
+    KATANA_LOG_ASSERT(first != last);
+    KATANA_LOG_ASSERT(index.Find(property.GetView(id)) == first);
+    for (auto it = first; it != last; ++it) {
+      KATANA_LOG_VASSERT(*it < num_entities, "Invalid id: {}", *it);
+      KATANA_LOG_VASSERT(!found[*it], "Duplicate id: {}", *it);
+      KATANA_LOG_ASSERT(property.GetView(*it) == property.GetView(id));
+      found[*it] = true;
+      ++num_found;
+    }
+  }
+  KATANA_LOG_ASSERT(num_found == num_entities);
+}
+
+template <typename node_or_edge>
+void
+TestHashIndex(size_t num_nodes, size_t line_width) {
+  using IntIndexType = katana::HashPropertyIndex<node_or_edge, int64_t>;
+  using StringIndexType =
+      katana::HashPropertyIndex<node_or_edge, std::string_view>;
+
+  LinePolicy policy{line_width};
+
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<int64_t>(num_nodes, 0, &policy);
+  size_t num_entities = NodeOrEdge<node_or_edge>::num_entities(g.get());
+
+  KATANA_LOG_ASSERT(NodeOrEdge<node_or_edge>::AddProperties(
+      g.get(),
+      CreatePrimitiveProperty<int64_t>("uniform", true, num_entities)));
+  KATANA_LOG_ASSERT(NodeOrEdge<node_or_edge>::AddProperties(
+      g.get(),
+      CreatePrimitiveProperty<int64_t>("nonuniform", false, num_entities)));
+  std::shared_ptr<arrow::Table> string_prop =
+      CreateStringProperty("string", false, num_entities);
+  KATANA_LOG_ASSERT(
+      NodeOrEdge<node_or_edge>::AddProperties(g.get(), string_prop));
+
+  auto make_index = [&](const std::string& name) {
+    auto result = NodeOrEdge<node_or_edge>::MakeIndex(
+        g.get(), name, katana::PropertyIndexKind::kHash);
+    KATANA_LOG_VASSERT(result, "Could not create index: {}", result.error());
+    return result.value();
+  };
+  auto* uniform_index = static_cast<IntIndexType*>(make_index("uniform"));
+  auto* nonuniform_index =
+      static_cast<IntIndexType*>(make_index("nonuniform"));
+  auto* string_index = static_cast<StringIndexType*>(make_index("string"));
+
+  // The uniform index has every value == 42 in one range.
+  KATANA_LOG_ASSERT(uniform_index->Find(0) == uniform_index->end());
+  auto [first, last] = uniform_index->EqualRange(42);
+  KATANA_LOG_ASSERT(first == uniform_index->begin());
+  KATANA_LOG_ASSERT(last == uniform_index->end());
+  KATANA_LOG_ASSERT(uniform_index->num_distinct_values() == 1);
+
+  // The non-uniform index starts at 42 and increases by 2.
+  KATANA_LOG_ASSERT(nonuniform_index->Find(43) == nonuniform_index->end());
+  auto it = nonuniform_index->Find(44);
+  KATANA_LOG_ASSERT(it != nonuniform_index->end());
+  KATANA_LOG_ASSERT(*it == 1);
+  KATANA_LOG_ASSERT(nonuniform_index->num_distinct_values() == num_entities);
+  for (node_or_edge id = 0; id < num_entities; ++id) {
+    auto [id_first, id_last] = nonuniform_index->EqualRange(id * 2 + 42);
+    KATANA_LOG_ASSERT(id_last - id_first == 1);
+    KATANA_LOG_ASSERT(*id_first == id);
+  }
+
+  // The strings start at "aaaa" and increase by 2, so they are distinct.
+  KATANA_LOG_ASSERT(string_index->Find("aaab") == string_index->end());
+  auto string_prop_array = std::static_pointer_cast<arrow::LargeStringArray>(
+      string_prop->column(0)->chunk(0));
+  CheckHashIndex(
+      *string_index, *string_prop_array, num_entities, num_entities);
+}
+
+void
+TestStoredIndex(size_t num_nodes, size_t line_width) {
+  using NodeID = katana::GraphTopology::Node;
+  using OrderedIndexType = katana::PrimitivePropertyIndex<NodeID, int64_t>;
+  using HashIndexType = katana::HashPropertyIndex<NodeID, std::string_view>;
+
+  LinePolicy policy{line_width};
+
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<int64_t>(num_nodes, 0, &policy);
+  KATANA_LOG_ASSERT(g->AddNodeProperties(
+      CreatePrimitiveProperty<int64_t>("ordered", false, num_nodes)));
+  KATANA_LOG_ASSERT(
+      g->AddNodeProperties(CreateStringProperty("hashed", false, num_nodes)));
+  KATANA_LOG_ASSERT(g->MakeNodeIndex("ordered"));
+  KATANA_LOG_ASSERT(
+      g->MakeNodeIndex("hashed", katana::PropertyIndexKind::kHash));
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyindex");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  auto write_result = g->Write(rdg_dir, "property-index");
+  if (!write_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  auto make_result =
+      katana::PropertyGraph::Make(rdg_dir, tsuba::RDGLoadOptions());
+  if (!make_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> g2 = std::move(make_result.value());
+
+  // The stored indexes are mapped instead of rebuilt.
+  auto ordered_result = Node::MakeIndex(g2.get(), "ordered");
+  auto hashed_result =
+      Node::MakeIndex(g2.get(), "hashed", katana::PropertyIndexKind::kHash);
+  fs::remove_all(rdg_dir);
+  KATANA_LOG_VASSERT(
+      ordered_result, "Could not create index: {}", ordered_result.error());
+  KATANA_LOG_VASSERT(
+      hashed_result, "Could not create index: {}", hashed_result.error());
+
+  auto* ordered_index = static_cast<OrderedIndexType*>(ordered_result.value());
+  KATANA_LOG_ASSERT(ordered_index->is_mapped());
+  KATANA_LOG_ASSERT(ordered_index->size() == num_nodes);
+  auto it = ordered_index->Find(44);
+  KATANA_LOG_ASSERT(it != ordered_index->end() && *it == 1);
+  KATANA_LOG_ASSERT(ordered_index->Find(43) == ordered_index->end());
+
+  auto* hashed_index = static_cast<HashIndexType*>(hashed_result.value());
+  KATANA_LOG_ASSERT(hashed_index->is_mapped());
+  auto hashed_prop = g2->GetNodeProperty("hashed");
+  KATANA_LOG_ASSERT(hashed_prop);
+  CheckHashIndex(
+      *hashed_index,
+      *std::static_pointer_cast<arrow::LargeStringArray>(
+          hashed_prop.value()->chunk(0)),
+      num_nodes, num_nodes);
+
+  // Upserting a property rebuilds its index over the new values.
+  KATANA_LOG_ASSERT(g2->UpsertNodeProperties(
+      CreatePrimitiveProperty<int64_t>("ordered", true, num_nodes)));
+  auto upserted_result = g2->GetNodePropertyIndex("ordered");
+  KATANA_LOG_ASSERT(upserted_result);
+  auto* upserted_index =
+      static_cast<OrderedIndexType*>(upserted_result.value());
+  KATANA_LOG_ASSERT(!upserted_index->is_mapped());
+  KATANA_LOG_ASSERT(upserted_index->Find(42) == upserted_index->begin());
+  KATANA_LOG_ASSERT(upserted_index->Find(44) == upserted_index->end());
+
+  // Removing a property drops its index.
+  KATANA_LOG_ASSERT(g2->RemoveNodeProperty("hashed"));
+  KATANA_LOG_ASSERT(!g2->HasNodePropertyIndex("hashed"));
+}
+
 int
 main() {
   katana::SharedMemSys S;
@@ -273,9 +463,19 @@ main() {
   TestPrimitiveIndex<katana::GraphTopology::Edge, int64_t>(10, 3);
   TestPrimitiveIndex<katana::GraphTopology::Node, double_t>(10, 3);
   TestPrimitiveIndex<katana::GraphTopology::Edge, double_t>(10, 3);
+  // Enough entities for several levels of search blocks
+  TestPrimitiveIndex<katana::GraphTopology::Node, int64_t>(1000, 3);
+  TestPrimitiveIndex<katana::GraphTopology::Edge, double_t>(1000, 3);
 
   TestStringIndex<katana::GraphTopology::Node>(10, 3);
   TestStringIndex<katana::GraphTopology::Edge>(10, 3);
 
+  TestHashIndex<katana::GraphTopology::Node>(10, 3);
+  TestHashIndex<katana::GraphTopology::Edge>(10, 3);
+  // Enough values for several buckets
+  TestHashIndex<katana::GraphTopology::Node>(1000, 3);
+
+  TestStoredIndex(1000, 3);
+
   return 0;
 }
@@ -0,0 +1,158 @@
+#include <optional>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+constexpr size_t kNumNodes = 1000;
+
+/// Make a table with a single double column named rank, with element i equal
+/// to i * scale, split into chunks of the given sizes
+std::shared_ptr<arrow::Table>
+MakeRanks(
+    double scale, const std::vector<size_t>& chunk_sizes = {kNumNodes},
+    std::optional<size_t> null_index = std::nullopt) {
+  std::vector<std::shared_ptr<arrow::Array>> chunks;
+  size_t i = 0;
+  for (size_t chunk_size : chunk_sizes) {
+    arrow::DoubleBuilder builder;
+    for (size_t end = i + chunk_size; i < end; ++i) {
+      KATANA_LOG_ASSERT(
+          (i == null_index ? builder.AppendNull() : builder.Append(i * scale))
+              .ok());
+    }
+    std::shared_ptr<arrow::Array> chunk;
+    KATANA_LOG_ASSERT(builder.Finish(&chunk).ok());
+    chunks.emplace_back(chunk);
+  }
+  return arrow::Table::Make(
+      arrow::schema({arrow::field("rank", arrow::float64())}),
+      {std::make_shared<arrow::ChunkedArray>(chunks, arrow::float64())});
+}
+
+/// The address of the values of the rank property
+const uint8_t*
+RankValues(const katana::PropertyGraph& g) {
+  auto rank = g.GetNodeProperty("rank");
+  KATANA_LOG_ASSERT(rank && rank.value()->num_chunks() == 1);
+  return rank.value()->chunk(0)->data()->buffers[1]->data();
+}
+
+void
+CheckRanks(const arrow::ChunkedArray& ranks, double scale) {
+  KATANA_LOG_ASSERT(ranks.null_count() == 0);
+  int64_t i = 0;
+  for (const auto& chunk : ranks.chunks()) {
+    const auto& values = static_cast<const arrow::DoubleArray&>(*chunk);
+    for (int64_t j = 0; j < values.length(); ++j, ++i) {
+      KATANA_LOG_VASSERT(
+          values.Value(j) == i * scale, "rank {} is {}, expected {}", i,
+          values.Value(j), i * scale);
+    }
+  }
+  KATANA_LOG_ASSERT(i == ranks.length());
+}
+
+void
+CheckRanks(const katana::PropertyGraph& g, double scale) {
+  auto rank = g.GetNodeProperty("rank");
+  KATANA_LOG_ASSERT(rank);
+  CheckRanks(*rank.value(), scale);
+}
+
+void
+TestUpsertInPlace() {
+  LinePolicy policy{2};
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<uint32_t>(kNumNodes, 0, &policy);
+  KATANA_LOG_ASSERT(g->AddNodeProperties(MakeRanks(1, {kNumNodes}, 7)));
+
+  // The existing column is rewritten, including its nulls, whatever the
+  // chunking of the new values
+  const uint8_t* values = RankValues(*g);
+  KATANA_LOG_ASSERT(g->UpsertNodeProperties(MakeRanks(2)));
+  KATANA_LOG_ASSERT(RankValues(*g) == values);
+  CheckRanks(*g, 2);
+  KATANA_LOG_ASSERT(g->UpsertNodeProperties(MakeRanks(3, {10, 0, 990})));
+  KATANA_LOG_ASSERT(RankValues(*g) == values);
+  CheckRanks(*g, 3);
+
+  // A reader holding the column keeps its values
+  std::shared_ptr<arrow::ChunkedArray> held =
+      g->GetNodeProperty("rank").value();
+  KATANA_LOG_ASSERT(g->UpsertNodeProperties(MakeRanks(4)));
+  KATANA_LOG_ASSERT(RankValues(*g) != values);
+  CheckRanks(*held, 3);
+  CheckRanks(*g, 4);
+  held.reset();
+
+  // New values with nulls replace the column
+  values = RankValues(*g);
+  KATANA_LOG_ASSERT(g->UpsertNodeProperties(MakeRanks(5, {kNumNodes}, 3)));
+  KATANA_LOG_ASSERT(RankValues(*g) != values);
+  KATANA_LOG_ASSERT(g->GetNodeProperty("rank").value()->null_count() == 1);
+
+  // As do values of another type
+  auto ints = arrow::Table::Make(
+      arrow::schema({arrow::field("rank", arrow::int64())}),
+      {std::make_shared<arrow::ChunkedArray>(
+          arrow::MakeArrayFromScalar(arrow::Int64Scalar(1), kNumNodes)
+              .ValueOrDie())});
+  KATANA_LOG_ASSERT(g->UpsertNodeProperties(ints));
+  KATANA_LOG_ASSERT(
+      g->GetNodeProperty("rank").value()->type()->Equals(arrow::int64()));
+}
+
+/// A snapshot holds the columns only while it is held: the graph does not
+/// keep its last snapshot alive, so upserts after it is dropped stay in place
+void
+TestUpsertAfterSnapshot() {
+  LinePolicy policy{2};
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<uint32_t>(kNumNodes, 0, &policy);
+  KATANA_LOG_ASSERT(g->AddNodeProperties(MakeRanks(1)));
+
+  // While a snapshot is held, upserts copy the column and the snapshot keeps
+  // its values
+  const uint8_t* values = RankValues(*g);
+  std::shared_ptr<const katana::PropertyGraphSnapshot> snapshot =
+      g->Snapshot();
+  KATANA_LOG_ASSERT(g->UpsertNodeProperties(MakeRanks(2)));
+  KATANA_LOG_ASSERT(RankValues(*g) != values);
+  auto held = snapshot->GetNodeProperty("rank");
+  KATANA_LOG_ASSERT(held);
+  CheckRanks(*held.value(), 1);
+  CheckRanks(*g, 2);
+  held.value().reset();
+  snapshot.reset();
+
+  // Once it is dropped, they are in place again
+  values = RankValues(*g);
+  KATANA_LOG_ASSERT(g->UpsertNodeProperties(MakeRanks(3)));
+  KATANA_LOG_ASSERT(RankValues(*g) == values);
+  CheckRanks(*g, 3);
+
+  // Even when no change was made after the snapshot was taken
+  g->Snapshot().reset();
+  KATANA_LOG_ASSERT(g->UpsertNodeProperties(MakeRanks(4)));
+  KATANA_LOG_ASSERT(RankValues(*g) == values);
+  CheckRanks(*g, 4);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestUpsertInPlace();
+  TestUpsertAfterSnapshot();
+
+  return 0;
+}
@@ -0,0 +1,331 @@
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/random_walks/random_walks.h"
+
+namespace {
+
+using Walk = std::vector<uint32_t>;
+
+constexpr uint32_t kNumNodes = 300;
+
+/// A symmetric graph of a path through all nodes and random edges
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph() {
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<uint32_t> node(0, kNumNodes - 1);
+  std::vector<std::vector<uint32_t>> adjacency(kNumNodes);
+  uint64_t num_edges = 0;
+  auto add_edge = [&](uint32_t src, uint32_t dest) {
+    adjacency[src].emplace_back(dest);
+    adjacency[dest].emplace_back(src);
+    num_edges += 2;
+  };
+  for (uint32_t n = 0; n + 1 < kNumNodes; ++n) {
+    add_edge(n, n + 1);
+  }
+  for (uint32_t i = 0; i < 2 * kNumNodes; ++i) {
+    add_edge(node(gen), node(gen));
+  }
+
+  katana::GraphTopology::AdjIndexVec adj_indices;
+  adj_indices.allocateInterleaved(kNumNodes);
+  katana::GraphTopology::EdgeDestVec dests;
+  dests.allocateInterleaved(num_edges);
+  uint64_t end = 0;
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    for (uint32_t dest : adjacency[n]) {
+      dests[end++] = dest;
+    }
+    adj_indices[n] = end;
+  }
+  auto res = katana::PropertyGraph::Make(
+      katana::GraphTopology(std::move(adj_indices), std::move(dests)));
+  KATANA_LOG_VASSERT(res, "making graph: {}", res.error());
+  return std::move(res.value());
+}
+
+bool
+HasEdge(const katana::PropertyGraph& pg, uint32_t src, uint32_t dest) {
+  for (auto e : pg.topology().edges(src)) {
+    if (pg.topology().edge_dest(e) == dest) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/// Check the layout of num_walks flat walks and append them, without their
+/// padding, to out
+void
+AppendWalks(
+    const katana::PropertyGraph& pg, uint32_t stride, const uint32_t* walks,
+    uint64_t num_walks, std::vector<Walk>* out) {
+  for (uint64_t w = 0; w < num_walks; ++w) {
+    const uint32_t* walk = walks + w * stride;
+    const uint32_t* walk_end =
+        std::find(walk, walk + stride, katana::analytics::kRandomWalkPadding);
+    KATANA_LOG_ASSERT(walk_end - walk >= 2);
+    KATANA_LOG_ASSERT(std::all_of(walk_end, walk + stride, [](uint32_t id) {
+      return id == katana::analytics::kRandomWalkPadding;
+    }));
+    for (const uint32_t* it = walk + 1; it != walk_end; ++it) {
+      KATANA_LOG_VASSERT(
+          HasEdge(pg, *(it - 1), *it), "step from {} to {} is not an edge",
+          *(it - 1), *it);
+    }
+    out->emplace_back(walk, walk_end);
+  }
+}
+
+/// The flat buffer, the sink in small chunks, the record batch sink and the
+/// vector of vectors all produce the same walks
+void
+TestOutputs(katana::PropertyGraph* pg) {
+  auto plan = katana::analytics::RandomWalksPlan::Node2Vec(6, 3, 0.5, 2.0);
+  uint32_t stride = plan.walk_stride();
+  uint64_t max_walks = katana::analytics::RandomWalksMaxWalks(*pg, plan);
+  KATANA_LOG_ASSERT(max_walks == kNumNodes * plan.number_of_walks());
+
+  std::vector<uint32_t> buffer(max_walks * stride);
+  auto too_small = katana::analytics::RandomWalks(
+      pg, buffer.data(), max_walks - 1, plan);
+  KATANA_LOG_ASSERT(
+      !too_small && too_small.error() == katana::ErrorCode::InvalidArgument);
+  auto num_res =
+      katana::analytics::RandomWalks(pg, buffer.data(), max_walks, plan);
+  KATANA_LOG_VASSERT(num_res, "{}", num_res.error());
+  // Every node has an edge, so no walk is dropped
+  KATANA_LOG_ASSERT(num_res.value() == max_walks);
+  std::vector<Walk> flat;
+  AppendWalks(*pg, stride, buffer.data(), num_res.value(), &flat);
+  std::sort(flat.begin(), flat.end());
+
+  constexpr uint64_t kChunkSize = 7;
+  std::mutex mutex;
+  std::vector<Walk> streamed;
+  auto stream_res = katana::analytics::RandomWalks(
+      pg,
+      [&](const uint32_t* walks, uint64_t num_walks) -> katana::Result<void> {
+        std::lock_guard<std::mutex> lock(mutex);
+        KATANA_LOG_ASSERT(num_walks > 0 && num_walks <= kChunkSize);
+        AppendWalks(*pg, stride, walks, num_walks, &streamed);
+        return katana::ResultSuccess();
+      },
+      kChunkSize, plan);
+  KATANA_LOG_VASSERT(stream_res, "{}", stream_res.error());
+  std::sort(streamed.begin(), streamed.end());
+  KATANA_LOG_ASSERT(streamed == flat);
+
+  std::vector<Walk> batched;
+  auto batch_res = katana::analytics::RandomWalks(
+      pg,
+      katana::analytics::MakeRandomWalksRecordBatchSink(
+          stride,
+          [&](const std::shared_ptr<arrow::RecordBatch>& batch)
+              -> katana::Result<void> {
+            KATANA_LOG_ASSERT(batch->num_columns() == 1);
+            KATANA_LOG_ASSERT(batch->schema()->field(0)->name() == "walk");
+            auto list = std::static_pointer_cast<arrow::FixedSizeListArray>(
+                batch->column(0));
+            KATANA_LOG_ASSERT(list->value_length() == int32_t(stride));
+            auto values =
+                std::static_pointer_cast<arrow::UInt32Array>(list->values());
+            KATANA_LOG_ASSERT(
+                values->length() == batch->num_rows() * int64_t(stride));
+            AppendWalks(
+                *pg, stride, values->raw_values(), batch->num_rows(),
+                &batched);
+            return katana::ResultSuccess();
+          }),
+      kChunkSize, plan);
+  KATANA_LOG_VASSERT(batch_res, "{}", batch_res.error());
+  std::sort(batched.begin(), batched.end());
+  KATANA_LOG_ASSERT(batched == flat);
+
+  auto vector_res = katana::analytics::RandomWalks(pg, plan);
+  KATANA_LOG_VASSERT(vector_res, "{}", vector_res.error());
+  std::vector<Walk> vectors = std::move(vector_res.value());
+  std::sort(vectors.begin(), vectors.end());
+  KATANA_LOG_ASSERT(vectors == flat);
+}
+
+/// An error from the sink stops the walks and is returned
+void
+TestSinkError(katana::PropertyGraph* pg) {
+  auto plan = katana::analytics::RandomWalksPlan::Node2Vec();
+  uint64_t num_calls = 0;
+  auto res = katana::analytics::RandomWalks(
+      pg,
+      [&](const uint32_t*, uint64_t) -> katana::Result<void> {
+        if (++num_calls == 2) {
+          return katana::ErrorCode::NotFound;
+        }
+        return katana::ResultSuccess();
+      },
+      16, plan);
+  KATANA_LOG_ASSERT(!res && res.error() == katana::ErrorCode::NotFound);
+  KATANA_LOG_ASSERT(num_calls == 2);
+
+  auto no_chunk = katana::analytics::RandomWalks(
+      pg, [](const uint32_t*, uint64_t) { return katana::ResultSuccess(); },
+      0, plan);
+  KATANA_LOG_ASSERT(
+      !no_chunk && no_chunk.error() == katana::ErrorCode::InvalidArgument);
+}
+
+/// A symmetric graph of a hub, node 0, joined to nodes 1 to kHubDegree, and
+/// a node kHubDegree + 1 joined to nodes 1 to 4. The hub is of high enough
+/// degree for an alias table; the other node always binary searches its
+/// prefix sums. Some edges of both have weight zero.
+constexpr uint32_t kHubDegree = 64;
+constexpr uint32_t kSmallNode = kHubDegree + 1;
+constexpr uint32_t kSmallNodeWeights[] = {1, 0, 3, 6};
+
+uint32_t
+HubWeight(uint32_t dest) {
+  return dest % 5;
+}
+
+std::unique_ptr<katana::PropertyGraph>
+MakeWeightedGraph() {
+  // (src, dest, weight)
+  std::vector<std::tuple<uint32_t, uint32_t, uint32_t>> edges;
+  for (uint32_t n = 1; n <= kHubDegree; ++n) {
+    edges.emplace_back(0, n, HubWeight(n));
+    edges.emplace_back(n, 0, 1);
+  }
+  for (uint32_t n = 1; n <= 4; ++n) {
+    edges.emplace_back(kSmallNode, n, kSmallNodeWeights[n - 1]);
+    edges.emplace_back(n, kSmallNode, 1);
+  }
+  std::sort(edges.begin(), edges.end());
+
+  constexpr uint32_t kNumWeightedNodes = kSmallNode + 1;
+  katana::GraphTopology::AdjIndexVec adj_indices;
+  adj_indices.allocateInterleaved(kNumWeightedNodes);
+  katana::GraphTopology::EdgeDestVec dests;
+  dests.allocateInterleaved(edges.size());
+  arrow::UInt32Builder builder;
+  uint64_t end = 0;
+  for (uint32_t n = 0; n < kNumWeightedNodes; ++n) {
+    for (; end < edges.size() && std::get<0>(edges[end]) == n; ++end) {
+      dests[end] = std::get<1>(edges[end]);
+      KATANA_LOG_ASSERT(builder.Append(std::get<2>(edges[end])).ok());
+    }
+    adj_indices[n] = end;
+  }
+  auto res = katana::PropertyGraph::Make(
+      katana::GraphTopology(std::move(adj_indices), std::move(dests)));
+  KATANA_LOG_VASSERT(res, "making graph: {}", res.error());
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(res.value());
+
+  std::shared_ptr<arrow::Array> weights;
+  KATANA_LOG_ASSERT(builder.Finish(&weights).ok());
+  KATANA_LOG_ASSERT(pg->AddEdgeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("weight", weights->type())}), {weights})));
+  return pg;
+}
+
+/// Check that counts[dest] of num_samples steps from a node are within six
+/// standard deviations of weight(dest) / total_weight
+template <typename Weight>
+void
+CheckDistribution(
+    const std::vector<uint64_t>& counts, uint64_t num_samples,
+    const std::vector<uint32_t>& neighbors, const Weight& weight,
+    const char* what) {
+  double total_weight = 0;
+  uint64_t num_counted = 0;
+  for (uint32_t dest : neighbors) {
+    total_weight += weight(dest);
+    num_counted += counts[dest];
+  }
+  KATANA_LOG_ASSERT(num_counted == num_samples);
+  for (uint32_t dest : neighbors) {
+    double p = weight(dest) / total_weight;
+    double expected = p * num_samples;
+    double max_error = 6 * std::sqrt(num_samples * p * (1 - p)) + 1;
+    KATANA_LOG_VASSERT(
+        std::abs(counts[dest] - expected) <= max_error,
+        "{}: {} steps to {}, expected {}", what, counts[dest], dest,
+        expected);
+    // Not even once on an edge of weight zero
+    KATANA_LOG_ASSERT(p > 0 || counts[dest] == 0);
+  }
+}
+
+/// Weighted first steps from the hub and from the small node follow the edge
+/// weights, with the hub using its alias table or, when the tables get no
+/// memory, its prefix sums
+void
+TestWeightedDistribution() {
+  auto pg = MakeWeightedGraph();
+  constexpr uint32_t kNumSamples = 100000;
+  std::vector<uint32_t> hub_neighbors;
+  for (uint32_t n = 1; n <= kHubDegree; ++n) {
+    hub_neighbors.emplace_back(n);
+  }
+  std::vector<uint32_t> small_neighbors{1, 2, 3, 4};
+
+  uint64_t default_alias_bytes =
+      katana::analytics::RandomWalksPlan::kDefaultAliasTableMaxBytes;
+  for (uint64_t max_alias_bytes : {default_alias_bytes, uint64_t{0}}) {
+    // Walks of one step have no second order bias
+    auto plan = katana::analytics::RandomWalksPlan::Node2Vec(
+        1, kNumSamples, 1.0, 1.0, max_alias_bytes);
+    std::mutex mutex;
+    std::vector<uint64_t> hub_counts(kSmallNode + 1);
+    std::vector<uint64_t> small_counts(kSmallNode + 1);
+    auto res = katana::analytics::RandomWalks(
+        pg.get(), "weight",
+        [&](const uint32_t* walks, uint64_t num_walks) -> katana::Result<void> {
+          std::lock_guard<std::mutex> lock(mutex);
+          for (uint64_t w = 0; w < num_walks; ++w) {
+            const uint32_t* walk = walks + w * plan.walk_stride();
+            if (walk[0] == 0) {
+              ++hub_counts[walk[1]];
+            } else if (walk[0] == kSmallNode) {
+              ++small_counts[walk[1]];
+            }
+          }
+          return katana::ResultSuccess();
+        },
+        katana::analytics::kRandomWalksDefaultChunkSize, plan);
+    KATANA_LOG_VASSERT(res, "{}", res.error());
+
+    const char* what = max_alias_bytes ? "alias table" : "prefix sums";
+    CheckDistribution(
+        hub_counts, kNumSamples, hub_neighbors, HubWeight, what);
+    CheckDistribution(
+        small_counts, kNumSamples, small_neighbors,
+        [](uint32_t dest) { return kSmallNodeWeights[dest - 1]; },
+        "small node");
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  auto pg = MakeGraph();
+  TestOutputs(pg.get());
+  TestSinkError(pg.get());
+  TestWeightedDistribution();
+
+  return 0;
+}
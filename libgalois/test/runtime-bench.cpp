@@ -0,0 +1,293 @@
+/// Benchmarks of the runtime primitives that parallel loops are built from:
+/// the katana::wl<> worklists, the Barrier implementations, GAccumulator,
+/// InsertBag, FixedSizeAllocator and the page pool, each at several thread
+/// counts.
+///
+///   unit-runtime-bench [--threads=1,2,4,8] [--items=1048576]
+///       [--benchmark_out=results.json --benchmark_out_format=json]
+///
+/// Benchmarks are named <primitive>/<variant>/threads:<n> and report the
+/// operations (items, rounds, pushes or allocations) they do per second, so
+/// the JSON output of two runs, e.g., before and after a runtime change, can
+/// be compared with the compare.py tool of Google Benchmark. The default
+/// thread counts are the powers of two up to the number of threads, plus that
+/// number.
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "katana/Allocators.h"
+#include "katana/Bag.h"
+#include "katana/Barrier.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PagePool.h"
+#include "katana/Reduction.h"
+#include "katana/Strings.h"
+#include "katana/ThreadPool.h"
+#include "katana/WorkList.h"
+
+namespace {
+
+/// Worklist items are an id and, in the low bits, the number of items left
+/// to push after it
+constexpr uint32_t kDepthBits = 3;
+constexpr uint32_t kDepth = 4;
+constexpr uint32_t kBarrierRounds = 1024;
+constexpr uint32_t kAllocsPerThread = 4096;
+constexpr uint32_t kPagesPerThread = 16;
+
+uint32_t num_items = 1 << 20;
+
+struct DepthIndexer {
+  uint32_t operator()(uint32_t item) const {
+    return item & ((1 << kDepthBits) - 1);
+  }
+};
+
+struct OwnerIndexer {
+  uint32_t operator()(uint32_t item) const {
+    return (item >> kDepthBits) % katana::getActiveThreads();
+  }
+};
+
+using Obim =
+    katana::OrderedByIntegerMetric<DepthIndexer, katana::PerSocketChunkFIFO<>>;
+using OwnerComputes =
+    katana::OwnerComputes<OwnerIndexer, katana::PerSocketChunkLIFO<>>;
+using BulkSynchronous = katana::BulkSynchronous<katana::PerSocketChunkFIFO<>>;
+
+void
+SetItemsProcessed(benchmark::State& state, uint64_t per_iteration) {
+  state.counters["items_per_second"] = benchmark::Counter(
+      static_cast<double>(per_iteration) * state.iterations(),
+      benchmark::Counter::kIsRate);
+}
+
+/// Each initial item pushes a chain of kDepth more, so most of the items a
+/// worklist sees are pushed by the loop body rather than the initial range
+template <typename WL>
+void
+BenchWorklist(benchmark::State& state) {
+  katana::setActiveThreads(state.range(0));
+  std::vector<uint32_t> initial(num_items);
+  for (uint32_t i = 0; i < num_items; ++i) {
+    initial[i] = i << kDepthBits | kDepth;
+  }
+
+  for (auto _ : state) {
+    katana::GAccumulator<uint64_t> processed;
+    katana::for_each(
+        katana::iterate(initial.begin(), initial.end()),
+        [&](uint32_t item, auto& ctx) {
+          processed += 1;
+          if (DepthIndexer()(item) != 0) {
+            ctx.push(item - 1);
+          }
+        },
+        katana::wl<WL>(), katana::disable_conflict_detection(),
+        katana::no_stats());
+    KATANA_LOG_ASSERT(
+        processed.reduce() == uint64_t{num_items} * (kDepth + 1));
+  }
+
+  SetItemsProcessed(state, uint64_t{num_items} * (kDepth + 1));
+}
+
+void
+BenchBarrier(
+    benchmark::State& state,
+    const std::function<std::unique_ptr<katana::Barrier>(unsigned)>& make) {
+  uint32_t threads = katana::setActiveThreads(state.range(0));
+  std::unique_ptr<katana::Barrier> barrier = make(threads);
+  if (barrier == nullptr) {
+    state.SkipWithError("barrier not available");
+    return;
+  }
+  barrier->Reinit(threads);
+
+  for (auto _ : state) {
+    katana::on_each([&](unsigned, unsigned) {
+      for (uint32_t i = 0; i < kBarrierRounds; ++i) {
+        barrier->Wait();
+      }
+    });
+  }
+
+  state.counters["rounds_per_second"] = benchmark::Counter(
+      static_cast<double>(kBarrierRounds) * state.iterations(),
+      benchmark::Counter::kIsRate);
+}
+
+void
+BenchAccumulator(benchmark::State& state) {
+  katana::setActiveThreads(state.range(0));
+
+  for (auto _ : state) {
+    katana::GAccumulator<uint64_t> sum;
+    katana::do_all(
+        katana::iterate(uint32_t{0}, num_items),
+        [&](uint32_t i) { sum += i; }, katana::no_stats());
+    benchmark::DoNotOptimize(sum.reduce());
+  }
+
+  SetItemsProcessed(state, num_items);
+}
+
+void
+BenchInsertBag(benchmark::State& state) {
+  katana::setActiveThreads(state.range(0));
+
+  for (auto _ : state) {
+    katana::InsertBag<uint32_t> bag;
+    katana::do_all(
+        katana::iterate(uint32_t{0}, num_items),
+        [&](uint32_t i) { bag.push(i); }, katana::no_stats());
+    benchmark::DoNotOptimize(bag.empty());
+  }
+
+  SetItemsProcessed(state, num_items);
+}
+
+/// Each thread allocates a batch and then frees it, so the free lists are
+/// exercised as well as fresh memory
+template <size_t Size>
+void
+BenchFixedSizeAllocator(benchmark::State& state) {
+  struct Object {
+    char bytes[Size];
+  };
+  uint32_t threads = katana::setActiveThreads(state.range(0));
+
+  for (auto _ : state) {
+    katana::on_each([&](unsigned, unsigned) {
+      katana::FixedSizeAllocator<Object> alloc;
+      std::vector<Object*> objects(kAllocsPerThread);
+      for (auto& object : objects) {
+        object = alloc.allocate(1);
+      }
+      for (Object* object : objects) {
+        alloc.deallocate(object, 1);
+      }
+    });
+  }
+
+  state.counters["allocs_per_second"] = benchmark::Counter(
+      static_cast<double>(kAllocsPerThread) * threads * state.iterations(),
+      benchmark::Counter::kIsRate);
+}
+
+void
+BenchPagePool(benchmark::State& state) {
+  uint32_t threads = katana::setActiveThreads(state.range(0));
+
+  for (auto _ : state) {
+    katana::on_each([&](unsigned, unsigned) {
+      void* pages[kPagesPerThread];
+      for (void*& page : pages) {
+        page = katana::pagePoolAlloc();
+      }
+      for (void* page : pages) {
+        katana::pagePoolFree(page);
+      }
+    });
+  }
+
+  state.counters["allocs_per_second"] = benchmark::Counter(
+      static_cast<double>(kPagesPerThread) * threads * state.iterations(),
+      benchmark::Counter::kIsRate);
+}
+
+std::vector<uint32_t>
+ParseList(const std::string& list) {
+  std::vector<uint32_t> values;
+  for (const auto& value : katana::SplitView(list, ",")) {
+    values.emplace_back(std::stoul(std::string(value)));
+  }
+  return values;
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  katana::SharedMemSys G;
+
+  uint32_t max_threads = katana::GetThreadPool().getMaxThreads();
+  std::vector<uint32_t> threads;
+  for (uint32_t t = 1; t < max_threads; t *= 2) {
+    threads.emplace_back(t);
+  }
+  threads.emplace_back(max_threads);
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (katana::HasPrefix(arg, "--threads=")) {
+      threads = ParseList(arg.substr(10));
+    } else if (katana::HasPrefix(arg, "--items=")) {
+      num_items = std::stoul(arg.substr(8));
+    } else {
+      KATANA_LOG_FATAL("unknown argument: {}", arg);
+    }
+  }
+  KATANA_LOG_VASSERT(
+      num_items < (uint32_t{1} << (32 - kDepthBits)), "too many items: {}",
+      num_items);
+
+  std::vector<std::pair<std::string, std::function<void(benchmark::State&)>>>
+      benchmarks = {
+          {"Worklist/ChunkFIFO", BenchWorklist<katana::ChunkFIFO<>>},
+          {"Worklist/ChunkLIFO", BenchWorklist<katana::ChunkLIFO<>>},
+          {"Worklist/PerSocketChunkFIFO",
+           BenchWorklist<katana::PerSocketChunkFIFO<>>},
+          {"Worklist/PerSocketChunkLIFO",
+           BenchWorklist<katana::PerSocketChunkLIFO<>>},
+          {"Worklist/PerSocketChunkBag",
+           BenchWorklist<katana::PerSocketChunkBag<>>},
+          {"Worklist/AdaptivePerSocketChunkFIFO",
+           BenchWorklist<katana::AdaptivePerSocketChunkFIFO<>>},
+          {"Worklist/Obim", BenchWorklist<Obim>},
+          {"Worklist/OwnerComputes", BenchWorklist<OwnerComputes>},
+          {"Worklist/BulkSynchronous", BenchWorklist<BulkSynchronous>},
+          {"Barrier/Counting",
+           [](benchmark::State& state) {
+             BenchBarrier(state, katana::CreateCountingBarrier);
+           }},
+          {"Barrier/MCS",
+           [](benchmark::State& state) {
+             BenchBarrier(state, katana::CreateMCSBarrier);
+           }},
+          {"Barrier/Topo",
+           [](benchmark::State& state) {
+             BenchBarrier(state, katana::CreateTopoBarrier);
+           }},
+          {"Barrier/Dissemination",
+           [](benchmark::State& state) {
+             BenchBarrier(state, katana::CreateDisseminationBarrier);
+           }},
+          // CreateSimpleBarrier is left out because it can deadlock; see
+          // barriers.cpp
+          {"Reduction/GAccumulator", BenchAccumulator},
+          {"InsertBag/Push", BenchInsertBag},
+          {"FixedSizeAllocator/16", BenchFixedSizeAllocator<16>},
+          {"FixedSizeAllocator/256", BenchFixedSizeAllocator<256>},
+          {"PagePool/AllocFree", BenchPagePool},
+      };
+
+  for (const auto& [name, fn] : benchmarks) {
+    auto* b = ::benchmark::RegisterBenchmark(name.c_str(), fn);
+    for (uint32_t t : threads) {
+      b->Arg(std::min(t, max_threads));
+    }
+    b->ArgName("threads")->Unit(benchmark::kMicrosecond)->UseRealTime();
+  }
+
+  ::benchmark::RunSpecifiedBenchmarks();
+}
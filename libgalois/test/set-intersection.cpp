@@ -0,0 +1,111 @@
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <vector>
+
+#include "katana/Logging.h"
+#include "katana/SetIntersection.h"
+
+namespace {
+
+constexpr uint32_t kUniverse = 1 << 16;
+
+std::vector<uint32_t>
+MakeList(size_t size, std::mt19937* gen) {
+  std::uniform_int_distribution<uint32_t> dist(0, kUniverse - 1);
+  std::vector<uint32_t> list;
+  for (size_t i = 0; i < size; ++i) {
+    list.emplace_back(dist(*gen));
+  }
+  std::sort(list.begin(), list.end());
+  list.erase(std::unique(list.begin(), list.end()), list.end());
+  return list;
+}
+
+template <typename Kernel>
+std::vector<uint32_t>
+Collect(const Kernel& kernel) {
+  std::vector<uint32_t> common;
+  kernel([&](uint32_t id) { common.emplace_back(id); });
+  return common;
+}
+
+void
+TestPair(
+    const std::vector<uint32_t>& a, const std::vector<uint32_t>& b,
+    katana::IntersectionBitmap* bitmap) {
+  std::vector<uint32_t> expected;
+  std::set_intersection(
+      a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+
+  KATANA_LOG_ASSERT(
+      Collect([&](const auto& fn) {
+        katana::ForEachCommonMerge(a.data(), a.size(), b.data(), b.size(), fn);
+      }) == expected);
+  KATANA_LOG_ASSERT(
+      Collect([&](const auto& fn) {
+        katana::ForEachCommonMerge(b.data(), b.size(), a.data(), a.size(), fn);
+      }) == expected);
+  KATANA_LOG_ASSERT(
+      Collect([&](const auto& fn) {
+        katana::ForEachCommonGalloping(
+            a.data(), a.size(), b.data(), b.size(), fn);
+      }) == expected);
+  KATANA_LOG_ASSERT(
+      Collect([&](const auto& fn) {
+        katana::ForEachCommonGalloping(
+            b.data(), b.size(), a.data(), a.size(), fn);
+      }) == expected);
+  KATANA_LOG_ASSERT(
+      katana::CountCommon(a.data(), a.size(), b.data(), b.size()) ==
+      expected.size());
+
+  bitmap->Assign(a.data(), a.size(), kUniverse);
+  KATANA_LOG_ASSERT(bitmap->members() == a.data());
+  KATANA_LOG_ASSERT(
+      Collect([&](const auto& fn) {
+        katana::ForEachCommonBitmap(*bitmap, b.data(), b.size(), fn);
+      }) == expected);
+  KATANA_LOG_ASSERT(
+      katana::CountCommon(*bitmap, a.data(), a.size(), b.data(), b.size()) ==
+      expected.size());
+  bitmap->Clear();
+  for (uint32_t id : a) {
+    KATANA_LOG_ASSERT(!bitmap->Contains(id));
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  std::mt19937 gen(0);
+  katana::IntersectionBitmap bitmap;
+
+  // Sizes that exercise the block loop and its tails, and both sides of the
+  // galloping ratio
+  for (size_t a_size : {0, 1, 3, 4, 5, 17, 100, 1000}) {
+    for (size_t b_size : {0, 1, 4, 7, 64, 1000, 30000}) {
+      for (int trial = 0; trial < 4; ++trial) {
+        TestPair(MakeList(a_size, &gen), MakeList(b_size, &gen), &bitmap);
+      }
+    }
+  }
+
+  // Identical and disjoint lists
+  std::vector<uint32_t> evens;
+  std::vector<uint32_t> odds;
+  for (uint32_t i = 0; i < 1000; ++i) {
+    evens.emplace_back(2 * i);
+    odds.emplace_back(2 * i + 1);
+  }
+  TestPair(evens, evens, &bitmap);
+  TestPair(evens, odds, &bitmap);
+
+  // Ids past the universe of the bitmap are not members
+  bitmap.Assign(evens.data(), evens.size(), 2000);
+  KATANA_LOG_ASSERT(!bitmap.Contains(kUniverse));
+
+  return 0;
+}
@@ -0,0 +1,199 @@
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "katana/Frontier.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SparseMatrixVector.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+using View = katana::PropertyGraphViews::BiDirectional;
+
+constexpr uint32_t kNumNodes = 3000;
+constexpr uint32_t kDegree = 5;
+// Small blocks so that pushes spread over many bins
+constexpr uint32_t kBlockBits = 6;
+
+/// A random graph, with a path through every node so everything is
+/// reachable from node 0
+std::vector<std::vector<Node>>
+MakeAdjacency() {
+  std::vector<std::vector<Node>> adjacency(kNumNodes);
+  uint64_t state = 12345;
+  for (Node n = 0; n < kNumNodes; ++n) {
+    if (n + 1 < kNumNodes) {
+      adjacency[n].emplace_back(n + 1);
+    }
+    for (uint32_t i = 1; i < kDegree; ++i) {
+      state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+      adjacency[n].emplace_back((state >> 33) % kNumNodes);
+    }
+  }
+  return adjacency;
+}
+
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph(const std::vector<std::vector<Node>>& adjacency) {
+  std::vector<Edge> indices;
+  std::vector<Node> dests;
+  for (const auto& edges : adjacency) {
+    dests.insert(dests.end(), edges.begin(), edges.end());
+    indices.emplace_back(dests.size());
+  }
+  auto pg_res = katana::PropertyGraph::Make(katana::GraphTopology(
+      indices.data(), indices.size(), dests.data(), dests.size()));
+  KATANA_LOG_VASSERT(pg_res, "making graph: {}", pg_res.error());
+  return std::move(pg_res.value());
+}
+
+uint32_t
+Weight(uint64_t edge) {
+  return edge % 7 + 1;
+}
+
+/// Dense products with and without weights against a serial loop
+void
+TestDense(const std::vector<std::vector<Node>>& adjacency, const View& view) {
+  std::vector<double> x(kNumNodes);
+  for (Node n = 0; n < kNumNodes; ++n) {
+    x[n] = n % 10;
+  }
+  std::vector<double> expected(kNumNodes, 1);
+  std::vector<double> expected_weighted(kNumNodes, 1);
+  uint64_t edge = 0;
+  for (Node src = 0; src < kNumNodes; ++src) {
+    for (Node dst : adjacency[src]) {
+      expected[dst] += x[src];
+      expected_weighted[dst] += Weight(edge++) * x[src];
+    }
+  }
+
+  katana::SparseMatrixVector<katana::PlusTimesSemiring<double>, View> spmv(
+      view);
+  std::vector<double> y(kNumNodes, 1);
+  spmv.Multiply(x.data(), y.data());
+  KATANA_LOG_ASSERT(y == expected);
+
+  std::vector<double> y_weighted(kNumNodes, 1);
+  spmv.Multiply(x.data(), y_weighted.data(), [](uint64_t edge) {
+    return static_cast<double>(Weight(edge));
+  });
+  KATANA_LOG_ASSERT(y_weighted == expected_weighted);
+}
+
+using MinPlus =
+    katana::SparseMatrixVector<katana::MinPlusSemiring<uint32_t>, View>;
+
+/// Bellman-Ford rounds of SpMSpV over (min, +) against Dijkstra
+void
+TestShortestPaths(
+    const std::vector<std::vector<Node>>& adjacency, const View& view,
+    MinPlus::Direction direction) {
+  constexpr uint32_t kInfinity = std::numeric_limits<uint32_t>::max();
+  std::vector<uint32_t> expected(kNumNodes, kInfinity);
+  using Item = std::pair<uint32_t, Node>;
+  std::priority_queue<Item, std::vector<Item>, std::greater<>> queue;
+  std::vector<uint64_t> first_edge(kNumNodes);
+  for (Node n = 1; n < kNumNodes; ++n) {
+    first_edge[n] = first_edge[n - 1] + adjacency[n - 1].size();
+  }
+  expected[0] = 0;
+  queue.emplace(0, 0);
+  while (!queue.empty()) {
+    auto [dist, n] = queue.top();
+    queue.pop();
+    if (dist != expected[n]) {
+      continue;
+    }
+    for (size_t i = 0; i < adjacency[n].size(); ++i) {
+      Node dst = adjacency[n][i];
+      uint32_t next = dist + Weight(first_edge[n] + i);
+      if (next < expected[dst]) {
+        expected[dst] = next;
+        queue.emplace(next, dst);
+      }
+    }
+  }
+
+  MinPlus spmv(view, 1.0 / 20, kBlockBits);
+  std::vector<uint32_t> dist(kNumNodes, kInfinity);
+  dist[0] = 0;
+  katana::Frontier current(kNumNodes);
+  katana::Frontier next(kNumNodes);
+  current.Push(0);
+  current.Seal();
+  while (!current.empty()) {
+    std::vector<uint32_t> updated = dist;
+    spmv.Multiply(
+        current, dist.data(), updated.data(), &next,
+        [](uint64_t edge) { return Weight(edge); }, direction);
+    next.Seal();
+    dist = std::move(updated);
+    std::swap(current, next);
+    next.Clear();
+  }
+  KATANA_LOG_ASSERT(dist == expected);
+}
+
+/// BFS levels with SpMSpV over (or, and): every node is reached, one level
+/// per call
+void
+TestReachability(const View& view) {
+  using Direction =
+      katana::SparseMatrixVector<katana::OrAndSemiring, View>::Direction;
+  for (Direction direction :
+       {Direction::kAuto, Direction::kPush, Direction::kPull}) {
+    katana::SparseMatrixVector<katana::OrAndSemiring, View> spmv(
+        view, 1.0 / 20, kBlockBits);
+    std::vector<uint8_t> ones(kNumNodes, 1);
+    std::vector<uint8_t> visited(kNumNodes, 0);
+    visited[0] = 1;
+    katana::Frontier current(kNumNodes);
+    katana::Frontier next(kNumNodes);
+    current.Push(0);
+    current.Seal();
+    uint32_t levels = 0;
+    while (!current.empty()) {
+      spmv.Multiply(
+          current, ones.data(), visited.data(), &next, {}, direction);
+      next.Seal();
+      std::swap(current, next);
+      next.Clear();
+      ++levels;
+    }
+    for (Node n = 0; n < kNumNodes; ++n) {
+      KATANA_LOG_ASSERT(visited[n] == 1);
+    }
+    // The random edges make the graph much shallower than the path
+    KATANA_LOG_ASSERT(levels > 1 && levels < kNumNodes / 10);
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxThreads());
+
+  std::vector<std::vector<Node>> adjacency = MakeAdjacency();
+  std::unique_ptr<katana::PropertyGraph> pg = MakeGraph(adjacency);
+  View view = pg->BuildView<View>();
+
+  TestDense(adjacency, view);
+  TestShortestPaths(adjacency, view, MinPlus::Direction::kAuto);
+  TestShortestPaths(adjacency, view, MinPlus::Direction::kPush);
+  TestShortestPaths(adjacency, view, MinPlus::Direction::kPull);
+  TestReachability(view);
+
+  return 0;
+}
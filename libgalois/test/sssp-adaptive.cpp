@@ -0,0 +1,196 @@
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/sssp/sssp.h"
+
+namespace {
+
+using SsspPlan = katana::analytics::SsspPlan;
+
+template <typename Weight>
+std::unique_ptr<katana::PropertyGraph>
+MakeWeightedGraph(
+    katana::GraphTopology&& topo, const std::vector<Weight>& weights) {
+  auto pg_res = katana::PropertyGraph::Make(std::move(topo));
+  KATANA_LOG_ASSERT(pg_res);
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_res.value());
+  KATANA_LOG_ASSERT(weights.size() == pg->num_edges());
+
+  typename arrow::CTypeTraits<Weight>::BuilderType builder;
+  KATANA_LOG_ASSERT(builder.AppendValues(weights).ok());
+  std::shared_ptr<arrow::Array> array;
+  KATANA_LOG_ASSERT(builder.Finish(&array).ok());
+  KATANA_LOG_ASSERT(pg->AddEdgeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("weight", array->type())}), {array})));
+  return pg;
+}
+
+/// Collects the statistics reported while it is installed, to read back the
+/// delta steps the adaptive plan picked
+class StatReader : public katana::StatManager {
+public:
+  StatReader() : previous_(katana::internal::sysStatManager()) {
+    katana::internal::setSysStatManager(this);
+  }
+  ~StatReader() { katana::internal::setSysStatManager(previous_); }
+
+  /// The integer statistic category of region, if it was reported.
+  /// Statistics are merged once, so call this after the run.
+  std::optional<int64_t> Get(
+      const std::string& region, const std::string& category) {
+    MergeStats();
+    Str stat_region;
+    Str stat_category;
+    int64_t total{};
+    katana::StatTotal::Type type{};
+    katana::gstl::Vector<int64_t> values;
+    for (auto i = int_cbegin(); i != int_cend(); ++i) {
+      ReadInt(i, stat_region, stat_category, total, type, values);
+      if (std::string(stat_region.begin(), stat_region.end()) == region &&
+          std::string(stat_category.begin(), stat_category.end()) ==
+              category) {
+        return total;
+      }
+    }
+    return std::nullopt;
+  }
+
+private:
+  katana::StatManager* previous_;
+};
+
+/// The initial and final delta shifts of a run of the adaptive plan
+struct DeltaShifts {
+  std::optional<int64_t> initial;
+  std::optional<int64_t> final;
+};
+
+/// Run the adaptive and automatic plans from source and compare their
+/// distances with those of Dijkstra
+template <typename Weight>
+DeltaShifts
+CheckAgainstDijkstra(katana::PropertyGraph* pg, uint32_t source) {
+  KATANA_LOG_ASSERT(katana::analytics::Sssp(
+      pg, source, "weight", "dijkstra", SsspPlan::Dijkstra()));
+  DeltaShifts shifts{};
+  {
+    StatReader stats;
+    KATANA_LOG_ASSERT(katana::analytics::Sssp(
+        pg, source, "weight", "adaptive", SsspPlan::DeltaStepAdaptive()));
+    shifts.initial = stats.Get("SSSP", "InitialDeltaShift");
+    shifts.final = stats.Get("SSSP", "FinalDeltaShift");
+  }
+  // The automatic plan estimates delta the same way
+  KATANA_LOG_ASSERT(katana::analytics::Sssp(
+      pg, source, "weight", "automatic", SsspPlan()));
+
+  auto expected = pg->GetNodePropertyTyped<Weight>("dijkstra").value();
+  for (const std::string& name : {"adaptive", "automatic"}) {
+    auto dist = pg->GetNodePropertyTyped<Weight>(name).value();
+    for (uint32_t n = 0; n < pg->num_nodes(); ++n) {
+      KATANA_LOG_VASSERT(
+          dist->Value(n) == expected->Value(n),
+          "{}: node {} at distance {}, Dijkstra found {}", name, n,
+          dist->Value(n), expected->Value(n));
+    }
+    KATANA_LOG_ASSERT(pg->RemoveNodeProperty(name));
+  }
+  KATANA_LOG_ASSERT(pg->RemoveNodeProperty("dijkstra"));
+  return shifts;
+}
+
+/// Random graphs with four out-edges per node, weights from make_weight
+template <typename Weight, typename MakeWeight>
+std::unique_ptr<katana::PropertyGraph>
+MakeRandomGraph(uint32_t num_nodes, const MakeWeight& make_weight) {
+  katana::GraphTopology topo =
+      katana::CreateUniformRandomTopology(num_nodes, 4);
+  std::vector<Weight> weights;
+  for (size_t e = 0; e < topo.num_edges(); ++e) {
+    weights.emplace_back(make_weight());
+  }
+  return MakeWeightedGraph(std::move(topo), weights);
+}
+
+/// The estimate is 2 * mean weight / average degree, as a power of two
+void
+TestEstimate() {
+  auto ints = MakeRandomGraph<uint32_t>(1000, [] { return 8; });
+  DeltaShifts int_shifts = CheckAgainstDijkstra<uint32_t>(ints.get(), 0);
+  KATANA_LOG_ASSERT(int_shifts.initial == 2);
+
+  auto floats = MakeRandomGraph<float>(1000, [] { return 0.25f; });
+  DeltaShifts float_shifts = CheckAgainstDijkstra<float>(floats.get(), 0);
+  KATANA_LOG_ASSERT(float_shifts.initial == -3);
+}
+
+/// Uniform weights and skewed weights, mostly light with a few heavy ones
+/// that inflate the estimate
+template <typename Weight>
+void
+TestDistributions(Weight heavy) {
+  std::mt19937 gen(0);
+  std::uniform_real_distribution<double> uniform(1, 100);
+  auto uniform_graph = MakeRandomGraph<Weight>(
+      5000, [&] { return static_cast<Weight>(uniform(gen)); });
+  std::uniform_real_distribution<double> coin(0, 1);
+  auto skewed_graph = MakeRandomGraph<Weight>(5000, [&] {
+    return coin(gen) < 0.02 ? heavy : static_cast<Weight>(1);
+  });
+
+  for (uint32_t source : {0, 17, 4999}) {
+    CheckAgainstDijkstra<Weight>(uniform_graph.get(), source);
+    CheckAgainstDijkstra<Weight>(skewed_graph.get(), source);
+  }
+}
+
+/// On a long path, the estimated delta covers a couple of nodes per round,
+/// which is too little work, so delta has to grow
+template <typename Weight>
+void
+TestPathGrows(Weight weight) {
+  constexpr uint32_t kNumNodes = 5000;
+  std::vector<katana::GraphTopology::Edge> adj_indices;
+  std::vector<katana::GraphTopology::Node> dests;
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    if (n + 1 < kNumNodes) {
+      dests.emplace_back(n + 1);
+    }
+    adj_indices.emplace_back(dests.size());
+  }
+  auto pg = MakeWeightedGraph(
+      katana::GraphTopology(
+          adj_indices.data(), adj_indices.size(), dests.data(), dests.size()),
+      std::vector<Weight>(dests.size(), weight));
+
+  DeltaShifts shifts = CheckAgainstDijkstra<Weight>(pg.get(), 0);
+  KATANA_LOG_ASSERT(shifts.initial && shifts.final);
+  KATANA_LOG_VASSERT(
+      *shifts.final > *shifts.initial, "delta shift went from {} to {}",
+      *shifts.initial, *shifts.final);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestEstimate();
+  TestDistributions<uint32_t>(1 << 20);
+  TestDistributions<float>(1e6f);
+  TestPathGrows<uint32_t>(16);
+  TestPathGrows<float>(0.1f);
+
+  return 0;
+}
@@ -0,0 +1,470 @@
+/// Benchmarks of loading and storing RDGs. A graph with a uniform random
+/// topology and generated properties is written to each storage location,
+/// and then each location is measured with:
+///
+///   Open           tsuba::Open and tsuba::Close
+///   Load/Cold      PropertyGraph::Make after the page cache is dropped
+///   Load/Warm      PropertyGraph::Make after a previous load
+///   Slice          RDGSlice::Make of the first half of the nodes
+///   LoadProperty   PropertyGraph::LoadNodeProperty of one node property
+///   Commit         PropertyGraph::Commit after one property changed
+///   Write          PropertyGraph::Write to a new RDG
+///   CopyRDG        tsuba::CopyRDG of the latest version
+///
+///   unit-storage-bench [--locations=/tmp,s3://bucket/prefix] [--nodes=N]
+///       [--degree=D] [--properties=P] [--types=int64,double,uint8,string]
+///       [--benchmark_out=results.json --benchmark_out_format=json]
+///
+/// Each node and each edge gets P properties whose types cycle through
+/// --types. Locations may be any URI with a registered FileStorage backend.
+///
+/// Benchmarks are named <operation>/<location> and report GB/s, the bytes
+/// moved through tsuba (see tsuba::GetIOStats) per second, next to raw_GB/s,
+/// the rate of a single FileGet or FileStore of a file of the same size as
+/// the RDG in the same location. The page cache can only be dropped for local
+/// files; Load/Cold of remote locations measures a process without cached
+/// state.
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <arrow/api.h>
+#include <benchmark/benchmark.h>
+#include <boost/filesystem.hpp>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Strings.h"
+#include "katana/URI.h"
+#include "tsuba/IOStats.h"
+#include "tsuba/RDGSlice.h"
+#include "tsuba/file.h"
+#include "tsuba/tsuba.h"
+
+namespace {
+
+namespace fs = boost::filesystem;
+
+const char* const kCommandLine = "storage-bench";
+
+struct Options {
+  std::vector<std::string> locations{"/tmp"};
+  uint64_t nodes{1 << 20};
+  uint64_t degree{8};
+  uint32_t properties{4};
+  std::vector<std::string> types{"int64", "double", "uint8", "string"};
+};
+
+struct Location {
+  katana::Uri base;
+  katana::Uri rdg;
+  uint64_t rdg_bytes{0};
+  double raw_read_gbps{0};
+  double raw_write_gbps{0};
+};
+
+/// Benchmarks cannot continue past a failed storage operation
+template <typename T>
+T
+OrDie(katana::Result<T> res) {
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  return std::move(res.value());
+}
+
+void
+OrDie(katana::Result<void> res) {
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+}
+
+/// A deterministic stream of random numbers for each key
+uint64_t
+Mix(uint64_t x) {
+  x += 0x9e3779b97f4a7c15ULL;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+template <typename Builder, typename Fn>
+std::shared_ptr<arrow::Array>
+BuildArray(uint64_t length, Fn value) {
+  Builder builder;
+  KATANA_LOG_ASSERT(builder.Reserve(length).ok());
+  for (uint64_t i = 0; i < length; ++i) {
+    KATANA_LOG_ASSERT(builder.Append(value(i)).ok());
+  }
+  std::shared_ptr<arrow::Array> array;
+  KATANA_LOG_ASSERT(builder.Finish(&array).ok());
+  return array;
+}
+
+std::shared_ptr<arrow::Array>
+MakeColumn(const std::string& type, uint64_t length, uint64_t seed) {
+  auto random = [seed](uint64_t i) { return Mix(seed << 40 ^ i); };
+  if (type == "int64") {
+    return BuildArray<arrow::Int64Builder>(
+        length, [&](uint64_t i) { return static_cast<int64_t>(random(i)); });
+  }
+  if (type == "double") {
+    return BuildArray<arrow::DoubleBuilder>(length, [&](uint64_t i) {
+      return static_cast<double>(random(i) >> 11) * 0x1.0p-53;
+    });
+  }
+  if (type == "uint8") {
+    return BuildArray<arrow::UInt8Builder>(
+        length, [&](uint64_t i) { return static_cast<uint8_t>(random(i)); });
+  }
+  if (type == "string") {
+    return BuildArray<arrow::StringBuilder>(length, [&](uint64_t i) {
+      return fmt::format("{:x}", random(i) >> (random(i) & 63));
+    });
+  }
+  KATANA_LOG_FATAL("unknown property type: {}", type);
+}
+
+std::shared_ptr<arrow::Table>
+MakeProperties(
+    const Options& opts, const std::string& prefix, uint64_t length,
+    uint64_t seed) {
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::Array>> columns;
+  for (uint32_t i = 0; i < opts.properties; ++i) {
+    columns.emplace_back(MakeColumn(
+        opts.types[i % opts.types.size()], length, seed + i));
+    fields.emplace_back(arrow::field(
+        fmt::format("{}{}", prefix, i), columns.back()->type()));
+  }
+  return arrow::Table::Make(arrow::schema(fields), columns);
+}
+
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph(const Options& opts) {
+  auto pg = OrDie(katana::PropertyGraph::Make(
+      katana::CreateUniformRandomTopology(opts.nodes, opts.degree)));
+  OrDie(pg->AddNodeProperties(
+      MakeProperties(opts, "n", pg->num_nodes(), 0)));
+  OrDie(pg->AddEdgeProperties(
+      MakeProperties(opts, "e", pg->num_edges(), 1 << 16)));
+  return pg;
+}
+
+/// Evict the pages of a local file from the page cache so that the next read
+/// goes to the device
+void
+DropFileCache(const katana::Uri& file) {
+  if (file.scheme() != katana::Uri::kFileScheme) {
+    return;
+  }
+  int fd = open(file.path().c_str(), O_RDONLY);
+  if (fd < 0) {
+    return;
+  }
+  // Dirty pages are not dropped, so write them first
+  fdatasync(fd);
+  posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+  close(fd);
+}
+
+std::vector<std::string>
+ListFiles(const katana::Uri& dir, std::vector<uint64_t>* sizes = nullptr) {
+  std::vector<std::string> files;
+  auto res = tsuba::FileListAsync(dir.string(), &files, sizes).get();
+  KATANA_LOG_VASSERT(res, "listing {}: {}", dir, res.error());
+  return files;
+}
+
+void
+DropPageCache(const katana::Uri& dir) {
+  if (dir.scheme() != katana::Uri::kFileScheme) {
+    return;
+  }
+  for (const auto& file : ListFiles(dir)) {
+    DropFileCache(dir.Join(file));
+  }
+}
+
+void
+RemoveRDG(const katana::Uri& dir) {
+  if (dir.scheme() == katana::Uri::kFileScheme) {
+    fs::remove_all(dir.path());
+    return;
+  }
+  std::vector<std::string> files = ListFiles(dir);
+  OrDie(tsuba::FileDelete(
+      dir.string(),
+      std::unordered_set<std::string>(files.begin(), files.end())));
+}
+
+double
+SecondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+/// Time one FileStore and one FileGet of a file the size of the RDG, as the
+/// best the location can do for loads and stores of the RDG
+void
+MeasureRawBandwidth(Location* loc) {
+  std::vector<uint8_t> buf(loc->rdg_bytes);
+  for (size_t i = 0; i < buf.size(); ++i) {
+    buf[i] = static_cast<uint8_t>(Mix(i));
+  }
+  katana::Uri file = loc->base.RandFile("storage-bench-raw");
+
+  auto start = std::chrono::steady_clock::now();
+  OrDie(tsuba::FileStore(file.string(), buf.data(), buf.size()));
+  loc->raw_write_gbps = buf.size() / SecondsSince(start) / 1e9;
+
+  DropFileCache(file);
+  start = std::chrono::steady_clock::now();
+  OrDie(tsuba::FileGet(file.string(), buf.data(), 0, buf.size()));
+  loc->raw_read_gbps = buf.size() / SecondsSince(start) / 1e9;
+
+  OrDie(tsuba::FileDelete(file.DirName().string(), {file.BaseName()}));
+}
+
+uint64_t
+IOBytes(bool write) {
+  uint64_t bytes = 0;
+  for (const auto& [scheme, stats] : tsuba::GetIOStats().schemes) {
+    bytes += write ? stats.writes.bytes : stats.reads.bytes;
+  }
+  return bytes;
+}
+
+void
+ReportThroughput(benchmark::State& state, uint64_t bytes, double raw_gbps) {
+  state.counters["GB/s"] = benchmark::Counter(
+      static_cast<double>(bytes) / 1e9, benchmark::Counter::kIsRate);
+  state.counters["raw_GB/s"] = raw_gbps;
+}
+
+std::unique_ptr<katana::PropertyGraph>
+Load(const Location& loc, const tsuba::RDGLoadOptions& opts = {}) {
+  return OrDie(katana::PropertyGraph::Make(loc.rdg.string(), opts));
+}
+
+void
+BenchOpen(benchmark::State& state, const Location& loc) {
+  for (auto _ : state) {
+    auto handle = OrDie(tsuba::Open(loc.rdg.string(), tsuba::kReadOnly));
+    OrDie(tsuba::Close(handle));
+  }
+}
+
+void
+BenchLoad(benchmark::State& state, const Location& loc, bool cold) {
+  if (!cold) {
+    Load(loc);
+  }
+  tsuba::ResetIOStats();
+  for (auto _ : state) {
+    if (cold) {
+      state.PauseTiming();
+      DropPageCache(loc.rdg);
+      state.ResumeTiming();
+    }
+    benchmark::DoNotOptimize(Load(loc));
+  }
+  ReportThroughput(state, IOBytes(false), loc.raw_read_gbps);
+}
+
+void
+BenchSlice(benchmark::State& state, const Location& loc, const Options& opts) {
+  uint64_t half = std::max<uint64_t>(opts.nodes / 2, 1);
+  // Uniform random topologies have the same degree for every node
+  uint64_t edges = half * opts.degree;
+  tsuba::RDGSlice::SliceArg slice{
+      .node_range = {0, half},
+      .edge_range = {0, edges},
+      .topo_off = 0,
+      .topo_size = (4 + opts.nodes) * sizeof(uint64_t) +
+                   edges * sizeof(katana::GraphTopology::Node),
+  };
+
+  tsuba::ResetIOStats();
+  for (auto _ : state) {
+    state.PauseTiming();
+    DropPageCache(loc.rdg);
+    state.ResumeTiming();
+    auto handle = OrDie(tsuba::Open(loc.rdg.string(), tsuba::kReadOnly));
+    benchmark::DoNotOptimize(OrDie(tsuba::RDGSlice::Make(handle, slice)));
+    OrDie(tsuba::Close(handle));
+  }
+  ReportThroughput(state, IOBytes(false), loc.raw_read_gbps);
+}
+
+void
+BenchLoadProperty(benchmark::State& state, const Location& loc) {
+  tsuba::RDGLoadOptions load_opts;
+  load_opts.node_properties = std::vector<std::string>{};
+  load_opts.edge_properties = std::vector<std::string>{};
+  auto pg = Load(loc, load_opts);
+
+  tsuba::ResetIOStats();
+  for (auto _ : state) {
+    state.PauseTiming();
+    DropPageCache(loc.rdg);
+    state.ResumeTiming();
+    OrDie(pg->LoadNodeProperty("n0"));
+    state.PauseTiming();
+    OrDie(pg->UnloadNodeProperty("n0"));
+    state.ResumeTiming();
+  }
+  ReportThroughput(state, IOBytes(false), loc.raw_read_gbps);
+}
+
+void
+BenchCommit(benchmark::State& state, const Location& loc, const Options& opts) {
+  auto pg = Load(loc);
+
+  tsuba::ResetIOStats();
+  uint64_t seed = 1 << 24;
+  for (auto _ : state) {
+    state.PauseTiming();
+    OrDie(pg->UpsertNodeProperties(
+        MakeProperties(opts, "n", pg->num_nodes(), seed++)
+            ->SelectColumns({0})
+            .ValueOrDie()));
+    state.ResumeTiming();
+    OrDie(pg->Commit(kCommandLine));
+  }
+  ReportThroughput(state, IOBytes(true), loc.raw_write_gbps);
+}
+
+void
+BenchWrite(
+    benchmark::State& state, const Location& loc,
+    katana::PropertyGraph* generated) {
+  tsuba::ResetIOStats();
+  for (auto _ : state) {
+    katana::Uri dst = loc.base.RandFile("storage-bench-write");
+    OrDie(generated->Write(dst.string(), kCommandLine));
+    state.PauseTiming();
+    RemoveRDG(dst);
+    state.ResumeTiming();
+  }
+  ReportThroughput(state, IOBytes(true), loc.raw_write_gbps);
+}
+
+void
+BenchCopyRDG(benchmark::State& state, const Location& loc) {
+  auto views = OrDie(tsuba::ListAvailableViews(loc.rdg.string()));
+
+  for (auto _ : state) {
+    katana::Uri dst = loc.base.RandFile("storage-bench-copy");
+    auto src_dst = OrDie(tsuba::CreateSrcDestFromViewsForCopy(
+        loc.rdg.string(), dst.string(), views.first));
+    OrDie(tsuba::CopyRDG(std::move(src_dst)));
+    state.PauseTiming();
+    RemoveRDG(dst);
+    state.ResumeTiming();
+  }
+  // Copies may happen within the storage service, so count the RDG size
+  // rather than the bytes that pass through tsuba
+  ReportThroughput(
+      state, loc.rdg_bytes * state.iterations(), loc.raw_write_gbps);
+}
+
+Location
+Prepare(const std::string& location, katana::PropertyGraph* generated) {
+  Location loc;
+  loc.base = OrDie(katana::Uri::Make(location));
+  loc.rdg = loc.base.RandFile("storage-bench");
+  OrDie(generated->Write(loc.rdg.string(), kCommandLine));
+
+  std::vector<uint64_t> sizes;
+  ListFiles(loc.rdg, &sizes);
+  for (uint64_t size : sizes) {
+    loc.rdg_bytes += size;
+  }
+  MeasureRawBandwidth(&loc);
+  return loc;
+}
+
+std::vector<std::string>
+ParseList(const std::string& list) {
+  std::vector<std::string> values;
+  for (const auto& value : katana::SplitView(list, ",")) {
+    values.emplace_back(value);
+  }
+  return values;
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  katana::SharedMemSys G;
+
+  Options opts;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (katana::HasPrefix(arg, "--locations=")) {
+      opts.locations = ParseList(arg.substr(12));
+    } else if (katana::HasPrefix(arg, "--nodes=")) {
+      opts.nodes = std::stoull(arg.substr(8));
+    } else if (katana::HasPrefix(arg, "--degree=")) {
+      opts.degree = std::stoull(arg.substr(9));
+    } else if (katana::HasPrefix(arg, "--properties=")) {
+      opts.properties = std::stoul(arg.substr(13));
+    } else if (katana::HasPrefix(arg, "--types=")) {
+      opts.types = ParseList(arg.substr(8));
+    } else {
+      KATANA_LOG_FATAL("unknown argument: {}", arg);
+    }
+  }
+  KATANA_LOG_VASSERT(
+      opts.properties > 0 && !opts.types.empty(),
+      "at least one property is needed");
+
+  std::unique_ptr<katana::PropertyGraph> generated = MakeGraph(opts);
+  std::vector<Location> locations;
+  for (const auto& location : opts.locations) {
+    locations.emplace_back(Prepare(location, generated.get()));
+  }
+
+  for (const Location& loc : locations) {
+    auto add = [&](const std::string& name, auto fn) {
+      ::benchmark::RegisterBenchmark(
+          fmt::format("{}/{}", name, loc.base).c_str(), fn)
+          ->Unit(benchmark::kMillisecond)
+          ->UseRealTime();
+    };
+    add("Open", [&loc](benchmark::State& state) { BenchOpen(state, loc); });
+    add("Load/Cold",
+        [&loc](benchmark::State& state) { BenchLoad(state, loc, true); });
+    add("Load/Warm",
+        [&loc](benchmark::State& state) { BenchLoad(state, loc, false); });
+    add("Slice", [&loc, &opts](benchmark::State& state) {
+      BenchSlice(state, loc, opts);
+    });
+    add("LoadProperty",
+        [&loc](benchmark::State& state) { BenchLoadProperty(state, loc); });
+    add("Commit", [&loc, &opts](benchmark::State& state) {
+      BenchCommit(state, loc, opts);
+    });
+    add("Write", [&loc, &generated](benchmark::State& state) {
+      BenchWrite(state, loc, generated.get());
+    });
+    add("CopyRDG",
+        [&loc](benchmark::State& state) { BenchCopyRDG(state, loc); });
+  }
+
+  ::benchmark::RunSpecifiedBenchmarks();
+
+  for (const Location& loc : locations) {
+    RemoveRDG(loc.rdg);
+  }
+}
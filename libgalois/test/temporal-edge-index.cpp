@@ -0,0 +1,235 @@
+#include <algorithm>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <set>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TemporalEdgeIndex.h"
+#include "katana/analytics/bfs/bfs.h"
+#include "katana/analytics/random_walks/random_walks.h"
+#include "katana/analytics/subgraph_extraction/subgraph_extraction.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+
+constexpr int64_t kMaxTime = 1000;
+
+/// A random graph whose edges have random timestamps in [0, kMaxTime)
+std::unique_ptr<katana::PropertyGraph>
+MakeTimedGraph(std::vector<int64_t>* times) {
+  auto pg_res =
+      katana::PropertyGraph::Make(katana::CreateUniformRandomTopology(256, 6));
+  KATANA_LOG_ASSERT(pg_res);
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_res.value());
+
+  std::mt19937 generator(7);
+  std::uniform_int_distribution<int64_t> dist(0, kMaxTime - 1);
+  arrow::TimestampBuilder builder(
+      arrow::timestamp(arrow::TimeUnit::SECOND), arrow::default_memory_pool());
+  for (size_t i = 0; i < pg->num_edges(); ++i) {
+    times->emplace_back(dist(generator));
+    KATANA_LOG_ASSERT(builder.Append(times->back()).ok());
+  }
+  std::shared_ptr<arrow::Array> array;
+  KATANA_LOG_ASSERT(builder.Finish(&array).ok());
+  KATANA_LOG_ASSERT(pg->AddEdgeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("time", array->type())}), {array})));
+  return pg;
+}
+
+/// The destinations of the edges of n in window, by brute force
+std::multiset<Node>
+WindowDests(
+    const katana::PropertyGraph& pg, const std::vector<int64_t>& times,
+    Node n, const katana::TimeWindow& window) {
+  std::multiset<Node> dests;
+  for (Edge e : pg.topology().edges(n)) {
+    if (window.Contains(times[pg.topology().edge_property_index(e)])) {
+      dests.insert(pg.topology().edge_dest(e));
+    }
+  }
+  return dests;
+}
+
+void
+TestIndex(
+    katana::PropertyGraph* pg, const std::vector<int64_t>& times,
+    const katana::TimeWindow& window) {
+  auto index_res = pg->GetTemporalEdgeIndex("time");
+  KATANA_LOG_VASSERT(index_res, "{}", index_res.error());
+  auto index = index_res.value();
+  KATANA_LOG_ASSERT(index->num_edges() == pg->num_edges());
+
+  for (Node n : index->all_nodes()) {
+    int64_t last = std::numeric_limits<int64_t>::min();
+    for (Edge e : index->edges(n)) {
+      KATANA_LOG_ASSERT(index->edge_time(e) >= last);
+      KATANA_LOG_ASSERT(
+          index->edge_time(e) == times[index->edge_property_index(e)]);
+      last = index->edge_time(e);
+    }
+
+    std::multiset<Node> dests;
+    for (Edge e : index->edges(n, window)) {
+      KATANA_LOG_ASSERT(window.Contains(index->edge_time(e)));
+      dests.insert(index->edge_dest(e));
+    }
+    KATANA_LOG_ASSERT(dests == WindowDests(*pg, times, n, window));
+  }
+
+  // Cached
+  auto again = pg->GetTemporalEdgeIndex("time");
+  KATANA_LOG_ASSERT(again && again.value() == index);
+}
+
+/// Distances from source along edges in window, by brute force
+std::vector<uint32_t>
+WindowDistances(
+    const katana::PropertyGraph& pg, const std::vector<int64_t>& times,
+    Node source, const katana::TimeWindow& window) {
+  std::vector<uint32_t> dist(
+      pg.num_nodes(), std::numeric_limits<uint32_t>::max());
+  std::vector<Node> level{source};
+  dist[source] = 0;
+  for (uint32_t d = 1; !level.empty(); ++d) {
+    std::vector<Node> next;
+    for (Node n : level) {
+      for (Node dest : WindowDests(pg, times, n, window)) {
+        if (dist[dest] == std::numeric_limits<uint32_t>::max()) {
+          dist[dest] = d;
+          next.emplace_back(dest);
+        }
+      }
+    }
+    level = std::move(next);
+  }
+  return dist;
+}
+
+void
+TestBfs(
+    katana::PropertyGraph* pg, const std::vector<int64_t>& times,
+    const katana::TimeWindow& window) {
+  auto res =
+      katana::analytics::TimeWindowBfs(pg, 0, "time", window, "distance");
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  auto property = pg->GetNodeProperty("distance");
+  KATANA_LOG_ASSERT(property);
+  auto combined = katana::CombinedArray(property.value());
+  KATANA_LOG_ASSERT(combined);
+  auto distances =
+      std::static_pointer_cast<arrow::UInt32Array>(combined.value());
+
+  std::vector<uint32_t> expected = WindowDistances(*pg, times, 0, window);
+  for (Node n = 0; n < pg->num_nodes(); ++n) {
+    KATANA_LOG_VASSERT(
+        distances->Value(n) == expected[n], "node {}: {} != {}", n,
+        distances->Value(n), expected[n]);
+  }
+  KATANA_LOG_ASSERT(pg->RemoveNodeProperty("distance"));
+}
+
+void
+TestKHop(
+    katana::PropertyGraph* pg, const std::vector<int64_t>& times,
+    const katana::TimeWindow& window) {
+  constexpr uint32_t kHops = 2;
+  auto res = katana::analytics::KHopNeighborhood(
+      pg, {0, 1}, kHops, "time", window);
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+
+  std::vector<uint32_t> from0 = WindowDistances(*pg, times, 0, window);
+  std::vector<uint32_t> from1 = WindowDistances(*pg, times, 1, window);
+  std::set<Node> expected;
+  for (Node n = 0; n < pg->num_nodes(); ++n) {
+    if (std::min(from0[n], from1[n]) <= kHops) {
+      expected.insert(n);
+    }
+  }
+  std::set<Node> found(res.value().begin(), res.value().end());
+  KATANA_LOG_ASSERT(found.size() == res.value().size());
+  KATANA_LOG_ASSERT(found == expected);
+}
+
+void
+TestRandomWalks(
+    katana::PropertyGraph* pg, const std::vector<int64_t>& times,
+    const katana::TimeWindow& window) {
+  auto plan = katana::analytics::RandomWalksPlan::Node2Vec(5, 2, 0.5, 2.0);
+  uint32_t stride = plan.walk_stride();
+  std::mutex mutex;
+  uint64_t total_walks = 0;
+  auto res = katana::analytics::TimeWindowRandomWalks(
+      pg, "time", window,
+      [&](const uint32_t* walks, uint64_t num_walks) -> katana::Result<void> {
+        std::lock_guard<std::mutex> lock(mutex);
+        total_walks += num_walks;
+        for (uint64_t w = 0; w < num_walks; ++w) {
+          const uint32_t* walk = walks + w * stride;
+          for (uint32_t i = 1; i < stride; ++i) {
+            if (walk[i] == katana::analytics::kRandomWalkPadding) {
+              // A walk only ends early at a node without edges in window
+              KATANA_LOG_ASSERT(
+                  WindowDests(*pg, times, walk[i - 1], window).empty());
+              break;
+            }
+            KATANA_LOG_ASSERT(
+                WindowDests(*pg, times, walk[i - 1], window).count(walk[i]));
+          }
+        }
+        return katana::ResultSuccess();
+      },
+      64, plan);
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+
+  // Walks start at every node with an edge in window
+  uint64_t expected_walks = 0;
+  for (Node n = 0; n < pg->num_nodes(); ++n) {
+    if (!WindowDests(*pg, times, n, window).empty()) {
+      expected_walks += plan.number_of_walks();
+    }
+  }
+  KATANA_LOG_ASSERT(total_walks == expected_walks);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  std::vector<int64_t> times;
+  std::unique_ptr<katana::PropertyGraph> pg = MakeTimedGraph(&times);
+
+  for (const katana::TimeWindow& window :
+       {katana::TimeWindow{}, katana::TimeWindow{0, kMaxTime / 2},
+        katana::TimeWindow{kMaxTime / 4, kMaxTime / 4 + 100},
+        katana::TimeWindow{kMaxTime, kMaxTime + 1}}) {
+    TestIndex(pg.get(), times, window);
+    TestBfs(pg.get(), times, window);
+    TestKHop(pg.get(), times, window);
+    TestRandomWalks(pg.get(), times, window);
+  }
+
+  // Not a timestamp
+  arrow::StringBuilder builder;
+  for (size_t i = 0; i < pg->num_edges(); ++i) {
+    KATANA_LOG_ASSERT(builder.Append("t").ok());
+  }
+  std::shared_ptr<arrow::Array> names;
+  KATANA_LOG_ASSERT(builder.Finish(&names).ok());
+  KATANA_LOG_ASSERT(pg->AddEdgeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("name", arrow::utf8())}), {names})));
+  KATANA_LOG_ASSERT(!pg->GetTemporalEdgeIndex("name"));
+
+  return 0;
+}
@@ -0,0 +1,93 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "katana/CompilerSpecific.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+
+namespace {
+
+// A for_each whose work is generated on the fly, with a long tail of little
+// work per round, and an outer loop that restarts termination detection
+void
+TestForEach() {
+  constexpr uint32_t kDepth = 16;
+
+  for (unsigned threads : {1U, katana::GetThreadPool().getMaxThreads()}) {
+    katana::setActiveThreads(threads);
+    for (int round = 0; round < 3; ++round) {
+      std::atomic<uint64_t> visited{0};
+      katana::for_each(
+          katana::iterate({uint32_t{1}}),
+          [&](uint32_t n, auto& ctx) {
+            ++visited;
+            if (n < (uint32_t{1} << kDepth)) {
+              ctx.push(2 * n);
+              ctx.push(2 * n + 1);
+            }
+          },
+          katana::no_stats());
+      KATANA_LOG_ASSERT(visited == (uint64_t{2} << kDepth) - 1);
+    }
+
+    std::atomic<uint64_t> sum{0};
+    katana::do_all(
+        katana::iterate(uint32_t{0}, uint32_t{100000}),
+        [&](uint32_t i) { sum += i; }, katana::steal());
+    KATANA_LOG_ASSERT(sum == uint64_t{100000} * 99999 / 2);
+  }
+}
+
+// Many short loops while other threads compete for every core, so that
+// threads are preempted between reading an epoch and confirming it
+void
+TestOversubscribed() {
+  katana::setActiveThreads(katana::GetThreadPool().getMaxThreads());
+
+  std::atomic<bool> done{false};
+  std::vector<std::thread> hogs;
+  for (unsigned i = 0; i < std::max(1U, std::thread::hardware_concurrency());
+       ++i) {
+    hogs.emplace_back([&] {
+      while (!done) {
+        katana::asmPause();
+      }
+    });
+  }
+
+  for (int round = 0; round < 200; ++round) {
+    std::atomic<uint32_t> visited{0};
+    katana::for_each(
+        katana::iterate({uint32_t{1}}),
+        [&](uint32_t n, auto& ctx) {
+          ++visited;
+          if (n < 64) {
+            ctx.push(2 * n);
+            ctx.push(2 * n + 1);
+          }
+        },
+        katana::no_stats());
+    KATANA_LOG_ASSERT(visited == 127);
+  }
+
+  done = true;
+  for (auto& hog : hogs) {
+    hog.join();
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  setenv("KATANA_TERMINATION", "snzi", 1);
+  katana::SharedMemSys Katana_runtime;
+  TestForEach();
+  TestOversubscribed();
+
+  return 0;
+}
@@ -0,0 +1,83 @@
+#include <atomic>
+#include <cstdlib>
+#include <stdexcept>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/ThreadPool.h"
+
+namespace {
+
+/// Storage made before threads start is there when they do
+void
+TestLazyStart() {
+  auto& tp = katana::GetThreadPool();
+  KATANA_LOG_ASSERT(tp.getNumSpawnedThreads() == 1);
+
+  katana::PerThreadStorage<int> values(7);
+  katana::PerSocketStorage<int> socket_values(11);
+  for (unsigned i = 0; i < tp.getMaxThreads(); ++i) {
+    KATANA_LOG_ASSERT(*values.getRemote(i) == 7);
+  }
+
+  unsigned num = katana::setActiveThreads(2);
+  KATANA_LOG_ASSERT(tp.getNumSpawnedThreads() == 1);
+  std::atomic<unsigned> seen{0};
+  katana::on_each([&](unsigned tid, unsigned) {
+    if (*values.getLocal() == 7 && *socket_values.getLocal() == 11) {
+      ++seen;
+    }
+    *values.getLocal() = tid;
+  });
+  KATANA_LOG_ASSERT(seen == num);
+  KATANA_LOG_ASSERT(tp.getNumSpawnedThreads() == num);
+  for (unsigned i = 0; i < num; ++i) {
+    KATANA_LOG_ASSERT(*values.getRemote(i) == static_cast<int>(i));
+  }
+
+  num = katana::setActiveThreads(tp.getMaxThreads());
+  seen = 0;
+  katana::on_each([&](unsigned, unsigned) { ++seen; });
+  KATANA_LOG_ASSERT(seen == num);
+  KATANA_LOG_ASSERT(tp.getNumSpawnedThreads() == num);
+}
+
+/// A region whose master thread throws releases the pool for the next one
+void
+TestThrowReleasesPool() {
+  auto& tp = katana::GetThreadPool();
+  unsigned num = katana::setActiveThreads(tp.getMaxThreads());
+
+  std::atomic<unsigned> seen{0};
+  bool caught = false;
+  try {
+    katana::on_each([&](unsigned tid, unsigned) {
+      ++seen;
+      if (tid == 0) {
+        throw std::runtime_error("master failed");
+      }
+    });
+  } catch (const std::runtime_error&) {
+    caught = true;
+  }
+  KATANA_LOG_ASSERT(caught);
+  KATANA_LOG_ASSERT(seen == num);
+  KATANA_LOG_ASSERT(!tp.isRunning());
+
+  seen = 0;
+  katana::on_each([&](unsigned, unsigned) { ++seen; });
+  KATANA_LOG_ASSERT(seen == num);
+}
+
+}  // namespace
+
+int
+main() {
+  unsetenv("KATANA_EAGER_THREADS");
+  katana::SharedMemSys Katana_runtime;
+  TestLazyStart();
+  TestThrowReleasesPool();
+
+  return 0;
+}
@@ -0,0 +1,168 @@
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/URI.h"
+#include "tsuba/CSRTopology.h"
+#include "tsuba/PartitionedLoad.h"
+#include "tsuba/RDGPrefix.h"
+#include "tsuba/RDGSlice.h"
+#include "tsuba/tsuba.h"
+
+namespace {
+
+constexpr uint64_t kNumNodes = 1000;
+
+/// Write topo as an RDG, then rewrite its topology file in the version 2
+/// format with 64-bit destinations. If bad_dest is set, the last edge points
+/// to a node past 2^32, whose low 32 bits are a valid node.
+std::string
+WriteWideRDG(const katana::GraphTopology& topo, bool bad_dest) {
+  auto pg_res =
+      katana::PropertyGraph::Make(katana::GraphTopology::Copy(topo));
+  KATANA_LOG_ASSERT(pg_res);
+  auto uri_res = katana::Uri::MakeRand("/tmp/widetopology");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+  if (auto res = pg_res.value()->Write(rdg_dir, "wide-topology"); !res) {
+    boost::filesystem::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", res.error());
+  }
+
+  uint64_t num_rewritten = 0;
+  for (const auto& entry : boost::filesystem::directory_iterator(rdg_dir)) {
+    if (entry.path().filename().string().rfind("topology", 0) != 0) {
+      continue;
+    }
+    tsuba::CSRTopologyHeader header;
+    std::ifstream in(entry.path().string(), std::ios::binary);
+    in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    KATANA_LOG_ASSERT(in && header.version == tsuba::kCSRTopologyVersion);
+    KATANA_LOG_ASSERT(header.edge_type_size == 0);
+    std::vector<uint64_t> out_indices(header.num_nodes);
+    std::vector<uint32_t> dests(header.num_edges);
+    in.read(
+        reinterpret_cast<char*>(out_indices.data()),
+        out_indices.size() * sizeof(uint64_t));
+    in.read(
+        reinterpret_cast<char*>(dests.data()),
+        dests.size() * sizeof(uint32_t));
+    KATANA_LOG_ASSERT(in);
+    in.close();
+
+    std::vector<uint64_t> wide_dests(dests.begin(), dests.end());
+    if (bad_dest) {
+      wide_dests.back() = (UINT64_C(1) << 32) + 1;
+    }
+    header.version = tsuba::kCSRTopology64Version;
+    std::ofstream out(
+        entry.path().string(), std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(
+        reinterpret_cast<const char*>(out_indices.data()),
+        out_indices.size() * sizeof(uint64_t));
+    out.write(
+        reinterpret_cast<const char*>(wide_dests.data()),
+        wide_dests.size() * sizeof(uint64_t));
+    KATANA_LOG_ASSERT(out);
+    out.close();
+    KATANA_LOG_ASSERT(
+        boost::filesystem::file_size(entry.path()) ==
+        tsuba::CSRTopologyFileSize(header));
+    ++num_rewritten;
+  }
+  KATANA_LOG_ASSERT(num_rewritten == 1);
+  return rdg_dir;
+}
+
+/// A version 2 topology loads whole into the same GraphTopology
+void
+TestLoad(const katana::GraphTopology& topo, const std::string& rdg_dir) {
+  auto pg_res = katana::PropertyGraph::Make(rdg_dir, tsuba::RDGLoadOptions());
+  KATANA_LOG_VASSERT(pg_res, "loading: {}", pg_res.error());
+  KATANA_LOG_ASSERT(pg_res.value()->topology().Equals(topo));
+}
+
+/// Slices of a version 2 topology hold the 64-bit destinations of their
+/// edges, and a partitioned load of it matches the graph
+katana::Result<void>
+TestSlices(const katana::GraphTopology& topo, const std::string& rdg_dir) {
+  auto handle = KATANA_CHECKED(tsuba::Open(rdg_dir, tsuba::kReadOnly));
+  auto prefix = KATANA_CHECKED(tsuba::RDGPrefix::Make(handle));
+  KATANA_LOG_ASSERT(prefix.version() == tsuba::kCSRTopology64Version);
+  KATANA_LOG_ASSERT(prefix.num_nodes() == topo.num_nodes());
+
+  for (auto node_range :
+       {std::make_pair(uint64_t{0}, kNumNodes),
+        std::make_pair(uint64_t{1}, uint64_t{2}),
+        std::make_pair(kNumNodes / 3, 2 * kNumNodes / 3),
+        std::make_pair(kNumNodes - 1, kNumNodes)}) {
+    tsuba::RDGSlice::SliceArg arg = tsuba::MakeSliceArg(prefix, node_range);
+    KATANA_LOG_ASSERT(
+        arg.edge_range.first == *topo.edges(node_range.first).begin());
+    KATANA_LOG_ASSERT(
+        arg.edge_range.second == *topo.edges(node_range.second - 1).end());
+    KATANA_LOG_ASSERT(
+        arg.topo_size ==
+        (arg.edge_range.second - arg.edge_range.first) * sizeof(uint64_t));
+    auto slice = KATANA_CHECKED(tsuba::RDGSlice::Make(
+        handle, arg, std::vector<std::string>{},
+        std::vector<std::string>{}));
+    const uint64_t* dests =
+        slice.topology_file_storage().ptr<uint64_t>(arg.topo_off);
+    for (uint64_t e = arg.edge_range.first; e < arg.edge_range.second; ++e) {
+      KATANA_LOG_VASSERT(
+          dests[e - arg.edge_range.first] == topo.edge_dest(e),
+          "slice [{}, {}): edge {}", node_range.first, node_range.second, e);
+    }
+  }
+
+  auto part = KATANA_CHECKED(
+      tsuba::LoadPartitionedSlice(handle, std::vector<std::string>{}));
+  KATANA_LOG_ASSERT(part.metadata.num_owned_ == topo.num_nodes());
+  KATANA_LOG_ASSERT(part.edge_dests.size() == topo.num_edges());
+  for (auto e : topo.all_edges()) {
+    KATANA_LOG_ASSERT(part.edge_dests[e] == topo.edge_dest(e));
+  }
+
+  KATANA_CHECKED(tsuba::Close(handle));
+  return katana::ResultSuccess();
+}
+
+/// Destinations are checked before they are narrowed, so a node past 2^32
+/// fails the load instead of aliasing a small node
+void
+TestBadDest(const std::string& rdg_dir) {
+  auto pg_res = katana::PropertyGraph::Make(rdg_dir, tsuba::RDGLoadOptions());
+  KATANA_LOG_ASSERT(!pg_res);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  katana::GraphTopology topo =
+      katana::CreateUniformRandomTopology(kNumNodes, 5);
+
+  std::string rdg_dir = WriteWideRDG(topo, false);
+  TestLoad(topo, rdg_dir);
+  if (auto res = TestSlices(topo, rdg_dir); !res) {
+    boost::filesystem::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("TestSlices: {}", res.error());
+  }
+  boost::filesystem::remove_all(rdg_dir);
+
+  std::string bad_dir = WriteWideRDG(topo, true);
+  TestBadDest(bad_dir);
+  boost::filesystem::remove_all(bad_dir);
+
+  return 0;
+}
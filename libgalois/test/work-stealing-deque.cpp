@@ -0,0 +1,107 @@
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/WorkList.h"
+
+namespace {
+
+// Every thread pushes to and pops from its own deque while stealing from the
+// others; every item must be taken exactly once
+void
+TestDeque() {
+  constexpr uint32_t kItemsPerThread = 100000;
+
+  const unsigned num_threads = katana::getActiveThreads();
+  std::vector<std::unique_ptr<katana::internal::ChaseLevDeque<uint32_t>>>
+      deques;
+  for (unsigned i = 0; i < num_threads; ++i) {
+    // Start small so that the buffers grow under contention
+    deques.emplace_back(
+        std::make_unique<katana::internal::ChaseLevDeque<uint32_t>>(4));
+  }
+  std::vector<std::atomic<uint32_t>> taken(num_threads * kItemsPerThread);
+  std::atomic<uint64_t> num_taken{0};
+
+  katana::on_each([&](unsigned tid, unsigned num) {
+    auto& mine = *deques[tid];
+    auto take = [&](uint32_t item) {
+      taken[item].fetch_add(1);
+      num_taken.fetch_add(1);
+    };
+
+    for (uint32_t i = 0; i < kItemsPerThread; ++i) {
+      mine.push(tid * kItemsPerThread + i);
+      if (i % 3 == 0) {
+        if (auto item = mine.pop()) {
+          take(*item);
+        }
+      }
+      if (num > 1 && i % 5 == 0) {
+        bool aborted = false;
+        if (auto item = deques[(tid + 1) % num]->steal(&aborted)) {
+          take(*item);
+        }
+      }
+    }
+    while (auto item = mine.pop()) {
+      take(*item);
+    }
+    // Others may still be pushing, so keep stealing until everything is gone
+    while (num_taken.load() < num * kItemsPerThread) {
+      for (unsigned v = 0; v < num; ++v) {
+        bool aborted = false;
+        if (auto item = deques[v]->steal(&aborted)) {
+          take(*item);
+        }
+      }
+    }
+  });
+
+  for (auto& t : taken) {
+    KATANA_LOG_ASSERT(t.load() == 1);
+  }
+  for (auto& d : deques) {
+    KATANA_LOG_ASSERT(d->empty());
+  }
+}
+
+// Expand a complete binary tree; each iteration pushes its children
+void
+TestForEach() {
+  constexpr uint64_t kDepth = 18;
+
+  std::atomic<uint64_t> visited{0};
+  std::vector<uint64_t> root{1};
+  katana::for_each(
+      katana::iterate(root),
+      [&](uint64_t node, katana::UserContext<uint64_t>& ctx) {
+        visited.fetch_add(1, std::memory_order_relaxed);
+        if (node < (uint64_t{1} << kDepth)) {
+          ctx.push(2 * node);
+          ctx.push(2 * node + 1);
+        }
+      },
+      katana::wl<katana::WorkStealingLIFO<>>(),
+      katana::disable_conflict_detection(),
+      katana::loopname("WorkStealingForEach"));
+
+  KATANA_LOG_ASSERT(visited.load() == (uint64_t{1} << (kDepth + 1)) - 1);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys Katana_runtime;
+
+  for (unsigned threads : {1U, 2U, katana::GetThreadPool().getMaxThreads()}) {
+    katana::setActiveThreads(threads);
+    TestDeque();
+    TestForEach();
+  }
+
+  return 0;
+}
@@ -1,6 +1,9 @@
 #ifndef KATANA_LIBSUPPORT_KATANA_ARROWINTERCHANGE_H_
 #define KATANA_LIBSUPPORT_KATANA_ARROWINTERCHANGE_H_
 
+#include <string>
+#include <string_view>
+
 #include <arrow/stl.h>
 #include <arrow/type_traits.h>
 
@@ -286,6 +289,27 @@ TableBuilder::AddColumn(const ColumnOptions& options) {
 KATANA_EXPORT std::shared_ptr<arrow::ChunkedArray> NullChunkedArray(
     const std::shared_ptr<arrow::DataType>& type, int64_t length);
 
+/// Return the values of \p array as one array: its only chunk, without a
+/// copy, or else a concatenation of its chunks. Code that can handle several
+/// chunks should use them directly instead (see ChunkedPropertyView).
+KATANA_EXPORT Result<std::shared_ptr<arrow::Array>> CombinedArray(
+    const std::shared_ptr<arrow::ChunkedArray>& array);
+
+/// Return the dictionary encoded values of \p array as one array with one
+/// dictionary. Chunks, such as the row groups of a parquet file, may each
+/// have their own dictionary; their codes are translated into codes of a
+/// dictionary with the values of all of them.
+KATANA_EXPORT Result<std::shared_ptr<arrow::Array>> UnifiedDictionaryArray(
+    const std::shared_ptr<arrow::ChunkedArray>& array);
+
+/// Return \p array dictionary encoded: int32 codes into a dictionary of its
+/// distinct values, in order of first appearance, as one chunk. Columns
+/// with few distinct values, such as categories, take much less memory
+/// encoded and stay encoded when stored. Dictionary arrays are returned as
+/// they are.
+KATANA_EXPORT Result<std::shared_ptr<arrow::ChunkedArray>> DictionaryEncode(
+    const std::shared_ptr<arrow::ChunkedArray>& array);
+
 /// Print the differences between two ChunkedArrays only using
 /// about approx_total_characters
 KATANA_EXPORT void DiffFormatTo(
@@ -305,6 +329,32 @@ ApproxArrayMemUse(const std::shared_ptr<arrow::Array>& array);
 KATANA_EXPORT uint64_t
 ApproxTableMemUse(const std::shared_ptr<arrow::Table>& table);
 
+/// Return a 128-bit digest of the type and values of \p array, as
+/// kContentDigestVersion followed by 32 hex characters. Arrays with equal
+/// digests hold the same values. Equal arrays have equal digests if they are
+/// chunked the same way, or in any case if IsContentDigestCanonical. Blocks
+/// of rows, or chunks, are digested on up to \p num_threads threads; the
+/// digest does not depend on how many. The digest is not cryptographic; it is
+/// for detecting unchanged data.
+KATANA_EXPORT std::string ContentDigest(
+    const std::shared_ptr<arrow::ChunkedArray>& array,
+    unsigned num_threads = 1);
+
+/// The prefix of digests returned by ContentDigest. It changes whenever the
+/// digest of some array does, so that digests recorded by earlier versions
+/// are recognized, rather than compared against current ones.
+constexpr std::string_view kContentDigestVersion = "d1:";
+
+/// Whether \p digest was made by the current version of ContentDigest
+KATANA_EXPORT bool IsCurrentContentDigest(const std::string& digest);
+
+/// Whether the ContentDigest of \p array depends only on its type and values,
+/// not on how it is chunked or sliced, so that an array of the same type with
+/// a different digest holds different values. This is the case for arrays of
+/// byte-aligned fixed-width values without nulls.
+KATANA_EXPORT bool IsContentDigestCanonical(
+    const std::shared_ptr<arrow::ChunkedArray>& array);
+
 }  // namespace katana
 
 #endif
@@ -1,6 +1,9 @@
 #ifndef KATANA_LIBSUPPORT_KATANA_ARROWVISITOR_H_
 #define KATANA_LIBSUPPORT_KATANA_ARROWVISITOR_H_
 
+#include <cstdint>
+#include <tuple>
+
 #include <arrow/api.h>
 #include <arrow/vendored/datetime/date.h>
 
@@ -266,6 +269,60 @@ VisitArrow(
   return VisitArrow(builder.get(), std::forward<VisitorType>(visitor));
 }
 
+/// The C++ types a template is instantiated for by VisitArrowCType
+template <typename... CTypes>
+struct CTypeList {
+  static_assert(sizeof...(CTypes) > 0);
+  using First = std::tuple_element_t<0, std::tuple<CTypes...>>;
+};
+
+/// The numeric property types, e.g., of edge weights, that analytics
+/// kernels are instantiated for
+using NumericCTypes =
+    CTypeList<uint32_t, int32_t, uint64_t, int64_t, float, double>;
+
+namespace internal {
+
+template <typename Fn, typename CType, typename... Rest>
+auto
+VisitArrowCTypeInternal(
+    const arrow::DataType& type, const Fn& fn, CTypeList<CType, Rest...>)
+    -> decltype(fn(CType{})) {
+  if (type.id() == arrow::CTypeTraits<CType>::ArrowType::type_id) {
+    return fn(CType{});
+  }
+  if constexpr (sizeof...(Rest) > 0) {
+    return VisitArrowCTypeInternal(type, fn, CTypeList<Rest...>{});
+  } else {
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "Unsupported type: {}", type.ToString());
+  }
+}
+
+}  // namespace internal
+
+/// Call fn with a value of the type in CTypes that is the C++ type of the
+/// Arrow type, e.g.,
+///
+///     VisitArrowCType<NumericCTypes>(*field->type(), [&](auto tag) {
+///       using Weight = decltype(tag);
+///       ...
+///     });
+///
+/// fn is instantiated for every type in CTypes at compile time and the one
+/// to run is picked from the type, typically from a schema, so a templated
+/// kernel reads a column of any of the types directly rather than a cast
+/// copy of it. fn returns a katana::Result, the same type for every CType.
+///
+/// \returns what fn returns, or ErrorCode::TypeError if type is not in
+///     CTypes
+template <typename CTypes, typename Fn>
+auto
+VisitArrowCType(const arrow::DataType& type, const Fn& fn)
+    -> decltype(fn(typename CTypes::First{})) {
+  return internal::VisitArrowCTypeInternal(type, fn, CTypes{});
+}
+
 class AppendScalarToBuilder {
 public:
   using ReturnType = void;
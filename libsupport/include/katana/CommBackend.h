@@ -2,7 +2,11 @@
 #define KATANA_LIBSUPPORT_KATANA_COMMBACKEND_H_
 
 #include <cstdint>
+#include <memory>
 #include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include "katana/Logging.h"
 #include "katana/Result.h"
@@ -10,8 +14,38 @@
 
 namespace katana {
 
+/// A nonblocking collective operation in progress
+class KATANA_EXPORT CommRequest {
+public:
+  CommRequest() = default;
+  CommRequest(const CommRequest& other) = delete;
+  CommRequest& operator=(const CommRequest& other) = delete;
+  virtual ~CommRequest();
+
+  /// Whether the operation has finished; Wait returns at once if so
+  virtual bool Test() = 0;
+  /// Wait for the operation to finish. Its buffers may be used again after.
+  virtual Result<void> Wait() = 0;
+};
+
+/// A request of an operation that finished when it was started
+class KATANA_EXPORT CompletedCommRequest : public CommRequest {
+public:
+  explicit CompletedCommRequest(Result<void> res) : res_(std::move(res)) {}
+
+  bool Test() override { return true; }
+  Result<void> Wait() override { return res_; }
+
+private:
+  Result<void> res_;
+};
+
 class KATANA_EXPORT CommBackend {
 public:
+  /// The element types of Allreduce
+  enum class DataType { kUInt8, kInt32, kUInt32, kInt64, kUInt64, kDouble };
+  enum class ReduceOp { kSum, kMin, kMax };
+
   CommBackend() = default;
   CommBackend(const CommBackend& other) = delete;
   CommBackend(CommBackend&& other) = delete;
@@ -29,6 +63,78 @@ public:
   /// Notify other tasks that there was a failure; e.g., with MPI_Abort
   virtual void NotifyFailure() = 0;
 
+  /// Combine the count elements of send of every task elementwise with op,
+  /// and put the result in recv of every task. send may be recv.
+  virtual Result<void> Allreduce(
+      const void* send, void* recv, uint64_t count, DataType type,
+      ReduceOp op) = 0;
+
+  /// Put the send_bytes bytes of send of every task into recv of every task,
+  /// in order of task id; recv_bytes[i] is send_bytes of task i
+  virtual Result<void> Allgatherv(
+      const void* send, uint64_t send_bytes, void* recv,
+      const uint64_t* recv_bytes) = 0;
+
+  /// Send bytes to every task: send holds send_bytes[i] bytes for task i, in
+  /// order of task id, and recv receives recv_bytes[i] bytes from task i
+  /// likewise. Each task must know what it receives, e.g., from an
+  /// Allgatherv of the sizes first.
+  virtual Result<void> Alltoallv(
+      const void* send, const uint64_t* send_bytes, void* recv,
+      const uint64_t* recv_bytes) = 0;
+
+  /// Allgatherv with bytes bytes from every task
+  Result<void> Allgather(const void* send, uint64_t bytes, void* recv) {
+    std::vector<uint64_t> recv_bytes(Num, bytes);
+    return Allgatherv(send, bytes, recv, recv_bytes.data());
+  }
+
+  /// Allreduce of a single value
+  template <typename T>
+  Result<T> Allreduce(T val, ReduceOp op) {
+    T ret{};
+    if (auto res = Allreduce(&val, &ret, 1, TypeOf<T>(), op); !res) {
+      return res.error();
+    }
+    return ret;
+  }
+
+  // Nonblocking variants of the collective operations. The buffers must stay
+  // valid and untouched until the request is done. The defaults run the
+  // blocking operation before returning; backends with a nonblocking
+  // transport should override them.
+
+  virtual std::unique_ptr<CommRequest> IAllreduce(
+      const void* send, void* recv, uint64_t count, DataType type,
+      ReduceOp op);
+  virtual std::unique_ptr<CommRequest> IAllgatherv(
+      const void* send, uint64_t send_bytes, void* recv,
+      const uint64_t* recv_bytes);
+  virtual std::unique_ptr<CommRequest> IAlltoallv(
+      const void* send, const uint64_t* send_bytes, void* recv,
+      const uint64_t* recv_bytes);
+
+  /// The size of an element of type
+  static uint64_t SizeOf(DataType type);
+
+  template <typename T>
+  static constexpr DataType TypeOf() {
+    if constexpr (std::is_same_v<T, uint8_t>) {
+      return DataType::kUInt8;
+    } else if constexpr (std::is_same_v<T, int32_t>) {
+      return DataType::kInt32;
+    } else if constexpr (std::is_same_v<T, uint32_t>) {
+      return DataType::kUInt32;
+    } else if constexpr (std::is_same_v<T, int64_t>) {
+      return DataType::kInt64;
+    } else if constexpr (std::is_same_v<T, uint64_t>) {
+      return DataType::kUInt64;
+    } else {
+      static_assert(std::is_same_v<T, double>, "unsupported element type");
+      return DataType::kDouble;
+    }
+  }
+
   // TODO(thunt): Num and ID were chosen because of NetworkInterface. Changing
   // them is very disruptive so I'll defer for a time in the future where we're
   // not worried about upstream and can global replace.
@@ -51,6 +157,17 @@ public:
       uint64_t max_size) override {
     return val.substr(0, max_size);
   }
+
+  using CommBackend::Allreduce;
+  Result<void> Allreduce(
+      const void* send, void* recv, uint64_t count, DataType type,
+      ReduceOp op) override;
+  Result<void> Allgatherv(
+      const void* send, uint64_t send_bytes, void* recv,
+      const uint64_t* recv_bytes) override;
+  Result<void> Alltoallv(
+      const void* send, const uint64_t* send_bytes, void* recv,
+      const uint64_t* recv_bytes) override;
 };
 
 }  // namespace katana
@@ -0,0 +1,244 @@
+#ifndef KATANA_LIBSUPPORT_KATANA_CONCURRENTCACHE_H_
+#define KATANA_LIBSUPPORT_KATANA_CONCURRENTCACHE_H_
+
+// A thread-safe variant of katana::Cache. Like Cache, it is intended to store
+// metadata (e.g., a shared_ptr to a property column), not large objects.
+//
+// Keys are hashed into independently locked shards, each with its own LRU
+// list, so lookups and inserts of unrelated keys do not contend. The capacity
+// (entries or bytes) is global: it is tracked with atomics across all shards
+// and, when exceeded, entries are evicted from the LRU tails of the shards in
+// round-robin order. A thread never holds more than one shard lock at a time,
+// which sidesteps the lock ordering problem described in Cache.h.
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "katana/Logging.h"
+
+namespace katana {
+
+template <typename Key, typename Value>
+class KATANA_EXPORT ConcurrentCache {
+  using ListType = std::list<Key>;
+  struct MapValue {
+    Value value;
+    size_t bytes;
+    typename ListType::iterator lru_it;
+  };
+  using MapType = std::unordered_map<Key, MapValue, typename Key::Hash>;
+  enum class ReplacementPolicy { kLRUSize, kLRUBytes };
+
+  struct alignas(64) Shard {
+    std::mutex mutex;
+    MapType key_to_value;
+    ListType lru_list;
+  };
+
+public:
+  static constexpr size_t kDefaultNumShards = 16;
+
+  /// Construct an LRU cache that has a fixed number of entries.
+  ConcurrentCache(
+      size_t capacity,  // number of entries
+      std::function<void(const Key& key)> evict_cb = nullptr,
+      size_t num_shards = kDefaultNumShards)
+      : policy_(ReplacementPolicy::kLRUSize),
+        capacity_(capacity),
+        value_to_bytes_(nullptr),
+        evict_cb_(std::move(evict_cb)) {
+    KATANA_LOG_VASSERT(capacity_ > 0, "cache requires positive capacity");
+    InitShards(num_shards);
+  }
+  /// Construct an LRU cache that holds fixed number of bytes.
+  ConcurrentCache(
+      size_t capacity,  // bytes of entries
+      std::function<size_t(const Value& value)> value_to_bytes,
+      std::function<void(const Key& key)> evict_cb = nullptr,
+      size_t num_shards = kDefaultNumShards)
+      : policy_(ReplacementPolicy::kLRUBytes),
+        capacity_(capacity),
+        value_to_bytes_(std::move(value_to_bytes)),
+        evict_cb_(std::move(evict_cb)) {
+    KATANA_LOG_VASSERT(capacity_ > 0, "cache requires positive capacity");
+    KATANA_LOG_VASSERT(
+        value_to_bytes_ != nullptr,
+        "kLRUBytes policy requires value to bytes function");
+    InitShards(num_shards);
+  }
+
+  ConcurrentCache(const ConcurrentCache&) = delete;
+  ConcurrentCache& operator=(const ConcurrentCache&) = delete;
+
+  /// For kLRUSize the number of entries, for kLRUBytes the byte total. The
+  /// value is a snapshot and may be stale by the time it is returned.
+  size_t size() const {
+    if (policy_ == ReplacementPolicy::kLRUSize) {
+      return num_entries_.load(std::memory_order_relaxed);
+    } else {
+      return total_bytes_.load(std::memory_order_relaxed);
+    }
+  }
+
+  size_t capacity() const { return capacity_; }
+
+  size_t num_shards() const { return shards_.size(); }
+
+  bool Empty() const {
+    return num_entries_.load(std::memory_order_relaxed) == 0;
+  }
+
+  bool Contains(const Key& key) const {
+    Shard& shard = ShardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return shard.key_to_value.find(key) != shard.key_to_value.end();
+  }
+
+  /// Insert or replace the value for \p key and return the number of entries
+  /// evicted to make room for it
+  size_t Insert(const Key& key, const Value& value) {
+    size_t bytes = value_to_bytes_ != nullptr ? value_to_bytes_(value) : 0;
+    Shard& shard = ShardFor(key);
+    {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      auto mapit = shard.key_to_value.find(key);
+      if (mapit == shard.key_to_value.end()) {
+        shard.lru_list.push_front(key);
+        shard.key_to_value.emplace(
+            key, MapValue{value, bytes, shard.lru_list.begin()});
+        num_entries_.fetch_add(1, std::memory_order_relaxed);
+      } else {
+        total_bytes_.fetch_sub(mapit->second.bytes, std::memory_order_relaxed);
+        mapit->second.value = value;
+        mapit->second.bytes = bytes;
+        UpdateLRU(&shard, mapit);
+      }
+      total_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+    }
+    return EvictIfNecessary(key);
+  }
+
+  std::optional<Value> Get(const Key& key) {
+    std::optional<Value> ret;
+    Shard& shard = ShardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.key_to_value.find(key);
+    if (it != shard.key_to_value.end()) {
+      ret = UpdateLRU(&shard, it);
+    }
+    return ret;
+  }
+
+private:
+  void InitShards(size_t num_shards) {
+    KATANA_LOG_VASSERT(num_shards > 0, "cache requires at least one shard");
+    if (policy_ == ReplacementPolicy::kLRUSize) {
+      // More shards than entries only costs memory
+      num_shards = std::min(num_shards, capacity_);
+    }
+    shards_ = std::vector<std::unique_ptr<Shard>>(num_shards);
+    for (auto& shard : shards_) {
+      shard = std::make_unique<Shard>();
+    }
+  }
+
+  Shard& ShardFor(const Key& key) const {
+    return *shards_[typename Key::Hash()(key) % shards_.size()];
+  }
+
+  static Value UpdateLRU(Shard* shard, typename MapType::iterator mapit) {
+    auto lru_it = mapit->second.lru_it;
+    auto lru_head = shard->lru_list.begin();
+    if (lru_it != lru_head) {
+      // move item to the front of the most recently used list
+      shard->lru_list.splice(lru_head, shard->lru_list, lru_it);
+      mapit->second.lru_it = shard->lru_list.begin();
+    }
+    return mapit->second.value;
+  }
+
+  bool OverCapacity() const {
+    switch (policy_) {
+    case ReplacementPolicy::kLRUSize:
+      return size() > capacity_;
+    case ReplacementPolicy::kLRUBytes:
+      // Allow a single entry to exceed our byte capacity
+      return size() > capacity_ &&
+             num_entries_.load(std::memory_order_relaxed) > 1;
+    default:
+      KATANA_LOG_FATAL(
+          "bad cache replacement policy: {}", static_cast<int>(policy_));
+    }
+  }
+
+  /// Evict the least recently used entry of the next non-empty shard in
+  /// round-robin order, never evicting \p keep (the entry just inserted).
+  /// Returns false if there is nothing to evict.
+  bool EvictOne(const Key& keep, std::vector<Key>* evicted) {
+    for (size_t attempt = 0; attempt < shards_.size(); ++attempt) {
+      size_t idx =
+          evict_hand_.fetch_add(1, std::memory_order_relaxed) % shards_.size();
+      Shard& shard = *shards_[idx];
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      if (shard.lru_list.empty() || shard.lru_list.back() == keep) {
+        continue;
+      }
+      if (policy_ == ReplacementPolicy::kLRUBytes &&
+          num_entries_.load(std::memory_order_relaxed) <= 1) {
+        return false;
+      }
+      auto tail = --shard.lru_list.end();
+      auto mapit = shard.key_to_value.find(*tail);
+      KATANA_LOG_ASSERT(mapit != shard.key_to_value.end());
+      total_bytes_.fetch_sub(mapit->second.bytes, std::memory_order_relaxed);
+      num_entries_.fetch_sub(1, std::memory_order_relaxed);
+      shard.key_to_value.erase(mapit);
+      if (evict_cb_) {
+        evicted->emplace_back(std::move(*tail));
+      }
+      shard.lru_list.erase(tail);
+      return true;
+    }
+    return false;
+  }
+
+  size_t EvictIfNecessary(const Key& keep) {
+    KATANA_LOG_DEBUG_ASSERT(
+        policy_ == ReplacementPolicy::kLRUSize || value_to_bytes_ != nullptr);
+    std::vector<Key> evicted;
+    while (OverCapacity()) {
+      if (!EvictOne(keep, &evicted)) {
+        break;
+      }
+    }
+    // Run callbacks without holding any shard lock so that they may call back
+    // into the cache
+    for (const auto& key : evicted) {
+      evict_cb_(key);
+    }
+    return evicted.size();
+  }
+
+  std::vector<std::unique_ptr<Shard>> shards_;
+
+  ReplacementPolicy policy_;
+  // for kLRUSize number of entries kLRUBytes it is byte total
+  size_t capacity_{0};
+  std::atomic<size_t> num_entries_{0};
+  std::atomic<size_t> total_bytes_{0};
+  std::atomic<size_t> evict_hand_{0};
+
+  std::function<size_t(const Value& value)> value_to_bytes_;
+  std::function<void(const Key& key)> evict_cb_;
+};
+
+}  // namespace katana
+
+#endif
@@ -1,7 +1,8 @@
 #pragma once
 
-#include <bitset>
+#include <cstdint>
 #include <optional>
+#include <ostream>
 #include <set>
 #include <string>
 #include <string_view>
@@ -19,15 +20,153 @@ namespace katana {
 /// EntityTypeID uniquely identifies an entity (node or edge) type
 /// EntityTypeID for nodes is distinct from EntityTypeID for edges
 /// This type may either be an atomic type or an intersection of atomic types
-/// EntityTypeID is represented using 8 bits
-using EntityTypeID = uint8_t;
+/// EntityTypeID is represented using 16 bits
+using EntityTypeID = uint16_t;
 static constexpr EntityTypeID kUnknownEntityType = EntityTypeID{0};
 static constexpr std::string_view kUnknownEntityTypeName = "kUnknownName";
 static constexpr EntityTypeID kInvalidEntityType =
     std::numeric_limits<EntityTypeID>::max();
+
 /// A set of EntityTypeIDs
-using SetOfEntityTypeIDs =
-    std::bitset<std::numeric_limits<EntityTypeID>::max() + 1>;
+///
+/// The set is a bitset that only stores the words up to the one holding its
+/// largest ID. A bitset over every EntityTypeID would take 8 KiB, while the
+/// sets kept by an EntityTypeManager rarely need more than a few words.
+class SetOfEntityTypeIDs {
+public:
+  /// \returns true iff \p id is in the set
+  bool test(size_t id) const {
+    size_t word = id / kBitsPerWord;
+    return word < words_.size() &&
+           ((words_[word] >> (id % kBitsPerWord)) & 1) != 0;
+  }
+
+  bool operator[](size_t id) const { return test(id); }
+
+  /// Add \p id to the set
+  void set(size_t id) {
+    size_t word = id / kBitsPerWord;
+    if (word >= words_.size()) {
+      words_.resize(word + 1, 0);
+    }
+    words_[word] |= uint64_t{1} << (id % kBitsPerWord);
+  }
+
+  /// Remove \p id from the set
+  void reset(size_t id) {
+    size_t word = id / kBitsPerWord;
+    if (word < words_.size()) {
+      words_[word] &= ~(uint64_t{1} << (id % kBitsPerWord));
+      Trim();
+    }
+  }
+
+  /// \returns a bound on the IDs in the set: every ID in it is less than
+  /// size()
+  size_t size() const { return words_.size() * kBitsPerWord; }
+
+  /// \returns the number of IDs in the set
+  size_t count() const {
+    size_t num = 0;
+    for (uint64_t word : words_) {
+      num += __builtin_popcountll(word);
+    }
+    return num;
+  }
+
+  /// \returns true iff the set is empty
+  bool none() const { return words_.empty(); }
+
+  /// \returns true iff every ID in this set is also in \p other
+  bool IsSubsetOf(const SetOfEntityTypeIDs& other) const {
+    // The last word of a set is never zero, so a set with more words has an
+    // ID that other does not
+    if (words_.size() > other.words_.size()) {
+      return false;
+    }
+    for (size_t i = 0, n = words_.size(); i < n; ++i) {
+      if ((words_[i] & ~other.words_[i]) != 0) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /// Call \p fn with each ID in the set, in increasing order
+  template <typename F>
+  void ForEach(F fn) const {
+    for (size_t i = 0, n = words_.size(); i < n; ++i) {
+      for (uint64_t word = words_[i]; word != 0; word &= word - 1) {
+        fn(EntityTypeID(i * kBitsPerWord + __builtin_ctzll(word)));
+      }
+    }
+  }
+
+  SetOfEntityTypeIDs& operator&=(const SetOfEntityTypeIDs& other) {
+    if (words_.size() > other.words_.size()) {
+      words_.resize(other.words_.size());
+    }
+    for (size_t i = 0, n = words_.size(); i < n; ++i) {
+      words_[i] &= other.words_[i];
+    }
+    Trim();
+    return *this;
+  }
+
+  SetOfEntityTypeIDs& operator|=(const SetOfEntityTypeIDs& other) {
+    if (words_.size() < other.words_.size()) {
+      words_.resize(other.words_.size(), 0);
+    }
+    for (size_t i = 0, n = other.words_.size(); i < n; ++i) {
+      words_[i] |= other.words_[i];
+    }
+    return *this;
+  }
+
+  friend SetOfEntityTypeIDs operator&(
+      SetOfEntityTypeIDs lhs, const SetOfEntityTypeIDs& rhs) {
+    return lhs &= rhs;
+  }
+
+  friend SetOfEntityTypeIDs operator|(
+      SetOfEntityTypeIDs lhs, const SetOfEntityTypeIDs& rhs) {
+    return lhs |= rhs;
+  }
+
+  friend bool operator==(
+      const SetOfEntityTypeIDs& lhs, const SetOfEntityTypeIDs& rhs) {
+    return lhs.words_ == rhs.words_;
+  }
+
+  friend bool operator!=(
+      const SetOfEntityTypeIDs& lhs, const SetOfEntityTypeIDs& rhs) {
+    return !(lhs == rhs);
+  }
+
+  friend std::ostream& operator<<(
+      std::ostream& os, const SetOfEntityTypeIDs& type_id_set) {
+    os << "{";
+    const char* sep = "";
+    type_id_set.ForEach([&](EntityTypeID id) {
+      os << sep << id;
+      sep = ", ";
+    });
+    return os << "}";
+  }
+
+private:
+  static constexpr size_t kBitsPerWord = 64;
+
+  /// Drop the zero words at the end so that equal sets have equal words
+  void Trim() {
+    while (!words_.empty() && words_.back() == 0) {
+      words_.pop_back();
+    }
+  }
+
+  std::vector<uint64_t> words_;
+};
+
 /// A map from EntityTypeID to a set of EntityTypeIDs
 using EntityTypeIDToSetOfEntityTypeIDsMap = std::vector<SetOfEntityTypeIDs>;
 /// A map from the atomic type name to its EntityTypeID
@@ -43,7 +182,6 @@ using TypeNameSet = std::set<std::string>;
 class KATANA_EXPORT EntityTypeManager {
   // TODO (scober): add iterator over all types
   // TODO (scober): add iterator over all atomic types
-  // TODO (scober): add convenient iteration over SetOfEntityTypeIDs
 public:
   EntityTypeManager() { Init(); }
 
@@ -63,11 +201,10 @@ public:
     size_t num_entity_types = entity_type_id_to_atomic_entity_type_ids_.size();
     atomic_entity_type_id_to_entity_type_ids_.resize(num_entity_types);
     for (size_t i = 0, ni = num_entity_types; i < ni; ++i) {
-      for (size_t j = 0, nj = num_entity_types; j < nj; ++j) {
-        if (entity_type_id_to_atomic_entity_type_ids_[i].test(j)) {
-          atomic_entity_type_id_to_entity_type_ids_[j].set(i);
-        }
-      }
+      entity_type_id_to_atomic_entity_type_ids_[i].ForEach(
+          [&](EntityTypeID j) {
+            atomic_entity_type_id_to_entity_type_ids_.at(j).set(i);
+          });
     }
   }
 
@@ -87,12 +224,17 @@ public:
         atomic_entity_type_id_to_entity_type_ids_(
             std::move(atomic_entity_type_id_to_entity_type_ids)) {}
 
+  /// The most type properties for which rows are processed in parallel
+  static constexpr size_t kMaxMaskedTypes = 64;
+
   /// This function can be used to convert "old style" graphs (storage format 1,
   /// where types are represented by bool or uint8 properties) and "new style"
   /// graphs (version > 2, where types are represented in our native type
-  /// represenation). This function is serial but it likely iterates over
-  /// O(nodes) and O(edges) vectors, so it is very slow. It should only be used
-  /// for updating old graphs.
+  /// represenation). It should only be used for updating old graphs. With up
+  /// to kMaxMaskedTypes type properties, the rows are processed in parallel:
+  /// the type properties of a block of rows are turned into a bitmask per
+  /// row, one column at a time, and the distinct masks are found per thread
+  /// and merged; with more, the rows are processed one by one.
   ///
   /// The length of entity_type_ids should be equal to topo_size.
   /// properties->num_rows() should be equal to the length of entity_type_ids or
@@ -134,29 +276,8 @@ public:
     }
     TypeProperties type_properties = std::move(res.value());
 
-    // assign the type ID for each row
-    for (int64_t row = 0; row < num_rows; ++row) {
-      TypeProperties::FieldEntity field_indices;
-      for (auto& bool_property : type_properties.bool_properties) {
-        if (bool_property.array->IsValid(row) &&
-            bool_property.array->Value(row)) {
-          field_indices.emplace_back(bool_property.field_index);
-        }
-      }
-      for (auto& uint8_property : type_properties.uint8_properties) {
-        if (uint8_property.array->IsValid(row) &&
-            uint8_property.array->Value(row)) {
-          field_indices.emplace_back(uint8_property.field_index);
-        }
-      }
-      if (field_indices.empty()) {
-        entity_type_ids->at(row) = katana::kUnknownEntityType;
-      } else {
-        katana::EntityTypeID entity_type_id =
-            type_properties.type_field_indices_to_id.at(field_indices);
-        entity_type_ids->at(row) = entity_type_id;
-      }
-    }
+    DoAssignEntityTypeIDsToRows(
+        type_properties, num_rows, entity_type_ids->data());
 
     return ResultSuccess();
   }
@@ -298,7 +419,7 @@ public:
           return KATANA_ERROR(
               ErrorCode::InvalidArgument, "duplicate name: {}", name);
         }
-        res[id] = true;
+        res.set(id);
       } else {
         return KATANA_ERROR(
             ErrorCode::NotFound, "type {} does not exist", name);
@@ -326,7 +447,7 @@ public:
         return KATANA_ERROR(
             ErrorCode::InvalidArgument, "duplicate name: {}", name);
       }
-      res[id] = true;
+      res.set(id);
     }
     return MakeResult(std::move(res));
   }
@@ -370,11 +491,17 @@ public:
   /// \returns true iff the type \p sub_type is a
   /// sub-type of the type \p super_type
   /// (assumes that the sub_type and super_type EntityTypeIDs exists)
+  ///
+  /// When \p sub_type is atomic, as in DoesNodeHaveType with an atomic type,
+  /// this tests one bit of the supertypes of \p sub_type, which stay in cache
+  /// when many entities are tested for the same type.
   bool IsSubtypeOf(EntityTypeID sub_type, EntityTypeID super_type) const {
-    const auto& super_atomic_types = GetAtomicSubtypes(super_type);
     const auto& sub_atomic_types = GetAtomicSubtypes(sub_type);
-    // return true if sub_atomic_types is a subset of super_atomic_types
-    return (sub_atomic_types & super_atomic_types) == sub_atomic_types;
+    // only an atomic type intersects itself
+    if (sub_atomic_types.test(sub_type)) {
+      return GetSupertypes(sub_type).test(super_type);
+    }
+    return sub_atomic_types.IsSubsetOf(GetAtomicSubtypes(super_type));
   }
 
   const EntityTypeIDToSetOfEntityTypeIDsMap&
@@ -410,12 +537,32 @@ private:
     std::vector<PropertyColumn<arrow::UInt8Array>> uint8_properties;
     using FieldEntity = std::vector<int>;
     std::map<FieldEntity, katana::EntityTypeID> type_field_indices_to_id;
+    // Whether rows are described by masks: bit i is set if the i-th type
+    // property, bool ones first, is set
+    bool use_masks{false};
+    // The ID of every mask in the rows
+    std::unordered_map<uint64_t, katana::EntityTypeID> mask_to_id;
   };
 
   static Result<TypeProperties> DoAssignEntityTypeIDsFromProperties(
       const std::shared_ptr<arrow::Table>& properties,
       EntityTypeManager* entity_type_manager);
 
+  static void DoAssignEntityTypeIDsToRows(
+      const TypeProperties& type_properties, int64_t num_rows,
+      EntityTypeID* entity_type_ids);
+
+  /// The masks of rows [begin, end)
+  static void ComputeTypeMasks(
+      const TypeProperties& type_properties, int64_t begin, int64_t end,
+      uint64_t* masks);
+
+  static TypeProperties::FieldEntity FieldEntityOfMask(
+      const TypeProperties& type_properties, uint64_t mask);
+
+  static TypeProperties::FieldEntity FieldEntityOfRow(
+      const TypeProperties& type_properties, int64_t row);
+
   void Init() {
     // assume kUnknownEntityType is 0
     static_assert(kUnknownEntityType == 0);
@@ -66,6 +66,8 @@ enum class ErrorCode {
   AssertionFailed = 12,
   GraphUpdateFailed = 13,
   FeatureNotEnabled = 14,
+  OutOfMemory = 15,
+  Cancelled = 16,
 };
 
 }  // namespace katana
@@ -108,6 +110,10 @@ public:
       return "graph update failed";
     case ErrorCode::FeatureNotEnabled:
       return "not built with this feature";
+    case ErrorCode::OutOfMemory:
+      return "memory budget exceeded";
+    case ErrorCode::Cancelled:
+      return "cancelled";
     default:
       return "unknown error";
     }
@@ -134,6 +140,10 @@ public:
       return make_error_condition(std::errc::no_such_file_or_directory);
     case ErrorCode::HTTPError:
       return make_error_condition(std::errc::io_error);
+    case ErrorCode::OutOfMemory:
+      return make_error_condition(std::errc::not_enough_memory);
+    case ErrorCode::Cancelled:
+      return make_error_condition(std::errc::operation_canceled);
     default:
       return std::error_condition(c, *this);
     }
@@ -0,0 +1,122 @@
+#ifndef KATANA_LIBSUPPORT_KATANA_EVENTRECORDER_H_
+#define KATANA_LIBSUPPORT_KATANA_EVENTRECORDER_H_
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// EventRecorder keeps the most recent timestamped events of each thread,
+/// e.g., the start and end of its part of a parallel loop, barrier waits,
+/// samples of worklist traffic and storage reads and writes, so that the
+/// timeline leading up to a slow moment of a long run can be looked at after
+/// the fact.
+///
+/// Each thread appends to a ring buffer of its own without locks or
+/// allocation, so recording is cheap enough to leave on. The size of the
+/// rings, in events, is set with KATANA_EVENT_RING_SIZE; 0 turns recording
+/// off. The rings are written out as Chrome trace JSON or as a Perfetto
+/// trace on demand: by calling Dump, at exit if KATANA_EVENT_TRACE names a
+/// file, or, with KATANA_EVENT_TRACE set, on SIGUSR2 once the current
+/// parallel region ends.
+class KATANA_EXPORT EventRecorder {
+public:
+  enum Category : uint8_t {
+    kLoop,
+    kBarrier,
+    kWorklist,
+    kStorage,
+    kNumCategories,
+  };
+
+  /// Begin and End events on a thread nest; Counter events are samples of a
+  /// running total
+  enum Phase : uint8_t {
+    kBegin,
+    kEnd,
+    kInstant,
+    kCounter,
+  };
+
+  /// Names are copied into events and cut to this length
+  static constexpr size_t kMaxNameSize = 23;
+
+  struct Event {
+    uint64_t ts_ns;
+    uint64_t value;
+    uint32_t tid;
+    Category category;
+    Phase phase;
+    char name[kMaxNameSize + 1];
+  };
+
+  static bool IsEnabled() { return enabled_; }
+
+  static void Record(
+      Category category, Phase phase, const char* name, uint64_t value = 0) {
+    if (enabled_) {
+      RecordSlow(category, phase, name, value);
+    }
+  }
+
+  static const char* CategoryName(Category category);
+
+  /// Write the recorded events of all threads as Chrome trace event JSON,
+  /// which chrome://tracing and ui.perfetto.dev open
+  static void WriteChromeTrace(std::ostream& out);
+
+  /// Write the recorded events of all threads as a Perfetto trace protobuf
+  static void WritePerfettoTrace(std::ostream& out);
+
+  /// Write the recorded events to \p path, as Chrome trace JSON if it ends
+  /// in .json and as a Perfetto trace otherwise
+  static Result<void> Dump(const std::string& path);
+
+  /// If KATANA_EVENT_TRACE is set, dump to it on SIGUSR2
+  static void InstallDumpSignal();
+
+  /// Dump to KATANA_EVENT_TRACE if SIGUSR2 arrived since the last dump. Only
+  /// call this outside of parallel regions.
+  static void DumpIfRequested();
+
+  /// Dump to KATANA_EVENT_TRACE, if it is set
+  static void DumpAtExit();
+
+private:
+  static void RecordSlow(
+      Category category, Phase phase, const char* name, uint64_t value);
+
+  static bool enabled_;
+};
+
+/// Records a Begin event when constructed and the matching End event when
+/// destroyed
+class [[nodiscard]] EventScope {
+public:
+  EventScope(
+      EventRecorder::Category category, const char* name, uint64_t value = 0)
+      : category_(category), name_(name) {
+    EventRecorder::Record(category_, EventRecorder::kBegin, name_, value);
+  }
+
+  ~EventScope() {
+    EventRecorder::Record(category_, EventRecorder::kEnd, name_);
+  }
+
+  EventScope(const EventScope&) = delete;
+  EventScope(EventScope&&) = delete;
+  EventScope& operator=(const EventScope&) = delete;
+  EventScope& operator=(EventScope&&) = delete;
+
+private:
+  EventRecorder::Category category_;
+  const char* name_;
+};
+
+}  // namespace katana
+
+#endif
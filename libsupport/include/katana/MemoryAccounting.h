@@ -0,0 +1,134 @@
+#ifndef KATANA_LIBSUPPORT_KATANA_MEMORYACCOUNTING_H_
+#define KATANA_LIBSUPPORT_KATANA_MEMORYACCOUNTING_H_
+
+#include <cstdint>
+#include <string>
+
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// The subsystems that large allocations are attributed to
+enum class MemoryCategory : uint8_t {
+  /// The topology of loaded graphs
+  kTopology,
+  /// Topologies derived from a loaded graph, e.g., those in the PGViewCache
+  kViews,
+  /// The Arrow buffers of loaded node and edge properties
+  kProperties,
+  /// Property indexes
+  kIndexes,
+  /// Pages of the page pool, which back worklists and per-thread allocators
+  kWorklists,
+  /// Everything else, e.g., the NUMAArrays of an algorithm
+  kScratch,
+  kNumCategories,
+};
+
+KATANA_EXPORT const char* MemoryCategoryName(MemoryCategory category);
+
+/// MemoryAccounting keeps the current and the peak number of bytes charged to
+/// each MemoryCategory, so that when memory runs short there is a record of
+/// what grew.
+///
+/// Optionally, the total across categories can be held to a budget, which
+/// is set with set_budget or, in megabytes, with KATANA_MEMORY_BUDGET_MB.
+/// Charges that would go over the budget fail with ErrorCode::OutOfMemory
+/// instead of being made.
+class KATANA_EXPORT MemoryAccounting {
+public:
+  /// Charge \p bytes to \p category, or fail without charging anything if
+  /// that would go over the budget
+  static Result<void> Charge(MemoryCategory category, uint64_t bytes);
+
+  /// Charge \p bytes to \p category for callers that cannot fail; going over
+  /// the budget is fatal, and the message says what is using the memory
+  static void ChargeOrDie(MemoryCategory category, uint64_t bytes);
+
+  /// Charge \p bytes to \p category even if that goes over the budget
+  static void ForceCharge(MemoryCategory category, uint64_t bytes);
+
+  static void Release(MemoryCategory category, uint64_t bytes);
+
+  static uint64_t current(MemoryCategory category);
+  static uint64_t peak(MemoryCategory category);
+
+  /// The bytes currently charged to all categories
+  static uint64_t total();
+
+  /// The most bytes that may be charged to all categories together; 0 means
+  /// there is no budget
+  static uint64_t budget();
+  static void set_budget(uint64_t bytes);
+
+  /// Set the peak of each category to its current value
+  static void ResetPeaks();
+
+  /// A one line description of the current and peak bytes of each category
+  static std::string Summary();
+};
+
+/// MemoryCharge holds a charge to a category for as long as it lives, e.g.,
+/// for the memory of an object that grows and shrinks
+class KATANA_EXPORT MemoryCharge {
+public:
+  MemoryCharge() = default;
+  explicit MemoryCharge(MemoryCategory category) : category_(category) {}
+  ~MemoryCharge() { ForceResize(0); }
+
+  MemoryCharge(MemoryCharge&& other) noexcept
+      : category_(other.category_), bytes_(other.bytes_) {
+    other.bytes_ = 0;
+  }
+
+  MemoryCharge& operator=(MemoryCharge&& other) noexcept {
+    if (this != &other) {
+      ForceResize(0);
+      category_ = other.category_;
+      bytes_ = other.bytes_;
+      other.bytes_ = 0;
+    }
+    return *this;
+  }
+
+  MemoryCharge(const MemoryCharge&) = delete;
+  MemoryCharge& operator=(const MemoryCharge&) = delete;
+
+  /// Change the charge to \p bytes, or fail and keep the current charge if
+  /// growing would go over the budget
+  Result<void> Resize(uint64_t bytes);
+
+  /// Change the charge to \p bytes even if that goes over the budget
+  void ForceResize(uint64_t bytes);
+
+  MemoryCategory category() const { return category_; }
+  uint64_t bytes() const { return bytes_; }
+
+private:
+  MemoryCategory category_{MemoryCategory::kScratch};
+  uint64_t bytes_{0};
+};
+
+/// The category that allocators which are not told otherwise, like
+/// largeMalloc and so NUMAArray, charge on this thread
+KATANA_EXPORT MemoryCategory CurrentMemoryCategory();
+
+/// Sets the CurrentMemoryCategory of this thread for as long as it lives
+class [[nodiscard]] KATANA_EXPORT MemoryCategoryScope {
+public:
+  explicit MemoryCategoryScope(MemoryCategory category);
+  ~MemoryCategoryScope();
+
+  MemoryCategoryScope(const MemoryCategoryScope&) = delete;
+  MemoryCategoryScope(MemoryCategoryScope&&) = delete;
+  MemoryCategoryScope& operator=(const MemoryCategoryScope&) = delete;
+  MemoryCategoryScope& operator=(MemoryCategoryScope&&) = delete;
+
+private:
+  MemoryCategory previous_;
+};
+
+}  // namespace katana
+
+#endif
@@ -1,10 +1,17 @@
 #include "katana/ArrowInterchange.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <iostream>
 #include <iterator>
 #include <sstream>
+#include <thread>
+#include <vector>
 
+#include <arrow/array.h>
 #include <arrow/array/concatenate.h>
+#include <arrow/compute/api_vector.h>
 
 #include "katana/Random.h"
 
@@ -46,6 +53,230 @@ ApproxArrayDataMemUse(const std::shared_ptr<arrow::ArrayData>& data) {
   return total_mem_use;
 }
 
+/// Two independent multiply-rotate lanes over 8-byte words, finished with
+/// the splitmix64 finalizer
+class Digest {
+public:
+  void Update(const void* data, uint64_t size) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    uint64_t i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+      uint64_t word;
+      std::memcpy(&word, bytes + i, sizeof(word));
+      Mix(word);
+    }
+    uint64_t tail = 0;
+    std::memcpy(&tail, bytes + i, size - i);
+    Mix(tail);
+    Mix(size);
+  }
+
+  void Update(uint64_t val) { Mix(val); }
+
+  /// Mix in the result of another digest
+  void Update(const Digest& other) {
+    Mix(Finalize(other.a_));
+    Mix(Finalize(other.b_));
+  }
+
+  /// Digest bytes that arrive in pieces; the result depends only on their
+  /// concatenation. Finish the sequence with EndAppend.
+  void Append(const void* data, uint64_t size) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    appended_ += size;
+    if (pending_size_ > 0) {
+      uint64_t fill =
+          std::min<uint64_t>(size, sizeof(pending_) - pending_size_);
+      std::memcpy(pending_ + pending_size_, bytes, fill);
+      pending_size_ += fill;
+      bytes += fill;
+      size -= fill;
+      if (pending_size_ < sizeof(pending_)) {
+        return;
+      }
+      MixPending();
+    }
+    for (; size >= sizeof(uint64_t); size -= sizeof(uint64_t)) {
+      uint64_t word;
+      std::memcpy(&word, bytes, sizeof(word));
+      Mix(word);
+      bytes += sizeof(word);
+    }
+    std::memcpy(pending_, bytes, size);
+    pending_size_ = size;
+  }
+
+  void EndAppend() {
+    if (pending_size_ > 0) {
+      std::memset(
+          pending_ + pending_size_, 0, sizeof(pending_) - pending_size_);
+      MixPending();
+    }
+    Mix(appended_);
+    appended_ = 0;
+  }
+
+  std::string Hex() const {
+    return fmt::format("{:016x}{:016x}", Finalize(a_), Finalize(b_));
+  }
+
+private:
+  static uint64_t Rotl(uint64_t val, int shift) {
+    return (val << shift) | (val >> (64 - shift));
+  }
+
+  static uint64_t Finalize(uint64_t val) {
+    val ^= val >> 30;
+    val *= UINT64_C(0xbf58476d1ce4e5b9);
+    val ^= val >> 27;
+    val *= UINT64_C(0x94d049bb133111eb);
+    val ^= val >> 31;
+    return val;
+  }
+
+  void Mix(uint64_t word) {
+    a_ = Rotl(a_ ^ (word * UINT64_C(0x87c37b91114253d5)), 31) *
+         UINT64_C(0x9e3779b97f4a7c15);
+    b_ = Rotl(b_ + (word * UINT64_C(0x4cf5ad432745937f)), 27) *
+             UINT64_C(0xc2b2ae3d27d4eb4f) +
+         a_;
+  }
+
+  void MixPending() {
+    uint64_t word;
+    std::memcpy(&word, pending_, sizeof(word));
+    Mix(word);
+    pending_size_ = 0;
+  }
+
+  uint64_t a_{UINT64_C(0x243f6a8885a308d3)};
+  uint64_t b_{UINT64_C(0x13198a2e03707344)};
+  uint8_t pending_[sizeof(uint64_t)]{};
+  uint64_t pending_size_{0};
+  uint64_t appended_{0};
+};
+
+/// Rows of fixed-width arrays are digested in blocks of about this many
+/// bytes, independently and in parallel
+constexpr int64_t kDigestBlockBytes = int64_t{1} << 22;
+
+/// Run fn(i) for each i in [0, n) on up to num_threads threads, the calling
+/// thread among them. This is libsupport, below the Galois runtime, so it
+/// cannot use the thread pool; callers pass the number of threads they are
+/// allowed instead.
+template <typename F>
+void
+ParallelForEach(int64_t n, unsigned num_threads_allowed, const F& fn) {
+  auto num_threads = std::min<int64_t>(std::max(1U, num_threads_allowed), n);
+  std::atomic<int64_t> next{0};
+  auto work = [&]() {
+    for (int64_t i = next.fetch_add(1); i < n; i = next.fetch_add(1)) {
+      fn(i);
+    }
+  };
+  std::vector<std::thread> threads;
+  for (int64_t t = 1; t < num_threads; ++t) {
+    threads.emplace_back(work);
+  }
+  work();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+/// The width in bytes of the values of array if they are byte-aligned fixed
+/// width values without nulls, whose digest depends only on the values, or 0
+int64_t
+FlatValueWidth(const arrow::ChunkedArray& array) {
+  const auto* fixed_width =
+      dynamic_cast<const arrow::FixedWidthType*>(array.type().get());
+  if (fixed_width == nullptr || fixed_width->bit_width() % 8 != 0 ||
+      array.type()->id() == arrow::Type::DICTIONARY ||
+      array.null_count() != 0) {
+    return 0;
+  }
+  for (const auto& chunk : array.chunks()) {
+    if (!chunk->data()->child_data.empty() || chunk->data()->dictionary) {
+      return 0;
+    }
+  }
+  return fixed_width->bit_width() / 8;
+}
+
+/// Digest the values of a FlatValueWidth array in blocks of rows, which may
+/// span chunks, so that the digest does not depend on the chunking
+void
+DigestFlatValues(
+    const arrow::ChunkedArray& array, int64_t width, unsigned num_threads,
+    Digest* digest) {
+  std::vector<int64_t> chunk_begin{0};
+  for (const auto& chunk : array.chunks()) {
+    chunk_begin.emplace_back(chunk_begin.back() + chunk->length());
+  }
+  const int64_t num_rows = array.length();
+  const int64_t block_rows = std::max<int64_t>(1, kDigestBlockBytes / width);
+  const int64_t num_blocks = (num_rows + block_rows - 1) / block_rows;
+
+  std::vector<Digest> blocks(num_blocks);
+  ParallelForEach(num_blocks, num_threads, [&](int64_t block) {
+    int64_t begin = block * block_rows;
+    int64_t end = std::min(num_rows, begin + block_rows);
+    auto c = std::upper_bound(chunk_begin.begin(), chunk_begin.end(), begin) -
+             chunk_begin.begin() - 1;
+    for (; begin < end; ++c) {
+      const arrow::ArrayData& data = *array.chunk(c)->data();
+      int64_t row = begin - chunk_begin[c];
+      int64_t rows = std::min(end, chunk_begin[c + 1]) - begin;
+      if (rows > 0) {
+        blocks[block].Append(
+            data.buffers[1]->data() + (data.offset + row) * width,
+            rows * width);
+      }
+      begin += rows;
+    }
+    blocks[block].EndAppend();
+  });
+
+  for (const auto& block : blocks) {
+    digest->Update(block);
+  }
+}
+
+void
+DigestArrayData(const arrow::ArrayData& data, Digest* digest) {
+  digest->Update(data.length);
+  digest->Update(data.GetNullCount());
+
+  const auto* fixed_width =
+      dynamic_cast<const arrow::FixedWidthType*>(data.type.get());
+  if (fixed_width != nullptr && fixed_width->bit_width() % 8 == 0 &&
+      data.GetNullCount() == 0 && data.child_data.empty() &&
+      !data.dictionary) {
+    // Common case: only the visible values matter, not how they are sliced
+    if (data.length > 0) {
+      uint64_t width = fixed_width->bit_width() / 8;
+      digest->Update(
+          data.buffers[1]->data() + data.offset * width, data.length * width);
+    }
+    return;
+  }
+
+  digest->Update(data.offset);
+  for (const auto& buffer : data.buffers) {
+    if (!buffer) {
+      digest->Update(uint64_t{0});
+      continue;
+    }
+    digest->Update(buffer->data(), buffer->size());
+  }
+  for (const auto& child_data : data.child_data) {
+    DigestArrayData(*child_data, digest);
+  }
+  if (data.dictionary) {
+    DigestArrayData(*data.dictionary, digest);
+  }
+}
+
 }  // anonymous namespace
 
 std::shared_ptr<arrow::ChunkedArray>
@@ -61,6 +292,79 @@ katana::NullChunkedArray(
   return std::make_shared<arrow::ChunkedArray>(chunks);
 }
 
+katana::Result<std::shared_ptr<arrow::Array>>
+katana::CombinedArray(const std::shared_ptr<arrow::ChunkedArray>& array) {
+  if (array->num_chunks() == 1) {
+    return array->chunk(0);
+  }
+  if (array->num_chunks() == 0) {
+    return KATANA_CHECKED(arrow::MakeArrayOfNull(array->type(), 0));
+  }
+  if (array->type()->id() == arrow::Type::DICTIONARY) {
+    // Concatenate requires chunks to share their dictionary
+    return UnifiedDictionaryArray(array);
+  }
+  return KATANA_CHECKED(arrow::Concatenate(array->chunks()));
+}
+
+katana::Result<std::shared_ptr<arrow::Array>>
+katana::UnifiedDictionaryArray(
+    const std::shared_ptr<arrow::ChunkedArray>& array) {
+  const auto& type = static_cast<const arrow::DictionaryType&>(*array->type());
+  auto unifier =
+      KATANA_CHECKED(arrow::DictionaryUnifier::Make(type.value_type()));
+  std::vector<std::shared_ptr<arrow::Buffer>> transposes;
+  for (const auto& chunk : array->chunks()) {
+    const auto& dict_chunk = static_cast<const arrow::DictionaryArray&>(*chunk);
+    std::shared_ptr<arrow::Buffer> transpose;
+    KATANA_CHECKED(unifier->Unify(*dict_chunk.dictionary(), &transpose));
+    transposes.emplace_back(std::move(transpose));
+  }
+  std::shared_ptr<arrow::DataType> unified_type;
+  std::shared_ptr<arrow::Array> dictionary;
+  KATANA_CHECKED(unifier->GetResult(&unified_type, &dictionary));
+
+  // Keep the width of the codes unless the values of all chunks need more
+  auto bit_width = [](const std::shared_ptr<arrow::DataType>& t) {
+    return static_cast<const arrow::FixedWidthType&>(*t).bit_width();
+  };
+  std::shared_ptr<arrow::DataType> index_type = type.index_type();
+  const auto& unified_index_type =
+      static_cast<const arrow::DictionaryType&>(*unified_type).index_type();
+  if (bit_width(unified_index_type) > bit_width(index_type)) {
+    index_type = unified_index_type;
+  }
+  auto out_type =
+      arrow::dictionary(index_type, type.value_type(), type.ordered());
+
+  std::vector<std::shared_ptr<arrow::Array>> chunks;
+  for (int i = 0, n = array->num_chunks(); i < n; ++i) {
+    const auto& dict_chunk =
+        static_cast<const arrow::DictionaryArray&>(*array->chunk(i));
+    chunks.emplace_back(KATANA_CHECKED(dict_chunk.Transpose(
+        out_type, dictionary, transposes[i]->data_as<int32_t>())));
+  }
+  if (chunks.empty()) {
+    return KATANA_CHECKED(arrow::MakeArrayOfNull(out_type, 0));
+  }
+  if (chunks.size() == 1) {
+    return chunks[0];
+  }
+  return KATANA_CHECKED(arrow::Concatenate(chunks));
+}
+
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+katana::DictionaryEncode(const std::shared_ptr<arrow::ChunkedArray>& array) {
+  if (array->type()->id() == arrow::Type::DICTIONARY) {
+    return array;
+  }
+  arrow::Datum encoded =
+      KATANA_CHECKED(arrow::compute::DictionaryEncode(arrow::Datum(array)));
+  std::shared_ptr<arrow::Array> unified =
+      KATANA_CHECKED(UnifiedDictionaryArray(encoded.chunked_array()));
+  return std::make_shared<arrow::ChunkedArray>(unified);
+}
+
 void
 katana::DiffFormatTo(
     fmt::memory_buffer& buf, const std::shared_ptr<arrow::ChunkedArray>& a0,
@@ -129,3 +433,38 @@ katana::ApproxTableMemUse(const std::shared_ptr<arrow::Table>& table) {
   }
   return total_mem_use;
 }
+
+std::string
+katana::ContentDigest(
+    const std::shared_ptr<arrow::ChunkedArray>& array, unsigned num_threads) {
+  Digest digest;
+  std::string type = array->type()->ToString();
+  digest.Update(type.data(), type.size());
+  digest.Update(static_cast<uint64_t>(array->length()));
+
+  if (int64_t width = FlatValueWidth(*array); width > 0) {
+    DigestFlatValues(*array, width, num_threads, &digest);
+    return std::string(kContentDigestVersion) + digest.Hex();
+  }
+
+  std::vector<Digest> chunks(array->num_chunks());
+  ParallelForEach(array->num_chunks(), num_threads, [&](int64_t i) {
+    DigestArrayData(*array->chunk(i)->data(), &chunks[i]);
+  });
+  for (const auto& chunk : chunks) {
+    digest.Update(chunk);
+  }
+  return std::string(kContentDigestVersion) + digest.Hex();
+}
+
+bool
+katana::IsCurrentContentDigest(const std::string& digest) {
+  return digest.compare(
+             0, kContentDigestVersion.size(), kContentDigestVersion) == 0;
+}
+
+bool
+katana::IsContentDigestCanonical(
+    const std::shared_ptr<arrow::ChunkedArray>& array) {
+  return FlatValueWidth(*array) > 0;
+}
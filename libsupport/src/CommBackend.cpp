@@ -1,8 +1,86 @@
 #include "katana/CommBackend.h"
 
+#include <cstring>
+
+#include "katana/ErrorCode.h"
+
 // Anchor vtables
 
+katana::CommRequest::~CommRequest() = default;
+
 katana::CommBackend::~CommBackend() = default;
 
+uint64_t
+katana::CommBackend::SizeOf(DataType type) {
+  switch (type) {
+  case DataType::kUInt8:
+    return sizeof(uint8_t);
+  case DataType::kInt32:
+    return sizeof(int32_t);
+  case DataType::kUInt32:
+    return sizeof(uint32_t);
+  case DataType::kInt64:
+    return sizeof(int64_t);
+  case DataType::kUInt64:
+    return sizeof(uint64_t);
+  case DataType::kDouble:
+    return sizeof(double);
+  }
+  KATANA_LOG_FATAL("unknown data type: {}", static_cast<int>(type));
+}
+
+std::unique_ptr<katana::CommRequest>
+katana::CommBackend::IAllreduce(
+    const void* send, void* recv, uint64_t count, DataType type,
+    ReduceOp op) {
+  return std::make_unique<CompletedCommRequest>(
+      Allreduce(send, recv, count, type, op));
+}
+
+std::unique_ptr<katana::CommRequest>
+katana::CommBackend::IAllgatherv(
+    const void* send, uint64_t send_bytes, void* recv,
+    const uint64_t* recv_bytes) {
+  return std::make_unique<CompletedCommRequest>(
+      Allgatherv(send, send_bytes, recv, recv_bytes));
+}
+
+std::unique_ptr<katana::CommRequest>
+katana::CommBackend::IAlltoallv(
+    const void* send, const uint64_t* send_bytes, void* recv,
+    const uint64_t* recv_bytes) {
+  return std::make_unique<CompletedCommRequest>(
+      Alltoallv(send, send_bytes, recv, recv_bytes));
+}
+
 void
 katana::NullCommBackend::NotifyFailure() {}
+
+katana::Result<void>
+katana::NullCommBackend::Allreduce(
+    const void* send, void* recv, uint64_t count, DataType type,
+    [[maybe_unused]] ReduceOp op) {
+  // The only task's values are the result
+  std::memmove(recv, send, count * SizeOf(type));
+  return ResultSuccess();
+}
+
+katana::Result<void>
+katana::NullCommBackend::Allgatherv(
+    const void* send, uint64_t send_bytes, void* recv,
+    const uint64_t* recv_bytes) {
+  if (recv_bytes[0] != send_bytes) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "sending {} bytes but receiving {}",
+        send_bytes, recv_bytes[0]);
+  }
+  std::memmove(recv, send, send_bytes);
+  return ResultSuccess();
+}
+
+katana::Result<void>
+katana::NullCommBackend::Alltoallv(
+    const void* send, const uint64_t* send_bytes, void* recv,
+    const uint64_t* recv_bytes) {
+  return Allgatherv(send, send_bytes[0], recv, recv_bytes);
+}
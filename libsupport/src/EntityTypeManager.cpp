@@ -1,5 +1,108 @@
 #include "katana/EntityTypeManager.h"
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <unordered_set>
+
+#include <arrow/util/bit_util.h>
+
+namespace {
+
+using Mask = uint64_t;
+
+/// Rows are handed out to threads in blocks of this many, and the type masks
+/// of a block are computed column by column
+constexpr int64_t kRowBlockSize = int64_t{1} << 14;
+
+/// Run fn(thread, begin, end) over blocks of [0, num_rows) on all hardware
+/// threads. This is libsupport, below the Galois runtime, so it spawns its
+/// own threads, as tsuba does for its loads.
+template <typename F>
+void
+ParallelForRowBlocks(int64_t num_rows, const F& fn) {
+  int64_t num_blocks = (num_rows + kRowBlockSize - 1) / kRowBlockSize;
+  auto num_threads = static_cast<int64_t>(
+      std::min<int64_t>(std::max(1U, std::thread::hardware_concurrency()),
+                        num_blocks));
+  std::atomic<int64_t> next_block{0};
+  auto work = [&](int64_t thread) {
+    for (int64_t block = next_block.fetch_add(1); block < num_blocks;
+         block = next_block.fetch_add(1)) {
+      int64_t begin = block * kRowBlockSize;
+      fn(thread, begin, std::min(num_rows, begin + kRowBlockSize));
+    }
+  };
+  std::vector<std::thread> threads;
+  for (int64_t t = 1; t < num_threads; ++t) {
+    threads.emplace_back(work, t);
+  }
+  work(0);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+}  // namespace
+
+void
+katana::EntityTypeManager::ComputeTypeMasks(
+    const TypeProperties& type_properties, int64_t begin, int64_t end,
+    uint64_t* masks) {
+  std::fill(masks, masks + (end - begin), Mask{0});
+  int bit = 0;
+  // One pass per column, so the inner loops run over contiguous values
+  for (const auto& property : type_properties.bool_properties) {
+    const arrow::BooleanArray& array = *property.array;
+    const uint8_t* values = array.values()->data();
+    const uint8_t* valid = array.null_bitmap_data();
+    int64_t offset = array.offset();
+    for (int64_t row = begin; row < end; ++row) {
+      bool set = arrow::bit_util::GetBit(values, offset + row) &&
+                 (valid == nullptr ||
+                  arrow::bit_util::GetBit(valid, offset + row));
+      masks[row - begin] |= Mask{set} << bit;
+    }
+    ++bit;
+  }
+  for (const auto& property : type_properties.uint8_properties) {
+    const arrow::UInt8Array& array = *property.array;
+    const uint8_t* values = array.raw_values();
+    const uint8_t* valid = array.null_bitmap_data();
+    int64_t offset = array.offset();
+    if (valid == nullptr) {
+      for (int64_t row = begin; row < end; ++row) {
+        masks[row - begin] |= Mask{values[row] != 0} << bit;
+      }
+    } else {
+      for (int64_t row = begin; row < end; ++row) {
+        bool set = values[row] != 0 &&
+                   arrow::bit_util::GetBit(valid, offset + row);
+        masks[row - begin] |= Mask{set} << bit;
+      }
+    }
+    ++bit;
+  }
+}
+
+katana::EntityTypeManager::TypeProperties::FieldEntity
+katana::EntityTypeManager::FieldEntityOfMask(
+    const TypeProperties& type_properties, uint64_t mask) {
+  TypeProperties::FieldEntity field_indices;
+  int bit = 0;
+  for (const auto& property : type_properties.bool_properties) {
+    if (mask & (Mask{1} << bit++)) {
+      field_indices.emplace_back(property.field_index);
+    }
+  }
+  for (const auto& property : type_properties.uint8_properties) {
+    if (mask & (Mask{1} << bit++)) {
+      field_indices.emplace_back(property.field_index);
+    }
+  }
+  return field_indices;
+}
+
 katana::Result<katana::EntityTypeManager::TypeProperties>
 katana::EntityTypeManager::DoAssignEntityTypeIDsFromProperties(
     const std::shared_ptr<arrow::Table>& properties,
@@ -43,7 +146,7 @@ katana::EntityTypeManager::DoAssignEntityTypeIDsFromProperties(
 
   // assign a new ID to each type
   // NB: cannot use unordered_map without defining a hash function for vectors;
-  // performance is not affected here because the map is very small (<=256)
+  // performance is not affected here because the map is small
   for (int i : type_field_indices) {
     const std::shared_ptr<arrow::Field>& current_field = schema->field(i);
     const std::string& field_name = current_field->name();
@@ -56,26 +159,48 @@ katana::EntityTypeManager::DoAssignEntityTypeIDsFromProperties(
   }
 
   // NB: cannot use unordered_set without defining a hash function for vectors;
-  // performance is not affected here because the set is very small (<=256)
+  // performance is not affected here because the set is small
   using FieldEntityTypeSet = std::set<TypeProperties::FieldEntity>;
   FieldEntityTypeSet type_combinations;
-  for (int64_t row = 0, num_rows = properties->num_rows(); row < num_rows;
-       ++row) {
-    TypeProperties::FieldEntity field_indices;
-    for (auto bool_property : type_properties.bool_properties) {
-      if (bool_property.array->IsValid(row) &&
-          bool_property.array->Value(row)) {
-        field_indices.emplace_back(bool_property.field_index);
+  int64_t num_rows = properties->num_rows();
+  type_properties.use_masks = type_field_indices.size() <= kMaxMaskedTypes;
+  if (type_properties.use_masks) {
+    // Every thread collects the distinct masks of its rows; the merged set
+    // is small, so turning it into combinations is serial
+    std::vector<std::unordered_set<Mask>> thread_masks(
+        std::max(1U, std::thread::hardware_concurrency()));
+    ParallelForRowBlocks(num_rows, [&](int64_t thread, int64_t begin,
+                                       int64_t end) {
+      std::vector<Mask> masks(end - begin);
+      ComputeTypeMasks(type_properties, begin, end, masks.data());
+      std::unordered_set<Mask>& seen = thread_masks[thread];
+      Mask last = ~Mask{0};
+      for (Mask mask : masks) {
+        if (mask != last) {
+          seen.emplace(mask);
+          last = mask;
+        }
       }
+    });
+    std::unordered_set<Mask> distinct;
+    for (const auto& seen : thread_masks) {
+      distinct.insert(seen.begin(), seen.end());
     }
-    for (auto uint8_property : type_properties.uint8_properties) {
-      if (uint8_property.array->IsValid(row) &&
-          uint8_property.array->Value(row)) {
-        field_indices.emplace_back(uint8_property.field_index);
+    for (Mask mask : distinct) {
+      TypeProperties::FieldEntity field_indices =
+          FieldEntityOfMask(type_properties, mask);
+      if (field_indices.size() > 1) {
+        type_combinations.emplace(std::move(field_indices));
       }
+      type_properties.mask_to_id.emplace(mask, kUnknownEntityType);
     }
-    if (field_indices.size() > 1) {
-      type_combinations.emplace(field_indices);
+  } else {
+    for (int64_t row = 0; row < num_rows; ++row) {
+      TypeProperties::FieldEntity field_indices =
+          FieldEntityOfRow(type_properties, row);
+      if (field_indices.size() > 1) {
+        type_combinations.emplace(field_indices);
+      }
     }
   }
 
@@ -94,9 +219,16 @@ katana::EntityTypeManager::DoAssignEntityTypeIDsFromProperties(
         field_indices, new_entity_type_id);
   }
 
+  for (auto& [mask, id] : type_properties.mask_to_id) {
+    if (mask != 0) {
+      id = type_properties.type_field_indices_to_id.at(
+          FieldEntityOfMask(type_properties, mask));
+    }
+  }
+
   // assert that all type IDs (including kUnknownEntityType) and
   // 1 special type ID (kInvalidEntityType)
-  // can be stored in 8 bits
+  // can be stored in an EntityTypeID
   if (entity_type_manager->GetNumEntityTypes() >
       (std::numeric_limits<katana::EntityTypeID>::max() - size_t{1})) {
     return KATANA_ERROR(
@@ -112,6 +244,57 @@ katana::EntityTypeManager::DoAssignEntityTypeIDsFromProperties(
   return type_properties;
 }
 
+katana::EntityTypeManager::TypeProperties::FieldEntity
+katana::EntityTypeManager::FieldEntityOfRow(
+    const TypeProperties& type_properties, int64_t row) {
+  TypeProperties::FieldEntity field_indices;
+  for (const auto& bool_property : type_properties.bool_properties) {
+    if (bool_property.array->IsValid(row) && bool_property.array->Value(row)) {
+      field_indices.emplace_back(bool_property.field_index);
+    }
+  }
+  for (const auto& uint8_property : type_properties.uint8_properties) {
+    if (uint8_property.array->IsValid(row) &&
+        uint8_property.array->Value(row)) {
+      field_indices.emplace_back(uint8_property.field_index);
+    }
+  }
+  return field_indices;
+}
+
+void
+katana::EntityTypeManager::DoAssignEntityTypeIDsToRows(
+    const TypeProperties& type_properties, int64_t num_rows,
+    EntityTypeID* entity_type_ids) {
+  if (!type_properties.use_masks) {
+    for (int64_t row = 0; row < num_rows; ++row) {
+      TypeProperties::FieldEntity field_indices =
+          FieldEntityOfRow(type_properties, row);
+      entity_type_ids[row] =
+          field_indices.empty()
+              ? kUnknownEntityType
+              : type_properties.type_field_indices_to_id.at(field_indices);
+    }
+    return;
+  }
+
+  ParallelForRowBlocks(num_rows, [&](int64_t, int64_t begin, int64_t end) {
+    std::vector<Mask> masks(end - begin);
+    ComputeTypeMasks(type_properties, begin, end, masks.data());
+    // Neighboring rows mostly have the same types
+    Mask last = 0;
+    EntityTypeID last_id = kUnknownEntityType;
+    for (int64_t row = begin; row < end; ++row) {
+      Mask mask = masks[row - begin];
+      if (mask != last) {
+        last = mask;
+        last_id = type_properties.mask_to_id.at(mask);
+      }
+      entity_type_ids[row] = last_id;
+    }
+  });
+}
+
 katana::Result<katana::EntityTypeID>
 katana::EntityTypeManager::AddNonAtomicEntityType(
     const katana::SetOfEntityTypeIDs& type_id_set) {
@@ -125,13 +308,10 @@ katana::EntityTypeManager::AddNonAtomicEntityType(
 
   entity_type_id_to_atomic_entity_type_ids_.emplace_back(type_id_set);
   atomic_entity_type_id_to_entity_type_ids_.emplace_back(SetOfEntityTypeIDs());
-  for (size_t atomic_entity_type_id = 0;
-       atomic_entity_type_id < type_id_set.size(); ++atomic_entity_type_id) {
-    if (type_id_set[atomic_entity_type_id]) {
-      atomic_entity_type_id_to_entity_type_ids_.at(atomic_entity_type_id)
-          .set(new_entity_type_id);
-    }
-  }
+  type_id_set.ForEach([&](EntityTypeID atomic_entity_type_id) {
+    atomic_entity_type_id_to_entity_type_ids_.at(atomic_entity_type_id)
+        .set(new_entity_type_id);
+  });
 
   // Ideally this would return an error instead of failing. But checking is
   // probably too slow. Remember kids, fast is more important than correct.
@@ -315,13 +495,10 @@ katana::EntityTypeManager::EntityTypeToTypeNameSet(
         ErrorCode::InvalidArgument,
         "no string representation for invalid type");
   }
-  auto type_set = GetAtomicSubtypes(type_id);
-  for (size_t idx = 0; idx < type_set.size(); ++idx) {
-    if (type_set[idx]) {
-      auto name = GetAtomicTypeName(idx);
-      KATANA_LOG_ASSERT(name.has_value());
-      type_name_set.insert(name.value());
-    }
-  }
+  GetAtomicSubtypes(type_id).ForEach([&](EntityTypeID idx) {
+    auto name = GetAtomicTypeName(idx);
+    KATANA_LOG_ASSERT(name.has_value());
+    type_name_set.insert(name.value());
+  });
   return type_name_set;
 }
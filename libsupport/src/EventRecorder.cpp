@@ -0,0 +1,464 @@
+#include "katana/EventRecorder.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "katana/Env.h"
+#include "katana/Logging.h"
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+using Event = katana::EventRecorder::Event;
+
+constexpr int kDefaultRingSize = 4096;
+
+/// The number of events each thread keeps, a power of two, or 0 if
+/// recording is off
+size_t
+RingSize() {
+  static const size_t size = [] {
+    int value = kDefaultRingSize;
+    katana::GetEnv("KATANA_EVENT_RING_SIZE", &value);
+    if (value <= 0) {
+      return size_t{0};
+    }
+    size_t size = 1;
+    while (size < static_cast<size_t>(value)) {
+      size <<= 1;
+    }
+    return size;
+  }();
+  return size;
+}
+
+uint64_t
+NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+uint32_t
+ThreadID() {
+#ifdef __linux__
+  return static_cast<uint32_t>(syscall(SYS_gettid));
+#else
+  return static_cast<uint32_t>(
+      std::hash<std::thread::id>()(std::this_thread::get_id()));
+#endif
+}
+
+uint32_t
+ProcessID() {
+#ifdef __linux__
+  return static_cast<uint32_t>(getpid());
+#else
+  return 0;
+#endif
+}
+
+/// The events of one thread. Only its thread writes it; head is published
+/// after each event so that readers can tell which slots are stable.
+struct Ring {
+  explicit Ring(size_t size) : events(size) {}
+
+  std::vector<Event> events;
+  std::atomic<uint64_t> head{0};
+};
+
+/// All rings ever made. The rings of threads that exit are kept, so that
+/// their events can still be dumped, and reused by new threads.
+class Registry {
+public:
+  static Registry& Get() {
+    // Leaked so that threads exiting after static destruction can release
+    // their rings
+    static Registry* registry = new Registry();
+    return *registry;
+  }
+
+  Ring* Acquire() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!free_.empty()) {
+      Ring* ring = free_.back();
+      free_.pop_back();
+      return ring;
+    }
+    rings_.emplace_back(std::make_unique<Ring>(RingSize()));
+    return rings_.back().get();
+  }
+
+  void Release(Ring* ring) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    free_.emplace_back(ring);
+  }
+
+  /// The events of all rings that were not overwritten while they were
+  /// copied, in time order
+  std::vector<Event> Snapshot() {
+    std::vector<Event> events;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& ring : rings_) {
+      const uint64_t size = ring->events.size();
+      const uint64_t mask = size - 1;
+      uint64_t end = ring->head.load(std::memory_order_acquire);
+      uint64_t begin = end > size ? end - size : 0;
+      size_t first = events.size();
+      for (uint64_t i = begin; i < end; ++i) {
+        events.emplace_back(ring->events[i & mask]);
+      }
+      // The writer may have lapped the slots copied first; drop those and
+      // the slot it may be writing now
+      uint64_t after = ring->head.load(std::memory_order_acquire);
+      uint64_t stable = after >= size ? after - size + 1 : 0;
+      if (stable > begin) {
+        uint64_t dropped = std::min(stable, end) - begin;
+        events.erase(
+            events.begin() + first, events.begin() + first + dropped);
+      }
+    }
+    std::stable_sort(
+        events.begin(), events.end(),
+        [](const Event& a, const Event& b) { return a.ts_ns < b.ts_ns; });
+    return events;
+  }
+
+private:
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<Ring>> rings_;
+  std::vector<Ring*> free_;
+};
+
+/// Gives the ring of a thread back to the registry when the thread exits
+class LocalRing {
+public:
+  ~LocalRing() {
+    if (ring_) {
+      Registry::Get().Release(ring_);
+    }
+  }
+
+  Ring& Get() {
+    if (!ring_) {
+      ring_ = Registry::Get().Acquire();
+      tid_ = ThreadID();
+    }
+    return *ring_;
+  }
+
+  uint32_t tid() const { return tid_; }
+
+private:
+  Ring* ring_{nullptr};
+  uint32_t tid_{0};
+};
+
+thread_local LocalRing local_ring;
+
+std::atomic<bool> dump_requested{false};
+
+void
+RequestDump(int) {
+  dump_requested.store(true, std::memory_order_relaxed);
+}
+
+std::string
+TracePath() {
+  std::string path;
+  katana::GetEnv("KATANA_EVENT_TRACE", &path);
+  return path;
+}
+
+/// Just enough of the protobuf wire format for Perfetto traces
+class ProtoWriter {
+public:
+  void Varint(uint32_t field, uint64_t value) {
+    Tag(field, 0);
+    PutVarint(value);
+  }
+
+  void Bytes(uint32_t field, const std::string& value) {
+    Tag(field, 2);
+    PutVarint(value.size());
+    buf_ += value;
+  }
+
+  void Message(uint32_t field, const ProtoWriter& message) {
+    Bytes(field, message.buf_);
+  }
+
+  const std::string& buf() const { return buf_; }
+
+private:
+  void Tag(uint32_t field, uint32_t wire_type) {
+    PutVarint((field << 3) | wire_type);
+  }
+
+  void PutVarint(uint64_t value) {
+    while (value >= 0x80) {
+      buf_.push_back(static_cast<char>(value | 0x80));
+      value >>= 7;
+    }
+    buf_.push_back(static_cast<char>(value));
+  }
+
+  std::string buf_;
+};
+
+// Field numbers of perfetto/trace/trace_packet.proto and friends
+namespace perfetto {
+constexpr uint32_t kTracePacket = 1;
+constexpr uint32_t kPacketTimestamp = 8;
+constexpr uint32_t kPacketSequenceID = 10;
+constexpr uint32_t kPacketTrackEvent = 11;
+constexpr uint32_t kPacketTrackDescriptor = 60;
+constexpr uint32_t kTrackUUID = 1;
+constexpr uint32_t kTrackName = 2;
+constexpr uint32_t kTrackThread = 4;
+constexpr uint32_t kTrackParentUUID = 5;
+constexpr uint32_t kTrackCounter = 8;
+constexpr uint32_t kThreadPID = 1;
+constexpr uint32_t kThreadTID = 2;
+constexpr uint32_t kThreadName = 5;
+constexpr uint32_t kEventDebugAnnotation = 4;
+constexpr uint32_t kEventType = 9;
+constexpr uint32_t kEventTrackUUID = 11;
+constexpr uint32_t kEventCategory = 22;
+constexpr uint32_t kEventName = 23;
+constexpr uint32_t kEventCounterValue = 30;
+constexpr uint32_t kAnnotationUintValue = 3;
+constexpr uint32_t kAnnotationName = 10;
+constexpr uint64_t kSliceBegin = 1;
+constexpr uint64_t kSliceEnd = 2;
+constexpr uint64_t kInstant = 3;
+constexpr uint64_t kCounter = 4;
+constexpr uint64_t kSequenceID = 1;
+}  // namespace perfetto
+
+}  // namespace
+
+bool katana::EventRecorder::enabled_ = RingSize() > 0;
+
+void
+katana::EventRecorder::RecordSlow(
+    Category category, Phase phase, const char* name, uint64_t value) {
+  Ring& ring = local_ring.Get();
+  uint64_t head = ring.head.load(std::memory_order_relaxed);
+  Event& event = ring.events[head & (ring.events.size() - 1)];
+  event.ts_ns = NowNs();
+  event.value = value;
+  event.tid = local_ring.tid();
+  event.category = category;
+  event.phase = phase;
+  std::strncpy(event.name, name, kMaxNameSize);
+  event.name[kMaxNameSize] = '\0';
+  ring.head.store(head + 1, std::memory_order_release);
+}
+
+const char*
+katana::EventRecorder::CategoryName(Category category) {
+  switch (category) {
+  case kLoop:
+    return "loop";
+  case kBarrier:
+    return "barrier";
+  case kWorklist:
+    return "worklist";
+  case kStorage:
+    return "storage";
+  default:
+    return "unknown";
+  }
+}
+
+void
+katana::EventRecorder::WriteChromeTrace(std::ostream& out) {
+  std::vector<Event> events = Registry::Get().Snapshot();
+  uint64_t start = events.empty() ? 0 : events.front().ts_ns;
+  uint32_t pid = ProcessID();
+
+  out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+  bool first = true;
+  for (const Event& event : events) {
+    nlohmann::json json{
+        {"name", event.name},
+        {"cat", CategoryName(event.category)},
+        {"ts", static_cast<double>(event.ts_ns - start) / 1000.0},
+        {"pid", pid},
+        {"tid", event.tid},
+    };
+    switch (event.phase) {
+    case kBegin:
+      json["ph"] = "B";
+      json["args"] = {{"value", event.value}};
+      break;
+    case kEnd:
+      json["ph"] = "E";
+      break;
+    case kInstant:
+      json["ph"] = "i";
+      json["s"] = "t";
+      json["args"] = {{"value", event.value}};
+      break;
+    case kCounter:
+      // Chrome keys counter tracks by process and name only
+      json["ph"] = "C";
+      json["name"] = fmt::format("{} {}", event.name, event.tid);
+      json["args"] = {{"value", event.value}};
+      break;
+    }
+    out << (first ? "\n" : ",\n") << json.dump();
+    first = false;
+  }
+  out << "\n]}\n";
+}
+
+void
+katana::EventRecorder::WritePerfettoTrace(std::ostream& out) {
+  std::vector<Event> events = Registry::Get().Snapshot();
+  uint32_t pid = ProcessID();
+
+  auto write_packet = [&out](const ProtoWriter& packet) {
+    ProtoWriter trace;
+    trace.Message(perfetto::kTracePacket, packet);
+    out << trace.buf();
+  };
+
+  // One track per thread and one child counter track per thread and counter
+  std::unordered_map<uint32_t, uint64_t> thread_tracks;
+  std::unordered_map<std::string, uint64_t> counter_tracks;
+  uint64_t next_uuid = 1;
+  auto thread_track = [&](uint32_t tid) {
+    auto [it, inserted] = thread_tracks.emplace(tid, next_uuid);
+    if (inserted) {
+      ++next_uuid;
+      ProtoWriter thread;
+      thread.Varint(perfetto::kThreadPID, pid);
+      thread.Varint(perfetto::kThreadTID, tid);
+      thread.Bytes(perfetto::kThreadName, fmt::format("thread {}", tid));
+      ProtoWriter track;
+      track.Varint(perfetto::kTrackUUID, it->second);
+      track.Message(perfetto::kTrackThread, thread);
+      ProtoWriter packet;
+      packet.Message(perfetto::kPacketTrackDescriptor, track);
+      write_packet(packet);
+    }
+    return it->second;
+  };
+  auto counter_track = [&](const Event& event) {
+    uint64_t parent = thread_track(event.tid);
+    auto [it, inserted] = counter_tracks.emplace(
+        fmt::format("{}/{}", event.tid, event.name), next_uuid);
+    if (inserted) {
+      ++next_uuid;
+      ProtoWriter track;
+      track.Varint(perfetto::kTrackUUID, it->second);
+      track.Varint(perfetto::kTrackParentUUID, parent);
+      track.Bytes(perfetto::kTrackName, event.name);
+      track.Message(perfetto::kTrackCounter, ProtoWriter());
+      ProtoWriter packet;
+      packet.Message(perfetto::kPacketTrackDescriptor, track);
+      write_packet(packet);
+    }
+    return it->second;
+  };
+
+  for (const Event& event : events) {
+    ProtoWriter track_event;
+    if (event.phase == kCounter) {
+      track_event.Varint(perfetto::kEventType, perfetto::kCounter);
+      track_event.Varint(perfetto::kEventTrackUUID, counter_track(event));
+      track_event.Varint(perfetto::kEventCounterValue, event.value);
+    } else {
+      track_event.Varint(
+          perfetto::kEventType, event.phase == kBegin ? perfetto::kSliceBegin
+                                : event.phase == kEnd ? perfetto::kSliceEnd
+                                                      : perfetto::kInstant);
+      track_event.Varint(perfetto::kEventTrackUUID, thread_track(event.tid));
+      if (event.phase != kEnd) {
+        track_event.Bytes(
+            perfetto::kEventCategory, CategoryName(event.category));
+        track_event.Bytes(perfetto::kEventName, event.name);
+        ProtoWriter annotation;
+        annotation.Bytes(perfetto::kAnnotationName, "value");
+        annotation.Varint(perfetto::kAnnotationUintValue, event.value);
+        track_event.Message(perfetto::kEventDebugAnnotation, annotation);
+      }
+    }
+    ProtoWriter packet;
+    packet.Varint(perfetto::kPacketTimestamp, event.ts_ns);
+    packet.Varint(perfetto::kPacketSequenceID, perfetto::kSequenceID);
+    packet.Message(perfetto::kPacketTrackEvent, track_event);
+    write_packet(packet);
+  }
+}
+
+katana::Result<void>
+katana::EventRecorder::Dump(const std::string& path) {
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  if (!out) {
+    return KATANA_ERROR(ResultErrno(), "opening {}", path);
+  }
+  const std::string suffix = ".json";
+  if (path.size() >= suffix.size() &&
+      path.compare(path.size() - suffix.size(), suffix.size(), suffix) == 0) {
+    WriteChromeTrace(out);
+  } else {
+    WritePerfettoTrace(out);
+  }
+  out.close();
+  if (!out) {
+    return KATANA_ERROR(ResultErrno(), "writing {}", path);
+  }
+  return ResultSuccess();
+}
+
+void
+katana::EventRecorder::InstallDumpSignal() {
+  if (!enabled_ || TracePath().empty()) {
+    return;
+  }
+  struct sigaction action {};
+  action.sa_handler = RequestDump;
+  sigemptyset(&action.sa_mask);
+  action.sa_flags = SA_RESTART;
+  if (sigaction(SIGUSR2, &action, nullptr) != 0) {
+    KATANA_LOG_WARN("cannot install SIGUSR2 handler for KATANA_EVENT_TRACE");
+  }
+}
+
+void
+katana::EventRecorder::DumpIfRequested() {
+  if (!dump_requested.load(std::memory_order_relaxed) ||
+      !dump_requested.exchange(false)) {
+    return;
+  }
+  DumpAtExit();
+}
+
+void
+katana::EventRecorder::DumpAtExit() {
+  std::string path = TracePath();
+  if (!enabled_ || path.empty()) {
+    return;
+  }
+  if (auto res = Dump(path); !res) {
+    KATANA_LOG_WARN("dumping events to {}: {}", path, res.error());
+  }
+}
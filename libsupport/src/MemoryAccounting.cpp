@@ -0,0 +1,200 @@
+#include "katana/MemoryAccounting.h"
+
+#include <array>
+#include <atomic>
+#include <iterator>
+
+#include <fmt/format.h>
+
+#include "katana/Env.h"
+#include "katana/ErrorCode.h"
+#include "katana/Logging.h"
+
+namespace {
+
+constexpr size_t kNumCategories =
+    static_cast<size_t>(katana::MemoryCategory::kNumCategories);
+
+struct Counters {
+  std::atomic<uint64_t> current{0};
+  std::atomic<uint64_t> peak{0};
+};
+
+struct State {
+  State() {
+    int megabytes = 0;
+    if (katana::GetEnv("KATANA_MEMORY_BUDGET_MB", &megabytes) &&
+        megabytes > 0) {
+      budget = static_cast<uint64_t>(megabytes) << 20;
+    }
+  }
+
+  std::array<Counters, kNumCategories> categories;
+  std::atomic<uint64_t> total{0};
+  std::atomic<uint64_t> budget{0};
+};
+
+State&
+GetState() {
+  // Leaked so that memory released by static destructors in other
+  // libraries can still be accounted for
+  static State* state = new State();
+  return *state;
+}
+
+Counters&
+GetCounters(katana::MemoryCategory category) {
+  KATANA_LOG_DEBUG_ASSERT(category < katana::MemoryCategory::kNumCategories);
+  return GetState().categories[static_cast<size_t>(category)];
+}
+
+void
+Add(katana::MemoryCategory category, uint64_t bytes) {
+  Counters& counters = GetCounters(category);
+  uint64_t current = counters.current.fetch_add(bytes) + bytes;
+  uint64_t peak = counters.peak.load(std::memory_order_relaxed);
+  while (peak < current && !counters.peak.compare_exchange_weak(
+                               peak, current, std::memory_order_relaxed)) {
+  }
+}
+
+thread_local katana::MemoryCategory current_category =
+    katana::MemoryCategory::kScratch;
+
+}  // namespace
+
+const char*
+katana::MemoryCategoryName(MemoryCategory category) {
+  switch (category) {
+  case MemoryCategory::kTopology:
+    return "Topology";
+  case MemoryCategory::kViews:
+    return "Views";
+  case MemoryCategory::kProperties:
+    return "Properties";
+  case MemoryCategory::kIndexes:
+    return "Indexes";
+  case MemoryCategory::kWorklists:
+    return "Worklists";
+  case MemoryCategory::kScratch:
+    return "Scratch";
+  default:
+    return "Unknown";
+  }
+}
+
+katana::Result<void>
+katana::MemoryAccounting::Charge(MemoryCategory category, uint64_t bytes) {
+  State& state = GetState();
+  uint64_t budget = state.budget.load(std::memory_order_relaxed);
+  uint64_t total = state.total.fetch_add(bytes) + bytes;
+  if (budget != 0 && total > budget) {
+    state.total -= bytes;
+    return KATANA_ERROR(
+        ErrorCode::OutOfMemory,
+        "charging {} bytes to {} would exceed the budget of {} bytes; {}",
+        bytes, MemoryCategoryName(category), budget, Summary());
+  }
+  Add(category, bytes);
+  return ResultSuccess();
+}
+
+void
+katana::MemoryAccounting::ChargeOrDie(MemoryCategory category, uint64_t bytes) {
+  if (auto res = Charge(category, bytes); !res) {
+    KATANA_LOG_FATAL("{}", res.error());
+  }
+}
+
+void
+katana::MemoryAccounting::ForceCharge(MemoryCategory category, uint64_t bytes) {
+  GetState().total += bytes;
+  Add(category, bytes);
+}
+
+void
+katana::MemoryAccounting::Release(MemoryCategory category, uint64_t bytes) {
+  KATANA_LOG_DEBUG_ASSERT(GetCounters(category).current >= bytes);
+  GetCounters(category).current -= bytes;
+  GetState().total -= bytes;
+}
+
+uint64_t
+katana::MemoryAccounting::current(MemoryCategory category) {
+  return GetCounters(category).current;
+}
+
+uint64_t
+katana::MemoryAccounting::peak(MemoryCategory category) {
+  return GetCounters(category).peak;
+}
+
+uint64_t
+katana::MemoryAccounting::total() {
+  return GetState().total;
+}
+
+uint64_t
+katana::MemoryAccounting::budget() {
+  return GetState().budget;
+}
+
+void
+katana::MemoryAccounting::set_budget(uint64_t bytes) {
+  GetState().budget = bytes;
+}
+
+void
+katana::MemoryAccounting::ResetPeaks() {
+  for (Counters& counters : GetState().categories) {
+    counters.peak = counters.current.load();
+  }
+}
+
+std::string
+katana::MemoryAccounting::Summary() {
+  fmt::memory_buffer buf;
+  for (size_t i = 0; i < kNumCategories; ++i) {
+    auto category = static_cast<MemoryCategory>(i);
+    fmt::format_to(
+        std::back_inserter(buf), "{}{}: {} bytes (peak {})",
+        i == 0 ? "" : ", ", MemoryCategoryName(category), current(category),
+        peak(category));
+  }
+  return fmt::to_string(buf);
+}
+
+katana::Result<void>
+katana::MemoryCharge::Resize(uint64_t bytes) {
+  if (bytes > bytes_) {
+    KATANA_CHECKED(MemoryAccounting::Charge(category_, bytes - bytes_));
+  } else if (bytes < bytes_) {
+    MemoryAccounting::Release(category_, bytes_ - bytes);
+  }
+  bytes_ = bytes;
+  return ResultSuccess();
+}
+
+void
+katana::MemoryCharge::ForceResize(uint64_t bytes) {
+  if (bytes > bytes_) {
+    MemoryAccounting::ForceCharge(category_, bytes - bytes_);
+  } else if (bytes < bytes_) {
+    MemoryAccounting::Release(category_, bytes_ - bytes);
+  }
+  bytes_ = bytes;
+}
+
+katana::MemoryCategory
+katana::CurrentMemoryCategory() {
+  return current_category;
+}
+
+katana::MemoryCategoryScope::MemoryCategoryScope(MemoryCategory category)
+    : previous_(current_category) {
+  current_category = category;
+}
+
+katana::MemoryCategoryScope::~MemoryCategoryScope() {
+  current_category = previous_;
+}
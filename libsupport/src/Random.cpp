@@ -95,3 +95,58 @@ katana::RandomAlphanumericString(uint64_t len, RandGenerator* gen) {
   std::generate_n(std::begin(result), len, [&]() { return chars[dist(*gen)]; });
   return result;
 }
+
+void
+katana::PhiloxGenerateBatch(
+    uint64_t key, uint64_t item, uint64_t first_step, size_t num_blocks,
+    uint32_t* out) {
+  // The rounds of kLanes blocks in structure of arrays form, so each
+  // statement is one vector operation over the lanes
+  constexpr size_t kLanes = 8;
+  const auto item_lo = static_cast<uint32_t>(item);
+  const auto item_hi = static_cast<uint32_t>(item >> 32);
+
+  size_t block = 0;
+  for (; block + kLanes <= num_blocks; block += kLanes) {
+    uint32_t c0[kLanes];
+    uint32_t c1[kLanes];
+    uint32_t c2[kLanes];
+    uint32_t c3[kLanes];
+    for (size_t l = 0; l < kLanes; ++l) {
+      uint64_t step = first_step + block + l;
+      c0[l] = item_lo;
+      c1[l] = item_hi;
+      c2[l] = static_cast<uint32_t>(step);
+      c3[l] = static_cast<uint32_t>(step >> 32);
+    }
+    uint32_t k0 = static_cast<uint32_t>(key);
+    uint32_t k1 = static_cast<uint32_t>(key >> 32);
+    for (int round = 0; round < Philox4x32::kRounds; ++round) {
+      for (size_t l = 0; l < kLanes; ++l) {
+        uint64_t p0 = uint64_t{Philox4x32::kMul0} * c0[l];
+        uint64_t p1 = uint64_t{Philox4x32::kMul1} * c2[l];
+        uint32_t n0 = static_cast<uint32_t>(p1 >> 32) ^ c1[l] ^ k0;
+        uint32_t n2 = static_cast<uint32_t>(p0 >> 32) ^ c3[l] ^ k1;
+        c1[l] = static_cast<uint32_t>(p1);
+        c3[l] = static_cast<uint32_t>(p0);
+        c0[l] = n0;
+        c2[l] = n2;
+      }
+      k0 += Philox4x32::kWeyl0;
+      k1 += Philox4x32::kWeyl1;
+    }
+    for (size_t l = 0; l < kLanes; ++l) {
+      uint32_t* dest = out + 4 * (block + l);
+      dest[0] = c0[l];
+      dest[1] = c1[l];
+      dest[2] = c2[l];
+      dest[3] = c3[l];
+    }
+  }
+
+  for (; block < num_blocks; ++block) {
+    Philox4x32::Block values =
+        Philox4x32::Generate(key, item, first_step + block);
+    std::copy(values.begin(), values.end(), out + 4 * block);
+  }
+}
@@ -0,0 +1,173 @@
+#include "katana/ArrowInterchange.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/Logging.h"
+
+namespace {
+
+std::shared_ptr<arrow::ChunkedArray>
+Chunked(std::shared_ptr<arrow::Array> array) {
+  return std::make_shared<arrow::ChunkedArray>(
+      std::vector<std::shared_ptr<arrow::Array>>{std::move(array)});
+}
+
+void
+TestContentDigest() {
+  std::vector<int64_t> values{1, 2, 3, 4, 5, 6};
+  std::vector<int64_t> other_values{1, 2, 3, 4, 5, 7};
+  std::vector<uint64_t> unsigned_values{1, 2, 3, 4, 5, 6};
+  std::vector<int64_t> padded_values{0, 1, 2, 3, 4, 5, 6, 0};
+
+  auto array = Chunked(katana::BuildArray(values));
+  std::string digest = katana::ContentDigest(array);
+  KATANA_LOG_ASSERT(digest.size() == katana::kContentDigestVersion.size() + 32);
+  KATANA_LOG_ASSERT(katana::IsCurrentContentDigest(digest));
+  KATANA_LOG_ASSERT(digest == katana::ContentDigest(array));
+
+  // Digests recorded before digests were versioned
+  KATANA_LOG_ASSERT(!katana::IsCurrentContentDigest(
+      digest.substr(katana::kContentDigestVersion.size())));
+  KATANA_LOG_ASSERT(!katana::IsCurrentContentDigest(""));
+
+  // Equal values in different buffers
+  auto copy = Chunked(katana::BuildArray(values));
+  KATANA_LOG_ASSERT(digest == katana::ContentDigest(copy));
+
+  // Equal values at an offset into a larger buffer
+  auto sliced = Chunked(katana::BuildArray(padded_values)->Slice(1, 6));
+  KATANA_LOG_ASSERT(digest == katana::ContentDigest(sliced));
+
+  auto other = Chunked(katana::BuildArray(other_values));
+  KATANA_LOG_ASSERT(digest != katana::ContentDigest(other));
+
+  auto other_type = Chunked(katana::BuildArray(unsigned_values));
+  KATANA_LOG_ASSERT(digest != katana::ContentDigest(other_type));
+
+  auto shorter = Chunked(katana::BuildArray(values)->Slice(0, 5));
+  KATANA_LOG_ASSERT(digest != katana::ContentDigest(shorter));
+
+  // Equal values chunked differently
+  KATANA_LOG_ASSERT(katana::IsContentDigestCanonical(array));
+  auto whole = katana::BuildArray(values);
+  auto rechunked = std::make_shared<arrow::ChunkedArray>(
+      std::vector<std::shared_ptr<arrow::Array>>{
+          whole->Slice(0, 1), whole->Slice(1, 0), whole->Slice(1, 5)});
+  KATANA_LOG_ASSERT(digest == katana::ContentDigest(rechunked));
+}
+
+/// Digests of byte values spanning many blocks do not depend on where the
+/// chunks split them, even within 8-byte words
+void
+TestContentDigestBlocks() {
+  std::vector<uint8_t> values(int64_t{3} << 22);
+  for (size_t i = 0; i < values.size(); ++i) {
+    values[i] = static_cast<uint8_t>(i * 31 + i / 251);
+  }
+  auto whole = katana::BuildArray(values);
+  std::string digest = katana::ContentDigest(Chunked(whole));
+
+  std::vector<std::shared_ptr<arrow::Array>> chunks;
+  int64_t begin = 0;
+  for (int64_t length = 3; begin < whole->length(); length = length * 7 + 5) {
+    length = std::min(length, whole->length() - begin);
+    chunks.emplace_back(whole->Slice(begin, length));
+    begin += length;
+  }
+  auto rechunked = std::make_shared<arrow::ChunkedArray>(chunks);
+  KATANA_LOG_ASSERT(digest == katana::ContentDigest(rechunked));
+
+  // Nor on how many threads digest them
+  KATANA_LOG_ASSERT(digest == katana::ContentDigest(Chunked(whole), 4));
+  KATANA_LOG_ASSERT(digest == katana::ContentDigest(rechunked, 3));
+
+  values[values.size() / 2] ^= 1;
+  auto other = Chunked(katana::BuildArray(values));
+  KATANA_LOG_ASSERT(digest != katana::ContentDigest(other));
+}
+
+std::shared_ptr<arrow::Array>
+Strings(const std::vector<std::string>& values) {
+  arrow::LargeStringBuilder builder;
+  KATANA_LOG_ASSERT(builder.AppendValues(values).ok());
+  std::shared_ptr<arrow::Array> array;
+  KATANA_LOG_ASSERT(builder.Finish(&array).ok());
+  return array;
+}
+
+/// The string value of element i of a dictionary array of strings
+std::string
+Decode(const arrow::DictionaryArray& array, int64_t i) {
+  const auto& dictionary =
+      static_cast<const arrow::LargeStringArray&>(*array.dictionary());
+  const auto& indices = *array.indices();
+  int64_t code = indices.type_id() == arrow::Type::INT8
+                     ? static_cast<const arrow::Int8Array&>(indices).Value(i)
+                     : static_cast<const arrow::Int32Array&>(indices).Value(i);
+  return dictionary.GetString(code);
+}
+
+void
+TestDictionaryEncode() {
+  std::vector<std::string> first{"us", "fr", "us", "de"};
+  std::vector<std::string> second{"fr", "jp", "jp", "us", "fr"};
+  auto strings = std::make_shared<arrow::ChunkedArray>(
+      std::vector<std::shared_ptr<arrow::Array>>{
+          Strings(first), Strings(second)});
+
+  auto encoded_result = katana::DictionaryEncode(strings);
+  KATANA_LOG_VASSERT(encoded_result, "{}", encoded_result.error());
+  auto encoded = encoded_result.value();
+  KATANA_LOG_ASSERT(encoded->num_chunks() == 1);
+  KATANA_LOG_ASSERT(encoded->type()->Equals(
+      arrow::dictionary(arrow::int32(), arrow::large_utf8())));
+  const auto& array =
+      static_cast<const arrow::DictionaryArray&>(*encoded->chunk(0));
+  KATANA_LOG_ASSERT(array.dictionary()->length() == 4);
+
+  std::vector<std::string> expected(first);
+  expected.insert(expected.end(), second.begin(), second.end());
+  KATANA_LOG_ASSERT(array.length() == static_cast<int64_t>(expected.size()));
+  for (size_t i = 0; i < expected.size(); ++i) {
+    KATANA_LOG_VASSERT(
+        Decode(array, i) == expected[i], "element {} is {}, expected {}", i,
+        Decode(array, i), expected[i]);
+  }
+
+  // Chunks with their own dictionaries are combined into one
+  auto type = arrow::dictionary(arrow::int8(), arrow::large_utf8());
+  auto make_chunk = [&](std::vector<int8_t> codes,
+                        const std::vector<std::string>& values) {
+    return arrow::DictionaryArray::FromArrays(
+               type, katana::BuildArray(codes), Strings(values))
+        .ValueOrDie();
+  };
+  auto chunked = std::make_shared<arrow::ChunkedArray>(
+      std::vector<std::shared_ptr<arrow::Array>>{
+          make_chunk({0, 1, 1}, {"a", "b"}), make_chunk({1, 0}, {"c", "a"})});
+  auto unified_result = katana::UnifiedDictionaryArray(chunked);
+  KATANA_LOG_VASSERT(unified_result, "{}", unified_result.error());
+  auto unified =
+      std::static_pointer_cast<arrow::DictionaryArray>(unified_result.value());
+  KATANA_LOG_ASSERT(unified->dictionary()->length() == 3);
+  std::vector<std::string> unified_expected{"a", "b", "b", "a", "c"};
+  for (size_t i = 0; i < unified_expected.size(); ++i) {
+    KATANA_LOG_ASSERT(Decode(*unified, i) == unified_expected[i]);
+  }
+  auto combined = katana::CombinedArray(chunked);
+  KATANA_LOG_ASSERT(combined && combined.value()->Equals(*unified));
+}
+
+}  // namespace
+
+int
+main() {
+  TestContentDigest();
+  TestContentDigestBlocks();
+  TestDictionaryEncode();
+  return 0;
+}
@@ -0,0 +1,71 @@
+#include "katana/ArrowVisitor.h"
+
+#include <type_traits>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/Logging.h"
+
+namespace {
+
+/// Sum an array of any numeric type in its own type, without casting it
+katana::Result<double>
+Sum(const std::shared_ptr<arrow::Array>& array) {
+  return katana::VisitArrowCType<katana::NumericCTypes>(
+      *array->type(), [&](auto tag) -> katana::Result<double> {
+        using T = decltype(tag);
+        using ArrayType = typename arrow::CTypeTraits<T>::ArrayType;
+        auto typed = std::static_pointer_cast<ArrayType>(array);
+        T sum = 0;
+        for (int64_t i = 0; i < typed->length(); ++i) {
+          sum += typed->Value(i);
+        }
+        return static_cast<double>(sum);
+      });
+}
+
+template <typename T>
+void
+TestSum() {
+  std::vector<T> values{1, 2, 3, 4};
+  auto res = Sum(katana::BuildArray(values));
+  KATANA_LOG_VASSERT(res, "summing: {}", res.error());
+  KATANA_LOG_ASSERT(res.value() == 10);
+}
+
+void
+TestDispatch() {
+  TestSum<uint32_t>();
+  TestSum<int32_t>();
+  TestSum<uint64_t>();
+  TestSum<int64_t>();
+  TestSum<float>();
+  TestSum<double>();
+
+  // Types not in the list are errors
+  std::vector<int16_t> shorts{1, 2};
+  auto res = Sum(katana::BuildArray(shorts));
+  KATANA_LOG_ASSERT(!res);
+  KATANA_LOG_ASSERT(res.error() == katana::ErrorCode::TypeError);
+
+  using IntTypes = katana::CTypeList<int32_t, int64_t>;
+  auto is_64 = [](auto tag) -> katana::Result<bool> {
+    return sizeof(tag) == 8;
+  };
+  KATANA_LOG_ASSERT(
+      katana::VisitArrowCType<IntTypes>(*arrow::int64(), is_64).value());
+  KATANA_LOG_ASSERT(
+      !katana::VisitArrowCType<IntTypes>(*arrow::int32(), is_64).value());
+  KATANA_LOG_ASSERT(
+      !katana::VisitArrowCType<IntTypes>(*arrow::float64(), is_64));
+}
+
+}  // namespace
+
+int
+main() {
+  TestDispatch();
+  return 0;
+}
@@ -0,0 +1,63 @@
+#include "katana/CommBackend.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "katana/Logging.h"
+
+namespace {
+
+void
+TestAllreduce(katana::CommBackend* comm) {
+  std::vector<double> send{1.5, 2.5};
+  std::vector<double> recv(2);
+  auto res = comm->Allreduce(
+      send.data(), recv.data(), send.size(),
+      katana::CommBackend::DataType::kDouble,
+      katana::CommBackend::ReduceOp::kSum);
+  KATANA_LOG_VASSERT(res, "allreduce: {}", res.error());
+  KATANA_LOG_ASSERT(recv == send);
+
+  auto max_res =
+      comm->Allreduce<uint64_t>(7, katana::CommBackend::ReduceOp::kMax);
+  KATANA_LOG_ASSERT(max_res && max_res.value() == 7);
+}
+
+void
+TestAllgather(katana::CommBackend* comm) {
+  std::vector<uint32_t> send{1, 2, 3};
+  std::vector<uint32_t> recv(send.size() * comm->Num);
+  auto res =
+      comm->Allgather(send.data(), send.size() * sizeof(uint32_t), recv.data());
+  KATANA_LOG_VASSERT(res, "allgather: {}", res.error());
+  KATANA_LOG_ASSERT(recv == send);
+
+  uint64_t wrong_size = 1;
+  KATANA_LOG_ASSERT(
+      !comm->Allgatherv(send.data(), 4, recv.data(), &wrong_size));
+}
+
+void
+TestAlltoallv(katana::CommBackend* comm) {
+  std::vector<uint8_t> send{4, 5, 6};
+  std::vector<uint8_t> recv(send.size());
+  uint64_t bytes = send.size();
+  auto request = comm->IAlltoallv(send.data(), &bytes, recv.data(), &bytes);
+  auto res = request->Wait();
+  KATANA_LOG_VASSERT(res, "alltoallv: {}", res.error());
+  KATANA_LOG_ASSERT(request->Test());
+  KATANA_LOG_ASSERT(recv == send);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::NullCommBackend comm;
+
+  TestAllreduce(&comm);
+  TestAllgather(&comm);
+  TestAlltoallv(&comm);
+
+  return 0;
+}
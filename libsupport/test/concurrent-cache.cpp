@@ -0,0 +1,134 @@
+#include "katana/ConcurrentCache.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <boost/container_hash/hash.hpp>
+
+#include "katana/Logging.h"
+
+enum class NodeEdge { kNode, kEdge };
+
+// This code is replicated from libtsuba::PropertyCache.h to allow testing of
+// libsupport::ConcurrentCache.h (libtsuba depends on libsupport, not the
+// other way around)
+struct KATANA_EXPORT PropertyCacheKey {
+  NodeEdge node_edge;
+  std::string name;
+  PropertyCacheKey(NodeEdge _node_edge, const std::string& _name = "")
+      : node_edge(_node_edge), name(_name) {}
+  bool operator==(const PropertyCacheKey& o) const {
+    return node_edge == o.node_edge && name == o.name;
+  }
+  struct Hash {
+    std::size_t operator()(const PropertyCacheKey& k) const {
+      using boost::hash_combine;
+      using boost::hash_value;
+
+      std::size_t seed = 0;
+      hash_combine(seed, hash_value(k.node_edge));
+      hash_combine(seed, hash_value(k.name));
+
+      // Return the result.
+      return seed;
+    }
+  };
+};
+
+using Cache = katana::ConcurrentCache<PropertyCacheKey, size_t>;
+
+PropertyCacheKey
+MakeKey(size_t i) {
+  return PropertyCacheKey(
+      (i & 1) ? NodeEdge::kEdge : NodeEdge::kNode, std::to_string(i));
+}
+
+// With a single shard the cache must behave exactly like katana::Cache
+void
+TestSingleShardLRU() {
+  constexpr size_t kCapacity = 10;
+  size_t evictions = 0;
+  Cache cache(
+      kCapacity, [&](const PropertyCacheKey&) { evictions++; }, 1);
+
+  for (size_t i = 0; i < 2 * kCapacity; ++i) {
+    cache.Insert(MakeKey(i), i);
+  }
+  KATANA_LOG_ASSERT(cache.size() == kCapacity);
+  KATANA_LOG_ASSERT(evictions == kCapacity);
+  for (size_t i = 0; i < kCapacity; ++i) {
+    KATANA_LOG_ASSERT(!cache.Contains(MakeKey(i)));
+  }
+
+  // Touch the oldest remaining entry so the next eviction skips it
+  KATANA_LOG_ASSERT(cache.Get(MakeKey(kCapacity)).value() == kCapacity);
+  cache.Insert(MakeKey(100), 100);
+  KATANA_LOG_ASSERT(cache.Contains(MakeKey(kCapacity)));
+  KATANA_LOG_ASSERT(!cache.Contains(MakeKey(kCapacity + 1)));
+}
+
+void
+TestLRUBytes() {
+  constexpr size_t kCapacity = 64;
+  Cache cache(
+      kCapacity, [](const size_t& value) { return value; }, nullptr, 4);
+
+  for (size_t i = 0; i < 64; ++i) {
+    cache.Insert(MakeKey(i), 4);
+    KATANA_LOG_ASSERT(cache.size() <= kCapacity);
+  }
+  KATANA_LOG_ASSERT(cache.size() == kCapacity);
+
+  // A single entry is allowed to exceed the byte capacity and must survive
+  // its own insertion
+  cache.Insert(MakeKey(1000), 2 * kCapacity);
+  KATANA_LOG_ASSERT(cache.Contains(MakeKey(1000)));
+  KATANA_LOG_ASSERT(cache.size() == 2 * kCapacity);
+}
+
+void
+TestConcurrent() {
+  constexpr size_t kCapacity = 1000;
+  constexpr size_t kNumThreads = 8;
+  constexpr size_t kOpsPerThread = 20000;
+
+  std::atomic<size_t> evictions{0};
+  Cache cache(
+      kCapacity, [](const size_t&) { return 1; },
+      [&](const PropertyCacheKey&) { evictions++; });
+
+  std::atomic<size_t> inserts{0};
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&, t]() {
+      for (size_t i = 0; i < kOpsPerThread; ++i) {
+        size_t k = (t * 7919 + i * 31) % (4 * kCapacity);
+        auto key = MakeKey(k);
+        auto found = cache.Get(key);
+        if (found) {
+          KATANA_LOG_ASSERT(found.value() == k);
+        } else {
+          cache.Insert(key, k);
+          inserts++;
+        }
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  KATANA_LOG_ASSERT(cache.size() <= kCapacity);
+  // Concurrent inserts of the same key overwrite rather than add entries, so
+  // this is an upper bound
+  KATANA_LOG_ASSERT(cache.size() + evictions.load() <= inserts.load());
+}
+
+int
+main() {
+  TestSingleShardLRU();
+  TestLRUBytes();
+  TestConcurrent();
+  return 0;
+}
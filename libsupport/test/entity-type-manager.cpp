@@ -0,0 +1,227 @@
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/EntityTypeManager.h"
+#include "katana/Logging.h"
+
+namespace {
+
+// More atomic types than fit in 8 bits
+constexpr size_t kNumAtomicTypes = 300;
+
+std::string
+Name(size_t i) {
+  return "t" + std::to_string(i);
+}
+
+void
+TestSetOfEntityTypeIDs() {
+  katana::SetOfEntityTypeIDs a;
+  KATANA_LOG_ASSERT(a.none());
+  KATANA_LOG_ASSERT(a.size() == 0);
+  KATANA_LOG_ASSERT(!a.test(1000));
+
+  a.set(3);
+  a.set(700);
+  KATANA_LOG_ASSERT(a.test(3) && a[700] && !a.test(4));
+  KATANA_LOG_ASSERT(a.count() == 2);
+  KATANA_LOG_ASSERT(a.size() > 700);
+
+  katana::SetOfEntityTypeIDs b;
+  b.set(3);
+  KATANA_LOG_ASSERT(b.IsSubsetOf(a));
+  KATANA_LOG_ASSERT(!a.IsSubsetOf(b));
+  KATANA_LOG_ASSERT((a & b) == b);
+  KATANA_LOG_ASSERT((a | b) == a);
+
+  // Removing the largest ID leaves a set equal to one that never had it
+  a.reset(700);
+  KATANA_LOG_ASSERT(a == b);
+  KATANA_LOG_ASSERT(a.size() == b.size());
+  b.reset(3);
+  KATANA_LOG_ASSERT(b.none() && b != a);
+
+  std::vector<katana::EntityTypeID> ids;
+  katana::SetOfEntityTypeIDs c;
+  for (katana::EntityTypeID id : {65534, 0, 64, 63}) {
+    c.set(id);
+  }
+  c.ForEach([&](katana::EntityTypeID id) { ids.emplace_back(id); });
+  KATANA_LOG_ASSERT(
+      (ids == std::vector<katana::EntityTypeID>{0, 63, 64, 65534}));
+  KATANA_LOG_ASSERT(fmt::format("{}", c) == "{0, 63, 64, 65534}");
+}
+
+void
+TestManyTypes() {
+  katana::EntityTypeManager manager;
+  for (size_t i = 0; i < kNumAtomicTypes; ++i) {
+    auto id = manager.AddAtomicEntityType(Name(i));
+    KATANA_LOG_VASSERT(id, "{}", id.error());
+    KATANA_LOG_ASSERT(id.value() == i + 1);
+  }
+
+  // Intersections of each atomic type with the next one
+  std::vector<katana::EntityTypeID> pairs;
+  for (size_t i = 0; i + 1 < kNumAtomicTypes; ++i) {
+    auto id = manager.GetOrAddNonAtomicEntityTypeFromStrings(
+        std::vector<std::string>{Name(i), Name(i + 1)});
+    KATANA_LOG_VASSERT(id, "{}", id.error());
+    pairs.emplace_back(id.value());
+  }
+  KATANA_LOG_ASSERT(manager.GetNumEntityTypes() == 2 * kNumAtomicTypes);
+
+  for (size_t i = 0; i + 1 < kNumAtomicTypes; ++i) {
+    katana::EntityTypeID first = manager.GetEntityTypeID(Name(i));
+    katana::EntityTypeID second = manager.GetEntityTypeID(Name(i + 1));
+    katana::EntityTypeID pair = pairs[i];
+
+    KATANA_LOG_ASSERT(manager.IsSubtypeOf(first, pair));
+    KATANA_LOG_ASSERT(manager.IsSubtypeOf(second, pair));
+    KATANA_LOG_ASSERT(manager.IsSubtypeOf(pair, pair));
+    KATANA_LOG_ASSERT(!manager.IsSubtypeOf(pair, first));
+    KATANA_LOG_ASSERT(!manager.IsSubtypeOf(katana::kUnknownEntityType, pair));
+    if (i + 2 < kNumAtomicTypes) {
+      KATANA_LOG_ASSERT(!manager.IsSubtypeOf(pairs[i + 1], pair));
+    }
+
+    KATANA_LOG_ASSERT(manager.GetSupertypes(second).test(pair));
+    KATANA_LOG_ASSERT(manager.GetAtomicSubtypes(pair).count() == 2);
+
+    auto names = manager.EntityTypeToTypeNameSet(pair);
+    KATANA_LOG_ASSERT(names);
+    KATANA_LOG_ASSERT(
+        (names.value() == katana::TypeNameSet{Name(i), Name(i + 1)}));
+  }
+
+  // Finding an existing intersection does not add one
+  auto found = manager.GetNonAtomicEntityTypeFromStrings(
+      std::vector<std::string>{Name(kNumAtomicTypes - 1), Name(0)});
+  KATANA_LOG_ASSERT(!found);
+  auto existing = manager.GetOrAddNonAtomicEntityTypeFromStrings(
+      std::vector<std::string>{Name(1), Name(0)});
+  KATANA_LOG_ASSERT(existing && existing.value() == pairs[0]);
+  KATANA_LOG_ASSERT(manager.GetNumEntityTypes() == 2 * kNumAtomicTypes);
+
+  // A manager rebuilt from the type sets, as when loading an RDG, derives
+  // the same supertypes
+  katana::EntityTypeIDToAtomicTypeNameMap names =
+      manager.GetEntityTypeIDToAtomicTypeNameMap();
+  katana::EntityTypeIDToSetOfEntityTypeIDsMap type_sets =
+      manager.GetEntityTypeIDToAtomicEntityTypeIDs();
+  katana::EntityTypeManager rebuilt(std::move(names), std::move(type_sets));
+  KATANA_LOG_ASSERT(rebuilt.Equals(manager));
+}
+
+/// A table of num_bool bool and num_uint8 uint8 type properties, with nulls,
+/// and an int32 property that is not a type
+std::shared_ptr<arrow::Table>
+MakeTypeTable(int num_bool, int num_uint8, int64_t num_rows) {
+  std::mt19937 generator(num_bool + num_uint8);
+  // Runs of equal rows, as in sorted inputs, and a few random ones
+  std::uniform_int_distribution<int> value(0, 3);
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::Array>> columns;
+
+  arrow::Int32Builder ints;
+  for (int64_t row = 0; row < num_rows; ++row) {
+    KATANA_LOG_ASSERT(ints.Append(static_cast<int32_t>(row)).ok());
+  }
+  fields.emplace_back(arrow::field("id", arrow::int32()));
+  columns.emplace_back(ints.Finish().ValueOrDie());
+
+  for (int i = 0; i < num_bool + num_uint8; ++i) {
+    // Slice off the first row so arrays have an offset
+    arrow::BooleanBuilder bools;
+    arrow::UInt8Builder uint8s;
+    int v = value(generator);
+    for (int64_t row = 0; row < num_rows + 1; ++row) {
+      if (row % 1000 == 0) {
+        v = value(generator);
+      }
+      if (row % 7 == i % 7) {
+        v = value(generator);
+      }
+      bool null = v == 3;
+      if (i < num_bool) {
+        KATANA_LOG_ASSERT(
+            (null ? bools.AppendNull() : bools.Append(v & 1)).ok());
+      } else {
+        KATANA_LOG_ASSERT(
+            (null ? uint8s.AppendNull() : uint8s.Append(v * (v & 1))).ok());
+      }
+    }
+    std::shared_ptr<arrow::Array> array =
+        i < num_bool ? bools.Finish().ValueOrDie()
+                     : uint8s.Finish().ValueOrDie();
+    fields.emplace_back(arrow::field(Name(i), array->type()));
+    columns.emplace_back(array->Slice(1));
+  }
+  return arrow::Table::Make(arrow::schema(fields), columns);
+}
+
+/// Check AssignEntityTypeIDsFromProperties against the type properties set
+/// in every row
+void
+TestAssignFromProperties(int num_bool, int num_uint8, int64_t num_rows) {
+  std::shared_ptr<arrow::Table> table =
+      MakeTypeTable(num_bool, num_uint8, num_rows);
+  katana::EntityTypeManager manager;
+  std::vector<katana::EntityTypeID> ids(num_rows);
+  auto res = katana::EntityTypeManager::AssignEntityTypeIDsFromProperties(
+      num_rows, table, &manager, &ids);
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+
+  std::map<katana::TypeNameSet, katana::EntityTypeID> seen;
+  for (int64_t row = 0; row < num_rows; ++row) {
+    katana::TypeNameSet names;
+    for (int i = 0; i < num_bool + num_uint8; ++i) {
+      const std::shared_ptr<arrow::Array>& column =
+          table->column(i + 1)->chunk(0);
+      bool set = column->IsValid(row) &&
+                 (i < num_bool
+                      ? static_cast<const arrow::BooleanArray&>(*column).Value(
+                            row)
+                      : static_cast<const arrow::UInt8Array&>(*column).Value(
+                            row) != 0);
+      if (set) {
+        names.emplace(Name(i));
+      }
+    }
+    if (names.empty()) {
+      KATANA_LOG_ASSERT(ids[row] == katana::kUnknownEntityType);
+      continue;
+    }
+    auto found = manager.EntityTypeToTypeNameSet(ids[row]);
+    KATANA_LOG_ASSERT(found);
+    KATANA_LOG_VASSERT(found.value() == names, "row {}", row);
+    auto it = seen.emplace(names, ids[row]).first;
+    KATANA_LOG_ASSERT(it->second == ids[row]);
+  }
+  // Every type property is an atomic type, and only combinations that
+  // appear are added
+  size_t num_non_atomic = 0;
+  for (const auto& [names, id] : seen) {
+    num_non_atomic += names.size() > 1;
+  }
+  KATANA_LOG_ASSERT(
+      manager.GetNumEntityTypes() ==
+      1 + num_bool + num_uint8 + num_non_atomic);
+}
+
+}  // namespace
+
+int
+main() {
+  TestSetOfEntityTypeIDs();
+  TestManyTypes();
+  // Several blocks of rows
+  TestAssignFromProperties(3, 3, 100000);
+  // Too many type properties for masks
+  TestAssignFromProperties(40, 30, 5000);
+  return 0;
+}
@@ -0,0 +1,115 @@
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "katana/EventRecorder.h"
+#include "katana/Logging.h"
+
+namespace {
+
+constexpr int kThreads = 4;
+constexpr int kEvents = 100;
+
+void
+RecordLoop() {
+  for (int i = 0; i < kEvents; ++i) {
+    katana::EventScope loop(katana::EventRecorder::kLoop, "loop", i);
+    katana::EventScope barrier(
+        katana::EventRecorder::kBarrier, "a name that is too long to keep");
+    katana::EventRecorder::Record(
+        katana::EventRecorder::kWorklist, katana::EventRecorder::kCounter,
+        "pops", i);
+  }
+}
+
+void
+TestChromeTrace() {
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kThreads; ++i) {
+    threads.emplace_back(RecordLoop);
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  std::stringstream out;
+  katana::EventRecorder::WriteChromeTrace(out);
+  nlohmann::json trace = nlohmann::json::parse(out.str());
+  const auto& events = trace["traceEvents"];
+
+  int begins = 0;
+  int ends = 0;
+  int counters = 0;
+  double last_ts = 0;
+  for (const auto& event : events) {
+    double ts = event["ts"];
+    KATANA_LOG_ASSERT(ts >= last_ts);
+    last_ts = ts;
+    std::string ph = event["ph"];
+    begins += ph == "B";
+    ends += ph == "E";
+    counters += ph == "C";
+    std::string name = event["name"];
+    KATANA_LOG_ASSERT(
+        name.size() <= katana::EventRecorder::kMaxNameSize || ph == "C");
+  }
+  KATANA_LOG_VASSERT(
+      begins == 2 * kThreads * kEvents && ends == begins &&
+          counters == kThreads * kEvents,
+      "{} begins, {} ends, {} counters", begins, ends, counters);
+}
+
+void
+TestPerfettoTrace() {
+  std::stringstream out;
+  katana::EventRecorder::WritePerfettoTrace(out);
+  std::string trace = out.str();
+  // Every packet is field 1 of Trace, length delimited
+  KATANA_LOG_ASSERT(!trace.empty() && trace[0] == 0x0a);
+}
+
+void
+TestOverwrite() {
+  // Threads that exited gave their rings back; this one reuses one and
+  // overwrites its oldest events
+  std::thread thread([] {
+    for (int i = 0; i < 10 * 4096; ++i) {
+      katana::EventRecorder::Record(
+          katana::EventRecorder::kLoop, katana::EventRecorder::kInstant,
+          "instant", i);
+    }
+  });
+  thread.join();
+
+  std::stringstream out;
+  katana::EventRecorder::WriteChromeTrace(out);
+  nlohmann::json trace = nlohmann::json::parse(out.str());
+  uint64_t first = 0;
+  int instants = 0;
+  for (const auto& event : trace["traceEvents"]) {
+    if (event["ph"] == "i") {
+      uint64_t value = event["args"]["value"];
+      first = instants == 0 ? value : first;
+      ++instants;
+    }
+  }
+  KATANA_LOG_VASSERT(
+      instants > 0 && first + instants == 10 * 4096,
+      "{} instants from {}", instants, first);
+}
+
+}  // namespace
+
+int
+main() {
+  if (!katana::EventRecorder::IsEnabled()) {
+    return 0;
+  }
+  TestChromeTrace();
+  TestPerfettoTrace();
+  TestOverwrite();
+  return 0;
+}
@@ -0,0 +1,82 @@
+#include "katana/MemoryAccounting.h"
+
+#include <utility>
+
+#include "katana/ErrorCode.h"
+#include "katana/Logging.h"
+
+namespace {
+
+using katana::MemoryAccounting;
+using katana::MemoryCategory;
+
+void
+TestChargeAndPeak() {
+  MemoryAccounting::Charge(MemoryCategory::kViews, 1000).value();
+  MemoryAccounting::Charge(MemoryCategory::kViews, 500).value();
+  MemoryAccounting::Release(MemoryCategory::kViews, 1200);
+  KATANA_LOG_ASSERT(MemoryAccounting::current(MemoryCategory::kViews) == 300);
+  KATANA_LOG_ASSERT(MemoryAccounting::peak(MemoryCategory::kViews) == 1500);
+  KATANA_LOG_ASSERT(MemoryAccounting::total() == 300);
+
+  MemoryAccounting::ResetPeaks();
+  KATANA_LOG_ASSERT(MemoryAccounting::peak(MemoryCategory::kViews) == 300);
+  MemoryAccounting::Release(MemoryCategory::kViews, 300);
+}
+
+void
+TestBudget() {
+  MemoryAccounting::set_budget(1000);
+
+  katana::MemoryCharge charge(MemoryCategory::kProperties);
+  KATANA_LOG_ASSERT(charge.Resize(800));
+  auto res = charge.Resize(1200);
+  KATANA_LOG_ASSERT(!res && res.error() == katana::ErrorCode::OutOfMemory);
+  KATANA_LOG_ASSERT(charge.bytes() == 800);
+
+  // Other categories count against the same budget
+  KATANA_LOG_ASSERT(!MemoryAccounting::Charge(MemoryCategory::kIndexes, 300));
+  KATANA_LOG_ASSERT(
+      MemoryAccounting::current(MemoryCategory::kIndexes) == 0 &&
+      MemoryAccounting::total() == 800);
+
+  charge.ForceResize(1200);
+  KATANA_LOG_ASSERT(MemoryAccounting::total() == 1200);
+
+  katana::MemoryCharge moved(std::move(charge));
+  KATANA_LOG_ASSERT(charge.bytes() == 0 && moved.bytes() == 1200);
+  KATANA_LOG_ASSERT(moved.Resize(100));
+  KATANA_LOG_ASSERT(
+      MemoryAccounting::current(MemoryCategory::kProperties) == 100);
+
+  MemoryAccounting::set_budget(0);
+}
+
+void
+TestScope() {
+  KATANA_LOG_ASSERT(
+      katana::CurrentMemoryCategory() == MemoryCategory::kScratch);
+  {
+    katana::MemoryCategoryScope topology(MemoryCategory::kTopology);
+    {
+      katana::MemoryCategoryScope indexes(MemoryCategory::kIndexes);
+      KATANA_LOG_ASSERT(
+          katana::CurrentMemoryCategory() == MemoryCategory::kIndexes);
+    }
+    KATANA_LOG_ASSERT(
+        katana::CurrentMemoryCategory() == MemoryCategory::kTopology);
+  }
+  KATANA_LOG_ASSERT(
+      katana::CurrentMemoryCategory() == MemoryCategory::kScratch);
+}
+
+}  // namespace
+
+int
+main() {
+  TestChargeAndPeak();
+  TestBudget();
+  KATANA_LOG_ASSERT(MemoryAccounting::total() == 0);
+  TestScope();
+  return 0;
+}
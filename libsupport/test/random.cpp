@@ -1,12 +1,74 @@
 #include "katana/Random.h"
 
+#include <random>
 #include <thread>
 #include <vector>
 
 #include "katana/Logging.h"
 
+namespace {
+
+void
+TestPhilox() {
+  // Known answers from the Random123 distribution
+  using Block = katana::Philox4x32::Block;
+  KATANA_LOG_ASSERT(
+      katana::Philox4x32::Generate(0, 0, 0) ==
+      (Block{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}));
+  KATANA_LOG_ASSERT(
+      katana::Philox4x32::Generate(~uint64_t{0}, ~uint64_t{0}, ~uint64_t{0}) ==
+      (Block{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}));
+  KATANA_LOG_ASSERT(
+      katana::Philox4x32::Generate(
+          0x299f31d0a4093822, 0x85a308d3243f6a88, 0x0370734413198a2e) ==
+      (Block{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}));
+
+  // Batches match single blocks, including the tail that is not a
+  // multiple of the lanes
+  constexpr size_t kBlocks = 37;
+  std::vector<uint32_t> batch(4 * kBlocks);
+  katana::PhiloxGenerateBatch(42, 7, 1000, kBlocks, batch.data());
+  katana::CounterRng rng(42, 7, 1000);
+  for (uint32_t value : batch) {
+    KATANA_LOG_ASSERT(value == rng());
+  }
+
+  // Draws depend only on seed, item and position, not on the thread
+  std::vector<std::vector<uint32_t>> draws(16);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < draws.size(); ++t) {
+    threads.emplace_back([&draws, t]() {
+      katana::CounterRng item_rng(8675309, t % 2);
+      std::uniform_int_distribution<uint32_t> dist(0, 99);
+      for (int i = 0; i < 100; ++i) {
+        draws[t].emplace_back(dist(item_rng));
+      }
+    });
+  }
+  for (std::thread& t : threads) {
+    t.join();
+  }
+  for (size_t t = 2; t < draws.size(); ++t) {
+    KATANA_LOG_ASSERT(draws[t] == draws[t % 2]);
+  }
+  KATANA_LOG_ASSERT(draws[0] != draws[1]);
+
+  katana::CounterRng seeked(1, 2);
+  seeked.Seek(5);
+  katana::CounterRng counted(1, 2, 5);
+  KATANA_LOG_ASSERT(seeked() == counted());
+  for (int i = 0; i < 1000; ++i) {
+    double d = counted.NextDouble();
+    KATANA_LOG_ASSERT(d >= 0 && d < 1);
+  }
+}
+
+}  // namespace
+
 int
 main() {
+  TestPhilox();
+
   // test to make sure we have enough randomness
   std::vector<std::thread> threads;
   for (int i = 0; i < 128; ++i) {
@@ -19,6 +19,52 @@ struct CSRTopologyHeader {
   uint64_t num_edges{0};
 };
 
+/// Version of topology files whose destinations are stored as uint32_t
+constexpr uint64_t kCSRTopologyVersion = 1;
+
+/// Version of topology files whose destinations are stored as uint64_t, for
+/// graphs with more nodes than uint32_t can number. They are otherwise laid
+/// out like version 1 files.
+constexpr uint64_t kCSRTopology64Version = 2;
+
+/// The size of a destination in an uncompressed (version 1 or 2) CSR file
+constexpr uint64_t
+CSRTopologyDestSize(uint64_t version) {
+  return version == kCSRTopologyVersion ? sizeof(uint32_t) : sizeof(uint64_t);
+}
+
+/// Version of topology files whose destinations are stored compressed. Such
+/// files share the header and out index array with uncompressed ones, so
+/// CSRTopologyPrefix (and RDGPrefix) can read them unchanged. The out indexes
+/// are followed by:
+///
+///   CompressedCSRTopologyHeader
+///   uint64_t[num_blocks + 1] block_offsets: byte offset of each block in the
+///     payload; the last entry is the payload size
+///   uint8_t[payload_size] payload, padded to a multiple of 8 bytes
+///
+/// Edges are grouped by edge ID into blocks of edges_per_block edges. Each
+/// destination is stored as the zigzag LEB128 varint of its difference from a
+/// base: the source node for the first edge of a node or of a block, and the
+/// preceding destination otherwise. Blocks can therefore be decoded
+/// independently, and edge lists sorted by destination compress best.
+constexpr uint64_t kCompressedCSRTopologyVersion = 3;
+
+struct CompressedCSRTopologyHeader {
+  uint64_t edges_per_block{0};
+  uint64_t num_blocks{0};
+  uint64_t payload_size{0};
+};
+
+/// Version of derived topology files (see tsuba::DerivedTopologyInfo), which
+/// hold an edge shuffled topology, e.g., a transpose. They are laid out like
+/// version 1 files without edge data, with the destinations padded to a
+/// multiple of 8 bytes, and end with:
+///
+///   uint64_t[num_edges] edge_prop_indices: for each edge, the ID of the
+///     corresponding edge in the main topology, i.e., its property row
+constexpr uint64_t kDerivedCSRTopologyVersion = 4;
+
 /// The header and out index array of every CSR file. The length of out_indexes
 /// depends on the number of nodes.
 struct CSRTopologyPrefix {
@@ -26,15 +72,34 @@ struct CSRTopologyPrefix {
   uint64_t out_indexes[];  // NOLINT needed for layout
 };
 
+/// The size of an uncompressed (version 1 or 2) CSR file
 constexpr uint64_t
 CSRTopologyFileSize(const CSRTopologyHeader& header) {
-  uint64_t edge_size =
-      header.version == 1 ? sizeof(uint32_t) : sizeof(uint64_t);
+  uint64_t edge_size = CSRTopologyDestSize(header.version);
   return sizeof(header) + ((header.num_nodes) * sizeof(uint64_t)) +
          katana::AlignUp<uint64_t>(header.num_edges * edge_size) +
          (header.num_edges * header.edge_type_size);
 }
 
+/// The size of a compressed (kCompressedCSRTopologyVersion) CSR file
+constexpr uint64_t
+CompressedCSRTopologyFileSize(
+    const CSRTopologyHeader& header,
+    const CompressedCSRTopologyHeader& compressed_header) {
+  return sizeof(header) + ((header.num_nodes) * sizeof(uint64_t)) +
+         sizeof(compressed_header) +
+         ((compressed_header.num_blocks + 1) * sizeof(uint64_t)) +
+         katana::AlignUp<uint64_t>(compressed_header.payload_size);
+}
+
+/// The size of a derived (kDerivedCSRTopologyVersion) CSR file
+constexpr uint64_t
+DerivedCSRTopologyFileSize(const CSRTopologyHeader& header) {
+  return sizeof(header) + ((header.num_nodes) * sizeof(uint64_t)) +
+         katana::AlignUp<uint64_t>(header.num_edges * sizeof(uint32_t)) +
+         (header.num_edges * sizeof(uint64_t));
+}
+
 }  // namespace tsuba
 
 #endif
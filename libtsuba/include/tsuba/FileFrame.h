@@ -3,6 +3,7 @@
 
 #include <cstdint>
 #include <future>
+#include <memory>
 #include <string>
 
 #include <parquet/arrow/writer.h>
@@ -13,6 +14,8 @@
 namespace tsuba {
 
 class KATANA_EXPORT FileFrame : public arrow::io::OutputStream {
+  struct Stream;
+
   std::string path_;
   uint8_t* map_start_;
   uint64_t map_size_;
@@ -20,43 +23,24 @@ class KATANA_EXPORT FileFrame : public arrow::io::OutputStream {
   uint64_t cursor_;
   bool valid_ = false;
   bool synced_ = false;
+  std::unique_ptr<Stream> stream_;
 
   katana::Result<void> GrowBuffer(int64_t accommodate);
 
   katana::Result<void> MapContguousExtension(uint64_t new_size);
 
+  katana::Result<void> PutPart();
+  katana::Result<void> WaitForParts(size_t max_in_flight);
+  katana::Result<void> PersistParts();
+
 public:
-  FileFrame() = default;
+  static constexpr uint64_t kDefaultPartSize = UINT64_C(64) << 20;
+
+  FileFrame();
   FileFrame(const FileFrame&) = delete;
   FileFrame& operator=(const FileFrame&) = delete;
-
-  FileFrame(FileFrame&& other) noexcept
-      : path_(other.path_),
-        map_start_(other.map_start_),
-        map_size_(other.map_size_),
-        region_size_(other.region_size_),
-        cursor_(other.cursor_),
-        valid_(other.valid_),
-        synced_(other.synced_) {
-    other.valid_ = false;
-  }
-
-  FileFrame& operator=(FileFrame&& other) noexcept {
-    if (&other != this) {
-      if (auto res = Destroy(); !res) {
-        KATANA_LOG_ERROR("Destroy: {}", res.error());
-      }
-      path_ = other.path_;
-      map_start_ = other.map_start_;
-      map_size_ = other.map_size_;
-      region_size_ = other.region_size_;
-      cursor_ = other.cursor_;
-      synced_ = other.synced_;
-      valid_ = other.valid_;
-      other.valid_ = false;
-    }
-    return *this;
-  }
+  FileFrame(FileFrame&& other) noexcept;
+  FileFrame& operator=(FileFrame&& other) noexcept;
 
   ~FileFrame() override;
 
@@ -66,11 +50,21 @@ public:
 
   katana::Result<void> Destroy();
 
+  /// Store the file in parts while it is being written, once it outgrows
+  /// part_size bytes, so that at most about (max_parts_in_flight + 1) *
+  /// part_size bytes are held in memory however large it grows. The path
+  /// must be bound before the first part is full. Smaller files are stored
+  /// at once by Persist, as usual. Call after Init.
+  katana::Result<void> StartStreaming(
+      uint64_t part_size = kDefaultPartSize, uint32_t max_parts_in_flight = 2);
+
   katana::Result<void> Persist();
   std::future<katana::CopyableResult<void>> PersistAsync();
 
   uint64_t map_size() const { return map_size_; }
 
+  /// The bytes written since the last part was stored, which is all of them
+  /// unless streaming
   template <typename T>
   katana::Result<T*> ptr() const {
     return reinterpret_cast<T*>(map_start_); /* NOLINT */
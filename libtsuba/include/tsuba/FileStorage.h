@@ -3,6 +3,8 @@
 
 #include <cstdint>
 #include <future>
+#include <memory>
+#include <string>
 #include <string_view>
 #include <unordered_set>
 #include <vector>
@@ -14,6 +16,49 @@ namespace tsuba {
 
 struct StatBuf;
 
+/// A byte range of a file and the buffer to read it into
+struct FileRange {
+  uint64_t start;
+  uint64_t size;
+  uint8_t* result_buf;
+};
+
+/// How FileStorage::GetRangesAsync turns ranges into requests
+struct KATANA_EXPORT VectoredReadOptions {
+  /// Ranges at most this many bytes apart are fetched by one request; the
+  /// bytes in between are read and discarded
+  uint64_t max_gap{UINT64_C(1) << 20};
+  /// Coalescing stops once a request would grow past this size
+  uint64_t max_request_size{UINT64_C(64) << 20};
+  /// Requests larger than this are split into parts fetched in parallel
+  uint64_t part_size{UINT64_C(16) << 20};
+};
+
+/// Writes one file as a sequence of parts, e.g., with a multipart upload,
+/// so that early parts are stored while later ones are still being
+/// produced. Parts are contiguous and put in order of offset, but several
+/// may be in flight at once. The file is complete once Finish succeeds;
+/// destroying a writer before then abandons the file, though back-ends
+/// that write in place may leave a partial file behind.
+class KATANA_EXPORT MultipartWriter {
+public:
+  /// Back-ends may reject parts, other than the last, smaller than this
+  static constexpr uint64_t kMinPartSize = UINT64_C(5) << 20;
+
+  MultipartWriter() = default;
+  MultipartWriter(const MultipartWriter& no_copy) = delete;
+  MultipartWriter& operator=(const MultipartWriter& no_copy) = delete;
+  virtual ~MultipartWriter();
+
+  /// Store size bytes of data at offset; data must stay valid until the
+  /// returned future is ready
+  virtual std::future<katana::CopyableResult<void>> PutPartAsync(
+      uint64_t offset, const uint8_t* data, uint64_t size) = 0;
+
+  /// Complete the file once every part is ready
+  virtual katana::Result<void> Finish() = 0;
+};
+
 class KATANA_EXPORT FileStorage {
   std::string uri_scheme_;
 
@@ -54,6 +99,23 @@ public:
   virtual std::future<katana::CopyableResult<void>> GetAsync(
       const std::string& uri, uint64_t start, uint64_t size,
       uint8_t* result_buf) = 0;
+
+  /// Read many ranges of one file. The default implementation sorts the
+  /// ranges, coalesces the ones that are close together, splits large
+  /// requests into parts and issues all of them through GetAsync, so that a
+  /// scattered read costs a few large requests rather than one per range.
+  /// Ranges may overlap, but their buffers must not.
+  virtual std::future<katana::CopyableResult<void>> GetRangesAsync(
+      const std::string& uri, std::vector<FileRange> ranges,
+      const VectoredReadOptions& opts = VectoredReadOptions());
+
+  /// Start writing uri in parts. The default implementation collects the
+  /// parts in memory and stores them with PutMultiSync on Finish; back-ends
+  /// with multipart uploads or positional writes override it so that only
+  /// the parts in flight are held in memory.
+  virtual katana::Result<std::unique_ptr<MultipartWriter>> StartMultipartWrite(
+      const std::string& uri);
+
   virtual std::future<katana::CopyableResult<void>> ListAsync(
       const std::string& directory, std::vector<std::string>* list,
       std::vector<uint64_t>* size) = 0;
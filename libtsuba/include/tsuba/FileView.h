@@ -5,6 +5,8 @@
 #include <future>
 #include <optional>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <parquet/arrow/reader.h>
 
@@ -15,10 +17,26 @@
 namespace tsuba {
 
 class KATANA_EXPORT FileView : public arrow::io::RandomAccessFile {
+public:
+  /// How Read decides what to fetch ahead of the caller
+  enum class ReadaheadPolicy {
+    /// Prefetch the size of the last read plus 10%
+    kLastReadSize,
+    /// Start like kLastReadSize, then track sequential and random accesses
+    /// and grow (up to kMaxReadaheadPages) or shrink a readahead window
+    /// accordingly
+    kAdaptive,
+  };
+
+  /// Largest kAdaptive readahead window, unless a single read is larger
+  static constexpr uint64_t kMaxReadaheadPages = 256;
+
+private:
   struct FillingRange {
     uint64_t first_page;
     uint64_t last_page;
-    std::future<katana::CopyableResult<void>> work;
+    // Shared by all the ranges of one vectored read
+    std::shared_future<katana::CopyableResult<void>> work;
   };
 
   uint8_t* map_start_{nullptr};
@@ -31,6 +49,13 @@ class KATANA_EXPORT FileView : public arrow::io::RandomAccessFile {
   std::vector<uint64_t> filling_;
   std::unique_ptr<std::vector<FillingRange>> fetches_;
 
+  ReadaheadPolicy readahead_policy_{ReadaheadPolicy::kAdaptive};
+  // End of the previous Read or -1 if there was none
+  int64_t last_read_end_{-1};
+  uint64_t readahead_window_{0};
+  uint64_t readahead_hits_{0};
+  uint64_t readahead_misses_{0};
+
 public:
   FileView() = default;
   FileView(const FileView&) = delete;
@@ -45,7 +70,12 @@ public:
         filename_(std::move(other.filename_)),
         valid_(other.valid_),
         filling_(std::move(other.filling_)),
-        fetches_(std::move(other.fetches_)) {
+        fetches_(std::move(other.fetches_)),
+        readahead_policy_(other.readahead_policy_),
+        last_read_end_(other.last_read_end_),
+        readahead_window_(other.readahead_window_),
+        readahead_hits_(other.readahead_hits_),
+        readahead_misses_(other.readahead_misses_) {
     other.valid_ = false;
   }
 
@@ -64,6 +94,11 @@ public:
       filling_ = std::move(other.filling_);
       fetches_ =
           std::unique_ptr<std::vector<FillingRange>>(std::move(other.fetches_));
+      readahead_policy_ = other.readahead_policy_;
+      last_read_end_ = other.last_read_end_;
+      readahead_window_ = other.readahead_window_;
+      readahead_hits_ = other.readahead_hits_;
+      readahead_misses_ = other.readahead_misses_;
       other.valid_ = false;
     }
     return *this;
@@ -93,6 +128,18 @@ public:
 
   katana::Result<void> Fill(uint64_t begin, uint64_t end, bool resolve);
 
+  /// Fill many [begin, end) byte ranges with a single vectored read (see
+  /// FileStorage::GetRangesAsync). Prefer this to calling Fill once per range
+  /// when the ranges are known up front.
+  katana::Result<void> Fill(
+      const std::vector<std::pair<uint64_t, uint64_t>>& ranges, bool resolve);
+
+  /// Wait for the fills that overlap [begin, end), e.g., those started by
+  /// Bind or Fill with resolve=false to prefetch a range
+  katana::Result<void> Wait(uint64_t begin, uint64_t end) {
+    return Resolve(begin, end - begin);
+  }
+
   bool Valid() const { return valid_; }
 
   katana::Result<void> Unbind();
@@ -127,6 +174,18 @@ public:
 
   uint64_t size() const { return file_size_; }
 
+  ReadaheadPolicy readahead_policy() const { return readahead_policy_; }
+  void set_readahead_policy(ReadaheadPolicy policy) {
+    readahead_policy_ = policy;
+  }
+
+  /// Number of reads that were (or were not) already present in memory when
+  /// requested, i.e., how often readahead paid off
+  uint64_t readahead_hits() const { return readahead_hits_; }
+  uint64_t readahead_misses() const { return readahead_misses_; }
+  /// Bytes kAdaptive fetches behind the next read
+  uint64_t readahead_window() const { return readahead_window_; }
+
   // support iterating through characters
   const char* begin() const { return ptr<char>(); }
   const char* end() const { return ptr<char>() + size(); }
@@ -164,12 +223,20 @@ private:
   katana::Result<void> MarkFilled(
       uint64_t* bitmap, uint64_t begin, uint64_t end);
 
+  // Are all pages of [begin, end) already present or being fetched?
+  bool IsFilled(uint64_t begin, uint64_t end);
+
+  // Shared implementation of the Read methods: make [cursor_, cursor_ +
+  // nbytes) resident and start readahead behind it
+  arrow::Status PrepareRead(int64_t nbytes);
+
   // Resolve all outstanding reads that overlap with the range [cursor_, nbytes]
   katana::Result<void> Resolve(int64_t start, int64_t size);
 
   // Start asynchronously fetching data that we think we might need from storage
-  // @start and @size give the location and range of the previous read
-  katana::Result<void> PreFetch(int64_t start, int64_t size);
+  // @start and @size give the location and range of the previous read and
+  // @hit whether that range was already in memory
+  katana::Result<void> PreFetch(int64_t start, int64_t size, bool hit);
 };
 }  // namespace tsuba
 
@@ -0,0 +1,79 @@
+#ifndef KATANA_LIBTSUBA_TSUBA_IOSTATS_H_
+#define KATANA_LIBTSUBA_TSUBA_IOSTATS_H_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "katana/config.h"
+
+namespace tsuba {
+
+/// Requests of one kind, reads or writes, to one storage backend
+struct KATANA_EXPORT IORequestStats {
+  static constexpr size_t kNumLatencyBuckets = 32;
+
+  uint64_t requests{0};
+  uint64_t bytes{0};
+  /// Bucket 0 counts requests that took less than a microsecond; bucket i
+  /// counts those that took from 2^(i-1) up to 2^i microseconds. The last
+  /// bucket also counts anything slower. Asynchronous requests are timed
+  /// until their result is taken.
+  std::vector<uint64_t> latency_us_histogram =
+      std::vector<uint64_t>(kNumLatencyBuckets);
+};
+
+struct KATANA_EXPORT IOSchemeStats {
+  IORequestStats reads;
+  IORequestStats writes;
+};
+
+/// IOStats counts the storage work tsuba has done since it was loaded or
+/// since the last ResetIOStats
+struct KATANA_EXPORT IOStats {
+  /// By the URI scheme of the storage backend, e.g., "file" or "s3"
+  std::map<std::string, IOSchemeStats> schemes;
+
+  /// FileView pages read because a reader needed them
+  uint64_t pages_faulted{0};
+  /// FileView pages read ahead of readers
+  uint64_t pages_prefetched{0};
+  /// Time readers spent waiting for FileView reads to finish
+  uint64_t fill_wait_ns{0};
+
+  /// Parquet files read into tables and the time it took, which includes
+  /// waiting for their FileViews
+  uint64_t tables_decoded{0};
+  uint64_t decode_ns{0};
+
+  /// Operations added to ReadGroups and WriteGroups and the time spent in
+  /// their Finish waiting for them
+  uint64_t read_group_ops{0};
+  uint64_t read_group_wait_ns{0};
+  uint64_t write_group_ops{0};
+  uint64_t write_group_wait_ns{0};
+
+  /// Property loads found in a PropertyCache or not, and entries pushed out
+  /// of one
+  uint64_t cache_hits{0};
+  uint64_t cache_misses{0};
+  uint64_t cache_evictions{0};
+
+  /// RDGManifests and partition headers found in the metadata cache or not,
+  /// see MetadataCacheOptions
+  uint64_t metadata_cache_hits{0};
+  uint64_t metadata_cache_misses{0};
+};
+
+KATANA_EXPORT IOStats GetIOStats();
+
+KATANA_EXPORT void ResetIOStats();
+
+/// Log GetIOStats as a "storage io" event of the active span, if there is
+/// one
+KATANA_EXPORT void TraceIOStats();
+
+}  // namespace tsuba
+
+#endif
@@ -29,9 +29,16 @@ public:
     bool make_cannonical{true};
 
     /// if provided, slice the resulting table so that it only contains
-    /// Slice.length rows starting from Slice.offset
+    /// Slice.length rows starting from Slice.offset. Only the column chunks
+    /// of the row groups that overlap the slice are read from storage.
     std::optional<Slice> slice{std::nullopt};
 
+    /// if true, the columns of a row group are decoded in parallel on
+    /// arrow's CPU thread pool rather than on the calling thread, and the
+    /// files of a blocked table are read on up to one thread per hardware
+    /// thread
+    bool use_threads{false};
+
     static ReadOpts Defaults() { return ReadOpts{}; }
   };
 
@@ -47,8 +54,8 @@ public:
   katana::Result<std::shared_ptr<arrow::Table>> ReadTable(
       const katana::Uri& uri);
 
-  /// read part of a table from storage
-  /// n.b. support for the `slice` read option is missing here
+  /// read part of a table from storage; only the selected columns are read
+  /// from storage
   ///   \param uri an identifier for a parquet file
   ///   \param column_bitmap must have the same length as the number of columns
   ///      in the table in the parquet file. The loaded table will only contain
@@ -61,7 +68,6 @@ public:
       const katana::Uri& uri);
 
   /// read a column part of a table from storage
-  /// n.b. support for the `slice` read option is missing here
   ///   \param uri an identifier for a parquet file
   ///   \param column_idx must be a valid column index for the table in that
   ///      file
@@ -77,8 +83,11 @@ public:
   katana::Result<int64_t> NumRows(const katana::Uri& uri);
 
 private:
-  ParquetReader(std::optional<Slice> slice, bool make_cannonical)
-      : slice_(slice), make_cannonical_{make_cannonical} {}
+  ParquetReader(
+      std::optional<Slice> slice, bool make_cannonical, bool use_threads)
+      : slice_(slice),
+        make_cannonical_{make_cannonical},
+        use_threads_{use_threads} {}
 
   katana::Result<std::shared_ptr<arrow::Table>> ReadFromUriSliced(
       const katana::Uri& uri);
@@ -91,6 +100,7 @@ private:
 
   std::optional<Slice> slice_;
   bool make_cannonical_;
+  bool use_threads_;
 };
 
 }  // namespace tsuba
@@ -1,10 +1,12 @@
 #ifndef KATANA_LIBTSUBA_TSUBA_PARQUETWRITER_H_
 #define KATANA_LIBTSUBA_TSUBA_PARQUETWRITER_H_
 
+#include <functional>
 #include <limits>
 #include <vector>
 
 #include <arrow/api.h>
+#include <arrow/util/compression.h>
 #include <parquet/properties.h>
 
 #include "katana/Result.h"
@@ -13,8 +15,39 @@
 
 namespace tsuba {
 
+/// How the values of one column are compressed and encoded
+struct KATANA_EXPORT ColumnCodec {
+  arrow::Compression::type compression{arrow::Compression::UNCOMPRESSED};
+  /// the codec's own default unless set, e.g., 1 (fast) to 19 for ZSTD
+  int compression_level{arrow::util::kUseDefaultCompressionLevel};
+  /// dictionary encode values, falling back to encoding once the dictionary
+  /// grows too large
+  bool dictionary{true};
+  /// the encoding of values that are not dictionary encoded, e.g.,
+  /// BYTE_STREAM_SPLIT for floats. Only applies to columns of primitive
+  /// type; nested columns keep parquet's default
+  parquet::Encoding::type encoding{parquet::Encoding::PLAIN};
+};
+
+/// Chooses the codec of a column of a table about to be written
+using CodecPolicy = std::function<ColumnCodec(
+    const arrow::Field& field, const arrow::ChunkedArray& column)>;
+
 class KATANA_EXPORT ParquetWriter {
 public:
+  /// A policy that chooses every column's codec from a sample of its values:
+  /// byte-stream-split floats, delta encoded sorted integers where the
+  /// parquet library can write them, no compression for values that do not
+  /// compress, and otherwise LZ4 or the ZSTD level that pays off
+  static CodecPolicy AutoCodecPolicy();
+
+  /// A policy that uses codec for every column
+  static CodecPolicy FixedCodecPolicy(ColumnCodec codec);
+
+  /// The codec that AutoCodecPolicy chooses for column
+  static ColumnCodec ChooseColumnCodec(
+      const arrow::Field& field, const arrow::ChunkedArray& column);
+
   struct WriteOpts {
     /// int64 timestamps with nanosecond resolution requires Parquet version
     /// 2.0. In Arrow to Parquet version 1.0, nanosecond timestamps will get
@@ -31,6 +64,22 @@ public:
 
     /// control the approximate size of blocked files when writing blocked
     uint64_t mbs_per_block{256};
+
+    /// the maximum number of rows in a row group. Sliced reads (see
+    /// ParquetReader::ReadOpts::slice) fetch whole row groups, so smaller row
+    /// groups reduce the data read for small slices
+    int64_t max_row_group_length{parquet::DEFAULT_MAX_ROW_GROUP_LENGTH};
+
+    /// files larger than this are stored in parts of this size while they
+    /// are encoded (see FileFrame::StartStreaming), so encoding a large
+    /// table does not hold the whole file in memory. 0 stores files whole
+    uint64_t streaming_part_size{FileFrame::kDefaultPartSize};
+
+    /// chooses how each column is compressed and encoded; empty is the same
+    /// as AutoCodecPolicy. Codecs are chosen per file, so the blocks of a
+    /// blocked write may differ
+    CodecPolicy codec_policy{AutoCodecPolicy()};
+
     static WriteOpts Defaults() { return WriteOpts{}; }
   };
 
@@ -62,10 +111,6 @@ private:
       std::vector<std::shared_ptr<arrow::Table>> tables, WriteOpts opts)
       : tables_(std::move(tables)), opts_(opts) {}
 
-  std::shared_ptr<parquet::WriterProperties> StandardWriterProperties();
-
-  std::shared_ptr<parquet::ArrowWriterProperties> StandardArrowProperties();
-
   katana::Result<void> StoreParquet(
       const katana::Uri& uri, tsuba::WriteGroup* desc);
 
@@ -0,0 +1,78 @@
+#ifndef KATANA_LIBTSUBA_TSUBA_PARTITIONEDLOAD_H_
+#define KATANA_LIBTSUBA_TSUBA_PARTITIONEDLOAD_H_
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "katana/Result.h"
+#include "katana/config.h"
+#include "tsuba/PartitionMetadata.h"
+#include "tsuba/RDGPrefix.h"
+#include "tsuba/RDGSlice.h"
+#include "tsuba/tsuba.h"
+
+namespace tsuba {
+
+/// Split the nodes of a CSR into num_hosts contiguous ranges [first, second)
+/// with about the same number of edges each. out_indexes[n] is the end of the
+/// edges of node n, as in RDGPrefix::out_indexes. Graphs without edges are
+/// split by nodes.
+KATANA_EXPORT std::vector<std::pair<uint64_t, uint64_t>>
+ComputeEdgeBalancedRanges(
+    const uint64_t* out_indexes, uint64_t num_nodes, uint32_t num_hosts);
+
+/// The RDGSlice::SliceArg of the nodes [node_range.first, node_range.second)
+/// of the graph of prefix. The topology part of the slice is only the
+/// destinations of the edges of those nodes; their indexes are in prefix.
+KATANA_EXPORT RDGSlice::SliceArg MakeSliceArg(
+    const RDGPrefix& prefix, std::pair<uint64_t, uint64_t> node_range);
+
+/// The part of an unpartitioned RDG that one host loads with
+/// LoadPartitionedSlice: an outgoing edge cut in which every host owns a
+/// contiguous range of nodes and their edges
+struct KATANA_EXPORT PartitionedSlice {
+  /// The properties and topology of the owned nodes and their edges
+  RDGSlice slice;
+  PartitionMetadata metadata;
+
+  /// The nodes owned by every host, in order of host ID
+  std::vector<std::pair<uint64_t, uint64_t>> host_ranges;
+
+  /// The global ID of every local node: the owned nodes in order, then the
+  /// ghosts, i.e., the destinations owned by other hosts, in ascending order
+  std::vector<uint64_t> local_to_global;
+
+  /// The local CSR: out_indexes[n] is the end of the edges of owned node n,
+  /// counted from the first edge of the host, and edge_dests are local IDs
+  std::vector<uint64_t> out_indexes;
+  std::vector<uint32_t> edge_dests;
+
+  /// mirrors[h] holds the local IDs of the owned nodes that are ghosts on
+  /// host h, in ascending order of global ID, i.e., the nodes whose values
+  /// host h reads
+  std::vector<std::vector<uint32_t>> mirrors;
+
+  /// The host that owns global node n
+  uint32_t GetHostID(uint64_t n) const;
+  /// The local ID of global node n, which must be owned or a ghost
+  uint32_t GetLocalID(uint64_t n) const;
+};
+
+/// Load the slice of the RDG of handle that belongs to this host in an edge
+/// balanced partition among all hosts of tsuba::Comm, build its local CSR
+/// and ghost nodes, and exchange the mirror lists with the other hosts. This
+/// is a collective operation; all hosts must call it with the same graph.
+/// Global node IDs are 64-bit, so graphs with more nodes than a GraphTopology
+/// can number (kCSRTopology64Version files) load as long as the nodes of each
+/// host do.
+KATANA_EXPORT katana::Result<PartitionedSlice> LoadPartitionedSlice(
+    RDGHandle handle,
+    const std::optional<std::vector<std::string>>& node_props = std::nullopt,
+    const std::optional<std::vector<std::string>>& edge_props = std::nullopt);
+
+}  // namespace tsuba
+
+#endif
@@ -1,7 +1,7 @@
 #ifndef KATANA_LIBTSUBA_TSUBA_PROPERTYCACHE_H_
 #define KATANA_LIBTSUBA_TSUBA_PROPERTYCACHE_H_
 
-#include "katana/Cache.h"
+#include "katana/ConcurrentCache.h"
 
 namespace tsuba {
 
@@ -31,8 +31,11 @@ struct KATANA_EXPORT PropertyCacheKey {
 
 // Property names are unique, and we enforce that.
 // Each table should only contain a single column.
+//
+// The cache is thread safe so that a single instance can be shared by
+// concurrent RDG loads (see RDGLoadOptions::prop_cache).
 using PropertyCache =
-    katana::Cache<PropertyCacheKey, std::shared_ptr<arrow::Table>>;
+    katana::ConcurrentCache<PropertyCacheKey, std::shared_ptr<arrow::Table>>;
 
 }  // namespace tsuba
 
@@ -6,6 +6,7 @@
 #include <optional>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include <arrow/api.h>
 #include <arrow/chunked_array.h>
@@ -30,6 +31,8 @@ namespace tsuba {
 class RDGManifest;
 class RDGCore;
 class PropStorageInfo;
+class PropertyLoadLimiter;
+struct PropertyPrefetches;
 
 struct KATANA_EXPORT RDGLoadOptions {
   /// Which partition of the RDG on storage should be loaded
@@ -43,6 +46,67 @@ struct KATANA_EXPORT RDGLoadOptions {
   /// nullptr means all edge properties will be loaded
   std::optional<std::vector<std::string>> edge_properties{std::nullopt};
   tsuba::PropertyCache* prop_cache{nullptr};
+  /// Maximum number of property files fetched and decoded at the same time
+  /// 0 means one per hardware thread
+  uint32_t max_concurrent_property_loads{0};
+  /// If true, the columns of each property file, and the files of a blocked
+  /// property, are decoded in parallel on arrow's CPU thread pool
+  bool parallel_property_decode{false};
+  /// If true, only the properties named in node_properties and
+  /// edge_properties are loaded, and nullopt means none rather than all.
+  /// The other properties are registered but absent, and PropertyGraph
+  /// loads each one when it is first accessed by name.
+  bool load_properties_on_access{false};
+  /// If true, Make returns once the topology and entity types are loaded.
+  /// The properties it would otherwise load, as selected by node_properties
+  /// and edge_properties, are registered but absent and start loading in
+  /// the background, through the same limiter as other loads. Accessing one
+  /// by name waits for just its column; this implies
+  /// load_properties_on_access. Graphs of older formats, which store their
+  /// entity types as properties, are loaded as without this option.
+  bool load_properties_in_background{false};
+};
+
+/// A topology derived from the main topology of an RDG partition, e.g., its
+/// transpose or a copy with sorted edge lists, that is stored with the
+/// partition so that it does not have to be rebuilt after loading. The states
+/// are opaque to tsuba; libgalois records EdgeShuffleTopology::TransposeKind
+/// and EdgeSortKind values in them.
+struct KATANA_EXPORT DerivedTopologyInfo {
+  /// File name relative to the RDG directory
+  std::string path;
+  int32_t transpose_state{0};
+  int32_t edge_sort_state{0};
+  uint64_t num_nodes{0};
+  uint64_t num_edges{0};
+};
+
+/// A serialized derived topology for RDG::Store to persist. info.path is
+/// filled in by Store.
+struct KATANA_EXPORT DerivedTopologyFrame {
+  DerivedTopologyInfo info;
+  std::unique_ptr<FileFrame> ff;
+};
+
+/// An index over a property of an RDG partition that is stored with the
+/// partition so that it does not have to be rebuilt after loading. It is
+/// dropped when its property is upserted or removed. The file and kind are
+/// opaque to tsuba; libgalois records katana::PropertyIndexKind values in
+/// kind.
+struct KATANA_EXPORT PropertyIndexInfo {
+  /// File name relative to the RDG directory
+  std::string path;
+  std::string property_name;
+  bool is_edge_property{false};
+  int32_t kind{0};
+  uint64_t num_entities{0};
+};
+
+/// A serialized property index for RDG::Store to persist. info.path is
+/// filled in by Store.
+struct KATANA_EXPORT PropertyIndexFrame {
+  PropertyIndexInfo info;
+  std::unique_ptr<FileFrame> ff;
 };
 
 class KATANA_EXPORT RDG {
@@ -60,6 +124,11 @@ public:
   /// in their own dedicated structures
   bool IsEntityTypeIDsOutsideProperties() const;
 
+  /// The size in bytes of each EntityTypeID in the stored type ID arrays,
+  /// which is smaller than sizeof(katana::EntityTypeID) for RDGs stored
+  /// before EntityTypeIDs were widened
+  size_t EntityTypeIDStorageSize() const;
+
   /// Perform some checks on assumed invariants
   katana::Result<void> Validate() const;
 
@@ -77,6 +146,8 @@ public:
   /// @param edge_entity_type_id_array_ff :: if not nullptr, it is persisted as the edge_entity_type_id_array for this RDG.
   /// @param node_entity_type_manager :: persisted as the node EntityTypeID -> Atomic node EntityType id mapping and Atomic node EntityType ID -> Atomic EntityType Name
   /// @param edge_entity_type_manager :: persisted as the edge EntityTypeID -> Atomic node EntityType id mapping and Atomic edge EntityType ID -> Atomic EntityType Name
+  /// @param derived_topology_ffs :: persisted as derived topologies, replacing stored ones with the same states. If topology_ff, node_entity_type_id_array_ff or edge_entity_type_id_array_ff is not nullptr, all previously stored derived topologies are dropped first.
+  /// @param property_index_ffs :: persisted as property indexes, replacing stored ones over the same property with the same kind.
   katana::Result<void> Store(
       RDGHandle handle, const std::string& command_line,
       RDGVersioningPolicy versioning_action,
@@ -84,7 +155,9 @@ public:
       std::unique_ptr<FileFrame> node_entity_type_id_array_ff,
       std::unique_ptr<FileFrame> edge_entity_type_id_array_ff,
       const katana::EntityTypeManager& node_entity_type_manager,
-      const katana::EntityTypeManager& edge_entity_type_manager);
+      const katana::EntityTypeManager& edge_entity_type_manager,
+      std::vector<DerivedTopologyFrame> derived_topology_ffs = {},
+      std::vector<PropertyIndexFrame> property_index_ffs = {});
 
   /// @brief Store new version of the RDG with lineage based on command line.
   /// @param handle :: handle indicating where to store RDG
@@ -169,9 +242,34 @@ public:
   /// cannot be loaded more than once
   katana::Result<void> LoadEdgeProperty(const std::string& name, int i = -1);
 
+  /// Start loading the named node properties in the background. A later
+  /// LoadNodeProperty of one of them waits for and uses its prefetched
+  /// column. Properties that are loaded, unknown or already being
+  /// prefetched are ignored.
+  katana::Result<void> PrefetchNodeProperties(
+      const std::vector<std::string>& names);
+
+  /// Start loading the named edge properties in the background; see
+  /// PrefetchNodeProperties
+  katana::Result<void> PrefetchEdgeProperties(
+      const std::vector<std::string>& names);
+
+  /// Whether this RDG was made with RDGLoadOptions::load_properties_on_access
+  /// or RDGLoadOptions::load_properties_in_background
+  bool load_properties_on_access() const { return load_properties_on_access_; }
+
   std::vector<std::string> ListNodeProperties() const;
   std::vector<std::string> ListEdgeProperties() const;
 
+  /// The katana::ContentDigest of the node property \p name recorded in the
+  /// metadata when it was stored, or an empty string if it was modified
+  /// since or none was recorded
+  std::string NodePropertyContentDigest(const std::string& name) const;
+
+  /// The recorded katana::ContentDigest of the edge property \p name; see
+  /// NodePropertyContentDigest
+  std::string EdgePropertyContentDigest(const std::string& name) const;
+
   /// Explain to graph how it is derived from previous version
   void AddLineage(const std::string& command_line);
 
@@ -234,6 +332,22 @@ public:
   /// Remove topology data
   katana::Result<void> DropTopology();
 
+  /// The derived topologies stored with this partition. They were all
+  /// derived from the current topology.
+  const std::vector<DerivedTopologyInfo>& derived_topologies() const;
+
+  /// Map the file of one of derived_topologies()
+  katana::Result<std::unique_ptr<FileView>> MapDerivedTopology(
+      const DerivedTopologyInfo& info) const;
+
+  /// The property indexes stored with this partition. They were all built
+  /// from the current values of their properties.
+  const std::vector<PropertyIndexInfo>& property_indexes() const;
+
+  /// Map the file of one of property_indexes()
+  katana::Result<std::unique_ptr<FileView>> MapPropertyIndex(
+      const PropertyIndexInfo& info) const;
+
   std::shared_ptr<arrow::Schema> full_node_schema() const;
 
   std::shared_ptr<arrow::Schema> full_edge_schema() const;
@@ -301,6 +415,12 @@ public:
 
   void set_view_name(const std::string& v) { view_type_ = v; }
 
+  /// The number of threads used to compute the content digests of properties
+  /// when they are stored or unloaded; see katana::ContentDigest
+  void set_digest_threads(unsigned num_threads) {
+    digest_threads_ = num_threads;
+  }
+
 private:
   std::string view_type_;
   RDG(std::unique_ptr<RDGCore>&& core);
@@ -330,6 +450,14 @@ private:
       RDGHandle handle, std::unique_ptr<FileFrame> topology_ff,
       std::unique_ptr<WriteGroup>& write_group);
 
+  katana::Result<void> DoStoreDerivedTopologies(
+      RDGHandle handle, std::vector<DerivedTopologyFrame> derived_topology_ffs,
+      std::unique_ptr<WriteGroup>& write_group);
+
+  katana::Result<void> DoStorePropertyIndexes(
+      RDGHandle handle, std::vector<PropertyIndexFrame> property_index_ffs,
+      std::unique_ptr<WriteGroup>& write_group);
+
   katana::Result<void> DoStoreNodeEntityTypeIDArray(
       RDGHandle handle, std::unique_ptr<FileFrame> node_entity_type_id_array_ff,
       std::unique_ptr<WriteGroup>& write_group);
@@ -345,6 +473,12 @@ private:
   std::unique_ptr<RDGCore> core_;
   // Optional property cache
   PropertyCache* prop_cache_{nullptr};
+  // Shared by all property loads of this RDG
+  std::shared_ptr<PropertyLoadLimiter> prop_load_limiter_;
+  // Property loads started by Prefetch*Properties; null until the first one
+  std::unique_ptr<PropertyPrefetches> prefetches_;
+  bool load_properties_on_access_{false};
+  unsigned digest_threads_{1};
 
   std::vector<std::shared_ptr<arrow::ChunkedArray>> mirror_nodes_;
   std::vector<std::shared_ptr<arrow::ChunkedArray>> master_nodes_;
@@ -0,0 +1,165 @@
+#ifndef KATANA_LIBTSUBA_TSUBA_RDGEDGESTREAM_H_
+#define KATANA_LIBTSUBA_TSUBA_RDGEDGESTREAM_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "katana/Result.h"
+#include "katana/config.h"
+#include "tsuba/CSRTopology.h"
+#include "tsuba/FileView.h"
+#include "tsuba/tsuba.h"
+
+namespace tsuba {
+
+/// Streams the edges of an RDG topology from storage in blocks, for
+/// out-of-core processing of graphs whose edges do not fit in memory, in the
+/// manner of X-Stream and GridGraph: per-node state stays in memory while
+/// each pass over the edges reads every block once, in order.
+///
+/// Only the header and out indexes of the topology are held for the life of
+/// the stream. Blocks are read through FileViews; while the caller works on
+/// one block the following ones are fetched, and at most
+/// max_resident_blocks blocks, including the current one, are in memory.
+///
+/// \code
+/// KATANA_CHECKED(stream->Rewind());
+/// while (true) {
+///   const RDGEdgeStream::Block* block = KATANA_CHECKED(stream->Next());
+///   if (block == nullptr) {
+///     break;
+///   }
+///   for (uint64_t n = block->first_node(); n < block->end_node(); ++n) {
+///     auto [begin, end] = block->edges(n);
+///     for (uint64_t e = begin; e < end; ++e) {
+///       Visit(n, block->dest(e));
+///     }
+///   }
+/// }
+/// \endcode
+///
+/// Uncompressed topologies (versions 1, 2 and derived topologies) can be
+/// streamed.
+class KATANA_EXPORT RDGEdgeStream {
+public:
+  struct Options {
+    /// the approximate number of bytes of destinations in a block
+    uint64_t block_bytes{64UL << 20};
+    /// the number of blocks in memory at once; 2 is double buffering
+    uint32_t max_resident_blocks{2};
+  };
+
+  /// Edges [edge_begin, edge_end) of the topology. A block starts and ends
+  /// anywhere in the out edges of a node, so a node with more edges than a
+  /// block spans several blocks. Valid until the next call to Next or
+  /// Rewind.
+  class Block {
+  public:
+    uint64_t edge_begin() const { return edge_begin_; }
+    uint64_t edge_end() const { return edge_end_; }
+
+    /// The nodes with edges in the block are [first_node, end_node)
+    uint64_t first_node() const { return first_node_; }
+    uint64_t end_node() const { return end_node_; }
+
+    /// The edges of n that are in the block
+    std::pair<uint64_t, uint64_t> edges(uint64_t n) const {
+      uint64_t begin = n == 0 ? 0 : out_indexes_[n - 1];
+      return {
+          std::max(begin, edge_begin_), std::min(out_indexes_[n], edge_end_)};
+    }
+
+    uint64_t dest(uint64_t e) const {
+      uint64_t offset = dests_offset_ + e * dest_size_;
+      if (dest_size_ == sizeof(uint32_t)) {
+        return *view_->ptr<uint32_t>(offset);
+      }
+      return *view_->ptr<uint64_t>(offset);
+    }
+
+  private:
+    friend class RDGEdgeStream;
+
+    const FileView* view_{};
+    const uint64_t* out_indexes_{};
+    uint64_t dests_offset_{0};
+    uint64_t dest_size_{0};
+    uint64_t edge_begin_{0};
+    uint64_t edge_end_{0};
+    uint64_t first_node_{0};
+    uint64_t end_node_{0};
+  };
+
+  /// Stream the topology of the RDG handle refers to
+  static katana::Result<std::unique_ptr<RDGEdgeStream>> Make(
+      RDGHandle handle, const Options& opts = Options());
+
+  /// Stream a topology file
+  static katana::Result<std::unique_ptr<RDGEdgeStream>> Make(
+      const std::string& topology_uri, const Options& opts = Options());
+
+  RDGEdgeStream(const RDGEdgeStream& no_copy) = delete;
+  RDGEdgeStream& operator=(const RDGEdgeStream& no_copy) = delete;
+
+  uint64_t num_nodes() const { return header_.num_nodes; }
+  uint64_t num_edges() const { return header_.num_edges; }
+  uint64_t num_blocks() const { return num_blocks_; }
+
+  /// out_indexes()[n] is the end of the out edges of n
+  const uint64_t* out_indexes() const { return out_indexes_; }
+
+  uint64_t out_degree(uint64_t n) const {
+    return out_indexes_[n] - (n == 0 ? 0 : out_indexes_[n - 1]);
+  }
+
+  /// Start a pass over the blocks and prefetch its first ones
+  katana::Result<void> Rewind();
+
+  /// The next block of the pass, or nullptr once all have been returned.
+  /// Releases the block returned before.
+  katana::Result<const Block*> Next();
+
+private:
+  static constexpr uint64_t kNoBlock = ~uint64_t{0};
+
+  struct Slot {
+    FileView view;
+    // The block the view holds, or kNoBlock
+    uint64_t block{kNoBlock};
+  };
+
+  RDGEdgeStream(
+      std::string topology_uri, const Options& opts, CSRTopologyHeader header,
+      FileView&& prefix);
+
+  std::pair<uint64_t, uint64_t> BlockEdges(uint64_t block) const;
+  std::pair<uint64_t, uint64_t> BlockBytes(uint64_t block) const;
+
+  katana::Result<void> Prefetch();
+  katana::Result<void> Release(Slot* slot);
+
+  std::string topology_uri_;
+  Options opts_;
+  CSRTopologyHeader header_;
+  FileView prefix_;
+  const uint64_t* out_indexes_{};
+  uint64_t dests_offset_{0};
+  uint64_t dest_size_{0};
+  uint64_t edges_per_block_{1};
+  uint64_t num_blocks_{0};
+
+  std::vector<Slot> slots_;
+  // The next block to return and to prefetch in this pass
+  uint64_t next_block_{0};
+  uint64_t next_prefetch_{0};
+  Slot* current_{nullptr};
+  Block block_;
+};
+
+}  // namespace tsuba
+
+#endif
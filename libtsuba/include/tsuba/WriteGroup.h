@@ -1,9 +1,13 @@
 #ifndef KATANA_LIBTSUBA_TSUBA_WRITEGROUP_H_
 #define KATANA_LIBTSUBA_TSUBA_WRITEGROUP_H_
 
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
 #include <future>
-#include <list>
 #include <memory>
+#include <mutex>
+#include <string>
 
 #include "katana/Result.h"
 #include "tsuba/AsyncOpGroup.h"
@@ -14,25 +18,54 @@ namespace tsuba {
 
 /// Track multiple, outstanding async writes and provide a mechanism to ensure
 /// that they have all completed
+///
+/// Writes are pipelined: StartEncodeAndStore runs a bounded number of encoders
+/// concurrently and each encoded FileFrame is persisted while later ones
+/// encode. The bytes of encoded frames that have not yet been persisted are
+/// capped at max_outstanding_size; when the cap is reached, encoders (and the
+/// callers of StartStore) wait for earlier writes to finish, so memory stays
+/// bounded and the store proceeds at the speed of the storage backend.
 class WriteGroup {
-  struct AsyncOp {
-    std::future<katana::CopyableResult<void>> result;
-    std::string location;
-    uint64_t accounted_size;
-  };
-
   std::string tag_;
-  std::atomic<uint64_t> outstanding_size_{0};
   AsyncOpGroup async_op_group_;
 
-  WriteGroup(std::string tag) : tag_(std::move(tag)){};
+  uint64_t max_outstanding_size_;
+  uint32_t max_concurrent_encodes_;
+
+  // Protects outstanding_size_ and active_encodes_
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  uint64_t outstanding_size_{0};
+  uint32_t active_encodes_{0};
+
+  WriteGroup(
+      std::string tag, uint64_t max_outstanding_size,
+      uint32_t max_concurrent_encodes)
+      : tag_(std::move(tag)),
+        max_outstanding_size_(max_outstanding_size),
+        max_concurrent_encodes_(max_concurrent_encodes) {}
+
+  /// Wait until \p size more bytes may be in flight and account for them.
+  /// Returns the size that was accounted, which must be released.
+  uint64_t ReserveOutstanding(uint64_t size);
+  void ReleaseOutstanding(uint64_t size);
+
+  void AcquireEncodeSlot();
+  void ReleaseEncodeSlot();
 
 public:
   static constexpr uint64_t kMaxOutstandingSize = 10ULL << 30;  // 10 GB
 
   /// Build a descriptor with a tag. If running with multiple hosts, Make should
   /// be Called BSP style and all hosts will have the same tag
-  static katana::Result<std::unique_ptr<WriteGroup>> Make();
+  ///
+  /// \param max_outstanding_size bytes of encoded data allowed to wait for or
+  ///     be in the middle of being persisted
+  /// \param max_concurrent_encodes encoders allowed to run at once; 0 means
+  ///     one per hardware thread
+  static katana::Result<std::unique_ptr<WriteGroup>> Make(
+      uint64_t max_outstanding_size = kMaxOutstandingSize,
+      uint32_t max_concurrent_encodes = 0);
 
   /// Return a random tag that uniquely identifies this op
   const std::string& tag() const { return tag_; }
@@ -48,14 +81,18 @@ public:
     AddOp(FileStoreAsync(file, buf, size), file);
   }
 
-  void AddToOutstanding(uint64_t size) { outstanding_size_ += size; }
+  /// Run \p encode asynchronously and persist the FileFrame it returns. This
+  /// blocks while max_concurrent_encodes encoders are running. The encoder
+  /// keeps its slot until its output fits under max_outstanding_size, which is
+  /// what pushes back on callers when storage is slower than encoding.
+  void StartEncodeAndStore(
+      std::string file,
+      std::function<katana::CopyableResult<std::shared_ptr<FileFrame>>()>
+          encode);
 
   /// Add future to the list of futures this descriptor will wait for, note
-  /// the file name for debugging. If the operation is associated with a file
-  /// frame that we are responsible for, note the size
-  void AddOp(
-      std::future<katana::CopyableResult<void>> future, std::string file,
-      uint64_t accounted_size = 0);
+  /// the file name for debugging
+  void AddOp(std::future<katana::CopyableResult<void>> future, std::string file);
 };
 
 }  // namespace tsuba
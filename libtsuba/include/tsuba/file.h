@@ -3,13 +3,16 @@
 
 #include <cstdint>
 #include <future>
+#include <memory>
 #include <string>
 #include <string_view>
 #include <type_traits>
 #include <unordered_set>
+#include <vector>
 
 #include "katana/Result.h"
 #include "katana/config.h"
+#include "tsuba/FileStorage.h"
 
 namespace tsuba {
 
@@ -30,6 +33,12 @@ RoundUpToBlock(T val) {
 
 struct StatBuf {
   uint64_t size{UINT64_C(0)};
+  /// Last modification time in nanoseconds since the epoch, or 0 if the
+  /// backend does not report one
+  uint64_t mtime_ns{UINT64_C(0)};
+  /// Entity tag of an object store, or empty if the backend does not report
+  /// one
+  std::string etag;
 };
 
 // Returns an error file uri does not exist
@@ -69,6 +78,12 @@ KATANA_EXPORT katana::Result<void> FileRemoteCopy(
     const std::string& source_uri, const std::string& dest_uri, uint64_t begin,
     uint64_t size);
 
+/// Start writing a file in parts, see MultipartWriter
+///
+/// \param uri the destination file
+KATANA_EXPORT katana::Result<std::unique_ptr<MultipartWriter>>
+FileStartMultipartWrite(const std::string& uri);
+
 /// Take whatever is in a buffer and put it in the file
 ///
 /// \param uri the destination file to fill with data
@@ -93,6 +108,12 @@ FileGet(const StrType& uri, T* obj) {
 KATANA_EXPORT std::future<katana::CopyableResult<void>> FileGetAsync(
     const std::string& uri, void* result_buffer, uint64_t begin, uint64_t size);
 
+/// start reading many parts of a file into caller defined buffers; see
+/// FileStorage::GetRangesAsync
+KATANA_EXPORT std::future<katana::CopyableResult<void>> FileGetRangesAsync(
+    const std::string& uri, std::vector<FileRange> ranges,
+    const VectoredReadOptions& opts = VectoredReadOptions());
+
 /// List the set of files in a directory
 /// \param directory is URI whose contents are listed. It can be
 /// Async return type allows this function to be called repeatedly (and
@@ -110,14 +110,60 @@ KATANA_EXPORT katana::Result<std::vector<std::pair<katana::Uri, katana::Uri>>>
 CreateSrcDestFromViewsForCopy(
     const std::string& src_dir, const std::string& dst_dir, uint64_t version);
 
+/// How CopyRDG copies files
+struct KATANA_EXPORT CopyRDGOptions {
+  /// Files copied at once
+  uint32_t num_parallel_copies{16};
+  /// Bytes of file contents held in memory at once by copies that the
+  /// storage service cannot do itself, e.g., between back-ends. A larger
+  /// file is copied alone.
+  uint64_t max_buffered_bytes{UINT64_C(1) << 30};
+};
+
 /// CopyRDG copies RDG files from a source to a destination.
 /// E.g. SRC_DIR/part_vers0003_rdg_node00000 -> DST_DIR/part_vers0001_rdg_node_00000
 /// The argument is a list of source and destination pairs as an RDG consists of many files.
 /// See CreateSrcDestFromViewsForCopy for how to generate this list from an RDG prefix and version
+///
+/// Files are copied in parallel. Within one back-end, a file is copied by
+/// FileRemoteCopy, i.e., by the storage service without passing through
+/// this host; otherwise it is read and stored within
+/// CopyRDGOptions::max_buffered_bytes. A data file is skipped if the
+/// destination, in the same back-end, has it with the same size and entity
+/// tag; every other file is copied, even over a file of the same size.
+/// Manifests are written last, so an interrupted copy is not a valid RDG.
 /// \param src_dst_files is a vector of src-dest pairs for individual RDG files
 /// \returns a Result to indicate whether the method succeeded or failed
 KATANA_EXPORT katana::Result<void> CopyRDG(
-    std::vector<std::pair<katana::Uri, katana::Uri>> src_dst_files);
+    std::vector<std::pair<katana::Uri, katana::Uri>> src_dst_files,
+    const CopyRDGOptions& opts = CopyRDGOptions());
+
+/// How tsuba reuses the RDGManifests and partition headers it has parsed.
+/// Both name their version, e.g., katana_vers00000000000000000003_rdg.manifest,
+/// so they are cached by URI. Files that tsuba writes or deletes are dropped
+/// from the cache.
+struct KATANA_EXPORT MetadataCacheOptions {
+  /// Files whose contents are kept; the least recently used are dropped
+  /// first. 0 disables the cache.
+  size_t max_entries{1024};
+  /// Before reusing a file's contents, check with FileStat that its size,
+  /// modification time and ETag have not changed; files of backends that
+  /// report neither are not cached. Without validation a cached file costs
+  /// no requests to storage, which is safe when RDG files are only rewritten
+  /// by this process.
+  bool validate{true};
+  /// When a single host opens an RDG with several partitions, read all of
+  /// their headers at once, num_parallel_reads at a time
+  bool prefetch_part_headers{true};
+  uint32_t num_parallel_reads{16};
+};
+
+KATANA_EXPORT void SetMetadataCacheOptions(const MetadataCacheOptions& opts);
+
+KATANA_EXPORT MetadataCacheOptions GetMetadataCacheOptions();
+
+/// Forget every RDGManifest and partition header read so far
+KATANA_EXPORT void ClearMetadataCache();
 
 // Setup and tear down
 KATANA_EXPORT katana::Result<void> Init(katana::CommBackend* comm);
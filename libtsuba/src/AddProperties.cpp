@@ -1,10 +1,13 @@
 #include "AddProperties.h"
 
+#include <algorithm>
 #include <memory>
 #include <optional>
+#include <thread>
 
 #include <arrow/chunked_array.h>
 
+#include "IOStats_internal.h"
 #include "katana/ProgressTracer.h"
 #include "katana/Result.h"
 #include "tsuba/Errors.h"
@@ -17,9 +20,11 @@ namespace {
 katana::Result<std::shared_ptr<arrow::Table>>
 DoLoadProperties(
     const std::string& expected_name, const katana::Uri& file_path,
+    bool use_threads,
     std::optional<tsuba::ParquetReader::Slice> slice = std::nullopt) {
   auto read_opts = tsuba::ParquetReader::ReadOpts::Defaults();
   read_opts.slice = slice;
+  read_opts.use_threads = use_threads;
   auto reader_res = tsuba::ParquetReader::Make(read_opts);
   if (!reader_res) {
     return reader_res.error().WithContext("loading property");
@@ -48,13 +53,89 @@ DoLoadProperties(
   return out;
 }
 
+using TableFuture =
+    std::future<katana::CopyableResult<std::shared_ptr<arrow::Table>>>;
+
+/// Run load on a thread of limiter or, if it is null, when the future is
+/// waited on
+template <typename LoadFn>
+TableFuture
+StartLoad(tsuba::PropertyLoadLimiter* limiter, LoadFn load) {
+  if (!limiter) {
+    return std::async(std::launch::deferred, std::move(load));
+  }
+  auto task = std::make_shared<std::packaged_task<
+      katana::CopyableResult<std::shared_ptr<arrow::Table>>()>>(
+      std::move(load));
+  TableFuture future = task->get_future();
+  limiter->Run([task]() { (*task)(); });
+  return future;
+}
+
 }  // namespace
 
+tsuba::PropertyLoadLimiter::PropertyLoadLimiter(
+    uint32_t max_concurrent, bool use_threads)
+    : max_concurrent_(
+          max_concurrent > 0
+              ? max_concurrent
+              : std::max(1U, std::thread::hardware_concurrency())),
+      use_threads_(use_threads) {}
+
+tsuba::PropertyLoadLimiter::~PropertyLoadLimiter() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  cv_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+void
+tsuba::PropertyLoadLimiter::Run(std::function<void()> load) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.emplace_back(std::move(load));
+    if (num_idle_ < queue_.size() && threads_.size() < max_concurrent_) {
+      threads_.emplace_back([this]() { Work(); });
+      return;
+    }
+  }
+  cv_.notify_one();
+}
+
+size_t
+tsuba::PropertyLoadLimiter::num_threads() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return threads_.size();
+}
+
+void
+tsuba::PropertyLoadLimiter::Work() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    ++num_idle_;
+    cv_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+    --num_idle_;
+    if (queue_.empty()) {
+      return;
+    }
+    std::function<void()> load = std::move(queue_.front());
+    queue_.pop_front();
+    lock.unlock();
+    load();
+    lock.lock();
+  }
+}
+
 katana::Result<std::shared_ptr<arrow::Table>>
 tsuba::LoadProperties(
-    const std::string& expected_name, const katana::Uri& file_path) {
+    const std::string& expected_name, const katana::Uri& file_path,
+    bool use_threads) {
   try {
-    return DoLoadProperties(expected_name, file_path);
+    return DoLoadProperties(expected_name, file_path, use_threads);
   } catch (const std::exception& exp) {
     return KATANA_ERROR(
         tsuba::ErrorCode::ArrowError, "arrow exception: {}", exp.what());
@@ -64,10 +145,10 @@ tsuba::LoadProperties(
 katana::Result<std::shared_ptr<arrow::Table>>
 tsuba::LoadPropertySlice(
     const std::string& expected_name, const katana::Uri& file_path,
-    int64_t offset, int64_t length) {
+    int64_t offset, int64_t length, bool use_threads) {
   try {
     return DoLoadProperties(
-        expected_name, file_path,
+        expected_name, file_path, use_threads,
         tsuba::ParquetReader::Slice{.offset = offset, .length = length});
   } catch (const std::exception& exp) {
     return KATANA_ERROR(
@@ -75,22 +156,44 @@ tsuba::LoadPropertySlice(
   }
 }
 
+std::future<katana::CopyableResult<std::shared_ptr<arrow::Table>>>
+tsuba::LoadPropertiesAsync(
+    const std::string& expected_name, const katana::Uri& file_path,
+    std::shared_ptr<PropertyLoadLimiter> limiter) {
+  bool use_threads = limiter && limiter->use_threads();
+  return StartLoad(
+      limiter.get(),
+      [expected_name, file_path, use_threads]()
+          -> katana::CopyableResult<std::shared_ptr<arrow::Table>> {
+        return KATANA_CHECKED_CONTEXT(
+            LoadProperties(expected_name, file_path, use_threads),
+            "error loading {}", file_path);
+      });
+}
+
 katana::Result<void>
 tsuba::AddProperties(
     const katana::Uri& uri, tsuba::PropertyCacheKey* cache_key,
     tsuba::PropertyCache* cache,
     const std::vector<tsuba::PropStorageInfo*>& properties, ReadGroup* grp,
     const std::function<katana::Result<void>(std::shared_ptr<arrow::Table>)>&
-        add_fn) {
+        add_fn,
+    std::shared_ptr<PropertyLoadLimiter> limiter) {
   for (tsuba::PropStorageInfo* prop : properties) {
     if (!prop->IsAbsent()) {
       return KATANA_ERROR(
           ErrorCode::Exists, "property {} must be absent to be added",
           std::quoted(prop->name()));
     }
+    // The key is copied per property because completions may run
+    // concurrently with each other and with other loads sharing the cache.
+    // Loads without a cache, e.g., of partition metadata, pass no key.
+    tsuba::PropertyCacheKey key(tsuba::NodeEdge::kNode);
     if (cache != nullptr) {
-      cache_key->name = prop->name();
-      auto column_table = cache->Get(*cache_key);
+      key = *cache_key;
+      key.name = prop->name();
+      auto column_table = cache->Get(key);
+      tsuba::RecordPropertyCacheLookup(column_table.has_value());
       if (column_table) {
         auto props = column_table.value();
         KATANA_CHECKED_CONTEXT(
@@ -100,24 +203,17 @@ tsuba::AddProperties(
         auto upsert_scope =
             tracer.StartActiveSpan("property loaded from cache");
         upsert_scope.span().SetTags({
-            {"type", (cache_key->node_edge == tsuba::NodeEdge::kNode) ? "node"
-                                                                      : "edge"},
+            {"type",
+             (key.node_edge == tsuba::NodeEdge::kNode) ? "node" : "edge"},
             {"name", prop->name()},
         });
-        return katana::ResultSuccess();
+        continue;
       }
     }
     const katana::Uri& path = uri.Join(prop->path());
 
-    std::future<katana::CopyableResult<std::shared_ptr<arrow::Table>>> future =
-        std::async(
-            std::launch::async,
-            [prop,
-             path]() -> katana::CopyableResult<std::shared_ptr<arrow::Table>> {
-              return KATANA_CHECKED_CONTEXT(
-                  LoadProperties(prop->name(), path), "error loading {}", path);
-            });
-    auto on_complete = [add_fn, prop, cache_key,
+    TableFuture future = LoadPropertiesAsync(prop->name(), path, limiter);
+    auto on_complete = [add_fn, prop, key,
                         cache](const std::shared_ptr<arrow::Table>& props)
         -> katana::CopyableResult<void> {
       KATANA_CHECKED_CONTEXT(
@@ -128,12 +224,11 @@ tsuba::AddProperties(
         auto upsert_scope =
             tracer.StartActiveSpan("property inserted into cache");
         upsert_scope.span().SetTags({
-            {"type", (cache_key->node_edge == tsuba::NodeEdge::kNode) ? "node"
-                                                                      : "edge"},
+            {"type",
+             (key.node_edge == tsuba::NodeEdge::kNode) ? "node" : "edge"},
             {"name", prop->name()},
         });
-        cache_key->name = prop->name();
-        cache->Insert(*cache_key, props);
+        tsuba::RecordPropertyCacheEvictions(cache->Insert(key, props));
       }
       return katana::CopyableResultSuccess();
     };
@@ -156,7 +251,9 @@ tsuba::AddPropertySlice(
     const std::vector<tsuba::PropStorageInfo*>& properties,
     std::pair<uint64_t, uint64_t> range, ReadGroup* grp,
     const std::function<katana::Result<void>(std::shared_ptr<arrow::Table>)>&
-        add_fn) {
+        add_fn,
+    std::shared_ptr<PropertyLoadLimiter> limiter) {
+  bool use_threads = limiter && limiter->use_threads();
   uint64_t begin = range.first;
   uint64_t size = range.second - range.first;
   for (tsuba::PropStorageInfo* prop : properties) {
@@ -167,19 +264,17 @@ tsuba::AddPropertySlice(
     }
     const katana::Uri& path = dir.Join(prop->path());
 
-    std::future<katana::CopyableResult<std::shared_ptr<arrow::Table>>> future =
-        std::async(
-            std::launch::async,
-            [path, prop, begin,
-             size]() -> katana::CopyableResult<std::shared_ptr<arrow::Table>> {
-              auto load_result =
-                  LoadPropertySlice(prop->name(), path, begin, size);
-              if (!load_result) {
-                return load_result.error().WithContext(
-                    "error loading {}", path);
-              }
-              return load_result.value();
-            });
+    TableFuture future = StartLoad(
+        limiter.get(),
+        [path, name = prop->name(), begin, size, use_threads]()
+            -> katana::CopyableResult<std::shared_ptr<arrow::Table>> {
+          auto load_result =
+              LoadPropertySlice(name, path, begin, size, use_threads);
+          if (!load_result) {
+            return load_result.error().WithContext("error loading {}", path);
+          }
+          return load_result.value();
+        });
     auto on_complete = [add_fn,
                         prop](const std::shared_ptr<arrow::Table>& props)
         -> katana::CopyableResult<void> {
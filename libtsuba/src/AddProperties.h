@@ -1,6 +1,18 @@
 #ifndef KATANA_LIBTSUBA_ADDPROPERTIES_H_
 #define KATANA_LIBTSUBA_ADDPROPERTIES_H_
 
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
 #include <arrow/api.h>
 
 #include "RDGPartHeader.h"
@@ -10,26 +22,101 @@
 
 namespace tsuba {
 
+/// Runs the property file loads of AddProperties and AddPropertySlice on a
+/// fixed number of threads, so that loading many properties does not
+/// oversubscribe the host with threads and in-flight buffers. One limiter is
+/// shared by all the loads of an RDG; loads wait in FIFO order for a thread.
+class KATANA_EXPORT PropertyLoadLimiter {
+public:
+  /// \param max_concurrent loads allowed at once, i.e., threads; 0 means
+  ///     one per hardware thread
+  /// \param use_threads if true, each load also decodes its columns, and the
+  ///     files of a blocked property, in parallel (see
+  ///     ParquetReader::ReadOpts::use_threads)
+  PropertyLoadLimiter(uint32_t max_concurrent, bool use_threads);
+
+  /// Runs the loads already queued and stops the threads
+  ~PropertyLoadLimiter();
+
+  PropertyLoadLimiter(const PropertyLoadLimiter&) = delete;
+  PropertyLoadLimiter& operator=(const PropertyLoadLimiter&) = delete;
+
+  /// Queue load to run on one of the threads; a thread is started for it if
+  /// none is idle and there are fewer than max_concurrent(). load must not
+  /// refer to the limiter, which may be destroyed by its last owner while
+  /// loads are queued.
+  void Run(std::function<void()> load);
+
+  uint32_t max_concurrent() const { return max_concurrent_; }
+  bool use_threads() const { return use_threads_; }
+
+  /// The number of threads started so far
+  size_t num_threads() const;
+
+private:
+  void Work();
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::function<void()>> queue_;
+  std::vector<std::thread> threads_;
+  uint32_t num_idle_{0};
+  bool stopping_{false};
+  uint32_t max_concurrent_;
+  bool use_threads_;
+};
+
 KATANA_EXPORT katana::Result<std::shared_ptr<arrow::Table>> LoadProperties(
-    const std::string& expected_name, const katana::Uri& file_path);
+    const std::string& expected_name, const katana::Uri& file_path,
+    bool use_threads = false);
 
 KATANA_EXPORT katana::Result<std::shared_ptr<arrow::Table>> LoadPropertySlice(
     const std::string& expected_name, const katana::Uri& file_path,
-    int64_t offset, int64_t length);
+    int64_t offset, int64_t length, bool use_threads = false);
+
+/// Start loading the property in \p file_path on a thread of \p limiter; if
+/// \p limiter is null the load runs when the future is waited on
+KATANA_EXPORT std::future<katana::CopyableResult<std::shared_ptr<arrow::Table>>>
+LoadPropertiesAsync(
+    const std::string& expected_name, const katana::Uri& file_path,
+    std::shared_ptr<PropertyLoadLimiter> limiter);
+
+/// A property load started by RDG::PrefetchNodeProperties or
+/// RDG::PrefetchEdgeProperties before the property is asked for
+struct PropertyPrefetch {
+  /// PropStorageInfo::path() when the load started; a prefetch whose
+  /// property has been written since then is stale
+  std::string path;
+  std::future<katana::CopyableResult<std::shared_ptr<arrow::Table>>> table;
+};
+
+/// The outstanding prefetches of an RDG by property name
+struct PropertyPrefetches {
+  std::unordered_map<std::string, PropertyPrefetch> node;
+  std::unordered_map<std::string, PropertyPrefetch> edge;
+};
+
+/// Load \p properties from the files under \p uri and pass each table to
+/// \p add_fn. If \p grp is not null the loads run asynchronously and
+/// add_fn is called from grp->Finish(); otherwise they run one at a time.
+/// The loads run on the threads of \p limiter, or one at a time when their
+/// results are needed if it is null.
 
 KATANA_EXPORT katana::Result<void> AddProperties(
     const katana::Uri& uri, tsuba::PropertyCacheKey* key,
     tsuba::PropertyCache* cache,
     const std::vector<tsuba::PropStorageInfo*>& properties, ReadGroup* grp,
     const std::function<katana::Result<void>(std::shared_ptr<arrow::Table>)>&
-        add_fn);
+        add_fn,
+    std::shared_ptr<PropertyLoadLimiter> limiter = nullptr);
 
 KATANA_EXPORT katana::Result<void> AddPropertySlice(
     const katana::Uri& dir,
     const std::vector<tsuba::PropStorageInfo*>& properties,
     std::pair<uint64_t, uint64_t> range, ReadGroup* grp,
     const std::function<katana::Result<void>(std::shared_ptr<arrow::Table>)>&
-        add_fn);
+        add_fn,
+    std::shared_ptr<PropertyLoadLimiter> limiter = nullptr);
 
 }  // namespace tsuba
 
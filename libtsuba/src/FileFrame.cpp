@@ -2,6 +2,9 @@
 
 #include <sys/mman.h>
 
+#include <algorithm>
+#include <deque>
+
 #include "katana/Logging.h"
 #include "katana/Platform.h"
 #include "katana/Result.h"
@@ -10,6 +13,56 @@
 
 namespace tsuba {
 
+/// The state of a frame that stores its file in parts
+struct FileFrame::Stream {
+  struct Part {
+    uint8_t* buf;
+    uint64_t buf_size;
+    std::future<katana::CopyableResult<void>> stored;
+  };
+
+  uint64_t part_size;
+  uint32_t max_parts_in_flight;
+  std::unique_ptr<MultipartWriter> writer;
+  // The bytes in parts already put
+  uint64_t offset{0};
+  std::deque<Part> in_flight;
+  bool finished{false};
+};
+
+FileFrame::FileFrame() = default;
+
+FileFrame::FileFrame(FileFrame&& other) noexcept
+    : path_(other.path_),
+      map_start_(other.map_start_),
+      map_size_(other.map_size_),
+      region_size_(other.region_size_),
+      cursor_(other.cursor_),
+      valid_(other.valid_),
+      synced_(other.synced_),
+      stream_(std::move(other.stream_)) {
+  other.valid_ = false;
+}
+
+FileFrame&
+FileFrame::operator=(FileFrame&& other) noexcept {
+  if (&other != this) {
+    if (auto res = Destroy(); !res) {
+      KATANA_LOG_ERROR("Destroy: {}", res.error());
+    }
+    path_ = other.path_;
+    map_start_ = other.map_start_;
+    map_size_ = other.map_size_;
+    region_size_ = other.region_size_;
+    cursor_ = other.cursor_;
+    synced_ = other.synced_;
+    valid_ = other.valid_;
+    stream_ = std::move(other.stream_);
+    other.valid_ = false;
+  }
+  return *this;
+}
+
 FileFrame::~FileFrame() {
   if (auto res = Destroy(); !res) {
     KATANA_LOG_ERROR("Destroy failed in ~FileFrame");
@@ -18,6 +71,13 @@ FileFrame::~FileFrame() {
 
 katana::Result<void>
 FileFrame::Destroy() {
+  if (stream_) {
+    // Parts in flight still read their buffers
+    if (auto res = WaitForParts(0); !res) {
+      KATANA_LOG_DEBUG("abandoning {}: {}", path_, res.error());
+    }
+    stream_.reset();
+  }
   if (valid_) {
     int err = munmap(map_start_, map_size_);
     valid_ = false;
@@ -97,6 +157,10 @@ FileFrame::GrowBuffer(int64_t accommodate) {
   while (cursor_ + accommodate > new_size) {
     new_size *= 2;
   }
+  if (stream_) {
+    // Writes are split so as not to go past a part
+    new_size = std::min(new_size, stream_->part_size);
+  }
   auto res = MapContguousExtension(new_size);
   if (!res && cursor_ + accommodate < new_size) {
     // our power of 2 alloc failed, but there's a chance a smaller ask
@@ -106,6 +170,83 @@ FileFrame::GrowBuffer(int64_t accommodate) {
   return res;
 }
 
+katana::Result<void>
+FileFrame::StartStreaming(uint64_t part_size, uint32_t max_parts_in_flight) {
+  if (!valid_) {
+    return KATANA_ERROR(ErrorCode::InvalidArgument, "not initialized");
+  }
+  stream_ = std::make_unique<Stream>();
+  stream_->part_size = tsuba::RoundUpToBlock(
+      std::max(part_size, MultipartWriter::kMinPartSize));
+  stream_->max_parts_in_flight = std::max<uint32_t>(max_parts_in_flight, 1);
+  return katana::ResultSuccess();
+}
+
+/// Wait for the oldest parts until at most max_in_flight are left, and
+/// unmap their buffers
+katana::Result<void>
+FileFrame::WaitForParts(size_t max_in_flight) {
+  katana::Result<void> result = katana::ResultSuccess();
+  while (stream_->in_flight.size() > max_in_flight) {
+    Stream::Part& part = stream_->in_flight.front();
+    if (auto res = part.stored.get(); !res && result) {
+      result = katana::ErrorInfo(res.error());
+    }
+    if (munmap(part.buf, part.buf_size) && result) {
+      result = KATANA_ERROR(katana::ResultErrno(), "unmapping part");
+    }
+    stream_->in_flight.pop_front();
+  }
+  return result;
+}
+
+/// Start storing the bytes since the last part and map a buffer for the
+/// next one
+katana::Result<void>
+FileFrame::PutPart() {
+  if (!stream_->writer) {
+    if (path_.empty()) {
+      return KATANA_ERROR(ErrorCode::InvalidArgument, "no path provided");
+    }
+    stream_->writer = KATANA_CHECKED(tsuba::FileStartMultipartWrite(path_));
+  }
+  stream_->in_flight.emplace_back(Stream::Part{
+      .buf = map_start_,
+      .buf_size = map_size_,
+      .stored = stream_->writer->PutPartAsync(
+          stream_->offset, map_start_, cursor_),
+  });
+  stream_->offset += cursor_;
+  valid_ = false;
+
+  KATANA_CHECKED_CONTEXT(
+      WaitForParts(stream_->max_parts_in_flight), "storing {}", path_);
+  void* ptr = katana::MmapPopulate(
+      nullptr, stream_->part_size, PROT_READ | PROT_WRITE,
+      MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+  if (ptr == MAP_FAILED) {
+    return KATANA_ERROR(katana::ResultErrno(), "mapping part");
+  }
+  map_start_ = static_cast<uint8_t*>(ptr);
+  map_size_ = stream_->part_size;
+  cursor_ = 0;
+  valid_ = true;
+  return katana::ResultSuccess();
+}
+
+/// Put the last part, wait for all of them and complete the file
+katana::Result<void>
+FileFrame::PersistParts() {
+  auto last_res =
+      stream_->writer->PutPartAsync(stream_->offset, map_start_, cursor_)
+          .get();
+  KATANA_CHECKED_CONTEXT(WaitForParts(0), "storing {}", path_);
+  KATANA_CHECKED_CONTEXT(std::move(last_res), "storing {}", path_);
+  KATANA_CHECKED_CONTEXT(stream_->writer->Finish(), "storing {}", path_);
+  stream_->finished = true;
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 FileFrame::Persist() {
   if (!valid_) {
@@ -114,6 +255,12 @@ FileFrame::Persist() {
   if (path_.empty()) {
     return KATANA_ERROR(tsuba::ErrorCode::InvalidArgument, "no path provided");
   }
+  if (stream_ && stream_->finished) {
+    return KATANA_ERROR(ErrorCode::InvalidArgument, "already stored");
+  }
+  if (stream_ && stream_->writer) {
+    return PersistParts();
+  }
   if (auto res = tsuba::FileStore(path_, map_start_, cursor_); !res) {
     return res.error();
   }
@@ -134,6 +281,13 @@ FileFrame::PersistAsync() {
           return KATANA_ERROR(ErrorCode::InvalidArgument, "no path provided");
         });
   }
+  if (stream_ && stream_->writer) {
+    return std::async(
+        std::launch::async, [this]() -> katana::CopyableResult<void> {
+          KATANA_CHECKED(Persist());
+          return katana::CopyableResultSuccess();
+        });
+  }
   return tsuba::FileStoreAsync(path_, map_start_, cursor_);
 }
 
@@ -152,6 +306,9 @@ FileFrame::Tell() const {
   if (!valid_) {
     return -1;
   }
+  if (stream_) {
+    return stream_->offset + cursor_;
+  }
   return cursor_;
 }
 
@@ -169,15 +326,42 @@ FileFrame::Write(const void* data, int64_t nbytes) {
     return arrow::Status(
         arrow::StatusCode::Invalid, "Cannot Write negative bytes");
   }
-  if (cursor_ + nbytes > map_size_) {
-    if (auto res = GrowBuffer(nbytes); !res) {
-      return arrow::Status(
-          arrow::StatusCode::OutOfMemory,
-          "FileFrame could not grow buffer to hold incoming write");
+  if (!stream_) {
+    if (cursor_ + nbytes > map_size_) {
+      if (auto res = GrowBuffer(nbytes); !res) {
+        return arrow::Status(
+            arrow::StatusCode::OutOfMemory,
+            "FileFrame could not grow buffer to hold incoming write");
+      }
+    }
+    memcpy(map_start_ + cursor_, data, nbytes);
+    cursor_ += nbytes;
+    return arrow::Status::OK();
+  }
+
+  // A part is put once more bytes follow it, so a file of one part is
+  // stored at once
+  const auto* src = static_cast<const uint8_t*>(data);
+  while (nbytes > 0) {
+    if (cursor_ >= stream_->part_size) {
+      if (auto res = PutPart(); !res) {
+        return arrow::Status::IOError("FileFrame::PutPart: ", res.error());
+      }
+    }
+    uint64_t size =
+        std::min<uint64_t>(nbytes, stream_->part_size - cursor_);
+    if (cursor_ + size > map_size_) {
+      if (auto res = GrowBuffer(size); !res) {
+        return arrow::Status(
+            arrow::StatusCode::OutOfMemory,
+            "FileFrame could not grow buffer to hold incoming write");
+      }
     }
+    memcpy(map_start_ + cursor_, src, size);
+    cursor_ += size;
+    src += size;
+    nbytes -= size;
   }
-  memcpy(map_start_ + cursor_, data, nbytes);
-  cursor_ += nbytes;
   return arrow::Status::OK();
 }
 
@@ -1,9 +1,153 @@
 #include "tsuba/FileStorage.h"
 
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <numeric>
+
 #include "FileStorage_internal.h"
 
+namespace {
+
+/// One request to storage and the ranges it serves. If it serves a single
+/// range, it is read straight into that range's buffer.
+struct CoalescedRead {
+  uint64_t start;
+  uint64_t size;
+  std::vector<tsuba::FileRange> ranges;
+  std::unique_ptr<uint8_t[]> buf;
+};
+
+std::vector<CoalescedRead>
+PlanReads(
+    std::vector<tsuba::FileRange> ranges,
+    const tsuba::VectoredReadOptions& opts) {
+  ranges.erase(
+      std::remove_if(
+          ranges.begin(), ranges.end(),
+          [](const tsuba::FileRange& r) { return r.size == 0; }),
+      ranges.end());
+  std::sort(
+      ranges.begin(), ranges.end(),
+      [](const tsuba::FileRange& a, const tsuba::FileRange& b) {
+        return a.start < b.start;
+      });
+
+  std::vector<CoalescedRead> reads;
+  for (const tsuba::FileRange& range : ranges) {
+    uint64_t end = range.start + range.size;
+    if (!reads.empty()) {
+      CoalescedRead& last = reads.back();
+      uint64_t last_end = last.start + last.size;
+      uint64_t new_end = std::max(end, last_end);
+      if (range.start <= last_end + opts.max_gap &&
+          new_end - last.start <= opts.max_request_size) {
+        last.size = new_end - last.start;
+        last.ranges.emplace_back(range);
+        continue;
+      }
+    }
+    reads.emplace_back(CoalescedRead{
+        .start = range.start,
+        .size = range.size,
+        .ranges = {range},
+        .buf = nullptr,
+    });
+  }
+  return reads;
+}
+
+/// Collects parts and stores the whole file at once
+class BufferedMultipartWriter : public tsuba::MultipartWriter {
+public:
+  BufferedMultipartWriter(tsuba::FileStorage* fs, std::string uri)
+      : fs_(fs), uri_(std::move(uri)) {}
+
+  std::future<katana::CopyableResult<void>> PutPartAsync(
+      uint64_t offset, const uint8_t* data, uint64_t size) override {
+    if (buf_.size() < offset + size) {
+      buf_.resize(offset + size);
+    }
+    std::memcpy(buf_.data() + offset, data, size);
+    return std::async(
+        std::launch::deferred, []() -> katana::CopyableResult<void> {
+          return katana::CopyableResultSuccess();
+        });
+  }
+
+  katana::Result<void> Finish() override {
+    return fs_->PutMultiSync(uri_, buf_.data(), buf_.size());
+  }
+
+private:
+  tsuba::FileStorage* fs_;
+  std::string uri_;
+  std::vector<uint8_t> buf_;
+};
+
+}  // namespace
+
+tsuba::MultipartWriter::~MultipartWriter() = default;
+
 tsuba::FileStorage::~FileStorage() = default;
 
+katana::Result<std::unique_ptr<tsuba::MultipartWriter>>
+tsuba::FileStorage::StartMultipartWrite(const std::string& uri) {
+  return std::unique_ptr<MultipartWriter>(
+      std::make_unique<BufferedMultipartWriter>(this, uri));
+}
+
+std::future<katana::CopyableResult<void>>
+tsuba::FileStorage::GetRangesAsync(
+    const std::string& uri, std::vector<FileRange> ranges,
+    const VectoredReadOptions& opts) {
+  std::vector<CoalescedRead> reads = PlanReads(std::move(ranges), opts);
+  const uint64_t part_size = std::max<uint64_t>(opts.part_size, 1);
+
+  std::vector<std::future<katana::CopyableResult<void>>> parts;
+  for (CoalescedRead& read : reads) {
+    uint8_t* dest = read.ranges[0].result_buf;
+    if (read.ranges.size() > 1) {
+      read.buf = std::make_unique<uint8_t[]>(read.size);
+      dest = read.buf.get();
+    }
+    for (uint64_t off = 0; off < read.size; off += part_size) {
+      parts.emplace_back(GetAsync(
+          uri, read.start + off, std::min(part_size, read.size - off),
+          dest + off));
+    }
+  }
+
+  // Wait for every part, even after an error, since they write into buffers
+  // that are freed here
+  return std::async(
+      std::launch::deferred,
+      [reads = std::move(reads),
+       parts = std::move(parts)]() mutable -> katana::CopyableResult<void> {
+        katana::CopyableResult<void> ret = katana::CopyableResultSuccess();
+        for (auto& part : parts) {
+          auto res = part.get();
+          if (!res && ret) {
+            ret = res.error();
+          }
+        }
+        if (!ret) {
+          return ret;
+        }
+        for (const CoalescedRead& read : reads) {
+          if (!read.buf) {
+            continue;
+          }
+          for (const FileRange& range : read.ranges) {
+            std::memcpy(
+                range.result_buf, read.buf.get() + (range.start - read.start),
+                range.size);
+          }
+        }
+        return katana::CopyableResultSuccess();
+      });
+}
+
 std::vector<tsuba::FileStorage*>&
 tsuba::GetRegisteredFileStorages() {
   static std::vector<FileStorage*> fs;
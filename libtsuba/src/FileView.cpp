@@ -3,10 +3,15 @@
 #include <sys/mman.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <cassert>
 #include <cstdio>
 #include <string>
+#include <utility>
+#include <vector>
 
+#include "IOStats_internal.h"
+#include "katana/EventRecorder.h"
 #include "katana/Logging.h"
 #include "katana/Result.h"
 #include "tsuba/Errors.h"
@@ -102,61 +107,95 @@ FileView::Bind(
   }
 
   cursor_ = 0;
+  last_read_end_ = -1;
+  readahead_window_ = 0;
+  readahead_hits_ = 0;
+  readahead_misses_ = 0;
   valid_ = true;
   return katana::ResultSuccess();
 }
 
 katana::Result<void>
 FileView::Fill(uint64_t begin, uint64_t end, bool resolve) {
-  uint64_t in_end = std::min<uint64_t>(end, file_size_);
-  uint64_t in_begin = std::min<uint64_t>(begin, in_end);
-  uint64_t first_page = 0;
-  uint64_t last_page = 0;
-  bool found_empty = false;
+  return Fill({{begin, end}}, resolve);
+}
 
+katana::Result<void>
+FileView::Fill(
+    const std::vector<std::pair<uint64_t, uint64_t>>& ranges, bool resolve) {
   // We would check !valid_ but we want to call this in Bind before we have
   // set valid_. fetches_ should be default constructed to
   // nullptr.
   if (!fetches_) {
     return KATANA_ERROR(ErrorCode::InvalidArgument, "not bound");
   }
-  // Gracefully handle the fill zero case here to simplify Bind
-  if (in_end != in_begin) {
-    if (auto opt =
-            MustFill(&filling_[0], page_number(in_begin), page_number(in_end));
-        opt.has_value()) {
-      std::tie(first_page, last_page) = opt.value();
-      found_empty = true;
+
+  std::vector<FileRange> reads;
+  std::vector<std::pair<uint64_t, uint64_t>> read_pages;
+  for (const auto& [begin, end] : ranges) {
+    uint64_t in_end = std::min<uint64_t>(end, file_size_);
+    uint64_t in_begin = std::min<uint64_t>(begin, in_end);
+    // Gracefully handle the fill zero case here to simplify Bind
+    if (in_end == in_begin) {
+      continue;
     }
+    auto opt =
+        MustFill(&filling_[0], page_number(in_begin), page_number(in_end));
+    if (!opt.has_value()) {
+      continue;
+    }
+    auto [first_page, last_page] = opt.value();
 
     uint64_t file_off = first_page * (1UL << page_shift_);
     uint64_t map_size = std::min(
         (last_page + 1) * (1UL << page_shift_) - file_off,
         file_size_ - file_off);
-    if (found_empty) {
-      // Get physical pages for the region we are about to write
-      int err =
-          mprotect(map_start_ + file_off, map_size, PROT_READ | PROT_WRITE);
-      if (err == -1) {
-        return KATANA_ERROR(katana::ResultErrno(), "mprotecting buffer");
-      }
+    // Get physical pages for the region we are about to write
+    int err = mprotect(map_start_ + file_off, map_size, PROT_READ | PROT_WRITE);
+    if (err == -1) {
+      return KATANA_ERROR(katana::ResultErrno(), "mprotecting buffer");
+    }
+    // Marking pages now keeps later ranges in this call from fetching them
+    // again
+    if (auto res = MarkFilled(&filling_[0], first_page, last_page); !res) {
+      return res.error().WithContext("updating bookkeeping data");
+    }
+    reads.emplace_back(FileRange{
+        .start = file_off,
+        .size = map_size,
+        .result_buf = map_start_ + file_off,
+    });
+    read_pages.emplace_back(first_page, last_page);
+
+    int64_t signed_begin = static_cast<int64_t>(in_begin);
+    if (mem_start_ < 0 || signed_begin < mem_start_) {
+      mem_start_ = signed_begin;
+    }
+  }
+  if (reads.empty()) {
+    return katana::ResultSuccess();
+  }
 
-      auto peek_fut =
-          FileGetAsync(filename_, map_start_ + file_off, file_off, map_size);
-      KATANA_LOG_ASSERT(peek_fut.valid());
-      FillingRange fetch = {first_page, last_page, std::move(peek_fut)};
-      fetches_->push_back(std::move(fetch));
-      if (auto res = MarkFilled(&filling_[0], first_page, last_page); !res) {
-        return res.error().WithContext("updating bookkeeping data");
-      }
-      if (resolve) {
-        if (auto res = Resolve(file_off, map_size); !res) {
-          return res.error().WithContext("resolving fill");
-        }
-      }
-      int64_t signed_begin = static_cast<int64_t>(in_begin);
-      if (mem_start_ < 0 || signed_begin < mem_start_) {
-        mem_start_ = signed_begin;
+  // One vectored read for everything, so storage can coalesce nearby ranges
+  // and split large ones
+  uint64_t pages = 0;
+  for (const auto& [first_page, last_page] : read_pages) {
+    pages += last_page - first_page + 1;
+  }
+  RecordFileViewFill(pages, !resolve);
+
+  std::vector<FileRange> to_resolve = reads;
+  std::shared_future<katana::CopyableResult<void>> work =
+      FileGetRangesAsync(filename_, std::move(reads)).share();
+  KATANA_LOG_ASSERT(work.valid());
+  for (const auto& [first_page, last_page] : read_pages) {
+    fetches_->push_back(FillingRange{first_page, last_page, work});
+  }
+
+  if (resolve) {
+    for (const FileRange& read : to_resolve) {
+      if (auto res = Resolve(read.start, read.size); !res) {
+        return res.error().WithContext("resolving fill");
       }
     }
   }
@@ -232,20 +271,8 @@ FileView::Read(int64_t nbytes) {
   if (cursor_ + nbytes > file_size_) {
     nbytes_internal = file_size_ - cursor_;
   }
-  // fetch data from storage if necessary
-  if (auto res = Fill(cursor_, cursor_ + nbytes_internal, true); !res) {
-    return arrow::Status(arrow::StatusCode::IOError, "FileView::Fill");
-  }
-  // resolve outstanding relevant fetches
-  if (auto res = Resolve(cursor_, nbytes_internal); !res) {
-    // TODO (scober): Include res.error() as part of arrow Status
-    return arrow::Status(
-        arrow::StatusCode::IOError, "Resolving asynchronous reads");
-  }
-  // prefetch
-  if (auto res = PreFetch(cursor_, nbytes_internal); !res) {
-    // TODO (scober): Include res.error() as part of arrow Status
-    return arrow::Status(arrow::StatusCode::IOError, "prefetching");
+  if (auto status = PrepareRead(nbytes_internal); !status.ok()) {
+    return status;
   }
   // and return the requested data
   auto ret =
@@ -267,20 +294,8 @@ FileView::Read(int64_t nbytes, void* out) {
   if (cursor_ + nbytes > file_size_) {
     nbytes_internal = file_size_ - cursor_;
   }
-  // fetch data from storage if necessary
-  if (auto res = Fill(cursor_, cursor_ + nbytes_internal, true); !res) {
-    return arrow::Status(arrow::StatusCode::IOError, "FileView::Fill");
-  }
-  // resolve outstanding relevant fetches
-  if (auto res = Resolve(cursor_, nbytes_internal); !res) {
-    // TODO (scober): Include res.error() as part of arrow Status
-    return arrow::Status(
-        arrow::StatusCode::IOError, "Resolving asynchronous reads");
-  }
-  // prefetch
-  if (auto res = PreFetch(cursor_, nbytes_internal); !res) {
-    // TODO (scober): Include res.error() as part of arrow Status
-    return arrow::Status(arrow::StatusCode::IOError, "prefetching");
+  if (auto status = PrepareRead(nbytes_internal); !status.ok()) {
+    return status;
   }
   // and return the requested data
   std::memcpy(out, map_start_ + cursor_, nbytes_internal);
@@ -295,6 +310,27 @@ FileView::GetSize() {
 
 ///// End arrow::io::RandomAccessFile method definitions /////////
 
+arrow::Status
+FileView::PrepareRead(int64_t nbytes) {
+  bool hit = IsFilled(cursor_, cursor_ + nbytes);
+  // fetch data from storage if necessary
+  if (auto res = Fill(cursor_, cursor_ + nbytes, true); !res) {
+    return arrow::Status(arrow::StatusCode::IOError, "FileView::Fill");
+  }
+  // resolve outstanding relevant fetches
+  if (auto res = Resolve(cursor_, nbytes); !res) {
+    // TODO (scober): Include res.error() as part of arrow Status
+    return arrow::Status(
+        arrow::StatusCode::IOError, "Resolving asynchronous reads");
+  }
+  // prefetch
+  if (auto res = PreFetch(cursor_, nbytes, hit); !res) {
+    // TODO (scober): Include res.error() as part of arrow Status
+    return arrow::Status(arrow::StatusCode::IOError, "prefetching");
+  }
+  return arrow::Status::OK();
+}
+
 uint64_t
 FileView::page_number(uint64_t size) {
   return size >> page_shift_;
@@ -464,7 +500,13 @@ FileView::Resolve(int64_t start, int64_t size) {
         fetch->last_page >= page_number(start)) {
       // Complete the remaining work if there is some
       if (fetch->work.valid()) {
-        if (auto res = fetch->work.get(); !res) {
+        katana::EventScope event(
+            katana::EventRecorder::kStorage, "FileView wait",
+            (fetch->last_page - fetch->first_page + 1) << page_shift_);
+        uint64_t start_ns = IONowNs();
+        auto res = fetch->work.get();
+        RecordFileViewWait(IONowNs() - start_ns);
+        if (!res) {
           return res.error();
         }
       } else {
@@ -478,15 +520,65 @@ FileView::Resolve(int64_t start, int64_t size) {
   return katana::ResultSuccess();
 }
 
+bool
+FileView::IsFilled(uint64_t begin, uint64_t end) {
+  uint64_t in_end = std::min<uint64_t>(end, file_size_);
+  uint64_t in_begin = std::min<uint64_t>(begin, in_end);
+  if (in_begin == in_end) {
+    return true;
+  }
+  return !MustFill(&filling_[0], page_number(in_begin), page_number(in_end))
+              .has_value();
+}
+
 katana::Result<void>
-FileView::PreFetch(int64_t start, int64_t size) {
-  // Our highly sophisticated prefetching algorithm is to crudely approximate
-  // the size of the last read plus 10%. This is largely motivated by parquet
-  // files, which consecutively read row groups that are (in theory)
-  // approximately the same size.
-  int64_t fetch_size = (size / 10) * 11;
+FileView::PreFetch(int64_t start, int64_t size, bool hit) {
+  int64_t fetch_size = 0;
+  if (readahead_policy_ == ReadaheadPolicy::kLastReadSize) {
+    // Our highly sophisticated prefetching algorithm is to crudely approximate
+    // the size of the last read plus 10%. This is largely motivated by parquet
+    // files, which consecutively read row groups that are (in theory)
+    // approximately the same size.
+    fetch_size = (size / 10) * 11;
+  } else {
+    // A read is sequential if it starts within a page of where the last one
+    // ended. The first read prefetches the last read plus 10%, as above, and
+    // every sequential read doubles the window (it is never less than that).
+    // Random reads that also missed mean readahead is wasted I/O, so they
+    // halve it; random reads that hit leave it alone since earlier readahead
+    // is evidently still being consumed.
+    const uint64_t page_size = UINT64_C(1) << page_shift_;
+    const uint64_t last_read_size = static_cast<uint64_t>(size / 10) * 11;
+    const uint64_t max_window =
+        std::max(page_size * kMaxReadaheadPages, last_read_size);
+    bool sequential =
+        last_read_end_ >= 0 && start >= last_read_end_ &&
+        static_cast<uint64_t>(start - last_read_end_) <= page_size;
+    if (hit) {
+      readahead_hits_++;
+    } else {
+      readahead_misses_++;
+    }
+    if (last_read_end_ < 0) {
+      readahead_window_ = last_read_size;
+    } else if (sequential) {
+      readahead_window_ = std::min(
+          std::max({readahead_window_ * 2, last_read_size, page_size}),
+          max_window);
+    } else if (!hit) {
+      readahead_window_ /= 2;
+      if (readahead_window_ < page_size) {
+        readahead_window_ = 0;
+      }
+    }
+    last_read_end_ = start + size;
+    fetch_size = static_cast<int64_t>(readahead_window_);
+  }
   // Make sure we haven't overflown
   KATANA_LOG_DEBUG_ASSERT(fetch_size >= 0);
+  if (fetch_size == 0) {
+    return katana::ResultSuccess();
+  }
   uint64_t begin = static_cast<uint64_t>(start + size);
   uint64_t end = static_cast<uint64_t>(start + size + fetch_size);
   if (auto res = Fill(begin, end, false); !res) {
@@ -10,6 +10,10 @@
 #include "katana/Result.h"
 #include "tsuba/FileStorage.h"
 
+#if defined(KATANA_USE_IO_URING)
+#include "UringLocalStorage.h"
+#endif
+
 namespace tsuba {
 
 class GlobalState {
@@ -18,7 +22,11 @@ class GlobalState {
   std::vector<FileStorage*> file_stores_;
   katana::CommBackend* comm_;
 
+#if defined(KATANA_USE_IO_URING)
+  tsuba::UringLocalStorage local_storage_;
+#else
   tsuba::LocalStorage local_storage_;
+#endif
 
   GlobalState(katana::CommBackend* comm) : comm_(comm) {
     file_stores_.emplace_back(&local_storage_);
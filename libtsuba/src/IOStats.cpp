@@ -0,0 +1,243 @@
+#include "tsuba/IOStats.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+#include "IOStats_internal.h"
+#include "katana/ProgressTracer.h"
+
+namespace {
+
+struct Counters {
+  std::atomic<uint64_t> pages_faulted{0};
+  std::atomic<uint64_t> pages_prefetched{0};
+  std::atomic<uint64_t> fill_wait_ns{0};
+  std::atomic<uint64_t> tables_decoded{0};
+  std::atomic<uint64_t> decode_ns{0};
+  std::atomic<uint64_t> read_group_ops{0};
+  std::atomic<uint64_t> read_group_wait_ns{0};
+  std::atomic<uint64_t> write_group_ops{0};
+  std::atomic<uint64_t> write_group_wait_ns{0};
+  std::atomic<uint64_t> cache_hits{0};
+  std::atomic<uint64_t> cache_misses{0};
+  std::atomic<uint64_t> cache_evictions{0};
+  std::atomic<uint64_t> metadata_cache_hits{0};
+  std::atomic<uint64_t> metadata_cache_misses{0};
+
+  // Storage requests are large, so a lock per request costs little
+  std::mutex schemes_mutex;
+  std::map<std::string, tsuba::IOSchemeStats> schemes;
+};
+
+Counters&
+GetCounters() {
+  static Counters counters;
+  return counters;
+}
+
+size_t
+LatencyBucket(uint64_t latency_ns) {
+  uint64_t us = latency_ns / 1000;
+  size_t bucket = 0;
+  while (us > 0 && bucket + 1 < tsuba::IORequestStats::kNumLatencyBuckets) {
+    us >>= 1;
+    ++bucket;
+  }
+  return bucket;
+}
+
+/// The upper bound, in microseconds, of the bucket that holds the q-th
+/// quantile of requests
+uint64_t
+LatencyQuantileUs(const tsuba::IORequestStats& stats, double q) {
+  uint64_t target = static_cast<uint64_t>(q * stats.requests);
+  uint64_t seen = 0;
+  for (size_t i = 0; i < stats.latency_us_histogram.size(); ++i) {
+    seen += stats.latency_us_histogram[i];
+    if (seen > target) {
+      return UINT64_C(1) << i;
+    }
+  }
+  return UINT64_C(1) << (stats.latency_us_histogram.size() - 1);
+}
+
+void
+AddRequestTags(
+    const std::string& prefix, const tsuba::IORequestStats& stats,
+    katana::Tags* tags) {
+  if (stats.requests == 0) {
+    return;
+  }
+  tags->emplace_back(prefix + "_requests", stats.requests);
+  tags->emplace_back(prefix + "_bytes", stats.bytes);
+  tags->emplace_back(prefix + "_p50_us", LatencyQuantileUs(stats, 0.5));
+  tags->emplace_back(prefix + "_p99_us", LatencyQuantileUs(stats, 0.99));
+}
+
+}  // namespace
+
+uint64_t
+tsuba::IONowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void
+tsuba::RecordStorageRequest(
+    std::string_view uri_scheme, bool write, uint64_t bytes,
+    uint64_t latency_ns) {
+  // Backends are registered with schemes like "s3://"
+  std::string scheme(uri_scheme.substr(0, uri_scheme.find(':')));
+
+  Counters& counters = GetCounters();
+  std::lock_guard<std::mutex> lock(counters.schemes_mutex);
+  auto it = counters.schemes.find(scheme);
+  if (it == counters.schemes.end()) {
+    it = counters.schemes.emplace(scheme, IOSchemeStats{}).first;
+  }
+  IORequestStats& stats = write ? it->second.writes : it->second.reads;
+  stats.requests += 1;
+  stats.bytes += bytes;
+  stats.latency_us_histogram[LatencyBucket(latency_ns)] += 1;
+}
+
+void
+tsuba::RecordFileViewFill(uint64_t pages, bool prefetch) {
+  if (prefetch) {
+    GetCounters().pages_prefetched += pages;
+  } else {
+    GetCounters().pages_faulted += pages;
+  }
+}
+
+void
+tsuba::RecordFileViewWait(uint64_t ns) {
+  GetCounters().fill_wait_ns += ns;
+}
+
+void
+tsuba::RecordDecode(uint64_t ns) {
+  GetCounters().tables_decoded += 1;
+  GetCounters().decode_ns += ns;
+}
+
+void
+tsuba::RecordGroupOps(bool write, uint64_t ops) {
+  if (write) {
+    GetCounters().write_group_ops += ops;
+  } else {
+    GetCounters().read_group_ops += ops;
+  }
+}
+
+void
+tsuba::RecordGroupWait(bool write, uint64_t ns) {
+  if (write) {
+    GetCounters().write_group_wait_ns += ns;
+  } else {
+    GetCounters().read_group_wait_ns += ns;
+  }
+}
+
+void
+tsuba::RecordPropertyCacheLookup(bool hit) {
+  if (hit) {
+    GetCounters().cache_hits += 1;
+  } else {
+    GetCounters().cache_misses += 1;
+  }
+}
+
+void
+tsuba::RecordPropertyCacheEvictions(uint64_t evictions) {
+  GetCounters().cache_evictions += evictions;
+}
+
+void
+tsuba::RecordMetadataCacheLookup(bool hit) {
+  if (hit) {
+    GetCounters().metadata_cache_hits += 1;
+  } else {
+    GetCounters().metadata_cache_misses += 1;
+  }
+}
+
+tsuba::IOStats
+tsuba::GetIOStats() {
+  Counters& counters = GetCounters();
+  IOStats ret;
+  {
+    std::lock_guard<std::mutex> lock(counters.schemes_mutex);
+    ret.schemes = counters.schemes;
+  }
+  ret.pages_faulted = counters.pages_faulted;
+  ret.pages_prefetched = counters.pages_prefetched;
+  ret.fill_wait_ns = counters.fill_wait_ns;
+  ret.tables_decoded = counters.tables_decoded;
+  ret.decode_ns = counters.decode_ns;
+  ret.read_group_ops = counters.read_group_ops;
+  ret.read_group_wait_ns = counters.read_group_wait_ns;
+  ret.write_group_ops = counters.write_group_ops;
+  ret.write_group_wait_ns = counters.write_group_wait_ns;
+  ret.cache_hits = counters.cache_hits;
+  ret.cache_misses = counters.cache_misses;
+  ret.cache_evictions = counters.cache_evictions;
+  ret.metadata_cache_hits = counters.metadata_cache_hits;
+  ret.metadata_cache_misses = counters.metadata_cache_misses;
+  return ret;
+}
+
+void
+tsuba::ResetIOStats() {
+  Counters& counters = GetCounters();
+  {
+    std::lock_guard<std::mutex> lock(counters.schemes_mutex);
+    counters.schemes.clear();
+  }
+  counters.pages_faulted = 0;
+  counters.pages_prefetched = 0;
+  counters.fill_wait_ns = 0;
+  counters.tables_decoded = 0;
+  counters.decode_ns = 0;
+  counters.read_group_ops = 0;
+  counters.read_group_wait_ns = 0;
+  counters.write_group_ops = 0;
+  counters.write_group_wait_ns = 0;
+  counters.cache_hits = 0;
+  counters.cache_misses = 0;
+  counters.cache_evictions = 0;
+  counters.metadata_cache_hits = 0;
+  counters.metadata_cache_misses = 0;
+}
+
+void
+tsuba::TraceIOStats() {
+  auto& tracer = katana::GetTracer();
+  if (!tracer.HasActiveSpan()) {
+    return;
+  }
+
+  IOStats stats = GetIOStats();
+  katana::Tags tags;
+  for (const auto& [scheme, scheme_stats] : stats.schemes) {
+    AddRequestTags(scheme + "_read", scheme_stats.reads, &tags);
+    AddRequestTags(scheme + "_write", scheme_stats.writes, &tags);
+  }
+  tags.emplace_back("pages_faulted", stats.pages_faulted);
+  tags.emplace_back("pages_prefetched", stats.pages_prefetched);
+  tags.emplace_back("fill_wait_ns", stats.fill_wait_ns);
+  tags.emplace_back("tables_decoded", stats.tables_decoded);
+  tags.emplace_back("decode_ns", stats.decode_ns);
+  tags.emplace_back("read_group_ops", stats.read_group_ops);
+  tags.emplace_back("read_group_wait_ns", stats.read_group_wait_ns);
+  tags.emplace_back("write_group_ops", stats.write_group_ops);
+  tags.emplace_back("write_group_wait_ns", stats.write_group_wait_ns);
+  tags.emplace_back("cache_hits", stats.cache_hits);
+  tags.emplace_back("cache_misses", stats.cache_misses);
+  tags.emplace_back("cache_evictions", stats.cache_evictions);
+  tags.emplace_back("metadata_cache_hits", stats.metadata_cache_hits);
+  tags.emplace_back("metadata_cache_misses", stats.metadata_cache_misses);
+  tracer.GetActiveSpan().Log("storage io", tags);
+}
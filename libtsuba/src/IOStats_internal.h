@@ -0,0 +1,36 @@
+#ifndef KATANA_LIBTSUBA_IOSTATSINTERNAL_H_
+#define KATANA_LIBTSUBA_IOSTATSINTERNAL_H_
+
+#include <cstdint>
+#include <string_view>
+
+#include "tsuba/IOStats.h"
+
+namespace tsuba {
+
+/// Nanoseconds since an arbitrary start, for timing requests
+uint64_t IONowNs();
+
+void RecordStorageRequest(
+    std::string_view uri_scheme, bool write, uint64_t bytes,
+    uint64_t latency_ns);
+
+void RecordFileViewFill(uint64_t pages, bool prefetch);
+
+void RecordFileViewWait(uint64_t ns);
+
+void RecordDecode(uint64_t ns);
+
+void RecordGroupOps(bool write, uint64_t ops);
+
+void RecordGroupWait(bool write, uint64_t ns);
+
+void RecordPropertyCacheLookup(bool hit);
+
+void RecordPropertyCacheEvictions(uint64_t evictions);
+
+void RecordMetadataCacheLookup(bool hit);
+
+}  // namespace tsuba
+
+#endif
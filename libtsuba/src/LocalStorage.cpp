@@ -23,6 +23,69 @@
 
 namespace fs = boost::filesystem;
 
+namespace {
+
+katana::Result<void>
+CreateParentDirectories(const std::string& path) {
+  fs::path dir = fs::path{path}.parent_path();
+  if (!dir.empty()) {
+    if (boost::system::error_code err; !fs::create_directories(dir, err)) {
+      if (err) {
+        return KATANA_ERROR(
+            std::error_code(err.value(), err.category()),
+            "creating parent directories: {}", err.message());
+      }
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+/// Writes each part in place with pwrite as soon as it is put
+class LocalMultipartWriter : public tsuba::MultipartWriter {
+public:
+  explicit LocalMultipartWriter(int fd) : fd_(fd) {}
+
+  ~LocalMultipartWriter() override {
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+  }
+
+  std::future<katana::CopyableResult<void>> PutPartAsync(
+      uint64_t offset, const uint8_t* data, uint64_t size) override {
+    return std::async(
+        std::launch::async,
+        [fd = fd_, offset, data, size]() -> katana::CopyableResult<void> {
+          for (uint64_t done = 0; done < size;) {
+            ssize_t written =
+                pwrite(fd, data + done, size - done, offset + done);
+            if (written < 0) {
+              if (errno == EINTR) {
+                continue;
+              }
+              return KATANA_ERROR(katana::ResultErrno(), "writing part");
+            }
+            done += written;
+          }
+          return katana::CopyableResultSuccess();
+        });
+  }
+
+  katana::Result<void> Finish() override {
+    int fd = fd_;
+    fd_ = -1;
+    if (close(fd)) {
+      return KATANA_ERROR(katana::ResultErrno(), "closing file");
+    }
+    return katana::ResultSuccess();
+  }
+
+private:
+  int fd_;
+};
+
+}  // namespace
+
 void
 tsuba::LocalStorage::CleanUri(std::string* uri) {
   if (uri->find(uri_scheme()) != 0) {
@@ -35,17 +98,7 @@ katana::Result<void>
 tsuba::LocalStorage::WriteFile(
     std::string uri, const uint8_t* data, uint64_t size) {
   CleanUri(&uri);
-  fs::path m_path{uri};
-  fs::path dir = m_path.parent_path();
-  if (!dir.empty()) {
-    if (boost::system::error_code err; !fs::create_directories(dir, err)) {
-      if (err) {
-        return KATANA_ERROR(
-            std::error_code(err.value(), err.category()),
-            "creating parent directories: {}", err.message());
-      }
-    }
-  }
+  KATANA_CHECKED(CreateParentDirectories(uri));
 
   std::ofstream ofile(uri);
   if (!ofile.good()) {
@@ -59,6 +112,19 @@ tsuba::LocalStorage::WriteFile(
   return katana::ResultSuccess();
 }
 
+katana::Result<std::unique_ptr<tsuba::MultipartWriter>>
+tsuba::LocalStorage::StartMultipartWrite(const std::string& uri) {
+  std::string path = uri;
+  CleanUri(&path);
+  KATANA_CHECKED(CreateParentDirectories(path));
+  int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    return KATANA_ERROR(katana::ResultErrno(), "opening {}", path);
+  }
+  return std::unique_ptr<MultipartWriter>(
+      std::make_unique<LocalMultipartWriter>(fd));
+}
+
 katana::Result<void>
 tsuba::LocalStorage::RemoteCopyFile(
     std::string source_uri, std::string dest_uri, uint64_t begin,
@@ -119,6 +185,9 @@ tsuba::LocalStorage::Stat(const std::string& uri, StatBuf* s_buf) {
     return katana::ResultErrno();
   }
   s_buf->size = local_s_buf.st_size;
+  s_buf->mtime_ns =
+      static_cast<uint64_t>(local_s_buf.st_mtim.tv_sec) * 1000000000 +
+      local_s_buf.st_mtim.tv_nsec;
   return katana::ResultSuccess();
 }
 
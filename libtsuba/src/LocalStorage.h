@@ -5,6 +5,7 @@
 
 #include <cstdint>
 #include <future>
+#include <memory>
 #include <string>
 #include <thread>
 
@@ -16,7 +17,6 @@ namespace tsuba {
 /// Store byte arrays to the local file system; Provided as a convenience for
 /// testing only (un-optimized)
 class LocalStorage : public FileStorage {
-  void CleanUri(std::string* uri);
   katana::Result<void> WriteFile(
       std::string, const uint8_t* data, uint64_t size);
   katana::Result<void> ReadFile(
@@ -25,6 +25,9 @@ class LocalStorage : public FileStorage {
       std::string source_uri, std::string dest_uri, uint64_t begin,
       uint64_t size);
 
+protected:
+  void CleanUri(std::string* uri);
+
 public:
   LocalStorage() : FileStorage("file://") {}
 
@@ -51,6 +54,10 @@ public:
     return RemoteCopyFile(source_uri, dest_uri, begin, size);
   }
 
+  /// Parts are written in place as they are put
+  katana::Result<std::unique_ptr<MultipartWriter>> StartMultipartWrite(
+      const std::string& uri) override;
+
   // get on future can potentially block (bulk synchronous parallel)
   std::future<katana::CopyableResult<void>> PutAsync(
       const std::string& uri, const uint8_t* data, uint64_t size) override {
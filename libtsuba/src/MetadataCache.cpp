@@ -0,0 +1,175 @@
+#include "MetadataCache.h"
+
+#include <algorithm>
+#include <future>
+#include <optional>
+#include <vector>
+
+#include "IOStats_internal.h"
+#include "katana/Logging.h"
+
+namespace {
+
+bool
+SameFile(const tsuba::StatBuf& a, const tsuba::StatBuf& b) {
+  return a.size == b.size && a.mtime_ns == b.mtime_ns && a.etag == b.etag;
+}
+
+}  // namespace
+
+tsuba::MetadataCache&
+tsuba::MetadataCache::Get() {
+  static MetadataCache cache;
+  return cache;
+}
+
+template <typename T>
+katana::Result<T>
+tsuba::MetadataCache::GetOrRead(
+    const katana::Uri& uri, const std::function<katana::Result<T>()>& read) {
+  const std::string& key = uri.string();
+  std::optional<Entry> cached;
+  MetadataCacheOptions opts;
+  uint64_t generation = 0;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    opts = opts_;
+    generation = generation_;
+    if (auto it = entries_.find(key);
+        it != entries_.end() && std::holds_alternative<T>(it->second.value)) {
+      cached = it->second;
+      lru_.splice(lru_.begin(), lru_, it->second.lru_it);
+    }
+  }
+  if (opts.max_entries == 0) {
+    return read();
+  }
+
+  // Stat before reading, so that a change between the two is caught by the
+  // next lookup
+  StatBuf stat;
+  if (opts.validate) {
+    if (auto res = FileStat(key, &stat); !res) {
+      // Let read report why the file cannot be had
+      Invalidate(key);
+      return read();
+    }
+    // A backend that reports neither a modification time nor an ETag leaves
+    // only the size to compare, which misses a rewrite of the same size, so
+    // its files are not cached
+    if (stat.mtime_ns == 0 && stat.etag.empty()) {
+      return read();
+    }
+  }
+
+  if (cached && (!opts.validate || SameFile(cached->stat, stat))) {
+    RecordMetadataCacheLookup(true);
+    return std::get<T>(std::move(cached->value));
+  }
+  RecordMetadataCacheLookup(false);
+
+  T value = KATANA_CHECKED(read());
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (generation != generation_ || opts_.max_entries == 0) {
+    return value;
+  }
+  if (auto it = entries_.find(key); it != entries_.end()) {
+    it->second.stat = stat;
+    it->second.value = value;
+  } else {
+    lru_.emplace_front(key);
+    entries_.emplace(key, Entry{stat, value, lru_.begin()});
+    EvictLocked();
+  }
+  return value;
+}
+
+katana::Result<tsuba::RDGManifest>
+tsuba::MetadataCache::GetManifest(
+    const katana::Uri& uri,
+    const std::function<katana::Result<RDGManifest>()>& read) {
+  return GetOrRead(uri, read);
+}
+
+katana::Result<tsuba::RDGPartHeader>
+tsuba::MetadataCache::GetPartHeader(
+    const katana::Uri& uri,
+    const std::function<katana::Result<RDGPartHeader>()>& read) {
+  return GetOrRead(uri, read);
+}
+
+void
+tsuba::MetadataCache::PrefetchPartHeaders(const RDGManifest& manifest) {
+  uint32_t num_parallel = std::max<uint32_t>(options().num_parallel_reads, 1);
+  for (uint32_t begin = 0; begin < manifest.num_hosts();
+       begin += num_parallel) {
+    uint32_t end = std::min(begin + num_parallel, manifest.num_hosts());
+    std::vector<std::future<void>> reads;
+    for (uint32_t i = begin; i < end; ++i) {
+      reads.emplace_back(std::async(std::launch::async, [&manifest, i]() {
+        katana::Uri path = manifest.PartitionFileName(i);
+        if (auto res = RDGPartHeader::Make(path); !res) {
+          KATANA_LOG_DEBUG("prefetching {}: {}", path, res.error());
+        }
+      }));
+    }
+    for (auto& read : reads) {
+      read.get();
+    }
+  }
+}
+
+void
+tsuba::MetadataCache::Invalidate(const std::string& uri) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++generation_;
+  if (auto it = entries_.find(uri); it != entries_.end()) {
+    lru_.erase(it->second.lru_it);
+    entries_.erase(it);
+  }
+}
+
+void
+tsuba::MetadataCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++generation_;
+  entries_.clear();
+  lru_.clear();
+}
+
+void
+tsuba::MetadataCache::SetOptions(const MetadataCacheOptions& opts) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  opts_ = opts;
+  EvictLocked();
+}
+
+tsuba::MetadataCacheOptions
+tsuba::MetadataCache::options() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return opts_;
+}
+
+void
+tsuba::MetadataCache::EvictLocked() {
+  while (entries_.size() > opts_.max_entries) {
+    entries_.erase(lru_.back());
+    lru_.pop_back();
+  }
+}
+
+void
+tsuba::SetMetadataCacheOptions(const MetadataCacheOptions& opts) {
+  MetadataCache::Get().SetOptions(opts);
+}
+
+tsuba::MetadataCacheOptions
+tsuba::GetMetadataCacheOptions() {
+  return MetadataCache::Get().options();
+}
+
+void
+tsuba::ClearMetadataCache() {
+  MetadataCache::Get().Clear();
+}
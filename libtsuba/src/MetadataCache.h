@@ -0,0 +1,78 @@
+#ifndef KATANA_LIBTSUBA_METADATACACHE_H_
+#define KATANA_LIBTSUBA_METADATACACHE_H_
+
+#include <functional>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <variant>
+
+#include "RDGManifest.h"
+#include "RDGPartHeader.h"
+#include "katana/Result.h"
+#include "katana/URI.h"
+#include "tsuba/file.h"
+#include "tsuba/tsuba.h"
+
+namespace tsuba {
+
+/// The process-wide cache of parsed RDGManifests and RDGPartHeaders by the
+/// URI of their file, see MetadataCacheOptions.
+///
+/// Lookups return copies, so callers may modify what they get. Storage is
+/// never accessed while holding the lock; a file read concurrently with a
+/// write or delete through tsuba is not cached.
+class MetadataCache {
+public:
+  static MetadataCache& Get();
+
+  katana::Result<RDGManifest> GetManifest(
+      const katana::Uri& uri,
+      const std::function<katana::Result<RDGManifest>()>& read);
+
+  katana::Result<RDGPartHeader> GetPartHeader(
+      const katana::Uri& uri,
+      const std::function<katana::Result<RDGPartHeader>()>& read);
+
+  /// Read the headers of all partitions of manifest in parallel, so that
+  /// RDGPartHeader::Make finds them in the cache. Errors are left for Make
+  /// to report.
+  void PrefetchPartHeaders(const RDGManifest& manifest);
+
+  /// Drop a file that is about to change
+  void Invalidate(const std::string& uri);
+
+  void Clear();
+
+  void SetOptions(const MetadataCacheOptions& opts);
+  MetadataCacheOptions options();
+
+private:
+  using Value = std::variant<RDGManifest, RDGPartHeader>;
+
+  struct Entry {
+    StatBuf stat;
+    Value value;
+    std::list<std::string>::iterator lru_it;
+  };
+
+  template <typename T>
+  katana::Result<T> GetOrRead(
+      const katana::Uri& uri, const std::function<katana::Result<T>()>& read);
+
+  void EvictLocked();
+
+  std::mutex mutex_;
+  MetadataCacheOptions opts_;
+  std::unordered_map<std::string, Entry> entries_;
+  /// Most recently used first
+  std::list<std::string> lru_;
+  /// Advanced by every invalidation, so a read that started before one is
+  /// not cached
+  uint64_t generation_{0};
+};
+
+}  // namespace tsuba
+
+#endif
@@ -1,15 +1,22 @@
 #include "tsuba/ParquetReader.h"
 
+#include <algorithm>
+#include <atomic>
 #include <limits>
 #include <memory>
-#include <unordered_map>
+#include <mutex>
+#include <thread>
 
 #include <arrow/array/util.h>
 #include <arrow/chunked_array.h>
 #include <arrow/type.h>
 #include <arrow/type_fwd.h>
+#include <parquet/arrow/reader.h>
 #include <parquet/arrow/schema.h>
+#include <parquet/metadata.h>
 
+#include "IOStats_internal.h"
+#include "katana/ArrowInterchange.h"
 #include "katana/JSON.h"
 #include "tsuba/Errors.h"
 #include "tsuba/FileView.h"
@@ -60,6 +67,26 @@ ChunkedStringToLargeString(const std::shared_ptr<arrow::ChunkedArray>& arr) {
   return maybe_res.ValueOrDie();
 }
 
+/// Dictionary encoded columns are read with a dictionary for each row group;
+/// give them one dictionary, of large strings for string values, so that
+/// their chunks can be combined
+Result<std::shared_ptr<arrow::ChunkedArray>>
+UnifyDictionaries(const std::shared_ptr<arrow::ChunkedArray>& arr) {
+  auto unified = std::static_pointer_cast<arrow::DictionaryArray>(
+      KATANA_CHECKED(katana::UnifiedDictionaryArray(arr)));
+  const auto& type =
+      static_cast<const arrow::DictionaryType&>(*unified->type());
+  if (type.value_type()->id() != arrow::Type::STRING) {
+    return std::make_shared<arrow::ChunkedArray>(unified);
+  }
+  auto dictionary = KATANA_CHECKED(ChunkedStringToLargeString(
+      std::make_shared<arrow::ChunkedArray>(unified->dictionary())));
+  auto large = KATANA_CHECKED(arrow::DictionaryArray::FromArrays(
+      arrow::dictionary(type.index_type(), arrow::large_utf8(), type.ordered()),
+      unified->indices(), dictionary->chunk(0)));
+  return std::make_shared<arrow::ChunkedArray>(large);
+}
+
 // HandleBadParquetTypes here and HandleBadParquetTypes in ParquetWriter.cpp
 // workaround a libarrow2.0 limitation in reading and writing LargeStrings to
 // parquet files.
@@ -69,6 +96,9 @@ HandleBadParquetTypes(std::shared_ptr<arrow::ChunkedArray> old_array) {
   case arrow::Type::type::STRING: {
     return ChunkedStringToLargeString(old_array);
   }
+  case arrow::Type::type::DICTIONARY: {
+    return UnifyDictionaries(old_array);
+  }
   default:
     return old_array;
   }
@@ -81,6 +111,17 @@ HandleBadParquetTypes(std::shared_ptr<arrow::Field> old_field) {
     return std::make_shared<arrow::Field>(
         old_field->name(), arrow::large_utf8());
   }
+  case arrow::Type::type::DICTIONARY: {
+    const auto& type =
+        static_cast<const arrow::DictionaryType&>(*old_field->type());
+    if (type.value_type()->id() != arrow::Type::STRING) {
+      return old_field;
+    }
+    return std::make_shared<arrow::Field>(
+        old_field->name(),
+        arrow::dictionary(
+            type.index_type(), arrow::large_utf8(), type.ordered()));
+  }
   default:
     return old_field;
   }
@@ -88,7 +129,7 @@ HandleBadParquetTypes(std::shared_ptr<arrow::Field> old_field) {
 
 Result<std::unique_ptr<parquet::arrow::FileReader>>
 BuildReader(
-    const std::string& uri, bool preload,
+    const std::string& uri, bool preload, bool use_threads,
     std::shared_ptr<tsuba::FileView>* fv) {
   auto fv_tmp = std::make_shared<tsuba::FileView>();
   KATANA_CHECKED_CONTEXT(
@@ -100,42 +141,94 @@ BuildReader(
   std::unique_ptr<parquet::arrow::FileReader> reader;
   KATANA_CHECKED(
       parquet::arrow::OpenFile(fv_tmp, arrow::default_memory_pool(), &reader));
+  // Decode columns concurrently on arrow's CPU thread pool
+  reader->set_use_threads(use_threads);
 
   return std::unique_ptr<parquet::arrow::FileReader>(std::move(reader));
 }
 
+/// \returns the byte range [begin, end) of the file holding a column chunk
+std::pair<int64_t, int64_t>
+ColumnChunkRange(const parquet::ColumnChunkMetaData& md) {
+  int64_t begin = md.data_page_offset();
+  if (md.has_dictionary_page() && md.dictionary_page_offset() > 0) {
+    begin = std::min(begin, md.dictionary_page_offset());
+  }
+  return {begin, begin + md.total_compressed_size()};
+}
+
+void
+CollectLeaves(
+    const parquet::arrow::SchemaField& field, std::vector<int>* leaves) {
+  if (field.is_leaf()) {
+    leaves->emplace_back(field.column_index);
+  }
+  for (const auto& child : field.children) {
+    CollectLeaves(child, leaves);
+  }
+}
+
+/// \returns the parquet leaf column indexes that make up the top level
+/// schema fields \p fields
+std::vector<int>
+LeafIndices(
+    parquet::arrow::FileReader* reader, const std::vector<int>& fields) {
+  std::vector<int> leaves;
+  for (int field : fields) {
+    CollectLeaves(reader->manifest().schema_fields[field], &leaves);
+  }
+  return leaves;
+}
+
+/// Read rows [first_row, last_row) of the leaf columns \p leaves (or all
+/// columns if null). Only the column chunks of the row groups that overlap
+/// the rows are fetched from storage.
 Result<std::shared_ptr<arrow::Table>>
 ReadTableSlice(
     parquet::arrow::FileReader* reader, tsuba::FileView* fv, int64_t first_row,
-    int64_t last_row) {
+    int64_t last_row, const std::vector<int>* leaves = nullptr) {
+  auto metadata = reader->parquet_reader()->metadata();
   std::vector<int> row_groups;
   int rg_count = reader->num_row_groups();
   int64_t row_offset = 0;
   int64_t cumulative_rows = 0;
-  int64_t file_offset = 0;
-  int64_t cumulative_bytes = 0;
 
   for (int i = 0; cumulative_rows < last_row && i < rg_count; ++i) {
-    auto rg_md = reader->parquet_reader()->metadata()->RowGroup(i);
-    int64_t new_rows = rg_md->num_rows();
-    int64_t new_bytes = rg_md->total_byte_size();
+    int64_t new_rows = metadata->RowGroup(i)->num_rows();
     if (first_row < cumulative_rows + new_rows) {
       if (row_groups.empty()) {
         row_offset = first_row - cumulative_rows;
-        file_offset = cumulative_bytes;
       }
       row_groups.push_back(i);
     }
     cumulative_rows += new_rows;
-    cumulative_bytes += new_bytes;
   }
 
-  if (auto res = fv->Fill(file_offset, cumulative_bytes, false); !res) {
-    return res.error();
+  std::vector<std::pair<uint64_t, uint64_t>> ranges;
+  for (int rg : row_groups) {
+    auto rg_md = metadata->RowGroup(rg);
+    if (leaves) {
+      for (int leaf : *leaves) {
+        ranges.emplace_back(ColumnChunkRange(*rg_md->ColumnChunk(leaf)));
+      }
+    } else {
+      for (int col = 0, num_cols = rg_md->num_columns(); col < num_cols;
+           ++col) {
+        ranges.emplace_back(ColumnChunkRange(*rg_md->ColumnChunk(col)));
+      }
+    }
   }
 
+  // Fetch all the ranges with one vectored read, which coalesces nearby
+  // column chunks; parquet's reads through the FileView wait for it
+  KATANA_CHECKED(fv->Fill(ranges, false));
+
   std::shared_ptr<arrow::Table> out;
-  KATANA_CHECKED(reader->ReadRowGroups(row_groups, &out));
+  if (leaves) {
+    KATANA_CHECKED(reader->ReadRowGroups(row_groups, *leaves, &out));
+  } else {
+    KATANA_CHECKED(reader->ReadRowGroups(row_groups, &out));
+  }
   return out->Slice(row_offset, last_row - first_row);
 }
 
@@ -160,9 +253,9 @@ public:
   /// "s3://example_file/table.parquet.part_000000000" and rows 10-end are
   /// in "s3://example_file/table.parquet.part_000000001"
   static Result<std::unique_ptr<BlockedParquetReader>> Make(
-      const katana::Uri& uri, bool preload) {
+      const katana::Uri& uri, bool preload, bool use_threads) {
     std::shared_ptr<tsuba::FileView> fv;
-    auto builder_res = BuildReader(uri.string(), preload, &fv);
+    auto builder_res = BuildReader(uri.string(), preload, use_threads, &fv);
 
     if (builder_res) {
       std::vector<std::unique_ptr<parquet::arrow::FileReader>> readers;
@@ -171,7 +264,8 @@ public:
       fvs.emplace_back(std::move(fv));
 
       return std::unique_ptr<BlockedParquetReader>(new BlockedParquetReader(
-          uri.string(), std::move(fvs), std::move(readers), {0}));
+          uri.string(), std::move(fvs), std::move(readers), {0},
+          use_threads));
     }
 
     if (builder_res.error() != katana::ErrorCode::InvalidArgument) {
@@ -199,7 +293,7 @@ public:
 
     std::unique_ptr<BlockedParquetReader> bpr(new BlockedParquetReader(
         uri.string(), std::move(fvs), std::move(readers),
-        std::move(row_offsets)));
+        std::move(row_offsets), use_threads));
 
     if (preload) {
       for (size_t i = 0, num_files = bpr->row_offsets_.size(); i < num_files;
@@ -233,19 +327,86 @@ public:
   Result<std::shared_ptr<arrow::Table>> ReadTable(
       std::optional<tsuba::ParquetReader::Slice> slice = std::nullopt) {
     if (!slice) {
-      std::vector<std::shared_ptr<arrow::Table>> tables;
-      for (size_t i = 0, num_files = readers_.size(); i < num_files; ++i) {
-        KATANA_CHECKED(EnsureReader(i, true));
-        std::shared_ptr<arrow::Table> table;
-        KATANA_CHECKED(readers_[i]->ReadTable(&table));
-        tables.emplace_back(std::move(table));
+      std::vector<std::shared_ptr<arrow::Table>> tables(readers_.size());
+      if (use_threads_ && readers_.size() > 1) {
+        KATANA_CHECKED(ReadFilesConcurrently(&tables));
+      } else {
+        for (size_t i = 0, num_files = readers_.size(); i < num_files; ++i) {
+          KATANA_CHECKED(ReadFile(i, &tables[i]));
+        }
       }
       return KATANA_CHECKED(arrow::ConcatenateTables(tables));
     }
+    return ReadRows(slice->offset, slice->offset + slice->length, nullptr);
+  }
+
+  /// Read the columns at \p col_indexes (top level schema fields, possibly
+  /// repeated) in the requested order, optionally only the rows in \p slice
+  Result<std::shared_ptr<arrow::Table>> ReadTable(
+      const std::vector<int32_t>& col_indexes,
+      std::optional<tsuba::ParquetReader::Slice> slice = std::nullopt) {
+    KATANA_CHECKED(EnsureReader(0));
+    std::shared_ptr<arrow::Schema> schema;
+    KATANA_CHECKED(readers_[0]->GetSchema(&schema));
+    for (int32_t idx : col_indexes) {
+      if (idx < 0) {
+        return KATANA_ERROR(
+            ErrorCode::InvalidArgument, "column indexes must be positive");
+      }
+      if (idx >= schema->num_fields()) {
+        return KATANA_ERROR(
+            ErrorCode::InvalidArgument,
+            "column index {} should be less than the number of columns {}",
+            idx, schema->num_fields());
+      }
+    }
+
+    // Parquet returns projected fields in file order without repeats
+    std::vector<int> fields(col_indexes.begin(), col_indexes.end());
+    std::sort(fields.begin(), fields.end());
+    fields.erase(std::unique(fields.begin(), fields.end()), fields.end());
+
+    int64_t first_row = slice ? slice->offset : 0;
+    int64_t last_row = slice ? slice->offset + slice->length
+                             : std::numeric_limits<int64_t>::max();
+    std::shared_ptr<arrow::Table> table =
+        KATANA_CHECKED(ReadRows(first_row, last_row, &fields));
+
+    std::vector<std::shared_ptr<arrow::Field>> out_fields;
+    std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+    for (int32_t idx : col_indexes) {
+      int pos = std::lower_bound(fields.begin(), fields.end(), idx) -
+                fields.begin();
+      out_fields.emplace_back(table->field(pos));
+      columns.emplace_back(table->column(pos));
+    }
+    return arrow::Table::Make(arrow::schema(out_fields), columns);
+  }
+
+private:
+  BlockedParquetReader(
+      std::string prefix, std::vector<std::shared_ptr<tsuba::FileView>>&& fvs,
+      std::vector<std::unique_ptr<parquet::arrow::FileReader>>&& readers,
+      std::vector<int64_t>&& row_offsets, bool use_threads)
+      : prefix_(std::move(prefix)),
+        fvs_(std::move(fvs)),
+        readers_(std::move(readers)),
+        row_offsets_(std::move(row_offsets)),
+        use_threads_(use_threads) {}
+
+  /// Read rows [first_row, last_row) of the top level fields \p fields (or
+  /// all fields if null) across all files. last_row is clamped to the
+  /// number of rows.
+  Result<std::shared_ptr<arrow::Table>> ReadRows(
+      int64_t first_row, int64_t last_row, const std::vector<int>* fields) {
+    if (first_row < 0 || last_row < first_row) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "slice offset and length must be non-negative");
+    }
 
-    int64_t curr_global_row = slice->offset;
-    int64_t last_global_row =
-        std::min(KATANA_CHECKED(NumRows()), curr_global_row + slice->length);
+    int64_t curr_global_row = first_row;
+    int64_t last_global_row = std::min(KATANA_CHECKED(NumRows()), last_row);
 
     if (last_global_row < curr_global_row) {
       return KATANA_ERROR(
@@ -268,18 +429,23 @@ public:
           (idx == row_offsets_.size() - 1 ? std::numeric_limits<int64_t>::max()
                                           : row_offsets_[idx + 1]);
       std::shared_ptr<arrow::Table> table;
-      if (curr_global_row == table_offset &&
+      if (!fields && curr_global_row == table_offset &&
           last_global_row >= next_table_offset) {
         KATANA_CHECKED(EnsureReader(idx, true));
         KATANA_CHECKED(readers_[idx]->ReadTable(&table));
       } else {
         KATANA_CHECKED(EnsureReader(idx, false));
+        std::optional<std::vector<int>> leaves;
+        if (fields) {
+          leaves = LeafIndices(readers_[idx].get(), *fields);
+        }
         table = KATANA_CHECKED(ReadTableSlice(
             readers_[idx].get(), fvs_[idx].get(),
             curr_global_row - table_offset,
             std::min(
                 next_table_offset - table_offset,
-                last_global_row - table_offset)));
+                last_global_row - table_offset),
+            leaves ? &leaves.value() : nullptr));
       }
       tables.emplace_back(std::move(table));
       curr_global_row = next_table_offset;
@@ -288,7 +454,14 @@ public:
     if (tables.empty()) {
       KATANA_CHECKED(EnsureReader(0, false));
       std::shared_ptr<arrow::Schema> schema;
-      KATANA_CHECKED(readers_[idx]->GetSchema(&schema));
+      KATANA_CHECKED(readers_[0]->GetSchema(&schema));
+      if (fields) {
+        std::vector<std::shared_ptr<arrow::Field>> subset;
+        for (int field : *fields) {
+          subset.emplace_back(schema->field(field));
+        }
+        schema = arrow::schema(subset);
+      }
 
       std::vector<std::shared_ptr<arrow::ChunkedArray>> cols;
       for (const auto& field : schema->fields()) {
@@ -301,69 +474,54 @@ public:
     return KATANA_CHECKED(arrow::ConcatenateTables(tables));
   }
 
-  Result<std::shared_ptr<arrow::Table>> ReadTable(
-      std::vector<int32_t> col_indexes,
-      std::optional<tsuba::ParquetReader::Slice> slice = std::nullopt) {
-    std::vector<std::shared_ptr<arrow::Table>> tables;
-
-    for (auto& reader : readers_) {
-      std::vector<std::shared_ptr<arrow::Field>> fields;
-      std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
-      std::unordered_map<int32_t, std::shared_ptr<arrow::ChunkedArray>>
-          read_arrays;
+  Result<void> ReadFile(size_t idx, std::shared_ptr<arrow::Table>* table) {
+    KATANA_CHECKED(EnsureReader(idx, true));
+    KATANA_CHECKED(readers_[idx]->ReadTable(table));
+    return katana::ResultSuccess();
+  }
 
-      std::shared_ptr<arrow::Schema> schema;
-      KATANA_CHECKED(reader->GetSchema(&schema));
-      for (int32_t idx : col_indexes) {
-        if (idx < 0) {
-          return KATANA_ERROR(
-              ErrorCode::InvalidArgument, "column indexes must be positive");
-        }
-        if (idx >= schema->num_fields()) {
-          return KATANA_ERROR(
-              ErrorCode::InvalidArgument,
-              "column index {} should be less than the number of columns {}",
-              idx, schema->num_fields());
-        }
-        std::shared_ptr<arrow::ChunkedArray> column;
-        if (auto arr_it = read_arrays.find(idx); arr_it != read_arrays.end()) {
-          column = arr_it->second;
-        } else {
-          KATANA_CHECKED(reader->ReadColumn(idx, &column));
-          read_arrays.emplace(idx, column);
+  /// Fetch and decode the files of a blocked table on a fixed number of
+  /// threads, at most one per hardware thread, that take the next file
+  /// until none is left; each file has its own reader and FileView so they
+  /// do not share state
+  Result<void> ReadFilesConcurrently(
+      std::vector<std::shared_ptr<arrow::Table>>* tables) {
+    size_t num_files = readers_.size();
+    size_t num_workers = std::min<size_t>(
+        num_files, std::max(1U, std::thread::hardware_concurrency()));
+    std::atomic<size_t> next{0};
+    std::mutex mutex;
+    katana::CopyableResult<void> ret = katana::CopyableResultSuccess();
+    auto work = [&]() {
+      for (size_t i = next++; i < num_files; i = next++) {
+        if (auto res = ReadFile(i, &(*tables)[i]); !res) {
+          std::lock_guard<std::mutex> lock(mutex);
+          if (ret) {
+            ret = res.error();
+          }
         }
-        fields.emplace_back(schema->field(idx));
-        columns.emplace_back(std::move(column));
       }
-      tables.emplace_back(arrow::Table::Make(arrow::schema(fields), columns));
+    };
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < num_workers; ++i) {
+      workers.emplace_back(work);
     }
-
-    std::shared_ptr<arrow::Table> concatenated_table =
-        KATANA_CHECKED(arrow::ConcatenateTables(tables));
-    if (slice) {
-      concatenated_table =
-          concatenated_table->Slice(slice->offset, slice->length);
+    work();
+    for (auto& worker : workers) {
+      worker.join();
     }
-    return concatenated_table;
+    KATANA_CHECKED(ret);
+    return katana::ResultSuccess();
   }
 
-private:
-  BlockedParquetReader(
-      std::string prefix, std::vector<std::shared_ptr<tsuba::FileView>>&& fvs,
-      std::vector<std::unique_ptr<parquet::arrow::FileReader>>&& readers,
-      std::vector<int64_t>&& row_offsets)
-      : prefix_(std::move(prefix)),
-        fvs_(std::move(fvs)),
-        readers_(std::move(readers)),
-        row_offsets_(std::move(row_offsets)) {}
-
   Result<void> EnsureReader(size_t idx, bool preload = false) {
     if (readers_[idx]) {
       KATANA_LOG_ASSERT(fvs_[idx]);
       return katana::ResultSuccess();
     }
     readers_[idx] = KATANA_CHECKED(BuildReader(
-        fmt::format("{}.part_{:09}", prefix_, idx), preload, &fvs_[idx]));
+        fmt::format("{}.part_{:09}", prefix_, idx), preload, use_threads_,
+        &fvs_[idx]));
 
     return katana::ResultSuccess();
   }
@@ -372,6 +530,17 @@ private:
   std::vector<std::shared_ptr<tsuba::FileView>> fvs_;
   std::vector<std::unique_ptr<parquet::arrow::FileReader>> readers_;
   std::vector<int64_t> row_offsets_;
+  bool use_threads_;
+};
+
+/// Count a table read, successful or not, in the IOStats
+class DecodeTimer {
+public:
+  DecodeTimer() : start_(tsuba::IONowNs()) {}
+  ~DecodeTimer() { tsuba::RecordDecode(tsuba::IONowNs() - start_); }
+
+private:
+  uint64_t start_;
 };
 
 }  // namespace
@@ -379,11 +548,12 @@ private:
 Result<std::unique_ptr<tsuba::ParquetReader>>
 tsuba::ParquetReader::Make(ReadOpts opts) {
   return std::unique_ptr<ParquetReader>(
-      new ParquetReader(opts.slice, opts.make_cannonical));
+      new ParquetReader(opts.slice, opts.make_cannonical, opts.use_threads));
 }
 
 Result<std::shared_ptr<arrow::Table>>
 tsuba::ParquetReader::ReadTable(const katana::Uri& uri) {
+  DecodeTimer timer;
   bool preload = true;
   if (slice_) {
     if (slice_->offset < 0 || slice_->length < 0) {
@@ -394,37 +564,47 @@ tsuba::ParquetReader::ReadTable(const katana::Uri& uri) {
     preload = false;
   }
 
-  auto bpr = KATANA_CHECKED(BlockedParquetReader::Make(uri, preload));
+  auto bpr =
+      KATANA_CHECKED(BlockedParquetReader::Make(uri, preload, use_threads_));
   return FixTable(KATANA_CHECKED(bpr->ReadTable(slice_)));
 }
 
 katana::Result<std::shared_ptr<arrow::Schema>>
 tsuba::ParquetReader::GetSchema(const katana::Uri& uri) {
-  auto bpr = KATANA_CHECKED(BlockedParquetReader::Make(uri, false));
+  auto bpr =
+      KATANA_CHECKED(BlockedParquetReader::Make(uri, false, use_threads_));
   return FixSchema(KATANA_CHECKED(bpr->ReadSchema()));
 }
 
 Result<std::shared_ptr<arrow::Table>>
 tsuba::ParquetReader::ReadColumn(const katana::Uri& uri, int32_t column_idx) {
-  auto bpr = KATANA_CHECKED(BlockedParquetReader::Make(uri, false));
-  return FixTable(KATANA_CHECKED(bpr->ReadTable({column_idx})));
+  DecodeTimer timer;
+  auto bpr =
+      KATANA_CHECKED(BlockedParquetReader::Make(uri, false, use_threads_));
+  return FixTable(KATANA_CHECKED(bpr->ReadTable({column_idx}, slice_)));
 }
 
 Result<std::shared_ptr<arrow::Table>>
 tsuba::ParquetReader::ReadTable(
     const katana::Uri& uri, const std::vector<int32_t>& column_indexes) {
-  auto bpr = KATANA_CHECKED(BlockedParquetReader::Make(uri, false));
-  return FixTable(KATANA_CHECKED(bpr->ReadTable(column_indexes)));
+  DecodeTimer timer;
+  auto bpr =
+      KATANA_CHECKED(BlockedParquetReader::Make(uri, false, use_threads_));
+  return FixTable(KATANA_CHECKED(bpr->ReadTable(column_indexes, slice_)));
 }
 
 Result<int32_t>
 tsuba::ParquetReader::NumColumns(const katana::Uri& uri) {
-  return KATANA_CHECKED(BlockedParquetReader::Make(uri, false))->NumColumns();
+  auto bpr =
+      KATANA_CHECKED(BlockedParquetReader::Make(uri, false, use_threads_));
+  return bpr->NumColumns();
 }
 
 Result<int64_t>
 tsuba::ParquetReader::NumRows(const katana::Uri& uri) {
-  return KATANA_CHECKED(BlockedParquetReader::Make(uri, false))->NumRows();
+  auto bpr =
+      KATANA_CHECKED(BlockedParquetReader::Make(uri, false, use_threads_));
+  return bpr->NumRows();
 }
 
 Result<std::shared_ptr<arrow::Schema>>
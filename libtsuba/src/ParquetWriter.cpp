@@ -1,5 +1,16 @@
 #include "tsuba/ParquetWriter.h"
 
+#include <algorithm>
+#include <cstring>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <arrow/util/config.h>
+#include <parquet/arrow/schema.h>
+#include <parquet/schema.h>
+
 #include "katana/ArrowInterchange.h"
 #include "katana/JSON.h"
 #include "katana/Result.h"
@@ -91,6 +102,39 @@ HandleBadParquetTypes(std::shared_ptr<arrow::ChunkedArray> old_array) {
     }
     return maybe_res.ValueOrDie();
   }
+  case arrow::Type::type::DICTIONARY: {
+    // Codes are written as they are; only the dictionary values are
+    // converted
+    const auto& type =
+        static_cast<const arrow::DictionaryType&>(*old_array->type());
+    if (type.value_type()->id() != arrow::Type::LARGE_STRING) {
+      return old_array;
+    }
+    auto new_type =
+        arrow::dictionary(type.index_type(), arrow::utf8(), type.ordered());
+    std::vector<std::shared_ptr<arrow::Array>> new_chunks;
+    for (const auto& chunk : old_array->chunks()) {
+      auto arr = std::static_pointer_cast<arrow::DictionaryArray>(chunk);
+      auto dictionary_chunks =
+          KATANA_CHECKED(LargeStringToChunkedString(
+              std::static_pointer_cast<arrow::LargeStringArray>(
+                  arr->dictionary())));
+      if (dictionary_chunks.size() > 1) {
+        return KATANA_ERROR(
+            tsuba::ErrorCode::NotImplemented,
+            "dictionary values do not fit in a string array");
+      }
+      std::shared_ptr<arrow::Array> dictionary;
+      if (dictionary_chunks.empty()) {
+        dictionary = KATANA_CHECKED(arrow::MakeArrayOfNull(arrow::utf8(), 0));
+      } else {
+        dictionary = dictionary_chunks[0];
+      }
+      new_chunks.emplace_back(KATANA_CHECKED(arrow::DictionaryArray::FromArrays(
+          new_type, arr->indices(), dictionary)));
+    }
+    return std::make_shared<arrow::ChunkedArray>(new_chunks, new_type);
+  }
   default:
     return old_array;
   }
@@ -160,50 +204,340 @@ BlockTable(std::shared_ptr<arrow::Table> table, uint64_t mbs_per_block) {
   return blocks;
 }
 
+// Codec sampling
+constexpr int64_t kSampleRows = 1 << 14;
+constexpr int64_t kSampleSlices = 4;
+// A column with fewer distinct values than 1 in kFewDistinct is left to
+// dictionary encoding
+constexpr uint64_t kFewDistinct = 4;
+// A sample that does not compress below this fraction is stored as it is
+constexpr double kIncompressible = 0.9;
+// ZSTD at kSlowZstdLevel is chosen over kFastZstdLevel only when it saves
+// more than 1 - kSlowZstdGain of the size; decompression, which is what
+// loads pay for, is as fast at either level
+constexpr int kFastZstdLevel = 1;
+constexpr int kSlowZstdLevel = 9;
+constexpr double kSlowZstdGain = 0.9;
+// LZ4 decompresses faster than ZSTD, so it is chosen unless it is more than
+// kLz4Loss times larger
+constexpr double kLz4Loss = 1.1;
+
+/// Up to kSampleRows values of column from kSampleSlices evenly spaced slices
+std::vector<std::shared_ptr<arrow::Array>>
+SampleColumn(const arrow::ChunkedArray& column) {
+  int64_t length = column.length();
+  if (length <= kSampleRows) {
+    return column.chunks();
+  }
+  std::vector<std::shared_ptr<arrow::Array>> sample;
+  int64_t slice_length = kSampleRows / kSampleSlices;
+  for (int64_t i = 0; i < kSampleSlices; ++i) {
+    int64_t offset = (length - slice_length) * i / (kSampleSlices - 1);
+    for (const auto& chunk : column.Slice(offset, slice_length)->chunks()) {
+      sample.emplace_back(chunk);
+    }
+  }
+  return sample;
+}
+
+/// Append the non-null values of array to bytes as they are laid out in
+/// memory. Returns the width of a value, 0 for variable width values, or
+/// nullopt for types without a flat layout.
+std::optional<int>
+AppendValueBytes(const arrow::Array& array, std::string* bytes) {
+  const arrow::ArrayData& data = *array.data();
+  switch (array.type_id()) {
+  case arrow::Type::STRING:
+  case arrow::Type::BINARY: {
+    const auto& binary = static_cast<const arrow::BinaryArray&>(array);
+    bytes->append(
+        reinterpret_cast<const char*>(binary.value_data()->data()) +
+            binary.value_offset(0),
+        binary.value_offset(binary.length()) - binary.value_offset(0));
+    return 0;
+  }
+  case arrow::Type::LARGE_STRING:
+  case arrow::Type::LARGE_BINARY: {
+    const auto& binary = static_cast<const arrow::LargeBinaryArray&>(array);
+    bytes->append(
+        reinterpret_cast<const char*>(binary.value_data()->data()) +
+            binary.value_offset(0),
+        binary.value_offset(binary.length()) - binary.value_offset(0));
+    return 0;
+  }
+  case arrow::Type::DICTIONARY:
+    return std::nullopt;
+  default:
+    break;
+  }
+  const auto* fixed_width =
+      dynamic_cast<const arrow::FixedWidthType*>(array.type().get());
+  if (fixed_width == nullptr || fixed_width->bit_width() % 8 != 0) {
+    return std::nullopt;
+  }
+  int bit_width = fixed_width->bit_width();
+  int width = bit_width / 8;
+  const char* values =
+      reinterpret_cast<const char*>(data.buffers[1]->data()) +
+      data.offset * width;
+  if (array.null_count() == 0) {
+    bytes->append(values, array.length() * width);
+    return width;
+  }
+  for (int64_t i = 0; i < array.length(); ++i) {
+    if (array.IsValid(i)) {
+      bytes->append(values + i * width, width);
+    }
+  }
+  return width;
+}
+
+/// The values in bytes with the k-th bytes of all values together, which is
+/// what BYTE_STREAM_SPLIT stores
+std::string
+ByteStreamSplit(const std::string& bytes, int width) {
+  size_t num_values = bytes.size() / width;
+  std::string split(num_values * width, '\0');
+  for (size_t i = 0; i < num_values; ++i) {
+    for (int b = 0; b < width; ++b) {
+      split[b * num_values + i] = bytes[i * width + b];
+    }
+  }
+  return split;
+}
+
+#if ARROW_VERSION_MAJOR >= 8
+// Older parquet libraries cannot write DELTA_BINARY_PACKED
+template <typename T>
+bool
+IsSorted(const std::string& bytes) {
+  size_t num_values = bytes.size() / sizeof(T);
+  T prev{};
+  for (size_t i = 0; i < num_values; ++i) {
+    T value;
+    std::memcpy(&value, bytes.data() + i * sizeof(T), sizeof(T));
+    if (i > 0 && value < prev) {
+      return false;
+    }
+    prev = value;
+  }
+  return true;
+}
+
+/// Whether the integers in bytes, of width bytes each, are in order
+bool
+IsSortedInteger(const std::string& bytes, int width, bool is_signed) {
+  switch (width) {
+  case 1:
+    return is_signed ? IsSorted<int8_t>(bytes) : IsSorted<uint8_t>(bytes);
+  case 2:
+    return is_signed ? IsSorted<int16_t>(bytes) : IsSorted<uint16_t>(bytes);
+  case 4:
+    return is_signed ? IsSorted<int32_t>(bytes) : IsSorted<uint32_t>(bytes);
+  case 8:
+    return is_signed ? IsSorted<int64_t>(bytes) : IsSorted<uint64_t>(bytes);
+  default:
+    return false;
+  }
+}
+#endif
+
+uint64_t
+CountDistinct(const std::string& bytes, int width) {
+  std::unordered_set<std::string_view> distinct;
+  for (size_t i = 0; i + width <= bytes.size(); i += width) {
+    distinct.emplace(bytes.data() + i, width);
+  }
+  return distinct.size();
+}
+
+/// The size of bytes compressed with type at level, or nullopt if arrow was
+/// built without the codec
+std::optional<uint64_t>
+CompressedSize(
+    const std::string& bytes, arrow::Compression::type type, int level) {
+  auto codec_res = arrow::util::Codec::Create(type, level);
+  if (!codec_res.ok()) {
+    return std::nullopt;
+  }
+  std::unique_ptr<arrow::util::Codec> codec =
+      std::move(codec_res).ValueOrDie();
+  const auto* input = reinterpret_cast<const uint8_t*>(bytes.data());
+  int64_t max_size = codec->MaxCompressedLen(bytes.size(), input);
+  std::vector<uint8_t> output(max_size);
+  auto size_res =
+      codec->Compress(bytes.size(), input, max_size, output.data());
+  if (!size_res.ok()) {
+    return std::nullopt;
+  }
+  return size_res.ValueOrDie();
+}
+
+/// Set the compression of codec from how well a sample of its values, laid
+/// out as they will be stored, compresses
+void
+ChooseCompression(const std::string& bytes, tsuba::ColumnCodec* codec) {
+  auto zstd_fast =
+      CompressedSize(bytes, arrow::Compression::ZSTD, kFastZstdLevel);
+  auto zstd_slow =
+      CompressedSize(bytes, arrow::Compression::ZSTD, kSlowZstdLevel);
+  auto lz4 = CompressedSize(
+      bytes, arrow::Compression::LZ4, arrow::util::kUseDefaultCompressionLevel);
+
+  codec->compression = arrow::Compression::UNCOMPRESSED;
+  codec->compression_level = arrow::util::kUseDefaultCompressionLevel;
+  uint64_t smallest = bytes.size();
+  for (const auto& size : {zstd_fast, zstd_slow, lz4}) {
+    if (size) {
+      smallest = std::min(smallest, size.value());
+    }
+  }
+  if (smallest > kIncompressible * bytes.size()) {
+    return;
+  }
+  if (zstd_fast && zstd_slow &&
+      zstd_slow.value() < kSlowZstdGain * zstd_fast.value()) {
+    codec->compression = arrow::Compression::ZSTD;
+    codec->compression_level = kSlowZstdLevel;
+  } else if (
+      lz4 && (!zstd_fast || lz4.value() <= kLz4Loss * zstd_fast.value())) {
+    codec->compression = arrow::Compression::LZ4;
+  } else {
+    codec->compression = arrow::Compression::ZSTD;
+    codec->compression_level = kFastZstdLevel;
+  }
+}
+
+/// Whether arrow was built with the codec
+bool
+IsAvailable(arrow::Compression::type type) {
+  return arrow::util::Codec::Create(type).ok();
+}
+
+/// The compression of columns that cannot be sampled
+void
+DefaultCompression(tsuba::ColumnCodec* codec) {
+  if (IsAvailable(arrow::Compression::ZSTD)) {
+    codec->compression = arrow::Compression::ZSTD;
+    codec->compression_level = kFastZstdLevel;
+  } else if (IsAvailable(arrow::Compression::LZ4)) {
+    codec->compression = arrow::Compression::LZ4;
+  }
+}
+
+std::shared_ptr<parquet::ArrowWriterProperties>
+StandardArrowProperties() {
+  parquet::ArrowWriterProperties::Builder builder;
+  // The stored arrow schema lets readers restore dictionary encoded columns
+  // as dictionary arrays instead of decoding them
+  builder.store_schema();
+#if ARROW_VERSION_MAJOR >= 8
+  // Encode and compress the columns of a row group in parallel
+  builder.set_use_threads(true);
+#endif
+  return builder.build();
+}
+
+/// Writer properties for table with the codecs that opts.codec_policy
+/// chooses for its columns
+Result<std::shared_ptr<parquet::WriterProperties>>
+MakeWriterProperties(
+    const arrow::Table& table, const tsuba::ParquetWriter::WriteOpts& opts,
+    const parquet::ArrowWriterProperties& arrow_props) {
+  parquet::WriterProperties::Builder builder;
+  builder.version(opts.parquet_version)
+      ->data_page_version(opts.data_page_version)
+      ->max_row_group_length(opts.max_row_group_length);
+
+  // The parquet columns, i.e., the leaves, that each arrow column becomes
+  std::shared_ptr<parquet::SchemaDescriptor> descriptor;
+  KATANA_CHECKED(parquet::arrow::ToParquetSchema(
+      table.schema().get(), *builder.build(), arrow_props, &descriptor));
+  std::unordered_map<const parquet::schema::Node*, int> root_index;
+  for (int i = 0; i < descriptor->group_node()->field_count(); ++i) {
+    root_index.emplace(descriptor->group_node()->field(i).get(), i);
+  }
+
+  std::vector<tsuba::ColumnCodec> codecs;
+  for (int i = 0; i < table.num_columns(); ++i) {
+    const arrow::Field& field = *table.field(i);
+    const arrow::ChunkedArray& column = *table.column(i);
+    codecs.emplace_back(
+        opts.codec_policy
+            ? opts.codec_policy(field, column)
+            : tsuba::ParquetWriter::ChooseColumnCodec(field, column));
+  }
+
+  for (int i = 0; i < descriptor->num_columns(); ++i) {
+    const tsuba::ColumnCodec& codec =
+        codecs.at(root_index.at(descriptor->GetColumnRoot(i)));
+    std::shared_ptr<parquet::schema::ColumnPath> path =
+        descriptor->Column(i)->path();
+    builder.compression(path, codec.compression);
+    if (codec.compression_level != arrow::util::kUseDefaultCompressionLevel) {
+      builder.compression_level(path, codec.compression_level);
+    }
+    if (descriptor->Column(i)->schema_node()->parent() !=
+        descriptor->group_node()) {
+      continue;
+    }
+    if (!codec.dictionary) {
+      builder.disable_dictionary(path);
+    }
+    if (codec.encoding == parquet::Encoding::PLAIN_DICTIONARY ||
+        codec.encoding == parquet::Encoding::RLE_DICTIONARY) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "column {}: use ColumnCodec::dictionary for dictionary encoding",
+          path->ToDotString());
+    }
+    if (codec.encoding != parquet::Encoding::PLAIN) {
+      builder.encoding(path, codec.encoding);
+    }
+  }
+  return builder.build();
+}
+
 Result<void>
 DoStoreParquet(
     const std::string& path, std::shared_ptr<arrow::Table> table,
-    const std::shared_ptr<parquet::WriterProperties>& writer_props,
-    const std::shared_ptr<parquet::ArrowWriterProperties>& arrow_props,
-    tsuba::WriteGroup* desc) {
-  auto ff = std::make_shared<tsuba::FileFrame>();
-  KATANA_CHECKED(ff->Init());
-  ff->Bind(path);
-
-  auto future = std::async(
-      std::launch::async,
-      [table = std::move(table), ff = std::move(ff), desc, writer_props,
-       arrow_props]() mutable -> katana::CopyableResult<void> {
-        table = KATANA_CHECKED(HandleBadParquetTypes(table));
-        auto write_result = parquet::arrow::WriteTable(
-            *table, arrow::default_memory_pool(), ff,
-            std::numeric_limits<int64_t>::max(), writer_props, arrow_props);
-        table.reset();
-
-        if (!write_result.ok()) {
-          return KATANA_ERROR(
-              tsuba::ErrorCode::ArrowError, "arrow error: {}", write_result);
-        }
-        if (desc) {
-          desc->AddToOutstanding(ff->map_size());
-        }
-
-        TSUBA_PTP(tsuba::internal::FaultSensitivity::Normal);
-        if (auto res = ff->Persist(); !res) {
-          return res.error();
-        }
-        return katana::CopyableResultSuccess();
-      });
+    const tsuba::ParquetWriter::WriteOpts& opts, tsuba::WriteGroup* desc) {
+  auto encode = [path, table = std::move(table), opts]() mutable
+      -> katana::CopyableResult<std::shared_ptr<tsuba::FileFrame>> {
+    auto ff = std::make_shared<tsuba::FileFrame>();
+    KATANA_CHECKED(ff->Init());
+    ff->Bind(path);
+    if (opts.streaming_part_size > 0) {
+      KATANA_CHECKED(ff->StartStreaming(opts.streaming_part_size));
+    }
 
-  if (!desc) {
-    auto res = future.get();
-    if (!res) {
-      return res.error();
+    table = KATANA_CHECKED(HandleBadParquetTypes(table));
+    // Codecs are chosen here, so that sampling runs in parallel with the
+    // encoding of other files of a write group
+    auto arrow_props = StandardArrowProperties();
+    auto writer_props =
+        KATANA_CHECKED(MakeWriterProperties(*table, opts, *arrow_props));
+    auto write_result = parquet::arrow::WriteTable(
+        *table, arrow::default_memory_pool(), ff,
+        std::numeric_limits<int64_t>::max(), writer_props, arrow_props);
+    table.reset();
+
+    if (!write_result.ok()) {
+      return KATANA_ERROR(
+          tsuba::ErrorCode::ArrowError, "arrow error: {}", write_result);
     }
+    return ff;
+  };
+
+  if (!desc) {
+    auto ff = KATANA_CHECKED(encode());
+    TSUBA_PTP(tsuba::internal::FaultSensitivity::Normal);
+    KATANA_CHECKED(ff->Persist());
     return katana::ResultSuccess();
   }
 
-  desc->AddOp(std::move(future), path);
+  // Encoding and persisting overlap with the encoding of later tables
+  desc->StartEncodeAndStore(path, std::move(encode));
   return katana::ResultSuccess();
 }
 
@@ -240,17 +574,61 @@ tsuba::ParquetWriter::WriteToUri(const katana::Uri& uri, WriteGroup* group) {
   }
 }
 
-std::shared_ptr<parquet::WriterProperties>
-tsuba::ParquetWriter::StandardWriterProperties() {
-  return parquet::WriterProperties::Builder()
-      .version(opts_.parquet_version)
-      ->data_page_version(opts_.data_page_version)
-      ->build();
+tsuba::ColumnCodec
+tsuba::ParquetWriter::ChooseColumnCodec(
+    const arrow::Field& field, const arrow::ChunkedArray& column) {
+  ColumnCodec codec;
+  std::string bytes;
+  std::optional<int> width = 0;
+  for (const auto& chunk : SampleColumn(column)) {
+    width = AppendValueBytes(*chunk, &bytes);
+    if (!width) {
+      KATANA_LOG_DEBUG("column {} is not sampled", field.name());
+      DefaultCompression(&codec);
+      return codec;
+    }
+  }
+  if (bytes.empty()) {
+    DefaultCompression(&codec);
+    return codec;
+  }
+
+  arrow::Type::type type = column.type()->id();
+  bool is_float = type == arrow::Type::FLOAT || type == arrow::Type::DOUBLE;
+  bool is_integer = arrow::is_integer(type) || type == arrow::Type::DATE32 ||
+                    type == arrow::Type::DATE64 ||
+                    type == arrow::Type::TIMESTAMP;
+  if ((is_float || is_integer) && width.value() > 0) {
+    uint64_t num_values = bytes.size() / width.value();
+    if (CountDistinct(bytes, width.value()) * kFewDistinct > num_values) {
+      // Too many distinct values for a dictionary to pay off
+      codec.dictionary = false;
+      if (is_float) {
+        codec.encoding = parquet::Encoding::BYTE_STREAM_SPLIT;
+        bytes = ByteStreamSplit(bytes, width.value());
+      }
+#if ARROW_VERSION_MAJOR >= 8
+      bool is_signed = !arrow::is_unsigned_integer(type);
+      if (is_integer && IsSortedInteger(bytes, width.value(), is_signed)) {
+        codec.encoding = parquet::Encoding::DELTA_BINARY_PACKED;
+      }
+#endif
+    }
+  }
+  ChooseCompression(bytes, &codec);
+  return codec;
 }
 
-std::shared_ptr<parquet::ArrowWriterProperties>
-tsuba::ParquetWriter::StandardArrowProperties() {
-  return parquet::ArrowWriterProperties::Builder().build();
+tsuba::CodecPolicy
+tsuba::ParquetWriter::AutoCodecPolicy() {
+  return ChooseColumnCodec;
+}
+
+tsuba::CodecPolicy
+tsuba::ParquetWriter::FixedCodecPolicy(ColumnCodec codec) {
+  return [codec](const arrow::Field&, const arrow::ChunkedArray&) {
+    return codec;
+  };
 }
 
 /// Store the arrow table in a file
@@ -258,12 +636,10 @@ katana::Result<void>
 tsuba::ParquetWriter::StoreParquet(
     std::shared_ptr<arrow::Table> table, const katana::Uri& uri,
     tsuba::WriteGroup* desc) {
-  auto writer_props = StandardWriterProperties();
-  auto arrow_props = StandardArrowProperties();
   std::string prefix = uri.string();
 
   if (table->num_rows() <= kMaxRowsPerFile) {
-    return DoStoreParquet(prefix, table, writer_props, arrow_props, desc);
+    return DoStoreParquet(prefix, table, opts_, desc);
   }
 
   std::vector<std::shared_ptr<arrow::Table>> tables;
@@ -285,8 +661,7 @@ tsuba::ParquetWriter::StoreParquet(
   uint32_t table_count = 0;
   for (const auto& t : tables) {
     KATANA_CHECKED(DoStoreParquet(
-        fmt::format("{}.part_{:09}", prefix, table_count++), t, writer_props,
-        arrow_props, desc));
+        fmt::format("{}.part_{:09}", prefix, table_count++), t, opts_, desc));
   }
   return FileStore(
       uri.string(), KATANA_CHECKED(katana::JsonDump(table_offsets)));
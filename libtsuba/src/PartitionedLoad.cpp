@@ -0,0 +1,263 @@
+#include "tsuba/PartitionedLoad.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "GlobalState.h"
+#include "katana/CommBackend.h"
+#include "katana/Logging.h"
+#include "tsuba/Errors.h"
+
+namespace {
+
+using Range = std::pair<uint64_t, uint64_t>;
+
+/// The edges before node n
+uint64_t
+EdgesBefore(const uint64_t* out_indexes, uint64_t n) {
+  return n == 0 ? 0 : out_indexes[n - 1];
+}
+
+/// The ghosts of a host that owns node_range, in ascending order
+template <typename T>
+std::vector<uint64_t>
+FindGhosts(const T* dests, uint64_t num_edges, const Range& node_range) {
+  std::vector<uint64_t> ghosts;
+  for (uint64_t e = 0; e < num_edges; ++e) {
+    uint64_t dst = dests[e];
+    if (dst < node_range.first || dst >= node_range.second) {
+      ghosts.emplace_back(dst);
+    }
+  }
+  std::sort(ghosts.begin(), ghosts.end());
+  ghosts.erase(std::unique(ghosts.begin(), ghosts.end()), ghosts.end());
+  return ghosts;
+}
+
+template <typename T>
+void
+LocalizeDests(
+    const T* dests, uint64_t num_edges, const tsuba::PartitionedSlice& part,
+    std::vector<uint32_t>* local_dests) {
+  local_dests->resize(num_edges);
+  for (uint64_t e = 0; e < num_edges; ++e) {
+    (*local_dests)[e] = part.GetLocalID(dests[e]);
+  }
+}
+
+/// Exchange the ghosts of this host with their owners; the result holds the
+/// global IDs of the owned nodes that every host reads
+katana::Result<std::vector<std::vector<uint64_t>>>
+ExchangeGhosts(
+    katana::CommBackend* comm, const std::vector<uint64_t>& ghosts,
+    const std::vector<uint64_t>& ghost_counts) {
+  const uint32_t num_hosts = comm->Num;
+
+  // counts[h * num_hosts + o] is the number of ghosts of host h owned by o
+  std::vector<uint64_t> counts(uint64_t{num_hosts} * num_hosts);
+  KATANA_CHECKED_CONTEXT(
+      comm->Allgather(
+          ghost_counts.data(), num_hosts * sizeof(uint64_t), counts.data()),
+      "gathering ghost counts");
+
+  std::vector<uint64_t> send_bytes(num_hosts);
+  std::vector<uint64_t> recv_bytes(num_hosts);
+  uint64_t num_recv = 0;
+  for (uint32_t h = 0; h < num_hosts; ++h) {
+    send_bytes[h] = ghost_counts[h] * sizeof(uint64_t);
+    uint64_t count = counts[uint64_t{h} * num_hosts + comm->ID];
+    recv_bytes[h] = count * sizeof(uint64_t);
+    num_recv += count;
+  }
+
+  // Ghosts are sorted and every host owns a contiguous range, so they are
+  // already grouped by owner
+  std::vector<uint64_t> recv(num_recv);
+  KATANA_CHECKED_CONTEXT(
+      comm->Alltoallv(
+          ghosts.data(), send_bytes.data(), recv.data(), recv_bytes.data()),
+      "exchanging ghosts");
+
+  std::vector<std::vector<uint64_t>> mirrors(num_hosts);
+  auto it = recv.begin();
+  for (uint32_t h = 0; h < num_hosts; ++h) {
+    auto end = it + recv_bytes[h] / sizeof(uint64_t);
+    mirrors[h].assign(it, end);
+    it = end;
+  }
+  return mirrors;
+}
+
+}  // namespace
+
+std::vector<std::pair<uint64_t, uint64_t>>
+tsuba::ComputeEdgeBalancedRanges(
+    const uint64_t* out_indexes, uint64_t num_nodes, uint32_t num_hosts) {
+  KATANA_LOG_ASSERT(num_hosts > 0);
+  uint64_t num_edges = EdgesBefore(out_indexes, num_nodes);
+
+  std::vector<uint64_t> bounds(num_hosts + 1, num_nodes);
+  bounds[0] = 0;
+  for (uint32_t h = 1; h < num_hosts; ++h) {
+    if (num_edges == 0) {
+      bounds[h] =
+          num_nodes / num_hosts * h + num_nodes % num_hosts * h / num_hosts;
+      continue;
+    }
+    // The first node with at least h / num_hosts of the edges before it,
+    // computed without overflowing num_edges * h
+    uint64_t target =
+        num_edges / num_hosts * h + num_edges % num_hosts * h / num_hosts;
+    const uint64_t* it =
+        std::lower_bound(out_indexes, out_indexes + num_nodes, target);
+    uint64_t bound = std::min<uint64_t>(it - out_indexes + 1, num_nodes);
+    bounds[h] = std::max(bound, bounds[h - 1]);
+  }
+
+  std::vector<Range> ranges;
+  ranges.reserve(num_hosts);
+  for (uint32_t h = 0; h < num_hosts; ++h) {
+    ranges.emplace_back(bounds[h], bounds[h + 1]);
+  }
+  return ranges;
+}
+
+tsuba::RDGSlice::SliceArg
+tsuba::MakeSliceArg(
+    const RDGPrefix& prefix, std::pair<uint64_t, uint64_t> node_range) {
+  const uint64_t* out_indexes = prefix.out_indexes();
+  Range edge_range{
+      EdgesBefore(out_indexes, node_range.first),
+      EdgesBefore(out_indexes, node_range.second)};
+  uint64_t dest_size = CSRTopologyDestSize(prefix.version());
+  return RDGSlice::SliceArg{
+      .node_range = node_range,
+      .edge_range = edge_range,
+      .topo_off = prefix.view_offset() + edge_range.first * dest_size,
+      .topo_size = (edge_range.second - edge_range.first) * dest_size,
+  };
+}
+
+uint32_t
+tsuba::PartitionedSlice::GetHostID(uint64_t n) const {
+  auto it = std::upper_bound(
+      host_ranges.begin(), host_ranges.end(), n,
+      [](uint64_t node, const Range& range) { return node < range.second; });
+  KATANA_LOG_DEBUG_ASSERT(it != host_ranges.end());
+  return it - host_ranges.begin();
+}
+
+uint32_t
+tsuba::PartitionedSlice::GetLocalID(uint64_t n) const {
+  // The owned nodes are contiguous
+  auto owned_end = local_to_global.begin() + metadata.num_owned_;
+  if (metadata.num_owned_ > 0 && n >= local_to_global.front() &&
+      n - local_to_global.front() < metadata.num_owned_) {
+    return n - local_to_global.front();
+  }
+  auto it = std::lower_bound(owned_end, local_to_global.end(), n);
+  KATANA_LOG_DEBUG_ASSERT(it != local_to_global.end() && *it == n);
+  return it - local_to_global.begin();
+}
+
+katana::Result<tsuba::PartitionedSlice>
+tsuba::LoadPartitionedSlice(
+    RDGHandle handle, const std::optional<std::vector<std::string>>& node_props,
+    const std::optional<std::vector<std::string>>& edge_props) {
+  katana::CommBackend* comm = Comm();
+
+  RDGPrefix prefix = KATANA_CHECKED(RDGPrefix::Make(handle));
+  const bool wide = prefix.version() == kCSRTopology64Version;
+  if (prefix.version() != kCSRTopologyVersion && !wide) {
+    return KATANA_ERROR(
+        ErrorCode::NotImplemented,
+        "cannot load partitions of topology version {}", prefix.version());
+  }
+  const uint64_t* out_indexes = prefix.out_indexes();
+  std::vector<Range> host_ranges =
+      ComputeEdgeBalancedRanges(out_indexes, prefix.num_nodes(), comm->Num);
+  Range node_range = host_ranges[comm->ID];
+  if (node_range.second - node_range.first >
+      std::numeric_limits<uint32_t>::max()) {
+    return KATANA_ERROR(
+        ErrorCode::NotImplemented, "too many nodes for host {}: {}", comm->ID,
+        node_range.second - node_range.first);
+  }
+
+  RDGSlice::SliceArg slice_arg = MakeSliceArg(prefix, node_range);
+  RDGSlice slice = KATANA_CHECKED_CONTEXT(
+      RDGSlice::Make(handle, slice_arg, node_props, edge_props),
+      "loading slice of host {}", comm->ID);
+
+  const uint64_t first_edge = slice_arg.edge_range.first;
+  const uint64_t num_edges = slice_arg.edge_range.second - first_edge;
+  // Global IDs may need 64 bits, but local IDs fit in 32
+  const FileView& topo_storage = slice.topology_file_storage();
+  const uint32_t* dests = topo_storage.ptr<uint32_t>(slice_arg.topo_off);
+  const uint64_t* wide_dests = topo_storage.ptr<uint64_t>(slice_arg.topo_off);
+
+  std::vector<uint64_t> ghosts =
+      wide ? FindGhosts(wide_dests, num_edges, node_range)
+           : FindGhosts(dests, num_edges, node_range);
+
+  uint64_t num_owned = node_range.second - node_range.first;
+  if (num_owned + ghosts.size() > std::numeric_limits<uint32_t>::max()) {
+    return KATANA_ERROR(
+        ErrorCode::NotImplemented, "too many local nodes for host {}: {}",
+        comm->ID, num_owned + ghosts.size());
+  }
+
+  PartitionedSlice part{std::move(slice)};
+  part.host_ranges = std::move(host_ranges);
+
+  part.local_to_global.reserve(num_owned + ghosts.size());
+  for (uint64_t n = node_range.first; n < node_range.second; ++n) {
+    part.local_to_global.emplace_back(n);
+  }
+  part.local_to_global.insert(
+      part.local_to_global.end(), ghosts.begin(), ghosts.end());
+
+  PartitionMetadata& md = part.metadata;
+  md.is_outgoing_edge_cut_ = true;
+  md.num_global_nodes_ = prefix.num_nodes();
+  md.max_global_node_id_ = prefix.num_nodes() == 0 ? 0 : prefix.num_nodes() - 1;
+  md.num_global_edges_ = prefix.num_edges();
+  md.num_edges_ = num_edges;
+  md.num_nodes_ = part.local_to_global.size();
+  md.num_owned_ = num_owned;
+
+  part.out_indexes.resize(num_owned);
+  for (uint64_t n = 0; n < num_owned; ++n) {
+    part.out_indexes[n] = out_indexes[node_range.first + n] - first_edge;
+  }
+  if (wide) {
+    LocalizeDests(wide_dests, num_edges, part, &part.edge_dests);
+  } else {
+    LocalizeDests(dests, num_edges, part, &part.edge_dests);
+  }
+
+  std::vector<uint64_t> ghost_counts(comm->Num);
+  for (uint64_t ghost : ghosts) {
+    ghost_counts[part.GetHostID(ghost)] += 1;
+  }
+  auto mirrors = KATANA_CHECKED(ExchangeGhosts(comm, ghosts, ghost_counts));
+  part.mirrors.resize(comm->Num);
+  for (uint32_t h = 0; h < comm->Num; ++h) {
+    part.mirrors[h].reserve(mirrors[h].size());
+    for (uint64_t n : mirrors[h]) {
+      part.mirrors[h].emplace_back(n - node_range.first);
+    }
+  }
+
+  // Every edge must belong to exactly one host
+  uint64_t total_edges = KATANA_CHECKED(
+      comm->Allreduce(num_edges, katana::CommBackend::ReduceOp::kSum));
+  if (total_edges != prefix.num_edges()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "hosts loaded {} edges of a graph with {}", total_edges,
+        prefix.num_edges());
+  }
+
+  return PartitionedSlice(std::move(part));
+}
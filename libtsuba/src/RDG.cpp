@@ -5,8 +5,10 @@
 #include <fstream>
 #include <iterator>
 #include <memory>
+#include <optional>
 #include <regex>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -24,6 +26,7 @@
 
 #include "AddProperties.h"
 #include "GlobalState.h"
+#include "IOStats_internal.h"
 #include "RDGCore.h"
 #include "RDGHandleImpl.h"
 #include "katana/ArrowInterchange.h"
@@ -67,10 +70,28 @@ MasterPropName(unsigned i) {
   return std::string(kMasterNodesPropName) + "_" + std::to_string(i);
 }
 
-katana::Result<std::string>
+struct StoredArray {
+  std::string path;
+  std::string content_digest;
+};
+
+/// Store \p array as a file in \p dir, unless \p header already knows of a
+/// file there with the same name and contents, in which case that file is
+/// reused. The contents are digested on \p digest_threads threads.
+katana::Result<StoredArray>
 StoreArrowArrayAtName(
     const std::shared_ptr<arrow::ChunkedArray>& array, const katana::Uri& dir,
-    const std::string& name, tsuba::WriteGroup* desc) {
+    const std::string& name, tsuba::WriteGroup* desc,
+    tsuba::RDGPartHeader* header, unsigned digest_threads) {
+  std::string content_digest = katana::ContentDigest(array, digest_threads);
+  if (auto path = header->FindStoredContent(name, content_digest); path) {
+    KATANA_LOG_DEBUG("{} is unchanged, reusing {}", name, path.value());
+    return StoredArray{
+        .path = std::move(path.value()),
+        .content_digest = std::move(content_digest),
+    };
+  }
+
   auto writer_res = tsuba::ParquetWriter::Make(array, name);
   if (!writer_res) {
     return writer_res.error().WithContext("making property writer");
@@ -81,26 +102,30 @@ StoreArrowArrayAtName(
   if (!res) {
     return res.error().WithContext("writing property writer");
   }
-  return new_path.BaseName();
+  return StoredArray{
+      .path = new_path.BaseName(),
+      .content_digest = std::move(content_digest),
+  };
 }
 
 katana::Result<void>
 WriteProperties(
     const arrow::Table& props, std::vector<tsuba::PropStorageInfo*> prop_info,
-    const katana::Uri& dir, tsuba::WriteGroup* desc) {
+    const katana::Uri& dir, tsuba::WriteGroup* desc,
+    tsuba::RDGPartHeader* header, unsigned digest_threads) {
   const auto& schema = props.schema();
 
-  std::vector<std::string> next_paths;
   for (size_t i = 0, n = prop_info.size(); i < n; ++i) {
     if (!prop_info[i]->IsDirty()) {
       continue;
     }
     std::string name = prop_info[i]->name().empty() ? schema->field(i)->name()
                                                     : prop_info[i]->name();
-    std::string path =
-        KATANA_CHECKED(StoreArrowArrayAtName(props.column(i), dir, name, desc));
+    StoredArray stored = KATANA_CHECKED(StoreArrowArrayAtName(
+        props.column(i), dir, name, desc, header, digest_threads));
 
-    prop_info[i]->WasWritten(path);
+    prop_info[i]->WasWritten(stored.path, std::move(stored.content_digest));
+    header->NoteStoredContent(*prop_info[i]);
   }
   TSUBA_PTP(tsuba::internal::FaultSensitivity::Normal);
 
@@ -206,6 +231,19 @@ tsuba::RDGFile::~RDGFile() {
 katana::Result<std::vector<tsuba::PropStorageInfo>>
 tsuba::RDG::WritePartArrays(const katana::Uri& dir, tsuba::WriteGroup* desc) {
   std::vector<tsuba::PropStorageInfo> next_properties;
+  RDGPartHeader* header = &core_->part_header();
+  // Partition arrays rarely change between versions, so most are found in
+  // storage by content
+  auto store = [&](const std::shared_ptr<arrow::ChunkedArray>& array,
+                   const std::string& name) -> katana::Result<void> {
+    StoredArray stored = KATANA_CHECKED_CONTEXT(
+        StoreArrowArrayAtName(array, dir, name, desc, header, digest_threads_),
+        "storing {}", name);
+    next_properties.emplace_back(tsuba::PropStorageInfo(
+        name, std::move(stored.path), std::move(stored.content_digest)));
+    header->NoteStoredContent(next_properties.back());
+    return katana::ResultSuccess();
+  };
 
   KATANA_LOG_DEBUG(
       "WritePartArrays master sz: {} mirrors sz: {} h2owned sz : {} "
@@ -222,52 +260,29 @@ tsuba::RDG::WritePartArrays(const katana::Uri& dir, tsuba::WriteGroup* desc) {
       local_to_global_id_ == nullptr ? 0 : local_to_global_id_->length());
 
   for (size_t i = 0; i < mirror_nodes_.size(); ++i) {
-    std::string name = MirrorPropName(i);
-    std::string path = KATANA_CHECKED_CONTEXT(
-        StoreArrowArrayAtName(mirror_nodes_[i], dir, name, desc), "storing {}",
-        name);
-    next_properties.emplace_back(tsuba::PropStorageInfo(name, path));
+    KATANA_CHECKED(store(mirror_nodes_[i], MirrorPropName(i)));
   }
 
   for (size_t i = 0; i < master_nodes_.size(); ++i) {
-    std::string name = MasterPropName(i);
-    std::string path = KATANA_CHECKED_CONTEXT(
-        StoreArrowArrayAtName(master_nodes_[i], dir, name, desc), "storing {}",
-        name);
-    next_properties.emplace_back(tsuba::PropStorageInfo(name, path));
+    KATANA_CHECKED(store(master_nodes_[i], MasterPropName(i)));
   }
 
   if (host_to_owned_global_node_ids_ != nullptr) {
-    std::string name = kHostToOwnedGlobalNodeIDsPropName;
-    std::string path = KATANA_CHECKED_CONTEXT(
-        StoreArrowArrayAtName(host_to_owned_global_node_ids_, dir, name, desc),
-        "storing {}", name);
-    next_properties.emplace_back(tsuba::PropStorageInfo(name, path));
+    KATANA_CHECKED(store(
+        host_to_owned_global_node_ids_, kHostToOwnedGlobalNodeIDsPropName));
   }
 
   if (host_to_owned_global_edge_ids_ != nullptr) {
-    std::string name = kHostToOwnedGlobalEdgeIDsPropName;
-    std::string path = KATANA_CHECKED_CONTEXT(
-        StoreArrowArrayAtName(host_to_owned_global_edge_ids_, dir, name, desc),
-        "storing {}", name);
-    next_properties.emplace_back(tsuba::PropStorageInfo(name, path));
+    KATANA_CHECKED(store(
+        host_to_owned_global_edge_ids_, kHostToOwnedGlobalEdgeIDsPropName));
   }
 
   if (local_to_user_id_ != nullptr) {
-    std::string name = kLocalToUserIDPropName;
-    std::string path = KATANA_CHECKED_CONTEXT(
-        StoreArrowArrayAtName(local_to_user_id_, dir, name, desc), "storing {}",
-        name);
-    next_properties.emplace_back(tsuba::PropStorageInfo(name, path));
+    KATANA_CHECKED(store(local_to_user_id_, kLocalToUserIDPropName));
   }
 
   if (local_to_global_id_ != nullptr) {
-    std::string name = kLocalToGlobalIDPropName;
-    std::string path = KATANA_CHECKED_CONTEXT(
-        StoreArrowArrayAtName(
-            local_to_global_id_, dir, kLocalToGlobalIDPropName, desc),
-        "storing {}", name);
-    next_properties.emplace_back(tsuba::PropStorageInfo(name, path));
+    KATANA_CHECKED(store(local_to_global_id_, kLocalToGlobalIDPropName));
   }
 
   return next_properties;
@@ -292,6 +307,8 @@ tsuba::RDG::DoStoreTopology(
     write_group->StartStore(std::move(topology_ff));
     TSUBA_PTP(internal::FaultSensitivity::Normal);
     core_->part_header().set_topology_path(path_uri.BaseName());
+    // anything derived from the old topology is stale
+    core_->part_header().set_derived_topologies({});
   } else if (handle.impl_->rdg_manifest().dir() != rdg_dir_) {
     KATANA_LOG_DEBUG("persisting topology in new location");
     // we don't have an update, but we are persisting in a new location
@@ -314,6 +331,38 @@ tsuba::RDG::DoStoreTopology(
   return katana::ResultSuccess();
 }
 
+katana::Result<void>
+tsuba::RDG::DoStoreDerivedTopologies(
+    RDGHandle handle, std::vector<DerivedTopologyFrame> derived_topology_ffs,
+    std::unique_ptr<WriteGroup>& write_group) {
+  for (DerivedTopologyFrame& frame : derived_topology_ffs) {
+    katana::Uri path_uri = GetRDGDir(handle).RandFile("derived_topology");
+    frame.ff->Bind(path_uri.string());
+    TSUBA_PTP(internal::FaultSensitivity::Normal);
+    write_group->StartStore(std::move(frame.ff));
+    TSUBA_PTP(internal::FaultSensitivity::Normal);
+    frame.info.path = path_uri.BaseName();
+    core_->part_header().UpsertDerivedTopology(std::move(frame.info));
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+tsuba::RDG::DoStorePropertyIndexes(
+    RDGHandle handle, std::vector<PropertyIndexFrame> property_index_ffs,
+    std::unique_ptr<WriteGroup>& write_group) {
+  for (PropertyIndexFrame& frame : property_index_ffs) {
+    katana::Uri path_uri = GetRDGDir(handle).RandFile("property_index");
+    frame.ff->Bind(path_uri.string());
+    TSUBA_PTP(internal::FaultSensitivity::Normal);
+    write_group->StartStore(std::move(frame.ff));
+    TSUBA_PTP(internal::FaultSensitivity::Normal);
+    frame.info.path = path_uri.BaseName();
+    core_->part_header().UpsertPropertyIndex(std::move(frame.info));
+  }
+  return katana::ResultSuccess();
+}
+
 //TODO : emcginnis combine the Edge and Node DoStoreNode/EntityTypeIDArray
 // into a single generalized function.
 katana::Result<void>
@@ -327,6 +376,15 @@ tsuba::RDG::DoStoreNodeEntityTypeIDArray(
         "no node_entity_type_id_array file frame update, but "
         "node_entity_type_id_array_file_storage is invalid");
   }
+  if (!node_entity_type_id_array_ff &&
+      core_->part_header().EntityTypeIDStorageSize() !=
+          sizeof(katana::EntityTypeID)) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "no node_entity_type_id_array file frame update, but the stored "
+        "array has {} byte type ids",
+        core_->part_header().EntityTypeIDStorageSize());
+  }
 
   if (node_entity_type_id_array_ff) {
     // we have an update, store the passed in memory state
@@ -337,6 +395,8 @@ tsuba::RDG::DoStoreNodeEntityTypeIDArray(
     TSUBA_PTP(internal::FaultSensitivity::Normal);
     core_->part_header().set_node_entity_type_id_array_path(
         path_uri.BaseName());
+    // derived topologies may be sorted by node type
+    core_->part_header().set_derived_topologies({});
   } else if (handle.impl_->rdg_manifest().dir() != rdg_dir_) {
     KATANA_LOG_DEBUG("persisting node_entity_type_id_array in new location");
     // we don't have an update, but we are persisting in a new location
@@ -375,6 +435,15 @@ tsuba::RDG::DoStoreEdgeEntityTypeIDArray(
         "no edge_entity_type_id_array file frame update, but "
         "edge_entity_type_id_array_file_storage is invalid");
   }
+  if (!edge_entity_type_id_array_ff &&
+      core_->part_header().EntityTypeIDStorageSize() !=
+          sizeof(katana::EntityTypeID)) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "no edge_entity_type_id_array file frame update, but the stored "
+        "array has {} byte type ids",
+        core_->part_header().EntityTypeIDStorageSize());
+  }
 
   if (edge_entity_type_id_array_ff) {
     // we have an update, store the passed in memory state
@@ -385,6 +454,8 @@ tsuba::RDG::DoStoreEdgeEntityTypeIDArray(
     TSUBA_PTP(internal::FaultSensitivity::Normal);
     core_->part_header().set_edge_entity_type_id_array_path(
         path_uri.BaseName());
+    // derived topologies may be sorted by edge type
+    core_->part_header().set_derived_topologies({});
   } else if (handle.impl_->rdg_manifest().dir() != rdg_dir_) {
     KATANA_LOG_DEBUG("persisting edge_entity_type_id_array in new location");
     // we don't have an update, but we are persisting in a new location
@@ -429,7 +500,8 @@ tsuba::RDG::DoStore(
   KATANA_CHECKED_CONTEXT(
       WriteProperties(
           *core_->node_properties(), node_props_to_store,
-          handle.impl_->rdg_manifest().dir(), write_group.get()),
+          handle.impl_->rdg_manifest().dir(), write_group.get(),
+          &core_->part_header(), digest_threads_),
       "writing node properties");
 
   std::vector<std::string> edge_prop_names;
@@ -443,7 +515,8 @@ tsuba::RDG::DoStore(
   KATANA_CHECKED_CONTEXT(
       WriteProperties(
           *core_->edge_properties(), edge_props_to_store,
-          handle.impl_->rdg_manifest().dir(), write_group.get()),
+          handle.impl_->rdg_manifest().dir(), write_group.get(),
+          &core_->part_header(), digest_threads_),
       "writing edge properties");
 
   core_->part_header().set_part_properties(KATANA_CHECKED_CONTEXT(
@@ -500,9 +573,9 @@ tsuba::RDG::DoMake(
             } else {
               prop_table = props;
             }
-            rdg->core_->set_node_properties(std::move(prop_table));
-            return katana::ResultSuccess();
-          }),
+            return rdg->core_->set_node_properties(std::move(prop_table));
+          },
+          prop_load_limiter_),
       "populating node properties");
 
   tsuba::PropertyCacheKey edge_key(tsuba::NodeEdge::kEdge);
@@ -523,9 +596,9 @@ tsuba::RDG::DoMake(
             } else {
               prop_table = props;
             }
-            rdg->core_->set_edge_properties(std::move(prop_table));
-            return katana::ResultSuccess();
-          }),
+            return rdg->core_->set_edge_properties(std::move(prop_table));
+          },
+          prop_load_limiter_),
       "populating edge properties");
 
   katana::Uri t_path = metadata_dir.Join(core_->part_header().topology_path());
@@ -565,7 +638,8 @@ tsuba::RDG::DoMake(
           metadata_dir, nullptr, nullptr, part_info, &grp,
           [rdg = this](const std::shared_ptr<arrow::Table>& props) {
             return rdg->AddPartitionMetadataArray(props);
-          }),
+          },
+          prop_load_limiter_),
       "populating partition metadata");
   KATANA_CHECKED(grp.Finish());
 
@@ -630,16 +704,47 @@ tsuba::RDG::Make(const RDGManifest& manifest, const RDGLoadOptions& opts) {
 
   RDG rdg(std::make_unique<RDGCore>(std::move(part_header_res.value())));
   rdg.prop_cache_ = opts.prop_cache;
+  rdg.prop_load_limiter_ = std::make_shared<PropertyLoadLimiter>(
+      opts.max_concurrent_property_loads, opts.parallel_property_decode);
+
+  // Older graphs store their entity types as properties, which Make needs
+  bool in_background = opts.load_properties_in_background &&
+                       rdg.IsEntityTypeIDsOutsideProperties();
+  rdg.load_properties_on_access_ =
+      opts.load_properties_on_access || in_background;
+
+  std::optional<std::vector<std::string>> node_props_to_load =
+      opts.node_properties;
+  std::optional<std::vector<std::string>> edge_props_to_load =
+      opts.edge_properties;
+  if (in_background) {
+    // Started after the topology is loaded
+    node_props_to_load = std::vector<std::string>{};
+    edge_props_to_load = std::vector<std::string>{};
+  } else if (opts.load_properties_on_access) {
+    node_props_to_load = node_props_to_load.value_or(
+        std::vector<std::string>{});
+    edge_props_to_load = edge_props_to_load.value_or(
+        std::vector<std::string>{});
+  }
 
   std::vector<PropStorageInfo*> node_props = KATANA_CHECKED(
-      rdg.core_->part_header().SelectNodeProperties(opts.node_properties));
+      rdg.core_->part_header().SelectNodeProperties(node_props_to_load));
 
   std::vector<PropStorageInfo*> edge_props = KATANA_CHECKED(
-      rdg.core_->part_header().SelectEdgeProperties(opts.edge_properties));
+      rdg.core_->part_header().SelectEdgeProperties(edge_props_to_load));
 
   KATANA_CHECKED(rdg.DoMake(node_props, edge_props, manifest.dir()));
 
+  if (in_background) {
+    KATANA_CHECKED(rdg.PrefetchNodeProperties(
+        opts.node_properties.value_or(rdg.ListNodeProperties())));
+    KATANA_CHECKED(rdg.PrefetchEdgeProperties(
+        opts.edge_properties.value_or(rdg.ListEdgeProperties())));
+  }
+
   rdg.set_partition_id(partition_id_to_load);
+  TraceIOStats();
 
   return RDG(std::move(rdg));
 }
@@ -649,6 +754,11 @@ tsuba::RDG::IsEntityTypeIDsOutsideProperties() const {
   return core_->part_header().IsEntityTypeIDsOutsideProperties();
 }
 
+size_t
+tsuba::RDG::EntityTypeIDStorageSize() const {
+  return core_->part_header().EntityTypeIDStorageSize();
+}
+
 katana::Result<void>
 tsuba::RDG::Validate() const {
   if (auto res = core_->part_header().Validate(); !res) {
@@ -679,7 +789,9 @@ tsuba::RDG::Store(
     std::unique_ptr<FileFrame> node_entity_type_id_array_ff,
     std::unique_ptr<FileFrame> edge_entity_type_id_array_ff,
     const katana::EntityTypeManager& node_entity_type_manager,
-    const katana::EntityTypeManager& edge_entity_type_manager) {
+    const katana::EntityTypeManager& edge_entity_type_manager,
+    std::vector<DerivedTopologyFrame> derived_topology_ffs,
+    std::vector<PropertyIndexFrame> property_index_ffs) {
   if (!handle.impl_->AllowsWrite()) {
     return KATANA_ERROR(
         ErrorCode::InvalidArgument, "handle does not allow write");
@@ -721,10 +833,19 @@ tsuba::RDG::Store(
     return res.error();
   }
 
+  // after the topology and entity types, which drop stale derived topologies
+  KATANA_CHECKED(
+      DoStoreDerivedTopologies(handle, std::move(derived_topology_ffs), desc));
+  KATANA_CHECKED(
+      DoStorePropertyIndexes(handle, std::move(property_index_ffs), desc));
+
   core_->part_header().StoreNodeEntityTypeManager(node_entity_type_manager);
   core_->part_header().StoreEdgeEntityTypeManager(edge_entity_type_manager);
 
-  return DoStore(handle, command_line, versioning_action, std::move(desc));
+  KATANA_CHECKED(
+      DoStore(handle, command_line, versioning_action, std::move(desc)));
+  TraceIOStats();
+  return katana::ResultSuccess();
 }
 
 katana::Result<void>
@@ -771,7 +892,8 @@ katana::Result<std::shared_ptr<arrow::Table>>
 UnloadProperty(
     const std::shared_ptr<arrow::Table>& props, int i,
     std::vector<tsuba::PropStorageInfo>* prop_info_list,
-    const katana::Uri& dir) {
+    const katana::Uri& dir, tsuba::RDGPartHeader* header,
+    unsigned digest_threads) {
   if (i < 0 || i > props->num_columns()) {
     return KATANA_ERROR(
         katana::ErrorCode::InvalidArgument, "property index out of bounds");
@@ -789,9 +911,10 @@ UnloadProperty(
   KATANA_LOG_ASSERT(!prop_info.IsAbsent());
 
   if (prop_info.IsDirty()) {
-    std::string path = KATANA_CHECKED(
-        StoreArrowArrayAtName(props->column(i), dir, name, nullptr));
-    prop_info.WasWritten(path);
+    StoredArray stored = KATANA_CHECKED(StoreArrowArrayAtName(
+        props->column(i), dir, name, nullptr, header, digest_threads));
+    prop_info.WasWritten(stored.path, std::move(stored.content_digest));
+    header->NoteStoredContent(prop_info);
   }
 
   prop_info.WasUnloaded();
@@ -799,12 +922,84 @@ UnloadProperty(
   return KATANA_CHECKED(props->RemoveColumn(i));
 }
 
+/// Remove and return the prefetch of the property name from prefetches if
+/// there is one and it is not stale
+std::optional<tsuba::PropertyPrefetch>
+TakePrefetch(
+    std::unordered_map<std::string, tsuba::PropertyPrefetch>* prefetches,
+    const tsuba::PropStorageInfo& prop_info) {
+  auto it = prefetches->find(prop_info.name());
+  if (it == prefetches->end()) {
+    return std::nullopt;
+  }
+  tsuba::PropertyPrefetch prefetch = std::move(it->second);
+  prefetches->erase(it);
+  if (prefetch.path != prop_info.path()) {
+    // The property was written since, so the column being read is out of
+    // date; destroying the future waits for the read to finish
+    return std::nullopt;
+  }
+  return prefetch;
+}
+
+katana::Result<void>
+PrefetchProperties(
+    const std::vector<std::string>& names,
+    const std::vector<tsuba::PropStorageInfo>& prop_info_list,
+    tsuba::PropertyCacheKey cache_key, tsuba::PropertyCache* cache,
+    const katana::Uri& dir,
+    const std::shared_ptr<tsuba::PropertyLoadLimiter>& limiter,
+    std::unordered_map<std::string, tsuba::PropertyPrefetch>* prefetches) {
+  for (const auto& name : names) {
+    auto psi_it = std::find_if(
+        prop_info_list.begin(), prop_info_list.end(),
+        [&](const tsuba::PropStorageInfo& psi) { return psi.name() == name; });
+    if (psi_it == prop_info_list.end() || !psi_it->IsAbsent()) {
+      continue;
+    }
+    if (auto it = prefetches->find(name); it != prefetches->end()) {
+      if (it->second.path == psi_it->path()) {
+        continue;
+      }
+      prefetches->erase(it);
+    }
+    if (cache != nullptr) {
+      cache_key.name = name;
+      if (cache->Get(cache_key)) {
+        // Loading it will be cheap anyway
+        continue;
+      }
+    }
+    prefetches->emplace(
+        name, tsuba::PropertyPrefetch{
+                  .path = psi_it->path(),
+                  .table = tsuba::LoadPropertiesAsync(
+                      name, dir.Join(psi_it->path()), limiter),
+              });
+  }
+  return katana::ResultSuccess();
+}
+
+/// Undo the state change of a property whose loaded column could not be kept
+void
+MarkUnloaded(
+    std::vector<tsuba::PropStorageInfo>* prop_info_list,
+    const std::string& name) {
+  for (auto& prop_info : *prop_info_list) {
+    if (prop_info.name() == name) {
+      prop_info.WasUnloaded();
+    }
+  }
+}
+
 katana::Result<std::shared_ptr<arrow::Table>>
 LoadProperty(
     const std::shared_ptr<arrow::Table>& props, const std::string name, int i,
     tsuba::PropertyCacheKey* cache_key, tsuba::PropertyCache* cache,
     std::vector<tsuba::PropStorageInfo>* prop_info_list,
-    const katana::Uri& dir) {
+    const katana::Uri& dir,
+    const std::shared_ptr<tsuba::PropertyLoadLimiter>& limiter,
+    std::unordered_map<std::string, tsuba::PropertyPrefetch>* prefetches) {
   if (i < 0 || i > props->num_columns()) {
     i = props->num_columns();
   }
@@ -828,18 +1023,37 @@ LoadProperty(
   }
 
   std::shared_ptr<arrow::Table> new_table;
-
-  KATANA_CHECKED(tsuba::AddProperties(
-      dir, cache_key, cache, {&prop_info}, nullptr,
+  auto add_fn =
       [&](const std::shared_ptr<arrow::Table>& col) -> katana::Result<void> {
-        if (props->num_columns() > 0) {
-          new_table = KATANA_CHECKED(
-              props->AddColumn(i, col->field(0), col->column(0)));
-        } else {
-          new_table = col;
-        }
-        return katana::ResultSuccess();
-      }));
+    if (props->num_columns() > 0) {
+      new_table =
+          KATANA_CHECKED(props->AddColumn(i, col->field(0), col->column(0)));
+    } else {
+      new_table = col;
+    }
+    return katana::ResultSuccess();
+  };
+
+  std::optional<tsuba::PropertyPrefetch> prefetch;
+  if (prefetches != nullptr) {
+    prefetch = TakePrefetch(prefetches, prop_info);
+  }
+  if (prefetch) {
+    std::shared_ptr<arrow::Table> col = KATANA_CHECKED_CONTEXT(
+        prefetch->table.get(), "prefetching {}", std::quoted(name));
+    KATANA_CHECKED(add_fn(col));
+    prop_info.WasLoaded(col->field(0)->type());
+    if (cache != nullptr) {
+      // The prefetch was only started because the cache missed
+      tsuba::RecordPropertyCacheLookup(false);
+      tsuba::PropertyCacheKey key = *cache_key;
+      key.name = name;
+      tsuba::RecordPropertyCacheEvictions(cache->Insert(key, col));
+    }
+  } else {
+    KATANA_CHECKED(tsuba::AddProperties(
+        dir, cache_key, cache, {&prop_info}, nullptr, add_fn, limiter));
+  }
 
   KATANA_LOG_ASSERT(prop_info.IsClean());
 
@@ -852,18 +1066,16 @@ katana::Result<void>
 tsuba::RDG::UnloadNodeProperty(int i) {
   std::shared_ptr<arrow::Table> new_props = KATANA_CHECKED(UnloadProperty(
       node_properties(), i, &core_->part_header().node_prop_info_list(),
-      rdg_dir()));
-  core_->set_node_properties(std::move(new_props));
-  return katana::ResultSuccess();
+      rdg_dir(), &core_->part_header(), digest_threads_));
+  return core_->set_node_properties(std::move(new_props));
 }
 
 katana::Result<void>
 tsuba::RDG::UnloadEdgeProperty(int i) {
   std::shared_ptr<arrow::Table> new_props = KATANA_CHECKED(UnloadProperty(
       edge_properties(), i, &core_->part_header().edge_prop_info_list(),
-      rdg_dir()));
-  core_->set_edge_properties(std::move(new_props));
-  return katana::ResultSuccess();
+      rdg_dir(), &core_->part_header(), digest_threads_));
+  return core_->set_edge_properties(std::move(new_props));
 }
 
 katana::Result<void>
@@ -871,8 +1083,12 @@ tsuba::RDG::LoadNodeProperty(const std::string& name, int i) {
   tsuba::PropertyCacheKey node_key(tsuba::NodeEdge::kNode);
   std::shared_ptr<arrow::Table> new_props = KATANA_CHECKED(LoadProperty(
       node_properties(), name, i, &node_key, prop_cache_,
-      &core_->part_header().node_prop_info_list(), rdg_dir()));
-  core_->set_node_properties(std::move(new_props));
+      &core_->part_header().node_prop_info_list(), rdg_dir(),
+      prop_load_limiter_, prefetches_ ? &prefetches_->node : nullptr));
+  if (auto res = core_->set_node_properties(std::move(new_props)); !res) {
+    MarkUnloaded(&core_->part_header().node_prop_info_list(), name);
+    return res.error();
+  }
   return katana::ResultSuccess();
 }
 
@@ -881,11 +1097,37 @@ tsuba::RDG::LoadEdgeProperty(const std::string& name, int i) {
   tsuba::PropertyCacheKey edge_key(tsuba::NodeEdge::kEdge);
   std::shared_ptr<arrow::Table> new_props = KATANA_CHECKED(LoadProperty(
       edge_properties(), name, i, &edge_key, prop_cache_,
-      &core_->part_header().edge_prop_info_list(), rdg_dir()));
-  core_->set_edge_properties(std::move(new_props));
+      &core_->part_header().edge_prop_info_list(), rdg_dir(),
+      prop_load_limiter_, prefetches_ ? &prefetches_->edge : nullptr));
+  if (auto res = core_->set_edge_properties(std::move(new_props)); !res) {
+    MarkUnloaded(&core_->part_header().edge_prop_info_list(), name);
+    return res.error();
+  }
   return katana::ResultSuccess();
 }
 
+katana::Result<void>
+tsuba::RDG::PrefetchNodeProperties(const std::vector<std::string>& names) {
+  if (!prefetches_) {
+    prefetches_ = std::make_unique<PropertyPrefetches>();
+  }
+  return PrefetchProperties(
+      names, core_->part_header().node_prop_info_list(),
+      tsuba::PropertyCacheKey(tsuba::NodeEdge::kNode), prop_cache_, rdg_dir(),
+      prop_load_limiter_, &prefetches_->node);
+}
+
+katana::Result<void>
+tsuba::RDG::PrefetchEdgeProperties(const std::vector<std::string>& names) {
+  if (!prefetches_) {
+    prefetches_ = std::make_unique<PropertyPrefetches>();
+  }
+  return PrefetchProperties(
+      names, core_->part_header().edge_prop_info_list(),
+      tsuba::PropertyCacheKey(tsuba::NodeEdge::kEdge), prop_cache_, rdg_dir(),
+      prop_load_limiter_, &prefetches_->edge);
+}
+
 std::vector<std::string>
 tsuba::RDG::ListNodeProperties() const {
   std::vector<std::string> result;
@@ -904,6 +1146,26 @@ tsuba::RDG::ListEdgeProperties() const {
   return result;
 }
 
+std::string
+tsuba::RDG::NodePropertyContentDigest(const std::string& name) const {
+  for (const auto& prop : core_->part_header().node_prop_info_list()) {
+    if (prop.name() == name) {
+      return prop.content_digest();
+    }
+  }
+  return "";
+}
+
+std::string
+tsuba::RDG::EdgePropertyContentDigest(const std::string& name) const {
+  for (const auto& prop : core_->part_header().edge_prop_info_list()) {
+    if (prop.name() == name) {
+      return prop.content_digest();
+    }
+  }
+  return "";
+}
+
 const tsuba::PartitionMetadata&
 tsuba::RDG::part_metadata() const {
   return core_->part_header().metadata();
@@ -939,6 +1201,34 @@ tsuba::RDG::DropTopology() {
   return core_->UnbindTopologyFile();
 }
 
+const std::vector<tsuba::DerivedTopologyInfo>&
+tsuba::RDG::derived_topologies() const {
+  return core_->part_header().derived_topologies();
+}
+
+katana::Result<std::unique_ptr<tsuba::FileView>>
+tsuba::RDG::MapDerivedTopology(const DerivedTopologyInfo& info) const {
+  katana::Uri path = rdg_dir_.Join(info.path);
+  auto fv = std::make_unique<FileView>();
+  KATANA_CHECKED_CONTEXT(
+      fv->Bind(path.string(), true), "mapping derived topology {}", path);
+  return std::unique_ptr<FileView>(std::move(fv));
+}
+
+const std::vector<tsuba::PropertyIndexInfo>&
+tsuba::RDG::property_indexes() const {
+  return core_->part_header().property_indexes();
+}
+
+katana::Result<std::unique_ptr<tsuba::FileView>>
+tsuba::RDG::MapPropertyIndex(const PropertyIndexInfo& info) const {
+  katana::Uri path = rdg_dir_.Join(info.path);
+  auto fv = std::make_unique<FileView>();
+  KATANA_CHECKED_CONTEXT(
+      fv->Bind(path.string(), true), "mapping property index {}", path);
+  return std::unique_ptr<FileView>(std::move(fv));
+}
+
 std::shared_ptr<arrow::Schema>
 tsuba::RDG::full_node_schema() const {
   std::vector<std::shared_ptr<arrow::Field>> fields;
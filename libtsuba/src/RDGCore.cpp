@@ -1,12 +1,88 @@
 #include "RDGCore.h"
 
+#include <cstring>
+
+#include <arrow/util/bit_util.h>
+
 #include "RDGPartHeader.h"
+#include "katana/ArrowInterchange.h"
 #include "katana/Result.h"
 #include "tsuba/Errors.h"
 #include "tsuba/ParquetReader.h"
 
 namespace {
 
+/// Whether buffer may be written without the change being seen through any
+/// reference other than the one being checked
+bool
+IsExclusive(const std::shared_ptr<arrow::Buffer>& buffer) {
+  return !buffer || (buffer.use_count() == 1 && buffer->is_mutable() &&
+                     !buffer->parent());
+}
+
+/// Overwrite the values of column col of table with those of new_column,
+/// keeping the existing allocation, and return true; or return false and
+/// leave the column unchanged if that cannot be done.
+///
+/// This is only done for fixed-width types, when the types and lengths match,
+/// when new_column has no nulls and when every level of the existing column
+/// (chunked array, array, array data and buffers) is referenced only by table.
+/// A column that is shared, e.g., with a table in the PropertyCache or with a
+/// caller that kept the result of GetNodeProperty, is left alone and replaced
+/// by the caller instead, so other readers keep seeing the old values.
+bool
+TryOverwriteColumn(
+    const arrow::Table& table, int col,
+    const std::shared_ptr<arrow::ChunkedArray>& new_column) {
+  std::shared_ptr<arrow::ChunkedArray> column = table.column(col);
+  // One reference is held by the table and one by column
+  if (column.use_count() > 2 || column->num_chunks() != 1 ||
+      column->length() != new_column->length() ||
+      new_column->null_count() != 0 ||
+      !column->type()->Equals(new_column->type())) {
+    return false;
+  }
+
+  const auto* fixed_width =
+      dynamic_cast<const arrow::FixedWidthType*>(column->type().get());
+  if (fixed_width == nullptr || column->type()->id() == arrow::Type::BOOL ||
+      column->type()->id() == arrow::Type::DICTIONARY ||
+      fixed_width->bit_width() % 8 != 0) {
+    return false;
+  }
+
+  const std::shared_ptr<arrow::Array>& chunk = column->chunks()[0];
+  if (chunk.use_count() != 1 || chunk->data().use_count() != 1) {
+    return false;
+  }
+  arrow::ArrayData* data = chunk->data().get();
+  if (data->buffers.size() != 2 || !data->buffers[1] ||
+      !IsExclusive(data->buffers[0]) || !IsExclusive(data->buffers[1])) {
+    return false;
+  }
+
+  int64_t width = fixed_width->bit_width() / 8;
+  uint8_t* dst = data->buffers[1]->mutable_data() + data->offset * width;
+  for (const auto& new_chunk : new_column->chunks()) {
+    const arrow::ArrayData& new_data = *new_chunk->data();
+    int64_t num_bytes = new_data.length * width;
+    if (num_bytes == 0) {
+      continue;
+    }
+    std::memmove(
+        dst, new_data.buffers[1]->data() + new_data.offset * width, num_bytes);
+    dst += num_bytes;
+  }
+
+  if (chunk->null_count() != 0) {
+    arrow::BitUtil::SetBitsTo(
+        data->buffers[0]->mutable_data(), data->offset, data->length, true);
+  }
+  data->null_count = 0;
+
+  return true;
+}
+
 katana::Result<void>
 UpsertProperties(
     const std::shared_ptr<arrow::Table>& props,
@@ -27,6 +103,8 @@ UpsertProperties(
     return katana::ResultSuccess();
   }
 
+  // Checked before taking another reference below
+  bool table_exclusive = to_update->use_count() == 1;
   std::shared_ptr<arrow::Table> next = *to_update;
 
   if (next->num_columns() > 0 && next->num_rows() != props->num_rows()) {
@@ -35,6 +113,18 @@ UpsertProperties(
         next->num_rows(), props->num_rows());
   }
 
+  // Overwrite the columns that can be written in place before building the
+  // new table, which shares the other columns. A table held elsewhere is
+  // never written, even if its columns are not shared.
+  std::vector<bool> overwritten(props->num_columns(), false);
+  if (table_exclusive) {
+    for (int i = 0, n = props->num_columns(); i < n; i++) {
+      int col = next->schema()->GetFieldIndex(props->field(i)->name());
+      overwritten[i] =
+          col >= 0 && TryOverwriteColumn(*next, col, props->column(i));
+    }
+  }
+
   int last = next->num_columns();
 
   for (int i = 0, n = props->num_columns(); i < n; i++) {
@@ -60,9 +150,13 @@ UpsertProperties(
         next = KATANA_CHECKED_CONTEXT(
             next->AddColumn(last++, field, props->column(i)), "insert");
       }
-    } else {
+    } else if (!overwritten[i]) {
       next = KATANA_CHECKED_CONTEXT(
           next->SetColumn(current_col, field, props->column(i)), "update");
+    } else if (!next->field(current_col)->Equals(field)) {
+      next = KATANA_CHECKED_CONTEXT(
+          next->SetColumn(current_col, field, next->column(current_col)),
+          "update field");
     }
     prop_info_it->WasModified(field->type());
   }
@@ -117,26 +211,48 @@ namespace tsuba {
 
 katana::Result<void>
 RDGCore::AddNodeProperties(const std::shared_ptr<arrow::Table>& props) {
-  return AddProperties(
+  KATANA_CHECKED(ReservePropertyCharge(props));
+  auto res = AddProperties(
       props, &node_properties_, &part_header_.node_prop_info_list());
+  ResetPropertyCharge();
+  return res;
 }
 
 katana::Result<void>
 RDGCore::AddEdgeProperties(const std::shared_ptr<arrow::Table>& props) {
-  return AddProperties(
+  KATANA_CHECKED(ReservePropertyCharge(props));
+  auto res = AddProperties(
       props, &edge_properties_, &part_header_.edge_prop_info_list());
+  ResetPropertyCharge();
+  return res;
 }
 
 katana::Result<void>
 RDGCore::UpsertNodeProperties(const std::shared_ptr<arrow::Table>& props) {
-  return UpsertProperties(
+  KATANA_CHECKED(ReservePropertyCharge(props));
+  auto res = UpsertProperties(
       props, &node_properties_, &part_header_.node_prop_info_list());
+  ResetPropertyCharge();
+  KATANA_CHECKED(res);
+  // the stored indexes of these properties are out of date
+  for (const auto& field : props->fields()) {
+    part_header_.RemovePropertyIndexes(field->name(), false);
+  }
+  return katana::ResultSuccess();
 }
 
 katana::Result<void>
 RDGCore::UpsertEdgeProperties(const std::shared_ptr<arrow::Table>& props) {
-  return UpsertProperties(
+  KATANA_CHECKED(ReservePropertyCharge(props));
+  auto res = UpsertProperties(
       props, &edge_properties_, &part_header_.edge_prop_info_list());
+  ResetPropertyCharge();
+  KATANA_CHECKED(res);
+  // the stored indexes of these properties are out of date
+  for (const auto& field : props->fields()) {
+    part_header_.RemovePropertyIndexes(field->name(), true);
+  }
+  return katana::ResultSuccess();
 }
 
 katana::Result<void>
@@ -166,6 +282,39 @@ RDGCore::InitEmptyProperties() {
   edge_properties_ = arrow::Table::Make(arrow::schema({}), empty, 0);
 }
 
+katana::Result<void>
+RDGCore::set_node_properties(std::shared_ptr<arrow::Table>&& node_properties) {
+  KATANA_CHECKED(property_charge_.Resize(
+      katana::ApproxTableMemUse(node_properties) +
+      katana::ApproxTableMemUse(edge_properties_)));
+  node_properties_ = std::move(node_properties);
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+RDGCore::set_edge_properties(std::shared_ptr<arrow::Table>&& edge_properties) {
+  KATANA_CHECKED(property_charge_.Resize(
+      katana::ApproxTableMemUse(node_properties_) +
+      katana::ApproxTableMemUse(edge_properties)));
+  edge_properties_ = std::move(edge_properties);
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+RDGCore::ReservePropertyCharge(const std::shared_ptr<arrow::Table>& props) {
+  // An upper bound: upserted columns replace existing ones or are written in
+  // place
+  return property_charge_.Resize(
+      property_charge_.bytes() + katana::ApproxTableMemUse(props));
+}
+
+void
+RDGCore::ResetPropertyCharge() {
+  property_charge_.ForceResize(
+      katana::ApproxTableMemUse(node_properties_) +
+      katana::ApproxTableMemUse(edge_properties_));
+}
+
 bool
 RDGCore::Equals(const RDGCore& other) const {
   // Assumption: t_f_s and other.t_f_s are both fully loaded into memory
@@ -182,7 +331,9 @@ katana::Result<void>
 RDGCore::RemoveNodeProperty(int i) {
   auto field = node_properties_->field(i);
   node_properties_ = KATANA_CHECKED(node_properties_->RemoveColumn(i));
+  ResetPropertyCharge();
 
+  part_header_.RemovePropertyIndexes(field->name(), false);
   return part_header_.RemoveNodeProperty(field->name());
 }
 
@@ -190,7 +341,9 @@ katana::Result<void>
 RDGCore::RemoveEdgeProperty(int i) {
   auto field = edge_properties_->field(i);
   edge_properties_ = KATANA_CHECKED(edge_properties_->RemoveColumn(i));
+  ResetPropertyCharge();
 
+  part_header_.RemovePropertyIndexes(field->name(), true);
   return part_header_.RemoveEdgeProperty(field->name());
 }
 
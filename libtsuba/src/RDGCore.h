@@ -6,6 +6,7 @@
 #include <arrow/api.h>
 
 #include "RDGPartHeader.h"
+#include "katana/MemoryAccounting.h"
 #include "katana/config.h"
 #include "tsuba/FileView.h"
 
@@ -49,26 +50,28 @@ public:
   const std::shared_ptr<arrow::Table>& node_properties() const {
     return node_properties_;
   }
-  void set_node_properties(std::shared_ptr<arrow::Table>&& node_properties) {
-    node_properties_ = std::move(node_properties);
-  }
+  /// Fails, leaving the properties as they are, if the new table would go
+  /// over the memory budget
+  katana::Result<void> set_node_properties(
+      std::shared_ptr<arrow::Table>&& node_properties);
 
   const std::shared_ptr<arrow::Table>& edge_properties() const {
     return edge_properties_;
   }
-  void set_edge_properties(std::shared_ptr<arrow::Table>&& edge_properties) {
-    edge_properties_ = std::move(edge_properties);
-  }
+  katana::Result<void> set_edge_properties(
+      std::shared_ptr<arrow::Table>&& edge_properties);
 
   void drop_node_properties() {
     std::vector<std::shared_ptr<arrow::Array>> empty;
     node_properties_ = arrow::Table::Make(arrow::schema({}), empty, 0);
     part_header_.set_node_prop_info_list({});
+    ResetPropertyCharge();
   }
   void drop_edge_properties() {
     std::vector<std::shared_ptr<arrow::Array>> empty;
     edge_properties_ = arrow::Table::Make(arrow::schema({}), empty, 0);
     part_header_.set_edge_prop_info_list({});
+    ResetPropertyCharge();
   }
 
   const FileView& topology_file_storage() const {
@@ -111,6 +114,7 @@ public:
 
   katana::Result<void> RegisterTopologyFile(const std::string& new_top) {
     part_header_.set_topology_path(new_top);
+    part_header_.set_derived_topologies({});
     return topology_file_storage_.Unbind();
   }
 
@@ -133,6 +137,15 @@ public:
 private:
   void InitEmptyProperties();
 
+  /// Charge enough for \p props to be added to the properties, before
+  /// changing them, so that going over the memory budget leaves them as they
+  /// are
+  katana::Result<void> ReservePropertyCharge(
+      const std::shared_ptr<arrow::Table>& props);
+
+  /// Charge what the properties use now
+  void ResetPropertyCharge();
+
   //
   // Data
   //
@@ -140,6 +153,8 @@ private:
   std::shared_ptr<arrow::Table> node_properties_;
   std::shared_ptr<arrow::Table> edge_properties_;
 
+  katana::MemoryCharge property_charge_{katana::MemoryCategory::kProperties};
+
   FileView topology_file_storage_;
 
   FileView node_entity_type_id_array_file_storage_;
@@ -0,0 +1,158 @@
+#include "tsuba/RDGEdgeStream.h"
+
+#include "RDGHandleImpl.h"
+#include "RDGManifest.h"
+#include "RDGPartHeader.h"
+#include "katana/Result.h"
+#include "tsuba/Errors.h"
+#include "tsuba/file.h"
+
+katana::Result<std::unique_ptr<tsuba::RDGEdgeStream>>
+tsuba::RDGEdgeStream::Make(RDGHandle handle, const Options& opts) {
+  const RDGManifest& manifest = handle.impl_->rdg_manifest();
+  if (manifest.num_hosts() != 1) {
+    return KATANA_ERROR(
+        ErrorCode::NotImplemented, "cannot stream a partitioned graph");
+  }
+  auto part_header =
+      KATANA_CHECKED(RDGPartHeader::Make(manifest.PartitionFileName(0)));
+  if (part_header.topology_path().empty()) {
+    return KATANA_ERROR(ErrorCode::InvalidArgument, "graph has no topology");
+  }
+  return Make(
+      manifest.dir().Join(part_header.topology_path()).string(), opts);
+}
+
+katana::Result<std::unique_ptr<tsuba::RDGEdgeStream>>
+tsuba::RDGEdgeStream::Make(
+    const std::string& topology_uri, const Options& opts) {
+  if (opts.block_bytes == 0 || opts.max_resident_blocks == 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "blocks and resident blocks must be positive");
+  }
+  CSRTopologyHeader header;
+  KATANA_CHECKED_CONTEXT(
+      FileGet(topology_uri, &header), "reading header of {}", topology_uri);
+  if (header.version != kCSRTopologyVersion &&
+      header.version != kCSRTopology64Version &&
+      header.version != kDerivedCSRTopologyVersion) {
+    return KATANA_ERROR(
+        ErrorCode::NotImplemented,
+        "cannot stream topology {} of version {}", topology_uri,
+        header.version);
+  }
+
+  FileView prefix;
+  KATANA_CHECKED_CONTEXT(
+      prefix.Bind(
+          topology_uri, sizeof(header) + header.num_nodes * sizeof(uint64_t),
+          true),
+      "reading out indexes of {}", topology_uri);
+  return std::unique_ptr<RDGEdgeStream>(
+      new RDGEdgeStream(topology_uri, opts, header, std::move(prefix)));
+}
+
+tsuba::RDGEdgeStream::RDGEdgeStream(
+    std::string topology_uri, const Options& opts, CSRTopologyHeader header,
+    FileView&& prefix)
+    : topology_uri_(std::move(topology_uri)),
+      opts_(opts),
+      header_(header),
+      prefix_(std::move(prefix)),
+      out_indexes_(prefix_.ptr<CSRTopologyPrefix>()->out_indexes),
+      dests_offset_(sizeof(header) + header.num_nodes * sizeof(uint64_t)),
+      dest_size_(
+          header.version == kCSRTopology64Version ? sizeof(uint64_t)
+                                                  : sizeof(uint32_t)),
+      slots_(opts.max_resident_blocks) {
+  edges_per_block_ = std::max<uint64_t>(1, opts_.block_bytes / dest_size_);
+  num_blocks_ = (header_.num_edges + edges_per_block_ - 1) / edges_per_block_;
+  block_.out_indexes_ = out_indexes_;
+  block_.dests_offset_ = dests_offset_;
+  block_.dest_size_ = dest_size_;
+}
+
+std::pair<uint64_t, uint64_t>
+tsuba::RDGEdgeStream::BlockEdges(uint64_t block) const {
+  uint64_t begin = block * edges_per_block_;
+  return {begin, std::min(begin + edges_per_block_, header_.num_edges)};
+}
+
+std::pair<uint64_t, uint64_t>
+tsuba::RDGEdgeStream::BlockBytes(uint64_t block) const {
+  auto [begin, end] = BlockEdges(block);
+  return {dests_offset_ + begin * dest_size_, dests_offset_ + end * dest_size_};
+}
+
+katana::Result<void>
+tsuba::RDGEdgeStream::Release(Slot* slot) {
+  slot->block = kNoBlock;
+  return slot->view.Unbind();
+}
+
+katana::Result<void>
+tsuba::RDGEdgeStream::Prefetch() {
+  for (Slot& slot : slots_) {
+    if (next_prefetch_ >= num_blocks_) {
+      break;
+    }
+    if (slot.block != kNoBlock) {
+      continue;
+    }
+    auto [begin, end] = BlockBytes(next_prefetch_);
+    KATANA_CHECKED_CONTEXT(
+        slot.view.Bind(topology_uri_, begin, end, false),
+        "prefetching block {} of {}", next_prefetch_, topology_uri_);
+    slot.block = next_prefetch_++;
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+tsuba::RDGEdgeStream::Rewind() {
+  for (Slot& slot : slots_) {
+    KATANA_CHECKED(Release(&slot));
+  }
+  current_ = nullptr;
+  next_block_ = 0;
+  next_prefetch_ = 0;
+  return Prefetch();
+}
+
+katana::Result<const tsuba::RDGEdgeStream::Block*>
+tsuba::RDGEdgeStream::Next() {
+  if (current_ != nullptr) {
+    KATANA_CHECKED(Release(current_));
+    current_ = nullptr;
+  }
+  if (next_block_ >= num_blocks_) {
+    return static_cast<const Block*>(nullptr);
+  }
+  // Refill the slot just released before waiting for the next block
+  KATANA_CHECKED(Prefetch());
+
+  auto it = std::find_if(slots_.begin(), slots_.end(), [&](const Slot& slot) {
+    return slot.block == next_block_;
+  });
+  KATANA_LOG_ASSERT(it != slots_.end());
+  auto [begin, end] = BlockBytes(next_block_);
+  KATANA_CHECKED_CONTEXT(
+      it->view.Wait(begin, end), "reading block {} of {}", next_block_,
+      topology_uri_);
+  current_ = &*it;
+
+  auto [edge_begin, edge_end] = BlockEdges(next_block_);
+  const uint64_t* nodes_end = out_indexes_ + header_.num_nodes;
+  block_.view_ = &current_->view;
+  block_.edge_begin_ = edge_begin;
+  block_.edge_end_ = edge_end;
+  // The first node whose edges end after edge_begin, through the node of
+  // the last edge
+  block_.first_node_ =
+      std::upper_bound(out_indexes_, nodes_end, edge_begin) - out_indexes_;
+  block_.end_node_ =
+      std::lower_bound(out_indexes_, nodes_end, edge_end) - out_indexes_ + 1;
+  ++next_block_;
+  return &block_;
+}
@@ -4,6 +4,7 @@
 
 #include "Constants.h"
 #include "GlobalState.h"
+#include "MetadataCache.h"
 #include "RDGHandleImpl.h"
 #include "RDGPartHeader.h"
 #include "katana/JSON.h"
@@ -84,7 +85,7 @@ RDGManifest::MakeFromStorage(const katana::Uri& uri) {
 Result<RDGManifest>
 RDGManifest::Make(
     const katana::Uri& uri, const std::string& view_type, uint64_t version) {
-  return MakeFromStorage(FileName(uri, view_type, version));
+  return Make(FileName(uri, view_type, version));
 }
 
 Result<RDGManifest>
@@ -94,8 +95,8 @@ RDGManifest::Make(RDGHandle handle) {
 
 Result<RDGManifest>
 RDGManifest::Make(const katana::Uri& uri) {
-  auto rdg_manifest = MakeFromStorage(uri);
-  return rdg_manifest;
+  return MetadataCache::Get().GetManifest(
+      uri, [&uri]() { return MakeFromStorage(uri); });
 }
 
 std::string
@@ -214,6 +215,7 @@ Result<std::set<std::string>>
 RDGManifest::FileNames() {
   std::set<std::string> fnames{};
   fnames.emplace(FileName().BaseName());
+  MetadataCache::Get().PrefetchPartHeaders(*this);
   for (auto i = 0U; i < num_hosts(); ++i) {
     // All other file names are directory-local, so we pass an empty
     // directory instead of handle.impl_->rdg_manifest.path for the partition files
@@ -2,7 +2,9 @@
 
 #include "Constants.h"
 #include "GlobalState.h"
+#include "MetadataCache.h"
 #include "RDGHandleImpl.h"
+#include "katana/ArrowInterchange.h"
 #include "katana/Logging.h"
 #include "katana/Result.h"
 #include "tsuba/Errors.h"
@@ -14,6 +16,10 @@ using json = nlohmann::json;
 namespace {
 
 const char* kTopologyPathKey = "kg.v1.topology.path";
+// Optional list of topologies derived from the one at kTopologyPathKey
+const char* kDerivedTopologiesKey = "kg.v1.derived_topologies";
+// Optional list of indexes over node and edge properties
+const char* kPropertyIndexesKey = "kg.v1.property_indexes";
 const char* kNodePropertyKey = "kg.v1.node_property";
 const char* kEdgePropertyKey = "kg.v1.edge_property";
 const char* kPartPropertyFilesKey = "kg.v1.part_property_files";
@@ -97,11 +103,8 @@ RDGPartHeader::MakeJson(const katana::Uri& partition_path) {
 
 katana::Result<RDGPartHeader>
 RDGPartHeader::Make(const katana::Uri& partition_path) {
-  katana::Result<RDGPartHeader> res = MakeJson(partition_path);
-  if (!res) {
-    return res.error();
-  }
-  return res;
+  return MetadataCache::Get().GetPartHeader(
+      partition_path, [&partition_path]() { return MakeJson(partition_path); });
 }
 
 katana::Result<void>
@@ -162,6 +165,13 @@ RDGPartHeader::IsEntityTypeIDsOutsideProperties() const {
   return (storage_format_version_ >= kPartitionStorageFormatVersion2);
 }
 
+size_t
+RDGPartHeader::EntityTypeIDStorageSize() const {
+  return storage_format_version_ >= kPartitionStorageFormatVersion3
+             ? sizeof(katana::EntityTypeID)
+             : sizeof(uint8_t);
+}
+
 katana::Result<void>
 RDGPartHeader::ValidateEntityTypeIDStructures() const {
   if (node_entity_type_id_array_path_.empty()) {
@@ -254,8 +264,23 @@ RDGPartHeader::ChangeStorageLocation(
     }
   }
 
+  // only the copied files exist in the new location
+  stored_content_.clear();
+  for (const auto* list :
+       {&node_prop_info_list_, &edge_prop_info_list_, &part_prop_info_list_}) {
+    for (const PropStorageInfo& prop : *list) {
+      if (prop.IsAbsent()) {
+        NoteStoredContent(prop);
+      }
+    }
+  }
+
   // clear out specific file paths so that we know to store them later
   topology_path_ = "";
+  // derived topologies are only a cache, they are rebuilt rather than copied
+  derived_topologies_.clear();
+  // and so are property indexes
+  property_indexes_.clear();
   node_entity_type_id_array_path_ = "";
   edge_entity_type_id_array_path_ = "";
 
@@ -289,6 +314,12 @@ tsuba::to_json(json& j, const tsuba::RDGPartHeader& header) {
       {kNodeEntityTypeIDNameKey, header.node_entity_type_id_name_},
       {kEdgeEntityTypeIDNameKey, header.edge_entity_type_id_name_},
   };
+  if (!header.derived_topologies_.empty()) {
+    j[kDerivedTopologiesKey] = header.derived_topologies_;
+  }
+  if (!header.property_indexes_.empty()) {
+    j[kPropertyIndexesKey] = header.property_indexes_;
+  }
 }
 
 void
@@ -319,6 +350,21 @@ tsuba::from_json(const json& j, tsuba::RDGPartHeader& header) {
     j.at(kNodeEntityTypeIDNameKey).get_to(header.node_entity_type_id_name_);
     j.at(kEdgeEntityTypeIDNameKey).get_to(header.edge_entity_type_id_name_);
   }
+
+  if (auto it = j.find(kDerivedTopologiesKey); it != j.end()) {
+    it->get_to(header.derived_topologies_);
+  }
+  if (auto it = j.find(kPropertyIndexesKey); it != j.end()) {
+    it->get_to(header.property_indexes_);
+  }
+
+  for (const auto* list :
+       {&header.node_prop_info_list_, &header.edge_prop_info_list_,
+        &header.part_prop_info_list_}) {
+    for (const PropStorageInfo& prop : *list) {
+      header.NoteStoredContent(prop);
+    }
+  }
 }
 
 void
@@ -369,10 +415,63 @@ void
 tsuba::from_json(const nlohmann::json& j, tsuba::PropStorageInfo& propmd) {
   j.at(0).get_to(propmd.name_);
   j.at(1).get_to(propmd.path_);
+  // optional, older RDGs do not record digests
+  if (j.size() > 2) {
+    j.at(2).get_to(propmd.content_digest_);
+    // a digest made by another version of ContentDigest is not comparable
+    // with current ones, so the content is treated as unknown
+    if (!katana::IsCurrentContentDigest(propmd.content_digest_)) {
+      propmd.content_digest_.clear();
+    }
+  }
   propmd.state_ = PropStorageInfo::State::kAbsent;
 }
 
 void
 tsuba::to_json(json& j, const tsuba::PropStorageInfo& propmd) {
-  j = json{propmd.name(), propmd.path()};
+  if (propmd.content_digest().empty()) {
+    j = json{propmd.name(), propmd.path()};
+  } else {
+    j = json{propmd.name(), propmd.path(), propmd.content_digest()};
+  }
+}
+
+void
+tsuba::to_json(json& j, const tsuba::DerivedTopologyInfo& info) {
+  j = json{
+      {"path", info.path},
+      {"transpose_state", info.transpose_state},
+      {"edge_sort_state", info.edge_sort_state},
+      {"num_nodes", info.num_nodes},
+      {"num_edges", info.num_edges},
+  };
+}
+
+void
+tsuba::from_json(const json& j, tsuba::DerivedTopologyInfo& info) {
+  j.at("path").get_to(info.path);
+  j.at("transpose_state").get_to(info.transpose_state);
+  j.at("edge_sort_state").get_to(info.edge_sort_state);
+  j.at("num_nodes").get_to(info.num_nodes);
+  j.at("num_edges").get_to(info.num_edges);
+}
+
+void
+tsuba::to_json(json& j, const tsuba::PropertyIndexInfo& info) {
+  j = json{
+      {"path", info.path},
+      {"property_name", info.property_name},
+      {"is_edge_property", info.is_edge_property},
+      {"kind", info.kind},
+      {"num_entities", info.num_entities},
+  };
+}
+
+void
+tsuba::from_json(const json& j, tsuba::PropertyIndexInfo& info) {
+  j.at("path").get_to(info.path);
+  j.at("property_name").get_to(info.property_name);
+  j.at("is_edge_property").get_to(info.is_edge_property);
+  j.at("kind").get_to(info.kind);
+  j.at("num_entities").get_to(info.num_entities);
 }
@@ -1,8 +1,10 @@
 #ifndef KATANA_LIBTSUBA_RDGPARTHEADER_H_
 #define KATANA_LIBTSUBA_RDGPARTHEADER_H_
 
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <map>
 #include <optional>
 #include <regex>
 #include <string>
@@ -63,9 +65,11 @@ public:
         type_(std::move(type)),
         state_(State::kDirty) {}
 
-  PropStorageInfo(std::string name, std::string path)
+  PropStorageInfo(
+      std::string name, std::string path, std::string content_digest = "")
       : name_(std::move(name)),
         path_(std::move(path)),
+        content_digest_(std::move(content_digest)),
         state_(State::kAbsent) {}
 
   void WasLoaded(const std::shared_ptr<arrow::DataType>& type) {
@@ -76,13 +80,17 @@ public:
 
   void WasModified(const std::shared_ptr<arrow::DataType>& type) {
     path_.clear();
+    content_digest_.clear();
     state_ = State::kDirty;
     type_ = type;
   }
 
-  void WasWritten(std::string_view new_path) {
+  /// \param content_digest katana::ContentDigest of the data stored at
+  ///     new_path, if known
+  void WasWritten(std::string_view new_path, std::string content_digest = "") {
     KATANA_LOG_ASSERT(state_ == State::kDirty);
     path_ = new_path;
+    content_digest_ = std::move(content_digest);
     state_ = State::kClean;
   }
 
@@ -99,6 +107,7 @@ public:
 
   const std::string& name() const { return name_; }
   const std::string& path() const { return path_; }
+  const std::string& content_digest() const { return content_digest_; }
   const std::shared_ptr<arrow::DataType>& type() const { return type_; }
 
   // since we don't have type info in the header don't know the
@@ -119,6 +128,7 @@ public:
 private:
   std::string name_;
   std::string path_;
+  std::string content_digest_;
   std::shared_ptr<arrow::DataType> type_;
   State state_;
 };
@@ -146,6 +156,10 @@ public:
       const std::string& file);
 
   bool IsEntityTypeIDsOutsideProperties() const;
+
+  /// The size in bytes of each EntityTypeID in the stored node and edge type
+  /// ID arrays; arrays stored before storage format version 3 hold 8 bit IDs
+  size_t EntityTypeIDStorageSize() const;
   //
   // Property manipulation
   //
@@ -164,6 +178,30 @@ public:
     return SelectProperties(&part_prop_info_list_, std::nullopt);
   }
 
+  /// \returns the path, relative to the RDG directory, of a stored file that
+  ///     holds the property \p name with the given content digest (see
+  ///     katana::ContentDigest), so that an unchanged property can reuse it
+  ///     instead of being written again
+  std::optional<std::string> FindStoredContent(
+      const std::string& name, const std::string& content_digest) const {
+    if (content_digest.empty()) {
+      return std::nullopt;
+    }
+    auto it = stored_content_.find({name, content_digest});
+    if (it == stored_content_.end()) {
+      return std::nullopt;
+    }
+    return it->second;
+  }
+
+  /// Remember that \p prop is stored with its content digest
+  void NoteStoredContent(const PropStorageInfo& prop) {
+    if (prop.path().empty() || prop.content_digest().empty()) {
+      return;
+    }
+    stored_content_[{prop.name(), prop.content_digest()}] = prop.path();
+  }
+
   void UpsertNodePropStorageInfo(PropStorageInfo&& pmd) {
     auto pmd_it = std::find_if(
         node_prop_info_list_.begin(), node_prop_info_list_.end(),
@@ -235,6 +273,58 @@ public:
   const std::string& topology_path() const { return topology_path_; }
   void set_topology_path(std::string path) { topology_path_ = std::move(path); }
 
+  const std::vector<DerivedTopologyInfo>& derived_topologies() const {
+    return derived_topologies_;
+  }
+  void set_derived_topologies(std::vector<DerivedTopologyInfo>&& infos) {
+    derived_topologies_ = std::move(infos);
+  }
+  /// Add \p info, replacing any derived topology with the same states
+  void UpsertDerivedTopology(DerivedTopologyInfo&& info) {
+    auto it = std::find_if(
+        derived_topologies_.begin(), derived_topologies_.end(),
+        [&](const DerivedTopologyInfo& other) {
+          return other.transpose_state == info.transpose_state &&
+                 other.edge_sort_state == info.edge_sort_state;
+        });
+    if (it != derived_topologies_.end()) {
+      *it = std::move(info);
+    } else {
+      derived_topologies_.emplace_back(std::move(info));
+    }
+  }
+
+  const std::vector<PropertyIndexInfo>& property_indexes() const {
+    return property_indexes_;
+  }
+  /// Add \p info, replacing any index of the same kind over the same property
+  void UpsertPropertyIndex(PropertyIndexInfo&& info) {
+    auto it = std::find_if(
+        property_indexes_.begin(), property_indexes_.end(),
+        [&](const PropertyIndexInfo& other) {
+          return other.property_name == info.property_name &&
+                 other.is_edge_property == info.is_edge_property &&
+                 other.kind == info.kind;
+        });
+    if (it != property_indexes_.end()) {
+      *it = std::move(info);
+    } else {
+      property_indexes_.emplace_back(std::move(info));
+    }
+  }
+  /// Drop the indexes over a property whose values changed
+  void RemovePropertyIndexes(
+      const std::string& property_name, bool is_edge_property) {
+    property_indexes_.erase(
+        std::remove_if(
+            property_indexes_.begin(), property_indexes_.end(),
+            [&](const PropertyIndexInfo& info) {
+              return info.property_name == property_name &&
+                     info.is_edge_property == is_edge_property;
+            }),
+        property_indexes_.end());
+  }
+
   const std::string& node_entity_type_id_array_path() const {
     return node_entity_type_id_array_path_;
   }
@@ -318,20 +408,17 @@ public:
 
     size_t num_entity_types = manager_type_id_sets.size();
     for (size_t i = 0, ni = num_entity_types; i < ni; ++i) {
-      for (size_t j = 0, nj = num_entity_types; j < nj; ++j) {
-        if (manager_type_id_sets[i].test(j)) {
-          auto cur_id = katana::EntityTypeID(i);
-          if (id_dict.count(cur_id)) {
-            // if we have seen this EntityTypeID already, add to its set
-            id_dict.at(cur_id).emplace_back(katana::EntityTypeID(j));
-          } else {
-            // if we have not, create a set with the id
-            tsuba::StorageSetOfEntityTypeIDs new_set = {
-                katana::EntityTypeID(j)};
-            id_dict.emplace(std::make_pair(cur_id, new_set));
-          }
+      auto cur_id = katana::EntityTypeID(i);
+      manager_type_id_sets[i].ForEach([&](katana::EntityTypeID j) {
+        if (id_dict.count(cur_id)) {
+          // if we have seen this EntityTypeID already, add to its set
+          id_dict.at(cur_id).emplace_back(j);
+        } else {
+          // if we have not, create a set with the id
+          tsuba::StorageSetOfEntityTypeIDs new_set = {j};
+          id_dict.emplace(std::make_pair(cur_id, new_set));
         }
-      }
+      });
     }
     // Convert EntityTypeID name map
     id_name = manager.GetEntityTypeIDToAtomicTypeNameMap();
@@ -502,6 +589,11 @@ private:
   std::vector<PropStorageInfo> node_prop_info_list_;
   std::vector<PropStorageInfo> edge_prop_info_list_;
 
+  /// (name, content digest) -> path of every property file known to be in
+  /// the RDG directory, including ones that have since been modified in
+  /// memory; older versions still refer to those
+  std::map<std::pair<std::string, std::string>, std::string> stored_content_;
+
   /// Metadata filled in by CuSP, or from storage (meta partition file)
   PartitionMetadata metadata_;
 
@@ -513,11 +605,16 @@ private:
 
   static const uint32_t kPartitionStorageFormatVersion1 = 1;
   static const uint32_t kPartitionStorageFormatVersion2 = 2;
+  static const uint32_t kPartitionStorageFormatVersion3 = 3;
   /// current_storage_format_version_ to be bumped any time
   /// the on disk format of RDGPartHeader changes
-  uint32_t latest_storage_format_version_ = kPartitionStorageFormatVersion2;
+  uint32_t latest_storage_format_version_ = kPartitionStorageFormatVersion3;
 
   std::string topology_path_;
+  /// Topologies derived from the one at topology_path_
+  std::vector<DerivedTopologyInfo> derived_topologies_;
+  /// Indexes over the current values of node and edge properties
+  std::vector<PropertyIndexInfo> property_indexes_;
 
   std::string node_entity_type_id_array_path_;
   std::string edge_entity_type_id_array_path_;
@@ -547,6 +644,12 @@ void from_json(const nlohmann::json& j, PartitionMetadata& propmd);
 void to_json(
     nlohmann::json& j, const std::vector<tsuba::PropStorageInfo>& vec_pmd);
 
+void to_json(nlohmann::json& j, const DerivedTopologyInfo& info);
+void from_json(const nlohmann::json& j, DerivedTopologyInfo& info);
+
+void to_json(nlohmann::json& j, const PropertyIndexInfo& info);
+void from_json(const nlohmann::json& j, PropertyIndexInfo& info);
+
 }  // namespace tsuba
 
 #endif
@@ -13,6 +13,7 @@ tsuba::RDGSlice::DoMake(
     const std::optional<std::vector<std::string>>& edge_props,
     const katana::Uri& metadata_dir, const SliceArg& slice) {
   ReadGroup grp;
+  auto limiter = std::make_shared<PropertyLoadLimiter>(0, false);
   katana::Uri topology_path =
       metadata_dir.Join(core_->part_header().topology_path());
   KATANA_CHECKED_CONTEXT(
@@ -22,6 +23,7 @@ tsuba::RDGSlice::DoMake(
       "loading topology array");
 
   if (core_->part_header().IsEntityTypeIDsOutsideProperties()) {
+    const size_t id_size = core_->part_header().EntityTypeIDStorageSize();
     katana::Uri node_types_path = metadata_dir.Join(
         core_->part_header().node_entity_type_id_array_path());
     katana::Uri edge_types_path = metadata_dir.Join(
@@ -29,17 +31,14 @@ tsuba::RDGSlice::DoMake(
 
     KATANA_CHECKED_CONTEXT(
         core_->node_entity_type_id_array_file_storage().Bind(
-            node_types_path.string(),
-            slice.node_range.first * sizeof(katana::EntityTypeID),
-            slice.node_range.second * sizeof(katana::EntityTypeID), true),
+            node_types_path.string(), slice.node_range.first * id_size,
+            slice.node_range.second * id_size, true),
         "loading node type id array; begin: {}, end: {}",
-        slice.node_range.first * sizeof(katana::EntityTypeID),
-        slice.node_range.second * sizeof(katana::EntityTypeID));
+        slice.node_range.first * id_size, slice.node_range.second * id_size);
     KATANA_CHECKED_CONTEXT(
         core_->edge_entity_type_id_array_file_storage().Bind(
-            edge_types_path.string(),
-            slice.edge_range.first * sizeof(katana::EntityTypeID),
-            slice.edge_range.second * sizeof(katana::EntityTypeID), true),
+            edge_types_path.string(), slice.edge_range.first * id_size,
+            slice.edge_range.second * id_size, true),
         "loading edge type id array");
   }
   // all of the properties
@@ -61,9 +60,9 @@ tsuba::RDGSlice::DoMake(
         } else {
           prop_table = props;
         }
-        rdg->core_->set_node_properties(std::move(prop_table));
-        return katana::ResultSuccess();
-      }));
+        return rdg->core_->set_node_properties(std::move(prop_table));
+      },
+      limiter));
 
   // all of the properties
   std::vector<PropStorageInfo*> edge_properties =
@@ -84,9 +83,9 @@ tsuba::RDGSlice::DoMake(
         } else {
           prop_table = props;
         }
-        rdg->core_->set_edge_properties(std::move(prop_table));
-        return katana::ResultSuccess();
-      });
+        return rdg->core_->set_edge_properties(std::move(prop_table));
+      },
+      limiter);
   if (!edge_result) {
     return edge_result.error();
   }
@@ -145,6 +144,11 @@ tsuba::RDGSlice::edge_entity_type_id_array_file_storage() const {
   return core_->edge_entity_type_id_array_file_storage();
 }
 
+size_t
+tsuba::RDGSlice::EntityTypeIDStorageSize() const {
+  return core_->part_header().EntityTypeIDStorageSize();
+}
+
 katana::Result<katana::EntityTypeManager>
 tsuba::RDGSlice::node_entity_type_manager() const {
   return core_->part_header().GetNodeEntityTypeManager();
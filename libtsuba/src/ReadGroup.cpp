@@ -1,13 +1,19 @@
 #include "tsuba/ReadGroup.h"
 
+#include "IOStats_internal.h"
+
 void
 tsuba::ReadGroup::AddOp(
     std::future<katana::CopyableResult<void>> future, std::string file,
     const std::function<katana::CopyableResult<void>()>& on_complete) {
+  RecordGroupOps(false, 1);
   async_op_group_.AddOp(std::move(future), std::move(file), on_complete);
 }
 
 katana::Result<void>
 tsuba::ReadGroup::Finish() {
-  return async_op_group_.Finish();
+  uint64_t start = IONowNs();
+  auto res = async_op_group_.Finish();
+  RecordGroupWait(false, IONowNs() - start);
+  return res;
 }
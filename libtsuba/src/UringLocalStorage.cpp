@@ -0,0 +1,447 @@
+#include "UringLocalStorage.h"
+
+#include <fcntl.h>
+#include <liburing.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "katana/Env.h"
+#include "katana/Logging.h"
+#include "katana/Result.h"
+#include "tsuba/Errors.h"
+#include "tsuba/file.h"
+
+namespace {
+
+constexpr unsigned kRingEntries = 256;
+// Reads larger than this are split so that the device can work on pieces of
+// one large read in parallel
+constexpr uint64_t kMaxChunkSize = UINT64_C(16) << 20; /* 16M */
+// Submit without waiting for the completion thread once this many reads are
+// queued
+constexpr size_t kSubmitBatch = 32;
+// After a transient submission failure with nothing in flight, the
+// completion thread retries this often, and gives up on the queued reads
+// after this many failures in a row
+constexpr int kSubmitRetryMillis = 10;
+constexpr int kMaxSubmitFailures = 100;
+
+struct ReadRequest {
+  int fd{-1};
+  std::string path;
+  std::atomic<uint64_t> outstanding{0};
+  std::promise<katana::CopyableResult<void>> promise;
+  // The first error of any chunk; chunks fail on the completion thread or,
+  // if they cannot be submitted, on a submitting thread
+  std::mutex error_mutex;
+  std::optional<katana::CopyableErrorInfo> error;
+
+  ~ReadRequest() {
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+};
+
+struct ReadChunk {
+  std::shared_ptr<ReadRequest> request;
+  uint8_t* buf;
+  uint64_t offset;
+  uint64_t size;
+};
+
+/// Reset an eventfd so that poll waits for its next signal
+void
+DrainEventFd(int fd) {
+  uint64_t count;
+  while (read(fd, &count, sizeof(count)) < 0 && errno == EINTR) {
+  }
+}
+
+}  // namespace
+
+class tsuba::UringLocalStorage::Impl {
+public:
+  static katana::Result<std::unique_ptr<Impl>> Make() {
+    std::unique_ptr<Impl> impl(new Impl());
+    if (int ret = io_uring_queue_init(kRingEntries, &impl->ring_, 0); ret < 0) {
+      return KATANA_ERROR(
+          std::error_code(-ret, std::system_category()),
+          "initializing io_uring");
+    }
+    impl->ring_valid_ = true;
+    // The completion thread polls an eventfd signaled on every completion,
+    // rather than blocking in the ring, so that it can also be woken to
+    // retry submissions and to stop
+    impl->cq_event_fd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    impl->wake_fd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (impl->cq_event_fd_ < 0 || impl->wake_fd_ < 0) {
+      return KATANA_ERROR(katana::ResultErrno(), "creating eventfd");
+    }
+    if (int ret = io_uring_register_eventfd(&impl->ring_, impl->cq_event_fd_);
+        ret < 0) {
+      return KATANA_ERROR(
+          std::error_code(-ret, std::system_category()),
+          "registering io_uring eventfd");
+    }
+    impl->reaper_ = std::thread([impl = impl.get()]() { impl->ReapLoop(); });
+    return std::unique_ptr<Impl>(std::move(impl));
+  }
+
+  Impl(const Impl&) = delete;
+  Impl& operator=(const Impl&) = delete;
+
+  /// Waits for every read already queued to complete or fail, so that no
+  /// future is left without a value and no buffer is written afterwards
+  ~Impl() {
+    if (reaper_.joinable()) {
+      stopping_.store(true);
+      Wake();
+      reaper_.join();
+    }
+    if (ring_valid_) {
+      io_uring_queue_exit(&ring_);
+    }
+    for (int fd : {cq_event_fd_, wake_fd_}) {
+      if (fd >= 0) {
+        close(fd);
+      }
+    }
+  }
+
+  /// Whether submissions failed for good; reads then fail right away
+  bool broken() const { return broken_.load(); }
+
+  std::future<katana::CopyableResult<void>> Read(
+      const std::string& path, uint64_t start, uint64_t size, uint8_t* buf) {
+    auto request = std::make_shared<ReadRequest>();
+    request->path = path;
+    auto future = request->promise.get_future();
+
+    request->fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (request->fd < 0) {
+      request->promise.set_value(katana::CopyableErrorInfo{KATANA_ERROR(
+          ErrorCode::LocalStorageError, "opening file {}: {}", path,
+          katana::ResultErrno().message())});
+      return future;
+    }
+
+    struct stat s_buf;
+    if (fstat(request->fd, &s_buf) != 0) {
+      request->promise.set_value(katana::CopyableErrorInfo{KATANA_ERROR(
+          ErrorCode::LocalStorageError, "stat file {}: {}", path,
+          katana::ResultErrno().message())});
+      return future;
+    }
+
+    // Like LocalStorage::ReadFile, tolerate reads that extend less than a
+    // block past the end of the file
+    uint64_t file_size = static_cast<uint64_t>(s_buf.st_size);
+    uint64_t available = start < file_size ? file_size - start : 0;
+    if (size > available) {
+      if (size - available > kBlockSize) {
+        request->promise.set_value(katana::CopyableErrorInfo{KATANA_ERROR(
+            ErrorCode::LocalStorageError, "failed to read {} past end of file",
+            path)});
+        return future;
+      }
+      size = available;
+    }
+    if (size == 0) {
+      request->promise.set_value(katana::CopyableResultSuccess());
+      return future;
+    }
+
+    uint64_t num_chunks = (size + kMaxChunkSize - 1) / kMaxChunkSize;
+    request->outstanding = num_chunks;
+
+    std::lock_guard<std::mutex> lock(sq_mutex_);
+    for (uint64_t i = 0; i < num_chunks; ++i) {
+      uint64_t chunk_begin = i * kMaxChunkSize;
+      auto* chunk = new ReadChunk{
+          .request = request,
+          .buf = buf + chunk_begin,
+          .offset = start + chunk_begin,
+          .size = std::min(kMaxChunkSize, size - chunk_begin),
+      };
+      EnqueueLocked(chunk);
+    }
+    if (in_flight_.load() == 0 || unsubmitted_.size() >= kSubmitBatch) {
+      SubmitLocked();
+    }
+    return future;
+  }
+
+  /// Submit any queued reads
+  void Flush() {
+    std::lock_guard<std::mutex> lock(sq_mutex_);
+    SubmitLocked();
+  }
+
+private:
+  Impl() = default;
+
+  void Wake() {
+    uint64_t one = 1;
+    while (write(wake_fd_, &one, sizeof(one)) < 0 && errno == EINTR) {
+    }
+  }
+
+  /// A free submission queue entry, or null once submissions have failed
+  /// for good
+  io_uring_sqe* GetSQELocked() {
+    while (!broken_.load()) {
+      if (io_uring_sqe* sqe = io_uring_get_sqe(&ring_); sqe != nullptr) {
+        return sqe;
+      }
+      // Submission queue is full; make room
+      SubmitLocked();
+      if (!unsubmitted_.empty()) {
+        std::this_thread::yield();
+      }
+    }
+    return nullptr;
+  }
+
+  void EnqueueLocked(ReadChunk* chunk) {
+    io_uring_sqe* sqe = GetSQELocked();
+    if (sqe == nullptr) {
+      Fail(
+          chunk, KATANA_ERROR(
+                     ErrorCode::LocalStorageError,
+                     "reading {}: io_uring submission failed",
+                     chunk->request->path));
+      Finish(chunk);
+      return;
+    }
+    io_uring_prep_read(
+        sqe, chunk->request->fd, chunk->buf, chunk->size, chunk->offset);
+    io_uring_sqe_set_data(sqe, chunk);
+    unsubmitted_.emplace_back(chunk);
+  }
+
+  /// Submit the queued reads. After a transient failure with nothing in
+  /// flight, which would otherwise leave them queued with no completion to
+  /// trigger another attempt, the completion thread retries until
+  /// kMaxSubmitFailures; other failures, and that many transient ones in a
+  /// row, fail the queued reads.
+  void SubmitLocked() {
+    while (!unsubmitted_.empty()) {
+      int ret = io_uring_submit(&ring_);
+      if (ret > 0) {
+        submit_failures_ = 0;
+        in_flight_.fetch_add(ret);
+        unsubmitted_.erase(
+            unsubmitted_.begin(),
+            unsubmitted_.begin() +
+                std::min<size_t>(unsubmitted_.size(), ret));
+        continue;
+      }
+      // Nothing taken is as good as a transient failure
+      std::error_code ec(ret == 0 ? EAGAIN : -ret, std::system_category());
+      bool transient = ret == 0 || ret == -EAGAIN || ret == -EBUSY ||
+                       ret == -EINTR;
+      if (transient && ++submit_failures_ < kMaxSubmitFailures) {
+        KATANA_LOG_DEBUG("io_uring_submit: {}", ec.message());
+        if (in_flight_.load() == 0) {
+          Wake();
+        }
+        return;
+      }
+      KATANA_LOG_WARN(
+          "io_uring_submit: {}; failing {} queued reads", ec.message(),
+          unsubmitted_.size());
+      // The entries stay in the submission queue but are never submitted,
+      // so their chunks can be released
+      broken_.store(true);
+      for (ReadChunk* chunk : unsubmitted_) {
+        Fail(
+            chunk, KATANA_ERROR(
+                       ErrorCode::LocalStorageError, "reading {}: {}",
+                       chunk->request->path, ec.message()));
+        Finish(chunk);
+      }
+      unsubmitted_.clear();
+      return;
+    }
+  }
+
+  static void Fail(ReadChunk* chunk, katana::CopyableErrorInfo err) {
+    ReadRequest& request = *chunk->request;
+    std::lock_guard<std::mutex> lock(request.error_mutex);
+    if (!request.error) {
+      request.error = std::move(err);
+    }
+  }
+
+  /// Release a chunk that is done and set the value of its request if it
+  /// was the last chunk
+  static void Finish(ReadChunk* chunk) {
+    std::shared_ptr<ReadRequest> request = std::move(chunk->request);
+    delete chunk;
+    if (request->outstanding.fetch_sub(1) == 1) {
+      std::lock_guard<std::mutex> lock(request->error_mutex);
+      if (request->error) {
+        request->promise.set_value(request->error.value());
+      } else {
+        request->promise.set_value(katana::CopyableResultSuccess());
+      }
+    }
+  }
+
+  /// Handle the completion of one read; returns true if the chunk has to be
+  /// queued again
+  bool Complete(ReadChunk* chunk, int res) {
+    if (res == -EINTR || res == -EAGAIN) {
+      return true;
+    }
+    if (res < 0) {
+      Fail(
+          chunk, KATANA_ERROR(
+                     ErrorCode::LocalStorageError, "reading {}: {}",
+                     chunk->request->path,
+                     std::error_code(-res, std::system_category()).message()));
+    } else if (res == 0) {
+      Fail(
+          chunk, KATANA_ERROR(
+                     ErrorCode::LocalStorageError,
+                     "unexpected end of file reading {}",
+                     chunk->request->path));
+    } else if (static_cast<uint64_t>(res) < chunk->size) {
+      // Short read, continue where it left off
+      chunk->buf += res;
+      chunk->offset += res;
+      chunk->size -= res;
+      return true;
+    }
+    Finish(chunk);
+    return false;
+  }
+
+  void ReapLoop() {
+    std::vector<ReadChunk*> requeue;
+    int timeout_millis = -1;
+    while (true) {
+      pollfd fds[2] = {
+          {.fd = cq_event_fd_, .events = POLLIN, .revents = 0},
+          {.fd = wake_fd_, .events = POLLIN, .revents = 0},
+      };
+      if (poll(fds, 2, timeout_millis) < 0 && errno != EINTR) {
+        KATANA_LOG_FATAL("poll: {}", katana::ResultErrno().message());
+      }
+      DrainEventFd(cq_event_fd_);
+      DrainEventFd(wake_fd_);
+
+      // Drain everything that is ready before touching the submission side
+      uint64_t reaped = 0;
+      io_uring_cqe* cqe = nullptr;
+      while (io_uring_peek_cqe(&ring_, &cqe) == 0 && cqe != nullptr) {
+        auto* chunk = static_cast<ReadChunk*>(io_uring_cqe_get_data(cqe));
+        int res = cqe->res;
+        io_uring_cqe_seen(&ring_, cqe);
+        reaped++;
+        if (Complete(chunk, res)) {
+          requeue.emplace_back(chunk);
+        }
+      }
+      in_flight_.fetch_sub(reaped);
+
+      // Reads that arrived while others were in flight go out as one batch
+      std::lock_guard<std::mutex> lock(sq_mutex_);
+      for (ReadChunk* chunk : requeue) {
+        EnqueueLocked(chunk);
+      }
+      requeue.clear();
+      SubmitLocked();
+      if (stopping_.load() && unsubmitted_.empty() && in_flight_.load() == 0) {
+        return;
+      }
+      // Poll again soon if a submission has to be retried
+      timeout_millis = unsubmitted_.empty() ? -1 : kSubmitRetryMillis;
+    }
+  }
+
+  io_uring ring_{};
+  bool ring_valid_{false};
+  int cq_event_fd_{-1};
+  int wake_fd_{-1};
+  std::thread reaper_;
+  std::atomic<bool> stopping_{false};
+
+  // Protects the submission queue, unsubmitted_ and submit_failures_
+  std::mutex sq_mutex_;
+  /// Chunks whose entries are queued but not submitted, in queue order
+  std::vector<ReadChunk*> unsubmitted_;
+  int submit_failures_{0};
+  std::atomic<bool> broken_{false};
+  std::atomic<uint64_t> in_flight_{0};
+};
+
+tsuba::UringLocalStorage::UringLocalStorage() = default;
+
+tsuba::UringLocalStorage::~UringLocalStorage() = default;
+
+katana::Result<void>
+tsuba::UringLocalStorage::Init() {
+  KATANA_CHECKED(LocalStorage::Init());
+  if (katana::GetEnv("KATANA_DISABLE_IO_URING")) {
+    return katana::ResultSuccess();
+  }
+  auto impl_res = Impl::Make();
+  if (!impl_res) {
+    KATANA_LOG_DEBUG(
+        "io_uring unavailable, using synchronous reads: {}", impl_res.error());
+    return katana::ResultSuccess();
+  }
+  impl_ = std::move(impl_res.value());
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+tsuba::UringLocalStorage::Fini() {
+  impl_.reset();
+  return LocalStorage::Fini();
+}
+
+katana::Result<void>
+tsuba::UringLocalStorage::GetMultiSync(
+    const std::string& uri, uint64_t start, uint64_t size,
+    uint8_t* result_buf) {
+  if (!impl_) {
+    return LocalStorage::GetMultiSync(uri, start, size, result_buf);
+  }
+  return GetAsync(uri, start, size, result_buf).get();
+}
+
+std::future<katana::CopyableResult<void>>
+tsuba::UringLocalStorage::GetAsync(
+    const std::string& uri, uint64_t start, uint64_t size,
+    uint8_t* result_buf) {
+  if (!impl_ || impl_->broken()) {
+    return LocalStorage::GetAsync(uri, start, size, result_buf);
+  }
+  std::string path = uri;
+  CleanUri(&path);
+  auto future = impl_->Read(path, start, size, result_buf);
+  // Waiting on a read pushes out anything still queued behind it. Fini
+  // completes every read, so there is nothing to push once impl_ is gone.
+  return std::async(
+      std::launch::deferred,
+      [impl = std::weak_ptr<Impl>(impl_),
+       future = std::move(future)]() mutable -> katana::CopyableResult<void> {
+        if (auto locked = impl.lock()) {
+          locked->Flush();
+        }
+        return future.get();
+      });
+}
@@ -0,0 +1,51 @@
+#ifndef KATANA_LIBTSUBA_URINGLOCALSTORAGE_H_
+#define KATANA_LIBTSUBA_URINGLOCALSTORAGE_H_
+
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <string>
+
+#include "LocalStorage.h"
+#include "katana/Result.h"
+
+namespace tsuba {
+
+/// LocalStorage whose reads go through a Linux io_uring.
+///
+/// GetAsync queues reads on a submission ring that is shared by all callers.
+/// Reads queued while others are in flight are submitted together by the
+/// completion thread, so the many small reads issued by ReadGroup and
+/// FileView::Fill are amortized into a few io_uring_enter calls. Large reads
+/// are split into chunks that the device can service in parallel.
+///
+/// If the ring cannot be created (old kernel, seccomp, etc.) or
+/// KATANA_DISABLE_IO_URING is set, this behaves exactly like LocalStorage.
+/// A transient submission failure is retried by the completion thread; if
+/// submissions keep failing, the queued reads fail and later ones fall back
+/// to LocalStorage. Fini waits for every queued read to complete.
+class UringLocalStorage : public LocalStorage {
+public:
+  class Impl;
+
+  UringLocalStorage();
+  ~UringLocalStorage() override;
+
+  katana::Result<void> Init() override;
+  katana::Result<void> Fini() override;
+
+  katana::Result<void> GetMultiSync(
+      const std::string& uri, uint64_t start, uint64_t size,
+      uint8_t* result_buf) override;
+
+  std::future<katana::CopyableResult<void>> GetAsync(
+      const std::string& uri, uint64_t start, uint64_t size,
+      uint8_t* result_buf) override;
+
+private:
+  std::shared_ptr<Impl> impl_;
+};
+
+}  // namespace tsuba
+
+#endif
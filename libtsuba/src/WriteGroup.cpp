@@ -1,8 +1,14 @@
 #include "tsuba/WriteGroup.h"
 
+#include <algorithm>
+#include <thread>
+
 #include "GlobalState.h"
+#include "IOStats_internal.h"
+#include "katana/Logging.h"
 #include "katana/Random.h"
 #include "katana/Result.h"
+#include "tsuba/FaultTest.h"
 
 template <typename T>
 using Result = katana::Result<T>;
@@ -16,41 +22,88 @@ constexpr uint32_t kTagLen = 12;
 namespace tsuba {
 
 Result<std::unique_ptr<WriteGroup>>
-WriteGroup::Make() {
+WriteGroup::Make(
+    uint64_t max_outstanding_size, uint32_t max_concurrent_encodes) {
   // Don't use `OneHostOnly` because we can skip its broadcast
   std::string tag;
   if (Comm()->ID == 0) {
     tag = katana::RandomAlphanumericString(kTagLen);
   }
   tag = Comm()->Broadcast(0, tag, kTagLen);
-  return std::unique_ptr<WriteGroup>(new WriteGroup(tag));
+
+  if (max_outstanding_size == 0) {
+    max_outstanding_size = kMaxOutstandingSize;
+  }
+  if (max_concurrent_encodes == 0) {
+    max_concurrent_encodes = std::max(1U, std::thread::hardware_concurrency());
+  }
+  return std::unique_ptr<WriteGroup>(
+      new WriteGroup(tag, max_outstanding_size, max_concurrent_encodes));
 }
 
 Result<void>
 WriteGroup::Finish() {
-  return async_op_group_.Finish();
+  uint64_t start = IONowNs();
+  auto res = async_op_group_.Finish();
+  RecordGroupWait(true, IONowNs() - start);
+  return res;
+}
+
+uint64_t
+WriteGroup::ReserveOutstanding(uint64_t size) {
+  if (size > max_outstanding_size_) {
+    size = max_outstanding_size_;
+  }
+  if (size == 0) {
+    return 0;
+  }
+  std::unique_lock<std::mutex> lock(mutex_);
+  // A write larger than the limit is let through once nothing else is in
+  // flight
+  cv_.wait(lock, [&] {
+    return outstanding_size_ == 0 ||
+           outstanding_size_ + size <= max_outstanding_size_;
+  });
+  outstanding_size_ += size;
+  return size;
 }
 
 void
-WriteGroup::AddOp(
-    std::future<katana::CopyableResult<void>> future, std::string file,
-    uint64_t accounted_size) {
-  if (accounted_size > kMaxOutstandingSize) {
-    accounted_size = kMaxOutstandingSize;
+WriteGroup::ReleaseOutstanding(uint64_t size) {
+  if (size == 0) {
+    return;
   }
-  if (accounted_size > 0) {
-    while (outstanding_size_ + accounted_size > kMaxOutstandingSize) {
-      if (!async_op_group_.FinishOne()) {
-        KATANA_LOG_ERROR(
-            "outstanding_size should be zero if we couldn't drain");
-        break;
-      }
-    }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    KATANA_LOG_DEBUG_ASSERT(outstanding_size_ >= size);
+    outstanding_size_ -= size;
+  }
+  cv_.notify_all();
+}
+
+void
+WriteGroup::AcquireEncodeSlot() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  cv_.wait(lock, [&] { return active_encodes_ < max_concurrent_encodes_; });
+  active_encodes_++;
+}
+
+void
+WriteGroup::ReleaseEncodeSlot() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    active_encodes_--;
   }
+  cv_.notify_all();
+}
+
+void
+WriteGroup::AddOp(
+    std::future<katana::CopyableResult<void>> future, std::string file) {
+  RecordGroupOps(true, 1);
   async_op_group_.AddOp(
       std::move(future), std::move(file),
-      [wg = this, accounted_size]() -> katana::CopyableResult<void> {
-        wg->outstanding_size_ -= accounted_size;
+      []() -> katana::CopyableResult<void> {
         return katana::CopyableResultSuccess();
       });
 }
@@ -60,13 +113,51 @@ WriteGroup::AddOp(
 void
 WriteGroup::StartStore(std::shared_ptr<FileFrame> ff) {
   std::string file = ff->path();
-  uint64_t size = ff->map_size();
+  uint64_t accounted_size = ReserveOutstanding(ff->map_size());
 
   // wrap future to hold onto FileFrame, but free it as soon as possible
-  auto future = std::async(std::launch::async, [ff = std::move(ff)]() mutable {
-    return ff->PersistAsync().get();
-  });
-  AddOp(std::move(future), file, size);
+  auto future = std::async(
+      std::launch::async,
+      [wg = this, ff = std::move(ff), accounted_size]() mutable {
+        auto res = ff->PersistAsync().get();
+        ff.reset();
+        wg->ReleaseOutstanding(accounted_size);
+        return res;
+      });
+  AddOp(std::move(future), file);
+}
+
+void
+WriteGroup::StartEncodeAndStore(
+    std::string file,
+    std::function<katana::CopyableResult<std::shared_ptr<FileFrame>>()>
+        encode) {
+  AcquireEncodeSlot();
+
+  auto future = std::async(
+      std::launch::async,
+      [wg = this,
+       encode = std::move(encode)]() mutable -> katana::CopyableResult<void> {
+        auto ff_res = encode();
+        encode = nullptr;
+        if (!ff_res) {
+          wg->ReleaseEncodeSlot();
+          return ff_res.error();
+        }
+        std::shared_ptr<FileFrame> ff = std::move(ff_res.value());
+
+        // Hold the encode slot until there is room for the output so that
+        // encoding stalls instead of piling up frames in memory
+        uint64_t accounted_size = wg->ReserveOutstanding(ff->map_size());
+        wg->ReleaseEncodeSlot();
+
+        TSUBA_PTP(internal::FaultSensitivity::Normal);
+        auto res = ff->PersistAsync().get();
+        ff.reset();
+        wg->ReleaseOutstanding(accounted_size);
+        return res;
+      });
+  AddOp(std::move(future), std::move(file));
 }
 
 }  // namespace tsuba
@@ -15,41 +15,141 @@
 #include <unordered_map>
 
 #include "GlobalState.h"
+#include "IOStats_internal.h"
+#include "MetadataCache.h"
+#include "katana/EventRecorder.h"
 #include "katana/Logging.h"
 #include "katana/Platform.h"
 #include "katana/Result.h"
+#include "katana/URI.h"
 #include "tsuba/Errors.h"
 
+namespace {
+
+/// Count a request to \p fs in the IOStats once \p future is taken
+std::future<katana::CopyableResult<void>>
+Counted(
+    std::future<katana::CopyableResult<void>> future,
+    const tsuba::FileStorage* fs, bool write, uint64_t size) {
+  return std::async(
+      std::launch::deferred,
+      [future = std::move(future), scheme = std::string(fs->uri_scheme()),
+       write, size,
+       start = tsuba::IONowNs()]() mutable -> katana::CopyableResult<void> {
+        auto res = future.get();
+        tsuba::RecordStorageRequest(
+            scheme, write, res ? size : 0, tsuba::IONowNs() - start);
+        return res;
+      });
+}
+
+/// Counts each part put by a back-end's writer in the IOStats
+class CountedMultipartWriter : public tsuba::MultipartWriter {
+public:
+  CountedMultipartWriter(
+      std::unique_ptr<tsuba::MultipartWriter> writer,
+      const tsuba::FileStorage* fs)
+      : writer_(std::move(writer)), fs_(fs) {}
+
+  std::future<katana::CopyableResult<void>> PutPartAsync(
+      uint64_t offset, const uint8_t* data, uint64_t size) override {
+    katana::EventRecorder::Record(
+        katana::EventRecorder::kStorage, katana::EventRecorder::kInstant,
+        "FilePutPartAsync", size);
+    return Counted(writer_->PutPartAsync(offset, data, size), fs_, true, size);
+  }
+
+  katana::Result<void> Finish() override { return writer_->Finish(); }
+
+private:
+  std::unique_ptr<tsuba::MultipartWriter> writer_;
+  const tsuba::FileStorage* fs_;
+};
+
+}  // namespace
+
+katana::Result<std::unique_ptr<tsuba::MultipartWriter>>
+tsuba::FileStartMultipartWrite(const std::string& uri) {
+  MetadataCache::Get().Invalidate(uri);
+  FileStorage* fs = FS(uri);
+  auto writer = KATANA_CHECKED_CONTEXT(
+      fs->StartMultipartWrite(uri), "starting write of {}", uri);
+  return std::unique_ptr<MultipartWriter>(
+      std::make_unique<CountedMultipartWriter>(std::move(writer), fs));
+}
+
 katana::Result<void>
 tsuba::FileStore(const std::string& uri, const void* data, uint64_t size) {
-  return FS(uri)->PutMultiSync(uri, static_cast<const uint8_t*>(data), size);
+  katana::EventScope event(katana::EventRecorder::kStorage, "FileStore", size);
+  MetadataCache::Get().Invalidate(uri);
+  FileStorage* fs = FS(uri);
+  uint64_t start = IONowNs();
+  auto res = fs->PutMultiSync(uri, static_cast<const uint8_t*>(data), size);
+  RecordStorageRequest(
+      fs->uri_scheme(), true, res ? size : 0, IONowNs() - start);
+  return res;
 }
 
 std::future<katana::CopyableResult<void>>
 tsuba::FileStoreAsync(const std::string& uri, const void* data, uint64_t size) {
-  return FS(uri)->PutAsync(uri, static_cast<const uint8_t*>(data), size);
+  katana::EventRecorder::Record(
+      katana::EventRecorder::kStorage, katana::EventRecorder::kInstant,
+      "FileStoreAsync", size);
+  MetadataCache::Get().Invalidate(uri);
+  FileStorage* fs = FS(uri);
+  return Counted(
+      fs->PutAsync(uri, static_cast<const uint8_t*>(data), size), fs, true,
+      size);
 }
 
 katana::Result<void>
 tsuba::FileGet(
     const std::string& uri, void* result_buffer, uint64_t begin,
     uint64_t size) {
-  return FS(uri)->GetMultiSync(
+  katana::EventScope event(katana::EventRecorder::kStorage, "FileGet", size);
+  FileStorage* fs = FS(uri);
+  uint64_t start = IONowNs();
+  auto res = fs->GetMultiSync(
       uri, begin, size, static_cast<uint8_t*>(result_buffer));
+  RecordStorageRequest(
+      fs->uri_scheme(), false, res ? size : 0, IONowNs() - start);
+  return res;
 }
 
 std::future<katana::CopyableResult<void>>
 tsuba::FileGetAsync(
     const std::string& uri, void* result_buffer, uint64_t begin,
     uint64_t size) {
-  return FS(uri)->GetAsync(
-      uri, begin, size, static_cast<uint8_t*>(result_buffer));
+  katana::EventRecorder::Record(
+      katana::EventRecorder::kStorage, katana::EventRecorder::kInstant,
+      "FileGetAsync", size);
+  FileStorage* fs = FS(uri);
+  return Counted(
+      fs->GetAsync(uri, begin, size, static_cast<uint8_t*>(result_buffer)), fs,
+      false, size);
+}
+
+std::future<katana::CopyableResult<void>>
+tsuba::FileGetRangesAsync(
+    const std::string& uri, std::vector<FileRange> ranges,
+    const VectoredReadOptions& opts) {
+  uint64_t size = 0;
+  for (const FileRange& range : ranges) {
+    size += range.size;
+  }
+  katana::EventRecorder::Record(
+      katana::EventRecorder::kStorage, katana::EventRecorder::kInstant,
+      "FileGetRangesAsync", size);
+  FileStorage* fs = FS(uri);
+  return Counted(
+      fs->GetRangesAsync(uri, std::move(ranges), opts), fs, false, size);
 }
 
 katana::Result<void>
 tsuba::FileRemoteCopy(
     const std::string& source_uri, const std::string& dest_uri, uint64_t begin,
     uint64_t size) {
+  MetadataCache::Get().Invalidate(dest_uri);
   auto source_fs = FS(source_uri);
   auto dest_fs = FS(dest_uri);
 
@@ -77,5 +177,8 @@ katana::Result<void>
 tsuba::FileDelete(
     const std::string& directory,
     const std::unordered_set<std::string>& files) {
+  for (const std::string& file : files) {
+    MetadataCache::Get().Invalidate(katana::Uri::JoinPath(directory, file));
+  }
   return FS(directory)->Delete(directory, files);
 }
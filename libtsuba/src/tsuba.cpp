@@ -1,6 +1,13 @@
 #include "tsuba/tsuba.h"
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+
 #include "GlobalState.h"
+#include "MetadataCache.h"
 #include "RDGHandleImpl.h"
 #include "RDGPartHeader.h"
 #include "katana/CommBackend.h"
@@ -54,6 +61,16 @@ FindLatestManifestFile(const katana::Uri& name) {
   return name.Join(found_manifest);
 }
 
+/// A single host reads every partition of a partitioned RDG, so read all of
+/// their headers at once rather than one per load
+void
+MaybePrefetchPartHeaders(const tsuba::RDGManifest& manifest) {
+  if (manifest.num_hosts() > 1 && tsuba::Comm()->Num == 1 &&
+      tsuba::GetMetadataCacheOptions().prefetch_part_headers) {
+    tsuba::MetadataCache::Get().PrefetchPartHeaders(manifest);
+  }
+}
+
 }  // namespace
 
 katana::Result<tsuba::RDGHandle>
@@ -74,6 +91,7 @@ tsuba::Open(const std::string& rdg_name, uint32_t flags) {
     if (!manifest_res) {
       return manifest_res.error();
     }
+    MaybePrefetchPartHeaders(manifest_res.value());
 
     return RDGHandle{
         .impl_ = new RDGHandleImpl(flags, std::move(manifest_res.value()))};
@@ -90,6 +108,7 @@ tsuba::Open(const std::string& rdg_name, uint32_t flags) {
   if (!manifest_res) {
     return manifest_res.error();
   }
+  MaybePrefetchPartHeaders(manifest_res.value());
 
   return RDGHandle{
       .impl_ = new RDGHandleImpl(flags, std::move(manifest_res.value()))};
@@ -272,23 +291,126 @@ tsuba::CreateSrcDestFromViewsForCopy(
   return src_dst_files;
 }
 
+namespace {
+
+/// Bounds the bytes of the files that CopyRDG holds in memory at once
+class ByteBudget {
+public:
+  explicit ByteBudget(uint64_t capacity)
+      : capacity_(std::max<uint64_t>(capacity, 1)), available_(capacity_) {}
+
+  /// Wait for size bytes, or for the whole budget if size is larger, and
+  /// return how many were taken
+  uint64_t Acquire(uint64_t size) {
+    size = std::min(size, capacity_);
+    std::unique_lock<std::mutex> lock(mutex_);
+    available_cv_.wait(lock, [&]() { return available_ >= size; });
+    available_ -= size;
+    return size;
+  }
+
+  void Release(uint64_t size) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      available_ += size;
+    }
+    available_cv_.notify_all();
+  }
+
+private:
+  uint64_t capacity_;
+  uint64_t available_;
+  std::mutex mutex_;
+  std::condition_variable available_cv_;
+};
+
+/// Copy one data file of an RDG, see CopyRDG
+katana::Result<void>
+CopyRDGFile(
+    const std::string& src, const std::string& dst, ByteBudget* budget) {
+  tsuba::StatBuf src_stat;
+  KATANA_CHECKED_CONTEXT(tsuba::FileStat(src, &src_stat), "stat {}", src);
+  if (src == dst) {
+    return katana::ResultSuccess();
+  }
+  bool same_backend = tsuba::FS(src) == tsuba::FS(dst);
+  // Destination names do not depend on the contents, so only an entity tag
+  // from the same back-end shows that dst already holds them
+  if (same_backend && !src_stat.etag.empty()) {
+    tsuba::StatBuf dst_stat;
+    if (tsuba::FileStat(dst, &dst_stat) && dst_stat.size == src_stat.size &&
+        dst_stat.etag == src_stat.etag) {
+      KATANA_LOG_DEBUG("skipping {}, which {} already has", src, dst);
+      return katana::ResultSuccess();
+    }
+  }
+
+  if (same_backend) {
+    KATANA_CHECKED_CONTEXT(
+        tsuba::FileRemoteCopy(src, dst, 0, src_stat.size), "copying {} to {}",
+        src, dst);
+    return katana::ResultSuccess();
+  }
+
+  uint64_t reserved = budget->Acquire(src_stat.size);
+  auto store = [&]() -> katana::Result<void> {
+    tsuba::FileView fv;
+    KATANA_CHECKED_CONTEXT(fv.Bind(src, false), "reading {}", src);
+    KATANA_CHECKED_CONTEXT(
+        tsuba::FileStore(dst, fv.ptr<char>(), fv.size()), "storing {}", dst);
+    return katana::ResultSuccess();
+  };
+  auto res = store();
+  budget->Release(reserved);
+  return res;
+}
+
+}  // namespace
+
 katana::Result<void>
-tsuba::CopyRDG(std::vector<std::pair<katana::Uri, katana::Uri>> src_dst_files) {
-  // TODO(vkarthik): write tests
-  // TODO(vkarthik): add do_all loop
+tsuba::CopyRDG(
+    std::vector<std::pair<katana::Uri, katana::Uri>> src_dst_files,
+    const CopyRDGOptions& opts) {
   std::vector<uint64_t> manifest_uri_idxs;
+  std::vector<uint64_t> data_uri_idxs;
   for (uint64_t i = 0; i < src_dst_files.size(); i++) {
-    auto [src_file_uri, dst_file_uri] = src_dst_files[i];
     // We save the names of all the manifest files and we write them out at the end.
-    if (tsuba::RDGManifest::IsManifestUri(src_file_uri)) {
+    if (tsuba::RDGManifest::IsManifestUri(src_dst_files[i].first)) {
       manifest_uri_idxs.push_back(i);
-      continue;
+    } else {
+      data_uri_idxs.push_back(i);
+    }
+  }
+
+  // Workers take the next file until none are left or one fails
+  ByteBudget budget(opts.max_buffered_bytes);
+  std::atomic<uint64_t> next{0};
+  std::atomic<bool> failed{false};
+  auto copy_files = [&]() -> katana::CopyableResult<void> {
+    for (uint64_t i = next++; i < data_uri_idxs.size() && !failed;
+         i = next++) {
+      const auto& [src_uri, dst_uri] = src_dst_files[data_uri_idxs[i]];
+      if (auto res = CopyRDGFile(src_uri.string(), dst_uri.string(), &budget);
+          !res) {
+        failed = true;
+        return res.error();
+      }
+    }
+    return katana::CopyableResultSuccess();
+  };
+  uint64_t num_workers = std::min<uint64_t>(
+      std::max<uint32_t>(opts.num_parallel_copies, 1), data_uri_idxs.size());
+  std::vector<std::future<katana::CopyableResult<void>>> workers;
+  for (uint64_t w = 0; w < num_workers; ++w) {
+    workers.emplace_back(std::async(std::launch::async, copy_files));
+  }
+  katana::Result<void> result = katana::ResultSuccess();
+  for (auto& worker : workers) {
+    if (auto res = worker.get(); !res && result) {
+      result = katana::ErrorInfo(res.error());
     }
-    tsuba::FileView fv;
-    KATANA_CHECKED(fv.Bind(src_file_uri.path(), false));
-    KATANA_CHECKED(
-        tsuba::FileStore(dst_file_uri.path(), fv.ptr<char>(), fv.size()));
   }
+  KATANA_CHECKED(result);
 
   // Process all the manifest files, write them out.
   // We want to write this last so that we know whether a write fully finished or not.
@@ -303,7 +425,7 @@ tsuba::CopyRDG(std::vector<std::pair<katana::Uri, katana::Uri>> src_dst_files) {
 
     auto rdg_manifest_json = rdg_manifest.ToJsonString();
     KATANA_CHECKED(tsuba::FileStore(
-        dst_file_uri.path(),
+        dst_file_uri.string(),
         reinterpret_cast<const uint8_t*>(rdg_manifest_json.data()),
         rdg_manifest_json.size()));
   }
@@ -343,6 +465,7 @@ tsuba::Init() {
 
 katana::Result<void>
 tsuba::Fini() {
+  ClearMetadataCache();
   auto r = GlobalState::Fini();
   return r;
 }
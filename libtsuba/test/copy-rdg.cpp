@@ -0,0 +1,102 @@
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "katana/Logging.h"
+#include "katana/Result.h"
+#include "katana/URI.h"
+#include "tsuba/file.h"
+#include "tsuba/tsuba.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+constexpr uint64_t kNumFiles = 40;
+
+std::vector<uint8_t>
+Contents(uint64_t file, uint8_t salt) {
+  std::vector<uint8_t> contents(file * 1031);
+  for (uint64_t i = 0; i < contents.size(); ++i) {
+    contents[i] = static_cast<uint8_t>(i * 13 + file + salt);
+  }
+  return contents;
+}
+
+katana::Uri
+FileUri(const katana::Uri& dir, uint64_t file) {
+  return dir.Join(fmt::format("part_vers0001_rdg_node{:05}", file));
+}
+
+/// Copy kNumFiles data files, of which the destination already has some
+/// with the same size, and check that it ends with the source contents
+katana::Result<void>
+TestCopy(uint32_t num_parallel_copies) {
+  auto src_dir = KATANA_CHECKED(katana::Uri::MakeRand("/tmp/copy-rdg-src"));
+  auto dst_dir = KATANA_CHECKED(katana::Uri::MakeRand("/tmp/copy-rdg-dst"));
+  KATANA_CHECKED(tsuba::Create(src_dir.string()));
+  KATANA_CHECKED(tsuba::Create(dst_dir.string()));
+
+  std::vector<std::pair<katana::Uri, katana::Uri>> src_dst_files;
+  for (uint64_t file = 0; file < kNumFiles; ++file) {
+    std::vector<uint8_t> contents = Contents(file, 0);
+    KATANA_CHECKED(tsuba::FileStore(
+        FileUri(src_dir, file).string(), contents.data(), contents.size()));
+    src_dst_files.emplace_back(FileUri(src_dir, file), FileUri(dst_dir, file));
+  }
+
+  // Left by another graph or an interrupted copy: same names and sizes,
+  // other contents
+  for (uint64_t file = 0; file < kNumFiles; file += 3) {
+    std::vector<uint8_t> stale = Contents(file, 1);
+    KATANA_CHECKED(tsuba::FileStore(
+        FileUri(dst_dir, file).string(), stale.data(), stale.size()));
+  }
+
+  tsuba::CopyRDGOptions opts;
+  opts.num_parallel_copies = num_parallel_copies;
+  KATANA_CHECKED(tsuba::CopyRDG(src_dst_files, opts));
+
+  for (uint64_t file = 0; file < kNumFiles; ++file) {
+    std::vector<uint8_t> expected = Contents(file, 0);
+    std::string uri = FileUri(dst_dir, file).string();
+    tsuba::StatBuf stat;
+    KATANA_CHECKED(tsuba::FileStat(uri, &stat));
+    KATANA_LOG_ASSERT(stat.size == expected.size());
+    std::vector<uint8_t> copied(expected.size());
+    KATANA_CHECKED(tsuba::FileGet(uri, copied.data(), 0, copied.size()));
+    KATANA_LOG_VASSERT(copied == expected, "{} has stale contents", uri);
+  }
+
+  // A missing source fails the copy
+  src_dst_files.emplace_back(
+      FileUri(src_dir, kNumFiles), FileUri(dst_dir, kNumFiles));
+  KATANA_LOG_ASSERT(!tsuba::CopyRDG(src_dst_files, opts));
+
+  fs::remove_all(src_dir.path());
+  fs::remove_all(dst_dir.path());
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+int
+main() {
+  if (auto init_good = tsuba::Init(); !init_good) {
+    KATANA_LOG_FATAL("tsuba::Init: {}", init_good.error());
+  }
+
+  for (uint32_t num_parallel_copies : {1, 8}) {
+    if (auto res = TestCopy(num_parallel_copies); !res) {
+      KATANA_LOG_FATAL("TestCopy({}): {}", num_parallel_copies, res.error());
+    }
+  }
+
+  if (auto fini_good = tsuba::Fini(); !fini_good) {
+    KATANA_LOG_FATAL("tsuba::Fini: {}", fini_good.error());
+  }
+  return 0;
+}
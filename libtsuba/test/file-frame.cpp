@@ -0,0 +1,90 @@
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "katana/Logging.h"
+#include "katana/Result.h"
+#include "katana/URI.h"
+#include "tsuba/FileFrame.h"
+#include "tsuba/file.h"
+#include "tsuba/tsuba.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+/// Write size bytes to a frame at uri in odd-sized pieces, store it and
+/// check what was stored
+katana::Result<void>
+TestStore(const std::string& uri, uint64_t size, bool streaming) {
+  std::vector<uint8_t> expected(size);
+  for (uint64_t i = 0; i < size; ++i) {
+    expected[i] = static_cast<uint8_t>(i * 7 + i / 4096);
+  }
+
+  tsuba::FileFrame ff;
+  KATANA_CHECKED(ff.Init());
+  ff.Bind(uri);
+  if (streaming) {
+    KATANA_CHECKED(
+        ff.StartStreaming(tsuba::MultipartWriter::kMinPartSize, 2));
+  }
+  constexpr uint64_t kPiece = 1000003;
+  for (uint64_t off = 0; off < size; off += kPiece) {
+    uint64_t piece = std::min(kPiece, size - off);
+    KATANA_LOG_ASSERT(ff.Write(expected.data() + off, piece).ok());
+    KATANA_LOG_ASSERT(ff.Tell().ValueOrDie() == int64_t(off + piece));
+  }
+  if (streaming) {
+    // Only the parts in flight and the current one are held in memory
+    KATANA_LOG_ASSERT(ff.map_size() <= tsuba::MultipartWriter::kMinPartSize);
+  }
+  KATANA_CHECKED(ff.PersistAsync().get());
+
+  tsuba::StatBuf stat;
+  KATANA_CHECKED(tsuba::FileStat(uri, &stat));
+  KATANA_LOG_ASSERT(stat.size == size);
+  std::vector<uint8_t> stored(size);
+  KATANA_CHECKED(tsuba::FileGet(uri, stored.data(), 0, size));
+  KATANA_LOG_ASSERT(stored == expected);
+
+  // A frame stored in parts cannot be stored again
+  if (streaming && size > tsuba::MultipartWriter::kMinPartSize) {
+    KATANA_LOG_ASSERT(!ff.Persist());
+  }
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+int
+main() {
+  if (auto init_good = tsuba::Init(); !init_good) {
+    KATANA_LOG_FATAL("tsuba::Init: {}", init_good.error());
+  }
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/fileframe");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string dir = uri_res.value().string();
+
+  constexpr uint64_t kPart = tsuba::MultipartWriter::kMinPartSize;
+  for (uint64_t size : {uint64_t{0}, uint64_t{12345}, kPart, 3 * kPart + 17}) {
+    for (bool streaming : {false, true}) {
+      std::string uri = katana::Uri::JoinPath(
+          dir, fmt::format("{}-{}", size, streaming ? "parts" : "whole"));
+      if (auto res = TestStore(uri, size, streaming); !res) {
+        KATANA_LOG_FATAL("TestStore({}): {}", uri, res.error());
+      }
+    }
+  }
+
+  fs::remove_all(dir);
+
+  if (auto fini_good = tsuba::Fini(); !fini_good) {
+    KATANA_LOG_FATAL("tsuba::Fini: {}", fini_good.error());
+  }
+  return 0;
+}
@@ -0,0 +1,144 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "katana/Logging.h"
+#include "katana/Result.h"
+#include "katana/URI.h"
+#include "tsuba/FileView.h"
+#include "tsuba/IOStats.h"
+#include "tsuba/file.h"
+#include "tsuba/tsuba.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+using ReadaheadPolicy = tsuba::FileView::ReadaheadPolicy;
+
+/// FileView pages are 1 MiB
+constexpr uint64_t kPageSize = UINT64_C(1) << 20;
+constexpr uint64_t kNumPages = 32;
+/// Random reads skip this many pages, so no readahead reaches the next one
+constexpr uint64_t kRandomStride = 4;
+
+struct Fetched {
+  uint64_t faulted;
+  uint64_t prefetched;
+};
+
+/// Read a page at each of pages in turn and return the pages FileView
+/// fetched to do so
+katana::Result<Fetched>
+ReadPages(
+    const std::string& uri, ReadaheadPolicy policy,
+    const std::vector<uint64_t>& pages, uint64_t* final_window) {
+  tsuba::FileView fv;
+  KATANA_CHECKED(fv.Bind(uri, 0, false));
+  fv.set_readahead_policy(policy);
+  tsuba::ResetIOStats();
+
+  std::vector<uint8_t> buf(kPageSize);
+  for (uint64_t page : pages) {
+    auto status = fv.Seek(page * kPageSize);
+    KATANA_LOG_ASSERT(status.ok());
+    auto read = fv.Read(kPageSize, buf.data());
+    KATANA_LOG_VASSERT(read.ok(), "{}", read.status().ToString());
+    KATANA_LOG_ASSERT(read.ValueOrDie() == static_cast<int64_t>(kPageSize));
+    for (uint64_t i = 0; i < kPageSize; i += 4096) {
+      KATANA_LOG_ASSERT(buf[i] == static_cast<uint8_t>(page * kPageSize + i));
+    }
+  }
+  *final_window = fv.readahead_window();
+  KATANA_CHECKED(fv.Unbind());
+
+  tsuba::IOStats stats = tsuba::GetIOStats();
+  return Fetched{stats.pages_faulted, stats.pages_prefetched};
+}
+
+/// Sequential reads fault only the first page: readahead starts with it and
+/// keeps ahead of every read after; the window grows past 64 pages
+katana::Result<void>
+TestSequential(const std::string& uri) {
+  std::vector<uint64_t> pages;
+  for (uint64_t page = 0; page < kNumPages; ++page) {
+    pages.emplace_back(page);
+  }
+  uint64_t window{};
+  Fetched fetched = KATANA_CHECKED(
+      ReadPages(uri, ReadaheadPolicy::kAdaptive, pages, &window));
+  KATANA_LOG_VASSERT(
+      fetched.faulted == 1, "{} pages faulted reading sequentially",
+      fetched.faulted);
+  KATANA_LOG_ASSERT(fetched.faulted + fetched.prefetched == kNumPages);
+  KATANA_LOG_VASSERT(
+      window == tsuba::FileView::kMaxReadaheadPages * kPageSize,
+      "window of {} bytes after a sequential scan", window);
+  return katana::ResultSuccess();
+}
+
+/// Random reads fault every page they read; readahead follows only the first
+/// of them, so adaptive fetches far less than the last read size policy
+katana::Result<void>
+TestRandom(const std::string& uri) {
+  std::vector<uint64_t> pages;
+  for (uint64_t page = 0; page < kNumPages; page += kRandomStride) {
+    pages.emplace_back(page);
+  }
+  std::shuffle(pages.begin(), pages.end(), std::mt19937(0));
+
+  uint64_t window{};
+  Fetched adaptive = KATANA_CHECKED(
+      ReadPages(uri, ReadaheadPolicy::kAdaptive, pages, &window));
+  KATANA_LOG_ASSERT(adaptive.faulted == pages.size());
+  KATANA_LOG_VASSERT(
+      adaptive.prefetched <= 2, "{} pages prefetched reading randomly",
+      adaptive.prefetched);
+  KATANA_LOG_ASSERT(window == 0);
+
+  Fetched last_read_size = KATANA_CHECKED(
+      ReadPages(uri, ReadaheadPolicy::kLastReadSize, pages, &window));
+  KATANA_LOG_ASSERT(last_read_size.faulted == pages.size());
+  KATANA_LOG_ASSERT(last_read_size.prefetched == 2 * pages.size());
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+TestReadahead() {
+  auto dir = KATANA_CHECKED(katana::Uri::MakeRand("/tmp/file-view-readahead"));
+  KATANA_CHECKED(tsuba::Create(dir.string()));
+  std::string uri = dir.Join("data").string();
+  std::vector<uint8_t> contents(kNumPages * kPageSize);
+  for (uint64_t i = 0; i < contents.size(); ++i) {
+    contents[i] = static_cast<uint8_t>(i);
+  }
+  KATANA_CHECKED(tsuba::FileStore(uri, contents.data(), contents.size()));
+
+  KATANA_CHECKED(TestSequential(uri));
+  KATANA_CHECKED(TestRandom(uri));
+
+  fs::remove_all(dir.path());
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+int
+main() {
+  if (auto init_good = tsuba::Init(); !init_good) {
+    KATANA_LOG_FATAL("tsuba::Init: {}", init_good.error());
+  }
+
+  if (auto res = TestReadahead(); !res) {
+    KATANA_LOG_FATAL("TestReadahead: {}", res.error());
+  }
+
+  if (auto fini_good = tsuba::Fini(); !fini_good) {
+    KATANA_LOG_FATAL("tsuba::Fini: {}", fini_good.error());
+  }
+  return 0;
+}
@@ -0,0 +1,122 @@
+#include <cstdint>
+#include <future>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "katana/Logging.h"
+#include "katana/Result.h"
+#include "katana/URI.h"
+#include "tsuba/file.h"
+#include "tsuba/tsuba.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+/// Larger than the chunks a single read is split into
+constexpr uint64_t kFileSize = (UINT64_C(40) << 20) + 12345;
+constexpr uint64_t kNumSmallReads = 500;
+
+uint8_t
+ByteAt(uint64_t offset) {
+  return static_cast<uint8_t>(offset * 7 + (offset >> 12));
+}
+
+struct PendingRead {
+  uint64_t begin;
+  std::vector<uint8_t> buf;
+  std::future<katana::CopyableResult<void>> future;
+};
+
+/// Start a whole-file read and many small ones, which are submitted in
+/// batches
+std::vector<PendingRead>
+StartReads(const std::string& uri) {
+  std::vector<PendingRead> reads;
+  reads.emplace_back(PendingRead{0, std::vector<uint8_t>(kFileSize), {}});
+  for (uint64_t i = 0; i < kNumSmallReads; ++i) {
+    uint64_t begin = (i * 104729) % (kFileSize - 4096);
+    reads.emplace_back(
+        PendingRead{begin, std::vector<uint8_t>(1 + i % 4096), {}});
+  }
+  for (auto& read : reads) {
+    read.future = tsuba::FileGetAsync(
+        uri, read.buf.data(), read.begin, read.buf.size());
+  }
+  return reads;
+}
+
+katana::Result<void>
+CheckReads(std::vector<PendingRead>* reads) {
+  for (auto& read : *reads) {
+    KATANA_CHECKED(read.future.get());
+    for (uint64_t i = 0; i < read.buf.size(); ++i) {
+      KATANA_LOG_VASSERT(
+          read.buf[i] == ByteAt(read.begin + i), "byte {} of read at {}", i,
+          read.begin);
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+/// Batched reads return the file contents, and reads that fail, in the
+/// middle of the batch or on their own, do not affect the others
+katana::Result<void>
+TestReads(const std::string& dir, const std::string& uri) {
+  std::vector<PendingRead> reads = StartReads(uri);
+
+  // Missing file, read too far past the end, and a read that only fails
+  // once it is issued
+  std::vector<uint8_t> buf(2 * tsuba::kBlockSize);
+  auto missing =
+      tsuba::FileGetAsync(dir + "/missing", buf.data(), 0, buf.size());
+  auto past_end = tsuba::FileGetAsync(
+      uri, buf.data(), kFileSize - 10, 10 + 2 * tsuba::kBlockSize);
+  auto directory = tsuba::FileGetAsync(dir, buf.data(), 0, 16);
+
+  KATANA_CHECKED(CheckReads(&reads));
+  KATANA_LOG_ASSERT(!missing.get());
+  KATANA_LOG_ASSERT(!past_end.get());
+  KATANA_LOG_ASSERT(!directory.get());
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+int
+main() {
+  if (auto init_good = tsuba::Init(); !init_good) {
+    KATANA_LOG_FATAL("tsuba::Init: {}", init_good.error());
+  }
+
+  auto dir_res = katana::Uri::MakeRand("/tmp/local-storage-reads");
+  KATANA_LOG_ASSERT(dir_res);
+  std::string dir = dir_res.value().path();
+  std::string uri = dir + "/data";
+  std::vector<uint8_t> contents(kFileSize);
+  for (uint64_t i = 0; i < kFileSize; ++i) {
+    contents[i] = ByteAt(i);
+  }
+  if (auto res = tsuba::FileStore(uri, contents.data(), contents.size());
+      !res) {
+    KATANA_LOG_FATAL("storing {}: {}", uri, res.error());
+  }
+
+  if (auto res = TestReads(dir, uri); !res) {
+    KATANA_LOG_FATAL("TestReads: {}", res.error());
+  }
+
+  // Shutting down while reads are outstanding completes them first
+  std::vector<PendingRead> reads = StartReads(uri);
+  if (auto fini_good = tsuba::Fini(); !fini_good) {
+    KATANA_LOG_FATAL("tsuba::Fini: {}", fini_good.error());
+  }
+  if (auto res = CheckReads(&reads); !res) {
+    KATANA_LOG_FATAL("reads outstanding at Fini: {}", res.error());
+  }
+
+  fs::remove_all(dir);
+  return 0;
+}
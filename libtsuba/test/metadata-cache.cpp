@@ -0,0 +1,252 @@
+#include <fstream>
+#include <future>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "MetadataCache.h"
+#include "RDGManifest.h"
+#include "RDGPartHeader.h"
+#include "katana/Result.h"
+#include "katana/URI.h"
+#include "tsuba/FileStorage.h"
+#include "tsuba/IOStats.h"
+#include "tsuba/file.h"
+#include "tsuba/tsuba.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+uint64_t
+FileReads() {
+  return tsuba::GetIOStats().schemes["file"].reads.requests;
+}
+
+/// Make the manifest at uri, expecting it to be found in the cache or not
+katana::Result<tsuba::RDGManifest>
+MakeManifest(const katana::Uri& uri, bool hit) {
+  tsuba::IOStats before = tsuba::GetIOStats();
+  auto manifest = KATANA_CHECKED(tsuba::RDGManifest::Make(uri));
+  tsuba::IOStats after = tsuba::GetIOStats();
+  KATANA_LOG_VASSERT(
+      after.metadata_cache_hits == before.metadata_cache_hits + (hit ? 1 : 0),
+      "expected a {} for {}", hit ? "hit" : "miss", uri);
+  return manifest;
+}
+
+katana::Result<void>
+TestHits(const katana::Uri& uri) {
+  tsuba::ClearMetadataCache();
+  tsuba::RDGManifest first = KATANA_CHECKED(MakeManifest(uri, false));
+  tsuba::RDGManifest second = KATANA_CHECKED(MakeManifest(uri, true));
+  KATANA_LOG_ASSERT(first.ToJsonString() == second.ToJsonString());
+  KATANA_LOG_ASSERT(first.dir() == second.dir());
+
+  // Headers are prefetched for all partitions
+  tsuba::MetadataCache::Get().PrefetchPartHeaders(first);
+  uint64_t hits = tsuba::GetIOStats().metadata_cache_hits;
+  for (uint32_t i = 0; i < first.num_hosts(); ++i) {
+    KATANA_CHECKED(tsuba::RDGPartHeader::Make(first.PartitionFileName(i)));
+  }
+  KATANA_LOG_ASSERT(
+      tsuba::GetIOStats().metadata_cache_hits == hits + first.num_hosts());
+
+  // Without validation a hit reads nothing from storage
+  tsuba::MetadataCacheOptions opts;
+  opts.validate = false;
+  tsuba::SetMetadataCacheOptions(opts);
+  uint64_t reads = FileReads();
+  KATANA_CHECKED(MakeManifest(uri, true));
+  KATANA_LOG_ASSERT(FileReads() == reads);
+
+  // Nor does a disabled cache hit
+  opts.max_entries = 0;
+  tsuba::SetMetadataCacheOptions(opts);
+  KATANA_CHECKED(MakeManifest(uri, false));
+  KATANA_CHECKED(MakeManifest(uri, false));
+
+  tsuba::SetMetadataCacheOptions(tsuba::MetadataCacheOptions());
+  return katana::ResultSuccess();
+}
+
+/// A manifest that changes is read again
+katana::Result<void>
+TestChanges(const katana::Uri& uri) {
+  tsuba::RDGManifest manifest = KATANA_CHECKED(tsuba::RDGManifest::Make(uri));
+  std::string contents = manifest.ToJsonString();
+
+  auto dir = KATANA_CHECKED(katana::Uri::MakeRand("/tmp/metadata-cache"));
+  KATANA_CHECKED(tsuba::Create(dir.string()));
+  katana::Uri copy =
+      tsuba::RDGManifest::FileName(dir, tsuba::kDefaultRDGViewType, 0);
+  tsuba::RDGManifest read = KATANA_CHECKED(MakeManifest(copy, false));
+  KATANA_LOG_ASSERT(read.IsEmptyRDG());
+  read = KATANA_CHECKED(MakeManifest(copy, true));
+  KATANA_LOG_ASSERT(read.IsEmptyRDG());
+
+  // Written through tsuba
+  KATANA_CHECKED(
+      tsuba::FileStore(copy.string(), contents.data(), contents.size()));
+  read = KATANA_CHECKED(MakeManifest(copy, false));
+  KATANA_LOG_ASSERT(!read.IsEmptyRDG());
+
+  // Written behind tsuba's back is only seen with validation
+  std::string empty = tsuba::RDGManifest().ToJsonString();
+  std::ofstream(copy.path()) << empty;
+  tsuba::MetadataCacheOptions opts;
+  opts.validate = false;
+  tsuba::SetMetadataCacheOptions(opts);
+  read = KATANA_CHECKED(MakeManifest(copy, true));
+  KATANA_LOG_ASSERT(!read.IsEmptyRDG());
+  tsuba::SetMetadataCacheOptions(tsuba::MetadataCacheOptions());
+  read = KATANA_CHECKED(MakeManifest(copy, false));
+  KATANA_LOG_ASSERT(read.IsEmptyRDG());
+
+  // Deleted through tsuba
+  KATANA_CHECKED(tsuba::FileDelete(dir.string(), {copy.BaseName()}));
+  KATANA_LOG_ASSERT(!tsuba::RDGManifest::Make(copy));
+
+  fs::remove_all(dir.path());
+  return katana::ResultSuccess();
+}
+
+/// Local files under the sizeonly:// scheme, stated without a modification
+/// time, like a backend that reports only sizes
+class SizeOnlyStorage : public tsuba::FileStorage {
+public:
+  SizeOnlyStorage() : FileStorage("sizeonly://") {}
+
+  katana::Result<void> Init() override { return katana::ResultSuccess(); }
+  katana::Result<void> Fini() override { return katana::ResultSuccess(); }
+
+  katana::Result<void> Stat(
+      const std::string& uri, tsuba::StatBuf* s_buf) override {
+    KATANA_CHECKED(tsuba::FileStat(Local(uri), s_buf));
+    s_buf->mtime_ns = 0;
+    return katana::ResultSuccess();
+  }
+
+  katana::Result<void> GetMultiSync(
+      const std::string& uri, uint64_t start, uint64_t size,
+      uint8_t* result_buf) override {
+    return tsuba::FileGet(Local(uri), result_buf, start, size);
+  }
+
+  katana::Result<void> PutMultiSync(
+      const std::string& uri, const uint8_t* data, uint64_t size) override {
+    return tsuba::FileStore(Local(uri), data, size);
+  }
+
+  katana::Result<void> RemoteCopy(
+      const std::string& source_uri, const std::string& dest_uri,
+      uint64_t begin, uint64_t size) override {
+    return tsuba::FileRemoteCopy(
+        Local(source_uri), Local(dest_uri), begin, size);
+  }
+
+  std::future<katana::CopyableResult<void>> PutAsync(
+      const std::string& uri, const uint8_t* data, uint64_t size) override {
+    return tsuba::FileStoreAsync(Local(uri), data, size);
+  }
+
+  std::future<katana::CopyableResult<void>> GetAsync(
+      const std::string& uri, uint64_t start, uint64_t size,
+      uint8_t* result_buf) override {
+    return tsuba::FileGetAsync(Local(uri), result_buf, start, size);
+  }
+
+  std::future<katana::CopyableResult<void>> ListAsync(
+      const std::string& directory, std::vector<std::string>* list,
+      std::vector<uint64_t>* size) override {
+    return tsuba::FileListAsync(Local(directory), list, size);
+  }
+
+  katana::Result<void> Delete(
+      const std::string& directory,
+      const std::unordered_set<std::string>& files) override {
+    return tsuba::FileDelete(Local(directory), files);
+  }
+
+private:
+  std::string Local(const std::string& uri) {
+    return uri.substr(uri_scheme().size());
+  }
+};
+
+/// Without a modification time or ETag, files are read every time, since a
+/// rewrite of the same size could not be told apart
+katana::Result<void>
+TestSizeOnly(const katana::Uri& uri) {
+  tsuba::RDGManifest manifest = KATANA_CHECKED(tsuba::RDGManifest::Make(uri));
+  std::string contents = manifest.ToJsonString();
+
+  auto dir = KATANA_CHECKED(katana::Uri::MakeRand("/tmp/metadata-cache"));
+  KATANA_CHECKED(tsuba::Create(dir.string()));
+  katana::Uri local =
+      tsuba::RDGManifest::FileName(dir, tsuba::kDefaultRDGViewType, 0);
+  KATANA_CHECKED(
+      tsuba::FileStore(local.string(), contents.data(), contents.size()));
+  katana::Uri size_only =
+      KATANA_CHECKED(katana::Uri::Make("sizeonly://" + local.path()));
+
+  tsuba::ClearMetadataCache();
+  KATANA_CHECKED(MakeManifest(size_only, false));
+  KATANA_CHECKED(MakeManifest(size_only, false));
+
+  // Without validation nothing is compared, so they are cached
+  tsuba::MetadataCacheOptions opts;
+  opts.validate = false;
+  tsuba::SetMetadataCacheOptions(opts);
+  KATANA_CHECKED(MakeManifest(size_only, false));
+  KATANA_CHECKED(MakeManifest(size_only, true));
+  tsuba::SetMetadataCacheOptions(tsuba::MetadataCacheOptions());
+
+  fs::remove_all(dir.path());
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+int
+main(int argc, char* argv[]) {
+  if (auto init_good = tsuba::Init(); !init_good) {
+    KATANA_LOG_FATAL("tsuba::Init: {}", init_good.error());
+  }
+
+  if (argc <= 1) {
+    KATANA_LOG_FATAL("metadata-cache <rdg manifest>");
+  }
+
+  auto uri_res = katana::Uri::MakeFromFile(argv[1]);
+  if (!uri_res) {
+    KATANA_LOG_FATAL("bad path {}: {}", argv[1], uri_res.error());
+  }
+  if (auto res = TestHits(uri_res.value()); !res) {
+    KATANA_LOG_FATAL("TestHits: {}", res.error());
+  }
+  if (auto res = TestChanges(uri_res.value()); !res) {
+    KATANA_LOG_FATAL("TestChanges: {}", res.error());
+  }
+
+  if (auto fini_good = tsuba::Fini(); !fini_good) {
+    KATANA_LOG_FATAL("tsuba::Fini: {}", fini_good.error());
+  }
+
+  // Backends are registered for each tsuba::Init
+  SizeOnlyStorage size_only;
+  tsuba::RegisterFileStorage(&size_only);
+  if (auto init_good = tsuba::Init(); !init_good) {
+    KATANA_LOG_FATAL("tsuba::Init: {}", init_good.error());
+  }
+  if (auto res = TestSizeOnly(uri_res.value()); !res) {
+    KATANA_LOG_FATAL("TestSizeOnly: {}", res.error());
+  }
+  if (auto fini_good = tsuba::Fini(); !fini_good) {
+    KATANA_LOG_FATAL("tsuba::Fini: {}", fini_good.error());
+  }
+
+  return 0;
+}
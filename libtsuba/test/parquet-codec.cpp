@@ -0,0 +1,142 @@
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+
+#include <arrow/api.h>
+#include <boost/filesystem.hpp>
+
+#include "katana/Logging.h"
+#include "katana/Result.h"
+#include "katana/URI.h"
+#include "tsuba/ParquetReader.h"
+#include "tsuba/ParquetWriter.h"
+#include "tsuba/tsuba.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+constexpr int64_t kNumRows = 100000;
+
+template <typename Builder, typename Fn>
+std::shared_ptr<arrow::Array>
+MakeArray(Fn value) {
+  Builder builder;
+  for (int64_t i = 0; i < kNumRows; ++i) {
+    if (i % 101 == 0) {
+      KATANA_LOG_ASSERT(builder.AppendNull().ok());
+    } else {
+      KATANA_LOG_ASSERT(builder.Append(value(i)).ok());
+    }
+  }
+  std::shared_ptr<arrow::Array> array;
+  KATANA_LOG_ASSERT(builder.Finish(&array).ok());
+  return array;
+}
+
+/// A table with a column of each kind the auto policy tells apart
+std::shared_ptr<arrow::Table>
+MakeTable() {
+  std::mt19937_64 generator(11);
+  std::uniform_real_distribution<double> real;
+  std::uniform_int_distribution<int64_t> integer(0, 1L << 40);
+
+  auto floats =
+      MakeArray<arrow::DoubleBuilder>([&](int64_t) { return real(generator); });
+  auto sorted =
+      MakeArray<arrow::Int64Builder>([](int64_t i) { return i * 3; });
+  auto random = MakeArray<arrow::Int64Builder>(
+      [&](int64_t) { return integer(generator); });
+  auto few = MakeArray<arrow::Int32Builder>(
+      [](int64_t i) { return static_cast<int32_t>(i % 5); });
+  auto strings = MakeArray<arrow::StringBuilder>(
+      [](int64_t i) { return fmt::format("name-{}", i / 16); });
+  return arrow::Table::Make(
+      arrow::schema(
+          {arrow::field("floats", floats->type()),
+           arrow::field("sorted", sorted->type()),
+           arrow::field("random", random->type()),
+           arrow::field("few", few->type()),
+           arrow::field("strings", strings->type())}),
+      {floats, sorted, random, few, strings});
+}
+
+void
+TestChoice(const arrow::Table& table) {
+  auto choose = [&](const std::string& name) {
+    return tsuba::ParquetWriter::ChooseColumnCodec(
+        *table.schema()->GetFieldByName(name),
+        *table.GetColumnByName(name));
+  };
+
+  tsuba::ColumnCodec floats = choose("floats");
+  KATANA_LOG_ASSERT(!floats.dictionary);
+  KATANA_LOG_ASSERT(floats.encoding == parquet::Encoding::BYTE_STREAM_SPLIT);
+
+  tsuba::ColumnCodec random = choose("random");
+  KATANA_LOG_ASSERT(!random.dictionary);
+  KATANA_LOG_ASSERT(random.encoding == parquet::Encoding::PLAIN);
+
+  tsuba::ColumnCodec few = choose("few");
+  KATANA_LOG_ASSERT(few.dictionary);
+
+  KATANA_LOG_ASSERT(!choose("sorted").dictionary);
+  KATANA_LOG_ASSERT(choose("strings").dictionary);
+}
+
+katana::Result<void>
+TestRoundTrip(
+    const std::shared_ptr<arrow::Table>& table, const std::string& uri_str,
+    tsuba::ParquetWriter::WriteOpts opts) {
+  auto uri = KATANA_CHECKED(katana::Uri::Make(uri_str));
+  auto writer = KATANA_CHECKED(tsuba::ParquetWriter::Make(table, opts));
+  KATANA_CHECKED(writer->WriteToUri(uri));
+
+  tsuba::ParquetReader::ReadOpts read_opts;
+  read_opts.make_cannonical = false;
+  auto reader = KATANA_CHECKED(tsuba::ParquetReader::Make(read_opts));
+  auto read = KATANA_CHECKED(reader->ReadTable(uri));
+  KATANA_LOG_ASSERT(read->Equals(*table));
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+int
+main() {
+  if (auto init_good = tsuba::Init(); !init_good) {
+    KATANA_LOG_FATAL("tsuba::Init: {}", init_good.error());
+  }
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/parquet-codec");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string dir = uri_res.value().string();
+
+  std::shared_ptr<arrow::Table> table = MakeTable();
+  TestChoice(*table);
+
+  auto opts = tsuba::ParquetWriter::WriteOpts::Defaults();
+  opts.max_row_group_length = kNumRows / 4;
+  if (auto res = TestRoundTrip(table, dir + "/auto", opts); !res) {
+    KATANA_LOG_FATAL("auto codecs: {}", res.error());
+  }
+
+  opts.codec_policy = tsuba::ParquetWriter::FixedCodecPolicy({});
+  if (auto res = TestRoundTrip(table, dir + "/plain", opts); !res) {
+    KATANA_LOG_FATAL("uncompressed: {}", res.error());
+  }
+
+  // Dictionary encoding is not an encoding of its own
+  tsuba::ColumnCodec dictionary;
+  dictionary.encoding = parquet::Encoding::RLE_DICTIONARY;
+  opts.codec_policy = tsuba::ParquetWriter::FixedCodecPolicy(dictionary);
+  KATANA_LOG_ASSERT(!TestRoundTrip(table, dir + "/invalid", opts));
+
+  fs::remove_all(dir);
+
+  if (auto fini_good = tsuba::Fini(); !fini_good) {
+    KATANA_LOG_FATAL("tsuba::Fini: {}", fini_good.error());
+  }
+  return 0;
+}
@@ -0,0 +1,145 @@
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+#include <boost/filesystem.hpp>
+
+#include "katana/Logging.h"
+#include "katana/Result.h"
+#include "katana/URI.h"
+#include "tsuba/ParquetReader.h"
+#include "tsuba/ParquetWriter.h"
+#include "tsuba/tsuba.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+constexpr int64_t kNumRows = 10000;
+constexpr int64_t kRowGroupLength = 1000;
+
+template <typename Builder, typename Fn>
+std::shared_ptr<arrow::Array>
+MakeArray(Fn value) {
+  Builder builder;
+  for (int64_t i = 0; i < kNumRows; ++i) {
+    if (i % 97 == 0) {
+      KATANA_LOG_ASSERT(builder.AppendNull().ok());
+    } else {
+      KATANA_LOG_ASSERT(builder.Append(value(i)).ok());
+    }
+  }
+  std::shared_ptr<arrow::Array> array;
+  KATANA_LOG_ASSERT(builder.Finish(&array).ok());
+  return array;
+}
+
+/// The first column is a struct with two leaves, so the parquet columns of
+/// the later fields are not at their field indexes
+std::shared_ptr<arrow::Table>
+MakeTable() {
+  auto first = MakeArray<arrow::Int32Builder>(
+      [](int64_t i) { return static_cast<int32_t>(i); });
+  auto second = MakeArray<arrow::Int32Builder>(
+      [](int64_t i) { return static_cast<int32_t>(-i); });
+  auto pair_res =
+      arrow::StructArray::Make({first, second}, {"first", "second"});
+  KATANA_LOG_ASSERT(pair_res.ok());
+  std::shared_ptr<arrow::Array> pair = pair_res.ValueOrDie();
+
+  auto id = MakeArray<arrow::Int64Builder>([](int64_t i) { return i * 7; });
+  auto weight = MakeArray<arrow::DoubleBuilder>(
+      [](int64_t i) { return static_cast<double>(i) / 3; });
+  auto name = MakeArray<arrow::StringBuilder>(
+      [](int64_t i) { return fmt::format("name-{}", i); });
+  return arrow::Table::Make(
+      arrow::schema(
+          {arrow::field("pair", pair->type()), arrow::field("id", id->type()),
+           arrow::field("weight", weight->type()),
+           arrow::field("name", name->type())}),
+      {pair, id, weight, name});
+}
+
+/// Reading some columns of a slice gives the same rows as selecting them from
+/// a read of the whole table
+katana::Result<void>
+CheckSlice(
+    const katana::Uri& uri, const arrow::Table& full,
+    const std::vector<int32_t>& columns, tsuba::ParquetReader::Slice slice) {
+  tsuba::ParquetReader::ReadOpts opts;
+  opts.slice = slice;
+  auto reader = KATANA_CHECKED(tsuba::ParquetReader::Make(opts));
+
+  std::vector<int> indexes(columns.begin(), columns.end());
+  auto expected = KATANA_CHECKED(full.SelectColumns(indexes))
+                      ->Slice(slice.offset, slice.length);
+
+  auto read = KATANA_CHECKED(reader->ReadTable(uri, columns));
+  KATANA_LOG_VASSERT(
+      read->Equals(*expected), "rows [{}, {}) of {} columns differ",
+      slice.offset, slice.offset + slice.length, columns.size());
+
+  for (int32_t column : columns) {
+    auto read_column = KATANA_CHECKED(reader->ReadColumn(uri, column));
+    auto expected_column = KATANA_CHECKED(full.SelectColumns({column}))
+                               ->Slice(slice.offset, slice.length);
+    KATANA_LOG_VASSERT(
+        read_column->Equals(*expected_column),
+        "rows [{}, {}) of column {} differ", slice.offset,
+        slice.offset + slice.length, column);
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+TestSlices(const std::string& uri_str) {
+  auto uri = KATANA_CHECKED(katana::Uri::Make(uri_str));
+  auto opts = tsuba::ParquetWriter::WriteOpts::Defaults();
+  opts.max_row_group_length = kRowGroupLength;
+  auto writer = KATANA_CHECKED(tsuba::ParquetWriter::Make(MakeTable(), opts));
+  KATANA_CHECKED(writer->WriteToUri(uri));
+
+  auto reader = KATANA_CHECKED(tsuba::ParquetReader::Make());
+  auto full = KATANA_CHECKED(reader->ReadTable(uri));
+  KATANA_LOG_ASSERT(full->num_rows() == kNumRows);
+
+  // Across two row group boundaries, after the struct
+  KATANA_CHECKED(CheckSlice(uri, *full, {1, 3}, {900, 1200}));
+  // One row on each side of a boundary
+  KATANA_CHECKED(CheckSlice(uri, *full, {0, 2}, {999, 2}));
+  // Exactly one row group
+  KATANA_CHECKED(CheckSlice(uri, *full, {0, 3}, {1000, 1000}));
+  // Within a row group
+  KATANA_CHECKED(CheckSlice(uri, *full, {2}, {4321, 100}));
+  // The last rows
+  KATANA_CHECKED(CheckSlice(uri, *full, {1, 2, 3}, {9500, 500}));
+  // Every row group
+  KATANA_CHECKED(CheckSlice(uri, *full, {0, 1, 2, 3}, {1, kNumRows - 2}));
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+int
+main() {
+  if (auto init_good = tsuba::Init(); !init_good) {
+    KATANA_LOG_FATAL("tsuba::Init: {}", init_good.error());
+  }
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/parquet-slice");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string dir = uri_res.value().string();
+
+  if (auto res = TestSlices(dir + "/table"); !res) {
+    KATANA_LOG_FATAL("slices: {}", res.error());
+  }
+
+  fs::remove_all(dir);
+
+  if (auto fini_good = tsuba::Fini(); !fini_good) {
+    KATANA_LOG_FATAL("tsuba::Fini: {}", fini_good.error());
+  }
+  return 0;
+}
@@ -0,0 +1,83 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "katana/Logging.h"
+#include "katana/Result.h"
+#include "tsuba/PartitionedLoad.h"
+#include "tsuba/RDGPrefix.h"
+#include "tsuba/tsuba.h"
+
+namespace {
+
+void
+TestRanges() {
+  // Node 0 has 8 edges and the others 1
+  std::vector<uint64_t> out_indexes{8, 9, 10, 11, 12, 13, 14, 15, 16};
+  auto ranges = tsuba::ComputeEdgeBalancedRanges(
+      out_indexes.data(), out_indexes.size(), 2);
+  KATANA_LOG_ASSERT(ranges.size() == 2);
+  KATANA_LOG_ASSERT(ranges[0] == std::make_pair(uint64_t{0}, uint64_t{1}));
+  KATANA_LOG_ASSERT(ranges[1] == std::make_pair(uint64_t{1}, uint64_t{9}));
+
+  // More hosts than nodes leaves some hosts empty
+  ranges = tsuba::ComputeEdgeBalancedRanges(out_indexes.data(), 2, 4);
+  KATANA_LOG_ASSERT(ranges.size() == 4);
+  KATANA_LOG_ASSERT(ranges.front().first == 0);
+  KATANA_LOG_ASSERT(ranges.back().second == 2);
+  for (size_t i = 1; i < ranges.size(); ++i) {
+    KATANA_LOG_ASSERT(ranges[i].first == ranges[i - 1].second);
+  }
+
+  // Without edges, nodes are split evenly
+  std::vector<uint64_t> no_edges(10, 0);
+  ranges =
+      tsuba::ComputeEdgeBalancedRanges(no_edges.data(), no_edges.size(), 2);
+  KATANA_LOG_ASSERT(ranges[0] == std::make_pair(uint64_t{0}, uint64_t{5}));
+}
+
+katana::Result<void>
+TestLoad(const std::string& path) {
+  auto handle = KATANA_CHECKED(tsuba::Open(path, tsuba::kReadOnly));
+  tsuba::RDGFile file(handle);
+  auto prefix = KATANA_CHECKED(tsuba::RDGPrefix::Make(handle));
+  auto part = KATANA_CHECKED(
+      tsuba::LoadPartitionedSlice(handle, std::vector<std::string>{}));
+
+  // A single host owns everything and has no ghosts or mirrors
+  KATANA_LOG_ASSERT(part.metadata.num_owned_ == prefix.num_nodes());
+  KATANA_LOG_ASSERT(part.metadata.num_nodes_ == prefix.num_nodes());
+  KATANA_LOG_ASSERT(part.metadata.num_edges_ == prefix.num_edges());
+  KATANA_LOG_ASSERT(part.mirrors.size() == 1 && part.mirrors[0].empty());
+  KATANA_LOG_ASSERT(part.out_indexes == prefix.range(0, prefix.num_nodes()));
+  KATANA_LOG_ASSERT(part.edge_dests.size() == prefix.num_edges());
+  for (uint64_t n = 0; n < prefix.num_nodes(); ++n) {
+    KATANA_LOG_ASSERT(part.GetHostID(n) == 0);
+    KATANA_LOG_ASSERT(part.GetLocalID(n) == n);
+  }
+
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+int
+main(int argc, char* argv[]) {
+  if (auto init_good = tsuba::Init(); !init_good) {
+    KATANA_LOG_FATAL("tsuba::Init: {}", init_good.error());
+  }
+
+  if (argc <= 1) {
+    KATANA_LOG_FATAL("partitioned-load <rdg prefix>");
+  }
+
+  TestRanges();
+  if (auto res = TestLoad(argv[1]); !res) {
+    KATANA_LOG_FATAL("TestLoad: {}", res.error());
+  }
+
+  if (auto fini_good = tsuba::Fini(); !fini_good) {
+    KATANA_LOG_FATAL("tsuba::Fini: {}", fini_good.error());
+  }
+  return 0;
+}
@@ -0,0 +1,71 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "AddProperties.h"
+#include "katana/Logging.h"
+
+namespace {
+
+/// No more than max_concurrent loads run at once, on no more threads, and
+/// every load runs
+void
+TestBound() {
+  constexpr uint32_t kMaxConcurrent = 3;
+  constexpr int kNumLoads = 60;
+  tsuba::PropertyLoadLimiter limiter(kMaxConcurrent, false);
+
+  std::atomic<int> running{0};
+  std::atomic<int> max_running{0};
+  std::vector<std::future<void>> done;
+  for (int i = 0; i < kNumLoads; ++i) {
+    auto promise = std::make_shared<std::promise<void>>();
+    done.emplace_back(promise->get_future());
+    limiter.Run([&running, &max_running, promise]() {
+      int now = ++running;
+      int prev = max_running.load();
+      while (prev < now && !max_running.compare_exchange_weak(prev, now)) {
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(2));
+      --running;
+      promise->set_value();
+    });
+  }
+  for (auto& future : done) {
+    future.get();
+  }
+  KATANA_LOG_VASSERT(
+      max_running.load() <= int(kMaxConcurrent), "{} loads ran at once",
+      max_running.load());
+  KATANA_LOG_ASSERT(limiter.num_threads() <= kMaxConcurrent);
+}
+
+/// Destroying the limiter runs the loads still queued
+void
+TestDrainOnDestroy() {
+  constexpr int kNumLoads = 10;
+  std::atomic<int> num_run{0};
+  {
+    auto limiter = std::make_unique<tsuba::PropertyLoadLimiter>(1, false);
+    for (int i = 0; i < kNumLoads; ++i) {
+      limiter->Run([&num_run]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        ++num_run;
+      });
+    }
+  }
+  KATANA_LOG_ASSERT(num_run.load() == kNumLoads);
+}
+
+}  // namespace
+
+int
+main() {
+  TestBound();
+  TestDrainOnDestroy();
+  return 0;
+}
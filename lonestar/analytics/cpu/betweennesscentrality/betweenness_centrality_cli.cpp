@@ -55,6 +55,16 @@ static cll::opt<bool> allSources(
         "Flag to compute betweenness centrality on all the sources (default "
         "false); if set -startNodesFile and -startNodes are ignored"),
     cll::init(false));
+static cll::opt<double> epsilon(
+    "epsilon",
+    cll::desc(
+        "If positive, sample random sources until the centralities, "
+        "normalized by n(n-1), are within epsilon with probability "
+        "1 - delta; other source options are ignored (default 0)"),
+    cll::init(0));
+static cll::opt<double> delta(
+    "delta", cll::desc("Failure probability of -epsilon (default 0.1)"),
+    cll::init(0.1));
 static cll::opt<BetweennessCentralityPlan::Algorithm> algo(
     "algo", cll::desc("Choose an algorithm (default value AutoAlgo):"),
     cll::values(
@@ -64,11 +74,20 @@ static cll::opt<BetweennessCentralityPlan::Algorithm> algo(
         // clEnumValN(BetweennessCentralityPlan::kAsynchronous, "Async", "Asynchronous"),
         clEnumValN(
             BetweennessCentralityPlan::kOuter, "Outer",
-            "Outer parallel algorithm")
+            "Outer parallel algorithm"),
+        clEnumValN(
+            BetweennessCentralityPlan::kBatched, "Batched",
+            "Level parallel algorithm over batches of sources")
         // clEnumValN(BetweennessCentralityPlan::kAutoAlgo, "Auto", "Auto: choose among the algorithms automatically")
         ),
     cll::init(BetweennessCentralityPlan::kLevel));
 
+static cll::opt<uint64_t> max_batch_mb(
+    "maxBatchMB",
+    cll::desc("Memory for the sources of a batch of -algo=Batched in MiB "
+              "(default 1024)"),
+    cll::init(BetweennessCentralityPlan::kDefaultMaxBatchBytes >> 20));
+
 static cll::opt<bool> thread_spin(
     "threadSpin",
     cll::desc("If enabled, threads busy-wait for work rather than use "
@@ -101,12 +120,16 @@ main(int argc, char** argv) {
       MakeFileGraph(inputFile, edge_property_name);
 
   BetweennessCentralityPlan plan =
-      BetweennessCentralityPlan::FromAlgorithm(algo);
+      algo == BetweennessCentralityPlan::kBatched
+          ? BetweennessCentralityPlan::Batched(max_batch_mb << 20)
+          : BetweennessCentralityPlan::FromAlgorithm(algo);
 
   BetweennessCentralitySources sources = kBetweennessCentralityAllNodes;
   uint32_t num_sources = pg->num_nodes();
 
-  if (!allSources) {
+  if (epsilon > 0) {
+    sources = BetweennessCentralityAdaptiveSources{epsilon, delta};
+  } else if (!allSources) {
     if (!startNodesFile.getValue().empty()) {
       std::ifstream file(startNodesFile);
       if (!file.good()) {
@@ -143,8 +166,12 @@ main(int argc, char** argv) {
     sources = num_sources;
   }
 
-  std::cout << "Running betweenness-centrality on " << num_sources
-            << " sources\n";
+  if (epsilon > 0) {
+    std::cout << "Running betweenness-centrality on random sources\n";
+  } else {
+    std::cout << "Running betweenness-centrality on " << num_sources
+              << " sources\n";
+  }
   if (auto r = BetweennessCentrality(
           pg.get(), "betweenness_centrality", sources, plan);
       !r) {
@@ -17,7 +17,9 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include <algorithm>
 #include <iostream>
+#include <unordered_set>
 
 #include <katana/analytics/bfs/bfs.h>
 
@@ -82,9 +84,22 @@ static cll::opt<BfsPlan::Algorithm> algo(
         clEnumValN(BfsPlan::kAsynchronous, "Async", "Asynchronous"),
         clEnumValN(
             BfsPlan::kSynchronousDirectOpt, "SyncDO",
-            "Synchronous direction optimization")),
+            "Synchronous direction optimization"),
+        clEnumValN(
+            BfsPlan::kSynchronousDirectOptLazyTranspose, "SyncDOLazy",
+            "Synchronous direction optimization with the transpose built "
+            "in the background"),
+        clEnumValN(
+            BfsPlan::kMultiSource, "MultiSource",
+            "Search from batchSize sources at once; outputs distances")),
     cll::init(BfsPlan::kSynchronousDirectOpt));
 
+static cll::opt<uint32_t> batchSize(
+    "batchSize",
+    cll::desc("Number of sources searched together by MultiSource, a "
+              "multiple of 64 (default value 64)"),
+    cll::init(BfsPlan::kDefaultBatchSize));
+
 std::string
 AlgorithmName(BfsPlan::Algorithm algorithm) {
   switch (algorithm) {
@@ -98,6 +113,10 @@ AlgorithmName(BfsPlan::Algorithm algorithm) {
     return "Sync";
   case BfsPlan::kSynchronousDirectOpt:
     return "SyncDO";
+  case BfsPlan::kSynchronousDirectOptLazyTranspose:
+    return "SyncDOLazy";
+  case BfsPlan::kMultiSource:
+    return "MultiSource";
   default:
     return "Unknown";
   }
@@ -125,6 +144,14 @@ main(int argc, char** argv) {
     plan = BfsPlan::SynchronousDirectOpt(alpha, beta);
     break;
   }
+  case BfsPlan::kSynchronousDirectOptLazyTranspose: {
+    plan = BfsPlan::SynchronousDirectOptLazyTranspose(alpha, beta);
+    break;
+  }
+  case BfsPlan::kMultiSource: {
+    plan = BfsPlan::MultiSource(batchSize);
+    break;
+  }
   default:
     KATANA_LOG_FATAL("Unsupported algorithm: {}", algo.getValue());
   }
@@ -157,17 +184,54 @@ main(int argc, char** argv) {
         startNodes.end(), std::istream_iterator<uint32_t>{str},
         std::istream_iterator<uint32_t>{});
   }
-  uint32_t num_sources = startNodes.size();
-  std::cout << "Running BFS for " << num_sources << " sources\n";
-
   for (auto start_node : startNodes) {
     if (start_node >= pg->topology().num_nodes()) {
       KATANA_LOG_FATAL("failed to set source: {}", start_node);
     }
+  }
+  // Each source's distances go in its own level-N property, so search from
+  // each source once
+  std::unordered_set<uint32_t> seen;
+  auto duplicates = std::remove_if(
+      startNodes.begin(), startNodes.end(),
+      [&](uint32_t start_node) { return !seen.insert(start_node).second; });
+  if (duplicates != startNodes.end()) {
+    KATANA_LOG_WARN(
+        "ignoring {} repeated start nodes",
+        std::distance(duplicates, startNodes.end()));
+    startNodes.erase(duplicates, startNodes.end());
+  }
+  uint32_t num_sources = startNodes.size();
+  std::cout << "Running BFS for " << num_sources << " sources\n";
+
+  // MultiSource computes the distances from every source up front
+  bool multi_source = plan.algorithm() == BfsPlan::kMultiSource;
+  if (multi_source) {
+    std::vector<std::string> props;
+    for (auto start_node : startNodes) {
+      props.emplace_back("level-" + std::to_string(start_node));
+    }
+    if (auto r = MultiSourceBfs(pg.get(), startNodes, props, plan); !r) {
+      KATANA_LOG_FATAL("Failed to run multi-source bfs {}", r.error());
+    }
+  }
 
+  for (auto start_node : startNodes) {
     std::string node_distance_prop = "level-" + std::to_string(start_node);
-    if (auto r = Bfs(pg.get(), start_node, node_distance_prop, plan); !r) {
-      KATANA_LOG_FATAL("Failed to run bfs {}", r.error());
+    if (!multi_source) {
+      LonestarRepeat(
+          "Bfs",
+          [&]() {
+            if (auto r = Bfs(pg.get(), start_node, node_distance_prop, plan);
+                !r) {
+              KATANA_LOG_FATAL("Failed to run bfs {}", r.error());
+            }
+          },
+          [&]() {
+            if (auto r = pg->RemoveNodeProperty(node_distance_prop); !r) {
+              KATANA_LOG_FATAL("Failed to remove bfs output {}", r.error());
+            }
+          });
     }
 
     auto r = pg->GetNodePropertyTyped<uint32_t>(node_distance_prop);
@@ -179,25 +243,39 @@ main(int argc, char** argv) {
     std::cout << "Node " << reportNode << " has distance "
               << results->Value(reportNode) << "\n";
 
-    auto stats_result = BfsStatistics::Compute(pg.get(), node_distance_prop);
-    if (!stats_result) {
-      KATANA_LOG_FATAL("Failed to compute stats {}", stats_result.error());
-    }
-    auto stats = stats_result.value();
-    stats.Print();
-
-    if (!skipVerify) {
-      if (stats.n_reached_nodes < pg->num_nodes()) {
-        KATANA_LOG_WARN(
-            "{} unvisited nodes; this is an error if the graph is strongly "
-            "connected",
-            pg->num_nodes() - stats.n_reached_nodes);
+    if (multi_source) {
+      if (!skipVerify) {
+        if (auto res = MultiSourceBfsAssertValid(
+                pg.get(), start_node, node_distance_prop);
+            res) {
+          std::cout << "Verification successful.\n";
+        } else {
+          KATANA_LOG_FATAL("verification failed: {}", res.error());
+        }
+      }
+    } else {
+      auto stats_result =
+          BfsStatistics::Compute(pg.get(), node_distance_prop);
+      if (!stats_result) {
+        KATANA_LOG_FATAL("Failed to compute stats {}", stats_result.error());
       }
-      if (auto res = BfsAssertValid(pg.get(), start_node, node_distance_prop);
-          res) {
-        std::cout << "Verification successful.\n";
-      } else {
-        KATANA_LOG_FATAL("verification failed: {}", res.error());
+      auto stats = stats_result.value();
+      stats.Print();
+
+      if (!skipVerify) {
+        if (stats.n_reached_nodes < pg->num_nodes()) {
+          KATANA_LOG_WARN(
+              "{} unvisited nodes; this is an error if the graph is strongly "
+              "connected",
+              pg->num_nodes() - stats.n_reached_nodes);
+        }
+        if (auto res =
+                BfsAssertValid(pg.get(), start_node, node_distance_prop);
+            res) {
+          std::cout << "Verification successful.\n";
+        } else {
+          KATANA_LOG_FATAL("verification failed: {}", res.error());
+        }
       }
     }
 
@@ -204,11 +204,21 @@ main(int argc, char** argv) {
     abort();
   }
 
-  auto pg_result = ConnectedComponents(pg.get(), "component", plan);
-  if (!pg_result) {
-    KATANA_LOG_FATAL(
-        "Failed to run ConnectedComponents: {}", pg_result.error());
-  }
+  LonestarRepeat(
+      "ConnectedComponents",
+      [&]() {
+        auto pg_result = ConnectedComponents(pg.get(), "component", plan);
+        if (!pg_result) {
+          KATANA_LOG_FATAL(
+              "Failed to run ConnectedComponents: {}", pg_result.error());
+        }
+      },
+      [&]() {
+        if (auto r = pg->RemoveNodeProperty("component"); !r) {
+          KATANA_LOG_FATAL(
+              "Failed to remove ConnectedComponents output: {}", r.error());
+        }
+      });
 
   auto stats_result =
       ConnectedComponentsStatistics::Compute(pg.get(), "component");
@@ -52,15 +52,18 @@ cll::opt<IndependentSetPlan::Algorithm> algo(
         //        clEnumValN(
         //            IndependentSetPlan::kNondeterministic, "Nondeterministic",
         //            "Non-deterministic, use bulk synchronous worklist"),
-        //        clEnumValN(
-        //            IndependentSetPlan::kDeterministicBase, "DeterministicBase",
-        //            "use deterministic worklist"),
         clEnumValN(
             IndependentSetPlan::kPriority, "Priority",
             "prio algo based on Martin's GPU ECL-MIS algorithm (default)"),
         clEnumValN(
             IndependentSetPlan::kEdgeTiledPriority, "EdgeTiledPriority",
-            "edge-tiled prio algo based on Martin's GPU ECL-MIS algorithm")),
+            "edge-tiled prio algo based on Martin's GPU ECL-MIS algorithm"),
+        clEnumValN(
+            IndependentSetPlan::kLuby, "Luby",
+            "Luby's algorithm with degree-aware priorities"),
+        clEnumValN(
+            IndependentSetPlan::kDeterministic, "Deterministic",
+            "Bulk-synchronous, same set on every run and thread count")),
     cll::init(IndependentSetPlan::kPriority));
 
 }  // namespace
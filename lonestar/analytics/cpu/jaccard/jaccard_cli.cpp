@@ -44,6 +44,19 @@ static cll::opt<unsigned int> report_node(
     "reportNode",
     cll::desc("Node to report the similarity of (default value 1)"),
     cll::init(1));
+static cll::opt<unsigned int> top_k(
+    "topK",
+    cll::desc("Instead of comparing to the base node, find the topK most "
+              "similar nodes of every node (default value 0)"),
+    cll::init(0));
+static cll::opt<double> min_similarity(
+    "minSimilarity",
+    cll::desc("With topK, the smallest similarity to keep (default value 0)"),
+    cll::init(0));
+static cll::opt<bool> min_hash(
+    "minHash",
+    cll::desc("With topK, estimate similarities with MinHash (default false)"),
+    cll::init(false));
 
 using NodeValue = katana::PODProperty<double>;
 
@@ -69,6 +82,31 @@ main(int argc, char** argv) {
   std::cout << "Read " << pg->topology().num_nodes() << " nodes, "
             << pg->topology().num_edges() << " edges\n";
 
+  if (top_k > 0) {
+    using katana::analytics::JaccardSimilarityJoinPlan;
+    auto plan = min_hash
+                    ? JaccardSimilarityJoinPlan::MinHash(top_k, min_similarity)
+                    : JaccardSimilarityJoinPlan::Exact(top_k, min_similarity);
+    auto join_result = katana::analytics::JaccardSimilarityJoin(pg.get(), plan);
+    if (!join_result) {
+      KATANA_LOG_FATAL(
+          "Jaccard similarity join failed: {}", join_result.error());
+    }
+    const auto& pairs = join_result.value();
+    double total_similarity = 0;
+    for (double similarity : pairs.similarities) {
+      total_similarity += similarity;
+    }
+    std::cout << "Number of similar pairs = " << pairs.sources.size() << "\n";
+    if (!pairs.sources.empty()) {
+      std::cout << "Average similarity = "
+                << total_similarity / pairs.sources.size() << "\n";
+    }
+
+    totalTime.stop();
+    return 0;
+  }
+
   if (base_node >= pg->topology().num_nodes() ||
       report_node >= pg->topology().num_nodes()) {
     std::cerr << "failed to set report: " << report_node
@@ -47,8 +47,10 @@ static cll::opt<KCorePlan::Algorithm> algo(
         clEnumValN(
             KCorePlan::kSynchronous, "Synchronous", "Synchronous algorithm"),
         clEnumValN(
-            KCorePlan::kAsynchronous, "Asynchronous",
-            "Asynchronous algorithm")),
+            KCorePlan::kAsynchronous, "Asynchronous", "Asynchronous algorithm"),
+        clEnumValN(
+            KCorePlan::kBucketPeeling, "BucketPeeling",
+            "Bucket peeling algorithm computing all core numbers")),
     cll::init(KCorePlan::kSynchronous));
 
 //! Required k specification for k-core.
@@ -58,6 +60,12 @@ static cll::opt<uint32_t> kCoreNumber(
               "kCoreNumber value (default value 10)"),
     cll::init(10));
 
+static cll::opt<bool> coreNumbers(
+    "coreNumbers",
+    cll::desc("Output the core number of every node instead of whether it is "
+              "in the k-core (default value false)"),
+    cll::init(false));
+
 std::string
 AlgorithmName(KCorePlan::Algorithm algorithm) {
   switch (algorithm) {
@@ -65,6 +73,8 @@ AlgorithmName(KCorePlan::Algorithm algorithm) {
     return "Synchronous";
   case KCorePlan::kAsynchronous:
     return "Asynchronous";
+  case KCorePlan::kBucketPeeling:
+    return "BucketPeeling";
   default:
     return "Unknown";
   }
@@ -102,6 +112,9 @@ main(int argc, char** argv) {
   case KCorePlan::kAsynchronous:
     plan = KCorePlan::Asynchronous();
     break;
+  case KCorePlan::kBucketPeeling:
+    plan = KCorePlan::BucketPeeling();
+    break;
   default:
     KATANA_LOG_FATAL("Invalid algorithm");
   }
@@ -127,8 +140,15 @@ main(int argc, char** argv) {
     }
   }
 
+  if (coreNumbers) {
+    if (auto r = KCoreNumbers(pg.get(), "core-number"); !r) {
+      KATANA_LOG_FATAL("Failed to compute core numbers: {}", r.error());
+    }
+  }
+
   if (output) {
-    auto r = pg->GetNodePropertyTyped<uint32_t>("node-in-core");
+    auto r = pg->GetNodePropertyTyped<uint32_t>(
+        coreNumbers ? "core-number" : "node-in-core");
     if (!r) {
       KATANA_LOG_FATAL("Failed to get node property {}", r.error());
     }
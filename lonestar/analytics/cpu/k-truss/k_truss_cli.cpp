@@ -50,7 +50,10 @@ static cll::opt<KTrussPlan::Algorithm> algo(
             KTrussPlan::kBsp, "Bsp", "Bulk-synchronous parallel (default)"),
         clEnumValN(
             KTrussPlan::kBspCoreThenTruss, "BspCoreThenTruss",
-            "Compute k-1 core and then k-truss")),
+            "Compute k-1 core and then k-truss"),
+        clEnumValN(
+            KTrussPlan::kTrussDecomposition, "TrussDecomposition",
+            "Compute the trussness of every edge and then k-truss")),
     cll::init(KTrussPlan::kBsp));
 
 std::string
@@ -62,6 +65,8 @@ AlgorithmName(KTrussPlan::Algorithm algorithm) {
     return "BspJacobi";
   case KTrussPlan::kBspCoreThenTruss:
     return "BspCoreThenTruss";
+  case KTrussPlan::kTrussDecomposition:
+    return "TrussDecomposition";
   default:
     return "Unknown";
   }
@@ -106,6 +111,9 @@ main(int argc, char** argv) {
   case KTrussPlan::kBspCoreThenTruss:
     plan = KTrussPlan::BspCoreThenTruss();
     break;
+  case KTrussPlan::kTrussDecomposition:
+    plan = KTrussPlan::TrussDecomposition();
+    break;
   default:
     KATANA_LOG_FATAL("Invalid algorithm");
   }
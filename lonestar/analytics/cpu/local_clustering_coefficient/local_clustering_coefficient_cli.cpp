@@ -39,8 +39,13 @@ static cll::opt<LocalClusteringCoefficientPlan::Algorithm> algo(
     cll::values(clEnumValN(
         LocalClusteringCoefficientPlan::kOrderedCountPerThread,
         "orderedCountPerThread",
-        "Ordered Simple Count using PerThreadStorage (default)")),
-    cll::init(LocalClusteringCoefficientPlan::kOrderedCountPerThread));
+        "Ordered Simple Count using PerThreadStorage")),
+    cll::values(clEnumValN(
+        LocalClusteringCoefficientPlan::kOrderedCountHybrid,
+        "orderedCountHybrid",
+        "Ordered Simple Count using per-thread caches and atomics "
+        "(default)")),
+    cll::init(LocalClusteringCoefficientPlan::kOrderedCountHybrid));
 
 static cll::opt<bool> relabel(
     "relabel",
@@ -80,6 +85,9 @@ main(int argc, char** argv) {
     plan =
         LocalClusteringCoefficientPlan::OrderedCountPerThread(relabeling_flag);
     break;
+  case LocalClusteringCoefficientPlan::kOrderedCountHybrid:
+    plan = LocalClusteringCoefficientPlan::OrderedCountHybrid(relabeling_flag);
+    break;
   default:
     std::cerr << "Unknown algo: " << algo << "\n";
   }
@@ -50,6 +50,7 @@ enum Algo {
   sgdByEdges,
   sgdBlockEdge,
   sgdBlockJump,
+  sgdBlockHogwild,
 };
 
 enum Step { bold, bottou, intel, inverse, purdue };
@@ -70,6 +71,9 @@ static cll::opt<Algo> algo(
             Algo::sgdBlockEdge, "sgdBlockEdge", "SGD Edge blocking (default)"),
         clEnumValN(
             Algo::sgdBlockJump, "sgdBlockJump", "SGD using Block jumping "),
+        clEnumValN(
+            Algo::sgdBlockHogwild, "sgdBlockHogwild",
+            "Lock-free SGD on blocks of items and users"),
         clEnumValN(Algo::sgdByItems, "sgdByItems", "Simple SGD on Items"),
         clEnumValN(Algo::sgdByEdges, "sgdByEdges", "Simple SGD on edges")),
     cll::init(Algo::sgdBlockEdge));
@@ -138,7 +142,7 @@ sumSquaredError(Graph& g) {
       katana::iterate(g.begin(), g.begin() + NUM_ITEM_NODES), [&](GNode n) {
         for (auto ii = g.edge_begin(n), ei = g.edge_end(n); ii != ei; ++ii) {
           GNode dst = g.getEdgeDst(ii);
-          LatentValue e = predictionError(
+          LatentValue e = predictionError<latentSizeOf<Graph>>(
               g.getData(n).latentVector, g.getData(dst).latentVector,
               g.getEdgeData(ii));
           error += (e * e);
@@ -304,8 +308,8 @@ executeUntilConverged(const StepFunction& sf, Graph& g, Fn fn) {
     unsigned long millis = curElapsed - lastTime;
     lastTime = curElapsed;
 
-    double gflops = countFlops(g.sizeEdges(), deltaRound, LATENT_VECTOR_SIZE) /
-                    millis / 1e6;
+    double gflops =
+        countFlops(g.sizeEdges(), deltaRound, latentVectorSize) / millis / 1e6;
 
     int curRound = round + deltaRound;
     katana::gPrint(
@@ -340,6 +344,7 @@ executeUntilConverged(const StepFunction& sf, Graph& g, Fn fn) {
  * Divides the Items and users into 2D blocks.
  * Locks each block to work on it.
  */
+template <int LatentSize>
 struct SGDBlockJumpAlgo {
   bool isSgd() const { return true; }
   typedef katana::PaddedLock<true> SpinLock;
@@ -348,13 +353,13 @@ struct SGDBlockJumpAlgo {
   std::string name() const { return "sgdBlockJumpAlgo"; }
 
   struct Node {
-    LatentValue latentVector[LATENT_VECTOR_SIZE];
+    LatentValue latentVector[LatentSize];
   };
 
-  typedef katana::LC_CSR_Graph<Node, EdgeType>
-      //    ::with_numa_alloc<true>::type
-      ::with_no_lockable<true>::type Graph;
-  typedef Graph::GraphNode GNode;
+  typedef typename katana::LC_CSR_Graph<Node, EdgeType>
+      //    ::template with_numa_alloc<true>::type
+      ::template with_no_lockable<true>::type Graph;
+  typedef typename Graph::GraphNode GNode;
 
   void readGraph(Graph& g) { katana::readGraph(g, inputFile); }
 
@@ -397,7 +402,7 @@ struct SGDBlockJumpAlgo {
       Graph* g;
       GetDst() {}
       GetDst(Graph* _g) : g(_g) {}
-      GNode operator()(Graph::edge_iterator ii) const {
+      GNode operator()(typename Graph::edge_iterator ii) const {
         return g->getEdgeDst(ii);
       }
     };
@@ -413,7 +418,8 @@ struct SGDBlockJumpAlgo {
         BlockInfo& si, typename std::enable_if<!Enable>::type* = 0) {
       if (si.updates >= maxUpdates)
         return 0;
-      typedef katana::NoDerefIterator<Graph::edge_iterator> no_deref_iterator;
+      typedef katana::NoDerefIterator<typename Graph::edge_iterator>
+          no_deref_iterator;
       typedef boost::transform_iterator<GetDst, no_deref_iterator>
           edge_dst_iterator;
 
@@ -423,7 +429,7 @@ struct SGDBlockJumpAlgo {
 
       // Set up item iterators
       size_t itemID = 0;
-      Graph::iterator mm = g.begin(), em = g.begin();
+      typename Graph::iterator mm = g.begin(), em = g.begin();
       std::advance(mm, si.itemStart);
       std::advance(em, si.itemEnd);
 
@@ -453,7 +459,7 @@ struct SGDBlockJumpAlgo {
           if (user >= lastUser)
             break;
 
-          LatentValue e = doGradientUpdate(
+          LatentValue e = doGradientUpdate<LatentSize>(
               itemData.latentVector, g.getData(user).latentVector, lambda,
               g.getEdgeData(*ii.base()), stepSize);
           if (errorAccum)
@@ -481,7 +487,7 @@ struct SGDBlockJumpAlgo {
 
       // Set up item iterators
       size_t itemID = 0;
-      Graph::iterator mm = g.begin(), em = g.begin();
+      typename Graph::iterator mm = g.begin(), em = g.begin();
       std::advance(mm, si.itemStart);
       std::advance(em, si.itemEnd);
 
@@ -503,7 +509,7 @@ struct SGDBlockJumpAlgo {
           if (user >= lastUser)
             break;
 
-          LatentValue e = doGradientUpdate(
+          LatentValue e = doGradientUpdate<LatentSize>(
               itemData.latentVector, g.getData(user).latentVector, lambda,
               g.getEdgeData(ii), stepSize);
           if (errorAccum)
@@ -667,11 +673,12 @@ struct SGDBlockJumpAlgo {
  * Simple SGD going over all the destination(users) for a given
  * source(Item)
  */
+template <int LatentSize>
 class SGDItemsAlgo {
   static const bool makeSerializable = false;
 
   struct BasicNode {
-    LatentValue latentVector[LATENT_VECTOR_SIZE];
+    LatentValue latentVector[LatentSize];
   };
 
   using Node = BasicNode;
@@ -706,7 +713,7 @@ private:
           [&](GNode src, auto&) {
             for (auto ii : g.edges(src)) {
               GNode dst = g.getEdgeDst(ii);
-              LatentValue error = doGradientUpdate(
+              LatentValue error = doGradientUpdate<LatentSize>(
                   g.getData(src, katana::MethodFlag::UNPROTECTED).latentVector,
                   g.getData(dst).latentVector, lambda, g.getEdgeData(ii),
                   stepSize);
@@ -743,12 +750,13 @@ public:
  * Simple by-edge grouped by items (only one edge per item on the WL at any
  * time)
  */
+template <int LatentSize>
 class SGDEdgeItem {
   static const bool makeSerializable = false;
 
   struct BasicNode {
     // latent vector to be learned.
-    LatentValue latentVector[LATENT_VECTOR_SIZE];
+    LatentValue latentVector[LatentSize];
     // if a item's update is interrupted, where to start when resuming.
     unsigned int edge_offset;
   };
@@ -796,7 +804,7 @@ private:
             // Take lock on the destination as multiple source may update the
             // same destination.
             auto& dstData = g.getData(g.getEdgeDst(ii));
-            LatentValue error = doGradientUpdate(
+            LatentValue error = doGradientUpdate<LatentSize>(
                 srcData.latentVector, dstData.latentVector, lambda,
                 g.getEdgeData(ii), stepSize);
 
@@ -847,11 +855,12 @@ public:
  * Locks blocks (blocks may share Items or Users) to work on them.
  *
  */
+template <int LatentSize>
 class SGDBlockEdgeAlgo {
   static const bool makeSerializable = false;
 
   struct BasicNode {
-    LatentValue latentVector[LATENT_VECTOR_SIZE];
+    LatentValue latentVector[LatentSize];
   };
 
   using Node = BasicNode;
@@ -886,7 +895,7 @@ private:
           g.end(), itemsPerBlock, usersPerBlock,
           [&](GNode src, GNode dst, edge_iterator edge) {
             const LatentValue stepSize = steps[0];
-            LatentValue error = doGradientUpdate(
+            LatentValue error = doGradientUpdate<LatentSize>(
                 g.getData(src).latentVector, g.getData(dst).latentVector,
                 lambda, g.getEdgeData(edge), stepSize);
             edgesVisited += 1;
@@ -916,26 +925,149 @@ public:
   }
 };
 
+/*
+ * Lock-free (Hogwild) SGD on 2D blocks of items and users. Each task sweeps
+ * a block of items over all the blocks of users, so the latent vectors of a
+ * block stay in cache while its edges are updated. Blocks of items start
+ * their sweeps at different blocks of users, which makes concurrent updates
+ * of the same user rare; updates that do race are not synchronized.
+ */
+template <int LatentSize>
+class SGDBlockHogwildAlgo {
+  struct BasicNode {
+    LatentValue latentVector[LatentSize];
+  };
+
+  using Node = BasicNode;
+
+public:
+  bool isSgd() const { return true; }
+
+  typedef typename katana::LC_CSR_Graph<Node, EdgeType>::template
+      with_no_lockable<true>::type Graph;
+
+  void readGraph(Graph& g) { katana::readGraph(g, inputFile); }
+
+  std::string name() const { return "sgdBlockHogwild"; }
+
+  size_t numItems() const { return NUM_ITEM_NODES; }
+
+private:
+  using edge_iterator = typename Graph::edge_iterator;
+
+  struct Execute {
+    Graph& g;
+    katana::GAccumulator<unsigned>& edgesVisited;
+    // Error of each block of items in its last sweep
+    std::vector<double> blockErrors{};
+
+    void operator()(
+        LatentValue* steps, int, katana::GAccumulator<double>* errorAccum) {
+      const LatentValue stepSize = steps[0];
+      const size_t numUsers = g.size() - NUM_ITEM_NODES;
+      const size_t numItemBlocks =
+          (NUM_ITEM_NODES + itemsPerBlock - 1) / itemsPerBlock;
+      const size_t numUserBlocks = std::max<size_t>(
+          1, (numUsers + usersPerBlock - 1) / usersPerBlock);
+      // Next edge of each item of a block; edges are sorted by user
+      katana::PerThreadStorage<std::vector<edge_iterator>> cursors;
+      blockErrors.resize(numItemBlocks, 0.0);
+
+      katana::do_all(
+          katana::iterate(size_t{0}, numItemBlocks),
+          [&](size_t itemBlock) {
+            size_t itemStart = itemBlock * itemsPerBlock;
+            size_t itemEnd =
+                std::min<size_t>(itemStart + itemsPerBlock, NUM_ITEM_NODES);
+            size_t firstUserBlock = itemBlock % numUserBlocks;
+            size_t firstUser = NUM_ITEM_NODES + firstUserBlock * usersPerBlock;
+
+            std::vector<edge_iterator>& cursor = *cursors.getLocal();
+            cursor.clear();
+            for (size_t item = itemStart; item < itemEnd; ++item) {
+              cursor.emplace_back(std::partition_point(
+                  g.edge_begin(item), g.edge_end(item),
+                  [&](auto e) { return g.getEdgeDst(e) < firstUser; }));
+            }
+
+            size_t visited = 0;
+            double error = 0.0;
+            for (size_t b = 0; b < numUserBlocks; ++b) {
+              size_t userBlock = (firstUserBlock + b) % numUserBlocks;
+              size_t userEnd =
+                  NUM_ITEM_NODES +
+                  std::min<size_t>((userBlock + 1) * usersPerBlock, numUsers);
+              for (size_t item = itemStart; item < itemEnd; ++item) {
+                edge_iterator& ii = cursor[item - itemStart];
+                if (userBlock == 0) {
+                  // Wrapped around to the first users
+                  ii = g.edge_begin(item);
+                }
+                LatentValue* itemLatent = g.getData(item).latentVector;
+                for (auto ei = g.edge_end(item);
+                     ii != ei && g.getEdgeDst(ii) < userEnd; ++ii) {
+                  LatentValue e = doGradientUpdate<LatentSize>(
+                      itemLatent, g.getData(g.getEdgeDst(ii)).latentVector,
+                      lambda, g.getEdgeData(ii), stepSize);
+                  error += e * e;
+                  ++visited;
+                }
+              }
+            }
+
+            edgesVisited += visited;
+            if (errorAccum) {
+              *errorAccum += error - blockErrors[itemBlock];
+              blockErrors[itemBlock] = error;
+            }
+          },
+          katana::steal(), katana::chunk_size<1>(),
+          katana::loopname("sgdBlockHogwild"));
+    }
+  };
+
+public:
+  void operator()(Graph& g, const StepFunction& sf) {
+    verify(g, "sgdBlockHogwild");
+    katana::GAccumulator<unsigned> edgesVisited;
+
+    katana::StatTimer executeTimer("Time");
+    executeTimer.start();
+
+    Execute fn{g, edgesVisited};
+    executeUntilConverged(sf, g, fn);
+
+    executeTimer.stop();
+
+    katana::ReportStatSingle(
+        "sgdBlockHogwild", "EdgesVisited", edgesVisited.reduce());
+  }
+};
+
 /**
  * ALS algorithms
  */
 
 #ifdef HAS_EIGEN
 
+template <int LatentSize>
 struct SimpleALSalgo {
   bool isSgd() const { return false; }
   std::string name() const { return "AlternatingLeastSquares"; }
   struct Node {
-    LatentValue latentVector[LATENT_VECTOR_SIZE];
+    LatentValue latentVector[LatentSize];
   };
 
-  typedef typename katana::LC_CSR_Graph<Node, EdgeType>::with_no_lockable<
-      true>::type Graph;
-  typedef Graph::GraphNode GNode;
+  typedef typename katana::LC_CSR_Graph<Node, EdgeType>::template
+      with_no_lockable<true>::type Graph;
+  typedef typename Graph::GraphNode GNode;
+  // Larger fixed-size matrices do not fit on the stack
+  static constexpr int kEigenSize =
+      LatentSize <= 64 ? LatentSize : Eigen::Dynamic;
   // Column-major access
   typedef Eigen::SparseMatrix<LatentValue> Sp;
-  typedef Eigen::Matrix<LatentValue, LATENT_VECTOR_SIZE, Eigen::Dynamic> MT;
-  typedef Eigen::Matrix<LatentValue, LATENT_VECTOR_SIZE, 1> V;
+  typedef Eigen::Matrix<LatentValue, kEigenSize, Eigen::Dynamic> MT;
+  typedef Eigen::Matrix<LatentValue, kEigenSize, 1> V;
   typedef Eigen::Map<V> MapV;
 
   Sp A;
@@ -947,7 +1079,7 @@ struct SimpleALSalgo {
     // Copy out
     for (GNode n : g) {
       LatentValue* ptr = &g.getData(n).latentVector[0];
-      MapV mapV{ptr};
+      MapV mapV{ptr, LatentSize};
       if (n < NUM_ITEM_NODES) {
         mapV = WT.col(n);
       } else {
@@ -959,7 +1091,7 @@ struct SimpleALSalgo {
   void copyFromGraph(Graph& g, MT& WT, MT& HT) {
     for (GNode n : g) {
       LatentValue* ptr = &g.getData(n).latentVector[0];
-      MapV mapV{ptr};
+      MapV mapV{ptr, LatentSize};
       if (n < NUM_ITEM_NODES) {
         WT.col(n) = mapV;
       } else {
@@ -991,11 +1123,11 @@ struct SimpleALSalgo {
     // squares problems:
     //   (W^T W + lambda I) H^T = W^T A (solving for H^T)
     //   (H^T H + lambda I) W^T = H^T A^T (solving for W^T)
-    MT WT{LATENT_VECTOR_SIZE, NUM_ITEM_NODES};
-    MT HT{LATENT_VECTOR_SIZE, g.size() - NUM_ITEM_NODES};
-    typedef Eigen::Matrix<LatentValue, LATENT_VECTOR_SIZE, LATENT_VECTOR_SIZE>
+    MT WT{LatentSize, NUM_ITEM_NODES};
+    MT HT{LatentSize, g.size() - NUM_ITEM_NODES};
+    typedef Eigen::Matrix<LatentValue, kEigenSize, kEigenSize>
         XTX;
-    typedef Eigen::Matrix<LatentValue, LATENT_VECTOR_SIZE, Eigen::Dynamic> XTSp;
+    typedef Eigen::Matrix<LatentValue, kEigenSize, Eigen::Dynamic> XTSp;
     typedef katana::PerThreadStorage<XTX> PerThrdXTX;
 
     katana::gPrint("ALS::Start initializeA\n");
@@ -1031,14 +1163,15 @@ struct SimpleALSalgo {
           [&](int col, katana::UserContext<int>&) {
             // Compute WTW = W^T * W for sparse A
             XTX& WTW = *xtxs.getLocal();
-            WTW.setConstant(0);
+            WTW.setZero(LatentSize, LatentSize);
             for (Sp::InnerIterator it(A, col); it; ++it)
-              WTW.triangularView<Eigen::Upper>() +=
+              WTW.template triangularView<Eigen::Upper>() +=
                   WT.col(it.row()) * WT.col(it.row()).transpose();
-            for (int i = 0; i < LATENT_VECTOR_SIZE; ++i)
+            for (int i = 0; i < LatentSize; ++i)
               WTW(i, i) += lambda;
-            HT.col(col) =
-                WTW.selfadjointView<Eigen::Upper>().llt().solve(WTA.col(col));
+            HT.col(col) = WTW.template selfadjointView<Eigen::Upper>()
+                              .llt()
+                              .solve(WTA.col(col));
           });
       update1Time.stop();
 
@@ -1054,14 +1187,15 @@ struct SimpleALSalgo {
           [&](int col, katana::UserContext<int>&) {
             // Compute HTH = H^T * H for sparse A
             XTX& HTH = *xtxs.getLocal();
-            HTH.setConstant(0);
+            HTH.setZero(LatentSize, LatentSize);
             for (Sp::InnerIterator it(AT, col); it; ++it)
-              HTH.triangularView<Eigen::Upper>() +=
+              HTH.template triangularView<Eigen::Upper>() +=
                   HT.col(it.row()) * HT.col(it.row()).transpose();
-            for (int i = 0; i < LATENT_VECTOR_SIZE; ++i)
+            for (int i = 0; i < LatentSize; ++i)
               HTH(i, i) += lambda;
-            WT.col(col) =
-                HTH.selfadjointView<Eigen::Upper>().llt().solve(HTAT.col(col));
+            WT.col(col) = HTH.template selfadjointView<Eigen::Upper>()
+                              .llt()
+                              .solve(HTAT.col(col));
           });
       update2Time.stop();
 
@@ -1089,13 +1223,14 @@ struct SimpleALSalgo {
   }
 };
 
+template <int LatentSize>
 struct SyncALSalgo {
   bool isSgd() const { return false; }
 
   std::string name() const { return "SynchronousAlternatingLeastSquares"; }
 
   struct Node {
-    LatentValue latentVector[LATENT_VECTOR_SIZE];
+    LatentValue latentVector[LatentSize];
   };
 
   static const bool NEEDS_LOCKS = false;
@@ -1105,14 +1240,17 @@ struct SyncALSalgo {
       typename BaseGraph::template with_out_of_line_lockable<true>::type,
       typename BaseGraph::template with_no_lockable<true>::type>::type Graph;
   typedef typename Graph::GraphNode GNode;
+  // Larger fixed-size matrices do not fit on the stack
+  static constexpr int kEigenSize =
+      LatentSize <= 64 ? LatentSize : Eigen::Dynamic;
   // Column-major access
   typedef Eigen::SparseMatrix<LatentValue> Sp;
-  typedef Eigen::Matrix<LatentValue, LATENT_VECTOR_SIZE, Eigen::Dynamic> MT;
-  typedef Eigen::Matrix<LatentValue, LATENT_VECTOR_SIZE, 1> V;
+  typedef Eigen::Matrix<LatentValue, kEigenSize, Eigen::Dynamic> MT;
+  typedef Eigen::Matrix<LatentValue, kEigenSize, 1> V;
   typedef Eigen::Map<V> MapV;
-  typedef Eigen::Matrix<LatentValue, LATENT_VECTOR_SIZE, LATENT_VECTOR_SIZE>
+  typedef Eigen::Matrix<LatentValue, kEigenSize, kEigenSize>
       XTX;
-  typedef Eigen::Matrix<LatentValue, LATENT_VECTOR_SIZE, Eigen::Dynamic> XTSp;
+  typedef Eigen::Matrix<LatentValue, kEigenSize, Eigen::Dynamic> XTSp;
 
   typedef katana::PerThreadStorage<XTX> PerThrdXTX;
   typedef katana::PerThreadStorage<V> PerThrdV;
@@ -1126,7 +1264,7 @@ struct SyncALSalgo {
     // Copy out
     for (GNode n : g) {
       LatentValue* ptr = &g.getData(n).latentVector[0];
-      MapV mapV{ptr};
+      MapV mapV{ptr, LatentSize};
       if (n < NUM_ITEM_NODES) {
         mapV = WT.col(n);
       } else {
@@ -1138,7 +1276,7 @@ struct SyncALSalgo {
   void copyFromGraph(Graph& g, MT& WT, MT& HT) {
     for (GNode n : g) {
       LatentValue* ptr = &g.getData(n).latentVector[0];
-      MapV mapV{ptr};
+      MapV mapV{ptr, LatentSize};
       if (n < NUM_ITEM_NODES) {
         WT.col(n) = mapV;
       } else {
@@ -1167,32 +1305,32 @@ struct SyncALSalgo {
     // Compute WTW = W^T * W for sparse A
     V& r = *rhs.getLocal();
     if (col < NUM_ITEM_NODES) {
-      r.setConstant(0);
+      r.setZero(LatentSize);
       // HTAT = HT * AT; r = HTAT.col(col)
       for (Sp::InnerIterator it(AT, col); it; ++it)
         r += it.value() * HT.col(it.row());
       XTX& HTH = *xtxs.getLocal();
-      HTH.setConstant(0);
+      HTH.setZero(LatentSize, LatentSize);
       for (Sp::InnerIterator it(AT, col); it; ++it)
-        HTH.triangularView<Eigen::Upper>() +=
+        HTH.template triangularView<Eigen::Upper>() +=
             HT.col(it.row()) * HT.col(it.row()).transpose();
-      for (int i = 0; i < LATENT_VECTOR_SIZE; ++i)
+      for (int i = 0; i < LatentSize; ++i)
         HTH(i, i) += lambda;
-      WT.col(col) = HTH.selfadjointView<Eigen::Upper>().llt().solve(r);
+      WT.col(col) = HTH.template selfadjointView<Eigen::Upper>().llt().solve(r);
     } else {
       col = col - NUM_ITEM_NODES;
-      r.setConstant(0);
+      r.setZero(LatentSize);
       // WTA = WT * A; x = WTA.col(col)
       for (Sp::InnerIterator it(A, col); it; ++it)
         r += it.value() * WT.col(it.row());
       XTX& WTW = *xtxs.getLocal();
-      WTW.setConstant(0);
+      WTW.setZero(LatentSize, LatentSize);
       for (Sp::InnerIterator it(A, col); it; ++it)
-        WTW.triangularView<Eigen::Upper>() +=
+        WTW.template triangularView<Eigen::Upper>() +=
             WT.col(it.row()) * WT.col(it.row()).transpose();
-      for (int i = 0; i < LATENT_VECTOR_SIZE; ++i)
+      for (int i = 0; i < LatentSize; ++i)
         WTW(i, i) += lambda;
-      HT.col(col) = WTW.selfadjointView<Eigen::Upper>().llt().solve(r);
+      HT.col(col) = WTW.template selfadjointView<Eigen::Upper>().llt().solve(r);
     }
   }
 
@@ -1249,8 +1387,8 @@ struct SyncALSalgo {
     // squares problems:
     //   (W^T W + lambda I) H^T = W^T A (solving for H^T)
     //   (H^T H + lambda I) W^T = H^T A^T (solving for W^T)
-    MT WT{LATENT_VECTOR_SIZE, NUM_ITEM_NODES};
-    MT HT{LATENT_VECTOR_SIZE, g.size() - NUM_ITEM_NODES};
+    MT WT{LatentSize, NUM_ITEM_NODES};
+    MT HT{LatentSize, g.size() - NUM_ITEM_NODES};
 
     initializeA(g);
     copyFromGraph(g, WT, HT);
@@ -1326,7 +1464,7 @@ initializeGraphData(Graph& g) {
   katana::gPrint("initializeGraphData\n");
   katana::StatTimer initTimer("InitializeGraph");
   initTimer.start();
-  double top = 1.0 / std::sqrt(LATENT_VECTOR_SIZE);
+  double top = 1.0 / std::sqrt(static_cast<double>(latentVectorSize));
   katana::PerThreadStorage<std::mt19937> gen;
 
 #if __cplusplus >= 201103L || defined(HAVE_CXX11_UNIFORM_INT_DISTRIBUTION)
@@ -1339,9 +1477,12 @@ initializeGraphData(Graph& g) {
     katana::do_all(katana::iterate(g), [&](typename Graph::GraphNode n) {
       auto& data = g.getData(n);
       auto val = genVal(n);
-      for (int i = 0; i < LATENT_VECTOR_SIZE; i++) {
+      for (unsigned i = 0; i < latentVectorSize; i++) {
         data.latentVector[i] = val;
       }
+      std::fill(
+          data.latentVector + latentVectorSize,
+          data.latentVector + latentSizeOf<Graph>, 0);
     });
   } else {
     katana::do_all(katana::iterate(g), [&](typename Graph::GraphNode n) {
@@ -1351,14 +1492,17 @@ initializeGraphData(Graph& g) {
       // a thread local one
       if (useSameLatentVector) {
         std::mt19937 sameGen;
-        for (int i = 0; i < LATENT_VECTOR_SIZE; i++) {
+        for (unsigned i = 0; i < latentVectorSize; i++) {
           data.latentVector[i] = dist(sameGen);
         }
       } else {
-        for (int i = 0; i < LATENT_VECTOR_SIZE; i++) {
+        for (unsigned i = 0; i < latentVectorSize; i++) {
           data.latentVector[i] = dist(*gen.getLocal());
         }
       }
+      std::fill(
+          data.latentVector + latentVectorSize,
+          data.latentVector + latentSizeOf<Graph>, 0);
     });
   }
 
@@ -1419,7 +1563,7 @@ writeBinaryLatentVectors(Graph& g, const std::string& filename) {
   std::ofstream file(filename);
   for (auto ii = g.begin(), ei = g.end(); ii != ei; ++ii) {
     auto& v = g.getData(*ii).latentVector;
-    for (int i = 0; i < LATENT_VECTOR_SIZE; ++i) {
+    for (unsigned i = 0; i < latentVectorSize; ++i) {
       file.write(reinterpret_cast<char*>(&v[i]), sizeof(v[i]));
     }
   }
@@ -1432,7 +1576,7 @@ writeAsciiLatentVectors(Graph& g, const std::string& filename) {
   std::ofstream file(filename);
   for (auto ii = g.begin(), ei = g.end(); ii != ei; ++ii) {
     auto& v = g.getData(*ii).latentVector;
-    for (int i = 0; i < LATENT_VECTOR_SIZE; ++i) {
+    for (unsigned i = 0; i < latentVectorSize; ++i) {
       file << v[i] << " ";
     }
     file << "\n";
@@ -1465,8 +1609,11 @@ run() {
             << " num ratings: " << g.sizeEdges() << "\n";
 
   std::unique_ptr<StepFunction> sf{newStepFunction()};
-  std::cout << "latent vector size: " << LATENT_VECTOR_SIZE
-            << " algo: " << algo.name() << " lambda: " << lambda;
+  std::cout << "latent vector size: " << latentVectorSize;
+  if (latentSizeOf<typename Algo::Graph> != (int)latentVectorSize) {
+    std::cout << " (padded to " << latentSizeOf<typename Algo::Graph> << ")";
+  }
+  std::cout << " algo: " << algo.name() << " lambda: " << lambda;
 
   if (algo.isSgd()) {
     std::cout << " learning rate: " << learningRate
@@ -1505,6 +1652,48 @@ run() {
   }
 }
 
+/**
+ * Run the provided algorithm for the shortest compiled latent vector length
+ * that holds latentVectorSize entries.
+ *
+ * @param Algo algorithm to run, parameterized by the latent vector length
+ */
+template <template <int> class Algo>
+void
+runWithLatentSize() {
+  const unsigned* size = std::find_if(
+      std::begin(LATENT_VECTOR_SIZES), std::end(LATENT_VECTOR_SIZES),
+      [](unsigned s) { return s >= latentVectorSize; });
+  if (latentVectorSize == 0 || size == std::end(LATENT_VECTOR_SIZES)) {
+    KATANA_DIE(
+        "latent vector size must be between 1 and ",
+        *std::rbegin(LATENT_VECTOR_SIZES));
+  }
+
+  switch (*size) {
+  case 16:
+    run<Algo<16>>();
+    break;
+  case 20:
+    run<Algo<20>>();
+    break;
+  case 32:
+    run<Algo<32>>();
+    break;
+  case 64:
+    run<Algo<64>>();
+    break;
+  case 128:
+    run<Algo<128>>();
+    break;
+  case 256:
+    run<Algo<256>>();
+    break;
+  default:
+    KATANA_DIE("unknown latent vector size");
+  }
+}
+
 int
 main(int argc, char** argv) {
   std::unique_ptr<katana::SharedMemSys> G =
@@ -1516,23 +1705,26 @@ main(int argc, char** argv) {
   switch (algo) {
 #ifdef HAS_EIGEN
   case Algo::syncALS:
-    run<SyncALSalgo>();
+    runWithLatentSize<SyncALSalgo>();
     break;
   case Algo::simpleALS:
-    run<SimpleALSalgo>();
+    runWithLatentSize<SimpleALSalgo>();
     break;
 #endif
   case Algo::sgdByItems:
-    run<SGDItemsAlgo>();
+    runWithLatentSize<SGDItemsAlgo>();
     break;
   case Algo::sgdByEdges:
-    run<SGDEdgeItem>();
+    runWithLatentSize<SGDEdgeItem>();
     break;
   case Algo::sgdBlockEdge:
-    run<SGDBlockEdgeAlgo>();
+    runWithLatentSize<SGDBlockEdgeAlgo>();
     break;
   case Algo::sgdBlockJump:
-    run<SGDBlockJumpAlgo>();
+    runWithLatentSize<SGDBlockJumpAlgo>();
+    break;
+  case Algo::sgdBlockHogwild:
+    runWithLatentSize<SGDBlockHogwildAlgo>();
     break;
   default:
     KATANA_DIE("unknown algorithm");
@@ -22,18 +22,19 @@
 
 #include <cassert>
 #include <string>
+#include <type_traits>
 
 #include <katana/gstl.h>
 
 #include "llvm/Support/CommandLine.h"
 
+#ifdef __AVX512F__
+#include <immintrin.h>
+#endif
+
 typedef float LatentValue;
 typedef float EdgeType;
 
-// Purdue, CSGD: 100; Intel: 20
-// static const int LATENT_VECTOR_SIZE = 100;
-static const int LATENT_VECTOR_SIZE = 20;  // Purdue, CSGD: 100; Intel: 20
-
 /**
  * Common commandline parameters to for matrix completion algorithms
  */
@@ -69,6 +70,14 @@ static cll::opt<float> decayRate(
 static cll::opt<float> lambda(
     "lambda", cll::desc("regularization parameter [lambda]"), cll::init(0.05));
 
+// Purdue, CSGD: 100; Intel: 20
+static cll::opt<unsigned> latentVectorSize(
+    "latentVectorSize",
+    cll::desc("length of the latent vectors; lengths other than 16, 20, 32, "
+              "64, 128 and 256 are padded with zeros to the next of them "
+              "(default 20)"),
+    cll::init(20));
+
 static cll::opt<unsigned> usersPerBlock(
     "usersPerBlock", cll::desc("users per block"), cll::init(2048));
 static cll::opt<unsigned> itemsPerBlock(
@@ -118,40 +127,53 @@ static cll::opt<bool> useDetInit(
               "use deterministic values for latent vector"),
     cll::init(false));
 
+/**
+ * The lengths of latent vector that the algorithms are compiled for. Other
+ * lengths are padded with zeros to the next one: zero entries stay zero
+ * under both SGD and ALS updates, so padding does not change the results.
+ */
+static const unsigned LATENT_VECTOR_SIZES[] = {16, 20, 32, 64, 128, 256};
+
 /**
  * Inner product of 2 vectors.
  *
  * Like std::inner_product but rewritten here to check vectorization
  *
+ * @tparam Size length of the vectors
  * @param first1 Pointer to beginning of vector 1
- * @param last1 Pointer to end of vector 1. Should be exactly LATENT_VECTOR_SIZE
- * away from first1
- * @param first2 Pointer to beginning of vector 2. Should have at least
- * LATENT_VECTOR_SIZE elements from this point.
+ * @param first2 Pointer to beginning of vector 2
  * @param init Initial value to accumulate sum into
  *
  * @returns init + the inner product (i.e. the inner product if init is 0, error
  * if init is -"ground truth"
  */
-template <typename T>
+template <int Size, typename T>
 T
 innerProduct(
-    T* __restrict__ first1, [[maybe_unused]] T* __restrict__ last1,
-    T* __restrict__ first2, T init) {
-  KATANA_LOG_DEBUG_ASSERT(first1 + LATENT_VECTOR_SIZE == last1);
-  for (int i = 0; i < LATENT_VECTOR_SIZE; ++i) {
+    const T* __restrict__ first1, const T* __restrict__ first2, T init) {
+#ifdef __AVX512F__
+  if constexpr (std::is_same_v<T, float> && Size % 16 == 0) {
+    __m512 sum = _mm512_setzero_ps();
+    for (int i = 0; i < Size; i += 16) {
+      sum = _mm512_fmadd_ps(
+          _mm512_loadu_ps(first1 + i), _mm512_loadu_ps(first2 + i), sum);
+    }
+    return init + _mm512_reduce_add_ps(sum);
+  }
+#endif
+  for (int i = 0; i < Size; ++i) {
     init += first1[i] * first2[i];
   }
   return init;
 }
 
-template <typename T>
+template <int Size, typename T>
 T
 predictionError(
-    T* __restrict__ itemLatent, T* __restrict__ userLatent, double actual) {
+    const T* __restrict__ itemLatent, const T* __restrict__ userLatent,
+    double actual) {
   T v = actual;
-  return innerProduct(
-      itemLatent, itemLatent + LATENT_VECTOR_SIZE, userLatent, -v);
+  return innerProduct<Size>(itemLatent, userLatent, -v);
 }
 
 /**
@@ -159,6 +181,7 @@ predictionError(
  *
  * Updates latent vectors to reduce the error from the edge value.
  *
+ * @tparam Size length of the vectors
  * @param itemLatent latent vector of the item
  * @param userLatent latent vector of the user
  * @param lambda learning parameter
@@ -169,7 +192,7 @@ predictionError(
  *
  * @return Error before gradient update
  */
-template <typename T>
+template <int Size, typename T>
 T
 doGradientUpdate(
     T* __restrict__ itemLatent, T* __restrict__ userLatent, double lambda,
@@ -178,11 +201,30 @@ doGradientUpdate(
   T l = lambda;
   T step = stepSize;
   T rating = edgeRating;
-  T error = innerProduct(
-      itemLatent, itemLatent + LATENT_VECTOR_SIZE, userLatent, -rating);
+  T error = innerProduct<Size>(itemLatent, userLatent, -rating);
 
   // Take gradient step to reduce error
-  for (int i = 0; i < LATENT_VECTOR_SIZE; i++) {
+#ifdef __AVX512F__
+  if constexpr (std::is_same_v<T, float> && Size % 16 == 0) {
+    __m512 vl = _mm512_set1_ps(l);
+    __m512 vstep = _mm512_set1_ps(step);
+    __m512 verror = _mm512_set1_ps(error);
+    for (int i = 0; i < Size; i += 16) {
+      __m512 prevItem = _mm512_loadu_ps(itemLatent + i);
+      __m512 prevUser = _mm512_loadu_ps(userLatent + i);
+      __m512 itemGrad =
+          _mm512_fmadd_ps(verror, prevUser, _mm512_mul_ps(vl, prevItem));
+      __m512 userGrad =
+          _mm512_fmadd_ps(verror, prevItem, _mm512_mul_ps(vl, prevUser));
+      _mm512_storeu_ps(
+          itemLatent + i, _mm512_fnmadd_ps(vstep, itemGrad, prevItem));
+      _mm512_storeu_ps(
+          userLatent + i, _mm512_fnmadd_ps(vstep, userGrad, prevUser));
+    }
+    return error;
+  }
+#endif
+  for (int i = 0; i < Size; i++) {
     T prevItem = itemLatent[i];
     T prevUser = userLatent[i];
     itemLatent[i] -= step * (error * prevUser + l * prevItem);
@@ -192,6 +234,13 @@ doGradientUpdate(
   return error;
 }
 
+/**
+ * The length of the latent vectors of the node data of a graph
+ */
+template <typename Graph>
+constexpr int latentSizeOf = std::extent_v<
+    decltype(std::declval<typename Graph::node_data_type>().latentVector)>;
+
 struct StepFunction {
   virtual LatentValue stepSize(int round) const = 0;
   virtual std::string name() const = 0;
@@ -46,10 +46,18 @@ static cll::opt<PagerankPlan::Algorithm> algo(
             PagerankPlan::kPullTopological, "PullTopological",
             "PullTopological"),
         clEnumValN(PagerankPlan::kPullResidual, "PullResidual", "PullResidual"),
+        clEnumValN(
+            PagerankPlan::kPullBlocked, "PullBlocked",
+            "PullTopological with propagation blocking"),
         clEnumValN(PagerankPlan::kPushSynchronous, "PushSync", "PushSync"),
         clEnumValN(PagerankPlan::kPushAsynchronous, "PushAsync", "PushAsync")),
     cll::init(PagerankPlan::kPushAsynchronous));
 
+static cll::opt<bool> bf16Contributions(
+    "bf16Contributions",
+    cll::desc("Store the contributions of PullBlocked as bfloat16"),
+    cll::init(false));
+
 //! Flag that forces user to be aware that they should be passing in a
 //! transposed graph.
 static cll::opt<bool> transposedGraph(
@@ -62,7 +70,8 @@ main(int argc, char** argv) {
       LonestarStart(argc, argv, name, desc, url, &inputFile);
 
   if ((algo == PagerankPlan::kPullResidual ||
-       algo == PagerankPlan::kPullTopological) &&
+       algo == PagerankPlan::kPullTopological ||
+       algo == PagerankPlan::kPullBlocked) &&
       !transposedGraph) {
     KATANA_DIE(
         "This application requires a transposed graph input;"
@@ -85,11 +94,26 @@ main(int argc, char** argv) {
   std::cout << "Read " << pg->topology().num_nodes() << " nodes, "
             << pg->topology().num_edges() << " edges\n";
 
-  PagerankPlan plan{kCPU, algo, tolerance, maxIterations, kAlpha};
-
-  if (auto r = Pagerank(pg.get(), "rank", plan); !r) {
-    KATANA_LOG_FATAL("Failed to run Pagerank {}", r.error());
-  }
+  PagerankPlan plan{
+      kCPU,
+      algo,
+      tolerance,
+      maxIterations,
+      kAlpha,
+      bf16Contributions ? PagerankPlan::kBFloat16 : PagerankPlan::kFloat32};
+
+  LonestarRepeat(
+      "Pagerank",
+      [&]() {
+        if (auto r = Pagerank(pg.get(), "rank", plan); !r) {
+          KATANA_LOG_FATAL("Failed to run Pagerank {}", r.error());
+        }
+      },
+      [&]() {
+        if (auto r = pg->RemoveNodeProperty("rank"); !r) {
+          KATANA_LOG_FATAL("Failed to remove Pagerank output {}", r.error());
+        }
+      });
 
   auto stats_result = PagerankStatistics::Compute(pg.get(), "rank");
   if (!stats_result) {
@@ -17,13 +17,18 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include <atomic>
 #include <deque>
 #include <fstream>
 #include <iostream>
 
 #include "Lonestar/BoilerPlate.h"
+#include "PointsToSet.h"
 #include "SparseBitVector.h"
 #include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/Reduction.h"
+#include "katana/SimpleLock.h"
 #include "llvm/Support/CommandLine.h"
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -39,9 +44,24 @@ const char* desc =
 
 static cll::opt<std::string> inputFile(
     cll::Positional, cll::desc("<input file>"), cll::Required);
+
+enum Algo { Wave, Worklist };
+
+static cll::opt<Algo> algo(
+    "algo", cll::desc("Choose an algorithm:"),
+    cll::values(
+        clEnumVal(
+            Wave,
+            "Wave propagation over hash-consed points-to sets with cycle "
+            "collapsing"),
+        clEnumVal(
+            Worklist,
+            "Worklist propagation over sparse bit vectors (default)")),
+    cll::init(Worklist));
+
 static cll::opt<bool> useSerial(
     "serial",
-    cll::desc("Runs serial version of the algorithm "
+    cll::desc("Runs serial version of the worklist algorithm "
               "(i.e. 1 thread, no katana::for_each) "
               "(default false)"),
     cll::init(false));
@@ -641,6 +661,14 @@ public:
     }
   }
 
+  /**
+   * Run the sanity checks on representatives.
+   */
+  void verify() {
+    checkReprPointsTo();
+    checkReprEdges();
+  }
+
   /**
    * @returns The total number of points to facts in the system.
    */
@@ -771,6 +799,489 @@ public:
   }
 };
 
+/**
+ * Wave propagation points to executor. Each round collapses the strongly
+ * connected components of the copy graph into one representative,
+ * propagates the points-to facts added since the previous round through the
+ * now acyclic graph, then adds the edges implied by the load/store
+ * constraints, until a round adds no edge.
+ *
+ * Points-to sets are hash-consed in a PointsToSetTable, so variables with
+ * equal sets share one copy, and sending a set along an edge is one memoized
+ * union. Propagation is parallel: a representative is processed once all of
+ * its predecessors have been, and sets are updated by compare and swap of
+ * the set pointer. Load/store constraints are processed in parallel and
+ * only look at the part of their pointer's set they have not seen before.
+ *
+ * PEREIRA, Fernando Magno Quintao; BERLIN, Daniel. Wave propagation and deep
+ * propagation for pointer analysis. CGO, 2009.
+ */
+class PTAWave : public PTABase<true> {
+  using SetPtr = const katana::PointsToSet*;
+  using NodeAllocator =
+      katana::FixedSizeAllocator<typename katana::SparseBitVector<true>::Node>;
+
+  katana::PointsToSetTable sets;
+
+  //! sorted outgoing edges of each representative; kept in sorted vectors
+  //! rather than outgoingEdges so that membership tests are a binary search
+  std::vector<std::vector<unsigned>> edges;
+  //! edges added by the load/store constraints, not yet merged into edges
+  std::vector<std::vector<unsigned>> newEdges;
+  katana::NUMAArray<katana::SimpleLock> newEdgeLocks;
+
+  //! points-to set of each representative
+  katana::NUMAArray<std::atomic<SetPtr>> pointsTo;
+  //! part of the points-to set already sent along the outgoing edges
+  std::vector<SetPtr> propagated;
+  //! part of its pointer's points-to set each load/store has handled
+  std::vector<SetPtr> handled;
+  //! representative of each node; always a node that is its own
+  //! representative
+  std::vector<unsigned> repr;
+  //! number of predecessors not yet processed in the current wave
+  katana::NUMAArray<std::atomic<unsigned>> pending;
+
+  /**
+   * Atomically add set to the points-to set of representative dst.
+   */
+  void addTo(unsigned dst, SetPtr set) {
+    SetPtr old = pointsTo[dst].load();
+    SetPtr merged = sets.unify(old, set);
+
+    while (merged != old && !pointsTo[dst].compare_exchange_weak(old, merged)) {
+      merged = sets.unify(old, set);
+    }
+  }
+
+  /**
+   * Make rep the representative of member, giving it member's points-to set
+   * and edges. Since the edges of member did not necessarily see what rep
+   * has already propagated, rep propagates its whole set again.
+   */
+  void merge(unsigned member, unsigned rep) {
+    pointsTo[rep] = sets.unify(pointsTo[rep].load(), pointsTo[member].load());
+    pointsTo[member] = sets.empty();
+    propagated[rep] = sets.empty();
+
+    edges[rep].insert(
+        edges[rep].end(), edges[member].begin(), edges[member].end());
+    edges[member].clear();
+    edges[member].shrink_to_fit();
+
+    repr[member] = rep;
+  }
+
+  /**
+   * Find the strongly connected components of the copy graph between
+   * representatives with an iterative Tarjan search, and collapse each into
+   * its root. Afterwards, every edge goes to a representative.
+   *
+   * @returns number of nodes that got a new representative
+   */
+  size_t collapseCycles() {
+    const unsigned unvisited = 0;
+    std::vector<unsigned> index(numNodes, unvisited);
+    std::vector<unsigned> lowLink(numNodes);
+    std::vector<bool> onStack(numNodes, false);
+    std::vector<unsigned> componentStack;
+    // node and position in its edges
+    std::vector<std::pair<unsigned, size_t>> callStack;
+
+    unsigned nextIndex = 1;
+    size_t numMerged = 0;
+
+    auto visit = [&](unsigned node) {
+      index[node] = lowLink[node] = nextIndex++;
+      componentStack.push_back(node);
+      onStack[node] = true;
+      callStack.emplace_back(node, 0);
+    };
+
+    for (unsigned root = 0; root < numNodes; ++root) {
+      if (repr[root] != root || index[root] != unvisited) {
+        continue;
+      }
+
+      visit(root);
+
+      while (!callStack.empty()) {
+        unsigned node = callStack.back().first;
+        size_t& edge = callStack.back().second;
+
+        if (edge < edges[node].size()) {
+          unsigned dst = repr[edges[node][edge++]];
+
+          if (index[dst] == unvisited) {
+            visit(dst);
+          } else if (onStack[dst]) {
+            lowLink[node] = std::min(lowLink[node], index[dst]);
+          }
+          continue;
+        }
+
+        callStack.pop_back();
+
+        if (!callStack.empty()) {
+          unsigned parent = callStack.back().first;
+          lowLink[parent] = std::min(lowLink[parent], lowLink[node]);
+        }
+
+        if (lowLink[node] == index[node]) {
+          unsigned member;
+
+          do {
+            member = componentStack.back();
+            componentStack.pop_back();
+            onStack[member] = false;
+
+            if (member != node) {
+              katana::gDebug("collapsing ", member, " into ", node);
+              merge(member, node);
+              numMerged++;
+            }
+          } while (member != node);
+        }
+      }
+    }
+
+    // representatives only just merged are one step away from their new
+    // representative, everything else two at most
+    for (unsigned ii = 0; ii < numNodes; ++ii) {
+      repr[ii] = repr[repr[ii]];
+    }
+
+    katana::do_all(
+        katana::iterate(size_t{0}, numNodes),
+        [&](size_t node) {
+          std::vector<unsigned>& nodeEdges = edges[node];
+
+          for (unsigned& dst : nodeEdges) {
+            dst = repr[dst];
+          }
+
+          std::sort(nodeEdges.begin(), nodeEdges.end());
+          nodeEdges.erase(
+              std::unique(nodeEdges.begin(), nodeEdges.end()),
+              nodeEdges.end());
+          // drop the edges that became self loops
+          auto self = std::lower_bound(
+              nodeEdges.begin(), nodeEdges.end(), unsigned(node));
+          if (self != nodeEdges.end() && *self == node) {
+            nodeEdges.erase(self);
+          }
+        },
+        katana::steal(), katana::loopname("PointsToWaveEdges"));
+
+    return numMerged;
+  }
+
+  /**
+   * Send the points-to facts each representative gained since it was last
+   * processed along its outgoing edges, visiting the acyclic graph of
+   * representatives in topological order.
+   */
+  void propagateWave() {
+    katana::do_all(
+        katana::iterate(size_t{0}, numNodes),
+        [&](size_t node) { pending[node].store(0, std::memory_order_relaxed); },
+        katana::loopname("PointsToWaveReset"));
+
+    katana::do_all(
+        katana::iterate(size_t{0}, numNodes),
+        [&](size_t node) {
+          for (unsigned dst : edges[node]) {
+            pending[dst].fetch_add(1, std::memory_order_relaxed);
+          }
+        },
+        katana::steal(), katana::loopname("PointsToWaveCount"));
+
+    katana::InsertBag<unsigned> sources;
+
+    katana::do_all(
+        katana::iterate(size_t{0}, numNodes),
+        [&](size_t node) {
+          if (repr[node] == node && pending[node].load() == 0) {
+            sources.push(node);
+          }
+        },
+        katana::loopname("PointsToWaveSources"));
+
+    katana::for_each(
+        katana::iterate(sources),
+        [&](unsigned node, auto& ctx) {
+          // all predecessors are done, so this set is final for this wave
+          SetPtr current = pointsTo[node].load();
+          SetPtr delta = sets.difference(current, propagated[node]);
+          propagated[node] = current;
+
+          for (unsigned dst : edges[node]) {
+            if (!delta->empty()) {
+              addTo(dst, delta);
+            }
+            if (pending[dst].fetch_sub(1) == 1) {
+              ctx.push(dst);
+            }
+          }
+        },
+        katana::loopname("PointsToWave"), katana::disable_conflict_detection(),
+        katana::wl<katana::PerSocketChunkFIFO<8>>());
+  }
+
+  /**
+   * Adds edges to the graph based on the load/store constraints, looking
+   * only at the pointees added since the constraint was last processed.
+   * Every new edge immediately receives the current points-to set of its
+   * source; what the source gains later is sent by the next wave. New edges
+   * are buffered per source and merged into the sorted edges after the loop.
+   *
+   * @returns true if an edge was added
+   */
+  bool processLoadStore() {
+    katana::GReduceLogicalOr edgeAdded;
+
+    auto addEdge = [&](unsigned src, unsigned dst) {
+      if (src != dst &&
+          !std::binary_search(edges[src].begin(), edges[src].end(), dst)) {
+        addTo(dst, pointsTo[src].load());
+
+        newEdgeLocks[src].lock();
+        newEdges[src].push_back(dst);
+        newEdgeLocks[src].unlock();
+
+        edgeAdded.update(true);
+      }
+    };
+
+    katana::do_all(
+        katana::iterate(size_t{0}, loadStoreConstraints.size()),
+        [&](size_t ii) {
+          const PtsToCons& constraint = loadStoreConstraints[ii];
+
+          unsigned src;
+          unsigned dst;
+          std::tie(src, dst) = constraint.getSrcDst();
+
+          unsigned srcRepr = repr[src];
+          unsigned dstRepr = repr[dst];
+          bool isLoad = constraint.getType() == PtsToCons::Load;
+
+          // a load reads through src, a store writes through dst
+          SetPtr current = pointsTo[isLoad ? srcRepr : dstRepr].load();
+          SetPtr delta = sets.difference(current, handled[ii]);
+          handled[ii] = current;
+
+          delta->forEach([&](unsigned pointee) {
+            if (isLoad) {
+              addEdge(repr[pointee], dstRepr);
+            } else {
+              addEdge(srcRepr, repr[pointee]);
+            }
+          });
+        },
+        katana::steal(), katana::loopname("PointsToLoadStore"));
+
+    if (!edgeAdded.reduce()) {
+      return false;
+    }
+
+    katana::do_all(
+        katana::iterate(size_t{0}, numNodes),
+        [&](size_t node) {
+          std::vector<unsigned>& added = newEdges[node];
+
+          if (added.empty()) {
+            return;
+          }
+
+          // the same edge may have been added by several constraints
+          std::sort(added.begin(), added.end());
+          added.erase(std::unique(added.begin(), added.end()), added.end());
+
+          std::vector<unsigned>& nodeEdges = edges[node];
+          size_t oldSize = nodeEdges.size();
+          nodeEdges.insert(nodeEdges.end(), added.begin(), added.end());
+          std::inplace_merge(
+              nodeEdges.begin(), nodeEdges.begin() + oldSize, nodeEdges.end());
+
+          std::vector<unsigned>().swap(added);
+        },
+        katana::steal(), katana::loopname("PointsToLoadStoreEdges"));
+
+    return true;
+  }
+
+public:
+  /**
+   * Given the number of nodes in the constraint graph, initialize the
+   * structures needed for the points-to algorithm.
+   *
+   * @param n Number of nodes in the constraint graph
+   * @param nodeAllocator galois allocator object to allocate nodes in the
+   * sparse bit vector of the edges
+   */
+  void initialize(size_t n, NodeAllocator& nodeAllocator) {
+    PTABase<true>::initialize(n, nodeAllocator);
+
+    pointsTo.allocateBlocked(numNodes);
+    pending.allocateBlocked(numNodes);
+    edges.resize(numNodes);
+    newEdges.resize(numNodes);
+    newEdgeLocks.allocateBlocked(numNodes);
+    newEdgeLocks.construct();
+    propagated.assign(numNodes, sets.empty());
+    handled.assign(loadStoreConstraints.size(), sets.empty());
+    repr.resize(numNodes);
+
+    katana::do_all(
+        katana::iterate(size_t{0}, numNodes),
+        [&](size_t node) {
+          pointsTo[node].store(sets.empty());
+          repr[node] = node;
+        },
+        katana::loopname("PointsToWaveInit"));
+  }
+
+  /**
+   * Run points-to-analysis with wave propagation.
+   */
+  void run() {
+    katana::gDebug(
+        "no of addr+copy constraints = ", addressCopyConstraints.size(),
+        ", no of load+store constraints = ", loadStoreConstraints.size());
+    katana::gDebug("no of nodes = ", numNodes);
+
+    // initial points-to sets, built one variable at a time from the sorted
+    // AddressOf constraints so that equal sets are interned once
+    std::vector<std::pair<unsigned, unsigned>> addresses;
+
+    for (const PtsToCons& constraint : addressCopyConstraints) {
+      unsigned src;
+      unsigned dst;
+      std::tie(src, dst) = constraint.getSrcDst();
+
+      if (constraint.getType() == PtsToCons::AddressOf) {
+        addresses.emplace_back(dst, src);
+      } else if (src != dst) {
+        // duplicates are removed when the edges are first normalized
+        edges[src].push_back(dst);
+      }
+    }
+
+    std::sort(addresses.begin(), addresses.end());
+
+    for (auto ii = addresses.begin(); ii != addresses.end();) {
+      std::vector<unsigned> pointees;
+      auto jj = ii;
+
+      for (; jj != addresses.end() && jj->first == ii->first; ++jj) {
+        pointees.push_back(jj->second);
+      }
+
+      pointsTo[ii->first] = sets.make(std::move(pointees));
+      ii = jj;
+    }
+
+    size_t numRounds = 0;
+    size_t numCollapsed = 0;
+    bool edgeAdded = true;
+
+    while (edgeAdded) {
+      numCollapsed += collapseCycles();
+      propagateWave();
+      edgeAdded = processLoadStore();
+      numRounds++;
+
+      katana::gDebug(
+          "round ", numRounds, ": ", countPointsToFacts(),
+          " points-to facts, ", sets.size(), " distinct sets");
+
+      // the next round works on new sets, so old results will not be reused
+      sets.clearCaches();
+    }
+
+    katana::ReportStatSingle("PointsToWave", "Rounds", numRounds);
+    katana::ReportStatSingle("PointsToWave", "CollapsedNodes", numCollapsed);
+    katana::ReportStatSingle("PointsToWave", "DistinctSets", sets.size());
+  }
+
+  /**
+   * Checks that the points-to sets satisfy every constraint.
+   */
+  void verify() {
+    katana::GAccumulator<size_t> violations;
+
+    auto subsetEq = [&](unsigned a, unsigned b) {
+      return sets.isSubsetEq(
+          pointsTo[repr[a]].load(), pointsTo[repr[b]].load());
+    };
+
+    katana::do_all(
+        katana::iterate(addressCopyConstraints),
+        [&](const PtsToCons& constraint) {
+          unsigned src;
+          unsigned dst;
+          std::tie(src, dst) = constraint.getSrcDst();
+
+          if (constraint.getType() == PtsToCons::AddressOf
+                  ? !pointsTo[repr[dst]].load()->test(src)
+                  : !subsetEq(src, dst)) {
+            violations += 1;
+          }
+        },
+        katana::loopname("PointsToVerifyAddressOfCopy"));
+
+    katana::do_all(
+        katana::iterate(loadStoreConstraints),
+        [&](const PtsToCons& constraint) {
+          unsigned src;
+          unsigned dst;
+          std::tie(src, dst) = constraint.getSrcDst();
+          bool isLoad = constraint.getType() == PtsToCons::Load;
+
+          pointsTo[repr[isLoad ? src : dst]].load()->forEach(
+              [&](unsigned pointee) {
+                if (isLoad ? !subsetEq(pointee, dst)
+                           : !subsetEq(src, pointee)) {
+                  violations += 1;
+                }
+              });
+        },
+        katana::steal(), katana::loopname("PointsToVerifyLoadStore"));
+
+    if (violations.reduce()) {
+      katana::gError(
+          violations.reduce(), " constraints are not satisfied by the "
+          "points-to sets.");
+    }
+  }
+
+  /**
+   * @returns The total number of points to facts in the system.
+   */
+  size_t countPointsToFacts() {
+    size_t count = 0;
+
+    for (unsigned ii = 0; ii < numNodes; ++ii) {
+      count += pointsTo[repr[ii]].load()->count();
+    }
+
+    return count;
+  }
+
+  /**
+   * Prints out points to info for all verticies in the constraint graph.
+   */
+  void printPointsToInfo() {
+    std::string prefix = "v";
+
+    for (unsigned ii = 0; ii < numNodes; ++ii) {
+      std::cerr << prefix << ii << ": ";
+      pointsTo[repr[ii]].load()->print(std::cerr, prefix);
+    }
+  }
+};
+
 /**
  * Method from running PTA.
  */
@@ -790,8 +1301,7 @@ runPTA(PTAClass& pta, Alloc& nodeAllocator) {
 
   if (!skipVerify) {
     katana::gInfo("Doing verification step");
-    pta.checkReprPointsTo();
-    pta.checkReprEdges();
+    pta.verify();
   }
 
   if (printAnswer) {
@@ -812,7 +1322,16 @@ main(int argc, char** argv) {
 
   // depending on serial or concurrent, create the correct class and pass it
   // into the run harness which takes care of the rest
-  if (!useSerial) {
+  if (!useSerial && algo == Wave) {
+    katana::gInfo(
+        "-------- Wave propagation: ", katana::getActiveThreads(),
+        " threads.");
+
+    PTAWave p;
+    katana::FixedSizeAllocator<typename katana::SparseBitVector<true>::Node>
+        nodeAllocator;
+    runPTA(p, nodeAllocator);
+  } else if (!useSerial) {
     katana::gInfo(
         "-------- Parallel version: ", katana::getActiveThreads(), " threads.");
     katana::gInfo(
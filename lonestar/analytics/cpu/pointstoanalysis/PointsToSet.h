@@ -0,0 +1,404 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#ifndef _KATANA_POINTSTOSET_
+#define _KATANA_POINTSTOSET_
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <katana/SimpleLock.h>
+
+namespace katana {
+
+/**
+ * Immutable sparse set of unsigned integers, stored as a sorted array of
+ * 64-bit words tagged with their base. Sets are only created by a
+ * PointsToSetTable, which keeps exactly one copy of each distinct set, so
+ * equal sets are the same object and can be compared by pointer.
+ */
+class PointsToSet {
+public:
+  using WORD = uint64_t;
+  static const unsigned wordSize = sizeof(WORD) * 8;
+
+  struct Word {
+    unsigned base;
+    WORD bits;
+
+    bool operator==(const Word& other) const {
+      return base == other.base && bits == other.bits;
+    }
+  };
+
+private:
+  friend class PointsToSetTable;
+
+  std::vector<Word> words;
+  size_t hashValue;
+  unsigned numBits;
+
+  explicit PointsToSet(std::vector<Word>&& w) : words(std::move(w)) {
+    hashValue = words.size();
+    numBits = 0;
+
+    for (const Word& word : words) {
+      // boost::hash_combine
+      hashValue ^= std::hash<WORD>()(word.bits ^ ((WORD)word.base << 32)) +
+                   0x9e3779b97f4a7c15ULL + (hashValue << 6) + (hashValue >> 2);
+      numBits += __builtin_popcountll(word.bits);
+    }
+  }
+
+public:
+  /**
+   * @returns true if no bit is set
+   */
+  bool empty() const { return words.empty(); }
+
+  /**
+   * @returns number of bits set in this set
+   */
+  unsigned count() const { return numBits; }
+
+  /**
+   * @param num The bit to test
+   * @returns true if num is in this set
+   */
+  bool test(unsigned num) const {
+    unsigned base = num / wordSize;
+    auto it = std::lower_bound(
+        words.begin(), words.end(), base,
+        [](const Word& word, unsigned b) { return word.base < b; });
+
+    return it != words.end() && it->base == base &&
+           (it->bits & ((WORD)1 << (num % wordSize)));
+  }
+
+  /**
+   * Call fn on every set bit in increasing order.
+   *
+   * @param fn Functor taking the unsigned number of the set bit
+   */
+  template <typename Fn>
+  void forEach(Fn fn) const {
+    for (const Word& word : words) {
+      WORD bits = word.bits;
+
+      while (bits) {
+        fn(word.base * wordSize + __builtin_ctzll(bits));
+        bits &= bits - 1;
+      }
+    }
+  }
+
+  /**
+   * @returns Vector with all set bits
+   */
+  std::vector<unsigned> getAllSetBits() const {
+    std::vector<unsigned> setBits;
+    forEach([&](unsigned bit) { setBits.push_back(bit); });
+    return setBits;
+  }
+
+  /**
+   * Output the bits that are set in this set, in the same format as
+   * SparseBitVector::print.
+   *
+   * @param out Stream to output to
+   * @param prefix A string to append to the set bit numbers
+   */
+  void print(std::ostream& out, std::string prefix = std::string("")) const {
+    out << "Elements(" << count() << "): ";
+
+    forEach([&](unsigned bit) { out << prefix << bit << ", "; });
+
+    out << "\n";
+  }
+};
+
+/**
+ * Thread safe table of hash-consed sets. Every set is interned: building a
+ * set equal to one already in the table returns the existing copy, so
+ * variables with equal points-to sets share memory. Unions and differences
+ * of interned sets are memoized by the pair of operands, which makes
+ * repeated propagation of the same set along many edges cheap.
+ *
+ * Sets are never freed before the table is destroyed; the memoized results
+ * can be dropped with clearCaches.
+ */
+class PointsToSetTable {
+  static const unsigned numShards = 64;
+
+  using SetPair = std::pair<const PointsToSet*, const PointsToSet*>;
+
+  struct ContentHash {
+    size_t operator()(const PointsToSet* set) const { return set->hashValue; }
+  };
+
+  struct ContentEqual {
+    bool operator()(const PointsToSet* a, const PointsToSet* b) const {
+      return a->hashValue == b->hashValue && a->words == b->words;
+    }
+  };
+
+  struct PairHash {
+    size_t operator()(const SetPair& p) const {
+      size_t h = std::hash<const PointsToSet*>()(p.first);
+      return h ^ (std::hash<const PointsToSet*>()(p.second) + 0x9e3779b9 +
+                  (h << 6) + (h >> 2));
+    }
+  };
+
+  struct alignas(64) SetShard {
+    katana::SimpleLock lock;
+    std::unordered_set<const PointsToSet*, ContentHash, ContentEqual> sets;
+  };
+
+  struct alignas(64) CacheShard {
+    katana::SimpleLock lock;
+    std::unordered_map<SetPair, const PointsToSet*, PairHash> results;
+  };
+
+  SetShard setShards[numShards];
+  CacheShard unionShards[numShards];
+  CacheShard differenceShards[numShards];
+
+  const PointsToSet* emptySet;
+
+  static unsigned shardOf(size_t hash) { return (hash >> 7) % numShards; }
+
+  /**
+   * Memoized binary operation on interned sets.
+   */
+  template <typename Op>
+  const PointsToSet* memoize(
+      CacheShard* shards, const PointsToSet* a, const PointsToSet* b, Op op) {
+    SetPair key(a, b);
+    CacheShard& shard = shards[shardOf(PairHash()(key))];
+
+    shard.lock.lock();
+    auto it = shard.results.find(key);
+    const PointsToSet* result =
+        it != shard.results.end() ? it->second : nullptr;
+    shard.lock.unlock();
+
+    if (result) {
+      return result;
+    }
+
+    result = intern(op(a->words, b->words));
+
+    shard.lock.lock();
+    shard.results.emplace(key, result);
+    shard.lock.unlock();
+
+    return result;
+  }
+
+public:
+  using Word = PointsToSet::Word;
+
+  PointsToSetTable() { emptySet = intern(std::vector<Word>()); }
+
+  PointsToSetTable(const PointsToSetTable&) = delete;
+  PointsToSetTable& operator=(const PointsToSetTable&) = delete;
+
+  ~PointsToSetTable() {
+    for (SetShard& shard : setShards) {
+      for (const PointsToSet* set : shard.sets) {
+        delete set;
+      }
+    }
+  }
+
+  /**
+   * @returns the interned empty set
+   */
+  const PointsToSet* empty() const { return emptySet; }
+
+  /**
+   * Intern a set given by its words.
+   *
+   * @param words Words of the set sorted by base, without zero words
+   * @returns The single copy of this set in the table
+   */
+  const PointsToSet* intern(std::vector<Word>&& words) {
+    PointsToSet candidate(std::move(words));
+    SetShard& shard = setShards[shardOf(candidate.hashValue)];
+
+    std::lock_guard<katana::SimpleLock> guard(shard.lock);
+    auto it = shard.sets.find(&candidate);
+
+    if (it != shard.sets.end()) {
+      return *it;
+    }
+
+    const PointsToSet* set = new PointsToSet(std::move(candidate));
+    shard.sets.insert(set);
+    return set;
+  }
+
+  /**
+   * Intern the set of the given numbers.
+   *
+   * @param bits Numbers in the set, in any order and possibly repeated
+   * @returns The single copy of this set in the table
+   */
+  const PointsToSet* make(std::vector<unsigned> bits) {
+    std::sort(bits.begin(), bits.end());
+
+    std::vector<Word> words;
+
+    for (unsigned bit : bits) {
+      unsigned base = bit / PointsToSet::wordSize;
+      PointsToSet::WORD mask = (PointsToSet::WORD)1
+                               << (bit % PointsToSet::wordSize);
+
+      if (words.empty() || words.back().base != base) {
+        words.push_back(Word{base, mask});
+      } else {
+        words.back().bits |= mask;
+      }
+    }
+
+    return intern(std::move(words));
+  }
+
+  /**
+   * @returns The interned union of a and b
+   */
+  const PointsToSet* unify(const PointsToSet* a, const PointsToSet* b) {
+    if (a == b || b->empty()) {
+      return a;
+    }
+    if (a->empty()) {
+      return b;
+    }
+    // union is commutative, so share one cache entry for both orders
+    if (b < a) {
+      std::swap(a, b);
+    }
+
+    return memoize(
+        unionShards, a, b,
+        [](const std::vector<Word>& x, const std::vector<Word>& y) {
+          std::vector<Word> result;
+          result.reserve(std::max(x.size(), y.size()));
+
+          auto xi = x.begin();
+          auto yi = y.begin();
+
+          while (xi != x.end() && yi != y.end()) {
+            if (xi->base < yi->base) {
+              result.push_back(*xi++);
+            } else if (yi->base < xi->base) {
+              result.push_back(*yi++);
+            } else {
+              result.push_back(Word{xi->base, xi->bits | yi->bits});
+              ++xi;
+              ++yi;
+            }
+          }
+
+          result.insert(result.end(), xi, x.end());
+          result.insert(result.end(), yi, y.end());
+          return result;
+        });
+  }
+
+  /**
+   * @returns The interned set of the elements of a that are not in b
+   */
+  const PointsToSet* difference(const PointsToSet* a, const PointsToSet* b) {
+    if (a == b || a->empty()) {
+      return emptySet;
+    }
+    if (b->empty()) {
+      return a;
+    }
+
+    return memoize(
+        differenceShards, a, b,
+        [](const std::vector<Word>& x, const std::vector<Word>& y) {
+          std::vector<Word> result;
+
+          auto yi = y.begin();
+
+          for (const Word& word : x) {
+            while (yi != y.end() && yi->base < word.base) {
+              ++yi;
+            }
+
+            PointsToSet::WORD bits = word.bits;
+
+            if (yi != y.end() && yi->base == word.base) {
+              bits &= ~yi->bits;
+            }
+            if (bits) {
+              result.push_back(Word{word.base, bits});
+            }
+          }
+
+          return result;
+        });
+  }
+
+  /**
+   * @returns true if every element of a is in b
+   */
+  bool isSubsetEq(const PointsToSet* a, const PointsToSet* b) {
+    return difference(a, b)->empty();
+  }
+
+  /**
+   * Drop all memoized unions and differences. Not thread safe.
+   */
+  void clearCaches() {
+    for (unsigned i = 0; i < numShards; ++i) {
+      unionShards[i].results.clear();
+      differenceShards[i].results.clear();
+    }
+  }
+
+  /**
+   * @returns number of distinct sets in the table. Not thread safe.
+   */
+  size_t size() const {
+    size_t numSets = 0;
+
+    for (const SetShard& shard : setShards) {
+      numSets += shard.sets.size();
+    }
+
+    return numSets;
+  }
+};
+
+}  // namespace katana
+
+#endif
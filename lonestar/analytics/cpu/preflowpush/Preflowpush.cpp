@@ -17,6 +17,7 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include <atomic>
 #include <fstream>
 #include <iostream>
 
@@ -26,6 +27,7 @@
 #include "katana/Bag.h"
 #include "katana/Galois.h"
 #include "katana/LCGraph.h"
+#include "katana/NUMAArray.h"
 #include "katana/Reduction.h"
 #include "katana/Timer.h"
 #include "llvm/Support/CommandLine.h"
@@ -54,11 +56,15 @@ static cll::opt<bool> useSymmetricDirectly(
     "useSymmetricDirectly",
     cll::desc("Assume input graph is symmetric and has unit capacities"),
     cll::init(false));
-static cll::opt<int> relabelInt(
+static cll::opt<int64_t> relabelInt(
     "relabel",
-    cll::desc("relabel interval X: relabel every X iterations "
-              "(default 0 uses default interval)"),
+    cll::desc("relabel interval X: relabel globally after X units of work "
+              "(default 0 uses ALPHA * nodes + edges)"),
     cll::init(0));
+static cll::opt<bool> useGap(
+    "useGap",
+    cll::desc("Use the gap relabeling heuristic (non-deterministic only)"),
+    cll::init(true));
 static cll::opt<DetAlgo> detAlgo(
     cll::desc("Deterministic algorithm:"),
     cll::values(
@@ -68,21 +74,23 @@ static cll::opt<DetAlgo> detAlgo(
     cll::init(nondet));
 
 /**
- * Alpha parameter the original Goldberg algorithm to control when global
- * relabeling occurs. For comparison purposes, we keep them the same as
- * before, but it is possible to achieve much better performance by adjusting
- * the global relabel frequency.
+ * Alpha parameter of the Cherkassky-Goldberg heuristic: a global relabel
+ * happens once the work since the last one exceeds ALPHA * nodes + edges.
  */
 static const int ALPHA = 6;
 
 /**
- * Beta parameter the original Goldberg algorithm to control when global
- * relabeling occurs. For comparison purposes, we keep them the same as
- * before, but it is possible to achieve much better performance by adjusting
- * the global relabel frequency.
+ * Beta parameter of the Cherkassky-Goldberg heuristic: the work charged for a
+ * relabel, in addition to the edges it scans.
  */
 static const int BETA = 12;
 
+/**
+ * Work is added to the shared count in batches of at least this much, so
+ * that threads do not contend on it.
+ */
+static const int64_t WORK_BATCH = 1024;
+
 struct Node {
   uint32_t id;
   int64_t excess;
@@ -100,16 +108,24 @@ operator<<(std::ostream& os, const Node& n) {
   return os;
 }
 
-using Graph = katana::LC_CSR_Graph<Node, int32_t>::with_numa_alloc<false>::type;
+using Graph = katana::LC_CSR_Graph<Node, int64_t>::with_numa_alloc<false>::type;
 using GNode = Graph::GraphNode;
-using Counter = katana::GAccumulator<int>;
+using Counter = katana::GAccumulator<int64_t>;
 
 struct PreflowPush {
   Graph graph;
   GNode sink;
   GNode source;
-  int global_relabel_interval;
+  int64_t global_relabel_interval;
   bool should_global_relabel = false;
+  //! Work since the last global relabel, summed over threads
+  std::atomic<int64_t> work{0};
+  //! Number of nodes at each height below graph.size(), for gap relabeling
+  katana::NUMAArray<std::atomic<int>> heightCounts;
+  bool gapEnabled = false;
+  //! Whether a gap lifted a node since the last global relabel
+  std::atomic<bool> gapped{false};
+  katana::GAccumulator<uint64_t> numGaps;
   katana::NUMAArray<Graph::edge_iterator>
       reverseDirectionEdgeIterator;  // ideally should be on the graph as
                                      // graph.getReverseEdgeIterator()
@@ -221,6 +237,21 @@ struct PreflowPush {
     ++minHeight;
 
     Node& node = graph.getData(src, katana::MethodFlag::UNPROTECTED);
+    if (gapEnabled) {
+      // If src was the last node at its height, no node above it can reach
+      // the sink, so src can skip to graph.size(). Other threads may be
+      // relabeling concurrently, so a gap can be spurious; a global relabel
+      // before termination repairs such heights.
+      if (heightCounts[node.height].fetch_sub(1) == 1 &&
+          minHeight > node.height) {
+        minHeight = graph.size();
+        numGaps += 1;
+        gapped.store(true, std::memory_order_relaxed);
+      }
+      if (minHeight < (int)graph.size()) {
+        heightCounts[minHeight].fetch_add(1);
+      }
+    }
     if (minHeight < (int)graph.size()) {
       node.height = minHeight;
       node.current = minEdge;
@@ -229,13 +260,27 @@ struct PreflowPush {
     }
   }
 
+  //! Charge work to the shared count; returns true once a global relabel is
+  //! due
+  bool addWork(Counter& counter, int64_t amount) {
+    int64_t& local = counter.getLocal();
+    local += amount;
+    if (local < WORK_BATCH) {
+      return false;
+    }
+    int64_t total = work.fetch_add(local) + local;
+    local = 0;
+    return global_relabel_interval > 0 && total >= global_relabel_interval;
+  }
+
+  //! Returns the work done: the edges scanned plus BETA for each relabel
   template <typename C>
-  bool discharge(const GNode& src, C& ctx) {
+  int64_t discharge(const GNode& src, C& ctx) {
     Node& node = graph.getData(src, katana::MethodFlag::UNPROTECTED);
-    bool relabeled = false;
+    int64_t work = 0;
 
     if (node.excess == 0 || node.height >= (int)graph.size()) {
-      return false;
+      return work;
     }
 
     while (true) {
@@ -249,6 +294,7 @@ struct PreflowPush {
       std::advance(ii, node.current);
 
       for (; ii != ee; ++ii, ++current) {
+        ++work;
         GNode dst = graph.getEdgeDst(ii);
         int64_t cap = graph.getEdgeData(ii);
         if (cap == 0)  // || current < node.current)
@@ -281,7 +327,7 @@ struct PreflowPush {
         break;
 
       relabel(src);
-      relabeled = true;
+      work += BETA + (ee - graph.edge_begin(src, flag));
 
       if (node.height == (int)graph.size())
         break;
@@ -289,23 +335,20 @@ struct PreflowPush {
       // prevHeight = node.height;
     }
 
-    return relabeled;
+    return work;
   }
 
   template <DetAlgo version>
-  void detDischarge(katana::InsertBag<GNode>& initial, Counter& counter) {
+  void detDischarge(katana::InsertBag<GNode>& initial) {
     typedef katana::Deterministic<> DWL;
 
     auto detIDfn = [this](const GNode& item) -> uint32_t {
       return graph.getData(item, katana::MethodFlag::UNPROTECTED).id;
     };
 
-    const int relabel_interval =
-        global_relabel_interval / katana::getActiveThreads();
-
     auto detBreakFn = [&, this](void) -> bool {
       if (this->global_relabel_interval > 0 &&
-          counter.getLocal() >= relabel_interval) {
+          this->work.load() >= this->global_relabel_interval) {
         this->should_global_relabel = true;
         return true;
       } else {
@@ -328,12 +371,8 @@ struct PreflowPush {
             }
           }
 
-          int increment = 1;
-          if (this->discharge(src, ctx)) {
-            increment += BETA;
-          }
-
-          counter += increment;
+          this->work.fetch_add(
+              this->discharge(src, ctx), std::memory_order_relaxed);
         },
         katana::loopname("detDischarge"), katana::wl<DWL>(),
         katana::per_iter_alloc(), katana::det_id<decltype(detIDfn)>(detIDfn),
@@ -343,23 +382,13 @@ struct PreflowPush {
   template <typename W>
   void nonDetDischarge(
       katana::InsertBag<GNode>& initial, Counter& counter, const W& wl_opt) {
-    // per thread
-    const int relabel_interval =
-        global_relabel_interval / katana::getActiveThreads();
-
     katana::for_each(
         katana::iterate(initial),
-        [&counter, relabel_interval, this](GNode& src, auto& ctx) {
-          int increment = 1;
+        [&counter, this](GNode& src, auto& ctx) {
           this->acquire(src);
-          if (this->discharge(src, ctx)) {
-            increment += BETA;
-          }
-
-          counter += increment;
-          if (this->global_relabel_interval > 0 &&
-              counter.getLocal() >= relabel_interval) {  // local check
-
+          // Triggered by the work of all threads, so that uneven work does
+          // not delay the relabel
+          if (this->addWork(counter, this->discharge(src, ctx))) {
             this->should_global_relabel = true;
             ctx.breakLoop();
             return;
@@ -474,6 +503,29 @@ struct PreflowPush {
             incoming.push_back(src);
         },
         katana::loopname("FindWork"));
+
+    countHeights();
+    work = 0;
+    gapped = false;
+  }
+
+  void countHeights() {
+    if (!gapEnabled) {
+      return;
+    }
+    katana::do_all(
+        katana::iterate(size_t{0}, graph.size()),
+        [&](size_t h) { heightCounts[h] = 0; }, katana::no_stats());
+    katana::do_all(
+        katana::iterate(graph),
+        [&](const GNode& src) {
+          int height =
+              graph.getData(src, katana::MethodFlag::UNPROTECTED).height;
+          if (height < (int)graph.size()) {
+            heightCounts[height].fetch_add(1, std::memory_order_relaxed);
+          }
+        },
+        katana::loopname("CountHeights"));
   }
 
   template <typename C>
@@ -499,6 +551,12 @@ struct PreflowPush {
     typedef katana::PerSocketChunkFIFO<16> Chunk;
     typedef katana::OrderedByIntegerMetric<decltype(obimIndexer), Chunk> OBIM;
 
+    gapEnabled = useGap && detAlgo == nondet;
+    if (gapEnabled) {
+      heightCounts.allocateInterleaved(graph.size());
+      countHeights();
+    }
+
     katana::InsertBag<GNode> initial;
     initializePreflow(initial);
 
@@ -515,10 +573,10 @@ struct PreflowPush {
         }
         break;
       case detBase:
-        detDischarge<detBase>(initial, counter);
+        detDischarge<detBase>(initial);
         break;
       case detDisjoint:
-        detDischarge<detDisjoint>(initial, counter);
+        detDischarge<detDisjoint>(initial);
         break;
       default:
         std::cerr << "Unknown algorithm" << detAlgo << "\n";
@@ -526,7 +584,9 @@ struct PreflowPush {
       }
       T_discharge.stop();
 
-      if (should_global_relabel) {
+      if (should_global_relabel || gapped) {
+        // After gaps, a final global relabel restores any heights lifted by
+        // spurious gaps, and work continues if nodes are still active
         katana::StatTimer T_global_relabel("GlobalRelabelTime");
         T_global_relabel.start();
         initial.clear();
@@ -539,6 +599,10 @@ struct PreflowPush {
         break;
       }
     }
+
+    if (gapEnabled) {
+      katana::ReportStatSingle("PreflowPush", "Gaps", numGaps.reduce());
+    }
   }
 
   template <typename EdgeTy>
@@ -591,8 +655,14 @@ struct PreflowPush {
     }
 
     EdgeTy one = 1;
-    static_assert(sizeof(one) == sizeof(uint32_t), "Unexpected edge data size");
-    one = katana::convert_le32toh(one);
+    static_assert(sizeof(one) == sizeof(uint64_t), "Unexpected edge data size");
+    one = katana::convert_le64toh(one);
+    if (!useUnitCapacity && reader.edgeSize() != sizeof(uint32_t) &&
+        reader.edgeSize() != sizeof(uint64_t)) {
+      KATANA_LOG_FATAL(
+          "capacities must be 32 or 64 bit integers, got {} bytes per edge",
+          reader.edgeSize());
+    }
 
     p.phase2();
     edgeData.create(numEdges);
@@ -605,7 +675,14 @@ struct PreflowPush {
           continue;
         if (!reader.hasNeighbor(rdst, rsrc))
           edgeData.set(p.addNeighbor(rdst, rsrc), 0);
-        EdgeTy cap = useUnitCapacity ? one : reader.getEdgeData<EdgeTy>(jj);
+        EdgeTy cap = one;
+        if (!useUnitCapacity && reader.edgeSize() == sizeof(uint32_t)) {
+          // Widen the little endian 32 bit capacity
+          cap = katana::convert_le64toh(
+              katana::convert_le32toh(reader.getEdgeData<uint32_t>(jj)));
+        } else if (!useUnitCapacity) {
+          cap = reader.getEdgeData<EdgeTy>(jj);
+        }
         edgeData.set(p.addNeighbor(rsrc, rdst), cap);
       }
     }
@@ -635,13 +712,15 @@ struct PreflowPush {
   void initializeGraph(
       std::string inputFile, uint32_t sourceID, uint32_t sinkID) {
     if (useSymmetricDirectly) {
-      katana::readGraph(graph, inputFile);
+      katana::readGraph(graph, inputFile, true);
       for (auto ss : graph)
         for (auto ii : graph.edges(ss))
           graph.getEdgeData(ii) = 1;
     } else {
-      if (inputFile.find(".gr.pfp") != inputFile.size() - strlen(".gr.pfp")) {
-        std::string pfpName = inputFile + ".pfp";
+      // Capacities are 64 bit, so files from the 32 bit version are not reused
+      if (inputFile.find(".gr.pfp64") !=
+          inputFile.size() - strlen(".gr.pfp64")) {
+        std::string pfpName = inputFile + ".pfp64";
         std::ifstream pfpFile(pfpName.c_str());
         if (!pfpFile.good()) {
           katana::gPrint("Writing new input file: ", pfpName, "\n");
@@ -827,7 +906,7 @@ main(int argc, char** argv) {
 
   if (relabelInt == 0) {
     app.global_relabel_interval =
-        app.graph.size() * ALPHA + app.graph.sizeEdges() / 3;
+        int64_t{ALPHA} * app.graph.size() + app.graph.sizeEdges();
   } else {
     app.global_relabel_interval = relabelInt;
   }
@@ -17,6 +17,7 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include <fstream>
 #include <iostream>
 
 #include "Lonestar/BoilerPlate.h"
@@ -69,6 +70,18 @@ static cll::opt<uint32_t> numberOfEdgeTypes(
     "numberOfEdgeTypes", cll::desc("Number of edge types (only for Edge2Vec)"),
     cll::init(1));
 
+static cll::opt<bool> weighted(
+    "weighted",
+    cll::desc(
+        "Pick steps in proportion to the edge weights in the edge property "
+        "(Default: false)"),
+    cll::init(false));
+
+static cll::opt<uint64_t> aliasTableMaxBytes(
+    "aliasTableMaxBytes",
+    cll::desc("Memory for the alias tables of weighted walks"),
+    cll::init(RandomWalksPlan::kDefaultAliasTableMaxBytes));
+
 std::string
 AlgorithmName(RandomWalksPlan::Algorithm algorithm) {
   switch (algorithm) {
@@ -83,15 +96,15 @@ AlgorithmName(RandomWalksPlan::Algorithm algorithm) {
 
 void
 PrintWalks(
-    const std::vector<std::vector<uint32_t>>& walks,
-    const std::string& output_file) {
-  std::ofstream f(output_file);
-
-  for (auto walk : walks) {
-    for (auto node : walk) {
-      f << node << " ";
+    const uint32_t* walks, uint64_t num_walks, uint32_t walk_stride,
+    std::ostream* f) {
+  for (uint64_t i = 0; i < num_walks; ++i) {
+    const uint32_t* walk = walks + i * walk_stride;
+    for (uint32_t j = 0; j < walk_stride && walk[j] != kRandomWalkPadding;
+         ++j) {
+      *f << walk[j] << " ";
     }
-    f << std::endl;
+    *f << "\n";
   }
 }
 
@@ -123,26 +136,45 @@ main(int argc, char** argv) {
   switch (algo) {
   case RandomWalksPlan::kNode2Vec:
     plan = RandomWalksPlan::Node2Vec(
-        walkLength, numberOfWalks, backwardProbability, forwardProbability);
+        walkLength, numberOfWalks, backwardProbability, forwardProbability,
+        aliasTableMaxBytes);
     break;
   case RandomWalksPlan::kEdge2Vec:
     plan = RandomWalksPlan::Edge2Vec(
         walkLength, numberOfWalks, backwardProbability, forwardProbability,
-        maxIterations, numberOfEdgeTypes);
+        maxIterations, numberOfEdgeTypes, aliasTableMaxBytes);
     break;
   default:
     KATANA_LOG_FATAL("Invalid algorithm");
   }
 
-  auto walks_result = RandomWalks(pg.get(), plan);
-  if (!walks_result) {
-    KATANA_LOG_FATAL("Failed to run RandomWalks: {}", walks_result.error());
-  }
-
+  // Walks are written out chunk by chunk as they are generated
+  std::ofstream f;
   if (output) {
     std::string output_file = outputLocation + "/" + outputFile;
     katana::gInfo("Writing random walks to a file: ", output_file);
-    PrintWalks(walks_result.value(), output_file);
+    f.open(output_file);
+  }
+
+  std::string edge_weight_property_name;
+  if (weighted) {
+    if (edge_property_name.empty()) {
+      KATANA_LOG_FATAL("Weighted walks need an edge property");
+    }
+    edge_weight_property_name = edge_property_name;
+  }
+
+  auto walks_result = RandomWalks(
+      pg.get(), edge_weight_property_name,
+      [&](const uint32_t* walks, uint64_t num_walks) -> katana::Result<void> {
+        if (output) {
+          PrintWalks(walks, num_walks, plan.walk_stride(), &f);
+        }
+        return katana::ResultSuccess();
+      },
+      kRandomWalksDefaultChunkSize, plan);
+  if (!walks_result) {
+    KATANA_LOG_FATAL("Failed to run RandomWalks: {}", walks_result.error());
   }
 
   return 0;
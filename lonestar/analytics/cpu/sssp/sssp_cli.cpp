@@ -75,6 +75,12 @@ static cll::opt<SsspPlan::Algorithm> algo(
         clEnumValN(
             SsspPlan::kDeltaStepFusion, "DeltaStepFusion",
             "Delta stepping with barrier and fused buckets"),
+        clEnumValN(
+            SsspPlan::kDeltaStepAdaptive, "DeltaStepAdaptive",
+            "Delta stepping with fused buckets and a self-tuned delta"),
+        clEnumValN(
+            SsspPlan::kMultiQueue, "MultiQueue",
+            "Asynchronous relaxation with a relaxed priority queue"),
         clEnumValN(
             SsspPlan::kSerialDelta, "SerialDelta", "Serial delta stepping"),
         clEnumValN(
@@ -109,6 +115,10 @@ AlgorithmName(SsspPlan::Algorithm algorithm) {
     return "DeltaStepBarrier";
   case SsspPlan::kDeltaStepFusion:
     return "DeltaStepFusion";
+  case SsspPlan::kDeltaStepAdaptive:
+    return "DeltaStepAdaptive";
+  case SsspPlan::kMultiQueue:
+    return "MultiQueue";
   case SsspPlan::kSerialDeltaTile:
     return "SerialDeltaTile";
   case SsspPlan::kSerialDelta:
@@ -213,6 +223,12 @@ main(int argc, char** argv) {
   case SsspPlan::kDeltaStepFusion:
     plan = SsspPlan::DeltaStepFusion(stepShift);
     break;
+  case SsspPlan::kDeltaStepAdaptive:
+    plan = SsspPlan::DeltaStepAdaptive();
+    break;
+  case SsspPlan::kMultiQueue:
+    plan = SsspPlan::MultiQueue();
+    break;
   case SsspPlan::kSerialDeltaTile:
     plan = SsspPlan::SerialDeltaTile(stepShift);
     break;
@@ -244,11 +260,21 @@ main(int argc, char** argv) {
     }
 
     std::string node_distance_prop = "distance-" + std::to_string(startNode);
-    auto pg_result =
-        Sssp(pg.get(), startNode, edge_property_name, node_distance_prop, plan);
-    if (!pg_result) {
-      KATANA_LOG_FATAL("Failed to run SSSP: {}", pg_result.error());
-    }
+    LonestarRepeat(
+        "Sssp",
+        [&]() {
+          auto pg_result = Sssp(
+              pg.get(), startNode, edge_property_name, node_distance_prop,
+              plan);
+          if (!pg_result) {
+            KATANA_LOG_FATAL("Failed to run SSSP: {}", pg_result.error());
+          }
+        },
+        [&]() {
+          if (auto r = pg->RemoveNodeProperty(node_distance_prop); !r) {
+            KATANA_LOG_FATAL("Failed to remove SSSP output: {}", r.error());
+          }
+        });
 
     auto stats_result = SsspStatistics::Compute(pg.get(), node_distance_prop);
     if (!stats_result) {
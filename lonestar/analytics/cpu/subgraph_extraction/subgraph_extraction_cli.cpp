@@ -43,6 +43,17 @@ static cll::opt<std::string> nodesString(
               "''); ignore if "
               "-nodesFile is used"),
     cll::init(""));
+static cll::opt<uint32_t> hops(
+    "hops",
+    cll::desc("If positive, extract the subgraph of the nodes within this "
+              "many out-edges of the given nodes (default value 0)"),
+    cll::init(0));
+static cll::list<std::string> nodeProperties(
+    "nodeProperties", cll::desc("Node properties to copy to the subgraph"),
+    cll::CommaSeparated);
+static cll::list<std::string> edgeProperties(
+    "edgeProperties", cll::desc("Edge properties to copy to the subgraph"),
+    cll::CommaSeparated);
 static cll::opt<SubGraphExtractionPlan::Algorithm> algo(
     "algo", cll::desc("Choose an algorithm:"),
     cll::values(clEnumValN(
@@ -80,12 +91,25 @@ main(int argc, char** argv) {
         node_vec.end(), std::istream_iterator<uint64_t>{str},
         std::istream_iterator<uint64_t>{});
   }
+  if (hops > 0) {
+    auto neighborhood_result = KHopNeighborhood(pg.get(), node_vec, hops);
+    if (!neighborhood_result) {
+      KATANA_LOG_FATAL(
+          "Failed to find neighborhood: {}", neighborhood_result.error());
+    }
+    node_vec = std::move(neighborhood_result.value());
+  }
   uint64_t num_nodes = node_vec.size();
   std::cout << "Extracting subgraph with " << num_nodes << " num nodes\n";
   std::cout << "INFO: This is extracting the topology containing nodes from "
                "the user defined node set.\n";
 
-  auto subgraph_result = SubGraphExtraction(pg.get(), node_vec, plan);
+  std::vector<std::string> node_properties(
+      nodeProperties.begin(), nodeProperties.end());
+  std::vector<std::string> edge_properties(
+      edgeProperties.begin(), edgeProperties.end());
+  auto subgraph_result = SubGraphExtraction(
+      pg.get(), node_vec, node_properties, edge_properties, plan);
   if (!subgraph_result) {
     KATANA_LOG_FATAL("Failed to run algorithm: {}", subgraph_result.error());
   }
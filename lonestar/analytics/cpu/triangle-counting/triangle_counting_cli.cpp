@@ -40,7 +40,10 @@ static cll::opt<TriangleCountPlan::Algorithm> algo(
             TriangleCountPlan::kEdgeIteration, "edgeiterator", "Edge Iterator"),
         clEnumValN(
             TriangleCountPlan::kOrderedCount, "orderedCount",
-            "Ordered Simple Count (default)")),
+            "Ordered Simple Count (default)"),
+        clEnumValN(
+            TriangleCountPlan::kWedgeSampling, "wedgeSampling",
+            "Estimate from sampled wedges")),
     cll::init(TriangleCountPlan::kOrderedCount));
 
 static cll::opt<bool> relabel(
@@ -48,6 +51,19 @@ static cll::opt<bool> relabel(
     cll::desc("Relabel nodes of the graph (default value of false => "
               "choose automatically)"),
     cll::init(false));
+
+static cll::opt<uint64_t> numSamples(
+    "numSamples",
+    cll::desc("Number of wedges to sample for wedgeSampling (default value "
+              "2^20)"),
+    cll::init(TriangleCountPlan::kDefaultNumSamples));
+
+static cll::opt<uint32_t> timeBudgetMs(
+    "timeBudgetMs",
+    cll::desc("Stop sampling after this many milliseconds for wedgeSampling "
+              "(default value 0 => no limit)"),
+    cll::init(TriangleCountPlan::kDefaultTimeBudgetMs));
+
 int
 main(int argc, char** argv) {
   std::unique_ptr<katana::SharedMemSys> G =
@@ -85,10 +101,24 @@ main(int argc, char** argv) {
     plan = TriangleCountPlan::OrderedCount(relabeling_flag);
     break;
 
+  case TriangleCountPlan::kWedgeSampling:
+    plan = TriangleCountPlan::WedgeSampling(numSamples, timeBudgetMs);
+    break;
+
   default:
     std::cerr << "Unknown algo: " << algo << "\n";
   }
 
+  if (algo == TriangleCountPlan::kWedgeSampling) {
+    auto estimate_result = TriangleCountApproximate(pg.get(), plan);
+    if (!estimate_result) {
+      KATANA_LOG_FATAL("failed to run algorithm: {}", estimate_result.error());
+    }
+    estimate_result.value().Print();
+    totalTime.stop();
+    return 0;
+  }
+
   auto num_triangles_result = TriangleCount(pg.get(), plan);
   if (!num_triangles_result) {
     KATANA_LOG_FATAL(
@@ -20,6 +20,9 @@
 #ifndef LONESTAR_BOILERPLATE_H
 #define LONESTAR_BOILERPLATE_H
 
+#include <functional>
+#include <string>
+
 #include "Lonestar/Utils.h"
 #include "katana/Galois.h"
 #include "katana/SharedMemSys.h"
@@ -39,10 +42,24 @@ extern llvm::cl::opt<std::string> edge_property_name;
 //! Where to write output if output is set
 extern llvm::cl::opt<std::string> outputLocation;
 extern llvm::cl::opt<bool> output;
+//! Benchmark runs: untimed warm-up runs, then timed runs
+extern llvm::cl::opt<unsigned> warmupRuns;
+extern llvm::cl::opt<unsigned> repeatRuns;
+//! Drop the page cache before every run but the first
+extern llvm::cl::opt<bool> dropPageCache;
 
 //! initialize lonestar benchmark
 std::unique_ptr<katana::SharedMemSys> LonestarStart(
     int argc, char** argv, const char* app, const char* desc, const char* url,
     llvm::cl::opt<std::string>* input);
 std::unique_ptr<katana::SharedMemSys> LonestarStart(int argc, char** argv);
+
+//! Run \p run -warmupRuns times and then -repeatRuns times, timing the
+//! latter, and report the minimum, median and 95th percentile times of
+//! region. Before every run but the first, \p reset, if given, undoes the
+//! previous run, e.g., removes its output property, and the page cache is
+//! dropped if -dropPageCache is set.
+void LonestarRepeat(
+    const std::string& region, const std::function<void()>& run,
+    const std::function<void()>& reset = nullptr);
 #endif
@@ -19,8 +19,17 @@
 
 #include "Lonestar/BoilerPlate.h"
 
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
 #include <sstream>
+#include <vector>
 
+#include "katana/Logging.h"
 #include "katana/SharedMemSys.h"
 
 //! standard global options to the benchmarks
@@ -56,6 +65,118 @@ llvm::cl::opt<bool> output(
     "output", llvm::cl::desc("Write result (default false)"),
     llvm::cl::init(false));
 
+llvm::cl::opt<unsigned> warmupRuns(
+    "warmupRuns",
+    llvm::cl::desc("Number of untimed runs before the timed ones of "
+                   "benchmarked regions (default value 0)"),
+    llvm::cl::init(0));
+
+llvm::cl::opt<unsigned> repeatRuns(
+    "repeatRuns",
+    llvm::cl::desc("Number of timed runs of benchmarked regions; their "
+                   "minimum, median and 95th percentile times are reported "
+                   "(default value 1)"),
+    llvm::cl::init(1));
+
+llvm::cl::opt<bool> dropPageCache(
+    "dropPageCache",
+    llvm::cl::desc("Drop the page cache before every run of benchmarked "
+                   "regions but the first; needs root (default false)"),
+    llvm::cl::init(false));
+
+namespace {
+
+enum class PinThreads { kWorkers, kAll, kNone };
+
+enum class HugePages { kHugeTLB, kTransparent, kNone };
+
+enum class NumaPlacement { kBorrowed, kInterleaved, kBlocked };
+
+llvm::cl::opt<PinThreads> pinThreads(
+    "pinThreads",
+    llvm::cl::desc("Which threads to bind to hardware threads "
+                   "(default value workers):"),
+    llvm::cl::values(
+        clEnumValN(PinThreads::kWorkers, "workers", "All but the main thread"),
+        clEnumValN(PinThreads::kAll, "all", "All threads"),
+        clEnumValN(PinThreads::kNone, "none", "No threads")),
+    llvm::cl::init(PinThreads::kWorkers));
+
+llvm::cl::opt<HugePages> hugePages(
+    "hugePages",
+    llvm::cl::desc("Page sizes for the runtime's memory "
+                   "(default value hugetlb):"),
+    llvm::cl::values(
+        clEnumValN(
+            HugePages::kHugeTLB, "hugetlb",
+            "Reserved huge pages, then transparent huge pages"),
+        clEnumValN(
+            HugePages::kTransparent, "transparent", "Transparent huge pages"),
+        clEnumValN(HugePages::kNone, "none", "Regular pages")),
+    llvm::cl::init(HugePages::kHugeTLB));
+
+llvm::cl::opt<NumaPlacement> numaPlacement(
+    "numaPlacement",
+    llvm::cl::desc("NUMA placement of the graph topology "
+                   "(default value borrowed):"),
+    llvm::cl::values(
+        clEnumValN(
+            NumaPlacement::kBorrowed, "borrowed",
+            "Read the mapped file where the kernel placed it"),
+        clEnumValN(
+            NumaPlacement::kInterleaved, "interleaved",
+            "Copy, interleaved across NUMA nodes"),
+        clEnumValN(
+            NumaPlacement::kBlocked, "blocked",
+            "Copy, each thread's block on its NUMA node")),
+    llvm::cl::init(NumaPlacement::kBorrowed));
+
+/// Pass the options read by the runtime as it starts to it through the
+/// environment; options left at their defaults keep the environment's
+/// settings
+void
+SetRuntimeEnv() {
+  if (pinThreads.getNumOccurrences()) {
+    unsetenv("KATANA_DO_NOT_BIND_THREADS");
+    unsetenv("KATANA_BIND_MAIN_THREAD");
+    if (pinThreads == PinThreads::kNone) {
+      setenv("KATANA_DO_NOT_BIND_THREADS", "1", 1);
+    } else if (pinThreads == PinThreads::kAll) {
+      setenv("KATANA_BIND_MAIN_THREAD", "1", 1);
+    }
+  }
+  if (hugePages.getNumOccurrences()) {
+    const char* names[] = {"hugetlb", "transparent", "none"};
+    setenv(
+        "KATANA_HUGE_PAGES", names[static_cast<int>(hugePages.getValue())], 1);
+  }
+  if (numaPlacement.getNumOccurrences()) {
+    const char* names[] = {"borrowed", "interleaved", "blocked"};
+    setenv(
+        "KATANA_TOPOLOGY_PLACEMENT",
+        names[static_cast<int>(numaPlacement.getValue())], 1);
+  }
+}
+
+void
+DropPageCache() {
+  sync();
+  std::ofstream drop_caches("/proc/sys/vm/drop_caches");
+  drop_caches << "1" << std::flush;
+  if (!drop_caches) {
+    KATANA_WARN_ONCE("cannot drop the page cache; -dropPageCache needs root");
+  }
+}
+
+/// The p-th percentile of sorted by the nearest-rank method
+double
+Percentile(const std::vector<double>& sorted, double p) {
+  size_t rank = static_cast<size_t>(std::ceil(p / 100 * sorted.size()));
+  return sorted[std::max<size_t>(rank, 1) - 1];
+}
+
+}  // namespace
+
 static void
 LonestarPrintVersion(llvm::raw_ostream& out) {
   out << "LoneStar Benchmark Suite v" << katana::getVersion() << " ("
@@ -76,6 +197,7 @@ LonestarStart(
     llvm::cl::opt<std::string>* input) {
   llvm::cl::SetVersionPrinter(LonestarPrintVersion);
   llvm::cl::ParseCommandLineOptions(argc, argv);
+  SetRuntimeEnv();
 
   auto shared_mem_sys = std::make_unique<katana::SharedMemSys>();
 
@@ -116,5 +238,46 @@ LonestarStart(
   char name[256];
   gethostname(name, 256);
   katana::ReportParam("(NULL)", "Hostname", name);
+  katana::ReportParam("(NULL)", "WarmupRuns", warmupRuns);
+  katana::ReportParam("(NULL)", "RepeatRuns", repeatRuns);
   return shared_mem_sys;
 }
+
+void
+LonestarRepeat(
+    const std::string& region, const std::function<void()>& run,
+    const std::function<void()>& reset) {
+  unsigned timed_runs = std::max(repeatRuns.getValue(), 1U);
+  std::vector<double> times_ms;
+  for (unsigned i = 0; i < warmupRuns + timed_runs; ++i) {
+    if (i > 0) {
+      if (reset) {
+        reset();
+      }
+      if (dropPageCache) {
+        DropPageCache();
+      }
+    }
+    auto start = std::chrono::steady_clock::now();
+    run();
+    std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start;
+    if (i >= warmupRuns) {
+      times_ms.emplace_back(elapsed.count());
+    }
+  }
+
+  std::sort(times_ms.begin(), times_ms.end());
+  double min = times_ms.front();
+  double median = Percentile(times_ms, 50);
+  double p95 = Percentile(times_ms, 95);
+  katana::ReportStatSingle(region, "Runs", times_ms.size());
+  katana::ReportStatSingle(region, "TimeMinMs", min);
+  katana::ReportStatSingle(region, "TimeMedianMs", median);
+  katana::ReportStatSingle(region, "TimeP95Ms", p95);
+  if (times_ms.size() > 1) {
+    llvm::outs() << region << ": " << times_ms.size() << " runs, min " << min
+                 << " ms, median " << median << " ms, p95 " << p95 << " ms\n";
+    llvm::outs().flush();
+  }
+}
@@ -0,0 +1,83 @@
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <string>
+
+#include <boost/filesystem.hpp>
+
+#include "Lonestar/BoilerPlate.h"
+#include "katana/JSON.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/URI.h"
+
+namespace {
+
+constexpr unsigned kWarmupRuns = 2;
+constexpr unsigned kRepeatRuns = 3;
+
+/// The total of the statistic of region and category in stats, the JSON
+/// array a stat file ending in .json holds
+std::optional<nlohmann::json>
+FindStat(
+    const nlohmann::json& stats, const std::string& region,
+    const std::string& category) {
+  for (const auto& stat : stats) {
+    if (stat.at("region") == region && stat.at("category") == category) {
+      return stat.at("total");
+    }
+  }
+  return std::nullopt;
+}
+
+}  // namespace
+
+int
+main() {
+  auto uri_res = katana::Uri::MakeRand("/tmp/lonestar-repeat");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string stat_file = uri_res.value().path() + ".json";
+
+  unsigned runs = 0;
+  unsigned resets = 0;
+  {
+    // Stats are written when the runtime shuts down
+    katana::SharedMemSys sys;
+    katana::SetStatFile(stat_file);
+    warmupRuns = kWarmupRuns;
+    repeatRuns = kRepeatRuns;
+    LonestarRepeat("Repeat", [&]() { ++runs; }, [&]() { ++resets; });
+  }
+  // Every run but the first is reset
+  KATANA_LOG_ASSERT(runs == kWarmupRuns + kRepeatRuns);
+  KATANA_LOG_ASSERT(resets == runs - 1);
+
+  std::ifstream in(stat_file);
+  KATANA_LOG_VASSERT(in, "no stat file {}", stat_file);
+  std::string contents(
+      (std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  in.close();
+  boost::filesystem::remove(stat_file);
+
+  auto parse_res = katana::JsonParse<nlohmann::json>(contents);
+  KATANA_LOG_VASSERT(parse_res, "parsing stats: {}", parse_res.error());
+  const nlohmann::json& stats = parse_res.value();
+  KATANA_LOG_ASSERT(stats.is_array());
+
+  // Only the timed runs count
+  auto num_runs = FindStat(stats, "Repeat", "Runs");
+  KATANA_LOG_ASSERT(num_runs);
+  KATANA_LOG_VASSERT(
+      *num_runs == kRepeatRuns, "{} runs reported, expected {}",
+      num_runs->dump(), kRepeatRuns);
+
+  auto min = FindStat(stats, "Repeat", "TimeMinMs");
+  auto median = FindStat(stats, "Repeat", "TimeMedianMs");
+  auto p95 = FindStat(stats, "Repeat", "TimeP95Ms");
+  KATANA_LOG_ASSERT(min && median && p95);
+  KATANA_LOG_ASSERT(min->get<double>() >= 0);
+  KATANA_LOG_ASSERT(min->get<double>() <= median->get<double>());
+  KATANA_LOG_ASSERT(median->get<double>() <= p95->get<double>());
+
+  return 0;
+}
@@ -6,7 +6,7 @@ from metagraph.plugins.core.types import Graph, Vector
 from metagraph.plugins.networkx.types import NetworkXGraph
 from metagraph.plugins.numpy.types import NumpyNodeMap, NumpyVectorType
 
-from katana.local.analytics import bfs, jaccard, local_clustering_coefficient
+from katana.local.analytics import bfs, jaccard, local_clustering_coefficient, triangle_count
 
 from .types import KatanaGraph
 
@@ -37,18 +37,26 @@ def kg_bfs_iter(graph: KatanaGraph, source_node: NodeID, depth_limit: int) -> Nu
     start_node = source_node
     if not has_node_prop(graph.value, bfs_prop_name):
         bfs(graph.value, start_node, bfs_prop_name)
-    pg_bfs_list = graph.value.get_node_property(bfs_prop_name).to_pandas().values.tolist()
-    new_list = [[i, pg_bfs_list[i]] for i in range(len(pg_bfs_list)) if pg_bfs_list[i] < depth_limit_internal]
-    sorted_list = sorted(new_list, key=lambda each: (each[1], each[0]))
-    bfs_arr = np.array([each[0] for each in sorted_list])
+    # order the reached nodes by level and then by id without leaving numpy
+    levels = graph.value.get_node_property(bfs_prop_name).to_numpy()
+    reached = np.nonzero(levels < depth_limit_internal)[0]
+    bfs_arr = reached[np.argsort(levels[reached], kind="stable")]
     return bfs_arr
 
+
+@concrete_algorithm("clustering.triangle_count")
+def triangle_count_kg(graph: KatanaGraph) -> int:
+    """
+    Count the triangles with Katana directly, so that undirected Katana graphs are not translated to NetworkX first.
+    """
+    return triangle_count(graph.value)
+
+
 # TODO(pengfei):
 # single-source shortest path
 # connected components
 # PageRank
 # betweenness centrality
-# triangle counting
 # Louvain community detection
 # subgraph extraction
 # community detection using label propagation\
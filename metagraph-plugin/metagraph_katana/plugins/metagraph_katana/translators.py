@@ -1,11 +1,10 @@
-from collections import OrderedDict
-
 import metagraph as mg
 import networkx as nx
 import numpy as np
 import pyarrow
 from metagraph import translator
 from metagraph.plugins.networkx.types import NetworkXGraph
+from metagraph.plugins.scipy.types import ScipyGraph
 from scipy.sparse import csr_matrix
 
 from katana.local.import_data import from_csr
@@ -13,65 +12,92 @@ from katana.local.import_data import from_csr
 from .types import KatanaGraph
 
 
-@translator
-def networkx_to_katanagraph(x: NetworkXGraph, **props) -> KatanaGraph:
-    aprops = NetworkXGraph.Type.compute_abstract_properties(x, {"node_dtype", "node_type", "edge_type", "is_directed"})
-    is_weighted = aprops["edge_type"] == "map"
-    # get the edge list directly from the NetworkX Graph
-    elist_raw = list(x.value.edges(data=True))
-    # sort the eddge list and node list
-    if aprops["is_directed"]:
-        elist = sorted(elist_raw, key=lambda each: (each[0], each[1]))
+def _katana_csr(x: KatanaGraph):
+    """
+    Return ``(indptr, indices, weights)`` of the topology of `x` in SciPy's CSR form. The indices and the weights share
+    memory with the graph; only the index of length ``num_nodes + 1`` is copied to prepend a zero.
+    """
+    pg = x.value
+    indptr = np.concatenate(([0], pg.adj_indices())).astype(np.int64, copy=False)
+    indices = pg.edge_dests()
+    # Reinterpret instead of converting, since SciPy does not take unsigned indices
+    indices = indices.view(np.int32) if pg.num_nodes() <= np.iinfo(np.int32).max else indices.astype(np.int64)
+    if x.is_weighted:
+        weights = pg.get_edge_property(x.edge_weight_prop_name).to_numpy()
     else:
-        inv_elist = [(each[1], each[0], each[2]) for each in elist_raw]
-        elist = sorted(elist_raw + inv_elist, key=lambda each: (each[0], each[1]))
-    nlist = sorted(list(x.value.nodes(data=True)), key=lambda each: each[0])
-    # build the CSR format from the edge list (weight, (src, dst))
-    row = np.array([each_edge[0] for each_edge in elist])
-    col = np.array([each_edge[1] for each_edge in elist])
-    data = np.array([each_edge[2]["weight"] for each_edge in elist])
-    csr = csr_matrix((data, (row, col)), shape=(len(nlist), len(nlist)))
+        weights = np.ones(pg.num_edges(), dtype=bool)
+    return indptr, indices, weights
+
+
+def _katanagraph_from_csr(matrix: csr_matrix, is_weighted, is_directed) -> KatanaGraph:
+    matrix.sort_indices()
     # call the katana api to build a Graph (unweighted) from the CSR format
     # noting that the first 0 in csr.indptr is excluded
-    pg = from_csr(csr.indptr[1:], csr.indices)
+    pg = from_csr(matrix.indptr[1:], matrix.indices)
     # add the edge weight as a new property
-    t = pyarrow.table(dict(value_from_translator=data))
-    pg.add_edge_property(t)
+    pg.add_edge_property(pyarrow.table(dict(value_from_translator=matrix.data)))
     # use the metagraph's Graph warpper to wrap the katana.local.Graph
     return KatanaGraph(
         pg_graph=pg,
         is_weighted=is_weighted,
         edge_weight_prop_name="value_from_translator",
-        is_directed=aprops["is_directed"],
+        is_directed=is_directed,
         node_weight_index=0,
     )
 
 
+@translator
+def networkx_to_katanagraph(x: NetworkXGraph, **props) -> KatanaGraph:
+    aprops = NetworkXGraph.Type.compute_abstract_properties(x, {"node_dtype", "node_type", "edge_type", "is_directed"})
+    is_weighted = aprops["edge_type"] == "map"
+    num_nodes = x.value.number_of_nodes()
+    num_edges = x.value.number_of_edges()
+    # get the edge list directly from the NetworkX Graph, one array per column
+    row = np.fromiter((each_edge[0] for each_edge in x.value.edges()), dtype=np.int64, count=num_edges)
+    col = np.fromiter((each_edge[1] for each_edge in x.value.edges()), dtype=np.int64, count=num_edges)
+    data = np.array([each_edge[2]["weight"] for each_edge in x.value.edges(data=True)])
+    if not aprops["is_directed"]:
+        row, col = np.concatenate((row, col)), np.concatenate((col, row))
+        data = np.concatenate((data, data))
+    # build the CSR format from the edge list (weight, (src, dst)); the conversion sorts the edges of each node
+    csr = csr_matrix((data, (row, col)), shape=(num_nodes, num_nodes))
+    return _katanagraph_from_csr(csr, is_weighted, aprops["is_directed"])
+
+
 @translator
 def katanagraph_to_networkx(x: KatanaGraph, **props) -> NetworkXGraph:
     pg = x.value
-    dest_list = [dest for src in pg for dest in [pg.get_edge_dest(e) for e in pg.edges(src)]]
-    for src in pg:
-        if pg.edges(src) == range(0, 0):
-            if src not in dest_list:
-                raise ValueError("NetworkX does not support graph with isolated nodes")
-    edge_dict_count = {(src, dest): 0 for src in pg for dest in [pg.get_edge_dest(e) for e in pg.edges(src)]}
-    for src in pg:
-        for dest in [pg.get_edge_dest(e) for e in pg.edges(src)]:
-            edge_dict_count[(src, dest)] += 1
-            if edge_dict_count[(src, dest)] > 1:
-                raise ValueError("NetworkX does not support graph with duplicated edges")
-    elist = []
-    edge_weights = pg.get_edge_property(x.edge_weight_prop_name).to_pandas()
-    if isinstance(edge_weights[0], np.int64):
-        elist = [(nid, pg.get_edge_dest(j), int(edge_weights[j])) for nid in pg for j in pg.edges(nid)]
-    elif isinstance(edge_weights[0], pyarrow.lib.Int64Scalar):
-        elist = [(nid, pg.get_edge_dest(j), edge_weights[j].as_py()) for nid in pg for j in pg.edges(nid)]
-        # TODO(pengfei): add more type conversion support: like np.float64 -> float??
-    elist = list(OrderedDict.fromkeys(elist))
+    indptr, indices, weights = _katana_csr(x)
+    sources = np.repeat(np.arange(pg.num_nodes()), np.diff(indptr))
+    in_degrees = np.bincount(indices, minlength=pg.num_nodes())
+    if np.any((np.diff(indptr) == 0) & (in_degrees == 0)):
+        raise ValueError("NetworkX does not support graph with isolated nodes")
+    if len(np.unique(sources * pg.num_nodes() + indices)) != pg.num_edges():
+        raise ValueError("NetworkX does not support graph with duplicated edges")
     if x.is_directed:
         graph = nx.DiGraph()
     else:
         graph = nx.Graph()
-    graph.add_weighted_edges_from(elist)
+    # tolist converts to Python scalars in one pass
+    graph.add_weighted_edges_from(zip(sources.tolist(), indices.tolist(), weights.tolist()))
     return mg.wrappers.Graph.NetworkXGraph(graph)
+
+
+@translator
+def scipygraph_to_katanagraph(x: ScipyGraph, **props) -> KatanaGraph:
+    aprops = ScipyGraph.Type.compute_abstract_properties(x, {"edge_type", "is_directed"})
+    if not np.array_equal(x.node_list, np.arange(len(x.node_list))):
+        raise ValueError("Katana graphs need node ids 0 to n-1")
+    return _katanagraph_from_csr(x.value.tocsr(), aprops["edge_type"] == "map", aprops["is_directed"])
+
+
+@translator
+def katanagraph_to_scipygraph(x: KatanaGraph, **props) -> ScipyGraph:
+    """
+    The matrix reuses the destination and weight arrays of the graph without copies.
+    """
+    pg = x.value
+    matrix = csr_matrix(_katana_csr(x)[::-1], shape=(pg.num_nodes(), pg.num_nodes()), copy=False)
+    return ScipyGraph(
+        matrix, aprops={"is_directed": x.is_directed, "edge_type": "map" if x.is_weighted else "set"},
+    )
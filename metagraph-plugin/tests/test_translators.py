@@ -77,3 +77,19 @@ def test_num_edges(nx_from_kg_di_8_12, katanagraph_cleaned_8_12_di):
                 edge_dict_count[(src, dest)] += 1
     assert sum([edge_dict_count[i] for i in edge_dict_count]) == katanagraph_cleaned_8_12_di.value.num_edges()
     assert len(list(nx_from_kg_di_8_12.value.edges(data=True))) == katanagraph_cleaned_8_12_di.value.num_edges()
+
+
+def test_scipy_round_trip(katanagraph_cleaned_8_12_di):
+    pg = katanagraph_cleaned_8_12_di.value
+    scipy_graph = mg.translate(katanagraph_cleaned_8_12_di, mg.wrappers.Graph.ScipyGraph)
+    matrix = scipy_graph.value
+    assert matrix.shape == (8, 8)
+    assert matrix.nnz == 12
+    assert list(matrix.indptr) == [0] + list(pg.adj_indices())
+    assert list(matrix.indices) == list(pg.edge_dests())
+    assert list(matrix.data) == pg.get_edge_property("value").tolist()
+
+    kg = mg.translate(scipy_graph, mg.wrappers.Graph.KatanaGraph)
+    assert list(kg.value.adj_indices()) == list(pg.adj_indices())
+    assert list(kg.value.edge_dests()) == list(pg.edge_dests())
+    assert kg.value.get_edge_property("value_from_translator").tolist() == pg.get_edge_property("value").tolist()
@@ -28,7 +28,7 @@ from katana.plugin import installed_plugins
 
 try:
     import katana.globals
-    from katana.globals import get_active_threads, set_active_threads, set_busy_wait
+    from katana.globals import get_active_threads, get_thread_id, set_active_threads, set_busy_wait
 
     __version__ = katana.globals.get_version()
 
@@ -66,6 +66,7 @@ __all__ = [
     "installed_plugins",
     "obim_metric",
     "get_active_threads",
+    "get_thread_id",
     "set_active_threads",
     "set_busy_wait",
 ]
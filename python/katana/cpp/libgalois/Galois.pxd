@@ -8,6 +8,9 @@ cdef extern from "katana/ThreadPool.h" namespace "katana" nogil:
         void burnPower(unsigned num)
         void beKind()
 
+        @staticmethod
+        unsigned getTID()
+
     ThreadPool& GetThreadPool()
 
 
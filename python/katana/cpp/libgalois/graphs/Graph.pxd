@@ -2,7 +2,7 @@ from libc.stdint cimport uint32_t, uint64_t
 from libcpp.memory cimport shared_ptr, unique_ptr
 from libcpp.string cimport string
 from libcpp.vector cimport vector
-from pyarrow.lib cimport CArray, CChunkedArray, CSchema, CTable, CUInt32Array, CUInt64Array
+from pyarrow.lib cimport CArray, CChunkedArray, CLargeListArray, CSchema, CTable, CUInt32Array, CUInt64Array
 
 from katana.cpp.boost cimport counting_iterator
 from katana.cpp.libgalois.datastructures cimport NUMAArray
@@ -130,6 +130,23 @@ cdef extern from "katana/Graph.h" namespace "katana" nogil:
         Node edge_dest(Edge edge_id) const
         uint64_t num_nodes() const
         uint64_t num_edges() const
+        const Edge* adj_data() const
+        const Node* dest_data() const
+
+    cdef enum EdgeSortKind "katana::EdgeShuffleTopology::EdgeSortKind":
+        kEdgeSortAny "katana::EdgeShuffleTopology::EdgeSortKind::kAny"
+        kSortedByDestID "katana::EdgeShuffleTopology::EdgeSortKind::kSortedByDestID"
+        kSortedByEdgeType "katana::EdgeShuffleTopology::EdgeSortKind::kSortedByEdgeType"
+        kSortedByNodeType "katana::EdgeShuffleTopology::EdgeSortKind::kSortedByNodeType"
+
+    cdef enum TransposeKind "katana::EdgeShuffleTopology::TransposeKind":
+        kTransposeNo "katana::EdgeShuffleTopology::TransposeKind::kNo"
+        kTransposeYes "katana::EdgeShuffleTopology::TransposeKind::kYes"
+
+    cppclass EdgeShuffleTopology(GraphTopology):
+        bint is_transposed() const
+        EdgeSortKind edge_sort_state() const
+        const uint64_t* edge_prop_index_data() const
 
     cppclass _PropertyGraph "katana::PropertyGraph":
         PropertyGraph()
@@ -149,6 +166,8 @@ cdef extern from "katana/Graph.h" namespace "katana" nogil:
         Result[void] Commit(string command_line)
 
         GraphTopology& topology()
+        vector[shared_ptr[const EdgeShuffleTopology]] GetCachedEdgeShuffleTopologies() const
+        shared_ptr[const EdgeShuffleTopology] BuildEdgeShuffleTopology(TransposeKind, EdgeSortKind)
 
         shared_ptr[CSchema] loaded_node_schema()
         shared_ptr[CSchema] loaded_edge_schema()
@@ -183,6 +202,13 @@ cdef extern from "katana/Graph.h" namespace "katana" nogil:
 
 
 
+cdef extern from "katana/PropertyGraph.h" namespace "katana" nogil:
+    Result[shared_ptr[CUInt64Array]] GetDegrees(const GraphTopology& topo, const CArray& nodes)
+    Result[shared_ptr[CLargeListArray]] GetNeighbors(const GraphTopology& topo, const CArray& nodes)
+    Result[shared_ptr[CChunkedArray]] GatherNodeProperty(
+        const _PropertyGraph& pg, const string& name, const CArray& nodes)
+
+
 cdef extern from "katana/BuildGraph.h" namespace "katana" nogil:
     cppclass GraphComponents:
         # These exist in C++, but are not needed in Cython yet, so commented to avoid accidentally using untested code.
@@ -196,6 +222,10 @@ cdef extern from "katana/BuildGraph.h" namespace "katana" nogil:
 
         void Dump()
 
+cdef extern from "katana/BulkImport.h" namespace "katana" nogil:
+    Result[GraphComponents] ImportEdgeList(
+        shared_ptr[CArray] sources, shared_ptr[CArray] dests, shared_ptr[CTable] edge_properties)
+
 cdef extern from "katana/GraphML.h" namespace "katana" nogil:
     Result[unique_ptr[_PropertyGraph]] ConvertToPropertyGraph(GraphComponents&& graph_comps);
 
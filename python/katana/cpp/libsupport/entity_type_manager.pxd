@@ -1,4 +1,4 @@
-from libc.stdint cimport uint8_t
+from libc.stdint cimport uint16_t
 from libcpp.string cimport string
 from libcpp.vector cimport vector
 
@@ -8,5 +8,5 @@ from katana.cpp.libstd.optional cimport optional
 cdef extern from "katana/EntityTypeManager.h" namespace "katana" nogil:
 
     cdef cppclass EntityTypeManager:
-        vector[uint8_t] GetAtomicEntityTypeIDs()
-        optional[string] GetAtomicTypeName(uint8_t)
+        vector[uint16_t] GetAtomicEntityTypeIDs()
+        optional[string] GetAtomicTypeName(uint16_t)
@@ -0,0 +1,33 @@
+from libc.stdint cimport uint64_t
+
+
+cdef extern from "katana/MemoryAccounting.h" namespace "katana" nogil:
+    cdef enum MemoryCategory "katana::MemoryCategory":
+        kTopology "katana::MemoryCategory::kTopology"
+        kViews "katana::MemoryCategory::kViews"
+        kProperties "katana::MemoryCategory::kProperties"
+        kIndexes "katana::MemoryCategory::kIndexes"
+        kWorklists "katana::MemoryCategory::kWorklists"
+        kScratch "katana::MemoryCategory::kScratch"
+        kNumCategories "katana::MemoryCategory::kNumCategories"
+
+    const char* MemoryCategoryName(MemoryCategory)
+
+    cppclass MemoryAccounting:
+        @staticmethod
+        uint64_t current(MemoryCategory)
+
+        @staticmethod
+        uint64_t peak(MemoryCategory)
+
+        @staticmethod
+        uint64_t total()
+
+        @staticmethod
+        uint64_t budget()
+
+        @staticmethod
+        void set_budget(uint64_t)
+
+        @staticmethod
+        void ResetPeaks()
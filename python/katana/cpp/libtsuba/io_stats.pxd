@@ -0,0 +1,35 @@
+from libc.stdint cimport uint64_t
+from libcpp.map cimport map
+from libcpp.string cimport string
+from libcpp.vector cimport vector
+
+
+cdef extern from "tsuba/IOStats.h" namespace "tsuba" nogil:
+    cppclass IORequestStats:
+        uint64_t requests
+        uint64_t bytes
+        vector[uint64_t] latency_us_histogram
+
+    cppclass IOSchemeStats:
+        IORequestStats reads
+        IORequestStats writes
+
+    cppclass IOStats:
+        map[string, IOSchemeStats] schemes
+        uint64_t pages_faulted
+        uint64_t pages_prefetched
+        uint64_t fill_wait_ns
+        uint64_t tables_decoded
+        uint64_t decode_ns
+        uint64_t read_group_ops
+        uint64_t read_group_wait_ns
+        uint64_t write_group_ops
+        uint64_t write_group_wait_ns
+        uint64_t cache_hits
+        uint64_t cache_misses
+        uint64_t cache_evictions
+        uint64_t metadata_cache_hits
+        uint64_t metadata_cache_misses
+
+    IOStats GetIOStats()
+    void ResetIOStats()
@@ -1,9 +1,15 @@
-from katana.cpp.libgalois.Galois cimport GetThreadPool
+import ctypes
+
+from libc.stdint cimport uintptr_t
+
+from katana.cpp.libgalois.Galois cimport GetThreadPool, ThreadPool
 from katana.cpp.libgalois.Galois cimport getActiveThreads as c_getActiveTheads
 from katana.cpp.libgalois.Galois cimport getVersion as c_getVersion
 from katana.cpp.libgalois.Galois cimport setActiveThreads as c_setActiveThreads
 
-__all__ = ["get_active_threads", "set_active_threads", "set_busy_wait", "get_version"]
+from numba.extending import overload
+
+__all__ = ["get_active_threads", "get_thread_id", "set_active_threads", "set_busy_wait", "get_version"]
 
 
 def get_active_threads():
@@ -13,6 +19,40 @@ def get_active_threads():
     return c_getActiveTheads()
 
 
+cdef unsigned _get_thread_id() nogil:
+    return ThreadPool.getTID()
+
+
+_get_thread_id_native = ctypes.CFUNCTYPE(ctypes.c_uint)(<uintptr_t>&_get_thread_id)
+
+
+def get_thread_id():
+    """
+    The id of the calling Katana thread, in ``range(get_active_threads())`` inside a parallel loop. Threads that are
+    not Katana threads get 0.
+
+    This can be called from numba compiled operators, e.g., to accumulate into a per-thread slot of an array instead
+    of using an atomic operation on a single value::
+
+        @do_all_operator()
+        def f(partial_sums, i):
+            partial_sums[get_thread_id()] += i
+
+        partial_sums = np.zeros(get_active_threads(), dtype=int)
+        do_all(range(n), f(partial_sums))
+        total = partial_sums.sum()
+    """
+    return _get_thread_id_native()
+
+
+@overload(get_thread_id)
+def _overload_get_thread_id():
+    def impl():
+        return _get_thread_id_native()
+
+    return impl
+
+
 def set_active_threads(int n):
     """
     Set the number of threads Katana should use to do computation.
@@ -0,0 +1,65 @@
+"""
+Storage I/O statistics: the requests Katana has made to each storage backend while loading and storing graphs, how
+much of each file was read on demand or ahead of time, and how often the property cache was useful.
+"""
+from libcpp.pair cimport pair
+from libcpp.string cimport string
+
+from katana.cpp.libtsuba.io_stats cimport GetIOStats, IORequestStats, IOSchemeStats, IOStats, ResetIOStats
+
+__all__ = ["get_io_stats", "reset_io_stats"]
+
+
+cdef _request_stats(const IORequestStats& stats):
+    return {
+        "requests": stats.requests,
+        "bytes": stats.bytes,
+        "latency_us_histogram": list(stats.latency_us_histogram),
+    }
+
+
+def get_io_stats():
+    """
+    The counts are for the whole process and start when Katana is loaded or at the last :py:func:`reset_io_stats`.
+
+    :return: A dict with a "schemes" entry mapping each URI scheme (e.g., "file", "s3") to the "reads" and "writes"
+        made to it, each with its "requests", "bytes" and "latency_us_histogram". Bucket 0 of the histogram counts
+        requests that took under a microsecond and bucket i those that took from 2^(i-1) to 2^i microseconds. The
+        remaining entries count FileView pages ("pages_faulted", "pages_prefetched", "fill_wait_ns"), Parquet decoding
+        ("tables_decoded", "decode_ns"), read and write groups ("read_group_ops", "read_group_wait_ns",
+        "write_group_ops", "write_group_wait_ns"), the property cache ("cache_hits", "cache_misses",
+        "cache_evictions") and the cache of manifests and partition headers ("metadata_cache_hits",
+        "metadata_cache_misses").
+    """
+    cdef IOStats stats = GetIOStats()
+    cdef pair[string, IOSchemeStats] scheme
+    schemes = {}
+    for scheme in stats.schemes:
+        schemes[str(scheme.first, encoding="UTF-8")] = {
+            "reads": _request_stats(scheme.second.reads),
+            "writes": _request_stats(scheme.second.writes),
+        }
+    return {
+        "schemes": schemes,
+        "pages_faulted": stats.pages_faulted,
+        "pages_prefetched": stats.pages_prefetched,
+        "fill_wait_ns": stats.fill_wait_ns,
+        "tables_decoded": stats.tables_decoded,
+        "decode_ns": stats.decode_ns,
+        "read_group_ops": stats.read_group_ops,
+        "read_group_wait_ns": stats.read_group_wait_ns,
+        "write_group_ops": stats.write_group_ops,
+        "write_group_wait_ns": stats.write_group_wait_ns,
+        "cache_hits": stats.cache_hits,
+        "cache_misses": stats.cache_misses,
+        "cache_evictions": stats.cache_evictions,
+        "metadata_cache_hits": stats.metadata_cache_hits,
+        "metadata_cache_misses": stats.metadata_cache_misses,
+    }
+
+
+def reset_io_stats():
+    """
+    Set all storage I/O statistics back to zero.
+    """
+    ResetIOStats()
@@ -5,7 +5,7 @@ from libcpp.memory cimport shared_ptr, unique_ptr
 from libcpp.vector cimport vector
 from pyarrow.lib cimport CTable, Schema
 
-from katana.cpp.libgalois.graphs.Graph cimport GraphTopology, _PropertyGraph
+from katana.cpp.libgalois.graphs.Graph cimport EdgeShuffleTopology, GraphTopology, _PropertyGraph
 from katana.cpp.libsupport.result cimport Result
 
 from .entity_type cimport EntityType
@@ -33,6 +33,8 @@ cdef class GraphBase:
 
     cpdef uint64_t num_edges(PropertyGraphInterface)
 
+    cdef object _topology_view(self, shared_ptr[const EdgeShuffleTopology] topo)
+
     cpdef uint64_t get_edge_dest(PropertyGraphInterface, uint64_t)
 
 
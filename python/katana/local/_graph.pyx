@@ -1,9 +1,33 @@
+from collections import namedtuple
+
 import numpy
 import pyarrow
 
-from pyarrow.lib cimport pyarrow_unwrap_table, pyarrow_wrap_chunked_array, pyarrow_wrap_schema, to_shared
+from pyarrow.lib cimport (
+    CArray,
+    CChunkedArray,
+    CLargeListArray,
+    CUInt64Array,
+    pyarrow_unwrap_array,
+    pyarrow_unwrap_table,
+    pyarrow_wrap_array,
+    pyarrow_wrap_chunked_array,
+    pyarrow_wrap_schema,
+    to_shared,
+)
 
 from katana.cpp.libgalois.graphs cimport Graph as CGraph
+from katana.cpp.libgalois.graphs.Graph cimport (
+    EdgeShuffleTopology,
+    EdgeSortKind,
+    TransposeKind,
+    kEdgeSortAny,
+    kSortedByDestID,
+    kSortedByEdgeType,
+    kSortedByNodeType,
+    kTransposeNo,
+    kTransposeYes,
+)
 from katana.cpp.libsupport.entity_type_manager cimport EntityTypeManager
 from katana.cpp.libsupport.result cimport Result, handle_result_void, raise_error_code
 
@@ -13,9 +37,10 @@ from . cimport datastructures
 
 from . import datastructures
 
+from cpython.buffer cimport PyBUF_FORMAT, PyBUF_WRITABLE
 from cython.operator cimport dereference as deref
-from libc.stdint cimport uint32_t
-from libcpp.memory cimport shared_ptr, unique_ptr
+from libc.stdint cimport uint32_t, uint64_t
+from libcpp.memory cimport shared_ptr, static_pointer_cast, unique_ptr
 from libcpp.string cimport string
 from libcpp.utility cimport move
 from libcpp.vector cimport vector
@@ -23,7 +48,7 @@ from libcpp.vector cimport vector
 from ..native_interfacing.buffer_access cimport to_pyarrow
 from .entity_type cimport EntityType
 
-__all__ = ["GraphBase", "Graph"]
+__all__ = ["GraphBase", "Graph", "TopologyView"]
 
 
 cdef _convert_string_list(l):
@@ -37,6 +62,120 @@ cdef shared_ptr[_PropertyGraph] handle_result_PropertyGraph(Result[unique_ptr[_P
     return to_shared(res.value())
 
 
+cdef shared_ptr[CUInt64Array] handle_result_UInt64Array(Result[shared_ptr[CUInt64Array]] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef shared_ptr[CLargeListArray] handle_result_LargeListArray(Result[shared_ptr[CLargeListArray]] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef shared_ptr[CChunkedArray] handle_result_ChunkedArray(Result[shared_ptr[CChunkedArray]] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class _TopologyBuffer:
+    """
+    A read-only buffer over an array of a topology, for numpy.asarray. It keeps
+    the graph, and the derived topology of a view if any, alive while in use.
+    """
+    cdef object graph
+    cdef shared_ptr[const EdgeShuffleTopology] view
+    cdef const void* data
+    cdef char* format
+    cdef Py_ssize_t shape
+    cdef Py_ssize_t itemsize
+
+    @staticmethod
+    cdef object array(object graph, shared_ptr[const EdgeShuffleTopology] view, const void* data,
+                      uint64_t length, bint is_edge):
+        if length == 0:
+            a = numpy.empty(0, dtype=numpy.uint64 if is_edge else numpy.uint32)
+            a.flags.writeable = False
+            return a
+        b = <_TopologyBuffer>_TopologyBuffer.__new__(_TopologyBuffer)
+        b.graph = graph
+        b.view = view
+        b.data = data
+        b.format = b"Q" if is_edge else b"I"
+        b.shape = length
+        b.itemsize = sizeof(uint64_t) if is_edge else sizeof(uint32_t)
+        return numpy.asarray(b)
+
+    def __getbuffer__(self, Py_buffer *buffer, int flags):
+        if flags & PyBUF_WRITABLE:
+            raise BufferError("topology arrays are read-only")
+        buffer.buf = <void *>self.data
+        buffer.format = self.format if flags & PyBUF_FORMAT else NULL
+        buffer.internal = NULL
+        buffer.itemsize = self.itemsize
+        buffer.len = self.shape * self.itemsize
+        buffer.ndim = 1
+        buffer.obj = self
+        buffer.readonly = 1
+        buffer.shape = &self.shape
+        buffer.strides = &self.itemsize
+        buffer.suboffsets = NULL
+
+    def __releasebuffer__(self, Py_buffer *buffer):
+        pass
+
+
+cdef str _edge_sort_name(EdgeSortKind kind):
+    if kind == kSortedByDestID:
+        return "dest_id"
+    if kind == kSortedByEdgeType:
+        return "edge_type"
+    if kind == kSortedByNodeType:
+        return "node_type"
+    return "any"
+
+
+cdef EdgeSortKind _edge_sort_kind(str name) except *:
+    if name == "dest_id":
+        return kSortedByDestID
+    if name == "edge_type":
+        return kSortedByEdgeType
+    if name == "node_type":
+        return kSortedByNodeType
+    if name == "any":
+        return kEdgeSortAny
+    raise ValueError(f"unknown edge sort: {name}")
+
+
+class TopologyView(
+    namedtuple("TopologyView", ["transposed", "edge_sort", "adj_indices", "edge_dests", "edge_property_indices"])
+):
+    """
+    A topology derived from a graph for views, e.g., with edges sorted by destination or transposed. The arrays are
+    like `Graph.adj_indices` and `Graph.edge_dests`; entry `e` of ``edge_property_indices`` is the edge of the graph,
+    i.e., the row of the edge properties, that edge `e` of the view comes from. For a transposed view ``edges(n)``
+    are the incoming edges of `n` and ``get_edge_dest(e)`` is their source.
+
+    The arrays share memory with the topology and keep it alive. `edges` and `get_edge_dest` can be called from numba
+    compiled code.
+    """
+
+    __slots__ = ()
+
+    def edges(self, n):
+        if n >= len(self.adj_indices):
+            raise IndexError(n)
+        return range(self.adj_indices[n - 1] if n > 0 else 0, self.adj_indices[n])
+
+    def get_edge_dest(self, e):
+        return self.edge_dests[e]
+
+
 # TODO(amp): Wrap Copy
 
 cdef class GraphBase:
@@ -164,6 +303,117 @@ cdef class GraphBase:
             raise IndexError(e)
         return self.topology().edge_dest(e)
 
+    def adj_indices(self):
+        """
+        Return the CSR index of the topology as a read-only uint64 numpy array of length `num_nodes()`. Entry `n` is
+        one past the last edge of node `n`, so the edges of `n` start at entry `n - 1`, or 0 for the first node.
+
+        The array shares memory with the graph, without copying, and keeps the graph alive. SciPy expects a leading
+        zero in its index::
+
+            indptr = numpy.concatenate(([0], graph.adj_indices()))
+            m = scipy.sparse.csr_matrix((weights, graph.edge_dests(), indptr))
+        """
+        cdef const GraphTopology* topo = self.topology()
+        return _TopologyBuffer.array(self, shared_ptr[const EdgeShuffleTopology](), topo.adj_data(),
+                                     topo.num_nodes(), True)
+
+    def edge_dests(self):
+        """
+        Return the destination node of every edge as a read-only uint32 numpy array of length `num_edges()`, i.e., the
+        array that `get_edge_dest` reads.
+
+        The array shares memory with the graph, without copying, and keeps the graph alive.
+        """
+        cdef const GraphTopology* topo = self.topology()
+        return _TopologyBuffer.array(self, shared_ptr[const EdgeShuffleTopology](), topo.dest_data(),
+                                     topo.num_edges(), False)
+
+    cdef object _topology_view(self, shared_ptr[const EdgeShuffleTopology] topo):
+        return TopologyView(
+            transposed=topo.get().is_transposed(),
+            edge_sort=_edge_sort_name(topo.get().edge_sort_state()),
+            adj_indices=_TopologyBuffer.array(self, topo, topo.get().adj_data(), topo.get().num_nodes(), True),
+            edge_dests=_TopologyBuffer.array(self, topo, topo.get().dest_data(), topo.get().num_edges(), False),
+            edge_property_indices=_TopologyBuffer.array(
+                self, topo, topo.get().edge_prop_index_data(), topo.get().num_edges(), True
+            ),
+        )
+
+    def topology_view(self, bint transposed = False, str edge_sort = "any"):
+        """
+        Return the topology of a view of this graph as a `TopologyView`, e.g., ``topology_view(transposed=True)`` for
+        the incoming edges of each node or ``topology_view(edge_sort="dest_id")`` for edges sorted by destination.
+        `edge_sort` is one of ``"any"``, ``"dest_id"``, ``"edge_type"`` or ``"node_type"``.
+
+        The topology is built in parallel, without the GIL, the first time it is needed and is cached with the graph,
+        so later calls and the analytics that build the same view (e.g., ``BiDirectional`` views for in-edges) reuse
+        it.
+        """
+        cdef EdgeSortKind sort_kind = _edge_sort_kind(edge_sort)
+        cdef TransposeKind tpose_kind = kTransposeYes if transposed else kTransposeNo
+        cdef shared_ptr[const EdgeShuffleTopology] topo
+        with nogil:
+            topo = self.underlying_property_graph().BuildEdgeShuffleTopology(tpose_kind, sort_kind)
+        return self._topology_view(topo)
+
+    def cached_topologies(self):
+        """
+        Return the topologies derived from this graph for views, e.g., with edges sorted by destination or transposed,
+        that have been built so far. Each is a dict with keys ``transposed`` (bool), ``edge_sort`` (one of ``"any"``,
+        ``"dest_id"``, ``"edge_type"`` or ``"node_type"``), ``adj_indices``, ``edge_dests`` and
+        ``edge_property_indices``, as in `TopologyView`. The arrays keep their topology alive even if the graph drops
+        it from its cache.
+        """
+        cdef vector[shared_ptr[const EdgeShuffleTopology]] topos = \
+            self.underlying_property_graph().GetCachedEdgeShuffleTopologies()
+        cdef shared_ptr[const EdgeShuffleTopology] topo
+        ret = []
+        for topo in topos:
+            ret.append(dict(self._topology_view(topo)._asdict()))
+        return ret
+
+    def degree(self, nodes):
+        """
+        Return the number of outgoing edges of each node of `nodes`, an array or sequence of node IDs, as a uint64
+        numpy array. The degrees are computed in parallel in C++ without the GIL.
+        """
+        cdef shared_ptr[CArray] c_nodes = pyarrow_unwrap_array(to_pyarrow(nodes))
+        cdef shared_ptr[CUInt64Array] degrees
+        with nogil:
+            degrees = handle_result_UInt64Array(CGraph.GetDegrees(deref(self.topology()), deref(c_nodes)))
+        return pyarrow_wrap_array(static_pointer_cast[CArray, CUInt64Array](degrees)).to_numpy()
+
+    def neighbors(self, nodes):
+        """
+        Return the destinations of the outgoing edges of each node of `nodes`, an array or sequence of node IDs, in
+        CSR form: a tuple ``(offsets, destinations)`` of an int64 numpy array of length ``len(nodes) + 1`` and a uint32
+        numpy array, where the neighbors of ``nodes[i]`` are ``destinations[offsets[i]:offsets[i + 1]]`` in edge order.
+        This replaces calls to `edges` and `get_edge_dest` for each node with one parallel pass in C++ without the GIL.
+        """
+        cdef shared_ptr[CArray] c_nodes = pyarrow_unwrap_array(to_pyarrow(nodes))
+        cdef shared_ptr[CLargeListArray] lists
+        with nogil:
+            lists = handle_result_LargeListArray(CGraph.GetNeighbors(deref(self.topology()), deref(c_nodes)))
+        neighbors = pyarrow_wrap_array(static_pointer_cast[CArray, CLargeListArray](lists))
+        return neighbors.offsets.to_numpy(), neighbors.values.to_numpy()
+
+    def gather_node_property(self, prop, nodes):
+        """
+        Return a `pyarrow` array of the values of node property `prop` at each node of `nodes`, an array or sequence of
+        node IDs. The values are gathered in parallel in C++ without the GIL.
+        `prop` may be either a name or an index.
+        """
+        schema = self.loaded_node_schema()
+        cdef string name = bytes(schema.names[Graph._property_name_to_id(prop, schema)], "utf-8")
+        cdef shared_ptr[CArray] c_nodes = pyarrow_unwrap_array(to_pyarrow(nodes))
+        cdef shared_ptr[CChunkedArray] values
+        with nogil:
+            values = handle_result_ChunkedArray(
+                CGraph.GatherNodeProperty(deref(self.underlying_property_graph()), name, deref(c_nodes))
+            )
+        return unchunked(pyarrow_wrap_chunked_array(values))
+
     def get_node_property(self, prop):
         """
         Return a `pyarrow` array or chunked array storing the data for node property `prop`.
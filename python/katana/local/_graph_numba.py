@@ -1,6 +1,7 @@
 from numba import types
 from numba.extending import overload, overload_method
 
+from katana.local._graph import TopologyView
 from katana.local._graph_numba_native import Graph_numba_wrapper
 
 # Graph
@@ -41,3 +42,36 @@ def overload_Graph_edges(self, n):
 
         return impl
     return None
+
+
+# TopologyView
+
+
+def _is_topology_view(typ):
+    return isinstance(typ, types.BaseNamedTuple) and issubclass(typ.instance_class, TopologyView)
+
+
+@overload_method(types.BaseNamedTuple, "edges")
+def overload_TopologyView_edges(self, n):
+    if _is_topology_view(self) and isinstance(n, types.Integer):
+
+        def impl(self, n):
+            if n == 0:
+                prev = 0
+            else:
+                prev = self.adj_indices[n - 1]
+            return range(prev, self.adj_indices[n])
+
+        return impl
+    return None
+
+
+@overload_method(types.BaseNamedTuple, "get_edge_dest")
+def overload_TopologyView_get_edge_dest(self, e):
+    if _is_topology_view(self) and isinstance(e, types.Integer):
+
+        def impl(self, e):
+            return self.edge_dests[e]
+
+        return impl
+    return None
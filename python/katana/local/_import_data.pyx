@@ -2,14 +2,18 @@ from libc.stdint cimport uint64_t
 from libcpp.memory cimport make_shared, shared_ptr, unique_ptr
 from libcpp.string cimport string
 from libcpp.utility cimport move
+from pyarrow.lib cimport CArray, CTable, pyarrow_unwrap_array, pyarrow_unwrap_table
 
 from . cimport datastructures
 
 from . import datastructures
 
+import pyarrow
+
 from katana.cpp.libgalois.graphs cimport Graph as CGraph
 from katana.cpp.libsupport.result cimport Result, raise_error_code
 from katana.local._graph cimport Graph, handle_result_PropertyGraph
+from katana.native_interfacing.buffer_access cimport to_pyarrow
 
 
 cdef CGraph.GraphComponents handle_result_GraphComponents(Result[CGraph.GraphComponents] res) nogil except *:
@@ -48,6 +52,28 @@ def from_csr(edge_indices, edge_destinations):
     return Graph.make(pg)
 
 
+def _from_edge_list_arrays(sources, destinations, properties):
+    """
+    Build a `Graph` from the integer node ids of the ends of each edge in C++, with a parallel counting sort of the
+    edges by source. The arrays are passed to C++ without a copy if they are contiguous and have no nulls, and fixed
+    width properties are put in the order of the edges in the same pass as the destinations.
+
+    :param properties: a dict of arrays of edge properties, or ``None``
+    """
+    cdef shared_ptr[CArray] c_sources = pyarrow_unwrap_array(to_pyarrow(sources))
+    cdef shared_ptr[CArray] c_destinations = pyarrow_unwrap_array(to_pyarrow(destinations))
+    cdef shared_ptr[CTable] c_properties
+    if properties:
+        c_properties = pyarrow_unwrap_table(pyarrow.table({name: to_pyarrow(v) for name, v in properties.items()}))
+
+    with nogil:
+        pg = handle_result_PropertyGraph(
+            CGraph.ConvertToPropertyGraph(
+            move(handle_result_GraphComponents(CGraph.ImportEdgeList(c_sources, c_destinations, c_properties)))
+            ))
+    return Graph.make(pg)
+
+
 def from_graphml(path, uint64_t chunk_size=25000):
     """
     Load a GraphML file into Katana form.
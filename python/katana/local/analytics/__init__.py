@@ -19,19 +19,48 @@ Statistics
 .. autoclass:: katana.local.analytics.Statistics
     :members: __init__
 
+.. _Asynchronous:
+
+Asynchronous Calls
+------------------
+
+Some routines have an ``*_async`` variant that runs the routine on a dedicated analytics thread and returns an
+:py:class:`~katana.local.analytics.AnalyticsFuture` right away. The routines release the GIL, so the calling thread
+can prepare data while the graph computation runs.
+
+.. autoclass:: katana.local.analytics.AnalyticsContext
+    :members:
+
+.. autoclass:: katana.local.analytics.AnalyticsFuture
+    :members: cancel
+
 Algorithms
 ----------
 
+.. automodule:: katana.local.analytics._analytics_batch
+
 .. automodule:: katana.local.analytics._betweenness_centrality
 
 .. automodule:: katana.local.analytics._bfs
 
+.. automodule:: katana.local.analytics._bipartite_matching
+
 .. automodule:: katana.local.analytics._connected_components
 
+.. automodule:: katana.local.analytics._graph_coloring
+
+.. automodule:: katana.local.analytics._hypergraph_partition
+
 .. automodule:: katana.local.analytics._independent_set
 
 .. automodule:: katana.local.analytics._louvain_clustering
 
+.. automodule:: katana.local.analytics._matrix_completion
+
+.. automodule:: katana.local.analytics._max_flow
+
+.. automodule:: katana.local.analytics._minimum_spanning_forest
+
 .. automodule:: katana.local.analytics._local_clustering_coefficient
 
 .. automodule:: katana.local.analytics._subgraph_extraction
@@ -42,10 +71,16 @@ Algorithms
 
 .. automodule:: katana.local.analytics._k_truss
 
+.. automodule:: katana.local.analytics._label_propagation
+
 .. automodule:: katana.local.analytics._pagerank
 
+.. automodule:: katana.local.analytics._partition
+
 .. automodule:: katana.local.analytics._sssp
 
+.. automodule:: katana.local.analytics._strongly_connected_components
+
 .. automodule:: katana.local.analytics._triangle_count
 
 .. automodule:: katana.local.analytics._wrappers
@@ -54,18 +89,38 @@ Algorithms
 """
 
 
+from katana.local.analytics._analytics_batch import AnalyticsBatch
 from katana.local.analytics._betweenness_centrality import (
+    BetweennessCentralityAdaptiveSources,
     BetweennessCentralityPlan,
     BetweennessCentralityStatistics,
     betweenness_centrality,
 )
-from katana.local.analytics._bfs import BfsPlan, BfsStatistics, bfs, bfs_assert_valid
+from katana.local.analytics._bfs import BfsPlan, BfsStatistics, bfs, bfs_assert_valid, bfs_async
+from katana.local.analytics._bipartite_matching import (
+    BipartiteMatchingPlan,
+    BipartiteMatchingStatistics,
+    bipartite_matching,
+    bipartite_matching_assert_valid,
+    maximum_weight_bipartite_matching,
+)
 from katana.local.analytics._connected_components import (
     ConnectedComponentsPlan,
     ConnectedComponentsStatistics,
     connected_components,
     connected_components_assert_valid,
 )
+from katana.local.analytics._graph_coloring import (
+    GraphColoringPlan,
+    GraphColoringStatistics,
+    graph_coloring,
+    graph_coloring_assert_valid,
+)
+from katana.local.analytics._hypergraph_partition import (
+    HypergraphPartitionPlan,
+    HypergraphPartitionStatistics,
+    hypergraph_partition,
+)
 from katana.local.analytics._independent_set import (
     IndependentSetPlan,
     IndependentSetStatistics,
@@ -73,8 +128,14 @@ from katana.local.analytics._independent_set import (
     independent_set_assert_valid,
 )
 from katana.local.analytics._jaccard import JaccardPlan, JaccardStatistics, jaccard, jaccard_assert_valid
-from katana.local.analytics._k_core import KCorePlan, KCoreStatistics, k_core, k_core_assert_valid
-from katana.local.analytics._k_truss import KTrussPlan, KTrussStatistics, k_truss, k_truss_assert_valid
+from katana.local.analytics._k_core import KCorePlan, KCoreStatistics, k_core, k_core_assert_valid, k_core_numbers
+from katana.local.analytics._k_truss import KTrussPlan, KTrussStatistics, k_truss, k_truss_assert_valid, k_truss_numbers
+from katana.local.analytics._label_propagation import (
+    LabelPropagationPlan,
+    LabelPropagationStatistics,
+    label_propagation,
+    label_propagation_assert_valid,
+)
 from katana.local.analytics._local_clustering_coefficient import (
     LocalClusteringCoefficientPlan,
     local_clustering_coefficient,
@@ -85,9 +146,40 @@ from katana.local.analytics._louvain_clustering import (
     louvain_clustering,
     louvain_clustering_assert_valid,
 )
-from katana.local.analytics._pagerank import PagerankPlan, PagerankStatistics, pagerank, pagerank_assert_valid
-from katana.local.analytics._sssp import SsspPlan, SsspStatistics, sssp, sssp_assert_valid
-from katana.local.analytics._subgraph_extraction import SubGraphExtractionPlan, subgraph_extraction
-from katana.local.analytics._triangle_count import TriangleCountPlan, triangle_count
+from katana.local.analytics._matrix_completion import (
+    MatrixCompletionPlan,
+    MatrixCompletionStatistics,
+    matrix_completion,
+)
+from katana.local.analytics._max_flow import MaxFlowPlan, MaxFlowStatistics, max_flow, max_flow_assert_valid
+from katana.local.analytics._minimum_spanning_forest import (
+    MinimumSpanningForestPlan,
+    MinimumSpanningForestStatistics,
+    minimum_spanning_forest,
+    minimum_spanning_forest_assert_valid,
+)
+from katana.local.analytics._pagerank import (
+    PagerankPlan,
+    PagerankStatistics,
+    pagerank,
+    pagerank_assert_valid,
+    pagerank_async,
+)
+from katana.local.analytics._partition import PartitionPlan, PartitionStatistics, partition
+from katana.local.analytics._sssp import SsspPlan, SsspStatistics, sssp, sssp_assert_valid, sssp_async
+from katana.local.analytics._strongly_connected_components import (
+    StronglyConnectedComponentsPlan,
+    StronglyConnectedComponentsStatistics,
+    strongly_connected_components,
+    strongly_connected_components_assert_valid,
+)
+from katana.local.analytics._subgraph_extraction import SubGraphExtractionPlan, k_hop_neighborhood, subgraph_extraction
+from katana.local.analytics._triangle_count import (
+    TriangleCountEstimate,
+    TriangleCountPlan,
+    triangle_count,
+    triangle_count_approximate,
+)
 from katana.local.analytics._wrappers import find_edge_sorted_by_dest, sort_all_edges_by_dest, sort_nodes_by_degree
+from katana.local.analytics.context import AnalyticsContext, AnalyticsFuture
 from katana.local.analytics.plan import Architecture, Plan, Statistics
@@ -0,0 +1,106 @@
+"""
+Analytics Batch
+---------------
+
+.. autoclass:: katana.local.analytics.AnalyticsBatch
+    :members:
+"""
+from libcpp.string cimport string
+
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libsupport.result cimport Result, handle_result_void
+from katana.local._graph cimport Graph
+
+
+cdef extern from "katana/analytics/pagerank/pagerank.h" namespace "katana::analytics" nogil:
+    cppclass _PagerankPlan "katana::analytics::PagerankPlan":
+        _PagerankPlan()
+
+        @staticmethod
+        _PagerankPlan PullTopological(float tolerance, unsigned int max_iterations, float alpha)
+
+    double kDefaultTolerance "katana::analytics::PagerankPlan::kDefaultTolerance"
+    int kDefaultMaxIterations "katana::analytics::PagerankPlan::kDefaultMaxIterations"
+    double kDefaultAlpha "katana::analytics::PagerankPlan::kDefaultAlpha"
+
+
+cdef extern from "katana/analytics/analytics_batch/analytics_batch.h" namespace "katana::analytics" nogil:
+    cppclass _AnalyticsBatch "katana::analytics::AnalyticsBatch":
+        _AnalyticsBatch& AddOutDegree(string output_property_name)
+        _AnalyticsBatch& AddInDegree(string output_property_name)
+        _AnalyticsBatch& AddPagerank(string output_property_name, _PagerankPlan plan)
+        _AnalyticsBatch& AddConnectedComponents(string output_property_name)
+
+        Result[void] Run(_PropertyGraph* pg) const
+
+
+cdef class AnalyticsBatch:
+    """
+    A batch of node analytics computed together, sharing passes over the edges instead of each scanning the topology.
+    Every ``add_`` method returns the batch, so calls can be chained. All the properties are created at once by
+    :py:meth:`run`; they may not exist before the call and must have distinct names.
+
+    .. code-block:: python
+
+        import katana.local
+        from katana.example_data import get_input
+        from katana.local import Graph
+        katana.local.initialize()
+
+        graph = Graph(get_input("propertygraphs/rmat15"))
+        from katana.local.analytics import AnalyticsBatch
+        AnalyticsBatch().add_out_degree("out_degree").add_pagerank("rank").run(graph)
+    """
+    cdef:
+        _AnalyticsBatch underlying_
+
+    def add_out_degree(self, str output_property_name) -> AnalyticsBatch:
+        """
+        Compute the number of edges leaving each node, as a uint32 property.
+        """
+        self.underlying_.AddOutDegree(output_property_name.encode("utf-8"))
+        return self
+
+    def add_in_degree(self, str output_property_name) -> AnalyticsBatch:
+        """
+        Compute the number of edges entering each node, as a uint32 property.
+        """
+        self.underlying_.AddInDegree(output_property_name.encode("utf-8"))
+        return self
+
+    def add_pagerank(
+        self,
+        str output_property_name,
+        float tolerance = kDefaultTolerance,
+        unsigned int max_iterations = kDefaultMaxIterations,
+        float alpha = kDefaultAlpha,
+    ) -> AnalyticsBatch:
+        """
+        Compute the Page Rank of each node as :py:func:`~katana.local.analytics.pagerank` does with
+        :py:meth:`PagerankPlan.pull_topological(tolerance, max_iterations, alpha)
+        <katana.local.analytics.PagerankPlan.pull_topological>`, as a float property. The graph must be transposed.
+        """
+        self.underlying_.AddPagerank(
+            output_property_name.encode("utf-8"), _PagerankPlan.PullTopological(tolerance, max_iterations, alpha)
+        )
+        return self
+
+    def add_connected_components(self, str output_property_name) -> AnalyticsBatch:
+        """
+        Compute the connected component of each node as :py:func:`~katana.local.analytics.connected_components` does
+        with :py:meth:`ConnectedComponentsPlan.label_prop
+        <katana.local.analytics.ConnectedComponentsPlan.label_prop>`, as a uint64 property holding the smallest node
+        ID of the component. The graph must be symmetric.
+        """
+        self.underlying_.AddConnectedComponents(output_property_name.encode("utf-8"))
+        return self
+
+    def run(self, Graph pg):
+        """
+        Compute every analytic added to the batch and create its property.
+
+        :type pg: katana.local.Graph
+        :param pg: The graph to analyze.
+        """
+        with nogil:
+            handle_result_void(self.underlying_.Run(pg.underlying_property_graph()))
@@ -11,6 +11,10 @@ Betweenness Centrality
     :members:
     :undoc-members:
 
+.. autoclass:: katana.local.analytics.BetweennessCentralityAdaptiveSources
+    :members:
+    :special-members: __init__
+
 .. autofunction:: katana.local.analytics.betweenness_centrality
 
 .. autoclass:: katana.local.analytics.BetweennessCentralityStatistics
@@ -18,7 +22,8 @@ Betweenness Centrality
     :undoc-members:
 """
 
-from libc.stdint cimport uint32_t
+from libc.stddef cimport size_t
+from libc.stdint cimport uint32_t, uint64_t
 from libcpp.string cimport string
 from libcpp.vector cimport vector
 
@@ -39,8 +44,10 @@ cdef extern from "katana/analytics/betweenness_centrality/betweenness_centrality
         enum Algorithm:
             kOuter "katana::analytics::BetweennessCentralityPlan::kOuter"
             kLevel "katana::analytics::BetweennessCentralityPlan::kLevel"
+            kBatched "katana::analytics::BetweennessCentralityPlan::kBatched"
 
         _BetweennessCentralityPlan.Algorithm algorithm() const
+        size_t max_batch_bytes() const
 
         BetweennessCentralityPlan()
 
@@ -49,8 +56,12 @@ cdef extern from "katana/analytics/betweenness_centrality/betweenness_centrality
         @staticmethod
         _BetweennessCentralityPlan Outer()
         @staticmethod
+        _BetweennessCentralityPlan Batched(size_t max_batch_bytes)
+        @staticmethod
         _BetweennessCentralityPlan FromAlgorithm(_BetweennessCentralityPlan.Algorithm algo)
 
+    size_t kDefaultMaxBatchBytes "katana::analytics::BetweennessCentralityPlan::kDefaultMaxBatchBytes"
+
     BetweennessCentralitySources kBetweennessCentralityAllNodes;
 
     Result[void] BetweennessCentrality(_PropertyGraph* pg, string output_property_name, const BetweennessCentralitySources& sources, _BetweennessCentralityPlan plan)
@@ -76,9 +87,26 @@ cdef extern from * nogil:
     katana::analytics::BetweennessCentralitySources BetweennessCentralitySources_from_vector(std::vector<uint32_t> v) {
         return v;
     }
+    katana::analytics::BetweennessCentralitySources BetweennessCentralitySources_from_adaptive(double epsilon, double delta, uint64_t seed) {
+        return katana::analytics::BetweennessCentralityAdaptiveSources{epsilon, delta, seed};
+    }
     """
     BetweennessCentralitySources BetweennessCentralitySources_from_int(uint32_t v)
     BetweennessCentralitySources BetweennessCentralitySources_from_vector(vector[uint32_t] v);
+    BetweennessCentralitySources BetweennessCentralitySources_from_adaptive(double epsilon, double delta, uint64_t seed)
+
+
+class BetweennessCentralityAdaptiveSources:
+    """
+    Sources drawn uniformly at random, in batches, until the betweenness centrality of every node, normalized by n(n-1),
+    is estimated within epsilon of its exact value with probability at least 1 - delta. The estimates are scaled to the
+    range of the exact centralities.
+    """
+
+    def __init__(self, epsilon: float, delta: float = 0.1, seed: int = 0):
+        self.epsilon = epsilon
+        self.delta = delta
+        self.seed = seed
 
 
 class _BetweennessCentralityAlgorithm(Enum):
@@ -87,6 +115,7 @@ class _BetweennessCentralityAlgorithm(Enum):
     """
     Outer = _BetweennessCentralityPlan.Algorithm.kOuter
     Level = _BetweennessCentralityPlan.Algorithm.kLevel
+    Batched = _BetweennessCentralityPlan.Algorithm.kBatched
 
 
 cdef class BetweennessCentralityPlan(Plan):
@@ -127,6 +156,21 @@ cdef class BetweennessCentralityPlan(Plan):
         """
         return BetweennessCentralityPlan.make(_BetweennessCentralityPlan.Level())
 
+    @property
+    def max_batch_bytes(self) -> int:
+        return self.underlying_.max_batch_bytes()
+
+    @staticmethod
+    def batched(size_t max_batch_bytes = kDefaultMaxBatchBytes):
+        """
+        Process sources in batches, with the levels of all the sources of a batch in parallel. Memory does not grow
+        with the number of threads.
+
+        :param max_batch_bytes: The most memory for the state of the sources of a batch, about 16 bytes per node per
+            source.
+        """
+        return BetweennessCentralityPlan.make(_BetweennessCentralityPlan.Batched(max_batch_bytes))
+
 
 def betweenness_centrality(Graph pg, str output_property_name, sources = None,
              BetweennessCentralityPlan plan = BetweennessCentralityPlan()):
@@ -138,8 +182,8 @@ def betweenness_centrality(Graph pg, str output_property_name, sources = None,
     :param pg: The graph to analyze.
     :type output_property_name: str
     :param output_property_name: The output property to write path lengths into. This property must not already exist.
-    :type sources: Union[List[int], int]
-    :param sources: Only process some sources, producing an approximate betweenness centrality. If this is a list of node IDs process those source nodes; if this is an int process that number of source nodes.
+    :type sources: Union[List[int], int, BetweennessCentralityAdaptiveSources]
+    :param sources: Only process some sources, producing an approximate betweenness centrality. If this is a list of node IDs process those source nodes; if this is an int process that number of source nodes; if this is a BetweennessCentralityAdaptiveSources process random sources until the estimates are accurate enough.
     :type plan: BetweennessCentralityPlan
     :param plan: The execution plan to use.
 
@@ -165,6 +209,8 @@ def betweenness_centrality(Graph pg, str output_property_name, sources = None,
     output_property_name_cstr = <string>output_property_name_bytes
     if sources is None:
         c_sources = kBetweennessCentralityAllNodes
+    elif isinstance(sources, BetweennessCentralityAdaptiveSources):
+        c_sources = BetweennessCentralitySources_from_adaptive(sources.epsilon, sources.delta, sources.seed)
     elif isinstance(sources, list) or isinstance(sources, set) or \
             isinstance(sources, tuple) or  isinstance(sources, frozenset):
         c_sources = BetweennessCentralitySources_from_vector(sources)
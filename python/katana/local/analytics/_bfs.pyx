@@ -13,6 +13,8 @@ Breadth-first Search
 
 .. autofunction:: katana.local.analytics.bfs
 
+.. autofunction:: katana.local.analytics.bfs_async
+
 .. autoclass:: katana.local.analytics.BfsStatistics
     :members:
     :undoc-members:
@@ -28,10 +30,13 @@ from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
 from katana.cpp.libstd.iostream cimport ostream, ostringstream
 from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_result_void, raise_error_code
 from katana.local._graph cimport Graph
+from katana.local.analytics.context cimport AnalyticsContext, _AnalyticsContext, underlying_context
 from katana.local.analytics.plan cimport Plan, _Plan
 
 from enum import Enum
 
+from katana.local.analytics.context import AnalyticsFuture, submit
+
 
 cdef extern from "katana/Analytics.h" namespace "katana::analytics" nogil:
     cppclass _BfsPlan "katana::analytics::BfsPlan" (_Plan):
@@ -41,6 +46,7 @@ cdef extern from "katana/Analytics.h" namespace "katana::analytics" nogil:
             kSynchronousTile "katana::analytics::BfsPlan::kSynchronousTile"
             kSynchronous "katana::analytics::BfsPlan::kSynchronous"
             kSynchronousDirectOpt "katana::analytics::BfsPlan::kSynchronousDirectOpt"
+            kSynchronousDirectOptLazyTranspose "katana::analytics::BfsPlan::kSynchronousDirectOptLazyTranspose"
 
         _BfsPlan.Algorithm algorithm() const
         ptrdiff_t edge_tile_size() const
@@ -62,6 +68,9 @@ cdef extern from "katana/Analytics.h" namespace "katana::analytics" nogil:
         @staticmethod
         _BfsPlan SynchronousDirectOpt(uint32_t, uint32_t)
 
+        @staticmethod
+        _BfsPlan SynchronousDirectOptLazyTranspose(uint32_t, uint32_t)
+
     ptrdiff_t kDefaultEdgeTileSize "katana::analytics::BfsPlan::kDefaultEdgeTileSize"
     uint32_t kDefaultAlpha "katana::analytics::BfsPlan::kDefaultAlpha"
     uint32_t kDefaultBeta "katana::analytics::BfsPlan::kDefaultBeta"
@@ -69,7 +78,8 @@ cdef extern from "katana/Analytics.h" namespace "katana::analytics" nogil:
     Result[void] Bfs(_PropertyGraph * pg,
                      uint32_t start_node,
                      string output_property_name,
-                     _BfsPlan algo)
+                     _BfsPlan algo,
+                     _AnalyticsContext* context)
 
     Result[void] BfsAssertValid(_PropertyGraph* pg, uint32_t start_node,
                                 string property_name);
@@ -91,6 +101,7 @@ class _BfsAlgorithm(Enum):
     AsynchronousTile = _BfsPlan.Algorithm.kAsynchronousTile
     Synchronous = _BfsPlan.Algorithm.kSynchronous
     SynchronousDirectOpt = _BfsPlan.Algorithm.kSynchronousDirectOpt
+    SynchronousDirectOptLazyTranspose = _BfsPlan.Algorithm.kSynchronousDirectOptLazyTranspose
     SynchronousTile = _BfsPlan.Algorithm.kSynchronousTile
 
 
@@ -158,8 +169,17 @@ cdef class BfsPlan(Plan):
         """
         return BfsPlan.make(_BfsPlan.SynchronousDirectOpt(alpha, beta))
 
+    @staticmethod
+    def synchronous_direction_opt_lazy_transpose(int alpha=kDefaultAlpha, int beta=kDefaultBeta):
+        """
+        Bulk-synchronous using edge direction optimizations, building the transpose in the background while the
+        first top-down levels run
+        """
+        return BfsPlan.make(_BfsPlan.SynchronousDirectOptLazyTranspose(alpha, beta))
+
 
-def bfs(Graph pg, uint32_t start_node, str output_property_name, BfsPlan plan = BfsPlan()):
+def bfs(Graph pg, uint32_t start_node, str output_property_name, BfsPlan plan = BfsPlan(),
+        AnalyticsContext context = None):
     """
     Compute the Breadth-First Search parents on `pg` using `start_node` as the source. The computed parents are
     written to the property `output_property_name`.
@@ -172,6 +192,8 @@ def bfs(Graph pg, uint32_t start_node, str output_property_name, BfsPlan plan =
     :param output_property_name: The output property to write path lengths into. This property must not already exist.
     :type plan: BfsPlan
     :param plan: The execution plan to use.
+    :type context: AnalyticsContext
+    :param context: Scratch memory to reuse across calls, and a flag to cancel the call. (Optional)
 
     .. code-block:: python
 
@@ -191,8 +213,19 @@ def bfs(Graph pg, uint32_t start_node, str output_property_name, BfsPlan plan =
     """
     output_property_name_bytes = bytes(output_property_name, "utf-8")
     output_property_name_cstr = <string>output_property_name_bytes
+    cdef _AnalyticsContext* c_context = underlying_context(context)
     with nogil:
-        handle_result_void(Bfs(pg.underlying_property_graph(), start_node, output_property_name_cstr, plan.underlying_))
+        handle_result_void(
+            Bfs(pg.underlying_property_graph(), start_node, output_property_name_cstr, plan.underlying_, c_context)
+        )
+
+
+def bfs_async(Graph pg, uint32_t start_node, str output_property_name, BfsPlan plan = BfsPlan()) -> AnalyticsFuture:
+    """
+    Start :py:func:`bfs` on the analytics thread and return a future of its completion. The calling thread keeps
+    running; cancelling the future stops the search between levels.
+    """
+    return submit(bfs, pg, start_node, output_property_name, plan)
 
 def bfs_assert_valid(Graph pg, uint32_t start_node, str property_name):
     """
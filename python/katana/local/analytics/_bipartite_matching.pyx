@@ -0,0 +1,289 @@
+"""
+Bipartite Matching
+------------------
+
+.. autoclass:: katana.local.analytics.BipartiteMatchingPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.local.analytics._bipartite_matching._BipartiteMatchingPlanAlgorithm
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.local.analytics.bipartite_matching
+
+.. autofunction:: katana.local.analytics.maximum_weight_bipartite_matching
+
+.. autoclass:: katana.local.analytics.BipartiteMatchingStatistics
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.local.analytics.bipartite_matching_assert_valid
+"""
+from libc.stdint cimport uint32_t, uint64_t
+from libcpp.string cimport string
+
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libstd.iostream cimport ostream, ostringstream
+from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_result_void, raise_error_code
+from katana.local._graph cimport Graph
+from katana.local.analytics.plan cimport Plan, _Plan
+
+from enum import Enum
+
+
+cdef extern from "katana/analytics/bipartite_matching/bipartite_matching.h" namespace "katana::analytics" nogil:
+    cppclass _BipartiteMatchingPlan "katana::analytics::BipartiteMatchingPlan" (_Plan):
+        enum Algorithm:
+            kPushRelabel "katana::analytics::BipartiteMatchingPlan::kPushRelabel"
+            kPothenFan "katana::analytics::BipartiteMatchingPlan::kPothenFan"
+            kAuction "katana::analytics::BipartiteMatchingPlan::kAuction"
+
+        _BipartiteMatchingPlan.Algorithm algorithm() const
+        double epsilon() const
+
+        BipartiteMatchingPlan()
+
+        @staticmethod
+        _BipartiteMatchingPlan PushRelabel()
+
+        @staticmethod
+        _BipartiteMatchingPlan PothenFan()
+
+        @staticmethod
+        _BipartiteMatchingPlan Auction(double epsilon)
+
+    double kDefaultEpsilon "katana::analytics::BipartiteMatchingPlan::kDefaultEpsilon"
+
+    uint32_t kBipartiteMatchingUnmatched
+
+    Result[void] BipartiteMatching(
+        _PropertyGraph* pg, string left_node_type_name, string output_property_name, _BipartiteMatchingPlan plan)
+
+    Result[void] MaximumWeightBipartiteMatching(
+        _PropertyGraph* pg, string left_node_type_name, string edge_weight_property_name,
+        string output_property_name, _BipartiteMatchingPlan plan)
+
+    Result[void] BipartiteMatchingAssertValid(_PropertyGraph* pg, string left_node_type_name, string property_name)
+
+    cppclass _BipartiteMatchingStatistics "katana::analytics::BipartiteMatchingStatistics":
+        uint64_t num_matched_pairs
+        double total_weight
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_BipartiteMatchingStatistics] Compute(
+            _PropertyGraph* pg, string property_name, string edge_weight_property_name)
+
+
+UNMATCHED = kBipartiteMatchingUnmatched
+"""
+The value of the output property for unmatched nodes.
+"""
+
+
+class _BipartiteMatchingPlanAlgorithm(Enum):
+    """
+    :see: :py:class:`~katana.local.analytics.BipartiteMatchingPlan` constructors for algorithm documentation.
+    """
+    PushRelabel = _BipartiteMatchingPlan.Algorithm.kPushRelabel
+    PothenFan = _BipartiteMatchingPlan.Algorithm.kPothenFan
+    Auction = _BipartiteMatchingPlan.Algorithm.kAuction
+
+
+cdef class BipartiteMatchingPlan(Plan):
+    """
+    A computational :ref:`Plan` for Bipartite Matching.
+
+    Static methods construct BipartiteMatchingPlans.
+    """
+    cdef:
+        _BipartiteMatchingPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _BipartiteMatchingPlanAlgorithm
+
+    @staticmethod
+    cdef BipartiteMatchingPlan make(_BipartiteMatchingPlan u):
+        f = <BipartiteMatchingPlan>BipartiteMatchingPlan.__new__(BipartiteMatchingPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> _BipartiteMatchingPlanAlgorithm:
+        return _BipartiteMatchingPlanAlgorithm(self.underlying_.algorithm())
+
+    @property
+    def epsilon(self) -> float:
+        return self.underlying_.epsilon()
+
+    @staticmethod
+    def push_relabel() -> BipartiteMatchingPlan:
+        """
+        Maximum cardinality matching by asynchronous push-relabel. Free left nodes take their lowest labeled right
+        neighbor with an atomic exchange, displacing its mate. Labels are recomputed by a breadth first search from the
+        free right nodes once enough work has been done.
+        """
+        return BipartiteMatchingPlan.make(_BipartiteMatchingPlan.PushRelabel())
+
+    @staticmethod
+    def pothen_fan() -> BipartiteMatchingPlan:
+        """
+        Maximum cardinality matching by parallel augmenting paths. In each phase, every free left node searches depth
+        first, with lookahead, for an augmenting path disjoint from those of the other searches.
+        """
+        return BipartiteMatchingPlan.make(_BipartiteMatchingPlan.PothenFan())
+
+    @staticmethod
+    def auction(epsilon=kDefaultEpsilon) -> BipartiteMatchingPlan:
+        """
+        Maximum weight matching by a parallel auction with epsilon scaling. The weight of the matching is within the
+        number of left nodes times epsilon of the maximum. The default epsilon, 0, selects 1 / (number of left nodes +
+        1), which finds a maximum weight matching when the weights are integers.
+        """
+        return BipartiteMatchingPlan.make(_BipartiteMatchingPlan.Auction(epsilon))
+
+
+def bipartite_matching(
+    Graph pg,
+    str left_node_type_name,
+    str output_property_name,
+    BipartiteMatchingPlan plan = BipartiteMatchingPlan(),
+):
+    """
+    Compute a maximum cardinality matching between the nodes of the atomic node type `left_node_type_name` and the
+    other nodes. Only edges between the two sides, in either direction, are considered. Create a node property with
+    the mate of each node, or :py:data:`~katana.local.analytics._bipartite_matching.UNMATCHED` for unmatched nodes.
+    The created property has type uint32_t and may not exist before the call.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type left_node_type_name: str
+    :param left_node_type_name: The node type of the left side.
+    :type output_property_name: str
+    :param output_property_name: The output property to write mates into. This property must not already exist.
+    :type plan: BipartiteMatchingPlan
+    :param plan: The execution plan to use.
+
+    .. code-block:: python
+
+        import katana.local
+        from katana.example_data import get_input
+        from katana.local import Graph
+        katana.local.initialize()
+
+        graph = Graph(get_input("propertygraphs/ldbc_003"))
+        from katana.local.analytics import bipartite_matching, BipartiteMatchingStatistics
+        bipartite_matching(graph, "Person", "mate")
+        stats = BipartiteMatchingStatistics(graph, "mate")
+        print(stats)
+
+    """
+    cdef string left_node_type_name_str = left_node_type_name.encode("utf-8")
+    cdef string output_property_name_str = output_property_name.encode("utf-8")
+    with nogil:
+        handle_result_void(
+            BipartiteMatching(
+                pg.underlying_property_graph(), left_node_type_name_str, output_property_name_str, plan.underlying_
+            )
+        )
+
+
+def maximum_weight_bipartite_matching(
+    Graph pg,
+    str left_node_type_name,
+    str edge_weight_property_name,
+    str output_property_name,
+    BipartiteMatchingPlan plan = BipartiteMatchingPlan.auction(),
+):
+    """
+    Compute a matching of maximum total weight between the nodes of the atomic node type `left_node_type_name` and
+    the other nodes. Edges with non-positive weight are never matched. The output property is as for
+    :py:func:`~katana.local.analytics.bipartite_matching`.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type left_node_type_name: str
+    :param left_node_type_name: The node type of the left side.
+    :type edge_weight_property_name: str
+    :param edge_weight_property_name: The edge property holding the weights.
+    :type output_property_name: str
+    :param output_property_name: The output property to write mates into. This property must not already exist.
+    :type plan: BipartiteMatchingPlan
+    :param plan: The execution plan to use. It must select the auction.
+    """
+    cdef string left_node_type_name_str = left_node_type_name.encode("utf-8")
+    cdef string edge_weight_property_name_str = edge_weight_property_name.encode("utf-8")
+    cdef string output_property_name_str = output_property_name.encode("utf-8")
+    with nogil:
+        handle_result_void(
+            MaximumWeightBipartiteMatching(
+                pg.underlying_property_graph(),
+                left_node_type_name_str,
+                edge_weight_property_name_str,
+                output_property_name_str,
+                plan.underlying_,
+            )
+        )
+
+
+def bipartite_matching_assert_valid(Graph pg, str left_node_type_name, str property_name):
+    """
+    Raise an exception if the mates in `pg` are not mutual pairs of a left and a right node joined by an edge. This
+    does not check that the matching is maximum.
+
+    :raises: AssertionError
+    """
+    cdef string left_node_type_name_str = left_node_type_name.encode("utf-8")
+    cdef string property_name_str = property_name.encode("utf-8")
+    with nogil:
+        handle_result_assert(
+            BipartiteMatchingAssertValid(pg.underlying_property_graph(), left_node_type_name_str, property_name_str)
+        )
+
+
+cdef _BipartiteMatchingStatistics handle_result_BipartiteMatchingStatistics(
+    Result[_BipartiteMatchingStatistics] res
+) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class BipartiteMatchingStatistics:
+    """
+    Compute the :ref:`statistics` of a Bipartite Matching. The total weight is computed only when
+    `edge_weight_property_name` is given.
+    """
+    cdef _BipartiteMatchingStatistics underlying
+
+    def __init__(self, Graph pg, str property_name, str edge_weight_property_name = ""):
+        cdef string property_name_str = property_name.encode("utf-8")
+        cdef string edge_weight_property_name_str = edge_weight_property_name.encode("utf-8")
+        with nogil:
+            self.underlying = handle_result_BipartiteMatchingStatistics(_BipartiteMatchingStatistics.Compute(
+                pg.underlying_property_graph(), property_name_str, edge_weight_property_name_str))
+
+    @property
+    def num_matched_pairs(self) -> int:
+        """
+        The number of matched pairs.
+        """
+        return self.underlying.num_matched_pairs
+
+    @property
+    def total_weight(self) -> float:
+        """
+        The total weight of the matched pairs, each weighing as much as the heaviest edge between them.
+        """
+        return self.underlying.total_weight
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
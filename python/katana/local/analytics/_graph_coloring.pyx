@@ -0,0 +1,218 @@
+"""
+Graph Coloring
+--------------
+
+.. autoclass:: katana.local.analytics.GraphColoringPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.local.analytics._graph_coloring._GraphColoringPlanAlgorithm
+    :members:
+    :undoc-members:
+
+.. autoclass:: katana.local.analytics._graph_coloring._GraphColoringPlanPriority
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.local.analytics.graph_coloring
+
+.. autoclass:: katana.local.analytics.GraphColoringStatistics
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.local.analytics.graph_coloring_assert_valid
+"""
+from libc.stdint cimport uint32_t, uint64_t
+from libcpp.string cimport string
+
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libstd.iostream cimport ostream, ostringstream
+from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_result_void, raise_error_code
+from katana.local._graph cimport Graph
+from katana.local.analytics.plan cimport Plan, _Plan
+
+from enum import Enum
+
+
+cdef extern from "katana/analytics/graph_coloring/graph_coloring.h" namespace "katana::analytics" nogil:
+    cppclass _GraphColoringPlan "katana::analytics::GraphColoringPlan" (_Plan):
+        enum Algorithm:
+            kJonesPlassmann "katana::analytics::GraphColoringPlan::kJonesPlassmann"
+            kSpeculative "katana::analytics::GraphColoringPlan::kSpeculative"
+
+        enum Priority:
+            kRandom "katana::analytics::GraphColoringPlan::kRandom"
+            kDegree "katana::analytics::GraphColoringPlan::kDegree"
+
+        _GraphColoringPlan.Algorithm algorithm() const
+        _GraphColoringPlan.Priority priority() const
+
+        GraphColoringPlan()
+
+        @staticmethod
+        _GraphColoringPlan JonesPlassmann(_GraphColoringPlan.Priority priority)
+        @staticmethod
+        _GraphColoringPlan Speculative(_GraphColoringPlan.Priority priority)
+
+    Result[void] GraphColoring(_PropertyGraph* pg, string output_property_name, _GraphColoringPlan plan)
+
+    Result[void] GraphColoringAssertValid(_PropertyGraph* pg, string output_property_name)
+
+    cppclass _GraphColoringStatistics "katana::analytics::GraphColoringStatistics":
+        uint32_t num_colors
+        uint64_t largest_color_class
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_GraphColoringStatistics] Compute(_PropertyGraph* pg, string output_property_name)
+
+
+class _GraphColoringPlanAlgorithm(Enum):
+    """
+    :see: :py:class:`~katana.local.analytics.GraphColoringPlan` constructors for algorithm documentation.
+    """
+    JonesPlassmann = _GraphColoringPlan.Algorithm.kJonesPlassmann
+    Speculative = _GraphColoringPlan.Algorithm.kSpeculative
+
+
+class _GraphColoringPlanPriority(Enum):
+    """
+    The order in which nodes are colored.
+    """
+    Random = _GraphColoringPlan.Priority.kRandom
+    Degree = _GraphColoringPlan.Priority.kDegree
+
+
+cdef class GraphColoringPlan(Plan):
+    """
+    A computational :ref:`Plan` for Graph Coloring.
+
+    Static methods construct GraphColoringPlans.
+    """
+    cdef:
+        _GraphColoringPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _GraphColoringPlanAlgorithm
+    Priority = _GraphColoringPlanPriority
+
+    @staticmethod
+    cdef GraphColoringPlan make(_GraphColoringPlan u):
+        f = <GraphColoringPlan>GraphColoringPlan.__new__(GraphColoringPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> _GraphColoringPlanAlgorithm:
+        return _GraphColoringPlanAlgorithm(self.underlying_.algorithm())
+
+    @property
+    def priority(self) -> _GraphColoringPlanPriority:
+        return _GraphColoringPlanPriority(self.underlying_.priority())
+
+    @staticmethod
+    def jones_plassmann(priority=_GraphColoringPlanPriority.Degree) -> GraphColoringPlan:
+        """
+        Jones-Plassmann coloring: a node gets the smallest color not used by its neighbors once all of its neighbors
+        with higher priorities are colored. The coloring does not depend on the number of threads.
+        """
+        return GraphColoringPlan.make(_GraphColoringPlan.JonesPlassmann(_GraphColoringPlanPriority(priority).value))
+
+    @staticmethod
+    def speculative(priority=_GraphColoringPlanPriority.Degree) -> GraphColoringPlan:
+        """
+        Speculative iterative coloring: all uncolored nodes are colored at once, then the lower priority node of each
+        conflict is recolored, until there are no conflicts.
+        """
+        return GraphColoringPlan.make(_GraphColoringPlan.Speculative(_GraphColoringPlanPriority(priority).value))
+
+
+def graph_coloring(Graph pg, str output_property_name, GraphColoringPlan plan = GraphColoringPlan()):
+    """
+    Color the nodes of the graph so that no two neighbors have the same color, and create a property with the color
+    of each node. Colors are consecutive from 0, and self loops are ignored. The graph must be symmetric. The property
+    named output_property_name is created by this function and may not exist before the call. The created property
+    has type uint32_t.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type output_property_name: str
+    :param output_property_name: The output property to write colors into. This property must not already exist.
+    :type plan: GraphColoringPlan
+    :param plan: The execution plan to use.
+
+    .. code-block:: python
+
+        import katana.local
+        from katana.example_data import get_input
+        from katana.local import Graph
+        katana.local.initialize()
+
+        graph = Graph(get_input("propertygraphs/rmat10_symmetric"))
+        from katana.local.analytics import graph_coloring, GraphColoringStatistics
+        graph_coloring(graph, "color")
+        stats = GraphColoringStatistics(graph, "color")
+        print(stats)
+
+    """
+    output_property_name_bytes = bytes(output_property_name, "utf-8")
+    output_property_name_cstr = <string>output_property_name_bytes
+    with nogil:
+        handle_result_void(GraphColoring(pg.underlying_property_graph(), output_property_name_cstr, plan.underlying_))
+
+
+def graph_coloring_assert_valid(Graph pg, str output_property_name):
+    """
+    Raise an exception if the coloring in `pg` is invalid: if a node is not colored or two neighbors have the same
+    color.
+
+    :raises: AssertionError
+    """
+    output_property_name_bytes = bytes(output_property_name, "utf-8")
+    output_property_name_cstr = <string>output_property_name_bytes
+    with nogil:
+        handle_result_assert(GraphColoringAssertValid(pg.underlying_property_graph(), output_property_name_cstr))
+
+
+cdef _GraphColoringStatistics handle_result_GraphColoringStatistics(Result[_GraphColoringStatistics] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class GraphColoringStatistics:
+    """
+    Compute the :ref:`statistics` of a Graph Coloring.
+    """
+    cdef _GraphColoringStatistics underlying
+
+    def __init__(self, Graph pg, str output_property_name):
+        output_property_name_bytes = bytes(output_property_name, "utf-8")
+        output_property_name_cstr = <string> output_property_name_bytes
+        with nogil:
+            self.underlying = handle_result_GraphColoringStatistics(_GraphColoringStatistics.Compute(
+                pg.underlying_property_graph(), output_property_name_cstr))
+
+    @property
+    def num_colors(self) -> int:
+        """
+        The number of colors used.
+        """
+        return self.underlying.num_colors
+
+    @property
+    def largest_color_class(self) -> int:
+        """
+        The largest number of nodes with the same color.
+        """
+        return self.underlying.largest_color_class
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
@@ -0,0 +1,250 @@
+"""
+Hypergraph Partition
+--------------------
+
+.. autoclass:: katana.local.analytics.HypergraphPartitionPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.local.analytics._hypergraph_partition._HypergraphPartitionPlanAlgorithm
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.local.analytics.hypergraph_partition
+
+.. autoclass:: katana.local.analytics.HypergraphPartitionStatistics
+    :members:
+    :undoc-members:
+"""
+from libc.stdint cimport uint32_t, uint64_t
+from libcpp.string cimport string
+
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libstd.iostream cimport ostream, ostringstream
+from katana.cpp.libsupport.result cimport Result, handle_result_void, raise_error_code
+from katana.local._graph cimport Graph
+from katana.local.analytics.plan cimport Plan, _Plan
+
+from enum import Enum
+
+
+cdef extern from "katana/analytics/hypergraph_partition/hypergraph_partition.h" namespace "katana::analytics" nogil:
+    cppclass _HypergraphPartitionPlan "katana::analytics::HypergraphPartitionPlan" (_Plan):
+        enum Algorithm:
+            kRecursiveBisection "katana::analytics::HypergraphPartitionPlan::kRecursiveBisection"
+
+        _HypergraphPartitionPlan.Algorithm algorithm() const
+        double imbalance() const
+        uint32_t coarsest_nodes_per_partition() const
+        uint32_t refinement_rounds() const
+
+        HypergraphPartitionPlan()
+
+        @staticmethod
+        _HypergraphPartitionPlan RecursiveBisection(
+            double imbalance, uint32_t coarsest_nodes_per_partition, uint32_t refinement_rounds)
+
+    double kDefaultImbalance "katana::analytics::HypergraphPartitionPlan::kDefaultImbalance"
+    uint32_t kDefaultCoarsestNodesPerPartition "katana::analytics::HypergraphPartitionPlan::kDefaultCoarsestNodesPerPartition"
+    uint32_t kDefaultRefinementRounds "katana::analytics::HypergraphPartitionPlan::kDefaultRefinementRounds"
+
+    uint32_t kHypergraphPartitionHyperedge
+
+    Result[void] HypergraphPartition(
+        _PropertyGraph* pg, string hyperedge_node_type_name, uint32_t num_partitions, string output_property_name,
+        _HypergraphPartitionPlan plan)
+
+    cppclass _HypergraphPartitionStatistics "katana::analytics::HypergraphPartitionStatistics":
+        uint32_t num_partitions
+        uint64_t cut_hyperedges
+        uint64_t connectivity_cut
+        uint64_t largest_partition_size
+        double imbalance
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_HypergraphPartitionStatistics] Compute(_PropertyGraph* pg, string output_property_name)
+
+
+HYPEREDGE = kHypergraphPartitionHyperedge
+"""
+The value of the output property for hyperedge nodes.
+"""
+
+
+class _HypergraphPartitionPlanAlgorithm(Enum):
+    """
+    :see: :py:class:`~katana.local.analytics.HypergraphPartitionPlan` constructors for algorithm documentation.
+    """
+    RecursiveBisection = _HypergraphPartitionPlan.Algorithm.kRecursiveBisection
+
+
+cdef class HypergraphPartitionPlan(Plan):
+    """
+    A computational :ref:`Plan` for Hypergraph Partition.
+
+    Static methods construct HypergraphPartitionPlans.
+    """
+    cdef:
+        _HypergraphPartitionPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _HypergraphPartitionPlanAlgorithm
+
+    @staticmethod
+    cdef HypergraphPartitionPlan make(_HypergraphPartitionPlan u):
+        f = <HypergraphPartitionPlan>HypergraphPartitionPlan.__new__(HypergraphPartitionPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> _HypergraphPartitionPlanAlgorithm:
+        return _HypergraphPartitionPlanAlgorithm(self.underlying_.algorithm())
+
+    @property
+    def imbalance(self) -> float:
+        return self.underlying_.imbalance()
+
+    @property
+    def coarsest_nodes_per_partition(self) -> int:
+        return self.underlying_.coarsest_nodes_per_partition()
+
+    @property
+    def refinement_rounds(self) -> int:
+        return self.underlying_.refinement_rounds()
+
+    @staticmethod
+    def recursive_bisection(
+        imbalance=kDefaultImbalance,
+        coarsest_nodes_per_partition=kDefaultCoarsestNodesPerPartition,
+        refinement_rounds=kDefaultRefinementRounds,
+    ) -> HypergraphPartitionPlan:
+        """
+        Recursive multilevel bisection followed by direct k-way refinement. The independent subproblems of each level
+        of the recursion run concurrently. Coarsening and bisection are deterministic but k-way refinement depends on
+        the schedule.
+        """
+        return HypergraphPartitionPlan.make(
+            _HypergraphPartitionPlan.RecursiveBisection(imbalance, coarsest_nodes_per_partition, refinement_rounds)
+        )
+
+
+def hypergraph_partition(
+    Graph pg,
+    str hyperedge_node_type_name,
+    uint32_t num_partitions,
+    str output_property_name,
+    HypergraphPartitionPlan plan = HypergraphPartitionPlan(),
+):
+    """
+    Partition a hypergraph stored as a bipartite graph: the nodes of the atomic node type `hyperedge_node_type_name`
+    are hyperedges, and their other neighbors, by edges in either direction, are their pins. The other nodes are split
+    into num_partitions parts of at most (1 + imbalance) times the average number of nodes, minimizing the sum over
+    hyperedges of one less than the number of parts they span. Create a node property with the partition of each node,
+    or :py:data:`~katana.local.analytics._hypergraph_partition.HYPEREDGE` for hyperedges. The created property has type
+    uint32_t and may not exist before the call.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type hyperedge_node_type_name: str
+    :param hyperedge_node_type_name: The node type of the hyperedges.
+    :type num_partitions: int
+    :param num_partitions: The number of partitions.
+    :type output_property_name: str
+    :param output_property_name: The output property to write partition IDs into. This property must not already
+        exist.
+    :type plan: HypergraphPartitionPlan
+    :param plan: The execution plan to use.
+
+    .. code-block:: python
+
+        import katana.local
+        from katana.example_data import get_input
+        from katana.local import Graph
+        katana.local.initialize()
+
+        graph = Graph(get_input("propertygraphs/ldbc_003"))
+        from katana.local.analytics import hypergraph_partition, HypergraphPartitionStatistics
+        hypergraph_partition(graph, "Person", 4, "partition")
+        stats = HypergraphPartitionStatistics(graph, "partition")
+        print(stats)
+
+    """
+    cdef string hyperedge_node_type_name_str = hyperedge_node_type_name.encode("utf-8")
+    cdef string output_property_name_str = output_property_name.encode("utf-8")
+    with nogil:
+        handle_result_void(
+            HypergraphPartition(
+                pg.underlying_property_graph(),
+                hyperedge_node_type_name_str,
+                num_partitions,
+                output_property_name_str,
+                plan.underlying_,
+            )
+        )
+
+
+cdef _HypergraphPartitionStatistics handle_result_HypergraphPartitionStatistics(
+        Result[_HypergraphPartitionStatistics] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class HypergraphPartitionStatistics:
+    """
+    Compute the :ref:`statistics` of a Hypergraph Partition.
+    """
+    cdef _HypergraphPartitionStatistics underlying
+
+    def __init__(self, Graph pg, str output_property_name):
+        output_property_name_bytes = bytes(output_property_name, "utf-8")
+        output_property_name_cstr = <string> output_property_name_bytes
+        with nogil:
+            self.underlying = handle_result_HypergraphPartitionStatistics(_HypergraphPartitionStatistics.Compute(
+                pg.underlying_property_graph(), output_property_name_cstr))
+
+    @property
+    def num_partitions(self) -> int:
+        """
+        The number of partitions, one more than the largest partition ID.
+        """
+        return self.underlying.num_partitions
+
+    @property
+    def cut_hyperedges(self) -> int:
+        """
+        The number of hyperedges with pins in more than one partition.
+        """
+        return self.underlying.cut_hyperedges
+
+    @property
+    def connectivity_cut(self) -> int:
+        """
+        The sum over hyperedges of one less than the number of partitions they span.
+        """
+        return self.underlying.connectivity_cut
+
+    @property
+    def largest_partition_size(self) -> int:
+        """
+        The largest number of nodes in a partition.
+        """
+        return self.underlying.largest_partition_size
+
+    @property
+    def imbalance(self) -> float:
+        """
+        The ratio of the largest partition size to the average.
+        """
+        return self.underlying.imbalance
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
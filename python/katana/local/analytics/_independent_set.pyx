@@ -38,6 +38,8 @@ cdef extern from "katana/analytics/independent_set/independent_set.h" namespace
             kPull "katana::analytics::IndependentSetPlan::kPull"
             kPriority "katana::analytics::IndependentSetPlan::kPriority"
             kEdgeTiledPriority "katana::analytics::IndependentSetPlan::kEdgeTiledPriority"
+            kLuby "katana::analytics::IndependentSetPlan::kLuby"
+            kDeterministic "katana::analytics::IndependentSetPlan::kDeterministic"
 
         # unsigned int kChunkSize
 
@@ -56,6 +58,10 @@ cdef extern from "katana/analytics/independent_set/independent_set.h" namespace
         _IndependentSetPlan Priority()
         @staticmethod
         _IndependentSetPlan EdgeTiledPriority()
+        @staticmethod
+        _IndependentSetPlan Luby()
+        @staticmethod
+        _IndependentSetPlan Deterministic()
 
     Result[void] IndependentSet(_PropertyGraph* pg, string output_property_name, _IndependentSetPlan plan)
 
@@ -78,6 +84,8 @@ class _IndependentSetPlanAlgorithm(Enum):
     Pull = _IndependentSetPlan.Algorithm.kPull
     Priority = _IndependentSetPlan.Algorithm.kPriority
     EdgeTiledPriority = _IndependentSetPlan.Algorithm.kEdgeTiledPriority
+    Luby = _IndependentSetPlan.Algorithm.kLuby
+    Deterministic = _IndependentSetPlan.Algorithm.kDeterministic
 
 
 cdef class IndependentSetPlan(Plan):
@@ -120,6 +128,22 @@ cdef class IndependentSetPlan(Plan):
     def edge_tiled_priority():
         return IndependentSetPlan.make(_IndependentSetPlan.EdgeTiledPriority())
 
+    @staticmethod
+    def luby():
+        """
+        Luby's algorithm with fixed priorities that favor low degree nodes. The set found does not depend on the number
+        of threads.
+        """
+        return IndependentSetPlan.make(_IndependentSetPlan.Luby())
+
+    @staticmethod
+    def deterministic():
+        """
+        Find the set a serial greedy pass finds taking nodes in a fixed pseudo-random order, in bulk-synchronous rounds.
+        The set is the same on every run and for any number of threads.
+        """
+        return IndependentSetPlan.make(_IndependentSetPlan.Deterministic())
+
 
 def independent_set(Graph pg, str output_property_name,
              IndependentSetPlan plan = IndependentSetPlan()):
@@ -13,6 +13,8 @@ k-Core
 
 .. autofunction:: katana.local.analytics.k_core
 
+.. autofunction:: katana.local.analytics.k_core_numbers
+
 .. autoclass:: katana.local.analytics.KCoreStatistics
     :members:
     :undoc-members:
@@ -36,6 +38,7 @@ cdef extern from "katana/analytics/k_core/k_core.h" namespace "katana::analytics
         enum Algorithm:
             kSynchronous "katana::analytics::KCorePlan::kSynchronous"
             kAsynchronous "katana::analytics::KCorePlan::kAsynchronous"
+            kBucketPeeling "katana::analytics::KCorePlan::kBucketPeeling"
 
         _KCorePlan.Algorithm algorithm() const
 
@@ -45,10 +48,14 @@ cdef extern from "katana/analytics/k_core/k_core.h" namespace "katana::analytics
         _KCorePlan Synchronous()
         @staticmethod
         _KCorePlan Asynchronous()
+        @staticmethod
+        _KCorePlan BucketPeeling()
 
     Result[void] KCore(_PropertyGraph* pg, uint32_t k_core_number, string output_property_name, _KCorePlan plan)
 
 
+    Result[void] KCoreNumbers(_PropertyGraph* pg, string output_property_name)
+
     Result[void] KCoreAssertValid(_PropertyGraph* pg, uint32_t k_core_number, string output_property_name)
 
     cppclass _KCoreStatistics "katana::analytics::KCoreStatistics":
@@ -66,6 +73,7 @@ class _KCorePlanAlgorithm(Enum):
     """
     Synchronous = _KCorePlan.Algorithm.kSynchronous
     Asynchronous = _KCorePlan.Algorithm.kAsynchronous
+    BucketPeeling = _KCorePlan.Algorithm.kBucketPeeling
 
 
 cdef class KCorePlan(Plan):
@@ -104,6 +112,12 @@ cdef class KCorePlan(Plan):
         Asynchronous
         """
         return KCorePlan.make(_KCorePlan.Asynchronous())
+    @staticmethod
+    def bucket_peeling() -> KCorePlan:
+        """
+        Bucket peeling, computing the core numbers of all nodes at once
+        """
+        return KCorePlan.make(_KCorePlan.BucketPeeling())
 
 
 def k_core(Graph pg, uint32_t k_core_number, str output_property_name, KCorePlan plan = KCorePlan()) -> int:
@@ -140,6 +154,23 @@ def k_core(Graph pg, uint32_t k_core_number, str output_property_name, KCorePlan
     return v
 
 
+def k_core_numbers(Graph pg, str output_property_name) -> int:
+    """
+    Compute the core number of every node of pg, the largest k such that the node is in the k-core. The pg must be
+    symmetric.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type output_property_name: str
+    :param output_property_name: The output property holding the core number of each node as a uint32.
+        This property must not already exist.
+    """
+    cdef string output_property_name_str = output_property_name.encode("utf-8")
+    with nogil:
+        v = handle_result_void(KCoreNumbers(pg.underlying_property_graph(), output_property_name_str))
+    return v
+
+
 def k_core_assert_valid(Graph pg, uint32_t k_core_number, str output_property_name):
     """
     Raise an exception if the k-core results in `pg` are invalid. This is not an exhaustive check, just a sanity check.
@@ -15,6 +15,8 @@ The k-Truss is a maximal connected subgraph in which all edges are part of at le
 
 .. autofunction:: katana.local.analytics.k_truss
 
+.. autofunction:: katana.local.analytics.k_truss_numbers
+
 .. autoclass:: katana.local.analytics.KTrussStatistics
     :members:
     :undoc-members:
@@ -39,6 +41,7 @@ cdef extern from "katana/analytics/k_truss/k_truss.h" namespace "katana::analyti
             kBsp "katana::analytics::KTrussPlan::kBsp"
             kBspJacobi "katana::analytics::KTrussPlan::kBspJacobi"
             kBspCoreThenTruss "katana::analytics::KTrussPlan::kBspCoreThenTruss"
+            kTrussDecomposition "katana::analytics::KTrussPlan::kTrussDecomposition"
 
         _KTrussPlan.Algorithm algorithm() const
 
@@ -50,9 +53,13 @@ cdef extern from "katana/analytics/k_truss/k_truss.h" namespace "katana::analyti
         _KTrussPlan BspJacobi()
         @staticmethod
         _KTrussPlan BspCoreThenTruss()
+        @staticmethod
+        _KTrussPlan TrussDecomposition()
 
     Result[void] KTruss(_PropertyGraph* pg, uint32_t k_truss_number,string output_property_name, _KTrussPlan plan)
 
+    Result[void] KTrussNumbers(_PropertyGraph* pg, string output_property_name)
+
     Result[void] KTrussAssertValid(_PropertyGraph* pg, uint32_t k_truss_number,
                                    string output_property_name)
 
@@ -73,6 +80,7 @@ class _KTrussPlanAlgorithm(Enum):
     Bsp = _KTrussPlan.Algorithm.kBsp
     BspJacobi = _KTrussPlan.Algorithm.kBspJacobi
     BspCoreThenTruss = _KTrussPlan.Algorithm.kBspCoreThenTruss
+    TrussDecomposition = _KTrussPlan.Algorithm.kTrussDecomposition
 
 
 cdef class KTrussPlan(Plan):
@@ -120,6 +128,14 @@ cdef class KTrussPlan(Plan):
         """
         return KTrussPlan.make(_KTrussPlan.BspCoreThenTruss())
 
+    @staticmethod
+    def truss_decomposition() -> KTrussPlan:
+        """
+        Compute the trussness of every edge at once by peeling edges in order of support, and keep edges whose
+        trussness is at least k.
+        """
+        return KTrussPlan.make(_KTrussPlan.TrussDecomposition())
+
 
 def k_truss(Graph pg, uint32_t k_truss_number, str output_property_name, KTrussPlan plan = KTrussPlan()) -> int:
     """
@@ -155,6 +171,23 @@ def k_truss(Graph pg, uint32_t k_truss_number, str output_property_name, KTrussP
     return v
 
 
+def k_truss_numbers(Graph pg, str output_property_name) -> int:
+    """
+    Compute the trussness of every edge of pg, the largest k such that the edge is in the k-truss. `pg` must be
+    symmetric. Edges in no triangle have trussness 2.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type output_property_name: str
+    :param output_property_name: The output edge property holding the trussness of each edge as a uint32.
+        This property must not already exist.
+    """
+    cdef string output_property_name_str = output_property_name.encode("utf-8")
+    with nogil:
+        v = handle_result_void(KTrussNumbers(pg.underlying_property_graph(), output_property_name_str))
+    return v
+
+
 def k_truss_assert_valid(Graph pg, uint32_t k_truss_number, str output_property_name):
     """
     Raise an exception if the k-truss results in `pg` are invalid. This is not an exhaustive check, just a sanity check.
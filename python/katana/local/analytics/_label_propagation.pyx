@@ -0,0 +1,214 @@
+"""
+Label Propagation
+-----------------
+
+.. autoclass:: katana.local.analytics.LabelPropagationPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.local.analytics._label_propagation._LabelPropagationPlanAlgorithm
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.local.analytics.label_propagation
+
+.. autoclass:: katana.local.analytics.LabelPropagationStatistics
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.local.analytics.label_propagation_assert_valid
+"""
+from libc.stdint cimport uint32_t, uint64_t
+from libcpp.string cimport string
+
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libstd.iostream cimport ostream, ostringstream
+from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_result_void, raise_error_code
+from katana.local._graph cimport Graph
+from katana.local.analytics.plan cimport Plan, _Plan
+
+from enum import Enum
+
+
+cdef extern from "katana/analytics/label_propagation/label_propagation.h" namespace "katana::analytics" nogil:
+    cppclass _LabelPropagationPlan "katana::analytics::LabelPropagationPlan" (_Plan):
+        enum Algorithm:
+            kFrontier "katana::analytics::LabelPropagationPlan::kFrontier"
+
+        _LabelPropagationPlan.Algorithm algorithm() const
+        double changed_fraction_threshold() const
+        uint32_t max_iterations() const
+
+        LabelPropagationPlan()
+
+        @staticmethod
+        _LabelPropagationPlan Frontier(double changed_fraction_threshold, uint32_t max_iterations)
+
+    double kDefaultChangedFractionThreshold "katana::analytics::LabelPropagationPlan::kDefaultChangedFractionThreshold"
+    uint32_t kDefaultMaxIterations "katana::analytics::LabelPropagationPlan::kDefaultMaxIterations"
+
+    Result[void] LabelPropagation(_PropertyGraph* pg, string output_property_name, _LabelPropagationPlan plan)
+
+    Result[void] LabelPropagationAssertValid(_PropertyGraph* pg, string property_name)
+
+    cppclass _LabelPropagationStatistics "katana::analytics::LabelPropagationStatistics":
+        uint64_t total_communities
+        uint64_t total_non_trivial_communities
+        uint64_t largest_community_size
+        double largest_community_ratio
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_LabelPropagationStatistics] Compute(_PropertyGraph* pg, string property_name)
+
+
+class _LabelPropagationPlanAlgorithm(Enum):
+    """
+    :see: :py:class:`~katana.local.analytics.LabelPropagationPlan` constructors for algorithm documentation.
+    """
+    Frontier = _LabelPropagationPlan.Algorithm.kFrontier
+
+
+cdef class LabelPropagationPlan(Plan):
+    """
+    A computational :ref:`Plan` for Label Propagation.
+
+    Static methods construct LabelPropagationPlans.
+    """
+    cdef:
+        _LabelPropagationPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _LabelPropagationPlanAlgorithm
+
+    @staticmethod
+    cdef LabelPropagationPlan make(_LabelPropagationPlan u):
+        f = <LabelPropagationPlan>LabelPropagationPlan.__new__(LabelPropagationPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> _LabelPropagationPlanAlgorithm:
+        return _LabelPropagationPlanAlgorithm(self.underlying_.algorithm())
+
+    @property
+    def changed_fraction_threshold(self) -> float:
+        return self.underlying_.changed_fraction_threshold()
+
+    @property
+    def max_iterations(self) -> int:
+        return self.underlying_.max_iterations()
+
+    @staticmethod
+    def frontier(
+        changed_fraction_threshold=kDefaultChangedFractionThreshold, max_iterations=kDefaultMaxIterations
+    ) -> LabelPropagationPlan:
+        """
+        Asynchronous label propagation: every node in the frontier takes the most frequent label among its
+        neighbors, and the neighbors of the nodes that changed form the frontier of the next round. Stop after a
+        round in which fewer than `changed_fraction_threshold` of the nodes changed, or after `max_iterations`
+        rounds.
+        """
+        return LabelPropagationPlan.make(_LabelPropagationPlan.Frontier(changed_fraction_threshold, max_iterations))
+
+
+def label_propagation(Graph pg, str output_property_name, LabelPropagationPlan plan = LabelPropagationPlan()):
+    """
+    Detect communities in `pg` by label propagation, treating edges as undirected, and create a node property with
+    the label of every node, which is the ID of the node whose label spread to its community. The created property
+    has type uint32_t and may not exist before the call.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type output_property_name: str
+    :param output_property_name: The output property to write labels into. This property must not already exist.
+    :type plan: LabelPropagationPlan
+    :param plan: The execution plan to use.
+
+    .. code-block:: python
+
+        import katana.local
+        from katana.example_data import get_input
+        from katana.local import Graph
+        katana.local.initialize()
+
+        graph = Graph(get_input("propertygraphs/rmat15"))
+        from katana.local.analytics import label_propagation, LabelPropagationStatistics
+        label_propagation(graph, "output")
+        stats = LabelPropagationStatistics(graph, "output")
+        print(stats)
+
+    """
+    cdef string output_property_name_str = output_property_name.encode("utf-8")
+    with nogil:
+        handle_result_void(LabelPropagation(pg.underlying_property_graph(), output_property_name_str, plan.underlying_))
+
+
+def label_propagation_assert_valid(Graph pg, str property_name):
+    """
+    Raise an exception if a label in `pg` is not a node ID.
+
+    :raises: AssertionError
+    """
+    cdef string property_name_str = property_name.encode("utf-8")
+    with nogil:
+        handle_result_assert(LabelPropagationAssertValid(pg.underlying_property_graph(), property_name_str))
+
+
+cdef _LabelPropagationStatistics handle_result_LabelPropagationStatistics(
+    Result[_LabelPropagationStatistics] res
+) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class LabelPropagationStatistics:
+    """
+    Compute the :ref:`statistics` of Label Propagation.
+    """
+    cdef _LabelPropagationStatistics underlying
+
+    def __init__(self, Graph pg, str property_name):
+        cdef string property_name_str = property_name.encode("utf-8")
+        with nogil:
+            self.underlying = handle_result_LabelPropagationStatistics(
+                _LabelPropagationStatistics.Compute(pg.underlying_property_graph(), property_name_str))
+
+    @property
+    def total_communities(self) -> int:
+        """
+        Total number of communities in the graph.
+        """
+        return self.underlying.total_communities
+
+    @property
+    def total_non_trivial_communities(self) -> int:
+        """
+        Total number of communities with more than 1 node.
+        """
+        return self.underlying.total_non_trivial_communities
+
+    @property
+    def largest_community_size(self) -> int:
+        """
+        The number of nodes present in the largest community.
+        """
+        return self.underlying.largest_community_size
+
+    @property
+    def largest_community_ratio(self) -> float:
+        """
+        The ratio of nodes present in the largest community.
+        """
+        return self.underlying.largest_community_ratio
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
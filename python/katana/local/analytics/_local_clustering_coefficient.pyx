@@ -31,6 +31,7 @@ cdef extern from "katana/analytics/local_clustering_coefficient/local_clustering
         enum Algorithm:
             kOrderedCountAtomics "katana::analytics::LocalClusteringCoefficientPlan::kOrderedCountAtomics"
             kOrderedCountPerThread "katana::analytics::LocalClusteringCoefficientPlan::kOrderedCountPerThread"
+            kOrderedCountHybrid "katana::analytics::LocalClusteringCoefficientPlan::kOrderedCountHybrid"
 
         enum Relabeling:
             kRelabel "katana::analytics::LocalClusteringCoefficientPlan::kRelabel"
@@ -53,6 +54,11 @@ cdef extern from "katana/analytics/local_clustering_coefficient/local_clustering
                 bool edges_sorted,
                 _LocalClusteringCoefficientPlan.Relabeling relabeling
             )
+        @staticmethod
+        _LocalClusteringCoefficientPlan OrderedCountHybrid(
+                bool edges_sorted,
+                _LocalClusteringCoefficientPlan.Relabeling relabeling
+            )
 
     _LocalClusteringCoefficientPlan.Relabeling kDefaultRelabeling "katana::analytics::LocalClusteringCoefficientPlan::kDefaultRelabeling"
     bool kDefaultEdgesSorted "katana::analytics::LocalClusteringCoefficientPlan::kDefaultEdgesSorted"
@@ -66,6 +72,7 @@ class _LocalClusteringCoefficientPlanAlgorithm(Enum):
     """
     OrderedCountAtomics = _LocalClusteringCoefficientPlan.Algorithm.kOrderedCountAtomics
     OrderedCountPerThread = _LocalClusteringCoefficientPlan.Algorithm.kOrderedCountPerThread
+    OrderedCountHybrid = _LocalClusteringCoefficientPlan.Algorithm.kOrderedCountHybrid
 
 
 cdef _relabeling_to_python(v):
@@ -143,7 +150,8 @@ cdef class LocalClusteringCoefficientPlan(Plan):
         ordered count algorithm from the following:
         http://gap.cs.berkeley.edu/benchmark.html
 
-        This algorithm uses thread-local counters for parallel counting.
+        This algorithm uses thread-local counters for parallel counting. It
+        needs a counter per node per thread, so it only suits small graphs.
 
         :param relabeling: Should the algorithm relabel the nodes.
         :param edges_sorted: Are the edges of the graph already sorted.
@@ -151,6 +159,26 @@ cdef class LocalClusteringCoefficientPlan(Plan):
         return LocalClusteringCoefficientPlan.make(_LocalClusteringCoefficientPlan.OrderedCountPerThread(
              edges_sorted, _relabeling_from_python(relabeling)))
 
+    @staticmethod
+    def ordered_count_hybrid(
+                relabeling = _relabeling_to_python(kDefaultRelabeling),
+                bool edges_sorted = kDefaultEdgesSorted
+            ):
+        """
+        An ordered count algorithm that sorts the nodes by degree before
+        execution. We implement the ordered count algorithm from the following:
+        http://gap.cs.berkeley.edu/benchmark.html
+
+        This algorithm combines counts in small thread-local caches and adds
+        them to shared counters with atomic instructions, so its memory does
+        not grow with the number of threads. This is the default.
+
+        :param relabeling: Should the algorithm relabel the nodes.
+        :param edges_sorted: Are the edges of the graph already sorted.
+        """
+        return LocalClusteringCoefficientPlan.make(_LocalClusteringCoefficientPlan.OrderedCountHybrid(
+             edges_sorted, _relabeling_from_python(relabeling)))
+
 
 def local_clustering_coefficient(Graph pg, str output_property_name, LocalClusteringCoefficientPlan plan = LocalClusteringCoefficientPlan()):
     cdef string output_property_name_str = bytes(output_property_name, "utf-8")
@@ -39,6 +39,7 @@ cdef extern from "katana/analytics/louvain_clustering/louvain_clustering.h" name
         enum Algorithm:
             kDoAll "katana::analytics::LouvainClusteringPlan::kDoAll"
             kDeterministic "katana::analytics::LouvainClusteringPlan::kDeterministic"
+            kLeiden "katana::analytics::LouvainClusteringPlan::kLeiden"
 
         _LouvainClusteringPlan.Algorithm algorithm() const
         bool enable_vf() const
@@ -66,6 +67,14 @@ cdef extern from "katana/analytics/louvain_clustering/louvain_clustering.h" name
             uint32_t max_iterations,
             uint32_t min_graph_size)
 
+        @staticmethod
+        _LouvainClusteringPlan Leiden(
+            bool enable_vf,
+            double modularity_threshold_per_round,
+            double modularity_threshold_total,
+            uint32_t max_iterations,
+            uint32_t min_graph_size)
+
     bool kDefaultEnableVF "katana::analytics::LouvainClusteringPlan::kDefaultEnableVF"
     double kDefaultModularityThresholdPerRound "katana::analytics::LouvainClusteringPlan::kDefaultModularityThresholdPerRound"
     double kDefaultModularityThresholdTotal "katana::analytics::LouvainClusteringPlan::kDefaultModularityThresholdTotal"
@@ -101,6 +110,7 @@ class _LouvainClusteringPlanAlgorithm(Enum):
     """
     DoAll = _LouvainClusteringPlan.Algorithm.kDoAll
     Deterministic = _LouvainClusteringPlan.Algorithm.kDeterministic
+    Leiden = _LouvainClusteringPlan.Algorithm.kLeiden
 
 
 cdef class LouvainClusteringPlan(Plan):
@@ -171,6 +181,21 @@ cdef class LouvainClusteringPlan(Plan):
         return LouvainClusteringPlan.make(_LouvainClusteringPlan.Deterministic(
             enable_vf, modularity_threshold_per_round, modularity_threshold_total, max_iterations, min_graph_size))
 
+    @staticmethod
+    def leiden(
+            bool enable_vf = kDefaultEnableVF,
+            double modularity_threshold_per_round = kDefaultModularityThresholdPerRound,
+            double modularity_threshold_total = kDefaultModularityThresholdTotal,
+            uint32_t max_iterations = kDefaultMaxIterations,
+            uint32_t min_graph_size = kDefaultMinGraphSize
+    ) -> LouvainClusteringPlan:
+        """
+        Leiden algorithm: do_all local moving with a refinement of every
+        cluster into well connected sub-clusters
+        """
+        return LouvainClusteringPlan.make(_LouvainClusteringPlan.Leiden(
+            enable_vf, modularity_threshold_per_round, modularity_threshold_total, max_iterations, min_graph_size))
+
 def louvain_clustering(Graph pg, str edge_weight_property_name, str output_property_name, LouvainClusteringPlan plan = LouvainClusteringPlan()):
     """
     Compute the Louvain Clustering for pg.
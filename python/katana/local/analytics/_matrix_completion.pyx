@@ -0,0 +1,267 @@
+"""
+Matrix Completion
+-----------------
+
+.. autoclass:: katana.local.analytics.MatrixCompletionPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.local.analytics._matrix_completion._MatrixCompletionPlanAlgorithm
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.local.analytics.matrix_completion
+
+.. autoclass:: katana.local.analytics.MatrixCompletionStatistics
+    :members:
+    :undoc-members:
+"""
+from libc.stdint cimport uint32_t
+from libcpp.string cimport string
+
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libstd.iostream cimport ostream, ostringstream
+from katana.cpp.libsupport.result cimport Result, handle_result_void, raise_error_code
+from katana.local._graph cimport Graph
+from katana.local.analytics.plan cimport Plan, _Plan
+
+from enum import Enum
+
+
+cdef extern from "katana/analytics/matrix_completion/matrix_completion.h" namespace "katana::analytics" nogil:
+    cppclass _MatrixCompletionPlan "katana::analytics::MatrixCompletionPlan" (_Plan):
+        enum Algorithm:
+            kSGD "katana::analytics::MatrixCompletionPlan::kSGD"
+            kALS "katana::analytics::MatrixCompletionPlan::kALS"
+
+        _MatrixCompletionPlan.Algorithm algorithm() const
+        uint32_t latent_vector_size() const
+        double lambda_ "lambda"() const
+        double learning_rate() const
+        double decay_rate() const
+        double tolerance() const
+        uint32_t max_iterations() const
+        uint32_t users_per_block() const
+        uint32_t items_per_block() const
+
+        MatrixCompletionPlan()
+
+        @staticmethod
+        _MatrixCompletionPlan SGD(
+            uint32_t latent_vector_size,
+            double lambda_,
+            double learning_rate,
+            double decay_rate,
+            double tolerance,
+            uint32_t max_iterations,
+            uint32_t users_per_block,
+            uint32_t items_per_block)
+
+        @staticmethod
+        _MatrixCompletionPlan ALS(uint32_t latent_vector_size, double lambda_, double tolerance, uint32_t max_iterations)
+
+    uint32_t kDefaultLatentVectorSize "katana::analytics::MatrixCompletionPlan::kDefaultLatentVectorSize"
+    double kDefaultLambda "katana::analytics::MatrixCompletionPlan::kDefaultLambda"
+    double kDefaultLearningRate "katana::analytics::MatrixCompletionPlan::kDefaultLearningRate"
+    double kDefaultDecayRate "katana::analytics::MatrixCompletionPlan::kDefaultDecayRate"
+    double kDefaultTolerance "katana::analytics::MatrixCompletionPlan::kDefaultTolerance"
+    uint32_t kDefaultMaxIterations "katana::analytics::MatrixCompletionPlan::kDefaultMaxIterations"
+    uint32_t kDefaultUsersPerBlock "katana::analytics::MatrixCompletionPlan::kDefaultUsersPerBlock"
+    uint32_t kDefaultItemsPerBlock "katana::analytics::MatrixCompletionPlan::kDefaultItemsPerBlock"
+
+    Result[void] MatrixCompletion(
+        _PropertyGraph* pg, string rating_property_name, string output_property_name, _MatrixCompletionPlan plan)
+
+    cppclass _MatrixCompletionStatistics "katana::analytics::MatrixCompletionStatistics":
+        double rmse
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_MatrixCompletionStatistics] Compute(
+            _PropertyGraph* pg, string rating_property_name, string output_property_name)
+
+
+class _MatrixCompletionPlanAlgorithm(Enum):
+    """
+    :see: :py:class:`~katana.local.analytics.MatrixCompletionPlan` constructors for algorithm documentation.
+    """
+    SGD = _MatrixCompletionPlan.Algorithm.kSGD
+    ALS = _MatrixCompletionPlan.Algorithm.kALS
+
+
+cdef class MatrixCompletionPlan(Plan):
+    """
+    A computational :ref:`Plan` for Matrix Completion.
+
+    Static methods construct MatrixCompletionPlans.
+    """
+    cdef:
+        _MatrixCompletionPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _MatrixCompletionPlanAlgorithm
+
+    @staticmethod
+    cdef MatrixCompletionPlan make(_MatrixCompletionPlan u):
+        f = <MatrixCompletionPlan>MatrixCompletionPlan.__new__(MatrixCompletionPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> _MatrixCompletionPlanAlgorithm:
+        return _MatrixCompletionPlanAlgorithm(self.underlying_.algorithm())
+
+    @property
+    def latent_vector_size(self) -> int:
+        return self.underlying_.latent_vector_size()
+
+    @property
+    def lambda_(self) -> float:
+        return self.underlying_.lambda_()
+
+    @property
+    def learning_rate(self) -> float:
+        return self.underlying_.learning_rate()
+
+    @property
+    def decay_rate(self) -> float:
+        return self.underlying_.decay_rate()
+
+    @property
+    def tolerance(self) -> float:
+        return self.underlying_.tolerance()
+
+    @property
+    def max_iterations(self) -> int:
+        return self.underlying_.max_iterations()
+
+    @property
+    def users_per_block(self) -> int:
+        return self.underlying_.users_per_block()
+
+    @property
+    def items_per_block(self) -> int:
+        return self.underlying_.items_per_block()
+
+    @staticmethod
+    def sgd(
+        latent_vector_size=kDefaultLatentVectorSize,
+        lambda_=kDefaultLambda,
+        learning_rate=kDefaultLearningRate,
+        decay_rate=kDefaultDecayRate,
+        tolerance=kDefaultTolerance,
+        max_iterations=kDefaultMaxIterations,
+        users_per_block=kDefaultUsersPerBlock,
+        items_per_block=kDefaultItemsPerBlock,
+    ) -> MatrixCompletionPlan:
+        """
+        Lock-free stochastic gradient descent over blocks of users and items. The step size of round r is
+        learning_rate * 1.5 / (1 + decay_rate * (r + 1)^1.5).
+        """
+        return MatrixCompletionPlan.make(
+            _MatrixCompletionPlan.SGD(
+                latent_vector_size,
+                lambda_,
+                learning_rate,
+                decay_rate,
+                tolerance,
+                max_iterations,
+                users_per_block,
+                items_per_block,
+            )
+        )
+
+    @staticmethod
+    def als(
+        latent_vector_size=kDefaultLatentVectorSize,
+        lambda_=kDefaultLambda,
+        tolerance=kDefaultTolerance,
+        max_iterations=kDefaultMaxIterations,
+    ) -> MatrixCompletionPlan:
+        """
+        Alternating least squares with weighted regularization. The results do not depend on the number of threads.
+        """
+        return MatrixCompletionPlan.make(
+            _MatrixCompletionPlan.ALS(latent_vector_size, lambda_, tolerance, max_iterations)
+        )
+
+
+def matrix_completion(
+    Graph pg, str rating_property_name, str output_property_name, MatrixCompletionPlan plan = MatrixCompletionPlan()
+):
+    """
+    Factor the ratings that users give items into latent vectors, so that the inner product of the latent vectors of
+    a user and an item approximates the rating, and create a property with the latent vector of each node. Each edge
+    is a rating from a user to an item, and no node may have both in- and out-edges. The property named
+    output_property_name is created by this function and may not exist before the call. The created property is a
+    fixed size list of float32.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type rating_property_name: str
+    :param rating_property_name: A numeric edge property with the ratings.
+    :type output_property_name: str
+    :param output_property_name: The output property to write latent vectors into. This property must not already
+        exist.
+    :type plan: MatrixCompletionPlan
+    :param plan: The execution plan to use.
+
+    .. code-block:: python
+
+        from katana.local.analytics import matrix_completion, MatrixCompletionStatistics
+        matrix_completion(graph, "rating", "latent")
+        stats = MatrixCompletionStatistics(graph, "rating", "latent")
+        print(stats)
+
+    """
+    rating_property_name_bytes = bytes(rating_property_name, "utf-8")
+    rating_property_name_cstr = <string>rating_property_name_bytes
+    output_property_name_bytes = bytes(output_property_name, "utf-8")
+    output_property_name_cstr = <string>output_property_name_bytes
+    with nogil:
+        handle_result_void(
+            MatrixCompletion(
+                pg.underlying_property_graph(), rating_property_name_cstr, output_property_name_cstr, plan.underlying_
+            )
+        )
+
+
+cdef _MatrixCompletionStatistics handle_result_MatrixCompletionStatistics(
+    Result[_MatrixCompletionStatistics] res
+) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class MatrixCompletionStatistics:
+    """
+    Compute the :ref:`statistics` of a Matrix Completion.
+    """
+    cdef _MatrixCompletionStatistics underlying
+
+    def __init__(self, Graph pg, str rating_property_name, str output_property_name):
+        rating_property_name_bytes = bytes(rating_property_name, "utf-8")
+        rating_property_name_cstr = <string> rating_property_name_bytes
+        output_property_name_bytes = bytes(output_property_name, "utf-8")
+        output_property_name_cstr = <string> output_property_name_bytes
+        with nogil:
+            self.underlying = handle_result_MatrixCompletionStatistics(_MatrixCompletionStatistics.Compute(
+                pg.underlying_property_graph(), rating_property_name_cstr, output_property_name_cstr))
+
+    @property
+    def rmse(self) -> float:
+        """
+        The root mean squared error of the predicted ratings.
+        """
+        return self.underlying.rmse
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
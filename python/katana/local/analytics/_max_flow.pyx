@@ -0,0 +1,236 @@
+"""
+Max Flow
+--------
+
+.. autoclass:: katana.local.analytics.MaxFlowPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.local.analytics._max_flow._MaxFlowPlanAlgorithm
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.local.analytics.max_flow
+
+.. autoclass:: katana.local.analytics.MaxFlowStatistics
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.local.analytics.max_flow_assert_valid
+"""
+from libc.stdint cimport uint32_t, uint64_t
+from libcpp cimport bool
+from libcpp.string cimport string
+
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libstd.iostream cimport ostream, ostringstream
+from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_result_void, raise_error_code
+from katana.local._graph cimport Graph
+from katana.local.analytics.plan cimport Plan, _Plan
+
+from enum import Enum
+
+
+cdef extern from "katana/analytics/max_flow/max_flow.h" namespace "katana::analytics" nogil:
+    cppclass _MaxFlowPlan "katana::analytics::MaxFlowPlan" (_Plan):
+        enum Algorithm:
+            kPushRelabel "katana::analytics::MaxFlowPlan::kPushRelabel"
+
+        _MaxFlowPlan.Algorithm algorithm() const
+        double global_relabel_frequency() const
+        bool gap_relabeling() const
+
+        MaxFlowPlan()
+
+        @staticmethod
+        _MaxFlowPlan PushRelabel(double global_relabel_frequency, bool gap_relabeling)
+
+    double kDefaultGlobalRelabelFrequency "katana::analytics::MaxFlowPlan::kDefaultGlobalRelabelFrequency"
+    bool kDefaultGapRelabeling "katana::analytics::MaxFlowPlan::kDefaultGapRelabeling"
+
+    Result[void] MaxFlow(
+        _PropertyGraph* pg, uint32_t source, uint32_t sink, string capacity_property_name,
+        string output_flow_property_name, string output_cut_property_name, _MaxFlowPlan plan)
+
+    Result[void] MaxFlowAssertValid(
+        _PropertyGraph* pg, uint32_t source, uint32_t sink, string capacity_property_name, string flow_property_name)
+
+    cppclass _MaxFlowStatistics "katana::analytics::MaxFlowStatistics":
+        uint64_t flow_value
+        uint64_t num_cut_edges
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_MaxFlowStatistics] Compute(
+            _PropertyGraph* pg, uint32_t source, string flow_property_name, string cut_property_name)
+
+
+class _MaxFlowPlanAlgorithm(Enum):
+    """
+    :see: :py:class:`~katana.local.analytics.MaxFlowPlan` constructors for algorithm documentation.
+    """
+    PushRelabel = _MaxFlowPlan.Algorithm.kPushRelabel
+
+
+cdef class MaxFlowPlan(Plan):
+    """
+    A computational :ref:`Plan` for Max Flow.
+
+    Static methods construct MaxFlowPlans.
+    """
+    cdef:
+        _MaxFlowPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _MaxFlowPlanAlgorithm
+
+    @staticmethod
+    cdef MaxFlowPlan make(_MaxFlowPlan u):
+        f = <MaxFlowPlan>MaxFlowPlan.__new__(MaxFlowPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> _MaxFlowPlanAlgorithm:
+        return _MaxFlowPlanAlgorithm(self.underlying_.algorithm())
+
+    @property
+    def global_relabel_frequency(self) -> float:
+        return self.underlying_.global_relabel_frequency()
+
+    @property
+    def gap_relabeling(self) -> bool:
+        return self.underlying_.gap_relabeling()
+
+    @staticmethod
+    def push_relabel(
+        global_relabel_frequency=kDefaultGlobalRelabelFrequency, gap_relabeling=kDefaultGapRelabeling
+    ) -> MaxFlowPlan:
+        """
+        Asynchronous lock-free push-relabel. Heights are recomputed by a parallel breadth first search from the sink
+        once the work since the last recomputation exceeds global_relabel_frequency times 6 * |V| + |E|. With
+        gap_relabeling, a node that empties its height is lifted out of reach of the sink immediately.
+        """
+        return MaxFlowPlan.make(_MaxFlowPlan.PushRelabel(global_relabel_frequency, gap_relabeling))
+
+
+def max_flow(
+    Graph pg,
+    uint32_t source,
+    uint32_t sink,
+    str capacity_property_name,
+    str output_flow_property_name,
+    str output_cut_property_name,
+    MaxFlowPlan plan = MaxFlowPlan(),
+):
+    """
+    Compute a maximum flow from source to sink, where the capacity of each edge is given by an edge property with a
+    non-negative integer type. Create an edge property with the flow on each edge, and a node property which is 1 for
+    the nodes on the source side of a minimum cut and 0 for the others. The created properties have types uint64_t
+    and uint8_t and may not exist before the call.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type source: int
+    :param source: The source node.
+    :type sink: int
+    :param sink: The sink node.
+    :type capacity_property_name: str
+    :param capacity_property_name: The edge property holding the capacities.
+    :type output_flow_property_name: str
+    :param output_flow_property_name: The edge property to write flows into. This property must not already exist.
+    :type output_cut_property_name: str
+    :param output_cut_property_name: The node property to write the sides of the cut into. This property must not
+        already exist.
+    :type plan: MaxFlowPlan
+    :param plan: The execution plan to use.
+
+    .. code-block:: python
+
+        import katana.local
+        from katana.example_data import get_input
+        from katana.local import Graph
+        katana.local.initialize()
+
+        graph = Graph(get_input("propertygraphs/rmat15"))
+        from katana.local.analytics import max_flow, MaxFlowStatistics
+        max_flow(graph, 0, 1, "value", "flow", "cut")
+        stats = MaxFlowStatistics(graph, 0, "flow", "cut")
+        print(stats)
+
+    """
+    cdef string capacity_property_name_str = capacity_property_name.encode("utf-8")
+    cdef string output_flow_property_name_str = output_flow_property_name.encode("utf-8")
+    cdef string output_cut_property_name_str = output_cut_property_name.encode("utf-8")
+    with nogil:
+        handle_result_void(
+            MaxFlow(
+                pg.underlying_property_graph(),
+                source,
+                sink,
+                capacity_property_name_str,
+                output_flow_property_name_str,
+                output_cut_property_name_str,
+                plan.underlying_,
+            )
+        )
+
+
+def max_flow_assert_valid(Graph pg, uint32_t source, uint32_t sink, str capacity_property_name, str flow_property_name):
+    """
+    Raise an exception if the flow in `pg` exceeds a capacity, is not conserved, or is not maximum.
+
+    :raises: AssertionError
+    """
+    cdef string capacity_property_name_str = capacity_property_name.encode("utf-8")
+    cdef string flow_property_name_str = flow_property_name.encode("utf-8")
+    with nogil:
+        handle_result_assert(
+            MaxFlowAssertValid(
+                pg.underlying_property_graph(), source, sink, capacity_property_name_str, flow_property_name_str
+            )
+        )
+
+
+cdef _MaxFlowStatistics handle_result_MaxFlowStatistics(Result[_MaxFlowStatistics] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class MaxFlowStatistics:
+    """
+    Compute the :ref:`statistics` of a Max Flow.
+    """
+    cdef _MaxFlowStatistics underlying
+
+    def __init__(self, Graph pg, uint32_t source, str flow_property_name, str cut_property_name):
+        cdef string flow_property_name_str = flow_property_name.encode("utf-8")
+        cdef string cut_property_name_str = cut_property_name.encode("utf-8")
+        with nogil:
+            self.underlying = handle_result_MaxFlowStatistics(_MaxFlowStatistics.Compute(
+                pg.underlying_property_graph(), source, flow_property_name_str, cut_property_name_str))
+
+    @property
+    def flow_value(self) -> int:
+        """
+        The net flow out of the source.
+        """
+        return self.underlying.flow_value
+
+    @property
+    def num_cut_edges(self) -> int:
+        """
+        The number of edges from the source side of the cut to the sink side.
+        """
+        return self.underlying.num_cut_edges
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
@@ -0,0 +1,228 @@
+"""
+Minimum Spanning Forest
+-----------------------
+
+.. autoclass:: katana.local.analytics.MinimumSpanningForestPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.local.analytics._minimum_spanning_forest._MinimumSpanningForestPlanAlgorithm
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.local.analytics.minimum_spanning_forest
+
+.. autoclass:: katana.local.analytics.MinimumSpanningForestStatistics
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.local.analytics.minimum_spanning_forest_assert_valid
+"""
+from libc.stdint cimport uint64_t
+from libcpp.string cimport string
+
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libstd.iostream cimport ostream, ostringstream
+from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_result_void, raise_error_code
+from katana.local._graph cimport Graph
+from katana.local.analytics.plan cimport Plan, _Plan
+
+from enum import Enum
+
+
+cdef extern from "katana/analytics/minimum_spanning_forest/minimum_spanning_forest.h" namespace "katana::analytics" nogil:
+    cppclass _MinimumSpanningForestPlan "katana::analytics::MinimumSpanningForestPlan" (_Plan):
+        enum Algorithm:
+            kBoruvka "katana::analytics::MinimumSpanningForestPlan::kBoruvka"
+            kFilterKruskal "katana::analytics::MinimumSpanningForestPlan::kFilterKruskal"
+
+        _MinimumSpanningForestPlan.Algorithm algorithm() const
+        uint64_t base_case_size() const
+
+        MinimumSpanningForestPlan()
+
+        @staticmethod
+        _MinimumSpanningForestPlan Boruvka()
+
+        @staticmethod
+        _MinimumSpanningForestPlan FilterKruskal(uint64_t base_case_size)
+
+    uint64_t kDefaultBaseCaseSize "katana::analytics::MinimumSpanningForestPlan::kDefaultBaseCaseSize"
+
+    Result[void] MinimumSpanningForest(
+        _PropertyGraph* pg, string edge_weight_property_name, string output_property_name,
+        _MinimumSpanningForestPlan plan)
+
+    Result[void] MinimumSpanningForestAssertValid(_PropertyGraph* pg, string property_name)
+
+    cppclass _MinimumSpanningForestStatistics "katana::analytics::MinimumSpanningForestStatistics":
+        uint64_t num_forest_edges
+        uint64_t num_trees
+        double total_weight
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_MinimumSpanningForestStatistics] Compute(
+            _PropertyGraph* pg, string edge_weight_property_name, string property_name)
+
+
+class _MinimumSpanningForestPlanAlgorithm(Enum):
+    """
+    :see: :py:class:`~katana.local.analytics.MinimumSpanningForestPlan` constructors for algorithm documentation.
+    """
+    Boruvka = _MinimumSpanningForestPlan.Algorithm.kBoruvka
+    FilterKruskal = _MinimumSpanningForestPlan.Algorithm.kFilterKruskal
+
+
+cdef class MinimumSpanningForestPlan(Plan):
+    """
+    A computational :ref:`Plan` for Minimum Spanning Forest.
+
+    Static methods construct MinimumSpanningForestPlans.
+    """
+    cdef:
+        _MinimumSpanningForestPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _MinimumSpanningForestPlanAlgorithm
+
+    @staticmethod
+    cdef MinimumSpanningForestPlan make(_MinimumSpanningForestPlan u):
+        f = <MinimumSpanningForestPlan>MinimumSpanningForestPlan.__new__(MinimumSpanningForestPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> _MinimumSpanningForestPlanAlgorithm:
+        return _MinimumSpanningForestPlanAlgorithm(self.underlying_.algorithm())
+
+    @property
+    def base_case_size(self) -> int:
+        return self.underlying_.base_case_size()
+
+    @staticmethod
+    def boruvka() -> MinimumSpanningForestPlan:
+        """
+        Parallel Boruvka: every component adds its lightest edge to the forest, then the joined components are
+        contracted into a new graph, until no edges remain between components.
+        """
+        return MinimumSpanningForestPlan.make(_MinimumSpanningForestPlan.Boruvka())
+
+    @staticmethod
+    def filter_kruskal(base_case_size=kDefaultBaseCaseSize) -> MinimumSpanningForestPlan:
+        """
+        Filter-Kruskal: split the edges around a pivot weight, process the light edges, filter out the heavy edges
+        within a component and process the rest. Ranges of at most base_case_size edges are sorted and scanned with
+        Kruskal's algorithm.
+        """
+        return MinimumSpanningForestPlan.make(_MinimumSpanningForestPlan.FilterKruskal(base_case_size))
+
+
+def minimum_spanning_forest(
+    Graph pg,
+    str edge_weight_property_name,
+    str output_property_name,
+    MinimumSpanningForestPlan plan = MinimumSpanningForestPlan(),
+):
+    """
+    Compute a minimum spanning forest of the graph, treating edges as undirected, and create an edge property which
+    is 1 for the edges in the forest and 0 for the others. Ties between equal weights are broken by edge, so the
+    forest is unique. The created property has type uint8_t and may not exist before the call.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type edge_weight_property_name: str
+    :param edge_weight_property_name: The edge property holding the weights.
+    :type output_property_name: str
+    :param output_property_name: The output property to write forest membership into. This property must not
+        already exist.
+    :type plan: MinimumSpanningForestPlan
+    :param plan: The execution plan to use.
+
+    .. code-block:: python
+
+        import katana.local
+        from katana.example_data import get_input
+        from katana.local import Graph
+        katana.local.initialize()
+
+        graph = Graph(get_input("propertygraphs/rmat15"))
+        from katana.local.analytics import minimum_spanning_forest, MinimumSpanningForestStatistics
+        minimum_spanning_forest(graph, "value", "forest")
+        stats = MinimumSpanningForestStatistics(graph, "value", "forest")
+        print(stats)
+
+    """
+    cdef string edge_weight_property_name_str = edge_weight_property_name.encode("utf-8")
+    cdef string output_property_name_str = output_property_name.encode("utf-8")
+    with nogil:
+        handle_result_void(
+            MinimumSpanningForest(
+                pg.underlying_property_graph(), edge_weight_property_name_str, output_property_name_str, plan.underlying_
+            )
+        )
+
+
+def minimum_spanning_forest_assert_valid(Graph pg, str property_name):
+    """
+    Raise an exception if the edges marked in `pg` do not form a forest spanning each connected component. This does
+    not check that the forest is minimum.
+
+    :raises: AssertionError
+    """
+    cdef string property_name_str = property_name.encode("utf-8")
+    with nogil:
+        handle_result_assert(MinimumSpanningForestAssertValid(pg.underlying_property_graph(), property_name_str))
+
+
+cdef _MinimumSpanningForestStatistics handle_result_MinimumSpanningForestStatistics(
+    Result[_MinimumSpanningForestStatistics] res
+) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class MinimumSpanningForestStatistics:
+    """
+    Compute the :ref:`statistics` of a Minimum Spanning Forest.
+    """
+    cdef _MinimumSpanningForestStatistics underlying
+
+    def __init__(self, Graph pg, str edge_weight_property_name, str property_name):
+        cdef string edge_weight_property_name_str = edge_weight_property_name.encode("utf-8")
+        cdef string property_name_str = property_name.encode("utf-8")
+        with nogil:
+            self.underlying = handle_result_MinimumSpanningForestStatistics(_MinimumSpanningForestStatistics.Compute(
+                pg.underlying_property_graph(), edge_weight_property_name_str, property_name_str))
+
+    @property
+    def num_forest_edges(self) -> int:
+        """
+        The number of edges in the forest.
+        """
+        return self.underlying.num_forest_edges
+
+    @property
+    def num_trees(self) -> int:
+        """
+        The number of trees in the forest, including isolated nodes.
+        """
+        return self.underlying.num_trees
+
+    @property
+    def total_weight(self) -> float:
+        """
+        The total weight of the edges in the forest.
+        """
+        return self.underlying.total_weight
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
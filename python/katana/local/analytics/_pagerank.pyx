@@ -17,6 +17,8 @@ Page Rank
 
 .. autofunction:: katana.local.analytics.pagerank
 
+.. autofunction:: katana.local.analytics.pagerank_async
+
 .. autoclass:: katana.local.analytics.PagerankStatistics
     :members:
     :undoc-members:
@@ -29,19 +31,27 @@ from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
 from katana.cpp.libstd.iostream cimport ostream, ostringstream
 from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_result_void, raise_error_code
 from katana.local._graph cimport Graph
+from katana.local.analytics.context cimport AnalyticsContext, _AnalyticsContext, underlying_context
 from katana.local.analytics.plan cimport Plan, _Plan
 
 from enum import Enum
 
+from katana.local.analytics.context import AnalyticsFuture, submit
+
 
 cdef extern from "katana/analytics/pagerank/pagerank.h" namespace "katana::analytics" nogil:
     cppclass _PagerankPlan "katana::analytics::PagerankPlan" (_Plan):
         enum Algorithm:
             kPullTopological "katana::analytics::PagerankPlan::kPullTopological"
             kPullResidual "katana::analytics::PagerankPlan::kPullResidual"
+            kPullBlocked "katana::analytics::PagerankPlan::kPullBlocked"
             kPushSynchronous "katana::analytics::PagerankPlan::kPushSynchronous"
             kPushAsynchronous "katana::analytics::PagerankPlan::kPushAsynchronous"
 
+        enum ContributionPrecision:
+            kFloat32 "katana::analytics::PagerankPlan::kFloat32"
+            kBFloat16 "katana::analytics::PagerankPlan::kBFloat16"
+
         # unsigned int kChunkSize
 
         _PagerankPlan.Algorithm algorithm() const
@@ -57,6 +67,8 @@ cdef extern from "katana/analytics/pagerank/pagerank.h" namespace "katana::analy
         @staticmethod
         _PagerankPlan PullResidual(float tolerance, unsigned int max_iterations, float alpha)
         @staticmethod
+        _PagerankPlan PullBlocked(float tolerance, unsigned int max_iterations, float alpha, _PagerankPlan.ContributionPrecision contribution_precision)
+        @staticmethod
         _PagerankPlan PushAsynchronous(float tolerance, float alpha)
         @staticmethod
         _PagerankPlan PushSynchronous(float tolerance, unsigned int max_iterations, float alpha)
@@ -65,7 +77,8 @@ cdef extern from "katana/analytics/pagerank/pagerank.h" namespace "katana::analy
     int kDefaultMaxIterations "katana::analytics::PagerankPlan::kDefaultMaxIterations"
     double kDefaultAlpha "katana::analytics::PagerankPlan::kDefaultAlpha"
 
-    Result[void] Pagerank(_PropertyGraph* pg, string output_property_name, _PagerankPlan plan)
+    Result[void] Pagerank(_PropertyGraph* pg, string output_property_name, _PagerankPlan plan,
+                          _AnalyticsContext* context)
 
     Result[void] PagerankAssertValid(_PropertyGraph* pg, string output_property_name)
 
@@ -83,6 +96,7 @@ cdef extern from "katana/analytics/pagerank/pagerank.h" namespace "katana::analy
 class _PagerankPlanAlgorithm(Enum):
     PullTopological = _PagerankPlan.Algorithm.kPullTopological
     PullResidual = _PagerankPlan.Algorithm.kPullResidual
+    PullBlocked = _PagerankPlan.Algorithm.kPullBlocked
     PushSynchronous = _PagerankPlan.Algorithm.kPushSynchronous
     PushAsynchronous = _PagerankPlan.Algorithm.kPushAsynchronous
 
@@ -145,6 +159,19 @@ cdef class PagerankPlan(Plan):
         """
         return PagerankPlan.make(_PagerankPlan.PullResidual(tolerance, max_iterations, alpha))
 
+    @staticmethod
+    def pull_blocked(float tolerance = kDefaultTolerance, unsigned int max_iterations = kDefaultMaxIterations, float alpha = kDefaultAlpha, bint bfloat16_contributions = False):
+        """
+        Topological pull algorithm with propagation blocking
+
+        Contributions are streamed into cache-sized bins of destinations and then added up bin by bin. With
+        bfloat16_contributions, they are stored with 8 bits of mantissa, which halves their memory traffic.
+
+        The graph must be transposed to use this algorithm.
+        """
+        precision = _PagerankPlan.ContributionPrecision.kBFloat16 if bfloat16_contributions else _PagerankPlan.ContributionPrecision.kFloat32
+        return PagerankPlan.make(_PagerankPlan.PullBlocked(tolerance, max_iterations, alpha, precision))
+
     @staticmethod
     def push_asynchronous(float tolerance = kDefaultTolerance, float alpha = kDefaultAlpha):
         """
@@ -167,7 +194,8 @@ cdef class PagerankPlan(Plan):
         return PagerankPlan.make(_PagerankPlan.PushSynchronous(tolerance, max_iterations, alpha))
 
 
-def pagerank(Graph pg, str output_property_name, PagerankPlan plan = PagerankPlan()):
+def pagerank(Graph pg, str output_property_name, PagerankPlan plan = PagerankPlan(),
+             AnalyticsContext context = None):
     """
     Compute the Page Rank of each node in the graph.
 
@@ -177,6 +205,9 @@ def pagerank(Graph pg, str output_property_name, PagerankPlan plan = PagerankPla
     :param output_property_name: The output property to store the rank. This property must not already exist.
     :type plan: PagerankPlan
     :param plan: The execution plan to use.
+    :type context: AnalyticsContext
+    :param context: Scratch memory to reuse across calls, and a flag to cancel the call. Only the pull plans check
+        for cancellation between iterations. (Optional)
 
     .. code-block:: python
 
@@ -199,8 +230,19 @@ def pagerank(Graph pg, str output_property_name, PagerankPlan plan = PagerankPla
     """
     output_property_name_bytes = bytes(output_property_name, "utf-8")
     output_property_name_cstr = <string>output_property_name_bytes
+    cdef _AnalyticsContext* c_context = underlying_context(context)
     with nogil:
-        handle_result_void(Pagerank(pg.underlying_property_graph(), output_property_name_cstr, plan.underlying_))
+        handle_result_void(
+            Pagerank(pg.underlying_property_graph(), output_property_name_cstr, plan.underlying_, c_context)
+        )
+
+
+def pagerank_async(Graph pg, str output_property_name, PagerankPlan plan = PagerankPlan()) -> AnalyticsFuture:
+    """
+    Start :py:func:`pagerank` on the analytics thread and return a future of its completion. The calling thread keeps
+    running; cancelling the future stops the pull plans between iterations.
+    """
+    return submit(pagerank, pg, output_property_name, plan)
 
 
 def pagerank_assert_valid(Graph pg, str output_property_name):
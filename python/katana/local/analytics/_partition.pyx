@@ -0,0 +1,215 @@
+"""
+Partition
+---------
+
+.. autoclass:: katana.local.analytics.PartitionPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.local.analytics._partition._PartitionPlanAlgorithm
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.local.analytics.partition
+
+.. autoclass:: katana.local.analytics.PartitionStatistics
+    :members:
+    :undoc-members:
+"""
+from libc.stdint cimport uint32_t, uint64_t
+from libcpp.string cimport string
+
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libstd.iostream cimport ostream, ostringstream
+from katana.cpp.libsupport.result cimport Result, handle_result_void, raise_error_code
+from katana.local._graph cimport Graph
+from katana.local.analytics.plan cimport Plan, _Plan
+
+from enum import Enum
+
+
+cdef extern from "katana/analytics/partition/partition.h" namespace "katana::analytics" nogil:
+    cppclass _PartitionPlan "katana::analytics::PartitionPlan" (_Plan):
+        enum Algorithm:
+            kMultilevel "katana::analytics::PartitionPlan::kMultilevel"
+
+        _PartitionPlan.Algorithm algorithm() const
+        double imbalance() const
+        uint32_t coarsest_nodes_per_partition() const
+        uint32_t refinement_rounds() const
+
+        PartitionPlan()
+
+        @staticmethod
+        _PartitionPlan Multilevel(double imbalance, uint32_t coarsest_nodes_per_partition, uint32_t refinement_rounds)
+
+    double kDefaultImbalance "katana::analytics::PartitionPlan::kDefaultImbalance"
+    uint32_t kDefaultCoarsestNodesPerPartition "katana::analytics::PartitionPlan::kDefaultCoarsestNodesPerPartition"
+    uint32_t kDefaultRefinementRounds "katana::analytics::PartitionPlan::kDefaultRefinementRounds"
+
+    Result[void] Partition(
+        _PropertyGraph* pg, uint32_t num_partitions, string output_property_name, _PartitionPlan plan)
+
+    cppclass _PartitionStatistics "katana::analytics::PartitionStatistics":
+        uint32_t num_partitions
+        uint64_t edge_cut
+        uint64_t largest_partition_size
+        double imbalance
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_PartitionStatistics] Compute(_PropertyGraph* pg, string output_property_name)
+
+
+class _PartitionPlanAlgorithm(Enum):
+    """
+    :see: :py:class:`~katana.local.analytics.PartitionPlan` constructors for algorithm documentation.
+    """
+    Multilevel = _PartitionPlan.Algorithm.kMultilevel
+
+
+cdef class PartitionPlan(Plan):
+    """
+    A computational :ref:`Plan` for Partition.
+
+    Static methods construct PartitionPlans.
+    """
+    cdef:
+        _PartitionPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _PartitionPlanAlgorithm
+
+    @staticmethod
+    cdef PartitionPlan make(_PartitionPlan u):
+        f = <PartitionPlan>PartitionPlan.__new__(PartitionPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> _PartitionPlanAlgorithm:
+        return _PartitionPlanAlgorithm(self.underlying_.algorithm())
+
+    @property
+    def imbalance(self) -> float:
+        return self.underlying_.imbalance()
+
+    @property
+    def coarsest_nodes_per_partition(self) -> int:
+        return self.underlying_.coarsest_nodes_per_partition()
+
+    @property
+    def refinement_rounds(self) -> int:
+        return self.underlying_.refinement_rounds()
+
+    @staticmethod
+    def multilevel(
+        imbalance=kDefaultImbalance,
+        coarsest_nodes_per_partition=kDefaultCoarsestNodesPerPartition,
+        refinement_rounds=kDefaultRefinementRounds,
+    ) -> PartitionPlan:
+        """
+        Multilevel k-way partitioning: coarsen the graph by contracting heavy edge matchings, partition the coarsest
+        graph by greedy graph growing, and refine the partition at each level on the way back. Coarsening is
+        deterministic but refinement depends on the schedule.
+        """
+        return PartitionPlan.make(
+            _PartitionPlan.Multilevel(imbalance, coarsest_nodes_per_partition, refinement_rounds)
+        )
+
+
+def partition(Graph pg, uint32_t num_partitions, str output_property_name, PartitionPlan plan = PartitionPlan()):
+    """
+    Partition the nodes of the graph into num_partitions parts of at most (1 + imbalance) times the average number of
+    nodes, minimizing the number of edges between parts, and create a property with the partition of each node. Edges
+    are treated as undirected. The property named output_property_name is created by this function and may not exist
+    before the call. The created property has type uint32_t.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type num_partitions: int
+    :param num_partitions: The number of partitions.
+    :type output_property_name: str
+    :param output_property_name: The output property to write partition IDs into. This property must not already
+        exist.
+    :type plan: PartitionPlan
+    :param plan: The execution plan to use.
+
+    .. code-block:: python
+
+        import katana.local
+        from katana.example_data import get_input
+        from katana.local import Graph
+        katana.local.initialize()
+
+        graph = Graph(get_input("propertygraphs/rmat10_symmetric"))
+        from katana.local.analytics import partition, PartitionStatistics
+        partition(graph, 4, "partition")
+        stats = PartitionStatistics(graph, "partition")
+        print(stats)
+
+    """
+    output_property_name_bytes = bytes(output_property_name, "utf-8")
+    output_property_name_cstr = <string>output_property_name_bytes
+    with nogil:
+        handle_result_void(
+            Partition(pg.underlying_property_graph(), num_partitions, output_property_name_cstr, plan.underlying_)
+        )
+
+
+cdef _PartitionStatistics handle_result_PartitionStatistics(Result[_PartitionStatistics] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class PartitionStatistics:
+    """
+    Compute the :ref:`statistics` of a Partition.
+    """
+    cdef _PartitionStatistics underlying
+
+    def __init__(self, Graph pg, str output_property_name):
+        output_property_name_bytes = bytes(output_property_name, "utf-8")
+        output_property_name_cstr = <string> output_property_name_bytes
+        with nogil:
+            self.underlying = handle_result_PartitionStatistics(_PartitionStatistics.Compute(
+                pg.underlying_property_graph(), output_property_name_cstr))
+
+    @property
+    def num_partitions(self) -> int:
+        """
+        The number of partitions, one more than the largest partition ID.
+        """
+        return self.underlying.num_partitions
+
+    @property
+    def edge_cut(self) -> int:
+        """
+        The number of edges whose endpoints are in different partitions.
+        """
+        return self.underlying.edge_cut
+
+    @property
+    def largest_partition_size(self) -> int:
+        """
+        The largest number of nodes in a partition.
+        """
+        return self.underlying.largest_partition_size
+
+    @property
+    def imbalance(self) -> float:
+        """
+        The ratio of the largest partition size to the average.
+        """
+        return self.underlying.imbalance
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
@@ -13,6 +13,8 @@ Single-Source Shortest Path
 
 .. autofunction:: katana.local.analytics.sssp
 
+.. autofunction:: katana.local.analytics.sssp_async
+
 .. autoclass:: katana.local.analytics.SsspStatistics
     :members:
     :undoc-members:
@@ -21,6 +23,8 @@ Single-Source Shortest Path
 """
 from enum import Enum
 
+from katana.local.analytics.context import AnalyticsFuture, submit
+
 from libc.stddef cimport ptrdiff_t
 from libc.stdint cimport uint64_t
 from libcpp.string cimport string
@@ -29,6 +33,7 @@ from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
 from katana.cpp.libstd.iostream cimport ostream, ostringstream
 from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_result_void, raise_error_code
 from katana.local._graph cimport Graph
+from katana.local.analytics.context cimport AnalyticsContext, _AnalyticsContext, underlying_context
 from katana.local.analytics.plan cimport Plan, Statistics, _Plan
 
 
@@ -39,6 +44,8 @@ cdef extern from "katana/analytics/sssp/sssp.h" namespace "katana::analytics" no
             kDeltaStep "katana::analytics::SsspPlan::kDeltaStep"
             kDeltaStepBarrier "katana::analytics::SsspPlan::kDeltaStepBarrier"
             kDeltaStepFusion "katana::analytics::SsspPlan::kDeltaStepFusion"
+            kDeltaStepAdaptive "katana::analytics::SsspPlan::kDeltaStepAdaptive"
+            kMultiQueue "katana::analytics::SsspPlan::kMultiQueue"
             kSerialDeltaTile "katana::analytics::SsspPlan::kSerialDeltaTile"
             kSerialDelta "katana::analytics::SsspPlan::kSerialDelta"
             kDijkstraTile "katana::analytics::SsspPlan::kDijkstraTile"
@@ -63,6 +70,10 @@ cdef extern from "katana/analytics/sssp/sssp.h" namespace "katana::analytics" no
         @staticmethod
         _SsspPlan DeltaStepFusion(unsigned delta)
         @staticmethod
+        _SsspPlan DeltaStepAdaptive()
+        @staticmethod
+        _SsspPlan MultiQueue()
+        @staticmethod
         _SsspPlan SerialDeltaTile(unsigned delta, ptrdiff_t edge_tile_size)
         @staticmethod
         _SsspPlan SerialDelta(unsigned delta)
@@ -79,7 +90,8 @@ cdef extern from "katana/analytics/sssp/sssp.h" namespace "katana::analytics" no
     ptrdiff_t kDefaultEdgeTileSize "katana::analytics::SsspPlan::kDefaultEdgeTileSize"
 
     Result[void] Sssp(_PropertyGraph* pg, size_t start_node,
-        const string& edge_weight_property_name, const string& output_property_name, _SsspPlan plan)
+        const string& edge_weight_property_name, const string& output_property_name, _SsspPlan plan,
+        _AnalyticsContext* context)
 
     Result[void] SsspAssertValid(_PropertyGraph* pg, size_t start_node,
                                  const string& edge_weight_property_name, const string& output_property_name);
@@ -105,6 +117,8 @@ class _SsspAlgorithm(Enum):
     DeltaStep = _SsspPlan.Algorithm.kDeltaStep
     DeltaStepBarrier = _SsspPlan.Algorithm.kDeltaStepBarrier
     DeltaStepFusion = _SsspPlan.Algorithm.kDeltaStepFusion
+    DeltaStepAdaptive = _SsspPlan.Algorithm.kDeltaStepAdaptive
+    MultiQueue = _SsspPlan.Algorithm.kMultiQueue
     SerialDeltaTile = _SsspPlan.Algorithm.kSerialDeltaTile
     SerialDelta = _SsspPlan.Algorithm.kSerialDelta
     DijkstraTile = _SsspPlan.Algorithm.kDijkstraTile
@@ -200,6 +214,20 @@ cdef class SsspPlan(Plan):
         """
         return SsspPlan.make(_SsspPlan.DeltaStepFusion(delta))
 
+    @staticmethod
+    def delta_step_adaptive() -> SsspPlan:
+        """
+        Delta stepping with fused buckets; delta is estimated from the edge weights and tuned during the run
+        """
+        return SsspPlan.make(_SsspPlan.DeltaStepAdaptive())
+
+    @staticmethod
+    def multi_queue() -> SsspPlan:
+        """
+        Asynchronous relaxation with a relaxed concurrent priority queue; no delta to tune
+        """
+        return SsspPlan.make(_SsspPlan.MultiQueue())
+
     @staticmethod
     def serial_delta_tile(unsigned delta = kDefaultDelta, ptrdiff_t edge_tile_size = kDefaultEdgeTileSize) -> SsspPlan:
         """
@@ -244,7 +272,7 @@ cdef class SsspPlan(Plan):
 
 
 def sssp(Graph pg, size_t start_node, str edge_weight_property_name, str output_property_name,
-         SsspPlan plan = SsspPlan()):
+         SsspPlan plan = SsspPlan(), AnalyticsContext context = None):
     """
     Compute the Single-Source Shortest Path on `pg` using `start_node` as the source. The computed path lengths are
     written to the property `output_property_name`.
@@ -259,6 +287,9 @@ def sssp(Graph pg, size_t start_node, str edge_weight_property_name, str output_
     :param output_property_name: The output property to write path lengths into. This property must not already exist.
     :type plan: SsspPlan
     :param plan: The execution plan to use. Defaults to heuristically selecting the plan.
+    :type context: AnalyticsContext
+    :param context: Scratch memory to reuse across calls, and a flag to cancel the call. The search has no rounds, so
+        it is only cancelled before it writes its output. (Optional)
 
     .. code-block:: python
 
@@ -279,9 +310,19 @@ def sssp(Graph pg, size_t start_node, str edge_weight_property_name, str output_
     """
     cdef string edge_weight_property_name_str = bytes(edge_weight_property_name, "utf-8")
     cdef string output_property_name_str = bytes(output_property_name, "utf-8")
+    cdef _AnalyticsContext* c_context = underlying_context(context)
     with nogil:
         handle_result_void(Sssp(pg.underlying_property_graph(), start_node, edge_weight_property_name_str,
-                                output_property_name_str, plan.underlying_))
+                                output_property_name_str, plan.underlying_, c_context))
+
+
+def sssp_async(Graph pg, size_t start_node, str edge_weight_property_name, str output_property_name,
+               SsspPlan plan = SsspPlan()) -> AnalyticsFuture:
+    """
+    Start :py:func:`sssp` on the analytics thread and return a future of its completion. The calling thread keeps
+    running.
+    """
+    return submit(sssp, pg, start_node, edge_weight_property_name, output_property_name, plan)
 
 def sssp_assert_valid(Graph pg, size_t start_node, str edge_weight_property_name, str output_property_name):
     """
@@ -0,0 +1,239 @@
+"""
+Strongly Connected Components
+-----------------------------
+
+.. autoclass:: katana.local.analytics.StronglyConnectedComponentsPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.local.analytics._strongly_connected_components._StronglyConnectedComponentsPlanAlgorithm
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.local.analytics.strongly_connected_components
+
+.. autoclass:: katana.local.analytics.StronglyConnectedComponentsStatistics
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.local.analytics.strongly_connected_components_assert_valid
+"""
+from libc.stdint cimport uint64_t
+from libcpp cimport bool
+from libcpp.string cimport string
+
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libstd.iostream cimport ostream, ostringstream
+from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_result_void, raise_error_code
+from katana.local._graph cimport Graph
+from katana.local.analytics.plan cimport Plan, _Plan
+
+from enum import Enum
+
+
+cdef extern from "katana/analytics/strongly_connected_components/strongly_connected_components.h" namespace "katana::analytics" nogil:
+    cppclass _StronglyConnectedComponentsPlan "katana::analytics::StronglyConnectedComponentsPlan" (_Plan):
+        enum Algorithm:
+            kMultiStep "katana::analytics::StronglyConnectedComponentsPlan::kMultiStep"
+            kForwardBackward "katana::analytics::StronglyConnectedComponentsPlan::kForwardBackward"
+            kColoring "katana::analytics::StronglyConnectedComponentsPlan::kColoring"
+
+        _StronglyConnectedComponentsPlan.Algorithm algorithm() const
+        bool trim2() const
+
+        StronglyConnectedComponentsPlan()
+
+        @staticmethod
+        _StronglyConnectedComponentsPlan MultiStep(bool trim2)
+
+        @staticmethod
+        _StronglyConnectedComponentsPlan ForwardBackward(bool trim2)
+
+        @staticmethod
+        _StronglyConnectedComponentsPlan Coloring(bool trim2)
+
+    bool kDefaultTrim2 "katana::analytics::StronglyConnectedComponentsPlan::kDefaultTrim2"
+
+    Result[void] StronglyConnectedComponents(
+        _PropertyGraph* pg, string output_property_name, _StronglyConnectedComponentsPlan plan)
+
+    Result[void] StronglyConnectedComponentsAssertValid(_PropertyGraph* pg, string property_name)
+
+    cppclass _StronglyConnectedComponentsStatistics "katana::analytics::StronglyConnectedComponentsStatistics":
+        uint64_t total_components
+        uint64_t total_non_trivial_components
+        uint64_t largest_component_size
+        double largest_component_ratio
+
+        void Print(ostream os)
+
+        @staticmethod
+        Result[_StronglyConnectedComponentsStatistics] Compute(_PropertyGraph* pg, string property_name)
+
+
+class _StronglyConnectedComponentsPlanAlgorithm(Enum):
+    """
+    :see: :py:class:`~katana.local.analytics.StronglyConnectedComponentsPlan` constructors for algorithm
+        documentation.
+    """
+    MultiStep = _StronglyConnectedComponentsPlan.Algorithm.kMultiStep
+    ForwardBackward = _StronglyConnectedComponentsPlan.Algorithm.kForwardBackward
+    Coloring = _StronglyConnectedComponentsPlan.Algorithm.kColoring
+
+
+cdef class StronglyConnectedComponentsPlan(Plan):
+    """
+    A computational :ref:`Plan` for Strongly Connected Components.
+
+    Static methods construct StronglyConnectedComponentsPlans. `trim2` selects whether pairs of nodes that only
+    reach each other are removed as components between rounds, besides single nodes without in- or out-edges.
+    """
+    cdef:
+        _StronglyConnectedComponentsPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _StronglyConnectedComponentsPlanAlgorithm
+
+    @staticmethod
+    cdef StronglyConnectedComponentsPlan make(_StronglyConnectedComponentsPlan u):
+        f = <StronglyConnectedComponentsPlan>StronglyConnectedComponentsPlan.__new__(StronglyConnectedComponentsPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> _StronglyConnectedComponentsPlanAlgorithm:
+        return _StronglyConnectedComponentsPlanAlgorithm(self.underlying_.algorithm())
+
+    @property
+    def trim2(self) -> bool:
+        return self.underlying_.trim2()
+
+    @staticmethod
+    def multi_step(trim2=kDefaultTrim2) -> StronglyConnectedComponentsPlan:
+        """
+        Multi-step: trim the trivial components, find the giant component with a single forward-backward search
+        from the node of highest degree, trim again and decompose the rest by coloring.
+        """
+        return StronglyConnectedComponentsPlan.make(_StronglyConnectedComponentsPlan.MultiStep(trim2))
+
+    @staticmethod
+    def forward_backward(trim2=kDefaultTrim2) -> StronglyConnectedComponentsPlan:
+        """
+        Forward-backward: trim, then split every remaining subgraph by the nodes reached forward and backward from
+        a pivot, whose intersection is a component, and repeat on all the pieces at once.
+        """
+        return StronglyConnectedComponentsPlan.make(_StronglyConnectedComponentsPlan.ForwardBackward(trim2))
+
+    @staticmethod
+    def coloring(trim2=kDefaultTrim2) -> StronglyConnectedComponentsPlan:
+        """
+        Coloring: trim, then propagate the largest node ID forward; each node that keeps its own ID roots a
+        component made of the nodes of its color that reach it backward.
+        """
+        return StronglyConnectedComponentsPlan.make(_StronglyConnectedComponentsPlan.Coloring(trim2))
+
+
+def strongly_connected_components(
+    Graph pg, str output_property_name, StronglyConnectedComponentsPlan plan = StronglyConnectedComponentsPlan()
+):
+    """
+    Compute the strongly connected components of `pg`, following edges in their direction, and create a node
+    property with, for every node, the smallest node ID of its component, so the result does not depend on the
+    plan. The created property has type uint32_t and may not exist before the call.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type output_property_name: str
+    :param output_property_name: The output property to write components into. This property must not already
+        exist.
+    :type plan: StronglyConnectedComponentsPlan
+    :param plan: The execution plan to use.
+
+    .. code-block:: python
+
+        import katana.local
+        from katana.example_data import get_input
+        from katana.local import Graph
+        katana.local.initialize()
+
+        graph = Graph(get_input("propertygraphs/rmat15"))
+        from katana.local.analytics import strongly_connected_components, StronglyConnectedComponentsStatistics
+        strongly_connected_components(graph, "output")
+        stats = StronglyConnectedComponentsStatistics(graph, "output")
+        print(stats)
+
+    """
+    cdef string output_property_name_str = output_property_name.encode("utf-8")
+    with nogil:
+        handle_result_void(
+            StronglyConnectedComponents(pg.underlying_property_graph(), output_property_name_str, plan.underlying_)
+        )
+
+
+def strongly_connected_components_assert_valid(Graph pg, str property_name):
+    """
+    Raise an exception if the components in `pg` differ from a serial computation.
+
+    :raises: AssertionError
+    """
+    cdef string property_name_str = property_name.encode("utf-8")
+    with nogil:
+        handle_result_assert(StronglyConnectedComponentsAssertValid(pg.underlying_property_graph(), property_name_str))
+
+
+cdef _StronglyConnectedComponentsStatistics handle_result_StronglyConnectedComponentsStatistics(
+    Result[_StronglyConnectedComponentsStatistics] res
+) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class StronglyConnectedComponentsStatistics:
+    """
+    Compute the :ref:`statistics` of Strongly Connected Components.
+    """
+    cdef _StronglyConnectedComponentsStatistics underlying
+
+    def __init__(self, Graph pg, str property_name):
+        cdef string property_name_str = property_name.encode("utf-8")
+        with nogil:
+            self.underlying = handle_result_StronglyConnectedComponentsStatistics(
+                _StronglyConnectedComponentsStatistics.Compute(pg.underlying_property_graph(), property_name_str))
+
+    @property
+    def total_components(self) -> int:
+        """
+        Total number of components in the graph.
+        """
+        return self.underlying.total_components
+
+    @property
+    def total_non_trivial_components(self) -> int:
+        """
+        Total number of components with more than 1 node.
+        """
+        return self.underlying.total_non_trivial_components
+
+    @property
+    def largest_component_size(self) -> int:
+        """
+        The number of nodes present in the largest component.
+        """
+        return self.underlying.largest_component_size
+
+    @property
+    def largest_component_ratio(self) -> float:
+        """
+        The ratio of nodes present in the largest component.
+        """
+        return self.underlying.largest_component_ratio
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
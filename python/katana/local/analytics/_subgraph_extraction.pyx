@@ -8,9 +8,12 @@ Subgraph Extraction
     :undoc-members:
 
 .. autofunction:: katana.local.analytics.subgraph_extraction
+
+.. autofunction:: katana.local.analytics.k_hop_neighborhood
 """
 from libc.stdint cimport uint32_t
 from libcpp.memory cimport shared_ptr, unique_ptr
+from libcpp.string cimport string
 from libcpp.vector cimport vector
 from pyarrow.lib cimport to_shared
 
@@ -35,7 +38,9 @@ cdef extern from "katana/analytics/subgraph_extraction/subgraph_extraction.h" na
         _SubGraphExtractionPlan NodeSet(
             )
 
-    Result[unique_ptr[_PropertyGraph]] SubGraphExtraction(_PropertyGraph* pfg, const vector[uint32_t]& node_vec, _SubGraphExtractionPlan plan)
+    Result[unique_ptr[_PropertyGraph]] SubGraphExtraction(_PropertyGraph* pfg, const vector[uint32_t]& node_vec, const vector[string]& node_properties_to_copy, const vector[string]& edge_properties_to_copy, _SubGraphExtractionPlan plan)
+
+    Result[vector[uint32_t]] KHopNeighborhood(_PropertyGraph* pfg, const vector[uint32_t]& seeds, uint32_t num_hops)
 
 
 class _SubGraphExtractionPlanAlgorithm(Enum):
@@ -81,12 +86,37 @@ cdef shared_ptr[_PropertyGraph] handle_result_property_graph(Result[unique_ptr[_
     return to_shared(res.value())
 
 
-def subgraph_extraction(Graph pg, node_vec, SubGraphExtractionPlan plan = SubGraphExtractionPlan()) -> Graph:
+def subgraph_extraction(
+    Graph pg, node_vec, node_properties=(), edge_properties=(), SubGraphExtractionPlan plan = SubGraphExtractionPlan()
+) -> Graph:
     """
     Given a set of node ids, this algorithm constructs a new sub-graph which contains all nodes in the set and edges
-    between them.
+    between them. Node i of the sub-graph is the i-th distinct node of node_vec.
+
+    :param node_properties: Names of the node properties to copy to the sub-graph.
+    :param edge_properties: Names of the edge properties to copy to the sub-graph.
     """
     cdef vector[uint32_t] vec = [<uint32_t>n for n in node_vec]
+    cdef vector[string] node_props = [bytes(p, "utf-8") for p in node_properties]
+    cdef vector[string] edge_props = [bytes(p, "utf-8") for p in edge_properties]
     with nogil:
-        v = handle_result_property_graph(SubGraphExtraction(pg.underlying_property_graph(), vec, plan.underlying_))
+        v = handle_result_property_graph(
+            SubGraphExtraction(pg.underlying_property_graph(), vec, node_props, edge_props, plan.underlying_)
+        )
     return Graph.make(v)
+
+
+def k_hop_neighborhood(Graph pg, seeds, uint32_t num_hops):
+    """
+    Find the nodes within num_hops out-edges of the seeds: the seeds in the order given, followed by the nodes at each
+    distance in increasing order. Pass the result to :py:func:`subgraph_extraction` to extract their ego-network.
+
+    :return: A list of node ids.
+    """
+    cdef vector[uint32_t] vec = [<uint32_t>n for n in seeds]
+    cdef Result[vector[uint32_t]] res
+    with nogil:
+        res = KHopNeighborhood(pg.underlying_property_graph(), vec, num_hops)
+    if not res.has_value():
+        raise_error_code(res.error())
+    return list(res.value())
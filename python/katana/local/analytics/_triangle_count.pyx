@@ -15,10 +15,18 @@ Triangle Counting
     :undoc-members:
 
 .. autofunction:: katana.local.analytics.triangle_count
+
+.. autofunction:: katana.local.analytics.triangle_count_approximate
+
+.. autoclass:: katana.local.analytics.TriangleCountEstimate
+    :members:
+    :undoc-members:
 """
-from libc.stdint cimport uint64_t
+from libc.stdint cimport uint32_t, uint64_t
 from libcpp cimport bool
 
+from katana.cpp.libstd.iostream cimport ostream, ostringstream
+
 from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
 from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_result_void, raise_error_code
 from katana.local._graph cimport Graph
@@ -33,6 +41,7 @@ cdef extern from "katana/analytics/triangle_count/triangle_count.h" namespace "k
             kNodeIteration "katana::analytics::TriangleCountPlan::kNodeIteration"
             kEdgeIteration "katana::analytics::TriangleCountPlan::kEdgeIteration"
             kOrderedCount "katana::analytics::TriangleCountPlan::kOrderedCount"
+            kWedgeSampling "katana::analytics::TriangleCountPlan::kWedgeSampling"
 
         enum Relabeling:
             kRelabel "katana::analytics::TriangleCountPlan::kRelabel"
@@ -42,6 +51,9 @@ cdef extern from "katana/analytics/triangle_count/triangle_count.h" namespace "k
         _TriangleCountPlan.Algorithm algorithm() const
         _TriangleCountPlan.Relabeling relabeling() const
         bool edges_sorted() const
+        uint64_t num_samples() const
+        uint32_t time_budget_ms() const
+        double confidence() const
 
         TriangleCountPlan()
 
@@ -51,18 +63,38 @@ cdef extern from "katana/analytics/triangle_count/triangle_count.h" namespace "k
         _TriangleCountPlan EdgeIteration(bool edges_sorted, _TriangleCountPlan.Relabeling relabeling)
         @staticmethod
         _TriangleCountPlan OrderedCount(bool edges_sorted, _TriangleCountPlan.Relabeling relabeling)
+        @staticmethod
+        _TriangleCountPlan WedgeSampling(uint64_t num_samples, uint32_t time_budget_ms, double confidence)
 
 
     _TriangleCountPlan.Relabeling kDefaultRelabeling "katana::analytics::TriangleCountPlan::kDefaultRelabeling"
     bool kDefaultEdgeSorted "katana::analytics::TriangleCountPlan::kDefaultEdgeSorted"
+    uint64_t kDefaultNumSamples "katana::analytics::TriangleCountPlan::kDefaultNumSamples"
+    uint32_t kDefaultTimeBudgetMs "katana::analytics::TriangleCountPlan::kDefaultTimeBudgetMs"
+    double kDefaultConfidence "katana::analytics::TriangleCountPlan::kDefaultConfidence"
 
     Result[uint64_t] TriangleCount(_PropertyGraph* pg, _TriangleCountPlan plan)
 
+    cppclass _TriangleCountEstimate "katana::analytics::TriangleCountEstimate":
+        double triangles
+        double triangles_lower
+        double triangles_upper
+        double average_clustering
+        double average_clustering_lower
+        double average_clustering_upper
+        double confidence
+        uint64_t num_samples
+        uint64_t num_wedges
+        void Print(ostream os)
+
+    Result[_TriangleCountEstimate] TriangleCountApproximate(_PropertyGraph* pg, _TriangleCountPlan plan)
+
 
 class _TriangleCountPlanAlgorithm(Enum):
     NodeIteration = _TriangleCountPlan.Algorithm.kNodeIteration
     EdgeIteration = _TriangleCountPlan.Algorithm.kEdgeIteration
     OrderedCount = _TriangleCountPlan.Algorithm.kOrderedCount
+    WedgeSampling = _TriangleCountPlan.Algorithm.kWedgeSampling
 
 
 cdef _relabeling_to_python(v):
@@ -125,6 +157,27 @@ cdef class TriangleCountPlan(Plan):
         """
         return _relabeling_to_python(self.underlying_.relabeling())
 
+    @property
+    def num_samples(self) -> int:
+        """
+        The most wedges to sample with :py:meth:`wedge_sampling`.
+        """
+        return self.underlying_.num_samples()
+
+    @property
+    def time_budget_ms(self) -> int:
+        """
+        Milliseconds after which :py:meth:`wedge_sampling` stops sampling, or 0 for no limit.
+        """
+        return self.underlying_.time_budget_ms()
+
+    @property
+    def confidence(self) -> float:
+        """
+        The probability that the intervals of a :py:class:`TriangleCountEstimate` hold the exact values.
+        """
+        return self.underlying_.confidence()
+
     @staticmethod
     def node_iteration(bool edges_sorted = kDefaultEdgeSorted,
                        relabeling = _relabeling_to_python(kDefaultRelabeling)):
@@ -169,6 +222,24 @@ cdef class TriangleCountPlan(Plan):
         return TriangleCountPlan.make(_TriangleCountPlan.OrderedCount(
             edges_sorted, _relabeling_from_python(relabeling)))
 
+    @staticmethod
+    def wedge_sampling(uint64_t num_samples = kDefaultNumSamples, uint32_t time_budget_ms = kDefaultTimeBudgetMs,
+                       double confidence = kDefaultConfidence):
+        """
+        Estimate the count from uniformly sampled wedges (paths of length two), without sorting or relabeling the
+        graph. Use :py:func:`triangle_count_approximate` to get the confidence interval.
+
+        C. Seshadhri, A. Pinar, T. G. Kolda. Triadic Measures on Graphs: The Power of Wedge Sampling. SDM 2013.
+
+        :type num_samples: int
+        :param num_samples: The most wedges to sample.
+        :type time_budget_ms: int
+        :param time_budget_ms: Stop sampling after this many milliseconds, or 0 for no limit.
+        :type confidence: float
+        :param confidence: The probability that the confidence interval holds the exact count, in (0, 1).
+        """
+        return TriangleCountPlan.make(_TriangleCountPlan.WedgeSampling(num_samples, time_budget_ms, confidence))
+
     def __str__(self):
         return "TriangleCountPlan({}, {}, {})".format(self.algorithm.name, self.edges_sorted, self.relabeling)
 
@@ -206,3 +277,83 @@ def triangle_count(Graph pg,  TriangleCountPlan plan = TriangleCountPlan()) -> i
     with nogil:
         v = handle_result_int(TriangleCount(pg.underlying_property_graph(), plan.underlying_))
     return v
+
+
+cdef _TriangleCountEstimate handle_result_TriangleCountEstimate(Result[_TriangleCountEstimate] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef class TriangleCountEstimate:
+    """
+    Estimates of the number of triangles and of the average local clustering coefficient, each with the bounds of its
+    confidence interval.
+    """
+    cdef _TriangleCountEstimate underlying
+
+    @staticmethod
+    cdef TriangleCountEstimate make(_TriangleCountEstimate u):
+        f = <TriangleCountEstimate>TriangleCountEstimate.__new__(TriangleCountEstimate)
+        f.underlying = u
+        return f
+
+    @property
+    def triangles(self) -> float:
+        return self.underlying.triangles
+
+    @property
+    def triangles_lower(self) -> float:
+        return self.underlying.triangles_lower
+
+    @property
+    def triangles_upper(self) -> float:
+        return self.underlying.triangles_upper
+
+    @property
+    def average_clustering(self) -> float:
+        return self.underlying.average_clustering
+
+    @property
+    def average_clustering_lower(self) -> float:
+        return self.underlying.average_clustering_lower
+
+    @property
+    def average_clustering_upper(self) -> float:
+        return self.underlying.average_clustering_upper
+
+    @property
+    def confidence(self) -> float:
+        return self.underlying.confidence
+
+    @property
+    def num_samples(self) -> int:
+        return self.underlying.num_samples
+
+    @property
+    def num_wedges(self) -> int:
+        return self.underlying.num_wedges
+
+    def __str__(self) -> str:
+        cdef ostringstream ss
+        self.underlying.Print(ss)
+        return str(ss.str(), "ascii")
+
+
+def triangle_count_approximate(Graph pg, TriangleCountPlan plan = TriangleCountPlan.wedge_sampling()) \
+        -> TriangleCountEstimate:
+    """
+    Estimate the number of triangles and the average local clustering coefficient of `pg` by sampling wedges.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze. It must be symmetric.
+    :type plan: TriangleCountPlan
+    :param plan: A :py:meth:`TriangleCountPlan.wedge_sampling` plan.
+    :return: The estimates with their confidence intervals.
+    """
+    cdef _TriangleCountEstimate estimate
+    with nogil:
+        estimate = handle_result_TriangleCountEstimate(
+            TriangleCountApproximate(pg.underlying_property_graph(), plan.underlying_))
+    return TriangleCountEstimate.make(estimate)
@@ -0,0 +1,21 @@
+from libc.stdint cimport uint64_t
+from libcpp.memory cimport unique_ptr
+
+
+cdef extern from "katana/analytics/AnalyticsContext.h" namespace "katana::analytics" nogil:
+    cppclass _AnalyticsContext "katana::analytics::AnalyticsContext":
+        void Clear()
+        uint64_t num_allocations() const
+        void Cancel()
+        void ResetCancelled()
+        bint cancelled() const
+
+
+cdef class AnalyticsContext:
+    cdef unique_ptr[_AnalyticsContext] underlying_
+
+
+cdef inline _AnalyticsContext* underlying_context(AnalyticsContext context):
+    if context is None:
+        return NULL
+    return context.underlying_.get()
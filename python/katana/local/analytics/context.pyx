@@ -0,0 +1,100 @@
+import threading
+from concurrent.futures import CancelledError, Future, ThreadPoolExecutor
+
+
+cdef class AnalyticsContext:
+    """
+    Scratch memory kept between calls of the analytics routines that accept a ``context``, and a flag to cancel the
+    call using it. A context may be used by one call at a time.
+
+    Routines check the flag between rounds, so a round in progress finishes first, and then raise without writing
+    their output property.
+    """
+    def __cinit__(self):
+        self.underlying_.reset(new _AnalyticsContext())
+
+    def cancel(self):
+        """
+        Ask the call using this context to stop. This may be called from any thread. Later calls with this context
+        are cancelled too, until :py:meth:`reset_cancelled`.
+        """
+        self.underlying_.get().Cancel()
+
+    def reset_cancelled(self):
+        self.underlying_.get().ResetCancelled()
+
+    @property
+    def cancelled(self) -> bool:
+        return self.underlying_.get().cancelled()
+
+    def clear(self):
+        """
+        Release all scratch memory.
+        """
+        self.underlying_.get().Clear()
+
+    @property
+    def num_allocations(self) -> int:
+        return self.underlying_.get().num_allocations()
+
+
+class AnalyticsFuture(Future):
+    """
+    The result of an ``*_async`` analytics call, e.g., :py:func:`~katana.local.analytics.bfs_async`.
+
+    Unlike other futures, a running call can be cancelled: :py:meth:`cancel` sets the cancellation flag of the
+    :py:class:`AnalyticsContext` of the call, and once the routine stops, :py:meth:`result` raises
+    :py:class:`concurrent.futures.CancelledError`.
+    """
+
+    def __init__(self, context: AnalyticsContext):
+        super().__init__()
+        self.context = context
+
+    def cancel(self) -> bool:
+        if super().cancel():
+            return True
+        if self.done():
+            return False
+        self.context.cancel()
+        return True
+
+
+# One thread, because the Katana thread pool runs one parallel region at a time. It starts the parallel loops of each
+# call, in turn, while the threads that submitted them carry on.
+_executor = None
+_executor_lock = threading.Lock()
+
+
+def _get_executor():
+    global _executor
+    with _executor_lock:
+        if _executor is None:
+            _executor = ThreadPoolExecutor(max_workers=1, thread_name_prefix="katana-analytics")
+        return _executor
+
+
+def submit(fn, *args, **kwargs) -> AnalyticsFuture:
+    """
+    Call ``fn(*args, context=context, **kwargs)`` on the analytics thread with a new :py:class:`AnalyticsContext`,
+    and return a future of its result. ``fn`` is expected to release the GIL while it computes, as the analytics
+    routines do.
+
+    Calls are run one at a time in the order they are submitted. While one runs, other threads should not run Katana
+    routines or modify the graphs it uses.
+    """
+    context = AnalyticsContext()
+    future = AnalyticsFuture(context)
+
+    def run():
+        if not future.set_running_or_notify_cancel():
+            return
+        try:
+            result = fn(*args, context=context, **kwargs)
+        except BaseException as e:
+            future.set_exception(CancelledError() if context.cancelled else e)
+        else:
+            future.set_result(result)
+
+    _get_executor().submit(run)
+    return future
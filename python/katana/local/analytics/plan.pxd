@@ -7,6 +7,8 @@ cdef extern from "katana/analytics/Plan.h" namespace "katana::analytics" nogil:
 
     cppclass _Plan "katana::analytics::Plan":
         _Architecture architecture() const
+        double edge_weight_tolerance() const
+        void set_edge_weight_tolerance(double tolerance)
 
 
 cdef class Plan:
@@ -47,6 +47,19 @@ cdef class Plan:
         """
         return Architecture(self.underlying().architecture())
 
+    @property
+    def edge_weight_tolerance(self) -> float:
+        """
+        The largest difference from its edge weight property that a weighted algorithm may round an edge weight by to
+        pack the weights into 8 or 16 bits. With the default, 0, weights are only packed when no weight changes. A
+        positive tolerance may change the results.
+        """
+        return self.underlying().edge_weight_tolerance()
+
+    @edge_weight_tolerance.setter
+    def edge_weight_tolerance(self, double tolerance):
+        self.underlying().set_edge_weight_tolerance(tolerance)
+
 
 cdef class Statistics:
     """
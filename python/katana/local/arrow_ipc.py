@@ -0,0 +1,124 @@
+"""
+The :py:mod:`~katana.local.arrow_ipc` module streams the topology and properties of a
+:py:class:`~katana.local.Graph` as Arrow record batches, and builds a graph back from such streams.
+
+A graph is two streams: one row per node with the CSR index (see :py:meth:`~katana.local.Graph.adj_indices`) and the
+node properties, and one row per edge with the destination (see :py:meth:`~katana.local.Graph.edge_dests`) and the
+edge properties. The batches are slices of the buffers of the graph, so building them copies nothing and serializing
+them is done by Arrow in C++ without Python objects.
+
+The readers returned by :py:func:`node_batches` and :py:func:`edge_batches` can be written to any Arrow IPC sink, e.g.,
+a file or a socket, or served as is by an Arrow Flight server (e.g., with ``pyarrow.flight.RecordBatchStream``)::
+
+    with open("nodes.arrows", "wb") as nodes, open("edges.arrows", "wb") as edges:
+        to_ipc_streams(graph, nodes, edges)
+    with open("nodes.arrows", "rb") as nodes, open("edges.arrows", "rb") as edges:
+        copy = from_ipc_streams(nodes, edges)
+"""
+
+import pyarrow
+import pyarrow.ipc
+
+from katana.local._graph import Graph
+from katana.local._import_data import from_csr
+
+__all__ = [
+    "ADJ_INDEX_COLUMN",
+    "EDGE_DEST_COLUMN",
+    "DEFAULT_MAX_CHUNKSIZE",
+    "node_batches",
+    "edge_batches",
+    "to_ipc_streams",
+    "from_ipc_streams",
+]
+
+ADJ_INDEX_COLUMN = "_katana_adj_index"
+"""The column of the node stream holding the CSR index."""
+
+EDGE_DEST_COLUMN = "_katana_edge_dest"
+"""The column of the edge stream holding the edge destinations."""
+
+DEFAULT_MAX_CHUNKSIZE = 1 << 20
+"""The default maximum number of rows in a record batch."""
+
+
+def _property_table(topology_column, topology_array, schema, get_property):
+    if topology_column in schema.names:
+        raise ValueError(f"property name {topology_column} is reserved for the topology")
+    columns = [pyarrow.array(topology_array)] + [get_property(name) for name in schema.names]
+    return pyarrow.table(columns, names=[topology_column] + schema.names)
+
+
+def _batches(table, max_chunksize):
+    if max_chunksize <= 0:
+        raise ValueError("max_chunksize must be positive")
+    return pyarrow.RecordBatchReader.from_batches(table.schema, table.to_batches(max_chunksize=max_chunksize))
+
+
+def node_batches(graph: Graph, max_chunksize: int = DEFAULT_MAX_CHUNKSIZE) -> pyarrow.RecordBatchReader:
+    """
+    Return a reader of record batches of at most `max_chunksize` nodes each, with the column `ADJ_INDEX_COLUMN`
+    followed by the node properties. The batches share memory with the graph.
+    """
+    table = _property_table(
+        ADJ_INDEX_COLUMN, graph.adj_indices(), graph.loaded_node_schema(), graph.get_node_property_chunked
+    )
+    return _batches(table, max_chunksize)
+
+
+def edge_batches(graph: Graph, max_chunksize: int = DEFAULT_MAX_CHUNKSIZE) -> pyarrow.RecordBatchReader:
+    """
+    Return a reader of record batches of at most `max_chunksize` edges each, with the column `EDGE_DEST_COLUMN`
+    followed by the edge properties. The batches share memory with the graph.
+    """
+    table = _property_table(
+        EDGE_DEST_COLUMN, graph.edge_dests(), graph.loaded_edge_schema(), graph.get_edge_property_chunked
+    )
+    return _batches(table, max_chunksize)
+
+
+def _write(reader, sink):
+    with pyarrow.ipc.new_stream(sink, reader.schema) as writer:
+        for batch in reader:
+            writer.write_batch(batch)
+
+
+def to_ipc_streams(graph: Graph, node_sink, edge_sink, max_chunksize: int = DEFAULT_MAX_CHUNKSIZE):
+    """
+    Write `graph` as two Arrow IPC streams of record batches of at most `max_chunksize` rows.
+
+    :param node_sink: Where to write the nodes, a path, a file-like object or a `pyarrow.NativeFile`.
+    :param edge_sink: Where to write the edges, like `node_sink`.
+    """
+    _write(node_batches(graph, max_chunksize), node_sink)
+    _write(edge_batches(graph, max_chunksize), edge_sink)
+
+
+def _read(source, topology_column):
+    if hasattr(source, "read_all"):
+        # A pyarrow.RecordBatchReader or a pyarrow.flight.FlightStreamReader
+        table = source.read_all()
+    else:
+        table = pyarrow.ipc.open_stream(source).read_all()
+    if topology_column not in table.column_names:
+        raise ValueError(f"stream has no column {topology_column}")
+    index = table.column_names.index(topology_column)
+    return table.column(index).to_numpy(), table.remove_column(index)
+
+
+def from_ipc_streams(node_source, edge_source) -> Graph:
+    """
+    Build a :py:class:`~katana.local.Graph` from the node and edge streams written by `to_ipc_streams`, or from readers
+    like those returned by `node_batches` and `edge_batches`, e.g., the readers of an Arrow Flight client.
+
+    :param node_source: The nodes, a reader with a ``read_all`` method or anything `pyarrow.ipc.open_stream` reads.
+    :param edge_source: The edges, like `node_source`.
+    """
+    adj_indices, node_properties = _read(node_source, ADJ_INDEX_COLUMN)
+    edge_dests, edge_properties = _read(edge_source, EDGE_DEST_COLUMN)
+    graph = from_csr(adj_indices, edge_dests)
+    if node_properties.num_columns:
+        graph.add_node_property(node_properties)
+    if edge_properties.num_columns:
+        graph.add_edge_property(edge_properties)
+    return graph
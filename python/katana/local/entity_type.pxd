@@ -1,4 +1,4 @@
-from libc.stdint cimport uint8_t
+from libc.stdint cimport uint16_t
 from libcpp.string cimport string
 
 from katana.cpp.libsupport.entity_type_manager cimport EntityTypeManager
@@ -6,6 +6,6 @@ from katana.cpp.libsupport.entity_type_manager cimport EntityTypeManager
 
 cdef class EntityType:
     cdef const EntityTypeManager *_type_manager
-    cdef uint8_t _type_id
+    cdef uint16_t _type_id
     @staticmethod
-    cdef EntityType make(const EntityTypeManager *manager, uint8_t type_id)
+    cdef EntityType make(const EntityTypeManager *manager, uint16_t type_id)
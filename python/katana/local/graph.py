@@ -1,4 +1,4 @@
 import katana.local._graph_numba
-from katana.local._graph import Graph
+from katana.local._graph import Graph, TopologyView
 
-__all__ = ["Graph"]
+__all__ = ["Graph", "TopologyView"]
@@ -5,11 +5,10 @@ and convert it into a Katana :py:class:`~katana.local.Graph` object.
 
 from typing import Collection, Dict, Optional, Union
 
-import numba
 import numpy as np
 
 from katana.local._graph import Graph
-from katana.local._import_data import from_csr, from_graphml
+from katana.local._import_data import _from_edge_list_arrays, from_csr, from_graphml
 from katana.native_interfacing.buffer_access import to_numpy
 
 __all__ = [
@@ -47,26 +46,13 @@ def from_edge_list_matrix(edges: np.ndarray) -> Graph:
     return from_edge_list_arrays(edges[:, 0], edges[:, 1])
 
 
-@numba.njit()
-def _fill_indices(sort_order: np.ndarray, sources: np.ndarray, indices: np.ndarray):
-    last_source = 0
-    for source_index, edge_index in enumerate(sort_order):
-        source = sources[source_index]
-        if source != last_source:
-            for j in range(last_source, source):
-                indices[j] = edge_index
-            last_source = source
-    for j in range(last_source, len(indices)):
-        indices[j] = len(sources)
-
-
 def from_edge_list_arrays(
     sources: np.ndarray, destinations: np.ndarray, property_dict: Dict[str, np.ndarray] = None, **properties: np.ndarray
 ) -> Graph:
     """
     Convert an edge list represented as two parallel arrays into a :py:class:`~katana.local.Graph`.
 
-    This preserves node IDs, but not edge IDs.
+    This preserves node IDs, but not edge IDs. The edges of each node are in the order of the arrays.
     """
     sources = to_numpy(sources)
     destinations = to_numpy(destinations)
@@ -91,18 +77,8 @@ def from_edge_list_arrays(
         if len(prop) != n_edges:
             raise ValueError(f"{name} does not have length equal to sources.")
 
-    n_nodes = max(np.max(sources), np.max(destinations)) + 1
-
-    sort_order = sources.argsort()
-
-    csr_destinations = destinations[sort_order]
-    csr_indices = np.empty(n_nodes, dtype=np.uint64)
-    _fill_indices(sort_order, sources, csr_indices)
-
-    graph = from_csr(csr_indices, csr_destinations)
-    if properties:
-        graph.add_edge_property(properties)
-    return graph
+    # The CSR is built in parallel, without the GIL, directly from the arrays
+    return _from_edge_list_arrays(np.ascontiguousarray(sources), np.ascontiguousarray(destinations), properties)
 
 
 def from_edge_list_dataframe(
@@ -0,0 +1,48 @@
+"""
+Memory accounting: the bytes that Katana's large allocations use, by the
+subsystem they belong to, and an optional budget for their total.
+"""
+from libc.stdint cimport uint64_t
+
+from katana.cpp.libsupport.memory_accounting cimport MemoryAccounting, MemoryCategory, MemoryCategoryName, kNumCategories
+
+__all__ = ["memory_usage", "get_memory_budget", "set_memory_budget", "reset_memory_peaks"]
+
+
+def memory_usage():
+    """
+    :return: A dict from each category (e.g., "Topology", "Properties") to a dict with its current and peak bytes.
+    """
+    usage = {}
+    cdef MemoryCategory category
+    for i in range(<int>kNumCategories):
+        category = <MemoryCategory>i
+        name = str(MemoryCategoryName(category), encoding="ASCII")
+        usage[name] = {"current": MemoryAccounting.current(category), "peak": MemoryAccounting.peak(category)}
+    return usage
+
+
+def get_memory_budget():
+    """
+    :return: The most bytes that may be charged to all categories together, or None if there is no budget.
+    """
+    budget = MemoryAccounting.budget()
+    return budget if budget else None
+
+
+def set_memory_budget(budget):
+    """
+    Limit the bytes charged to all categories together. Loading or adding properties past the budget raises an error
+    and leaves the graph as it was; other allocations past it are fatal.
+
+    :type budget: int or None
+    :param budget: The budget in bytes, or None to remove it.
+    """
+    MemoryAccounting.set_budget(<uint64_t>(budget or 0))
+
+
+def reset_memory_peaks():
+    """
+    Set the peak bytes of each category to its current bytes.
+    """
+    MemoryAccounting.ResetPeaks()
@@ -4,9 +4,11 @@ from tempfile import TemporaryDirectory
 
 import numpy as np
 import pandas
+import pyarrow
 import pytest
 
 from katana.local import Graph
+from katana.local.arrow_ipc import EDGE_DEST_COLUMN, edge_batches, from_ipc_streams, node_batches, to_ipc_streams
 from katana.local.import_data import (
     from_adjacency_matrix,
     from_edge_list_arrays,
@@ -60,6 +62,17 @@ def test_properties_arrays():
     assert list(g.get_edge_property("prop").to_numpy()) == [1, 2, 3]
 
 
+def test_unsorted_arrays():
+    sources = np.array([2, 0, 2, 1, 0], dtype=np.uint32)
+    destinations = np.array([0, 1, 1, 2, 2], dtype=np.int64)
+    g = from_edge_list_arrays(sources, destinations, weight=np.array([0.5, 1.5, 2.5, 3.5, 4.5]), row=np.arange(5))
+    assert [g.edges(n) for n in g] == [range(0, 2), range(2, 3), range(3, 5)]
+    # The edges of each node stay in the order of the arrays
+    assert list(g.get_edge_property("row").to_numpy()) == [1, 4, 3, 0, 2]
+    assert [g.get_edge_dest(i) for i in range(g.num_edges())] == [1, 2, 2, 0, 1]
+    assert list(g.get_edge_property("weight").to_numpy()) == [1.5, 4.5, 3.5, 0.5, 2.5]
+
+
 def test_trivial_matrix():
     g = from_edge_list_matrix(np.array([[0, 1], [1, 2], [10, 0]]))
     assert [g.edges(n) for n in g] == [
@@ -132,3 +145,29 @@ def test_load_graphml_write():
         graph = Graph(tmpdir)
         assert graph.path == f"file://{tmpdir}"
     assert graph.get_node_property(0)[1].as_py() == "Keanu Reeves"
+
+
+def test_ipc_streams(graph):
+    nodes = pyarrow.BufferOutputStream()
+    edges = pyarrow.BufferOutputStream()
+    to_ipc_streams(graph, nodes, edges, max_chunksize=1000)
+    copy = from_ipc_streams(pyarrow.BufferReader(nodes.getvalue()), pyarrow.BufferReader(edges.getvalue()))
+
+    assert copy.num_nodes() == graph.num_nodes()
+    assert copy.num_edges() == graph.num_edges()
+    assert np.array_equal(copy.adj_indices(), graph.adj_indices())
+    assert np.array_equal(copy.edge_dests(), graph.edge_dests())
+    assert copy.loaded_node_schema() == graph.loaded_node_schema()
+    assert copy.loaded_edge_schema() == graph.loaded_edge_schema()
+    for name in graph.loaded_node_schema().names:
+        assert copy.get_node_property_chunked(name).equals(graph.get_node_property_chunked(name))
+
+
+def test_ipc_batches(graph):
+    batches = list(edge_batches(graph, max_chunksize=100))
+    assert all(b.num_rows <= 100 for b in batches)
+    assert sum(b.num_rows for b in batches) == graph.num_edges()
+    assert batches[0].schema.names[0] == EDGE_DEST_COLUMN
+
+    copy = from_ipc_streams(node_batches(graph), edge_batches(graph))
+    assert np.array_equal(copy.edge_dests(), graph.edge_dests())
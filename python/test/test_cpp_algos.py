@@ -5,50 +5,100 @@ import numpy as np
 from pyarrow import Schema, table
 from pytest import approx, raises
 
-from katana import GaloisError, set_busy_wait
+from katana import GaloisError, get_active_threads, set_active_threads, set_busy_wait
 from katana.example_data import get_input
 from katana.local import Graph
 from katana.local.analytics import (
+    AnalyticsBatch,
+    AnalyticsContext,
+    BetweennessCentralityAdaptiveSources,
     BetweennessCentralityPlan,
     BetweennessCentralityStatistics,
     BfsStatistics,
+    BipartiteMatchingPlan,
+    BipartiteMatchingStatistics,
+    ConnectedComponentsPlan,
     ConnectedComponentsStatistics,
+    GraphColoringPlan,
+    GraphColoringStatistics,
+    HypergraphPartitionPlan,
+    HypergraphPartitionStatistics,
     IndependentSetPlan,
     IndependentSetStatistics,
     JaccardPlan,
     JaccardStatistics,
+    KCorePlan,
     KCoreStatistics,
+    KTrussPlan,
     KTrussStatistics,
+    LabelPropagationPlan,
+    LabelPropagationStatistics,
+    LocalClusteringCoefficientPlan,
+    LouvainClusteringPlan,
     LouvainClusteringStatistics,
+    MatrixCompletionPlan,
+    MatrixCompletionStatistics,
+    MaxFlowPlan,
+    MaxFlowStatistics,
+    MinimumSpanningForestPlan,
+    MinimumSpanningForestStatistics,
+    PagerankPlan,
     PagerankStatistics,
+    PartitionPlan,
+    PartitionStatistics,
     SsspStatistics,
+    StronglyConnectedComponentsPlan,
+    StronglyConnectedComponentsStatistics,
     TriangleCountPlan,
     betweenness_centrality,
     bfs,
     bfs_assert_valid,
+    bfs_async,
+    bipartite_matching,
+    bipartite_matching_assert_valid,
     connected_components,
     connected_components_assert_valid,
     find_edge_sorted_by_dest,
+    graph_coloring,
+    graph_coloring_assert_valid,
+    hypergraph_partition,
     independent_set,
     independent_set_assert_valid,
     jaccard,
     jaccard_assert_valid,
     k_core,
     k_core_assert_valid,
+    k_core_numbers,
+    k_hop_neighborhood,
     k_truss,
     k_truss_assert_valid,
+    k_truss_numbers,
+    label_propagation,
+    label_propagation_assert_valid,
     local_clustering_coefficient,
     louvain_clustering,
     louvain_clustering_assert_valid,
+    matrix_completion,
+    max_flow,
+    max_flow_assert_valid,
+    maximum_weight_bipartite_matching,
+    minimum_spanning_forest,
+    minimum_spanning_forest_assert_valid,
     pagerank,
     pagerank_assert_valid,
+    pagerank_async,
+    partition,
     sort_all_edges_by_dest,
     sort_nodes_by_degree,
     sssp,
     sssp_assert_valid,
+    strongly_connected_components,
+    strongly_connected_components_assert_valid,
     subgraph_extraction,
     triangle_count,
+    triangle_count_approximate,
 )
+from katana.local.import_data import from_csr
 
 NODES_TO_SAMPLE = 10
 
@@ -148,6 +198,34 @@ def test_sssp(graph: Graph):
     verify_sssp(graph, start_node, new_property_id)
 
 
+def test_async(graph: Graph):
+    bfs_future = bfs_async(graph, 0, "bfs")
+    pagerank_future = pagerank_async(graph, "rank")
+    assert bfs_future.result() is None
+    assert pagerank_future.result() is None
+    # Finished calls cannot be cancelled
+    assert not bfs_future.cancel()
+
+    bfs_assert_valid(graph, 0, "bfs")
+    pagerank_assert_valid(graph, "rank")
+
+
+def test_cancel(graph: Graph):
+    context = AnalyticsContext()
+    context.cancel()
+    assert context.cancelled
+    with raises(GaloisError):
+        bfs(graph, 0, "bfs", context=context)
+    with raises(GaloisError):
+        pagerank(graph, "rank", context=context)
+    assert "bfs" not in graph.loaded_node_schema().names
+    assert "rank" not in graph.loaded_node_schema().names
+
+    context.reset_cancelled()
+    bfs(graph, 0, "bfs", context=context)
+    bfs_assert_valid(graph, 0, "bfs")
+
+
 def test_jaccard(graph: Graph):
     property_name = "NewProp"
     compare_node = 0
@@ -225,6 +303,17 @@ def test_betweenness_centrality_outer(graph: Graph):
     assert stats.average_centrality == approx(0.000534295046236366)
 
 
+def test_betweenness_centrality_batched(graph: Graph):
+    betweenness_centrality(graph, "level", 16, BetweennessCentralityPlan.level())
+    expected = graph.get_node_property("level").to_numpy()
+
+    # One source per batch, and all of them in one
+    for max_batch_bytes in [1, BetweennessCentralityPlan.batched().max_batch_bytes]:
+        property_name = f"batched_{max_batch_bytes}"
+        betweenness_centrality(graph, property_name, 16, BetweennessCentralityPlan.batched(max_batch_bytes))
+        assert np.allclose(graph.get_node_property(property_name).to_numpy(), expected, rtol=1e-4)
+
+
 def test_betweenness_centrality_level(graph: Graph):
     property_name = "NewProp"
 
@@ -242,6 +331,21 @@ def test_betweenness_centrality_level(graph: Graph):
     assert stats.average_centrality == approx(0.000534295046236366)
 
 
+def test_betweenness_centrality_adaptive(graph: Graph):
+    num_nodes = graph.num_nodes()
+    epsilon = 0.2
+
+    for name, plan in [("Level", BetweennessCentralityPlan.level()), ("Outer", BetweennessCentralityPlan.outer())]:
+        betweenness_centrality(graph, name, BetweennessCentralityAdaptiveSources(epsilon, 0.1), plan)
+
+        stats = BetweennessCentralityStatistics(graph, name)
+        assert stats.min_centrality >= 0
+        assert stats.max_centrality <= num_nodes * (num_nodes - 1) * epsilon
+
+    with raises(GaloisError):
+        betweenness_centrality(graph, "Invalid", BetweennessCentralityAdaptiveSources(0, 0.1))
+
+
 def test_triangle_count():
     graph = Graph(get_input("propertygraphs/rmat15_cleaned_symmetric"))
     original_first_edge_list = [graph.get_edge_dest(e) for e in graph.edges(0)]
@@ -269,6 +373,17 @@ def test_triangle_count_presorted():
     assert n == 282617
 
 
+def test_triangle_count_wedge_sampling():
+    graph = Graph(get_input("propertygraphs/rmat15_cleaned_symmetric"))
+    estimate = triangle_count_approximate(graph, TriangleCountPlan.wedge_sampling(confidence=0.99))
+    assert estimate.triangles_lower <= 282617 <= estimate.triangles_upper
+    assert 0 <= estimate.average_clustering_lower <= estimate.average_clustering_upper <= 1
+    assert estimate.num_samples == TriangleCountPlan.wedge_sampling().num_samples
+
+    n = triangle_count(graph, TriangleCountPlan.wedge_sampling())
+    assert n == round(triangle_count_approximate(graph).triangles)
+
+
 def test_independent_set():
     graph = Graph(get_input("propertygraphs/rmat10_symmetric"))
 
@@ -285,6 +400,44 @@ def test_independent_set():
     independent_set_assert_valid(graph, "output2")
 
 
+def test_independent_set_luby():
+    graph = Graph(get_input("propertygraphs/rmat10_symmetric"))
+
+    previous_threads = get_active_threads()
+    try:
+        set_active_threads(1)
+        independent_set(graph, "deterministic1", IndependentSetPlan.deterministic())
+        set_active_threads(4)
+        independent_set(graph, "deterministic4", IndependentSetPlan.deterministic())
+    finally:
+        set_active_threads(previous_threads)
+    independent_set_assert_valid(graph, "deterministic4")
+    assert (
+        graph.get_node_property("deterministic1").to_numpy() == graph.get_node_property("deterministic4").to_numpy()
+    ).all()
+
+    independent_set(graph, "luby", IndependentSetPlan.luby())
+    independent_set_assert_valid(graph, "luby")
+    assert IndependentSetStatistics(graph, "luby").cardinality > 0
+
+
+def test_graph_coloring():
+    graph = Graph(get_input("propertygraphs/rmat10_symmetric"))
+
+    graph_coloring(graph, "output")
+    graph_coloring_assert_valid(graph, "output")
+    stats = GraphColoringStatistics(graph, "output")
+    colors = graph.get_node_property("output").to_numpy()
+    assert stats.num_colors == colors.max() + 1
+    assert stats.largest_color_class == np.bincount(colors).max()
+
+    graph_coloring(graph, "output2", GraphColoringPlan.jones_plassmann())
+    assert (graph.get_node_property("output2").to_numpy() == colors).all()
+
+    graph_coloring(graph, "output3", GraphColoringPlan.speculative(GraphColoringPlan.Priority.Random))
+    graph_coloring_assert_valid(graph, "output3")
+
+
 def test_connected_components():
     graph = Graph(get_input("propertygraphs/rmat10_symmetric"))
 
@@ -300,6 +453,28 @@ def test_connected_components():
     connected_components_assert_valid(graph, "output")
 
 
+def test_analytics_batch():
+    graph = Graph(get_input("propertygraphs/rmat10_symmetric"))
+
+    AnalyticsBatch().add_out_degree("out").add_in_degree("in").add_pagerank("rank").add_connected_components(
+        "component"
+    ).run(graph)
+
+    pagerank(graph, "pagerank", PagerankPlan.pull_topological())
+    connected_components(graph, "label_prop", ConnectedComponentsPlan.label_prop())
+
+    out_degree = graph.get_node_property("out").to_numpy()
+    assert out_degree.sum() == graph.num_edges()
+    assert (out_degree == graph.get_node_property("in").to_numpy()).all()
+    assert graph.get_node_property("rank").to_numpy() == approx(graph.get_node_property("pagerank").to_numpy(), abs=1e-5)
+    assert (graph.get_node_property("component").to_numpy() == graph.get_node_property("label_prop").to_numpy()).all()
+
+    with raises(GaloisError):
+        AnalyticsBatch().add_out_degree("out").run(graph)
+    with raises(GaloisError):
+        AnalyticsBatch().add_out_degree("same").add_in_degree("same").run(graph)
+
+
 def test_k_core():
     graph = Graph(get_input("propertygraphs/rmat10_symmetric"))
 
@@ -312,6 +487,23 @@ def test_k_core():
     k_core_assert_valid(graph, 10, "output")
 
 
+def test_k_core_bucket_peeling():
+    graph = Graph(get_input("propertygraphs/rmat10_symmetric"))
+
+    k_core(graph, 10, "output", KCorePlan.bucket_peeling())
+
+    stats = KCoreStatistics(graph, 10, "output")
+
+    assert stats.number_of_nodes_in_kcore == 438
+
+    k_core_assert_valid(graph, 10, "output")
+
+    k_core_numbers(graph, "core")
+    in_core = graph.get_node_property("output").to_numpy()
+    core = graph.get_node_property("core").to_numpy()
+    assert ((core >= 10) == (in_core == 1)).all()
+
+
 def test_k_truss():
     graph = Graph(get_input("propertygraphs/rmat10_symmetric"))
 
@@ -324,6 +516,21 @@ def test_k_truss():
     k_truss_assert_valid(graph, 10, "output")
 
 
+def test_k_truss_decomposition():
+    graph = Graph(get_input("propertygraphs/rmat10_symmetric"))
+
+    k_truss(graph, 10, "output", KTrussPlan.truss_decomposition())
+
+    stats = KTrussStatistics(graph, 10, "output")
+
+    assert stats.number_of_edges_left == 13338
+
+    k_truss_numbers(graph, "trussness")
+    alive = graph.get_edge_property("output").to_numpy()
+    trussness = graph.get_edge_property("trussness").to_numpy()
+    assert ((trussness >= 10) == (alive == 0)).all()
+
+
 def test_k_truss_fail():
     graph = Graph(get_input("propertygraphs/rmat10_symmetric"))
 
@@ -349,6 +556,264 @@ def test_louvain_clustering():
     # assert stats.largest_cluster_size == 297
 
 
+def test_louvain_clustering_leiden():
+    graph = Graph(get_input("propertygraphs/rmat10_symmetric"))
+
+    louvain_clustering(graph, "value", "output", LouvainClusteringPlan.leiden())
+
+    louvain_clustering_assert_valid(graph, "value", "output")
+
+    stats = LouvainClusteringStatistics(graph, "value", "output")
+    assert stats.modularity > 0
+
+
+def test_label_propagation():
+    graph = Graph(get_input("propertygraphs/rmat10_symmetric"))
+
+    label_propagation(graph, "output")
+    label_propagation_assert_valid(graph, "output")
+    stats = LabelPropagationStatistics(graph, "output")
+    assert 0 < stats.total_communities < graph.num_nodes()
+
+    label_propagation(graph, "one_round", LabelPropagationPlan.frontier(max_iterations=1))
+    label_propagation_assert_valid(graph, "one_round")
+
+    with raises(GaloisError):
+        label_propagation(graph, "bad", LabelPropagationPlan.frontier(changed_fraction_threshold=2.0))
+
+
+def test_label_propagation_triangles():
+    # Two directed triangles 0 -> 1 -> 2 -> 0 and 3 -> 4 -> 5 -> 3
+    edge_indices = np.array([1, 2, 3, 4, 5, 6], dtype=np.uint64)
+    edge_destinations = np.array([1, 2, 0, 4, 5, 3], dtype=np.uint32)
+    graph = from_csr(edge_indices, edge_destinations)
+
+    label_propagation(graph, "output", LabelPropagationPlan.frontier(changed_fraction_threshold=0.0))
+    labels = graph.get_node_property("output").to_numpy()
+    assert labels[0] == labels[1] == labels[2]
+    assert labels[3] == labels[4] == labels[5]
+    assert labels[0] != labels[3]
+    stats = LabelPropagationStatistics(graph, "output")
+    assert stats.total_communities == 2
+    assert stats.largest_community_size == 3
+
+
+def test_matrix_completion():
+    num_users = 40
+    num_items = 30
+    rng = np.random.default_rng(0)
+    user_factors = rng.uniform(0.5, 1.5, (num_users, 2))
+    item_factors = rng.uniform(0.5, 1.5, (num_items, 2))
+    edge_indices = []
+    edge_destinations = []
+    ratings = []
+    for user in range(num_users):
+        for item in range(num_items):
+            if (user + item) % 3 == 0:
+                edge_destinations.append(num_users + item)
+                ratings.append(user_factors[user] @ item_factors[item])
+        edge_indices.append(len(edge_destinations))
+    edge_indices.extend([len(edge_destinations)] * num_items)
+    graph = from_csr(np.array(edge_indices, dtype=np.uint64), np.array(edge_destinations, dtype=np.uint32))
+    graph.add_edge_property(table({"rating": np.array(ratings, dtype=np.float32)}))
+
+    matrix_completion(graph, "rating", "latent", MatrixCompletionPlan.sgd(latent_vector_size=4, max_iterations=200))
+    assert len(graph.get_node_property("latent")[0]) == 4
+    stats = MatrixCompletionStatistics(graph, "rating", "latent")
+    assert stats.rmse < 0.3
+
+    matrix_completion(graph, "rating", "latent_als", MatrixCompletionPlan.als(latent_vector_size=4))
+    stats = MatrixCompletionStatistics(graph, "rating", "latent_als")
+    assert stats.rmse < 0.1
+
+    with raises(GaloisError):
+        matrix_completion(graph, "rating", "latent_error", MatrixCompletionPlan.sgd(latent_vector_size=0))
+
+
+def test_max_flow():
+    # Two disjoint paths 0 -> 1 -> 3 and 0 -> 2 -> 3, a cross edge 1 -> 2 and an edge 3 -> 4 beyond the sink
+    edge_indices = np.array([2, 4, 5, 6, 6], dtype=np.uint64)
+    edge_destinations = np.array([1, 2, 3, 2, 3, 4], dtype=np.uint32)
+    graph = from_csr(edge_indices, edge_destinations)
+    capacities = np.array([3, 2, 2, 2, 3, 5], dtype=np.uint32)
+    graph.add_edge_property(table({"capacity": capacities}))
+
+    max_flow(graph, 0, 3, "capacity", "flow", "cut")
+    max_flow_assert_valid(graph, 0, 3, "capacity", "flow")
+    stats = MaxFlowStatistics(graph, 0, "flow", "cut")
+    assert stats.flow_value == 5
+    assert stats.num_cut_edges == 2
+    assert graph.get_node_property("cut").to_numpy()[0] == 1
+    assert graph.get_node_property("cut").to_numpy()[3] == 0
+
+    max_flow(graph, 0, 3, "capacity", "flow2", "cut2", MaxFlowPlan.push_relabel(gap_relabeling=False))
+    assert MaxFlowStatistics(graph, 0, "flow2", "cut2").flow_value == 5
+
+    graph.add_edge_property(table({"zero": np.zeros(len(capacities), dtype=np.uint64)}))
+    with raises(AssertionError):
+        max_flow_assert_valid(graph, 0, 3, "capacity", "zero")
+
+    with raises(GaloisError):
+        max_flow(graph, 0, 0, "capacity", "flow3", "cut3")
+
+
+def test_minimum_spanning_forest():
+    graph = Graph(get_input("propertygraphs/rmat15"))
+
+    minimum_spanning_forest(graph, "value", "boruvka", MinimumSpanningForestPlan.boruvka())
+    minimum_spanning_forest_assert_valid(graph, "boruvka")
+    boruvka_stats = MinimumSpanningForestStatistics(graph, "value", "boruvka")
+    assert boruvka_stats.num_forest_edges + boruvka_stats.num_trees == graph.num_nodes()
+
+    minimum_spanning_forest(graph, "value", "kruskal", MinimumSpanningForestPlan.filter_kruskal(base_case_size=1024))
+    minimum_spanning_forest_assert_valid(graph, "kruskal")
+    kruskal_stats = MinimumSpanningForestStatistics(graph, "value", "kruskal")
+    assert kruskal_stats.total_weight == boruvka_stats.total_weight
+    # Ties are broken by edge, so both algorithms find the same forest
+    assert (
+        graph.get_edge_property("boruvka").to_numpy() == graph.get_edge_property("kruskal").to_numpy()
+    ).all()
+
+
+def test_minimum_spanning_forest_path():
+    # A triangle 0 - 1 - 2 and a separate edge 3 - 4
+    edge_indices = np.array([2, 3, 3, 4, 4], dtype=np.uint64)
+    edge_destinations = np.array([1, 2, 2, 4], dtype=np.uint32)
+    graph = from_csr(edge_indices, edge_destinations)
+    graph.add_edge_property(table({"weight": np.array([1.0, 3.0, 2.0, 5.0], dtype=np.float64)}))
+
+    minimum_spanning_forest(graph, "weight", "forest")
+    assert list(graph.get_edge_property("forest").to_numpy()) == [1, 0, 1, 1]
+    stats = MinimumSpanningForestStatistics(graph, "weight", "forest")
+    assert stats.num_forest_edges == 3
+    assert stats.num_trees == 2
+    assert stats.total_weight == 8.0
+
+    graph.add_edge_property(table({"cycle": np.ones(4, dtype=np.uint8)}))
+    with raises(AssertionError):
+        minimum_spanning_forest_assert_valid(graph, "cycle")
+
+
+def test_strongly_connected_components():
+    graph = Graph(get_input("propertygraphs/rmat15"))
+
+    plans = {
+        "multi_step": StronglyConnectedComponentsPlan.multi_step(),
+        "forward_backward": StronglyConnectedComponentsPlan.forward_backward(trim2=False),
+        "coloring": StronglyConnectedComponentsPlan.coloring(),
+    }
+    for name, plan in plans.items():
+        strongly_connected_components(graph, name, plan)
+        strongly_connected_components_assert_valid(graph, name)
+        # Components are numbered by their smallest node, so all plans agree
+        assert (
+            graph.get_node_property(name).to_numpy() == graph.get_node_property("multi_step").to_numpy()
+        ).all()
+
+    stats = StronglyConnectedComponentsStatistics(graph, "multi_step")
+    assert stats.total_components >= stats.total_non_trivial_components
+    assert 0 < stats.largest_component_size <= graph.num_nodes()
+
+
+def test_strongly_connected_components_cycle():
+    # A cycle 0 -> 1 -> 2 -> 0, a pair 3 <-> 4 reached from it and a tail 4 -> 5
+    edge_indices = np.array([1, 2, 4, 5, 7, 7], dtype=np.uint64)
+    edge_destinations = np.array([1, 2, 0, 3, 4, 3, 5], dtype=np.uint32)
+    graph = from_csr(edge_indices, edge_destinations)
+
+    strongly_connected_components(graph, "scc")
+    assert list(graph.get_node_property("scc").to_numpy()) == [0, 0, 0, 3, 3, 5]
+    stats = StronglyConnectedComponentsStatistics(graph, "scc")
+    assert stats.total_components == 3
+    assert stats.total_non_trivial_components == 2
+    assert stats.largest_component_size == 3
+
+    graph.add_node_property(table({"wrong": np.array([0, 0, 0, 3, 4, 5], dtype=np.uint32)}))
+    with raises(AssertionError):
+        strongly_connected_components_assert_valid(graph, "wrong")
+
+
+def test_bipartite_matching(graph: Graph):
+    bipartite_matching(graph, "Person", "push_relabel", BipartiteMatchingPlan.push_relabel())
+    bipartite_matching_assert_valid(graph, "Person", "push_relabel")
+    push_relabel_stats = BipartiteMatchingStatistics(graph, "push_relabel")
+    assert push_relabel_stats.num_matched_pairs > 0
+
+    bipartite_matching(graph, "Person", "pothen_fan", BipartiteMatchingPlan.pothen_fan())
+    bipartite_matching_assert_valid(graph, "Person", "pothen_fan")
+    assert BipartiteMatchingStatistics(graph, "pothen_fan").num_matched_pairs == push_relabel_stats.num_matched_pairs
+
+    # With unit weights, a maximum weight matching has maximum cardinality
+    graph.add_edge_property(table({"weight": np.ones(graph.num_edges(), dtype=np.int64)}))
+    maximum_weight_bipartite_matching(graph, "Person", "weight", "auction")
+    bipartite_matching_assert_valid(graph, "Person", "auction")
+    auction_stats = BipartiteMatchingStatistics(graph, "auction", "weight")
+    assert auction_stats.num_matched_pairs == push_relabel_stats.num_matched_pairs
+    assert auction_stats.total_weight == push_relabel_stats.num_matched_pairs
+
+    with raises(GaloisError):
+        bipartite_matching(graph, "NoSuchType", "no_such_type")
+    with raises(GaloisError):
+        bipartite_matching(graph, "Person", "auction_plan", BipartiteMatchingPlan.auction())
+
+
+def test_partition():
+    graph = Graph(get_input("propertygraphs/rmat10_symmetric"))
+
+    partition(graph, 4, "output")
+    stats = PartitionStatistics(graph, "output")
+    assert stats.num_partitions == 4
+    assert stats.largest_partition_size <= np.ceil(1.03 * graph.num_nodes() / 4)
+    assert 0 < stats.edge_cut < graph.num_edges()
+
+    partition(graph, 1, "output2", PartitionPlan.multilevel(imbalance=0.1))
+    stats = PartitionStatistics(graph, "output2")
+    assert stats.num_partitions == 1
+    assert stats.edge_cut == 0
+
+    with raises(GaloisError):
+        partition(graph, 0, "output3")
+
+
+def test_partition_grid():
+    width = 20
+    edge_indices = []
+    edge_destinations = []
+    for node in range(width * width):
+        if node % width + 1 < width:
+            edge_destinations.append(node + 1)
+        if node + width < width * width:
+            edge_destinations.append(node + width)
+        edge_indices.append(len(edge_destinations))
+    graph = from_csr(np.array(edge_indices, dtype=np.uint64), np.array(edge_destinations, dtype=np.uint32))
+
+    partition(graph, 2, "output")
+    stats = PartitionStatistics(graph, "output")
+    assert stats.largest_partition_size <= np.ceil(1.03 * width * width / 2)
+    # A straight cut has width edges
+    assert stats.edge_cut <= 2 * width
+
+
+def test_hypergraph_partition(graph: Graph):
+    hypergraph_partition(graph, "Person", 4, "output")
+    output = graph.get_node_property("output").to_numpy()
+    assert (output == np.iinfo(np.uint32).max).any()
+    stats = HypergraphPartitionStatistics(graph, "output")
+    assert stats.num_partitions == 4
+    assert stats.imbalance <= 1.1
+    assert stats.connectivity_cut >= stats.cut_hyperedges
+
+    hypergraph_partition(graph, "Person", 1, "output2", HypergraphPartitionPlan.recursive_bisection(imbalance=0.1))
+    stats = HypergraphPartitionStatistics(graph, "output2")
+    assert stats.num_partitions == 1
+    assert stats.connectivity_cut == 0
+
+    with raises(GaloisError):
+        hypergraph_partition(graph, "Person", 0, "output3")
+    with raises(GaloisError):
+        hypergraph_partition(graph, "NoSuchType", 4, "output3")
+
+
 def test_local_clustering_coefficient():
     graph = Graph(get_input("propertygraphs/rmat15_cleaned_symmetric"))
 
@@ -359,6 +824,15 @@ def test_local_clustering_coefficient():
     assert out[-1].as_py() == 0
     assert not np.any(np.isnan(out))
 
+    # The algorithms count the same triangles
+    for plan in [
+        LocalClusteringCoefficientPlan.ordered_count_per_thread(),
+        LocalClusteringCoefficientPlan.ordered_count_hybrid(),
+    ]:
+        local_clustering_coefficient(graph, "output_" + plan.algorithm.name, plan)
+        other = graph.get_node_property("output_" + plan.algorithm.name)
+        assert np.allclose(other.to_numpy(), out.to_numpy())
+
 
 def test_subgraph_extraction():
     graph = Graph(get_input("propertygraphs/rmat15_cleaned_symmetric"))
@@ -380,6 +854,41 @@ def test_subgraph_extraction():
         assert [pg.get_edge_dest(e) for e in pg.edges(i)] == expected_edges[i]
 
 
+def test_subgraph_extraction_properties():
+    graph = Graph(get_input("propertygraphs/rmat15_cleaned_symmetric"))
+    graph.add_node_property(table({"id": np.arange(len(graph), dtype=np.uint64)}))
+    graph.add_edge_property(table({"edge_id": np.arange(graph.num_edges(), dtype=np.uint64)}))
+    nodes = [1, 3, 11, 120]
+
+    pg = subgraph_extraction(graph, nodes, node_properties=["id"], edge_properties=["edge_id"])
+
+    assert pg.get_node_property("id").to_pylist() == nodes
+    edge_ids = pg.get_edge_property("edge_id").to_pylist()
+    for i, n in enumerate(nodes):
+        for e in pg.edges(i):
+            assert graph.get_edge_dest(edge_ids[e]) == nodes[pg.get_edge_dest(e)]
+            assert edge_ids[e] in graph.edges(n)
+
+
+def test_k_hop_neighborhood():
+    graph = Graph(get_input("propertygraphs/rmat15_cleaned_symmetric"))
+    seeds = [3, 1, 3]
+
+    assert k_hop_neighborhood(graph, seeds, 0) == [3, 1]
+
+    one_hop = k_hop_neighborhood(graph, seeds, 1)
+    expected = {graph.get_edge_dest(e) for n in [3, 1] for e in graph.edges(n)} - {3, 1}
+    assert one_hop[:2] == [3, 1]
+    assert one_hop[2:] == sorted(expected)
+
+    two_hops = k_hop_neighborhood(graph, seeds, 2)
+    assert two_hops[: len(one_hop)] == one_hop
+    assert len(set(two_hops)) == len(two_hops)
+
+    pg = subgraph_extraction(graph, two_hops)
+    assert len(pg) == len(two_hops)
+
+
 def test_busy_wait(graph: Graph):
     set_busy_wait()
     property_name = "NewProp"
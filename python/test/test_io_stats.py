@@ -0,0 +1,22 @@
+from katana.example_data import get_input
+from katana.io_stats import get_io_stats, reset_io_stats
+from katana.local import Graph
+
+
+def test_io_stats_load():
+    reset_io_stats()
+    Graph(get_input("propertygraphs/ldbc_003"))
+    stats = get_io_stats()
+    reads = stats["schemes"]["file"]["reads"]
+    assert reads["requests"] > 0
+    assert reads["bytes"] > 0
+    assert sum(reads["latency_us_histogram"]) == reads["requests"]
+    assert stats["tables_decoded"] > 0
+
+
+def test_io_stats_reset():
+    reset_io_stats()
+    stats = get_io_stats()
+    assert stats["schemes"] == {}
+    assert stats["tables_decoded"] == 0
+    assert stats["cache_hits"] == 0
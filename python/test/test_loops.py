@@ -12,6 +12,8 @@ from katana import (
     do_all_operator,
     for_each,
     for_each_operator,
+    get_active_threads,
+    get_thread_id,
     obim_metric,
 )
 
@@ -103,6 +105,18 @@ def test_do_all(modes):
     assert np.allclose(out, np.array(range(1, 11)))
 
 
+@pytest.mark.parametrize("modes", simple_modes)
+def test_do_all_thread_id(modes):
+    @do_all_operator()
+    def f(partial_sums, i):
+        partial_sums[get_thread_id()] += i
+
+    partial_sums = np.zeros(get_active_threads(), dtype=int)
+    do_all(range(1000), f(partial_sums), **modes)
+    assert partial_sums.sum() == sum(range(1000))
+    assert get_thread_id() == 0
+
+
 @pytest.mark.parametrize("modes", simple_modes)
 def test_do_all_opaque(modes):
     from katana.local import InsertBag
@@ -0,0 +1,22 @@
+from katana.memory import get_memory_budget, memory_usage, reset_memory_peaks, set_memory_budget
+
+
+def test_memory_usage():
+    usage = memory_usage()
+    assert set(usage) == {"Topology", "Views", "Properties", "Indexes", "Worklists", "Scratch"}
+    for counts in usage.values():
+        assert counts["peak"] >= counts["current"] >= 0
+    reset_memory_peaks()
+    for counts in memory_usage().values():
+        assert counts["peak"] >= counts["current"]
+
+
+def test_memory_budget():
+    old = get_memory_budget()
+    try:
+        set_memory_budget(1 << 40)
+        assert get_memory_budget() == 1 << 40
+        set_memory_budget(None)
+        assert get_memory_budget() is None
+    finally:
+        set_memory_budget(old)
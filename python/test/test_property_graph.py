@@ -6,9 +6,12 @@ import numpy as np
 import pandas
 import pyarrow
 import pytest
+from numba import njit
 
-from katana import TsubaError, do_all, do_all_operator
+from katana import GaloisError, TsubaError, do_all, do_all_operator
 from katana.local import Graph
+from katana.local.analytics import local_clustering_coefficient
+from katana.local.graph import TopologyView
 from katana.local.import_data import from_csr
 
 
@@ -210,6 +213,91 @@ def test_from_csr_k3():
     assert pg.get_edge_dest(5) == 1
 
 
+def test_topology_arrays(graph):
+    adj_indices = graph.adj_indices()
+    edge_dests = graph.edge_dests()
+    assert adj_indices.dtype == np.uint64
+    assert edge_dests.dtype == np.uint32
+    assert len(adj_indices) == graph.num_nodes()
+    assert len(edge_dests) == graph.num_edges()
+    assert adj_indices[-1] == graph.num_edges()
+    assert edge_dests[0] == graph.get_edge_dest(0)
+    assert list(edge_dests[graph.edges(10).start : graph.edges(10).stop]) == [8015]
+    with pytest.raises(ValueError):
+        edge_dests[0] = 1
+
+    # The arrays share memory with the graph and keep it alive
+    del graph
+    pg = from_csr(adj_indices, edge_dests)
+    assert pg.num_edges() == len(edge_dests)
+
+
+def test_batched_queries(graph):
+    nodes = np.array([10, 0, 10, 29945], dtype=np.uint32)
+    assert list(graph.degree(nodes)) == [len(graph.edges(n)) for n in nodes]
+
+    offsets, dests = graph.neighbors(nodes)
+    assert len(offsets) == len(nodes) + 1
+    for i, n in enumerate(nodes):
+        assert list(dests[offsets[i] : offsets[i + 1]]) == [graph.get_edge_dest(e) for e in graph.edges(n)]
+    assert list(dests[offsets[0] : offsets[1]]) == [8015]
+
+    prop = graph.loaded_node_schema().names[4]
+    values = graph.gather_node_property(prop, [10, 0, 10])
+    assert values.equals(graph.get_node_property(prop).take(pyarrow.array([10, 0, 10])))
+    assert graph.gather_node_property(4, [10, 0, 10]).equals(values)
+
+    assert len(graph.degree(np.array([], dtype=np.int64))) == 0
+    with pytest.raises(GaloisError):
+        graph.degree([graph.num_nodes()])
+
+
+def test_cached_topologies():
+    graph = from_csr(np.array([2, 4, 6], dtype=np.uint64), np.array([2, 1, 0, 2, 1, 0], dtype=np.uint32))
+    assert graph.cached_topologies() == []
+    # The clustering coefficient builds a view with edges sorted by destination
+    local_clustering_coefficient(graph, "lcc")
+    sorted_topologies = [t for t in graph.cached_topologies() if t["edge_sort"] == "dest_id"]
+    assert sorted_topologies
+    assert not sorted_topologies[0]["transposed"]
+    assert list(sorted_topologies[0]["adj_indices"]) == [2, 4, 6]
+    assert list(sorted_topologies[0]["edge_dests"]) == [1, 2, 0, 2, 0, 1]
+
+
+def test_topology_view():
+    graph = from_csr(np.array([2, 3, 3], dtype=np.uint64), np.array([2, 1, 0], dtype=np.uint32))
+    graph.add_edge_property(weight=np.array([10, 11, 12]))
+
+    in_edges = graph.topology_view(transposed=True)
+    assert isinstance(in_edges, TopologyView)
+    assert in_edges.transposed
+    assert list(in_edges.adj_indices) == [1, 2, 3]
+    assert [in_edges.get_edge_dest(e) for e in in_edges.edges(2)] == [0]
+    weights = graph.get_edge_property("weight").to_numpy()
+    assert [weights[in_edges.edge_property_indices[e]] for e in in_edges.edges(0)] == [12]
+
+    # Built once and shared with the cache
+    assert graph.topology_view(transposed=True).edge_dests.ctypes.data == in_edges.edge_dests.ctypes.data
+    assert any(t["transposed"] for t in graph.cached_topologies())
+
+    sorted_edges = graph.topology_view(edge_sort="dest_id")
+    assert list(sorted_edges.edge_dests) == [1, 2, 0]
+    assert list(sorted_edges.edge_property_indices) == [1, 0, 2]
+    with pytest.raises(ValueError):
+        graph.topology_view(edge_sort="weight")
+
+    @njit
+    def in_degrees(view):
+        ret = np.zeros(len(view.adj_indices), dtype=np.uint64)
+        for n in range(len(view.adj_indices)):
+            for e in view.edges(n):
+                ret[view.get_edge_dest(e)] += 1
+        return ret
+
+    # The out degrees from the in-edges
+    assert list(in_degrees(in_edges)) == [2, 1, 0]
+
+
 def test_load_invalid_path():
     with pytest.raises(TsubaError):
         Graph("non-existent")
@@ -0,0 +1,49 @@
+#ifndef KATANA_TOOLS_GRAPHCONVERT_KEYRANGES_H_
+#define KATANA_TOOLS_GRAPHCONVERT_KEYRANGES_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace katana {
+
+/// Split the offsets [0, span] into ranges [first, last] of about equal
+/// width, in order. There are at most num_ranges of them, and fewer when the
+/// span has fewer offsets; none is empty.
+inline std::vector<std::pair<uint64_t, uint64_t>>
+SplitSpan(uint64_t span, uint64_t num_ranges) {
+  num_ranges = std::max<uint64_t>(num_ranges, 1);
+  if (span / num_ranges == std::numeric_limits<uint64_t>::max()) {
+    // a single range of every uint64_t, whose width does not fit in one
+    return {{0, span}};
+  }
+  const uint64_t width = span / num_ranges + 1;
+  std::vector<std::pair<uint64_t, uint64_t>> ranges;
+  for (uint64_t first = 0;; first += width) {
+    uint64_t last = span - first < width ? span : first + width - 1;
+    ranges.emplace_back(first, last);
+    if (last == span) {
+      return ranges;
+    }
+  }
+}
+
+/// Split the keys [min_key, max_key] into ranges like SplitSpan
+inline std::vector<std::pair<int64_t, int64_t>>
+SplitKeyRange(int64_t min_key, int64_t max_key, uint64_t num_ranges) {
+  // offsets from min_key in uint64_t, which wrap back to int64_t
+  const uint64_t base = static_cast<uint64_t>(min_key);
+  std::vector<std::pair<int64_t, int64_t>> ranges;
+  for (const auto& [first, last] :
+       SplitSpan(static_cast<uint64_t>(max_key) - base, num_ranges)) {
+    ranges.emplace_back(
+        static_cast<int64_t>(base + first), static_cast<int64_t>(base + last));
+  }
+  return ranges;
+}
+
+}  // namespace katana
+
+#endif
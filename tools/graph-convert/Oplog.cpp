@@ -0,0 +1,792 @@
+#include "Oplog.h"
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <optional>
+#include <utility>
+
+#include <arrow/api.h>
+#include <arrow/compute/api.h>
+#include <nlohmann/json.hpp>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/DeltaGraphTopology.h"
+#include "katana/DynamicBitset.h"
+#include "katana/EntityTypeManager.h"
+#include "katana/ErrorCode.h"
+#include "katana/Loops.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+
+namespace {
+
+using Json = nlohmann::json;
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+using PropIndexVec = katana::GraphTopology::PropIndexVec;
+
+constexpr uint64_t kNoRow = std::numeric_limits<uint64_t>::max();
+
+/// The values a batch writes to one property by row; the last write to a row
+/// wins
+struct StagedColumn {
+  std::shared_ptr<arrow::DataType> type;
+  std::unordered_map<uint64_t, size_t> rows;
+  std::vector<Json> values;
+
+  void Set(uint64_t row, const Json& value) {
+    auto [it, inserted] = rows.emplace(row, values.size());
+    if (inserted) {
+      values.emplace_back(value);
+    } else {
+      values[it->second] = value;
+    }
+  }
+};
+
+using StagedColumns = std::map<std::string, StagedColumn>;
+
+katana::Result<std::string>
+IdKey(const Json& id) {
+  if (id.is_string()) {
+    return id.get<std::string>();
+  }
+  if (id.is_number_integer()) {
+    return id.dump();
+  }
+  return KATANA_ERROR(
+      katana::ErrorCode::InvalidArgument,
+      "ids must be strings or integers, found {}", id.dump());
+}
+
+/// The type of a new property whose first value is value, or null if there is
+/// no arrow type for it
+std::shared_ptr<arrow::DataType>
+InferType(const Json& value) {
+  switch (value.type()) {
+  case Json::value_t::boolean:
+    return arrow::boolean();
+  case Json::value_t::number_integer:
+  case Json::value_t::number_unsigned:
+    return arrow::int64();
+  case Json::value_t::number_float:
+    return arrow::float64();
+  case Json::value_t::string:
+    return arrow::large_utf8();
+  default:
+    return nullptr;
+  }
+}
+
+template <typename BuilderType, typename T>
+std::optional<arrow::Status>
+AppendIf(bool matches, arrow::ArrayBuilder* builder, const Json& value) {
+  if (!matches) {
+    return std::nullopt;
+  }
+  return static_cast<BuilderType*>(builder)->Append(value.get<T>());
+}
+
+katana::Result<void>
+AppendJson(arrow::ArrayBuilder* builder, const Json& value) {
+  std::optional<arrow::Status> status;
+  bool is_int = value.is_number_integer();
+  bool is_uint = value.is_number_unsigned();
+  if (value.is_null()) {
+    status = builder->AppendNull();
+  } else {
+    switch (builder->type()->id()) {
+    case arrow::Type::BOOL:
+      status = AppendIf<arrow::BooleanBuilder, bool>(
+          value.is_boolean(), builder, value);
+      break;
+    case arrow::Type::INT8:
+      status = AppendIf<arrow::Int8Builder, int8_t>(is_int, builder, value);
+      break;
+    case arrow::Type::INT16:
+      status = AppendIf<arrow::Int16Builder, int16_t>(is_int, builder, value);
+      break;
+    case arrow::Type::INT32:
+      status = AppendIf<arrow::Int32Builder, int32_t>(is_int, builder, value);
+      break;
+    case arrow::Type::INT64:
+      status = AppendIf<arrow::Int64Builder, int64_t>(is_int, builder, value);
+      break;
+    case arrow::Type::UINT8:
+      status = AppendIf<arrow::UInt8Builder, uint8_t>(is_uint, builder, value);
+      break;
+    case arrow::Type::UINT16:
+      status =
+          AppendIf<arrow::UInt16Builder, uint16_t>(is_uint, builder, value);
+      break;
+    case arrow::Type::UINT32:
+      status =
+          AppendIf<arrow::UInt32Builder, uint32_t>(is_uint, builder, value);
+      break;
+    case arrow::Type::UINT64:
+      status =
+          AppendIf<arrow::UInt64Builder, uint64_t>(is_uint, builder, value);
+      break;
+    case arrow::Type::FLOAT:
+      status = AppendIf<arrow::FloatBuilder, float>(
+          value.is_number(), builder, value);
+      break;
+    case arrow::Type::DOUBLE:
+      status = AppendIf<arrow::DoubleBuilder, double>(
+          value.is_number(), builder, value);
+      break;
+    case arrow::Type::STRING:
+      status = AppendIf<arrow::StringBuilder, std::string>(
+          value.is_string(), builder, value);
+      break;
+    case arrow::Type::LARGE_STRING:
+      status = AppendIf<arrow::LargeStringBuilder, std::string>(
+          value.is_string(), builder, value);
+      break;
+    default:
+      break;
+    }
+  }
+  if (!status) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "cannot store {} in a property of type {}", value.dump(),
+        builder->type()->ToString());
+  }
+  if (!status->ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "appending value: {}",
+        status->ToString());
+  }
+  return katana::ResultSuccess();
+}
+
+/// A property column after a batch. Row i of the result is the value staged
+/// for row origin[i], or else row origin[i] of old, which has num_old rows.
+/// Rows past num_old are new and null unless a value was staged for them. A
+/// null origin is the identity.
+///
+/// \param base_indices row i is origin[i] if it is less than num_old and
+///     num_old otherwise
+/// \param final_rows the row of the result of each row before the batch, or
+///     kNoRow if the row was deleted; null for the identity
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+BuildColumn(
+    const std::shared_ptr<arrow::ChunkedArray>& old,
+    const StagedColumn* staged, uint64_t num_old,
+    const katana::NUMAArray<uint64_t>& base_indices,
+    const katana::NUMAArray<uint64_t>* final_rows) {
+  std::shared_ptr<arrow::DataType> type = old ? old->type() : staged->type;
+
+  // Values are the old rows, a null and then the staged values
+  std::unique_ptr<arrow::ArrayBuilder> builder;
+  if (auto st = arrow::MakeBuilder(arrow::default_memory_pool(), type, &builder);
+      !st.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "making builder: {}", st.ToString());
+  }
+  KATANA_CHECKED(AppendJson(builder.get(), Json()));
+  if (staged != nullptr) {
+    for (const auto& value : staged->values) {
+      KATANA_CHECKED(AppendJson(builder.get(), value));
+    }
+  }
+  std::shared_ptr<arrow::Array> staged_values;
+  if (auto st = builder->Finish(&staged_values); !st.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "finishing values: {}", st.ToString());
+  }
+
+  arrow::ArrayVector chunks;
+  if (old) {
+    chunks = old->chunks();
+  } else {
+    auto nulls = arrow::MakeArrayOfNull(type, num_old);
+    if (!nulls.ok()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::ArrowError, "making nulls: {}",
+          nulls.status().ToString());
+    }
+    chunks.emplace_back(nulls.ValueOrDie());
+  }
+  chunks.emplace_back(staged_values);
+  auto values = std::make_shared<arrow::ChunkedArray>(chunks, type);
+
+  const uint64_t num_rows = base_indices.size();
+  auto buffer_res = arrow::AllocateBuffer(num_rows * sizeof(uint64_t));
+  if (!buffer_res.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "allocating indices: {}",
+        buffer_res.status().ToString());
+  }
+  std::shared_ptr<arrow::Buffer> buffer = std::move(buffer_res.ValueOrDie());
+  auto* indices = reinterpret_cast<uint64_t*>(buffer->mutable_data());
+  std::copy(base_indices.begin(), base_indices.end(), indices);
+  if (staged != nullptr) {
+    for (const auto& [row, pos] : staged->rows) {
+      uint64_t out = final_rows != nullptr ? (*final_rows)[row] : row;
+      if (out != kNoRow) {
+        indices[out] = num_old + 1 + pos;
+      }
+    }
+  }
+
+  std::shared_ptr<arrow::Array> index_array =
+      std::make_shared<arrow::UInt64Array>(num_rows, buffer);
+  auto taken = arrow::compute::Take(values, index_array);
+  if (!taken.ok()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::ArrowError, "taking rows: {}",
+        taken.status().ToString());
+  }
+  return taken.ValueOrDie().chunked_array();
+}
+
+/// Build the columns names of a table after a batch in parallel, one column
+/// per task; see BuildColumn
+katana::Result<std::shared_ptr<arrow::Table>>
+BuildTable(
+    const std::vector<std::string>& names,
+    const std::vector<std::shared_ptr<arrow::ChunkedArray>>& old_columns,
+    const StagedColumns& staged, uint64_t num_old,
+    const PropIndexVec* origin, uint64_t num_rows) {
+  katana::NUMAArray<uint64_t> base_indices;
+  base_indices.allocateInterleaved(num_rows);
+  katana::NUMAArray<uint64_t> final_rows;
+  if (origin != nullptr) {
+    // Origins of new rows are past num_old but below the number of rows of
+    // the batch, which is at most num_old plus the number of staged rows
+    uint64_t num_origins = num_old;
+    for (uint64_t o : *origin) {
+      num_origins = std::max(num_origins, o + 1);
+    }
+    for (const auto& [name, column] : staged) {
+      for (const auto& [row, pos] : column.rows) {
+        num_origins = std::max(num_origins, row + 1);
+      }
+    }
+    final_rows.allocateInterleaved(num_origins);
+    katana::ParallelSTL::fill(final_rows.begin(), final_rows.end(), kNoRow);
+  }
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_rows),
+      [&](uint64_t i) {
+        uint64_t o = origin != nullptr ? (*origin)[i] : i;
+        base_indices[i] = o < num_old ? o : num_old;
+        if (origin != nullptr) {
+          final_rows[o] = i;
+        }
+      },
+      katana::no_stats(), katana::loopname("BuildBaseIndices"));
+
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns(names.size());
+  std::vector<std::string> errors(names.size());
+  katana::do_all(
+      katana::iterate(size_t{0}, names.size()),
+      [&](size_t i) {
+        auto it = staged.find(names[i]);
+        auto res = BuildColumn(
+            old_columns[i], it != staged.end() ? &it->second : nullptr,
+            num_old, base_indices, origin != nullptr ? &final_rows : nullptr);
+        if (res) {
+          columns[i] = res.value();
+        } else {
+          errors[i] = fmt::format("{}", res.error());
+        }
+      },
+      katana::steal(), katana::no_stats(), katana::loopname("BuildColumns"));
+
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  for (size_t i = 0; i < names.size(); ++i) {
+    if (!errors[i].empty()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "property {}: {}", names[i],
+          errors[i]);
+    }
+    fields.emplace_back(arrow::field(names[i], columns[i]->type()));
+  }
+  return arrow::Table::Make(arrow::schema(fields), columns, num_rows);
+}
+
+/// Remove the nodes deleted and their edges from topo in parallel. The old
+/// ids of the nodes that are left are put in node_origin, and edge_origin,
+/// which has an entry for each edge of topo, is filtered to the edges that
+/// are left.
+katana::GraphTopology
+RemoveNodes(
+    const katana::GraphTopology& topo, const std::vector<Node>& deleted,
+    PropIndexVec* node_origin, PropIndexVec* edge_origin) {
+  const uint64_t num_nodes = topo.num_nodes();
+  katana::DynamicBitset is_deleted;
+  is_deleted.resize(num_nodes);
+  for (Node n : deleted) {
+    is_deleted.set(n);
+  }
+
+  // The new id of a node that is left is its count minus one
+  katana::NUMAArray<uint64_t> counts;
+  counts.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(topo.all_nodes()),
+      [&](Node n) { counts[n] = is_deleted.test(n) ? 0 : 1; },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(counts.begin(), counts.end(), counts.begin());
+  const uint64_t num_left = num_nodes > 0 ? counts[num_nodes - 1] : 0;
+
+  node_origin->allocateInterleaved(num_left);
+  katana::do_all(
+      katana::iterate(topo.all_nodes()),
+      [&](Node n) {
+        if (!is_deleted.test(n)) {
+          (*node_origin)[counts[n] - 1] = n;
+        }
+      },
+      katana::no_stats());
+
+  katana::GraphTopology::AdjIndexVec indices;
+  indices.allocateInterleaved(num_left);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_left),
+      [&](uint64_t m) {
+        uint64_t degree = 0;
+        for (Edge e : topo.edges((*node_origin)[m])) {
+          degree += is_deleted.test(topo.edge_dest(e)) ? 0 : 1;
+        }
+        indices[m] = degree;
+      },
+      katana::steal(), katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      indices.begin(), indices.end(), indices.begin());
+  const uint64_t num_edges = num_left > 0 ? indices[num_left - 1] : 0;
+
+  katana::GraphTopology::EdgeDestVec dests;
+  dests.allocateInterleaved(num_edges);
+  PropIndexVec edges_left;
+  edges_left.allocateInterleaved(num_edges);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_left),
+      [&](uint64_t m) {
+        Edge out = m > 0 ? indices[m - 1] : 0;
+        for (Edge e : topo.edges((*node_origin)[m])) {
+          Node dst = topo.edge_dest(e);
+          if (!is_deleted.test(dst)) {
+            dests[out] = counts[dst] - 1;
+            edges_left[out] = (*edge_origin)[e];
+            ++out;
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+  *edge_origin = std::move(edges_left);
+
+  return katana::GraphTopology(std::move(indices), std::move(dests));
+}
+
+/// The changes of one batch, staged without modifying the graph. Nodes and
+/// edges are named by their ids in a DeltaGraphTopology over the graph.
+class StagedBatch {
+public:
+  StagedBatch(
+      const katana::PropertyGraph& graph,
+      const std::unordered_map<std::string, Node>& ids,
+      const std::string& id_property)
+      : graph_(graph), ids_(ids), id_property_(id_property) {}
+
+  katana::Result<void> Stage(const Json& change, katana::OplogStats* stats);
+
+  /// Apply the staged changes to graph
+  katana::Result<void> Write(katana::PropertyGraph* graph);
+
+  bool deletes_nodes() const { return !deleted_.empty(); }
+
+  /// The ids of the inserted nodes; only valid if no nodes were deleted
+  const std::unordered_map<std::string, std::optional<Node>>& new_ids() const {
+    return new_ids_;
+  }
+
+private:
+  katana::DeltaGraphTopology& Delta() {
+    if (!delta_) {
+      delta_.emplace(katana::GraphTopology::Copy(graph_.topology()));
+    }
+    return *delta_;
+  }
+
+  katana::Result<std::string> Key(const Json& change, const char* name) const;
+  katana::Result<Node> Find(const std::string& key) const;
+  katana::Result<Node> FindNode(const Json& change, const char* name) const;
+  katana::Result<Edge> FindEdge(Node src, Node dst) const;
+  katana::Result<void> StageProperties(
+      const Json& change, uint64_t row, const arrow::Schema& schema,
+      StagedColumns* staged) const;
+
+  const katana::PropertyGraph& graph_;
+  const std::unordered_map<std::string, Node>& ids_;
+  const std::string& id_property_;
+
+  std::optional<katana::DeltaGraphTopology> delta_;
+  // Ids of the nodes inserted or deleted (nullopt) by this batch
+  std::unordered_map<std::string, std::optional<Node>> new_ids_;
+  std::vector<Node> deleted_;
+  uint64_t num_inserted_nodes_{0};
+  StagedColumns node_values_;
+  StagedColumns edge_values_;
+};
+
+katana::Result<std::string>
+StagedBatch::Key(const Json& change, const char* name) const {
+  auto it = change.find(name);
+  if (it == change.end()) {
+    return KATANA_ERROR(katana::ErrorCode::InvalidArgument, "no {}", name);
+  }
+  return IdKey(*it);
+}
+
+katana::Result<Node>
+StagedBatch::Find(const std::string& key) const {
+  if (auto it = new_ids_.find(key); it != new_ids_.end()) {
+    if (it->second) {
+      return *it->second;
+    }
+  } else if (auto it = ids_.find(key); it != ids_.end()) {
+    return it->second;
+  }
+  return KATANA_ERROR(katana::ErrorCode::NotFound, "no node {}", key);
+}
+
+katana::Result<Node>
+StagedBatch::FindNode(const Json& change, const char* name) const {
+  return Find(KATANA_CHECKED(Key(change, name)));
+}
+
+katana::Result<Edge>
+StagedBatch::FindEdge(Node src, Node dst) const {
+  if (delta_) {
+    for (Edge e : delta_->edges(src)) {
+      if (delta_->edge_dest(e) == dst) {
+        return e;
+      }
+    }
+  } else {
+    const katana::GraphTopology& topo = graph_.topology();
+    for (Edge e : topo.edges(src)) {
+      if (topo.edge_dest(e) == dst) {
+        return e;
+      }
+    }
+  }
+  return KATANA_ERROR(
+      katana::ErrorCode::NotFound, "no edge from {} to {}", src, dst);
+}
+
+katana::Result<void>
+StagedBatch::StageProperties(
+    const Json& change, uint64_t row, const arrow::Schema& schema,
+    StagedColumns* staged) const {
+  auto props = change.find("properties");
+  if (props == change.end()) {
+    return katana::ResultSuccess();
+  }
+  if (!props->is_object()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "properties must be an object");
+  }
+  for (const auto& [name, value] : props->items()) {
+    auto it = staged->find(name);
+    if (it == staged->end()) {
+      auto field = schema.GetFieldByName(name);
+      std::shared_ptr<arrow::DataType> type =
+          field ? field->type() : InferType(value);
+      if (!type) {
+        if (value.is_null()) {
+          // A null for a property that does not exist changes nothing
+          continue;
+        }
+        return KATANA_ERROR(
+            katana::ErrorCode::InvalidArgument,
+            "no property type for {} of {}", value.dump(), name);
+      }
+      it = staged->emplace(name, StagedColumn{type}).first;
+    }
+    it->second.Set(row, value);
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+StagedBatch::Stage(const Json& change, katana::OplogStats* stats) {
+  if (!change.is_object()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "changes must be JSON objects");
+  }
+  auto op_it = change.find("op");
+  if (op_it == change.end() || !op_it->is_string()) {
+    return KATANA_ERROR(katana::ErrorCode::InvalidArgument, "no op");
+  }
+  const auto& op = op_it->get_ref<const std::string&>();
+  const arrow::Schema& node_schema = *graph_.loaded_node_schema();
+  const arrow::Schema& edge_schema = *graph_.loaded_edge_schema();
+
+  if (op == "insert_node" || op == "update_node") {
+    std::string key = KATANA_CHECKED(Key(change, "id"));
+    auto props = change.find("properties");
+    if (props != change.end() && props->is_object() &&
+        props->contains(id_property_)) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "the id property {} cannot be set", id_property_);
+    }
+    Node node{};
+    if (op == "insert_node") {
+      if (Find(key)) {
+        return KATANA_ERROR(
+            katana::ErrorCode::AlreadyExists, "node {} already exists", key);
+      }
+      katana::DeltaGraphTopology& delta = Delta();
+      delta.AddNodes(1);
+      node = delta.num_nodes() - 1;
+      new_ids_[key] = node;
+      ++num_inserted_nodes_;
+      KATANA_CHECKED(StageProperties(
+          Json{{"properties", {{id_property_, change["id"]}}}}, node,
+          node_schema, &node_values_));
+      ++stats->inserted_nodes;
+    } else {
+      node = KATANA_CHECKED(Find(key));
+      ++stats->updated_nodes;
+    }
+    return StageProperties(change, node, node_schema, &node_values_);
+  }
+  if (op == "delete_node") {
+    std::string key = KATANA_CHECKED(Key(change, "id"));
+    Node node = KATANA_CHECKED(Find(key));
+    Delta();
+    new_ids_[key] = std::nullopt;
+    deleted_.emplace_back(node);
+    ++stats->deleted_nodes;
+    return katana::ResultSuccess();
+  }
+
+  Node src = KATANA_CHECKED(FindNode(change, "src"));
+  Node dst = KATANA_CHECKED(FindNode(change, "dst"));
+  if (op == "insert_edge") {
+    Edge edge = KATANA_CHECKED(Delta().InsertEdge(src, dst));
+    ++stats->inserted_edges;
+    return StageProperties(change, edge, edge_schema, &edge_values_);
+  }
+  if (op == "update_edge") {
+    Edge edge = KATANA_CHECKED(FindEdge(src, dst));
+    ++stats->updated_edges;
+    return StageProperties(change, edge, edge_schema, &edge_values_);
+  }
+  if (op == "delete_edge") {
+    KATANA_CHECKED(Delta().DeleteEdge(src, dst));
+    ++stats->deleted_edges;
+    return katana::ResultSuccess();
+  }
+  return KATANA_ERROR(
+      katana::ErrorCode::InvalidArgument, "unknown op {}", op);
+}
+
+/// The old columns of names; null for properties that do not exist yet
+template <typename F>
+std::vector<std::shared_ptr<arrow::ChunkedArray>>
+OldColumns(
+    const std::vector<std::string>& names, const arrow::Schema& schema,
+    F get_column) {
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (const auto& name : names) {
+    int i = schema.GetFieldIndex(name);
+    columns.emplace_back(i != -1 ? get_column(i) : nullptr);
+  }
+  return columns;
+}
+
+/// The names of the staged columns, and with all_columns the names of schema
+/// before them
+std::vector<std::string>
+ColumnNames(
+    const arrow::Schema& schema, const StagedColumns& staged,
+    bool all_columns) {
+  std::vector<std::string> names;
+  if (all_columns) {
+    names = schema.field_names();
+  }
+  for (const auto& [name, column] : staged) {
+    if (std::find(names.begin(), names.end(), name) == names.end()) {
+      names.emplace_back(name);
+    }
+  }
+  return names;
+}
+
+katana::Result<void>
+StagedBatch::Write(katana::PropertyGraph* graph) {
+  const uint64_t num_old_nodes = graph->num_nodes();
+  const uint64_t num_old_edges = graph->num_edges();
+  const arrow::Schema& node_schema = *graph->loaded_node_schema();
+  const arrow::Schema& edge_schema = *graph->loaded_edge_schema();
+  auto node_column = [&](int i) { return graph->GetNodeProperty(i); };
+  auto edge_column = [&](int i) { return graph->GetEdgeProperty(i); };
+
+  bool nodes_change = num_inserted_nodes_ > 0 || !deleted_.empty();
+  bool edges_change =
+      delta_ && (delta_->delta_size() > 0 || !deleted_.empty());
+
+  // Build everything before modifying the graph so that an error leaves it
+  // as it was
+  std::optional<katana::GraphTopology> topo;
+  PropIndexVec node_origin;
+  PropIndexVec edge_origin;
+  if (delta_) {
+    topo = delta_->Materialize(&edge_origin);
+    if (!deleted_.empty()) {
+      topo = RemoveNodes(*topo, deleted_, &node_origin, &edge_origin);
+    }
+  }
+
+  std::shared_ptr<arrow::Table> nodes;
+  if (auto names = ColumnNames(node_schema, node_values_, nodes_change);
+      !names.empty() || nodes_change) {
+    nodes = KATANA_CHECKED(BuildTable(
+        names, OldColumns(names, node_schema, node_column), node_values_,
+        num_old_nodes, deleted_.empty() ? nullptr : &node_origin,
+        topo ? topo->num_nodes() : num_old_nodes));
+  }
+  std::shared_ptr<arrow::Table> edges;
+  if (auto names = ColumnNames(edge_schema, edge_values_, edges_change);
+      !names.empty() || edges_change) {
+    edges = KATANA_CHECKED(BuildTable(
+        names, OldColumns(names, edge_schema, edge_column), edge_values_,
+        num_old_edges, edges_change ? &edge_origin : nullptr,
+        topo ? topo->num_edges() : num_old_edges));
+  }
+
+  if (topo) {
+    katana::PropertyGraph::EntityTypeIDArray node_types;
+    if (nodes_change) {
+      node_types.allocateInterleaved(topo->num_nodes());
+      katana::do_all(
+          katana::iterate(topo->all_nodes()),
+          [&](Node n) {
+            uint64_t o = deleted_.empty() ? n : node_origin[n];
+            node_types[n] = o < num_old_nodes ? graph->GetTypeOfNode(o)
+                                              : katana::kUnknownEntityType;
+          },
+          katana::no_stats());
+    }
+    katana::PropertyGraph::EntityTypeIDArray edge_types;
+    if (edges_change) {
+      edge_types.allocateInterleaved(topo->num_edges());
+      katana::do_all(
+          katana::iterate(uint64_t{0}, topo->num_edges()),
+          [&](uint64_t e) {
+            uint64_t o = edge_origin[e];
+            edge_types[e] = o < num_old_edges ? graph->GetTypeOfEdge(o)
+                                              : katana::kUnknownEntityType;
+          },
+          katana::no_stats());
+    }
+    KATANA_CHECKED(graph->ReplaceTopology(
+        std::move(*topo), std::move(node_types), std::move(edge_types),
+        nodes_change ? nodes : nullptr, edges_change ? edges : nullptr));
+  }
+  if (!nodes_change && nodes) {
+    KATANA_CHECKED(graph->UpsertNodeProperties(nodes));
+  }
+  if (!edges_change && edges) {
+    KATANA_CHECKED(graph->UpsertEdgeProperties(edges));
+  }
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+katana::Result<katana::OplogApplier>
+katana::OplogApplier::Make(PropertyGraph* graph, std::string id_property) {
+  if (graph->full_node_schema()->num_fields() !=
+          graph->loaded_node_schema()->num_fields() ||
+      graph->full_edge_schema()->num_fields() !=
+          graph->loaded_edge_schema()->num_fields()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "all properties must be loaded to apply changes");
+  }
+  OplogApplier applier(graph, std::move(id_property));
+  KATANA_CHECKED(applier.IndexIds());
+  return applier;
+}
+
+katana::Result<void>
+katana::OplogApplier::IndexIds() {
+  ids_.clear();
+  if (!graph_->HasNodeProperty(id_property_)) {
+    if (graph_->num_nodes() > 0) {
+      return KATANA_ERROR(
+          ErrorCode::NotFound, "no id property {}", id_property_);
+    }
+    return ResultSuccess();
+  }
+  auto ids = KATANA_CHECKED(
+      CombinedArray(KATANA_CHECKED(graph_->GetNodeProperty(id_property_))));
+  auto type_id = ids->type()->id();
+  bool is_string =
+      type_id == arrow::Type::STRING || type_id == arrow::Type::LARGE_STRING;
+  auto cast_res = arrow::compute::Cast(
+      *ids, is_string ? arrow::large_utf8() : arrow::int64());
+  if (!cast_res.ok()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "ids must be strings or integers: {}",
+        cast_res.status().ToString());
+  }
+  std::shared_ptr<arrow::Array> keys = cast_res.ValueOrDie();
+  ids_.reserve(keys->length());
+  for (int64_t i = 0; i < keys->length(); ++i) {
+    if (keys->IsNull(i)) {
+      continue;
+    }
+    std::string key =
+        is_string
+            ? static_cast<const arrow::LargeStringArray&>(*keys).GetString(i)
+            : std::to_string(
+                  static_cast<const arrow::Int64Array&>(*keys).Value(i));
+    if (!ids_.emplace(std::move(key), i).second) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "duplicate id at node {}", i);
+    }
+  }
+  return ResultSuccess();
+}
+
+katana::Result<katana::OplogStats>
+katana::OplogApplier::Apply(const std::vector<std::string>& changes) {
+  // Changes are parsed in parallel and staged in order
+  std::vector<Json> parsed(changes.size());
+  katana::do_all(
+      katana::iterate(size_t{0}, changes.size()),
+      [&](size_t i) {
+        parsed[i] = Json::parse(changes[i], nullptr, false);
+      },
+      katana::steal(), katana::no_stats(), katana::loopname("ParseChanges"));
+
+  OplogStats stats;
+  StagedBatch batch(*graph_, ids_, id_property_);
+  for (size_t i = 0; i < parsed.size(); ++i) {
+    if (parsed[i].is_discarded()) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "change {} is not valid JSON", i);
+    }
+    KATANA_CHECKED_CONTEXT(batch.Stage(parsed[i], &stats), "change {}", i);
+  }
+  KATANA_CHECKED(batch.Write(graph_));
+
+  if (batch.deletes_nodes()) {
+    KATANA_CHECKED(IndexIds());
+  } else {
+    for (const auto& [key, node] : batch.new_ids()) {
+      ids_[key] = *node;
+    }
+  }
+  return stats;
+}
@@ -0,0 +1,70 @@
+#ifndef KATANA_TOOLS_GRAPH_CONVERT_OPLOG_H
+#define KATANA_TOOLS_GRAPH_CONVERT_OPLOG_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+
+namespace katana {
+
+/// The number of changes of each kind in a batch
+struct OplogStats {
+  uint64_t inserted_nodes{0};
+  uint64_t updated_nodes{0};
+  uint64_t deleted_nodes{0};
+  uint64_t inserted_edges{0};
+  uint64_t updated_edges{0};
+  uint64_t deleted_edges{0};
+};
+
+/// An OplogApplier applies a change stream, e.g., the oplog of a database, to
+/// a property graph in batches. Each change is a JSON object:
+///
+///   {"op": "insert_node", "id": ID, "properties": {NAME: VALUE, ...}}
+///   {"op": "update_node", "id": ID, "properties": {NAME: VALUE, ...}}
+///   {"op": "delete_node", "id": ID}
+///   {"op": "insert_edge", "src": ID, "dst": ID, "properties": {...}}
+///   {"op": "update_edge", "src": ID, "dst": ID, "properties": {...}}
+///   {"op": "delete_edge", "src": ID, "dst": ID}
+///
+/// Nodes are named by the values of an id node property, which are strings
+/// or integers. Updates and deletes of an edge apply to one edge from src to
+/// dst, and deleting a node deletes its edges. A property that the graph
+/// does not have yet is added with nulls for the other rows; its type comes
+/// from its first value. New nodes and edges have the unknown entity type.
+///
+/// A batch replaces only what it changes: a batch of updates replaces the
+/// properties it updates, and a batch that inserts or deletes nodes or edges
+/// also replaces the topology and the properties of the nodes or the edges
+/// it inserts or deletes. Committing the graph after each batch then writes
+/// only those files.
+class OplogApplier {
+public:
+  /// \param id_property the node property with the ids of the nodes; it may
+  ///     be missing if graph has no nodes
+  static Result<OplogApplier> Make(
+      PropertyGraph* graph, std::string id_property);
+
+  /// Apply a batch of changes in order. If a change is not valid, e.g., it
+  /// updates a node that does not exist, graph is not modified.
+  Result<OplogStats> Apply(const std::vector<std::string>& changes);
+
+private:
+  OplogApplier(PropertyGraph* graph, std::string id_property)
+      : graph_(graph), id_property_(std::move(id_property)) {}
+
+  /// Rebuild ids_ from the id property
+  Result<void> IndexIds();
+
+  PropertyGraph* graph_;
+  std::string id_property_;
+  std::unordered_map<std::string, GraphTopology::Node> ids_;
+};
+
+}  // namespace katana
+
+#endif
@@ -1,8 +1,18 @@
 #include "Transforms.h"
 
+#include <algorithm>
+#include <functional>
+
+#include <arrow/compute/api.h>
 #include <arrow/type.h>
 
 #include "TimeParser.h"
+#include "katana/ErrorCode.h"
+#include "katana/Iterators.h"
+#include "katana/Loops.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
 
 namespace {
 
@@ -161,3 +171,390 @@ katana::ApplyTransforms(
     ApplyTransform(graph->EdgeMutablePropertyView(), t.get());
   }
 }
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+using EntityTypeIDArray = katana::PropertyGraph::EntityTypeIDArray;
+
+/// Build a topology with num_nodes nodes from the edges of topo.
+/// new_edges(src, e, add) calls add(new_src, new_dst) for each new edge that
+/// the edge e of src gives, adding at most one edge to each node. The id of
+/// the edge that each new edge comes from is put in edge_ids.
+///
+/// New edges are counted, placed at the next free position of their sources
+/// and then sorted by edge_ids, which is the order a serial loop adds them.
+template <typename F>
+katana::GraphTopology
+BuildTopology(
+    const katana::GraphTopology& topo, uint64_t num_nodes, const F& new_edges,
+    katana::NUMAArray<uint64_t>* edge_ids) {
+  katana::NUMAArray<Edge> out_indices;
+  out_indices.allocateInterleaved(num_nodes);
+  katana::ParallelSTL::fill(out_indices.begin(), out_indices.end(), Edge{0});
+
+  katana::do_all(
+      katana::iterate(topo.all_nodes()),
+      [&](Node src) {
+        for (Edge e : topo.edges(src)) {
+          new_edges(src, e, [&](Node new_src, Node) {
+            __sync_fetch_and_add(&out_indices[new_src], 1);
+          });
+        }
+      },
+      katana::steal(), katana::no_stats(),
+      katana::loopname("TopologyTransformDegrees"));
+
+  katana::ParallelSTL::partial_sum(
+      out_indices.begin(), out_indices.end(), out_indices.begin());
+  uint64_t num_edges = num_nodes == 0 ? 0 : out_indices[num_nodes - 1];
+  auto begin = [&](Node n) { return n == 0 ? Edge{0} : out_indices[n - 1]; };
+
+  katana::NUMAArray<Edge> next;
+  next.allocateInterleaved(num_nodes);
+  katana::ParallelSTL::fill(next.begin(), next.end(), Edge{0});
+  katana::NUMAArray<Node> out_dests;
+  out_dests.allocateInterleaved(num_edges);
+  edge_ids->allocateInterleaved(num_edges);
+
+  katana::do_all(
+      katana::iterate(topo.all_nodes()),
+      [&](Node src) {
+        for (Edge e : topo.edges(src)) {
+          new_edges(src, e, [&](Node new_src, Node new_dst) {
+            Edge idx = begin(new_src) + __sync_fetch_and_add(&next[new_src], 1);
+            out_dests[idx] = new_dst;
+            (*edge_ids)[idx] = e;
+          });
+        }
+      },
+      katana::steal(), katana::no_stats(),
+      katana::loopname("TopologyTransformPlace"));
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](Node n) {
+        auto ids_begin = edge_ids->begin() + begin(n);
+        auto ids_end = edge_ids->begin() + out_indices[n];
+        if (std::is_sorted(ids_begin, ids_end)) {
+          return;
+        }
+        std::sort(
+            katana::make_zip_iterator(ids_begin, out_dests.begin() + begin(n)),
+            katana::make_zip_iterator(
+                ids_end, out_dests.begin() + out_indices[n]),
+            [](const auto& a, const auto& b) {
+              return std::get<0>(a) < std::get<0>(b);
+            });
+      },
+      katana::steal(), katana::no_stats(),
+      katana::loopname("TopologyTransformSort"));
+
+  return katana::GraphTopology(std::move(out_indices), std::move(out_dests));
+}
+
+/// Gather the rows ids of the columns of a property table, one column per
+/// task; with no ids, the columns are kept as they are
+katana::Result<std::shared_ptr<arrow::Table>>
+TakeProperties(
+    const std::shared_ptr<arrow::Schema>& schema,
+    const std::function<std::shared_ptr<arrow::ChunkedArray>(int)>& column,
+    const katana::NUMAArray<uint64_t>* ids) {
+  int num_columns = schema->num_fields();
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns(num_columns);
+  if (ids == nullptr) {
+    for (int i = 0; i < num_columns; ++i) {
+      columns[i] = column(i);
+    }
+    return arrow::Table::Make(schema, columns);
+  }
+
+  std::shared_ptr<arrow::Array> indices = std::make_shared<arrow::UInt64Array>(
+      ids->size(), arrow::Buffer::Wrap(ids->data(), ids->size()));
+  std::vector<arrow::Status> statuses(num_columns);
+  katana::do_all(
+      katana::iterate(0, num_columns),
+      [&](int i) {
+        auto res = arrow::compute::Take(column(i), indices);
+        if (!res.ok()) {
+          statuses[i] = res.status();
+          return;
+        }
+        columns[i] = res.ValueOrDie().chunked_array();
+      },
+      katana::steal(), katana::no_stats(),
+      katana::loopname("TopologyTransformTake"));
+  for (int i = 0; i < num_columns; ++i) {
+    if (!statuses[i].ok()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::ArrowError, "taking rows of {}: {}",
+          schema->field(i)->name(), statuses[i].ToString());
+    }
+  }
+  return arrow::Table::Make(schema, columns);
+}
+
+/// The entity types of ids, or a copy of types with no ids
+EntityTypeIDArray
+TakeTypes(
+    const katana::EntityTypeID* types, uint64_t size,
+    const katana::NUMAArray<uint64_t>* ids) {
+  EntityTypeIDArray new_types;
+  uint64_t new_size = ids ? ids->size() : size;
+  new_types.allocateInterleaved(new_size);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, new_size),
+      [&](uint64_t i) { new_types[i] = types[ids ? (*ids)[i] : i]; },
+      katana::no_stats());
+  return new_types;
+}
+
+/// Make the graph with topology topo whose node i is node node_ids[i] of
+/// graph, or node i with no node_ids, and whose edge i is edge edge_ids[i]
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+MakeDerivedGraph(
+    const katana::PropertyGraph& graph, katana::GraphTopology&& topo,
+    const katana::NUMAArray<uint64_t>* node_ids,
+    const katana::NUMAArray<uint64_t>& edge_ids) {
+  EntityTypeIDArray node_types =
+      TakeTypes(graph.node_type_data(), graph.num_nodes(), node_ids);
+  EntityTypeIDArray edge_types =
+      TakeTypes(graph.edge_type_data(), graph.num_edges(), &edge_ids);
+  auto node_type_manager = graph.GetNodeTypeManager();
+  auto edge_type_manager = graph.GetEdgeTypeManager();
+  auto derived = KATANA_CHECKED(katana::PropertyGraph::Make(
+      std::move(topo), std::move(node_types), std::move(edge_types),
+      std::move(node_type_manager), std::move(edge_type_manager)));
+
+  auto node_schema = graph.loaded_node_schema();
+  if (node_schema->num_fields() > 0) {
+    KATANA_CHECKED(derived->AddNodeProperties(KATANA_CHECKED(TakeProperties(
+        node_schema, [&](int i) { return graph.GetNodeProperty(i); },
+        node_ids))));
+  }
+  auto edge_schema = graph.loaded_edge_schema();
+  if (edge_schema->num_fields() > 0) {
+    KATANA_CHECKED(derived->AddEdgeProperties(KATANA_CHECKED(TakeProperties(
+        edge_schema, [&](int i) { return graph.GetEdgeProperty(i); },
+        &edge_ids))));
+  }
+  return derived;
+}
+
+/// Relabel node node_ids[i] of graph as node i, keeping only the edges of
+/// those nodes; rank is the new id of each kept node
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+RelabelNodes(
+    const katana::PropertyGraph& graph,
+    const katana::NUMAArray<uint64_t>& node_ids,
+    const katana::NUMAArray<Node>& rank, const std::vector<bool>& kept) {
+  const katana::GraphTopology& topo = graph.topology();
+  katana::NUMAArray<uint64_t> edge_ids;
+  katana::GraphTopology new_topo = BuildTopology(
+      topo, node_ids.size(),
+      [&](Node src, Edge e, const auto& add) {
+        if (kept.empty() || kept[src]) {
+          add(rank[src], rank[topo.edge_dest(e)]);
+        }
+      },
+      &edge_ids);
+  return MakeDerivedGraph(graph, std::move(new_topo), &node_ids, edge_ids);
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+SortNodesByDegree(const katana::PropertyGraph& graph) {
+  const katana::GraphTopology& topo = graph.topology();
+  uint64_t num_nodes = topo.num_nodes();
+
+  using DegreeNode = std::pair<uint64_t, Node>;
+  katana::NUMAArray<DegreeNode> order;
+  order.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(topo.all_nodes()),
+      [&](Node n) { order[n] = DegreeNode(topo.edges(n).size(), n); },
+      katana::no_stats());
+  katana::ParallelSTL::sort(
+      order.begin(), order.end(), [](const auto& a, const auto& b) {
+        return a.first > b.first || (a.first == b.first && a.second < b.second);
+      });
+
+  katana::NUMAArray<uint64_t> node_ids;
+  node_ids.allocateInterleaved(num_nodes);
+  katana::NUMAArray<Node> rank;
+  rank.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t i) {
+        node_ids[i] = order[i].second;
+        rank[order[i].second] = i;
+      },
+      katana::no_stats());
+
+  return RelabelNodes(graph, node_ids, rank, {});
+}
+
+/// The root of the union-find tree of n, halving the path to it
+Node
+FindRoot(katana::NUMAArray<Node>* parent, Node n) {
+  while (true) {
+    Node p = (*parent)[n];
+    if (p == n) {
+      return n;
+    }
+    Node gp = (*parent)[p];
+    if (gp != p) {
+      __sync_bool_compare_and_swap(&(*parent)[n], p, gp);
+    }
+    n = gp;
+  }
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+LargestComponent(const katana::PropertyGraph& graph) {
+  const katana::GraphTopology& topo = graph.topology();
+  uint64_t num_nodes = topo.num_nodes();
+  if (num_nodes == 0) {
+    return MakeDerivedGraph(
+        graph, katana::GraphTopology(), nullptr, katana::NUMAArray<uint64_t>());
+  }
+
+  // Union-find of weakly connected components, hooking the larger root
+  // under the smaller so that each root is the smallest node of its component
+  katana::NUMAArray<Node> parent;
+  parent.allocateInterleaved(num_nodes);
+  katana::ParallelSTL::iota(parent.begin(), parent.end(), Node{0});
+  katana::do_all(
+      katana::iterate(topo.all_nodes()),
+      [&](Node src) {
+        for (Edge e : topo.edges(src)) {
+          Node a = src;
+          Node b = topo.edge_dest(e);
+          while (true) {
+            a = FindRoot(&parent, a);
+            b = FindRoot(&parent, b);
+            if (a == b) {
+              break;
+            }
+            if (a < b) {
+              std::swap(a, b);
+            }
+            if (__sync_bool_compare_and_swap(&parent[a], a, b)) {
+              break;
+            }
+          }
+        }
+      },
+      katana::steal(), katana::no_stats(),
+      katana::loopname("TopologyTransformComponents"));
+
+  katana::NUMAArray<uint64_t> sizes;
+  sizes.allocateInterleaved(num_nodes);
+  katana::ParallelSTL::fill(sizes.begin(), sizes.end(), uint64_t{0});
+  katana::do_all(
+      katana::iterate(topo.all_nodes()),
+      [&](Node n) {
+        parent[n] = FindRoot(&parent, n);
+        __sync_fetch_and_add(&sizes[parent[n]], 1);
+      },
+      katana::no_stats());
+  Node largest = std::max_element(sizes.begin(), sizes.end()) - sizes.begin();
+
+  // rank[n] is the number of kept nodes up to and including n
+  katana::NUMAArray<Node> rank;
+  rank.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(topo.all_nodes()),
+      [&](Node n) { rank[n] = parent[n] == largest; }, katana::no_stats());
+  katana::ParallelSTL::partial_sum(rank.begin(), rank.end(), rank.begin());
+
+  std::vector<bool> kept(num_nodes);
+  for (Node n = 0; n < num_nodes; ++n) {
+    kept[n] = parent[n] == largest;
+  }
+  katana::NUMAArray<uint64_t> node_ids;
+  node_ids.allocateInterleaved(sizes[largest]);
+  katana::do_all(
+      katana::iterate(topo.all_nodes()),
+      [&](Node n) {
+        if (kept[n]) {
+          rank[n] -= 1;
+          node_ids[rank[n]] = n;
+        }
+      },
+      katana::no_stats());
+
+  return RelabelNodes(graph, node_ids, rank, kept);
+}
+
+}  // namespace
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::ApplyTopologyTransform(
+    const katana::PropertyGraph& graph, TopologyTransform transform) {
+  const katana::GraphTopology& topo = graph.topology();
+  katana::NUMAArray<uint64_t> edge_ids;
+
+  switch (transform) {
+  case TopologyTransform::kSymmetrize: {
+    auto new_topo = BuildTopology(
+        topo, topo.num_nodes(),
+        [&](Node src, Edge e, const auto& add) {
+          Node dst = topo.edge_dest(e);
+          add(src, dst);
+          if (src != dst) {
+            add(dst, src);
+          }
+        },
+        &edge_ids);
+    return MakeDerivedGraph(graph, std::move(new_topo), nullptr, edge_ids);
+  }
+  case TopologyTransform::kTranspose: {
+    auto new_topo = BuildTopology(
+        topo, topo.num_nodes(),
+        [&](Node src, Edge e, const auto& add) { add(topo.edge_dest(e), src); },
+        &edge_ids);
+    return MakeDerivedGraph(graph, std::move(new_topo), nullptr, edge_ids);
+  }
+  case TopologyTransform::kRemoveSelfLoopsAndDuplicates: {
+    // Mark the first edge of each node to each other node
+    katana::NUMAArray<uint8_t> keep_edge;
+    keep_edge.allocateInterleaved(topo.num_edges());
+    katana::PerThreadStorage<std::vector<std::pair<Node, Edge>>> buffers;
+    katana::do_all(
+        katana::iterate(topo.all_nodes()),
+        [&](Node src) {
+          auto& buffer = *buffers.getLocal();
+          buffer.clear();
+          for (Edge e : topo.edges(src)) {
+            keep_edge[e] = 0;
+            buffer.emplace_back(topo.edge_dest(e), e);
+          }
+          std::sort(buffer.begin(), buffer.end());
+          for (size_t i = 0; i < buffer.size(); ++i) {
+            if (buffer[i].first != src &&
+                (i == 0 || buffer[i].first != buffer[i - 1].first)) {
+              keep_edge[buffer[i].second] = 1;
+            }
+          }
+        },
+        katana::steal(), katana::no_stats(),
+        katana::loopname("TopologyTransformDuplicates"));
+    auto new_topo = BuildTopology(
+        topo, topo.num_nodes(),
+        [&](Node src, Edge e, const auto& add) {
+          if (keep_edge[e]) {
+            add(src, topo.edge_dest(e));
+          }
+        },
+        &edge_ids);
+    return MakeDerivedGraph(graph, std::move(new_topo), nullptr, edge_ids);
+  }
+  case TopologyTransform::kSortNodesByDegree:
+    return SortNodesByDegree(graph);
+  case TopologyTransform::kLargestComponent:
+    return LargestComponent(graph);
+  }
+  return KATANA_ERROR(
+      katana::ErrorCode::InvalidArgument, "unknown topology transform");
+}
@@ -84,6 +84,32 @@ void ApplyTransforms(
     katana::PropertyGraph* graph,
     const std::vector<std::unique_ptr<ColumnTransformer>>& transformers);
 
+/// A TopologyTransform changes the nodes or edges of a graph. Every new node
+/// and edge comes from a node or edge of the original graph and has its
+/// properties and entity type.
+enum class TopologyTransform {
+  /// Add the reverse of every edge that is not a self loop
+  kSymmetrize,
+  /// Reverse every edge
+  kTranspose,
+  /// Remove self loops and all but the first of the edges of a node to the
+  /// same destination
+  kRemoveSelfLoopsAndDuplicates,
+  /// Relabel nodes in descending order of out degree, and in order of their
+  /// ids for equal degrees
+  kSortNodesByDegree,
+  /// Keep the largest weakly connected component; ties go to the component
+  /// with the smallest node id
+  kLargestComponent,
+};
+
+/// Make the graph that transform gives for graph. The topology and the
+/// properties are built in parallel. The new edges of each node are in the
+/// order that a serial loop over the edges of each node of graph would add
+/// them, so the result does not depend on the number of threads.
+katana::Result<std::unique_ptr<katana::PropertyGraph>> ApplyTopologyTransform(
+    const katana::PropertyGraph& graph, TopologyTransform transform);
+
 }  // namespace katana
 
 #endif
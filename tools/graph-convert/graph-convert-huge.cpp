@@ -18,6 +18,7 @@
  */
 
 #include <fcntl.h>
+#include <unistd.h>
 
 #include <algorithm>
 #include <chrono>
@@ -28,10 +29,15 @@
 #include <ios>
 #include <iostream>
 #include <limits>
+#include <queue>
 #include <random>
 #include <regex>
+#include <string>
+#include <tuple>
 #include <vector>
 
+#include <arrow/api.h>
+#include <arrow/io/file.h>
 #include <boost/iostreams/filter/gzip.hpp>
 #include <boost/iostreams/filtering_streambuf.hpp>
 #include <boost/mpl/if.hpp>
@@ -39,7 +45,16 @@
 #include "katana/FileGraph.h"
 #include "katana/NUMAArray.h"
 #include "katana/OfflineGraph.h"
+#include "katana/ParallelSTL.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Strings.h"
+#include "katana/ThreadPool.h"
+#include "katana/Threads.h"
 #include "llvm/Support/CommandLine.h"
+#include "tsuba/CSRTopology.h"
+#include "tsuba/RDG.h"
+#include "tsuba/file.h"
+#include "tsuba/tsuba.h"
 
 namespace cll = llvm::cl;
 
@@ -54,6 +69,24 @@ static cll::opt<bool> edgesSorted(
     cll::init(false));
 static cll::opt<unsigned long long> numNodes(
     "numNodes", cll::desc("Total number of nodes given."), cll::init(0));
+static cll::opt<bool> externalSort(
+    "externalSort",
+    cll::desc("Sort the edges in runs that fit in memoryMB, spilled to "
+              "tempDir, so that the edge list need not fit in memory"),
+    cll::init(false));
+static cll::opt<unsigned long long> memoryMB(
+    "memoryMB", cll::desc("Memory budget of externalSort in MB"),
+    cll::init(1024));
+static cll::opt<std::string> tempDir(
+    "tempDir", cll::desc("Local directory for the runs of externalSort"),
+    cll::init("/tmp"));
+static cll::opt<bool> rdgOutput(
+    "rdg",
+    cll::desc("With externalSort, write an RDG, with any edge data as the "
+              "edge property \"value\", instead of a .gr"),
+    cll::init(false));
+
+static std::string commandLine;
 
 union dataTy {
   int64_t ival;
@@ -62,6 +95,10 @@ union dataTy {
   int32_t i32val;
 };
 
+//! Whether perEdge saw edges with integer and float data
+static bool sawIntData = false;
+static bool sawFloatData = false;
+
 void
 perEdge(
     std::istream& is, std::function<void(uint64_t, uint64_t, dataTy)> fn,
@@ -119,12 +156,14 @@ perEdge(
         data.fval = std::stof(matches[3].str());
       else
         data.dval = std::stod(matches[3].str());
+      sawFloatData = true;
       match = true;
     } else if (std::regex_match(line, matches, intData)) {
       if (useSmallData)
         data.i32val = std::stoul(matches[3].str());
       else
         data.ival = std::stoll(matches[3].str());
+      sawIntData = true;
       match = true;
     } else if (std::regex_match(
                    line, matches,
@@ -236,9 +275,292 @@ go_edgesSorted(std::istream& input, uint64_t numNodes) {
   }
 }
 
+//! An edge of externalSort
+struct EdgeRecord {
+  uint64_t src;
+  uint64_t dst;
+  dataTy data;
+
+  bool operator<(const EdgeRecord& other) const {
+    return std::tie(src, dst) < std::tie(other.src, other.dst);
+  }
+};
+
+std::string
+runFileName(const std::string& what) {
+  return tempDir + "/graph-convert-huge-" + std::to_string(getpid()) + "-" +
+         what;
+}
+
+//! Sort edges, write them to a new run file and clear them
+void
+spillRun(std::vector<EdgeRecord>* edges, std::vector<std::string>* runs) {
+  katana::ParallelSTL::sort(edges->begin(), edges->end());
+  std::string name = runFileName("run" + std::to_string(runs->size()));
+  std::ofstream out(name, std::ios_base::binary | std::ios_base::trunc);
+  out.write(
+      reinterpret_cast<const char*>(edges->data()),
+      edges->size() * sizeof(EdgeRecord));
+  if (!out) {
+    std::cerr << "Error: failed to write " << name << "\n";
+    abort();
+  }
+  runs->emplace_back(name);
+  edges->clear();
+}
+
+//! Reads a sorted run back in blocks of blockSize edges
+class RunReader {
+  std::ifstream in;
+  std::vector<EdgeRecord> block;
+  size_t pos = 0;
+  size_t size = 0;
+
+  void fill() {
+    in.read(
+        reinterpret_cast<char*>(block.data()),
+        block.size() * sizeof(EdgeRecord));
+    size = in.gcount() / sizeof(EdgeRecord);
+    pos = 0;
+  }
+
+public:
+  RunReader(const std::string& name, size_t blockSize)
+      : in(name, std::ios_base::binary), block(blockSize) {
+    fill();
+  }
+
+  bool done() const { return pos == size; }
+  const EdgeRecord& front() const { return block[pos]; }
+  void pop() {
+    if (++pos == size) {
+      fill();
+    }
+  }
+};
+
+//! Writes a version 1 CSR file in one pass over edges sorted by source. The
+//! out indexes, destinations and edge data are at offsets known from the
+//! header, so each is written sequentially through its own stream. Edge data
+//! is either in the CSR file, as in .gr files, or in a separate dataFile.
+class CSRWriter {
+  tsuba::CSRTopologyHeader header;
+  size_t dataSize;
+  std::fstream indexes;
+  std::fstream dests;
+  std::fstream data;
+  uint64_t node = 0;
+  uint64_t numEdges = 0;
+
+  static void open(std::fstream* f, const std::string& name, uint64_t off) {
+    f->open(
+        name, std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+    f->seekp(off);
+  }
+
+  template <typename T>
+  static void write(std::fstream* f, const T& v) {
+    f->write(reinterpret_cast<const char*>(&v), sizeof(v));
+  }
+
+public:
+  CSRWriter(
+      const std::string& file, const tsuba::CSRTopologyHeader& h,
+      size_t dataSize_, const std::string& dataFile)
+      : header(h), dataSize(dataSize_) {
+    std::ofstream(file, std::ios_base::binary | std::ios_base::trunc)
+        .write(reinterpret_cast<const char*>(&header), sizeof(header));
+    uint64_t destsOff = sizeof(header) + header.num_nodes * sizeof(uint64_t);
+    open(&indexes, file, sizeof(header));
+    open(&dests, file, destsOff);
+    if (dataFile.empty()) {
+      open(
+          &data, file,
+          destsOff + katana::AlignUp<uint64_t>(
+                         header.num_edges *
+                         tsuba::CSRTopologyDestSize(header.version)));
+    } else {
+      std::ofstream(dataFile, std::ios_base::binary | std::ios_base::trunc);
+      open(&data, dataFile, 0);
+    }
+  }
+
+  void add(const EdgeRecord& edge) {
+    // out indexes are the end offsets of the edges of each node
+    for (; node < edge.src; ++node) {
+      write(&indexes, numEdges);
+    }
+    if (header.version == tsuba::kCSRTopologyVersion) {
+      write(&dests, static_cast<uint32_t>(edge.dst));
+    } else {
+      write(&dests, uint64_t{edge.dst});
+    }
+    data.write(reinterpret_cast<const char*>(&edge.data), dataSize);
+    ++numEdges;
+  }
+
+  void finish() {
+    for (; node < header.num_nodes; ++node) {
+      write(&indexes, numEdges);
+    }
+    if (header.version == tsuba::kCSRTopologyVersion && numEdges % 2 == 1) {
+      write(&dests, uint32_t{0});
+    }
+    for (std::fstream* f : {&indexes, &dests, &data}) {
+      if (!f->flush()) {
+        std::cerr << "Error: failed to write CSR\n";
+        abort();
+      }
+    }
+  }
+};
+
+//! The type of the edge property of externalSort, or nullptr if no edge has
+//! data
+std::shared_ptr<arrow::DataType>
+edgeDataType() {
+  if (sawIntData && sawFloatData) {
+    std::cerr << "Error: edge data mixes integers and floats\n";
+    abort();
+  }
+  if (sawFloatData) {
+    return useSmallData ? arrow::float32() : arrow::float64();
+  }
+  if (sawIntData) {
+    return useSmallData ? arrow::int32() : arrow::int64();
+  }
+  return nullptr;
+}
+
+//! Make an RDG from a topology file without edge data and a file of edge
+//! data. The edge data is memory mapped rather than read so that storing it
+//! as a property does not need it to fit in memory.
+katana::Result<void>
+writeRDG(
+    const std::string& topologyFile, const tsuba::CSRTopologyHeader& header,
+    const std::string& dataFile) {
+  KATANA_CHECKED(tsuba::Create(outputFilename));
+  tsuba::RDGFile handle(
+      KATANA_CHECKED(tsuba::Open(outputFilename, tsuba::kReadWrite)));
+
+  katana::Uri topFileName = tsuba::MakeTopologyFileName(handle);
+  KATANA_CHECKED(tsuba::FileRemoteCopy(
+      topologyFile, topFileName.string(), 0,
+      tsuba::CSRTopologyFileSize(header)));
+
+  tsuba::RDG rdg;
+  rdg.set_rdg_dir(tsuba::GetRDGDir(handle));
+  KATANA_CHECKED(rdg.SetTopologyFile(topFileName));
+
+  if (auto type = edgeDataType(); type) {
+    auto mapped = KATANA_CHECKED(arrow::io::MemoryMappedFile::Open(
+        dataFile, arrow::io::FileMode::READ));
+    int64_t size = KATANA_CHECKED(mapped->GetSize());
+    auto buffer = KATANA_CHECKED(mapped->ReadAt(0, size));
+    auto values = arrow::MakeArray(arrow::ArrayData::Make(
+        type, header.num_edges, {nullptr, std::move(buffer)}));
+    KATANA_CHECKED(rdg.AddEdgeProperties(arrow::Table::Make(
+        arrow::schema({arrow::field("value", type)}), {values})));
+  }
+
+  return rdg.Store(handle, commandLine);
+}
+
+//! Convert an edge list larger than memory: edges are sorted in runs of at
+//! most memoryMB, which are spilled to tempDir and then k-way merged
+//! straight into the CSR file
+void
+go_externalSort(std::istream& input) {
+  size_t budget = (memoryMB << 20) / sizeof(EdgeRecord);
+  std::vector<EdgeRecord> edges;
+  edges.reserve(budget);
+  std::vector<std::string> runs;
+  uint64_t nodes = numNodes;
+  uint64_t numEdges = 0;
+  perEdge(
+      input,
+      [&](uint64_t src, uint64_t dst, dataTy data) {
+        edges.emplace_back(EdgeRecord{src, dst, data});
+        nodes = std::max(nodes, std::max(src, dst) + 1);
+        ++numEdges;
+        if (edges.size() == budget) {
+          spillRun(&edges, &runs);
+        }
+      },
+      [&](uint64_t n, uint64_t) { nodes = std::max(nodes, n); });
+  if (!edges.empty()) {
+    spillRun(&edges, &runs);
+  }
+  std::vector<EdgeRecord>().swap(edges);
+  std::cout << "Sorted " << numEdges << " edges in " << runs.size()
+            << " runs\n";
+
+  // Node IDs beyond uint32_t need 64-bit destinations
+  uint64_t version = nodes > uint64_t{std::numeric_limits<uint32_t>::max()} + 1
+                         ? tsuba::kCSRTopology64Version
+                         : tsuba::kCSRTopologyVersion;
+  size_t dataSize = useSmallData ? sizeof(int32_t) : sizeof(int64_t);
+  tsuba::CSRTopologyHeader header{
+      version, rdgOutput ? 0 : dataSize, nodes, numEdges};
+  std::string csrFile = rdgOutput ? runFileName("topology") : outputFilename;
+  std::string dataFile = rdgOutput ? runFileName("data") : "";
+
+  {
+    // the merge buffers share the memory budget of the runs
+    size_t blockSize =
+        std::max<size_t>(budget / std::max<size_t>(runs.size(), 1), 1024);
+    std::vector<RunReader> readers;
+    readers.reserve(runs.size());
+    for (const auto& run : runs) {
+      readers.emplace_back(run, blockSize);
+    }
+    // ties go to the earlier run so that the order is deterministic
+    auto later = [&](size_t a, size_t b) {
+      const EdgeRecord& x = readers[a].front();
+      const EdgeRecord& y = readers[b].front();
+      return std::tie(x.src, x.dst, a) > std::tie(y.src, y.dst, b);
+    };
+    std::priority_queue<size_t, std::vector<size_t>, decltype(later)> heap(
+        later);
+    for (size_t i = 0; i < readers.size(); ++i) {
+      if (!readers[i].done()) {
+        heap.push(i);
+      }
+    }
+
+    CSRWriter writer(csrFile, header, dataSize, dataFile);
+    while (!heap.empty()) {
+      size_t i = heap.top();
+      heap.pop();
+      writer.add(readers[i].front());
+      readers[i].pop();
+      if (!readers[i].done()) {
+        heap.push(i);
+      }
+    }
+    writer.finish();
+  }
+  for (const auto& run : runs) {
+    std::remove(run.c_str());
+  }
+
+  if (rdgOutput) {
+    auto res = writeRDG(csrFile, header, dataFile);
+    std::remove(csrFile.c_str());
+    std::remove(dataFile.c_str());
+    if (!res) {
+      std::cerr << "Error: failed to write RDG: " << res.error() << "\n";
+      abort();
+    }
+  }
+}
+
 int
 main(int argc, char** argv) {
+  commandLine = katana::Join(" ", argv, argv + argc);
+  katana::SharedMemSys G;
   llvm::cl::ParseCommandLineOptions(argc, argv);
+  katana::setActiveThreads(katana::GetThreadPool().getMaxThreads());
   std::cout << "Data will be " << (useSmallData ? 4 : 8) << " Bytes\n";
 
   std::ifstream infile(inputFilename, std::ios_base::in);
@@ -247,7 +569,12 @@ main(int argc, char** argv) {
     return 1;
   }
 
-  if (numNodes > 0 && edgesSorted) {
+  if (externalSort) {
+    go_externalSort(infile);
+  } else if (rdgOutput) {
+    std::cerr << "Error: -rdg requires -externalSort\n";
+    return 1;
+  } else if (numNodes > 0 && edgesSorted) {
     go_edgesSorted(infile, numNodes);
   } else {
     go(infile);
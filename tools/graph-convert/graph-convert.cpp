@@ -38,6 +38,7 @@
 #include "katana/Galois.h"
 #include "katana/NUMAArray.h"
 #include "katana/Strings.h"
+#include "katana/ThreadPool.h"
 #include "tsuba/CSRTopology.h"
 #include "tsuba/Errors.h"
 #include "tsuba/file.h"
@@ -224,6 +225,8 @@ static cll::opt<int> minValue(
     "minValue",
     cll::desc("minimum weight to add for random weight conversions"),
     cll::init(1));
+static cll::opt<unsigned> numThreads(
+    "t", cll::desc("Number of threads (default: all)"), cll::init(0));
 static cll::opt<size_t> maxDegree(
     "maxDegree", cll::desc("maximum degree to keep"), cll::init(2 * 1024));
 
@@ -1948,59 +1951,16 @@ struct Transpose : public Conversion {
   template <typename EdgeTy>
   void convert(const std::string& infilename, const std::string& outfilename) {
     typedef katana::FileGraph Graph;
-    typedef Graph::GraphNode GNode;
-    typedef katana::FileGraphWriter Writer;
-    typedef katana::NUMAArray<EdgeTy> EdgeData;
-    typedef typename EdgeData::value_type edge_value_type;
 
     Graph graph;
+    Graph outgraph;
     graph.fromFile(infilename);
+    katana::makeTranspose<EdgeTy>(graph, outgraph);
 
-    Writer p;
-    EdgeData edgeData;
-
-    p.setNumNodes(graph.size());
-    p.setNumEdges(graph.sizeEdges());
-    p.setSizeofEdgeData(EdgeData::size_of::value);
-    edgeData.create(graph.sizeEdges());
-
-    p.phase1();
-    for (Graph::iterator ii = graph.begin(), ei = graph.end(); ii != ei; ++ii) {
-      GNode src = *ii;
-
-      for (Graph::edge_iterator jj = graph.edge_begin(src),
-                                ej = graph.edge_end(src);
-           jj != ej; ++jj) {
-        GNode dst = graph.getEdgeDst(jj);
-        p.incrementDegree(dst);
-      }
-    }
-
-    p.phase2();
-    for (Graph::iterator ii = graph.begin(), ei = graph.end(); ii != ei; ++ii) {
-      GNode src = *ii;
-
-      for (Graph::edge_iterator jj = graph.edge_begin(src),
-                                ej = graph.edge_end(src);
-           jj != ej; ++jj) {
-        GNode dst = graph.getEdgeDst(jj);
-        if (EdgeData::has_value) {
-          edgeData.set(
-              p.addNeighbor(dst, src), graph.getEdgeData<edge_value_type>(jj));
-        } else {
-          p.addNeighbor(dst, src);
-        }
-      }
-    }
-
-    edge_value_type* rawEdgeData = p.finish<edge_value_type>();
-    if (EdgeData::has_value)
-      std::uninitialized_copy(
-          std::make_move_iterator(edgeData.begin()),
-          std::make_move_iterator(edgeData.end()), rawEdgeData);
-
-    p.toFile(outfilename);
-    printStatus(graph.size(), graph.sizeEdges(), p.size(), p.sizeEdges());
+    outgraph.toFile(outfilename);
+    printStatus(
+        graph.size(), graph.sizeEdges(), outgraph.size(),
+        outgraph.sizeEdges());
   }
 };
 
@@ -2038,26 +1998,28 @@ struct Cleanup : public Conversion {
       graph = orig;
     }
 
-    size_t numEdges = 0;
+    katana::GAccumulator<size_t> keptEdges;
 
-    for (Graph::iterator ii = graph.begin(), ei = graph.end(); ii != ei; ++ii) {
-      GNode src = *ii;
+    katana::do_all(
+        katana::iterate(GNode{0}, static_cast<GNode>(graph.size())),
+        [&](GNode src) {
+          graph.sortEdges<EdgeTy>(src, IDLess<GNode, EdgeTy>());
 
-      graph.sortEdges<EdgeTy>(src, IDLess<GNode, EdgeTy>());
-
-      Graph::edge_iterator prev = graph.edge_end(src);
-      for (Graph::edge_iterator jj = graph.edge_begin(src),
-                                ej = graph.edge_end(src);
-           jj != ej; ++jj) {
-        GNode dst = graph.getEdgeDst(jj);
-        if (src == dst) {
-        } else if (prev != ej && graph.getEdgeDst(prev) == dst) {
-        } else {
-          numEdges += 1;
-        }
-        prev = jj;
-      }
-    }
+          Graph::edge_iterator prev = graph.edge_end(src);
+          for (Graph::edge_iterator jj = graph.edge_begin(src),
+                                    ej = graph.edge_end(src);
+               jj != ej; ++jj) {
+            GNode dst = graph.getEdgeDst(jj);
+            if (src == dst) {
+            } else if (prev != ej && graph.getEdgeDst(prev) == dst) {
+            } else {
+              keptEdges += 1;
+            }
+            prev = jj;
+          }
+        },
+        katana::steal(), katana::no_stats(), katana::loopname("SortEdges"));
+    size_t numEdges = keptEdges.reduce();
 
     if (numEdges == graph.sizeEdges()) {
       std::cout << "Graph already simplified; copy input to output\n";
@@ -2144,12 +2106,12 @@ struct SortEdges
       graph = orig;
     }
 
-    for (typename Graph::iterator ii = graph.begin(), ei = graph.end();
-         ii != ei; ++ii) {
-      GNode src = *ii;
-
-      graph.sortEdges<EdgeTy>(src, SortBy<GNode, EdgeTy>());
-    }
+    katana::do_all(
+        katana::iterate(GNode{0}, static_cast<GNode>(graph.size())),
+        [&](GNode src) {
+          graph.sortEdges<EdgeTy>(src, SortBy<GNode, EdgeTy>());
+        },
+        katana::steal(), katana::no_stats(), katana::loopname("SortEdges"));
 
     graph.toFile(outfilename);
     printStatus(graph.size(), graph.sizeEdges());
@@ -3261,6 +3223,8 @@ main(int argc, char** argv) {
       argc, argv,
       "Converter for old graphs to gr formats for galois\n\n"
       "  For converting property graphs use graph-properties-convert\n");
+  katana::setActiveThreads(
+      numThreads ? numThreads : katana::GetThreadPool().getMaxThreads());
   std::ios_base::sync_with_stdio(false);
   switch (convertMode) {
   case bipartitegr2bigpetsc:
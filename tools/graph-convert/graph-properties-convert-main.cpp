@@ -3,11 +3,13 @@
 #include <llvm/Support/CommandLine.h>
 
 #include "Transforms.h"
+#include "katana/BulkImport.h"
 #include "katana/ErrorCode.h"
 #include "katana/Galois.h"
 #include "katana/GraphML.h"
 #include "katana/GraphMLSchema.h"
 #include "katana/Logging.h"
+#include "katana/ThreadPool.h"
 #include "katana/Timer.h"
 #include "katana/config.h"
 #include "tsuba/RDG.h"
@@ -36,7 +38,13 @@ cll::opt<katana::SourceType> type(
             "source file is of type GraphML"),
         clEnumValN(
             katana::SourceType::kKatana, "katana",
-            "source file is of type Katana")),
+            "source file is of type Katana"),
+        clEnumValN(
+            katana::SourceType::kCsv, "csv",
+            "source file is a CSV table of nodes"),
+        clEnumValN(
+            katana::SourceType::kParquet, "parquet",
+            "source file is a parquet table of nodes")),
     cll::init(katana::SourceType::kGraphml));
 cll::opt<katana::SourceDatabase> database(
     cll::desc("Database the data is from:"),
@@ -56,6 +64,17 @@ cll::opt<int> chunk_size(
               "it can be decreased to improve memory usage when "
               "converting large inputs"),
     cll::init(25000));
+cll::opt<unsigned> num_threads(
+    "t",
+    cll::desc("Number of threads for parallel parsing and database fetches "
+              "(default: all)"),
+    cll::init(0));
+cll::opt<bool> parallel_parse(
+    "parallel-parse",
+    cll::desc("Parse GraphML files on several threads\n"
+              "The keys are read first, then the graph is split at node and "
+              "edge elements"),
+    cll::init(false));
 cll::opt<std::string> mapping(
     "mapping",
     cll::desc("File in graphml format with a schema mapping for the database"),
@@ -67,6 +86,26 @@ cll::opt<bool> generate_mapping(
               "The file is created at the output destination specified"),
     cll::init(false));
 
+cll::list<std::string> edge_files(
+    "edges", cll::desc("csv or parquet tables of edges"), cll::CommaSeparated);
+cll::opt<std::string> node_id_column(
+    "node-id-column", cll::desc("Column of the node table with node ids"),
+    cll::init("id"));
+cll::opt<std::string> edge_source_column(
+    "edge-source-column",
+    cll::desc("Column of the edge tables with source node ids"),
+    cll::init("src"));
+cll::opt<std::string> edge_destination_column(
+    "edge-destination-column",
+    cll::desc("Column of the edge tables with destination node ids"),
+    cll::init("dst"));
+cll::opt<std::string> node_label_column(
+    "node-label-column", cll::desc("Column of the node table with labels"),
+    cll::init(""));
+cll::opt<std::string> edge_type_column(
+    "edge-type-column", cll::desc("Column of the edge tables with edge types"),
+    cll::init(""));
+
 cll::list<std::string> timestamp_properties(
     "timestamp", cll::desc("Timestamp properties"));
 cll::list<std::string> date32_properties(
@@ -74,6 +113,28 @@ cll::list<std::string> date32_properties(
 cll::list<std::string> date64_properties(
     "date64", cll::desc("Date64 properties"));
 
+cll::list<katana::TopologyTransform> topology_transforms(
+    "topology-transform",
+    cll::desc("Topology transforms of a Katana graph, applied in order:"),
+    cll::values(
+        clEnumValN(
+            katana::TopologyTransform::kSymmetrize, "symmetrize",
+            "add the reverse of each edge"),
+        clEnumValN(
+            katana::TopologyTransform::kTranspose, "transpose",
+            "reverse each edge"),
+        clEnumValN(
+            katana::TopologyTransform::kRemoveSelfLoopsAndDuplicates,
+            "remove-self-loops-and-duplicates",
+            "remove self loops and repeated edges"),
+        clEnumValN(
+            katana::TopologyTransform::kSortNodesByDegree,
+            "sort-nodes-by-degree", "relabel nodes by descending degree"),
+        clEnumValN(
+            katana::TopologyTransform::kLargestComponent, "largest-component",
+            "keep the largest weakly connected component")),
+    cll::CommaSeparated);
+
 cll::opt<std::string> host(
     "host",
     cll::desc("URL/IP/localhost for the target database if needed, "
@@ -131,6 +192,15 @@ ConvertKatana(const std::string& rdg_file) {
 
   ApplyTransforms(graph.get(), transformers);
 
+  for (katana::TopologyTransform transform : topology_transforms) {
+    auto transformed = katana::ApplyTopologyTransform(*graph, transform);
+    if (!transformed) {
+      KATANA_LOG_FATAL(
+          "failed to transform the topology: {}", transformed.error());
+    }
+    graph = std::move(transformed.value());
+  }
+
   return graph;
 }
 
@@ -138,8 +208,8 @@ void
 ParseWild() {
   switch (type) {
   case katana::SourceType::kGraphml: {
-    auto components_result =
-        katana::ConvertGraphML(input_filename, chunk_size, true);
+    auto components_result = katana::ConvertGraphML(
+        input_filename, chunk_size, true, parallel_parse);
     if (!components_result) {
       KATANA_LOG_FATAL("Error converting graph: {}", components_result.error());
     }
@@ -157,6 +227,26 @@ ParseWild() {
       KATANA_LOG_FATAL("Failed to convert property graph: {}", r.error());
     }
     return;
+  case katana::SourceType::kCsv:
+  case katana::SourceType::kParquet: {
+    katana::BulkImportOptions opts;
+    opts.node_id_column = node_id_column;
+    opts.edge_source_column = edge_source_column;
+    opts.edge_destination_column = edge_destination_column;
+    opts.node_label_column = node_label_column;
+    opts.edge_type_column = edge_type_column;
+    auto components_result = katana::ImportFiles(
+        {input_filename}, {edge_files.begin(), edge_files.end()}, type, opts);
+    if (!components_result) {
+      KATANA_LOG_FATAL("Error importing graph: {}", components_result.error());
+    }
+    if (auto r = katana::WritePropertyGraph(
+            std::move(components_result.value()), output_directory);
+        !r) {
+      KATANA_LOG_FATAL("Failed to convert property graph: {}", r.error());
+    }
+    return;
+  }
   default:
     KATANA_LOG_ERROR("Unsupported input type {}", type);
   }
@@ -166,8 +256,8 @@ void
 ParseNeo4j() {
   switch (type) {
   case katana::SourceType::kGraphml: {
-    auto components_result =
-        katana::ConvertGraphML(input_filename, chunk_size, true);
+    auto components_result = katana::ConvertGraphML(
+        input_filename, chunk_size, true, parallel_parse);
     if (!components_result) {
       KATANA_LOG_FATAL("Error converting graph: {}", components_result.error());
     }
@@ -232,6 +322,8 @@ main(int argc, char** argv) {
   if (chunk_size <= 0) {
     chunk_size = 25000;
   }
+  katana::setActiveThreads(
+      num_threads ? num_threads : katana::GetThreadPool().getMaxThreads());
 
   if (export_graphml) {
     katana::graphml::ExportGraph(output_directory, input_filename);
@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <deque>
 #include <fstream>
 #include <iostream>
@@ -18,12 +19,14 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/lexical_cast.hpp>
 
+#include "KeyRanges.h"
 #include "katana/ErrorCode.h"
 #include "katana/Galois.h"
 #include "katana/GraphMLSchema.h"
 #include "katana/Logging.h"
 #include "katana/PropertyGraph.h"
 #include "katana/SharedMemSys.h"
+#include "katana/ThreadPool.h"
 #include "katana/Threads.h"
 
 using katana::GraphComponents;
@@ -570,6 +573,192 @@ QueryEntireCollection(
   mongoc_collection_destroy(collection);
 }
 
+// Collections are fetched in ranges of _id of about this many documents,
+// one range per thread at a time
+constexpr int64_t kDocumentsPerRange = 100000;
+constexpr int32_t kCursorBatchSize = 10000;
+
+struct MongoClientPool {
+  mongoc_client_pool_t* pool;
+
+  MongoClientPool(mongoc_client_pool_t* pool_) : pool(pool_) {}
+  ~MongoClientPool() { mongoc_client_pool_destroy(pool); }
+};
+
+// mongoc_init() should be called before this function
+mongoc_client_pool_t*
+GetMongoClientPool(const char* uri_string) {
+  bson_error_t error;
+  mongoc_uri_t* uri = mongoc_uri_new_with_error(uri_string, &error);
+  if (!uri) {
+    KATANA_LOG_FATAL(
+        "Failed to parse URI: {}\n"
+        "Error message: {}\n",
+        uri_string, error.message);
+  }
+  mongoc_client_pool_t* pool = mongoc_client_pool_new(uri);
+  if (!pool) {
+    KATANA_LOG_FATAL("Could not create a client pool for URI: {}", uri_string);
+  }
+  mongoc_client_pool_set_appname(pool, "graph-properties-convert");
+  mongoc_uri_destroy(uri);
+
+  return pool;
+}
+
+// The _id of the first document of collection in _id order, or the last if
+// direction is -1, if it is an ObjectID
+std::optional<bson_oid_t>
+EndObjectID(mongoc_collection_t* collection, int32_t direction) {
+  bson_t filter;
+  bson_init(&filter);
+  bson_t* opts = BCON_NEW(
+      "sort", "{", "_id", BCON_INT32(direction), "}", "projection", "{", "_id",
+      BCON_INT32(1), "}", "limit", BCON_INT64(1));
+  auto cursor =
+      mongoc_collection_find_with_opts(collection, &filter, opts, nullptr);
+
+  std::optional<bson_oid_t> oid;
+  const bson_t* doc;
+  bson_iter_t iter;
+  if (mongoc_cursor_next(cursor, &doc) &&
+      bson_iter_init_find(&iter, doc, "_id") && BSON_ITER_HOLDS_OID(&iter)) {
+    oid = *bson_iter_oid(&iter);
+  }
+
+  mongoc_cursor_destroy(cursor);
+  bson_destroy(opts);
+  bson_destroy(&filter);
+  return oid;
+}
+
+// The smallest ObjectID created at the given second
+bson_oid_t
+ObjectIDAt(uint64_t seconds) {
+  bson_oid_t oid;
+  std::memset(&oid, 0, sizeof(oid));
+  uint32_t big_endian = BSON_UINT32_TO_BE(static_cast<uint32_t>(seconds));
+  std::memcpy(oid.bytes, &big_endian, sizeof(big_endian));
+  return oid;
+}
+
+// Filters splitting collection into ranges of ObjectID _ids, by creation
+// time, and a last filter for any other _ids; empty if the _ids are not
+// ObjectIDs
+std::vector<bson_t*>
+SplitCollection(mongoc_collection_t* collection) {
+  std::optional<bson_oid_t> first = EndObjectID(collection, 1);
+  std::optional<bson_oid_t> last = EndObjectID(collection, -1);
+  if (!first || !last) {
+    return {};
+  }
+
+  bson_error_t error;
+  int64_t num_documents = mongoc_collection_estimated_document_count(
+      collection, nullptr, nullptr, nullptr, &error);
+  const uint64_t first_second = bson_oid_get_time_t(&*first);
+  const uint64_t span = bson_oid_get_time_t(&*last) - first_second;
+  const uint64_t num_ranges = std::max<int64_t>(
+      katana::getActiveThreads(), num_documents / kDocumentsPerRange);
+
+  std::vector<bson_t*> filters;
+  for (const auto& [begin_offset, last_offset] :
+       katana::SplitSpan(span, num_ranges)) {
+    bson_oid_t begin = ObjectIDAt(first_second + begin_offset);
+    bson_oid_t end = ObjectIDAt(first_second + last_offset + 1);
+
+    bson_t* filter = bson_new();
+    bson_t range;
+    BSON_APPEND_DOCUMENT_BEGIN(filter, "_id", &range);
+    BSON_APPEND_OID(&range, "$gte", &begin);
+    if (last_offset == span) {
+      BSON_APPEND_OID(&range, "$lte", &*last);
+    } else {
+      BSON_APPEND_OID(&range, "$lt", &end);
+    }
+    bson_append_document_end(filter, &range);
+    filters.emplace_back(filter);
+  }
+  filters.emplace_back(BCON_NEW(
+      "_id", "{", "$not", "{", "$type", BCON_UTF8("objectId"), "}", "}"));
+  return filters;
+}
+
+// Copy the documents of a collection that match filter, on a client of pool
+std::vector<bson_t*>
+FetchDocuments(
+    mongoc_client_pool_t* pool, const std::string& db_name,
+    const std::string& coll_name, const bson_t* filter) {
+  mongoc_client_t* client = mongoc_client_pool_pop(pool);
+  auto collection = mongoc_client_get_collection(
+      client, db_name.c_str(), coll_name.c_str());
+  bson_t* opts = BCON_NEW(
+      "batchSize", BCON_INT32(kCursorBatchSize), "sort", "{", "_id",
+      BCON_INT32(1), "}");
+  auto cursor =
+      mongoc_collection_find_with_opts(collection, filter, opts, nullptr);
+
+  std::vector<bson_t*> documents;
+  const bson_t* doc;
+  while (mongoc_cursor_next(cursor, &doc)) {
+    documents.emplace_back(bson_copy(doc));
+  }
+  bson_error_t error;
+  if (mongoc_cursor_error(cursor, &error)) {
+    KATANA_LOG_ERROR(
+        "An error occurred with a mongodb cursor: {}", error.message);
+  }
+
+  mongoc_cursor_destroy(cursor);
+  bson_destroy(opts);
+  mongoc_collection_destroy(collection);
+  mongoc_client_pool_push(pool, client);
+  return documents;
+}
+
+// Fetch ranges of a collection on several clients at once and pass their
+// documents to document_op in _id order, or query the whole collection if it
+// cannot be split
+template <typename T>
+void
+QueryCollectionInRanges(
+    mongoc_client_pool_t* pool, mongoc_database_t* database,
+    const std::string& coll_name, T document_op) {
+  auto collection = mongoc_database_get_collection(database, coll_name.c_str());
+  std::vector<bson_t*> filters = SplitCollection(collection);
+  mongoc_collection_destroy(collection);
+
+  if (filters.empty()) {
+    const bson_t* document = nullptr;
+    QueryEntireCollection(
+        database, &document, coll_name, [&]() { document_op(document); });
+    return;
+  }
+
+  const std::string db_name = mongoc_database_get_name(database);
+  const size_t num_threads = katana::getActiveThreads();
+  for (size_t begin = 0; begin < filters.size(); begin += num_threads) {
+    size_t end = std::min(filters.size(), begin + num_threads);
+    std::vector<std::vector<bson_t*>> fetched(end - begin);
+    katana::do_all(
+        katana::iterate(begin, end),
+        [&](size_t i) {
+          fetched[i - begin] =
+              FetchDocuments(pool, db_name, coll_name, filters[i]);
+        },
+        katana::no_stats());
+    for (const auto& documents : fetched) {
+      for (bson_t* document : documents) {
+        document_op(document);
+        bson_destroy(document);
+      }
+    }
+  }
+  for (bson_t* filter : filters) {
+    bson_destroy(filter);
+  }
+}
+
 /***************************************/
 /* Functions for MongoDB preprocessing */
 /***************************************/
@@ -1114,13 +1303,12 @@ katana::GraphComponents
 katana::ConvertMongoDB(
     const std::string& db_name, const std::string& mapping, size_t chunk_size) {
   const char* uri_string = "mongodb://localhost:27017";
-  const bson_t* document = nullptr;
 
   katana::PropertyGraphBuilder builder{chunk_size};
-  katana::setActiveThreads(1000);
 
   mongoc_init();
   MongoClient client_wrapper{GetMongoClient(uri_string)};
+  MongoClientPool pool_wrapper{GetMongoClientPool(uri_string)};
   mongoc_database_t* database =
       mongoc_client_get_database(client_wrapper.client, db_name.c_str());
   std::vector<std::string> coll_names = GetCollectionNames(database);
@@ -1142,15 +1330,17 @@ katana::ConvertMongoDB(
 
   // add all edges first
   for (auto coll_name : edges) {
-    QueryEntireCollection(database, &document, coll_name, [&]() {
-      katana::HandleEdgeDocumentMongoDB(&builder, document, coll_name);
-    });
+    QueryCollectionInRanges(
+        pool_wrapper.pool, database, coll_name, [&](const bson_t* document) {
+          katana::HandleEdgeDocumentMongoDB(&builder, document, coll_name);
+        });
   }
   // then add all nodes
   for (auto coll_name : nodes) {
-    QueryEntireCollection(database, &document, coll_name, [&]() {
-      katana::HandleNodeDocumentMongoDB(&builder, document, coll_name);
-    });
+    QueryCollectionInRanges(
+        pool_wrapper.pool, database, coll_name, [&](const bson_t* document) {
+          katana::HandleNodeDocumentMongoDB(&builder, document, coll_name);
+        });
   }
 
   mongoc_cleanup();
@@ -21,12 +21,14 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/lexical_cast.hpp>
 
+#include "KeyRanges.h"
 #include "katana/ErrorCode.h"
 #include "katana/Galois.h"
 #include "katana/GraphMLSchema.h"
 #include "katana/Logging.h"
 #include "katana/PropertyGraph.h"
 #include "katana/SharedMemSys.h"
+#include "katana/ThreadPool.h"
 #include "katana/Threads.h"
 
 using katana::GraphComponents;
@@ -67,6 +69,8 @@ struct TableData {
   std::string name;
   bool is_node;
   int64_t primary_key_index;
+  std::string primary_key_name;
+  bool integer_primary_key;
   std::vector<Relationship> out_references;
   std::vector<Relationship> in_references;
   std::vector<std::string> field_names;
@@ -77,6 +81,7 @@ struct TableData {
       : name(std::move(name_)),
         is_node(true),
         primary_key_index(-1),
+        integer_primary_key(false),
         out_references(std::vector<Relationship>{}),
         in_references(std::vector<Relationship>{}),
         field_names(std::vector<std::string>{}),
@@ -220,6 +225,37 @@ GenerateFetchTableQuery(const std::string& table) {
   return std::string{"SELECT * FROM " + table + ";"};
 }
 
+std::string
+GenerateFetchKeyBoundsQuery(const std::string& table, const std::string& key) {
+  return std::string{
+      "SELECT MIN(" + key + "), MAX(" + key + "), COUNT(*) FROM " + table +
+      ";"};
+}
+
+std::string
+GenerateFetchKeyRangeQuery(
+    const std::string& table, const std::string& key, int64_t first,
+    int64_t last) {
+  return std::string{
+      "SELECT * FROM " + table + " WHERE " + key +
+      " BETWEEN " + std::to_string(first) + " AND " + std::to_string(last) +
+      " ORDER BY " + key + ";"};
+}
+
+bool
+IsIntegerField(enum_field_types type) {
+  switch (type) {
+  case MYSQL_TYPE_TINY:
+  case MYSQL_TYPE_SHORT:
+  case MYSQL_TYPE_INT24:
+  case MYSQL_TYPE_LONG:
+  case MYSQL_TYPE_LONGLONG:
+    return true;
+  default:
+    return false;
+  }
+}
+
 std::vector<std::string>
 FetchTableNames(MYSQL* con) {
   std::vector<std::string> table_names;
@@ -256,105 +292,184 @@ RunQuery(MYSQL* con, const std::string& query) {
   return MysqlRes(mysql_use_result(con));
 }
 
-void
-AddNodeTable(
-    katana::PropertyGraphBuilder* builder, MYSQL* con,
-    const TableData& table_data) {
-  MysqlRes table = RunQuery(con, GenerateFetchTableQuery(table_data.name));
+// A row of a result set
+struct MysqlRow {
   MYSQL_ROW row;
+  unsigned long* lengths;
 
-  while ((row = mysql_fetch_row(table.res))) {
-    auto lengths = mysql_fetch_lengths(table.res);
-
-    builder->StartNode();
-    builder->AddLabel(table_data.name);
-
-    // if table has a primary key, add it as node's ID
-    auto primary_index = table_data.primary_key_index;
-    if (primary_index >= 0) {
-      std::string primary_key{row[primary_index], lengths[primary_index]};
-      builder->AddNodeID(table_data.name + primary_key);
-    }
-
-    // add data fields
-    for (size_t i = 0; i < table_data.field_names.size(); i++) {
-      auto index = table_data.field_indexes[i];
-      // if the data is null then do not add it
-      if (row[index] != NULL) {
-        std::string value{row[index], lengths[index]};
-
-        builder->AddValue(
-            table_data.field_names[i],
-            []() {
-              return PropertyKey{
-                  "invalid", ImportDataType::kUnsupported, false};
-            },
-            [&value](ImportDataType type, bool is_list) {
-              return ResolveValue(value, type, is_list);
-            });
+  bool IsNull(size_t i) const { return row[i] == NULL; }
+  std::string Get(size_t i) const { return std::string{row[i], lengths[i]}; }
+};
+
+// Rows copied out of a result set, so that several parts of a table can be
+// fetched at once
+class RowBatch {
+public:
+  explicit RowBatch(size_t num_fields) : num_fields_(num_fields) {}
+
+  void Append(const MysqlRow& row) {
+    for (size_t i = 0; i < num_fields_; i++) {
+      if (row.IsNull(i)) {
+        begins_.emplace_back(kNull);
+        lengths_.emplace_back(0);
+      } else {
+        begins_.emplace_back(data_.size());
+        lengths_.emplace_back(row.lengths[i]);
+        data_.append(row.row[i], row.lengths[i]);
       }
     }
+  }
 
-    // if table has outgoing edges, add them
-    for (auto relation : table_data.out_references) {
-      auto foreign_index = relation.source_index;
-      // if the target is null then do not add an edge
-      if (row[foreign_index] != NULL) {
-        std::string foreign_key{row[foreign_index], lengths[foreign_index]};
-        std::string edge_id = relation.target_table + foreign_key;
-        builder->AddOutgoingEdge(edge_id, relation.label);
-      }
+  size_t num_rows() const {
+    return num_fields_ == 0 ? 0 : begins_.size() / num_fields_;
+  }
+
+  // Field i of row r of a batch
+  struct Row {
+    const RowBatch* batch;
+    size_t r;
+
+    bool IsNull(size_t i) const {
+      return batch->begins_[r * batch->num_fields_ + i] == kNull;
+    }
+    std::string Get(size_t i) const {
+      size_t f = r * batch->num_fields_ + i;
+      return batch->data_.substr(batch->begins_[f], batch->lengths_[f]);
     }
-    builder->FinishNode();
+  };
+
+  Row row(size_t r) const { return Row{this, r}; }
+
+private:
+  static constexpr uint64_t kNull = std::numeric_limits<uint64_t>::max();
+
+  size_t num_fields_;
+  std::string data_;
+  std::vector<uint64_t> begins_;
+  std::vector<uint64_t> lengths_;
+};
+
+template <typename Row>
+void
+AddNodeRow(
+    katana::PropertyGraphBuilder* builder, const TableData& table_data,
+    const Row& row) {
+  builder->StartNode();
+  builder->AddLabel(table_data.name);
+
+  // if table has a primary key, add it as node's ID
+  auto primary_index = table_data.primary_key_index;
+  if (primary_index >= 0) {
+    std::string primary_key = row.Get(primary_index);
+    builder->AddNodeID(table_data.name + primary_key);
   }
+
+  // add data fields
+  for (size_t i = 0; i < table_data.field_names.size(); i++) {
+    auto index = table_data.field_indexes[i];
+    // if the data is null then do not add it
+    if (!row.IsNull(index)) {
+      std::string value = row.Get(index);
+
+      builder->AddValue(
+          table_data.field_names[i],
+          []() {
+            return PropertyKey{"invalid", ImportDataType::kUnsupported, false};
+          },
+          [&value](ImportDataType type, bool is_list) {
+            return ResolveValue(value, type, is_list);
+          });
+    }
+  }
+
+  // if table has outgoing edges, add them
+  for (auto relation : table_data.out_references) {
+    auto foreign_index = relation.source_index;
+    // if the target is null then do not add an edge
+    if (!row.IsNull(foreign_index)) {
+      std::string foreign_key = row.Get(foreign_index);
+      std::string edge_id = relation.target_table + foreign_key;
+      builder->AddOutgoingEdge(edge_id, relation.label);
+    }
+  }
+  builder->FinishNode();
+}
+
+template <typename Row>
+void
+AddEdgeRow(
+    katana::PropertyGraphBuilder* builder, const TableData& table_data,
+    const Row& row) {
+  builder->StartEdge();
+  builder->AddLabel(table_data.name);
+
+  bool adding_source = true;
+  // if the source or target is null then add a placeholder node
+  for (auto relation : table_data.out_references) {
+    auto foreign_index = relation.source_index;
+    std::string foreign_key =
+        row.IsNull(foreign_index) ? std::string() : row.Get(foreign_index);
+    std::string edge_id = relation.target_table + foreign_key;
+    if (adding_source) {
+      builder->AddEdgeSource(edge_id);
+      adding_source = false;
+    } else {
+      builder->AddEdgeTarget(edge_id);
+    }
+  }
+
+  // add data fields
+  for (size_t i = 0; i < table_data.field_names.size(); i++) {
+    auto index = table_data.field_indexes[i];
+    // if the data is null then do not add it
+    if (!row.IsNull(index)) {
+      std::string value = row.Get(index);
+
+      builder->AddValue(
+          table_data.field_names[i],
+          []() {
+            return PropertyKey{"invalid", ImportDataType::kUnsupported, false};
+          },
+          [&value](ImportDataType type, bool is_list) {
+            return ResolveValue(value, type, is_list);
+          });
+    }
+  }
+  builder->FinishEdge();
 }
 
 void
-AddEdgeTable(
+AddTableRow(
+    katana::PropertyGraphBuilder* builder, const TableData& table_data,
+    const MysqlRow& row) {
+  if (table_data.is_node) {
+    AddNodeRow(builder, table_data, row);
+  } else {
+    AddEdgeRow(builder, table_data, row);
+  }
+}
+
+void
+AddTableRow(
+    katana::PropertyGraphBuilder* builder, const TableData& table_data,
+    const RowBatch::Row& row) {
+  if (table_data.is_node) {
+    AddNodeRow(builder, table_data, row);
+  } else {
+    AddEdgeRow(builder, table_data, row);
+  }
+}
+
+void
+AddTable(
     katana::PropertyGraphBuilder* builder, MYSQL* con,
     const TableData& table_data) {
   MysqlRes table = RunQuery(con, GenerateFetchTableQuery(table_data.name));
   MYSQL_ROW row;
 
   while ((row = mysql_fetch_row(table.res))) {
-    auto lengths = mysql_fetch_lengths(table.res);
-
-    builder->StartEdge();
-    builder->AddLabel(table_data.name);
-
-    bool adding_source = true;
-    // if the source or target is null then add a placeholder node
-    for (auto relation : table_data.out_references) {
-      auto foreign_index = relation.source_index;
-      std::string foreign_key{row[foreign_index], lengths[foreign_index]};
-      std::string edge_id = relation.target_table + foreign_key;
-      if (adding_source) {
-        builder->AddEdgeSource(edge_id);
-        adding_source = false;
-      } else {
-        builder->AddEdgeTarget(edge_id);
-      }
-    }
-
-    // add data fields
-    for (size_t i = 0; i < table_data.field_names.size(); i++) {
-      auto index = table_data.field_indexes[i];
-      // if the data is null then do not add it
-      if (row[index] != NULL) {
-        std::string value{row[index], lengths[index]};
-
-        builder->AddValue(
-            table_data.field_names[i],
-            []() {
-              return PropertyKey{
-                  "invalid", ImportDataType::kUnsupported, false};
-            },
-            [&value](ImportDataType type, bool is_list) {
-              return ResolveValue(value, type, is_list);
-            });
-      }
-    }
-    builder->FinishEdge();
+    AddTableRow(
+        builder, table_data, MysqlRow{row, mysql_fetch_lengths(table.res)});
   }
 }
 
@@ -642,6 +757,9 @@ PreprocessFields(
     // if this field is a primary key, do not add it for now
     if (IS_PRI_KEY(field->flags)) {
       table_iter->second.primary_key_index = static_cast<int64_t>(index);
+      table_iter->second.primary_key_name =
+          std::string(field->name, field->name_length);
+      table_iter->second.integer_primary_key = IsIntegerField(field->type);
     } else if (
         table_iter->second.ignore_list.find(key.id) ==
         table_iter->second.ignore_list.end()) {
@@ -675,6 +793,9 @@ PreprocessFields(
     // if this field is a primary key, do not add it for now
     if (IS_PRI_KEY(field->flags)) {
       table_iter->second.primary_key_index = static_cast<int64_t>(index);
+      table_iter->second.primary_key_name =
+          std::string(field->name, field->name_length);
+      table_iter->second.integer_primary_key = IsIntegerField(field->type);
     } else if (
         table_iter->second.ignore_list.find(key.id) !=
         table_iter->second.ignore_list.end()) {
@@ -854,6 +975,138 @@ GetMappingInput(
   katana::graphml::FinishGraphmlFile(writer);
 }
 
+/**********************************************/
+/* Functions for fetching tables in parallel */
+/**********************************************/
+
+// Tables with an integer primary key are fetched in key ranges of about this
+// many rows, one range per connection at a time
+constexpr uint64_t kRowsPerRange = 100000;
+
+struct MysqlLogin {
+  std::string host;
+  std::string user;
+  std::string password;
+  std::string db_name;
+};
+
+MYSQL*
+Connect(const MysqlLogin& login) {
+  MYSQL* con = mysql_init(NULL);
+  if (con == nullptr) {
+    KATANA_LOG_FATAL("mysql_init() failed");
+  }
+  if (mysql_real_connect(
+          con, login.host.c_str(), login.user.c_str(), login.password.c_str(),
+          login.db_name.c_str(), 0, NULL, 0) == NULL) {
+    KATANA_LOG_FATAL(
+        "Could not establish mysql connection: {}", mysql_error(con));
+  }
+  return con;
+}
+
+// One connection for each thread, opened when the thread first needs one
+class MysqlConnections {
+public:
+  explicit MysqlConnections(MysqlLogin login)
+      : login_(std::move(login)),
+        connections_(katana::getActiveThreads(), nullptr) {}
+  MysqlConnections(const MysqlConnections&) = delete;
+  MysqlConnections& operator=(const MysqlConnections&) = delete;
+  ~MysqlConnections() {
+    for (MYSQL* con : connections_) {
+      if (con != nullptr) {
+        mysql_close(con);
+      }
+    }
+  }
+
+  MYSQL* get() {
+    MYSQL*& con = connections_[katana::ThreadPool::getTID()];
+    if (con == nullptr) {
+      con = Connect(login_);
+    }
+    return con;
+  }
+
+private:
+  MysqlLogin login_;
+  std::vector<MYSQL*> connections_;
+};
+
+RowBatch
+FetchKeyRange(
+    MYSQL* con, const TableData& table_data, int64_t first, int64_t last) {
+  MysqlRes table = RunQuery(
+      con, GenerateFetchKeyRangeQuery(
+               table_data.name, table_data.primary_key_name, first, last));
+  RowBatch batch{mysql_num_fields(table.res)};
+  MYSQL_ROW row;
+  while ((row = mysql_fetch_row(table.res))) {
+    batch.Append(MysqlRow{row, mysql_fetch_lengths(table.res)});
+  }
+  return batch;
+}
+
+// Split a table with an integer primary key into key ranges, fetch the
+// ranges on several connections at once and add their rows in key order
+//
+// \returns false, without adding any rows, if the table cannot be split
+bool
+AddTableInRanges(
+    katana::PropertyGraphBuilder* builder, MYSQL* con,
+    MysqlConnections* connections, const TableData& table_data) {
+  if (!table_data.integer_primary_key) {
+    return false;
+  }
+  MysqlRes bounds = RunQuery(
+      con, GenerateFetchKeyBoundsQuery(
+               table_data.name, table_data.primary_key_name));
+  MYSQL_ROW row = mysql_fetch_row(bounds.res);
+  if (row == NULL || row[0] == NULL) {
+    // an empty table
+    ExhaustResultSet(&bounds);
+    return row != NULL;
+  }
+  MysqlRow bounds_row{row, mysql_fetch_lengths(bounds.res)};
+  int64_t min_key = 0;
+  int64_t max_key = 0;
+  uint64_t num_rows = 0;
+  bool parsed =
+      boost::conversion::try_lexical_convert(bounds_row.Get(0), min_key) &&
+      boost::conversion::try_lexical_convert(bounds_row.Get(1), max_key) &&
+      boost::conversion::try_lexical_convert(bounds_row.Get(2), num_rows);
+  ExhaustResultSet(&bounds);
+  if (!parsed) {
+    // unsigned keys beyond the range of int64_t
+    return false;
+  }
+
+  const size_t num_threads = katana::getActiveThreads();
+  std::vector<std::pair<int64_t, int64_t>> ranges = katana::SplitKeyRange(
+      min_key, max_key,
+      std::max<uint64_t>(num_threads, num_rows / kRowsPerRange));
+
+  for (size_t begin = 0; begin < ranges.size(); begin += num_threads) {
+    size_t end = std::min(ranges.size(), begin + num_threads);
+    std::vector<RowBatch> batches(end - begin, RowBatch{0});
+    katana::do_all(
+        katana::iterate(begin, end),
+        [&](size_t i) {
+          batches[i - begin] = FetchKeyRange(
+              connections->get(), table_data, ranges[i].first,
+              ranges[i].second);
+        },
+        katana::no_stats());
+    for (const RowBatch& batch : batches) {
+      for (size_t r = 0; r < batch.num_rows(); r++) {
+        AddTableRow(builder, table_data, batch.row(r));
+      }
+    }
+  }
+  return true;
+}
+
 }  // end of unnamed namespace
 
 GraphComponents
@@ -884,11 +1137,12 @@ katana::ConvertMysql(
     table_data = PreprocessTables(con, &builder, table_names);
   }
 
-  for (auto table : table_data) {
-    if (table.second.is_node) {
-      AddNodeTable(&builder, con, table.second);
-    } else {
-      AddEdgeTable(&builder, con, table.second);
+  {
+    MysqlConnections connections{MysqlLogin{host, user, password, db_name}};
+    for (const auto& table : table_data) {
+      if (!AddTableInRanges(&builder, con, &connections, table.second)) {
+        AddTable(&builder, con, table.second);
+      }
     }
   }
   mysql_close(con);
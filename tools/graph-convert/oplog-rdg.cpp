@@ -1,99 +1,198 @@
-#include "katana/BuildGraph.h"
+/// oplog-rdg applies a change stream, e.g., the oplog of a database exported
+/// as one JSON change per line (see OplogApplier), to an RDG in batches. Each
+/// batch is committed as a new version of the RDG that only rewrites the
+/// files the batch changed, and the lineage of the version records the
+/// changes it holds so that an interrupted ingestion can resume with -skip.
 
-constexpr uint64_t kNumNodes = 100;
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
 
-class LogPlay {
-  katana::PropertyGraphBuilder pgb;
+#include "Oplog.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Strings.h"
+#include "katana/ThreadPool.h"
+#include "llvm/Support/CommandLine.h"
 
+namespace cll = llvm::cl;
+
+static cll::opt<std::string> rdgName(
+    cll::Positional, cll::desc("<RDG>"), cll::Required);
+static cll::opt<std::string> oplogFile(
+    cll::Positional, cll::desc("<oplog file, or - for stdin>"), cll::init("-"));
+static cll::opt<std::string> idProperty(
+    "idProperty", cll::desc("Node property with the ids of the nodes"),
+    cll::init("id"));
+static cll::opt<uint64_t> batchSize(
+    "batchSize", cll::desc("Changes to apply and commit at once"),
+    cll::init(10000));
+static cll::opt<uint64_t> skip(
+    "skip", cll::desc("Number of changes at the start of the oplog that are "
+                      "already in the RDG"),
+    cll::init(0));
+static cll::opt<bool> create(
+    "create", cll::desc("Create an empty RDG to apply the changes to"),
+    cll::init(false));
+static cll::opt<bool> follow(
+    "follow",
+    cll::desc("Wait for more changes at the end of the oplog rather than "
+              "exiting"),
+    cll::init(false));
+static cll::opt<uint32_t> flushMillis(
+    "flushMillis",
+    cll::desc("With -follow, commit a partial batch once no change has "
+              "arrived for this long"),
+    cll::init(1000));
+static cll::opt<int> numThreads(
+    "t", cll::desc("Number of threads (default: all)"), cll::init(0));
+
+namespace {
+
+/// Reads the changes of an oplog one line at a time. With -follow, a line
+/// that is not finished yet is kept until the rest of it is appended.
+class OplogReader {
 public:
-  LogPlay() : pgb(25000) {}
+  explicit OplogReader(std::istream* in) : in_(in) {}
 
-  bool StartNode(const std::string& id) { return pgb.StartNode(id); }
-  void FinishNode() { pgb.FinishNode(); }
-  bool StartEdge(const std::string& source, const std::string& target) {
-    return pgb.StartEdge(source, target);
-  }
-  void FinishEdge() { pgb.FinishEdge(); }
-  void AddPropValue(
-      const std::string& id,
-      std::function<katana::PropertyKey()> ProcessElement,
-      std::function<katana::ImportData(katana::ImportDataType, bool)>
-          ResolveValue) {
-    pgb.AddValue(id, ProcessElement, ResolveValue);
+  /// Read the next change into line. Returns false at the end of the oplog,
+  /// which with -follow is only the end of what has been written so far.
+  bool Next(std::string* line) {
+    for (;;) {
+      std::string chunk;
+      if (!std::getline(*in_, chunk)) {
+        partial_ += chunk;
+        in_->clear();
+        return false;
+      }
+      if (in_->eof() && follow) {
+        // No newline yet; the writer may still be appending to this line
+        partial_ += chunk;
+        in_->clear();
+        return false;
+      }
+      *line = std::move(partial_) + chunk;
+      partial_.clear();
+      if (line->find_first_not_of(" \t\r") != std::string::npos) {
+        return true;
+      }
+    }
   }
-  void CreateRDG() {
-    auto uri_res = katana::Uri::MakeRand("/tmp/oplog");
-    KATANA_LOG_ASSERT(uri_res);
-    std::string dest_dir(uri_res.value().string());
-    auto components_result = pgb.Finish();
-    if (!components_result) {
-      KATANA_LOG_FATAL(
-          "Failed to construct graph: {}", components_result.error());
+
+private:
+  std::istream* in_;
+  std::string partial_;
+};
+
+std::unique_ptr<katana::PropertyGraph>
+OpenGraph(const std::string& command_line) {
+  if (create) {
+    auto pg = katana::PropertyGraph::Make(katana::GraphTopology());
+    if (!pg) {
+      KATANA_LOG_FATAL("failed to make graph: {}", pg.error());
     }
-    if (auto r =
-            WritePropertyGraph(std::move(components_result.value()), dest_dir);
-        !r) {
-      KATANA_LOG_FATAL("Failed to write graph: {}", r.error());
+    if (auto res = pg.value()->Write(rdgName, command_line); !res) {
+      KATANA_LOG_FATAL("failed to create {}: {}", rdgName, res.error());
     }
-    fmt::print("RDG written to {}\n", dest_dir);
+    return std::move(pg.value());
   }
-};
+  auto pg = katana::PropertyGraph::Make(rdgName, tsuba::RDGLoadOptions());
+  if (!pg) {
+    KATANA_LOG_FATAL("failed to load {}: {}", rdgName, pg.error());
+  }
+  return std::move(pg.value());
+}
 
 void
-ReadLog() {
-  LogPlay lp;
-
-  std::string prop_id = "n0";
-  {
-    katana::PropertyKey node_pk(
-        prop_id, true, false,
-        /* Arrow name */ prop_id, katana::ImportDataType::kInt64, false);
-    for (uint64_t i = 0; i < kNumNodes; ++i) {
-      auto id = std::to_string(i);
-      bool start_ok = lp.StartNode(id);
-      KATANA_LOG_ASSERT(start_ok);
-      lp.AddPropValue(
-          prop_id, [&]() -> katana::PropertyKey { return node_pk; },
-          [i](katana::ImportDataType type, bool is_list) -> katana::ImportData {
-            (void)(type);
-            (void)(is_list);
-            katana::ImportData data(katana::ImportDataType::kInt64, false);
-            data.value = (int64_t)i;
-            return data;
-          });
-      lp.FinishNode();
-    }
+Ingest(std::istream* in, const std::string& command_line) {
+  std::unique_ptr<katana::PropertyGraph> pg = OpenGraph(command_line);
+  auto applier_res = katana::OplogApplier::Make(pg.get(), idProperty);
+  if (!applier_res) {
+    KATANA_LOG_FATAL("cannot apply changes: {}", applier_res.error());
   }
+  katana::OplogApplier applier = std::move(applier_res.value());
+
+  OplogReader reader(in);
+  std::string line;
+  uint64_t num_read = 0;
 
-  prop_id = "rank";
-  katana::PropertyKey edge_pk(
-      prop_id, false, true,
-      /* Arrow name */ prop_id, katana::ImportDataType::kInt64, false);
-  for (uint64_t i = 0; i < kNumNodes; ++i) {
-    for (uint64_t j = 0; j < kNumNodes; ++j) {
-      bool start_ok = lp.StartEdge(std::to_string(i), std::to_string(j));
-      KATANA_LOG_ASSERT(start_ok);
-      lp.AddPropValue(
-          prop_id, [&]() -> katana::PropertyKey { return edge_pk; },
-          [i, j](
-              katana::ImportDataType type, bool is_list) -> katana::ImportData {
-            (void)(type);
-            (void)(is_list);
-            katana::ImportData data(katana::ImportDataType::kInt64, false);
-            data.value = (int64_t)(i * j);
-            return data;
-          });
-      lp.FinishEdge();
+  std::vector<std::string> batch;
+  auto commit = [&]() {
+    uint64_t first = num_read - batch.size();
+    auto stats = applier.Apply(batch);
+    if (!stats) {
+      KATANA_LOG_FATAL(
+          "changes {} to {} not applied: {}", first, num_read - 1,
+          stats.error());
+    }
+    // The lineage records the changes in each version for -skip
+    if (auto res = pg->Commit(fmt::format(
+            "{} # changes {} to {}", command_line, first, num_read - 1));
+        !res) {
+      KATANA_LOG_FATAL("commit failed: {}", res.error());
+    }
+    const katana::OplogStats& s = stats.value();
+    katana::gInfo(
+        "committed changes ", first, " to ", num_read - 1, ": nodes +",
+        s.inserted_nodes, " ~", s.updated_nodes, " -", s.deleted_nodes,
+        ", edges +", s.inserted_edges, " ~", s.updated_edges, " -",
+        s.deleted_edges);
+    batch.clear();
+  };
+
+  auto last_change = std::chrono::steady_clock::now();
+  for (;;) {
+    if (reader.Next(&line)) {
+      if (num_read++ < skip) {
+        continue;
+      }
+      batch.emplace_back(std::move(line));
+      last_change = std::chrono::steady_clock::now();
+      if (batch.size() >= batchSize) {
+        commit();
+      }
+      continue;
     }
+    if (!follow) {
+      break;
+    }
+    if (!batch.empty() && std::chrono::steady_clock::now() - last_change >=
+                              std::chrono::milliseconds(flushMillis)) {
+      commit();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  if (!batch.empty()) {
+    commit();
   }
-  lp.CreateRDG();
 }
 
+}  // namespace
+
 int
-main() {  //int argc, char* argv[]) {
+main(int argc, char* argv[]) {
   katana::SharedMemSys sys;
+  std::string command_line = katana::Join(" ", argv, argv + argc);
+  cll::ParseCommandLineOptions(argc, argv);
+  katana::setActiveThreads(
+      numThreads > 0 ? numThreads : katana::GetThreadPool().getMaxThreads());
+  if (batchSize == 0) {
+    KATANA_LOG_FATAL("-batchSize must be positive");
+  }
 
-  ReadLog();
-
+  if (oplogFile == "-") {
+    Ingest(&std::cin, command_line);
+    return 0;
+  }
+  std::ifstream in(oplogFile);
+  if (!in) {
+    KATANA_LOG_FATAL("failed to open {}", oplogFile);
+  }
+  Ingest(&in, command_line);
   return 0;
 }
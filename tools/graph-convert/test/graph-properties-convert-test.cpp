@@ -43,6 +43,9 @@ static cll::opt<ConvertTest> test_type(
 static cll::opt<int> chunk_size(
     "chunkSize", cll::desc("Chunk size for in memory arrow representation"),
     cll::init(25000));
+static cll::opt<bool> parallel(
+    "parallel", cll::desc("Parse GraphML files in parallel"),
+    cll::init(false));
 
 namespace {
 
@@ -1272,7 +1275,9 @@ main(int argc, char** argv) {
 
   switch (fileType) {
   case katana::SourceDatabase::kNeo4j:
-    if (auto r = katana::ConvertGraphML(input_filename, chunk_size, true); !r) {
+    if (auto r = katana::ConvertGraphML(
+            input_filename, chunk_size, true, parallel);
+        !r) {
       KATANA_LOG_FATAL(": {}", r.error());
     } else {
       graph = std::move(r.value());
@@ -0,0 +1,96 @@
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "KeyRanges.h"
+#include "katana/Logging.h"
+
+namespace {
+
+/// The ranges of SplitKeyRange cover [min_key, max_key] in order, without
+/// gaps or overlaps, and there are at most num_ranges of them
+void
+CheckKeyRanges(int64_t min_key, int64_t max_key, uint64_t num_ranges) {
+  std::vector<std::pair<int64_t, int64_t>> ranges =
+      katana::SplitKeyRange(min_key, max_key, num_ranges);
+  KATANA_LOG_VASSERT(
+      !ranges.empty() && ranges.size() <= std::max<uint64_t>(num_ranges, 1),
+      "[{}, {}] in {} ranges: {} ranges", min_key, max_key, num_ranges,
+      ranges.size());
+  KATANA_LOG_ASSERT(ranges.front().first == min_key);
+  KATANA_LOG_ASSERT(ranges.back().second == max_key);
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    KATANA_LOG_VASSERT(
+        ranges[i].first <= ranges[i].second, "[{}, {}] in {} ranges: {} > {}",
+        min_key, max_key, num_ranges, ranges[i].first, ranges[i].second);
+    if (i > 0) {
+      KATANA_LOG_VASSERT(
+          ranges[i - 1].second + 1 == ranges[i].first,
+          "[{}, {}] in {} ranges: range {} does not follow the last", min_key,
+          max_key, num_ranges, i);
+    }
+  }
+}
+
+/// MySQL integer primary keys, including the ends of int64_t
+void
+TestKeyRanges() {
+  constexpr int64_t kMin = std::numeric_limits<int64_t>::min();
+  constexpr int64_t kMax = std::numeric_limits<int64_t>::max();
+  for (uint64_t num_ranges : {0, 1, 2, 3, 7, 64, 1000}) {
+    // a single key
+    CheckKeyRanges(5, 5, num_ranges);
+    CheckKeyRanges(kMin, kMin, num_ranges);
+    CheckKeyRanges(kMax, kMax, num_ranges);
+    // fewer keys than ranges
+    CheckKeyRanges(-1, 1, num_ranges);
+    CheckKeyRanges(kMax - 2, kMax, num_ranges);
+    CheckKeyRanges(kMin, kMin + 2, num_ranges);
+    CheckKeyRanges(1, 100000, num_ranges);
+    CheckKeyRanges(kMin, kMax, num_ranges);
+    CheckKeyRanges(kMin, 0, num_ranges);
+    CheckKeyRanges(-1, kMax, num_ranges);
+  }
+
+  // One key per range when there are fewer keys than ranges
+  KATANA_LOG_ASSERT(katana::SplitKeyRange(-1, 1, 8).size() == 3);
+  KATANA_LOG_ASSERT(katana::SplitKeyRange(7, 7, 8).size() == 1);
+  // Every int64_t in one range, and in equal halves
+  auto whole = katana::SplitKeyRange(kMin, kMax, 1);
+  KATANA_LOG_ASSERT(whole.size() == 1);
+  auto halves = katana::SplitKeyRange(kMin, kMax, 2);
+  KATANA_LOG_ASSERT(halves.size() == 2);
+  KATANA_LOG_ASSERT(halves[0].second == -1 && halves[1].first == 0);
+}
+
+/// MongoDB ObjectID creation times, in seconds that fit in 32 bits
+void
+TestSpans() {
+  constexpr uint64_t kMaxSecond = std::numeric_limits<uint32_t>::max();
+  for (uint64_t num_ranges : {1, 4, 1000}) {
+    for (uint64_t span : {UINT64_C(0), UINT64_C(1), UINT64_C(3), kMaxSecond}) {
+      auto ranges = katana::SplitSpan(span, num_ranges);
+      KATANA_LOG_ASSERT(ranges.size() <= std::min(num_ranges, span + 1));
+      KATANA_LOG_ASSERT(ranges.front().first == 0);
+      KATANA_LOG_ASSERT(ranges.back().second == span);
+      for (size_t i = 1; i < ranges.size(); ++i) {
+        KATANA_LOG_ASSERT(ranges[i - 1].second + 1 == ranges[i].first);
+      }
+    }
+  }
+  // Every uint64_t
+  auto whole = katana::SplitSpan(std::numeric_limits<uint64_t>::max(), 1);
+  KATANA_LOG_ASSERT(whole.size() == 1);
+  KATANA_LOG_ASSERT(whole[0].second == std::numeric_limits<uint64_t>::max());
+}
+
+}  // namespace
+
+int
+main() {
+  TestKeyRanges();
+  TestSpans();
+  return 0;
+}
@@ -0,0 +1,147 @@
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "Oplog.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+/// The (destination, weight) of the edges of each node, in order
+using Edges = std::vector<std::vector<std::pair<Node, int64_t>>>;
+
+std::shared_ptr<arrow::Table>
+MakeTable(const std::string& name, size_t size, int64_t scale) {
+  arrow::Int64Builder builder;
+  for (size_t i = 0; i < size; ++i) {
+    KATANA_LOG_ASSERT(builder.Append(i * scale).ok());
+  }
+  std::shared_ptr<arrow::Array> array;
+  KATANA_LOG_ASSERT(builder.Finish(&array).ok());
+  return arrow::Table::Make(
+      arrow::schema({arrow::field(name, arrow::int64())}), {array});
+}
+
+/// Nodes 0, 1 and 2 with ids 0, 10 and 20 are a cycle; the weight of edge e
+/// is e
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph() {
+  katana::NUMAArray<katana::GraphTopology::Edge> indices;
+  indices.allocateInterleaved(3);
+  katana::NUMAArray<Node> dests;
+  dests.allocateInterleaved(3);
+  for (Node n = 0; n < 3; ++n) {
+    indices[n] = n + 1;
+    dests[n] = (n + 1) % 3;
+  }
+  auto res = katana::PropertyGraph::Make(
+      katana::GraphTopology(std::move(indices), std::move(dests)));
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  std::unique_ptr<katana::PropertyGraph> graph = std::move(res.value());
+  KATANA_LOG_ASSERT(
+      graph->AddNodeProperties(MakeTable("id", graph->num_nodes(), 10)));
+  KATANA_LOG_ASSERT(
+      graph->AddEdgeProperties(MakeTable("weight", graph->num_edges(), 1)));
+  return graph;
+}
+
+/// The value of row i of column as a string, or "null"
+std::string
+Value(const std::shared_ptr<arrow::ChunkedArray>& column, size_t i) {
+  auto scalar = column->GetScalar(i);
+  KATANA_LOG_ASSERT(scalar.ok());
+  return scalar.ValueOrDie()->ToString();
+}
+
+/// Check the ids and names of the nodes and that the edges of node n are
+/// expected[n]
+void
+Check(
+    const katana::PropertyGraph& graph, const std::vector<std::string>& ids,
+    const std::vector<std::string>& names, const Edges& expected) {
+  const katana::GraphTopology& topo = graph.topology();
+  KATANA_LOG_VASSERT(
+      topo.num_nodes() == expected.size(), "{} nodes, expected {}",
+      topo.num_nodes(), expected.size());
+  auto id_res = graph.GetNodeProperty("id");
+  auto name_res = graph.GetNodeProperty("name");
+  auto weight_res = graph.GetEdgeProperty("weight");
+  KATANA_LOG_ASSERT(id_res && name_res && weight_res);
+  for (Node n = 0; n < expected.size(); ++n) {
+    KATANA_LOG_VASSERT(
+        Value(id_res.value(), n) == ids[n] &&
+            Value(name_res.value(), n) == names[n],
+        "node {} is ({}, {}), expected ({}, {})", n, Value(id_res.value(), n),
+        Value(name_res.value(), n), ids[n], names[n]);
+    auto edges = topo.edges(n);
+    KATANA_LOG_VASSERT(
+        edges.size() == expected[n].size(), "node {} has {} edges, expected {}",
+        n, edges.size(), expected[n].size());
+    size_t i = 0;
+    for (auto e : edges) {
+      std::string weight = Value(weight_res.value(), e);
+      KATANA_LOG_VASSERT(
+          topo.edge_dest(e) == expected[n][i].first &&
+              weight == std::to_string(expected[n][i].second),
+          "edge {} of {} is ({}, {}), expected ({}, {})", i, n,
+          topo.edge_dest(e), weight, expected[n][i].first,
+          expected[n][i].second);
+      ++i;
+    }
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  auto graph = MakeGraph();
+  auto applier_res = katana::OplogApplier::Make(graph.get(), "id");
+  KATANA_LOG_VASSERT(applier_res, "{}", applier_res.error());
+  katana::OplogApplier applier = std::move(applier_res.value());
+
+  auto stats = applier.Apply({
+      R"({"op": "update_node", "id": 10, "properties": {"name": "b"}})",
+      R"({"op": "insert_node", "id": 30, "properties": {"name": "d"}})",
+      R"({"op": "insert_edge", "src": 30, "dst": 20,
+          "properties": {"weight": 7}})",
+      R"({"op": "update_edge", "src": 0, "dst": 10,
+          "properties": {"weight": 5}})",
+      R"({"op": "delete_edge", "src": 10, "dst": 20})",
+  });
+  KATANA_LOG_VASSERT(stats, "{}", stats.error());
+  KATANA_LOG_ASSERT(
+      stats.value().inserted_nodes == 1 && stats.value().updated_nodes == 1 &&
+      stats.value().inserted_edges == 1 && stats.value().updated_edges == 1 &&
+      stats.value().deleted_edges == 1);
+  Check(
+      *graph, {"0", "10", "20", "30"}, {"null", "b", "null", "d"},
+      {{{1, 5}}, {}, {{0, 2}}, {{2, 7}}});
+
+  // Deleting a node deletes its edges and renumbers the nodes after it
+  stats = applier.Apply({
+      R"({"op": "delete_node", "id": 20})",
+      R"({"op": "insert_edge", "src": 30, "dst": 0,
+          "properties": {"weight": 9}})",
+  });
+  KATANA_LOG_VASSERT(stats, "{}", stats.error());
+  Check(*graph, {"0", "10", "30"}, {"null", "b", "d"}, {{{1, 5}}, {}, {{0, 9}}});
+
+  // A batch with an invalid change is not applied
+  KATANA_LOG_ASSERT(!applier.Apply({
+      R"({"op": "update_node", "id": 0, "properties": {"name": "a"}})",
+      R"({"op": "update_node", "id": 20, "properties": {"name": "c"}})",
+  }));
+  KATANA_LOG_ASSERT(!applier.Apply({R"({"op": "insert_node", "id": 0})"}));
+  KATANA_LOG_ASSERT(!applier.Apply({R"({"op": "delete_edge", "src": 10,
+                                        "dst": 30})"}));
+  Check(*graph, {"0", "10", "30"}, {"null", "b", "d"}, {{{1, 5}}, {}, {{0, 9}}});
+
+  return 0;
+}
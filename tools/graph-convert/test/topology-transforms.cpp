@@ -0,0 +1,137 @@
+#include <utility>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "Transforms.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+/// The (destination, weight) of the edges of each node, in order
+using Edges = std::vector<std::vector<std::pair<Node, int64_t>>>;
+
+/// Nodes 0, 1 and 2 are a component with a self loop and a duplicate edge,
+/// 3 and 4 are a smaller component and 5 has no edges. The property id of
+/// node n is n * 10 and the weight of edge e is e.
+const Edges kEdges = {
+    {{1, 0}, {1, 1}}, {{1, 2}, {2, 3}, {0, 4}}, {{0, 5}}, {{4, 6}}, {}, {}};
+
+std::shared_ptr<arrow::Table>
+MakeTable(const std::string& name, size_t size, int64_t scale) {
+  arrow::Int64Builder builder;
+  for (size_t i = 0; i < size; ++i) {
+    KATANA_LOG_ASSERT(builder.Append(i * scale).ok());
+  }
+  std::shared_ptr<arrow::Array> array;
+  KATANA_LOG_ASSERT(builder.Finish(&array).ok());
+  return arrow::Table::Make(
+      arrow::schema({arrow::field(name, arrow::int64())}), {array});
+}
+
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph() {
+  katana::NUMAArray<katana::GraphTopology::Edge> indices;
+  indices.allocateInterleaved(kEdges.size());
+  std::vector<Node> dests;
+  for (size_t n = 0; n < kEdges.size(); ++n) {
+    for (const auto& [dst, weight] : kEdges[n]) {
+      dests.emplace_back(dst);
+    }
+    indices[n] = dests.size();
+  }
+  katana::NUMAArray<Node> out_dests;
+  out_dests.allocateInterleaved(dests.size());
+  std::copy(dests.begin(), dests.end(), out_dests.begin());
+
+  auto res = katana::PropertyGraph::Make(
+      katana::GraphTopology(std::move(indices), std::move(out_dests)));
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  std::unique_ptr<katana::PropertyGraph> graph = std::move(res.value());
+  KATANA_LOG_ASSERT(
+      graph->AddNodeProperties(MakeTable("id", graph->num_nodes(), 10)));
+  KATANA_LOG_ASSERT(
+      graph->AddEdgeProperties(MakeTable("weight", graph->num_edges(), 1)));
+  return graph;
+}
+
+int64_t
+Value(const std::shared_ptr<arrow::ChunkedArray>& column, size_t i) {
+  auto scalar = column->GetScalar(i);
+  KATANA_LOG_ASSERT(scalar.ok());
+  return std::static_pointer_cast<arrow::Int64Scalar>(scalar.ValueOrDie())
+      ->value;
+}
+
+/// Check that node n of the transformed graph is node old_ids[n] and that
+/// its edges are expected[n]
+void
+Check(
+    katana::TopologyTransform transform, const std::vector<Node>& old_ids,
+    const Edges& expected) {
+  auto graph = MakeGraph();
+  auto res = katana::ApplyTopologyTransform(*graph, transform);
+  KATANA_LOG_VASSERT(res, "{}", res.error());
+  const katana::PropertyGraph& out = *res.value();
+  const katana::GraphTopology& topo = out.topology();
+
+  KATANA_LOG_ASSERT(topo.num_nodes() == expected.size());
+  auto ids_res = out.GetNodeProperty("id");
+  auto weights_res = out.GetEdgeProperty("weight");
+  KATANA_LOG_ASSERT(ids_res && weights_res);
+  std::shared_ptr<arrow::ChunkedArray> ids = ids_res.value();
+  std::shared_ptr<arrow::ChunkedArray> weights = weights_res.value();
+  for (Node n = 0; n < expected.size(); ++n) {
+    KATANA_LOG_VASSERT(
+        Value(ids, n) == old_ids[n] * 10, "node {} has id {}, expected {}", n,
+        Value(ids, n), old_ids[n] * 10);
+    auto edges = topo.edges(n);
+    KATANA_LOG_VASSERT(
+        edges.size() == expected[n].size(), "node {} has {} edges, expected {}",
+        n, edges.size(), expected[n].size());
+    size_t i = 0;
+    for (auto e : edges) {
+      KATANA_LOG_VASSERT(
+          topo.edge_dest(e) == expected[n][i].first &&
+              Value(weights, e) == expected[n][i].second,
+          "edge {} of {} is ({}, {}), expected ({}, {})", i, n,
+          topo.edge_dest(e), Value(weights, e), expected[n][i].first,
+          expected[n][i].second);
+      ++i;
+    }
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  std::vector<Node> identity = {0, 1, 2, 3, 4, 5};
+  Check(
+      katana::TopologyTransform::kSymmetrize, identity,
+      {{{1, 0}, {1, 1}, {1, 4}, {2, 5}},
+       {{0, 0}, {0, 1}, {1, 2}, {2, 3}, {0, 4}},
+       {{1, 3}, {0, 5}},
+       {{4, 6}},
+       {{3, 6}},
+       {}});
+  Check(
+      katana::TopologyTransform::kTranspose, identity,
+      {{{1, 4}, {2, 5}}, {{0, 0}, {0, 1}, {1, 2}}, {{1, 3}}, {}, {{3, 6}}, {}});
+  Check(
+      katana::TopologyTransform::kRemoveSelfLoopsAndDuplicates, identity,
+      {{{1, 0}}, {{2, 3}, {0, 4}}, {{0, 5}}, {{4, 6}}, {}, {}});
+  // Degrees are 2, 3, 1, 1, 0 and 0
+  Check(
+      katana::TopologyTransform::kSortNodesByDegree, {1, 0, 2, 3, 4, 5},
+      {{{0, 2}, {2, 3}, {1, 4}}, {{0, 0}, {0, 1}}, {{1, 5}}, {{4, 6}}, {}, {}});
+  Check(
+      katana::TopologyTransform::kLargestComponent, {0, 1, 2},
+      {{{1, 0}, {1, 1}}, {{1, 2}, {2, 3}, {0, 4}}, {{0, 5}}});
+
+  return 0;
+}
@@ -0,0 +1,141 @@
+#include <string>
+
+#include "katana/BuildGraph.h"
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/GraphGenerators.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/ThreadPool.h"
+#include "katana/Timer.h"
+#include "llvm/Support/CommandLine.h"
+
+namespace cll = llvm::cl;
+
+enum class Generator { kRmat, kKronecker, kErdosRenyi, kPowerLaw, kGrid };
+
+static cll::opt<std::string> output(
+    cll::Positional, cll::desc("<output RDG>"), cll::Required);
+static cll::opt<Generator> generator(
+    "generator", cll::desc("Kind of graph:"),
+    cll::values(
+        clEnumValN(
+            Generator::kRmat, "rmat",
+            "R-MAT with probabilities -a, -b and -c (default)"),
+        clEnumValN(
+            Generator::kKronecker, "kronecker",
+            "Graph500 Kronecker: R-MAT with scrambled node ids"),
+        clEnumValN(
+            Generator::kErdosRenyi, "erdos-renyi",
+            "uniformly random endpoints"),
+        clEnumValN(
+            Generator::kPowerLaw, "power-law",
+            "Chung-Lu with power-law expected degrees of -exponent"),
+        clEnumValN(
+            Generator::kGrid, "grid", "-x by -y by -z grid of neighbors")),
+    cll::init(Generator::kRmat));
+static cll::opt<uint32_t> scale(
+    "scale",
+    cll::desc("2^scale nodes for rmat and kronecker; 2^scale nodes by "
+              "default for erdos-renyi and power-law (default: 16)"),
+    cll::init(16));
+static cll::opt<uint64_t> edgeFactor(
+    "edgeFactor", cll::desc("Edges per node of random graphs (default: 16)"),
+    cll::init(16));
+static cll::opt<uint64_t> numNodes(
+    "numNodes",
+    cll::desc("Number of nodes of erdos-renyi and power-law, instead of "
+              "2^scale"),
+    cll::init(0));
+static cll::opt<double> a("a", cll::desc("R-MAT a"), cll::init(0.57));
+static cll::opt<double> b("b", cll::desc("R-MAT b"), cll::init(0.19));
+static cll::opt<double> c("c", cll::desc("R-MAT c"), cll::init(0.19));
+static cll::opt<double> exponent(
+    "exponent", cll::desc("Power-law exponent, above 2 (default: 2.5)"),
+    cll::init(2.5));
+static cll::opt<uint64_t> x("x", cll::desc("Grid width"), cll::init(256));
+static cll::opt<uint64_t> y("y", cll::desc("Grid height"), cll::init(256));
+static cll::opt<uint64_t> z("z", cll::desc("Grid depth"), cll::init(1));
+static cll::opt<std::string> weightProperty(
+    "weightProperty",
+    cll::desc("Edge property with random weights; empty for none "
+              "(default: weight)"),
+    cll::init("weight"));
+static cll::opt<uint32_t> maxWeight(
+    "maxWeight", cll::desc("Weights are in [1, maxWeight] (default: 255)"),
+    cll::init(255));
+static cll::opt<uint32_t> numNodeTypes(
+    "numNodeTypes", cll::desc("Number of random node types (default: 0)"),
+    cll::init(0));
+static cll::opt<uint32_t> numEdgeTypes(
+    "numEdgeTypes", cll::desc("Number of random edge types (default: 0)"),
+    cll::init(0));
+static cll::opt<uint64_t> seed(
+    "seed", cll::desc("Random seed (default: 0)"), cll::init(0));
+static cll::opt<int> numThreads(
+    "t", cll::desc("Number of threads (default: all)"), cll::init(0));
+
+katana::Result<katana::GraphTopology>
+Generate() {
+  uint64_t n = numNodes > 0 ? numNodes : uint64_t{1} << scale;
+  switch (generator) {
+  case Generator::kRmat:
+  case Generator::kKronecker: {
+    katana::RmatOptions opts;
+    if (generator == Generator::kKronecker) {
+      opts = katana::RmatOptions::Graph500(scale, seed);
+    } else {
+      opts.scale = scale;
+      opts.a = a;
+      opts.b = b;
+      opts.c = c;
+      opts.seed = seed;
+    }
+    opts.edge_factor = edgeFactor;
+    return katana::GenerateRmatTopology(opts);
+  }
+  case Generator::kErdosRenyi:
+    return katana::GenerateErdosRenyiTopology(n, n * edgeFactor, seed);
+  case Generator::kPowerLaw:
+    return katana::GenerateChungLuTopology(
+        n, n * edgeFactor, exponent, seed);
+  case Generator::kGrid:
+    return katana::GenerateGridTopology(x, y, z);
+  }
+  return KATANA_ERROR(katana::ErrorCode::InvalidArgument, "unknown generator");
+}
+
+int
+main(int argc, char** argv) {
+  katana::SharedMemSys G;
+  llvm::cl::ParseCommandLineOptions(argc, argv);
+  katana::setActiveThreads(
+      numThreads > 0 ? numThreads : katana::GetThreadPool().getMaxThreads());
+
+  katana::Timer timer;
+  timer.start();
+  auto topology = Generate();
+  if (!topology) {
+    KATANA_LOG_FATAL("failed to generate graph: {}", topology.error());
+  }
+
+  katana::GeneratedPropertiesOptions opts;
+  opts.weight_property = weightProperty;
+  opts.max_weight = maxWeight;
+  opts.num_node_types = numNodeTypes;
+  opts.num_edge_types = numEdgeTypes;
+  opts.seed = seed;
+  auto pg = katana::MakeGeneratedGraph(std::move(topology.value()), opts);
+  if (!pg) {
+    KATANA_LOG_FATAL("failed to make graph: {}", pg.error());
+  }
+  timer.stop();
+  katana::gInfo(
+      "Generated ", pg.value()->num_nodes(), " nodes and ",
+      pg.value()->num_edges(), " edges in ", timer.get(), " ms");
+
+  if (auto r = katana::WritePropertyGraph(*pg.value(), output); !r) {
+    KATANA_LOG_FATAL("failed to write {}: {}", output.getValue(), r.error());
+  }
+  return 0;
+}
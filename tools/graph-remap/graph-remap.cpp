@@ -17,123 +17,445 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
-#include "katana/BufferedGraph.h"
+#include <fstream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+#include <arrow/compute/api.h>
+
+#include "katana/BuildGraph.h"
 #include "katana/FileGraph.h"
 #include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PropertyGraph.h"
+#include "katana/ThreadPool.h"
 #include "llvm/Support/CommandLine.h"
 
 namespace cll = llvm::cl;
 
-static cll::opt<std::string> inputFilename(
-    cll::Positional, cll::desc("<input file>"), cll::Required);
-static cll::opt<std::string> mappingFilename(
-    cll::Positional, cll::desc("<mapping file>"), cll::Required);
-static cll::opt<std::string> outputFilename(
-    cll::Positional, cll::desc("<output file>"), cll::Required);
+enum class Order {
+  kFile,
+  kDegree,
+  kBFS,
+  kReverseCuthillMcKee,
+  kGorder,
+  kHubCluster,
+  kRandom,
+  kProperty
+};
+
+static cll::list<std::string> positionals(
+    cll::Positional,
+    cll::desc("<input file> [<mapping file>] <output file>\n"
+              "The mapping file is only given with -order=file"),
+    cll::OneOrMore);
+static cll::opt<Order> order(
+    "order", cll::desc("New order of the nodes:"),
+    cll::values(
+        clEnumValN(
+            Order::kFile, "file",
+            "node listed on line n of the mapping file becomes node n "
+            "(default); for .gr inputs, unlisted nodes are removed"),
+        clEnumValN(Order::kDegree, "degree", "descending degree"),
+        clEnumValN(Order::kBFS, "bfs", "breadth first order"),
+        clEnumValN(
+            Order::kReverseCuthillMcKee, "rcm", "reverse Cuthill-McKee"),
+        clEnumValN(Order::kGorder, "gorder", "Gorder-style greedy placement"),
+        clEnumValN(Order::kHubCluster, "hub", "degree-bucketed hub clustering"),
+        clEnumValN(Order::kRandom, "random", "random order"),
+        clEnumValN(
+            Order::kProperty, "property",
+            "node property -mappingProperty of an RDG holds the new id of "
+            "each node")),
+    cll::init(Order::kFile));
+static cll::opt<bool> rdg(
+    "rdg", cll::desc("Input and output are RDGs rather than .gr files"),
+    cll::init(false));
+static cll::opt<std::string> mappingProperty(
+    "mappingProperty",
+    cll::desc("Integer node property with new ids for -order=property"),
+    cll::init(""));
+static cll::opt<std::string> inverseProperty(
+    "inverseProperty",
+    cll::desc("Node property of the output RDG with the old id of each node; "
+              "empty for none (default: original_id)"),
+    cll::init("original_id"));
+static cll::opt<std::string> inverseMapping(
+    "inverseMapping",
+    cll::desc("File to write the old id of each node of the output to, one "
+              "per line, in the format of mapping files"),
+    cll::init(""));
+static cll::opt<unsigned> seed(
+    "seed", cll::desc("Seed of -order=random"), cll::init(0));
+static cll::opt<int> numThreads(
+    "t", cll::desc("Number of threads (default: all)"), cll::init(0));
 
+using Node = katana::GraphTopology::Node;
 using Writer = katana::FileGraphWriter;
 
 /**
- * Create node map from file
+ * Read the node ids of a mapping file, one per line
  */
-std::map<uint32_t, uint32_t>
-createNodeMap() {
-  katana::gInfo("Creating node map");
-  // read new mapping
+std::vector<uint64_t>
+readMapping(const std::string& mappingFilename) {
+  katana::gInfo("Reading node map");
   std::ifstream mapFile(mappingFilename);
-  mapFile.seekg(0, std::ios_base::end);
-
-  int64_t endOfFile = mapFile.tellg();
   if (!mapFile) {
     KATANA_DIE("failed to read file");
   }
 
-  mapFile.seekg(0, std::ios_base::beg);
-  if (!mapFile) {
+  std::vector<uint64_t> mapping;
+  uint64_t nodeID;
+  while (mapFile >> nodeID) {
+    mapping.emplace_back(nodeID);
+  }
+  if (!mapFile.eof()) {
     KATANA_DIE("failed to read file");
   }
+  katana::gInfo("Remapping ", mapping.size(), " nodes");
+  return mapping;
+}
 
-  // remap node listed on line n in the mapping to node n
-  std::map<uint32_t, uint32_t> remapper;
-  uint64_t counter = 0;
-  while (((int64_t)mapFile.tellg() + 1) != endOfFile) {
-    uint64_t nodeID;
-    mapFile >> nodeID;
-    if (!mapFile) {
-      KATANA_DIE("failed to read file");
-    }
-    remapper[nodeID] = counter++;
+void
+writeInverseMapping(const katana::NUMAArray<Node>& oldIDs) {
+  if (inverseMapping.empty()) {
+    return;
+  }
+  std::ofstream out(inverseMapping);
+  for (Node n : oldIDs) {
+    out << n << '\n';
+  }
+  if (!out) {
+    KATANA_LOG_FATAL("failed to write {}", inverseMapping.getValue());
   }
+}
 
-  KATANA_LOG_ASSERT(remapper.size() == counter);
-  katana::gInfo("Remapping ", counter, " nodes");
+/// The nodes ordered by key, with ties broken by id
+template <typename KeyFn>
+katana::NUMAArray<Node>
+sortNodes(uint64_t numNodes, const KeyFn& key) {
+  using KeyNode = std::pair<decltype(key(Node{0})), Node>;
+  katana::NUMAArray<KeyNode> keys;
+  keys.allocateInterleaved(numNodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, numNodes),
+      [&](uint64_t n) { keys[n] = KeyNode(key(n), n); }, katana::no_stats());
+  katana::ParallelSTL::sort(keys.begin(), keys.end());
 
-  katana::gInfo("Node map created");
+  katana::NUMAArray<Node> oldIDs;
+  oldIDs.allocateInterleaved(numNodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, numNodes),
+      [&](uint64_t i) { oldIDs[i] = keys[i].second; }, katana::no_stats());
+  return oldIDs;
+}
 
-  return remapper;
+/// The old ids of the nodes of a view, in its order
+template <typename View>
+katana::NUMAArray<Node>
+viewOrder(katana::PropertyGraph* pg) {
+  View view = pg->BuildView<View>();
+  katana::NUMAArray<Node> oldIDs;
+  oldIDs.allocateInterleaved(view.num_nodes());
+  katana::do_all(
+      katana::iterate(view.all_nodes()),
+      [&](auto n) { oldIDs[n] = view.node_property_index(n); },
+      katana::no_stats());
+  return oldIDs;
 }
 
-int
-main(int argc, char** argv) {
-  katana::SharedMemSys G;
-  llvm::cl::ParseCommandLineOptions(argc, argv);
+/// The old id of each new node; mapping is the contents of the mapping file
+/// with -order=file
+katana::NUMAArray<Node>
+computeOrder(katana::PropertyGraph* pg, const std::vector<uint64_t>& mapping) {
+  const katana::GraphTopology& topo = pg->topology();
+  uint64_t numNodes = topo.num_nodes();
+
+  switch (order) {
+  case Order::kFile: {
+    if (mapping.size() != numNodes) {
+      KATANA_LOG_FATAL(
+          "mapping has {} nodes, graph has {}", mapping.size(), numNodes);
+    }
+    katana::NUMAArray<Node> oldIDs;
+    oldIDs.allocateInterleaved(numNodes);
+    std::copy(mapping.begin(), mapping.end(), oldIDs.begin());
+    return oldIDs;
+  }
+  case Order::kDegree:
+    // Negate so that higher degrees come first
+    return sortNodes(numNodes, [&](Node n) {
+      return -static_cast<int64_t>(topo.edges(n).size());
+    });
+  case Order::kBFS:
+    return viewOrder<katana::PropertyGraphViews::BFSOrder>(pg);
+  case Order::kReverseCuthillMcKee:
+    return viewOrder<katana::PropertyGraphViews::ReverseCuthillMcKee>(pg);
+  case Order::kGorder:
+    return viewOrder<katana::PropertyGraphViews::Gorder>(pg);
+  case Order::kHubCluster:
+    return viewOrder<katana::PropertyGraphViews::HubClustered>(pg);
+  case Order::kRandom:
+    return sortNodes(numNodes, [&](Node n) {
+      uint64_t x = n + 0x9e3779b97f4a7c15ULL * (1 + seed);
+      x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+      x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+      return x ^ (x >> 31);
+    });
+  case Order::kProperty: {
+    auto property = pg->GetNodeProperty(mappingProperty);
+    if (!property) {
+      KATANA_LOG_FATAL("no node property {}", mappingProperty.getValue());
+    }
+    auto cast = arrow::compute::Cast(property.value(), arrow::uint64());
+    if (!cast.ok()) {
+      KATANA_LOG_FATAL(
+          "{} is not an integer property: {}", mappingProperty.getValue(),
+          cast.status().ToString());
+    }
+    auto combined = katana::CombinedArray(cast.ValueOrDie().chunked_array());
+    if (!combined || combined.value()->null_count() != 0) {
+      KATANA_LOG_FATAL("{} has null values", mappingProperty.getValue());
+    }
+    const auto& newIDs =
+        static_cast<const arrow::UInt64Array&>(*combined.value());
+
+    // PermuteNodes checks that each node is given once
+    katana::NUMAArray<Node> oldIDs;
+    oldIDs.allocateInterleaved(numNodes);
+    bool inRange = true;
+    katana::do_all(
+        katana::iterate(uint64_t{0}, numNodes),
+        [&](uint64_t n) {
+          if (newIDs.Value(n) < numNodes) {
+            oldIDs[newIDs.Value(n)] = n;
+          } else {
+            inRange = false;
+          }
+        },
+        katana::no_stats());
+    if (!inRange) {
+      KATANA_LOG_FATAL(
+          "{} has ids of nodes that do not exist", mappingProperty.getValue());
+    }
+    return oldIDs;
+  }
+  }
+  KATANA_LOG_FATAL("unknown order");
+}
 
-  std::map<uint32_t, uint32_t> remapper = createNodeMap();
+void
+remapRDG(
+    const std::string& input, const std::vector<uint64_t>& mapping,
+    const std::string& output) {
+  auto pgResult = katana::PropertyGraph::Make(input, tsuba::RDGLoadOptions());
+  if (!pgResult) {
+    KATANA_LOG_FATAL("failed to load {}: {}", input, pgResult.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pgResult.value());
 
-  katana::gInfo("Loading graph to remap");
-  katana::BufferedGraph<void> graphToRemap;
-  graphToRemap.loadGraph(inputFilename);
-  katana::gInfo("Graph loaded");
+  katana::NUMAArray<Node> oldIDs = computeOrder(pg.get(), mapping);
+  auto permuted = katana::PermuteNodes(*pg, oldIDs);
+  if (!permuted) {
+    KATANA_LOG_FATAL("failed to remap: {}", permuted.error());
+  }
+
+  if (!inverseProperty.empty()) {
+    const std::string& name = inverseProperty;
+    arrow::UInt64Builder builder;
+    if (auto st = builder.AppendValues(oldIDs.begin(), oldIDs.end());
+        !st.ok()) {
+      KATANA_LOG_FATAL("building {}: {}", name, st.ToString());
+    }
+    std::shared_ptr<arrow::Array> values;
+    if (auto st = builder.Finish(&values); !st.ok()) {
+      KATANA_LOG_FATAL("building {}: {}", name, st.ToString());
+    }
+    auto table = arrow::Table::Make(
+        arrow::schema({arrow::field(name, arrow::uint64())}), {values});
+    if (auto r = permuted.value()->AddNodeProperties(table); !r) {
+      KATANA_LOG_FATAL("failed to add {}: {}", name, r.error());
+    }
+  }
+  writeInverseMapping(oldIDs);
+
+  if (auto r = katana::WritePropertyGraph(*permuted.value(), output); !r) {
+    KATANA_LOG_FATAL("failed to write {}: {}", output, r.error());
+  }
+}
+
+/**
+ * Keep the nodes of a .gr file listed in the mapping file, renumbered in the
+ * order they are listed, and the edges between them
+ */
+void
+remapGrByFile(
+    katana::FileGraph& graphToRemap, const std::vector<uint64_t>& mapping,
+    const std::string& output) {
+  constexpr uint64_t kRemoved = std::numeric_limits<uint64_t>::max();
+  size_t prevNumNodes = graphToRemap.size();
+  katana::NUMAArray<uint64_t> remapper;
+  remapper.allocateInterleaved(prevNumNodes);
+  katana::ParallelSTL::fill(remapper.begin(), remapper.end(), kRemoved);
+  for (size_t i = 0; i < mapping.size(); ++i) {
+    if (mapping[i] >= prevNumNodes || remapper[mapping[i]] != kRemoved) {
+      KATANA_DIE("mapping lists node ", mapping[i], " twice or out of range");
+    }
+    remapper[mapping[i]] = i;
+  }
+
+  katana::GAccumulator<uint64_t> numEdges;
+  bool danglingEdge = false;
+  katana::do_all(
+      katana::iterate(mapping),
+      [&](uint64_t oldID) {
+        for (auto e : graphToRemap.edges(oldID)) {
+          if (remapper[graphToRemap.getEdgeDst(e)] == kRemoved) {
+            danglingEdge = true;
+          }
+        }
+        numEdges += graphToRemap.edges(oldID).size();
+      },
+      katana::steal(), katana::no_stats());
+  if (danglingEdge) {
+    KATANA_DIE("an edge of a listed node is to a node that is not listed");
+  }
 
   Writer graphWriter;
-  graphWriter.setNumNodes(remapper.size());
-  graphWriter.setNumEdges(graphToRemap.sizeEdges());
+  graphWriter.setNumNodes(mapping.size());
+  graphWriter.setNumEdges(numEdges.reduce());
 
   // phase 1: count degrees
   graphWriter.phase1();
-  katana::gInfo("Starting degree counting");
-  size_t prevNumNodes = graphToRemap.size();
-  size_t nodeIDCounter = 0;
-  for (size_t i = 0; i < prevNumNodes; i++) {
-    // see if current node is to be remapped, i.e. exists in the map
-    if (remapper.find(i) != remapper.end()) {
-      KATANA_LOG_ASSERT(nodeIDCounter == remapper[i]);
-      for (auto e = graphToRemap.edgeBegin(i); e < graphToRemap.edgeEnd(i);
-           e++) {
-        graphWriter.incrementDegree(nodeIDCounter);
-      }
-      nodeIDCounter++;
-    }
+  for (size_t i = 0; i < mapping.size(); i++) {
+    graphWriter.incrementDegree(i, graphToRemap.edges(mapping[i]).size());
   }
-  KATANA_LOG_ASSERT(nodeIDCounter == remapper.size());
 
-  // phase 2: edge construction
+  // phase 2: edge construction; each task only adds edges of its own node
   graphWriter.phase2();
   katana::gInfo("Starting edge construction");
-  nodeIDCounter = 0;
-  for (size_t i = 0; i < prevNumNodes; i++) {
-    // see if current node is to be remapped, i.e. exists in the map
-    if (remapper.find(i) != remapper.end()) {
-      KATANA_LOG_ASSERT(nodeIDCounter == remapper[i]);
-      for (auto e = graphToRemap.edgeBegin(i); e < graphToRemap.edgeEnd(i);
-           e++) {
-        uint32_t dst = graphToRemap.edgeDestination(*e);
-        KATANA_LOG_ASSERT(remapper.find(dst) != remapper.end());
-        graphWriter.addNeighbor(nodeIDCounter, remapper[dst]);
-      }
-      nodeIDCounter++;
-    }
-  }
-  KATANA_LOG_ASSERT(nodeIDCounter == remapper.size());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, mapping.size()),
+      [&](uint64_t newID) {
+        for (auto e : graphToRemap.edges(mapping[newID])) {
+          graphWriter.addNeighbor(
+              newID, remapper[graphToRemap.getEdgeDst(e)]);
+        }
+      },
+      katana::steal(), katana::no_stats());
 
   katana::gInfo("Finishing up: outputting graph shortly");
 
   graphWriter.finish<void>();
-  graphWriter.toFile(outputFilename);
+  graphWriter.toFile(output);
 
   katana::gInfo(
       "new size is ", graphWriter.size(), " num edges ",
       graphWriter.sizeEdges());
+}
+
+template <typename EdgeTy>
+void
+permuteGr(
+    katana::FileGraph& graph, const katana::NUMAArray<Node>& oldIDs,
+    const std::string& output) {
+  std::vector<uint64_t> perm(oldIDs.size());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, oldIDs.size()),
+      [&](uint64_t i) { perm[oldIDs[i]] = i; }, katana::no_stats());
+  katana::FileGraph out;
+  katana::permute<EdgeTy>(graph, perm, out);
+  out.toFile(output);
+}
+
+/**
+ * Renumber all nodes of a .gr file, keeping edge data
+ */
+void
+remapGrByOrder(katana::FileGraph& graph, const std::string& output) {
+  if (graph.size() > std::numeric_limits<Node>::max()) {
+    KATANA_LOG_FATAL("graph has too many nodes for -order");
+  }
+
+  // Copy the topology to a property graph to use its node orders
+  katana::NUMAArray<katana::GraphTopology::Edge> adjIndices;
+  adjIndices.allocateInterleaved(graph.size());
+  katana::NUMAArray<Node> dests;
+  dests.allocateInterleaved(graph.sizeEdges());
+  katana::do_all(
+      katana::iterate(graph),
+      [&](uint64_t n) {
+        adjIndices[n] = *graph.edge_end(n);
+        for (auto e : graph.edges(n)) {
+          dests[*e] = graph.getEdgeDst(e);
+        }
+      },
+      katana::steal(), katana::no_stats());
+  auto pg = katana::PropertyGraph::Make(
+      katana::GraphTopology(std::move(adjIndices), std::move(dests)));
+  if (!pg) {
+    KATANA_LOG_FATAL("failed to make graph: {}", pg.error());
+  }
+
+  katana::NUMAArray<Node> oldIDs = computeOrder(pg.value().get(), {});
+  writeInverseMapping(oldIDs);
+
+  switch (graph.edgeSize()) {
+  case 0:
+    permuteGr<void>(graph, oldIDs, output);
+    break;
+  case sizeof(uint32_t):
+    permuteGr<uint32_t>(graph, oldIDs, output);
+    break;
+  case sizeof(uint64_t):
+    permuteGr<uint64_t>(graph, oldIDs, output);
+    break;
+  default:
+    KATANA_LOG_FATAL("unsupported edge data size {}", graph.edgeSize());
+  }
+}
+
+int
+main(int argc, char** argv) {
+  katana::SharedMemSys G;
+  llvm::cl::ParseCommandLineOptions(argc, argv);
+  katana::setActiveThreads(
+      numThreads > 0 ? numThreads : katana::GetThreadPool().getMaxThreads());
+
+  size_t expected = order == Order::kFile ? 3 : 2;
+  if (positionals.size() != expected) {
+    KATANA_LOG_FATAL(
+        "expected {} file arguments, got {}", expected, positionals.size());
+  }
+  if (order == Order::kProperty && (!rdg || mappingProperty.empty())) {
+    KATANA_LOG_FATAL("-order=property needs -rdg and -mappingProperty");
+  }
+  const std::string& input = positionals.front();
+  const std::string& output = positionals.back();
+  std::vector<uint64_t> mapping;
+  if (order == Order::kFile) {
+    mapping = readMapping(positionals[1]);
+  }
+
+  if (rdg) {
+    remapRDG(input, mapping, output);
+    return 0;
+  }
+
+  katana::gInfo("Loading graph to remap");
+  katana::FileGraph graphToRemap;
+  graphToRemap.fromFile(input);
+  katana::gInfo("Graph loaded");
+
+  if (order == Order::kFile) {
+    remapGrByFile(graphToRemap, mapping, output);
+  } else {
+    remapGrByOrder(graphToRemap, output);
+  }
 
   return 0;
 }
@@ -0,0 +1,382 @@
+#include "GraphStats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <unordered_map>
+
+#include "katana/Galois.h"
+#include "katana/HashMapReducer.h"
+#include "katana/Logging.h"
+#include "katana/NUMAArray.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
+
+namespace {
+
+using GNode = katana::FileGraph::GraphNode;
+
+katana::StatHistogram
+ToHistogram(katana::GHashMapReducer<uint64_t, uint64_t>& counts) {
+  const auto& reduced = counts.reduce();
+  return katana::StatHistogram(reduced.begin(), reduced.end());
+}
+
+/// A 64-bit mix of x, so that node ids are spread over the registers and
+/// ranks of the sketches
+uint64_t
+HashNode(uint64_t x, unsigned seed) {
+  x += 0x9e3779b97f4a7c15ULL * (1 + seed);
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+/// The HyperLogLog estimate of the number of distinct items added to the m
+/// registers at regs
+double
+EstimateCount(const uint8_t* regs, size_t m) {
+  double sum = 0;
+  size_t zeros = 0;
+  for (size_t j = 0; j < m; ++j) {
+    sum += std::ldexp(1.0, -regs[j]);
+    zeros += regs[j] == 0;
+  }
+  double alpha = m == 16 ? 0.673
+                 : m == 32 ? 0.697
+                 : m == 64 ? 0.709
+                           : 0.7213 / (1 + 1.079 / m);
+  double estimate = alpha * m * m / sum;
+  // Linear counting is more accurate for small counts
+  if (estimate <= 2.5 * m && zeros != 0) {
+    estimate = m * std::log(static_cast<double>(m) / zeros);
+  }
+  return estimate;
+}
+
+/// Union the trees of a and b in comp, hooking the larger root under the
+/// smaller
+void
+LinkComponents(uint64_t a, uint64_t b, katana::NUMAArray<uint64_t>& comp) {
+  uint64_t p1 = comp[a];
+  uint64_t p2 = comp[b];
+  while (p1 != p2) {
+    uint64_t high = std::max(p1, p2);
+    uint64_t low = std::min(p1, p2);
+    uint64_t p_high = comp[high];
+    if (p_high == low || (p_high == high && __sync_bool_compare_and_swap(
+                                                &comp[high], high, low))) {
+      break;
+    }
+    p1 = comp[comp[high]];
+    p2 = comp[low];
+  }
+}
+
+void
+CompressComponents(
+    katana::FileGraph& graph, katana::NUMAArray<uint64_t>& comp) {
+  katana::do_all(
+      katana::iterate(graph),
+      [&](GNode n) {
+        while (comp[n] != comp[comp[n]]) {
+          comp[n] = comp[comp[n]];
+        }
+      },
+      katana::no_stats(), katana::loopname("ComponentsCompress"));
+}
+
+}  // namespace
+
+std::vector<uint64_t>
+katana::StatDegrees(FileGraph& graph) {
+  std::vector<uint64_t> degrees(graph.size());
+  katana::do_all(
+      katana::iterate(graph),
+      [&](GNode n) { degrees[n] = graph.edges(n).size(); },
+      katana::no_stats());
+  return degrees;
+}
+
+katana::StatHistogram
+katana::StatDegreeHistogram(FileGraph& graph) {
+  katana::GHashMapReducer<uint64_t, uint64_t> counts;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](GNode n) { counts.update(graph.edges(n).size(), 1); },
+      katana::no_stats());
+  return ToHistogram(counts);
+}
+
+katana::StatHistogram
+katana::StatInDegreeHistogram(FileGraph& graph) {
+  katana::NUMAArray<uint64_t> in_degrees;
+  in_degrees.allocateInterleaved(graph.size());
+  katana::do_all(
+      katana::iterate(graph), [&](GNode n) { in_degrees[n] = 0; },
+      katana::no_stats());
+  katana::do_all(
+      katana::iterate(graph),
+      [&](GNode n) {
+        for (auto e : graph.edges(n)) {
+          __sync_fetch_and_add(&in_degrees[graph.getEdgeDst(e)], 1);
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  katana::GHashMapReducer<uint64_t, uint64_t> counts;
+  katana::do_all(
+      katana::iterate(graph), [&](GNode n) { counts.update(in_degrees[n], 1); },
+      katana::no_stats());
+  return ToHistogram(counts);
+}
+
+katana::StatHistogram
+katana::StatDestinationHistogram(FileGraph& graph) {
+  katana::GHashMapReducer<uint64_t, uint64_t> counts;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](GNode n) {
+        for (auto e : graph.edges(n)) {
+          counts.update(graph.getEdgeDst(e), 1);
+        }
+      },
+      katana::steal(), katana::no_stats());
+  return ToHistogram(counts);
+}
+
+katana::MaxDegreeNode
+katana::StatMaxDegreeNode(FileGraph& graph) {
+  if (graph.size() == 0) {
+    return MaxDegreeNode{0, 0};
+  }
+  katana::GReduceMax<uint64_t> max_degree;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](GNode n) { max_degree.update(graph.edges(n).size()); },
+      katana::no_stats());
+  uint64_t degree = max_degree.reduce();
+  katana::GReduceMin<uint64_t> first_node;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](GNode n) {
+        if (graph.edges(n).size() == degree) {
+          first_node.update(n);
+        }
+      },
+      katana::no_stats());
+  return MaxDegreeNode{first_node.reduce(), degree};
+}
+
+katana::NeighborhoodFunction
+katana::StatNeighborhoodFunction(
+    FileGraph& graph, unsigned register_bits, unsigned max_hops,
+    unsigned seed) {
+  if (register_bits < 4 || register_bits > 16) {
+    KATANA_LOG_FATAL("registerBits must be between 4 and 16");
+  }
+  const size_t m = size_t{1} << register_bits;
+  const size_t num_nodes = graph.size();
+
+  katana::NUMAArray<uint8_t> cur;
+  katana::NUMAArray<uint8_t> next;
+  cur.allocateInterleaved(num_nodes * m);
+  next.allocateInterleaved(num_nodes * m);
+
+  katana::GAccumulator<double> pairs;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](GNode n) {
+        uint8_t* regs = &cur[n * m];
+        std::fill(regs, regs + m, 0);
+        uint64_t h = HashNode(n, seed);
+        size_t j = h >> (64 - register_bits);
+        uint64_t rest = h << register_bits;
+        unsigned max_rank = 64 - register_bits + 1;
+        regs[j] = rest == 0 ? max_rank : __builtin_clzll(rest) + 1;
+        pairs += EstimateCount(regs, m);
+      },
+      katana::no_stats(), katana::loopname("NeighborhoodFunctionInit"));
+
+  NeighborhoodFunction nf{};
+  nf.pairs_within_hops.emplace_back(pairs.reduce());
+  while (nf.pairs_within_hops.size() <= max_hops) {
+    pairs.reset();
+    katana::GReduceLogicalOr changed;
+    katana::do_all(
+        katana::iterate(graph),
+        [&](GNode n) {
+          uint8_t* regs = &next[n * m];
+          std::copy(&cur[n * m], &cur[n * m] + m, regs);
+          bool node_changed = false;
+          for (auto e : graph.edges(n)) {
+            const uint8_t* other = &cur[graph.getEdgeDst(e) * m];
+            for (size_t j = 0; j < m; ++j) {
+              if (other[j] > regs[j]) {
+                regs[j] = other[j];
+                node_changed = true;
+              }
+            }
+          }
+          changed.update(node_changed);
+          pairs += EstimateCount(regs, m);
+        },
+        katana::steal(), katana::no_stats(),
+        katana::loopname("NeighborhoodFunctionHop"));
+    if (!changed.reduce()) {
+      break;
+    }
+    std::swap(cur, next);
+    nf.pairs_within_hops.emplace_back(pairs.reduce());
+  }
+
+  const std::vector<double>& within = nf.pairs_within_hops;
+  double total = within.back();
+  for (size_t h = 0; h < within.size(); ++h) {
+    if (within[h] >= 0.9 * total) {
+      nf.effective_diameter =
+          h == 0 ? 0
+                 : (h - 1) + (0.9 * total - within[h - 1]) /
+                                 (within[h] - within[h - 1]);
+      break;
+    }
+  }
+  nf.converged = within.size() <= max_hops;
+  return nf;
+}
+
+std::vector<uint64_t>
+katana::SampleNodes(
+    const FileGraph& graph, uint64_t num_samples, unsigned seed) {
+  KATANA_LOG_ASSERT(graph.size() != 0);
+  std::vector<uint64_t> samples(num_samples);
+  std::mt19937_64 gen(seed);
+  std::uniform_int_distribution<uint64_t> dist(0, graph.size() - 1);
+  for (auto& n : samples) {
+    n = dist(gen);
+  }
+  return samples;
+}
+
+double
+katana::StatClusteringCoefficient(
+    FileGraph& graph, const std::vector<uint64_t>& nodes) {
+  if (nodes.empty()) {
+    return 0;
+  }
+  katana::PerThreadStorage<std::vector<GNode>> neighbor_buffers;
+  katana::GAccumulator<double> sum;
+  katana::do_all(
+      katana::iterate(nodes),
+      [&](uint64_t n) {
+        auto& neighbors = *neighbor_buffers.getLocal();
+        neighbors.clear();
+        for (auto e : graph.edges(n)) {
+          GNode dst = graph.getEdgeDst(e);
+          if (dst != n) {
+            neighbors.emplace_back(dst);
+          }
+        }
+        std::sort(neighbors.begin(), neighbors.end());
+        neighbors.erase(
+            std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+        uint64_t k = neighbors.size();
+        if (k < 2) {
+          return;
+        }
+
+        uint64_t links = 0;
+        for (GNode v : neighbors) {
+          GNode last = v;
+          for (auto e : graph.edges(v)) {
+            GNode w = graph.getEdgeDst(e);
+            // Count each neighbor of v once, even with multi-edges
+            if (w != v && w != last &&
+                std::binary_search(neighbors.begin(), neighbors.end(), w)) {
+              ++links;
+            }
+            last = w;
+          }
+        }
+        sum += static_cast<double>(links) / (k * (k - 1));
+      },
+      katana::steal(), katana::no_stats(),
+      katana::loopname("ClusteringCoefficient"));
+  return sum.reduce() / nodes.size();
+}
+
+katana::StatHistogram
+katana::StatComponentSizes(FileGraph& graph, bool symmetric, unsigned seed) {
+  constexpr unsigned kNeighborRounds = 2;
+  constexpr unsigned kComponentSamples = 1024;
+
+  katana::NUMAArray<uint64_t> comp;
+  comp.allocateInterleaved(graph.size());
+  katana::do_all(
+      katana::iterate(graph), [&](GNode n) { comp[n] = n; },
+      katana::no_stats());
+
+  for (unsigned r = 0; r < kNeighborRounds; ++r) {
+    katana::do_all(
+        katana::iterate(graph),
+        [&](GNode n) {
+          auto e = graph.edge_begin(n) + r;
+          if (e < graph.edge_end(n)) {
+            LinkComponents(n, graph.getEdgeDst(e), comp);
+          }
+        },
+        katana::steal(), katana::no_stats(),
+        katana::loopname("ComponentsSampleLink"));
+    CompressComponents(graph, comp);
+  }
+
+  uint64_t skipped = graph.size();
+  if (symmetric && graph.size() != 0) {
+    std::unordered_map<uint64_t, unsigned> frequency;
+    for (uint64_t n : SampleNodes(graph, kComponentSamples, seed)) {
+      ++frequency[comp[n]];
+    }
+    skipped = std::max_element(
+                  frequency.begin(), frequency.end(),
+                  [](const auto& a, const auto& b) {
+                    return a.second < b.second;
+                  })
+                  ->first;
+  }
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](GNode n) {
+        if (comp[n] == skipped) {
+          return;
+        }
+        for (auto e = graph.edge_begin(n) + kNeighborRounds,
+                  end = graph.edge_end(n);
+             e < end; ++e) {
+          LinkComponents(n, graph.getEdgeDst(e), comp);
+        }
+      },
+      katana::steal(), katana::no_stats(),
+      katana::loopname("ComponentsLink"));
+  CompressComponents(graph, comp);
+
+  katana::NUMAArray<uint64_t> sizes;
+  sizes.allocateInterleaved(graph.size());
+  katana::do_all(
+      katana::iterate(graph), [&](GNode n) { sizes[n] = 0; },
+      katana::no_stats());
+  katana::do_all(
+      katana::iterate(graph),
+      [&](GNode n) { __sync_fetch_and_add(&sizes[comp[n]], 1); },
+      katana::no_stats());
+  katana::GHashMapReducer<uint64_t, uint64_t> counts;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](GNode n) {
+        if (sizes[n] != 0) {
+          counts.update(sizes[n], 1);
+        }
+      },
+      katana::no_stats());
+  return ToHistogram(counts);
+}
@@ -0,0 +1,82 @@
+#ifndef KATANA_TOOLS_GRAPHSTATS_GRAPHSTATS_H_
+#define KATANA_TOOLS_GRAPHSTATS_GRAPHSTATS_H_
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "katana/FileGraph.h"
+
+namespace katana {
+
+/// The statistics of graph-stats; each is computed in parallel on the active
+/// threads
+
+/// A histogram as the number of items with each value; values with no items
+/// are left out
+using StatHistogram = std::map<uint64_t, uint64_t>;
+
+std::vector<uint64_t> StatDegrees(FileGraph& graph);
+
+/// The number of nodes of each out-degree
+StatHistogram StatDegreeHistogram(FileGraph& graph);
+
+/// The number of nodes of each in-degree
+StatHistogram StatInDegreeHistogram(FileGraph& graph);
+
+/// The number of edges to each destination
+StatHistogram StatDestinationHistogram(FileGraph& graph);
+
+struct MaxDegreeNode {
+  uint64_t node;
+  uint64_t degree;
+};
+
+/// The first node of the largest out-degree, as a serial scan would find it
+MaxDegreeNode StatMaxDegreeNode(FileGraph& graph);
+
+struct NeighborhoodFunction {
+  /// The estimated N(h), the number of pairs (u, v) such that v is at most h
+  /// hops from u, for each h until no sketch changes or max_hops
+  std::vector<double> pairs_within_hops;
+  /// The smallest number of hops, interpolated between integers, within
+  /// which 90% of the reachable pairs are
+  double effective_diameter;
+  /// Whether the sketches stopped changing before max_hops; if so
+  /// pairs_within_hops.size() - 1 is a lower bound of the diameter
+  bool converged;
+};
+
+/// Estimates the neighborhood function with one HyperLogLog sketch of the
+/// nodes reachable from each node (HyperANF). Each round makes the sketch of
+/// a node the union of its sketch and those of its neighbors, so the memory
+/// used is 2 * 2^register_bits bytes per node and the time is that of a scan
+/// of the edges per hop. The error is about 1.04 / sqrt(2^register_bits) per
+/// node; register_bits must be between 4 and 16.
+NeighborhoodFunction StatNeighborhoodFunction(
+    FileGraph& graph, unsigned register_bits, unsigned max_hops,
+    unsigned seed);
+
+/// num_samples nodes of graph, which must have nodes, drawn uniformly with
+/// replacement
+std::vector<uint64_t> SampleNodes(
+    const FileGraph& graph, uint64_t num_samples, unsigned seed);
+
+/// The average of the local clustering coefficients of nodes. The
+/// coefficient of a node with k distinct neighbors other than itself is the
+/// fraction of the k * (k - 1) ordered pairs of those neighbors with an edge
+/// between them, and 0 if k < 2; on symmetric graphs this is the usual
+/// undirected coefficient.
+double StatClusteringCoefficient(
+    FileGraph& graph, const std::vector<uint64_t>& nodes);
+
+/// The number of weakly connected components of each size, with Afforest:
+/// link the first few edges of every node, guess the largest component from
+/// a sample of nodes and skip the remaining edges of its nodes. Skipping
+/// needs the reverse edges, so it is only done if the graph is symmetric.
+StatHistogram StatComponentSizes(
+    FileGraph& graph, bool symmetric, unsigned seed);
+
+}  // namespace katana
+
+#endif
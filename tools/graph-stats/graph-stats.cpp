@@ -18,12 +18,18 @@
  */
 
 #include <cstdlib>
+#include <functional>
 #include <iostream>
+#include <string>
 #include <vector>
 
+#include "GraphStats.h"
+#include "katana/FileGraph.h"
 #include "katana/Galois.h"
+#include "katana/JSON.h"
 #include "katana/LCGraph.h"
-#include "katana/OfflineGraph.h"
+#include "katana/Logging.h"
+#include "katana/ThreadPool.h"
 #include "llvm/Support/CommandLine.h"
 
 namespace cll = llvm::cl;
@@ -36,7 +42,10 @@ enum StatMode {
   indegreehist,
   sortedlogoffsethist,
   sparsityPattern,
-  summary
+  summary,
+  neighborhoodFunction,
+  clusteringCoefficient,
+  componentSizes
 };
 
 static cll::opt<std::string> inputfilename(
@@ -56,17 +65,61 @@ static cll::list<StatMode> statModeList(
             sparsityPattern,
             "Pattern of non-zeros when graph is "
             "interpreted as a sparse matrix"),
-        clEnumVal(summary, "Graph summary")));
+        clEnumVal(summary, "Graph summary"),
+        clEnumVal(
+            neighborhoodFunction,
+            "Approximate neighborhood function and effective diameter "
+            "(HyperANF)"),
+        clEnumVal(
+            clusteringCoefficient,
+            "Average clustering coefficient of sampled nodes"),
+        clEnumVal(
+            componentSizes,
+            "Distribution of weakly connected component sizes")));
 static cll::opt<int> numBins(
     "numBins", cll::desc("Number of bins"), cll::init(-1));
 static cll::opt<int> columns(
     "columns", cll::desc("Columns for sparsity"), cll::init(80));
+static cll::opt<bool> jsonOutput(
+    "json", cll::desc("Print all stats as one JSON object"), cll::init(false));
+static cll::opt<int> numThreads(
+    "t", cll::desc("Number of threads (default: all)"), cll::init(0));
+static cll::opt<bool> symmetricGraph(
+    "symmetricGraph",
+    cll::desc("Graph is symmetric, so components need fewer edge visits"),
+    cll::init(false));
+static cll::opt<unsigned> registerBits(
+    "registerBits",
+    cll::desc("log2 of the HyperLogLog registers per node of "
+              "neighborhoodFunction; error is about 1.04 / "
+              "sqrt(2^registerBits) per node (default 6)"),
+    cll::init(6));
+static cll::opt<unsigned> maxHops(
+    "maxHops",
+    cll::desc("Stop neighborhoodFunction after this many hops even if "
+              "it has not converged"),
+    cll::init(256));
+static cll::opt<uint64_t> numSamples(
+    "samples", cll::desc("Nodes sampled by clusteringCoefficient"),
+    cll::init(10000));
+static cll::opt<unsigned> seed(
+    "seed", cll::desc("Seed of the sketches and samples"), cll::init(0));
 
-typedef katana::OfflineGraph Graph;
+typedef katana::FileGraph Graph;
 typedef Graph::GraphNode GNode;
 
+/// With -json, the stats printed so far, by stat name
+static nlohmann::json jsonStats;
+
 void
 doSummary(Graph& graph) {
+  if (jsonOutput) {
+    jsonStats["summary"] = {
+        {"num_nodes", graph.size()},
+        {"num_edges", graph.sizeEdges()},
+        {"sizeof_edge", graph.edgeSize()}};
+    return;
+  }
   std::cout << "NumNodes: " << graph.size() << "\n";
   std::cout << "NumEdges: " << graph.sizeEdges() << "\n";
   std::cout << "SizeofEdge: " << graph.edgeSize() << "\n";
@@ -74,6 +127,10 @@ doSummary(Graph& graph) {
 
 void
 doDegrees(Graph& graph) {
+  if (jsonOutput) {
+    jsonStats["degrees"] = katana::StatDegrees(graph);
+    return;
+  }
   for (auto n : graph) {
     std::cout << graph.edges(n).size() << "\n";
   }
@@ -81,33 +138,40 @@ doDegrees(Graph& graph) {
 
 void
 findMaxDegreeNode(Graph& graph) {
-  uint64_t nodeID = 0;
-  size_t MaxDegree = 0;
-  uint64_t MaxDegreeNode = 0;
-  for (auto n : graph) {
-    size_t degree = graph.edges(n).size();
-    if (MaxDegree < degree) {
-      MaxDegree = degree;
-      MaxDegreeNode = nodeID;
-    }
-    ++nodeID;
+  katana::MaxDegreeNode max = katana::StatMaxDegreeNode(graph);
+  if (jsonOutput) {
+    jsonStats["maxDegreeNode"] = {{"node", max.node}, {"degree", max.degree}};
+    return;
   }
-  std::cout << "MaxDegreeNode : " << MaxDegreeNode
-            << " , MaxDegree : " << MaxDegree << "\n";
+  std::cout << "MaxDegreeNode : " << max.node
+            << " , MaxDegree : " << max.degree << "\n";
 }
 
+/// Print a histogram, or with -json add it to the stats as stat
 void
-printHistogram(const std::string& name, std::map<uint64_t, uint64_t>& hists) {
-  auto max = hists.rbegin()->first;
-  if (numBins <= 0) {
+printHistogram(
+    const std::string& name, const katana::StatHistogram& hists,
+    const std::string& stat) {
+  nlohmann::json jsonBins = nlohmann::json::array();
+  auto printBin = [&](unsigned x, uint64_t start, uint64_t end,
+                      uint64_t count) {
+    if (jsonOutput) {
+      jsonBins.push_back({{"start", start}, {"end", end}, {"count", count}});
+    } else {
+      std::cout << x << ',' << start << ',' << end << ',' << count << '\n';
+    }
+  };
+
+  if (!jsonOutput) {
     std::cout << name << "Bin,Start,End,Count\n";
+  }
+  auto max = hists.empty() ? 0 : hists.rbegin()->first;
+  if (hists.empty()) {
+    // No bins
+  } else if (numBins <= 0) {
     for (unsigned x = 0; x <= max; ++x) {
-      std::cout << x << ',' << x << ',' << x + 1 << ',';
-      if (hists.count(x)) {
-        std::cout << hists[x] << '\n';
-      } else {
-        std::cout << "0\n";
-      }
+      auto it = hists.find(x);
+      printBin(x, x, x + 1, it == hists.end() ? 0 : it->second);
     }
   } else {
     std::vector<uint64_t> bins(numBins);
@@ -115,16 +179,16 @@ printHistogram(const std::string& name, std::map<uint64_t, uint64_t>& hists) {
     if ((max + 1) % numBins) {
       ++bwidth;
     }
-    // std::cerr << "* " << max << " " << numBins << " " << bwidth << "\n";
     for (auto p : hists) {
       bins.at(p.first / bwidth) += p.second;
     }
-    std::cout << name << "Bin,Start,End,Count\n";
     for (unsigned x = 0; x < bins.size(); ++x) {
-      std::cout << x << ',' << x * bwidth << ',' << (x * bwidth + bwidth) << ','
-                << bins[x] << '\n';
+      printBin(x, x * bwidth, x * bwidth + bwidth, bins[x]);
     }
   }
+  if (jsonOutput) {
+    jsonStats[stat] = jsonBins;
+  }
 }
 
 void
@@ -132,42 +196,34 @@ doSparsityPattern(
     Graph& graph, std::function<void(unsigned, unsigned, bool)> printFn) {
   unsigned blockSize = (graph.size() + columns - 1) / columns;
 
+  std::vector<std::vector<char>> rows(columns, std::vector<char>(columns));
+  katana::do_all(
+      katana::iterate(0, static_cast<int>(columns)),
+      [&](int i) {
+        auto p = katana::block_range(graph.begin(), graph.end(), i, columns);
+        for (auto ii = p.first, ei = p.second; ii != ei; ++ii) {
+          for (auto jj : graph.edges(*ii)) {
+            rows[i][graph.getEdgeDst(jj) / blockSize] = true;
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
   for (int i = 0; i < columns; ++i) {
-    std::vector<bool> row(columns);
-    auto p = katana::block_range(graph.begin(), graph.end(), i, columns);
-    for (auto ii = p.first, ei = p.second; ii != ei; ++ii) {
-      for (auto jj : graph.edges(*ii)) {
-        row[graph.getEdgeDst(jj) / blockSize] = true;
-      }
-    }
     for (int x = 0; x < columns; ++x) {
-      printFn(x, i, row[x]);
+      printFn(x, i, rows[i][x]);
     }
   }
 }
 
 void
 doDegreeHistogram(Graph& graph) {
-  std::map<uint64_t, uint64_t> hist;
-  for (auto ii : graph) {
-    ++hist[graph.edges(ii).size()];
-  }
-  printHistogram("Degree", hist);
+  printHistogram("Degree", katana::StatDegreeHistogram(graph), "degreehist");
 }
 
 void
 doInDegreeHistogram(Graph& graph) {
-  std::vector<uint64_t> inv(graph.size());
-  std::map<uint64_t, uint64_t> hist;
-  for (auto ii : graph) {
-    for (auto jj : graph.edges(ii)) {
-      ++inv[graph.getEdgeDst(jj)];
-    }
-  }
-  for (uint64_t n : inv) {
-    ++hist[n];
-  }
-  printHistogram("InDegree", hist);
+  printHistogram(
+      "InDegree", katana::StatInDegreeHistogram(graph), "indegreehist");
 }
 
 struct EdgeComp {
@@ -242,20 +298,87 @@ doSortedLogOffsetHistogram([[maybe_unused]] Graph& graph) {
 
 void
 doDestinationHistogram(Graph& graph) {
-  std::map<uint64_t, uint64_t> hist;
-  for (auto ii : graph) {
-    for (auto jj : graph.edges(ii)) {
-      ++hist[graph.getEdgeDst(jj)];
+  printHistogram(
+      "DestinationBin", katana::StatDestinationHistogram(graph), "dsthist");
+}
+
+void
+doNeighborhoodFunction(Graph& graph) {
+  katana::NeighborhoodFunction nf =
+      katana::StatNeighborhoodFunction(graph, registerBits, maxHops, seed);
+  const std::vector<double>& pairs = nf.pairs_within_hops;
+  if (jsonOutput) {
+    jsonStats["neighborhoodFunction"] = {
+        {"pairs_within_hops", pairs},
+        {"effective_diameter", nf.effective_diameter},
+        {"diameter_lower_bound", pairs.size() - 1},
+        {"converged", nf.converged},
+        {"register_bits", registerBits.getValue()}};
+    return;
+  }
+  std::cout << "Hops,Pairs\n";
+  for (size_t h = 0; h < pairs.size(); ++h) {
+    std::cout << h << ',' << pairs[h] << '\n';
+  }
+  std::cout << "EffectiveDiameter: " << nf.effective_diameter << "\n";
+  std::cout << "DiameterLowerBound: " << pairs.size() - 1
+            << (nf.converged ? "" : " (not converged)") << "\n";
+}
+
+void
+doClusteringCoefficient(Graph& graph) {
+  if (graph.size() == 0) {
+    KATANA_LOG_FATAL("clusteringCoefficient needs a graph with nodes");
+  }
+  std::vector<uint64_t> samples = katana::SampleNodes(graph, numSamples, seed);
+  double average = katana::StatClusteringCoefficient(graph, samples);
+  if (jsonOutput) {
+    jsonStats["clusteringCoefficient"] = {
+        {"average", average}, {"samples", samples.size()}};
+    return;
+  }
+  std::cout << "AverageClusteringCoefficient: " << average << " ("
+            << samples.size() << " samples)\n";
+}
+
+/// Prints how many weakly connected components there are of each size
+void
+doComponentSizes(Graph& graph) {
+  katana::StatHistogram hist =
+      katana::StatComponentSizes(graph, symmetricGraph, seed);
+  uint64_t numComponents = 0;
+  for (const auto& [size, count] : hist) {
+    numComponents += count;
+  }
+  uint64_t largest = hist.empty() ? 0 : hist.rbegin()->first;
+  if (jsonOutput) {
+    nlohmann::json jsonSizes = nlohmann::json::array();
+    for (const auto& [size, count] : hist) {
+      jsonSizes.push_back({{"size", size}, {"count", count}});
     }
+    jsonStats["componentSizes"] = {
+        {"num_components", numComponents},
+        {"largest", largest},
+        {"sizes", jsonSizes}};
+    return;
+  }
+  std::cout << "NumComponents: " << numComponents << "\n";
+  std::cout << "LargestComponent: " << largest << "\n";
+  std::cout << "Size,Count\n";
+  for (const auto& [size, count] : hist) {
+    std::cout << size << ',' << count << '\n';
   }
-  printHistogram("DestinationBin", hist);
 }
 
 int
 main(int argc, char** argv) {
   llvm::cl::ParseCommandLineOptions(argc, argv);
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(
+      numThreads > 0 ? numThreads : katana::GetThreadPool().getMaxThreads());
   try {
-    Graph graph(inputfilename);
+    Graph graph;
+    graph.fromFile(inputfilename);
     for (unsigned i = 0; i != statModeList.size(); ++i) {
       switch (statModeList[i]) {
       case degreehist:
@@ -277,6 +400,16 @@ main(int argc, char** argv) {
         doSortedLogOffsetHistogram(graph);
         break;
       case sparsityPattern: {
+        if (jsonOutput) {
+          std::vector<std::string> rows(columns, std::string(columns, '.'));
+          doSparsityPattern(graph, [&rows](unsigned x, unsigned y, bool val) {
+            if (val) {
+              rows[y][x] = 'x';
+            }
+          });
+          jsonStats["sparsityPattern"] = rows;
+          break;
+        }
         unsigned lastrow = ~0;
         doSparsityPattern(graph, [&lastrow](unsigned, unsigned y, bool val) {
           if (y != lastrow) {
@@ -291,11 +424,23 @@ main(int argc, char** argv) {
       case summary:
         doSummary(graph);
         break;
+      case neighborhoodFunction:
+        doNeighborhoodFunction(graph);
+        break;
+      case clusteringCoefficient:
+        doClusteringCoefficient(graph);
+        break;
+      case componentSizes:
+        doComponentSizes(graph);
+        break;
       default:
         std::cerr << "Unknown stat requested\n";
         break;
       }
     }
+    if (jsonOutput) {
+      std::cout << jsonStats.dump(2) << "\n";
+    }
     return 0;
   } catch (...) {
     std::cerr << "failed\n";
@@ -0,0 +1,240 @@
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <set>
+#include <vector>
+
+#include "GraphStats.h"
+#include "katana/FileGraph.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+/// The destinations of the edges of each node, in order
+using Edges = std::vector<std::vector<uint64_t>>;
+
+/// Nodes 0 to 7 are weakly connected: 0, 1, 2 and 3 have cycles and a
+/// triangle, 1 has a multi-edge, 5 a self loop, and 4 to 7 are a path out of
+/// them. 8 and 9 are isolated and 10 -> 11 is a component of two.
+const Edges kEdges = {
+    {1, 2, 4}, {2, 2}, {0, 3}, {0}, {5}, {5, 6}, {7}, {}, {}, {}, {11}, {}};
+
+katana::FileGraph
+Build(const Edges& edges) {
+  size_t num_edges = 0;
+  for (const auto& node_edges : edges) {
+    num_edges += node_edges.size();
+  }
+  katana::FileGraphWriter writer;
+  writer.setNumNodes(edges.size());
+  writer.setNumEdges(num_edges);
+  writer.setSizeofEdgeData(0);
+  writer.phase1();
+  for (size_t src = 0; src < edges.size(); ++src) {
+    writer.incrementDegree(src, edges[src].size());
+  }
+  writer.phase2();
+  for (size_t src = 0; src < edges.size(); ++src) {
+    for (uint64_t dst : edges[src]) {
+      writer.addNeighbor(src, dst);
+    }
+  }
+  writer.finish<void>();
+  katana::FileGraph graph;
+  graph = std::move(writer);
+  return graph;
+}
+
+/// The edges in both directions, each once
+Edges
+Symmetrize(const Edges& edges) {
+  std::vector<std::set<uint64_t>> sets(edges.size());
+  for (size_t src = 0; src < edges.size(); ++src) {
+    for (uint64_t dst : edges[src]) {
+      sets[src].emplace(dst);
+      sets[dst].emplace(src);
+    }
+  }
+  Edges symmetric;
+  for (const auto& set : sets) {
+    symmetric.emplace_back(set.begin(), set.end());
+  }
+  return symmetric;
+}
+
+/// N(h) for each h up to the diameter, by a BFS from every node
+std::vector<double>
+ExactNeighborhoodFunction(const Edges& edges) {
+  std::vector<double> pairs;
+  for (size_t src = 0; src < edges.size(); ++src) {
+    std::vector<int64_t> dist(edges.size(), -1);
+    std::deque<uint64_t> queue{src};
+    dist[src] = 0;
+    while (!queue.empty()) {
+      uint64_t n = queue.front();
+      queue.pop_front();
+      if (pairs.size() <= static_cast<size_t>(dist[n])) {
+        pairs.resize(dist[n] + 1);
+      }
+      pairs[dist[n]] += 1;
+      for (uint64_t dst : edges[n]) {
+        if (dist[dst] < 0) {
+          dist[dst] = dist[n] + 1;
+          queue.emplace_back(dst);
+        }
+      }
+    }
+  }
+  for (size_t h = 1; h < pairs.size(); ++h) {
+    pairs[h] += pairs[h - 1];
+  }
+  return pairs;
+}
+
+void
+TestDegrees() {
+  katana::FileGraph graph = Build(kEdges);
+  KATANA_LOG_ASSERT(
+      katana::StatDegrees(graph) ==
+      std::vector<uint64_t>({3, 2, 2, 1, 1, 2, 1, 0, 0, 0, 1, 0}));
+  KATANA_LOG_ASSERT(
+      katana::StatDegreeHistogram(graph) ==
+      katana::StatHistogram({{0, 4}, {1, 4}, {2, 3}, {3, 1}}));
+  KATANA_LOG_ASSERT(
+      katana::StatInDegreeHistogram(graph) ==
+      katana::StatHistogram({{0, 3}, {1, 6}, {2, 2}, {3, 1}}));
+  KATANA_LOG_ASSERT(
+      katana::StatDestinationHistogram(graph) ==
+      katana::StatHistogram(
+          {{0, 2},
+           {1, 1},
+           {2, 3},
+           {3, 1},
+           {4, 1},
+           {5, 2},
+           {6, 1},
+           {7, 1},
+           {11, 1}}));
+  katana::MaxDegreeNode max = katana::StatMaxDegreeNode(graph);
+  KATANA_LOG_ASSERT(max.node == 0 && max.degree == 3);
+
+  // The first of several nodes of the largest degree
+  katana::FileGraph ties = Build({{}, {0, 2}, {}, {0, 1}});
+  max = katana::StatMaxDegreeNode(ties);
+  KATANA_LOG_ASSERT(max.node == 1 && max.degree == 2);
+}
+
+/// With 2^10 registers, counts of a dozen are off by much less than one
+void
+TestNeighborhoodFunction() {
+  constexpr unsigned kRegisterBits = 10;
+  katana::FileGraph graph = Build(kEdges);
+  std::vector<double> expected = ExactNeighborhoodFunction(kEdges);
+
+  katana::NeighborhoodFunction nf =
+      katana::StatNeighborhoodFunction(graph, kRegisterBits, 256, 0);
+  const std::vector<double>& pairs = nf.pairs_within_hops;
+  KATANA_LOG_VASSERT(
+      pairs.size() == expected.size(), "{} hops, expected {}", pairs.size(),
+      expected.size());
+  KATANA_LOG_ASSERT(nf.converged);
+  for (size_t h = 0; h < pairs.size(); ++h) {
+    KATANA_LOG_VASSERT(
+        std::abs(pairs[h] - expected[h]) < 0.01 * expected[h],
+        "{} pairs within {} hops, expected {}", pairs[h], h, expected[h]);
+  }
+
+  double total = expected.back();
+  double effective_diameter = 0;
+  for (size_t h = 1; h < expected.size(); ++h) {
+    if (expected[h] >= 0.9 * total) {
+      effective_diameter = (h - 1) + (0.9 * total - expected[h - 1]) /
+                                         (expected[h] - expected[h - 1]);
+      break;
+    }
+  }
+  KATANA_LOG_VASSERT(
+      std::abs(nf.effective_diameter - effective_diameter) < 0.1,
+      "effective diameter {}, expected {}", nf.effective_diameter,
+      effective_diameter);
+
+  // Stopped early
+  nf = katana::StatNeighborhoodFunction(graph, kRegisterBits, 2, 0);
+  KATANA_LOG_ASSERT(nf.pairs_within_hops.size() == 3);
+  KATANA_LOG_ASSERT(!nf.converged);
+}
+
+void
+TestClusteringCoefficient() {
+  katana::FileGraph graph = Build(kEdges);
+  // Node 0 has neighbors 1, 2 and 4, of which only 1 -> 2 is an edge, even
+  // though it is there twice; node 2 has 0 and 3, and 3 -> 0. Node 5 has
+  // one neighbor besides itself.
+  std::vector<double> expected(kEdges.size());
+  expected[0] = 1.0 / 6;
+  expected[2] = 1.0 / 2;
+  for (uint64_t n = 0; n < kEdges.size(); ++n) {
+    double coefficient = katana::StatClusteringCoefficient(graph, {n});
+    KATANA_LOG_VASSERT(
+        std::abs(coefficient - expected[n]) < 1e-12,
+        "node {} has coefficient {}, expected {}", n, coefficient,
+        expected[n]);
+  }
+
+  // Samples are nodes, the same for the same seed, and average like the
+  // nodes they are
+  std::vector<uint64_t> samples = katana::SampleNodes(graph, 1000, 3);
+  KATANA_LOG_ASSERT(samples == katana::SampleNodes(graph, 1000, 3));
+  KATANA_LOG_ASSERT(samples != katana::SampleNodes(graph, 1000, 4));
+  double sum = 0;
+  std::set<uint64_t> distinct;
+  for (uint64_t n : samples) {
+    KATANA_LOG_ASSERT(n < kEdges.size());
+    sum += expected[n];
+    distinct.emplace(n);
+  }
+  KATANA_LOG_ASSERT(distinct.size() == kEdges.size());
+  double average = katana::StatClusteringCoefficient(graph, samples);
+  KATANA_LOG_VASSERT(
+      std::abs(average - sum / samples.size()) < 1e-12,
+      "average of samples {}, expected {}", average, sum / samples.size());
+
+  // On a symmetric triangle every coefficient is 1
+  katana::FileGraph triangle = Build({{1, 2}, {0, 2}, {0, 1}});
+  KATANA_LOG_ASSERT(
+      katana::StatClusteringCoefficient(
+          triangle, katana::SampleNodes(triangle, 100, 0)) == 1);
+}
+
+void
+TestComponentSizes() {
+  const katana::StatHistogram expected = {{1, 2}, {2, 1}, {8, 1}};
+  katana::FileGraph graph = Build(kEdges);
+  KATANA_LOG_ASSERT(katana::StatComponentSizes(graph, false, 0) == expected);
+
+  // Skipping the largest component needs the reverse edges
+  katana::FileGraph symmetric = Build(Symmetrize(kEdges));
+  for (unsigned seed : {0, 1, 2}) {
+    KATANA_LOG_ASSERT(
+        katana::StatComponentSizes(symmetric, true, seed) == expected);
+    KATANA_LOG_ASSERT(
+        katana::StatComponentSizes(symmetric, false, seed) == expected);
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  TestDegrees();
+  TestNeighborhoodFunction();
+  TestClusteringCoefficient();
+  TestComponentSizes();
+
+  return 0;
+}